@@ -0,0 +1,11 @@
+-- The rows and bytes processed by the codec benchmarks, to turn their timings into rows/s and bytes/s
+LOAD spatial;
+SELECT type, count(*) AS rows, sum(octet_length(geom::BLOB)) AS geometry_bytes, sum(octet_length(wkb)) AS wkb_bytes,
+    sum(strlen(wkt)) AS wkt_bytes, sum(strlen(geojson)) AS geojson_bytes, sum(octet_length(twkb)) AS twkb_bytes
+FROM (
+    SELECT 'point' AS type, point AS geom FROM test_geometry_types(1000000)
+    UNION ALL SELECT 'linestring', linestring FROM test_geometry_types(10000)
+    UNION ALL SELECT 'multipolygon', multipolygon FROM test_geometry_types(10000)
+), LATERAL (SELECT ST_AsWKB(geom) AS wkb, ST_AsText(geom) AS wkt, ST_AsGeoJSON(geom)::VARCHAR AS geojson,
+    ST_AsTWKB(geom, 7) AS twkb)
+GROUP BY type;
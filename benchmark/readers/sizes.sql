@@ -0,0 +1,7 @@
+-- The features and bytes read by the reader benchmarks, to turn their timings into features/s and MB/s
+LOAD spatial;
+SELECT 'fgb' AS format, count(*) AS features FROM ST_ReadFGB('test/data/germany/roads/roads.fgb')
+UNION ALL SELECT 'gpkg', count(*) FROM ST_Read('test/data/germany/roads/roads.gpkg')
+UNION ALL SELECT 'geojson', count(*) FROM ST_Read('test/data/germany/roads/roads.geojson')
+UNION ALL SELECT 'shp', count(*) FROM ST_ReadSHP('test/data/germany/roads/roads.shp')
+UNION ALL SELECT 'pbf', count(*) FROM ST_ReadOSM('test/data/germany.osm.pbf');
@@ -0,0 +1,267 @@
+#!/usr/bin/env python3
+"""Runs the spatial benchmarks and compares the results against a baseline.
+
+    python3 scripts/benchmark.py run [--pattern REGEX] [--threads N] [--out FILE]
+    python3 scripts/benchmark.py compare BASELINE CURRENT [--threshold FRACTION]
+
+`run` times every benchmark matching the pattern with DuckDB's benchmark runner, then runs it once more in the DuckDB
+shell to read the peak memory of the geometry arenas from spatial_memory() and the number of threads it ran with. The
+results are written as JSON (see RESULT_SCHEMA), so they can be stored as a baseline by any CI system or by hand.
+
+`compare` matches the benchmarks of two result files by name and exits with status 1 if any of them got slower than
+the threshold allows, so that it can fail a CI job. Throughput is compared in rows per second when both results know
+the number of rows, and in median time otherwise.
+"""
+
+import argparse
+import datetime
+import json
+import os
+import re
+import statistics
+import subprocess
+import sys
+import tempfile
+
+RESULT_SCHEMA = "duckdb-spatial-benchmark"
+RESULT_VERSION = 1
+
+# Sections of a benchmark file whose body runs until the next empty line
+BLOCK_SECTIONS = ("load", "init", "run", "result", "cleanup")
+
+
+def read_benchmark(path):
+    """Returns the sections of a benchmark file, with its template expanded."""
+    with open(path) as f:
+        lines = f.read().splitlines()
+
+    # An instance of a template is "template <path>" followed by KEY=value lines
+    template = next((line.split(None, 1)[1] for line in lines if line.startswith("template ")), None)
+    if template is not None:
+        params = dict(line.split("=", 1) for line in lines if re.match(r"^[A-Z_][A-Z0-9_]*=", line))
+        with open(template) as f:
+            text = f.read()
+        for key, value in params.items():
+            text = text.replace("${" + key + "}", value)
+        lines = text.splitlines()
+    text = "\n".join(lines)
+    text = text.replace("${FILE_PATH}", path).replace("${BENCHMARK_DIR}", os.path.dirname(path))
+    lines = text.splitlines()
+
+    sections = {"name": path, "group": None}
+    i = 0
+    while i < len(lines):
+        line = lines[i].strip()
+        keyword, _, argument = line.partition(" ")
+        i += 1
+        if keyword in ("name", "group"):
+            sections[keyword] = argument.strip()
+        elif keyword in BLOCK_SECTIONS:
+            body = []
+            while i < len(lines) and lines[i].strip():
+                body.append(lines[i])
+                i += 1
+            if keyword in ("load", "run") and argument.strip() and not body:
+                # The queries are in a separate file
+                with open(argument.strip()) as f:
+                    body = f.read().splitlines()
+            sections[keyword] = "\n".join(body)
+            if keyword == "result":
+                sections["result_types"] = argument.strip()
+    return sections
+
+
+def expected_rows(sections):
+    """The number of rows a benchmark processes, by convention the single integer its run query returns."""
+    if sections.get("result_types") != "I":
+        return None
+    result = sections.get("result", "").strip()
+    return int(result) if re.fullmatch(r"\d+", result) else None
+
+
+def find_benchmarks(pattern):
+    paths = []
+    for root, _, files in os.walk("benchmark"):
+        for name in files:
+            path = os.path.join(root, name)
+            if name.endswith(".benchmark") and re.search(pattern, path):
+                paths.append(path)
+    return sorted(paths)
+
+
+def time_benchmark(runner, path, threads):
+    """Returns the timings of the runs of a benchmark, in seconds."""
+    with tempfile.NamedTemporaryFile(mode="r", suffix=".tsv") as out:
+        command = [runner, path, "--out=" + out.name]
+        if threads:
+            command.append("--threads=%d" % threads)
+        subprocess.run(command, check=True, stdout=subprocess.DEVNULL)
+        timings = []
+        for line in out.read().splitlines():
+            fields = line.split("\t")
+            if len(fields) == 3 and fields[1].isdigit():
+                timings.append(float(fields[2]))
+        return timings
+
+
+def measure_benchmark(shell, sections, threads):
+    """Runs a benchmark once in the shell and returns the peak arena memory of its run query and its thread count."""
+    script = [".mode csv", ".headers off"]
+    if threads:
+        script.append("SET threads TO %d;" % threads)
+    for section in ("load", "init"):
+        if sections.get(section):
+            script.append(sections[section].rstrip().rstrip(";") + ";")
+    # spatial_memory() resets the peak, so the second call only sees the run query
+    script.append("SELECT count(*) FROM spatial_memory();")
+    script.append(sections["run"].rstrip().rstrip(";") + ";")
+    script.append("SELECT 'benchmark_memory', peak_bytes, current_setting('threads') "
+                  "FROM spatial_memory() WHERE component = 'geometry_arenas';")
+    result = subprocess.run([shell], input="\n".join(script) + "\n", capture_output=True, text=True, check=True)
+    for line in reversed(result.stdout.splitlines()):
+        fields = line.split(",")
+        if fields[0] == "benchmark_memory":
+            return int(fields[1]), int(fields[2])
+    raise RuntimeError("could not read the memory of %s: %s" % (sections["name"], result.stderr.strip()))
+
+
+def git_commit():
+    try:
+        return subprocess.run(["git", "rev-parse", "HEAD"], capture_output=True, text=True, check=True).stdout.strip()
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+
+def run(args):
+    paths = find_benchmarks(args.pattern)
+    if not paths:
+        sys.exit("no benchmarks match %s" % args.pattern)
+
+    benchmarks = []
+    for path in paths:
+        print(path, file=sys.stderr)
+        sections = read_benchmark(path)
+        timings = time_benchmark(args.runner, path, args.threads)
+        median = statistics.median(timings) if timings else None
+        rows = expected_rows(sections)
+        peak_arena_bytes, threads = None, args.threads
+        if not args.skip_memory:
+            peak_arena_bytes, threads = measure_benchmark(args.shell, sections, args.threads)
+        benchmarks.append({
+            "name": path,
+            "display_name": sections["name"],
+            "group": sections["group"],
+            "threads": threads,
+            "timings": timings,
+            "median_seconds": median,
+            "rows": rows,
+            "rows_per_second": rows / median if rows is not None and median else None,
+            "peak_arena_bytes": peak_arena_bytes,
+        })
+
+    result = {
+        "schema": RESULT_SCHEMA,
+        "version": RESULT_VERSION,
+        "commit": git_commit(),
+        "timestamp": datetime.datetime.now(datetime.timezone.utc).isoformat(timespec="seconds"),
+        "benchmarks": benchmarks,
+    }
+    os.makedirs(os.path.dirname(os.path.abspath(args.out)), exist_ok=True)
+    with open(args.out, "w") as f:
+        json.dump(result, f, indent=2)
+        f.write("\n")
+    print("wrote %d results to %s" % (len(benchmarks), args.out), file=sys.stderr)
+
+
+def load_results(path):
+    with open(path) as f:
+        result = json.load(f)
+    if result.get("schema") != RESULT_SCHEMA or result.get("version") != RESULT_VERSION:
+        sys.exit("%s is not a version %d benchmark result" % (path, RESULT_VERSION))
+    return {benchmark["name"]: benchmark for benchmark in result["benchmarks"]}
+
+
+def throughput_ratio(baseline, current):
+    """How much faster the current result is than the baseline, 1.0 being the same speed."""
+    if baseline["rows_per_second"] and current["rows_per_second"]:
+        return current["rows_per_second"] / baseline["rows_per_second"]
+    if baseline["median_seconds"] and current["median_seconds"]:
+        return baseline["median_seconds"] / current["median_seconds"]
+    return None
+
+
+def format_bytes(value):
+    if value is None:
+        return "-"
+    for unit in ("B", "KiB", "MiB", "GiB"):
+        if value < 1024 or unit == "GiB":
+            return "%.1f %s" % (value, unit) if unit != "B" else "%d B" % value
+        value /= 1024.0
+
+
+def compare(args):
+    baseline = load_results(args.baseline)
+    current = load_results(args.current)
+
+    regressions = 0
+    print("%-60s %10s %12s %12s  %s" % ("benchmark", "speed", "peak arena", "baseline", "status"))
+    for name in sorted(set(baseline) | set(current)):
+        if name not in current:
+            print("%-60s %10s %12s %12s  %s" % (name, "-", "-", "-", "missing"))
+            continue
+        if name not in baseline:
+            print("%-60s %10s %12s %12s  %s" % (name, "-", format_bytes(current[name]["peak_arena_bytes"]), "-",
+                                                 "new"))
+            continue
+        old, new = baseline[name], current[name]
+        ratio = throughput_ratio(old, new)
+        status = []
+        if ratio is None:
+            status.append("no timings")
+        elif ratio < 1.0 - args.threshold:
+            status.append("SLOWER")
+            regressions += 1
+        old_peak, new_peak = old["peak_arena_bytes"], new["peak_arena_bytes"]
+        if args.memory_threshold is not None and old_peak is not None and new_peak is not None \
+                and new_peak > old_peak * (1.0 + args.memory_threshold):
+            status.append("MORE MEMORY")
+            regressions += 1
+        if old["threads"] != new["threads"]:
+            status.append("threads %s -> %s" % (old["threads"], new["threads"]))
+        speed = "%+.1f%%" % ((ratio - 1.0) * 100) if ratio is not None else "-"
+        print("%-60s %10s %12s %12s  %s" % (name, speed, format_bytes(new_peak), format_bytes(old_peak),
+                                            ", ".join(status) or "ok"))
+
+    if regressions:
+        print("%d regression(s) past the threshold" % regressions, file=sys.stderr)
+        sys.exit(1)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Run the spatial benchmarks and compare them against a baseline")
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    run_parser = commands.add_parser("run", help="run benchmarks and write their results as JSON")
+    run_parser.add_argument("--pattern", default="benchmark/layout/.*", help="regex of the benchmark paths to run")
+    run_parser.add_argument("--threads", type=int, default=None, help="threads, unless set by a benchmark")
+    run_parser.add_argument("--out", default="build/benchmark/results.json", help="the result file to write")
+    run_parser.add_argument("--runner", default="build/release/benchmark/benchmark_runner")
+    run_parser.add_argument("--shell", default="build/release/duckdb")
+    run_parser.add_argument("--skip-memory", action="store_true", help="do not run the benchmarks to measure memory")
+    run_parser.set_defaults(func=run)
+
+    compare_parser = commands.add_parser("compare", help="compare results against a baseline")
+    compare_parser.add_argument("baseline")
+    compare_parser.add_argument("current")
+    compare_parser.add_argument("--threshold", type=float, default=0.10,
+                                help="the fraction of throughput a benchmark may lose before it is flagged")
+    compare_parser.add_argument("--memory-threshold", type=float, default=None,
+                                help="the fraction of peak arena memory a benchmark may gain before it is flagged")
+    compare_parser.set_defaults(func=compare)
+
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,180 @@
+"""
+Write the small OSM PBF file used by the ST_ReadOSM tests to test/data/geometries.osm.pbf.
+
+The file has a header block with the bbox (0 0, 20 20), a block with the nodes (dense nodes and a plain node), and a
+block with the ways and relations:
+
+    nodes 1-4       corners of the square (0 0, 1 1)
+    nodes 5-8       corners of the square (0.25 0.25, 0.75 0.75)
+    nodes 9-10      (2 0) and (3 0), node 9 is tagged highway=crossing
+    node 11         (10 10), a plain node tagged amenity=bench
+    way 101         9, 10, tagged highway=residential
+    way 102         1, 2, 3
+    way 103         1, 4, 3, the other half of the outer ring, in reverse
+    way 104         5, 6, 7, 8, 5
+    way 105         1, 2, tagged barrier=fence
+    relation 201    multipolygon of the outer ways 102 and 103 and the inner way 104, tagged landuse=forest
+    relation 202    multipolygon of the outer way 105, which can not be closed
+    relation 203    route with the member node 9
+
+Usage: python3 scripts/generate_osm_fixture.py
+"""
+
+import os
+import struct
+import zlib
+
+OUTPUT = os.path.join(os.path.dirname(__file__), "..", "test", "data", "geometries.osm.pbf")
+
+
+def varint(value):
+    result = bytearray()
+    while True:
+        byte = value & 0x7F
+        value >>= 7
+        if value:
+            result.append(byte | 0x80)
+        else:
+            result.append(byte)
+            return bytes(result)
+
+
+def zigzag(value):
+    return (value << 1) ^ (value >> 63)
+
+
+def field_varint(tag, value):
+    return varint(tag << 3) + varint(value)
+
+
+def field_sint(tag, value):
+    return field_varint(tag, zigzag(value))
+
+
+def field_bytes(tag, data):
+    return varint((tag << 3) | 2) + varint(len(data)) + data
+
+
+def field_packed(tag, values):
+    return field_bytes(tag, b"".join(varint(v) for v in values))
+
+
+def field_packed_sint(tag, values):
+    return field_packed(tag, [zigzag(v) for v in values])
+
+
+def deltas(values):
+    return [v - p for v, p in zip(values, [0] + values[:-1])]
+
+
+# Coordinates are given in degrees and written with the default granularity of 100 nanodegrees
+def fixed(degrees):
+    return int(round(degrees * 10_000_000))
+
+
+class StringTable:
+    def __init__(self):
+        self.strings = [""]
+
+    def id(self, string):
+        if string not in self.strings:
+            self.strings.append(string)
+        return self.strings.index(string)
+
+    def encode(self):
+        return b"".join(field_bytes(1, s.encode()) for s in self.strings)
+
+
+def tags(table, entity_tags):
+    keys = [table.id(k) for k in entity_tags]
+    vals = [table.id(v) for v in entity_tags.values()]
+    return field_packed(2, keys) + field_packed(3, vals) if keys else b""
+
+
+def primitive_block(table, groups):
+    return field_bytes(1, table.encode()) + b"".join(field_bytes(2, group) for group in groups)
+
+
+def node_block():
+    table = StringTable()
+    nodes = [
+        (1, 0, 0, {}),
+        (2, 1, 0, {}),
+        (3, 1, 1, {}),
+        (4, 0, 1, {}),
+        (5, 0.25, 0.25, {}),
+        (6, 0.75, 0.25, {}),
+        (7, 0.75, 0.75, {}),
+        (8, 0.25, 0.75, {}),
+        (9, 2, 0, {"highway": "crossing"}),
+        (10, 3, 0, {}),
+    ]
+    keys_vals = []
+    for node in nodes:
+        for key, val in node[3].items():
+            keys_vals += [table.id(key), table.id(val)]
+        keys_vals.append(0)
+    dense = (
+        field_packed_sint(1, deltas([n[0] for n in nodes]))
+        + field_packed_sint(8, deltas([fixed(n[2]) for n in nodes]))
+        + field_packed_sint(9, deltas([fixed(n[1]) for n in nodes]))
+        + field_packed(10, keys_vals)
+    )
+    plain = field_sint(1, 11) + tags(table, {"amenity": "bench"}) + field_sint(8, fixed(10)) + field_sint(9, fixed(10))
+    return primitive_block(table, [field_bytes(2, dense), field_bytes(1, plain)])
+
+
+def way_block():
+    table = StringTable()
+    ways = [
+        (101, [9, 10], {"highway": "residential"}),
+        (102, [1, 2, 3], {}),
+        (103, [1, 4, 3], {}),
+        (104, [5, 6, 7, 8, 5], {}),
+        (105, [1, 2], {"barrier": "fence"}),
+    ]
+    way_group = b""
+    for way_id, refs, way_tags in ways:
+        way = field_varint(1, way_id) + tags(table, way_tags) + field_packed_sint(8, deltas(refs))
+        way_group += field_bytes(3, way)
+
+    # Member types: 0 node, 1 way, 2 relation
+    relations = [
+        (201, [(102, 1, "outer"), (103, 1, "outer"), (104, 1, "inner")], {"type": "multipolygon", "landuse": "forest"}),
+        (202, [(105, 1, "outer")], {"type": "multipolygon"}),
+        (203, [(9, 0, "stop")], {"type": "route"}),
+    ]
+    relation_group = b""
+    for relation_id, members, relation_tags in relations:
+        relation = (
+            field_varint(1, relation_id)
+            + tags(table, relation_tags)
+            + field_packed(8, [table.id(m[2]) for m in members])
+            + field_packed_sint(9, deltas([m[0] for m in members]))
+            + field_packed(10, [m[1] for m in members])
+        )
+        relation_group += field_bytes(4, relation)
+    return primitive_block(table, [way_group, relation_group])
+
+
+def header_block():
+    bbox = field_sint(1, 0) + field_sint(2, 20_000_000_000) + field_sint(3, 20_000_000_000) + field_sint(4, 0)
+    features = field_bytes(4, b"OsmSchema-V0.6") + field_bytes(4, b"DenseNodes")
+    return field_bytes(1, bbox) + features
+
+
+def file_block(block_type, data):
+    blob = field_varint(2, len(data)) + field_bytes(3, zlib.compress(data))
+    header = field_bytes(1, block_type.encode()) + field_varint(3, len(blob))
+    return struct.pack(">i", len(header)) + header + blob
+
+
+def main():
+    with open(OUTPUT, "wb") as f:
+        f.write(file_block("OSMHeader", header_block()))
+        f.write(file_block("OSMData", node_block()))
+        f.write(file_block("OSMData", way_block()))
+
+
+if __name__ == "__main__":
+    main()
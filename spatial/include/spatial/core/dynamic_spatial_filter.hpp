@@ -0,0 +1,54 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// DynamicSpatialFilter
+//------------------------------------------------------------------------------
+// The extent of the build side of a spatial join, which is only known once the build side is complete. The join and
+// the table function that scans its probe side share it: the probe pipeline starts after the build has finished, so
+// the scan can pass the extent on to its reader and skip the features outside of it. If the scan starts without an
+// extent it simply reads everything, the join matches the same rows either way.
+class DynamicSpatialFilter {
+public:
+	// Forget the extent of a previous run of the plan, when the build starts again
+	void Clear() {
+		lock_guard<mutex> guard(lock);
+		has_extent = false;
+	}
+
+	void SetExtent(const BoundingBox &extent_p) {
+		lock_guard<mutex> guard(lock);
+		extent = extent_p;
+		has_extent = true;
+	}
+
+	bool TryGetExtent(BoundingBox &result) const {
+		lock_guard<mutex> guard(lock);
+		if (!has_extent) {
+			return false;
+		}
+		result = extent;
+		return true;
+	}
+
+private:
+	mutable mutex lock;
+	bool has_extent = false;
+	BoundingBox extent;
+};
+
+// Implemented by the bind data of the table functions that can skip the features outside of a dynamic filter
+struct DynamicSpatialFilterTarget {
+	virtual ~DynamicSpatialFilterTarget() = default;
+	// Use the filter for the given column, returns false if it is not a geometry column the scan can filter on
+	virtual bool TryAddDynamicFilter(column_t column_id, shared_ptr<DynamicSpatialFilter> filter) = 0;
+};
+
+} // namespace core
+
+} // namespace spatial
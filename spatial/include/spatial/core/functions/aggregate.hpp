@@ -8,11 +8,33 @@ namespace core {
 struct CoreAggregateFunctions {
 public:
 	static void Register(DatabaseInstance &db) {
+		RegisterStAsMVT(db);
+		RegisterStClusterKMeans(db);
+		RegisterStCollectAgg(db);
+		RegisterStConvexHullAgg(db);
 		RegisterStEnvelopeAgg(db);
+		RegisterStExtentAgg(db);
+		RegisterStFeatureCollectionAgg(db);
+		RegisterStHeatmap(db);
+		RegisterStMakeLineAgg(db);
+		RegisterStRoutingGraphAgg(db);
+		RegisterStSampleGrid(db);
+		RegisterStSummaryAgg(db);
 	}
 
 private:
+	static void RegisterStAsMVT(DatabaseInstance &db);
+	static void RegisterStClusterKMeans(DatabaseInstance &db);
+	static void RegisterStCollectAgg(DatabaseInstance &db);
+	static void RegisterStConvexHullAgg(DatabaseInstance &db);
 	static void RegisterStEnvelopeAgg(DatabaseInstance &db);
+	static void RegisterStExtentAgg(DatabaseInstance &db);
+	static void RegisterStFeatureCollectionAgg(DatabaseInstance &db);
+	static void RegisterStHeatmap(DatabaseInstance &db);
+	static void RegisterStMakeLineAgg(DatabaseInstance &db);
+	static void RegisterStRoutingGraphAgg(DatabaseInstance &db);
+	static void RegisterStSampleGrid(DatabaseInstance &db);
+	static void RegisterStSummaryAgg(DatabaseInstance &db);
 };
 
 } // namespace core
@@ -9,11 +9,12 @@ struct GeometryFactory;
 
 struct CoreVectorOperations {
 public:
-	static void Point2DToVarchar(Vector &source, Vector &result, idx_t count);
-	static void LineString2DToVarchar(Vector &source, Vector &result, idx_t count);
-	static void Polygon2DToVarchar(Vector &source, Vector &result, idx_t count);
-	static void Box2DToVarchar(Vector &source, Vector &result, idx_t count);
-	static void GeometryToVarchar(Vector &source, Vector &result, idx_t count);
+	// Format as WKT, with at most "precision" digits after the decimal point (see Utils::format_coord)
+	static void Point2DToVarchar(Vector &source, Vector &result, idx_t count, uint32_t precision);
+	static void LineString2DToVarchar(Vector &source, Vector &result, idx_t count, uint32_t precision);
+	static void Polygon2DToVarchar(Vector &source, Vector &result, idx_t count, uint32_t precision);
+	static void Box2DToVarchar(Vector &source, Vector &result, idx_t count, uint32_t precision);
+	static void GeometryToVarchar(Vector &source, Vector &result, idx_t count, uint32_t precision);
 };
 
 struct CoreCastFunctions {
@@ -22,6 +23,7 @@ public:
 		RegisterVarcharCasts(db);
 		RegisterDimensionalCasts(db);
 		RegisterGeometryCasts(db);
+		RegisterQuantizedCasts(db);
 		RegisterWKBCasts(db);
 	}
 
@@ -29,6 +31,7 @@ private:
 	static void RegisterVarcharCasts(DatabaseInstance &db);
 	static void RegisterDimensionalCasts(DatabaseInstance &db);
 	static void RegisterGeometryCasts(DatabaseInstance &db);
+	static void RegisterQuantizedCasts(DatabaseInstance &db);
 	static void RegisterWKBCasts(DatabaseInstance &db);
 };
 
@@ -2,21 +2,222 @@
 #include "spatial/common.hpp"
 #include "spatial/core/geometry/geometry_factory.hpp"
 
+#include "duckdb/common/types/hash.hpp"
+#include "duckdb/common/vector_operations/unary_executor.hpp"
+
 namespace spatial {
 
 namespace core {
 
+//------------------------------------------------------------------------------
+// Geometry Arena
+//------------------------------------------------------------------------------
+// The arena of a function local state is reset between chunks, which keeps its largest block around for the next
+// chunk. If an outlier (e.g. one huge multipolygon) grew the arena past the "spatial_arena_soft_limit" setting, the
+// arena is released entirely instead, so it does not stay over-allocated for the rest of the query.
+// The arenas allocate through the buffer allocator, so their memory already counts towards the memory limit.
+struct GeometryArena {
+	// Get the soft limit configured for the client
+	static idx_t GetSoftLimit(ClientContext &context);
+	// Reset the arena after a chunk, tracked_size is the size of the arena as of the previous reset
+	static void Reset(ArenaAllocator &arena, idx_t soft_limit, idx_t &tracked_size);
+	// Stop tracking an arena that is about to be destroyed
+	static void Release(ArenaAllocator &arena, idx_t &tracked_size);
+
+	// Get the bytes currently held by all arenas, the peak and the number of trims since the last call
+	static void FetchMetrics(idx_t &held_bytes, idx_t &peak_bytes, idx_t &trim_count);
+	// Get the bytes currently held by all arenas and the peak since the last call, without resetting the trims
+	static void FetchMemory(idx_t &held_bytes, idx_t &peak_bytes);
+};
+
+//------------------------------------------------------------------------------
+// Aggregate State Memory
+//------------------------------------------------------------------------------
+// The GEOS geometries and copied inputs held by aggregate states (e.g. ST_ClusterDBSCAN) live outside of DuckDB's
+// allocators. GEOS has no allocator hook, so the size of a GEOS geometry is estimated from its coordinates. The states
+// report their size through the bind data of their aggregate, which fails the query with an OutOfMemoryException
+// once the aggregate states together with the buffer manager hold more than the memory limit.
+// States that keep their partial results serialized (e.g. ST_Union_Agg) allocate them through the buffer allocator
+// instead, which counts them towards the memory limit itself, so they are not reported here.
+struct AggregateMemoryBindData : public FunctionData {
+	string function_name;
+	// The client running the aggregate, whose query can be interrupted
+	ClientContext &context;
+	BufferManager &buffer_manager;
+	// The buffer allocator of the client
+	Allocator &allocator;
+
+	AggregateMemoryBindData(string function_name, ClientContext &context);
+
+	// Set the size of a state, tracked_size is its size as of the previous update. Throws if the state grew past
+	// the memory limit.
+	void Update(idx_t &tracked_size, idx_t new_size) const;
+
+	unique_ptr<FunctionData> Copy() const override;
+	bool Equals(const FunctionData &other_p) const override;
+
+	// Bind for the aggregates that have no parameters of their own
+	static unique_ptr<FunctionData> Bind(ClientContext &context, AggregateFunction &function,
+	                                     vector<unique_ptr<Expression>> &arguments);
+	// Get the bytes currently held by all aggregate states and the peak since the last call
+	static void FetchMemory(idx_t &held_bytes, idx_t &peak_bytes);
+};
+
+//------------------------------------------------------------------------------
+// Coordinate Precision
+//------------------------------------------------------------------------------
+// Bind data of the functions that write coordinates as text and take the most digits after the decimal point as an
+// optional last argument, e.g. ST_AsText(geom, 6). The precision has to be a constant between 0 and 15, so that
+// every row of a column is written the same way. Without it, coordinates are written with up to 15 digits.
+struct CoordinatePrecisionBindData final : public FunctionData {
+	uint32_t precision;
+
+	explicit CoordinatePrecisionBindData(uint32_t precision) : precision(precision) {
+	}
+
+	unique_ptr<FunctionData> Copy() const override;
+	bool Equals(const FunctionData &other_p) const override;
+
+	static unique_ptr<FunctionData> Bind(ClientContext &context, ScalarFunction &bound_function,
+	                                     vector<unique_ptr<Expression>> &arguments);
+	// Get the precision of a function bound with the above, or of one without bind data
+	static uint32_t Get(ExpressionState &state);
+};
+
 struct GeometryFunctionLocalState : FunctionLocalState {
 public:
 	GeometryFactory factory;
+	idx_t arena_soft_limit;
+	idx_t arena_size = 0;
 
 public:
 	explicit GeometryFunctionLocalState(ClientContext &context);
+	~GeometryFunctionLocalState() override;
 	static unique_ptr<FunctionLocalState> Init(ExpressionState &state, const BoundFunctionExpression &expr,
 	                                           FunctionData *bind_data);
 	static unique_ptr<FunctionLocalState> InitCast(CastLocalStateParameters &context);
 	static GeometryFunctionLocalState &ResetAndGet(ExpressionState &state);
 	static GeometryFunctionLocalState &ResetAndGet(CastParameters &parameters);
+	// The "spatial_double_precision_bbox" setting, for serializers that are not built from a local state
+	static bool GetDoubleBBox(ClientContext &context);
+};
+
+//------------------------------------------------------------------------------
+// Geometry Executor
+//------------------------------------------------------------------------------
+// Like UnaryExecutor::Execute, but meant for expensive functions over geometries, which are often repeated: a
+// polygon denormalized onto many rows of a fact table, or repeated by a join. The function is only evaluated once for
+// every distinct geometry of a chunk, and the result is a DICTIONARY vector over those results.
+// - In a DICTIONARY vector the geometries are distinct by dictionary entry.
+// - In a FLAT vector they are distinct by content: geometries of at least DEDUPLICATE_MIN_SIZE bytes are looked up by
+//   a hash of their start and size, and verified against the full blob. Smaller ones are cheaper to evaluate again.
+// CONSTANT vectors are already only evaluated once by the UnaryExecutor. INPUT_TYPE must be geometry_t or string_t.
+struct GeometryExecutor {
+	static constexpr idx_t DEDUPLICATE_MIN_SIZE = 256;
+	// The header and bounding box are usually enough to tell geometries apart
+	static constexpr idx_t DEDUPLICATE_KEY_PREFIX_SIZE = 64;
+
+	template <class INPUT_TYPE, class RESULT_TYPE, class FUNC>
+	static void ExecuteUnary(Vector &input, Vector &result, idx_t count, FUNC &&fun) {
+		if (input.GetVectorType() == VectorType::FLAT_VECTOR) {
+			ExecuteFlat<INPUT_TYPE, RESULT_TYPE>(input, result, count, std::forward<FUNC>(fun));
+			return;
+		}
+		if (input.GetVectorType() != VectorType::DICTIONARY_VECTOR ||
+		    DictionaryVector::Child(input).GetVectorType() != VectorType::FLAT_VECTOR) {
+			UnaryExecutor::Execute<INPUT_TYPE, RESULT_TYPE>(input, result, count, std::forward<FUNC>(fun));
+			return;
+		}
+
+		auto &child = DictionaryVector::Child(input);
+		auto &dict_sel = DictionaryVector::SelVector(input);
+		auto child_data = FlatVector::GetData<INPUT_TYPE>(child);
+		auto &child_validity = FlatVector::Validity(child);
+
+		result.SetVectorType(VectorType::FLAT_VECTOR);
+		auto result_data = FlatVector::GetData<RESULT_TYPE>(result);
+		auto &result_validity = FlatVector::Validity(result);
+
+		// The results of the distinct entries are written to the front of the result vector, in order of first use.
+		// Any string data is added to the result vector itself, so it stays alive once the result is sliced.
+		SelectionVector result_sel(count);
+		unordered_map<idx_t, idx_t> entry_slots;
+		idx_t slot_count = 0;
+		for (idx_t i = 0; i < count; i++) {
+			auto entry_idx = dict_sel.get_index(i);
+			auto entry = entry_slots.find(entry_idx);
+			if (entry != entry_slots.end()) {
+				result_sel.set_index(i, entry->second);
+				continue;
+			}
+			auto slot = slot_count++;
+			entry_slots.emplace(entry_idx, slot);
+			result_sel.set_index(i, slot);
+			if (!child_validity.RowIsValid(entry_idx)) {
+				result_validity.SetInvalid(slot);
+			} else {
+				result_data[slot] = fun(child_data[entry_idx]);
+			}
+		}
+
+		if (slot_count < count) {
+			result.Slice(result_sel, count);
+		}
+	}
+
+private:
+	template <class INPUT_TYPE, class RESULT_TYPE, class FUNC>
+	static void ExecuteFlat(Vector &input, Vector &result, idx_t count, FUNC &&fun) {
+		auto input_data = FlatVector::GetData<INPUT_TYPE>(input);
+		auto &input_validity = FlatVector::Validity(input);
+
+		result.SetVectorType(VectorType::FLAT_VECTOR);
+		auto result_data = FlatVector::GetData<RESULT_TYPE>(result);
+		auto &result_validity = FlatVector::Validity(result);
+
+		// Like for dictionaries, the distinct results are written to the front of the result vector. A slot never
+		// comes after the row it is written for, so the rows can be processed in order.
+		SelectionVector result_sel(count);
+		unordered_map<hash_t, idx_t> hash_slots;
+		vector<idx_t> slot_rows(count);
+		idx_t slot_count = 0;
+		for (idx_t i = 0; i < count; i++) {
+			if (!input_validity.RowIsValid(i)) {
+				auto slot = slot_count++;
+				result_validity.SetInvalid(slot);
+				result_sel.set_index(i, slot);
+				continue;
+			}
+			string_t blob = input_data[i];
+			auto size = blob.GetSize();
+			auto lookup = hash_slots.end();
+			hash_t key = 0;
+			if (size >= DEDUPLICATE_MIN_SIZE) {
+				auto data = blob.GetData();
+				key = CombineHash(Hash(data, MinValue<idx_t>(size, DEDUPLICATE_KEY_PREFIX_SIZE)), Hash(size));
+				lookup = hash_slots.find(key);
+				if (lookup != hash_slots.end()) {
+					string_t other = input_data[slot_rows[lookup->second]];
+					if (other.GetSize() == size && memcmp(other.GetData(), data, size) == 0) {
+						result_sel.set_index(i, lookup->second);
+						continue;
+					}
+				}
+			}
+			auto slot = slot_count++;
+			slot_rows[slot] = i;
+			result_sel.set_index(i, slot);
+			result_data[slot] = fun(input_data[i]);
+			if (size >= DEDUPLICATE_MIN_SIZE && lookup == hash_slots.end()) {
+				// On a collision the first geometry keeps the key, the others are evaluated for every row
+				hash_slots.emplace(key, slot);
+			}
+		}
+
+		if (slot_count < count) {
+			result.Slice(result_sel, count);
+		}
+	}
 };
 
 } // namespace core
@@ -0,0 +1,22 @@
+#pragma once
+#include "spatial/common.hpp"
+
+namespace spatial {
+
+namespace core {
+
+struct CoreCopyFunctions {
+public:
+	static void Register(DatabaseInstance &db) {
+		RegisterGeoJSONSeqCopyFunction(db);
+		RegisterShapefileCopyFunction(db);
+	}
+
+private:
+	static void RegisterGeoJSONSeqCopyFunction(DatabaseInstance &db);
+	static void RegisterShapefileCopyFunction(DatabaseInstance &db);
+};
+
+} // namespace core
+
+} // namespace spatial
@@ -11,9 +11,11 @@ public:
 		RegisterStArea(db);
 		RegisterStAsGeoJSON(db);
 		RegisterStAsText(db);
+		RegisterStAsTWKB(db);
 		RegisterStAsWKB(db);
 		RegisterStAsHEXWKB(db);
 		RegisterStCentroid(db);
+		RegisterStClipByBox2D(db);
 		RegisterStCollect(db);
 		RegisterStCollectionExtract(db);
 		RegisterStContains(db);
@@ -21,6 +23,7 @@ public:
 		RegisterStDistance(db);
 		RegisterStDump(db);
 		RegisterStEndPoint(db);
+		RegisterStExpand(db);
 		RegisterStExtent(db);
 		RegisterStExteriorRing(db);
 		RegisterStFlipCoordinates(db);
@@ -28,11 +31,21 @@ public:
 		RegisterStGeometryType(db);
 		RegisterStGeomFromHEXWKB(db);
         RegisterStGeomFromText(db);
+		RegisterStGeomFromTWKB(db);
 		RegisterStGeomFromWKB(db);
+		RegisterStHash(db);
+		RegisterStHasZM(db);
+		RegisterStHexGrid(db);
+		RegisterStHilbert(db);
 		RegisterStIntersects(db);
 		RegisterStIntersectsExtent(db);
 		RegisterStIsEmpty(db);
+		RegisterStKNN(db);
 		RegisterStLength(db);
+		RegisterStLineInterpolatePoint(db);
+		RegisterStLineLocatePoint(db);
+		RegisterStLineSubstring(db);
+		RegisterStLOD(db);
 		RegisterStMakeEnvelope(db);
 		RegisterStMakeLine(db);
 		RegisterStMakePolygon(db);
@@ -43,8 +56,15 @@ public:
 		RegisterStPoint(db);
 		RegisterStPointN(db);
 		RegisterStQuadKey(db);
+		RegisterStQuantize(db);
 		RegisterStRemoveRepeatedPoints(db);
+		RegisterStS2Cell(db);
+		RegisterStSegmentize(db);
+		RegisterStSimplify(db);
+		RegisterStSnapToGrid(db);
 		RegisterStStartPoint(db);
+		RegisterStTileEnvelope(db);
+		RegisterStTriangulate(db);
 		RegisterStX(db);
 		RegisterStXMax(db);
 		RegisterStXMin(db);
@@ -72,12 +92,18 @@ private:
 	// ST_AsHextWKB
 	static void RegisterStAsHEXWKB(DatabaseInstance &db);
 
+	// ST_AsTWKB
+	static void RegisterStAsTWKB(DatabaseInstance &db);
+
 	// ST_AsWKB
 	static void RegisterStAsWKB(DatabaseInstance &db);
 
 	// ST_Centroid
 	static void RegisterStCentroid(DatabaseInstance &db);
 
+	// ST_ClipByBox2D
+	static void RegisterStClipByBox2D(DatabaseInstance &db);
+
 	// ST_Collect
 	static void RegisterStCollect(DatabaseInstance &db);
 
@@ -99,6 +125,9 @@ private:
 	// ST_EndPoint
 	static void RegisterStEndPoint(DatabaseInstance &db);
 
+	// ST_Expand
+	static void RegisterStExpand(DatabaseInstance &db);
+
 	// ST_Extent
 	static void RegisterStExtent(DatabaseInstance &db);
 
@@ -114,15 +143,30 @@ private:
 	// ST_GeometryType
 	static void RegisterStGeometryType(DatabaseInstance &db);
 
+	// ST_Hash
+	static void RegisterStHash(DatabaseInstance &db);
+
+	// ST_HasZ, ST_HasM
+	static void RegisterStHasZM(DatabaseInstance &db);
+
+	// ST_HexCell, ST_HexCenter, ST_HexBoundary, ST_HexKRing, ST_HexPolyfill
+	static void RegisterStHexGrid(DatabaseInstance &db);
+
 	// ST_GeomFromHEXWKB
 	static void RegisterStGeomFromHEXWKB(DatabaseInstance &db);
 
     // ST_GeomFromText
     static void RegisterStGeomFromText(DatabaseInstance &db);
 
+	// ST_GeomFromTWKB
+	static void RegisterStGeomFromTWKB(DatabaseInstance &db);
+
 	// ST_GeomFromWKB
 	static void RegisterStGeomFromWKB(DatabaseInstance &db);
 
+	// ST_Hilbert, ST_Morton
+	static void RegisterStHilbert(DatabaseInstance &db);
+
 	// ST_Intersects
 	static void RegisterStIntersects(DatabaseInstance &db);
 
@@ -132,9 +176,24 @@ private:
 	// ST_IsEmpty
 	static void RegisterStIsEmpty(DatabaseInstance &db);
 
+	// ST_KNN
+	static void RegisterStKNN(DatabaseInstance &db);
+
 	// ST_Length
 	static void RegisterStLength(DatabaseInstance &db);
 
+	// ST_LineInterpolatePoint
+	static void RegisterStLineInterpolatePoint(DatabaseInstance &db);
+
+	// ST_LineLocatePoint
+	static void RegisterStLineLocatePoint(DatabaseInstance &db);
+
+	// ST_LineSubstring
+	static void RegisterStLineSubstring(DatabaseInstance &db);
+
+	// ST_BuildLOD, ST_LOD
+	static void RegisterStLOD(DatabaseInstance &db);
+
 	// ST_MakeEnvelope
 	static void RegisterStMakeEnvelope(DatabaseInstance &db);
 
@@ -165,12 +224,33 @@ private:
 	// ST_RemoveRepeatedPoints
 	static void RegisterStRemoveRepeatedPoints(DatabaseInstance &db);
 
+	// ST_Simplify, ST_SimplifyVW
+	static void RegisterStSimplify(DatabaseInstance &db);
+
 	// ST_QuadKey
 	static void RegisterStQuadKey(DatabaseInstance &db);
 
+	// ST_Quantize
+	static void RegisterStQuantize(DatabaseInstance &db);
+
+	// ST_S2Cell, ST_S2Covering
+	static void RegisterStS2Cell(DatabaseInstance &db);
+
+	// ST_Segmentize
+	static void RegisterStSegmentize(DatabaseInstance &db);
+
+	// ST_SnapToGrid
+	static void RegisterStSnapToGrid(DatabaseInstance &db);
+
 	// ST_StartPoint
 	static void RegisterStStartPoint(DatabaseInstance &db);
 
+	// ST_TileEnvelope
+	static void RegisterStTileEnvelope(DatabaseInstance &db);
+
+	// ST_Triangulate, ST_TriangulateIndices
+	static void RegisterStTriangulate(DatabaseInstance &db);
+
 	// ST_X
 	static void RegisterStX(DatabaseInstance &db);
 
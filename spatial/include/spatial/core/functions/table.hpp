@@ -9,17 +9,35 @@ struct CoreTableFunctions {
 public:
 	static void Register(DatabaseInstance &db) {
 		RegisterOsmTableFunction(db);
+		RegisterArenaMetricsTableFunction(db);
+		RegisterSpatialMemoryTableFunction(db);
+		RegisterProfilingMetricsTableFunction(db);
+		RegisterInitProfileTableFunction(db);
+		RegisterDumpTableFunctions(db);
+		RegisterShortestPathDistanceTableFunction(db);
+		RegisterCachedTileTableFunction(db);
 
 		// TODO: Move these
 		RegisterShapefileTableFunction(db);
 		RegisterShapefileMetaTableFunction(db);
+		RegisterFlatGeobufTableFunction(db);
+		RegisterGeoJSONTableFunction(db);
 		RegisterTestTableFunctions(db);
 	}
 
 private:
 	static void RegisterOsmTableFunction(DatabaseInstance &db);
+	static void RegisterArenaMetricsTableFunction(DatabaseInstance &db);
+	static void RegisterSpatialMemoryTableFunction(DatabaseInstance &db);
+	static void RegisterProfilingMetricsTableFunction(DatabaseInstance &db);
+	static void RegisterInitProfileTableFunction(DatabaseInstance &db);
+	static void RegisterDumpTableFunctions(DatabaseInstance &db);
+	static void RegisterShortestPathDistanceTableFunction(DatabaseInstance &db);
+	static void RegisterCachedTileTableFunction(DatabaseInstance &db);
 	static void RegisterShapefileTableFunction(DatabaseInstance &db);
 	static void RegisterShapefileMetaTableFunction(DatabaseInstance &db);
+	static void RegisterFlatGeobufTableFunction(DatabaseInstance &db);
+	static void RegisterGeoJSONTableFunction(DatabaseInstance &db);
 	static void RegisterTestTableFunctions(DatabaseInstance &db);
 };
 
@@ -0,0 +1,24 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+
+namespace spatial {
+
+namespace core {
+
+// The centroid and the interior point of a serialized geometry, computed in a pass over its vertices with the same
+// algorithms and dimension rules as GEOS. Z and M values are ignored.
+struct Centroid {
+	// The area weighted centroid of the polygons. Without any area, the length weighted centroid of the lines and the
+	// polygon rings, and without any length the average of the points. Returns false if the geometry is empty.
+	static bool TryGetCentroid(const geometry_t &geom, VertexXY &centroid);
+
+	// A point in the interior of the polygons, at the middle of the widest section of a horizontal line through the
+	// polygon where it is widest. Returns false if the geometry has no (multi)polygons, in which case the interior
+	// point is on the lines or points instead. Otherwise the point is empty if all the polygons are.
+	static bool TryGetInteriorPoint(const geometry_t &geom, VertexXY &point, bool &is_empty);
+};
+
+} // namespace core
+
+} // namespace spatial
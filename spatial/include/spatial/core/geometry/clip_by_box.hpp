@@ -0,0 +1,58 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry_processor.hpp"
+#include "spatial/core/geometry/geometry_writer.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// BoxClipper
+//------------------------------------------------------------------------------
+// Clips a serialized geometry to a rectangle, boundary included. Points outside of the rectangle are dropped, lines
+// are cut with Liang-Barsky and the rings of polygons with Sutherland-Hodgman, interpolating Z and M at the new
+// vertices. This is fast but not robust in the way an overlay is: a polygon that leaves and enters the rectangle
+// again is not split, its parts stay connected by edges along the boundary, so the result may be invalid.
+//
+// Geometries whose bounding box is inside the rectangle are returned as they are, and geometries whose bounding box
+// is outside of it become an empty geometry of the same type, both without reading their vertices. A LINESTRING that
+// is cut into several pieces becomes a MULTILINESTRING. Pieces of lines that only touch the rectangle in a point, and
+// rings that collapse, are dropped, as are polygons whose shell is dropped. The result is written straight into the
+// serialized format.
+class BoxClipper final : GeometryProcessor<uint32_t> {
+public:
+	struct ClipVertex {
+		double x;
+		double y;
+		double z;
+		double m;
+	};
+
+	geometry_t Execute(const geometry_t &geom, const BoundingBox &box, GeometryWriter &writer, Vector &result);
+
+private:
+	GeometryWriter *writer = nullptr;
+	BoundingBox box;
+	// The clipped vertices, and where each piece of a line or each ring of a polygon ends in them
+	vector<ClipVertex> vertices;
+	vector<uint32_t> ends;
+	// Scratch space for clipping a ring
+	vector<ClipVertex> ring_in;
+	vector<ClipVertex> ring_out;
+
+	// Append the pieces of a line that are inside the box
+	void ClipLine(const VertexData &data);
+	// Append a ring clipped to the box, returns false if it collapses
+	bool ClipRing(const VertexData &data);
+	void WriteVertices(uint32_t begin, uint32_t end);
+
+	uint32_t ProcessPoint(const VertexData &data) override;
+	uint32_t ProcessLineString(const VertexData &data) override;
+	uint32_t ProcessPolygon(PolygonState &state) override;
+	uint32_t ProcessCollection(CollectionState &state) override;
+};
+
+} // namespace core
+
+} // namespace spatial
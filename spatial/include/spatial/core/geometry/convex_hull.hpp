@@ -0,0 +1,28 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+
+namespace spatial {
+
+namespace core {
+
+// Planar convex hulls of point sets, with Andrew's monotone chain algorithm. Z and M values are ignored.
+struct ConvexHull {
+	// Append the X and Y coordinates of the vertices of a serialized geometry that can be on its hull, i.e. all of them
+	// except the vertices of polygon holes
+	static void AppendVertices(const geometry_t &geom, vector<VertexXY> &points);
+
+	// Reduce the points to the vertices of their convex hull in counter-clockwise order, without repeating the first
+	// vertex. Duplicate and collinear points are removed.
+	static void Reduce(vector<VertexXY> &points);
+
+	// Serialize the vertices of a hull the way GEOS returns a convex hull: a GEOMETRYCOLLECTION EMPTY without any
+	// vertices, a POINT for one, a LINESTRING for two and otherwise a POLYGON with a clockwise shell, starting at the
+	// lowest (then leftmost) vertex
+	static geometry_t Serialize(GeometryFactory &factory, Vector &result, const vector<VertexXY> &hull);
+};
+
+} // namespace core
+
+} // namespace spatial
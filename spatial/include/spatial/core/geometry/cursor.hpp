@@ -61,6 +61,14 @@ public:
 		ptr += sizeof(T);
 	}
 
+	void WriteBytes(const_data_ptr_t data, uint32_t size) {
+		if (ptr + size > end) {
+			throw SerializationException("Trying to write past end of buffer");
+		}
+		memcpy(ptr, data, size);
+		ptr += size;
+	}
+
 	template <class T>
 	T Peek() {
 		static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
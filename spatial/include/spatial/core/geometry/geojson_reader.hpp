@@ -0,0 +1,59 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+
+#include "yyjson.h"
+
+namespace spatial {
+
+namespace core {
+
+class GeometryFactory;
+
+// Lets yyjson allocate its documents from an arena, so that they are all freed at once when the arena is reset
+class JSONAllocator {
+	// Stolen from the JSON extension :)
+public:
+	explicit JSONAllocator(ArenaAllocator &allocator)
+	    : allocator(allocator), yyjson_allocator({Allocate, Reallocate, Free, &allocator}) {
+	}
+
+	inline duckdb_yyjson_spatial::yyjson_alc *GetYYJSONAllocator() {
+		return &yyjson_allocator;
+	}
+
+	void Reset() {
+		allocator.Reset();
+	}
+
+private:
+	static inline void *Allocate(void *ctx, size_t size) {
+		auto alloc = (ArenaAllocator *)ctx;
+		return alloc->AllocateAligned(size);
+	}
+
+	static inline void *Reallocate(void *ctx, void *ptr, size_t old_size, size_t size) {
+		auto alloc = (ArenaAllocator *)ctx;
+		return alloc->ReallocateAligned((data_ptr_t)ptr, old_size, size);
+	}
+
+	static inline void Free(void *ctx, void *ptr) {
+		// NOP because ArenaAllocator can't free
+	}
+
+private:
+	ArenaAllocator &allocator;
+	duckdb_yyjson_spatial::yyjson_alc yyjson_allocator;
+};
+
+// Builds geometries from parsed GeoJSON geometry objects
+struct GeoJSONReader {
+	// Read a GeoJSON geometry object, the raw input is only used in error messages. Sets has_z if any vertex has a Z
+	// value, in which case the caller has to give the whole geometry Z values.
+	static Geometry Read(duckdb_yyjson_spatial::yyjson_val *root, GeometryFactory &factory, const string_t &raw,
+	                     bool &has_z);
+};
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,41 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_processor.hpp"
+
+namespace spatial {
+
+namespace core {
+
+// Writes GeoJSON geometry objects straight from the serialized geometry format, without building a JSON document
+// first. M values are ignored as GeoJSON does not support them.
+class GeoJSONWriter final : GeometryProcessor<void, bool> {
+private:
+	string *text = nullptr;
+	uint32_t precision;
+
+	void WriteNumber(double value);
+	void WriteVertex(const VertexData &data, uint32_t idx);
+	void WriteVertices(const VertexData &data);
+
+	void ProcessPoint(const VertexData &data, bool in_typed_collection) override;
+	void ProcessLineString(const VertexData &data, bool in_typed_collection) override;
+	void ProcessPolygon(PolygonState &state, bool in_typed_collection) override;
+	void ProcessCollection(CollectionState &state, bool in_typed_collection) override;
+
+public:
+	// Write coordinates with at most "precision" digits after the decimal point, or in full with the default
+	explicit GeoJSONWriter(uint32_t precision = Utils::MAX_COORD_PRECISION) : precision(precision) {
+	}
+
+	// Append the GeoJSON geometry object of a geometry to the buffer
+	void Write(const geometry_t &geom, string &buffer);
+
+	// Append a number formatted as in GeoJSON coordinates to the buffer, NaN and infinity become null. Numbers are
+	// written in full (the shortest representation that reads back as the same double) unless the precision is lower.
+	static void AppendNumber(string &buffer, double value, uint32_t precision = Utils::MAX_COORD_PRECISION);
+};
+
+} // namespace core
+
+} // namespace spatial
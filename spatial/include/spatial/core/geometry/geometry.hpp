@@ -15,6 +15,18 @@ namespace core {
 //------------------------------------------------------------------------------
 
 struct Utils {
+	// The most digits after the decimal point that coordinates are written with, also the default
+	static constexpr uint32_t MAX_COORD_PRECISION = 15;
+	// The most characters a formatted coordinate takes
+	static constexpr uint32_t MAX_COORD_LENGTH = 25;
+
+	// Format a coordinate into a buffer of at least MAX_COORD_LENGTH characters, returns the number of characters
+	// written. This is the shortest representation that reads back as the same double, unless that needs more than
+	// "precision" digits after the decimal point, in which case it is rounded to that many.
+	static uint32_t format_coord(double d, char *buffer, uint32_t precision = MAX_COORD_PRECISION);
+	// Format a coordinate in place at the end of the buffer
+	static void append_coord(string &buffer, double d, uint32_t precision = MAX_COORD_PRECISION);
+
 	static string format_coord(double d);
 	static string format_coord(double x, double y);
 	static string format_coord(double x, double y, double z);
@@ -64,6 +76,13 @@ struct BoundingBox {
 	bool Intersects(const BoundingBox &other) const {
 		return !(minx > other.maxx || maxx < other.minx || miny > other.maxy || maxy < other.miny);
 	}
+
+	// Squared planar distance between the boxes, a lower bound of the squared distance between anything inside them
+	double DistanceSquared(const BoundingBox &other) const {
+		auto dx = MaxValue(0.0, MaxValue(other.minx - maxx, minx - other.maxx));
+		auto dy = MaxValue(0.0, MaxValue(other.miny - maxy, miny - other.maxy));
+		return dx * dx + dy * dy;
+	}
 };
 
 class Geometry;
@@ -2,6 +2,7 @@
 #include "spatial/common.hpp"
 #include "spatial/core/geometry/vertex_vector.hpp"
 #include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/profiling.hpp"
 
 namespace spatial {
 
@@ -13,6 +14,10 @@ struct BoundingBox;
 struct GeometryFactory {
 public:
 	ArenaAllocator allocator;
+	// Store the bounding box of serialized geometries with double precision
+	bool double_bbox = false;
+	// Hot path counters of the function this factory belongs to
+	SpatialCounters counters;
 
 	explicit GeometryFactory(Allocator &allocator) : allocator(allocator) {
 	}
@@ -21,6 +26,49 @@ public:
 	Geometry Deserialize(const geometry_t &data);
 
 	static bool TryGetSerializedBoundingBox(const geometry_t &data, BoundingBox &bbox);
+	// Skip the header and the bounding box of a serialized geometry, leaving the cursor at the type of the body
+	static GeometryProperties SkipSerializedHeader(Cursor &cursor);
+	// Points have a fixed serialized layout, so they can be written and read without going through a Geometry
+	static constexpr uint32_t SERIALIZED_POINT_2D_SIZE = 32;
+	static geometry_t SerializePoint2D(Vector &result, double x, double y);
+	// Returns false if the geometry is not a non-empty point
+	static bool TryGetSerializedPoint(const geometry_t &data, double &x, double &y);
+	// Copy a serialized geometry with the x and y coordinates swapped, without deserializing it
+	static geometry_t SerializedFlipCoordinates(Vector &result, const geometry_t &data);
+	// Copy a serialized geometry with the Z and M dimensions added or dropped, without deserializing it. Added
+	// dimensions are set to the default values.
+	static geometry_t SerializedSetVertexType(Vector &result, const geometry_t &data, bool has_z, bool has_m,
+	                                          double default_z, double default_m);
+	// Copy a serialized geometry and transform the vertices of the copy in place, without deserializing it. The
+	// function is called for every run of vertices with a pointer to the first vertex, the count and the vertex size
+	// in bytes. The bounding box is recomputed afterwards.
+	static geometry_t SerializedTransformVertices(Vector &result, const geometry_t &data,
+	                                              const std::function<void(data_ptr_t, uint32_t, uint32_t)> &transform);
+	// Copy a serialized geometry with the VALID property set, returns the geometry itself if it is already set
+	static geometry_t SerializedSetValid(Vector &result, const geometry_t &data);
+	// A hash of the type, the Z and M dimensions and the body of a serialized geometry. The rest of the header and the
+	// bounding box are left out, so that the same geometry hashes the same however its header was written.
+	static hash_t SerializedHash(const geometry_t &data);
+	// Whether two serialized geometries have the same type, dimensions and body, ignoring the header the same way
+	static bool SerializedEquals(const geometry_t &left, const geometry_t &right);
+	// Write the bounding box the way it is laid out after the header, if the properties say there is one
+	static void SerializeBoundingBox(Cursor &cursor, const BoundingBox &bbox, GeometryProperties properties);
+
+	// A non-collection part of a serialized geometry, the body points into the blob of the geometry it belongs to
+	struct SerializedPart {
+		GeometryType type;
+		const_data_ptr_t body;
+		uint32_t body_size;
+		uint32_t vertex_count;
+		// The 1-indexed position of the part in the collections around it, stored in a separate vector
+		uint32_t path_offset;
+		uint32_t path_length;
+	};
+	// Find the non-collection parts of a serialized geometry in order, appending their paths to the paths vector. A
+	// geometry that is not a collection is a part of its own with an empty path.
+	static void GetSerializedParts(const geometry_t &data, vector<SerializedPart> &parts, vector<int32_t> &paths);
+	// Copy a part into a geometry of its own with the Z and M of the properties, without deserializing it
+	static geometry_t SerializePart(Vector &result, GeometryProperties properties, const SerializedPart &part);
 
 private:
 	// Serialize
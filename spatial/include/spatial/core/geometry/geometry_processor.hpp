@@ -59,6 +59,15 @@ public:
 		return count == 0;
 	}
 
+	// Get a vertex of the exact vertex type of the data, e.g. within DispatchVertexType
+	template <class V>
+	V GetExact(uint32_t i) const {
+		static_assert(V::IS_VERTEX, "V must be a vertex type");
+		D_ASSERT(stride[0] == sizeof(V));
+		D_ASSERT(i < count);
+		return Load<V>(data[0] + i * sizeof(V));
+	}
+
 	uint32_t ByteSize() const {
 		return count * sizeof(double) * (2 + (stride[2] != 0) + (stride[3] != 0));
 	}
@@ -233,10 +242,7 @@ public:
 		cursor.Skip<uint16_t>();
 		cursor.Skip(4);
 
-		auto dims = 2 + (has_z ? 1 : 0) + (has_m ? 1 : 0);
-		auto has_bbox = geom.GetProperties().HasBBox();
-		auto bbox_size = has_bbox ? dims * 2 * sizeof(float) : 0;
-		cursor.Skip(bbox_size);
+		cursor.Skip(geom.GetProperties().BBoxSize());
 
 		return ReadGeometry(cursor, args...);
 	}
@@ -10,10 +10,13 @@ private:
 	static constexpr const uint8_t Z = 0x01;
 	static constexpr const uint8_t M = 0x02;
 	static constexpr const uint8_t BBOX = 0x04;
+	// The bounding box is stored with double instead of (rounded outwards) single precision
+	static constexpr const uint8_t DOUBLE_BBOX = 0x08;
+	// The geometry is known to be valid, e.g. because it was returned by ST_MakeValid. Unset does not mean invalid.
+	static constexpr const uint8_t VALID = 0x10;
 	// Example of other useful properties:
-	// static constexpr const uint8_t EMPTY = 0x08;
-	// static constexpr const uint8_t GEODETIC = 0x10;
-	// static constexpr const uint8_t SOLID = 0x20;
+	// static constexpr const uint8_t GEODETIC = 0x20;
+	// static constexpr const uint8_t SOLID = 0x40;
 	uint8_t flags = 0;
 
 public:
@@ -29,6 +32,12 @@ public:
 	inline bool HasBBox() const {
 		return (flags & BBOX) != 0;
 	}
+	inline bool HasDoubleBBox() const {
+		return (flags & DOUBLE_BBOX) != 0;
+	}
+	inline bool IsValid() const {
+		return (flags & VALID) != 0;
+	}
 	inline void SetZ(bool value) {
 		flags = value ? (flags | Z) : (flags & ~Z);
 	}
@@ -38,6 +47,21 @@ public:
 	inline void SetBBox(bool value) {
 		flags = value ? (flags | BBOX) : (flags & ~BBOX);
 	}
+	inline void SetDoubleBBox(bool value) {
+		flags = value ? (flags | DOUBLE_BBOX) : (flags & ~DOUBLE_BBOX);
+	}
+	inline void SetValid(bool value) {
+		flags = value ? (flags | VALID) : (flags & ~VALID);
+	}
+
+	// The size of the bounding box stored after the header, in bytes
+	inline uint32_t BBoxSize() const {
+		if (!HasBBox()) {
+			return 0;
+		}
+		auto dims = 2 + (HasZ() ? 1 : 0) + (HasM() ? 1 : 0);
+		return dims * 2 * (HasDoubleBBox() ? sizeof(double) : sizeof(float));
+	}
 };
 
 } // namespace core
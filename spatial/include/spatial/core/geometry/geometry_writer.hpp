@@ -12,43 +12,38 @@ namespace core {
 //------------------------------------------------------------------------------
 // WriteBuffer
 //------------------------------------------------------------------------------
+// A growable buffer that keeps its capacity between geometries, so that writing many geometries only allocates until
+// the largest one fits.
 class WriteBuffer {
-	ArenaAllocator &allocator;
-	data_ptr_t start;
+	unsafe_unique_array<data_t> start;
 	uint32_t size;
 	uint32_t capacity;
 
 public:
-	explicit WriteBuffer(ArenaAllocator &allocator_p) : allocator(allocator_p), start(nullptr), size(0), capacity(0) {
+	WriteBuffer() : size(0), capacity(0) {
 	}
 
-	// Begin the buffer with an initial capacity
-	void Begin(bool has_z, bool has_m) {
-		// The default initial capacity is 32 (+ 16) bytes which is enough to fit a single point geometry
-		auto initial_capacity = 32 + (has_z ? sizeof(double) : 0) + (has_m ? sizeof(double) : 0);
+	// Begin a new geometry, keeping the capacity
+	void Begin() {
 		size = 0;
-		start = allocator.ReallocateAligned(start, capacity, initial_capacity);
-		capacity = initial_capacity;
 	}
 
-	// Shrink the buffer to the current size
-	void End() {
-		start = allocator.ReallocateAligned(start, capacity, size);
-		capacity = size;
-	}
-
-	void AddCapacity(uint32_t capacity_p) {
-		start = allocator.ReallocateAligned(start, capacity, capacity + capacity_p);
-		capacity += capacity_p;
+	void Reserve(uint32_t reserve_size) {
+		if (size + reserve_size <= capacity) {
+			return;
+		}
+		auto new_capacity = MaxValue<uint32_t>(MaxValue<uint32_t>(capacity * 2, size + reserve_size), 64);
+		auto new_start = make_unsafe_uniq_array<data_t>(new_capacity);
+		if (size > 0) {
+			memcpy(new_start.get(), start.get(), size);
+		}
+		start = std::move(new_start);
+		capacity = new_capacity;
 	}
 
 	void Write(const void *data, uint32_t write_size) {
-		if (size + write_size > capacity) {
-			auto new_capacity = capacity * 2;
-			start = allocator.ReallocateAligned(start, capacity, new_capacity);
-			capacity = new_capacity;
-		}
-		memcpy(start + size, data, write_size);
+		Reserve(write_size);
+		memcpy(start.get() + size, data, write_size);
 		size += write_size;
 	}
 
@@ -57,13 +52,13 @@ public:
 		Write(&value, sizeof(T));
 	}
 
-	// Offset has to be less than count
+	// Overwrite a value that has already been written
 	template <class T>
 	void WriteOffset(const T &value, uint32_t offset) {
 		if (offset + sizeof(T) > size) {
 			throw SerializationException("Offset out of bounds");
 		}
-		memcpy(start + offset, &value, sizeof(T));
+		memcpy(start.get() + offset, &value, sizeof(T));
 	}
 	uint32_t Size() const {
 		return size;
@@ -72,7 +67,7 @@ public:
 		return capacity;
 	}
 	data_ptr_t GetPtr() const {
-		return start;
+		return start.get();
 	}
 };
 
@@ -81,134 +76,136 @@ public:
 //------------------------------------------------------------------------------
 struct GeometryStats {
 	uint32_t vertex_count = 0;
-	double min_x = std::numeric_limits<double>::max();
-	double min_y = std::numeric_limits<double>::max();
-	double max_x = std::numeric_limits<double>::lowest();
-	double max_y = std::numeric_limits<double>::lowest();
+	BoundingBox bbox;
 
 	void Reset() {
 		vertex_count = 0;
-		min_x = std::numeric_limits<double>::max();
-		min_y = std::numeric_limits<double>::max();
-		max_x = std::numeric_limits<double>::lowest();
-		max_y = std::numeric_limits<double>::lowest();
+		bbox = BoundingBox();
 	}
 
 	void Update(double x, double y) {
 		vertex_count++;
-		min_x = std::min(min_x, x);
-		min_y = std::min(min_y, y);
-		max_x = std::max(max_x, x);
-		max_y = std::max(max_y, y);
+		bbox.minx = std::min(bbox.minx, x);
+		bbox.miny = std::min(bbox.miny, y);
+		bbox.maxx = std::max(bbox.maxx, x);
+		bbox.maxy = std::max(bbox.maxy, y);
+	}
+
+	void UpdateZ(double z) {
+		bbox.minz = std::min(bbox.minz, z);
+		bbox.maxz = std::max(bbox.maxz, z);
+	}
+
+	void UpdateM(double m) {
+		bbox.minm = std::min(bbox.minm, m);
+		bbox.maxm = std::max(bbox.maxm, m);
 	}
 };
 
+// Writes a geometry in the serialized format in a single pass, without building a Geometry first. The body is written
+// into a buffer that is reused between geometries while the bounding box is tracked, and End() copies it behind the
+// header and the bounding box into the result vector. The structure is written top down, e.g. a MULTIPOLYGON with two
+// polygons of one ring each:
+//
+//   writer.Begin(GeometryType::MULTIPOLYGON, false, false);
+//   writer.AddCollection(GeometryType::MULTIPOLYGON, 2);
+//   writer.AddPolygon(1);
+//   writer.AddRing(4);
+//   writer.AddVertex(0, 0); ...
+//   writer.AddPolygon(1);
+//   ...
+//   auto blob = writer.End(result);
+//
+// Vertices are written with the Z and M of the writer, dimensions that are missing are set to 0.
 class GeometryWriter {
 private:
 	WriteBuffer buffer;
 	bool has_z = false;
 	bool has_m = false;
-	GeometryType type;
+	GeometryType type = GeometryType::POINT;
 	uint32_t ring_count_offset = 0;
 	GeometryStats stats;
 
+	void CopyVertices(const_data_ptr_t data, uint32_t count, bool in_z, bool in_m);
+
 public:
-	explicit GeometryWriter(ArenaAllocator &allocator_p) : buffer(allocator_p) {
-	}
+	// Store the bounding box with double precision
+	bool double_bbox = false;
 
 	void Begin(GeometryType geom_type, bool has_z_dim, bool has_m_dim) {
+		type = geom_type;
 		has_z = has_z_dim;
 		has_m = has_m_dim;
-		type = geom_type;
-		buffer.Begin(has_z, has_m);
-
-		buffer.Write<GeometryType>(type);
-		buffer.Write<uint8_t>(0);  // properties
-		buffer.Write<uint16_t>(0); // Hash
-		buffer.Write<uint32_t>(0); // padding
-
-		// We dont write the bbox yet, we will write it at the end, but we reserve space for it
-		if (type != GeometryType::POINT) {
-			buffer.Write(sizeof(float) * 4);
-		}
+		ring_count_offset = 0;
+		stats.Reset();
+		buffer.Begin();
 	}
 
-	string_t End() {
-		// Shrink the buffer to the actual size
-		buffer.End();
-
-		GeometryProperties properties;
-		properties.SetZ(has_z);
-		properties.SetM(has_m);
-		properties.SetBBox(false);
-		if (stats.vertex_count > 0 && type != GeometryType::POINT) {
-			properties.SetBBox(true);
-		}
-
-		// Write the properties at the beginning of the buffer (after geometry type)
-		buffer.WriteOffset(properties, 1);
-
-		if (properties.HasBBox()) {
-			// Write the bbox after the first 8 bytes
-			buffer.WriteOffset<float>(Utils::DoubleToFloatDown(stats.min_x), 8);
-			buffer.WriteOffset<float>(Utils::DoubleToFloatDown(stats.min_y), 12);
-			buffer.WriteOffset<float>(Utils::DoubleToFloatUp(stats.max_x), 16);
-			buffer.WriteOffset<float>(Utils::DoubleToFloatUp(stats.max_y), 20);
-			string_t blob = string_t {const_char_ptr_cast(buffer.GetPtr()), buffer.Size()};
-			return blob;
-		} else {
-			// Move the header forwards by 16 bytes
-			auto start = buffer.GetPtr();
-			std::memmove(start + 16, start, buffer.Size() - 16);
-			string_t blob = string_t {const_char_ptr_cast(start), buffer.Size()};
-			return blob;
-		}
-	}
+	geometry_t End(Vector &result);
 
 	void AddVertex(double x, double y) {
-		D_ASSERT(!has_z && !has_m);
 		buffer.Write(x);
 		buffer.Write(y);
-
+		if (has_z) {
+			buffer.Write(0.0);
+			stats.UpdateZ(0);
+		}
+		if (has_m) {
+			buffer.Write(0.0);
+			stats.UpdateM(0);
+		}
 		stats.Update(x, y);
 	}
 
-	void AddVertex(double x, double y, double zm) {
-		D_ASSERT(has_z || has_m);
+	void AddVertex(double x, double y, double z, double m) {
 		buffer.Write(x);
 		buffer.Write(y);
-		buffer.Write(zm);
-
+		if (has_z) {
+			buffer.Write(z);
+			stats.UpdateZ(z);
+		}
+		if (has_m) {
+			buffer.Write(m);
+			stats.UpdateM(m);
+		}
 		stats.Update(x, y);
 	}
 
-	void AddVertex(double x, double y, double z, double m) {
-		D_ASSERT(has_z && has_m);
-		buffer.Write(x);
-		buffer.Write(y);
-		buffer.Write(z);
-		buffer.Write(m);
-
-		stats.Update(x, y);
+	// Append the vertices of an array, converting them to the Z and M of the writer
+	void AddVertices(const VertexArray &vertices) {
+		auto props = vertices.GetProperties();
+		CopyVertices(vertices.GetData(), vertices.Count(), props.HasZ(), props.HasM());
 	}
 
-	void AddPoint(bool is_empty) {
+	// The Add functions write the type and the count of an item and return its offset, so that the count can be set
+	// later with SetCount() when it is not known up front
+	uint32_t AddPoint(bool is_empty) {
+		auto offset = buffer.Size();
 		buffer.Write<uint32_t>(static_cast<uint32_t>(GeometryType::POINT));
 		buffer.Write<uint32_t>(is_empty ? 0 : 1);
+		return offset;
 	}
 
-	void AddLineString(uint32_t vertex_count) {
+	uint32_t AddLineString(uint32_t vertex_count) {
+		auto offset = buffer.Size();
 		buffer.Write<uint32_t>(static_cast<uint32_t>(GeometryType::LINESTRING));
 		buffer.Write<uint32_t>(vertex_count);
+		return offset;
 	}
 
-	void AddPolygon(uint32_t ring_count) {
+	// The ring counts are written by AddRing(), in order, before the vertices of each ring
+	uint32_t AddPolygon(uint32_t ring_count) {
+		auto offset = buffer.Size();
 		buffer.Write<uint32_t>(static_cast<uint32_t>(GeometryType::POLYGON));
 		buffer.Write<uint32_t>(ring_count);
 		ring_count_offset = buffer.Size();
-		for (auto i = 0; i < ring_count; i++) {
+		for (uint32_t i = 0; i < ring_count; i++) {
 			buffer.Write<uint32_t>(0);
 		}
+		if (ring_count % 2 == 1) {
+			buffer.Write<uint32_t>(0); // padding
+		}
+		return offset;
 	}
 
 	void AddRing(uint32_t vertex_count) {
@@ -216,12 +213,21 @@ public:
 		ring_count_offset += sizeof(uint32_t);
 	}
 
-	void AddCollection(GeometryType collection_type, uint32_t item_count) {
+	uint32_t AddCollection(GeometryType collection_type, uint32_t item_count) {
+		auto offset = buffer.Size();
 		buffer.Write<uint32_t>(static_cast<uint32_t>(collection_type));
 		buffer.Write<uint32_t>(item_count);
+		return offset;
+	}
+
+	void SetCount(uint32_t offset, uint32_t count) {
+		buffer.WriteOffset(count, offset + sizeof(uint32_t));
 	}
+
+	// Append a whole geometry as an item, converting it to the Z and M of the writer
+	void AddGeometry(const Geometry &geometry);
 };
 
 } // namespace core
 
-} // namespace spatial
\ No newline at end of file
+} // namespace spatial
@@ -0,0 +1,22 @@
+#pragma once
+#include "spatial/common.hpp"
+
+namespace spatial {
+
+namespace core {
+
+// Hex encoding and decoding of binary blobs such as (E)WKB, with a lookup table per byte instead of a branch per
+// nibble. Both loops are branch-free per byte, invalid characters are collected into a flag that is checked once.
+struct HexCodec {
+	// Write 2 * size uppercase hex characters. The input may overlap the second half of the output, so a blob can be
+	// written there and then expanded in place.
+	static void Encode(const_data_ptr_t input, idx_t size, char *output);
+
+	// Read 2 * size hex characters (upper- or lowercase) into size bytes. Returns false if any character is invalid,
+	// the output is then undefined.
+	static bool Decode(const char *input, idx_t size, data_ptr_t output);
+};
+
+} // namespace core
+
+} // namespace spatial
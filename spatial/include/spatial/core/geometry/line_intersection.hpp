@@ -0,0 +1,26 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+
+namespace spatial {
+
+namespace core {
+
+// Intersection tests between LINESTRING and MULTILINESTRING geometries that run directly on the serialized geometry
+// format. The segments of both lines are swept from left to right so that only the segments whose x ranges overlap
+// are compared, using the same orientation test as the point-in-polygon kernel. Geometries of any other type,
+// collections and lines without length are left to GEOS.
+struct LineIntersection {
+	// Whether two (multi)linestrings intersect, stops at the first intersecting pair of segments. Returns false if
+	// the pair is not supported.
+	static bool TryIntersects(const geometry_t &left, const geometry_t &right, bool &result);
+
+	// Whether two (multi)linestrings cross, i.e. their interiors intersect in points only. The boundary of a line is
+	// its end points, with the end points that are shared by an even number of lines removed (the "Mod-2" rule of
+	// GEOS). Stops at the first overlapping pair of segments. Returns false if the pair is not supported.
+	static bool TryCrosses(const geometry_t &left, const geometry_t &right, bool &result);
+};
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,58 @@
+#pragma once
+#include "spatial/common.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// LinearReference
+//------------------------------------------------------------------------------
+// A copy of the vertices of a linestring with the planar length from the start to every vertex, for locating points
+// along it. Finding a point at a given distance is then a binary search instead of a walk over the segments.
+// The vertices are interleaved with all their dimensions, which are interpolated together, but the lengths are
+// measured in x and y only.
+// A local state keeps the last line loaded, so that a constant line (or the same line on consecutive rows) is only
+// measured once: loading checks if the vertices are the same before copying and measuring them again.
+class LinearReference {
+public:
+	// Load the interleaved vertices of a serialized geometry, returns false if they were already loaded
+	bool Load(const_data_ptr_t vertices, uint32_t count, uint32_t dimensions);
+	// Load the separate x and y arrays of a LINESTRING_2D, returns false if they were already loaded
+	bool Load(const double *xs, const double *ys, uint32_t count);
+
+	uint32_t Count() const {
+		return static_cast<uint32_t>(cumulative.size());
+	}
+	uint32_t Dimensions() const {
+		return dimensions;
+	}
+	double Length() const {
+		return cumulative.empty() ? 0 : cumulative.back();
+	}
+	const double *Vertex(uint32_t i) const {
+		return &coords[i * dimensions];
+	}
+
+	// Write the point at a distance along the line (clamped to the line) to out, which holds a value per dimension
+	void Interpolate(double distance, double *out) const;
+	// The distance along the line to the point on the line closest to (x, y), the first one if there are several
+	double Locate(double x, double y) const;
+	// Append the vertices of the part of the line between two distances along it to out, interleaved like the
+	// vertices of the line. The part has at least two vertices, which are the same if start == end.
+	void Substring(double start, double end, vector<double> &out) const;
+
+private:
+	uint32_t dimensions = 2;
+	vector<double> coords;
+	// The distance along the line to every vertex
+	vector<double> cumulative;
+
+	void Measure();
+	// The segment that a distance along the line falls in
+	uint32_t FindSegment(double distance) const;
+};
+
+} // namespace core
+
+} // namespace spatial
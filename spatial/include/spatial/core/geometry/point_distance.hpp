@@ -0,0 +1,104 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+
+namespace spatial {
+
+namespace core {
+
+// Planar distance from a point to other geometries, computed directly on the serialized geometry format
+struct PointDistance {
+	// Squared distance from the point (px, py) to the segment (ax, ay) -> (bx, by)
+	static double ToSegmentSquared(double px, double py, double ax, double ay, double bx, double by) {
+		auto dx = bx - ax;
+		auto dy = by - ay;
+		// If the segment is a vertex, then measure to that vertex
+		auto len_sq = dx * dx + dy * dy;
+		auto r = len_sq == 0 ? 0 : ((px - ax) * dx + (py - ay) * dy) / len_sq;
+		// Clamp the projection onto the segment
+		double cx;
+		double cy;
+		if (r <= 0) {
+			cx = ax;
+			cy = ay;
+		} else if (r >= 1) {
+			cx = bx;
+			cy = by;
+		} else {
+			cx = ax + r * dx;
+			cy = ay + r * dy;
+		}
+		return (px - cx) * (px - cx) + (py - cy) * (py - cy);
+	}
+
+	// Same as ToSegmentSquared, with selects instead of branches so that it can be evaluated for several segments at
+	// once. A degenerate segment divides by zero, but the result is discarded by the selects.
+	static inline double ToSegmentSquaredBranchless(double px, double py, double ax, double ay, double bx, double by,
+	                                                double dx, double dy, double len_sq) {
+		auto r = ((px - ax) * dx + (py - ay) * dy) / len_sq;
+		r = len_sq == 0 ? 0 : r;
+		auto cx = r <= 0 ? ax : (r >= 1 ? bx : ax + r * dx);
+		auto cy = r <= 0 ? ay : (r >= 1 ? by : ay + r * dy);
+		return (px - cx) * (px - cx) + (py - cy) * (py - cy);
+	}
+
+	// Minimum squared distance from the point (px, py) to the segments between consecutive vertices of the x and y
+	// arrays, or the largest double if there are less than two vertices. The segments are processed in blocks of
+	// SEGMENT_BLOCK with one accumulator per lane and no branches, which compilers vectorize for the baseline
+	// instruction set (SSE2 or NEON) and wider when targeting AVX2 or AVX-512.
+	static constexpr idx_t SEGMENT_BLOCK = 8;
+
+	static double ToSegmentsSquaredMin(double px, double py, const double *xs, const double *ys, idx_t vertex_count) {
+		if (vertex_count < 2) {
+			return std::numeric_limits<double>::max();
+		}
+		auto segment_count = vertex_count - 1;
+
+		double lane_min[SEGMENT_BLOCK];
+		for (idx_t l = 0; l < SEGMENT_BLOCK; l++) {
+			lane_min[l] = std::numeric_limits<double>::max();
+		}
+
+		idx_t i = 0;
+		for (; i + SEGMENT_BLOCK <= segment_count; i += SEGMENT_BLOCK) {
+			for (idx_t l = 0; l < SEGMENT_BLOCK; l++) {
+				auto ax = xs[i + l];
+				auto ay = ys[i + l];
+				auto bx = xs[i + l + 1];
+				auto by = ys[i + l + 1];
+				auto dx = bx - ax;
+				auto dy = by - ay;
+				auto distance = ToSegmentSquaredBranchless(px, py, ax, ay, bx, by, dx, dy, dx * dx + dy * dy);
+				lane_min[l] = distance < lane_min[l] ? distance : lane_min[l];
+			}
+			// The point touches the line, no segment can be closer
+			if (MinOf(lane_min) == 0) {
+				return 0;
+			}
+		}
+
+		auto result = MinOf(lane_min);
+		for (; i < segment_count; i++) {
+			auto distance = ToSegmentSquared(px, py, xs[i], ys[i], xs[i + 1], ys[i + 1]);
+			result = distance < result ? distance : result;
+		}
+		return result;
+	}
+
+	// Distance between a non-empty point and a non-empty point, (multi)linestring or (multi)polygon, in either
+	// argument order. Returns false for any other pair, e.g. geometry collections or empty geometries.
+	static bool TryCompute(const geometry_t &left, const geometry_t &right, double &distance);
+
+private:
+	static inline double MinOf(const double (&lanes)[SEGMENT_BLOCK]) {
+		auto result = lanes[0];
+		for (idx_t l = 1; l < SEGMENT_BLOCK; l++) {
+			result = lanes[l] < result ? lanes[l] : result;
+		}
+		return result;
+	}
+};
+
+} // namespace core
+
+} // namespace spatial
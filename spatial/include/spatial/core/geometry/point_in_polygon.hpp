@@ -0,0 +1,62 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+
+namespace spatial {
+
+namespace core {
+
+// The location of a point relative to an areal geometry. The values are bit flags so that predicates can be
+// expressed as a mask of the locations for which they hold.
+enum class PointLocation : uint8_t { EXTERIOR = 1, BOUNDARY = 2, INTERIOR = 4 };
+
+// Point-in-polygon tests that run directly on the serialized geometry format, for POINT against POLYGON or
+// MULTIPOLYGON. Uses the same ray crossing algorithm as GEOS, so points on the boundary (including the boundary of
+// holes) are classified the same way.
+struct PointInPolygon {
+	// Get the coordinates of a non-empty POINT, returns false for any other geometry
+	static bool TryGetPoint(const geometry_t &geom, double &x, double &y);
+
+	// Locate a point relative to a (multi)polygon by scanning all of its rings, after checking the bounding box in
+	// the header. Returns false if the arguments are not a non-empty point and a polygon or multipolygon.
+	static bool TryLocate(const geometry_t &point, const geometry_t &polygon, PointLocation &location);
+};
+
+// A (multi)polygon with its edges bucketed into horizontal strips, so that locating a point only has to look at the
+// edges crossing its strip. Worth building when the same polygon is tested against many points, e.g. when one side
+// of a predicate is constant.
+class PreparedPolygon {
+private:
+	struct Edge {
+		double x1;
+		double y1;
+		double x2;
+		double y2;
+	};
+
+	BoundingBox bbox;
+	vector<Edge> edges;
+	double strip_height = 0;
+	// Edges of strip i are strip_edges[strip_offsets[i]] .. strip_edges[strip_offsets[i + 1]]
+	vector<uint32_t> strip_offsets;
+	vector<uint32_t> strip_edges;
+
+	void BuildIndex();
+	static unique_ptr<PreparedPolygon> TryCreate(const vector<std::array<double, 4>> &raw_edges);
+
+public:
+	// Returns nullptr if the geometry is not a non-empty polygon or multipolygon
+	static unique_ptr<PreparedPolygon> TryCreate(const geometry_t &polygon);
+	// Same for a POLYGON_2D, whose rings are slices of the x and y arrays
+	static unique_ptr<PreparedPolygon> TryCreate(const list_entry_t *rings, idx_t ring_count, const double *x_data,
+	                                             const double *y_data);
+
+	const BoundingBox &GetBoundingBox() const {
+		return bbox;
+	}
+	PointLocation Locate(double x, double y) const;
+};
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,85 @@
+#pragma once
+#include "spatial/common.hpp"
+
+#include <cmath>
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Predicates
+//------------------------------------------------------------------------------
+// Robust geometric predicates in the style of Shewchuk's "Adaptive Precision Floating-Point Arithmetic and Fast
+// Robust Geometric Predicates". The determinant is first computed in double precision, and its sign is returned if it
+// is larger than a bound on the rounding error. Only when it is not, which takes (nearly) degenerate input, is it
+// recomputed exactly with floating-point expansions. The results are therefore exact for any finite input, so that
+// native kernels agree with GEOS on collinear and cocircular points instead of rounding either way.
+//
+// The filter is inline and branch free, so loops over many points vectorize, and the batch version below only leaves
+// the uncertain results for the exact path.
+struct Predicates {
+	// Orientation of c relative to the directed line a -> b: 1 if c is to the left (a -> b -> c turns
+	// counter-clockwise), -1 if it is to the right and 0 if the three points are collinear.
+	static inline int Orient2D(double ax, double ay, double bx, double by, double cx, double cy) {
+		auto det_left = (ax - cx) * (by - cy);
+		auto det_right = (ay - cy) * (bx - cx);
+		auto det = det_left - det_right;
+		auto err_bound = ORIENT_ERROR_BOUND * (std::fabs(det_left) + std::fabs(det_right));
+		if (det > err_bound || -det > err_bound) {
+			return det > 0 ? 1 : -1;
+		}
+		return Orient2DExact(ax, ay, bx, by, cx, cy);
+	}
+
+	// Location of d relative to the circle through a, b and c, which must be in counter-clockwise order: 1 if d is
+	// inside, -1 if it is outside and 0 if the four points are cocircular. The signs flip if a, b, c are clockwise.
+	static inline int InCircle(double ax, double ay, double bx, double by, double cx, double cy, double dx,
+	                           double dy) {
+		auto adx = ax - dx;
+		auto ady = ay - dy;
+		auto bdx = bx - dx;
+		auto bdy = by - dy;
+		auto cdx = cx - dx;
+		auto cdy = cy - dy;
+
+		auto bdxcdy = bdx * cdy;
+		auto cdxbdy = cdx * bdy;
+		auto alift = adx * adx + ady * ady;
+		auto cdxady = cdx * ady;
+		auto adxcdy = adx * cdy;
+		auto blift = bdx * bdx + bdy * bdy;
+		auto adxbdy = adx * bdy;
+		auto bdxady = bdx * ady;
+		auto clift = cdx * cdx + cdy * cdy;
+
+		auto det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+		auto permanent = (std::fabs(bdxcdy) + std::fabs(cdxbdy)) * alift +
+		                 (std::fabs(cdxady) + std::fabs(adxcdy)) * blift +
+		                 (std::fabs(adxbdy) + std::fabs(bdxady)) * clift;
+		auto err_bound = INCIRCLE_ERROR_BOUND * permanent;
+		if (det > err_bound || -det > err_bound) {
+			return det > 0 ? 1 : -1;
+		}
+		return InCircleExact(ax, ay, bx, by, cx, cy, dx, dy);
+	}
+
+	// Orient2D for count triples of points given as separate coordinate arrays. The filter runs over all of them
+	// first, and only the ones it can not decide are recomputed exactly.
+	static void Orient2D(const double *ax, const double *ay, const double *bx, const double *by, const double *cx,
+	                     const double *cy, int8_t *result, idx_t count);
+
+	// The sign of the determinants computed with exact arithmetic, without the filter
+	static int Orient2DExact(double ax, double ay, double bx, double by, double cx, double cy);
+	static int InCircleExact(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy);
+
+private:
+	// The error bounds of the double precision determinants from Shewchuk's paper, where epsilon is 2^-53
+	static constexpr double EPSILON = 1.1102230246251565e-16;
+	static constexpr double ORIENT_ERROR_BOUND = (3.0 + 16.0 * EPSILON) * EPSILON;
+	static constexpr double INCIRCLE_ERROR_BOUND = (10.0 + 96.0 * EPSILON) * EPSILON;
+};
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,50 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/point_in_polygon.hpp"
+
+namespace spatial {
+
+namespace core {
+
+// The GEOMETRY_Q format stores the X and Y coordinates of a geometry as 32 bit integers on a grid, relative to an
+// origin of its own, which takes half the space of the doubles of GEOMETRY. The layout is:
+//
+//   uint8 type, uint8 flags, uint16 + uint32 padding
+//   double origin_x, double origin_y, double grid_size
+//   int32 min_x, min_y, max_x, max_y    the bounding box on the grid, if the BOUNDING_BOX flag is set
+//   body
+//
+// where the origin is a position on the grid and a coordinate is (origin + value) * grid_size. The body of a POINT
+// and a LINESTRING is a uint32 vertex count followed by the vertices as pairs of int32, a POLYGON is a uint32 ring
+// count followed by the rings, and a MULTI geometry or GEOMETRYCOLLECTION is a uint32 item count followed by the
+// items, each a uint32 type and a body.
+struct QuantizedGeometry {
+	static constexpr uint32_t HEADER_SIZE = 32;
+	static constexpr uint8_t BOUNDING_BOX_FLAG = 1;
+
+	// The finest grid size used when none is given, coarser grids are only chosen when the geometry is too large
+	static constexpr int32_t MIN_AUTO_GRID_EXPONENT = -9;
+
+	// Quantize a geometry to the given grid size, or to the finest power of ten that fits its extent if the grid size
+	// is 0. Throws if the geometry has Z or M values, or if it does not fit in 32 bit integers at the grid size.
+	static void Quantize(const geometry_t &geometry, double grid_size, vector<data_t> &buffer);
+	static string_t Quantize(const geometry_t &geometry, double grid_size, Vector &result);
+
+	// Convert a GEOMETRY_Q back to a geometry
+	static Geometry Dequantize(ArenaAllocator &arena, const string_t &blob);
+
+	// Read the bounding box from the header, returns false for empty geometries
+	static bool TryGetBoundingBox(const string_t &blob, BoundingBox &bbox);
+
+	// Distance from a point to the geometry, measured on the integers. Returns false for empty geometries.
+	static bool TryGetDistanceToPoint(const string_t &blob, double x, double y, double &distance);
+
+	// Locate a point relative to a POLYGON or MULTIPOLYGON, measured on the integers. Returns false for any other
+	// geometry type, empty polygons do not contain any point.
+	static bool TryLocatePoint(const string_t &blob, double x, double y, PointLocation &location);
+};
+
+} // namespace core
+
+} // namespace spatial
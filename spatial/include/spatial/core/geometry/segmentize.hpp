@@ -0,0 +1,67 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry_processor.hpp"
+#include "spatial/core/geometry/geometry_writer.hpp"
+#include "spatial/core/geometry/vertex_vector.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Segmentizer
+//------------------------------------------------------------------------------
+// Densifies a serialized geometry so that none of its segments are longer than a maximum length, by splitting every
+// longer segment into equal pieces. The result is written straight into the serialized format: the pieces of every
+// segment of a linestring (or of all the rings of a polygon) are counted in a first pass, so that the vertex counts
+// can be written before the vertices are interpolated in a second pass. Points are copied as they are.
+// Subclasses define how segments are measured and split, e.g. in the plane or along the geodesic on a spheroid.
+class Segmentizer : GeometryProcessor<void> {
+public:
+	explicit Segmentizer(const char *function_name) : function_name(function_name) {
+	}
+	virtual ~Segmentizer() = default;
+
+	geometry_t Execute(const geometry_t &geom, GeometryWriter &writer, Vector &result);
+
+protected:
+	// The number of pieces to split the segment from a to b into, at least 1
+	virtual double CountPieces(const VertexXYZM &a, const VertexXYZM &b) = 0;
+	// Write the vertices between a and b that split the segment into the given number of pieces (more than 1)
+	virtual void WritePieces(const VertexXYZM &a, const VertexXYZM &b, uint32_t pieces, GeometryWriter &writer) = 0;
+
+private:
+	const char *function_name;
+	GeometryWriter *writer = nullptr;
+	// The pieces of every segment of the vertices being written, from the first pass
+	vector<uint32_t> pieces;
+	vector<VertexData> rings;
+
+	VertexXYZM GetVertex(const VertexData &vertices, uint32_t i) const;
+	// Count the vertices of the densified vertices and append the pieces of their segments
+	uint32_t CountVertices(const VertexData &vertices);
+	// Write the densified vertices, pieces starts at the pieces of their first segment
+	void WriteVertices(const VertexData &vertices, const uint32_t *segment_pieces);
+
+	void ProcessPoint(const VertexData &vertices) override;
+	void ProcessLineString(const VertexData &vertices) override;
+	void ProcessPolygon(PolygonState &state) override;
+	void ProcessCollection(CollectionState &state) override;
+};
+
+// Splits segments by their planar length, interpolating all the dimensions linearly
+class PlanarSegmentizer final : public Segmentizer {
+public:
+	double max_length = 1;
+
+	PlanarSegmentizer() : Segmentizer("ST_Segmentize") {
+	}
+
+protected:
+	double CountPieces(const VertexXYZM &a, const VertexXYZM &b) override;
+	void WritePieces(const VertexXYZM &a, const VertexXYZM &b, uint32_t pieces, GeometryWriter &writer) override;
+};
+
+} // namespace core
+
+} // namespace spatial
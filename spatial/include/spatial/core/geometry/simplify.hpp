@@ -0,0 +1,78 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+
+namespace spatial {
+
+namespace core {
+
+// Per-line simplification of geometries, without any topology checks. Vertices are selected on the vertex arrays as
+// they were deserialized and the kept ones are copied into new arrays in the arena, so unchanged parts of a geometry
+// are never copied twice. The scratch buffers are reused between geometries.
+class GeometrySimplifier {
+public:
+	enum class Method : uint8_t {
+		// Keep the vertices that are further than the tolerance from the simplified line (Douglas-Peucker)
+		DOUGLAS_PEUCKER,
+		// Remove the vertices that span a triangle with an area below the tolerance (Visvalingam-Whyatt)
+		VISVALINGAM_WHYATT
+	};
+
+	GeometrySimplifier(ArenaAllocator &arena, Method method) : arena(arena), method(method) {
+	}
+
+	// Simplify a geometry. Linestrings keep their endpoints, polygon rings that collapse to fewer than 4 vertices are
+	// dropped (a polygon without a shell becomes empty) and parts of collections that become empty are removed.
+	Geometry Simplify(const Geometry &geom, double tolerance);
+
+	// Rank the vertices of the lines and rings of a geometry for Douglas-Peucker simplification at a set of
+	// tolerances in ascending order (at most 255 of them), in a single pass. The rank of a vertex is the number of
+	// the tolerances it is kept at, which are always the smallest ones. The ranks are appended in the order of the
+	// vertices, the vertices of points are not ranked.
+	void Rank(const Geometry &geom, const vector<double> &tolerances, vector<uint8_t> &ranks);
+	// The number of ranks Rank appends for a geometry, i.e. the number of vertices of its lines and rings
+	static idx_t RankCount(const Geometry &geom);
+	// Simplify a geometry by selecting the vertices with at least min_rank from the ranks from Rank. The result is
+	// the same as Simplify with the Douglas-Peucker method at the min_rank-th smallest tolerance.
+	Geometry SimplifyRanked(const Geometry &geom, const uint8_t *ranks, uint8_t min_rank);
+
+private:
+	enum class Pass : uint8_t { SIMPLIFY, RANK, SELECT };
+
+	ArenaAllocator &arena;
+	Method method;
+	Pass pass = Pass::SIMPLIFY;
+	double tolerance = 0;
+
+	// The squared tolerances and the output of Rank, or the ranks being read and the rank to keep of SimplifyRanked
+	vector<double> rank_tolerances_sq;
+	vector<uint8_t> *rank_output = nullptr;
+	const uint8_t *rank_input = nullptr;
+	uint8_t min_rank = 0;
+
+	// Scratch buffers
+	vector<double> x_data;
+	vector<double> y_data;
+	vector<bool> keep;
+	vector<std::pair<uint32_t, uint32_t>> ranges;
+	vector<uint32_t> prev;
+	vector<uint32_t> next;
+	vector<double> areas;
+	vector<double> effective;
+	vector<double> limits;
+
+	void GatherCoordinates(const VertexArray &vertices);
+	void RankVertices(const VertexArray &vertices);
+
+	// Returns an array with at least min_count vertices, or an empty one if the line collapsed below that
+	VertexArray SimplifyVertices(const VertexArray &vertices, uint32_t min_count);
+	uint32_t MarkDouglasPeucker(uint32_t count);
+	uint32_t MarkVisvalingamWhyatt(uint32_t count, uint32_t min_count);
+
+	Polygon SimplifyPolygon(const Polygon &polygon);
+	Geometry SimplifyGeometry(const Geometry &geom);
+};
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,47 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry_processor.hpp"
+#include "spatial/core/geometry/geometry_writer.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// GridSnapper
+//------------------------------------------------------------------------------
+// Snaps the X and Y of every vertex of a serialized geometry to a grid of square cells, and drops the vertices that
+// end up on the same grid point as the vertex before them. Z and M are kept as they are. Lines that collapse to a
+// single point and rings with less than 4 vertices are dropped, as are polygons whose shell is dropped. A dropped
+// geometry at the top level is written as an empty geometry of the same type. The result is written straight into
+// the serialized format, it is not made valid: use ST_ReducePrecision for that.
+class GridSnapper final : GeometryProcessor<bool> {
+public:
+	double grid_size = 1;
+
+	geometry_t Execute(const geometry_t &geom, GeometryWriter &writer, Vector &result);
+
+private:
+	GeometryWriter *writer = nullptr;
+	// The snapped X and Y of the kept vertices, and their index in the input
+	vector<double> x_data;
+	vector<double> y_data;
+	vector<uint32_t> source_index;
+	// The input and the kept vertex count of every ring of a polygon
+	vector<VertexData> rings;
+	vector<uint32_t> ring_counts;
+
+	// Snap the vertices and append the kept ones, returns how many were kept
+	uint32_t SnapVertices(const VertexData &vertices);
+	// Write the kept vertices from the offset on, with the Z and M of their input vertex
+	void WriteVertices(const VertexData &vertices, idx_t offset, uint32_t count);
+
+	bool ProcessPoint(const VertexData &vertices) override;
+	bool ProcessLineString(const VertexData &vertices) override;
+	bool ProcessPolygon(PolygonState &state) override;
+	bool ProcessCollection(CollectionState &state) override;
+};
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,77 @@
+#pragma once
+#include "spatial/common.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Space filling curves
+//------------------------------------------------------------------------------
+// Both curves map a cell on a 2^32 x 2^32 grid to its 64-bit index along the curve.
+
+struct HilbertCurve {
+	static uint64_t Encode(uint32_t x, uint32_t y) {
+		uint64_t d = 0;
+		for (uint64_t s = static_cast<uint64_t>(1) << 31; s > 0; s >>= 1) {
+			uint32_t rx = (x & s) != 0;
+			uint32_t ry = (y & s) != 0;
+			d += s * s * ((3 * rx) ^ ry);
+			// Rotate the quadrant
+			if (ry == 0) {
+				if (rx == 1) {
+					x = ~x;
+					y = ~y;
+				}
+				std::swap(x, y);
+			}
+		}
+		return d;
+	}
+};
+
+struct MortonCurve {
+	// Spread the bits of a 32-bit integer out over the even bits of a 64-bit integer
+	static uint64_t Spread(uint32_t value) {
+		uint64_t x = value;
+		x = (x | (x << 16)) & 0x0000FFFF0000FFFF;
+		x = (x | (x << 8)) & 0x00FF00FF00FF00FF;
+		x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0F;
+		x = (x | (x << 2)) & 0x3333333333333333;
+		x = (x | (x << 1)) & 0x5555555555555555;
+		return x;
+	}
+
+	// Gather the even bits of a 64-bit integer into a 32-bit integer, the inverse of Spread
+	static uint32_t Compact(uint64_t value) {
+		uint64_t x = value & 0x5555555555555555;
+		x = (x | (x >> 1)) & 0x3333333333333333;
+		x = (x | (x >> 2)) & 0x0F0F0F0F0F0F0F0F;
+		x = (x | (x >> 4)) & 0x00FF00FF00FF00FF;
+		x = (x | (x >> 8)) & 0x0000FFFF0000FFFF;
+		x = (x | (x >> 16)) & 0x00000000FFFFFFFF;
+		return static_cast<uint32_t>(x);
+	}
+
+	static uint64_t Encode(uint32_t x, uint32_t y) {
+		return Spread(x) | (Spread(y) << 1);
+	}
+};
+
+struct CurveGrid {
+	// Map a coordinate to its cell along one axis of the bounds, coordinates outside the bounds are clamped
+	static uint32_t GetCell(double value, double min, double max) {
+		if (!(max > min) || !(value > min)) {
+			return 0;
+		}
+		if (value >= max) {
+			return NumericLimits<uint32_t>::Maximum();
+		}
+		return static_cast<uint32_t>((value - min) / (max - min) *
+		                             static_cast<double>(NumericLimits<uint32_t>::Maximum()));
+	}
+};
+
+} // namespace core
+
+} // namespace spatial
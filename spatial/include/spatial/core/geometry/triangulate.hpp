@@ -0,0 +1,86 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry_processor.hpp"
+#include "spatial/core/geometry/geometry_writer.hpp"
+#include "spatial/core/geometry/vertex_vector.hpp"
+
+#include <deque>
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Triangulator
+//------------------------------------------------------------------------------
+// Triangulates the polygons of a serialized geometry by ear clipping, following mapbox/earcut: the holes of a polygon
+// are bridged into its shell, from left to right, so that a single ring is left, whose ears are then cut off one by
+// one. Polygons with more than 80 vertices look up the vertices that could be inside an ear along a z-order curve,
+// instead of checking all of them. The orientation tests are exact (see Predicates), but like earcut this is not a
+// constrained triangulation: invalid polygons still get triangles, just not necessarily ones that cover them exactly.
+//
+// The buffers are kept between geometries, so triangulating a whole vector only allocates until the largest geometry
+// fits. Z and M are ignored.
+class Triangulator final : GeometryProcessor<void> {
+public:
+	// A vertex of the ring that is left to clip, linked to its neighbours along the ring and along the z-order curve
+	struct Node {
+		uint32_t i;
+		double x;
+		double y;
+		Node *prev;
+		Node *next;
+		uint32_t z;
+		Node *prev_z;
+		Node *next_z;
+		// A hole of a single vertex, which is never filtered out
+		bool steiner;
+	};
+
+	// The vertices of all rings without their closing vertex, polygon after polygon and ring after ring
+	vector<VertexXY> vertices;
+	// The indices into vertices of the corners of every triangle, in counter-clockwise order
+	vector<uint32_t> indices;
+
+	// Triangulate all polygons of a geometry, the other parts are ignored
+	void Execute(const geometry_t &geom);
+
+	// Serialize the triangles as a GEOMETRYCOLLECTION of POLYGONs, the way PostGIS returns a triangulation
+	geometry_t Serialize(GeometryWriter &writer, Vector &result) const;
+
+private:
+	// A deque, so that nodes stay in place when bridges add new ones
+	std::deque<Node> nodes;
+	// The leftmost nodes of the holes of the current polygon
+	vector<Node *> holes;
+	vector<Node *> z_order;
+	// The origin and scale of the z-order curve of the current polygon, inv_size is 0 if the curve is not used
+	double min_x = 0;
+	double min_y = 0;
+	double inv_size = 0;
+
+	Node *NewNode(uint32_t i);
+	Node *InsertNode(uint32_t i, Node *last);
+	// Link the vertices in [start, end) into a ring, counter-clockwise for a shell and clockwise for a hole
+	Node *LinkRing(uint32_t start, uint32_t end, bool is_shell);
+	// Link two vertices with a bridge and return the copy of b, which splits a ring into two or merges two into one
+	Node *SplitPolygon(Node *a, Node *b);
+	Node *EliminateHoles(Node *outer);
+
+	uint32_t ZOrder(double x, double y) const;
+	void IndexCurve(Node *start);
+	bool IsEarHashed(const Node *ear) const;
+	void AddTriangle(const Node *a, const Node *b, const Node *c);
+	Node *CureLocalIntersections(Node *start);
+	void SplitEarcut(Node *start);
+	void EarcutLinked(Node *ear, int pass);
+
+	void ProcessPoint(const VertexData &data) override;
+	void ProcessLineString(const VertexData &data) override;
+	void ProcessPolygon(PolygonState &state) override;
+	void ProcessCollection(CollectionState &state) override;
+};
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,55 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+
+namespace spatial {
+
+namespace core {
+
+class TWKBReader {
+private:
+	ArenaAllocator &arena;
+	const_data_ptr_t ptr = nullptr;
+	const_data_ptr_t end = nullptr;
+	bool has_any_z = false;
+	bool has_any_m = false;
+
+	// The header and the running coordinate values of the TWKB geometry being read, coordinates are delta encoded
+	// from the previous vertex of the same geometry
+	struct Encoding {
+		GeometryType type;
+		bool has_z;
+		bool has_m;
+		bool has_id_list;
+		double scale[4];
+		int64_t last[4];
+	};
+
+	// Primitives
+	uint8_t ReadByte();
+	uint64_t ReadVarInt();
+	int64_t ReadSignedVarInt();
+	uint32_t ReadCount();
+	void SkipIdList(const Encoding &encoding, uint32_t count);
+	VertexArray ReadVertices(Encoding &encoding, uint32_t count);
+
+	// Geometries
+	Polygon ReadPolygon(Encoding &encoding);
+	Geometry ReadGeometry();
+
+public:
+	explicit TWKBReader(ArenaAllocator &arena) : arena(arena) {
+	}
+	Geometry Deserialize(const string_t &twkb);
+	Geometry Deserialize(const_data_ptr_t twkb, uint32_t size);
+	bool GeomHasZ() const {
+		return has_any_z;
+	}
+	bool GeomHasM() const {
+		return has_any_m;
+	}
+};
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,30 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+
+namespace spatial {
+
+namespace core {
+
+struct TWKBOptions {
+	// The number of decimal digits kept of every axis, negative to round X and Y to tens, hundreds...
+	int32_t precision_xy = 0;
+	int32_t precision_z = 0;
+	int32_t precision_m = 0;
+	// Whether to prefix every geometry with its size in bytes
+	bool with_sizes = false;
+	// Whether to prefix every geometry with its bounding box
+	bool with_boxes = false;
+};
+
+struct TWKBWriter {
+	// Write a geometry to a TWKB blob attached to a vector
+	static string_t Write(const geometry_t &geometry, Vector &result, const TWKBOptions &options);
+
+	// Write a geometry to a TWKB blob into a buffer
+	static void Write(const geometry_t &geometry, vector<data_t> &buffer, const TWKBOptions &options);
+};
+
+} // namespace core
+
+} // namespace spatial
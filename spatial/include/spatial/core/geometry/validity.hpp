@@ -0,0 +1,19 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+
+namespace spatial {
+
+namespace core {
+
+// Cheap validity checks on serialized geometries, for the cases that do not need any topology
+struct GeometryValidity {
+	// Decide whether a geometry is valid (in the sense of GEOS) from the VALID property or, for geometries without
+	// polygons, from its coordinates alone: all X and Y values have to be finite and every non-empty linestring needs
+	// two distinct vertices. Returns false if GEOS has to decide.
+	static bool TryCheck(const geometry_t &geom, bool &valid);
+};
+
+} // namespace core
+
+} // namespace spatial
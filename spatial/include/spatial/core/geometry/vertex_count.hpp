@@ -0,0 +1,43 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry_processor.hpp"
+
+namespace spatial {
+
+namespace core {
+
+// Counts the vertices of a serialized geometry from the counts in its structure, without reading any coordinates
+class VertexCountProcessor final : GeometryProcessor<uint32_t> {
+	uint32_t ProcessPoint(const VertexData &vertices) override {
+		return vertices.count;
+	}
+
+	uint32_t ProcessLineString(const VertexData &vertices) override {
+		return vertices.count;
+	}
+
+	uint32_t ProcessPolygon(PolygonState &state) override {
+		uint32_t count = 0;
+		while (!state.IsDone()) {
+			count += state.Next().count;
+		}
+		return count;
+	}
+
+	uint32_t ProcessCollection(CollectionState &state) override {
+		uint32_t count = 0;
+		while (!state.IsDone()) {
+			count += state.Next();
+		}
+		return count;
+	}
+
+public:
+	uint32_t Execute(const geometry_t &geometry) {
+		return Process(geometry);
+	}
+};
+
+} // namespace core
+
+} // namespace spatial
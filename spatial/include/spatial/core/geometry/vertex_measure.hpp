@@ -0,0 +1,153 @@
+#pragma once
+#include "spatial/common.hpp"
+
+#include <type_traits>
+
+namespace spatial {
+
+namespace core {
+
+// Planar length and area kernels over coordinate arrays. The loops keep LANES independent accumulators and have no
+// branches, which compilers vectorize for the baseline instruction set (SSE2 or NEON) and wider when targeting AVX2
+// or AVX-512. The per-geometry kernels take byte pointers and strides, so that they work on the separate children of
+// the native nested types as well as on the interleaved, not necessarily aligned, vertices of a serialized geometry.
+// The variants templated on a vertex type take the interleaved vertices with the stride fixed at compile time.
+struct VertexMeasure {
+	static constexpr idx_t LANES = 8;
+
+	template <class V>
+	using VertexStride = std::integral_constant<idx_t, sizeof(V)>;
+
+	// Sum of the values
+	static double Sum(const double *values, idx_t count) {
+		double lanes[LANES] = {0};
+		idx_t i = 0;
+		for (; i + LANES <= count; i += LANES) {
+			for (idx_t l = 0; l < LANES; l++) {
+				lanes[l] += values[i + l];
+			}
+		}
+		auto result = SumOf(lanes);
+		for (; i < count; i++) {
+			result += values[i];
+		}
+		return result;
+	}
+
+	// Sum of the lengths of the segments between consecutive vertices
+	static double Length(const_data_ptr_t xs, const_data_ptr_t ys, idx_t stride, idx_t vertex_count) {
+		return LengthKernel(xs, ys, stride, vertex_count);
+	}
+
+	template <class V>
+	static double Length(const_data_ptr_t vertices, idx_t vertex_count) {
+		return LengthKernel(vertices, vertices + sizeof(double), VertexStride<V>(), vertex_count);
+	}
+
+	// Twice the signed area of a closed ring, with the x coordinates taken relative to the first vertex so that
+	// large coordinates lose less precision
+	static double ShoelaceSum(const_data_ptr_t xs, const_data_ptr_t ys, idx_t stride, idx_t vertex_count) {
+		return ShoelaceKernel(xs, ys, stride, vertex_count);
+	}
+
+	template <class V>
+	static double ShoelaceSum(const_data_ptr_t vertices, idx_t vertex_count) {
+		return ShoelaceKernel(vertices, vertices + sizeof(double), VertexStride<V>(), vertex_count);
+	}
+
+	// Segmented variants for the native nested types: compute a value for every pair of consecutive vertices of the
+	// whole child arrays in one streaming pass, ignoring list boundaries, so that each list only has to Sum its own
+	// slice afterwards. out must hold vertex_count values, the last one is set to 0.
+	static void SegmentLengths(const double *xs, const double *ys, idx_t vertex_count, double *out) {
+		for (idx_t i = 0; i + 1 < vertex_count; i++) {
+			auto dx = xs[i + 1] - xs[i];
+			auto dy = ys[i + 1] - ys[i];
+			out[i] = std::sqrt(dx * dx + dy * dy);
+		}
+		if (vertex_count > 0) {
+			out[vertex_count - 1] = 0;
+		}
+	}
+
+	static void ShoelaceTerms(const double *xs, const double *ys, idx_t vertex_count, double *out) {
+		for (idx_t i = 0; i + 1 < vertex_count; i++) {
+			out[i] = xs[i] * ys[i + 1] - xs[i + 1] * ys[i];
+		}
+		if (vertex_count > 0) {
+			out[vertex_count - 1] = 0;
+		}
+	}
+
+	// Sum of the pair values of a list of vertex_count vertices starting at offset
+	static double SumSegments(const double *pair_values, idx_t offset, idx_t vertex_count) {
+		return vertex_count < 2 ? 0.0 : Sum(pair_values + offset, vertex_count - 1);
+	}
+
+private:
+	template <class STRIDE>
+	static double LengthKernel(const_data_ptr_t xs, const_data_ptr_t ys, STRIDE stride, idx_t vertex_count) {
+		if (vertex_count < 2) {
+			return 0.0;
+		}
+		auto segment_count = vertex_count - 1;
+		double lanes[LANES] = {0};
+		idx_t i = 0;
+		for (; i + LANES <= segment_count; i += LANES) {
+			for (idx_t l = 0; l < LANES; l++) {
+				lanes[l] += SegmentLength(xs, ys, (i + l) * stride, stride);
+			}
+		}
+		auto result = SumOf(lanes);
+		for (; i < segment_count; i++) {
+			result += SegmentLength(xs, ys, i * stride, stride);
+		}
+		return result;
+	}
+
+	template <class STRIDE>
+	static double ShoelaceKernel(const_data_ptr_t xs, const_data_ptr_t ys, STRIDE stride, idx_t vertex_count) {
+		if (vertex_count < 3) {
+			return 0.0;
+		}
+		auto x0 = Load<double>(xs);
+		auto term_count = vertex_count - 2;
+		double lanes[LANES] = {0};
+		idx_t i = 0;
+		for (; i + LANES <= term_count; i += LANES) {
+			for (idx_t l = 0; l < LANES; l++) {
+				lanes[l] += ShoelaceTerm(xs, ys, x0, (i + l + 1) * stride, stride);
+			}
+		}
+		auto result = SumOf(lanes);
+		for (; i < term_count; i++) {
+			result += ShoelaceTerm(xs, ys, x0, (i + 1) * stride, stride);
+		}
+		return result;
+	}
+
+	template <class STRIDE>
+	static inline double SegmentLength(const_data_ptr_t xs, const_data_ptr_t ys, idx_t offset, STRIDE stride) {
+		auto dx = Load<double>(xs + offset + stride) - Load<double>(xs + offset);
+		auto dy = Load<double>(ys + offset + stride) - Load<double>(ys + offset);
+		return std::sqrt(dx * dx + dy * dy);
+	}
+
+	template <class STRIDE>
+	static inline double ShoelaceTerm(const_data_ptr_t xs, const_data_ptr_t ys, double x0, idx_t offset,
+	                                  STRIDE stride) {
+		auto dy = Load<double>(ys + offset - stride) - Load<double>(ys + offset + stride);
+		return (Load<double>(xs + offset) - x0) * dy;
+	}
+
+	static inline double SumOf(const double (&lanes)[LANES]) {
+		auto result = lanes[0];
+		for (idx_t l = 1; l < LANES; l++) {
+			result += lanes[l];
+		}
+		return result;
+	}
+};
+
+} // namespace core
+
+} // namespace spatial
@@ -59,6 +59,24 @@ struct VertexXYZM {
 	double m;
 };
 
+// Call OP::Operation<V> with the vertex type that has the given dimensions. Selecting the type once per geometry
+// instead of branching on the dimensions for every vertex compiles the loops of OP for each layout separately, with
+// a constant vertex size.
+template <class OP, class... ARGS>
+inline auto DispatchVertexType(bool has_z, bool has_m, ARGS &&...args)
+    -> decltype(OP::template Operation<VertexXY>(std::forward<ARGS>(args)...)) {
+	if (has_z && has_m) {
+		return OP::template Operation<VertexXYZM>(std::forward<ARGS>(args)...);
+	}
+	if (has_z) {
+		return OP::template Operation<VertexXYZ>(std::forward<ARGS>(args)...);
+	}
+	if (has_m) {
+		return OP::template Operation<VertexXYM>(std::forward<ARGS>(args)...);
+	}
+	return OP::template Operation<VertexXY>(std::forward<ARGS>(args)...);
+}
+
 // A VertexArray represents a copy-on-write array of potentially non-owned vertex data
 // A VertexArray will never free its data, even if it owns it as it expects to always be used with a ArenaAllocator
 class VertexArray {
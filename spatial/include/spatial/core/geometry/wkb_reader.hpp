@@ -35,11 +35,33 @@ private:
 	GeometryCollection ReadGeometryCollection(Cursor &cursor, bool little_endian);
 	Geometry ReadGeometry(Cursor &cursor);
 
+	// Transcoding
+	struct TranscodeState {
+		// The size of everything but the vertex data in the serialized geometry
+		uint32_t fixed_size = 0;
+		// The total number of vertices in the geometry
+		uint32_t vertex_count = 0;
+		// Whether any vertex contributing to the bounds is missing a Z or M value
+		bool missing_z = false;
+		bool missing_m = false;
+		BoundingBox bbox;
+	};
+
+	void MeasureVertices(Cursor &cursor, TranscodeState &state, bool little_endian, bool has_z, bool has_m,
+	                     uint32_t count, bool update_bounds);
+	GeometryType MeasureGeometry(Cursor &cursor, TranscodeState &state);
+	void TranscodeVertices(Cursor &input, Cursor &output, bool little_endian, bool has_z, bool has_m, uint32_t count);
+	void TranscodeGeometry(Cursor &input, Cursor &output);
+
 public:
 	explicit WKBReader(ArenaAllocator &arena) : arena(arena) {
 	}
 	Geometry Deserialize(const string_t &wkb);
 	Geometry Deserialize(const_data_ptr_t wkb, uint32_t size);
+
+	// Convert WKB straight to a serialized geometry, without materializing a Geometry in between
+	geometry_t Transcode(Vector &result, const string_t &wkb, bool double_bbox = false);
+	geometry_t Transcode(Vector &result, const_data_ptr_t wkb, uint32_t size, bool double_bbox = false);
 	bool GeomHasZ() const {
 		return has_any_z;
 	}
@@ -14,6 +14,9 @@ struct WKBWriter {
 	// Write a geometry to a WKB blob into a buffer
 	static void Write(const geometry_t &geometry, vector<data_t> &buffer);
 
+	// Write a geometry to a hex encoded WKB string attached to a vector, without an intermediate WKB buffer
+	static string_t WriteHex(const geometry_t &geometry, Vector &result);
+
 	// Write a geometry to a WKB blob into an arena allocator
 	static const_data_ptr_t Write(const geometry_t &geometry, uint32_t *size, ArenaAllocator &allocator);
 };
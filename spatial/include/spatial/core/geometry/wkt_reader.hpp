@@ -25,7 +25,9 @@ private:
     bool Match(char c);
     bool MatchCI(const char *str);
     void Expect(char c);
-    void ParseVertex(vector<double> &coords);
+    void SkipWhitespace();
+    uint32_t CountVertices();
+    void ParseVertex(double *coords);
     VertexArray ParseVertices();
     Point ParsePoint();
     LineString ParseLineString();
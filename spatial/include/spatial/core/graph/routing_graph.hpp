@@ -0,0 +1,107 @@
+#pragma once
+#include "spatial/common.hpp"
+
+#include "duckdb/storage/object_cache.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// RoutingGraph
+//------------------------------------------------------------------------------
+// An edge of a road network, from the start point to the end point of a LINESTRING
+struct RoutingEdge {
+	double x0;
+	double y0;
+	double x1;
+	double y1;
+	double weight;
+};
+
+// A road network in compressed sparse row form. The nodes are the distinct end points of the edges, edges that end at
+// exactly the same coordinates share a node. Every edge can be travelled in both directions, so it is stored once
+// for each of its nodes: the neighbours of node i are targets[offsets[i]] up to targets[offsets[i + 1]].
+// A graph is built once by ST_RoutingGraph_Agg and kept in the object cache of the database under its name, where the
+// routing functions of all connections look it up.
+class RoutingGraph : public ObjectCacheEntry {
+public:
+	vector<double> node_x;
+	vector<double> node_y;
+	vector<uint32_t> offsets;
+	vector<uint32_t> targets;
+	vector<double> weights;
+	// The number of input edges, before they were stored in both directions
+	idx_t edge_count = 0;
+	// The weights are the planar lengths of the edges, so the straight line distance between two nodes never
+	// overestimates the distance along the graph and can guide an A* search
+	bool planar_weights = false;
+
+	static unique_ptr<RoutingGraph> Build(const vector<RoutingEdge> &edges, bool planar_weights);
+
+	idx_t NodeCount() const {
+		return node_x.size();
+	}
+
+	// The closest node to a point, or INVALID_INDEX if the graph is empty
+	idx_t FindNearestNode(double x, double y) const;
+
+	static string ObjectType() {
+		return "spatial_routing_graph";
+	}
+	string GetObjectType() override {
+		return ObjectType();
+	}
+	static string GetCacheKey(const string &name) {
+		return "spatial_routing_graph:" + name;
+	}
+
+private:
+	// A uniform grid over the nodes, for snapping points to the graph. The nodes in cell c are
+	// grid_nodes[grid_offsets[c]] up to grid_nodes[grid_offsets[c + 1]].
+	double grid_min_x = 0;
+	double grid_min_y = 0;
+	double grid_cell_size = 1;
+	idx_t grid_width = 0;
+	idx_t grid_height = 0;
+	vector<uint32_t> grid_offsets;
+	vector<uint32_t> grid_nodes;
+
+	void BuildGrid();
+};
+
+//------------------------------------------------------------------------------
+// RoutingSearch
+//------------------------------------------------------------------------------
+// Shortest path searches over a graph with the buffers of one thread. The distance array is sized to the graph once
+// and only the entries touched by a search are reset afterwards, so a search costs as much as the part of the graph it
+// explores rather than the size of the graph.
+class RoutingSearch {
+public:
+	explicit RoutingSearch(const RoutingGraph &graph);
+
+	// The distances from a source to many targets (infinity if unreachable) with a single Dijkstra search, which stops
+	// once all the targets are settled
+	void OneToMany(uint32_t source, const vector<uint32_t> &target_nodes, vector<double> &distances);
+	// The distance from a source to a single target. Uses A* with the straight line distance to the target as the
+	// heuristic if the graph has planar weights.
+	double OneToOne(uint32_t source, uint32_t target);
+
+private:
+	using QueueEntry = std::pair<double, uint32_t>;
+
+	const RoutingGraph &graph;
+	vector<double> distance;
+	vector<uint32_t> touched;
+	// The searched targets are marked with the generation of the search, so the marks never have to be cleared
+	vector<uint32_t> target_mark;
+	uint32_t generation = 0;
+	vector<QueueEntry> queue;
+
+	void SetDistance(uint32_t node, double value);
+	void Reset();
+};
+
+} // namespace core
+
+} // namespace spatial
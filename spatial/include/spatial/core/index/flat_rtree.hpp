@@ -0,0 +1,213 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+
+#include <queue>
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// RTreeBox
+//------------------------------------------------------------------------------
+// A single precision bounding box, same precision as the bounding box stored
+// in the header of a serialized geometry.
+struct RTreeBox {
+	float minx = std::numeric_limits<float>::max();
+	float miny = std::numeric_limits<float>::max();
+	float maxx = std::numeric_limits<float>::lowest();
+	float maxy = std::numeric_limits<float>::lowest();
+
+	RTreeBox() = default;
+	RTreeBox(float minx, float miny, float maxx, float maxy) : minx(minx), miny(miny), maxx(maxx), maxy(maxy) {
+	}
+
+	// Round outwards so that the float box always contains the double box
+	static RTreeBox FromBoundingBox(const BoundingBox &bbox) {
+		return RTreeBox(Utils::DoubleToFloatDown(bbox.minx), Utils::DoubleToFloatDown(bbox.miny),
+		                Utils::DoubleToFloatUp(bbox.maxx), Utils::DoubleToFloatUp(bbox.maxy));
+	}
+
+	bool Intersects(const RTreeBox &other) const {
+		return !(minx > other.maxx || maxx < other.minx || miny > other.maxy || maxy < other.miny);
+	}
+
+	void Union(const RTreeBox &other) {
+		minx = std::min(minx, other.minx);
+		miny = std::min(miny, other.miny);
+		maxx = std::max(maxx, other.maxx);
+		maxy = std::max(maxy, other.maxy);
+	}
+
+	// The (euclidean) distance between the closest points of the two boxes, zero if they intersect
+	double Distance(const RTreeBox &other) const {
+		auto dx = std::max({0.0, static_cast<double>(minx) - static_cast<double>(other.maxx),
+		                    static_cast<double>(other.minx) - static_cast<double>(maxx)});
+		auto dy = std::max({0.0, static_cast<double>(miny) - static_cast<double>(other.maxy),
+		                    static_cast<double>(other.miny) - static_cast<double>(maxy)});
+		return std::sqrt(dx * dx + dy * dy);
+	}
+
+	double CenterX() const {
+		return (static_cast<double>(minx) + static_cast<double>(maxx)) / 2.0;
+	}
+
+	double CenterY() const {
+		return (static_cast<double>(miny) + static_cast<double>(maxy)) / 2.0;
+	}
+};
+
+//------------------------------------------------------------------------------
+// FlatRTree
+//------------------------------------------------------------------------------
+// A static, bulk-loaded R-tree stored in a single flat array.
+//
+// Entries are packed with the Sort-Tile-Recursive (STR) algorithm, which gives
+// close to 100% node utilization and good query performance for static data.
+// All levels are stored contiguously, leaves first and the root last. Every
+// internal node stores the offset of its first child, its children being the
+// NODE_SIZE consecutive entries of the level below (or less, for the last node
+// of a level).
+//
+// Insert all entries first, then call Build() once. The tree is read-only after
+// that and can be searched concurrently from multiple threads.
+//------------------------------------------------------------------------------
+class FlatRTree {
+public:
+	static constexpr const idx_t NODE_SIZE = 16;
+
+	void Insert(const RTreeBox &box, idx_t row_id) {
+		D_ASSERT(!is_built);
+		entries.push_back(Entry {box, row_id});
+	}
+
+	void Build();
+
+	idx_t Count() const {
+		return is_built ? item_count : entries.size();
+	}
+
+	bool IsEmpty() const {
+		return Count() == 0;
+	}
+
+	// The bounds of all the entries in the tree
+	RTreeBox GetBounds() const {
+		D_ASSERT(is_built);
+		if (item_count == 0) {
+			return RTreeBox();
+		}
+		return entries.back().box;
+	}
+
+	// The memory held by the tree
+	idx_t SizeInBytes() const {
+		return entries.capacity() * sizeof(Entry) + level_bounds.capacity() * sizeof(idx_t);
+	}
+
+	// Call the callback with the row id and box of every entry whose box intersects the query box
+	// The stack is passed in so that it can be reused between searches
+	template <class CALLBACK>
+	void Search(const RTreeBox &query, vector<idx_t> &stack, CALLBACK &&callback) const {
+		D_ASSERT(is_built);
+		if (item_count == 0) {
+			return;
+		}
+		auto root = entries.size() - 1;
+		if (!entries[root].box.Intersects(query)) {
+			return;
+		}
+
+		stack.clear();
+		stack.push_back(root);
+
+		while (!stack.empty()) {
+			auto node = stack.back();
+			stack.pop_back();
+
+			auto first = entries[node].index;
+			auto end = std::min(first + NODE_SIZE, LevelEnd(first));
+			for (auto i = first; i < end; i++) {
+				if (!entries[i].box.Intersects(query)) {
+					continue;
+				}
+				if (i < item_count) {
+					// Leaf entry
+					callback(entries[i].index, entries[i].box);
+				} else {
+					stack.push_back(i);
+				}
+			}
+		}
+	}
+
+	template <class CALLBACK>
+	void Search(const RTreeBox &query, CALLBACK &&callback) const {
+		vector<idx_t> stack;
+		Search(query, stack, std::forward<CALLBACK>(callback));
+	}
+
+	// Visit the entries in order of increasing distance to the query box (best-first search).
+	// The distance of a leaf entry is given by leaf_distance(row_id, box), which may refine the distance between the
+	// boxes but must never be smaller than it. The callback is called with the row id and the distance of every
+	// visited entry and returns false to stop the search.
+	template <class LEAF_DISTANCE, class CALLBACK>
+	void NearestSearch(const RTreeBox &query, LEAF_DISTANCE &&leaf_distance, CALLBACK &&callback) const {
+		D_ASSERT(is_built);
+		if (item_count == 0) {
+			return;
+		}
+
+		// Min-heap of (distance, entry offset)
+		using queue_entry_t = std::pair<double, idx_t>;
+		std::priority_queue<queue_entry_t, vector<queue_entry_t>, std::greater<queue_entry_t>> queue;
+
+		auto root = entries.size() - 1;
+		queue.emplace(entries[root].box.Distance(query), root);
+
+		while (!queue.empty()) {
+			auto top = queue.top();
+			queue.pop();
+
+			if (top.second < item_count) {
+				// Leaf entry, every entry left in the queue is at least as far away
+				if (!callback(entries[top.second].index, top.first)) {
+					return;
+				}
+				continue;
+			}
+
+			auto first = entries[top.second].index;
+			auto end = std::min(first + NODE_SIZE, LevelEnd(first));
+			for (auto i = first; i < end; i++) {
+				auto &entry = entries[i];
+				auto distance = i < item_count ? leaf_distance(entry.index, entry.box) : entry.box.Distance(query);
+				queue.emplace(distance, i);
+			}
+		}
+	}
+
+private:
+	struct Entry {
+		RTreeBox box;
+		// For leaf entries this is the row id, for internal nodes the offset of the first child
+		idx_t index;
+	};
+
+	// Returns the (exclusive) end offset of the level containing the given entry offset
+	idx_t LevelEnd(idx_t offset) const {
+		return *std::upper_bound(level_bounds.begin(), level_bounds.end(), offset);
+	}
+
+	void SortTileRecursive(idx_t begin, idx_t end);
+
+	vector<Entry> entries;
+	vector<idx_t> level_bounds;
+	idx_t item_count = 0;
+	bool is_built = false;
+};
+
+} // namespace core
+
+} // namespace spatial
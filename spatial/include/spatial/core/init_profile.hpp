@@ -0,0 +1,42 @@
+#pragma once
+#include "spatial/common.hpp"
+
+#include <chrono>
+
+namespace spatial {
+
+namespace core {
+
+// Records how long each module of the extension took to register its functions when the extension was loaded, and to
+// initialize the libraries that are only set up on first use (e.g. PROJ and GDAL). Reported by spatial_init_profile().
+struct InitProfile {
+	struct Entry {
+		string module;
+		string phase;
+		double elapsed_ms;
+	};
+
+	// Times a scope and records it on destruction
+	class Timer {
+	public:
+		Timer(string module_p, string phase_p)
+		    : module(std::move(module_p)), phase(std::move(phase_p)), start(std::chrono::steady_clock::now()) {
+		}
+		~Timer() {
+			auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+			InitProfile::Record(module, phase, elapsed.count());
+		}
+
+	private:
+		string module;
+		string phase;
+		std::chrono::steady_clock::time_point start;
+	};
+
+	static void Record(const string &module, const string &phase, double elapsed_ms);
+	static vector<Entry> GetEntries();
+};
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,117 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "duckdb/common/file_system.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// AsyncReader
+//------------------------------------------------------------------------------
+// Reads ranges of a file in the background, so that a reader can submit the ranges it needs next ahead of time and
+// decode the ones it already has in the meantime, with up to "spatial_io_queue_depth" reads in flight instead of one.
+//
+// The reads run on a pool of I/O threads shared by the process, which grows to the largest queue depth asked for.
+// This takes a thread per read in flight where io_uring would take none, but works the same on every platform and
+// for every file system DuckDB can read from, as the reads go through the file system of the handle. Every read in
+// flight uses a handle of its own, because the positional reads of remote file handles go through a buffer of the
+// handle.
+class AsyncReader {
+public:
+	static constexpr idx_t DEFAULT_QUEUE_DEPTH = 8;
+
+	// A range that is being read into a buffer of its own
+	class Request {
+	public:
+		Request(idx_t offset, idx_t size) : offset(offset), size(size), data(make_unsafe_uniq_array<data_t>(size)) {
+		}
+		idx_t offset;
+		idx_t size;
+		unsafe_unique_array<data_t> data;
+
+	private:
+		friend class AsyncReader;
+		bool done = false;
+		std::exception_ptr error;
+	};
+
+	// Reads ranges of the file of a handle, which is only used to open more handles
+	AsyncReader(FileHandle &handle, idx_t queue_depth);
+	// Waits for the reads in flight, whether or not they are still needed
+	~AsyncReader();
+
+	AsyncReader(const AsyncReader &) = delete;
+	AsyncReader &operator=(const AsyncReader &) = delete;
+
+	// The "spatial_io_queue_depth" setting of the client
+	static idx_t GetQueueDepth(ClientContext &context);
+
+	idx_t QueueDepth() const {
+		return queue_depth;
+	}
+
+	// Start reading a range. Requests that are dropped without waiting for them are still read to the end.
+	shared_ptr<Request> Submit(idx_t offset, idx_t size);
+	// Wait until a request has been read, rethrowing the error it failed with
+	void Wait(Request &request);
+
+private:
+	// Shared with the reads in flight, so that the reader can be destroyed while they run
+	struct State {
+		FileSystem &fs;
+		string path;
+		mutex lock;
+		std::condition_variable done;
+		idx_t in_flight = 0;
+		vector<unique_ptr<FileHandle>> idle_handles;
+
+		State(FileSystem &fs, string path) : fs(fs), path(std::move(path)) {
+		}
+	};
+
+	shared_ptr<State> state;
+	idx_t queue_depth;
+
+	static void Execute(State &state, Request &request);
+};
+
+//------------------------------------------------------------------------------
+// ReadAheadBuffer
+//------------------------------------------------------------------------------
+// Serves reads of a file that is mostly read from front to back, e.g. through a library that reads record after
+// record: once a read starts where the previous one ended, the blocks after it are read ahead with an AsyncReader,
+// up to its queue depth, and reads are copied from them. Reads anywhere else go straight to the file, so random
+// access does not read blocks that are never used.
+class ReadAheadBuffer {
+public:
+	ReadAheadBuffer(FileHandle &handle, idx_t block_size, idx_t queue_depth);
+
+	// Read a range, returns the number of bytes read, which is less than requested at the end of the file
+	idx_t Read(data_ptr_t buffer, idx_t size, idx_t offset);
+
+	idx_t GetFileSize() const {
+		return file_size;
+	}
+
+private:
+	FileHandle &handle;
+	AsyncReader reader;
+	idx_t file_size;
+	idx_t block_size;
+	// Where the previous read ended
+	idx_t next_offset = 0;
+	// The blocks read ahead, in order
+	std::deque<shared_ptr<AsyncReader::Request>> blocks;
+
+	// Submit the blocks from the one at the offset up to the queue depth
+	void SubmitBlocks(idx_t offset);
+};
+
+} // namespace core
+
+} // namespace spatial
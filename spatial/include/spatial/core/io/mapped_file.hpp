@@ -0,0 +1,47 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "duckdb/common/file_system.hpp"
+
+namespace spatial {
+
+namespace core {
+
+// A local file mapped into memory for reading, so that reads are plain copies without any system calls
+class MappedFile {
+public:
+	MappedFile(int fd, data_ptr_t data, idx_t size);
+	~MappedFile();
+
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+
+	// Map the file behind a handle of the local file system, hinting whether it is read from front to back.
+	// Returns nullptr for any other file system, or if the file can not be mapped, so the caller keeps the handle.
+	static unique_ptr<MappedFile> TryMap(FileHandle &handle, bool sequential);
+
+	const_data_ptr_t GetData() const {
+		return data;
+	}
+	idx_t GetSize() const {
+		return size;
+	}
+
+	// Copy a range of the file, returns the number of bytes copied, which is less than requested at the end
+	idx_t Read(data_ptr_t buffer, idx_t nr_bytes, idx_t location) const {
+		if (location >= size) {
+			return 0;
+		}
+		auto read_size = MinValue(nr_bytes, size - location);
+		memcpy(buffer, data + location, read_size);
+		return read_size;
+	}
+
+private:
+	int fd;
+	data_ptr_t data;
+	idx_t size;
+};
+
+} // namespace core
+
+} // namespace spatial
@@ -34,9 +34,41 @@ struct SHPObjectDeleter {
 
 using SHPObjectPtr = unique_ptr<SHPObject, SHPObjectDeleter>;
 
+struct SHPTreeDiskHandleDeleter {
+	void operator()(SHPDiskTreeInfo *info) {
+		if (info) {
+			SHPCloseDiskTree(info);
+		}
+	}
+};
+
+using SHPTreeDiskHandlePtr = unique_ptr<SHPDiskTreeInfo, SHPTreeDiskHandleDeleter>;
+
+struct SBNSearchHandleDeleter {
+	void operator()(SBNSearchInfo *info) {
+		if (info) {
+			SBNCloseDiskTree(info);
+		}
+	}
+};
+
+using SBNSearchHandlePtr = unique_ptr<SBNSearchInfo, SBNSearchHandleDeleter>;
+
 DBFHandlePtr OpenDBFFile(FileSystem &fs, const string &filename);
 SHPHandlePtr OpenSHPFile(FileSystem &fs, const string &filename);
 
+// Files inside zip archives can be addressed as /vsizip/path/to/archive.zip/member.shp
+bool ShapefileFileExists(FileSystem &fs, const string &filename);
+// Returns the .shp members of a zip archive as /vsizip/ paths, or the file itself if it is not a zip archive
+vector<string> ExpandShapefileArchive(FileSystem &fs, const string &file_name);
+
+// The spatial indexes are optional, these return nullptr if the file does not exist or can not be read
+SHPTreeDiskHandlePtr TryOpenQIXFile(FileSystem &fs, const string &filename);
+SBNSearchHandlePtr TryOpenSBNFile(FileSystem &fs, const string &filename);
+
+// Build a quadtree spatial index (.qix) of a shapefile that has been written
+void WriteQIXFile(FileSystem &fs, const string &shp_filename, const string &qix_filename);
+
 enum class AttributeEncoding {
 	UTF8,
 	LATIN1,
@@ -96,6 +128,20 @@ struct EncodingUtil {
 		}
 		return len;
 	}
+
+	// Same as above, but for an input of known length that is not null terminated
+	static idx_t LatinToUTF8Buffer(const_data_ptr_t in, idx_t in_len, data_ptr_t out) {
+		idx_t len = 0;
+		for (auto end = in + in_len; in < end; in++) {
+			if (*in < 128) {
+				out[len++] = *in;
+			} else {
+				out[len++] = 0xc2 + (*in > 0xbf);
+				out[len++] = (*in & 0x3f) + 0x80;
+			}
+		}
+		return len;
+	}
 };
 
 } // namespace core
@@ -0,0 +1,91 @@
+#pragma once
+#include "spatial/common.hpp"
+
+#include "duckdb/storage/object_cache.hpp"
+
+#include <list>
+
+namespace spatial {
+
+namespace core {
+
+class SpatialJoinIndex;
+
+//------------------------------------------------------------------------------
+// JoinIndexCache
+//------------------------------------------------------------------------------
+// The built build sides of spatial joins, i.e. their rows with the R-trees and grids over them, kept in the object
+// cache of the database so that joining against the same table in a later query skips the build, e.g. when every
+// dashboard refresh joins new events against a static table of zones. Only a build side that is a plain scan of a
+// table is cached, keyed by the table, the columns the scan reads and the expressions and parameters of the join.
+//
+// Like the results of the tile cache, a build side is only valid as long as its table has the version it had when
+// the build started. The cache is looked up when the join runs, so a prepared join checks it on every execution. The
+// version is bumped when a statement that writes to the table is planned, every time an INSERT, UPDATE or DELETE runs
+// (see LogicalSpatialCacheInvalidation), and again when the transaction of the write ends. Appenders write without
+// running a statement, so a build side also keeps the number of rows in the storage of its table, which changes with
+// every committed append. The least recently used build sides are evicted once they take more than the
+// "spatial_join_cache_size" setting.
+//
+// The rows and geometries of a build side are allocated through the buffer allocator, so they count towards the
+// memory limit while they are cached. The R-trees and grids over them are not.
+class JoinIndexCache : public ObjectCacheEntry {
+public:
+	static string ObjectType() {
+		return "spatial_join_index_cache";
+	}
+	string GetObjectType() override {
+		return ObjectType();
+	}
+
+	// The cache of the database, or nullptr if nothing was cached yet
+	static shared_ptr<JoinIndexCache> TryGet(ClientContext &context);
+	static shared_ptr<JoinIndexCache> GetOrCreate(ClientContext &context);
+	// The "spatial_join_cache_size" setting of the client, 0 if caching is disabled
+	static idx_t GetCapacity(ClientContext &context);
+
+	// Tables are identified by their lowercase name without the schema, as for the tile cache
+	idx_t GetTableVersion(const string &table);
+	// Bump the version of a table that is written to, and drop the build sides that read it
+	void InvalidateTable(const string &table);
+	// Bump the version of all tables, e.g. when a database is attached or detached, and drop all build sides
+	void InvalidateAll();
+
+	// The build side cached under a key, if its table did not change since and still has the given number of rows
+	shared_ptr<SpatialJoinIndex> Lookup(const string &key, idx_t table_rows);
+	// Cache a build side of the given size, which read the table at the given version and number of rows, evicting
+	// the least recently used build sides to keep the cache within the capacity. It is not cached if the table
+	// changed since.
+	void Insert(const string &key, shared_ptr<SpatialJoinIndex> index, const string &table, idx_t version,
+	            idx_t table_rows, idx_t index_size, idx_t capacity);
+
+	// Get the bytes held by the build sides and the peak since the last call
+	void FetchMemory(idx_t &held_bytes, idx_t &peak_bytes);
+
+private:
+	struct Entry {
+		shared_ptr<SpatialJoinIndex> index;
+		string table;
+		idx_t version;
+		idx_t table_rows;
+		idx_t size;
+		std::list<string>::iterator lru_position;
+	};
+
+	mutex lock;
+	unordered_map<string, Entry> entries;
+	// The keys of the entries, most recently used first
+	std::list<string> lru;
+	unordered_map<string, idx_t> table_versions;
+	// Added to the version of every table, so that bumping it bumps them all
+	idx_t generation = 0;
+	idx_t size = 0;
+	idx_t peak_size = 0;
+
+	idx_t GetVersion(const string &table) const;
+	void Erase(unordered_map<string, Entry>::iterator entry);
+};
+
+} // namespace core
+
+} // namespace spatial
@@ -1,15 +0,0 @@
-#pragma once
-
-#include "spatial/common.hpp"
-
-namespace spatial {
-
-namespace core {
-
-struct LayoutBenchmark {
-	static void Register(ClientContext &context);
-};
-
-} // namespace core
-
-} // namespace spatial
\ No newline at end of file
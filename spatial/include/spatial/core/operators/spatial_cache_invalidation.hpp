@@ -0,0 +1,84 @@
+#pragma once
+#include "spatial/common.hpp"
+
+#include "duckdb/execution/physical_operator.hpp"
+#include "duckdb/planner/operator/logical_extension_operator.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Spatial Cache Writes
+//------------------------------------------------------------------------------
+// Drops the results of the tile cache and the build sides of the join index
+// cache that read the given tables, by lowercase name without the schema. The
+// tables are remembered and dropped once more when the transaction of the
+// client ends, as a query that runs in between may cache what it read before
+// the write is committed.
+struct SpatialCacheWrites {
+	static void Invalidate(ClientContext &context, const unordered_set<string> &tables);
+	// Whether the open transaction of the client wrote to the table, by lowercase name
+	static bool IsWritten(ClientContext &context, const string &table);
+};
+
+//------------------------------------------------------------------------------
+// Logical Spatial Cache Invalidation
+//------------------------------------------------------------------------------
+// Placed on top of an INSERT, UPDATE or DELETE, and passes its output through.
+// Every time the statement runs, the operator invalidates the caches for the
+// table it writes to. A prepared statement is planned once but may run many
+// times, so invalidating when the statement is planned is not enough.
+class LogicalSpatialCacheInvalidation : public LogicalExtensionOperator {
+public:
+	// The table written by the child, by lowercase name
+	string table;
+
+	explicit LogicalSpatialCacheInvalidation(string table);
+
+	string GetName() const override {
+		return "SPATIAL_CACHE_INVALIDATION";
+	}
+
+	string GetExtensionName() const override {
+		return "spatial_cache_invalidation";
+	}
+
+	vector<ColumnBinding> GetColumnBindings() override;
+	unique_ptr<PhysicalOperator> CreatePlan(ClientContext &context, PhysicalPlanGenerator &generator) override;
+
+protected:
+	void ResolveTypes() override;
+};
+
+//------------------------------------------------------------------------------
+// Physical Spatial Cache Invalidation
+//------------------------------------------------------------------------------
+class PhysicalSpatialCacheInvalidation : public PhysicalOperator {
+public:
+	PhysicalSpatialCacheInvalidation(const LogicalSpatialCacheInvalidation &op, unique_ptr<PhysicalOperator> child);
+
+	string table;
+
+	string GetName() const override {
+		return "SPATIAL_CACHE_INVALIDATION";
+	}
+	string ParamsToString() const override {
+		return table;
+	}
+
+public:
+	unique_ptr<OperatorState> GetOperatorState(ExecutionContext &context) const override;
+	// Not parallel, so that the state is created once and by one thread at a time
+	bool ParallelOperator() const override {
+		return false;
+	}
+
+protected:
+	OperatorResultType Execute(ExecutionContext &context, DataChunk &input, DataChunk &chunk,
+	                           GlobalOperatorState &gstate, OperatorState &state) const override;
+};
+
+} // namespace core
+
+} // namespace spatial
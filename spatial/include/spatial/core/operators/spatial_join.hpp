@@ -0,0 +1,196 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/dynamic_spatial_filter.hpp"
+
+#include "duckdb/execution/operator/join/physical_join.hpp"
+#include "duckdb/planner/operator/logical_extension_operator.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Logical Spatial Join
+//------------------------------------------------------------------------------
+// A join where the left and right side are matched on the intersection of the
+// bounding boxes of a geometry expression on each side. Only candidate pairs
+// are produced, the exact spatial predicate is expected to be evaluated by a
+// filter on top of the join.
+//
+// expressions[0] is the geometry expression of the left (probe) side
+// expressions[1] is the geometry expression of the right (build) side
+//
+// If distance is non-zero, the bounding boxes of the left side are expanded by
+// the distance before matching, which is what distance predicates such as
+// ST_DWithin need.
+//
+// For LEFT, SEMI and ANTI joins, expressions[2] is the exact join condition,
+// which is evaluated by the join itself since a filter on top can not restore
+// the rows of the left side without a match.
+//
+// If k is non-zero, this is a k-nearest-neighbour join instead: every left row
+// is matched with the k right rows closest to it. The left side geometries have
+// to be points, and the right side can be any geometry but a collection. No
+// filter is needed on top in that case. If distance_index is set, the join also
+// returns the distance of every pair as a last DOUBLE column, bound to
+// (distance_index, 0).
+//
+// If the join also has a time band, the rows are only matched if the difference
+// of a time key on each side, left - right, is within [time_lower, time_upper].
+// The keys are TIMESTAMP (compared in microseconds) or DOUBLE, and come after
+// the geometry expressions: expressions[2] is the key of the left side and
+// expressions[3] the key of the right side. The exact condition then follows
+// them instead.
+class LogicalSpatialJoin : public LogicalExtensionOperator {
+public:
+	JoinType join_type;
+	// The distance to expand the left side bounding boxes by
+	double distance = 0;
+	// The number of nearest neighbours to match, or zero for an intersection join
+	idx_t k = 0;
+	// The table index of the distance column of a KNN join, if it returns one
+	idx_t distance_index = DConstants::INVALID_INDEX;
+	// The number of build side rows above which the build side is partitioned into tiles
+	idx_t partition_threshold = DConstants::INVALID_INDEX;
+	// The time band, if there are time key expressions
+	bool has_time_band = false;
+	double time_lower = -std::numeric_limits<double>::infinity();
+	double time_upper = std::numeric_limits<double>::infinity();
+	// Set if the left side is a scan that can skip the features outside of the extent of the right side
+	shared_ptr<DynamicSpatialFilter> extent_filter;
+
+	explicit LogicalSpatialJoin(JoinType join_type);
+
+	string GetName() const override {
+		return "SPATIAL_JOIN";
+	}
+
+	string GetExtensionName() const override {
+		return "spatial_join";
+	}
+
+	vector<ColumnBinding> GetColumnBindings() override;
+	vector<idx_t> GetTableIndex() const override;
+	void ResolveColumnBindings(ColumnBindingResolver &res, vector<ColumnBinding> &bindings) override;
+	unique_ptr<PhysicalOperator> CreatePlan(ClientContext &context, PhysicalPlanGenerator &generator) override;
+
+protected:
+	void ResolveTypes() override;
+};
+
+//------------------------------------------------------------------------------
+// Physical Spatial Join
+//------------------------------------------------------------------------------
+// Materializes the right side, bulk loads an STR-packed R-tree over the
+// bounding boxes of the right side geometries and then probes it in parallel
+// with the bounding boxes of the left side geometries.
+//
+// If the right side has more than partition_threshold rows, it is instead
+// partitioned into a uniform grid of tiles (partition based spatial-merge join)
+// and one R-tree is built per tile, in parallel. A right side geometry is
+// replicated into every tile its bounding box overlaps, and duplicate pairs are
+// avoided by only reporting a pair from the tile that contains the lower left
+// corner of the intersection of the two bounding boxes.
+//
+// A KNN join searches the R-tree nearest-first by bounding box distance, which
+// is a lower bound of the distance between the geometries. It computes the
+// exact distance of every entry it reaches and stops once the next bounding box
+// is further away than the k-th closest exact distance so far.
+//
+// With a time band, the build side is instead sorted by its time key and split
+// into buckets of consecutive times, with one R-tree per bucket. A probe row
+// only searches the buckets that overlap its time window, so the space and the
+// time condition prune the candidates together.
+//
+// Except for KNN joins, the build side also marks the cells of a fine grid over
+// its bounds that its boxes overlap. A probe row whose box only covers empty
+// cells is dropped before searching any R-tree, which is most of the rows when
+// the build side only covers a small part of the probe side. The extent of the
+// build side is also handed to the extent filter, if the probe side scan reads
+// through one, so that it does not read the features outside of it at all.
+//
+// The candidate pairs of a probe chunk are emitted ordered by build side row,
+// so that the exact predicate prepares every build side geometry once and
+// checks all of its candidates in a row, rather than alternating between the
+// build side geometries in the order of the probe side.
+//
+// With the "spatial_profiling" setting enabled, the candidate pairs, the exact
+// matches and the time spent building, probing and refining are counted for
+// spatial_profiling_metrics().
+//
+// With the "spatial_join_cache_size" setting, a build side that is a plain scan
+// of a table is kept in the join index cache once it is built. The scan of the
+// build side is still planned, and a later run of a join that finds its build
+// side in the cache when it starts stops the scan at its first chunk.
+class PhysicalSpatialJoin : public PhysicalJoin {
+public:
+	PhysicalSpatialJoin(LogicalOperator &op, unique_ptr<PhysicalOperator> left, unique_ptr<PhysicalOperator> right,
+	                    unique_ptr<Expression> left_key, unique_ptr<Expression> right_key, JoinType join_type,
+	                    double distance, idx_t k, idx_t partition_threshold, idx_t estimated_cardinality);
+
+	unique_ptr<Expression> left_key;
+	unique_ptr<Expression> right_key;
+	// The exact join condition, only set for join types other than INNER
+	unique_ptr<Expression> condition;
+	double distance;
+	idx_t k;
+	// Whether the distance of every pair of a KNN join is returned as the last column
+	bool emit_distance = false;
+	idx_t partition_threshold;
+	// The time keys of the left and right side, only set if the join has a time band
+	unique_ptr<Expression> left_time_key;
+	unique_ptr<Expression> right_time_key;
+	double time_lower = -std::numeric_limits<double>::infinity();
+	double time_upper = std::numeric_limits<double>::infinity();
+	// Receives the extent of the build side, expanded by the distance, once the build side is complete
+	shared_ptr<DynamicSpatialFilter> extent_filter;
+	// The key of the build side in the join index cache, empty if it can not be cached, with the table it reads by
+	// lowercase name as the cache knows it, and by catalog, schema and name to look up its storage when the join runs
+	string cache_key;
+	string cache_table;
+	string cache_catalog;
+	string cache_schema;
+	string cache_table_name;
+	// Whether the build side was cached when the join was planned, only shown by EXPLAIN. The cache is looked up
+	// again when the join runs.
+	bool cached_when_planned = false;
+
+	string GetName() const override {
+		return "SPATIAL_JOIN";
+	}
+	string ParamsToString() const override;
+
+public:
+	// Operator interface (probe side)
+	unique_ptr<OperatorState> GetOperatorState(ExecutionContext &context) const override;
+	bool ParallelOperator() const override {
+		return true;
+	}
+
+protected:
+	OperatorResultType ExecuteInternal(ExecutionContext &context, DataChunk &input, DataChunk &chunk,
+	                                   GlobalOperatorState &gstate, OperatorState &state) const override;
+
+private:
+	OperatorResultType ExecuteConditional(DataChunk &input, DataChunk &chunk, OperatorState &state) const;
+
+public:
+	// Sink interface (build side)
+	unique_ptr<GlobalSinkState> GetGlobalSinkState(ClientContext &context) const override;
+	unique_ptr<LocalSinkState> GetLocalSinkState(ExecutionContext &context) const override;
+	SinkResultType Sink(ExecutionContext &context, DataChunk &chunk, OperatorSinkInput &input) const override;
+	SinkCombineResultType Combine(ExecutionContext &context, OperatorSinkCombineInput &input) const override;
+	SinkFinalizeType Finalize(Pipeline &pipeline, Event &event, ClientContext &context,
+	                          OperatorSinkFinalizeInput &input) const override;
+
+	bool IsSink() const override {
+		return true;
+	}
+	bool ParallelSink() const override {
+		return true;
+	}
+};
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,92 @@
+#pragma once
+#include "spatial/common.hpp"
+
+#include "duckdb/execution/physical_operator.hpp"
+#include "duckdb/planner/operator/logical_extension_operator.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Logical Spatial Top-N Filter
+//------------------------------------------------------------------------------
+// Placed below a TOP_N that orders by the distance to a constant geometry, e.g.
+//
+//   ORDER BY ST_Distance(geom, ST_Point(...)) LIMIT k
+//
+// and drops the rows that can not be among the first k. Every thread keeps the
+// k smallest distances it has seen, which bound the k-th smallest distance of
+// the whole input from above. A row whose bounding box is further from the
+// bounding box of the constant than that is dropped without computing its
+// distance, the others have their exact distance computed and are dropped if
+// it is larger. The TOP_N above then only sorts the rows that are left.
+//
+// expressions[0] is the geometry expression
+// expressions[1] is the distance expression of the TOP_N
+//
+// Rows with a NULL geometry are dropped once k rows with a distance have been
+// seen, as the TOP_N orders NULLs last. Empty geometries are always kept.
+class LogicalSpatialTopNFilter : public LogicalExtensionOperator {
+public:
+	// The number of rows the TOP_N returns, including its offset
+	idx_t k;
+	// The bounding box of the constant geometry
+	double minx;
+	double miny;
+	double maxx;
+	double maxy;
+
+	explicit LogicalSpatialTopNFilter(idx_t k);
+
+	string GetName() const override {
+		return "SPATIAL_TOP_N_FILTER";
+	}
+
+	string GetExtensionName() const override {
+		return "spatial_top_n_filter";
+	}
+
+	vector<ColumnBinding> GetColumnBindings() override;
+	void ResolveColumnBindings(ColumnBindingResolver &res, vector<ColumnBinding> &bindings) override;
+	unique_ptr<PhysicalOperator> CreatePlan(ClientContext &context, PhysicalPlanGenerator &generator) override;
+
+protected:
+	void ResolveTypes() override;
+};
+
+//------------------------------------------------------------------------------
+// Physical Spatial Top-N Filter
+//------------------------------------------------------------------------------
+class PhysicalSpatialTopNFilter : public PhysicalOperator {
+public:
+	PhysicalSpatialTopNFilter(const LogicalSpatialTopNFilter &op, unique_ptr<PhysicalOperator> child,
+	                          unique_ptr<Expression> geometry, unique_ptr<Expression> distance);
+
+	unique_ptr<Expression> geometry;
+	unique_ptr<Expression> distance;
+	idx_t k;
+	double minx;
+	double miny;
+	double maxx;
+	double maxy;
+
+	string GetName() const override {
+		return "SPATIAL_TOP_N_FILTER";
+	}
+	string ParamsToString() const override;
+
+public:
+	unique_ptr<OperatorState> GetOperatorState(ExecutionContext &context) const override;
+	bool ParallelOperator() const override {
+		return true;
+	}
+
+protected:
+	OperatorResultType Execute(ExecutionContext &context, DataChunk &input, DataChunk &chunk,
+	                           GlobalOperatorState &gstate, OperatorState &state) const override;
+};
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,28 @@
+#pragma once
+#include "spatial/common.hpp"
+
+#include <functional>
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Parallel Chunks
+//------------------------------------------------------------------------------
+// Runs a function on every chunk of some work that a single function call or operator holds, e.g. the points of a
+// k-means aggregate or the cells of a split GEOS operation, on the calling thread and on the threads of the task
+// scheduler. The chunks are claimed one at a time. The tasks may only start once every chunk is done (or never, if
+// all threads are busy), so the calling thread works on the chunks too, and then only waits for the tasks that are
+// still working on a chunk.
+struct ParallelChunks {
+	using ChunkFunction = std::function<void(idx_t chunk)>;
+
+	// Run the function on the chunks 0 up to chunk_count and return once all of them are done. If the function throws
+	// on any thread, the others stop after their current chunk and the first error is thrown on the calling thread.
+	static void Run(ClientContext &context, idx_t chunk_count, const ChunkFunction &fun);
+};
+
+} // namespace core
+
+} // namespace spatial
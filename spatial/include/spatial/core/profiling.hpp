@@ -0,0 +1,70 @@
+#pragma once
+#include "spatial/common.hpp"
+
+#include <chrono>
+
+namespace spatial {
+
+namespace core {
+
+// Counters of the hot paths of the spatial functions. Every function local state counts into the SpatialCounters of
+// its geometry factory (and every spatial join thread into its own) with plain increments, which are only added to the process-wide totals when the state is
+// destroyed and the "spatial_profiling" setting was enabled for the query. Reported by spatial_profiling_metrics().
+struct SpatialCounters {
+	// Geometries deserialized into the geometry classes or into GEOS, and the size of their blobs
+	idx_t deserialize_calls = 0;
+	idx_t deserialize_bytes = 0;
+	// Predicates evaluated by GEOS, and how many of them used a geometry prepared by the per-thread cache
+	idx_t geos_predicate_calls = 0;
+	idx_t prepared_cache_hits = 0;
+	// Predicates answered from the bounding boxes in the geometry headers alone
+	idx_t bbox_rejects = 0;
+	// PROJ transformation pipelines created or cloned
+	idx_t proj_pipelines = 0;
+	// Spatial joins: the pairs of rows whose bounding boxes intersect, and how many of those satisfy the exact
+	// predicate. The matches are only known for the joins that evaluate the predicate themselves (LEFT, SEMI and ANTI),
+	// INNER joins leave it to a filter on top.
+	idx_t join_candidates = 0;
+	idx_t join_matches = 0;
+	// Spatial joins: the probe rows dropped because their bounding box only covers cells of the build side bounds
+	// that no build side geometry overlaps
+	idx_t join_grid_rejects = 0;
+	// Spatial joins: the time spent building the R-trees, searching them and evaluating the exact predicate, in
+	// microseconds summed over all threads
+	idx_t join_build_us = 0;
+	idx_t join_probe_us = 0;
+	idx_t join_refine_us = 0;
+	// Whether to add the counters to the totals when flushed
+	bool enabled = false;
+
+	// Enable the counters if the "spatial_profiling" setting is enabled for the client
+	void Init(ClientContext &context);
+	// Add the counters to the totals if enabled, and reset them
+	void Flush();
+	// Get the totals since the last call and reset them
+	static SpatialCounters Fetch();
+
+	// Adds the time spent in a scope to one of the counters, only reads the clock if the counters are enabled
+	class Timer {
+	public:
+		Timer(const SpatialCounters &counters, idx_t &target_p) : target(counters.enabled ? &target_p : nullptr) {
+			if (target) {
+				start = std::chrono::steady_clock::now();
+			}
+		}
+		~Timer() {
+			if (target) {
+				auto elapsed = std::chrono::steady_clock::now() - start;
+				*target += std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+			}
+		}
+
+	private:
+		idx_t *target;
+		std::chrono::steady_clock::time_point start;
+	};
+};
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,91 @@
+#pragma once
+#include "spatial/common.hpp"
+
+#include "duckdb/common/types/column/column_data_collection.hpp"
+#include "duckdb/storage/object_cache.hpp"
+
+#include <list>
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// TileCache
+//------------------------------------------------------------------------------
+// The results of the queries run through ST_CachedTile, e.g. the ST_AsMVT or ST_AsGeoJSON output of a tile, kept in
+// the object cache of the database so that all connections share them. A result is keyed by the text of its query,
+// which includes the tile coordinates, and is only valid as long as the tables it read have the version they had
+// when it ran. The version of a table is bumped every time a statement that writes to it runs, which is when the
+// entries that read it are dropped as well. Appenders write without running a statement, so a result also keeps the
+// number of rows in the storage of its tables, which ST_CachedTile compares before using it. The least recently used
+// results are evicted once the results take more than the "spatial_tile_cache_size" setting.
+class TileCache : public ObjectCacheEntry {
+public:
+	struct ReadTable {
+		// By lowercase name without the schema, which the versions are kept by
+		string name;
+		// The table the binder resolved the name to
+		string catalog;
+		string schema;
+		string table_name;
+		idx_t version = 0;
+		// The rows in the storage of the table when the query ran
+		idx_t rows = 0;
+	};
+	struct Result {
+		vector<LogicalType> types;
+		vector<string> names;
+		unique_ptr<ColumnDataCollection> rows;
+		// The tables the query read, with the views it read expanded
+		vector<ReadTable> tables;
+		idx_t size = 0;
+	};
+
+	static string ObjectType() {
+		return "spatial_tile_cache";
+	}
+	string GetObjectType() override {
+		return ObjectType();
+	}
+
+	// The cache of the database, or nullptr if nothing was cached yet
+	static shared_ptr<TileCache> TryGet(ClientContext &context);
+	static shared_ptr<TileCache> GetOrCreate(ClientContext &context);
+	// The "spatial_tile_cache_size" setting of the client, 0 if caching is disabled
+	static idx_t GetCapacity(ClientContext &context);
+
+	idx_t GetTableVersion(const string &table);
+	// Bump the version of a table that is written to, and drop the results that read it
+	void InvalidateTable(const string &table);
+
+	// The result of a query, if it is cached and the tables it read did not change since
+	shared_ptr<Result> Lookup(const string &query);
+	// Cache a result, evicting the least recently used results to keep the cache within the capacity. The result is
+	// not cached if a table it read changed while the query ran.
+	void Insert(const string &query, shared_ptr<Result> result, idx_t capacity);
+
+	// Get the bytes held by the results and the peak since the last call
+	void FetchMemory(idx_t &held_bytes, idx_t &peak_bytes);
+
+private:
+	struct Entry {
+		shared_ptr<Result> result;
+		std::list<string>::iterator lru_position;
+	};
+
+	mutex lock;
+	unordered_map<string, Entry> entries;
+	// The keys of the entries, most recently used first
+	std::list<string> lru;
+	unordered_map<string, idx_t> table_versions;
+	idx_t size = 0;
+	idx_t peak_size = 0;
+
+	bool IsValid(const Result &result);
+	void Erase(unordered_map<string, Entry>::iterator entry);
+};
+
+} // namespace core
+
+} // namespace spatial
@@ -11,8 +11,13 @@ struct GeoTypes {
 	static LogicalType POINT_4D();
 	static LogicalType LINESTRING_2D();
 	static LogicalType POLYGON_2D();
+	static LogicalType MULTIPOINT_2D();
+	static LogicalType MULTILINESTRING_2D();
+	static LogicalType MULTIPOLYGON_2D();
 	static LogicalType BOX_2D();
 	static LogicalType GEOMETRY();
+	static LogicalType GEOMETRY_Q();
+	static LogicalType GEOMETRY_LOD();
 	static LogicalType WKB_BLOB();
 
 	static void Register(DatabaseInstance &db);
@@ -9,6 +9,16 @@ namespace gdal {
 
 class DuckDBFileSystemHandler;
 
+// Counts the reads of GDAL through the DuckDB file system, and how many of the small reads were served from the
+// blocks cached per file handle (see the "spatial_gdal_io_buffer_size" setting), along with the features per Arrow
+// batch that ST_Read chose last. Reported by spatial_gdal_io_metrics().
+struct GdalIOMetrics {
+	// Get the totals since the last call and reset them
+	static void Fetch(idx_t &read_count, idx_t &cache_hit_count, idx_t &cache_miss_count, idx_t &bytes_read,
+	                  idx_t &batch_size);
+	static void RecordBatchSize(idx_t batch_size);
+};
+
 class GDALClientContextState : public ClientContextState {
 	string client_prefix;
 	DuckDBFileSystemHandler *fs_handler;
@@ -6,25 +6,38 @@
 
 #include "spatial/common.hpp"
 
+class OGRLayer;
+
 namespace spatial {
 
 namespace gdal {
 
+struct GdalLayerSchema;
+
 struct GdalTableFunction : ArrowTableFunction {
 private:
 	static unique_ptr<FunctionData> Bind(ClientContext &context, TableFunctionBindInput &input,
 	                                     vector<LogicalType> &return_types, vector<string> &names);
 	static void RenameColumns(vector<string> &names);
+	static unique_ptr<ArrowType> GetArrowType(ArrowSchema &attribute);
+	static void BindLayerSchema(OGRLayer *layer, const char *const *layer_creation_options, GdalLayerSchema &schema);
 
 	static unique_ptr<GlobalTableFunctionState> InitGlobal(ClientContext &context, TableFunctionInitInput &input);
 	static unique_ptr<LocalTableFunctionState> InitLocal(ExecutionContext &context, TableFunctionInitInput &input,
 	                                                     GlobalTableFunctionState *global_state_p);
 
+	static bool ScanStateNext(ClientContext &context, const FunctionData *bind_data, ArrowScanLocalState &state,
+	                          ArrowScanGlobalState &gstate);
 	static void Scan(ClientContext &context, TableFunctionInput &input, DataChunk &output);
 
 	static idx_t MaxThreads(ClientContext &context, const FunctionData *bind_data_p);
 
 	static unique_ptr<NodeStatistics> Cardinality(ClientContext &context, const FunctionData *data);
+	static double Progress(ClientContext &context, const FunctionData *bind_data_p,
+	                       const GlobalTableFunctionState *global_state);
+
+	static void PushdownComplexFilter(ClientContext &context, LogicalGet &get, FunctionData *bind_data,
+	                                  vector<unique_ptr<Expression>> &filters);
 
 	static unique_ptr<TableRef> ReplacementScan(ClientContext &context, const string &table_name,
 	                                            ReplacementScanData *data);
@@ -60,6 +73,18 @@ struct GdalMetadataFunction {
 	static void Register(DatabaseInstance &db);
 };
 
+struct GdalIOMetricsFunction {
+	static void Register(DatabaseInstance &db);
+};
+
+struct GdalReadRasterFunction {
+	static void Register(DatabaseInstance &db);
+};
+
+struct GdalZonalStatsFunction {
+	static void Register(DatabaseInstance &db);
+};
+
 } // namespace gdal
 
 } // namespace spatial
\ No newline at end of file
@@ -8,6 +8,8 @@ namespace gdal {
 struct GdalModule {
 public:
 	static void Register(DatabaseInstance &db);
+	// Register the GDAL drivers and error handler, on first call only
+	static void Initialize();
 };
 
 } // namespace gdal
@@ -0,0 +1,15 @@
+#pragma once
+#include "spatial/common.hpp"
+
+namespace spatial {
+
+namespace gdal {
+
+// ATTACH 'file' (TYPE GDAL, READ_ONLY): attach a dataset as a database with a view for each of its layers
+struct GdalStorageExtension {
+	static void Register(DatabaseInstance &db);
+};
+
+} // namespace gdal
+
+} // namespace spatial
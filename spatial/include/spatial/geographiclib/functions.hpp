@@ -14,6 +14,7 @@ public:
 		RegisterLength(db);
 		RegisterArea(db);
 		RegisterPerimeter(db);
+		RegisterSegmentize(db);
 	}
 
 private:
@@ -22,6 +23,7 @@ private:
 	static void RegisterLength(DatabaseInstance &db);
 	static void RegisterArea(DatabaseInstance &db);
 	static void RegisterPerimeter(DatabaseInstance &db);
+	static void RegisterSegmentize(DatabaseInstance &db);
 };
 
 } // namespace geographiclib
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "spatial/common.hpp"
+
+#include <cmath>
+
+namespace spatial {
+
+namespace geographiclib {
+
+// Conservative bounds on how far apart in degrees two points on the WGS84 ellipsoid can be when the geodesic
+// distance between them is at most a given number of meters. Used to reject pairs before solving the inverse
+// problem, and by the join rewrite of ST_DWithin_Spheroid (lat/lon order, as the rest of the spheroid functions).
+struct SpheroidBounds {
+	// The shortest length of one degree of latitude on the WGS84 ellipsoid (at the equator) is ~110574 meters.
+	// Use a slightly smaller value so that the resulting number of degrees is always a safe upper bound.
+	static constexpr const double MIN_METERS_PER_DEGREE_LATITUDE = 110000.0;
+	// One degree of longitude along a parallel at latitude phi is a * cos(phi) * pi / 180 meters, where the equatorial
+	// radius a = 6378137 is the smallest the prime vertical radius gets. That is ~111319 meters at the equator.
+	static constexpr const double MIN_METERS_PER_DEGREE_LONGITUDE = 111000.0;
+	// Do not bound the longitude if the points can get closer than this to a pole, the bound gets useless anyway
+	static constexpr const double MAX_LONGITUDE_BOUND_LATITUDE = 89.0;
+
+	static double LatitudeDegrees(double distance) {
+		return distance / MIN_METERS_PER_DEGREE_LATITUDE;
+	}
+
+	// Returns false if the two points are definitely more than distance meters apart. Any path between them crosses
+	// every latitude in between, and when it stays away from the poles, every meridian in between as well.
+	static bool MayBeWithin(double lat1, double lon1, double lat2, double lon2, double distance) {
+		auto lat_degrees = LatitudeDegrees(distance);
+		if (std::abs(lat1 - lat2) > lat_degrees) {
+			return false;
+		}
+		// Along a path of at most distance meters from the first point, the latitude never exceeds this
+		auto max_lat = std::abs(lat1) + lat_degrees;
+		if (!(max_lat < MAX_LONGITUDE_BOUND_LATITUDE)) {
+			return true;
+		}
+		// The shorter way around, the points may have longitudes outside of [-180, 180]
+		auto lon_delta = std::fmod(std::abs(lon1 - lon2), 360.0);
+		if (lon_delta > 180.0) {
+			lon_delta = 360.0 - lon_delta;
+		}
+		static constexpr double DEG_TO_RAD = 0.017453292519943296;
+		return lon_delta <= distance / (MIN_METERS_PER_DEGREE_LONGITUDE * std::cos(max_lat * DEG_TO_RAD));
+	}
+};
+
+} // namespace geographiclib
+
+} // namespace spatial
@@ -1,18 +1,29 @@
 #pragma once
 #include "spatial/common.hpp"
 #include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/functions/common.hpp"
 #include "spatial/geos/geos_wrappers.hpp"
+#include "spatial/geos/prepared_geometry_cache.hpp"
 namespace spatial {
 
 namespace geos {
 
 struct GEOSFunctionLocalState : FunctionLocalState {
 public:
+	ClientContext &context;
 	GeosContextWrapper ctx;
 	core::GeometryFactory factory;
+	idx_t arena_soft_limit;
+	idx_t arena_size = 0;
+
+private:
+	// Created on first use, kept for the lifetime of the state so geometries stay prepared across chunks
+	unique_ptr<PreparedGeometryCache> prepared_cache;
 
 public:
 	explicit GEOSFunctionLocalState(ClientContext &context);
+	~GEOSFunctionLocalState() override;
+	PreparedGeometryCache &GetPreparedCache();
 	static unique_ptr<FunctionLocalState> Init(ExpressionState &state, const BoundFunctionExpression &expr,
 	                                           FunctionData *bind_data);
 	static unique_ptr<FunctionLocalState> InitCast(CastLocalStateParameters &parameters);
@@ -8,9 +8,9 @@ namespace geos {
 struct GEOSScalarFunctions {
 public:
 	static void Register(DatabaseInstance &db) {
+		RegisterStAsMVTGeom(db);
 		RegisterStBoundary(db);
 		RegisterStBuffer(db);
-		RegisterStCentroid(db);
 		RegisterStContains(db);
 		RegisterStContainsProperly(db);
 		RegisterStConvexHull(db);
@@ -35,19 +35,20 @@ public:
 		RegisterStOverlaps(db);
 		RegisterStPointOnSurface(db);
 		RegisterStReducePrecision(db);
+		RegisterStRelate(db);
 		RegisterStRemoveRepeatedPoints(db);
 		RegisterStReverse(db);
 		RegisterStSimplifyPreserveTopology(db);
-		RegisterStSimplify(db);
+		RegisterStSubdivide(db);
 		RegisterStTouches(db);
 		RegisterStUnion(db);
 		RegisterStWithin(db);
 	}
 
 private:
+	static void RegisterStAsMVTGeom(DatabaseInstance &db);
 	static void RegisterStBoundary(DatabaseInstance &db);
 	static void RegisterStBuffer(DatabaseInstance &db);
-	static void RegisterStCentroid(DatabaseInstance &db);
 	static void RegisterStContains(DatabaseInstance &db);
 	static void RegisterStContainsProperly(DatabaseInstance &db);
 	static void RegisterStConvexHull(DatabaseInstance &db);
@@ -70,12 +71,13 @@ private:
 	static void RegisterStOverlaps(DatabaseInstance &db);
 	static void RegisterStPointOnSurface(DatabaseInstance &db);
 	static void RegisterStReducePrecision(DatabaseInstance &db);
+	static void RegisterStRelate(DatabaseInstance &db);
 	static void RegisterStRemoveRepeatedPoints(DatabaseInstance &db);
 	static void RegisterStReverse(DatabaseInstance &db);
 	static void RegisterStLineMerge(DatabaseInstance &db);
 	static void RegisterStMakeValid(DatabaseInstance &db);
 	static void RegisterStSimplifyPreserveTopology(DatabaseInstance &db);
-	static void RegisterStSimplify(DatabaseInstance &db);
+	static void RegisterStSubdivide(DatabaseInstance &db);
 	static void RegisterStTouches(DatabaseInstance &db);
 	static void RegisterStUnion(DatabaseInstance &db);
 	static void RegisterStWithin(DatabaseInstance &db);
@@ -2,6 +2,7 @@
 
 #include "spatial/common.hpp"
 #include "spatial/core/types.hpp"
+#include "spatial/core/geometry/point_in_polygon.hpp"
 #include "spatial/geos/functions/scalar.hpp"
 #include "spatial/geos/functions/common.hpp"
 #include "spatial/geos/geos_wrappers.hpp"
@@ -21,45 +22,253 @@ namespace geos {
 
 // Optimize binary predicate helper which use prepared geometry when one of the arguments is a constant
 // This is much more common than you would think, e.g. joins produce a lot of constant vectors.
+// Pairs whose bounding boxes are disjoint are answered from the serialized headers, without GEOS.
+// The rejects and the GEOS calls are counted in the SpatialCounters of the local state (see "spatial_profiling").
+// Pairs of a point and a (multi)polygon are answered by the native point-in-polygon kernel if the predicate passes a
+// PointInPolygonMask, and any other pairs the predicate has a native kernel for by that kernel.
 typedef char (*GEOSBinaryPredicate)(GEOSContextHandle_t ctx, const GEOSGeometry *left, const GEOSGeometry *right);
 typedef char (*GEOSPreparedBinaryPredicate)(GEOSContextHandle_t ctx, const GEOSPreparedGeometry *left,
                                             const GEOSGeometry *right);
 
+// A native kernel for a predicate, returns false for the pairs it leaves to GEOS
+typedef bool (*NativeBinaryPredicate)(const geometry_t &left, const geometry_t &right, bool &result);
+
+// The point locations for which a predicate is true when one argument is a point and the other a (multi)polygon.
+// Zero means the pair goes through GEOS for that argument order.
+struct PointInPolygonMask {
+	uint8_t polygon_left = 0;
+	uint8_t polygon_right = 0;
+};
+
 struct GEOSExecutor {
+	// A constant geometry that is only deserialized and prepared once GEOS actually needs it
+	class LazyPreparedGeometry {
+	private:
+		GEOSFunctionLocalState &lstate;
+		const geometry_t &blob;
+		GeometryPtr geom;
+		PreparedGeometryPtr prepared;
+
+	public:
+		LazyPreparedGeometry(GEOSFunctionLocalState &lstate, const geometry_t &blob) : lstate(lstate), blob(blob) {
+		}
+		const GEOSPreparedGeometry *Get() {
+			if (!prepared) {
+				auto &ctx = lstate.ctx.GetCtx();
+				geom = lstate.ctx.Deserialize(blob);
+				prepared = make_uniq_geos(ctx, GEOSPrepare_r(ctx, geom.get()));
+			}
+			return prepared.get();
+		}
+	};
+
+	// The geometry of the previous row, indexed for the point-in-polygon kernel once the same (multi)polygon repeats
+	// on the next row. The candidate pairs of a spatial join are consecutive per probe row, so a probed polygon is
+	// only indexed once for all of its pairs. Rows are compared by the address of their blob, which is only valid
+	// within the vectors of a single call.
+	class RepeatedPolygon {
+	private:
+		const char *data = nullptr;
+		idx_t size = 0;
+		bool indexed = false;
+		unique_ptr<PreparedPolygon> polygon;
+
+	public:
+		const PreparedPolygon *Get(const geometry_t &blob) {
+			string_t blob_str = blob;
+			if (blob_str.GetData() != data || blob_str.GetSize() != size) {
+				data = blob_str.GetData();
+				size = blob_str.GetSize();
+				indexed = false;
+				polygon.reset();
+				return nullptr;
+			}
+			if (!indexed) {
+				polygon = PreparedPolygon::TryCreate(blob);
+				indexed = true;
+			}
+			return polygon.get();
+		}
+	};
+
+	// The dimension of a geometry from its type, or -1 for geometry collections
+	static int GetTypeDimension(GeometryType type) {
+		switch (type) {
+		case GeometryType::POINT:
+		case GeometryType::MULTIPOINT:
+			return 0;
+		case GeometryType::LINESTRING:
+		case GeometryType::MULTILINESTRING:
+			return 1;
+		case GeometryType::POLYGON:
+		case GeometryType::MULTIPOLYGON:
+			return 2;
+		default:
+			return -1;
+		}
+	}
+
+	// An empty geometry of the given dimension, like the empty results of the GEOS overlays
+	static GeometryPtr CreateEmpty(GEOSContextHandle_t ctx, int dimension) {
+		return make_uniq_geos(ctx, dimension == 0   ? GEOSGeom_createEmptyPoint_r(ctx)
+		                           : dimension == 1 ? GEOSGeom_createEmptyLineString_r(ctx)
+		                                            : GEOSGeom_createEmptyPolygon_r(ctx));
+	}
+
+	// Whether the bounding boxes in the headers of two geometries are disjoint, in which case the result of a predicate
+	// is known without building any GEOS geometries: false for everything but ST_Disjoint. Empty geometries have no
+	// bounding box so they are never rejected here (e.g. two empty geometries are equal).
+	static bool BoundingBoxesDisjoint(const geometry_t &left, const geometry_t &right) {
+		BoundingBox left_bbox;
+		BoundingBox right_bbox;
+		if (!GeometryFactory::TryGetSerializedBoundingBox(left, left_bbox) ||
+		    !GeometryFactory::TryGetSerializedBoundingBox(right, right_bbox)) {
+			return false;
+		}
+		return !left_bbox.Intersects(right_bbox);
+	}
+
+	// Whether the bounding boxes in the headers of two geometries are further apart than the distance, in which case
+	// the geometries are too. Empty geometries are never rejected here.
+	static bool BoundingBoxesFartherThan(const geometry_t &left, const geometry_t &right, double distance) {
+		BoundingBox left_bbox;
+		BoundingBox right_bbox;
+		if (distance < 0 || !GeometryFactory::TryGetSerializedBoundingBox(left, left_bbox) ||
+		    !GeometryFactory::TryGetSerializedBoundingBox(right, right_bbox)) {
+			return false;
+		}
+		return left_bbox.DistanceSquared(right_bbox) > distance * distance;
+	}
+
+	// Answer a predicate between a point and a (multi)polygon without GEOS, returns false for any other pair
+	static bool TryPointInPolygon(const geometry_t &left, const geometry_t &right, const PointInPolygonMask &mask,
+	                              bool &result) {
+		PointLocation location;
+		if (mask.polygon_left && PointInPolygon::TryLocate(right, left, location)) {
+			result = (mask.polygon_left & static_cast<uint8_t>(location)) != 0;
+			return true;
+		}
+		if (mask.polygon_right && PointInPolygon::TryLocate(left, right, location)) {
+			result = (mask.polygon_right & static_cast<uint8_t>(location)) != 0;
+			return true;
+		}
+		return false;
+	}
+
+	// Same as above for a constant (multi)polygon with a precomputed edge index
+	static bool TryPointInPreparedPolygon(const PreparedPolygon *polygon, uint8_t mask, const geometry_t &point,
+	                                      bool &result) {
+		double x;
+		double y;
+		if (!polygon || !PointInPolygon::TryGetPoint(point, x, y)) {
+			return false;
+		}
+		result = (mask & static_cast<uint8_t>(polygon->Locate(x, y))) != 0;
+		return true;
+	}
+
+	// Same as above for a (multi)polygon that repeats over the rows, if the other geometry is a point
+	static bool TryPointInRepeatedPolygon(RepeatedPolygon &polygon, uint8_t mask, const geometry_t &polygon_blob,
+	                                      const geometry_t &point, bool &result) {
+		if (!mask || point.GetType() != GeometryType::POINT) {
+			return false;
+		}
+		return TryPointInPreparedPolygon(polygon.Get(polygon_blob), mask, point, result);
+	}
+
+	static bool TryNative(NativeBinaryPredicate native, const geometry_t &left, const geometry_t &right,
+	                      bool &result) {
+		return native && native(left, right, result);
+	}
+
 	// Symmetric: left and right can be swapped
 	// So we prepare either if one is constant
 	static void ExecuteSymmetricPreparedBinary(GEOSFunctionLocalState &lstate, Vector &left, Vector &right, idx_t count,
 	                                           Vector &result, GEOSBinaryPredicate normal,
-	                                           GEOSPreparedBinaryPredicate prepared) {
+	                                           GEOSPreparedBinaryPredicate prepared, bool result_if_disjoint = false,
+	                                           PointInPolygonMask pip_mask = PointInPolygonMask(),
+	                                           NativeBinaryPredicate native = nullptr) {
 		auto &ctx = lstate.ctx.GetCtx();
+		auto &counters = lstate.factory.counters;
 
 		if (left.GetVectorType() == VectorType::CONSTANT_VECTOR &&
 		    right.GetVectorType() != VectorType::CONSTANT_VECTOR && !ConstantVector::IsNull(left)) {
 			auto &left_blob = ConstantVector::GetData<geometry_t>(left)[0];
-			auto left_geom = lstate.ctx.Deserialize(left_blob);
-			auto left_prepared = make_uniq_geos(ctx, GEOSPrepare_r(ctx, left_geom.get()));
+			auto left_polygon = pip_mask.polygon_left ? PreparedPolygon::TryCreate(left_blob) : nullptr;
+			LazyPreparedGeometry left_prepared(lstate, left_blob);
 
 			UnaryExecutor::Execute<geometry_t, bool>(right, result, count, [&](geometry_t &right_blob) {
+				bool native_result;
+				if (BoundingBoxesDisjoint(left_blob, right_blob)) {
+					counters.bbox_rejects++;
+					return result_if_disjoint;
+				}
+				if (TryPointInPreparedPolygon(left_polygon.get(), pip_mask.polygon_left, right_blob, native_result) ||
+				    TryPointInPolygon(left_blob, right_blob, pip_mask, native_result) ||
+				    TryNative(native, left_blob, right_blob, native_result)) {
+					return native_result;
+				}
 				auto right_geometry = lstate.ctx.Deserialize(right_blob);
-				auto ok = prepared(ctx, left_prepared.get(), right_geometry.get());
+				counters.geos_predicate_calls++;
+				auto ok = prepared(ctx, left_prepared.Get(), right_geometry.get());
 				return ok == 1;
 			});
 		} else if (right.GetVectorType() == VectorType::CONSTANT_VECTOR &&
 		           left.GetVectorType() != VectorType::CONSTANT_VECTOR && !ConstantVector::IsNull(right)) {
 			auto &right_blob = ConstantVector::GetData<geometry_t>(right)[0];
-			auto right_geom = lstate.ctx.Deserialize(right_blob);
-			auto right_prepared = make_uniq_geos(ctx, GEOSPrepare_r(ctx, right_geom.get()));
+			auto right_polygon = pip_mask.polygon_right ? PreparedPolygon::TryCreate(right_blob) : nullptr;
+			LazyPreparedGeometry right_prepared(lstate, right_blob);
 
 			UnaryExecutor::Execute<geometry_t, bool>(left, result, count, [&](geometry_t &left_blob) {
+				bool native_result;
+				if (BoundingBoxesDisjoint(left_blob, right_blob)) {
+					counters.bbox_rejects++;
+					return result_if_disjoint;
+				}
+				if (TryPointInPreparedPolygon(right_polygon.get(), pip_mask.polygon_right, left_blob, native_result) ||
+				    TryPointInPolygon(left_blob, right_blob, pip_mask, native_result) ||
+				    TryNative(native, left_blob, right_blob, native_result)) {
+					return native_result;
+				}
 				auto left_geometry = lstate.ctx.Deserialize(left_blob);
-				auto ok = prepared(ctx, right_prepared.get(), left_geometry.get());
+				counters.geos_predicate_calls++;
+				auto ok = prepared(ctx, right_prepared.Get(), left_geometry.get());
 				return ok == 1;
 			});
 		} else {
+			// Neither side is constant, but the same geometry is often repeated over many rows and chunks (e.g. the
+			// polygon side of a join), so prepare the larger of the two through the per-thread cache
+			auto &cache = lstate.GetPreparedCache();
+			RepeatedPolygon left_polygon;
+			RepeatedPolygon right_polygon;
 			BinaryExecutor::Execute<geometry_t, geometry_t, bool>(
 			    left, right, result, count, [&](geometry_t &left_blob, geometry_t &right_blob) {
+				    bool native_result;
+				    if (BoundingBoxesDisjoint(left_blob, right_blob)) {
+					    counters.bbox_rejects++;
+					    return result_if_disjoint;
+				    }
+				    if (TryPointInRepeatedPolygon(left_polygon, pip_mask.polygon_left, left_blob, right_blob,
+				                                  native_result) ||
+				        TryPointInRepeatedPolygon(right_polygon, pip_mask.polygon_right, right_blob, left_blob,
+				                                  native_result) ||
+				        TryPointInPolygon(left_blob, right_blob, pip_mask, native_result) ||
+				        TryNative(native, left_blob, right_blob, native_result)) {
+					    return native_result;
+				    }
+				    auto left_is_larger = string_t(left_blob).GetSize() >= string_t(right_blob).GetSize();
+				    auto &prepare_blob = left_is_larger ? left_blob : right_blob;
+				    auto &other_blob = left_is_larger ? right_blob : left_blob;
+				    auto prepared_geom = cache.Get(prepare_blob);
+				    if (prepared_geom) {
+					    counters.prepared_cache_hits++;
+					    auto other_geometry = lstate.ctx.Deserialize(other_blob);
+					    counters.geos_predicate_calls++;
+					    return prepared(ctx, prepared_geom, other_geometry.get()) == 1;
+				    }
 				    auto left_geometry = lstate.ctx.Deserialize(left_blob);
 				    auto right_geometry = lstate.ctx.Deserialize(right_blob);
+				    counters.geos_predicate_calls++;
 				    auto ok = normal(ctx, left_geometry.get(), right_geometry.get());
 				    return ok == 1;
 			    });
@@ -70,26 +279,86 @@ struct GEOSExecutor {
 	// So we only prepare left if left is constant
 	static void ExecuteNonSymmetricPreparedBinary(GEOSFunctionLocalState &lstate, Vector &left, Vector &right,
 	                                              idx_t count, Vector &result, GEOSBinaryPredicate normal,
-	                                              GEOSPreparedBinaryPredicate prepared) {
+	                                              GEOSPreparedBinaryPredicate prepared, bool result_if_disjoint = false,
+	                                              PointInPolygonMask pip_mask = PointInPolygonMask()) {
 		auto &ctx = lstate.ctx.GetCtx();
+		auto &counters = lstate.factory.counters;
 
 		// Optimize: if one of the arguments is a constant, we can prepare it once and reuse it
 		if (left.GetVectorType() == VectorType::CONSTANT_VECTOR &&
 		    right.GetVectorType() != VectorType::CONSTANT_VECTOR && !ConstantVector::IsNull(left)) {
 			auto &left_blob = ConstantVector::GetData<geometry_t>(left)[0];
-			auto left_geom = lstate.ctx.Deserialize(left_blob);
-			auto left_prepared = make_uniq_geos(ctx, GEOSPrepare_r(ctx, left_geom.get()));
+			auto left_polygon = pip_mask.polygon_left ? PreparedPolygon::TryCreate(left_blob) : nullptr;
+			LazyPreparedGeometry left_prepared(lstate, left_blob);
 
 			UnaryExecutor::Execute<geometry_t, bool>(right, result, count, [&](geometry_t &right_blob) {
+				bool native_result;
+				if (BoundingBoxesDisjoint(left_blob, right_blob)) {
+					counters.bbox_rejects++;
+					return result_if_disjoint;
+				}
+				if (TryPointInPreparedPolygon(left_polygon.get(), pip_mask.polygon_left, right_blob, native_result) ||
+				    TryPointInPolygon(left_blob, right_blob, pip_mask, native_result)) {
+					return native_result;
+				}
+				auto right_geometry = lstate.ctx.Deserialize(right_blob);
+				counters.geos_predicate_calls++;
+				auto ok = prepared(ctx, left_prepared.Get(), right_geometry.get());
+				return ok == 1;
+			});
+		} else if (right.GetVectorType() == VectorType::CONSTANT_VECTOR &&
+		           left.GetVectorType() != VectorType::CONSTANT_VECTOR && !ConstantVector::IsNull(right) &&
+		           pip_mask.polygon_right) {
+			// A constant polygon on the right can not be prepared for GEOS, but it can still be indexed for the
+			// point-in-polygon kernel
+			auto &right_blob = ConstantVector::GetData<geometry_t>(right)[0];
+			auto right_polygon = PreparedPolygon::TryCreate(right_blob);
+
+			UnaryExecutor::Execute<geometry_t, bool>(left, result, count, [&](geometry_t &left_blob) {
+				bool native_result;
+				if (BoundingBoxesDisjoint(left_blob, right_blob)) {
+					counters.bbox_rejects++;
+					return result_if_disjoint;
+				}
+				if (TryPointInPreparedPolygon(right_polygon.get(), pip_mask.polygon_right, left_blob, native_result) ||
+				    TryPointInPolygon(left_blob, right_blob, pip_mask, native_result)) {
+					return native_result;
+				}
+				auto left_geometry = lstate.ctx.Deserialize(left_blob);
 				auto right_geometry = lstate.ctx.Deserialize(right_blob);
-				auto ok = prepared(ctx, left_prepared.get(), right_geometry.get());
+				counters.geos_predicate_calls++;
+				auto ok = normal(ctx, left_geometry.get(), right_geometry.get());
 				return ok == 1;
 			});
 		} else {
+			// Prepare left through the per-thread cache if it keeps repeating
+			auto &cache = lstate.GetPreparedCache();
+			RepeatedPolygon left_polygon;
+			RepeatedPolygon right_polygon;
 			BinaryExecutor::Execute<geometry_t, geometry_t, bool>(
 			    left, right, result, count, [&](geometry_t &left_blob, geometry_t &right_blob) {
+				    bool native_result;
+				    if (BoundingBoxesDisjoint(left_blob, right_blob)) {
+					    counters.bbox_rejects++;
+					    return result_if_disjoint;
+				    }
+				    if (TryPointInRepeatedPolygon(left_polygon, pip_mask.polygon_left, left_blob, right_blob,
+				                                  native_result) ||
+				        TryPointInRepeatedPolygon(right_polygon, pip_mask.polygon_right, right_blob, left_blob,
+				                                  native_result) ||
+				        TryPointInPolygon(left_blob, right_blob, pip_mask, native_result)) {
+					    return native_result;
+				    }
+				    auto left_prepared = cache.Get(left_blob);
+				    if (left_prepared) {
+					    counters.prepared_cache_hits++;
+					    auto right_geometry = lstate.ctx.Deserialize(right_blob);
+					    counters.geos_predicate_calls++;
+					    return prepared(ctx, left_prepared, right_geometry.get()) == 1;
+				    }
 				    auto left_geometry = lstate.ctx.Deserialize(left_blob);
 				    auto right_geometry = lstate.ctx.Deserialize(right_blob);
+				    counters.geos_predicate_calls++;
 				    auto ok = normal(ctx, left_geometry.get(), right_geometry.get());
 				    return ok == 1;
 			    });
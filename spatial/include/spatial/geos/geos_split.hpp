@@ -0,0 +1,48 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/geos/geos_wrappers.hpp"
+
+#include <functional>
+
+namespace spatial {
+
+namespace geos {
+
+//------------------------------------------------------------------------------
+// Split Executor
+//------------------------------------------------------------------------------
+// DuckDB parallelizes over rows, so a single huge geometry (e.g. a national boundary with millions of vertices) is
+// buffered or unioned on one thread while the others idle. With the "spatial_split_threshold" setting, the heaviest
+// GEOS functions split inputs with more vertices than that spatially: the extent of the inputs is halved along its
+// longer side, like ST_Subdivide does, until no cell holds more than its share of the vertices. The operation then
+// runs on the pieces of every cell on the threads of the task scheduler, and the results are stitched back together
+// with a cascaded union.
+//
+// This is only correct for operations that distribute over a union of their inputs, e.g. a buffer by a positive
+// radius or the union of two polygons, and the result can differ from the unsplit one in the vertices along the cuts.
+struct GEOSSplitExecutor {
+	// Give up halving a piece further after this many levels, e.g. when clipping keeps adding vertices
+	static constexpr idx_t MAX_DEPTH = 50;
+	// Cells are not made smaller than this, so the threads are not kept busy with clipping and stitching instead
+	static constexpr idx_t MIN_CELL_VERTICES = 4096;
+
+	// The operation on the pieces of the inputs in one cell. A piece is null if its input has nothing in the cell.
+	using CellFunction = std::function<GeometryPtr(GEOSContextHandle_t ctx, vector<GeometryPtr> &pieces)>;
+
+	// Split an extent (xmin, ymin, xmax, ymax) in half along its longer side
+	static void HalveExtent(double xmin, double ymin, double xmax, double ymax, double halves[2][4]);
+
+	// The vertex count above which inputs are split, 0 if splitting is disabled
+	static idx_t GetThreshold(ClientContext &context);
+	// Whether the inputs together have more vertices than the threshold
+	static bool ShouldSplit(GEOSContextHandle_t ctx, idx_t threshold, const vector<const GEOSGeometry *> &geoms);
+
+	// Split the inputs into cells, run the function on every cell in parallel, and union the results. The inputs and
+	// the result belong to the context of the wrapper.
+	static GeometryPtr Execute(ClientContext &context, GeosContextWrapper &wrapper,
+	                           const vector<const GEOSGeometry *> &geoms, const CellFunction &fun);
+};
+
+} // namespace geos
+
+} // namespace spatial
@@ -1,6 +1,8 @@
 #pragma once
 #include "spatial/common.hpp"
 #include "spatial/core/geometry/geometry.hpp"
+
+#include "duckdb/common/atomic.hpp"
 #include "spatial/core/geometry/geometry_factory.hpp"
 #include "geos_c.h"
 
@@ -48,6 +50,14 @@ struct GeosDeleter<const GEOSPreparedGeometry> {
 	}
 };
 
+template <>
+struct GeosDeleter<GEOSBufferParams> {
+	GEOSContextHandle_t ctx;
+	void operator()(GEOSBufferParams *ptr) const {
+		GEOSBufferParams_destroy_r(ctx, ptr);
+	}
+};
+
 template <class T>
 unique_ptr<T, GeosDeleter<T>> make_uniq_geos(GEOSContextHandle_t ctx, T *ptr) {
 	return unique_ptr<T, GeosDeleter<T>>(ptr, GeosDeleter<T> {ctx});
@@ -167,20 +177,62 @@ struct WKTWriter {
 	}
 };
 
+//------------------------------------------------------------------------------
+// Interrupts
+//------------------------------------------------------------------------------
+// GEOS 3.12 only has a process-wide interrupt callback, which it invokes regularly during long running operations
+// (overlays, buffers, unions). While a scope is alive on a thread, the callback stops the GEOS operations of that
+// thread with an InterruptException once the query of the scope is interrupted. Scopes nest, the innermost counts.
+class GeosInterruptScope {
+public:
+	explicit GeosInterruptScope(const atomic<bool> &interrupted);
+	explicit GeosInterruptScope(ClientContext &context);
+	~GeosInterruptScope();
+
+	// Throw an InterruptException if the query was interrupted, to check between rows
+	void Check() const {
+		if (interrupted.load(std::memory_order_relaxed)) {
+			throw InterruptException();
+		}
+	}
+
+	// Whether the innermost scope of the calling thread was interrupted
+	static bool IsInterrupted();
+	// Install the callback into GEOS
+	static void RegisterCallback();
+
+private:
+	const atomic<bool> &interrupted;
+	const atomic<bool> *previous;
+};
+
+// A GEOS context with the helper objects that are created on first use and kept with it
+struct GeosPooledContext;
+
+// Wraps a GEOS context that is taken from a process-wide pool and returned to it on destruction, together with its
+// deserializer and WKB reader and WKT writer. Every spatial expression and aggregate of every thread creates a
+// wrapper, so a query with many GEOS expressions would otherwise set up hundreds of contexts. Contexts are checked
+// out rather than bound to a worker thread, since a DuckDB task may resume on another thread while its expression
+// states (and the GEOS objects they hold) stay alive.
 struct GeosContextWrapper {
 private:
 	GEOSContextHandle_t ctx;
+	unique_ptr<GeosPooledContext> pooled;
 
 public:
-	GeosContextWrapper() {
-		ctx = GEOS_init_r();
-		GEOSContext_setErrorMessageHandler_r(ctx, ErrorHandler, (void *)nullptr);
-	}
-	~GeosContextWrapper() {
-		GEOS_finish_r(ctx);
-	}
+	// Where Deserialize counts its calls, if set
+	core::SpatialCounters *counters = nullptr;
+	// Whether Serialize writes double precision bounding boxes, see "spatial_double_precision_bbox"
+	bool double_bbox = false;
+
+	GeosContextWrapper();
+	~GeosContextWrapper();
 
 	static void ErrorHandler(const char *message, void *userdata) {
+		// GEOS reports the exception thrown by the interrupt callback as an error
+		if (GeosInterruptScope::IsInterrupted()) {
+			throw InterruptException();
+		}
 		throw InvalidInputException(message);
 	}
 
@@ -204,12 +256,20 @@ public:
 		return WKTReader(ctx);
 	}
 
+	// A reader and a writer that are kept with the pooled context. Callers set the options of the writer they need.
+	const WKBReader &GetWKBReader();
+	const WKTWriter &GetWKTWriter();
+
 	unique_ptr<GEOSGeometry, GeosDeleter<GEOSGeometry>> Deserialize(const geometry_t &blob);
 	geometry_t Serialize(Vector &result, const unique_ptr<GEOSGeometry, GeosDeleter<GEOSGeometry>> &geom);
 };
 
 GEOSGeometry *DeserializeGEOSGeometry(const geometry_t &blob, GEOSContextHandle_t ctx);
-geometry_t SerializeGEOSGeometry(Vector &result, const GEOSGeometry *geom, GEOSContextHandle_t ctx);
+geometry_t SerializeGEOSGeometry(Vector &result, const GEOSGeometry *geom, GEOSContextHandle_t ctx,
+                                 bool double_bbox = false);
+// Serialize into memory of the given allocator, e.g. for partial results that are kept in aggregate states
+AllocatedData SerializeGEOSGeometry(Allocator &allocator, const GEOSGeometry *geom, GEOSContextHandle_t ctx,
+                                    bool double_bbox = false);
 
 } // namespace geos
 
@@ -0,0 +1,50 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/geos/geos_wrappers.hpp"
+
+#include "duckdb/common/list.hpp"
+#include "duckdb/common/unordered_map.hpp"
+
+namespace spatial {
+
+namespace geos {
+
+using PreparedGeometryPtr = unique_ptr<const GEOSPreparedGeometry, GeosDeleter<const GEOSPreparedGeometry>>;
+
+// A per-thread LRU cache of prepared geometries, bounded by the size of the cached blobs.
+// After a spatial join the same polygon is usually repeated over many rows and chunks, in flat or dictionary
+// vectors, so it pays off to prepare it once instead of deserializing it and running the unprepared predicate for
+// every row. Entries are looked up by a hash of the start of the blob and verified against the full blob, so the same
+// geometry is found even if it is stored at a different address in the next chunk.
+class PreparedGeometryCache {
+public:
+	static constexpr idx_t DEFAULT_MAX_BYTES = 32 * 1024 * 1024;
+
+	explicit PreparedGeometryCache(GEOSContextHandle_t ctx, idx_t max_bytes = DEFAULT_MAX_BYTES);
+
+	// Get the prepared geometry of a blob, or nullptr if it is not worth preparing (yet). A geometry is only prepared
+	// the second time it is seen, so the cost of preparing is not paid for geometries that only occur once.
+	const GEOSPreparedGeometry *Get(const geometry_t &blob);
+
+private:
+	struct Entry {
+		hash_t key;
+		string blob;
+		GeometryPtr geometry;
+		// Declared after the geometry, so it is destroyed first
+		PreparedGeometryPtr prepared;
+	};
+
+	void Evict();
+
+	GEOSContextHandle_t ctx;
+	idx_t max_bytes;
+	idx_t size_in_bytes = 0;
+	// Most recently used first
+	list<Entry> entries;
+	unordered_map<hash_t, list<Entry>::iterator> index;
+};
+
+} // namespace geos
+
+} // namespace spatial
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "spatial/common.hpp"
+
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/list.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/unordered_map.hpp"
+
+#include "proj.h"
+
+#include <mutex>
+
+namespace spatial {
+
+namespace proj {
+
+//------------------------------------------------------------------------------
+// ProjGridCache
+//------------------------------------------------------------------------------
+// The grids of high accuracy datum shifts (NTv2, GeoTIFF geoid grids, ...), read by PROJ through the file system of
+// the client instead of its own file access, so that they can be served from anywhere DuckDB can read, e.g. S3 with
+// httpfs. The "spatial_proj_grid_path" setting is the directory (or URL prefix) PROJ searches for grids.
+//
+// Every PROJ context has its own file handles, and there is a context per thread, so the grids are kept in a
+// process-wide cache instead: a grid is read once and then shared by all threads and queries. The cache holds at most
+// "spatial_proj_grid_cache_size" bytes and evicts the least recently opened grids first. Grids larger than that are
+// read from the file system on demand instead of being cached.
+class ProjGridCache {
+public:
+	// Make a PROJ context search and read its grids through the cache, if a grid path is set
+	static void Attach(PJ_CONTEXT *ctx, ClientContext &context);
+
+	struct Grid {
+		string path;
+		string data;
+		// Whether the data is complete, other threads may still be reading it otherwise
+		bool ready = false;
+		// The bytes counted against the capacity, set once the grid is loaded
+		idx_t charged_size = 0;
+		std::once_flag loaded;
+	};
+
+	static ProjGridCache &Get();
+
+	// The cached grid at a path, or nullptr if it is not cached or still being read
+	shared_ptr<Grid> TryGet(const string &path);
+	// Read a grid from an open file into the cache, unless another thread already did
+	shared_ptr<Grid> Load(FileHandle &file, const string &path, idx_t capacity);
+
+private:
+	mutex lock;
+	// Most recently opened first
+	list<shared_ptr<Grid>> grids;
+	unordered_map<string, list<shared_ptr<Grid>>::iterator> index;
+	idx_t size = 0;
+
+	void Evict(idx_t capacity);
+};
+
+} // namespace proj
+
+} // namespace spatial
@@ -11,6 +11,8 @@ namespace proj {
 struct ProjModule {
 public:
 	static PJ_CONTEXT *GetThreadProjContext();
+	// Set up the embedded proj.db, on first call only
+	static void Initialize();
 	static void Register(DatabaseInstance &db);
 };
 
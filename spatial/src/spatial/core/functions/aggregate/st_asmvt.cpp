@@ -0,0 +1,533 @@
+#include "duckdb/parser/parsed_data/create_aggregate_function_info.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/common/vector_operations/vector_operations.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/geometry/geometry_processor.hpp"
+#include "spatial/core/functions/aggregate.hpp"
+
+#include "protozero/pbf_writer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace spatial {
+
+namespace core {
+
+namespace pz = protozero;
+
+//------------------------------------------------------------------------
+// Mapbox Vector Tile encoding
+//------------------------------------------------------------------------
+// See https://github.com/mapbox/vector-tile-spec/blob/master/2.1/vector_tile.proto
+
+enum class MVTGeometryType : uint32_t { UNKNOWN = 0, POINT = 1, LINESTRING = 2, POLYGON = 3 };
+
+enum class MVTCommand : uint32_t { MOVE_TO = 1, LINE_TO = 2, CLOSE_PATH = 7 };
+
+// Encodes a geometry in tile coordinates (e.g. returned by ST_AsMVTGeom) into MVT geometry commands. Coordinates are
+// rounded to integers, repeated vertices are dropped and polygon rings are oriented the way the spec requires.
+class MVTGeometryEncoder final : GeometryProcessor<void> {
+private:
+	// Anything further out than this is not in tile coordinates in the first place
+	static constexpr double MAX_COORDINATE = 1 << 30;
+
+	vector<uint32_t> *commands = nullptr;
+	int32_t cursor_x = 0;
+	int32_t cursor_y = 0;
+	MVTGeometryType type = MVTGeometryType::UNKNOWN;
+	bool is_mixed = false;
+	vector<std::pair<int32_t, int32_t>> points;
+	vector<std::pair<int32_t, int32_t>> vertices;
+
+	void SetType(MVTGeometryType new_type) {
+		if (type == MVTGeometryType::UNKNOWN) {
+			type = new_type;
+		} else if (type != new_type) {
+			is_mixed = true;
+		}
+	}
+
+	static int32_t Round(double value) {
+		if (!(std::abs(value) < MAX_COORDINATE)) {
+			throw InvalidInputException("ST_AsMVT: geometry coordinates are not in tile coordinates, use ST_AsMVTGeom");
+		}
+		return static_cast<int32_t>(std::round(value));
+	}
+
+	void LoadVertices(const VertexData &data) {
+		vertices.clear();
+		for (uint32_t i = 0; i < data.count; i++) {
+			auto x = Round(Load<double>(data.data[0] + i * data.stride[0]));
+			auto y = Round(Load<double>(data.data[1] + i * data.stride[1]));
+			if (vertices.empty() || vertices.back().first != x || vertices.back().second != y) {
+				vertices.emplace_back(x, y);
+			}
+		}
+	}
+
+	void WriteCommand(MVTCommand command, uint32_t count) {
+		commands->push_back((static_cast<uint32_t>(command) & 0x7) | (count << 3));
+	}
+
+	void WriteVertex(const std::pair<int32_t, int32_t> &vertex) {
+		commands->push_back(pz::encode_zigzag32(vertex.first - cursor_x));
+		commands->push_back(pz::encode_zigzag32(vertex.second - cursor_y));
+		cursor_x = vertex.first;
+		cursor_y = vertex.second;
+	}
+
+	void WritePath() {
+		WriteCommand(MVTCommand::MOVE_TO, 1);
+		WriteVertex(vertices[0]);
+		WriteCommand(MVTCommand::LINE_TO, vertices.size() - 1);
+		for (idx_t i = 1; i < vertices.size(); i++) {
+			WriteVertex(vertices[i]);
+		}
+	}
+
+	void ProcessPoint(const VertexData &data) override {
+		if (data.IsEmpty()) {
+			return;
+		}
+		SetType(MVTGeometryType::POINT);
+		// Written all at once with a single MoveTo command in the end, in case this is a multipoint
+		points.emplace_back(Round(Load<double>(data.data[0])), Round(Load<double>(data.data[1])));
+	}
+
+	void ProcessLineString(const VertexData &data) override {
+		LoadVertices(data);
+		if (vertices.size() < 2) {
+			return;
+		}
+		SetType(MVTGeometryType::LINESTRING);
+		WritePath();
+	}
+
+	void ProcessPolygon(PolygonState &state) override {
+		bool is_shell = true;
+		bool skip_holes = false;
+		while (!state.IsDone()) {
+			LoadVertices(state.Next());
+			if (skip_holes) {
+				continue;
+			}
+			// The ring is closed with a command instead of repeating the first vertex
+			if (vertices.size() > 1 && vertices.front() == vertices.back()) {
+				vertices.pop_back();
+			}
+			int64_t area = 0;
+			for (idx_t i = 0; i < vertices.size(); i++) {
+				auto &a = vertices[i];
+				auto &b = vertices[(i + 1) % vertices.size()];
+				area += static_cast<int64_t>(a.first) * b.second - static_cast<int64_t>(b.first) * a.second;
+			}
+			if (vertices.size() < 3 || area == 0) {
+				// A collapsed shell takes its holes with it
+				skip_holes = is_shell;
+				is_shell = false;
+				continue;
+			}
+			// With y pointing down, the shell has to have a positive area and the holes a negative one
+			if ((is_shell && area < 0) || (!is_shell && area > 0)) {
+				std::reverse(vertices.begin(), vertices.end());
+			}
+			is_shell = false;
+			SetType(MVTGeometryType::POLYGON);
+			WritePath();
+			WriteCommand(MVTCommand::CLOSE_PATH, 1);
+		}
+	}
+
+	void ProcessCollection(CollectionState &state) override {
+		while (!state.IsDone()) {
+			state.Next();
+		}
+	}
+
+public:
+	// Append the commands of a geometry to the buffer. Returns UNKNOWN if there was nothing to encode, or if the
+	// geometry mixes e.g. points and polygons, which a single feature can not hold.
+	MVTGeometryType Encode(const geometry_t &geom, vector<uint32_t> &buffer) {
+		commands = &buffer;
+		cursor_x = 0;
+		cursor_y = 0;
+		type = MVTGeometryType::UNKNOWN;
+		is_mixed = false;
+		points.clear();
+		Process(geom);
+		if (!points.empty()) {
+			WriteCommand(MVTCommand::MOVE_TO, points.size());
+			for (auto &point : points) {
+				WriteVertex(point);
+			}
+		}
+		commands = nullptr;
+		return is_mixed ? MVTGeometryType::UNKNOWN : type;
+	}
+};
+
+struct MVTFeature {
+	MVTGeometryType type;
+	vector<uint32_t> geometry;
+	// The key index and the encoded value of every non NULL property
+	vector<std::pair<uint32_t, string>> properties;
+};
+
+//------------------------------------------------------------------------
+// Bind
+//------------------------------------------------------------------------
+
+// How a property is written as a value in the tile
+enum class MVTValueKind : uint8_t { STRING, FLOAT, DOUBLE, SIGNED, UNSIGNED, BOOLEAN };
+
+struct MVTBindData : public FunctionData {
+	string layer_name = "default";
+	uint32_t extent = 4096;
+	idx_t geometry_field_idx = DConstants::INVALID_INDEX;
+	// The layer keys, and the struct field, value kind and type to cast to of every property
+	vector<string> keys;
+	vector<idx_t> key_fields;
+	vector<MVTValueKind> key_kinds;
+	vector<LogicalType> key_types;
+
+public:
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<MVTBindData>(*this);
+	}
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<MVTBindData>();
+		return layer_name == other.layer_name && extent == other.extent &&
+		       geometry_field_idx == other.geometry_field_idx && keys == other.keys;
+	}
+};
+
+static void GetValueKind(const LogicalType &type, MVTValueKind &kind, LogicalType &target) {
+	switch (type.id()) {
+	case LogicalTypeId::BOOLEAN:
+		kind = MVTValueKind::BOOLEAN;
+		target = LogicalType::BOOLEAN;
+		break;
+	case LogicalTypeId::TINYINT:
+	case LogicalTypeId::SMALLINT:
+	case LogicalTypeId::INTEGER:
+	case LogicalTypeId::BIGINT:
+		kind = MVTValueKind::SIGNED;
+		target = LogicalType::BIGINT;
+		break;
+	case LogicalTypeId::UTINYINT:
+	case LogicalTypeId::USMALLINT:
+	case LogicalTypeId::UINTEGER:
+	case LogicalTypeId::UBIGINT:
+		kind = MVTValueKind::UNSIGNED;
+		target = LogicalType::UBIGINT;
+		break;
+	case LogicalTypeId::FLOAT:
+		kind = MVTValueKind::FLOAT;
+		target = LogicalType::FLOAT;
+		break;
+	case LogicalTypeId::DOUBLE:
+	case LogicalTypeId::DECIMAL:
+	case LogicalTypeId::HUGEINT:
+	case LogicalTypeId::UHUGEINT:
+		kind = MVTValueKind::DOUBLE;
+		target = LogicalType::DOUBLE;
+		break;
+	default:
+		kind = MVTValueKind::STRING;
+		target = LogicalType::VARCHAR;
+		break;
+	}
+}
+
+static Value GetConstantArgument(ClientContext &context, Expression &arg, const char *name) {
+	if (arg.HasParameter()) {
+		throw BinderException("ST_AsMVT: parameters are not supported for the %s", name);
+	}
+	if (!arg.IsFoldable()) {
+		throw BinderException("ST_AsMVT: the %s must be a constant", name);
+	}
+	auto value = ExpressionExecutor::EvaluateScalar(context, arg);
+	if (value.IsNull()) {
+		throw BinderException("ST_AsMVT: the %s can not be NULL", name);
+	}
+	return value;
+}
+
+static unique_ptr<FunctionData> Bind(ClientContext &context, AggregateFunction &function,
+                                     vector<unique_ptr<Expression>> &arguments) {
+	auto &row_type = arguments[0]->return_type;
+	if (row_type.id() != LogicalTypeId::STRUCT) {
+		throw BinderException("ST_AsMVT: the first argument must be a STRUCT holding the geometry and properties");
+	}
+	function.arguments[0] = row_type;
+
+	auto bind_data = make_uniq<MVTBindData>();
+	if (arguments.size() > 1) {
+		bind_data->layer_name = GetConstantArgument(context, *arguments[1], "layer name").ToString();
+	}
+	if (arguments.size() > 2) {
+		auto extent = GetConstantArgument(context, *arguments[2], "extent").GetValue<int32_t>();
+		if (extent <= 0) {
+			throw BinderException("ST_AsMVT: the extent must be positive");
+		}
+		bind_data->extent = static_cast<uint32_t>(extent);
+	}
+	string geometry_name;
+	if (arguments.size() > 3) {
+		geometry_name = GetConstantArgument(context, *arguments[3], "geometry column name").ToString();
+	}
+
+	// The named geometry field, or the first one
+	auto &fields = StructType::GetChildTypes(row_type);
+	for (idx_t field_idx = 0; field_idx < fields.size(); field_idx++) {
+		auto &field = fields[field_idx];
+		if (field.second != GeoTypes::GEOMETRY()) {
+			continue;
+		}
+		if (geometry_name.empty() ? bind_data->geometry_field_idx == DConstants::INVALID_INDEX
+		                          : StringUtil::CIEquals(field.first, geometry_name)) {
+			bind_data->geometry_field_idx = field_idx;
+		}
+	}
+	if (bind_data->geometry_field_idx == DConstants::INVALID_INDEX) {
+		if (geometry_name.empty()) {
+			throw BinderException("ST_AsMVT: the row does not have a GEOMETRY field");
+		}
+		throw BinderException("ST_AsMVT: the row does not have a GEOMETRY field named '%s'", geometry_name);
+	}
+
+	// Every other field is a property
+	for (idx_t field_idx = 0; field_idx < fields.size(); field_idx++) {
+		if (field_idx == bind_data->geometry_field_idx) {
+			continue;
+		}
+		MVTValueKind kind;
+		LogicalType target;
+		GetValueKind(fields[field_idx].second, kind, target);
+		bind_data->keys.push_back(fields[field_idx].first);
+		bind_data->key_fields.push_back(field_idx);
+		bind_data->key_kinds.push_back(kind);
+		bind_data->key_types.push_back(target);
+	}
+
+	return std::move(bind_data);
+}
+
+//------------------------------------------------------------------------
+// Aggregate
+//------------------------------------------------------------------------
+
+struct MVTAggState {
+	// The features seen so far
+	vector<MVTFeature> *features;
+};
+
+struct MVTAggFunction {
+	template <class STATE>
+	static void Initialize(STATE &state) {
+		state.features = nullptr;
+	}
+
+	template <class STATE, class OP>
+	static void Combine(const STATE &source, STATE &target, AggregateInputData &) {
+		if (!source.features) {
+			return;
+		}
+		if (!target.features) {
+			target.features = new vector<MVTFeature>(*source.features);
+			return;
+		}
+		target.features->insert(target.features->end(), source.features->begin(), source.features->end());
+	}
+
+	template <class T, class STATE>
+	static void Finalize(STATE &state, T &target, AggregateFinalizeData &finalize_data) {
+		if (!state.features || state.features->empty()) {
+			// A tile without layers
+			target = StringVector::AddStringOrBlob(finalize_data.result, string_t(""));
+			return;
+		}
+		auto &bind_data = finalize_data.input.bind_data->Cast<MVTBindData>();
+
+		// Every distinct value is only stored once per layer
+		vector<const string *> values;
+		unordered_map<string, uint32_t> value_index;
+		vector<uint32_t> tags;
+
+		string tile;
+		{
+			pz::pbf_writer tile_writer(tile);
+			pz::pbf_writer layer_writer(tile_writer, 3);
+			layer_writer.add_uint32(15, 2);
+			layer_writer.add_string(1, bind_data.layer_name);
+			for (auto &feature : *state.features) {
+				tags.clear();
+				for (auto &property : feature.properties) {
+					auto entry = value_index.emplace(property.second, values.size());
+					if (entry.second) {
+						values.push_back(&entry.first->first);
+					}
+					tags.push_back(property.first);
+					tags.push_back(entry.first->second);
+				}
+				pz::pbf_writer feature_writer(layer_writer, 2);
+				feature_writer.add_packed_uint32(2, tags.begin(), tags.end());
+				feature_writer.add_enum(3, static_cast<int32_t>(feature.type));
+				feature_writer.add_packed_uint32(4, feature.geometry.begin(), feature.geometry.end());
+			}
+			for (auto &key : bind_data.keys) {
+				layer_writer.add_string(3, key);
+			}
+			for (auto &value : values) {
+				layer_writer.add_message(4, *value);
+			}
+			layer_writer.add_uint32(5, bind_data.extent);
+		}
+		target = StringVector::AddStringOrBlob(finalize_data.result, string_t(tile.data(), tile.size()));
+	}
+
+	template <class STATE>
+	static void Destroy(STATE &state, AggregateInputData &) {
+		if (state.features) {
+			delete state.features;
+			state.features = nullptr;
+		}
+	}
+};
+
+static void EncodeValue(MVTValueKind kind, UnifiedVectorFormat &format, idx_t idx, string &buffer) {
+	pz::pbf_writer writer(buffer);
+	switch (kind) {
+	case MVTValueKind::STRING: {
+		auto &str = UnifiedVectorFormat::GetData<string_t>(format)[idx];
+		writer.add_string(1, str.GetDataUnsafe(), str.GetSize());
+		break;
+	}
+	case MVTValueKind::FLOAT:
+		writer.add_float(2, UnifiedVectorFormat::GetData<float>(format)[idx]);
+		break;
+	case MVTValueKind::DOUBLE:
+		writer.add_double(3, UnifiedVectorFormat::GetData<double>(format)[idx]);
+		break;
+	case MVTValueKind::SIGNED: {
+		auto value = UnifiedVectorFormat::GetData<int64_t>(format)[idx];
+		if (value < 0) {
+			writer.add_sint64(6, value);
+		} else {
+			writer.add_uint64(5, static_cast<uint64_t>(value));
+		}
+		break;
+	}
+	case MVTValueKind::UNSIGNED:
+		writer.add_uint64(5, UnifiedVectorFormat::GetData<uint64_t>(format)[idx]);
+		break;
+	case MVTValueKind::BOOLEAN:
+		writer.add_bool(7, UnifiedVectorFormat::GetData<bool>(format)[idx]);
+		break;
+	}
+}
+
+static void Update(Vector inputs[], AggregateInputData &aggr_input_data, idx_t input_count, Vector &state_vector,
+                   idx_t count) {
+	auto &bind_data = aggr_input_data.bind_data->Cast<MVTBindData>();
+
+	UnifiedVectorFormat state_format;
+	state_vector.ToUnifiedFormat(count, state_format);
+	auto states = UnifiedVectorFormat::GetData<MVTAggState *>(state_format);
+
+	// Work on a flat struct so that the fields line up with the rows
+	auto &input = inputs[0];
+	unique_ptr<Vector> flat_rows;
+	if (input.GetVectorType() != VectorType::FLAT_VECTOR) {
+		flat_rows = make_uniq<Vector>(input.GetType(), count);
+		VectorOperations::Copy(input, *flat_rows, count, 0, 0);
+	}
+	auto &rows = flat_rows ? *flat_rows : input;
+	auto &row_validity = FlatVector::Validity(rows);
+	auto &fields = StructVector::GetEntries(rows);
+
+	UnifiedVectorFormat geom_format;
+	fields[bind_data.geometry_field_idx]->ToUnifiedFormat(count, geom_format);
+	auto geom_data = UnifiedVectorFormat::GetData<geometry_t>(geom_format);
+
+	auto key_count = bind_data.keys.size();
+	vector<unique_ptr<Vector>> casts(key_count);
+	vector<UnifiedVectorFormat> key_formats(key_count);
+	for (idx_t key_idx = 0; key_idx < key_count; key_idx++) {
+		auto &field = *fields[bind_data.key_fields[key_idx]];
+		auto &target = bind_data.key_types[key_idx];
+		if (field.GetType() == target) {
+			field.ToUnifiedFormat(count, key_formats[key_idx]);
+			continue;
+		}
+		casts[key_idx] = make_uniq<Vector>(target, count);
+		VectorOperations::DefaultCast(field, *casts[key_idx], count);
+		casts[key_idx]->ToUnifiedFormat(count, key_formats[key_idx]);
+	}
+
+	MVTGeometryEncoder encoder;
+	for (idx_t row_idx = 0; row_idx < count; row_idx++) {
+		auto geom_idx = geom_format.sel->get_index(row_idx);
+		if (!row_validity.RowIsValid(row_idx) || !geom_format.validity.RowIsValid(geom_idx)) {
+			continue;
+		}
+
+		MVTFeature feature;
+		feature.type = encoder.Encode(geom_data[geom_idx], feature.geometry);
+		if (feature.type == MVTGeometryType::UNKNOWN) {
+			// Empty, collapsed or mixed geometries can not be part of a tile
+			continue;
+		}
+
+		for (idx_t key_idx = 0; key_idx < key_count; key_idx++) {
+			auto &format = key_formats[key_idx];
+			auto idx = format.sel->get_index(row_idx);
+			if (!format.validity.RowIsValid(idx)) {
+				continue;
+			}
+			string value;
+			EncodeValue(bind_data.key_kinds[key_idx], format, idx, value);
+			feature.properties.emplace_back(key_idx, std::move(value));
+		}
+
+		auto &state = *states[state_format.sel->get_index(row_idx)];
+		if (!state.features) {
+			state.features = new vector<MVTFeature>();
+		}
+		state.features->push_back(std::move(feature));
+	}
+}
+
+//------------------------------------------------------------------------
+// Register
+//------------------------------------------------------------------------
+static AggregateFunction GetMVTAggregate(const vector<LogicalType> &arguments) {
+	return AggregateFunction(arguments, LogicalType::BLOB, AggregateFunction::StateSize<MVTAggState>,
+	                         AggregateFunction::StateInitialize<MVTAggState, MVTAggFunction>, Update,
+	                         AggregateFunction::StateCombine<MVTAggState, MVTAggFunction>,
+	                         AggregateFunction::StateFinalize<MVTAggState, string_t, MVTAggFunction>,
+	                         FunctionNullHandling::DEFAULT_NULL_HANDLING, nullptr, Bind,
+	                         AggregateFunction::StateDestroy<MVTAggState, MVTAggFunction>);
+}
+
+void CoreAggregateFunctions::RegisterStAsMVT(DatabaseInstance &db) {
+
+	AggregateFunctionSet st_asmvt("ST_AsMVT");
+
+	// ST_AsMVT(row [, layer_name [, extent [, geometry_name]]])
+	vector<LogicalType> arguments = {LogicalType::ANY};
+	st_asmvt.AddFunction(GetMVTAggregate(arguments));
+	for (auto &type : {LogicalType::VARCHAR, LogicalType::INTEGER, LogicalType::VARCHAR}) {
+		arguments.push_back(type);
+		st_asmvt.AddFunction(GetMVTAggregate(arguments));
+	}
+
+	ExtensionUtil::RegisterFunction(db, st_asmvt);
+}
+
+} // namespace core
+
+} // namespace spatial
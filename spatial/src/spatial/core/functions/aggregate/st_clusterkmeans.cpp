@@ -0,0 +1,456 @@
+#include "duckdb/parser/parsed_data/create_aggregate_function_info.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/common/random_engine.hpp"
+#include "duckdb/main/client_context.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/functions/aggregate.hpp"
+#include "spatial/core/functions/common.hpp"
+#include "spatial/core/parallel_chunks.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------
+// K-Means
+//------------------------------------------------------------------------
+// Lloyd's algorithm on the x and y coordinates of the points, kept as two separate arrays, with the centers seeded by
+// k-means++. Both the seeding and the assignment of the points to their nearest center go over the points in chunks,
+// which run in parallel once there is more than one. Within a chunk, the distances to one center are computed for all
+// points at a time, a branch-free loop over contiguous doubles that the compiler can vectorize. Every chunk sums up
+// the points of each cluster on its own, and the sums are added in chunk order, so the result does not depend on the
+// number of threads.
+class KMeansClustering {
+public:
+	static constexpr idx_t CHUNK_SIZE = 16384;
+	static constexpr idx_t MAX_ITERATIONS = 1000;
+	// The seeding is random, but the same for the same input
+	static constexpr int64_t SEED = 42;
+
+	KMeansClustering(ClientContext &context, vector<double> xs_p, vector<double> ys_p)
+	    : context(context), xs(std::move(xs_p)), ys(std::move(ys_p)), count(xs.size()),
+	      chunk_count((count + CHUNK_SIZE - 1) / CHUNK_SIZE) {
+	}
+
+	// Cluster the points into at most k clusters, fewer if there are fewer distinct points
+	void Execute(idx_t k) {
+		clusters.assign(count, 0);
+		if (count == 0) {
+			return;
+		}
+		nearest.assign(count, NumericLimits<double>::Maximum());
+		candidates.resize(count);
+		Seed(MinValue(k, count));
+
+		auto center_count = center_xs.size();
+		partial_xs.resize(chunk_count * center_count);
+		partial_ys.resize(chunk_count * center_count);
+		partial_counts.resize(chunk_count * center_count);
+		changes.resize(chunk_count);
+		for (idx_t iteration = 0;; iteration++) {
+			CheckInterrupted();
+			RunChunks([&](idx_t chunk) { AssignChunk(chunk); });
+			idx_t changed = 0;
+			for (auto chunk_changes : changes) {
+				changed += chunk_changes;
+			}
+			// The first assignment is compared to the placeholder cluster 0, so it always counts as a change
+			if ((iteration > 0 && changed == 0) || iteration + 1 >= MAX_ITERATIONS) {
+				break;
+			}
+			UpdateCenters();
+		}
+	}
+
+	// The cluster of every point, numbered in the order the centers were seeded
+	const vector<uint32_t> &GetClusters() const {
+		return clusters;
+	}
+
+private:
+	ClientContext &context;
+	vector<double> xs;
+	vector<double> ys;
+	idx_t count;
+	idx_t chunk_count;
+
+	vector<double> center_xs;
+	vector<double> center_ys;
+	vector<uint32_t> clusters;
+	// The squared distance of every point to its nearest center, and the index of that center
+	vector<double> nearest;
+	vector<uint32_t> candidates;
+
+	// Per chunk: the sum of the squared distances while seeding, the sums and sizes of the clusters and the number of
+	// points that changed cluster while iterating
+	vector<double> partial_nearest;
+	vector<double> partial_xs;
+	vector<double> partial_ys;
+	vector<idx_t> partial_counts;
+	vector<idx_t> changes;
+
+	void CheckInterrupted() {
+		if (context.interrupted) {
+			throw InterruptException();
+		}
+	}
+
+	void RunChunks(const ParallelChunks::ChunkFunction &fun) {
+		ParallelChunks::Run(context, chunk_count, fun);
+	}
+
+	void AddCenter(idx_t i) {
+		center_xs.push_back(xs[i]);
+		center_ys.push_back(ys[i]);
+	}
+
+	// k-means++: every next center is a point picked with a probability proportional to its squared distance to the
+	// nearest center so far
+	void Seed(idx_t k) {
+		RandomEngine random(SEED);
+		AddCenter(MinValue(static_cast<idx_t>(random.NextRandom() * static_cast<double>(count)), count - 1));
+		partial_nearest.resize(chunk_count);
+		while (center_xs.size() < k) {
+			CheckInterrupted();
+			RunChunks([&](idx_t chunk) { UpdateNearest(chunk); });
+			double total = 0;
+			for (auto sum : partial_nearest) {
+				total += sum;
+			}
+			if (!(total > 0)) {
+				// Every point coincides with a center
+				break;
+			}
+
+			// Find the chunk and then the point the random draw falls on, skipping points that are centers already
+			auto target = random.NextRandom() * total;
+			idx_t chunk = 0;
+			for (idx_t i = 0; i < chunk_count; i++) {
+				if (partial_nearest[i] > 0) {
+					chunk = i;
+					if (target < partial_nearest[i]) {
+						break;
+					}
+					target -= partial_nearest[i];
+				}
+			}
+			auto begin = chunk * CHUNK_SIZE;
+			auto end = MinValue(begin + CHUNK_SIZE, count);
+			idx_t pick = begin;
+			for (idx_t i = begin; i < end; i++) {
+				if (nearest[i] > 0) {
+					pick = i;
+					if (target < nearest[i]) {
+						break;
+					}
+					target -= nearest[i];
+				}
+			}
+			AddCenter(pick);
+		}
+	}
+
+	// Lower the distances of the points in a chunk to the center seeded last
+	void UpdateNearest(idx_t chunk) {
+		auto begin = chunk * CHUNK_SIZE;
+		auto end = MinValue(begin + CHUNK_SIZE, count);
+		auto px = xs.data();
+		auto py = ys.data();
+		auto distances = nearest.data();
+		auto cx = center_xs.back();
+		auto cy = center_ys.back();
+		double sum = 0;
+		for (idx_t i = begin; i < end; i++) {
+			auto dx = px[i] - cx;
+			auto dy = py[i] - cy;
+			auto distance = dx * dx + dy * dy;
+			distances[i] = distance < distances[i] ? distance : distances[i];
+			sum += distances[i];
+		}
+		partial_nearest[chunk] = sum;
+	}
+
+	// Assign the points in a chunk to their nearest center, ties going to the first center, and sum up the clusters
+	void AssignChunk(idx_t chunk) {
+		auto begin = chunk * CHUNK_SIZE;
+		auto end = MinValue(begin + CHUNK_SIZE, count);
+		auto px = xs.data();
+		auto py = ys.data();
+		auto distances = nearest.data();
+		auto next = candidates.data();
+		for (idx_t i = begin; i < end; i++) {
+			distances[i] = NumericLimits<double>::Maximum();
+			next[i] = 0;
+		}
+		auto center_count = center_xs.size();
+		for (idx_t c = 0; c < center_count; c++) {
+			auto cx = center_xs[c];
+			auto cy = center_ys[c];
+			auto center = static_cast<uint32_t>(c);
+			for (idx_t i = begin; i < end; i++) {
+				auto dx = px[i] - cx;
+				auto dy = py[i] - cy;
+				auto distance = dx * dx + dy * dy;
+				auto closer = distance < distances[i];
+				distances[i] = closer ? distance : distances[i];
+				next[i] = closer ? center : next[i];
+			}
+		}
+
+		auto sum_xs = partial_xs.data() + chunk * center_count;
+		auto sum_ys = partial_ys.data() + chunk * center_count;
+		auto sizes = partial_counts.data() + chunk * center_count;
+		std::fill_n(sum_xs, center_count, 0.0);
+		std::fill_n(sum_ys, center_count, 0.0);
+		std::fill_n(sizes, center_count, idx_t(0));
+		idx_t changed = 0;
+		for (idx_t i = begin; i < end; i++) {
+			auto c = next[i];
+			changed += c != clusters[i];
+			clusters[i] = c;
+			sum_xs[c] += px[i];
+			sum_ys[c] += py[i];
+			sizes[c]++;
+		}
+		changes[chunk] = changed;
+	}
+
+	// Move every center to the mean of its cluster, a center without points stays where it is
+	void UpdateCenters() {
+		auto center_count = center_xs.size();
+		for (idx_t c = 0; c < center_count; c++) {
+			double sum_x = 0;
+			double sum_y = 0;
+			idx_t size = 0;
+			for (idx_t chunk = 0; chunk < chunk_count; chunk++) {
+				sum_x += partial_xs[chunk * center_count + c];
+				sum_y += partial_ys[chunk * center_count + c];
+				size += partial_counts[chunk * center_count + c];
+			}
+			if (size > 0) {
+				center_xs[c] = sum_x / static_cast<double>(size);
+				center_ys[c] = sum_y / static_cast<double>(size);
+			}
+		}
+	}
+};
+
+constexpr idx_t KMeansClustering::CHUNK_SIZE;
+constexpr idx_t KMeansClustering::MAX_ITERATIONS;
+constexpr int64_t KMeansClustering::SEED;
+
+//------------------------------------------------------------------------
+// State
+//------------------------------------------------------------------------
+// The inputs in arrival order, together with the center of the bounding box of each, read from the header without
+// touching the coordinates. The center of an empty geometry is NaN.
+struct KMeansPoints {
+	vector<string> blobs;
+	vector<double> xs;
+	vector<double> ys;
+	idx_t size = 0;
+	idx_t tracked_size = 0;
+
+	void Append(const geometry_t &geom, idx_t count) {
+		BoundingBox bbox;
+		auto x = std::numeric_limits<double>::quiet_NaN();
+		auto y = x;
+		if (GeometryFactory::TryGetSerializedBoundingBox(geom, bbox)) {
+			x = bbox.minx + (bbox.maxx - bbox.minx) / 2;
+			y = bbox.miny + (bbox.maxy - bbox.miny) / 2;
+		}
+		string_t blob = geom;
+		for (idx_t i = 0; i < count; i++) {
+			blobs.emplace_back(blob.GetData(), blob.GetSize());
+			xs.push_back(x);
+			ys.push_back(y);
+		}
+		size += count * (sizeof(string) + 2 * sizeof(double) + blob.GetSize());
+	}
+};
+
+struct KMeansAggState {
+	KMeansPoints *points;
+};
+
+struct ClusterKMeansBindData final : public AggregateMemoryBindData {
+	idx_t k;
+
+	ClusterKMeansBindData(string function_name, ClientContext &context, idx_t k)
+	    : AggregateMemoryBindData(std::move(function_name), context), k(k) {
+	}
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<ClusterKMeansBindData>(function_name, context, k);
+	}
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<ClusterKMeansBindData>();
+		return AggregateMemoryBindData::Equals(other) && k == other.k;
+	}
+};
+
+//------------------------------------------------------------------------
+// CLUSTER KMEANS AGG
+//------------------------------------------------------------------------
+// Returns every input together with the id of its k-means cluster, or NULL if it is empty. Geometries other than
+// points are clustered by the center of their bounding box. The clusters are numbered in order of their first member.
+struct ClusterKMeansAggFunction {
+	template <class STATE>
+	static void Initialize(STATE &state) {
+		state.points = nullptr;
+	}
+
+	template <class STATE>
+	static void Append(STATE &state, const geometry_t &input, idx_t count, AggregateInputData &data) {
+		if (!state.points) {
+			state.points = new KMeansPoints();
+		}
+		state.points->Append(input, count);
+		data.bind_data->Cast<ClusterKMeansBindData>().Update(state.points->tracked_size, state.points->size);
+	}
+
+	template <class STATE, class OP>
+	static void Combine(const STATE &source, STATE &target, AggregateInputData &data) {
+		if (!source.points) {
+			return;
+		}
+		if (!target.points) {
+			target.points = new KMeansPoints();
+		}
+		// The source is copied rather than moved, as it can be combined into many targets when the aggregate runs
+		// over window frames
+		auto &points = *target.points;
+		points.blobs.insert(points.blobs.end(), source.points->blobs.begin(), source.points->blobs.end());
+		points.xs.insert(points.xs.end(), source.points->xs.begin(), source.points->xs.end());
+		points.ys.insert(points.ys.end(), source.points->ys.begin(), source.points->ys.end());
+		points.size += source.points->size;
+		data.bind_data->Cast<ClusterKMeansBindData>().Update(points.tracked_size, points.size);
+	}
+
+	template <class INPUT_TYPE, class STATE, class OP>
+	static void Operation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &agg) {
+		Append(state, input, 1, agg.input);
+	}
+
+	template <class INPUT_TYPE, class STATE, class OP>
+	static void ConstantOperation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &agg, idx_t count) {
+		// Duplicates pull the centers towards them, so keep all of them
+		Append(state, input, count, agg.input);
+	}
+
+	template <class T, class STATE>
+	static void Finalize(STATE &state, T &target, AggregateFinalizeData &finalize_data) {
+		if (!state.points || state.points->blobs.empty()) {
+			finalize_data.ReturnNull();
+			return;
+		}
+		auto &bind_data = finalize_data.input.bind_data->Cast<ClusterKMeansBindData>();
+		auto &points = *state.points;
+		auto count = points.blobs.size();
+
+		// Only the geometries with a finite center are clustered
+		vector<idx_t> members;
+		vector<double> xs;
+		vector<double> ys;
+		for (idx_t i = 0; i < count; i++) {
+			if (Value::IsFinite(points.xs[i]) && Value::IsFinite(points.ys[i])) {
+				members.push_back(i);
+				xs.push_back(points.xs[i]);
+				ys.push_back(points.ys[i]);
+			}
+		}
+		KMeansClustering kmeans(bind_data.context, std::move(xs), std::move(ys));
+		kmeans.Execute(bind_data.k);
+		auto &clusters = kmeans.GetClusters();
+
+		auto &result = finalize_data.result;
+		auto offset = ListVector::GetListSize(result);
+		ListVector::Reserve(result, offset + count);
+		auto &child_entries = StructVector::GetEntries(ListVector::GetEntry(result));
+		auto &geom_vec = *child_entries[0];
+		auto &cluster_vec = *child_entries[1];
+		auto geom_data = FlatVector::GetData<geometry_t>(geom_vec);
+		auto cluster_data = FlatVector::GetData<int32_t>(cluster_vec);
+		auto &cluster_validity = FlatVector::Validity(cluster_vec);
+
+		// Number the clusters in order of their first member
+		vector<int32_t> cluster_ids(MinValue(bind_data.k, count), -1);
+		int32_t next_id = 0;
+		idx_t member_idx = 0;
+		for (idx_t i = 0; i < count; i++) {
+			geom_data[offset + i] = geometry_t(StringVector::AddStringOrBlob(geom_vec, string_t(points.blobs[i])));
+			if (member_idx == members.size() || members[member_idx] != i) {
+				cluster_validity.SetInvalid(offset + i);
+				continue;
+			}
+			auto &id = cluster_ids[clusters[member_idx++]];
+			if (id < 0) {
+				id = next_id++;
+			}
+			cluster_data[offset + i] = id;
+		}
+		ListVector::SetListSize(result, offset + count);
+		target.offset = offset;
+		target.length = count;
+	}
+
+	template <class STATE>
+	static void Destroy(STATE &state, AggregateInputData &data) {
+		if (state.points) {
+			data.bind_data->Cast<ClusterKMeansBindData>().Update(state.points->tracked_size, 0);
+			delete state.points;
+			state.points = nullptr;
+		}
+	}
+
+	static bool IgnoreNull() {
+		return true;
+	}
+};
+
+//------------------------------------------------------------------------
+// Bind
+//------------------------------------------------------------------------
+static unique_ptr<FunctionData> ClusterKMeansBind(ClientContext &context, AggregateFunction &function,
+                                                  vector<unique_ptr<Expression>> &arguments) {
+	if (!arguments[1]->IsFoldable()) {
+		throw InvalidInputException("ST_ClusterKMeans: the number of clusters must be constant");
+	}
+	auto k_value = ExpressionExecutor::EvaluateScalar(context, *arguments[1]);
+	// The argument is not cast to the parameter type yet
+	if (k_value.IsNull() || k_value.GetValue<int64_t>() < 1) {
+		throw InvalidInputException("ST_ClusterKMeans: the number of clusters must be at least 1");
+	}
+	auto k = k_value.GetValue<int32_t>();
+
+	// The number of clusters is constant, so the aggregate itself only sees the geometries
+	Function::EraseArgument(function, arguments, 1);
+	return make_uniq<ClusterKMeansBindData>(function.name, context, static_cast<idx_t>(k));
+}
+
+//------------------------------------------------------------------------
+// Register
+//------------------------------------------------------------------------
+void CoreAggregateFunctions::RegisterStClusterKMeans(DatabaseInstance &db) {
+	AggregateFunctionSet st_cluster_kmeans("ST_ClusterKMeans");
+	auto result_type = LogicalType::LIST(
+	    LogicalType::STRUCT({{"geom", GeoTypes::GEOMETRY()}, {"cluster_id", LogicalType::INTEGER}}));
+	auto kmeans =
+	    AggregateFunction::UnaryAggregateDestructor<KMeansAggState, geometry_t, list_entry_t, ClusterKMeansAggFunction>(
+	        GeoTypes::GEOMETRY(), result_type);
+	kmeans.arguments = {GeoTypes::GEOMETRY(), LogicalType::INTEGER};
+	kmeans.bind = ClusterKMeansBind;
+	st_cluster_kmeans.AddFunction(kmeans);
+
+	ExtensionUtil::RegisterFunction(db, st_cluster_kmeans);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,287 @@
+#include "duckdb/parser/parsed_data/create_aggregate_function_info.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/geometry/cursor.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/geometry_writer.hpp"
+#include "spatial/core/functions/aggregate.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------
+// State
+//------------------------------------------------------------------------
+// The serialized items seen so far, in arrival order, each behind its size. Only their headers are read when they are
+// appended: the type, the dimensions and the bounding box, which are merged into those of the collection.
+struct CollectAggBuffer {
+	vector<data_t> items;
+	uint32_t item_count = 0;
+	// The type shared by all items, or GEOMETRYCOLLECTION if they differ
+	GeometryType item_type = GeometryType::GEOMETRYCOLLECTION;
+	// Whether any input has Z or M, empty ones included like in ST_Collect
+	bool has_z = false;
+	bool has_m = false;
+	// The bounds of the items, where an item without Z or M is bounded by the 0 it is upcast to
+	BoundingBox bbox;
+
+	void Append(const geometry_t &geom) {
+		auto properties = geom.GetProperties();
+		has_z = has_z || properties.HasZ();
+		has_m = has_m || properties.HasM();
+
+		// Empty items are left out
+		BoundingBox item_bbox;
+		if (!GeometryFactory::TryGetSerializedBoundingBox(geom, item_bbox)) {
+			return;
+		}
+		ReadZMBounds(geom, item_bbox);
+		MergeBounds(item_bbox);
+		MergeType(geom.GetType());
+
+		string_t blob = geom;
+		auto size = static_cast<uint32_t>(blob.GetSize());
+		auto offset = items.size();
+		items.resize(offset + sizeof(uint32_t) + size);
+		Store<uint32_t>(size, items.data() + offset);
+		memcpy(items.data() + offset + sizeof(uint32_t), blob.GetData(), size);
+		IncrementCount(1);
+	}
+
+	void Append(const CollectAggBuffer &other) {
+		has_z = has_z || other.has_z;
+		has_m = has_m || other.has_m;
+		if (other.item_count == 0) {
+			return;
+		}
+		MergeBounds(other.bbox);
+		MergeType(other.item_type);
+		items.insert(items.end(), other.items.begin(), other.items.end());
+		IncrementCount(other.item_count);
+	}
+
+private:
+	void IncrementCount(uint32_t count) {
+		if (item_count > NumericLimits<uint32_t>::Maximum() - count) {
+			throw InvalidInputException("ST_Collect_Agg: Too many geometries for a single collection");
+		}
+		item_count += count;
+	}
+
+	void MergeType(GeometryType type) {
+		if (item_count == 0) {
+			item_type = type;
+		} else if (item_type != type) {
+			item_type = GeometryType::GEOMETRYCOLLECTION;
+		}
+	}
+
+	void MergeBounds(const BoundingBox &other) {
+		bbox.minx = MinValue(bbox.minx, other.minx);
+		bbox.miny = MinValue(bbox.miny, other.miny);
+		bbox.maxx = MaxValue(bbox.maxx, other.maxx);
+		bbox.maxy = MaxValue(bbox.maxy, other.maxy);
+		bbox.minz = MinValue(bbox.minz, other.minz);
+		bbox.maxz = MaxValue(bbox.maxz, other.maxz);
+		bbox.minm = MinValue(bbox.minm, other.minm);
+		bbox.maxm = MaxValue(bbox.maxm, other.maxm);
+	}
+
+	// The Z and M bounds follow the X and Y bounds in the header, points have no bounding box and are read instead
+	static void ReadZMBounds(const geometry_t &geom, BoundingBox &bbox) {
+		auto properties = geom.GetProperties();
+		bbox.minz = bbox.maxz = 0;
+		bbox.minm = bbox.maxm = 0;
+		if (!properties.HasZ() && !properties.HasM()) {
+			return;
+		}
+		Cursor cursor(geom);
+		cursor.Skip(sizeof(GeometryType) + sizeof(GeometryProperties) + sizeof(uint16_t) + sizeof(uint32_t));
+		if (!properties.HasBBox()) {
+			// A non-empty point
+			cursor.Skip(sizeof(SerializedGeometryType) + sizeof(uint32_t) + 2 * sizeof(double));
+			if (properties.HasZ()) {
+				bbox.minz = bbox.maxz = cursor.Read<double>();
+			}
+			if (properties.HasM()) {
+				bbox.minm = bbox.maxm = cursor.Read<double>();
+			}
+			return;
+		}
+		auto read_range = [&](double &min, double &max) {
+			if (properties.HasDoubleBBox()) {
+				min = cursor.Read<double>();
+				max = cursor.Read<double>();
+			} else {
+				min = cursor.Read<float>();
+				max = cursor.Read<float>();
+			}
+		};
+		cursor.Skip(4 * (properties.HasDoubleBBox() ? sizeof(double) : sizeof(float)));
+		if (properties.HasZ()) {
+			read_range(bbox.minz, bbox.maxz);
+		}
+		if (properties.HasM()) {
+			read_range(bbox.minm, bbox.maxm);
+		}
+	}
+};
+
+struct CollectAggState {
+	CollectAggBuffer *buffer;
+};
+
+//------------------------------------------------------------------------
+// COLLECT AGG
+//------------------------------------------------------------------------
+// Like ST_Collect(list(geom)), without materializing a list of geometries per group or deserializing them: the
+// serialized items are appended to a buffer as they arrive, and the collection is written in one go by putting a
+// header, the merged bounding box and the collection type and count in front of the bodies of the items. Only items
+// with fewer dimensions than the collection are rewritten, to upcast their vertices.
+struct CollectAggFunction {
+	template <class STATE>
+	static void Initialize(STATE &state) {
+		state.buffer = nullptr;
+	}
+
+	template <class STATE, class OP>
+	static void Combine(const STATE &source, STATE &target, AggregateInputData &) {
+		if (!source.buffer) {
+			return;
+		}
+		if (!target.buffer) {
+			target.buffer = new auto(*source.buffer);
+			return;
+		}
+		target.buffer->Append(*source.buffer);
+	}
+
+	template <class INPUT_TYPE, class STATE, class OP>
+	static void Operation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &) {
+		if (!state.buffer) {
+			state.buffer = new CollectAggBuffer();
+		}
+		state.buffer->Append(input);
+	}
+
+	template <class INPUT_TYPE, class STATE, class OP>
+	static void ConstantOperation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &agg, idx_t count) {
+		for (idx_t i = 0; i < count; i++) {
+			Operation<INPUT_TYPE, STATE, OP>(state, input, agg);
+		}
+	}
+
+	template <class T, class STATE>
+	static void Finalize(STATE &state, T &target, AggregateFinalizeData &finalize_data) {
+		if (!state.buffer) {
+			finalize_data.ReturnNull();
+			return;
+		}
+		auto &buffer = *state.buffer;
+		if (buffer.item_count == 0) {
+			// Only empty geometries
+			GeometryWriter writer;
+			writer.Begin(GeometryType::GEOMETRYCOLLECTION, buffer.has_z, buffer.has_m);
+			writer.AddCollection(GeometryType::GEOMETRYCOLLECTION, 0);
+			target = writer.End(finalize_data.result);
+			return;
+		}
+
+		auto collection_type = GeometryType::GEOMETRYCOLLECTION;
+		switch (buffer.item_type) {
+		case GeometryType::POINT:
+			collection_type = GeometryType::MULTIPOINT;
+			break;
+		case GeometryType::LINESTRING:
+			collection_type = GeometryType::MULTILINESTRING;
+			break;
+		case GeometryType::POLYGON:
+			collection_type = GeometryType::MULTIPOLYGON;
+			break;
+		default:
+			break;
+		}
+
+		// Find the body of every item, upcasting the items that are missing a dimension of the collection
+		unique_ptr<Vector> upcast_items;
+		vector<string_t> items;
+		items.reserve(buffer.item_count);
+		idx_t body_size = 2 * sizeof(uint32_t);
+		auto ptr = buffer.items.data();
+		for (uint32_t i = 0; i < buffer.item_count; i++) {
+			auto size = Load<uint32_t>(ptr);
+			geometry_t item(string_t(const_char_ptr_cast(ptr + sizeof(uint32_t)), size));
+			ptr += sizeof(uint32_t) + size;
+
+			auto properties = item.GetProperties();
+			if (properties.HasZ() != buffer.has_z || properties.HasM() != buffer.has_m) {
+				if (!upcast_items) {
+					upcast_items = make_uniq<Vector>(GeoTypes::GEOMETRY());
+				}
+				item = GeometryFactory::SerializedSetVertexType(*upcast_items, item, buffer.has_z, buffer.has_m, 0, 0);
+				properties = item.GetProperties();
+			}
+			string_t blob = item;
+			auto header_size = 8 + properties.BBoxSize();
+			items.emplace_back(blob.GetData() + header_size, static_cast<uint32_t>(blob.GetSize() - header_size));
+			body_size += items.back().GetSize();
+		}
+
+		GeometryProperties properties;
+		properties.SetBBox(true);
+		properties.SetZ(buffer.has_z);
+		properties.SetM(buffer.has_m);
+		auto size = 8 + properties.BBoxSize() + body_size;
+		if (size > NumericLimits<uint32_t>::Maximum()) {
+			throw InvalidInputException("ST_Collect_Agg: The collection is too large to be serialized");
+		}
+
+		auto blob = StringVector::EmptyString(finalize_data.result, size);
+		Cursor cursor(blob);
+		cursor.Write<GeometryType>(collection_type);
+		cursor.Write<GeometryProperties>(properties);
+		cursor.Write<uint16_t>(0); // hash
+		cursor.Write<uint32_t>(0); // padding
+		GeometryFactory::SerializeBoundingBox(cursor, buffer.bbox, properties);
+		cursor.Write<uint32_t>(static_cast<uint32_t>(collection_type));
+		cursor.Write<uint32_t>(buffer.item_count);
+		for (auto &item : items) {
+			memcpy(cursor.GetPtr(), item.GetData(), item.GetSize());
+			cursor.Skip(item.GetSize());
+		}
+		blob.Finalize();
+		target = geometry_t(blob);
+	}
+
+	template <class STATE>
+	static void Destroy(STATE &state, AggregateInputData &) {
+		if (state.buffer) {
+			delete state.buffer;
+			state.buffer = nullptr;
+		}
+	}
+
+	static bool IgnoreNull() {
+		return true;
+	}
+};
+
+//------------------------------------------------------------------------
+// Register
+//------------------------------------------------------------------------
+void CoreAggregateFunctions::RegisterStCollectAgg(DatabaseInstance &db) {
+
+	AggregateFunctionSet st_collect_agg("ST_Collect_Agg");
+	st_collect_agg.AddFunction(
+	    AggregateFunction::UnaryAggregateDestructor<CollectAggState, geometry_t, geometry_t, CollectAggFunction>(
+	        core::GeoTypes::GEOMETRY(), core::GeoTypes::GEOMETRY()));
+
+	ExtensionUtil::RegisterFunction(db, st_collect_agg);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,112 @@
+#include "duckdb/parser/parsed_data/create_aggregate_function_info.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/geometry/convex_hull.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/functions/aggregate.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------
+// State
+//------------------------------------------------------------------------
+// The vertices of the hull so far, followed by the vertices added since it was last reduced. The buffer is reduced to
+// the hull again once it grows past twice the hull (or a minimum batch), so it stays proportional to the hull.
+struct ConvexHullAggState {
+	vector<VertexXY> *points;
+	idx_t hull_size;
+};
+
+//------------------------------------------------------------------------
+// CONVEXHULL AGG
+//------------------------------------------------------------------------
+struct ConvexHullAggFunction {
+	static constexpr idx_t MIN_BATCH_SIZE = 4096;
+
+	static void MaybeReduce(ConvexHullAggState &state) {
+		if (state.points->size() > MaxValue<idx_t>(2 * state.hull_size, MIN_BATCH_SIZE)) {
+			ConvexHull::Reduce(*state.points);
+			state.hull_size = state.points->size();
+		}
+	}
+
+	template <class STATE>
+	static void Initialize(STATE &state) {
+		state.points = nullptr;
+		state.hull_size = 0;
+	}
+
+	template <class STATE, class OP>
+	static void Combine(const STATE &source, STATE &target, AggregateInputData &) {
+		if (!source.points) {
+			return;
+		}
+		if (!target.points) {
+			target.points = new vector<VertexXY>(*source.points);
+			target.hull_size = source.hull_size;
+			return;
+		}
+		// Merging two hulls only needs the vertices of both
+		target.points->insert(target.points->end(), source.points->begin(), source.points->end());
+		MaybeReduce(target);
+	}
+
+	template <class INPUT_TYPE, class STATE, class OP>
+	static void Operation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &) {
+		if (!state.points) {
+			state.points = new vector<VertexXY>();
+		}
+		ConvexHull::AppendVertices(input, *state.points);
+		MaybeReduce(state);
+	}
+
+	template <class INPUT_TYPE, class STATE, class OP>
+	static void ConstantOperation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &agg, idx_t) {
+		// The hull of the same geometry repeated is the hull of the geometry
+		Operation<INPUT_TYPE, STATE, OP>(state, input, agg);
+	}
+
+	template <class T, class STATE>
+	static void Finalize(STATE &state, T &target, AggregateFinalizeData &finalize_data) {
+		if (!state.points) {
+			finalize_data.ReturnNull();
+			return;
+		}
+		ConvexHull::Reduce(*state.points);
+		state.hull_size = state.points->size();
+		GeometryFactory factory(finalize_data.input.allocator.GetAllocator());
+		target = ConvexHull::Serialize(factory, finalize_data.result, *state.points);
+	}
+
+	template <class STATE>
+	static void Destroy(STATE &state, AggregateInputData &) {
+		if (state.points) {
+			delete state.points;
+			state.points = nullptr;
+		}
+	}
+
+	static bool IgnoreNull() {
+		return true;
+	}
+};
+
+//------------------------------------------------------------------------
+// Register
+//------------------------------------------------------------------------
+void CoreAggregateFunctions::RegisterStConvexHullAgg(DatabaseInstance &db) {
+
+	AggregateFunctionSet st_convexhull_agg("ST_ConvexHull_Agg");
+	st_convexhull_agg.AddFunction(
+	    AggregateFunction::UnaryAggregateDestructor<ConvexHullAggState, geometry_t, geometry_t, ConvexHullAggFunction>(
+	        GeoTypes::GEOMETRY(), GeoTypes::GEOMETRY()));
+
+	ExtensionUtil::RegisterFunction(db, st_convexhull_agg);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,185 @@
+#include "duckdb/parser/parsed_data/create_aggregate_function_info.hpp"
+#include "duckdb/common/vector_operations/vector_operations.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/functions/aggregate.hpp"
+
+namespace spatial {
+
+namespace core {
+
+struct ExtentAggState {
+	bool is_set;
+	double xmin;
+	double ymin;
+	double xmax;
+	double ymax;
+
+	void Include(double minx, double miny, double maxx, double maxy) {
+		if (!is_set) {
+			is_set = true;
+			xmin = minx;
+			ymin = miny;
+			xmax = maxx;
+			ymax = maxy;
+		} else {
+			xmin = std::min(xmin, minx);
+			ymin = std::min(ymin, miny);
+			xmax = std::max(xmax, maxx);
+			ymax = std::max(ymax, maxy);
+		}
+	}
+};
+
+//------------------------------------------------------------------------
+// EXTENT AGG
+//------------------------------------------------------------------------
+// Like ST_Envelope_Agg, but returns a BOX_2D and also accepts precomputed boxes, so that the extent of a column can be
+// computed without building a polygon or touching more than the geometry headers
+struct ExtentAggFunction {
+	template <class STATE>
+	static void Initialize(STATE &state) {
+		state.is_set = false;
+	}
+
+	template <class STATE, class OP>
+	static void Combine(const STATE &source, STATE &target, AggregateInputData &) {
+		if (source.is_set) {
+			target.Include(source.xmin, source.ymin, source.xmax, source.ymax);
+		}
+	}
+
+	static void UpdateGeometry(Vector inputs[], AggregateInputData &, idx_t input_count, Vector &state_vector,
+	                           idx_t count) {
+		D_ASSERT(input_count == 1);
+		UnifiedVectorFormat input_format;
+		inputs[0].ToUnifiedFormat(count, input_format);
+		auto input_data = UnifiedVectorFormat::GetData<geometry_t>(input_format);
+
+		UnifiedVectorFormat state_format;
+		state_vector.ToUnifiedFormat(count, state_format);
+		auto states = UnifiedVectorFormat::GetData<ExtentAggState *>(state_format);
+
+		BoundingBox bbox;
+		for (idx_t i = 0; i < count; i++) {
+			auto idx = input_format.sel->get_index(i);
+			if (input_format.validity.RowIsValid(idx) &&
+			    GeometryFactory::TryGetSerializedBoundingBox(input_data[idx], bbox)) {
+				auto &state = *states[state_format.sel->get_index(i)];
+				state.Include(bbox.minx, bbox.miny, bbox.maxx, bbox.maxy);
+			}
+		}
+	}
+
+	static void UpdateBox(Vector inputs[], AggregateInputData &, idx_t input_count, Vector &state_vector, idx_t count) {
+		D_ASSERT(input_count == 1);
+		// Work on a flat struct so that the fields line up with the rows
+		auto &input = inputs[0];
+		unique_ptr<Vector> flat_boxes;
+		if (input.GetVectorType() != VectorType::FLAT_VECTOR) {
+			flat_boxes = make_uniq<Vector>(input.GetType(), count);
+			VectorOperations::Copy(input, *flat_boxes, count, 0, 0);
+		}
+		auto &boxes = flat_boxes ? *flat_boxes : input;
+		auto &validity = FlatVector::Validity(boxes);
+		auto &children = StructVector::GetEntries(boxes);
+		auto min_x_data = FlatVector::GetData<double>(*children[0]);
+		auto min_y_data = FlatVector::GetData<double>(*children[1]);
+		auto max_x_data = FlatVector::GetData<double>(*children[2]);
+		auto max_y_data = FlatVector::GetData<double>(*children[3]);
+
+		UnifiedVectorFormat state_format;
+		state_vector.ToUnifiedFormat(count, state_format);
+		auto states = UnifiedVectorFormat::GetData<ExtentAggState *>(state_format);
+
+		if (state_vector.GetVectorType() == VectorType::CONSTANT_VECTOR && validity.AllValid()) {
+			// Ungrouped, reduce the whole chunk in one pass over the columns before touching the state
+			if (count == 0) {
+				return;
+			}
+			auto minx = min_x_data[0];
+			auto miny = min_y_data[0];
+			auto maxx = max_x_data[0];
+			auto maxy = max_y_data[0];
+			for (idx_t i = 1; i < count; i++) {
+				minx = std::min(minx, min_x_data[i]);
+				miny = std::min(miny, min_y_data[i]);
+				maxx = std::max(maxx, max_x_data[i]);
+				maxy = std::max(maxy, max_y_data[i]);
+			}
+			states[0]->Include(minx, miny, maxx, maxy);
+			return;
+		}
+
+		for (idx_t i = 0; i < count; i++) {
+			if (validity.RowIsValid(i)) {
+				auto &state = *states[state_format.sel->get_index(i)];
+				state.Include(min_x_data[i], min_y_data[i], max_x_data[i], max_y_data[i]);
+			}
+		}
+	}
+
+	static void Finalize(Vector &state_vector, AggregateInputData &, Vector &result, idx_t count, idx_t offset) {
+		UnifiedVectorFormat state_format;
+		state_vector.ToUnifiedFormat(count, state_format);
+		auto states = UnifiedVectorFormat::GetData<ExtentAggState *>(state_format);
+
+		if (state_vector.GetVectorType() == VectorType::CONSTANT_VECTOR) {
+			result.SetVectorType(VectorType::CONSTANT_VECTOR);
+			count = 1;
+			offset = 0;
+		}
+
+		auto &children = StructVector::GetEntries(result);
+		auto min_x_data = FlatVector::GetData<double>(*children[0]);
+		auto min_y_data = FlatVector::GetData<double>(*children[1]);
+		auto max_x_data = FlatVector::GetData<double>(*children[2]);
+		auto max_y_data = FlatVector::GetData<double>(*children[3]);
+
+		for (idx_t i = 0; i < count; i++) {
+			auto &state = *states[state_format.sel->get_index(i)];
+			auto row_idx = i + offset;
+			if (!state.is_set) {
+				if (result.GetVectorType() == VectorType::CONSTANT_VECTOR) {
+					ConstantVector::SetNull(result, true);
+				} else {
+					FlatVector::SetNull(result, row_idx, true);
+				}
+				continue;
+			}
+			min_x_data[row_idx] = state.xmin;
+			min_y_data[row_idx] = state.ymin;
+			max_x_data[row_idx] = state.xmax;
+			max_y_data[row_idx] = state.ymax;
+		}
+	}
+
+	static bool IgnoreNull() {
+		return true;
+	}
+};
+
+//------------------------------------------------------------------------
+// Register
+//------------------------------------------------------------------------
+static AggregateFunction GetExtentAggregate(const LogicalType &input_type, aggregate_update_t update) {
+	return AggregateFunction({input_type}, GeoTypes::BOX_2D(), AggregateFunction::StateSize<ExtentAggState>,
+	                         AggregateFunction::StateInitialize<ExtentAggState, ExtentAggFunction>, update,
+	                         AggregateFunction::StateCombine<ExtentAggState, ExtentAggFunction>,
+	                         ExtentAggFunction::Finalize, nullptr);
+}
+
+void CoreAggregateFunctions::RegisterStExtentAgg(DatabaseInstance &db) {
+
+	AggregateFunctionSet st_extent_agg("ST_Extent_Agg");
+	st_extent_agg.AddFunction(GetExtentAggregate(GeoTypes::GEOMETRY(), ExtentAggFunction::UpdateGeometry));
+	st_extent_agg.AddFunction(GetExtentAggregate(GeoTypes::BOX_2D(), ExtentAggFunction::UpdateBox));
+
+	ExtensionUtil::RegisterFunction(db, st_extent_agg);
+}
+
+} // namespace core
+
+} // namespace spatial
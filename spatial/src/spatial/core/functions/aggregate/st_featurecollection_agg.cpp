@@ -0,0 +1,103 @@
+#include "duckdb/parser/parsed_data/create_aggregate_function_info.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/geometry/geojson_writer.hpp"
+#include "spatial/core/functions/aggregate.hpp"
+
+namespace spatial {
+
+namespace core {
+
+struct FeatureCollectionAggState {
+	// The comma separated GeoJSON features seen so far
+	string *features;
+};
+
+//------------------------------------------------------------------------
+// FEATURECOLLECTION AGG
+//------------------------------------------------------------------------
+struct FeatureCollectionAggFunction {
+	template <class STATE>
+	static void Initialize(STATE &state) {
+		state.features = nullptr;
+	}
+
+	template <class STATE>
+	static void AppendFeature(STATE &state, const geometry_t &input) {
+		if (!state.features) {
+			state.features = new string();
+		} else {
+			*state.features += ',';
+		}
+		*state.features += R"({"type":"Feature","geometry":)";
+		GeoJSONWriter writer;
+		writer.Write(input, *state.features);
+		*state.features += R"(,"properties":{}})";
+	}
+
+	template <class STATE, class OP>
+	static void Combine(const STATE &source, STATE &target, AggregateInputData &) {
+		if (!source.features) {
+			return;
+		}
+		if (!target.features) {
+			target.features = new string(*source.features);
+			return;
+		}
+		*target.features += ',';
+		*target.features += *source.features;
+	}
+
+	template <class INPUT_TYPE, class STATE, class OP>
+	static void Operation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &) {
+		AppendFeature(state, input);
+	}
+
+	template <class INPUT_TYPE, class STATE, class OP>
+	static void ConstantOperation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &, idx_t count) {
+		for (idx_t i = 0; i < count; i++) {
+			AppendFeature(state, input);
+		}
+	}
+
+	template <class T, class STATE>
+	static void Finalize(STATE &state, T &target, AggregateFinalizeData &finalize_data) {
+		string result = R"({"type":"FeatureCollection","features":[)";
+		if (state.features) {
+			result += *state.features;
+		}
+		result += "]}";
+		target = StringVector::AddString(finalize_data.result, result);
+	}
+
+	template <class STATE>
+	static void Destroy(STATE &state, AggregateInputData &) {
+		if (state.features) {
+			delete state.features;
+			state.features = nullptr;
+		}
+	}
+
+	static bool IgnoreNull() {
+		return true;
+	}
+};
+
+//------------------------------------------------------------------------
+// Register
+//------------------------------------------------------------------------
+void CoreAggregateFunctions::RegisterStFeatureCollectionAgg(DatabaseInstance &db) {
+
+	AggregateFunctionSet st_featurecollection_agg("ST_FeatureCollection_Agg");
+	st_featurecollection_agg.AddFunction(
+	    AggregateFunction::UnaryAggregateDestructor<FeatureCollectionAggState, geometry_t, string_t,
+	                                                FeatureCollectionAggFunction>(core::GeoTypes::GEOMETRY(),
+	                                                                              LogicalType::VARCHAR));
+
+	ExtensionUtil::RegisterFunction(db, st_featurecollection_agg);
+}
+
+} // namespace core
+
+} // namespace spatial
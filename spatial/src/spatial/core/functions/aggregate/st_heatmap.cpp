@@ -0,0 +1,242 @@
+#include "duckdb/parser/parsed_data/create_aggregate_function_info.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/functions/aggregate.hpp"
+#include "spatial/core/functions/common.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------
+// State
+//------------------------------------------------------------------------
+// The grid is dense and fixed by the constant arguments, so every state is a flat array of counts, one per cell in
+// row-major order, and combining two states adds them element-wise. A geometry is counted in the cell that the center
+// of its bounding box falls in, which is read from the geometry header without deserializing it.
+
+struct HeatmapAggState {
+	uint64_t *counts;
+	idx_t tracked_size;
+};
+
+struct HeatmapBindData final : public AggregateMemoryBindData {
+	double min_x;
+	double min_y;
+	double max_x;
+	double max_y;
+	int32_t width;
+	int32_t height;
+	// The number of cells per unit along each axis
+	double scale_x;
+	double scale_y;
+
+	HeatmapBindData(string function_name, ClientContext &context, double min_x, double min_y, double max_x,
+	                double max_y, int32_t width, int32_t height)
+	    : AggregateMemoryBindData(std::move(function_name), context), min_x(min_x), min_y(min_y), max_x(max_x),
+	      max_y(max_y), width(width), height(height), scale_x(width / (max_x - min_x)),
+	      scale_y(height / (max_y - min_y)) {
+	}
+	idx_t CellCount() const {
+		return static_cast<idx_t>(width) * static_cast<idx_t>(height);
+	}
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<HeatmapBindData>(function_name, context, min_x, min_y, max_x, max_y, width, height);
+	}
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<HeatmapBindData>();
+		return AggregateMemoryBindData::Equals(other) && min_x == other.min_x && min_y == other.min_y &&
+		       max_x == other.max_x && max_y == other.max_y && width == other.width && height == other.height;
+	}
+};
+
+//------------------------------------------------------------------------
+// HEATMAP AGG
+//------------------------------------------------------------------------
+struct HeatmapAggFunction {
+	template <class STATE>
+	static void Initialize(STATE &state) {
+		state.counts = nullptr;
+		state.tracked_size = 0;
+	}
+
+	static uint64_t *GetCounts(HeatmapAggState &state, const HeatmapBindData &bind_data) {
+		if (!state.counts) {
+			auto cell_count = bind_data.CellCount();
+			bind_data.Update(state.tracked_size, cell_count * sizeof(uint64_t));
+			state.counts = new uint64_t[cell_count]();
+		}
+		return state.counts;
+	}
+
+	template <class STATE, class OP>
+	static void Combine(const STATE &source, STATE &target, AggregateInputData &input) {
+		if (!source.counts) {
+			return;
+		}
+		auto &bind_data = input.bind_data->Cast<HeatmapBindData>();
+		auto target_counts = GetCounts(target, bind_data);
+		auto source_counts = source.counts;
+		auto cell_count = bind_data.CellCount();
+		for (idx_t i = 0; i < cell_count; i++) {
+			target_counts[i] += source_counts[i];
+		}
+	}
+
+	// The index of the cell of a coordinate along one axis, or false if it is outside of the box (or NaN). The max
+	// edge of the box belongs to the last cell.
+	static bool TryGetCell(double coordinate, double min, double scale, int32_t cell_count, idx_t &cell) {
+		auto position = (coordinate - min) * scale;
+		if (!(position >= 0 && position <= cell_count)) {
+			return false;
+		}
+		cell = MinValue<idx_t>(static_cast<idx_t>(position), static_cast<idx_t>(cell_count - 1));
+		return true;
+	}
+
+	static void Update(Vector inputs[], AggregateInputData &input, idx_t input_count, Vector &state_vector,
+	                   idx_t count) {
+		auto &bind_data = input.bind_data->Cast<HeatmapBindData>();
+		UnifiedVectorFormat input_format;
+		inputs[0].ToUnifiedFormat(count, input_format);
+		auto input_data = UnifiedVectorFormat::GetData<geometry_t>(input_format);
+
+		UnifiedVectorFormat state_format;
+		state_vector.ToUnifiedFormat(count, state_format);
+		auto states = UnifiedVectorFormat::GetData<HeatmapAggState *>(state_format);
+
+		BoundingBox bbox;
+		for (idx_t i = 0; i < count; i++) {
+			auto idx = input_format.sel->get_index(i);
+			if (!input_format.validity.RowIsValid(idx)) {
+				continue;
+			}
+			if (!GeometryFactory::TryGetSerializedBoundingBox(input_data[idx], bbox)) {
+				// Empty geometries have no place in the grid
+				continue;
+			}
+			// The grid exists as soon as there is a geometry, even if it falls outside of the box
+			auto counts = GetCounts(*states[state_format.sel->get_index(i)], bind_data);
+			idx_t cell_x;
+			idx_t cell_y;
+			if (TryGetCell((bbox.minx + bbox.maxx) / 2, bind_data.min_x, bind_data.scale_x, bind_data.width, cell_x) &&
+			    TryGetCell((bbox.miny + bbox.maxy) / 2, bind_data.min_y, bind_data.scale_y, bind_data.height, cell_y)) {
+				counts[cell_y * bind_data.width + cell_x]++;
+			}
+		}
+	}
+
+	static void Finalize(Vector &state_vector, AggregateInputData &input, Vector &result, idx_t count,
+	                     idx_t offset) {
+		auto &bind_data = input.bind_data->Cast<HeatmapBindData>();
+		UnifiedVectorFormat state_format;
+		state_vector.ToUnifiedFormat(count, state_format);
+		auto states = UnifiedVectorFormat::GetData<HeatmapAggState *>(state_format);
+
+		auto &children = StructVector::GetEntries(result);
+		auto width_data = FlatVector::GetData<int32_t>(*children[0]);
+		auto height_data = FlatVector::GetData<int32_t>(*children[1]);
+		auto &counts_vector = *children[2];
+		auto entries = FlatVector::GetData<list_entry_t>(counts_vector);
+		auto &counts_child = ListVector::GetEntry(counts_vector);
+		auto cell_count = bind_data.CellCount();
+
+		for (idx_t i = 0; i < count; i++) {
+			auto &state = *states[state_format.sel->get_index(i)];
+			auto row_idx = i + offset;
+			if (!state.counts) {
+				FlatVector::SetNull(result, row_idx, true);
+				continue;
+			}
+			width_data[row_idx] = bind_data.width;
+			height_data[row_idx] = bind_data.height;
+
+			auto list_offset = ListVector::GetListSize(counts_vector);
+			ListVector::Reserve(counts_vector, list_offset + cell_count);
+			auto child_data = FlatVector::GetData<uint64_t>(counts_child);
+			memcpy(child_data + list_offset, state.counts, cell_count * sizeof(uint64_t));
+			entries[row_idx].offset = list_offset;
+			entries[row_idx].length = cell_count;
+			ListVector::SetListSize(counts_vector, list_offset + cell_count);
+		}
+	}
+
+	static void Destroy(Vector &state_vector, AggregateInputData &input, idx_t count) {
+		auto &bind_data = input.bind_data->Cast<HeatmapBindData>();
+		auto states = FlatVector::GetData<HeatmapAggState *>(state_vector);
+		for (idx_t i = 0; i < count; i++) {
+			auto &state = *states[i];
+			if (state.counts) {
+				bind_data.Update(state.tracked_size, 0);
+				delete[] state.counts;
+				state.counts = nullptr;
+			}
+		}
+	}
+};
+
+//------------------------------------------------------------------------
+// Bind
+//------------------------------------------------------------------------
+static unique_ptr<FunctionData> HeatmapBind(ClientContext &context, AggregateFunction &function,
+                                            vector<unique_ptr<Expression>> &arguments) {
+	if (!arguments[1]->IsFoldable() || !arguments[2]->IsFoldable() || !arguments[3]->IsFoldable()) {
+		throw InvalidInputException("ST_Heatmap: the box, the width and the height must be constant");
+	}
+	auto box_value = ExpressionExecutor::EvaluateScalar(context, *arguments[1]);
+	if (box_value.IsNull()) {
+		throw InvalidInputException("ST_Heatmap: the box must not be NULL");
+	}
+	auto &box = StructValue::GetChildren(box_value);
+	double bounds[4];
+	for (idx_t i = 0; i < 4; i++) {
+		bounds[i] = box[i].IsNull() ? 0 : box[i].GetValue<double>();
+		if (box[i].IsNull() || !Value::IsFinite(bounds[i])) {
+			throw InvalidInputException("ST_Heatmap: the box must have finite bounds");
+		}
+	}
+	if (!(bounds[2] > bounds[0]) || !(bounds[3] > bounds[1])) {
+		throw InvalidInputException("ST_Heatmap: the box must have a positive width and height");
+	}
+	auto width_value = ExpressionExecutor::EvaluateScalar(context, *arguments[2]);
+	auto height_value = ExpressionExecutor::EvaluateScalar(context, *arguments[3]);
+	if (width_value.IsNull() || height_value.IsNull() || width_value.GetValue<int32_t>() < 1 ||
+	    height_value.GetValue<int32_t>() < 1) {
+		throw InvalidInputException("ST_Heatmap: the width and the height must be positive numbers");
+	}
+
+	// The box and the grid size are constant, so the aggregate itself only sees the geometries
+	Function::EraseArgument(function, arguments, 3);
+	Function::EraseArgument(function, arguments, 2);
+	Function::EraseArgument(function, arguments, 1);
+	return make_uniq<HeatmapBindData>(function.name, context, bounds[0], bounds[1], bounds[2], bounds[3],
+	                                  width_value.GetValue<int32_t>(), height_value.GetValue<int32_t>());
+}
+
+//------------------------------------------------------------------------
+// Register
+//------------------------------------------------------------------------
+void CoreAggregateFunctions::RegisterStHeatmap(DatabaseInstance &db) {
+	AggregateFunctionSet st_heatmap("ST_Heatmap");
+
+	auto result_type = LogicalType::STRUCT({{"width", LogicalType::INTEGER},
+	                                        {"height", LogicalType::INTEGER},
+	                                        {"counts", LogicalType::LIST(LogicalType::UBIGINT)}});
+
+	AggregateFunction function({GeoTypes::GEOMETRY(), GeoTypes::BOX_2D(), LogicalType::INTEGER, LogicalType::INTEGER},
+	                           result_type, AggregateFunction::StateSize<HeatmapAggState>,
+	                           AggregateFunction::StateInitialize<HeatmapAggState, HeatmapAggFunction>,
+	                           HeatmapAggFunction::Update,
+	                           AggregateFunction::StateCombine<HeatmapAggState, HeatmapAggFunction>,
+	                           HeatmapAggFunction::Finalize, nullptr, HeatmapBind, HeatmapAggFunction::Destroy);
+	st_heatmap.AddFunction(function);
+
+	ExtensionUtil::RegisterFunction(db, st_heatmap);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,306 @@
+#include "duckdb/parser/parsed_data/create_aggregate_function_info.hpp"
+#include "duckdb/common/vector_operations/vector_operations.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/geometry/cursor.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/functions/aggregate.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------
+// State
+//------------------------------------------------------------------------
+// The raw coordinates of the points seen so far, in arrival order, with their order keys. Z and M are only stored
+// once a point with them is seen, earlier points get 0 like ST_MakeLine does when it upcasts.
+template <class KEY>
+struct MakeLineBuffer {
+	vector<KEY> keys;
+	vector<double> xy;
+	vector<double> z;
+	vector<double> m;
+	bool has_z = false;
+	bool has_m = false;
+
+	idx_t Count() const {
+		return keys.size();
+	}
+
+	void Append(KEY key, double x, double y) {
+		keys.push_back(key);
+		xy.push_back(x);
+		xy.push_back(y);
+		if (has_z) {
+			z.push_back(0);
+		}
+		if (has_m) {
+			m.push_back(0);
+		}
+	}
+
+	void SetZ(double value) {
+		if (!has_z) {
+			has_z = true;
+			z.resize(Count(), 0);
+		}
+		z.back() = value;
+	}
+
+	void SetM(double value) {
+		if (!has_m) {
+			has_m = true;
+			m.resize(Count(), 0);
+		}
+		m.back() = value;
+	}
+
+	void Append(const MakeLineBuffer &other) {
+		if (other.has_z && !has_z) {
+			has_z = true;
+			z.resize(Count(), 0);
+		}
+		if (other.has_m && !has_m) {
+			has_m = true;
+			m.resize(Count(), 0);
+		}
+		keys.insert(keys.end(), other.keys.begin(), other.keys.end());
+		xy.insert(xy.end(), other.xy.begin(), other.xy.end());
+		if (has_z) {
+			if (other.has_z) {
+				z.insert(z.end(), other.z.begin(), other.z.end());
+			} else {
+				z.resize(Count(), 0);
+			}
+		}
+		if (has_m) {
+			if (other.has_m) {
+				m.insert(m.end(), other.m.begin(), other.m.end());
+			} else {
+				m.resize(Count(), 0);
+			}
+		}
+	}
+};
+
+template <class KEY>
+struct MakeLineAggState {
+	MakeLineBuffer<KEY> *buffer;
+};
+
+//------------------------------------------------------------------------
+// MAKELINE AGG
+//------------------------------------------------------------------------
+// Like ST_MakeLine(list(point ORDER BY key)), without materializing a list of geometries per group: the points are
+// appended to a coordinate buffer as they arrive, sorted by their key once all of them are in, and serialized once.
+struct MakeLineAggFunction {
+	template <class STATE>
+	static void Initialize(STATE &state) {
+		state.buffer = nullptr;
+	}
+
+	template <class STATE, class OP>
+	static void Combine(const STATE &source, STATE &target, AggregateInputData &) {
+		if (!source.buffer) {
+			return;
+		}
+		if (!target.buffer) {
+			target.buffer = new auto(*source.buffer);
+			return;
+		}
+		target.buffer->Append(*source.buffer);
+	}
+
+	template <class T, class STATE>
+	static void Finalize(STATE &state, T &target, AggregateFinalizeData &finalize_data) {
+		if (!state.buffer) {
+			finalize_data.ReturnNull();
+			return;
+		}
+		auto &buffer = *state.buffer;
+		auto count = buffer.Count();
+		auto &arena = finalize_data.input.allocator;
+		GeometryFactory factory(arena.GetAllocator());
+		if (count == 0) {
+			// Only empty points
+			LineString empty(false, false);
+			target = factory.Serialize(finalize_data.result, empty, false, false);
+			return;
+		}
+		if (count == 1) {
+			throw InvalidInputException("ST_MakeLine_Agg requires zero or two or more POINT geometries");
+		}
+		if (count > NumericLimits<uint32_t>::Maximum()) {
+			throw InvalidInputException("ST_MakeLine_Agg: Too many points for a single LINESTRING");
+		}
+
+		// Points with the same key stay in the order they arrived in
+		vector<uint32_t> order(count);
+		for (idx_t i = 0; i < count; i++) {
+			order[i] = static_cast<uint32_t>(i);
+		}
+		auto &keys = buffer.keys;
+		std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+
+		auto vertices = VertexArray::Create(arena, static_cast<uint32_t>(count), buffer.has_z, buffer.has_m);
+		auto vertex_size = vertices.GetProperties().VertexSize();
+		auto out = vertices.GetData();
+		for (idx_t i = 0; i < count; i++) {
+			auto src = order[i];
+			auto vertex = out + i * vertex_size;
+			Store<double>(buffer.xy[2 * src], vertex);
+			Store<double>(buffer.xy[2 * src + 1], vertex + sizeof(double));
+			auto offset = 2 * sizeof(double);
+			if (buffer.has_z) {
+				Store<double>(buffer.z[src], vertex + offset);
+				offset += sizeof(double);
+			}
+			if (buffer.has_m) {
+				Store<double>(buffer.m[src], vertex + offset);
+			}
+		}
+		LineString line(vertices);
+		target = factory.Serialize(finalize_data.result, line, buffer.has_z, buffer.has_m);
+	}
+
+	template <class STATE>
+	static void Destroy(STATE &state, AggregateInputData &) {
+		if (state.buffer) {
+			delete state.buffer;
+			state.buffer = nullptr;
+		}
+	}
+
+	static bool IgnoreNull() {
+		return true;
+	}
+};
+
+//------------------------------------------------------------------------
+// Update
+//------------------------------------------------------------------------
+// Rows with a NULL point or key are skipped, like NULL list elements in ST_MakeLine. Empty points are skipped too,
+// but still make the result an (empty) LINESTRING rather than NULL.
+template <class KEY>
+static void UpdateGeometry(Vector inputs[], AggregateInputData &, idx_t input_count, Vector &state_vector,
+                           idx_t count) {
+	D_ASSERT(input_count == 2);
+	UnifiedVectorFormat geom_format;
+	inputs[0].ToUnifiedFormat(count, geom_format);
+	auto geom_data = UnifiedVectorFormat::GetData<geometry_t>(geom_format);
+
+	UnifiedVectorFormat key_format;
+	inputs[1].ToUnifiedFormat(count, key_format);
+	auto key_data = UnifiedVectorFormat::GetData<KEY>(key_format);
+
+	UnifiedVectorFormat state_format;
+	state_vector.ToUnifiedFormat(count, state_format);
+	auto states = UnifiedVectorFormat::GetData<MakeLineAggState<KEY> *>(state_format);
+
+	for (idx_t i = 0; i < count; i++) {
+		auto geom_idx = geom_format.sel->get_index(i);
+		auto key_idx = key_format.sel->get_index(i);
+		if (!geom_format.validity.RowIsValid(geom_idx) || !key_format.validity.RowIsValid(key_idx)) {
+			continue;
+		}
+		auto &blob = geom_data[geom_idx];
+		if (blob.GetType() != GeometryType::POINT) {
+			throw InvalidInputException("ST_MakeLine_Agg only accepts POINT geometries");
+		}
+
+		auto &state = *states[state_format.sel->get_index(i)];
+		if (!state.buffer) {
+			state.buffer = new MakeLineBuffer<KEY>();
+		}
+
+		// Read the point in place, Z and M follow X and Y
+		Cursor cursor(blob);
+		auto properties = GeometryFactory::SkipSerializedHeader(cursor);
+		cursor.Skip<SerializedGeometryType>();
+		if (cursor.Read<uint32_t>() == 0) {
+			continue;
+		}
+		auto x = cursor.Read<double>();
+		auto y = cursor.Read<double>();
+		state.buffer->Append(key_data[key_idx], x, y);
+		if (properties.HasZ()) {
+			state.buffer->SetZ(cursor.Read<double>());
+		}
+		if (properties.HasM()) {
+			state.buffer->SetM(cursor.Read<double>());
+		}
+	}
+}
+
+template <class KEY>
+static void UpdatePoint2D(Vector inputs[], AggregateInputData &, idx_t input_count, Vector &state_vector,
+                          idx_t count) {
+	D_ASSERT(input_count == 2);
+	// Work on a flat struct so that the fields line up with the rows
+	auto &input = inputs[0];
+	unique_ptr<Vector> flat_points;
+	if (input.GetVectorType() != VectorType::FLAT_VECTOR) {
+		flat_points = make_uniq<Vector>(input.GetType(), count);
+		VectorOperations::Copy(input, *flat_points, count, 0, 0);
+	}
+	auto &points = flat_points ? *flat_points : input;
+	auto &point_validity = FlatVector::Validity(points);
+	auto &children = StructVector::GetEntries(points);
+	auto x_data = FlatVector::GetData<double>(*children[0]);
+	auto y_data = FlatVector::GetData<double>(*children[1]);
+
+	UnifiedVectorFormat key_format;
+	inputs[1].ToUnifiedFormat(count, key_format);
+	auto key_data = UnifiedVectorFormat::GetData<KEY>(key_format);
+
+	UnifiedVectorFormat state_format;
+	state_vector.ToUnifiedFormat(count, state_format);
+	auto states = UnifiedVectorFormat::GetData<MakeLineAggState<KEY> *>(state_format);
+
+	for (idx_t i = 0; i < count; i++) {
+		auto key_idx = key_format.sel->get_index(i);
+		if (!point_validity.RowIsValid(i) || !key_format.validity.RowIsValid(key_idx)) {
+			continue;
+		}
+		auto &state = *states[state_format.sel->get_index(i)];
+		if (!state.buffer) {
+			state.buffer = new MakeLineBuffer<KEY>();
+		}
+		state.buffer->Append(key_data[key_idx], x_data[i], y_data[i]);
+	}
+}
+
+//------------------------------------------------------------------------
+// Register
+//------------------------------------------------------------------------
+template <class KEY>
+static AggregateFunction GetMakeLineAggregate(const LogicalType &point_type, const LogicalType &key_type) {
+	using STATE = MakeLineAggState<KEY>;
+	aggregate_update_t update = point_type == GeoTypes::POINT_2D() ? UpdatePoint2D<KEY> : UpdateGeometry<KEY>;
+	return AggregateFunction({point_type, key_type}, GeoTypes::GEOMETRY(), AggregateFunction::StateSize<STATE>,
+	                         AggregateFunction::StateInitialize<STATE, MakeLineAggFunction>, update,
+	                         AggregateFunction::StateCombine<STATE, MakeLineAggFunction>,
+	                         AggregateFunction::StateFinalize<STATE, geometry_t, MakeLineAggFunction>,
+	                         FunctionNullHandling::DEFAULT_NULL_HANDLING, nullptr, nullptr,
+	                         AggregateFunction::StateDestroy<STATE, MakeLineAggFunction>);
+}
+
+void CoreAggregateFunctions::RegisterStMakeLineAgg(DatabaseInstance &db) {
+
+	AggregateFunctionSet st_makeline_agg("ST_MakeLine_Agg");
+	for (auto &point_type : {GeoTypes::GEOMETRY(), GeoTypes::POINT_2D()}) {
+		st_makeline_agg.AddFunction(GetMakeLineAggregate<int64_t>(point_type, LogicalType::BIGINT));
+		st_makeline_agg.AddFunction(GetMakeLineAggregate<double>(point_type, LogicalType::DOUBLE));
+		st_makeline_agg.AddFunction(GetMakeLineAggregate<timestamp_t>(point_type, LogicalType::TIMESTAMP));
+		st_makeline_agg.AddFunction(GetMakeLineAggregate<timestamp_t>(point_type, LogicalType::TIMESTAMP_TZ));
+	}
+
+	ExtensionUtil::RegisterFunction(db, st_makeline_agg);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,234 @@
+#include "duckdb/parser/parsed_data/create_aggregate_function_info.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/storage/object_cache.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/geometry/cursor.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/functions/aggregate.hpp"
+#include "spatial/core/functions/common.hpp"
+#include "spatial/core/graph/routing_graph.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------
+// State
+//------------------------------------------------------------------------
+struct RoutingGraphAggState {
+	vector<RoutingEdge> *edges;
+	idx_t tracked_size;
+};
+
+struct RoutingGraphBindData final : public AggregateMemoryBindData {
+	string graph_name;
+	// No weight was given, so every edge is as long as its LINESTRING
+	bool planar_weights;
+
+	RoutingGraphBindData(string function_name, ClientContext &context, string graph_name, bool planar_weights)
+	    : AggregateMemoryBindData(std::move(function_name), context), graph_name(std::move(graph_name)),
+	      planar_weights(planar_weights) {
+	}
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<RoutingGraphBindData>(function_name, context, graph_name, planar_weights);
+	}
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<RoutingGraphBindData>();
+		return AggregateMemoryBindData::Equals(other) && graph_name == other.graph_name &&
+		       planar_weights == other.planar_weights;
+	}
+};
+
+static void TrackEdges(RoutingGraphAggState &state, const AggregateInputData &input) {
+	auto &bind_data = input.bind_data->Cast<RoutingGraphBindData>();
+	bind_data.Update(state.tracked_size, state.edges ? state.edges->capacity() * sizeof(RoutingEdge) : 0);
+}
+
+//------------------------------------------------------------------------
+// ROUTING GRAPH AGG
+//------------------------------------------------------------------------
+// Collects the end points and weights of the input LINESTRINGs, and builds the graph once all of them are in. The
+// graph is stored in the object cache under its name, replacing an earlier graph with the same name, and the result
+// is the number of edges in it.
+struct RoutingGraphAggFunction {
+	template <class STATE>
+	static void Initialize(STATE &state) {
+		state.edges = nullptr;
+		state.tracked_size = 0;
+	}
+
+	template <class STATE, class OP>
+	static void Combine(const STATE &source, STATE &target, AggregateInputData &input) {
+		if (!source.edges) {
+			return;
+		}
+		if (!target.edges) {
+			target.edges = new vector<RoutingEdge>();
+		}
+		auto &edges = *source.edges;
+		target.edges->insert(target.edges->end(), edges.begin(), edges.end());
+		TrackEdges(target, input);
+	}
+
+	template <class T, class STATE>
+	static void Finalize(STATE &state, T &target, AggregateFinalizeData &finalize_data) {
+		auto &bind_data = finalize_data.input.bind_data->Cast<RoutingGraphBindData>();
+		vector<RoutingEdge> no_edges;
+		auto &edges = state.edges ? *state.edges : no_edges;
+		shared_ptr<RoutingGraph> graph = RoutingGraph::Build(edges, bind_data.planar_weights);
+
+		auto &cache = ObjectCache::GetObjectCache(bind_data.context);
+		cache.Put(RoutingGraph::GetCacheKey(bind_data.graph_name), graph);
+		target = static_cast<int64_t>(graph->edge_count);
+	}
+
+	template <class STATE>
+	static void Destroy(STATE &state, AggregateInputData &input) {
+		if (state.edges) {
+			delete state.edges;
+			state.edges = nullptr;
+			TrackEdges(state, input);
+		}
+	}
+
+	static bool IgnoreNull() {
+		return true;
+	}
+};
+
+//------------------------------------------------------------------------
+// Update
+//------------------------------------------------------------------------
+// The LINESTRINGs are read in place, only their end points (and their length if there is no weight) are needed.
+// Rows with a NULL or empty geometry or a NULL weight are skipped.
+static void RoutingGraphUpdate(Vector inputs[], AggregateInputData &aggr_input, idx_t input_count,
+                               Vector &state_vector, idx_t count) {
+	auto has_weight = input_count == 2;
+
+	UnifiedVectorFormat geom_format;
+	inputs[0].ToUnifiedFormat(count, geom_format);
+	auto geom_data = UnifiedVectorFormat::GetData<geometry_t>(geom_format);
+
+	UnifiedVectorFormat weight_format;
+	if (has_weight) {
+		inputs[1].ToUnifiedFormat(count, weight_format);
+	}
+
+	UnifiedVectorFormat state_format;
+	state_vector.ToUnifiedFormat(count, state_format);
+	auto states = UnifiedVectorFormat::GetData<RoutingGraphAggState *>(state_format);
+
+	for (idx_t i = 0; i < count; i++) {
+		auto geom_idx = geom_format.sel->get_index(i);
+		if (!geom_format.validity.RowIsValid(geom_idx)) {
+			continue;
+		}
+		double weight = 0;
+		if (has_weight) {
+			auto weight_idx = weight_format.sel->get_index(i);
+			if (!weight_format.validity.RowIsValid(weight_idx)) {
+				continue;
+			}
+			weight = UnifiedVectorFormat::GetData<double>(weight_format)[weight_idx];
+			if (!(weight >= 0) || !Value::IsFinite(weight)) {
+				throw InvalidInputException("ST_RoutingGraph_Agg: weights must be finite and not negative");
+			}
+		}
+
+		auto &blob = geom_data[geom_idx];
+		if (blob.GetType() != GeometryType::LINESTRING) {
+			throw InvalidInputException("ST_RoutingGraph_Agg only accepts LINESTRING geometries");
+		}
+		Cursor cursor(blob);
+		auto properties = GeometryFactory::SkipSerializedHeader(cursor);
+		cursor.Skip<SerializedGeometryType>();
+		auto vertex_count = cursor.Read<uint32_t>();
+		if (vertex_count == 0) {
+			continue;
+		}
+		auto vertex_size = properties.VertexSize();
+		auto vertices = cursor.GetPtr();
+
+		RoutingEdge edge;
+		edge.x0 = Load<double>(vertices);
+		edge.y0 = Load<double>(vertices + sizeof(double));
+		edge.weight = weight;
+		if (has_weight) {
+			auto last = vertices + (vertex_count - 1) * vertex_size;
+			edge.x1 = Load<double>(last);
+			edge.y1 = Load<double>(last + sizeof(double));
+		} else {
+			edge.x1 = edge.x0;
+			edge.y1 = edge.y0;
+			for (uint32_t v = 1; v < vertex_count; v++) {
+				auto vertex = vertices + v * vertex_size;
+				auto x = Load<double>(vertex);
+				auto y = Load<double>(vertex + sizeof(double));
+				edge.weight += std::sqrt((x - edge.x1) * (x - edge.x1) + (y - edge.y1) * (y - edge.y1));
+				edge.x1 = x;
+				edge.y1 = y;
+			}
+		}
+
+		auto &state = *states[state_format.sel->get_index(i)];
+		if (!state.edges) {
+			state.edges = new vector<RoutingEdge>();
+		}
+		auto capacity = state.edges->capacity();
+		state.edges->push_back(edge);
+		if (state.edges->capacity() != capacity) {
+			TrackEdges(state, aggr_input);
+		}
+	}
+}
+
+//------------------------------------------------------------------------
+// Bind
+//------------------------------------------------------------------------
+static unique_ptr<FunctionData> RoutingGraphBind(ClientContext &context, AggregateFunction &function,
+                                                 vector<unique_ptr<Expression>> &arguments) {
+	if (!arguments[0]->IsFoldable()) {
+		throw InvalidInputException("ST_RoutingGraph_Agg: the graph name must be constant");
+	}
+	auto name_value = ExpressionExecutor::EvaluateScalar(context, *arguments[0]);
+	if (name_value.IsNull()) {
+		throw InvalidInputException("ST_RoutingGraph_Agg: the graph name can not be NULL");
+	}
+	auto graph_name = name_value.ToString();
+	auto planar_weights = arguments.size() == 2;
+
+	// The name is constant, so the aggregate itself only sees the geometries and weights
+	Function::EraseArgument(function, arguments, 0);
+	return make_uniq<RoutingGraphBindData>(function.name, context, std::move(graph_name), planar_weights);
+}
+
+//------------------------------------------------------------------------
+// Register
+//------------------------------------------------------------------------
+void CoreAggregateFunctions::RegisterStRoutingGraphAgg(DatabaseInstance &db) {
+	using STATE = RoutingGraphAggState;
+
+	AggregateFunctionSet st_routinggraph_agg("ST_RoutingGraph_Agg");
+	for (auto &weighted : {false, true}) {
+		vector<LogicalType> arguments = {LogicalType::VARCHAR, GeoTypes::GEOMETRY()};
+		if (weighted) {
+			arguments.push_back(LogicalType::DOUBLE);
+		}
+		AggregateFunction function(arguments, LogicalType::BIGINT, AggregateFunction::StateSize<STATE>,
+		                           AggregateFunction::StateInitialize<STATE, RoutingGraphAggFunction>,
+		                           RoutingGraphUpdate, AggregateFunction::StateCombine<STATE, RoutingGraphAggFunction>,
+		                           AggregateFunction::StateFinalize<STATE, int64_t, RoutingGraphAggFunction>,
+		                           FunctionNullHandling::DEFAULT_NULL_HANDLING, nullptr, RoutingGraphBind,
+		                           AggregateFunction::StateDestroy<STATE, RoutingGraphAggFunction>);
+		st_routinggraph_agg.AddFunction(function);
+	}
+
+	ExtensionUtil::RegisterFunction(db, st_routinggraph_agg);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,281 @@
+#include "duckdb/parser/parsed_data/create_aggregate_function_info.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/common/random_engine.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/functions/aggregate.hpp"
+#include "spatial/core/functions/common.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------
+// State
+//------------------------------------------------------------------------
+// Every geometry is placed in the grid cell that the center of its bounding box falls in, read from the header
+// without touching the coordinates. Each cell keeps the geometries with the smallest random priorities seen so far,
+// which is a uniform sample of the cell that merges exactly: the sample of two states is the geometries with the
+// smallest priorities of both. The memory held is bounded by the number of occupied cells times the sample size.
+
+struct SampleGridItem {
+	double priority;
+	string blob;
+
+	bool operator<(const SampleGridItem &other) const {
+		return priority < other.priority;
+	}
+};
+
+struct SampleGridCell {
+	int64_t x;
+	int64_t y;
+
+	bool operator==(const SampleGridCell &other) const {
+		return x == other.x && y == other.y;
+	}
+	bool operator<(const SampleGridCell &other) const {
+		return y < other.y || (y == other.y && x < other.x);
+	}
+};
+
+struct SampleGridCellHash {
+	size_t operator()(const SampleGridCell &cell) const {
+		return CombineHash(Hash(cell.x), Hash(cell.y));
+	}
+};
+
+struct SampleGridData {
+	// A max-heap on the priority per cell, so the item to replace is at the front
+	unordered_map<SampleGridCell, vector<SampleGridItem>, SampleGridCellHash> cells;
+	RandomEngine random;
+	idx_t size = 0;
+	idx_t tracked_size = 0;
+
+	// The seed only has to differ between states, so that merged samples stay uniform
+	explicit SampleGridData(int64_t seed) : random(seed) {
+	}
+
+	// Returns true if the item was kept
+	bool Add(const SampleGridCell &cell, double priority, const char *blob, idx_t blob_size, idx_t sample_size) {
+		auto &items = cells[cell];
+		if (items.size() < sample_size) {
+			items.push_back({priority, string(blob, blob_size)});
+			std::push_heap(items.begin(), items.end());
+			size += sizeof(SampleGridItem) + blob_size;
+			return true;
+		}
+		if (!(priority < items.front().priority)) {
+			return false;
+		}
+		std::pop_heap(items.begin(), items.end());
+		size -= items.back().blob.size();
+		items.back().priority = priority;
+		items.back().blob.assign(blob, blob_size);
+		size += blob_size;
+		std::push_heap(items.begin(), items.end());
+		return true;
+	}
+};
+
+struct SampleGridAggState {
+	SampleGridData *data;
+};
+
+struct SampleGridBindData final : public AggregateMemoryBindData {
+	double cell_size;
+	idx_t sample_size;
+
+	SampleGridBindData(string function_name, ClientContext &context, double cell_size, idx_t sample_size)
+	    : AggregateMemoryBindData(std::move(function_name), context), cell_size(cell_size), sample_size(sample_size) {
+	}
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<SampleGridBindData>(function_name, context, cell_size, sample_size);
+	}
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<SampleGridBindData>();
+		return AggregateMemoryBindData::Equals(other) && cell_size == other.cell_size &&
+		       sample_size == other.sample_size;
+	}
+};
+
+//------------------------------------------------------------------------
+// SAMPLE GRID AGG
+//------------------------------------------------------------------------
+struct SampleGridAggFunction {
+	template <class STATE>
+	static void Initialize(STATE &state) {
+		state.data = nullptr;
+	}
+
+	static SampleGridData &GetData(SampleGridAggState &state) {
+		if (!state.data) {
+			state.data = new SampleGridData(reinterpret_cast<int64_t>(&state));
+		}
+		return *state.data;
+	}
+
+	template <class STATE, class OP>
+	static void Combine(const STATE &source, STATE &target, AggregateInputData &input) {
+		if (!source.data) {
+			return;
+		}
+		auto &bind_data = input.bind_data->Cast<SampleGridBindData>();
+		auto &target_data = GetData(target);
+		for (auto &entry : source.data->cells) {
+			for (auto &item : entry.second) {
+				target_data.Add(entry.first, item.priority, item.blob.data(), item.blob.size(), bind_data.sample_size);
+			}
+		}
+		bind_data.Update(target_data.tracked_size, target_data.size);
+	}
+
+	// Cells outside of the int64 range (and NaN coordinates) are clamped to the edge of the grid
+	static int64_t ToCell(double coordinate, double cell_size) {
+		auto cell = std::floor(coordinate / cell_size);
+		if (!(cell > static_cast<double>(NumericLimits<int64_t>::Minimum()))) {
+			return NumericLimits<int64_t>::Minimum();
+		}
+		if (!(cell < static_cast<double>(NumericLimits<int64_t>::Maximum()))) {
+			return NumericLimits<int64_t>::Maximum();
+		}
+		return static_cast<int64_t>(cell);
+	}
+
+	static void Update(Vector inputs[], AggregateInputData &input, idx_t input_count, Vector &state_vector,
+	                   idx_t count) {
+		auto &bind_data = input.bind_data->Cast<SampleGridBindData>();
+		UnifiedVectorFormat input_format;
+		inputs[0].ToUnifiedFormat(count, input_format);
+		auto input_data = UnifiedVectorFormat::GetData<geometry_t>(input_format);
+
+		UnifiedVectorFormat state_format;
+		state_vector.ToUnifiedFormat(count, state_format);
+		auto states = UnifiedVectorFormat::GetData<SampleGridAggState *>(state_format);
+
+		BoundingBox bbox;
+		for (idx_t i = 0; i < count; i++) {
+			auto idx = input_format.sel->get_index(i);
+			if (!input_format.validity.RowIsValid(idx)) {
+				continue;
+			}
+			auto &geom = input_data[idx];
+			if (!GeometryFactory::TryGetSerializedBoundingBox(geom, bbox)) {
+				// Empty geometries have no place in the grid
+				continue;
+			}
+			SampleGridCell cell;
+			cell.x = ToCell((bbox.minx + bbox.maxx) / 2, bind_data.cell_size);
+			cell.y = ToCell((bbox.miny + bbox.maxy) / 2, bind_data.cell_size);
+
+			auto &data = GetData(*states[state_format.sel->get_index(i)]);
+			auto blob = string_t(geom);
+			if (data.Add(cell, data.random.NextRandom(), blob.GetData(), blob.GetSize(), bind_data.sample_size)) {
+				bind_data.Update(data.tracked_size, data.size);
+			}
+		}
+	}
+
+	// The samples are returned cell by cell, ordered by the cell's row and then its column
+	static void Finalize(Vector &state_vector, AggregateInputData &, Vector &result, idx_t count, idx_t offset) {
+		UnifiedVectorFormat state_format;
+		state_vector.ToUnifiedFormat(count, state_format);
+		auto states = UnifiedVectorFormat::GetData<SampleGridAggState *>(state_format);
+
+		auto &validity = FlatVector::Validity(result);
+		auto entries = FlatVector::GetData<list_entry_t>(result);
+		auto &child = ListVector::GetEntry(result);
+		vector<SampleGridCell> order;
+		for (idx_t i = 0; i < count; i++) {
+			auto &state = *states[state_format.sel->get_index(i)];
+			if (!state.data) {
+				validity.SetInvalid(i + offset);
+				continue;
+			}
+			auto &cells = state.data->cells;
+			order.clear();
+			idx_t sample_count = 0;
+			for (auto &entry : cells) {
+				order.push_back(entry.first);
+				sample_count += entry.second.size();
+			}
+			std::sort(order.begin(), order.end());
+
+			auto list_offset = ListVector::GetListSize(result);
+			ListVector::Reserve(result, list_offset + sample_count);
+			auto child_data = FlatVector::GetData<string_t>(child);
+			auto child_idx = list_offset;
+			for (auto &cell : order) {
+				for (auto &item : cells[cell]) {
+					child_data[child_idx++] = StringVector::AddStringOrBlob(child, item.blob);
+				}
+			}
+			entries[i + offset].offset = list_offset;
+			entries[i + offset].length = sample_count;
+			ListVector::SetListSize(result, list_offset + sample_count);
+		}
+	}
+
+	static void Destroy(Vector &state_vector, AggregateInputData &input, idx_t count) {
+		auto &bind_data = input.bind_data->Cast<SampleGridBindData>();
+		auto states = FlatVector::GetData<SampleGridAggState *>(state_vector);
+		for (idx_t i = 0; i < count; i++) {
+			auto &state = *states[i];
+			if (state.data) {
+				bind_data.Update(state.data->tracked_size, 0);
+				delete state.data;
+				state.data = nullptr;
+			}
+		}
+	}
+};
+
+//------------------------------------------------------------------------
+// Bind
+//------------------------------------------------------------------------
+static unique_ptr<FunctionData> SampleGridBind(ClientContext &context, AggregateFunction &function,
+                                               vector<unique_ptr<Expression>> &arguments) {
+	if (!arguments[1]->IsFoldable() || !arguments[2]->IsFoldable()) {
+		throw InvalidInputException("ST_SampleGrid: the cell size and the sample size must be constant");
+	}
+	auto cell_size_value = ExpressionExecutor::EvaluateScalar(context, *arguments[1]);
+	auto cell_size = cell_size_value.IsNull() ? 0 : cell_size_value.GetValue<double>();
+	if (!(cell_size > 0) || !Value::IsFinite(cell_size)) {
+		throw InvalidInputException("ST_SampleGrid: the cell size must be a positive number");
+	}
+	auto sample_size_value = ExpressionExecutor::EvaluateScalar(context, *arguments[2]);
+	if (sample_size_value.IsNull() || sample_size_value.GetValue<int64_t>() < 1) {
+		throw InvalidInputException("ST_SampleGrid: the sample size per cell must be a positive number");
+	}
+	auto sample_size = sample_size_value.GetValue<idx_t>();
+
+	// The cell and sample sizes are constant, so the aggregate itself only sees the geometries
+	Function::EraseArgument(function, arguments, 2);
+	Function::EraseArgument(function, arguments, 1);
+	return make_uniq<SampleGridBindData>(function.name, context, cell_size, sample_size);
+}
+
+//------------------------------------------------------------------------
+// Register
+//------------------------------------------------------------------------
+void CoreAggregateFunctions::RegisterStSampleGrid(DatabaseInstance &db) {
+	AggregateFunctionSet st_samplegrid("ST_SampleGrid");
+
+	AggregateFunction function({GeoTypes::GEOMETRY(), LogicalType::DOUBLE, LogicalType::BIGINT},
+	                           LogicalType::LIST(GeoTypes::GEOMETRY()),
+	                           AggregateFunction::StateSize<SampleGridAggState>,
+	                           AggregateFunction::StateInitialize<SampleGridAggState, SampleGridAggFunction>,
+	                           SampleGridAggFunction::Update,
+	                           AggregateFunction::StateCombine<SampleGridAggState, SampleGridAggFunction>,
+	                           SampleGridAggFunction::Finalize, nullptr, SampleGridBind,
+	                           SampleGridAggFunction::Destroy);
+	st_samplegrid.AddFunction(function);
+
+	ExtensionUtil::RegisterFunction(db, st_samplegrid);
+}
+
+} // namespace core
+
+} // namespace spatial
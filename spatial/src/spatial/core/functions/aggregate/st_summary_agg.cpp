@@ -0,0 +1,376 @@
+#include "duckdb/parser/parsed_data/create_aggregate_function_info.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/common/random_engine.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/vertex_count.hpp"
+#include "spatial/core/functions/aggregate.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------
+// State
+//------------------------------------------------------------------------
+// Everything but the percentiles and the density grid is exact. Those are computed from a reservoir sample of the
+// non-empty geometries, which is exact as long as there are no more of them than the sample size.
+
+static constexpr idx_t SUMMARY_DEFAULT_SAMPLE_SIZE = 8192;
+static constexpr idx_t SUMMARY_GRID_SIZE = 8;
+static constexpr idx_t SUMMARY_TYPE_COUNT = 7;
+
+struct SummarySample {
+	uint32_t vertex_count;
+	double center_x;
+	double center_y;
+};
+
+struct SummaryData {
+	idx_t count = 0;
+	idx_t empty = 0;
+	idx_t with_z = 0;
+	idx_t with_m = 0;
+	idx_t types[SUMMARY_TYPE_COUNT] = {0};
+	idx_t total_vertices = 0;
+	uint32_t min_vertices = NumericLimits<uint32_t>::Maximum();
+	uint32_t max_vertices = 0;
+	double xmin = NumericLimits<double>::Maximum();
+	double ymin = NumericLimits<double>::Maximum();
+	double xmax = NumericLimits<double>::Minimum();
+	double ymax = NumericLimits<double>::Minimum();
+	// The non-empty geometries seen, and a uniform sample of them
+	idx_t sampled_from = 0;
+	vector<SummarySample> sample;
+	RandomEngine random;
+
+	// The seed only has to differ between states, so that merged samples stay uniform
+	explicit SummaryData(int64_t seed) : random(seed) {
+	}
+
+	void Add(const SummarySample &item, idx_t sample_size) {
+		sampled_from++;
+		if (sample.size() < sample_size) {
+			sample.push_back(item);
+			return;
+		}
+		// Keep the new item with probability sample_size / sampled_from
+		auto slot = static_cast<idx_t>(random.NextRandom() * static_cast<double>(sampled_from));
+		if (slot < sample_size) {
+			sample[slot] = item;
+		}
+	}
+
+	void Combine(SummaryData &other, idx_t sample_size) {
+		count += other.count;
+		empty += other.empty;
+		with_z += other.with_z;
+		with_m += other.with_m;
+		for (idx_t i = 0; i < SUMMARY_TYPE_COUNT; i++) {
+			types[i] += other.types[i];
+		}
+		total_vertices += other.total_vertices;
+		min_vertices = MinValue(min_vertices, other.min_vertices);
+		max_vertices = MaxValue(max_vertices, other.max_vertices);
+		xmin = MinValue(xmin, other.xmin);
+		ymin = MinValue(ymin, other.ymin);
+		xmax = MaxValue(xmax, other.xmax);
+		ymax = MaxValue(ymax, other.ymax);
+
+		auto total = sampled_from + other.sampled_from;
+		if (sample.size() + other.sample.size() <= sample_size) {
+			sample.insert(sample.end(), other.sample.begin(), other.sample.end());
+			sampled_from = total;
+			return;
+		}
+		// Draw the merged sample from both samples, in proportion to the number of geometries they stand for
+		auto &left = sample;
+		auto &right = other.sample;
+		Shuffle(left);
+		Shuffle(right);
+		vector<SummarySample> merged;
+		merged.reserve(sample_size);
+		idx_t left_idx = 0;
+		idx_t right_idx = 0;
+		auto left_weight = static_cast<double>(sampled_from) / static_cast<double>(total);
+		while (merged.size() < sample_size && (left_idx < left.size() || right_idx < right.size())) {
+			auto take_left = right_idx == right.size() || (left_idx < left.size() && random.NextRandom() < left_weight);
+			merged.push_back(take_left ? left[left_idx++] : right[right_idx++]);
+		}
+		sample = std::move(merged);
+		sampled_from = total;
+	}
+
+	void Shuffle(vector<SummarySample> &items) {
+		for (idx_t i = items.size(); i > 1; i--) {
+			auto j = static_cast<idx_t>(random.NextRandom() * static_cast<double>(i));
+			std::swap(items[i - 1], items[MinValue<idx_t>(j, i - 1)]);
+		}
+	}
+};
+
+struct SummaryAggState {
+	SummaryData *data;
+};
+
+struct SummaryBindData : public FunctionData {
+	idx_t sample_size;
+
+	explicit SummaryBindData(idx_t sample_size) : sample_size(sample_size) {
+	}
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<SummaryBindData>(sample_size);
+	}
+	bool Equals(const FunctionData &other_p) const override {
+		return sample_size == other_p.Cast<SummaryBindData>().sample_size;
+	}
+};
+
+//------------------------------------------------------------------------
+// SUMMARY AGG
+//------------------------------------------------------------------------
+// Only the headers, bounding boxes and vertex counts of the inputs are read, never their coordinates (except for
+// points, whose coordinates are their bounding box).
+struct SummaryAggFunction {
+	template <class STATE>
+	static void Initialize(STATE &state) {
+		state.data = nullptr;
+	}
+
+	static SummaryData &GetData(SummaryAggState &state) {
+		if (!state.data) {
+			state.data = new SummaryData(reinterpret_cast<int64_t>(&state));
+		}
+		return *state.data;
+	}
+
+	template <class STATE, class OP>
+	static void Combine(const STATE &source, STATE &target, AggregateInputData &input) {
+		if (!source.data) {
+			return;
+		}
+		auto &bind_data = input.bind_data->Cast<SummaryBindData>();
+		GetData(target).Combine(*source.data, bind_data.sample_size);
+	}
+
+	static void Update(Vector inputs[], AggregateInputData &input, idx_t input_count, Vector &state_vector,
+	                   idx_t count) {
+		auto &bind_data = input.bind_data->Cast<SummaryBindData>();
+		UnifiedVectorFormat input_format;
+		inputs[0].ToUnifiedFormat(count, input_format);
+		auto input_data = UnifiedVectorFormat::GetData<geometry_t>(input_format);
+
+		UnifiedVectorFormat state_format;
+		state_vector.ToUnifiedFormat(count, state_format);
+		auto states = UnifiedVectorFormat::GetData<SummaryAggState *>(state_format);
+
+		VertexCountProcessor vertex_counter;
+		BoundingBox bbox;
+		for (idx_t i = 0; i < count; i++) {
+			auto idx = input_format.sel->get_index(i);
+			if (!input_format.validity.RowIsValid(idx)) {
+				continue;
+			}
+			auto &geom = input_data[idx];
+			auto &data = GetData(*states[state_format.sel->get_index(i)]);
+			data.count++;
+			data.types[static_cast<uint8_t>(geom.GetType())]++;
+			auto properties = geom.GetProperties();
+			data.with_z += properties.HasZ();
+			data.with_m += properties.HasM();
+
+			if (!GeometryFactory::TryGetSerializedBoundingBox(geom, bbox)) {
+				data.empty++;
+				continue;
+			}
+			auto vertex_count = vertex_counter.Execute(geom);
+			data.total_vertices += vertex_count;
+			data.min_vertices = MinValue(data.min_vertices, vertex_count);
+			data.max_vertices = MaxValue(data.max_vertices, vertex_count);
+			data.xmin = MinValue(data.xmin, bbox.minx);
+			data.ymin = MinValue(data.ymin, bbox.miny);
+			data.xmax = MaxValue(data.xmax, bbox.maxx);
+			data.ymax = MaxValue(data.ymax, bbox.maxy);
+			data.Add({vertex_count, (bbox.minx + bbox.maxx) / 2, (bbox.miny + bbox.maxy) / 2},
+			         bind_data.sample_size);
+		}
+	}
+
+	static Value Summarize(SummaryData &data) {
+		auto count_value = [](idx_t value) {
+			return Value::UBIGINT(value);
+		};
+
+		child_list_t<Value> types;
+		const char *type_names[] = {"point",           "linestring",   "polygon",           "multipoint",
+		                            "multilinestring", "multipolygon", "geometrycollection"};
+		for (idx_t i = 0; i < SUMMARY_TYPE_COUNT; i++) {
+			types.emplace_back(type_names[i], count_value(data.types[i]));
+		}
+
+		auto non_empty = data.count - data.empty;
+		Value extent(GeoTypes::BOX_2D());
+		Value vertices(GetVerticesType());
+		vector<Value> density;
+		if (non_empty > 0) {
+			extent = Value::STRUCT({{"min_x", Value::DOUBLE(data.xmin)},
+			                        {"min_y", Value::DOUBLE(data.ymin)},
+			                        {"max_x", Value::DOUBLE(data.xmax)},
+			                        {"max_y", Value::DOUBLE(data.ymax)}});
+
+			vector<uint32_t> counts;
+			counts.reserve(data.sample.size());
+			for (auto &item : data.sample) {
+				counts.push_back(item.vertex_count);
+			}
+			std::sort(counts.begin(), counts.end());
+			auto percentile = [&](double fraction) {
+				auto rank = static_cast<idx_t>(std::ceil(fraction * static_cast<double>(counts.size())));
+				return Value::UINTEGER(counts[MaxValue<idx_t>(rank, 1) - 1]);
+			};
+			vertices = Value::STRUCT({{"total", count_value(data.total_vertices)},
+			                          {"min", Value::UINTEGER(data.min_vertices)},
+			                          {"p50", percentile(0.5)},
+			                          {"p90", percentile(0.9)},
+			                          {"p99", percentile(0.99)},
+			                          {"max", Value::UINTEGER(data.max_vertices)}});
+
+			// Scale the sampled cell counts up to all the non-empty geometries
+			vector<idx_t> cells(SUMMARY_GRID_SIZE * SUMMARY_GRID_SIZE, 0);
+			auto width = data.xmax - data.xmin;
+			auto height = data.ymax - data.ymin;
+			auto cell_of = [](double offset, double extent) {
+				if (!(extent > 0)) {
+					return idx_t(0);
+				}
+				auto cell = static_cast<idx_t>(offset / extent * SUMMARY_GRID_SIZE);
+				return MinValue<idx_t>(cell, SUMMARY_GRID_SIZE - 1);
+			};
+			for (auto &item : data.sample) {
+				auto x = cell_of(item.center_x - data.xmin, width);
+				auto y = cell_of(item.center_y - data.ymin, height);
+				cells[y * SUMMARY_GRID_SIZE + x]++;
+			}
+			auto scale = static_cast<double>(non_empty) / static_cast<double>(data.sample.size());
+			for (auto cell : cells) {
+				density.push_back(count_value(static_cast<idx_t>(std::round(static_cast<double>(cell) * scale))));
+			}
+		}
+
+		return Value::STRUCT({{"count", count_value(data.count)},
+		                      {"empty", count_value(data.empty)},
+		                      {"with_z", count_value(data.with_z)},
+		                      {"with_m", count_value(data.with_m)},
+		                      {"types", Value::STRUCT(std::move(types))},
+		                      {"extent", extent},
+		                      {"vertices", vertices},
+		                      {"sample_size", count_value(data.sample.size())},
+		                      {"density", non_empty > 0 ? Value::LIST(LogicalType::UBIGINT, std::move(density))
+		                                                : Value(LogicalType::LIST(LogicalType::UBIGINT))}});
+	}
+
+	static void Finalize(Vector &state_vector, AggregateInputData &, Vector &result, idx_t count, idx_t offset) {
+		UnifiedVectorFormat state_format;
+		state_vector.ToUnifiedFormat(count, state_format);
+		auto states = UnifiedVectorFormat::GetData<SummaryAggState *>(state_format);
+
+		if (state_vector.GetVectorType() == VectorType::CONSTANT_VECTOR) {
+			result.SetVectorType(VectorType::CONSTANT_VECTOR);
+			count = 1;
+			offset = 0;
+		}
+
+		for (idx_t i = 0; i < count; i++) {
+			auto &state = *states[state_format.sel->get_index(i)];
+			if (!state.data) {
+				result.SetValue(i + offset, Value(result.GetType()));
+				continue;
+			}
+			result.SetValue(i + offset, Summarize(*state.data));
+		}
+	}
+
+	static void Destroy(Vector &state_vector, AggregateInputData &, idx_t count) {
+		auto states = FlatVector::GetData<SummaryAggState *>(state_vector);
+		for (idx_t i = 0; i < count; i++) {
+			auto &state = *states[i];
+			if (state.data) {
+				delete state.data;
+				state.data = nullptr;
+			}
+		}
+	}
+
+	static LogicalType GetVerticesType() {
+		return LogicalType::STRUCT({{"total", LogicalType::UBIGINT},
+		                            {"min", LogicalType::UINTEGER},
+		                            {"p50", LogicalType::UINTEGER},
+		                            {"p90", LogicalType::UINTEGER},
+		                            {"p99", LogicalType::UINTEGER},
+		                            {"max", LogicalType::UINTEGER}});
+	}
+
+	static LogicalType GetResultType() {
+		child_list_t<LogicalType> types;
+		for (auto name : {"point", "linestring", "polygon", "multipoint", "multilinestring", "multipolygon",
+		                  "geometrycollection"}) {
+			types.emplace_back(name, LogicalType::UBIGINT);
+		}
+		return LogicalType::STRUCT({{"count", LogicalType::UBIGINT},
+		                            {"empty", LogicalType::UBIGINT},
+		                            {"with_z", LogicalType::UBIGINT},
+		                            {"with_m", LogicalType::UBIGINT},
+		                            {"types", LogicalType::STRUCT(std::move(types))},
+		                            {"extent", GeoTypes::BOX_2D()},
+		                            {"vertices", GetVerticesType()},
+		                            {"sample_size", LogicalType::UBIGINT},
+		                            {"density", LogicalType::LIST(LogicalType::UBIGINT)}});
+	}
+};
+
+//------------------------------------------------------------------------
+// Bind
+//------------------------------------------------------------------------
+static unique_ptr<FunctionData> SummaryBind(ClientContext &context, AggregateFunction &function,
+                                            vector<unique_ptr<Expression>> &arguments) {
+	auto sample_size = SUMMARY_DEFAULT_SAMPLE_SIZE;
+	if (arguments.size() == 2) {
+		if (!arguments[1]->IsFoldable()) {
+			throw InvalidInputException("ST_Summary: sample_size must be constant");
+		}
+		auto sample_size_value = ExpressionExecutor::EvaluateScalar(context, *arguments[1]);
+		if (sample_size_value.IsNull() || sample_size_value.GetValue<int64_t>() < 1) {
+			throw InvalidInputException("ST_Summary: sample_size must be a positive number");
+		}
+		sample_size = sample_size_value.GetValue<idx_t>();
+		// The sample size is constant, so the aggregate itself only sees the geometries
+		Function::EraseArgument(function, arguments, 1);
+	}
+	return make_uniq<SummaryBindData>(sample_size);
+}
+
+//------------------------------------------------------------------------
+// Register
+//------------------------------------------------------------------------
+void CoreAggregateFunctions::RegisterStSummaryAgg(DatabaseInstance &db) {
+	AggregateFunctionSet st_summary("ST_Summary");
+
+	AggregateFunction summary({GeoTypes::GEOMETRY()}, SummaryAggFunction::GetResultType(),
+	                          AggregateFunction::StateSize<SummaryAggState>,
+	                          AggregateFunction::StateInitialize<SummaryAggState, SummaryAggFunction>,
+	                          SummaryAggFunction::Update,
+	                          AggregateFunction::StateCombine<SummaryAggState, SummaryAggFunction>,
+	                          SummaryAggFunction::Finalize, nullptr, SummaryBind, SummaryAggFunction::Destroy);
+	st_summary.AddFunction(summary);
+
+	summary.arguments = {GeoTypes::GEOMETRY(), LogicalType::BIGINT};
+	st_summary.AddFunction(summary);
+
+	ExtensionUtil::RegisterFunction(db, st_summary);
+}
+
+} // namespace core
+
+} // namespace spatial
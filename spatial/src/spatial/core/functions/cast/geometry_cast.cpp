@@ -15,16 +15,35 @@ namespace core {
 // Point2D -> Geometry
 //------------------------------------------------------------------------------
 static bool Point2DToGeometryCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters) {
-	using POINT_TYPE = StructTypeBinary<double, double>;
-	using GEOMETRY_TYPE = PrimitiveType<geometry_t>;
-
-	auto &lstate = GeometryFunctionLocalState::ResetAndGet(parameters);
+	// Points have a fixed serialized layout, so write the blobs straight from the coordinate arrays
+	auto is_constant = source.GetVectorType() == VectorType::CONSTANT_VECTOR;
+	if (is_constant) {
+		count = 1;
+	}
+	source.Flatten(count);
+
+	auto &children = StructVector::GetEntries(source);
+	auto x_data = FlatVector::GetData<double>(*children[0]);
+	auto y_data = FlatVector::GetData<double>(*children[1]);
+	auto &validity = FlatVector::Validity(source);
+	auto result_data = FlatVector::GetData<geometry_t>(result);
+
+	if (validity.AllValid()) {
+		for (idx_t i = 0; i < count; i++) {
+			result_data[i] = GeometryFactory::SerializePoint2D(result, x_data[i], y_data[i]);
+		}
+	} else {
+		FlatVector::Validity(result).Copy(validity, count);
+		for (idx_t i = 0; i < count; i++) {
+			if (validity.RowIsValid(i)) {
+				result_data[i] = GeometryFactory::SerializePoint2D(result, x_data[i], y_data[i]);
+			}
+		}
+	}
 
-	GenericExecutor::ExecuteUnary<POINT_TYPE, GEOMETRY_TYPE>(source, result, count, [&](POINT_TYPE &point) {
-		// Don't bother resetting the allocator, points take up a fixed amount of space anyway
-		Point geom(lstate.factory.allocator, point.a_val, point.b_val);
-		return lstate.factory.Serialize(result, geom, false, false);
-	});
+	if (is_constant) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
 	return true;
 }
 
@@ -32,23 +51,40 @@ static bool Point2DToGeometryCast(Vector &source, Vector &result, idx_t count, C
 // Geometry -> Point2D
 //------------------------------------------------------------------------------
 static bool GeometryToPoint2DCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters) {
-	using POINT_TYPE = StructTypeBinary<double, double>;
-	using GEOMETRY_TYPE = PrimitiveType<geometry_t>;
-
 	auto &lstate = GeometryFunctionLocalState::ResetAndGet(parameters);
 
-	GenericExecutor::ExecuteUnary<GEOMETRY_TYPE, POINT_TYPE>(source, result, count, [&](GEOMETRY_TYPE &geometry) {
-		auto geom = lstate.factory.Deserialize(geometry.val);
-		if (geom.Type() != GeometryType::POINT) {
-			throw ConversionException("Cannot cast non-point GEOMETRY to POINT_2D");
+	auto is_constant = source.GetVectorType() == VectorType::CONSTANT_VECTOR;
+	if (is_constant) {
+		count = 1;
+	}
+
+	UnifiedVectorFormat source_format;
+	source.ToUnifiedFormat(count, source_format);
+	auto source_data = UnifiedVectorFormat::GetData<geometry_t>(source_format);
+
+	// Read the coordinates at their fixed offsets straight into the struct children
+	auto &children = StructVector::GetEntries(result);
+	auto x_data = FlatVector::GetData<double>(*children[0]);
+	auto y_data = FlatVector::GetData<double>(*children[1]);
+
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = source_format.sel->get_index(i);
+		if (!source_format.validity.RowIsValid(idx)) {
+			FlatVector::SetNull(result, i, true);
+			continue;
 		}
-		auto &point = geom.As<Point>();
-		if (point.IsEmpty()) {
+		if (!GeometryFactory::TryGetSerializedPoint(source_data[idx], x_data[i], y_data[i])) {
+			auto geom = lstate.factory.Deserialize(source_data[idx]);
+			if (geom.Type() != GeometryType::POINT) {
+				throw ConversionException("Cannot cast non-point GEOMETRY to POINT_2D");
+			}
 			throw ConversionException("Cannot cast empty point GEOMETRY to POINT_2D");
 		}
-		auto vertex = point.Vertices().Get(0);
-		return POINT_TYPE {vertex.x, vertex.y};
-	});
+	}
+
+	if (is_constant) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
 	return true;
 }
 
@@ -201,6 +237,219 @@ static bool GeometryToPolygon2DCast(Vector &source, Vector &result, idx_t count,
 	return true;
 }
 
+//------------------------------------------------------------------------------
+// Nested list helpers
+//------------------------------------------------------------------------------
+// Append the vertices to the child of a LIST(POINT_2D) vector, returns the list entry of the vertices
+static list_entry_t AppendVertices(Vector &list_vec, const VertexArray &vertices) {
+	auto offset = ListVector::GetListSize(list_vec);
+	auto count = vertices.Count();
+	ListVector::Reserve(list_vec, offset + count);
+
+	auto &coord_vec_children = StructVector::GetEntries(ListVector::GetEntry(list_vec));
+	auto x_data = FlatVector::GetData<double>(*coord_vec_children[0]);
+	auto y_data = FlatVector::GetData<double>(*coord_vec_children[1]);
+	for (idx_t i = 0; i < count; i++) {
+		auto vertex = vertices.Get(i);
+		x_data[offset + i] = vertex.x;
+		y_data[offset + i] = vertex.y;
+	}
+	ListVector::SetListSize(list_vec, offset + count);
+	return list_entry_t(offset, count);
+}
+
+// Append the items to the child of a nested list vector, where APPEND_ITEM appends a single item to the child.
+// Returns the list entry of the items.
+template <class T, class APPEND_ITEM>
+static list_entry_t AppendItems(Vector &list_vec, const T &items, uint32_t count, APPEND_ITEM &&append_item) {
+	auto offset = ListVector::GetListSize(list_vec);
+	ListVector::Reserve(list_vec, offset + count);
+	ListVector::SetListSize(list_vec, offset + count);
+
+	auto &child_vec = ListVector::GetEntry(list_vec);
+	for (idx_t i = 0; i < count; i++) {
+		auto entry = append_item(child_vec, items[i]);
+		ListVector::GetData(child_vec)[offset + i] = entry;
+	}
+	return list_entry_t(offset, count);
+}
+
+static list_entry_t AppendRings(Vector &list_vec, const Polygon &polygon) {
+	return AppendItems(list_vec, polygon, polygon.RingCount(), AppendVertices);
+}
+
+// Build a polygon from an entry of a POLYGON_2D vector
+static Polygon ReadPolygon2D(ArenaAllocator &arena, Vector &polygon_vec, const list_entry_t &poly) {
+	auto &ring_vec = ListVector::GetEntry(polygon_vec);
+	auto ring_entries = ListVector::GetData(ring_vec);
+	auto &coord_vec = ListVector::GetEntry(ring_vec);
+	auto &coord_vec_children = StructVector::GetEntries(coord_vec);
+	auto x_data = FlatVector::GetData<double>(*coord_vec_children[0]);
+	auto y_data = FlatVector::GetData<double>(*coord_vec_children[1]);
+
+	Polygon geom(arena, poly.length, false, false);
+	for (idx_t i = 0; i < poly.length; i++) {
+		auto ring = ring_entries[poly.offset + i];
+		auto &ring_array = geom[i];
+		ring_array.Resize(arena, ring.length);
+		for (idx_t j = 0; j < ring.length; j++) {
+			ring_array.Set(j, x_data[ring.offset + j], y_data[ring.offset + j]);
+		}
+	}
+	return geom;
+}
+
+//------------------------------------------------------------------------------
+// MultiPoint2D -> Geometry
+//------------------------------------------------------------------------------
+static bool MultiPoint2DToGeometryCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters) {
+	auto &lstate = GeometryFunctionLocalState::ResetAndGet(parameters);
+	auto &arena = lstate.factory.allocator;
+
+	auto &coord_vec = ListVector::GetEntry(source);
+	auto &coord_vec_children = StructVector::GetEntries(coord_vec);
+	auto x_data = FlatVector::GetData<double>(*coord_vec_children[0]);
+	auto y_data = FlatVector::GetData<double>(*coord_vec_children[1]);
+
+	UnaryExecutor::Execute<list_entry_t, geometry_t>(source, result, count, [&](list_entry_t &multi) {
+		MultiPoint geom(arena, multi.length, false, false);
+		for (idx_t i = 0; i < multi.length; i++) {
+			geom[i] = Point(arena, x_data[multi.offset + i], y_data[multi.offset + i]);
+		}
+		return lstate.factory.Serialize(result, geom, false, false);
+	});
+	return true;
+}
+
+//------------------------------------------------------------------------------
+// Geometry -> MultiPoint2D
+//------------------------------------------------------------------------------
+// Single geometries are cast to a collection of one item, empty items are skipped
+static bool GeometryToMultiPoint2DCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters) {
+	auto &lstate = GeometryFunctionLocalState::ResetAndGet(parameters);
+
+	UnaryExecutor::Execute<geometry_t, list_entry_t>(source, result, count, [&](geometry_t &geom) {
+		auto geometry = lstate.factory.Deserialize(geom);
+		switch (geometry.Type()) {
+		case GeometryType::POINT:
+			return AppendVertices(result, geometry.As<Point>().Vertices());
+		case GeometryType::MULTIPOINT: {
+			auto offset = ListVector::GetListSize(result);
+			for (auto &point : geometry.As<MultiPoint>()) {
+				AppendVertices(result, point.Vertices());
+			}
+			return list_entry_t(offset, ListVector::GetListSize(result) - offset);
+		}
+		default:
+			throw ConversionException("Cannot cast non-point GEOMETRY to MULTIPOINT_2D");
+		}
+	});
+	return true;
+}
+
+//------------------------------------------------------------------------------
+// MultiLineString2D -> Geometry
+//------------------------------------------------------------------------------
+static bool MultiLineString2DToGeometryCast(Vector &source, Vector &result, idx_t count,
+                                            CastParameters &parameters) {
+	auto &lstate = GeometryFunctionLocalState::ResetAndGet(parameters);
+	auto &arena = lstate.factory.allocator;
+
+	auto &line_vec = ListVector::GetEntry(source);
+	auto line_entries = ListVector::GetData(line_vec);
+	auto &coord_vec = ListVector::GetEntry(line_vec);
+	auto &coord_vec_children = StructVector::GetEntries(coord_vec);
+	auto x_data = FlatVector::GetData<double>(*coord_vec_children[0]);
+	auto y_data = FlatVector::GetData<double>(*coord_vec_children[1]);
+
+	UnaryExecutor::Execute<list_entry_t, geometry_t>(source, result, count, [&](list_entry_t &multi) {
+		MultiLineString geom(arena, multi.length, false, false);
+		for (idx_t i = 0; i < multi.length; i++) {
+			auto line = line_entries[multi.offset + i];
+			geom[i] = LineString(arena, line.length, false, false);
+			auto &vertices = geom[i].Vertices();
+			for (idx_t j = 0; j < line.length; j++) {
+				vertices.Set(j, x_data[line.offset + j], y_data[line.offset + j]);
+			}
+		}
+		return lstate.factory.Serialize(result, geom, false, false);
+	});
+	return true;
+}
+
+//------------------------------------------------------------------------------
+// Geometry -> MultiLineString2D
+//------------------------------------------------------------------------------
+static bool GeometryToMultiLineString2DCast(Vector &source, Vector &result, idx_t count,
+                                            CastParameters &parameters) {
+	auto &lstate = GeometryFunctionLocalState::ResetAndGet(parameters);
+
+	auto append_line = [](Vector &line_vec, const LineString &line) {
+		return AppendVertices(line_vec, line.Vertices());
+	};
+
+	UnaryExecutor::Execute<geometry_t, list_entry_t>(source, result, count, [&](geometry_t &geom) {
+		auto geometry = lstate.factory.Deserialize(geom);
+		switch (geometry.Type()) {
+		case GeometryType::LINESTRING: {
+			auto &line = geometry.As<LineString>();
+			return AppendItems(result, &line, line.IsEmpty() ? 0 : 1, append_line);
+		}
+		case GeometryType::MULTILINESTRING: {
+			auto &multi = geometry.As<MultiLineString>();
+			return AppendItems(result, multi, multi.ItemCount(), append_line);
+		}
+		default:
+			throw ConversionException("Cannot cast non-linestring GEOMETRY to MULTILINESTRING_2D");
+		}
+	});
+	return true;
+}
+
+//------------------------------------------------------------------------------
+// MultiPolygon2D -> Geometry
+//------------------------------------------------------------------------------
+static bool MultiPolygon2DToGeometryCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters) {
+	auto &lstate = GeometryFunctionLocalState::ResetAndGet(parameters);
+	auto &arena = lstate.factory.allocator;
+
+	auto &polygon_vec = ListVector::GetEntry(source);
+	auto polygon_entries = ListVector::GetData(polygon_vec);
+
+	UnaryExecutor::Execute<list_entry_t, geometry_t>(source, result, count, [&](list_entry_t &multi) {
+		MultiPolygon geom(arena, multi.length, false, false);
+		for (idx_t i = 0; i < multi.length; i++) {
+			geom[i] = ReadPolygon2D(arena, polygon_vec, polygon_entries[multi.offset + i]);
+		}
+		return lstate.factory.Serialize(result, geom, false, false);
+	});
+	return true;
+}
+
+//------------------------------------------------------------------------------
+// Geometry -> MultiPolygon2D
+//------------------------------------------------------------------------------
+static bool GeometryToMultiPolygon2DCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters) {
+	auto &lstate = GeometryFunctionLocalState::ResetAndGet(parameters);
+
+	UnaryExecutor::Execute<geometry_t, list_entry_t>(source, result, count, [&](geometry_t &geom) {
+		auto geometry = lstate.factory.Deserialize(geom);
+		switch (geometry.Type()) {
+		case GeometryType::POLYGON: {
+			auto &polygon = geometry.As<Polygon>();
+			return AppendItems(result, &polygon, polygon.IsEmpty() ? 0 : 1, AppendRings);
+		}
+		case GeometryType::MULTIPOLYGON: {
+			auto &multi = geometry.As<MultiPolygon>();
+			return AppendItems(result, multi, multi.ItemCount(), AppendRings);
+		}
+		default:
+			throw ConversionException("Cannot cast non-polygon GEOMETRY to MULTIPOLYGON_2D");
+		}
+	});
+	return true;
+}
+
 //------------------------------------------------------------------------------
 // BOX_2D -> Geometry
 //------------------------------------------------------------------------------
@@ -230,6 +479,45 @@ static bool Box2DToGeometryCast(Vector &source, Vector &result, idx_t count, Cas
 	return true;
 }
 
+//------------------------------------------------------------------------------
+// Geometry -> BOX_2D
+//------------------------------------------------------------------------------
+// Reads the bounding box from the geometry header without deserializing it. Empty geometries have no box.
+static bool GeometryToBox2DCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters) {
+	auto &children = StructVector::GetEntries(result);
+	auto min_x_data = FlatVector::GetData<double>(*children[0]);
+	auto min_y_data = FlatVector::GetData<double>(*children[1]);
+	auto max_x_data = FlatVector::GetData<double>(*children[2]);
+	auto max_y_data = FlatVector::GetData<double>(*children[3]);
+
+	if (source.GetVectorType() == VectorType::CONSTANT_VECTOR) {
+		count = 1;
+	}
+
+	UnifiedVectorFormat source_format;
+	source.ToUnifiedFormat(count, source_format);
+	auto source_data = UnifiedVectorFormat::GetData<geometry_t>(source_format);
+
+	BoundingBox bbox;
+	for (idx_t i = 0; i < count; i++) {
+		auto row_idx = source_format.sel->get_index(i);
+		if (source_format.validity.RowIsValid(row_idx) &&
+		    GeometryFactory::TryGetSerializedBoundingBox(source_data[row_idx], bbox)) {
+			min_x_data[i] = bbox.minx;
+			min_y_data[i] = bbox.miny;
+			max_x_data[i] = bbox.maxx;
+			max_y_data[i] = bbox.maxy;
+		} else {
+			FlatVector::SetNull(result, i, true);
+		}
+	}
+
+	if (source.GetVectorType() == VectorType::CONSTANT_VECTOR) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
+	return true;
+}
+
 //------------------------------------------------------------------------------
 //  Register functions
 //------------------------------------------------------------------------------
@@ -244,9 +532,8 @@ void CoreCastFunctions::RegisterGeometryCasts(DatabaseInstance &db) {
 	ExtensionUtil::RegisterCastFunction(
 	    db, GeoTypes::GEOMETRY(), GeoTypes::POINT_2D(),
 	    BoundCastInfo(GeometryToPoint2DCast, nullptr, GeometryFunctionLocalState::InitCast), 1);
-	ExtensionUtil::RegisterCastFunction(
-	    db, GeoTypes::POINT_2D(), GeoTypes::GEOMETRY(),
-	    BoundCastInfo(Point2DToGeometryCast, nullptr, GeometryFunctionLocalState::InitCast), 1);
+	ExtensionUtil::RegisterCastFunction(db, GeoTypes::POINT_2D(), GeoTypes::GEOMETRY(),
+	                                    BoundCastInfo(Point2DToGeometryCast), 1);
 
 	ExtensionUtil::RegisterCastFunction(
 	    db, GeoTypes::GEOMETRY(), GeoTypes::POLYGON_2D(),
@@ -255,9 +542,32 @@ void CoreCastFunctions::RegisterGeometryCasts(DatabaseInstance &db) {
 	    db, GeoTypes::POLYGON_2D(), GeoTypes::GEOMETRY(),
 	    BoundCastInfo(Polygon2DToGeometryCast, nullptr, GeometryFunctionLocalState::InitCast), 1);
 
+	ExtensionUtil::RegisterCastFunction(
+	    db, GeoTypes::GEOMETRY(), GeoTypes::MULTIPOINT_2D(),
+	    BoundCastInfo(GeometryToMultiPoint2DCast, nullptr, GeometryFunctionLocalState::InitCast), 1);
+	ExtensionUtil::RegisterCastFunction(
+	    db, GeoTypes::MULTIPOINT_2D(), GeoTypes::GEOMETRY(),
+	    BoundCastInfo(MultiPoint2DToGeometryCast, nullptr, GeometryFunctionLocalState::InitCast), 1);
+
+	ExtensionUtil::RegisterCastFunction(
+	    db, GeoTypes::GEOMETRY(), GeoTypes::MULTILINESTRING_2D(),
+	    BoundCastInfo(GeometryToMultiLineString2DCast, nullptr, GeometryFunctionLocalState::InitCast), 1);
+	ExtensionUtil::RegisterCastFunction(
+	    db, GeoTypes::MULTILINESTRING_2D(), GeoTypes::GEOMETRY(),
+	    BoundCastInfo(MultiLineString2DToGeometryCast, nullptr, GeometryFunctionLocalState::InitCast), 1);
+
+	ExtensionUtil::RegisterCastFunction(
+	    db, GeoTypes::GEOMETRY(), GeoTypes::MULTIPOLYGON_2D(),
+	    BoundCastInfo(GeometryToMultiPolygon2DCast, nullptr, GeometryFunctionLocalState::InitCast), 1);
+	ExtensionUtil::RegisterCastFunction(
+	    db, GeoTypes::MULTIPOLYGON_2D(), GeoTypes::GEOMETRY(),
+	    BoundCastInfo(MultiPolygon2DToGeometryCast, nullptr, GeometryFunctionLocalState::InitCast), 1);
+
 	ExtensionUtil::RegisterCastFunction(
 	    db, GeoTypes::BOX_2D(), GeoTypes::GEOMETRY(),
 	    BoundCastInfo(Box2DToGeometryCast, nullptr, GeometryFunctionLocalState::InitCast), 1);
+	ExtensionUtil::RegisterCastFunction(db, GeoTypes::GEOMETRY(), GeoTypes::BOX_2D(),
+	                                    BoundCastInfo(GeometryToBox2DCast));
 }
 
 } // namespace core
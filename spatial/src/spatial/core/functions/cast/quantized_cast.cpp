@@ -0,0 +1,80 @@
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/functions/cast.hpp"
+#include "spatial/core/functions/common.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/quantized_geometry.hpp"
+
+#include "duckdb/function/cast/cast_function_set.hpp"
+#include "duckdb/common/operator/cast_operators.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// GEOMETRY -> GEOMETRY_Q
+//------------------------------------------------------------------------------
+// Casts pick the finest grid that fits each geometry, use ST_Quantize to choose the grid size
+static bool GeometryToQuantizedCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters) {
+	vector<data_t> buffer;
+	bool success = true;
+	UnaryExecutor::ExecuteWithNulls<geometry_t, string_t>(
+	    source, result, count, [&](geometry_t input, ValidityMask &mask, idx_t idx) {
+		    try {
+			    QuantizedGeometry::Quantize(input, 0, buffer);
+			    return StringVector::AddStringOrBlob(result, const_char_ptr_cast(buffer.data()), buffer.size());
+		    } catch (InvalidInputException &e) {
+			    if (success) {
+				    success = false;
+				    ErrorData error(e);
+				    HandleCastError::AssignError(error.RawMessage(), parameters.error_message);
+			    }
+			    mask.SetInvalid(idx);
+			    return string_t {};
+		    }
+	    });
+	return success;
+}
+
+//------------------------------------------------------------------------------
+// GEOMETRY_Q -> GEOMETRY
+//------------------------------------------------------------------------------
+static bool QuantizedToGeometryCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters) {
+	auto &lstate = GeometryFunctionLocalState::ResetAndGet(parameters);
+	UnaryExecutor::Execute<string_t, geometry_t>(source, result, count, [&](string_t input) {
+		auto geom = QuantizedGeometry::Dequantize(lstate.factory.allocator, input);
+		return lstate.factory.Serialize(result, geom, false, false);
+	});
+	return true;
+}
+
+//------------------------------------------------------------------------------
+// GEOMETRY_Q -> VARCHAR
+//------------------------------------------------------------------------------
+static bool QuantizedToVarcharCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters) {
+	Vector geometries(GeoTypes::GEOMETRY(), count);
+	QuantizedToGeometryCast(source, geometries, count, parameters);
+	CoreVectorOperations::GeometryToVarchar(geometries, result, count, Utils::MAX_COORD_PRECISION);
+	return true;
+}
+
+//------------------------------------------------------------------------------
+//  Register functions
+//------------------------------------------------------------------------------
+void CoreCastFunctions::RegisterQuantizedCasts(DatabaseInstance &db) {
+	// Quantizing loses precision, so only an explicit cast does it. The other way is lossless and implicit, so that
+	// every GEOMETRY function accepts GEOMETRY_Q as well.
+	ExtensionUtil::RegisterCastFunction(db, GeoTypes::GEOMETRY(), GeoTypes::GEOMETRY_Q(),
+	                                    BoundCastInfo(GeometryToQuantizedCast));
+	ExtensionUtil::RegisterCastFunction(
+	    db, GeoTypes::GEOMETRY_Q(), GeoTypes::GEOMETRY(),
+	    BoundCastInfo(QuantizedToGeometryCast, nullptr, GeometryFunctionLocalState::InitCast), 1);
+	ExtensionUtil::RegisterCastFunction(
+	    db, GeoTypes::GEOMETRY_Q(), LogicalType::VARCHAR,
+	    BoundCastInfo(QuantizedToVarcharCast, nullptr, GeometryFunctionLocalState::InitCast), 1);
+}
+
+} // namespace core
+
+} // namespace spatial
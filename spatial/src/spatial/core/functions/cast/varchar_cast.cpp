@@ -17,10 +17,12 @@ namespace core {
 //------------------------------------------------------------------------------
 // POINT_2D -> VARCHAR
 //------------------------------------------------------------------------------
-void CoreVectorOperations::Point2DToVarchar(Vector &source, Vector &result, idx_t count) {
+void CoreVectorOperations::Point2DToVarchar(Vector &source, Vector &result, idx_t count, uint32_t precision) {
 	using POINT_TYPE = StructTypeBinary<double, double>;
 	using VARCHAR_TYPE = PrimitiveType<string_t>;
 
+	// Reused between rows
+	string result_str;
 	GenericExecutor::ExecuteUnary<POINT_TYPE, VARCHAR_TYPE>(source, result, count, [&](POINT_TYPE &point) {
 		auto x = point.a_val;
 		auto y = point.b_val;
@@ -29,19 +31,26 @@ void CoreVectorOperations::Point2DToVarchar(Vector &source, Vector &result, idx_
 			return StringVector::AddString(result, "POINT EMPTY");
 		}
 
-		return StringVector::AddString(result, StringUtil::Format("POINT (%s)", Utils::format_coord(x, y)));
+		result_str = "POINT (";
+		Utils::append_coord(result_str, x, precision);
+		result_str += ' ';
+		Utils::append_coord(result_str, y, precision);
+		result_str += ')';
+		return StringVector::AddString(result, result_str.data(), result_str.size());
 	});
 }
 
 //------------------------------------------------------------------------------
 // LINESTRING_2D -> VARCHAR
 //------------------------------------------------------------------------------
-void CoreVectorOperations::LineString2DToVarchar(Vector &source, Vector &result, idx_t count) {
+void CoreVectorOperations::LineString2DToVarchar(Vector &source, Vector &result, idx_t count, uint32_t precision) {
 	auto &inner = ListVector::GetEntry(source);
 	auto &children = StructVector::GetEntries(inner);
 	auto x_data = FlatVector::GetData<double>(*children[0]);
 	auto y_data = FlatVector::GetData<double>(*children[1]);
 
+	// Reused between rows
+	string result_str;
 	UnaryExecutor::Execute<list_entry_t, string_t>(source, result, count, [&](list_entry_t &line) {
 		auto offset = line.offset;
 		auto length = line.length;
@@ -50,22 +59,24 @@ void CoreVectorOperations::LineString2DToVarchar(Vector &source, Vector &result,
 			return StringVector::AddString(result, "LINESTRING EMPTY");
 		}
 
-		string result_str = "LINESTRING (";
+		result_str = "LINESTRING (";
 		for (idx_t i = offset; i < offset + length; i++) {
-			result_str += Utils::format_coord(x_data[i], y_data[i]);
+			Utils::append_coord(result_str, x_data[i], precision);
+			result_str += ' ';
+			Utils::append_coord(result_str, y_data[i], precision);
 			if (i < offset + length - 1) {
 				result_str += ", ";
 			}
 		}
 		result_str += ")";
-		return StringVector::AddString(result, result_str);
+		return StringVector::AddString(result, result_str.data(), result_str.size());
 	});
 }
 
 //------------------------------------------------------------------------------
 // POLYGON_2D -> VARCHAR
 //------------------------------------------------------------------------------
-void CoreVectorOperations::Polygon2DToVarchar(Vector &source, Vector &result, idx_t count) {
+void CoreVectorOperations::Polygon2DToVarchar(Vector &source, Vector &result, idx_t count, uint32_t precision) {
 	auto &poly_vector = source;
 	auto &ring_vector = ListVector::GetEntry(poly_vector);
 	auto ring_entries = ListVector::GetData(ring_vector);
@@ -74,6 +85,8 @@ void CoreVectorOperations::Polygon2DToVarchar(Vector &source, Vector &result, id
 	auto x_data = FlatVector::GetData<double>(*point_children[0]);
 	auto y_data = FlatVector::GetData<double>(*point_children[1]);
 
+	// Reused between rows
+	string result_str;
 	UnaryExecutor::Execute<list_entry_t, string_t>(poly_vector, result, count, [&](list_entry_t polygon_entry) {
 		auto offset = polygon_entry.offset;
 		auto length = polygon_entry.length;
@@ -82,14 +95,16 @@ void CoreVectorOperations::Polygon2DToVarchar(Vector &source, Vector &result, id
 			return StringVector::AddString(result, "POLYGON EMPTY");
 		}
 
-		string result_str = "POLYGON (";
+		result_str = "POLYGON (";
 		for (idx_t i = offset; i < offset + length; i++) {
 			auto ring_entry = ring_entries[i];
 			auto ring_offset = ring_entry.offset;
 			auto ring_length = ring_entry.length;
 			result_str += "(";
 			for (idx_t j = ring_offset; j < ring_offset + ring_length; j++) {
-				result_str += Utils::format_coord(x_data[j], y_data[j]);
+				Utils::append_coord(result_str, x_data[j], precision);
+				result_str += ' ';
+				Utils::append_coord(result_str, y_data[j], precision);
 				if (j < ring_offset + ring_length - 1) {
 					result_str += ", ";
 				}
@@ -100,20 +115,30 @@ void CoreVectorOperations::Polygon2DToVarchar(Vector &source, Vector &result, id
 			}
 		}
 		result_str += ")";
-		return StringVector::AddString(result, result_str);
+		return StringVector::AddString(result, result_str.data(), result_str.size());
 	});
 }
 
 //------------------------------------------------------------------------------
 // BOX_2D -> VARCHAR
 //------------------------------------------------------------------------------
-void CoreVectorOperations::Box2DToVarchar(Vector &source, Vector &result, idx_t count) {
+void CoreVectorOperations::Box2DToVarchar(Vector &source, Vector &result, idx_t count, uint32_t precision) {
 	using BOX_TYPE = StructTypeQuaternary<double, double, double, double>;
 	using VARCHAR_TYPE = PrimitiveType<string_t>;
+
+	// Reused between rows
+	string result_str;
 	GenericExecutor::ExecuteUnary<BOX_TYPE, VARCHAR_TYPE>(source, result, count, [&](BOX_TYPE &box) {
-		return StringVector::AddString(result,
-		                               StringUtil::Format("BOX(%s, %s)", Utils::format_coord(box.a_val, box.b_val),
-		                                                  Utils::format_coord(box.c_val, box.d_val)));
+		result_str = "BOX(";
+		Utils::append_coord(result_str, box.a_val, precision);
+		result_str += ' ';
+		Utils::append_coord(result_str, box.b_val, precision);
+		result_str += ", ";
+		Utils::append_coord(result_str, box.c_val, precision);
+		result_str += ' ';
+		Utils::append_coord(result_str, box.d_val, precision);
+		result_str += ')';
+		return StringVector::AddString(result, result_str.data(), result_str.size());
 	});
 }
 
@@ -123,53 +148,40 @@ void CoreVectorOperations::Box2DToVarchar(Vector &source, Vector &result, idx_t
 class GeometryTextProcessor final : GeometryProcessor<void, bool> {
 private:
 	string text;
+	uint32_t precision;
 
 public:
+	explicit GeometryTextProcessor(uint32_t precision) : precision(precision) {
+	}
+
 	void OnVertexData(const VertexData &data) {
 		auto &dims = data.data;
 		auto &strides = data.stride;
 		auto count = data.count;
 
-		if (HasZ() && HasM()) {
-			for (uint32_t i = 0; i < count; i++) {
-				auto x = Load<double>(dims[0] + i * strides[0]);
-				auto y = Load<double>(dims[1] + i * strides[1]);
-				auto z = Load<double>(dims[2] + i * strides[2]);
-				auto m = Load<double>(dims[3] + i * strides[3]);
-				text += Utils::format_coord(x, y, z, m);
-				if (i < count - 1) {
-					text += ", ";
-				}
-			}
-		} else if (HasZ()) {
-			for (uint32_t i = 0; i < count; i++) {
-				auto x = Load<double>(dims[0] + i * strides[0]);
-				auto y = Load<double>(dims[1] + i * strides[1]);
-				auto zm = Load<double>(dims[2] + i * strides[2]);
-				text += Utils::format_coord(x, y, zm);
-				if (i < count - 1) {
-					text += ", ";
-				}
-			}
-		} else if (HasM()) {
-			for (uint32_t i = 0; i < count; i++) {
-				auto x = Load<double>(dims[0] + i * strides[0]);
-				auto y = Load<double>(dims[1] + i * strides[1]);
-				auto m = Load<double>(dims[3] + i * strides[3]);
-				text += Utils::format_coord(x, y, m);
-				if (i < count - 1) {
-					text += ", ";
-				}
-			}
-		} else {
-			for (uint32_t i = 0; i < count; i++) {
-				auto x = Load<double>(dims[0] + i * strides[0]);
-				auto y = Load<double>(dims[1] + i * strides[1]);
-				text += Utils::format_coord(x, y);
+		// The dimensions to write, in order
+		uint32_t dim_count = 0;
+		uint32_t dim_idx[4];
+		dim_idx[dim_count++] = 0;
+		dim_idx[dim_count++] = 1;
+		if (HasZ()) {
+			dim_idx[dim_count++] = 2;
+		}
+		if (HasM()) {
+			dim_idx[dim_count++] = 3;
+		}
 
-				if (i < count - 1) {
-					text += ", ";
+		// Format the coordinates in place, instead of creating a string per vertex
+		for (uint32_t i = 0; i < count; i++) {
+			if (i > 0) {
+				text += ", ";
+			}
+			for (uint32_t j = 0; j < dim_count; j++) {
+				if (j > 0) {
+					text += ' ';
 				}
+				auto d = dim_idx[j];
+				Utils::append_coord(text, Load<double>(dims[d] + i * strides[d]), precision);
 			}
 		}
 	}
@@ -306,11 +318,11 @@ public:
 	}
 };
 
-void CoreVectorOperations::GeometryToVarchar(Vector &source, Vector &result, idx_t count) {
-	GeometryTextProcessor processor;
+void CoreVectorOperations::GeometryToVarchar(Vector &source, Vector &result, idx_t count, uint32_t precision) {
+	GeometryTextProcessor processor(precision);
 	UnaryExecutor::Execute<geometry_t, string_t>(source, result, count, [&](geometry_t &input) {
-		auto text = processor.Execute(input);
-		return StringVector::AddString(result, text);
+		auto &text = processor.Execute(input);
+		return StringVector::AddString(result, text.data(), text.size());
 	});
 }
 
@@ -341,27 +353,27 @@ static bool TextToGeometryCast(Vector &source, Vector &result, idx_t count, Cast
 // CASTS
 //------------------------------------------------------------------------------
 static bool Point2DToVarcharCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters) {
-	CoreVectorOperations::Point2DToVarchar(source, result, count);
+	CoreVectorOperations::Point2DToVarchar(source, result, count, Utils::MAX_COORD_PRECISION);
 	return true;
 }
 
 static bool LineString2DToVarcharCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters) {
-	CoreVectorOperations::LineString2DToVarchar(source, result, count);
+	CoreVectorOperations::LineString2DToVarchar(source, result, count, Utils::MAX_COORD_PRECISION);
 	return true;
 }
 
 static bool Polygon2DToVarcharCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters) {
-	CoreVectorOperations::Polygon2DToVarchar(source, result, count);
+	CoreVectorOperations::Polygon2DToVarchar(source, result, count, Utils::MAX_COORD_PRECISION);
 	return true;
 }
 
 static bool Box2DToVarcharCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters) {
-	CoreVectorOperations::Box2DToVarchar(source, result, count);
+	CoreVectorOperations::Box2DToVarchar(source, result, count, Utils::MAX_COORD_PRECISION);
 	return true;
 }
 
 static bool GeometryToVarcharCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters) {
-	CoreVectorOperations::GeometryToVarchar(source, result, count);
+	CoreVectorOperations::GeometryToVarchar(source, result, count, Utils::MAX_COORD_PRECISION);
 	return true;
 }
 
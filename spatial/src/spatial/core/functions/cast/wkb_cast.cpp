@@ -24,8 +24,7 @@ static bool WKBToGeometryCast(Vector &source, Vector &result, idx_t count, CastP
 	UnaryExecutor::ExecuteWithNulls<string_t, geometry_t>(
 	    source, result, count, [&](string_t input, ValidityMask &mask, idx_t idx) {
 		    try {
-			    auto geometry = reader.Deserialize(input);
-			    return lstate.factory.Serialize(result, geometry, reader.GeomHasZ(), reader.GeomHasM());
+			    return reader.Transcode(result, input, lstate.factory.double_bbox);
 		    } catch (SerializationException &e) {
 			    if (success) {
 				    success = false;
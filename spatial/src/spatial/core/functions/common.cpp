@@ -1,12 +1,184 @@
 #include "spatial/common.hpp"
 #include "spatial/core/functions/common.hpp"
 
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/main/config.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+
 namespace spatial {
 
 namespace core {
 
+//------------------------------------------------------------------------------
+// Geometry Arena
+//------------------------------------------------------------------------------
+static atomic<idx_t> arena_held_bytes(0);
+static atomic<idx_t> arena_peak_bytes(0);
+static atomic<idx_t> arena_trim_count(0);
+
+static void TrackArenaGrowth(idx_t old_size, idx_t new_size) {
+	auto held = arena_held_bytes.fetch_add(new_size - old_size) + (new_size - old_size);
+	auto peak = arena_peak_bytes.load();
+	while (held > peak && !arena_peak_bytes.compare_exchange_weak(peak, held)) {
+	}
+}
+
+idx_t GeometryArena::GetSoftLimit(ClientContext &context) {
+	Value soft_limit;
+	if (context.TryGetCurrentSetting("spatial_arena_soft_limit", soft_limit) && !soft_limit.IsNull()) {
+		return DBConfig::ParseMemoryLimit(soft_limit.ToString());
+	}
+	return DConstants::INVALID_INDEX;
+}
+
+void GeometryArena::Reset(ArenaAllocator &arena, idx_t soft_limit, idx_t &tracked_size) {
+	auto size = arena.SizeInBytes();
+	TrackArenaGrowth(tracked_size, size);
+
+	if (size > soft_limit) {
+		arena.Destroy();
+		arena_trim_count++;
+	} else {
+		arena.Reset();
+	}
+
+	auto new_size = arena.SizeInBytes();
+	arena_held_bytes -= size - new_size;
+	tracked_size = new_size;
+}
+
+void GeometryArena::Release(ArenaAllocator &arena, idx_t &tracked_size) {
+	TrackArenaGrowth(tracked_size, arena.SizeInBytes());
+	arena_held_bytes -= arena.SizeInBytes();
+	tracked_size = 0;
+}
+
+void GeometryArena::FetchMetrics(idx_t &held_bytes, idx_t &peak_bytes, idx_t &trim_count) {
+	held_bytes = arena_held_bytes.load();
+	// The peak starts over from what is held right now
+	peak_bytes = arena_peak_bytes.exchange(held_bytes);
+	trim_count = arena_trim_count.exchange(0);
+}
+
+void GeometryArena::FetchMemory(idx_t &held_bytes, idx_t &peak_bytes) {
+	held_bytes = arena_held_bytes.load();
+	peak_bytes = arena_peak_bytes.exchange(held_bytes);
+}
+
+//------------------------------------------------------------------------------
+// Aggregate State Memory
+//------------------------------------------------------------------------------
+static atomic<idx_t> aggregate_held_bytes(0);
+static atomic<idx_t> aggregate_peak_bytes(0);
+
+AggregateMemoryBindData::AggregateMemoryBindData(string function_name_p, ClientContext &context)
+    : function_name(std::move(function_name_p)), context(context),
+      buffer_manager(BufferManager::GetBufferManager(context)), allocator(BufferAllocator::Get(context)) {
+}
+
+void AggregateMemoryBindData::Update(idx_t &tracked_size, idx_t new_size) const {
+	if (new_size <= tracked_size) {
+		aggregate_held_bytes -= tracked_size - new_size;
+		tracked_size = new_size;
+		return;
+	}
+	auto growth = new_size - tracked_size;
+	tracked_size = new_size;
+	auto held = aggregate_held_bytes.fetch_add(growth) + growth;
+	auto peak = aggregate_peak_bytes.load();
+	while (held > peak && !aggregate_peak_bytes.compare_exchange_weak(peak, held)) {
+	}
+
+	auto used = buffer_manager.GetUsedMemory();
+	auto limit = buffer_manager.GetMaxMemory();
+	if (held + used > limit) {
+		throw OutOfMemoryException("%s: the aggregate states hold an estimated %s of geometries outside of the buffer "
+		                           "manager, which together with the %s used by the buffer manager exceeds the memory "
+		                           "limit of %s",
+		                           function_name, StringUtil::BytesToHumanReadableString(held),
+		                           StringUtil::BytesToHumanReadableString(used),
+		                           StringUtil::BytesToHumanReadableString(limit));
+	}
+}
+
+unique_ptr<FunctionData> AggregateMemoryBindData::Copy() const {
+	return make_uniq<AggregateMemoryBindData>(function_name, context);
+}
+
+bool AggregateMemoryBindData::Equals(const FunctionData &other_p) const {
+	auto &other = other_p.Cast<AggregateMemoryBindData>();
+	return function_name == other.function_name && &context == &other.context;
+}
+
+unique_ptr<FunctionData> AggregateMemoryBindData::Bind(ClientContext &context, AggregateFunction &function,
+                                                       vector<unique_ptr<Expression>> &arguments) {
+	return make_uniq<AggregateMemoryBindData>(function.name, context);
+}
+
+void AggregateMemoryBindData::FetchMemory(idx_t &held_bytes, idx_t &peak_bytes) {
+	held_bytes = aggregate_held_bytes.load();
+	peak_bytes = aggregate_peak_bytes.exchange(held_bytes);
+}
+
+//------------------------------------------------------------------------------
+// Coordinate Precision
+//------------------------------------------------------------------------------
+unique_ptr<FunctionData> CoordinatePrecisionBindData::Copy() const {
+	return make_uniq<CoordinatePrecisionBindData>(precision);
+}
+
+bool CoordinatePrecisionBindData::Equals(const FunctionData &other_p) const {
+	return precision == other_p.Cast<CoordinatePrecisionBindData>().precision;
+}
+
+unique_ptr<FunctionData> CoordinatePrecisionBindData::Bind(ClientContext &context, ScalarFunction &bound_function,
+                                                           vector<unique_ptr<Expression>> &arguments) {
+	if (arguments.size() < 2) {
+		return make_uniq<CoordinatePrecisionBindData>(Utils::MAX_COORD_PRECISION);
+	}
+	auto &arg = arguments.back();
+	if (arg->HasParameter() || !arg->IsFoldable()) {
+		throw InvalidInputException("%s: the precision must be a constant", bound_function.name);
+	}
+	auto value = ExpressionExecutor::EvaluateScalar(context, *arg);
+	if (value.IsNull() || IntegerValue::Get(value) < 0 ||
+	    IntegerValue::Get(value) > static_cast<int32_t>(Utils::MAX_COORD_PRECISION)) {
+		throw InvalidInputException("%s: the precision must be between 0 and %d", bound_function.name,
+		                            Utils::MAX_COORD_PRECISION);
+	}
+	return make_uniq<CoordinatePrecisionBindData>(static_cast<uint32_t>(IntegerValue::Get(value)));
+}
+
+uint32_t CoordinatePrecisionBindData::Get(ExpressionState &state) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	if (!func_expr.bind_info) {
+		return Utils::MAX_COORD_PRECISION;
+	}
+	return func_expr.bind_info->Cast<CoordinatePrecisionBindData>().precision;
+}
+
+//------------------------------------------------------------------------------
+// Geometry Function Local State
+//------------------------------------------------------------------------------
 GeometryFunctionLocalState::GeometryFunctionLocalState(ClientContext &context)
-    : factory(BufferAllocator::Get(context)) {
+    : factory(BufferAllocator::Get(context)), arena_soft_limit(GeometryArena::GetSoftLimit(context)) {
+	factory.double_bbox = GetDoubleBBox(context);
+	factory.counters.Init(context);
+}
+
+bool GeometryFunctionLocalState::GetDoubleBBox(ClientContext &context) {
+	Value double_bbox;
+	if (context.TryGetCurrentSetting("spatial_double_precision_bbox", double_bbox)) {
+		return double_bbox.GetValue<bool>();
+	}
+	return false;
+}
+
+GeometryFunctionLocalState::~GeometryFunctionLocalState() {
+	factory.counters.Flush();
+	GeometryArena::Release(factory.allocator, arena_size);
 }
 
 unique_ptr<FunctionLocalState>
@@ -20,13 +192,13 @@ unique_ptr<FunctionLocalState> GeometryFunctionLocalState::InitCast(CastLocalSta
 
 GeometryFunctionLocalState &GeometryFunctionLocalState::ResetAndGet(CastParameters &parameters) {
 	auto &local_state = (GeometryFunctionLocalState &)*parameters.local_state;
-	local_state.factory.allocator.Reset();
+	GeometryArena::Reset(local_state.factory.allocator, local_state.arena_soft_limit, local_state.arena_size);
 	return local_state;
 }
 
 GeometryFunctionLocalState &GeometryFunctionLocalState::ResetAndGet(ExpressionState &state) {
 	auto &local_state = (GeometryFunctionLocalState &)*ExecuteFunctionState::GetFunctionState(state);
-	local_state.factory.allocator.Reset();
+	GeometryArena::Reset(local_state.factory.allocator, local_state.arena_soft_limit, local_state.arena_size);
 	return local_state;
 }
 
@@ -6,6 +6,7 @@
 #include "spatial/core/geometry/geometry.hpp"
 #include "spatial/core/types.hpp"
 #include "spatial/core/geometry/geometry_processor.hpp"
+#include "spatial/core/geometry/vertex_measure.hpp"
 
 namespace spatial {
 
@@ -19,6 +20,11 @@ static void PolygonAreaFunction(DataChunk &args, ExpressionState &state, Vector
 
 	auto &input = args.data[0];
 	auto count = args.size();
+	auto is_constant = input.GetVectorType() == VectorType::CONSTANT_VECTOR;
+	if (is_constant) {
+		count = 1;
+	}
+	input.Flatten(count);
 
 	auto &ring_vec = ListVector::GetEntry(input);
 	auto ring_entries = ListVector::GetData(ring_vec);
@@ -27,35 +33,69 @@ static void PolygonAreaFunction(DataChunk &args, ExpressionState &state, Vector
 	auto x_data = FlatVector::GetData<double>(*coord_vec_children[0]);
 	auto y_data = FlatVector::GetData<double>(*coord_vec_children[1]);
 
-	UnaryExecutor::Execute<list_entry_t, double>(input, result, count, [&](list_entry_t polygon) {
-		auto polygon_offset = polygon.offset;
-		auto polygon_length = polygon.length;
+	// Compute the shoelace terms of all the child coordinates in one pass, then sum the terms of each ring
+	auto vertex_count = ListVector::GetListSize(ring_vec);
+	auto terms = make_unsafe_uniq_array<double>(vertex_count);
+	VertexMeasure::ShoelaceTerms(x_data, y_data, vertex_count, terms.get());
 
-		bool first = true;
+	UnaryExecutor::Execute<list_entry_t, double>(input, result, count, [&](list_entry_t polygon) {
 		double area = 0;
-		for (idx_t ring_idx = polygon_offset; ring_idx < polygon_offset + polygon_length; ring_idx++) {
+		for (idx_t ring_idx = polygon.offset; ring_idx < polygon.offset + polygon.length; ring_idx++) {
 			auto ring = ring_entries[ring_idx];
-			auto ring_offset = ring.offset;
-			auto ring_length = ring.length;
+			auto sum = std::abs(VertexMeasure::SumSegments(terms.get(), ring.offset, ring.length)) * 0.5;
+			// Add the outer ring, subtract the holes
+			area += ring_idx == polygon.offset ? sum : -sum;
+		}
+		return area;
+	});
 
-			double sum = 0;
-			for (idx_t coord_idx = ring_offset; coord_idx < ring_offset + ring_length - 1; coord_idx++) {
-				sum += (x_data[coord_idx] * y_data[coord_idx + 1]) - (x_data[coord_idx + 1] * y_data[coord_idx]);
-			}
-			sum = std::abs(sum);
-			if (first) {
-				// Add outer ring
-				area = sum * 0.5;
-				first = false;
-			} else {
-				// Subtract holes
-				area -= sum * 0.5;
+	if (is_constant) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
+}
+
+//------------------------------------------------------------------------------
+// MULTIPOLYGON_2D
+//------------------------------------------------------------------------------
+static void MultiPolygonAreaFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	D_ASSERT(args.data.size() == 1);
+
+	auto &input = args.data[0];
+	auto count = args.size();
+	auto is_constant = input.GetVectorType() == VectorType::CONSTANT_VECTOR;
+	if (is_constant) {
+		count = 1;
+	}
+	input.Flatten(count);
+
+	auto &polygon_vec = ListVector::GetEntry(input);
+	auto polygon_entries = ListVector::GetData(polygon_vec);
+	auto &ring_vec = ListVector::GetEntry(polygon_vec);
+	auto ring_entries = ListVector::GetData(ring_vec);
+	auto &coord_vec = ListVector::GetEntry(ring_vec);
+	auto &coord_vec_children = StructVector::GetEntries(coord_vec);
+	auto x_data = FlatVector::GetData<double>(*coord_vec_children[0]);
+	auto y_data = FlatVector::GetData<double>(*coord_vec_children[1]);
+
+	auto vertex_count = ListVector::GetListSize(ring_vec);
+	auto terms = make_unsafe_uniq_array<double>(vertex_count);
+	VertexMeasure::ShoelaceTerms(x_data, y_data, vertex_count, terms.get());
+
+	UnaryExecutor::Execute<list_entry_t, double>(input, result, count, [&](list_entry_t multi) {
+		double area = 0;
+		for (idx_t polygon_idx = multi.offset; polygon_idx < multi.offset + multi.length; polygon_idx++) {
+			auto polygon = polygon_entries[polygon_idx];
+			for (idx_t ring_idx = polygon.offset; ring_idx < polygon.offset + polygon.length; ring_idx++) {
+				auto ring = ring_entries[ring_idx];
+				auto sum = std::abs(VertexMeasure::SumSegments(terms.get(), ring.offset, ring.length)) * 0.5;
+				// Add the outer ring, subtract the holes
+				area += ring_idx == polygon.offset ? sum : -sum;
 			}
 		}
 		return area;
 	});
 
-	if (count == 1) {
+	if (is_constant) {
 		result.SetVectorType(VectorType::CONSTANT_VECTOR);
 	}
 }
@@ -99,30 +139,15 @@ static void BoxAreaFunction(DataChunk &args, ExpressionState &state, Vector &res
 // GEOMETRY
 //------------------------------------------------------------------------------
 class AreaProcessor final : GeometryProcessor<double> {
-	static double ProcessVertices(const VertexData &vertices) {
-		if (vertices.count < 3) {
-			return 0.0;
-		}
-
-		const auto count = vertices.count;
-		const auto x_data = vertices.data[0];
-		const auto y_data = vertices.data[1];
-		const auto x_stride = vertices.stride[0];
-		const auto y_stride = vertices.stride[1];
-
-		double signed_area = 0.0;
-
-		auto x0 = Load<double>(x_data);
-
-		for (uint32_t i = 1; i < count - 1; ++i) {
-			auto x1 = Load<double>(x_data + i * x_stride);
-			auto y1 = Load<double>(y_data + (i + 1) * y_stride);
-			auto y2 = Load<double>(y_data + (i - 1) * y_stride);
-			signed_area += (x1 - x0) * (y2 - y1);
+	struct ShoelaceOp {
+		template <class V>
+		static double Operation(const VertexData &vertices) {
+			return VertexMeasure::ShoelaceSum<V>(vertices.data[0], vertices.count);
 		}
+	};
 
-		signed_area *= 0.5;
-
+	double ProcessVertices(const VertexData &vertices) const {
+		auto signed_area = DispatchVertexType<ShoelaceOp>(HasZ(), HasM(), vertices) * 0.5;
 		return std::abs(signed_area);
 	}
 
@@ -170,8 +195,8 @@ static void GeometryAreaFunction(DataChunk &args, ExpressionState &state, Vector
 	auto &input = args.data[0];
 	auto count = args.size();
 	AreaProcessor processor;
-	UnaryExecutor::Execute<geometry_t, double>(input, result, count,
-	                                           [&](const geometry_t &input) { return processor.Execute(input); });
+	GeometryExecutor::ExecuteUnary<geometry_t, double>(input, result, count,
+	                                                   [&](const geometry_t &input) { return processor.Execute(input); });
 }
 
 //------------------------------------------------------------------------------
@@ -183,6 +208,7 @@ void CoreScalarFunctions::RegisterStArea(DatabaseInstance &db) {
 	set.AddFunction(ScalarFunction({GeoTypes::POINT_2D()}, LogicalType::DOUBLE, PointAreaFunction));
 	set.AddFunction(ScalarFunction({GeoTypes::LINESTRING_2D()}, LogicalType::DOUBLE, LineStringAreaFunction));
 	set.AddFunction(ScalarFunction({GeoTypes::POLYGON_2D()}, LogicalType::DOUBLE, PolygonAreaFunction));
+	set.AddFunction(ScalarFunction({GeoTypes::MULTIPOLYGON_2D()}, LogicalType::DOUBLE, MultiPolygonAreaFunction));
 	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY()}, LogicalType::DOUBLE, GeometryAreaFunction));
 	set.AddFunction(ScalarFunction({GeoTypes::BOX_2D()}, LogicalType::DOUBLE, BoxAreaFunction));
 
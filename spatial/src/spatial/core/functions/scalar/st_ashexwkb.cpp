@@ -1,7 +1,6 @@
 #include "duckdb/common/vector_operations/generic_executor.hpp"
 #include "duckdb/common/vector_operations/unary_executor.hpp"
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
-#include "duckdb/common/types/blob.hpp"
 
 #include "spatial/common.hpp"
 #include "spatial/core/functions/scalar.hpp"
@@ -23,26 +22,8 @@ void GeometryAsHEXWKBFunction(DataChunk &args, ExpressionState &state, Vector &r
 	auto &input = args.data[0];
 	auto count = args.size();
 
-	vector<data_t> buffer;
-	UnaryExecutor::Execute<geometry_t, string_t>(input, result, count, [&](geometry_t input) {
-		buffer.clear();
-		WKBWriter::Write(input, buffer);
-
-		auto blob_size = buffer.size() * 2; // every byte is rendered as two characters
-		auto blob_str = StringVector::EmptyString(result, blob_size);
-		auto blob_ptr = blob_str.GetDataWriteable();
-
-		idx_t str_idx = 0;
-		for (auto byte : buffer) {
-			auto byte_a = byte >> 4;
-			auto byte_b = byte & 0x0F;
-			blob_ptr[str_idx++] = Blob::HEX_TABLE[byte_a];
-			blob_ptr[str_idx++] = Blob::HEX_TABLE[byte_b];
-		}
-
-		blob_str.Finalize();
-		return blob_str;
-	});
+	UnaryExecutor::Execute<geometry_t, string_t>(
+	    input, result, count, [&](geometry_t input) { return WKBWriter::WriteHex(input, result); });
 }
 
 //------------------------------------------------------------------------------
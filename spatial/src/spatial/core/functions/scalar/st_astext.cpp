@@ -2,6 +2,7 @@
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
 #include "spatial/common.hpp"
 #include "spatial/core/functions/scalar.hpp"
+#include "spatial/core/functions/common.hpp"
 #include "spatial/core/types.hpp"
 
 #include "spatial/core/functions/cast.hpp"
@@ -15,54 +16,52 @@ namespace core {
 //------------------------------------------------------------------------------
 
 static void Point2DAsTextFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	D_ASSERT(args.data.size() == 1);
+	D_ASSERT(args.data.size() == 1 || args.data.size() == 2);
 	auto &input = args.data[0];
 	auto count = args.size();
-	CoreVectorOperations::Point2DToVarchar(input, result, count);
+	CoreVectorOperations::Point2DToVarchar(input, result, count, CoordinatePrecisionBindData::Get(state));
 }
 
 //------------------------------------------------------------------------------
 // LINESTRING_2D
 //------------------------------------------------------------------------------
 
-// TODO: We want to format these to trim trailing zeros
 static void LineString2DAsTextFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	D_ASSERT(args.data.size() == 1);
+	D_ASSERT(args.data.size() == 1 || args.data.size() == 2);
 	auto &input = args.data[0];
 	auto count = args.size();
-	CoreVectorOperations::LineString2DToVarchar(input, result, count);
+	CoreVectorOperations::LineString2DToVarchar(input, result, count, CoordinatePrecisionBindData::Get(state));
 }
 
 //------------------------------------------------------------------------------
 // POLYGON_2D
 //------------------------------------------------------------------------------
 
-// TODO: We want to format these to trim trailing zeros
 static void Polygon2DAsTextFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	D_ASSERT(args.data.size() == 1);
+	D_ASSERT(args.data.size() == 1 || args.data.size() == 2);
 	auto count = args.size();
 	auto &input = args.data[0];
-	CoreVectorOperations::Polygon2DToVarchar(input, result, count);
+	CoreVectorOperations::Polygon2DToVarchar(input, result, count, CoordinatePrecisionBindData::Get(state));
 }
 
 //------------------------------------------------------------------------------
 // BOX_2D
 //------------------------------------------------------------------------------
 static void Box2DAsTextFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	D_ASSERT(args.data.size() == 1);
+	D_ASSERT(args.data.size() == 1 || args.data.size() == 2);
 	auto count = args.size();
 	auto &input = args.data[0];
-	CoreVectorOperations::Box2DToVarchar(input, result, count);
+	CoreVectorOperations::Box2DToVarchar(input, result, count, CoordinatePrecisionBindData::Get(state));
 }
 
 //------------------------------------------------------------------------------
 // GEOMETRY
 //------------------------------------------------------------------------------
 static void GeometryAsTextFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	D_ASSERT(args.data.size() == 1);
+	D_ASSERT(args.data.size() == 1 || args.data.size() == 2);
 	auto count = args.size();
 	auto &input = args.data[0];
-	CoreVectorOperations::GeometryToVarchar(input, result, count);
+	CoreVectorOperations::GeometryToVarchar(input, result, count, CoordinatePrecisionBindData::Get(state));
 }
 
 //------------------------------------------------------------------------------
@@ -71,15 +70,24 @@ static void GeometryAsTextFunction(DataChunk &args, ExpressionState &state, Vect
 void CoreScalarFunctions::RegisterStAsText(DatabaseInstance &db) {
 	ScalarFunctionSet as_text_function_set("ST_AsText");
 
-	as_text_function_set.AddFunction(
-	    ScalarFunction({GeoTypes::POINT_2D()}, LogicalType::VARCHAR, Point2DAsTextFunction));
-	as_text_function_set.AddFunction(
-	    ScalarFunction({GeoTypes::LINESTRING_2D()}, LogicalType::VARCHAR, LineString2DAsTextFunction));
-	as_text_function_set.AddFunction(
-	    ScalarFunction({GeoTypes::POLYGON_2D()}, LogicalType::VARCHAR, Polygon2DAsTextFunction));
-	as_text_function_set.AddFunction(ScalarFunction({GeoTypes::BOX_2D()}, LogicalType::VARCHAR, Box2DAsTextFunction));
-	as_text_function_set.AddFunction(
-	    ScalarFunction({GeoTypes::GEOMETRY()}, LogicalType::VARCHAR, GeometryAsTextFunction));
+	// ST_AsText(geom [, precision])
+	for (auto &precision : vector<vector<LogicalType>> {{}, {LogicalType::INTEGER}}) {
+		auto arguments = [&](const LogicalType &type) {
+			vector<LogicalType> result = {type};
+			result.insert(result.end(), precision.begin(), precision.end());
+			return result;
+		};
+		as_text_function_set.AddFunction(ScalarFunction(arguments(GeoTypes::POINT_2D()), LogicalType::VARCHAR,
+		                                                Point2DAsTextFunction, CoordinatePrecisionBindData::Bind));
+		as_text_function_set.AddFunction(ScalarFunction(arguments(GeoTypes::LINESTRING_2D()), LogicalType::VARCHAR,
+		                                                LineString2DAsTextFunction, CoordinatePrecisionBindData::Bind));
+		as_text_function_set.AddFunction(ScalarFunction(arguments(GeoTypes::POLYGON_2D()), LogicalType::VARCHAR,
+		                                                Polygon2DAsTextFunction, CoordinatePrecisionBindData::Bind));
+		as_text_function_set.AddFunction(ScalarFunction(arguments(GeoTypes::BOX_2D()), LogicalType::VARCHAR,
+		                                                Box2DAsTextFunction, CoordinatePrecisionBindData::Bind));
+		as_text_function_set.AddFunction(ScalarFunction(arguments(GeoTypes::GEOMETRY()), LogicalType::VARCHAR,
+		                                                GeometryAsTextFunction, CoordinatePrecisionBindData::Bind));
+	}
 
 	ExtensionUtil::RegisterFunction(db, as_text_function_set);
 }
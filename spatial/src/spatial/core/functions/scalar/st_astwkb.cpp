@@ -0,0 +1,104 @@
+#include "duckdb/common/vector_operations/unary_executor.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include "spatial/common.hpp"
+#include "spatial/core/functions/scalar.hpp"
+#include "spatial/core/functions/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/geometry/twkb_writer.hpp"
+
+namespace spatial {
+
+namespace core {
+
+struct GeometryAsTWKBBindData : public FunctionData {
+	TWKBOptions options;
+
+	explicit GeometryAsTWKBBindData(TWKBOptions options) : options(options) {
+	}
+
+public:
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<GeometryAsTWKBBindData>(options);
+	}
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<GeometryAsTWKBBindData>();
+		return options.precision_xy == other.options.precision_xy &&
+		       options.precision_z == other.options.precision_z && options.precision_m == other.options.precision_m &&
+		       options.with_sizes == other.options.with_sizes && options.with_boxes == other.options.with_boxes;
+	}
+};
+
+//------------------------------------------------------------------------------
+// GEOMETRY
+//------------------------------------------------------------------------------
+static void GeometryAsTWKBFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &options = func_expr.bind_info->Cast<GeometryAsTWKBBindData>().options;
+	auto &input = args.data[0];
+	auto count = args.size();
+
+	vector<data_t> buffer;
+	UnaryExecutor::Execute<geometry_t, string_t>(input, result, count, [&](geometry_t input) {
+		TWKBWriter::Write(input, buffer, options);
+		return StringVector::AddStringOrBlob(result, const_char_ptr_cast(buffer.data()), buffer.size());
+	});
+}
+
+// The options are the same for every row, so that the blobs of a column share their precision
+static unique_ptr<FunctionData> GeometryAsTWKBBind(ClientContext &context, ScalarFunction &bound_function,
+                                                   vector<unique_ptr<Expression>> &arguments) {
+	vector<Value> values;
+	for (idx_t i = 1; i < arguments.size(); i++) {
+		auto &arg = arguments[i];
+		if (arg->HasParameter()) {
+			throw InvalidInputException("Parameters are not supported in ST_AsTWKB optional arguments");
+		}
+		if (!arg->IsFoldable()) {
+			throw InvalidInputException("Non-constant arguments are not supported in ST_AsTWKB optional arguments");
+		}
+		auto value = ExpressionExecutor::EvaluateScalar(context, *arg);
+		if (value.IsNull()) {
+			throw InvalidInputException("ST_AsTWKB optional arguments can not be NULL");
+		}
+		values.push_back(std::move(value));
+	}
+
+	TWKBOptions options;
+	if (values.size() > 0) {
+		options.precision_xy = values[0].GetValue<int32_t>();
+	}
+	if (values.size() > 2) {
+		options.precision_z = values[1].GetValue<int32_t>();
+		options.precision_m = values[2].GetValue<int32_t>();
+	}
+	if (values.size() > 4) {
+		options.with_sizes = values[3].GetValue<bool>();
+		options.with_boxes = values[4].GetValue<bool>();
+	}
+	return make_uniq<GeometryAsTWKBBindData>(options);
+}
+
+//------------------------------------------------------------------------------
+//  Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterStAsTWKB(DatabaseInstance &db) {
+	ScalarFunctionSet as_twkb_function_set("ST_AsTWKB");
+
+	// ST_AsTWKB(geom [, precision_xy [, precision_z, precision_m [, with_sizes, with_boxes]]])
+	vector<LogicalType> arguments = {GeoTypes::GEOMETRY()};
+	for (auto &optional : vector<vector<LogicalType>> {{},
+	                                                    {LogicalType::INTEGER},
+	                                                    {LogicalType::INTEGER, LogicalType::INTEGER},
+	                                                    {LogicalType::BOOLEAN, LogicalType::BOOLEAN}}) {
+		arguments.insert(arguments.end(), optional.begin(), optional.end());
+		as_twkb_function_set.AddFunction(
+		    ScalarFunction(arguments, LogicalType::BLOB, GeometryAsTWKBFunction, GeometryAsTWKBBind));
+	}
+
+	ExtensionUtil::RegisterFunction(db, as_twkb_function_set);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -4,6 +4,8 @@
 #include "spatial/core/functions/scalar.hpp"
 #include "spatial/core/functions/common.hpp"
 #include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/centroid.hpp"
 #include "spatial/core/types.hpp"
 
 namespace spatial {
@@ -197,6 +199,21 @@ static void BoxCentroidFunction(DataChunk &args, ExpressionState &state, Vector
 	}
 }
 
+//------------------------------------------------------------------------------
+// GEOMETRY
+//------------------------------------------------------------------------------
+static void GeometryCentroidFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
+	GeometryExecutor::ExecuteUnary<geometry_t, geometry_t>(args.data[0], result, args.size(), [&](geometry_t input) {
+		VertexXY centroid;
+		if (!Centroid::TryGetCentroid(input, centroid)) {
+			Point empty(false, false);
+			return lstate.factory.Serialize(result, empty, false, false);
+		}
+		return GeometryFactory::SerializePoint2D(result, centroid.x, centroid.y);
+	});
+}
+
 //------------------------------------------------------------------------------
 // Register functions
 //------------------------------------------------------------------------------
@@ -206,6 +223,8 @@ void CoreScalarFunctions::RegisterStCentroid(DatabaseInstance &db) {
 	set.AddFunction(ScalarFunction({GeoTypes::LINESTRING_2D()}, GeoTypes::POINT_2D(), LineStringCentroidFunction));
 	set.AddFunction(ScalarFunction({GeoTypes::POLYGON_2D()}, GeoTypes::POINT_2D(), PolygonCentroidFunction));
 	set.AddFunction(ScalarFunction({GeoTypes::BOX_2D()}, GeoTypes::POINT_2D(), BoxCentroidFunction));
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY()}, GeoTypes::GEOMETRY(), GeometryCentroidFunction, nullptr,
+	                               nullptr, nullptr, GeometryFunctionLocalState::Init));
 
 	ExtensionUtil::RegisterFunction(db, set);
 }
@@ -0,0 +1,55 @@
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/functions/scalar.hpp"
+#include "spatial/core/functions/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/clip_by_box.hpp"
+
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include "duckdb/common/vector_operations/generic_executor.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// GEOMETRY - BOX_2D
+//------------------------------------------------------------------------------
+static void GeometryClipByBoxFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
+	auto count = args.size();
+
+	GeometryWriter writer;
+	writer.double_bbox = lstate.factory.double_bbox;
+	BoxClipper clipper;
+
+	using GEOMETRY_TYPE = PrimitiveType<geometry_t>;
+	using BOX_TYPE = StructTypeQuaternary<double, double, double, double>;
+
+	GenericExecutor::ExecuteBinary<GEOMETRY_TYPE, BOX_TYPE, GEOMETRY_TYPE>(
+	    args.data[0], args.data[1], result, count, [&](GEOMETRY_TYPE &geom, BOX_TYPE &box_val) {
+		    BoundingBox box;
+		    box.minx = box_val.a_val;
+		    box.miny = box_val.b_val;
+		    box.maxx = box_val.c_val;
+		    box.maxy = box_val.d_val;
+		    return clipper.Execute(geom.val, box, writer, result);
+	    });
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterStClipByBox2D(DatabaseInstance &db) {
+	ScalarFunctionSet set("ST_ClipByBox2D");
+
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), GeoTypes::BOX_2D()}, GeoTypes::GEOMETRY(),
+	                               GeometryClipByBoxFunction, nullptr, nullptr, nullptr,
+	                               GeometryFunctionLocalState::Init));
+
+	ExtensionUtil::RegisterFunction(db, set);
+}
+
+} // namespace core
+
+} // namespace spatial
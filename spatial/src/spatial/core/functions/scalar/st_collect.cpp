@@ -3,6 +3,7 @@
 #include "spatial/core/functions/scalar.hpp"
 #include "spatial/core/functions/common.hpp"
 #include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_writer.hpp"
 
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
 #include "duckdb/common/vector_operations/unary_executor.hpp"
@@ -14,12 +15,14 @@ namespace core {
 
 static void CollectFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
-	auto &arena = lstate.factory.allocator;
 	auto count = args.size();
 	auto &child_vec = ListVector::GetEntry(args.data[0]);
 	UnifiedVectorFormat format;
 	child_vec.ToUnifiedFormat(count, format);
 
+	GeometryWriter writer;
+	writer.double_bbox = lstate.factory.double_bbox;
+
 	UnaryExecutor::Execute<list_entry_t, geometry_t>(args.data[0], result, count, [&](list_entry_t &geometry_list) {
 		auto offset = geometry_list.offset;
 		auto length = geometry_list.length;
@@ -52,8 +55,9 @@ static void CollectFunction(DataChunk &args, ExpressionState &state, Vector &res
 		}
 
 		if (geometries.empty()) {
-			GeometryCollection empty(has_z, has_m);
-			return lstate.factory.Serialize(result, empty, has_z, has_m);
+			writer.Begin(GeometryType::GEOMETRYCOLLECTION, has_z, has_m);
+			writer.AddCollection(GeometryType::GEOMETRYCOLLECTION, 0);
+			return writer.End(result);
 		}
 
 		bool all_points = true;
@@ -72,33 +76,22 @@ static void CollectFunction(DataChunk &args, ExpressionState &state, Vector &res
 			}
 		}
 
-        // TODO: Dont upcast the children, just append them.
-
+		auto type = GeometryType::GEOMETRYCOLLECTION;
 		if (all_points) {
-			MultiPoint collection(arena, geometries.size(), has_z, has_m);
-			for (idx_t i = 0; i < geometries.size(); i++) {
-				collection[i] = geometries[i].SetVertexType(arena, has_z, has_m).As<Point>();
-			}
-			return lstate.factory.Serialize(result, collection, has_z, has_m);
+			type = GeometryType::MULTIPOINT;
 		} else if (all_lines) {
-			MultiLineString collection(arena, geometries.size(), has_z, has_m);
-			for (idx_t i = 0; i < geometries.size(); i++) {
-				collection[i] = geometries[i].SetVertexType(arena, has_z, has_m).As<LineString>();
-			}
-			return lstate.factory.Serialize(result, collection, has_z, has_m);
+			type = GeometryType::MULTILINESTRING;
 		} else if (all_polygons) {
-			MultiPolygon collection(arena, geometries.size(), has_z, has_m);
-			for (idx_t i = 0; i < geometries.size(); i++) {
-				collection[i] = geometries[i].SetVertexType(arena, has_z, has_m).As<Polygon>();
-			}
-			return lstate.factory.Serialize(result, collection, has_z, has_m);
-		} else {
-			GeometryCollection collection(arena, geometries.size(), has_z, has_m);
-			for (idx_t i = 0; i < geometries.size(); i++) {
-				collection[i] = geometries[i].SetVertexType(arena, has_z, has_m);
-			}
-			return lstate.factory.Serialize(result, collection, has_z, has_m);
+			type = GeometryType::MULTIPOLYGON;
+		}
+
+		// The writer upcasts the vertices of the items to the dimensions of the collection
+		writer.Begin(type, has_z, has_m);
+		writer.AddCollection(type, geometries.size());
+		for (auto &geometry : geometries) {
+			writer.AddGeometry(geometry);
 		}
+		return writer.End(result);
 	});
 }
 
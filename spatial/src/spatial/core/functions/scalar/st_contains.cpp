@@ -1,8 +1,11 @@
 #include "spatial/common.hpp"
 #include "spatial/core/types.hpp"
 #include "spatial/core/functions/scalar.hpp"
+#include "spatial/core/geometry/point_in_polygon.hpp"
+#include "spatial/core/geometry/quantized_geometry.hpp"
 
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include "duckdb/common/vector_operations/generic_executor.hpp"
 namespace spatial {
 
 namespace core {
@@ -10,7 +13,118 @@ namespace core {
 //------------------------------------------------------------------------------
 // POLYGON_2D - POINT_2D
 //------------------------------------------------------------------------------
-static void PointInPolygonOperation(Vector &in_point, Vector &in_polygon, Vector &result, idx_t count) {
+// Caches an edge index over the last constant polygon seen, so that testing a
+// whole column of points against the same polygon does not rescan every ring per point
+struct PointInPolygonLocalState : FunctionLocalState {
+	vector<uint64_t> ring_lengths;
+	vector<double> x_data;
+	vector<double> y_data;
+	unique_ptr<PreparedPolygon> prepared;
+
+	static unique_ptr<FunctionLocalState> Init(ExpressionState &state, const BoundFunctionExpression &expr,
+	                                           FunctionData *bind_data) {
+		return make_uniq<PointInPolygonLocalState>();
+	}
+
+	// Returns nullptr if the polygon has no edges
+	PreparedPolygon *GetPrepared(const list_entry_t *rings, idx_t ring_count, const double *xs, const double *ys) {
+		if (!IsCached(rings, ring_count, xs, ys)) {
+			ring_lengths.clear();
+			x_data.clear();
+			y_data.clear();
+			for (idx_t ring_idx = 0; ring_idx < ring_count; ring_idx++) {
+				auto &ring = rings[ring_idx];
+				ring_lengths.push_back(ring.length);
+				x_data.insert(x_data.end(), xs + ring.offset, xs + ring.offset + ring.length);
+				y_data.insert(y_data.end(), ys + ring.offset, ys + ring.offset + ring.length);
+			}
+			prepared = PreparedPolygon::TryCreate(rings, ring_count, xs, ys);
+		}
+		return prepared.get();
+	}
+
+private:
+	bool IsCached(const list_entry_t *rings, idx_t ring_count, const double *xs, const double *ys) const {
+		if (ring_lengths.empty() || ring_lengths.size() != ring_count) {
+			return false;
+		}
+		idx_t vertex_offset = 0;
+		for (idx_t ring_idx = 0; ring_idx < ring_count; ring_idx++) {
+			auto &ring = rings[ring_idx];
+			if (ring.length != ring_lengths[ring_idx] ||
+			    memcmp(xs + ring.offset, x_data.data() + vertex_offset, ring.length * sizeof(double)) != 0 ||
+			    memcmp(ys + ring.offset, y_data.data() + vertex_offset, ring.length * sizeof(double)) != 0) {
+				return false;
+			}
+			vertex_offset += ring.length;
+		}
+		return true;
+	}
+};
+
+// Answers all points against a single constant polygon using the cached edge index
+static void PointInConstantPolygonOperation(Vector &in_point, Vector &in_polygon, Vector &result, idx_t count,
+                                            PointInPolygonLocalState &lstate) {
+	auto &ring_vec = ListVector::GetEntry(in_polygon);
+	auto &coord_vec = ListVector::GetEntry(ring_vec);
+	auto &coord_children = StructVector::GetEntries(coord_vec);
+	auto polygon = ConstantVector::GetData<list_entry_t>(in_polygon)[0];
+	auto rings = ListVector::GetData(ring_vec) + polygon.offset;
+	auto prepared = lstate.GetPrepared(rings, polygon.length, FlatVector::GetData<double>(*coord_children[0]),
+	                                   FlatVector::GetData<double>(*coord_children[1]));
+
+	if (in_point.GetVectorType() == VectorType::CONSTANT_VECTOR) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+		if (ConstantVector::IsNull(in_point)) {
+			ConstantVector::SetNull(result, true);
+			return;
+		}
+		count = 1;
+	} else {
+		in_point.Flatten(count);
+		FlatVector::Validity(result).Copy(FlatVector::Validity(in_point), count);
+	}
+
+	auto &p_children = StructVector::GetEntries(in_point);
+	auto p_x_data = FlatVector::GetData<double>(*p_children[0]);
+	auto p_y_data = FlatVector::GetData<double>(*p_children[1]);
+	auto result_data = FlatVector::GetData<bool>(result);
+
+	if (!prepared) {
+		memset(result_data, 0, count * sizeof(bool));
+		return;
+	}
+
+	// Reject everything outside of the bounding box in a branch-free pass first,
+	// and only locate the remaining candidates in the index
+	auto &bbox = prepared->GetBoundingBox();
+	SelectionVector candidates(count);
+	idx_t candidate_count = 0;
+	for (idx_t i = 0; i < count; i++) {
+		auto x = p_x_data[i];
+		auto y = p_y_data[i];
+		result_data[i] = false;
+		candidates.set_index(candidate_count, i);
+		candidate_count += (x >= bbox.minx) & (x <= bbox.maxx) & (y >= bbox.miny) & (y <= bbox.maxy);
+	}
+	for (idx_t i = 0; i < candidate_count; i++) {
+		auto idx = candidates.get_index(i);
+		result_data[idx] = prepared->Locate(p_x_data[idx], p_y_data[idx]) == PointLocation::INTERIOR;
+	}
+}
+
+static void PointInPolygonOperation(Vector &in_point, Vector &in_polygon, Vector &result, idx_t count,
+                                    PointInPolygonLocalState &lstate) {
+
+	if (in_polygon.GetVectorType() == VectorType::CONSTANT_VECTOR) {
+		if (ConstantVector::IsNull(in_polygon)) {
+			result.SetVectorType(VectorType::CONSTANT_VECTOR);
+			ConstantVector::SetNull(result, true);
+			return;
+		}
+		PointInConstantPolygonOperation(in_point, in_polygon, result, count, lstate);
+		return;
+	}
 
 	in_polygon.Flatten(count);
 	in_point.Flatten(count);
@@ -129,7 +243,8 @@ static void PolygonContainsPointFunction(DataChunk &args, ExpressionState &state
 	auto count = args.size();
 	auto &in_polygon = args.data[0];
 	auto &in_point = args.data[1];
-	PointInPolygonOperation(in_point, in_polygon, result, count);
+	auto &lstate = (PointInPolygonLocalState &)*ExecuteFunctionState::GetFunctionState(state);
+	PointInPolygonOperation(in_point, in_polygon, result, count, lstate);
 }
 
 static void PointWithinPolygonFunction(DataChunk &args, ExpressionState &state, Vector &result) {
@@ -137,7 +252,78 @@ static void PointWithinPolygonFunction(DataChunk &args, ExpressionState &state,
 	auto count = args.size();
 	auto &in_point = args.data[0];
 	auto &in_polygon = args.data[1];
-	PointInPolygonOperation(in_point, in_polygon, result, count);
+	auto &lstate = (PointInPolygonLocalState &)*ExecuteFunctionState::GetFunctionState(state);
+	PointInPolygonOperation(in_point, in_polygon, result, count, lstate);
+}
+
+//------------------------------------------------------------------------------
+// GEOMETRY_Q - POINT_2D
+//------------------------------------------------------------------------------
+// Located on the integer grid of each polygon by QuantizedGeometry::TryLocatePoint, points on the boundary are not
+// contained. Only POLYGON and MULTIPOLYGON are supported, other geometries have to be cast to GEOMETRY.
+static void QuantizedContainsPointOperation(Vector &in_geom, Vector &in_point, Vector &result, idx_t count) {
+	auto all_constant = in_point.GetVectorType() == VectorType::CONSTANT_VECTOR &&
+	                    in_geom.GetVectorType() == VectorType::CONSTANT_VECTOR;
+
+	UnifiedVectorFormat geom_format;
+	in_geom.ToUnifiedFormat(count, geom_format);
+	auto geom_data = UnifiedVectorFormat::GetData<string_t>(geom_format);
+
+	in_point.Flatten(count);
+	auto &p_children = StructVector::GetEntries(in_point);
+	auto p_x_data = FlatVector::GetData<double>(*p_children[0]);
+	auto p_y_data = FlatVector::GetData<double>(*p_children[1]);
+	auto &point_validity = FlatVector::Validity(in_point);
+
+	auto result_data = FlatVector::GetData<bool>(result);
+	for (idx_t i = 0; i < count; i++) {
+		auto geom_idx = geom_format.sel->get_index(i);
+		if (!point_validity.RowIsValid(i) || !geom_format.validity.RowIsValid(geom_idx)) {
+			FlatVector::SetNull(result, i, true);
+			continue;
+		}
+		PointLocation location;
+		if (!QuantizedGeometry::TryLocatePoint(geom_data[geom_idx], p_x_data[i], p_y_data[i], location)) {
+			throw InvalidInputException("ST_Contains: GEOMETRY_Q is only supported for POLYGON and MULTIPOLYGON, cast "
+			                            "other geometries to GEOMETRY");
+		}
+		result_data[i] = location == PointLocation::INTERIOR;
+	}
+
+	if (all_constant) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
+}
+
+static void QuantizedContainsPointFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	QuantizedContainsPointOperation(args.data[0], args.data[1], result, args.size());
+}
+
+static void PointWithinQuantizedFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	QuantizedContainsPointOperation(args.data[1], args.data[0], result, args.size());
+}
+
+//------------------------------------------------------------------------------
+// BOX_2D - BOX_2D
+//------------------------------------------------------------------------------
+// A box contains another box if it covers it completely, boundaries included
+static void BoxContainsBoxOperation(Vector &in_outer, Vector &in_inner, Vector &result, idx_t count) {
+	using BOX_TYPE = StructTypeQuaternary<double, double, double, double>;
+	using BOOL_TYPE = PrimitiveType<bool>;
+
+	GenericExecutor::ExecuteBinary<BOX_TYPE, BOX_TYPE, BOOL_TYPE>(
+	    in_outer, in_inner, result, count, [&](BOX_TYPE &outer, BOX_TYPE &inner) {
+		    return outer.a_val <= inner.a_val && outer.b_val <= inner.b_val && outer.c_val >= inner.c_val &&
+		           outer.d_val >= inner.d_val;
+	    });
+}
+
+static void BoxContainsBoxFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	BoxContainsBoxOperation(args.data[0], args.data[1], result, args.size());
+}
+
+static void BoxWithinBoxFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	BoxContainsBoxOperation(args.data[1], args.data[0], result, args.size());
 }
 
 //------------------------------------------------------------------------------
@@ -151,9 +337,23 @@ void CoreScalarFunctions::RegisterStContains(DatabaseInstance &db) {
 
 	// POLYGON_2D - POINT_2D
 	contains_function_set.AddFunction(ScalarFunction({GeoTypes::POLYGON_2D(), GeoTypes::POINT_2D()},
-	                                                 LogicalType::BOOLEAN, PolygonContainsPointFunction));
+	                                                 LogicalType::BOOLEAN, PolygonContainsPointFunction, nullptr,
+	                                                 nullptr, nullptr, PointInPolygonLocalState::Init));
 	within_function_set.AddFunction(ScalarFunction({GeoTypes::POINT_2D(), GeoTypes::POLYGON_2D()}, LogicalType::BOOLEAN,
-	                                               PointWithinPolygonFunction));
+	                                               PointWithinPolygonFunction, nullptr, nullptr, nullptr,
+	                                               PointInPolygonLocalState::Init));
+
+	// GEOMETRY_Q - POINT_2D
+	contains_function_set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY_Q(), GeoTypes::POINT_2D()},
+	                                                 LogicalType::BOOLEAN, QuantizedContainsPointFunction));
+	within_function_set.AddFunction(ScalarFunction({GeoTypes::POINT_2D(), GeoTypes::GEOMETRY_Q()}, LogicalType::BOOLEAN,
+	                                               PointWithinQuantizedFunction));
+
+	// BOX_2D - BOX_2D
+	contains_function_set.AddFunction(
+	    ScalarFunction({GeoTypes::BOX_2D(), GeoTypes::BOX_2D()}, LogicalType::BOOLEAN, BoxContainsBoxFunction));
+	within_function_set.AddFunction(
+	    ScalarFunction({GeoTypes::BOX_2D(), GeoTypes::BOX_2D()}, LogicalType::BOOLEAN, BoxWithinBoxFunction));
 
 	ExtensionUtil::RegisterFunction(db, contains_function_set);
 	ExtensionUtil::RegisterFunction(db, within_function_set);
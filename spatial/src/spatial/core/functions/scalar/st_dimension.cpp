@@ -3,6 +3,7 @@
 #include "spatial/core/functions/scalar.hpp"
 #include "spatial/core/functions/common.hpp"
 #include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_processor.hpp"
 
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
 #include "duckdb/common/vector_operations/unary_executor.hpp"
@@ -15,23 +16,68 @@ namespace core {
 //------------------------------------------------------------------------------
 // GEOMETRY
 //------------------------------------------------------------------------------
-static void DimensionFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
+// The dimension follows from the type in the inlined prefix of the blob, only geometry collections walk their items
+// for the highest dimension among them, without reading any vertices
+class DimensionProcessor final : GeometryProcessor<int32_t> {
+public:
+	int32_t Execute(const geometry_t &geom) {
+		switch (geom.GetType()) {
+		case GeometryType::POINT:
+		case GeometryType::MULTIPOINT:
+			return 0;
+		case GeometryType::LINESTRING:
+		case GeometryType::MULTILINESTRING:
+			return 1;
+		case GeometryType::POLYGON:
+		case GeometryType::MULTIPOLYGON:
+			return 2;
+		default:
+			return Process(geom);
+		}
+	}
+
+private:
+	int32_t ProcessPoint(const VertexData &) override {
+		return 0;
+	}
+	int32_t ProcessLineString(const VertexData &) override {
+		return 1;
+	}
+	int32_t ProcessPolygon(PolygonState &) override {
+		return 2;
+	}
+	int32_t ProcessCollection(CollectionState &state) override {
+		switch (CurrentType()) {
+		case GeometryType::MULTIPOINT:
+			return 0;
+		case GeometryType::MULTILINESTRING:
+			return 1;
+		case GeometryType::MULTIPOLYGON:
+			return 2;
+		default:
+			break;
+		}
+		int32_t max = 0;
+		while (!state.IsDone()) {
+			max = MaxValue(max, state.Next());
+		}
+		return max;
+	}
+};
 
+static void DimensionFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto count = args.size();
 	auto &input = args.data[0];
 
-	UnaryExecutor::Execute<geometry_t, int32_t>(input, result, count, [&](geometry_t input) {
-		auto geometry = lstate.factory.Deserialize(input);
-		return geometry.Dimension();
-	});
+	DimensionProcessor processor;
+	UnaryExecutor::Execute<geometry_t, int32_t>(input, result, count,
+	                                            [&](geometry_t input) { return processor.Execute(input); });
 }
 
 void CoreScalarFunctions::RegisterStDimension(DatabaseInstance &db) {
 	ScalarFunctionSet set("ST_Dimension");
 
-	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY()}, LogicalType::INTEGER, DimensionFunction, nullptr, nullptr,
-	                               nullptr, GeometryFunctionLocalState::Init));
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY()}, LogicalType::INTEGER, DimensionFunction));
 
 	ExtensionUtil::RegisterFunction(db, set);
 }
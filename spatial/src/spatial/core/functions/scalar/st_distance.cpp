@@ -4,51 +4,75 @@
 #include "spatial/core/functions/common.hpp"
 #include "spatial/core/geometry/geometry.hpp"
 #include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/point_distance.hpp"
+#include "spatial/core/geometry/quantized_geometry.hpp"
 #include "spatial/core/types.hpp"
 
 namespace spatial {
 
 namespace core {
 
-//-----------------------------------------------------------------------------
-// Helpers
-//-----------------------------------------------------------------------------
-static PointXY ClosestPointOnSegment(const PointXY &p, const PointXY &p1, const PointXY &p2) {
-	// If the segment is a Vertex, then return that Vertex
-	if (p1 == p2) {
-		return p1;
-	}
-	auto n1 = ((p.x - p1.x) * (p2.x - p1.x) + (p.y - p1.y) * (p2.y - p1.y));
-	auto n2 = ((p2.x - p1.x) * (p2.x - p1.x) + (p2.y - p1.y) * (p2.y - p1.y));
-	auto r = n1 / n2;
-	// If r is less than 0, then the Point is outside the segment in the p1 direction
-	if (r <= 0) {
-		return p1;
-	}
-	// If r is greater than 1, then the Point is outside the segment in the p2 direction
-	if (r >= 1) {
-		return p2;
-	}
-	// Interpolate between p1 and p2
-	return PointXY(p1.x + r * (p2.x - p1.x), p1.y + r * (p2.y - p1.y));
-}
-
-static double DistanceToSegmentSquared(const PointXY &px, const PointXY &ax, const PointXY &bx) {
-	auto point = ClosestPointOnSegment(px, ax, bx);
-	auto dx = px.x - point.x;
-	auto dy = px.y - point.y;
-	return dx * dx + dy * dy;
-}
-
 //------------------------------------------------------------------------------
 // POINT_2D - POINT_2D
 //------------------------------------------------------------------------------
+// The kernels below loop over the flat x/y child arrays without branches, so the compiler vectorizes them. A constant
+// argument is read once instead of being flattened, and two constant arguments produce a constant result.
+
+static void SetNullsOfEither(Vector &left, Vector &right, Vector &result, idx_t count) {
+	auto &validity = FlatVector::Validity(result);
+	validity.Copy(FlatVector::Validity(left), count);
+	validity.Combine(FlatVector::Validity(right), count);
+}
+
 static void PointToPointDistanceFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	D_ASSERT(args.data.size() == 2);
 	auto &left = args.data[0];
 	auto &right = args.data[1];
 	auto count = args.size();
 
+	auto left_constant = left.GetVectorType() == VectorType::CONSTANT_VECTOR;
+	auto right_constant = right.GetVectorType() == VectorType::CONSTANT_VECTOR;
+
+	if (left_constant || right_constant) {
+		auto &constant = left_constant ? left : right;
+		auto &other = left_constant ? right : left;
+		if (ConstantVector::IsNull(constant)) {
+			result.SetVectorType(VectorType::CONSTANT_VECTOR);
+			ConstantVector::SetNull(result, true);
+			return;
+		}
+		auto &constant_entries = StructVector::GetEntries(constant);
+		auto cx = ConstantVector::GetData<double>(*constant_entries[0])[0];
+		auto cy = ConstantVector::GetData<double>(*constant_entries[1])[0];
+
+		if (left_constant && right_constant) {
+			result.SetVectorType(VectorType::CONSTANT_VECTOR);
+			if (ConstantVector::IsNull(other)) {
+				ConstantVector::SetNull(result, true);
+				return;
+			}
+			auto &other_entries = StructVector::GetEntries(other);
+			auto dx = ConstantVector::GetData<double>(*other_entries[0])[0] - cx;
+			auto dy = ConstantVector::GetData<double>(*other_entries[1])[0] - cy;
+			ConstantVector::GetData<double>(result)[0] = std::sqrt(dx * dx + dy * dy);
+			return;
+		}
+
+		other.Flatten(count);
+		auto &other_entries = StructVector::GetEntries(other);
+		auto x_data = FlatVector::GetData<double>(*other_entries[0]);
+		auto y_data = FlatVector::GetData<double>(*other_entries[1]);
+
+		auto out_data = FlatVector::GetData<double>(result);
+		for (idx_t i = 0; i < count; i++) {
+			auto dx = x_data[i] - cx;
+			auto dy = y_data[i] - cy;
+			out_data[i] = std::sqrt(dx * dx + dy * dy);
+		}
+		FlatVector::Validity(result).Copy(FlatVector::Validity(other), count);
+		return;
+	}
+
 	left.Flatten(count);
 	right.Flatten(count);
 
@@ -62,65 +86,108 @@ static void PointToPointDistanceFunction(DataChunk &args, ExpressionState &state
 
 	auto out_data = FlatVector::GetData<double>(result);
 	for (idx_t i = 0; i < count; i++) {
-		out_data[i] = std::sqrt(std::pow(left_x[i] - right_x[i], 2) + std::pow(left_y[i] - right_y[i], 2));
-	}
-
-	if (count == 1) {
-		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+		auto dx = left_x[i] - right_x[i];
+		auto dy = left_y[i] - right_y[i];
+		out_data[i] = std::sqrt(dx * dx + dy * dy);
 	}
+	SetNullsOfEither(left, right, result, count);
 }
 
 //------------------------------------------------------------------------------
 // POINT_2D - LINESTRING_2D
 //------------------------------------------------------------------------------
+// The segments of each line are evaluated several at a time by PointDistance::ToSegmentsSquaredMin
+
+static void GetLineVertices(Vector &line, const double *&x_data, const double *&y_data) {
+	auto &line_vertices = ListVector::GetEntry(line);
+	auto &line_children = StructVector::GetEntries(line_vertices);
+	x_data = FlatVector::GetData<double>(*line_children[0]);
+	y_data = FlatVector::GetData<double>(*line_children[1]);
+}
 
 static void PointToLineStringDistanceOperation(Vector &in_point, Vector &in_line, Vector &result, idx_t count) {
+	auto point_constant = in_point.GetVectorType() == VectorType::CONSTANT_VECTOR;
+	auto line_constant = in_line.GetVectorType() == VectorType::CONSTANT_VECTOR;
 
-	// Set up the point vectors
-	in_point.Flatten(count);
-	auto &p_children = StructVector::GetEntries(in_point);
-	auto &p_x = p_children[0];
-	auto &p_y = p_children[1];
-	auto p_x_data = FlatVector::GetData<double>(*p_x);
-	auto p_y_data = FlatVector::GetData<double>(*p_y);
+	if ((point_constant && ConstantVector::IsNull(in_point)) || (line_constant && ConstantVector::IsNull(in_line))) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+		ConstantVector::SetNull(result, true);
+		return;
+	}
 
-	// Set up the line vectors
-	in_line.Flatten(count);
+	const double *x_data;
+	const double *y_data;
 
-	auto &inner = ListVector::GetEntry(in_line);
-	auto &children = StructVector::GetEntries(inner);
-	auto &x = children[0];
-	auto &y = children[1];
-	auto x_data = FlatVector::GetData<double>(*x);
-	auto y_data = FlatVector::GetData<double>(*y);
-	auto lines = ListVector::GetData(in_line);
+	if (point_constant && line_constant) {
+		auto &p_children = StructVector::GetEntries(in_point);
+		auto px = ConstantVector::GetData<double>(*p_children[0])[0];
+		auto py = ConstantVector::GetData<double>(*p_children[1])[0];
+		auto &line = ConstantVector::GetData<list_entry_t>(in_line)[0];
+		GetLineVertices(in_line, x_data, y_data);
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+		ConstantVector::GetData<double>(result)[0] = std::sqrt(
+		    PointDistance::ToSegmentsSquaredMin(px, py, x_data + line.offset, y_data + line.offset, line.length));
+		return;
+	}
 
 	auto result_data = FlatVector::GetData<double>(result);
-	for (idx_t i = 0; i < count; i++) {
-		auto offset = lines[i].offset;
-		auto length = lines[i].length;
 
-		double min_distance = std::numeric_limits<double>::max();
-		auto p = PointXY(p_x_data[i], p_y_data[i]);
+	// Many points against one line, the vertices of the line stay in cache
+	if (line_constant) {
+		in_point.Flatten(count);
+		auto &p_children = StructVector::GetEntries(in_point);
+		auto p_x_data = FlatVector::GetData<double>(*p_children[0]);
+		auto p_y_data = FlatVector::GetData<double>(*p_children[1]);
+		auto &line = ConstantVector::GetData<list_entry_t>(in_line)[0];
+		GetLineVertices(in_line, x_data, y_data);
+		auto line_x = x_data + line.offset;
+		auto line_y = y_data + line.offset;
 
-		// Loop over the segments and find the closes one to the point
-		for (idx_t j = 0; j < length - 1; j++) {
-			auto a = PointXY(x_data[offset + j], y_data[offset + j]);
-			auto b = PointXY(x_data[offset + j + 1], y_data[offset + j + 1]);
+		auto &validity = FlatVector::Validity(in_point);
+		for (idx_t i = 0; i < count; i++) {
+			if (validity.RowIsValid(i)) {
+				result_data[i] =
+				    std::sqrt(PointDistance::ToSegmentsSquaredMin(p_x_data[i], p_y_data[i], line_x, line_y, line.length));
+			}
+		}
+		FlatVector::Validity(result).Copy(validity, count);
+		return;
+	}
 
-			auto distance = DistanceToSegmentSquared(p, a, b);
-			if (distance < min_distance) {
-				min_distance = distance;
+	in_line.Flatten(count);
+	GetLineVertices(in_line, x_data, y_data);
+	auto lines = FlatVector::GetData<list_entry_t>(in_line);
+	auto &line_validity = FlatVector::Validity(in_line);
 
-				if (min_distance == 0) {
-					break;
-				}
+	// One point against many lines
+	if (point_constant) {
+		auto &p_children = StructVector::GetEntries(in_point);
+		auto px = ConstantVector::GetData<double>(*p_children[0])[0];
+		auto py = ConstantVector::GetData<double>(*p_children[1])[0];
+		for (idx_t i = 0; i < count; i++) {
+			if (line_validity.RowIsValid(i)) {
+				auto &line = lines[i];
+				result_data[i] = std::sqrt(
+				    PointDistance::ToSegmentsSquaredMin(px, py, x_data + line.offset, y_data + line.offset, line.length));
 			}
 		}
-		result_data[i] = std::sqrt(min_distance);
+		FlatVector::Validity(result).Copy(line_validity, count);
+		return;
 	}
-	if (count == 1) {
-		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+
+	in_point.Flatten(count);
+	auto &p_children = StructVector::GetEntries(in_point);
+	auto p_x_data = FlatVector::GetData<double>(*p_children[0]);
+	auto p_y_data = FlatVector::GetData<double>(*p_children[1]);
+
+	SetNullsOfEither(in_point, in_line, result, count);
+	auto &validity = FlatVector::Validity(result);
+	for (idx_t i = 0; i < count; i++) {
+		if (validity.RowIsValid(i)) {
+			auto &line = lines[i];
+			result_data[i] = std::sqrt(PointDistance::ToSegmentsSquaredMin(
+			    p_x_data[i], p_y_data[i], x_data + line.offset, y_data + line.offset, line.length));
+		}
 	}
 }
 
@@ -140,6 +207,50 @@ static void LineStringToPointDistanceFunction(DataChunk &args, ExpressionState &
 	PointToLineStringDistanceOperation(in_point, in_line, result, count);
 }
 
+//------------------------------------------------------------------------------
+// POINT_2D - GEOMETRY_Q
+//------------------------------------------------------------------------------
+// Measured on the integer grid of each geometry by QuantizedGeometry::TryGetDistanceToPoint, empty geometries are NULL
+
+static void PointToQuantizedDistanceOperation(Vector &in_point, Vector &in_geom, Vector &result, idx_t count) {
+	auto all_constant = in_point.GetVectorType() == VectorType::CONSTANT_VECTOR &&
+	                    in_geom.GetVectorType() == VectorType::CONSTANT_VECTOR;
+
+	UnifiedVectorFormat geom_format;
+	in_geom.ToUnifiedFormat(count, geom_format);
+	auto geom_data = UnifiedVectorFormat::GetData<string_t>(geom_format);
+
+	in_point.Flatten(count);
+	auto &p_children = StructVector::GetEntries(in_point);
+	auto p_x_data = FlatVector::GetData<double>(*p_children[0]);
+	auto p_y_data = FlatVector::GetData<double>(*p_children[1]);
+	auto &point_validity = FlatVector::Validity(in_point);
+
+	auto result_data = FlatVector::GetData<double>(result);
+	for (idx_t i = 0; i < count; i++) {
+		auto geom_idx = geom_format.sel->get_index(i);
+		if (!point_validity.RowIsValid(i) || !geom_format.validity.RowIsValid(geom_idx) ||
+		    !QuantizedGeometry::TryGetDistanceToPoint(geom_data[geom_idx], p_x_data[i], p_y_data[i],
+		                                              result_data[i])) {
+			FlatVector::SetNull(result, i, true);
+		}
+	}
+
+	if (all_constant) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
+}
+
+static void PointToQuantizedDistanceFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	D_ASSERT(args.data.size() == 2);
+	PointToQuantizedDistanceOperation(args.data[0], args.data[1], result, args.size());
+}
+
+static void QuantizedToPointDistanceFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	D_ASSERT(args.data.size() == 2);
+	PointToQuantizedDistanceOperation(args.data[1], args.data[0], result, args.size());
+}
+
 //------------------------------------------------------------------------------
 // Register functions
 //------------------------------------------------------------------------------
@@ -152,6 +263,10 @@ void CoreScalarFunctions::RegisterStDistance(DatabaseInstance &db) {
 	                                                 LogicalType::DOUBLE, PointToLineStringDistanceFunction));
 	distance_function_set.AddFunction(ScalarFunction({GeoTypes::LINESTRING_2D(), GeoTypes::POINT_2D()},
 	                                                 LogicalType::DOUBLE, LineStringToPointDistanceFunction));
+	distance_function_set.AddFunction(ScalarFunction({GeoTypes::POINT_2D(), GeoTypes::GEOMETRY_Q()},
+	                                                 LogicalType::DOUBLE, PointToQuantizedDistanceFunction));
+	distance_function_set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY_Q(), GeoTypes::POINT_2D()},
+	                                                 LogicalType::DOUBLE, QuantizedToPointDistanceFunction));
 
 	ExtensionUtil::RegisterFunction(db, distance_function_set);
 }
@@ -0,0 +1,39 @@
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/functions/scalar.hpp"
+
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include "duckdb/common/vector_operations/generic_executor.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// BOX_2D
+//------------------------------------------------------------------------------
+static void BoxExpandFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	using BOX_TYPE = StructTypeQuaternary<double, double, double, double>;
+	using DISTANCE_TYPE = PrimitiveType<double>;
+
+	GenericExecutor::ExecuteBinary<BOX_TYPE, DISTANCE_TYPE, BOX_TYPE>(
+	    args.data[0], args.data[1], result, args.size(), [&](BOX_TYPE &box, DISTANCE_TYPE &distance) {
+		    auto d = distance.val;
+		    return BOX_TYPE {box.a_val - d, box.b_val - d, box.c_val + d, box.d_val + d};
+	    });
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterStExpand(DatabaseInstance &db) {
+	ScalarFunctionSet set("ST_Expand");
+
+	set.AddFunction(ScalarFunction({GeoTypes::BOX_2D(), LogicalType::DOUBLE}, GeoTypes::BOX_2D(), BoxExpandFunction));
+
+	ExtensionUtil::RegisterFunction(db, set);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -10,7 +10,7 @@ namespace spatial {
 
 namespace core {
 
-// TODO: We should be able to optimize these and avoid the flatten
+// The fixed-size 2D types are flipped with plain copies of the coordinate arrays. Constant inputs are only flipped once.
 
 //------------------------------------------------------------------------------
 // POINT_2D
@@ -19,8 +19,11 @@ static void PointFlipCoordinatesFunction(DataChunk &args, ExpressionState &state
 	auto input = args.data[0];
 	auto count = args.size();
 
-	// TODO: Avoid flatten
+	if (input.GetVectorType() == VectorType::CONSTANT_VECTOR) {
+		count = 1;
+	}
 	input.Flatten(count);
+	FlatVector::SetValidity(result, FlatVector::Validity(input));
 
 	auto &coords_in = StructVector::GetEntries(input);
 	auto x_data_in = FlatVector::GetData<double>(*coords_in[0]);
@@ -45,8 +48,11 @@ static void LineStringFlipCoordinatesFunction(DataChunk &args, ExpressionState &
 	auto input = args.data[0];
 	auto count = args.size();
 
-	// TODO: Avoid flatten
+	if (input.GetVectorType() == VectorType::CONSTANT_VECTOR) {
+		count = 1;
+	}
 	input.Flatten(count);
+	FlatVector::SetValidity(result, FlatVector::Validity(input));
 
 	auto coord_vec_in = ListVector::GetEntry(input);
 	auto &coords_in = StructVector::GetEntries(coord_vec_in);
@@ -81,8 +87,11 @@ static void PolygonFlipCoordinatesFunction(DataChunk &args, ExpressionState &sta
 	auto input = args.data[0];
 	auto count = args.size();
 
-	// TODO: Avoid flatten
+	if (input.GetVectorType() == VectorType::CONSTANT_VECTOR) {
+		count = 1;
+	}
 	input.Flatten(count);
+	FlatVector::SetValidity(result, FlatVector::Validity(input));
 
 	auto ring_vec_in = ListVector::GetEntry(input);
 	auto ring_count = ListVector::GetListSize(input);
@@ -129,8 +138,11 @@ static void BoxFlipCoordinatesFunction(DataChunk &args, ExpressionState &state,
 	auto input = args.data[0];
 	auto count = args.size();
 
-	// TODO: Avoid flatten
+	if (input.GetVectorType() == VectorType::CONSTANT_VECTOR) {
+		count = 1;
+	}
 	input.Flatten(count);
+	FlatVector::SetValidity(result, FlatVector::Validity(input));
 
 	auto &children_in = StructVector::GetEntries(input);
 	auto min_x_in = FlatVector::GetData<double>(*children_in[0]);
@@ -148,73 +160,24 @@ static void BoxFlipCoordinatesFunction(DataChunk &args, ExpressionState &state,
 	memcpy(min_y_out, min_x_in, count * sizeof(double));
 	memcpy(max_x_out, max_y_in, count * sizeof(double));
 	memcpy(max_y_out, max_x_in, count * sizeof(double));
+
+	if (count == 1) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
 }
 
 //------------------------------------------------------------------------------
 // GEOMETRY
 //------------------------------------------------------------------------------
 
-struct FlipOp {
-	static void FlipVertexArray(VertexArray &vertices, ArenaAllocator &arena) {
-		vertices.MakeOwning(arena);
-		for (idx_t i = 0; i < vertices.Count(); i++) {
-			auto vertex = vertices.Get(i);
-			std::swap(vertex.x, vertex.y);
-			vertices.Set(i, vertex);
-		}
-	}
-
-	static void Apply(Point &point, ArenaAllocator &alloc) {
-		FlipVertexArray(point.Vertices(), alloc);
-	}
-
-	static void Apply(LineString &line, ArenaAllocator &alloc) {
-		FlipVertexArray(line.Vertices(), alloc);
-	}
-
-	static void Apply(Polygon &poly, ArenaAllocator &alloc) {
-		for (auto &ring : poly) {
-			FlipVertexArray(ring, alloc);
-		}
-	}
-
-	static void Apply(MultiPoint &multi_point, ArenaAllocator &alloc) {
-		for (auto &point : multi_point) {
-			Apply(point, alloc);
-		}
-	}
-
-	static void Apply(MultiLineString &multi_line, ArenaAllocator &alloc) {
-		for (auto &line : multi_line) {
-			Apply(line, alloc);
-		}
-	}
-
-	static void Apply(MultiPolygon &multi_poly, ArenaAllocator &alloc) {
-		for (auto &poly : multi_poly) {
-			Apply(poly, alloc);
-		}
-	}
-
-	static void Apply(GeometryCollection &geom, ArenaAllocator &alloc) {
-		for (auto &child : geom) {
-			child.Dispatch<FlipOp>(alloc);
-		}
-	}
-};
-
+// The serialized blob is copied and the coordinates are swapped in the copy, the structure of the geometry is never
+// materialized
 static void GeometryFlipCoordinatesFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-
-	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
-
 	auto input = args.data[0];
 	auto count = args.size();
 
-	UnaryExecutor::Execute<geometry_t, geometry_t>(input, result, count, [&](geometry_t input) {
-		auto props = input.GetProperties();
-		auto geom = lstate.factory.Deserialize(input);
-		geom.Dispatch<FlipOp>(lstate.factory.allocator);
-		return lstate.factory.Serialize(result, geom, props.HasZ(), props.HasM());
+	GeometryExecutor::ExecuteUnary<geometry_t, geometry_t>(input, result, count, [&](geometry_t input) {
+		return GeometryFactory::SerializedFlipCoordinates(result, input);
 	});
 }
 
@@ -230,9 +193,8 @@ void CoreScalarFunctions::RegisterStFlipCoordinates(DatabaseInstance &db) {
 	flip_function_set.AddFunction(
 	    ScalarFunction({GeoTypes::POLYGON_2D()}, GeoTypes::POLYGON_2D(), PolygonFlipCoordinatesFunction));
 	flip_function_set.AddFunction(ScalarFunction({GeoTypes::BOX_2D()}, GeoTypes::BOX_2D(), BoxFlipCoordinatesFunction));
-	flip_function_set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY()}, GeoTypes::GEOMETRY(),
-	                                             GeometryFlipCoordinatesFunction, nullptr, nullptr, nullptr,
-	                                             GeometryFunctionLocalState::Init));
+	flip_function_set.AddFunction(
+	    ScalarFunction({GeoTypes::GEOMETRY()}, GeoTypes::GEOMETRY(), GeometryFlipCoordinatesFunction));
 
 	ExtensionUtil::RegisterFunction(db, flip_function_set);
 }
@@ -11,89 +11,45 @@ namespace spatial {
 
 namespace core {
 
-struct UpdateDimensionFunctor {
-	static void Apply(Point &point, bool has_z, bool has_m, double default_z, double default_m, ArenaAllocator &arena) {
-		point.Vertices().SetVertexType(arena, has_z, has_m, default_z, default_m);
-	}
-
-	static void Apply(MultiPoint &mpoint, bool has_z, bool has_m, double default_z, double default_m,
-	                  ArenaAllocator &arena) {
-		for (auto &point : mpoint) {
-			point.Vertices().SetVertexType(arena, has_z, has_m, default_z, default_m);
-		}
-	}
-
-	static void Apply(LineString &line, bool has_z, bool has_m, double default_z, double default_m,
-	                  ArenaAllocator &arena) {
-		line.Vertices().SetVertexType(arena, has_z, has_m, default_z, default_m);
-	}
-
-	static void Apply(MultiLineString &mline, bool has_z, bool has_m, double default_z, double default_m,
-	                  ArenaAllocator &arena) {
-		for (auto &line : mline) {
-			line.Vertices().SetVertexType(arena, has_z, has_m, default_z, default_m);
-		}
-	}
-
-	static void Apply(Polygon &polygon, bool has_z, bool has_m, double default_z, double default_m,
-	                  ArenaAllocator &arena) {
-		for (auto &ring : polygon) {
-			ring.SetVertexType(arena, has_z, has_m, default_z, default_m);
-		}
-	}
-
-	static void Apply(MultiPolygon &mpolygon, bool has_z, bool has_m, double default_z, double default_m,
-	                  ArenaAllocator &arena) {
-		for (auto &polygon : mpolygon) {
-			for (auto &ring : polygon) {
-				ring.SetVertexType(arena, has_z, has_m, default_z, default_m);
-			}
-		}
-	}
-
-	static void Apply(GeometryCollection &collection, bool has_z, bool has_m, double default_z, double default_m,
-	                  ArenaAllocator &arena) {
-		for (auto &child : collection) {
-			child.Dispatch<UpdateDimensionFunctor>(has_z, has_m, default_z, default_m, arena);
-		}
-	}
-};
-
 //------------------------------------------------------------------------------
 // GEOMETRY
 //------------------------------------------------------------------------------
+// Z and M are added or dropped by rewriting the vertices of the serialized blob, the structure of the geometry is
+// never materialized. With constant defaults (the common case), dictionary inputs are only rewritten once per entry.
 template <bool HAS_Z, bool HAS_M>
 static void GeometryFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
-	auto &arena = lstate.factory.allocator;
 	auto count = args.size();
 	auto &input = args.data[0];
 
-	if (HAS_Z && HAS_M) {
-		auto &z_values = args.data[1];
-		auto &m_values = args.data[2];
+	auto all_defaults_constant = true;
+	for (idx_t i = 1; i < args.ColumnCount(); i++) {
+		all_defaults_constant &= args.data[i].GetVectorType() == VectorType::CONSTANT_VECTOR;
+	}
+
+	if (all_defaults_constant) {
+		for (idx_t i = 1; i < args.ColumnCount(); i++) {
+			if (ConstantVector::IsNull(args.data[i])) {
+				result.SetVectorType(VectorType::CONSTANT_VECTOR);
+				ConstantVector::SetNull(result, true);
+				return;
+			}
+		}
+		auto default_z = HAS_Z ? *ConstantVector::GetData<double>(args.data[1]) : 0;
+		auto default_m = HAS_M ? *ConstantVector::GetData<double>(args.data[HAS_Z ? 2 : 1]) : 0;
+		GeometryExecutor::ExecuteUnary<geometry_t, geometry_t>(input, result, count, [&](geometry_t blob) {
+			return GeometryFactory::SerializedSetVertexType(result, blob, HAS_Z, HAS_M, default_z, default_m);
+		});
+	} else if (HAS_Z && HAS_M) {
 		TernaryExecutor::Execute<geometry_t, double, double, geometry_t>(
-		    input, z_values, m_values, result, count, [&](const geometry_t &blob, double default_z, double default_m) {
-			    auto geometry = lstate.factory.Deserialize(blob);
-			    geometry.Dispatch<UpdateDimensionFunctor>(HAS_Z, HAS_M, default_z, default_m, arena);
-			    return lstate.factory.Serialize(result, geometry, HAS_Z, HAS_M);
+		    input, args.data[1], args.data[2], result, count, [&](geometry_t blob, double default_z, double default_m) {
+			    return GeometryFactory::SerializedSetVertexType(result, blob, HAS_Z, HAS_M, default_z, default_m);
 		    });
-
-	} else if (HAS_Z || HAS_M) {
-		auto &z_values = args.data[1];
+	} else {
 		BinaryExecutor::Execute<geometry_t, double, geometry_t>(
-		    input, z_values, result, count, [&](const geometry_t &blob, double default_value) {
-			    auto geometry = lstate.factory.Deserialize(blob);
-			    geometry.Dispatch<UpdateDimensionFunctor>(HAS_Z, HAS_M, HAS_Z ? default_value : 0,
-			                                              HAS_M ? default_value : 0, arena);
-			    return lstate.factory.Serialize(result, geometry, HAS_Z, HAS_M);
+		    input, args.data[1], result, count, [&](geometry_t blob, double default_value) {
+			    return GeometryFactory::SerializedSetVertexType(result, blob, HAS_Z, HAS_M, HAS_Z ? default_value : 0,
+			                                                    HAS_M ? default_value : 0);
 		    });
-	} else {
-		UnaryExecutor::Execute<geometry_t, geometry_t>(input, result, count, [&](const geometry_t &blob) {
-			auto geometry = lstate.factory.Deserialize(blob);
-			geometry.Dispatch<UpdateDimensionFunctor>(HAS_Z, HAS_M, 0, 0, arena);
-			return lstate.factory.Serialize(result, geometry, HAS_Z, HAS_M);
-		});
 	}
 }
 
@@ -102,17 +58,13 @@ static void GeometryFunction(DataChunk &args, ExpressionState &state, Vector &re
 //------------------------------------------------------------------------------
 void CoreScalarFunctions::RegisterStForce(DatabaseInstance &db) {
 	ScalarFunction st_force2d("ST_Force2D", {GeoTypes::GEOMETRY()}, GeoTypes::GEOMETRY(),
-	                          GeometryFunction<false, false>, nullptr, nullptr, nullptr,
-	                          GeometryFunctionLocalState::Init);
+	                          GeometryFunction<false, false>);
 	ScalarFunction st_force3dz("ST_Force3DZ", {GeoTypes::GEOMETRY(), LogicalType::DOUBLE}, GeoTypes::GEOMETRY(),
-	                           GeometryFunction<true, false>, nullptr, nullptr, nullptr,
-	                           GeometryFunctionLocalState::Init);
+	                           GeometryFunction<true, false>);
 	ScalarFunction st_force3dm("ST_Force3DM", {GeoTypes::GEOMETRY(), LogicalType::DOUBLE}, GeoTypes::GEOMETRY(),
-	                           GeometryFunction<false, true>, nullptr, nullptr, nullptr,
-	                           GeometryFunctionLocalState::Init);
+	                           GeometryFunction<false, true>);
 	ScalarFunction st_force4d("ST_Force4D", {GeoTypes::GEOMETRY(), LogicalType::DOUBLE, LogicalType::DOUBLE},
-	                          GeoTypes::GEOMETRY(), GeometryFunction<true, true>, nullptr, nullptr, nullptr,
-	                          GeometryFunctionLocalState::Init);
+	                          GeoTypes::GEOMETRY(), GeometryFunction<true, true>);
 
 	ExtensionUtil::RegisterFunction(db, st_force2d);
 	ExtensionUtil::RegisterFunction(db, st_force3dz);
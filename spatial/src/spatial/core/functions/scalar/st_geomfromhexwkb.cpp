@@ -1,7 +1,6 @@
 #include "duckdb/common/vector_operations/generic_executor.hpp"
 #include "duckdb/common/vector_operations/unary_executor.hpp"
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
-#include "duckdb/common/types/blob.hpp"
 
 #include "spatial/common.hpp"
 #include "spatial/core/functions/scalar.hpp"
@@ -10,6 +9,7 @@
 #include "spatial/core/types.hpp"
 #include "spatial/core/geometry/wkb_writer.hpp"
 #include "spatial/core/geometry/wkb_reader.hpp"
+#include "spatial/core/geometry/hex_codec.hpp"
 
 namespace spatial {
 
@@ -27,30 +27,19 @@ void GeometryFromHEXWKB(DataChunk &args, ExpressionState &state, Vector &result)
 	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
 	WKBReader reader(lstate.factory.allocator);
 
+	// The WKB of every row is decoded into the same buffer
+	vector<data_t> buffer;
 	UnaryExecutor::Execute<string_t, geometry_t>(input, result, count, [&](string_t input_hex) {
 		auto hex_size = input_hex.GetSize();
-		auto hex_ptr = const_data_ptr_cast(input_hex.GetData());
-
 		if (hex_size % 2 == 1) {
 			throw InvalidInputException("Invalid HEX WKB string, length must be even.");
 		}
-
 		auto blob_size = hex_size / 2;
-
-		unique_ptr<data_t[]> wkb_blob(new data_t[blob_size]);
-		auto blob_ptr = wkb_blob.get();
-		auto blob_idx = 0;
-		for (idx_t hex_idx = 0; hex_idx < hex_size; hex_idx += 2) {
-			auto byte_a = Blob::HEX_MAP[hex_ptr[hex_idx]];
-			auto byte_b = Blob::HEX_MAP[hex_ptr[hex_idx + 1]];
-			D_ASSERT(byte_a != -1);
-			D_ASSERT(byte_b != -1);
-
-			blob_ptr[blob_idx++] = (byte_a << 4) + byte_b;
+		buffer.resize(blob_size);
+		if (!HexCodec::Decode(input_hex.GetData(), blob_size, buffer.data())) {
+			throw InvalidInputException("Invalid HEX WKB string, it contains a character that is not a hex digit.");
 		}
-
-		auto geom = reader.Deserialize(blob_ptr, blob_size);
-		return lstate.factory.Serialize(result, geom, reader.GeomHasZ(), reader.GeomHasM());
+		return reader.Transcode(result, buffer.data(), blob_size, lstate.factory.double_bbox);
 	});
 }
 
@@ -28,7 +28,6 @@ public:
 	}
 };
 
-// TODO: we should implement our own WKT parser asap. This is a temporary and really inefficient solution.
 // TODO: Ignore_invalid doesnt make sense here, we should just use a try_cast instead.
 static void GeometryFromWKTFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto count = args.size();
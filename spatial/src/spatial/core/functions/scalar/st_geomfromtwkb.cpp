@@ -0,0 +1,41 @@
+#include "duckdb/common/vector_operations/unary_executor.hpp"
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include "spatial/common.hpp"
+#include "spatial/core/functions/scalar.hpp"
+#include "spatial/core/functions/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/twkb_reader.hpp"
+#include "spatial/core/types.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// GEOMETRY
+//------------------------------------------------------------------------------
+static void GeometryFromTWKBFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
+	auto &input = args.data[0];
+	auto count = args.size();
+
+	TWKBReader reader(lstate.factory.allocator);
+	UnaryExecutor::Execute<string_t, geometry_t>(input, result, count, [&](string_t input) {
+		auto geom = reader.Deserialize(input);
+		return lstate.factory.Serialize(result, geom, reader.GeomHasZ(), reader.GeomHasM());
+	});
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterStGeomFromTWKB(DatabaseInstance &db) {
+	ScalarFunctionSet st_geom_from_twkb("ST_GeomFromTWKB");
+	st_geom_from_twkb.AddFunction(ScalarFunction({LogicalType::BLOB}, GeoTypes::GEOMETRY(), GeometryFromTWKBFunction,
+	                                             nullptr, nullptr, nullptr, GeometryFunctionLocalState::Init));
+	ExtensionUtil::RegisterFunction(db, st_geom_from_twkb);
+}
+
+} // namespace core
+
+} // namespace spatial
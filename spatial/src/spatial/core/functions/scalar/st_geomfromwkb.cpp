@@ -273,8 +273,7 @@ static void GeometryFromWKBFunction(DataChunk &args, ExpressionState &state, Vec
 
 	WKBReader reader(lstate.factory.allocator);
 	UnaryExecutor::Execute<string_t, geometry_t>(input, result, count, [&](string_t input) {
-		auto geometry = reader.Deserialize(input);
-		return lstate.factory.Serialize(result, geometry, reader.GeomHasZ(), reader.GeomHasM());
+		return reader.Transcode(result, input, lstate.factory.double_bbox);
 	});
 }
 
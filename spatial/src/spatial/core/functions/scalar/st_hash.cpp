@@ -0,0 +1,34 @@
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include "spatial/common.hpp"
+#include "spatial/core/functions/scalar.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/types.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// GEOMETRY
+//------------------------------------------------------------------------------
+// Hashes the vertices and the structure of the geometry straight from the blob, leaving out the bounding box and the
+// properties in the header, which can differ between copies of the same geometry (e.g. after ST_MakeValid, or with
+// a double precision bounding box).
+static void GeometryHashFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	UnaryExecutor::Execute<geometry_t, uint64_t>(args.data[0], result, args.size(), [&](geometry_t input) {
+		return static_cast<uint64_t>(GeometryFactory::SerializedHash(input));
+	});
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterStHash(DatabaseInstance &db) {
+	ScalarFunctionSet set("ST_Hash");
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY()}, LogicalType::UBIGINT, GeometryHashFunction));
+	ExtensionUtil::RegisterFunction(db, set);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,54 @@
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/functions/scalar.hpp"
+#include "spatial/core/functions/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include "duckdb/common/vector_operations/unary_executor.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// GEOMETRY
+//------------------------------------------------------------------------------
+// The Z and M flags are part of the properties in the inlined prefix of the blob, so the geometry is never read
+static void HasZFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	UnaryExecutor::Execute<geometry_t, bool>(args.data[0], result, args.size(),
+	                                         [](geometry_t input) { return input.GetProperties().HasZ(); });
+}
+
+static void HasMFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	UnaryExecutor::Execute<geometry_t, bool>(args.data[0], result, args.size(),
+	                                         [](geometry_t input) { return input.GetProperties().HasM(); });
+}
+
+//------------------------------------------------------------------------------
+// POINT_2D, LINESTRING_2D, POLYGON_2D
+//------------------------------------------------------------------------------
+static void ConstantFalseFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	*ConstantVector::GetData<bool>(result) = false;
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterStHasZM(DatabaseInstance &db) {
+	ScalarFunctionSet has_z("ST_HasZ");
+	ScalarFunctionSet has_m("ST_HasM");
+	for (auto &type : {GeoTypes::POINT_2D(), GeoTypes::LINESTRING_2D(), GeoTypes::POLYGON_2D()}) {
+		has_z.AddFunction(ScalarFunction({type}, LogicalType::BOOLEAN, ConstantFalseFunction));
+		has_m.AddFunction(ScalarFunction({type}, LogicalType::BOOLEAN, ConstantFalseFunction));
+	}
+	has_z.AddFunction(ScalarFunction({GeoTypes::GEOMETRY()}, LogicalType::BOOLEAN, HasZFunction));
+	has_m.AddFunction(ScalarFunction({GeoTypes::GEOMETRY()}, LogicalType::BOOLEAN, HasMFunction));
+	ExtensionUtil::RegisterFunction(db, has_z);
+	ExtensionUtil::RegisterFunction(db, has_m);
+}
+
+} // namespace core
+
+} // namespace spatial
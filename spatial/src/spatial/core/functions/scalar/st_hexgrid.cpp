@@ -0,0 +1,348 @@
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include "duckdb/common/vector_operations/generic_executor.hpp"
+#include "spatial/common.hpp"
+#include "spatial/core/functions/scalar.hpp"
+#include "spatial/core/functions/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/point_in_polygon.hpp"
+#include "spatial/core/types.hpp"
+
+#include <cmath>
+
+namespace spatial {
+
+namespace core {
+
+// A grid of pointy-top hexagons in the plane of the input coordinates, with a cell centred on the origin. size is the
+// distance from the centre of a cell to its corners. Cells are addressed by their axial coordinates (q, r), packed
+// into a single UBIGINT with q in the high and r in the low 32 bits, so that cell ids group and join as plain integers.
+struct HexGrid {
+	static constexpr double SQRT_3 = 1.7320508075688772;
+	// Polyfill refuses to produce more cells than this for a single geometry
+	static constexpr idx_t MAX_POLYFILL_CELLS = 10000000;
+
+	static uint64_t Pack(int64_t q, int64_t r) {
+		return (static_cast<uint64_t>(static_cast<uint32_t>(q)) << 32) | static_cast<uint32_t>(r);
+	}
+
+	static void Unpack(uint64_t cell, int64_t &q, int64_t &r) {
+		q = static_cast<int32_t>(static_cast<uint32_t>(cell >> 32));
+		r = static_cast<int32_t>(static_cast<uint32_t>(cell));
+	}
+
+	static void Center(int64_t q, int64_t r, double size, double &x, double &y) {
+		x = size * SQRT_3 * (static_cast<double>(q) + static_cast<double>(r) / 2);
+		y = size * 1.5 * static_cast<double>(r);
+	}
+
+	// Fractional axial coordinates of a point, rounded to the cell containing it in cube coordinates: the rounded
+	// component that moved the most is recomputed from the other two.
+	static inline void Locate(double x, double y, double size, double &q, double &r) {
+		auto fq = (SQRT_3 / 3 * x - y / 3) / size;
+		auto fr = (2.0 / 3 * y) / size;
+		auto fs = -fq - fr;
+		auto rq = std::round(fq);
+		auto rr = std::round(fr);
+		auto rs = std::round(fs);
+		auto dq = std::abs(rq - fq);
+		auto dr = std::abs(rr - fr);
+		auto ds = std::abs(rs - fs);
+		auto fix_q = dq > dr && dq > ds;
+		auto fix_r = !fix_q && dr > ds;
+		q = fix_q ? -rr - rs : rq;
+		r = fix_r ? -rq - rs : rr;
+	}
+
+	static void CheckSize(const char *name, double size) {
+		if (!(size > 0) || !std::isfinite(size)) {
+			throw InvalidInputException("%s: Cell size must be a positive, finite number", name);
+		}
+	}
+
+	static void CheckRange(const char *name, double q, double r) {
+		auto min = static_cast<double>(NumericLimits<int32_t>::Minimum());
+		auto max = static_cast<double>(NumericLimits<int32_t>::Maximum());
+		if (!(q >= min && q <= max && r >= min && r <= max)) {
+			throw InvalidInputException("%s: Coordinate is too far from the origin for the cell size", name);
+		}
+	}
+};
+
+//------------------------------------------------------------------------------
+// ST_HexCell
+//------------------------------------------------------------------------------
+// Locate all rows in one branch-free pass, then check the range and pack the ids
+static void LocateCells(const double *x, const double *y, Vector &size_vec, ValidityMask &validity, Vector &result,
+                        idx_t count) {
+	UnifiedVectorFormat size_format;
+	size_vec.ToUnifiedFormat(count, size_format);
+	auto size_data = UnifiedVectorFormat::GetData<double>(size_format);
+
+	// Invalid rows get a size of 1, so that they can go through the same loops
+	auto size = make_unsafe_uniq_array<double>(count);
+	for (idx_t i = 0; i < count; i++) {
+		auto size_idx = size_format.sel->get_index(i);
+		if (!size_format.validity.RowIsValid(size_idx)) {
+			validity.SetInvalid(i);
+		}
+		if (!validity.RowIsValid(i)) {
+			size[i] = 1;
+			continue;
+		}
+		HexGrid::CheckSize("ST_HexCell", size_data[size_idx]);
+		size[i] = size_data[size_idx];
+	}
+
+	auto q = make_unsafe_uniq_array<double>(count);
+	auto r = make_unsafe_uniq_array<double>(count);
+	for (idx_t i = 0; i < count; i++) {
+		HexGrid::Locate(x[i], y[i], size[i], q[i], r[i]);
+	}
+
+	auto result_data = FlatVector::GetData<uint64_t>(result);
+	for (idx_t i = 0; i < count; i++) {
+		if (!validity.RowIsValid(i)) {
+			continue;
+		}
+		HexGrid::CheckRange("ST_HexCell", q[i], r[i]);
+		result_data[i] = HexGrid::Pack(static_cast<int64_t>(q[i]), static_cast<int64_t>(r[i]));
+	}
+}
+
+static void Point2DHexCellFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &point_vec = args.data[0];
+	auto &size_vec = args.data[1];
+	auto count = args.size();
+	auto is_constant = args.AllConstant();
+	if (is_constant) {
+		count = 1;
+	}
+	point_vec.Flatten(count);
+
+	auto &children = StructVector::GetEntries(point_vec);
+	auto x_data = FlatVector::GetData<double>(*children[0]);
+	auto y_data = FlatVector::GetData<double>(*children[1]);
+
+	auto &validity = FlatVector::Validity(result);
+	validity.Copy(FlatVector::Validity(point_vec), count);
+	LocateCells(x_data, y_data, size_vec, validity, result, count);
+
+	if (is_constant) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
+}
+
+// Points are binned by their coordinates, other geometries by the centre of the bounding box in their header
+static void GeometryHexCellFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &geom_vec = args.data[0];
+	auto &size_vec = args.data[1];
+	auto count = args.size();
+	auto is_constant = args.AllConstant();
+	if (is_constant) {
+		count = 1;
+	}
+
+	UnifiedVectorFormat geom_format;
+	geom_vec.ToUnifiedFormat(count, geom_format);
+	auto geom_data = UnifiedVectorFormat::GetData<geometry_t>(geom_format);
+
+	auto &validity = FlatVector::Validity(result);
+	auto x = make_unsafe_uniq_array<double>(count);
+	auto y = make_unsafe_uniq_array<double>(count);
+	BoundingBox bbox;
+	for (idx_t i = 0; i < count; i++) {
+		auto geom_idx = geom_format.sel->get_index(i);
+		x[i] = 0;
+		y[i] = 0;
+		if (!geom_format.validity.RowIsValid(geom_idx)) {
+			validity.SetInvalid(i);
+			continue;
+		}
+		auto &geom = geom_data[geom_idx];
+		if (GeometryFactory::TryGetSerializedPoint(geom, x[i], y[i])) {
+			continue;
+		}
+		if (GeometryFactory::TryGetSerializedBoundingBox(geom, bbox)) {
+			x[i] = bbox.minx + (bbox.maxx - bbox.minx) / 2;
+			y[i] = bbox.miny + (bbox.maxy - bbox.miny) / 2;
+			continue;
+		}
+		// Empty geometries are not in any cell
+		validity.SetInvalid(i);
+	}
+	LocateCells(x.get(), y.get(), size_vec, validity, result, count);
+
+	if (is_constant) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
+}
+
+//------------------------------------------------------------------------------
+// ST_HexCenter / ST_HexBoundary
+//------------------------------------------------------------------------------
+static void HexCenterFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	using CELL_TYPE = PrimitiveType<uint64_t>;
+	using SIZE_TYPE = PrimitiveType<double>;
+	using POINT_TYPE = StructTypeBinary<double, double>;
+
+	GenericExecutor::ExecuteBinary<CELL_TYPE, SIZE_TYPE, POINT_TYPE>(
+	    args.data[0], args.data[1], result, args.size(), [&](CELL_TYPE cell, SIZE_TYPE size) {
+		    HexGrid::CheckSize("ST_HexCenter", size.val);
+		    int64_t q;
+		    int64_t r;
+		    HexGrid::Unpack(cell.val, q, r);
+		    double x;
+		    double y;
+		    HexGrid::Center(q, r, size.val, x, y);
+		    return POINT_TYPE {x, y};
+	    });
+}
+
+static void HexBoundaryFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
+	auto &arena = lstate.factory.allocator;
+
+	BinaryExecutor::Execute<uint64_t, double, geometry_t>(
+	    args.data[0], args.data[1], result, args.size(), [&](uint64_t cell, double size) {
+		    HexGrid::CheckSize("ST_HexBoundary", size);
+		    int64_t q;
+		    int64_t r;
+		    HexGrid::Unpack(cell, q, r);
+		    double cx;
+		    double cy;
+		    HexGrid::Center(q, r, size, cx, cy);
+
+		    // Pointy-top corners, counter-clockwise starting at the lower right
+		    static constexpr double CORNER_X[6] = {HexGrid::SQRT_3 / 2, HexGrid::SQRT_3 / 2, 0,
+		                                           -HexGrid::SQRT_3 / 2, -HexGrid::SQRT_3 / 2, 0};
+		    static constexpr double CORNER_Y[6] = {-0.5, 0.5, 1, 0.5, -0.5, -1};
+		    uint32_t capacity = 7;
+		    Polygon hexagon(arena, 1, &capacity, false, false);
+		    auto &shell = hexagon[0];
+		    for (idx_t i = 0; i < 6; i++) {
+			    shell.Set(i, cx + size * CORNER_X[i], cy + size * CORNER_Y[i]);
+		    }
+		    shell.Set(6, cx + size * CORNER_X[0], cy + size * CORNER_Y[0]);
+		    return lstate.factory.Serialize(result, hexagon, false, false);
+	    });
+}
+
+//------------------------------------------------------------------------------
+// ST_HexKRing
+//------------------------------------------------------------------------------
+// All cells within k steps of the cell, the cell itself included, ordered by q and then r
+static void HexKRingFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &cell_entries = ListVector::GetEntry(result);
+	idx_t total_count = 0;
+
+	BinaryExecutor::Execute<uint64_t, int32_t, list_entry_t>(
+	    args.data[0], args.data[1], result, args.size(), [&](uint64_t cell, int32_t k) {
+		    if (k < 0 || k > 1000) {
+			    throw InvalidInputException("ST_HexKRing: k must be between 0 and 1000");
+		    }
+		    int64_t q;
+		    int64_t r;
+		    HexGrid::Unpack(cell, q, r);
+
+		    auto ring_count = static_cast<idx_t>(3 * k * (k + 1) + 1);
+		    list_entry_t entry(total_count, ring_count);
+		    ListVector::Reserve(result, total_count + ring_count);
+		    auto cell_data = FlatVector::GetData<uint64_t>(cell_entries);
+		    for (int64_t dq = -k; dq <= k; dq++) {
+			    auto dr_min = std::max<int64_t>(-k, -dq - k);
+			    auto dr_max = std::min<int64_t>(k, -dq + k);
+			    for (int64_t dr = dr_min; dr <= dr_max; dr++) {
+				    // Wraps around at the edges of the id space, like the coordinates would
+				    cell_data[total_count++] = HexGrid::Pack(q + dq, r + dr);
+			    }
+		    }
+		    D_ASSERT(total_count == entry.offset + entry.length);
+		    return entry;
+	    });
+	ListVector::SetListSize(result, total_count);
+}
+
+//------------------------------------------------------------------------------
+// ST_HexPolyfill
+//------------------------------------------------------------------------------
+// The cells whose centre lies in or on the boundary of a (multi)polygon. Other geometries cover no cells.
+static void HexPolyfillFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &cell_entries = ListVector::GetEntry(result);
+	idx_t total_count = 0;
+
+	BinaryExecutor::Execute<geometry_t, double, list_entry_t>(
+	    args.data[0], args.data[1], result, args.size(), [&](geometry_t geom, double size) {
+		    HexGrid::CheckSize("ST_HexPolyfill", size);
+		    list_entry_t entry(total_count, 0);
+		    auto prepared = PreparedPolygon::TryCreate(geom);
+		    if (!prepared) {
+			    return entry;
+		    }
+
+		    // Rows of cells with their centre in the bounding box, then the range of cells of each row likewise
+		    auto &bbox = prepared->GetBoundingBox();
+		    auto row_height = size * 1.5;
+		    auto cell_width = size * HexGrid::SQRT_3;
+		    auto r_min = std::ceil(bbox.miny / row_height);
+		    auto r_max = std::floor(bbox.maxy / row_height);
+		    auto q_span = (bbox.maxx - bbox.minx) / cell_width + 1;
+		    if ((r_max - r_min + 1) * q_span > static_cast<double>(HexGrid::MAX_POLYFILL_CELLS)) {
+			    throw InvalidInputException("ST_HexPolyfill: The geometry covers more than %llu cells",
+			                                static_cast<unsigned long long>(HexGrid::MAX_POLYFILL_CELLS));
+		    }
+		    HexGrid::CheckRange("ST_HexPolyfill", bbox.minx / cell_width - r_max, r_min);
+		    HexGrid::CheckRange("ST_HexPolyfill", bbox.maxx / cell_width - r_min, r_max);
+
+		    for (auto r = static_cast<int64_t>(r_min); r <= static_cast<int64_t>(r_max); r++) {
+			    auto q_min = static_cast<int64_t>(std::ceil(bbox.minx / cell_width - static_cast<double>(r) / 2));
+			    auto q_max = static_cast<int64_t>(std::floor(bbox.maxx / cell_width - static_cast<double>(r) / 2));
+			    for (auto q = q_min; q <= q_max; q++) {
+				    double x;
+				    double y;
+				    HexGrid::Center(q, r, size, x, y);
+				    if (prepared->Locate(x, y) == PointLocation::EXTERIOR) {
+					    continue;
+				    }
+				    ListVector::Reserve(result, total_count + 1);
+				    FlatVector::GetData<uint64_t>(cell_entries)[total_count++] = HexGrid::Pack(q, r);
+			    }
+		    }
+		    entry.length = total_count - entry.offset;
+		    return entry;
+	    });
+	ListVector::SetListSize(result, total_count);
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterStHexGrid(DatabaseInstance &db) {
+
+	ScalarFunctionSet hex_cell("ST_HexCell");
+	hex_cell.AddFunction(ScalarFunction({GeoTypes::POINT_2D(), LogicalType::DOUBLE}, LogicalType::UBIGINT,
+	                                    Point2DHexCellFunction));
+	hex_cell.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), LogicalType::DOUBLE}, LogicalType::UBIGINT,
+	                                    GeometryHexCellFunction));
+	ExtensionUtil::RegisterFunction(db, hex_cell);
+
+	ScalarFunction hex_center("ST_HexCenter", {LogicalType::UBIGINT, LogicalType::DOUBLE}, GeoTypes::POINT_2D(),
+	                          HexCenterFunction);
+	ExtensionUtil::RegisterFunction(db, hex_center);
+
+	ScalarFunction hex_boundary("ST_HexBoundary", {LogicalType::UBIGINT, LogicalType::DOUBLE}, GeoTypes::GEOMETRY(),
+	                            HexBoundaryFunction, nullptr, nullptr, nullptr, GeometryFunctionLocalState::Init);
+	ExtensionUtil::RegisterFunction(db, hex_boundary);
+
+	ScalarFunction hex_kring("ST_HexKRing", {LogicalType::UBIGINT, LogicalType::INTEGER},
+	                         LogicalType::LIST(LogicalType::UBIGINT), HexKRingFunction);
+	ExtensionUtil::RegisterFunction(db, hex_kring);
+
+	ScalarFunction hex_polyfill("ST_HexPolyfill", {GeoTypes::GEOMETRY(), LogicalType::DOUBLE},
+	                            LogicalType::LIST(LogicalType::UBIGINT), HexPolyfillFunction);
+	ExtensionUtil::RegisterFunction(db, hex_polyfill);
+}
+
+} // namespace core
+
+} // namespace spatial
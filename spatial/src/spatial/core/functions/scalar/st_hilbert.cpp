@@ -0,0 +1,144 @@
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include "spatial/common.hpp"
+#include "spatial/core/functions/scalar.hpp"
+#include "spatial/core/functions/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/space_filling_curve.hpp"
+#include "spatial/core/types.hpp"
+
+namespace spatial {
+
+namespace core {
+
+// Execute the curve over a chunk, get_center(i, x, y) returns the point to encode for row i, or false if the result
+// should be NULL. The bounds are the last (BOX_2D) argument.
+template <class CURVE, class GET_CENTER>
+static void ExecuteCurve(Vector &bounds_vec, Vector &result, idx_t count, GET_CENTER &&get_center) {
+	bounds_vec.Flatten(count);
+	auto &bounds_validity = FlatVector::Validity(bounds_vec);
+	auto &bounds_children = StructVector::GetEntries(bounds_vec);
+	auto min_x_data = FlatVector::GetData<double>(*bounds_children[0]);
+	auto min_y_data = FlatVector::GetData<double>(*bounds_children[1]);
+	auto max_x_data = FlatVector::GetData<double>(*bounds_children[2]);
+	auto max_y_data = FlatVector::GetData<double>(*bounds_children[3]);
+
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto result_data = FlatVector::GetData<uint64_t>(result);
+	auto &result_validity = FlatVector::Validity(result);
+
+	for (idx_t i = 0; i < count; i++) {
+		double x;
+		double y;
+		if (!bounds_validity.RowIsValid(i) || !get_center(i, x, y)) {
+			result_validity.SetInvalid(i);
+			continue;
+		}
+		auto cell_x = CurveGrid::GetCell(x, min_x_data[i], max_x_data[i]);
+		auto cell_y = CurveGrid::GetCell(y, min_y_data[i], max_y_data[i]);
+		result_data[i] = CURVE::Encode(cell_x, cell_y);
+	}
+
+	if (count == 1) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
+}
+
+//------------------------------------------------------------------------------
+// POINT_2D
+//------------------------------------------------------------------------------
+template <class CURVE>
+static void Point2DCurveFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto count = args.size();
+	auto &point_vec = args.data[0];
+	point_vec.Flatten(count);
+	auto &point_validity = FlatVector::Validity(point_vec);
+	auto &point_children = StructVector::GetEntries(point_vec);
+	auto x_data = FlatVector::GetData<double>(*point_children[0]);
+	auto y_data = FlatVector::GetData<double>(*point_children[1]);
+
+	ExecuteCurve<CURVE>(args.data[1], result, count, [&](idx_t i, double &x, double &y) {
+		if (!point_validity.RowIsValid(i)) {
+			return false;
+		}
+		x = x_data[i];
+		y = y_data[i];
+		return true;
+	});
+}
+
+//------------------------------------------------------------------------------
+// BOX_2D
+//------------------------------------------------------------------------------
+template <class CURVE>
+static void Box2DCurveFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto count = args.size();
+	auto &box_vec = args.data[0];
+	box_vec.Flatten(count);
+	auto &box_validity = FlatVector::Validity(box_vec);
+	auto &box_children = StructVector::GetEntries(box_vec);
+	auto min_x_data = FlatVector::GetData<double>(*box_children[0]);
+	auto min_y_data = FlatVector::GetData<double>(*box_children[1]);
+	auto max_x_data = FlatVector::GetData<double>(*box_children[2]);
+	auto max_y_data = FlatVector::GetData<double>(*box_children[3]);
+
+	ExecuteCurve<CURVE>(args.data[1], result, count, [&](idx_t i, double &x, double &y) {
+		if (!box_validity.RowIsValid(i)) {
+			return false;
+		}
+		x = min_x_data[i] + (max_x_data[i] - min_x_data[i]) / 2;
+		y = min_y_data[i] + (max_y_data[i] - min_y_data[i]) / 2;
+		return true;
+	});
+}
+
+//------------------------------------------------------------------------------
+// GEOMETRY
+//------------------------------------------------------------------------------
+// Only the bounding box in the header is read, the geometry is never deserialized.
+template <class CURVE>
+static void GeometryCurveFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto count = args.size();
+	UnifiedVectorFormat geom_format;
+	args.data[0].ToUnifiedFormat(count, geom_format);
+	auto geom_data = UnifiedVectorFormat::GetData<geometry_t>(geom_format);
+
+	ExecuteCurve<CURVE>(args.data[1], result, count, [&](idx_t i, double &x, double &y) {
+		auto idx = geom_format.sel->get_index(i);
+		if (!geom_format.validity.RowIsValid(idx)) {
+			return false;
+		}
+		BoundingBox bbox;
+		if (!GeometryFactory::TryGetSerializedBoundingBox(geom_data[idx], bbox)) {
+			// Empty geometry
+			return false;
+		}
+		x = bbox.minx + (bbox.maxx - bbox.minx) / 2;
+		y = bbox.miny + (bbox.maxy - bbox.miny) / 2;
+		return true;
+	});
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+template <class CURVE>
+static ScalarFunctionSet GetCurveFunctionSet(const string &name) {
+	ScalarFunctionSet set(name);
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), GeoTypes::BOX_2D()}, LogicalType::UBIGINT,
+	                               GeometryCurveFunction<CURVE>));
+	set.AddFunction(
+	    ScalarFunction({GeoTypes::POINT_2D(), GeoTypes::BOX_2D()}, LogicalType::UBIGINT, Point2DCurveFunction<CURVE>));
+	set.AddFunction(
+	    ScalarFunction({GeoTypes::BOX_2D(), GeoTypes::BOX_2D()}, LogicalType::UBIGINT, Box2DCurveFunction<CURVE>));
+	return set;
+}
+
+void CoreScalarFunctions::RegisterStHilbert(DatabaseInstance &db) {
+	ExtensionUtil::RegisterFunction(db, GetCurveFunctionSet<HilbertCurve>("ST_Hilbert"));
+	ExtensionUtil::RegisterFunction(db, GetCurveFunctionSet<MortonCurve>("ST_Morton"));
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -3,7 +3,7 @@
 #include "spatial/core/functions/scalar.hpp"
 #include "spatial/core/functions/common.hpp"
 #include "spatial/core/geometry/geometry.hpp"
-#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/geometry_processor.hpp"
 #include "spatial/core/types.hpp"
 
 namespace spatial {
@@ -47,16 +47,50 @@ static void PolygonIsEmptyFunction(DataChunk &args, ExpressionState &state, Vect
 //------------------------------------------------------------------------------
 // GEOMETRY
 //------------------------------------------------------------------------------
-static void GeometryIsEmptyFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
+// Every serializer writes a bounding box for all geometries but points that have at least one vertex, so the
+// properties in the inlined prefix of the blob are enough for those. Points and geometries without a bounding box
+// only read their counts, which stops at the first vertex.
+class IsEmptyProcessor final : GeometryProcessor<bool> {
+public:
+	bool Execute(const geometry_t &geom) {
+		if (geom.GetType() != GeometryType::POINT && geom.GetProperties().HasBBox()) {
+			return false;
+		}
+		return Process(geom);
+	}
 
+private:
+	bool ProcessPoint(const VertexData &data) override {
+		return data.IsEmpty();
+	}
+	bool ProcessLineString(const VertexData &data) override {
+		return data.IsEmpty();
+	}
+	bool ProcessPolygon(PolygonState &state) override {
+		while (!state.IsDone()) {
+			if (!state.Next().IsEmpty()) {
+				return false;
+			}
+		}
+		return true;
+	}
+	bool ProcessCollection(CollectionState &state) override {
+		while (!state.IsDone()) {
+			if (!state.Next()) {
+				return false;
+			}
+		}
+		return true;
+	}
+};
+
+static void GeometryIsEmptyFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &input = args.data[0];
 	auto count = args.size();
 
-	UnaryExecutor::Execute<geometry_t, bool>(input, result, count, [&](geometry_t input) {
-		auto geometry = lstate.factory.Deserialize(input);
-		return geometry.IsEmpty();
-	});
+	IsEmptyProcessor processor;
+	UnaryExecutor::Execute<geometry_t, bool>(input, result, count,
+	                                         [&](geometry_t input) { return processor.Execute(input); });
 
 	if (count == 1) {
 		result.SetVectorType(VectorType::CONSTANT_VECTOR);
@@ -74,9 +108,8 @@ void CoreScalarFunctions::RegisterStIsEmpty(DatabaseInstance &db) {
 	    ScalarFunction({GeoTypes::LINESTRING_2D()}, LogicalType::BOOLEAN, LineIsEmptyFunction));
 	is_empty_function_set.AddFunction(
 	    ScalarFunction({GeoTypes::POLYGON_2D()}, LogicalType::BOOLEAN, PolygonIsEmptyFunction));
-	is_empty_function_set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY()}, LogicalType::BOOLEAN,
-	                                                 GeometryIsEmptyFunction, nullptr, nullptr, nullptr,
-	                                                 GeometryFunctionLocalState::Init));
+	is_empty_function_set.AddFunction(
+	    ScalarFunction({GeoTypes::GEOMETRY()}, LogicalType::BOOLEAN, GeometryIsEmptyFunction));
 
 	ExtensionUtil::RegisterFunction(db, is_empty_function_set);
 }
@@ -0,0 +1,26 @@
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include "spatial/common.hpp"
+#include "spatial/core/functions/scalar.hpp"
+#include "spatial/core/types.hpp"
+
+namespace spatial {
+
+namespace core {
+
+// ST_KNN is only a marker for the optimizer, which turns joins on it into k-nearest-neighbour spatial joins.
+// It can not be evaluated row by row since it depends on all the rows of the right side.
+static void KNNFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	throw InvalidInputException("ST_KNN can only be used as the only condition of an inner join, e.g. "
+	                            "'a JOIN b ON ST_KNN(a.geom, b.geom, 5)'");
+}
+
+void CoreScalarFunctions::RegisterStKNN(DatabaseInstance &db) {
+	ScalarFunction knn_func("ST_KNN", {GeoTypes::GEOMETRY(), GeoTypes::GEOMETRY(), LogicalType::INTEGER},
+	                        LogicalType::BOOLEAN, KNNFunction);
+
+	ExtensionUtil::RegisterFunction(db, knn_func);
+}
+
+} // namespace core
+
+} // namespace spatial
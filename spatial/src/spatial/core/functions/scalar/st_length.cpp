@@ -3,7 +3,8 @@
 #include "spatial/core/functions/scalar.hpp"
 #include "spatial/core/functions/common.hpp"
 #include "spatial/core/geometry/geometry.hpp"
-#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/geometry_processor.hpp"
+#include "spatial/core/geometry/vertex_measure.hpp"
 #include "spatial/core/types.hpp"
 
 namespace spatial {
@@ -18,28 +19,66 @@ static void LineLengthFunction(DataChunk &args, ExpressionState &state, Vector &
 
 	auto &line_vec = args.data[0];
 	auto count = args.size();
+	auto is_constant = line_vec.GetVectorType() == VectorType::CONSTANT_VECTOR;
+	if (is_constant) {
+		count = 1;
+	}
+	line_vec.Flatten(count);
 
 	auto &coord_vec = ListVector::GetEntry(line_vec);
 	auto &coord_vec_children = StructVector::GetEntries(coord_vec);
 	auto x_data = FlatVector::GetData<double>(*coord_vec_children[0]);
 	auto y_data = FlatVector::GetData<double>(*coord_vec_children[1]);
 
+	// Measure every segment of the child arrays in one pass, then sum the segments of each line
+	auto vertex_count = ListVector::GetListSize(line_vec);
+	auto segment_lengths = make_unsafe_uniq_array<double>(vertex_count);
+	VertexMeasure::SegmentLengths(x_data, y_data, vertex_count, segment_lengths.get());
+
 	UnaryExecutor::Execute<list_entry_t, double>(line_vec, result, count, [&](list_entry_t line) {
-		auto offset = line.offset;
-		auto length = line.length;
+		return VertexMeasure::SumSegments(segment_lengths.get(), line.offset, line.length);
+	});
+
+	if (is_constant) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
+}
+
+//------------------------------------------------------------------------------
+// MultiLineString2D
+//------------------------------------------------------------------------------
+static void MultiLineLengthFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	D_ASSERT(args.data.size() == 1);
+
+	auto &multi_vec = args.data[0];
+	auto count = args.size();
+	auto is_constant = multi_vec.GetVectorType() == VectorType::CONSTANT_VECTOR;
+	if (is_constant) {
+		count = 1;
+	}
+	multi_vec.Flatten(count);
+
+	auto &line_vec = ListVector::GetEntry(multi_vec);
+	auto line_entries = ListVector::GetData(line_vec);
+	auto &coord_vec = ListVector::GetEntry(line_vec);
+	auto &coord_vec_children = StructVector::GetEntries(coord_vec);
+	auto x_data = FlatVector::GetData<double>(*coord_vec_children[0]);
+	auto y_data = FlatVector::GetData<double>(*coord_vec_children[1]);
+
+	auto vertex_count = ListVector::GetListSize(line_vec);
+	auto segment_lengths = make_unsafe_uniq_array<double>(vertex_count);
+	VertexMeasure::SegmentLengths(x_data, y_data, vertex_count, segment_lengths.get());
+
+	UnaryExecutor::Execute<list_entry_t, double>(multi_vec, result, count, [&](list_entry_t multi) {
 		double sum = 0;
-		// Loop over the segments
-		for (idx_t j = offset; j < offset + length - 1; j++) {
-			auto x1 = x_data[j];
-			auto y1 = y_data[j];
-			auto x2 = x_data[j + 1];
-			auto y2 = y_data[j + 1];
-			sum += std::sqrt(std::pow(x1 - x2, 2) + std::pow(y1 - y2, 2));
+		for (idx_t i = multi.offset; i < multi.offset + multi.length; i++) {
+			auto line = line_entries[i];
+			sum += VertexMeasure::SumSegments(segment_lengths.get(), line.offset, line.length);
 		}
 		return sum;
 	});
 
-	if (count == 1) {
+	if (is_constant) {
 		result.SetVectorType(VectorType::CONSTANT_VECTOR);
 	}
 }
@@ -47,45 +86,57 @@ static void LineLengthFunction(DataChunk &args, ExpressionState &state, Vector &
 //------------------------------------------------------------------------------
 // GEOMETRY
 //------------------------------------------------------------------------------
-static void GeometryLengthFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+// Only the linestrings of a geometry have a length, nested collections within collections are not visited
+class LengthProcessor final : GeometryProcessor<double> {
+	struct LengthOp {
+		template <class V>
+		static double Operation(const VertexData &vertices) {
+			return VertexMeasure::Length<V>(vertices.data[0], vertices.count);
+		}
+	};
 
-	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
+	double ProcessVertices(const VertexData &vertices) const {
+		return DispatchVertexType<LengthOp>(HasZ(), HasM(), vertices);
+	}
 
-	auto &input = args.data[0];
-	auto count = args.size();
+	double ProcessPoint(const VertexData &vertices) override {
+		return 0.0;
+	}
 
-	UnaryExecutor::Execute<geometry_t, double>(input, result, count, [&](geometry_t input) {
-		auto geometry = lstate.factory.Deserialize(input);
-		switch (geometry.Type()) {
-		case GeometryType::LINESTRING:
-			return geometry.As<LineString>().Vertices().Length();
-		case GeometryType::MULTILINESTRING: {
-			double sum = 0.0;
-			for (const auto &line : geometry.As<MultiLineString>()) {
-				sum += line.Vertices().Length();
-			}
-			return sum;
-		}
-		case GeometryType::GEOMETRYCOLLECTION:
-			return geometry.As<GeometryCollection>().Aggregate(
-			    [](const Geometry &geom, double state) {
-				    if (geom.Type() == GeometryType::LINESTRING) {
-					    return state + geom.As<LineString>().Vertices().Length();
-				    } else if (geom.Type() == GeometryType::MULTILINESTRING) {
-					    auto sum = 0.0;
-					    for (const auto &line : geom.As<MultiLineString>()) {
-						    sum += line.Vertices().Length();
-					    }
-					    return state + sum;
-				    } else {
-					    return state;
-				    }
-			    },
-			    0.0);
-		default:
+	double ProcessLineString(const VertexData &vertices) override {
+		return ProcessVertices(vertices);
+	}
+
+	double ProcessPolygon(PolygonState &state) override {
+		return 0.0;
+	}
+
+	double ProcessCollection(CollectionState &state) override {
+		auto visit = CurrentType() == GeometryType::MULTILINESTRING ||
+		             (CurrentType() == GeometryType::GEOMETRYCOLLECTION && !IsNested());
+		if (!visit) {
 			return 0.0;
 		}
-	});
+		double sum = 0.0;
+		while (!state.IsDone()) {
+			sum += state.Next();
+		}
+		return sum;
+	}
+
+public:
+	double Execute(const geometry_t &geometry) {
+		return Process(geometry);
+	}
+};
+
+static void GeometryLengthFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &input = args.data[0];
+	auto count = args.size();
+
+	LengthProcessor processor;
+	UnaryExecutor::Execute<geometry_t, double>(input, result, count,
+	                                           [&](const geometry_t &input) { return processor.Execute(input); });
 
 	if (count == 1) {
 		result.SetVectorType(VectorType::CONSTANT_VECTOR);
@@ -101,8 +152,9 @@ void CoreScalarFunctions::RegisterStLength(DatabaseInstance &db) {
 
 	length_function_set.AddFunction(
 	    ScalarFunction({GeoTypes::LINESTRING_2D()}, LogicalType::DOUBLE, LineLengthFunction));
-	length_function_set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY()}, LogicalType::DOUBLE, GeometryLengthFunction,
-	                                               nullptr, nullptr, nullptr, GeometryFunctionLocalState::Init));
+	length_function_set.AddFunction(
+	    ScalarFunction({GeoTypes::MULTILINESTRING_2D()}, LogicalType::DOUBLE, MultiLineLengthFunction));
+	length_function_set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY()}, LogicalType::DOUBLE, GeometryLengthFunction));
 
 	ExtensionUtil::RegisterFunction(db, length_function_set);
 }
@@ -0,0 +1,363 @@
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/functions/scalar.hpp"
+#include "spatial/core/functions/common.hpp"
+#include "spatial/core/geometry/cursor.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/linear_reference.hpp"
+
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include "duckdb/common/vector_operations/binary_executor.hpp"
+#include "duckdb/common/vector_operations/ternary_executor.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Local State
+//------------------------------------------------------------------------------
+// Keeps the last line loaded, with the length along it to every vertex, so that a constant line is measured once per
+// thread rather than once per row
+struct LinearReferenceLocalState : public GeometryFunctionLocalState {
+	LinearReference line;
+	// The line last loaded in the current chunk. A constant (or dictionary) vector repeats the same line, which is
+	// then known to be loaded without comparing its vertices again.
+	const_data_ptr_t loaded_data = nullptr;
+	idx_t loaded_row = DConstants::INVALID_INDEX;
+
+	explicit LinearReferenceLocalState(ClientContext &context) : GeometryFunctionLocalState(context) {
+	}
+
+	static unique_ptr<FunctionLocalState> Init(ExpressionState &state, const BoundFunctionExpression &expr,
+	                                           FunctionData *bind_data) {
+		return make_uniq<LinearReferenceLocalState>(state.GetContext());
+	}
+
+	static LinearReferenceLocalState &ResetAndGet(ExpressionState &state) {
+		auto &lstate = static_cast<LinearReferenceLocalState &>(GeometryFunctionLocalState::ResetAndGet(state));
+		lstate.loaded_data = nullptr;
+		lstate.loaded_row = DConstants::INVALID_INDEX;
+		return lstate;
+	}
+
+	// Load the vertices of a serialized LINESTRING, returns false if the geometry is not a LINESTRING
+	bool LoadLine(const geometry_t &geom) {
+		if (geom.GetType() != GeometryType::LINESTRING) {
+			return false;
+		}
+		string_t blob = geom;
+		auto data = const_data_ptr_cast(blob.GetData());
+		if (data == loaded_data && !blob.IsInlined()) {
+			return true;
+		}
+		Cursor cursor(blob);
+		auto properties = GeometryFactory::SkipSerializedHeader(cursor);
+		cursor.Skip<SerializedGeometryType>();
+		auto vertex_count = cursor.Read<uint32_t>();
+		line.Load(cursor.GetPtr(), vertex_count, properties.VertexSize() / sizeof(double));
+		loaded_data = data;
+		return true;
+	}
+
+	// Load the vertices of a LINESTRING_2D, row is the index of the line in the list vector
+	void LoadLine(const double *xs, const double *ys, const list_entry_t &entry, idx_t row) {
+		if (row == loaded_row) {
+			return;
+		}
+		line.Load(xs + entry.offset, ys + entry.offset, static_cast<uint32_t>(entry.length));
+		loaded_row = row;
+	}
+};
+
+static void CheckFraction(const char *function_name, double fraction) {
+	if (!(fraction >= 0 && fraction <= 1)) {
+		throw InvalidInputException("%s: the fraction must be between 0 and 1, not %f", function_name, fraction);
+	}
+}
+
+//------------------------------------------------------------------------------
+// ST_LineInterpolatePoint
+//------------------------------------------------------------------------------
+static void LineStringInterpolatePointFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = LinearReferenceLocalState::ResetAndGet(state);
+	auto &line_vec = args.data[0];
+	auto &fraction_vec = args.data[1];
+	auto count = args.size();
+
+	UnifiedVectorFormat line_format;
+	line_vec.ToUnifiedFormat(count, line_format);
+	UnifiedVectorFormat fraction_format;
+	fraction_vec.ToUnifiedFormat(count, fraction_format);
+	auto fraction_data = UnifiedVectorFormat::GetData<double>(fraction_format);
+
+	auto line_entries = UnifiedVectorFormat::GetData<list_entry_t>(line_format);
+	auto &line_vertex_children = StructVector::GetEntries(ListVector::GetEntry(line_vec));
+	auto line_x_data = FlatVector::GetData<double>(*line_vertex_children[0]);
+	auto line_y_data = FlatVector::GetData<double>(*line_vertex_children[1]);
+
+	auto &point_children = StructVector::GetEntries(result);
+	auto point_x_data = FlatVector::GetData<double>(*point_children[0]);
+	auto point_y_data = FlatVector::GetData<double>(*point_children[1]);
+
+	for (idx_t out_row_idx = 0; out_row_idx < count; out_row_idx++) {
+		auto line_idx = line_format.sel->get_index(out_row_idx);
+		auto fraction_idx = fraction_format.sel->get_index(out_row_idx);
+		if (!line_format.validity.RowIsValid(line_idx) || !fraction_format.validity.RowIsValid(fraction_idx)) {
+			FlatVector::SetNull(result, out_row_idx, true);
+			continue;
+		}
+		auto fraction = fraction_data[fraction_idx];
+		CheckFraction("ST_LineInterpolatePoint", fraction);
+		lstate.LoadLine(line_x_data, line_y_data, line_entries[line_idx], line_idx);
+		if (lstate.line.Count() == 0) {
+			FlatVector::SetNull(result, out_row_idx, true);
+			continue;
+		}
+		double point[2];
+		lstate.line.Interpolate(fraction * lstate.line.Length(), point);
+		point_x_data[out_row_idx] = point[0];
+		point_y_data[out_row_idx] = point[1];
+	}
+	if (count == 1) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
+}
+
+static void GeometryInterpolatePointFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = LinearReferenceLocalState::ResetAndGet(state);
+	auto count = args.size();
+
+	BinaryExecutor::ExecuteWithNulls<geometry_t, double, geometry_t>(
+	    args.data[0], args.data[1], result, count,
+	    [&](geometry_t input, double fraction, ValidityMask &mask, idx_t row_idx) {
+		    CheckFraction("ST_LineInterpolatePoint", fraction);
+		    if (!lstate.LoadLine(input)) {
+			    mask.SetInvalid(row_idx);
+			    return geometry_t {};
+		    }
+		    auto props = input.GetProperties();
+		    auto &line = lstate.line;
+		    if (line.Count() == 0) {
+			    return lstate.factory.Serialize(result, Point(props.HasZ(), props.HasM()), props.HasZ(),
+			                                    props.HasM());
+		    }
+		    auto vertices = VertexArray::Create(lstate.factory.allocator, 1, props.HasZ(), props.HasM());
+		    line.Interpolate(fraction * line.Length(), reinterpret_cast<double *>(vertices.GetData()));
+		    return lstate.factory.Serialize(result, Point(vertices), props.HasZ(), props.HasM());
+	    });
+}
+
+//------------------------------------------------------------------------------
+// ST_LineLocatePoint
+//------------------------------------------------------------------------------
+static void LineStringLocatePointFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = LinearReferenceLocalState::ResetAndGet(state);
+	auto &line_vec = args.data[0];
+	auto &point_vec = args.data[1];
+	auto count = args.size();
+
+	UnifiedVectorFormat line_format;
+	line_vec.ToUnifiedFormat(count, line_format);
+	auto line_entries = UnifiedVectorFormat::GetData<list_entry_t>(line_format);
+	auto &line_vertex_children = StructVector::GetEntries(ListVector::GetEntry(line_vec));
+	auto line_x_data = FlatVector::GetData<double>(*line_vertex_children[0]);
+	auto line_y_data = FlatVector::GetData<double>(*line_vertex_children[1]);
+
+	point_vec.Flatten(count);
+	auto &point_validity = FlatVector::Validity(point_vec);
+	auto &point_children = StructVector::GetEntries(point_vec);
+	auto point_x_data = FlatVector::GetData<double>(*point_children[0]);
+	auto point_y_data = FlatVector::GetData<double>(*point_children[1]);
+
+	auto result_data = FlatVector::GetData<double>(result);
+	for (idx_t out_row_idx = 0; out_row_idx < count; out_row_idx++) {
+		auto line_idx = line_format.sel->get_index(out_row_idx);
+		if (!line_format.validity.RowIsValid(line_idx) || !point_validity.RowIsValid(out_row_idx)) {
+			FlatVector::SetNull(result, out_row_idx, true);
+			continue;
+		}
+		lstate.LoadLine(line_x_data, line_y_data, line_entries[line_idx], line_idx);
+		auto &line = lstate.line;
+		if (line.Count() == 0) {
+			FlatVector::SetNull(result, out_row_idx, true);
+			continue;
+		}
+		auto length = line.Length();
+		auto location = line.Locate(point_x_data[out_row_idx], point_y_data[out_row_idx]);
+		result_data[out_row_idx] = length == 0 ? 0 : location / length;
+	}
+	if (count == 1) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
+}
+
+static void GeometryLocatePointFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = LinearReferenceLocalState::ResetAndGet(state);
+	auto count = args.size();
+
+	BinaryExecutor::ExecuteWithNulls<geometry_t, geometry_t, double>(
+	    args.data[0], args.data[1], result, count,
+	    [&](geometry_t input, geometry_t point, ValidityMask &mask, idx_t row_idx) {
+		    double x;
+		    double y;
+		    if (!GeometryFactory::TryGetSerializedPoint(point, x, y) || !lstate.LoadLine(input) ||
+		        lstate.line.Count() == 0) {
+			    mask.SetInvalid(row_idx);
+			    return 0.0;
+		    }
+		    auto length = lstate.line.Length();
+		    return length == 0 ? 0 : lstate.line.Locate(x, y) / length;
+	    });
+}
+
+//------------------------------------------------------------------------------
+// ST_LineSubstring
+//------------------------------------------------------------------------------
+static void CheckFractions(double start, double end) {
+	CheckFraction("ST_LineSubstring", start);
+	CheckFraction("ST_LineSubstring", end);
+	if (start > end) {
+		throw InvalidInputException("ST_LineSubstring: the start fraction must not be larger than the end fraction");
+	}
+}
+
+static void LineStringSubstringFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = LinearReferenceLocalState::ResetAndGet(state);
+	auto &line_vec = args.data[0];
+	auto count = args.size();
+
+	UnifiedVectorFormat line_format;
+	line_vec.ToUnifiedFormat(count, line_format);
+	auto line_entries = UnifiedVectorFormat::GetData<list_entry_t>(line_format);
+	auto &line_vertex_children = StructVector::GetEntries(ListVector::GetEntry(line_vec));
+	auto line_x_data = FlatVector::GetData<double>(*line_vertex_children[0]);
+	auto line_y_data = FlatVector::GetData<double>(*line_vertex_children[1]);
+
+	UnifiedVectorFormat start_format;
+	args.data[1].ToUnifiedFormat(count, start_format);
+	auto start_data = UnifiedVectorFormat::GetData<double>(start_format);
+	UnifiedVectorFormat end_format;
+	args.data[2].ToUnifiedFormat(count, end_format);
+	auto end_data = UnifiedVectorFormat::GetData<double>(end_format);
+
+	auto out_line_entries = ListVector::GetData(result);
+	auto &out_vertex_children = StructVector::GetEntries(ListVector::GetEntry(result));
+
+	vector<double> vertices;
+	idx_t out_offset = 0;
+	for (idx_t out_row_idx = 0; out_row_idx < count; out_row_idx++) {
+		auto line_idx = line_format.sel->get_index(out_row_idx);
+		auto start_idx = start_format.sel->get_index(out_row_idx);
+		auto end_idx = end_format.sel->get_index(out_row_idx);
+		if (!line_format.validity.RowIsValid(line_idx) || !start_format.validity.RowIsValid(start_idx) ||
+		    !end_format.validity.RowIsValid(end_idx)) {
+			FlatVector::SetNull(result, out_row_idx, true);
+			continue;
+		}
+		auto start = start_data[start_idx];
+		auto end = end_data[end_idx];
+		CheckFractions(start, end);
+		lstate.LoadLine(line_x_data, line_y_data, line_entries[line_idx], line_idx);
+		auto &line = lstate.line;
+
+		vertices.clear();
+		if (line.Count() > 0) {
+			line.Substring(start * line.Length(), end * line.Length(), vertices);
+		}
+		auto vertex_count = vertices.size() / 2;
+		ListVector::Reserve(result, out_offset + vertex_count);
+		auto out_x_data = FlatVector::GetData<double>(*out_vertex_children[0]);
+		auto out_y_data = FlatVector::GetData<double>(*out_vertex_children[1]);
+		for (idx_t i = 0; i < vertex_count; i++) {
+			out_x_data[out_offset + i] = vertices[2 * i];
+			out_y_data[out_offset + i] = vertices[2 * i + 1];
+		}
+		out_line_entries[out_row_idx] = list_entry_t {out_offset, vertex_count};
+		out_offset += vertex_count;
+	}
+	ListVector::SetListSize(result, out_offset);
+
+	if (count == 1) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
+}
+
+static void GeometrySubstringFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = LinearReferenceLocalState::ResetAndGet(state);
+	auto count = args.size();
+
+	vector<double> coords;
+	TernaryExecutor::ExecuteWithNulls<geometry_t, double, double, geometry_t>(
+	    args.data[0], args.data[1], args.data[2], result, count,
+	    [&](geometry_t input, double start, double end, ValidityMask &mask, idx_t row_idx) {
+		    CheckFractions(start, end);
+		    if (!lstate.LoadLine(input)) {
+			    mask.SetInvalid(row_idx);
+			    return geometry_t {};
+		    }
+		    auto &line = lstate.line;
+		    if (line.Count() == 0) {
+			    return input;
+		    }
+		    coords.clear();
+		    line.Substring(start * line.Length(), end * line.Length(), coords);
+		    // A substring without length is a point
+		    auto vertex_count = start == end ? 1 : static_cast<uint32_t>(coords.size() / line.Dimensions());
+
+		    auto props = input.GetProperties();
+		    auto vertices = VertexArray::Create(lstate.factory.allocator, vertex_count, props.HasZ(), props.HasM());
+		    memcpy(vertices.GetData(), coords.data(), vertex_count * line.Dimensions() * sizeof(double));
+		    if (vertex_count == 1) {
+			    return lstate.factory.Serialize(result, Point(vertices), props.HasZ(), props.HasM());
+		    }
+		    return lstate.factory.Serialize(result, LineString(vertices), props.HasZ(), props.HasM());
+	    });
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterStLineInterpolatePoint(DatabaseInstance &db) {
+	ScalarFunctionSet set("ST_LineInterpolatePoint");
+
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), LogicalType::DOUBLE}, GeoTypes::GEOMETRY(),
+	                               GeometryInterpolatePointFunction, nullptr, nullptr, nullptr,
+	                               LinearReferenceLocalState::Init));
+	set.AddFunction(ScalarFunction({GeoTypes::LINESTRING_2D(), LogicalType::DOUBLE}, GeoTypes::POINT_2D(),
+	                               LineStringInterpolatePointFunction, nullptr, nullptr, nullptr,
+	                               LinearReferenceLocalState::Init));
+
+	ExtensionUtil::RegisterFunction(db, set);
+}
+
+void CoreScalarFunctions::RegisterStLineLocatePoint(DatabaseInstance &db) {
+	ScalarFunctionSet set("ST_LineLocatePoint");
+
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), GeoTypes::GEOMETRY()}, LogicalType::DOUBLE,
+	                               GeometryLocatePointFunction, nullptr, nullptr, nullptr,
+	                               LinearReferenceLocalState::Init));
+	set.AddFunction(ScalarFunction({GeoTypes::LINESTRING_2D(), GeoTypes::POINT_2D()}, LogicalType::DOUBLE,
+	                               LineStringLocatePointFunction, nullptr, nullptr, nullptr,
+	                               LinearReferenceLocalState::Init));
+
+	ExtensionUtil::RegisterFunction(db, set);
+}
+
+void CoreScalarFunctions::RegisterStLineSubstring(DatabaseInstance &db) {
+	ScalarFunctionSet set("ST_LineSubstring");
+
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), LogicalType::DOUBLE, LogicalType::DOUBLE},
+	                               GeoTypes::GEOMETRY(), GeometrySubstringFunction, nullptr, nullptr, nullptr,
+	                               LinearReferenceLocalState::Init));
+	set.AddFunction(ScalarFunction({GeoTypes::LINESTRING_2D(), LogicalType::DOUBLE, LogicalType::DOUBLE},
+	                               GeoTypes::LINESTRING_2D(), LineStringSubstringFunction, nullptr, nullptr, nullptr,
+	                               LinearReferenceLocalState::Init));
+
+	ExtensionUtil::RegisterFunction(db, set);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,145 @@
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/functions/scalar.hpp"
+#include "spatial/core/functions/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/simplify.hpp"
+
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include "duckdb/common/vector_operations/binary_executor.hpp"
+
+namespace spatial {
+
+namespace core {
+
+// A GEOMETRY_LOD holds a geometry with the rank of every vertex of its lines and rings for Douglas-Peucker
+// simplification at a set of tolerances, the levels. A level is then a selection of the vertices with at least the
+// rank of the level, instead of a simplification. The layout is:
+//
+//   uint8 level_count, uint8 padding[3], uint32 geometry_size
+//   uint8 level_ranks[level_count]    the rank a vertex needs to be kept at each level
+//   geometry                          the serialized GEOMETRY
+//   uint8 ranks[]                     the rank of every vertex of the lines and rings, in order
+static constexpr idx_t LOD_HEADER_SIZE = 8;
+static constexpr idx_t LOD_MAX_LEVELS = 255;
+
+//------------------------------------------------------------------------------
+// ST_BuildLOD
+//------------------------------------------------------------------------------
+static void BuildLODFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
+	auto count = args.size();
+
+	auto &tolerance_vec = ListVector::GetEntry(args.data[1]);
+	UnifiedVectorFormat tolerance_format;
+	tolerance_vec.ToUnifiedFormat(ListVector::GetListSize(args.data[1]), tolerance_format);
+	auto tolerance_data = UnifiedVectorFormat::GetData<double>(tolerance_format);
+
+	GeometrySimplifier simplifier(lstate.factory.allocator, GeometrySimplifier::Method::DOUGLAS_PEUCKER);
+	vector<double> tolerances;
+	vector<double> sorted;
+	vector<uint8_t> ranks;
+
+	BinaryExecutor::Execute<geometry_t, list_entry_t, string_t>(
+	    args.data[0], args.data[1], result, count, [&](geometry_t input, const list_entry_t &levels) {
+		    if (levels.length == 0 || levels.length > LOD_MAX_LEVELS) {
+			    throw InvalidInputException("ST_BuildLOD: expected between 1 and %llu tolerances", LOD_MAX_LEVELS);
+		    }
+		    tolerances.clear();
+		    for (idx_t i = 0; i < levels.length; i++) {
+			    auto idx = tolerance_format.sel->get_index(levels.offset + i);
+			    if (!tolerance_format.validity.RowIsValid(idx) || !(tolerance_data[idx] >= 0)) {
+				    throw InvalidInputException("ST_BuildLOD: the tolerances must be non-negative");
+			    }
+			    tolerances.push_back(tolerance_data[idx]);
+		    }
+		    sorted = tolerances;
+		    std::sort(sorted.begin(), sorted.end());
+
+		    // Every vertex of the lines and rings is ranked in one pass, for all the tolerances
+		    ranks.clear();
+		    auto geom = lstate.factory.Deserialize(input);
+		    simplifier.Rank(geom, sorted, ranks);
+
+		    auto geometry = string_t(input);
+		    auto level_count = static_cast<uint8_t>(tolerances.size());
+		    auto geometry_size = static_cast<uint32_t>(geometry.GetSize());
+		    auto blob = StringVector::EmptyString(result, LOD_HEADER_SIZE + level_count + geometry_size + ranks.size());
+		    auto data = data_ptr_cast(blob.GetDataWriteable());
+		    memset(data, 0, LOD_HEADER_SIZE);
+		    Store<uint8_t>(level_count, data);
+		    Store<uint32_t>(geometry_size, data + 4);
+		    data += LOD_HEADER_SIZE;
+		    // A vertex is kept at a tolerance if it is kept at all the tolerances up to it
+		    for (auto &tolerance : tolerances) {
+			    auto up_to = std::upper_bound(sorted.begin(), sorted.end(), tolerance) - sorted.begin();
+			    *data++ = static_cast<uint8_t>(up_to);
+		    }
+		    memcpy(data, geometry.GetData(), geometry_size);
+		    data += geometry_size;
+		    memcpy(data, ranks.data(), ranks.size());
+		    blob.Finalize();
+		    return blob;
+	    });
+}
+
+//------------------------------------------------------------------------------
+// ST_LOD
+//------------------------------------------------------------------------------
+static void LODFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
+	auto count = args.size();
+
+	GeometrySimplifier simplifier(lstate.factory.allocator, GeometrySimplifier::Method::DOUGLAS_PEUCKER);
+
+	BinaryExecutor::Execute<string_t, int32_t, geometry_t>(
+	    args.data[0], args.data[1], result, count, [&](string_t lod, int32_t level) {
+		    auto data = const_data_ptr_cast(lod.GetData());
+		    auto size = lod.GetSize();
+		    if (size < LOD_HEADER_SIZE) {
+			    throw InvalidInputException("ST_LOD: invalid GEOMETRY_LOD");
+		    }
+		    auto level_count = Load<uint8_t>(data);
+		    auto geometry_size = Load<uint32_t>(data + 4);
+		    if (size < LOD_HEADER_SIZE + level_count + geometry_size) {
+			    throw InvalidInputException("ST_LOD: invalid GEOMETRY_LOD");
+		    }
+		    if (level < 0 || level >= level_count) {
+			    throw InvalidInputException("ST_LOD: level %d is out of range, the geometry has %d levels", level,
+			                                level_count);
+		    }
+		    auto min_rank = Load<uint8_t>(data + LOD_HEADER_SIZE + level);
+		    auto geometry_data = data + LOD_HEADER_SIZE + level_count;
+		    auto geometry = geometry_t(string_t(const_char_ptr_cast(geometry_data), geometry_size));
+		    auto ranks = geometry_data + geometry_size;
+
+		    auto props = geometry.GetProperties();
+		    auto geom = lstate.factory.Deserialize(geometry);
+		    // Every vertex of the lines and rings has a rank after the geometry
+		    if (size - (LOD_HEADER_SIZE + level_count + geometry_size) < GeometrySimplifier::RankCount(geom)) {
+			    throw InvalidInputException("ST_LOD: invalid GEOMETRY_LOD");
+		    }
+		    auto simplified = simplifier.SimplifyRanked(geom, ranks, min_rank);
+		    return lstate.factory.Serialize(result, simplified, props.HasZ(), props.HasM());
+	    });
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterStLOD(DatabaseInstance &db) {
+	ScalarFunctionSet build_set("ST_BuildLOD");
+	build_set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), LogicalType::LIST(LogicalType::DOUBLE)},
+	                                     GeoTypes::GEOMETRY_LOD(), BuildLODFunction, nullptr, nullptr, nullptr,
+	                                     GeometryFunctionLocalState::Init));
+	ExtensionUtil::RegisterFunction(db, build_set);
+
+	ScalarFunctionSet set("ST_LOD");
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY_LOD(), LogicalType::INTEGER}, GeoTypes::GEOMETRY(),
+	                               LODFunction, nullptr, nullptr, nullptr, GeometryFunctionLocalState::Init));
+	ExtensionUtil::RegisterFunction(db, set);
+}
+
+} // namespace core
+
+} // namespace spatial
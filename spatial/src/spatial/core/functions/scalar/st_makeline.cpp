@@ -3,6 +3,8 @@
 #include "spatial/core/functions/scalar.hpp"
 #include "spatial/core/functions/common.hpp"
 #include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/geometry_writer.hpp"
 
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
 #include "duckdb/common/vector_operations/unary_executor.hpp"
@@ -19,46 +21,48 @@ static void MakeLineListFunction(DataChunk &args, ExpressionState &state, Vector
 	UnifiedVectorFormat format;
 	child_vec.ToUnifiedFormat(count, format);
 
+	GeometryWriter writer;
+	writer.double_bbox = lstate.factory.double_bbox;
+
 	UnaryExecutor::Execute<list_entry_t, geometry_t>(args.data[0], result, count, [&](list_entry_t &geometry_list) {
 		auto offset = geometry_list.offset;
 		auto length = geometry_list.length;
 
-		LineString line_geom(lstate.factory.allocator, length, false, false);
+		writer.Begin(GeometryType::LINESTRING, false, false);
+		auto line = writer.AddLineString(0);
 
-        uint32_t vertex_idx = 0;
+		uint32_t vertex_count = 0;
 		for (idx_t i = offset; i < offset + length; i++) {
-
 			auto mapped_idx = format.sel->get_index(i);
 			if (!format.validity.RowIsValid(mapped_idx)) {
 				continue;
 			}
-			auto geometry_blob = ((geometry_t *)format.data)[mapped_idx];
+			auto geometry_blob = UnifiedVectorFormat::GetData<geometry_t>(format)[mapped_idx];
 
-            if(geometry_blob.GetType() != GeometryType::POINT) {
-                throw InvalidInputException("ST_MakeLine only accepts POINT geometries");
-            }
+			if (geometry_blob.GetType() != GeometryType::POINT) {
+				throw InvalidInputException("ST_MakeLine only accepts POINT geometries");
+			}
 
 			// TODO: Support Z and M
 			if (geometry_blob.GetProperties().HasZ() || geometry_blob.GetProperties().HasM()) {
 				throw InvalidInputException("ST_MakeLine from list does not support Z or M geometries");
 			}
 
-			auto point = lstate.factory.Deserialize(geometry_blob).As<Point>();
-			if (point.IsEmpty()) {
+			double x;
+			double y;
+			if (!GeometryFactory::TryGetSerializedPoint(geometry_blob, x, y)) {
 				continue;
 			}
-			auto vertex = point.Vertices().Get(0);
-			line_geom.Vertices().Set(vertex_idx++, vertex.x, vertex.y);
+			writer.AddVertex(x, y);
+			vertex_count++;
 		}
 
-        // Shrink the vertex array to the actual size
-        line_geom.Vertices().Resize(lstate.factory.allocator, vertex_idx);
-
-		if (line_geom.Vertices().Count() == 1) {
+		if (vertex_count == 1) {
 			throw InvalidInputException("ST_MakeLine requires zero or two or more POINT geometries");
 		}
 
-		return lstate.factory.Serialize(result, line_geom, false, false);
+		writer.SetCount(line, vertex_count);
+		return writer.End(result);
 	});
 }
 
@@ -66,6 +70,9 @@ static void MakeLineBinaryFunction(DataChunk &args, ExpressionState &state, Vect
 	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
 	auto count = args.size();
 
+	GeometryWriter writer;
+	writer.double_bbox = lstate.factory.double_bbox;
+
 	BinaryExecutor::Execute<geometry_t, geometry_t, geometry_t>(
 	    args.data[0], args.data[1], result, count, [&](geometry_t &geom_blob_left, geometry_t &geom_blob_right) {
 		    if (geom_blob_left.GetType() != GeometryType::POINT || geom_blob_right.GetType() != GeometryType::POINT) {
@@ -77,8 +84,9 @@ static void MakeLineBinaryFunction(DataChunk &args, ExpressionState &state, Vect
 
 		    if (geometry_left.IsEmpty() && geometry_right.IsEmpty()) {
 			    // Empty linestring
-			    LineString line(false, false);
-			    return lstate.factory.Serialize(result, line, false, false);
+			    writer.Begin(GeometryType::LINESTRING, false, false);
+			    writer.AddLineString(0);
+			    return writer.End(result);
 		    }
 
 		    if (geometry_left.IsEmpty() || geometry_right.IsEmpty()) {
@@ -88,20 +96,12 @@ static void MakeLineBinaryFunction(DataChunk &args, ExpressionState &state, Vect
 		    auto has_z = geom_blob_left.GetProperties().HasZ() || geom_blob_right.GetProperties().HasZ();
 		    auto has_m = geom_blob_left.GetProperties().HasM() || geom_blob_right.GetProperties().HasM();
 
-		    auto &point_left = geometry_left.As<Point>();
-		    auto &point_right = geometry_right.As<Point>();
-
-            // TODO: Dont upcast the child geometries, just append and let the append function handle upcasting of the target instead.
-            point_left.Vertices().SetVertexType(lstate.factory.allocator, has_z, has_m);
-            point_right.Vertices().SetVertexType(lstate.factory.allocator, has_z, has_m);
-
-		    auto vertices = VertexArray::Empty(has_z, has_m);
-		    vertices.Append(lstate.factory.allocator, point_left.Vertices());
-		    vertices.Append(lstate.factory.allocator, point_right.Vertices());
-
-		    LineString line_geom(vertices);
-
-		    return lstate.factory.Serialize(result, line_geom, has_z, has_m);
+		    // The writer upcasts the vertices of the points to the dimensions of the line
+		    writer.Begin(GeometryType::LINESTRING, has_z, has_m);
+		    writer.AddLineString(2);
+		    writer.AddVertices(geometry_left.As<Point>().Vertices());
+		    writer.AddVertices(geometry_right.As<Point>().Vertices());
+		    return writer.End(result);
 	    });
 }
 
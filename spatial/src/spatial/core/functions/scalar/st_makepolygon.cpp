@@ -3,6 +3,7 @@
 #include "spatial/core/functions/scalar.hpp"
 #include "spatial/core/functions/common.hpp"
 #include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_writer.hpp"
 
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
 #include "duckdb/common/vector_operations/unary_executor.hpp"
@@ -20,6 +21,9 @@ static void MakePolygonFromRingsFunction(DataChunk &args, ExpressionState &state
 	UnifiedVectorFormat format;
 	child_vec.ToUnifiedFormat(count, format);
 
+	GeometryWriter writer;
+	writer.double_bbox = lstate.factory.double_bbox;
+
 	BinaryExecutor::Execute<geometry_t, list_entry_t, geometry_t>(
 	    args.data[0], args.data[1], result, count, [&](geometry_t line_blob, list_entry_t &rings_list) {
 		    // First, setup the shell
@@ -90,17 +94,15 @@ static void MakePolygonFromRingsFunction(DataChunk &args, ExpressionState &state
 			    rings.push_back(hole);
 		    }
 
-		    Polygon polygon(lstate.factory.allocator, rings_counts.size(), rings_counts.data(), false, false);
-		    for (idx_t ring_idx = 0; ring_idx < rings.size(); ring_idx++) {
-			    auto &new_ring = rings[ring_idx];
-			    auto &poly_ring = polygon[ring_idx];
-
-			    for (auto i = 0; i < new_ring.Vertices().Count(); i++) {
-				    poly_ring.Set(i, new_ring.Vertices().Get(i));
-			    }
+		    writer.Begin(GeometryType::POLYGON, false, false);
+		    writer.AddPolygon(rings.size());
+		    for (auto ring_count : rings_counts) {
+			    writer.AddRing(ring_count);
 		    }
-
-		    return lstate.factory.Serialize(result, polygon, false, false);
+		    for (auto &ring : rings) {
+			    writer.AddVertices(ring.Vertices());
+		    }
+		    return writer.End(result);
 	    });
 }
 
@@ -108,6 +110,9 @@ static void MakePolygonFromShellFunction(DataChunk &args, ExpressionState &state
 	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
 	auto count = args.size();
 
+	GeometryWriter writer;
+	writer.double_bbox = lstate.factory.double_bbox;
+
 	UnaryExecutor::Execute<geometry_t, geometry_t>(args.data[0], result, count, [&](geometry_t &line_blob) {
 		if (line_blob.GetType() != GeometryType::LINESTRING) {
 			throw InvalidInputException("ST_MakePolygon only accepts LINESTRING geometries");
@@ -128,9 +133,11 @@ static void MakePolygonFromShellFunction(DataChunk &args, ExpressionState &state
 
 		auto props = line_blob.GetProperties();
 
-		Polygon polygon(lstate.factory.allocator, 1, props.HasZ(), props.HasM());
-		polygon[0] = line.Vertices();
-		return lstate.factory.Serialize(result, polygon, props.HasZ(), props.HasM());
+		writer.Begin(GeometryType::POLYGON, props.HasZ(), props.HasM());
+		writer.AddPolygon(1);
+		writer.AddRing(line_count);
+		writer.AddVertices(line_verts);
+		return writer.End(result);
 	});
 }
 
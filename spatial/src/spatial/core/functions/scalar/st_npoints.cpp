@@ -4,6 +4,7 @@
 #include "spatial/core/functions/scalar.hpp"
 #include "spatial/core/functions/common.hpp"
 #include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/vertex_count.hpp"
 #include "spatial/core/types.hpp"
 
 namespace spatial {
@@ -53,6 +54,38 @@ static void PolygonNumPointsFunction(DataChunk &args, ExpressionState &state, Ve
 	});
 }
 
+//------------------------------------------------------------------------------
+// MULTIPOINT_2D, MULTILINESTRING_2D, MULTIPOLYGON_2D
+//------------------------------------------------------------------------------
+// The number of points is the total length of the innermost lists, DEPTH is the number of nested lists
+template <idx_t DEPTH>
+static idx_t CountInnerPoints(Vector &list_vec, const list_entry_t &entry);
+
+template <>
+idx_t CountInnerPoints<1>(Vector &list_vec, const list_entry_t &entry) {
+	return entry.length;
+}
+
+template <idx_t DEPTH>
+static idx_t CountInnerPoints(Vector &list_vec, const list_entry_t &entry) {
+	auto &child_vec = ListVector::GetEntry(list_vec);
+	auto child_entries = ListVector::GetData(child_vec);
+	idx_t npoints = 0;
+	for (idx_t i = entry.offset; i < entry.offset + entry.length; i++) {
+		npoints += CountInnerPoints<DEPTH - 1>(child_vec, child_entries[i]);
+	}
+	return npoints;
+}
+
+template <idx_t DEPTH>
+static void MultiNumPointsFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	D_ASSERT(args.data.size() == 1);
+
+	auto &input = args.data[0];
+	UnaryExecutor::Execute<list_entry_t, idx_t>(
+	    input, result, args.size(), [&](list_entry_t multi) { return CountInnerPoints<DEPTH>(input, multi); });
+}
+
 //------------------------------------------------------------------------------
 // BOX_2D
 //------------------------------------------------------------------------------
@@ -67,51 +100,13 @@ static void BoxNumPointsFunction(DataChunk &args, ExpressionState &state, Vector
 //------------------------------------------------------------------------------
 // GEOMETRY
 //------------------------------------------------------------------------------
-struct GetVertexCountFunctor {
-	static uint32_t Apply(const Point &point) {
-		return point.IsEmpty() ? 0U : 1U;
-	}
-	static uint32_t Apply(const LineString &linestring) {
-		return linestring.Vertices().Count();
-	}
-
-	static uint32_t Apply(const Polygon &polygon) {
-		uint32_t count = 0;
-		for (const auto &ring : polygon) {
-			count += ring.Count();
-		}
-		return count;
-	}
-
-	static uint32_t Apply(const GeometryCollection &collection) {
-		uint32_t count = 0;
-		for (const auto &geom : collection) {
-			count += geom.Dispatch<GetVertexCountFunctor>();
-		}
-		return count;
-	}
-
-	template <class T>
-	static uint32_t Apply(const MultiGeometry<T> &multi) {
-		uint32_t count = 0;
-		for (const auto &geom : multi) {
-			count += Apply(geom);
-		}
-		return count;
-	}
-};
-
 static void GeometryNumPointsFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-
-	auto &ctx = GeometryFunctionLocalState::ResetAndGet(state);
-
 	auto &input = args.data[0];
 	auto count = args.size();
 
-	UnaryExecutor::Execute<geometry_t, uint32_t>(input, result, count, [&](geometry_t input) {
-		auto geometry = ctx.factory.Deserialize(input);
-		return geometry.Dispatch<GetVertexCountFunctor>();
-	});
+	VertexCountProcessor processor;
+	UnaryExecutor::Execute<geometry_t, uint32_t>(input, result, count,
+	                                             [&](const geometry_t &input) { return processor.Execute(input); });
 }
 
 //------------------------------------------------------------------------------
@@ -127,10 +122,15 @@ void CoreScalarFunctions::RegisterStNPoints(DatabaseInstance &db) {
 		    ScalarFunction({GeoTypes::LINESTRING_2D()}, LogicalType::UBIGINT, LineStringNumPointsFunction));
 		area_function_set.AddFunction(
 		    ScalarFunction({GeoTypes::POLYGON_2D()}, LogicalType::UBIGINT, PolygonNumPointsFunction));
+		area_function_set.AddFunction(
+		    ScalarFunction({GeoTypes::MULTIPOINT_2D()}, LogicalType::UBIGINT, MultiNumPointsFunction<1>));
+		area_function_set.AddFunction(
+		    ScalarFunction({GeoTypes::MULTILINESTRING_2D()}, LogicalType::UBIGINT, MultiNumPointsFunction<2>));
+		area_function_set.AddFunction(
+		    ScalarFunction({GeoTypes::MULTIPOLYGON_2D()}, LogicalType::UBIGINT, MultiNumPointsFunction<3>));
 		area_function_set.AddFunction(ScalarFunction({GeoTypes::BOX_2D()}, LogicalType::UBIGINT, BoxNumPointsFunction));
-		area_function_set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY()}, LogicalType::UINTEGER,
-		                                             GeometryNumPointsFunction, nullptr, nullptr, nullptr,
-		                                             GeometryFunctionLocalState::Init));
+		area_function_set.AddFunction(
+		    ScalarFunction({GeoTypes::GEOMETRY()}, LogicalType::UINTEGER, GeometryNumPointsFunction));
 
 		ExtensionUtil::RegisterFunction(db, area_function_set);
 	}
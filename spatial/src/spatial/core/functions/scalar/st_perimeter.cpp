@@ -4,7 +4,8 @@
 #include "spatial/common.hpp"
 #include "spatial/core/types.hpp"
 #include "spatial/core/geometry/geometry.hpp"
-#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/geometry_processor.hpp"
+#include "spatial/core/geometry/vertex_measure.hpp"
 #include "spatial/core/functions/common.hpp"
 #include "spatial/core/functions/scalar.hpp"
 
@@ -20,6 +21,11 @@ static void Polygon2DPerimeterFunction(DataChunk &args, ExpressionState &state,
 
 	auto &input = args.data[0];
 	auto count = args.size();
+	auto is_constant = input.GetVectorType() == VectorType::CONSTANT_VECTOR;
+	if (is_constant) {
+		count = 1;
+	}
+	input.Flatten(count);
 
 	auto &ring_vec = ListVector::GetEntry(input);
 	auto ring_entries = ListVector::GetData(ring_vec);
@@ -28,27 +34,21 @@ static void Polygon2DPerimeterFunction(DataChunk &args, ExpressionState &state,
 	auto x_data = FlatVector::GetData<double>(*coord_vec_children[0]);
 	auto y_data = FlatVector::GetData<double>(*coord_vec_children[1]);
 
+	// Measure every segment of the child arrays in one pass, then sum the segments of each ring
+	auto vertex_count = ListVector::GetListSize(ring_vec);
+	auto segment_lengths = make_unsafe_uniq_array<double>(vertex_count);
+	VertexMeasure::SegmentLengths(x_data, y_data, vertex_count, segment_lengths.get());
+
 	UnaryExecutor::Execute<list_entry_t, double>(input, result, count, [&](list_entry_t polygon) {
-		auto polygon_offset = polygon.offset;
-		auto polygon_length = polygon.length;
 		double perimeter = 0;
-		for (idx_t ring_idx = polygon_offset; ring_idx < polygon_offset + polygon_length; ring_idx++) {
+		for (idx_t ring_idx = polygon.offset; ring_idx < polygon.offset + polygon.length; ring_idx++) {
 			auto ring = ring_entries[ring_idx];
-			auto ring_offset = ring.offset;
-			auto ring_length = ring.length;
-
-			for (idx_t coord_idx = ring_offset; coord_idx < ring_offset + ring_length - 1; coord_idx++) {
-				auto x1 = x_data[coord_idx];
-				auto y1 = y_data[coord_idx];
-				auto x2 = x_data[coord_idx + 1];
-				auto y2 = y_data[coord_idx + 1];
-				perimeter += std::sqrt(std::pow(x1 - x2, 2) + std::pow(y1 - y2, 2));
-			}
+			perimeter += VertexMeasure::SumSegments(segment_lengths.get(), ring.offset, ring.length);
 		}
 		return perimeter;
 	});
 
-	if (count == 1) {
+	if (is_constant) {
 		result.SetVectorType(VectorType::CONSTANT_VECTOR);
 	}
 }
@@ -72,56 +72,55 @@ static void Box2DPerimeterFunction(DataChunk &args, ExpressionState &state, Vect
 //------------------------------------------------------------------------------
 // GEOMETRY
 //------------------------------------------------------------------------------
-static double PolygonPerimeter(const Polygon &poly) {
-	double perimeter = 0;
-	for (const auto &ring : poly) {
-		for (uint32_t i = 0; i < ring.Count() - 1; i++) {
-			auto v1 = ring.Get(i);
-			auto v2 = ring.Get(i + 1);
-			perimeter += std::sqrt(std::pow(v1.x - v2.x, 2) + std::pow(v1.y - v2.y, 2));
+class PerimeterProcessor final : GeometryProcessor<double> {
+	struct LengthOp {
+		template <class V>
+		static double Operation(const VertexData &vertices) {
+			return VertexMeasure::Length<V>(vertices.data[0], vertices.count);
 		}
+	};
+
+	double ProcessVertices(const VertexData &vertices) const {
+		return DispatchVertexType<LengthOp>(HasZ(), HasM(), vertices);
 	}
-	return perimeter;
-}
 
-static double GeometryPerimeter(const Geometry &geom) {
-	switch (geom.Type()) {
-	case core::GeometryType::POLYGON: {
-		auto &poly = geom.As<Polygon>();
-		return PolygonPerimeter(poly);
+	double ProcessPoint(const VertexData &vertices) override {
+		return 0.0;
 	}
-	case core::GeometryType::MULTIPOLYGON: {
-		auto &mpoly = geom.As<MultiPolygon>();
-		double total_perimeter = 0;
-		for (const auto &poly : mpoly) {
-			total_perimeter += PolygonPerimeter(poly);
-		}
-		return total_perimeter;
+
+	double ProcessLineString(const VertexData &vertices) override {
+		return 0.0;
 	}
-	case core::GeometryType::GEOMETRYCOLLECTION: {
-		auto &coll = geom.As<GeometryCollection>();
-		double total_perimeter = 0;
-		for (const auto &subgeom : coll) {
-			total_perimeter += GeometryPerimeter(subgeom);
+
+	double ProcessPolygon(PolygonState &state) override {
+		double sum = 0.0;
+		while (!state.IsDone()) {
+			sum += ProcessVertices(state.Next());
 		}
-		return total_perimeter;
+		return sum;
 	}
-	default: {
-		return 0.0;
+
+	double ProcessCollection(CollectionState &state) override {
+		double sum = 0.0;
+		while (!state.IsDone()) {
+			sum += state.Next();
+		}
+		return sum;
 	}
+
+public:
+	double Execute(const geometry_t &geometry) {
+		return Process(geometry);
 	}
-}
+};
 
 static void GeometryPerimeterFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	auto &lstate = core::GeometryFunctionLocalState::ResetAndGet(state);
-
 	auto &input = args.data[0];
 	auto count = args.size();
 
-	UnaryExecutor::Execute<geometry_t, double>(input, result, count, [&](geometry_t input) {
-		auto geometry = lstate.factory.Deserialize(input);
-		return GeometryPerimeter(geometry);
-	});
+	PerimeterProcessor processor;
+	UnaryExecutor::Execute<geometry_t, double>(input, result, count,
+	                                           [&](const geometry_t &input) { return processor.Execute(input); });
 
 	if (count == 1) {
 		result.SetVectorType(VectorType::CONSTANT_VECTOR);
@@ -134,8 +133,7 @@ void CoreScalarFunctions::RegisterStPerimeter(DatabaseInstance &db) {
 	ScalarFunctionSet set("ST_Perimeter");
 	set.AddFunction(ScalarFunction({GeoTypes::BOX_2D()}, LogicalType::DOUBLE, Box2DPerimeterFunction));
 	set.AddFunction(ScalarFunction({GeoTypes::POLYGON_2D()}, LogicalType::DOUBLE, Polygon2DPerimeterFunction));
-	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY()}, LogicalType::DOUBLE, GeometryPerimeterFunction, nullptr,
-	                               nullptr, nullptr, GeometryFunctionLocalState::Init));
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY()}, LogicalType::DOUBLE, GeometryPerimeterFunction));
 
 	ExtensionUtil::RegisterFunction(db, set);
 }
@@ -101,16 +101,12 @@ static void Point4DFunction(DataChunk &args, ExpressionState &state, Vector &res
 // GEOMETRY
 //------------------------------------------------------------------------------
 static void PointFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
-
 	auto &x = args.data[0];
 	auto &y = args.data[1];
 	auto count = args.size();
 
-	BinaryExecutor::Execute<double, double, geometry_t>(x, y, result, count, [&](double x, double y) {
-		Point point(lstate.factory.allocator, x, y);
-		return lstate.factory.Serialize(result, point, false, false);
-	});
+	BinaryExecutor::Execute<double, double, geometry_t>(
+	    x, y, result, count, [&](double x, double y) { return GeometryFactory::SerializePoint2D(result, x, y); });
 }
 
 //------------------------------------------------------------------------------
@@ -118,8 +114,7 @@ static void PointFunction(DataChunk &args, ExpressionState &state, Vector &resul
 //------------------------------------------------------------------------------
 void CoreScalarFunctions::RegisterStPoint(DatabaseInstance &db) {
 
-	ScalarFunction st_point("ST_Point", {LogicalType::DOUBLE, LogicalType::DOUBLE}, GeoTypes::GEOMETRY(), PointFunction,
-	                        nullptr, nullptr, nullptr, GeometryFunctionLocalState::Init);
+	ScalarFunction st_point("ST_Point", {LogicalType::DOUBLE, LogicalType::DOUBLE}, GeoTypes::GEOMETRY(), PointFunction);
 
 	ExtensionUtil::RegisterFunction(db, st_point);
 
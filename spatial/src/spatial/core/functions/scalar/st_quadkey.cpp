@@ -1,31 +1,70 @@
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
 #include "duckdb/common/vector_operations/generic_executor.hpp"
 #include "duckdb/common/constants.hpp"
+#include "duckdb/common/vector_operations/unary_executor.hpp"
 #include "spatial/common.hpp"
 #include "spatial/core/functions/scalar.hpp"
 #include "spatial/core/functions/common.hpp"
 #include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/space_filling_curve.hpp"
 #include "spatial/core/types.hpp"
 
 #include <cmath>
+#include <cstring>
 
 namespace spatial {
 
 namespace core {
 
-static void GetQuadKey(double lon, double lat, int32_t level, char *buffer) {
+// Web mercator tiles, numbered from the top left corner like the tiles of ST_TileEnvelope
+struct TileGrid {
+	static constexpr double MAX_LATITUDE = 85.05112878;
+	static constexpr int32_t MAX_ZOOM = 31;
 
-	lat = std::max(-85.05112878, std::min(85.05112878, lat));
-	lon = std::max(-180.0, std::min(180.0, lon));
+	// Position of a lon/lat coordinate within the web mercator square, from 0 to 1 along each axis. Coordinates
+	// outside of the bounds of the projection are clamped.
+	static inline void Project(double lon, double lat, double &u, double &v) {
+		lon = std::max(-180.0, std::min(180.0, lon));
+		lat = std::max(-MAX_LATITUDE, std::min(MAX_LATITUDE, lat));
+		// ln(tan(lat) + sec(lat)) == ln((1 + sin(lat)) / (1 - sin(lat))) / 2, with one transcendental call less
+		auto sin_lat = std::sin(lat * PI / 180.0);
+		u = (lon + 180.0) / 360.0;
+		v = 0.5 - std::log((1.0 + sin_lat) / (1.0 - sin_lat)) / (4.0 * PI);
+	}
 
-	double lat_rad = lat * PI / 180.0;
-	auto x = static_cast<int32_t>((lon + 180.0) / 360.0 * (1 << level));
-	auto y =
-	    static_cast<int32_t>((1.0 - std::log(std::tan(lat_rad) + 1.0 / std::cos(lat_rad)) / PI) / 2.0 * (1 << level));
+	// Tile along one axis, the right and bottom edges belong to the last tile
+	static inline uint32_t ToTile(double position, int32_t zoom) {
+		auto tile_count = static_cast<int64_t>(1) << zoom;
+		auto tile = static_cast<int64_t>(position * static_cast<double>(tile_count));
+		return static_cast<uint32_t>(std::min(tile, tile_count - 1));
+	}
+
+	// Project all coordinates first and only then convert them to tiles, so that both loops stay free of branches
+	static void GetTiles(const double *lon, const double *lat, const int32_t *zoom, idx_t count, uint32_t *tile_x,
+	                     uint32_t *tile_y) {
+		auto u = make_unsafe_uniq_array<double>(count);
+		auto v = make_unsafe_uniq_array<double>(count);
+		for (idx_t i = 0; i < count; i++) {
+			Project(lon[i], lat[i], u[i], v[i]);
+		}
+		for (idx_t i = 0; i < count; i++) {
+			tile_x[i] = ToTile(u[i], zoom[i]);
+			tile_y[i] = ToTile(v[i], zoom[i]);
+		}
+	}
+};
+
+static void GetQuadKey(double lon, double lat, int32_t level, char *buffer) {
+	double u;
+	double v;
+	TileGrid::Project(lon, lat, u, v);
+	auto x = TileGrid::ToTile(u, level);
+	auto y = TileGrid::ToTile(v, level);
 
 	for (int i = level; i > 0; --i) {
 		char digit = '0';
-		int32_t mask = 1 << (i - 1);
+		uint32_t mask = 1u << (i - 1);
 		if ((x & mask) != 0) {
 			digit += 1;
 		}
@@ -36,6 +75,7 @@ static void GetQuadKey(double lon, double lat, int32_t level, char *buffer) {
 		buffer[level - i] = digit;
 	}
 }
+
 //------------------------------------------------------------------------------
 // Coordinates
 //------------------------------------------------------------------------------
@@ -60,8 +100,6 @@ static void CoordinateQuadKeyFunction(DataChunk &args, ExpressionState &state, V
 // GEOMETRY
 //------------------------------------------------------------------------------
 static void GeometryQuadKeyFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	auto &ctx = GeometryFunctionLocalState::ResetAndGet(state);
-
 	auto &geom = args.data[0];
 	auto &level = args.data[1];
 	auto count = args.size();
@@ -71,13 +109,11 @@ static void GeometryQuadKeyFunction(DataChunk &args, ExpressionState &state, Vec
 		    if (input.GetType() != GeometryType::POINT) {
 			    throw InvalidInputException("ST_QuadKey: Only POINT geometries are supported");
 		    }
-		    auto point = ctx.factory.Deserialize(input);
-		    if (point.IsEmpty()) {
+		    double x;
+		    double y;
+		    if (!GeometryFactory::TryGetSerializedPoint(input, x, y)) {
 			    throw InvalidInputException("ST_QuadKey: Empty geometries are not supported");
 		    }
-		    auto vertex = point.As<Point>().Vertices().Get(0);
-		    auto x = vertex.x;
-		    auto y = vertex.y;
 
 		    if (level < 1 || level > 23) {
 			    throw InvalidInputException("ST_QuadKey: Level must be between 1 and 23");
@@ -89,6 +125,425 @@ static void GeometryQuadKeyFunction(DataChunk &args, ExpressionState &state, Vec
 	    });
 }
 
+//------------------------------------------------------------------------------
+// BOX_2D
+//------------------------------------------------------------------------------
+// The quadkeys of all the tiles that intersect a lon/lat box, e.g. to select the Hive partitions of data partitioned
+// by ST_QuadKey that a spatial filter can match
+static constexpr idx_t MAX_BOX_QUADKEYS = 1000000;
+
+static void BoxQuadKeysFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	using BOX_TYPE = StructTypeQuaternary<double, double, double, double>;
+	using LEVEL_TYPE = PrimitiveType<int32_t>;
+	using KEYS_TYPE = PrimitiveType<list_entry_t>;
+
+	auto &key_entries = ListVector::GetEntry(result);
+	idx_t total_count = 0;
+
+	GenericExecutor::ExecuteBinary<BOX_TYPE, LEVEL_TYPE, KEYS_TYPE>(
+	    args.data[0], args.data[1], result, args.size(), [&](BOX_TYPE box, LEVEL_TYPE level) {
+		    if (level.val < 1 || level.val > 23) {
+			    throw InvalidInputException("ST_QuadKeys: Level must be between 1 and 23");
+		    }
+		    list_entry_t entry(total_count, 0);
+		    if (!(box.a_val <= box.c_val && box.b_val <= box.d_val)) {
+			    return KEYS_TYPE {entry};
+		    }
+		    // Tile rows are numbered from the top, so the top left corner has the smallest tile on both axes
+		    double u_min;
+		    double v_min;
+		    double u_max;
+		    double v_max;
+		    TileGrid::Project(box.a_val, box.d_val, u_min, v_min);
+		    TileGrid::Project(box.c_val, box.b_val, u_max, v_max);
+		    auto x_min = TileGrid::ToTile(u_min, level.val);
+		    auto y_min = TileGrid::ToTile(v_min, level.val);
+		    auto x_max = TileGrid::ToTile(u_max, level.val);
+		    auto y_max = TileGrid::ToTile(v_max, level.val);
+		    auto tile_count = (static_cast<idx_t>(x_max - x_min) + 1) * (static_cast<idx_t>(y_max - y_min) + 1);
+		    if (tile_count > MAX_BOX_QUADKEYS) {
+			    throw InvalidInputException("ST_QuadKeys: The box intersects more than %llu tiles",
+			                                static_cast<unsigned long long>(MAX_BOX_QUADKEYS));
+		    }
+
+		    ListVector::Reserve(result, total_count + tile_count);
+		    auto key_data = FlatVector::GetData<string_t>(key_entries);
+		    char buffer[64];
+		    for (auto y = y_min; y <= y_max; y++) {
+			    for (auto x = x_min; x <= x_max; x++) {
+				    for (int i = level.val; i > 0; --i) {
+					    uint32_t mask = 1u << (i - 1);
+					    buffer[level.val - i] = static_cast<char>('0' + ((x & mask) != 0) + 2 * ((y & mask) != 0));
+				    }
+				    key_data[total_count++] = StringVector::AddString(key_entries, buffer, level.val);
+			    }
+		    }
+		    entry.length = tile_count;
+		    return KEYS_TYPE {entry};
+	    });
+	ListVector::SetListSize(result, total_count);
+}
+
+//------------------------------------------------------------------------------
+// Integer tiles
+//------------------------------------------------------------------------------
+// ST_TileXY, ST_QuadKeyIndex, ST_GeoHash and ST_GeoHashIndex share everything but the cells and the output. The
+// inputs are gathered into flat lon/lat/parameter arrays, the cells are computed for all valid rows at once and then
+// written out.
+static void CheckZoom(const char *name, int32_t zoom) {
+	if (zoom < 0 || zoom > TileGrid::MAX_ZOOM) {
+		throw InvalidInputException("%s: Zoom level must be between 0 and %d", name, TileGrid::MAX_ZOOM);
+	}
+}
+
+// Gather the integer parameter of every row, invalid rows get the default so that they can go through the same loops
+static unsafe_unique_array<int32_t> GetParameters(const char *name, Vector &param_vec, ValidityMask &validity,
+                                                  idx_t count, int32_t default_value,
+                                                  void (*check)(const char *name, int32_t value)) {
+	UnifiedVectorFormat param_format;
+	param_vec.ToUnifiedFormat(count, param_format);
+	auto param_data = UnifiedVectorFormat::GetData<int32_t>(param_format);
+
+	auto params = make_unsafe_uniq_array<int32_t>(count);
+	for (idx_t i = 0; i < count; i++) {
+		auto param_idx = param_format.sel->get_index(i);
+		if (!param_format.validity.RowIsValid(param_idx)) {
+			validity.SetInvalid(i);
+		}
+		if (!validity.RowIsValid(i)) {
+			params[i] = default_value;
+			continue;
+		}
+		check(name, param_data[param_idx]);
+		params[i] = param_data[param_idx];
+	}
+	return params;
+}
+
+template <class OUTPUT>
+static void ComputeTiles(const char *name, const double *lon, const double *lat, Vector &zoom_vec,
+                         ValidityMask &validity, Vector &result, idx_t count) {
+	auto zoom = GetParameters(name, zoom_vec, validity, count, 0, CheckZoom);
+	auto tile_x = make_unsafe_uniq_array<uint32_t>(count);
+	auto tile_y = make_unsafe_uniq_array<uint32_t>(count);
+	TileGrid::GetTiles(lon, lat, zoom.get(), count, tile_x.get(), tile_y.get());
+	OUTPUT::Write(result, tile_x.get(), tile_y.get(), count);
+}
+
+struct TileXYOutput {
+	static LogicalType Type() {
+		return LogicalType::STRUCT({{"x", LogicalType::INTEGER}, {"y", LogicalType::INTEGER}});
+	}
+	static void Write(Vector &result, const uint32_t *tile_x, const uint32_t *tile_y, idx_t count) {
+		auto &children = StructVector::GetEntries(result);
+		auto x_data = FlatVector::GetData<int32_t>(*children[0]);
+		auto y_data = FlatVector::GetData<int32_t>(*children[1]);
+		for (idx_t i = 0; i < count; i++) {
+			x_data[i] = static_cast<int32_t>(tile_x[i]);
+			y_data[i] = static_cast<int32_t>(tile_y[i]);
+		}
+		// Null structs need null fields as well
+		auto &validity = FlatVector::Validity(result);
+		if (!validity.AllValid()) {
+			for (idx_t i = 0; i < count; i++) {
+				if (!validity.RowIsValid(i)) {
+					FlatVector::SetNull(result, i, true);
+				}
+			}
+		}
+	}
+	static void Compute(const char *name, const double *lon, const double *lat, Vector &zoom_vec,
+	                    ValidityMask &validity, Vector &result, idx_t count) {
+		ComputeTiles<TileXYOutput>(name, lon, lat, zoom_vec, validity, result, count);
+	}
+};
+
+struct QuadKeyIndexOutput {
+	static LogicalType Type() {
+		return LogicalType::UBIGINT;
+	}
+	// The quadkey digits are the interleaved bits of the tile, so the key read as a base 4 number is its morton code
+	static void Write(Vector &result, const uint32_t *tile_x, const uint32_t *tile_y, idx_t count) {
+		auto result_data = FlatVector::GetData<uint64_t>(result);
+		for (idx_t i = 0; i < count; i++) {
+			result_data[i] = MortonCurve::Encode(tile_x[i], tile_y[i]);
+		}
+	}
+	static void Compute(const char *name, const double *lon, const double *lat, Vector &zoom_vec,
+	                    ValidityMask &validity, Vector &result, idx_t count) {
+		ComputeTiles<QuadKeyIndexOutput>(name, lon, lat, zoom_vec, validity, result, count);
+	}
+};
+
+//------------------------------------------------------------------------------
+// Geohashes
+//------------------------------------------------------------------------------
+// A geohash of n characters holds 5 * n bits, which alternate between the longitude and the latitude starting with
+// the longitude. Each axis is halved once per bit of it, so the bits of an axis are its cell on a grid of
+// 2^bits cells, and the hash is the morton code of the two cells with the longitude in the highest bit.
+struct GeoHash {
+	static constexpr int32_t MAX_PRECISION = 12;
+	static constexpr const char *ALPHABET = "0123456789bcdefghjkmnpqrstuvwxyz";
+
+	// The cell of a coordinate on an axis halved bits times, the upper edge belongs to the last cell
+	static inline uint32_t ToCell(double value, double min, double max, int32_t bits) {
+		auto cell_count = static_cast<double>(static_cast<uint64_t>(1) << bits);
+		auto cell = (value - min) / (max - min) * cell_count;
+		cell = cell > 0 ? cell : 0;
+		cell = cell < cell_count - 1 ? cell : cell_count - 1;
+		return static_cast<uint32_t>(cell);
+	}
+
+	// The longitude gets the extra bit of an odd number of bits, and with it the lowest bit of the morton code
+	static inline uint64_t Encode(double lon, double lat, int32_t precision) {
+		auto bits = 5 * precision;
+		auto odd = bits & 1;
+		auto x = ToCell(lon, -180, 180, (bits + 1) / 2);
+		auto y = ToCell(lat, -90, 90, bits / 2);
+		return (MortonCurve::Spread(x) << (1 - odd)) | (MortonCurve::Spread(y) << odd);
+	}
+
+	static inline void Decode(uint64_t hash, int32_t precision, double &min_lon, double &min_lat, double &max_lon,
+	                          double &max_lat) {
+		auto bits = 5 * precision;
+		auto odd = bits & 1;
+		auto x = MortonCurve::Compact(hash >> (1 - odd));
+		auto y = MortonCurve::Compact(hash >> odd);
+		auto width = 360.0 / static_cast<double>(static_cast<uint64_t>(1) << ((bits + 1) / 2));
+		auto height = 180.0 / static_cast<double>(static_cast<uint64_t>(1) << (bits / 2));
+		min_lon = -180 + x * width;
+		min_lat = -90 + y * height;
+		max_lon = min_lon + width;
+		max_lat = min_lat + height;
+	}
+
+	// Returns the number of characters written
+	static inline idx_t ToString(uint64_t hash, int32_t precision, char *buffer) {
+		for (int32_t i = 0; i < precision; i++) {
+			buffer[i] = ALPHABET[(hash >> (5 * (precision - 1 - i))) & 31];
+		}
+		return static_cast<idx_t>(precision);
+	}
+
+	// Both upper and lower case characters are accepted
+	static uint64_t FromString(const char *name, const char *data, idx_t size) {
+		if (size < 1 || size > static_cast<idx_t>(MAX_PRECISION)) {
+			throw InvalidInputException("%s: A geohash must have between 1 and %d characters", name, MAX_PRECISION);
+		}
+		uint64_t hash = 0;
+		for (idx_t i = 0; i < size; i++) {
+			auto c = StringUtil::CharacterToLower(data[i]);
+			auto digit = std::strchr(ALPHABET, c);
+			if (c == '\0' || !digit) {
+				throw InvalidInputException("%s: Invalid character '%c' in geohash '%s'", name, data[i],
+				                            string(data, size));
+			}
+			hash = (hash << 5) | static_cast<uint64_t>(digit - ALPHABET);
+		}
+		return hash;
+	}
+};
+
+constexpr int32_t GeoHash::MAX_PRECISION;
+constexpr const char *GeoHash::ALPHABET;
+
+static void CheckGeoHashPrecision(const char *name, int32_t precision) {
+	if (precision < 1 || precision > GeoHash::MAX_PRECISION) {
+		throw InvalidInputException("%s: Precision must be between 1 and %d", name, GeoHash::MAX_PRECISION);
+	}
+}
+
+template <class OUTPUT>
+static void ComputeGeoHashes(const char *name, const double *lon, const double *lat, Vector &precision_vec,
+                             ValidityMask &validity, Vector &result, idx_t count) {
+	auto precision = GetParameters(name, precision_vec, validity, count, 1, CheckGeoHashPrecision);
+	auto hashes = make_unsafe_uniq_array<uint64_t>(count);
+	for (idx_t i = 0; i < count; i++) {
+		hashes[i] = GeoHash::Encode(lon[i], lat[i], precision[i]);
+	}
+	OUTPUT::Write(result, hashes.get(), precision.get(), validity, count);
+}
+
+struct GeoHashOutput {
+	static LogicalType Type() {
+		return LogicalType::VARCHAR;
+	}
+	static void Write(Vector &result, const uint64_t *hashes, const int32_t *precision, ValidityMask &validity,
+	                  idx_t count) {
+		auto result_data = FlatVector::GetData<string_t>(result);
+		char buffer[GeoHash::MAX_PRECISION];
+		for (idx_t i = 0; i < count; i++) {
+			if (validity.RowIsValid(i)) {
+				// Short strings are inlined, so this does not touch the heap of the vector
+				auto size = GeoHash::ToString(hashes[i], precision[i], buffer);
+				result_data[i] = StringVector::AddString(result, buffer, size);
+			}
+		}
+	}
+	static void Compute(const char *name, const double *lon, const double *lat, Vector &precision_vec,
+	                    ValidityMask &validity, Vector &result, idx_t count) {
+		ComputeGeoHashes<GeoHashOutput>(name, lon, lat, precision_vec, validity, result, count);
+	}
+};
+
+struct GeoHashIndexOutput {
+	static LogicalType Type() {
+		return LogicalType::UBIGINT;
+	}
+	// The bits of the geohash, in the lowest 5 * precision bits
+	static void Write(Vector &result, const uint64_t *hashes, const int32_t *, ValidityMask &, idx_t count) {
+		memcpy(FlatVector::GetData<uint64_t>(result), hashes, count * sizeof(uint64_t));
+	}
+	static void Compute(const char *name, const double *lon, const double *lat, Vector &precision_vec,
+	                    ValidityMask &validity, Vector &result, idx_t count) {
+		ComputeGeoHashes<GeoHashIndexOutput>(name, lon, lat, precision_vec, validity, result, count);
+	}
+};
+
+//------------------------------------------------------------------------------
+// Cell functions
+//------------------------------------------------------------------------------
+template <class OUTPUT>
+static void Point2DCellFunction(DataChunk &args, ExpressionState &state, Vector &result, const char *name) {
+	auto &point_vec = args.data[0];
+	auto &param_vec = args.data[1];
+	auto count = args.size();
+	auto is_constant = args.AllConstant();
+	if (is_constant) {
+		count = 1;
+	}
+	point_vec.Flatten(count);
+
+	auto &children = StructVector::GetEntries(point_vec);
+	auto x_data = FlatVector::GetData<double>(*children[0]);
+	auto y_data = FlatVector::GetData<double>(*children[1]);
+
+	auto &validity = FlatVector::Validity(result);
+	validity.Copy(FlatVector::Validity(point_vec), count);
+	OUTPUT::Compute(name, x_data, y_data, param_vec, validity, result, count);
+
+	if (is_constant) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
+}
+
+// Points are binned by their coordinates, other geometries by the centre of the bounding box in their header
+template <class OUTPUT>
+static void GeometryCellFunction(DataChunk &args, ExpressionState &state, Vector &result, const char *name) {
+	auto &geom_vec = args.data[0];
+	auto &param_vec = args.data[1];
+	auto count = args.size();
+	auto is_constant = args.AllConstant();
+	if (is_constant) {
+		count = 1;
+	}
+
+	UnifiedVectorFormat geom_format;
+	geom_vec.ToUnifiedFormat(count, geom_format);
+	auto geom_data = UnifiedVectorFormat::GetData<geometry_t>(geom_format);
+
+	auto &validity = FlatVector::Validity(result);
+	auto lon = make_unsafe_uniq_array<double>(count);
+	auto lat = make_unsafe_uniq_array<double>(count);
+	BoundingBox bbox;
+	for (idx_t i = 0; i < count; i++) {
+		auto geom_idx = geom_format.sel->get_index(i);
+		lon[i] = 0;
+		lat[i] = 0;
+		if (!geom_format.validity.RowIsValid(geom_idx)) {
+			validity.SetInvalid(i);
+			continue;
+		}
+		auto &geom = geom_data[geom_idx];
+		if (GeometryFactory::TryGetSerializedPoint(geom, lon[i], lat[i])) {
+			continue;
+		}
+		if (GeometryFactory::TryGetSerializedBoundingBox(geom, bbox)) {
+			lon[i] = bbox.minx + (bbox.maxx - bbox.minx) / 2;
+			lat[i] = bbox.miny + (bbox.maxy - bbox.miny) / 2;
+			continue;
+		}
+		// Empty geometries are not in any cell
+		validity.SetInvalid(i);
+	}
+	OUTPUT::Compute(name, lon.get(), lat.get(), param_vec, validity, result, count);
+
+	if (is_constant) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
+}
+
+static void Point2DTileXYFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	Point2DCellFunction<TileXYOutput>(args, state, result, "ST_TileXY");
+}
+
+static void GeometryTileXYFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	GeometryCellFunction<TileXYOutput>(args, state, result, "ST_TileXY");
+}
+
+static void Point2DQuadKeyIndexFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	Point2DCellFunction<QuadKeyIndexOutput>(args, state, result, "ST_QuadKeyIndex");
+}
+
+static void GeometryQuadKeyIndexFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	GeometryCellFunction<QuadKeyIndexOutput>(args, state, result, "ST_QuadKeyIndex");
+}
+
+static void Point2DGeoHashFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	Point2DCellFunction<GeoHashOutput>(args, state, result, "ST_GeoHash");
+}
+
+static void GeometryGeoHashFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	GeometryCellFunction<GeoHashOutput>(args, state, result, "ST_GeoHash");
+}
+
+static void Point2DGeoHashIndexFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	Point2DCellFunction<GeoHashIndexOutput>(args, state, result, "ST_GeoHashIndex");
+}
+
+static void GeometryGeoHashIndexFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	GeometryCellFunction<GeoHashIndexOutput>(args, state, result, "ST_GeoHashIndex");
+}
+
+//------------------------------------------------------------------------------
+// Geohash cells
+//------------------------------------------------------------------------------
+static geometry_t GeoHashEnvelope(GeometryFunctionLocalState &lstate, Vector &result, uint64_t hash,
+                                  int32_t precision) {
+	double min_lon, min_lat, max_lon, max_lat;
+	GeoHash::Decode(hash, precision, min_lon, min_lat, max_lon, max_lat);
+	uint32_t capacity = 5;
+	Polygon envelope(lstate.factory.allocator, 1, &capacity, false, false);
+	auto &shell = envelope[0];
+	shell.Set(0, min_lon, min_lat);
+	shell.Set(1, min_lon, max_lat);
+	shell.Set(2, max_lon, max_lat);
+	shell.Set(3, max_lon, min_lat);
+	shell.Set(4, min_lon, min_lat);
+	return lstate.factory.Serialize(result, envelope, false, false);
+}
+
+static void GeomFromGeoHashFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
+	UnaryExecutor::Execute<string_t, geometry_t>(args.data[0], result, args.size(), [&](string_t input) {
+		auto size = input.GetSize();
+		auto hash = GeoHash::FromString("ST_GeomFromGeoHash", input.GetData(), size);
+		return GeoHashEnvelope(lstate, result, hash, static_cast<int32_t>(size));
+	});
+}
+
+static void GeomFromGeoHashIndexFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
+	BinaryExecutor::Execute<uint64_t, int32_t, geometry_t>(
+	    args.data[0], args.data[1], result, args.size(), [&](uint64_t hash, int32_t precision) {
+		    CheckGeoHashPrecision("ST_GeomFromGeoHash", precision);
+		    if (hash >> (5 * precision) != 0) {
+			    throw InvalidInputException("ST_GeomFromGeoHash: The geohash has more bits than its precision");
+		    }
+		    return GeoHashEnvelope(lstate, result, hash, precision);
+	    });
+}
+
 //------------------------------------------------------------------------------
 // Register functions
 //------------------------------------------------------------------------------
@@ -98,11 +553,51 @@ void CoreScalarFunctions::RegisterStQuadKey(DatabaseInstance &db) {
 
 	set.AddFunction(ScalarFunction({LogicalType::DOUBLE, LogicalType::DOUBLE, LogicalType::INTEGER},
 	                               LogicalType::VARCHAR, CoordinateQuadKeyFunction));
-	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), LogicalType::INTEGER}, LogicalType::VARCHAR,
-	                               GeometryQuadKeyFunction, nullptr, nullptr, nullptr,
-	                               GeometryFunctionLocalState::Init));
+	set.AddFunction(
+	    ScalarFunction({GeoTypes::GEOMETRY(), LogicalType::INTEGER}, LogicalType::VARCHAR, GeometryQuadKeyFunction));
 
 	ExtensionUtil::RegisterFunction(db, set);
+
+	ScalarFunction quadkeys("ST_QuadKeys", {GeoTypes::BOX_2D(), LogicalType::INTEGER},
+	                        LogicalType::LIST(LogicalType::VARCHAR), BoxQuadKeysFunction);
+	ExtensionUtil::RegisterFunction(db, quadkeys);
+
+	ScalarFunctionSet tile_xy("ST_TileXY");
+	tile_xy.AddFunction(ScalarFunction({GeoTypes::POINT_2D(), LogicalType::INTEGER}, TileXYOutput::Type(),
+	                                   Point2DTileXYFunction));
+	tile_xy.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), LogicalType::INTEGER}, TileXYOutput::Type(),
+	                                   GeometryTileXYFunction));
+	ExtensionUtil::RegisterFunction(db, tile_xy);
+
+	ScalarFunctionSet quadkey_index("ST_QuadKeyIndex");
+	quadkey_index.AddFunction(ScalarFunction({GeoTypes::POINT_2D(), LogicalType::INTEGER},
+	                                         QuadKeyIndexOutput::Type(), Point2DQuadKeyIndexFunction));
+	quadkey_index.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), LogicalType::INTEGER},
+	                                         QuadKeyIndexOutput::Type(), GeometryQuadKeyIndexFunction));
+	ExtensionUtil::RegisterFunction(db, quadkey_index);
+
+	ScalarFunctionSet geohash("ST_GeoHash");
+	geohash.AddFunction(ScalarFunction({GeoTypes::POINT_2D(), LogicalType::INTEGER}, GeoHashOutput::Type(),
+	                                   Point2DGeoHashFunction));
+	geohash.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), LogicalType::INTEGER}, GeoHashOutput::Type(),
+	                                   GeometryGeoHashFunction));
+	ExtensionUtil::RegisterFunction(db, geohash);
+
+	ScalarFunctionSet geohash_index("ST_GeoHashIndex");
+	geohash_index.AddFunction(ScalarFunction({GeoTypes::POINT_2D(), LogicalType::INTEGER},
+	                                         GeoHashIndexOutput::Type(), Point2DGeoHashIndexFunction));
+	geohash_index.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), LogicalType::INTEGER},
+	                                         GeoHashIndexOutput::Type(), GeometryGeoHashIndexFunction));
+	ExtensionUtil::RegisterFunction(db, geohash_index);
+
+	ScalarFunctionSet geom_from_geohash("ST_GeomFromGeoHash");
+	geom_from_geohash.AddFunction(ScalarFunction({LogicalType::VARCHAR}, GeoTypes::GEOMETRY(),
+	                                             GeomFromGeoHashFunction, nullptr, nullptr, nullptr,
+	                                             GeometryFunctionLocalState::Init));
+	geom_from_geohash.AddFunction(ScalarFunction({LogicalType::UBIGINT, LogicalType::INTEGER}, GeoTypes::GEOMETRY(),
+	                                             GeomFromGeoHashIndexFunction, nullptr, nullptr, nullptr,
+	                                             GeometryFunctionLocalState::Init));
+	ExtensionUtil::RegisterFunction(db, geom_from_geohash);
 }
 
 } // namespace core
@@ -0,0 +1,45 @@
+#include "duckdb/common/vector_operations/binary_executor.hpp"
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include "spatial/common.hpp"
+#include "spatial/core/functions/scalar.hpp"
+#include "spatial/core/functions/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/quantized_geometry.hpp"
+#include "spatial/core/types.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// GEOMETRY
+//------------------------------------------------------------------------------
+static void QuantizeFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &input = args.data[0];
+	auto &in_grid_size = args.data[1];
+	auto count = args.size();
+
+	vector<data_t> buffer;
+	auto quantize = [&](geometry_t geom, double grid_size) {
+		if (!(grid_size > 0)) {
+			throw InvalidInputException("ST_Quantize: the grid size must be positive");
+		}
+		QuantizedGeometry::Quantize(geom, grid_size, buffer);
+		return StringVector::AddStringOrBlob(result, const_char_ptr_cast(buffer.data()), buffer.size());
+	};
+	BinaryExecutor::Execute<geometry_t, double, string_t>(input, in_grid_size, result, count, quantize);
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterStQuantize(DatabaseInstance &db) {
+	ScalarFunctionSet set("ST_Quantize");
+	set.AddFunction(
+	    ScalarFunction({GeoTypes::GEOMETRY(), LogicalType::DOUBLE}, GeoTypes::GEOMETRY_Q(), QuantizeFunction));
+	ExtensionUtil::RegisterFunction(db, set);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,397 @@
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include "duckdb/common/vector_operations/generic_executor.hpp"
+#include "spatial/common.hpp"
+#include "spatial/core/functions/scalar.hpp"
+#include "spatial/core/functions/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/geometry_processor.hpp"
+#include "spatial/core/types.hpp"
+
+#include <cmath>
+
+namespace spatial {
+
+namespace core {
+
+// The cells of the S2 geometry library: the six faces of a cube around the unit sphere, each split into a quadtree of
+// 30 levels and numbered along a Hilbert curve. Coordinates are [latitude, longitude] in degrees, like the spheroid
+// functions. Cell ids are the 64 bit S2 cell ids, so that they match the ids of other S2 implementations.
+struct S2Grid {
+	static constexpr int32_t MAX_LEVEL = 30;
+	static constexpr uint32_t LIMIT_IJ = 1U << MAX_LEVEL;
+	static constexpr double DEG_TO_RAD = 0.017453292519943296;
+	static constexpr double PI = 3.14159265358979323846;
+	// The smallest radius of curvature of the WGS84 ellipsoid, the meridian radius at the equator, so that a distance
+	// on the ellipsoid is never more than the angle it is converted to
+	static constexpr double MIN_RADIUS_OF_CURVATURE = 6335439.327;
+	// Covering refuses to produce more cells than this for a single geometry
+	static constexpr idx_t MAX_COVERING_CELLS = 1000000;
+
+	struct XYZ {
+		double x;
+		double y;
+		double z;
+	};
+
+	static XYZ ToXYZ(double lat, double lng) {
+		auto phi = lat * DEG_TO_RAD;
+		auto theta = lng * DEG_TO_RAD;
+		auto cos_phi = std::cos(phi);
+		return {cos_phi * std::cos(theta), cos_phi * std::sin(theta), std::sin(phi)};
+	}
+
+	static XYZ Normalize(const XYZ &p) {
+		auto norm = std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+		return {p.x / norm, p.y / norm, p.z / norm};
+	}
+
+	// The angle between two unit vectors
+	static double Angle(const XYZ &a, const XYZ &b) {
+		auto dot = a.x * b.x + a.y * b.y + a.z * b.z;
+		return std::acos(std::max(-1.0, std::min(1.0, dot)));
+	}
+
+	// The quadratic projection of S2, which makes the cells closer to equal in area than the plain cube projection
+	static double STtoUV(double s) {
+		if (s >= 0.5) {
+			return (1.0 / 3) * (4 * s * s - 1);
+		}
+		return (1.0 / 3) * (1 - 4 * (1 - s) * (1 - s));
+	}
+
+	static double UVtoST(double u) {
+		if (u >= 0) {
+			return 0.5 * std::sqrt(1 + 3 * u);
+		}
+		return 1 - 0.5 * std::sqrt(1 - 3 * u);
+	}
+
+	static XYZ FaceUVtoXYZ(int32_t face, double u, double v) {
+		switch (face) {
+		case 0:
+			return {1, u, v};
+		case 1:
+			return {-u, 1, v};
+		case 2:
+			return {-u, -v, 1};
+		case 3:
+			return {-1, -v, -u};
+		case 4:
+			return {v, -1, -u};
+		default:
+			return {v, u, -1};
+		}
+	}
+
+	static int32_t XYZtoFaceUV(const XYZ &p, double &u, double &v) {
+		auto ax = std::abs(p.x);
+		auto ay = std::abs(p.y);
+		auto az = std::abs(p.z);
+		int32_t face = ax >= ay && ax >= az ? 0 : (ay >= az ? 1 : 2);
+		auto component = face == 0 ? p.x : (face == 1 ? p.y : p.z);
+		if (component < 0) {
+			face += 3;
+		}
+		switch (face) {
+		case 0:
+			u = p.y / p.x;
+			v = p.z / p.x;
+			break;
+		case 1:
+			u = -p.x / p.y;
+			v = p.z / p.y;
+			break;
+		case 2:
+			u = -p.x / p.z;
+			v = -p.y / p.z;
+			break;
+		case 3:
+			u = p.z / p.x;
+			v = p.y / p.x;
+			break;
+		case 4:
+			u = p.z / p.y;
+			v = -p.x / p.y;
+			break;
+		default:
+			u = -p.y / p.z;
+			v = -p.x / p.z;
+			break;
+		}
+		return face;
+	}
+
+	static uint32_t STtoIJ(double s) {
+		auto ij = std::floor(static_cast<double>(LIMIT_IJ) * s);
+		return static_cast<uint32_t>(std::max(0.0, std::min(static_cast<double>(LIMIT_IJ - 1), ij)));
+	}
+
+	// The id of the cell at the given level that contains the leaf cell (i, j) of the face, walking the Hilbert curve
+	// from the top of the quadtree down
+	static uint64_t FromFaceIJ(int32_t face, uint32_t i, uint32_t j, int32_t level) {
+		// The position of each (i, j) quadrant along the curve, and how the curve turns in it, per orientation
+		static constexpr uint8_t IJ_TO_POS[4][4] = {{0, 1, 3, 2}, {0, 3, 1, 2}, {2, 3, 1, 0}, {2, 1, 3, 0}};
+		static constexpr uint8_t POS_TO_ORIENTATION[4] = {1, 0, 0, 3};
+
+		uint64_t pos = 0;
+		uint8_t orientation = face & 1;
+		for (int32_t k = MAX_LEVEL - 1; k >= 0; k--) {
+			auto ij = (((i >> k) & 1) << 1) | ((j >> k) & 1);
+			auto bits = IJ_TO_POS[orientation][ij];
+			pos = (pos << 2) | bits;
+			orientation ^= POS_TO_ORIENTATION[bits];
+		}
+		auto leaf = (static_cast<uint64_t>(face) << 61) | (pos << 1) | 1;
+		auto lsb = uint64_t(1) << (2 * (MAX_LEVEL - level));
+		return (leaf & (~lsb + 1)) | lsb;
+	}
+
+	static uint64_t FromLatLng(double lat, double lng, int32_t level) {
+		double u;
+		double v;
+		auto face = XYZtoFaceUV(ToXYZ(lat, lng), u, v);
+		return FromFaceIJ(face, STtoIJ(UVtoST(u)), STtoIJ(UVtoST(v)), level);
+	}
+
+	static void CheckLevel(const char *name, int32_t level) {
+		if (level < 0 || level > MAX_LEVEL) {
+			throw InvalidInputException("%s: Level must be between 0 and 30", name);
+		}
+	}
+};
+
+//------------------------------------------------------------------------------
+// Spherical cap
+//------------------------------------------------------------------------------
+// The smallest cap around the mean of the vertices of a geometry that contains all of them. Edges are arcs of great
+// circles, so a cap of less than a hemisphere that contains the vertices contains the whole geometry, however it is
+// placed relative to the antimeridian or the poles.
+class SphericalCapProcessor final : GeometryProcessor<void> {
+public:
+	// Returns false for empty geometries
+	bool TryGetCap(const geometry_t &geom, S2Grid::XYZ &center, double &radius) {
+		vertices.clear();
+		Process(geom);
+		if (vertices.empty()) {
+			return false;
+		}
+		S2Grid::XYZ sum = {0, 0, 0};
+		for (auto &p : vertices) {
+			sum.x += p.x;
+			sum.y += p.y;
+			sum.z += p.z;
+		}
+		auto norm = std::sqrt(sum.x * sum.x + sum.y * sum.y + sum.z * sum.z);
+		if (!(norm > 1e-9 * static_cast<double>(vertices.size()))) {
+			// The vertices are spread around the whole sphere
+			center = {1, 0, 0};
+			radius = S2Grid::PI;
+			return true;
+		}
+		center = {sum.x / norm, sum.y / norm, sum.z / norm};
+		radius = 0;
+		for (auto &p : vertices) {
+			radius = std::max(radius, S2Grid::Angle(center, p));
+		}
+		if (radius >= S2Grid::PI / 2 && vertices.size() > 1) {
+			// Edges between the vertices may leave a cap of a hemisphere or more
+			radius = S2Grid::PI;
+		}
+		return true;
+	}
+
+private:
+	vector<S2Grid::XYZ> vertices;
+
+	void AddVertices(const VertexData &data) {
+		for (uint32_t i = 0; i < data.count; i++) {
+			auto lat = Load<double>(data.data[0] + i * data.stride[0]);
+			auto lng = Load<double>(data.data[1] + i * data.stride[1]);
+			vertices.push_back(S2Grid::ToXYZ(lat, lng));
+		}
+	}
+
+	void ProcessPoint(const VertexData &data) override {
+		AddVertices(data);
+	}
+
+	void ProcessLineString(const VertexData &data) override {
+		AddVertices(data);
+	}
+
+	void ProcessPolygon(PolygonState &state) override {
+		// The holes are inside the shell
+		if (!state.IsDone()) {
+			AddVertices(state.Next());
+		}
+	}
+
+	void ProcessCollection(CollectionState &state) override {
+		while (!state.IsDone()) {
+			state.Next();
+		}
+	}
+};
+
+// Collects the cells of a level whose bounding cap intersects a cap, descending the quadtree from the faces
+class S2Coverer {
+public:
+	S2Coverer(const S2Grid::XYZ &center, double radius, int32_t level) : center(center), radius(radius), level(level) {
+	}
+
+	void Cover(vector<uint64_t> &cells) {
+		for (int32_t face = 0; face < 6; face++) {
+			CoverCell(face, 0, 0, 0, cells);
+		}
+	}
+
+private:
+	S2Grid::XYZ center;
+	double radius;
+	int32_t level;
+
+	S2Grid::XYZ CellPoint(int32_t face, double s, double t) const {
+		return S2Grid::Normalize(S2Grid::FaceUVtoXYZ(face, S2Grid::STtoUV(s), S2Grid::STtoUV(t)));
+	}
+
+	void CoverCell(int32_t face, uint32_t i, uint32_t j, int32_t cell_level, vector<uint64_t> &cells) {
+		auto size = S2Grid::LIMIT_IJ >> cell_level;
+		auto s0 = static_cast<double>(i) / S2Grid::LIMIT_IJ;
+		auto t0 = static_cast<double>(j) / S2Grid::LIMIT_IJ;
+		auto s1 = static_cast<double>(i + static_cast<uint64_t>(size)) / S2Grid::LIMIT_IJ;
+		auto t1 = static_cast<double>(j + static_cast<uint64_t>(size)) / S2Grid::LIMIT_IJ;
+
+		// The edges of a cell are arcs of great circles too, so the cap around its corners contains it
+		auto cell_center = CellPoint(face, (s0 + s1) / 2, (t0 + t1) / 2);
+		auto cell_radius = std::max(std::max(S2Grid::Angle(cell_center, CellPoint(face, s0, t0)),
+		                                     S2Grid::Angle(cell_center, CellPoint(face, s1, t0))),
+		                            std::max(S2Grid::Angle(cell_center, CellPoint(face, s0, t1)),
+		                                     S2Grid::Angle(cell_center, CellPoint(face, s1, t1))));
+		if (S2Grid::Angle(center, cell_center) > radius + cell_radius + 1e-12) {
+			return;
+		}
+		if (cell_level == level) {
+			if (cells.size() >= S2Grid::MAX_COVERING_CELLS) {
+				throw InvalidInputException(
+				    "ST_S2Covering: The geometry covers more than %llu cells, use a lower level",
+				    static_cast<unsigned long long>(S2Grid::MAX_COVERING_CELLS));
+			}
+			cells.push_back(S2Grid::FromFaceIJ(face, i, j, level));
+			return;
+		}
+		auto half = size >> 1;
+		CoverCell(face, i, j, cell_level + 1, cells);
+		CoverCell(face, i + half, j, cell_level + 1, cells);
+		CoverCell(face, i, j + half, cell_level + 1, cells);
+		CoverCell(face, i + half, j + half, cell_level + 1, cells);
+	}
+};
+
+//------------------------------------------------------------------------------
+// ST_S2Cell
+//------------------------------------------------------------------------------
+static void Point2DS2CellFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	using POINT_TYPE = StructTypeBinary<double, double>;
+	using LEVEL_TYPE = PrimitiveType<int32_t>;
+	using CELL_TYPE = PrimitiveType<uint64_t>;
+
+	GenericExecutor::ExecuteBinary<POINT_TYPE, LEVEL_TYPE, CELL_TYPE>(
+	    args.data[0], args.data[1], result, args.size(), [&](POINT_TYPE point, LEVEL_TYPE level) {
+		    S2Grid::CheckLevel("ST_S2Cell", level.val);
+		    return CELL_TYPE {S2Grid::FromLatLng(point.a_val, point.b_val, level.val)};
+	    });
+}
+
+static void GeometryS2CellFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	BinaryExecutor::ExecuteWithNulls<geometry_t, int32_t, uint64_t>(
+	    args.data[0], args.data[1], result, args.size(),
+	    [&](geometry_t geom, int32_t level, ValidityMask &mask, idx_t idx) {
+		    S2Grid::CheckLevel("ST_S2Cell", level);
+		    if (geom.GetType() != GeometryType::POINT) {
+			    throw InvalidInputException("ST_S2Cell: Only points are in a single cell, use ST_S2Covering instead");
+		    }
+		    double lat;
+		    double lng;
+		    if (!GeometryFactory::TryGetSerializedPoint(geom, lat, lng)) {
+			    // Empty points are not in any cell
+			    mask.SetInvalid(idx);
+			    return uint64_t(0);
+		    }
+		    return S2Grid::FromLatLng(lat, lng, level);
+	    });
+}
+
+//------------------------------------------------------------------------------
+// ST_S2Covering
+//------------------------------------------------------------------------------
+// The cells of a level that may intersect the geometry, or come within the distance of it. Every cell that does is in
+// the covering, but cells near the geometry that do not may be as well.
+static void CoverGeometry(SphericalCapProcessor &processor, const geometry_t &geom, int32_t level, double distance,
+                          vector<uint64_t> &cells) {
+	S2Grid::CheckLevel("ST_S2Covering", level);
+	if (!(distance >= 0) || !std::isfinite(distance)) {
+		throw InvalidInputException("ST_S2Covering: Distance must be a non-negative, finite number");
+	}
+	cells.clear();
+	S2Grid::XYZ center;
+	double radius;
+	if (!processor.TryGetCap(geom, center, radius)) {
+		return;
+	}
+	// Allow for rounding in the cap and the conversion of the vertices
+	radius += distance / S2Grid::MIN_RADIUS_OF_CURVATURE + 1e-9;
+	S2Coverer coverer(center, radius, level);
+	coverer.Cover(cells);
+}
+
+static void GeometryS2CoveringFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &cell_entries = ListVector::GetEntry(result);
+	idx_t total_count = 0;
+	SphericalCapProcessor processor;
+	vector<uint64_t> cells;
+
+	auto append = [&](geometry_t geom, int32_t level, double distance) {
+		CoverGeometry(processor, geom, level, distance, cells);
+		list_entry_t entry(total_count, cells.size());
+		ListVector::Reserve(result, total_count + cells.size());
+		auto cell_data = FlatVector::GetData<uint64_t>(cell_entries);
+		for (auto &cell : cells) {
+			cell_data[total_count++] = cell;
+		}
+		return entry;
+	};
+	if (args.ColumnCount() == 2) {
+		BinaryExecutor::Execute<geometry_t, int32_t, list_entry_t>(
+		    args.data[0], args.data[1], result, args.size(),
+		    [&](geometry_t geom, int32_t level) { return append(geom, level, 0); });
+	} else {
+		TernaryExecutor::Execute<geometry_t, int32_t, double, list_entry_t>(args.data[0], args.data[1], args.data[2],
+		                                                                    result, args.size(), append);
+	}
+	ListVector::SetListSize(result, total_count);
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterStS2Cell(DatabaseInstance &db) {
+
+	ScalarFunctionSet s2_cell("ST_S2Cell");
+	s2_cell.AddFunction(
+	    ScalarFunction({GeoTypes::POINT_2D(), LogicalType::INTEGER}, LogicalType::UBIGINT, Point2DS2CellFunction));
+	s2_cell.AddFunction(
+	    ScalarFunction({GeoTypes::GEOMETRY(), LogicalType::INTEGER}, LogicalType::UBIGINT, GeometryS2CellFunction));
+	ExtensionUtil::RegisterFunction(db, s2_cell);
+
+	ScalarFunctionSet s2_covering("ST_S2Covering");
+	s2_covering.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), LogicalType::INTEGER},
+	                                       LogicalType::LIST(LogicalType::UBIGINT), GeometryS2CoveringFunction));
+	s2_covering.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), LogicalType::INTEGER, LogicalType::DOUBLE},
+	                                       LogicalType::LIST(LogicalType::UBIGINT), GeometryS2CoveringFunction));
+	ExtensionUtil::RegisterFunction(db, s2_covering);
+}
+
+} // namespace core
+
+} // namespace spatial
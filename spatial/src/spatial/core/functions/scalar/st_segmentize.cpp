@@ -0,0 +1,51 @@
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/functions/scalar.hpp"
+#include "spatial/core/functions/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/segmentize.hpp"
+
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include "duckdb/common/vector_operations/binary_executor.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// GEOMETRY
+//------------------------------------------------------------------------------
+static void GeometrySegmentizeFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
+	auto count = args.size();
+
+	GeometryWriter writer;
+	writer.double_bbox = lstate.factory.double_bbox;
+	PlanarSegmentizer segmentizer;
+
+	BinaryExecutor::Execute<geometry_t, double, geometry_t>(
+	    args.data[0], args.data[1], result, count, [&](geometry_t input, double max_length) {
+		    if (!(max_length > 0)) {
+			    throw InvalidInputException("ST_Segmentize: the maximum segment length must be positive");
+		    }
+		    segmentizer.max_length = max_length;
+		    return segmentizer.Execute(input, writer, result);
+	    });
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterStSegmentize(DatabaseInstance &db) {
+	ScalarFunctionSet set("ST_Segmentize");
+
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), LogicalType::DOUBLE}, GeoTypes::GEOMETRY(),
+	                               GeometrySegmentizeFunction, nullptr, nullptr, nullptr,
+	                               GeometryFunctionLocalState::Init));
+
+	ExtensionUtil::RegisterFunction(db, set);
+}
+
+} // namespace core
+
+} // namespace spatial
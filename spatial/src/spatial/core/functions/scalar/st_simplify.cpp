@@ -0,0 +1,55 @@
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/functions/scalar.hpp"
+#include "spatial/core/functions/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/simplify.hpp"
+
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include "duckdb/common/vector_operations/binary_executor.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// GEOMETRY
+//------------------------------------------------------------------------------
+template <GeometrySimplifier::Method METHOD>
+static void SimplifyFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
+	GeometrySimplifier simplifier(lstate.factory.allocator, METHOD);
+
+	BinaryExecutor::Execute<geometry_t, double, geometry_t>(
+	    args.data[0], args.data[1], result, args.size(), [&](geometry_t input, double tolerance) {
+		    if (tolerance < 0) {
+			    throw InvalidInputException("Tolerance must be non-negative");
+		    }
+		    auto props = input.GetProperties();
+		    auto geom = lstate.factory.Deserialize(input);
+		    auto simplified = simplifier.Simplify(geom, tolerance);
+		    return lstate.factory.Serialize(result, simplified, props.HasZ(), props.HasM());
+	    });
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterStSimplify(DatabaseInstance &db) {
+
+	ScalarFunctionSet set("ST_Simplify");
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), LogicalType::DOUBLE}, GeoTypes::GEOMETRY(),
+	                               SimplifyFunction<GeometrySimplifier::Method::DOUGLAS_PEUCKER>, nullptr, nullptr,
+	                               nullptr, GeometryFunctionLocalState::Init));
+	ExtensionUtil::RegisterFunction(db, set);
+
+	ScalarFunctionSet vw_set("ST_SimplifyVW");
+	vw_set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), LogicalType::DOUBLE}, GeoTypes::GEOMETRY(),
+	                                  SimplifyFunction<GeometrySimplifier::Method::VISVALINGAM_WHYATT>, nullptr,
+	                                  nullptr, nullptr, GeometryFunctionLocalState::Init));
+	ExtensionUtil::RegisterFunction(db, vw_set);
+}
+
+} // namespace core
+
+} // namespace spatial
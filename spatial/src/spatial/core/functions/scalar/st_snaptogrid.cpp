@@ -0,0 +1,51 @@
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/functions/scalar.hpp"
+#include "spatial/core/functions/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/snap_to_grid.hpp"
+
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include "duckdb/common/vector_operations/binary_executor.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// GEOMETRY
+//------------------------------------------------------------------------------
+static void GeometrySnapToGridFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
+	auto count = args.size();
+
+	GeometryWriter writer;
+	writer.double_bbox = lstate.factory.double_bbox;
+	GridSnapper snapper;
+
+	BinaryExecutor::Execute<geometry_t, double, geometry_t>(
+	    args.data[0], args.data[1], result, count, [&](geometry_t input, double grid_size) {
+		    if (!(grid_size > 0) || !Value::IsFinite(grid_size)) {
+			    throw InvalidInputException("ST_SnapToGrid: the grid size must be a positive number");
+		    }
+		    snapper.grid_size = grid_size;
+		    return snapper.Execute(input, writer, result);
+	    });
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterStSnapToGrid(DatabaseInstance &db) {
+	ScalarFunctionSet set("ST_SnapToGrid");
+
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), LogicalType::DOUBLE}, GeoTypes::GEOMETRY(),
+	                               GeometrySnapToGridFunction, nullptr, nullptr, nullptr,
+	                               GeometryFunctionLocalState::Init));
+
+	ExtensionUtil::RegisterFunction(db, set);
+}
+
+} // namespace core
+
+} // namespace spatial
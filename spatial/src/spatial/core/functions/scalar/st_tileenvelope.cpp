@@ -0,0 +1,65 @@
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/functions/scalar.hpp"
+#include "spatial/core/functions/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include "duckdb/common/vector_operations/generic_executor.hpp"
+
+namespace spatial {
+
+namespace core {
+
+// Half the circumference of the earth in web mercator (EPSG:3857) meters
+static constexpr double WEB_MERCATOR_ORIGIN = 20037508.342789244;
+
+static void TileEnvelopeFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
+	auto count = args.size();
+
+	using INT_TYPE = PrimitiveType<int32_t>;
+	using GEOMETRY_TYPE = PrimitiveType<geometry_t>;
+
+	GenericExecutor::ExecuteTernary<INT_TYPE, INT_TYPE, INT_TYPE, GEOMETRY_TYPE>(
+	    args.data[0], args.data[1], args.data[2], result, count, [&](INT_TYPE zoom, INT_TYPE x, INT_TYPE y) {
+		    if (zoom.val < 0 || zoom.val > 31) {
+			    throw InvalidInputException("ST_TileEnvelope: Zoom level must be between 0 and 31");
+		    }
+		    // Tiles are numbered from the top left corner, the same way as the quadkeys of ST_QuadKey
+		    auto tile_count = static_cast<int64_t>(1) << zoom.val;
+		    if (x.val < 0 || x.val >= tile_count || y.val < 0 || y.val >= tile_count) {
+			    throw InvalidInputException("ST_TileEnvelope: Tile x and y must be between 0 and 2^zoom - 1");
+		    }
+		    auto tile_size = 2 * WEB_MERCATOR_ORIGIN / static_cast<double>(tile_count);
+		    auto x_min = -WEB_MERCATOR_ORIGIN + x.val * tile_size;
+		    auto y_max = WEB_MERCATOR_ORIGIN - y.val * tile_size;
+		    auto x_max = x_min + tile_size;
+		    auto y_min = y_max - tile_size;
+
+		    uint32_t capacity = 5;
+		    Polygon envelope_geom(lstate.factory.allocator, 1, &capacity, false, false);
+		    auto &shell = envelope_geom[0];
+		    shell.Set(0, x_min, y_min);
+		    shell.Set(1, x_min, y_max);
+		    shell.Set(2, x_max, y_max);
+		    shell.Set(3, x_max, y_min);
+		    shell.Set(4, x_min, y_min);
+		    return lstate.factory.Serialize(result, envelope_geom, false, false);
+	    });
+}
+
+void CoreScalarFunctions::RegisterStTileEnvelope(DatabaseInstance &db) {
+
+	ScalarFunctionSet set("ST_TileEnvelope");
+
+	set.AddFunction(ScalarFunction({LogicalType::INTEGER, LogicalType::INTEGER, LogicalType::INTEGER},
+	                               GeoTypes::GEOMETRY(), TileEnvelopeFunction, nullptr, nullptr, nullptr,
+	                               GeometryFunctionLocalState::Init));
+
+	ExtensionUtil::RegisterFunction(db, set);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,106 @@
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/functions/scalar.hpp"
+#include "spatial/core/functions/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/triangulate.hpp"
+
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include "duckdb/common/vector_operations/unary_executor.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// GEOMETRY -> GEOMETRY
+//------------------------------------------------------------------------------
+static void TriangulateFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
+
+	GeometryWriter writer;
+	writer.double_bbox = lstate.factory.double_bbox;
+	Triangulator triangulator;
+
+	UnaryExecutor::Execute<geometry_t, geometry_t>(args.data[0], result, args.size(), [&](geometry_t geom) {
+		triangulator.Execute(geom);
+		return triangulator.Serialize(writer, result);
+	});
+}
+
+//------------------------------------------------------------------------------
+// GEOMETRY -> STRUCT(vertices DOUBLE[], indices UINTEGER[])
+//------------------------------------------------------------------------------
+// The buffers of all rows are appended to the same two child vectors, so a whole chunk can be shipped as is
+static void TriangulateIndicesFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto count = args.size();
+	auto &input = args.data[0];
+	UnifiedVectorFormat format;
+	input.ToUnifiedFormat(count, format);
+	auto input_data = UnifiedVectorFormat::GetData<geometry_t>(format);
+
+	auto &children = StructVector::GetEntries(result);
+	auto &vertex_vec = *children[0];
+	auto &index_vec = *children[1];
+	auto vertex_entries = ListVector::GetData(vertex_vec);
+	auto index_entries = ListVector::GetData(index_vec);
+
+	Triangulator triangulator;
+	for (idx_t out_idx = 0; out_idx < count; out_idx++) {
+		auto in_idx = format.sel->get_index(out_idx);
+		if (!format.validity.RowIsValid(in_idx)) {
+			FlatVector::SetNull(result, out_idx, true);
+			continue;
+		}
+		triangulator.Execute(input_data[in_idx]);
+
+		// The vertices are interleaved, x and y
+		auto &vertices = triangulator.vertices;
+		auto vertex_offset = ListVector::GetListSize(vertex_vec);
+		auto vertex_count = vertices.size() * 2;
+		ListVector::Reserve(vertex_vec, vertex_offset + vertex_count);
+		auto vertex_data = FlatVector::GetData<double>(ListVector::GetEntry(vertex_vec));
+		for (idx_t i = 0; i < vertices.size(); i++) {
+			vertex_data[vertex_offset + i * 2] = vertices[i].x;
+			vertex_data[vertex_offset + i * 2 + 1] = vertices[i].y;
+		}
+		vertex_entries[out_idx].offset = vertex_offset;
+		vertex_entries[out_idx].length = vertex_count;
+		ListVector::SetListSize(vertex_vec, vertex_offset + vertex_count);
+
+		auto &indices = triangulator.indices;
+		auto index_offset = ListVector::GetListSize(index_vec);
+		ListVector::Reserve(index_vec, index_offset + indices.size());
+		auto index_data = FlatVector::GetData<uint32_t>(ListVector::GetEntry(index_vec));
+		memcpy(index_data + index_offset, indices.data(), indices.size() * sizeof(uint32_t));
+		index_entries[out_idx].offset = index_offset;
+		index_entries[out_idx].length = indices.size();
+		ListVector::SetListSize(index_vec, index_offset + indices.size());
+	}
+
+	if (input.GetVectorType() == VectorType::CONSTANT_VECTOR) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterStTriangulate(DatabaseInstance &db) {
+	ScalarFunctionSet triangulate("ST_Triangulate");
+	triangulate.AddFunction(ScalarFunction({GeoTypes::GEOMETRY()}, GeoTypes::GEOMETRY(), TriangulateFunction, nullptr,
+	                                       nullptr, nullptr, GeometryFunctionLocalState::Init));
+	ExtensionUtil::RegisterFunction(db, triangulate);
+
+	ScalarFunctionSet triangulate_indices("ST_TriangulateIndices");
+	triangulate_indices.AddFunction(
+	    ScalarFunction({GeoTypes::GEOMETRY()},
+	                   LogicalType::STRUCT({{"vertices", LogicalType::LIST(LogicalType::DOUBLE)},
+	                                        {"indices", LogicalType::LIST(LogicalType::UINTEGER)}}),
+	                   TriangulateIndicesFunction));
+	ExtensionUtil::RegisterFunction(db, triangulate_indices);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -197,6 +197,19 @@ public:
 	}
 };
 
+// Points have no bounding box in the header, but their x and y ordinates can be read directly from the blob
+// without visiting the geometry. Sets is_empty if the point is empty.
+template <size_t N>
+static bool TryGetPointOrdinate(const geometry_t &blob, double &result, bool &is_empty) {
+	if (N > 1 || blob.GetType() != GeometryType::POINT) {
+		return false;
+	}
+	BoundingBox bbox;
+	is_empty = !GeometryFactory::TryGetSerializedBoundingBox(blob, bbox);
+	result = is_empty ? 0.0 : (N == 0 ? bbox.minx : bbox.miny);
+	return true;
+}
+
 template <size_t N, class OP>
 static void GeometryFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	static_assert(N < 4, "Invalid ordinate index");
@@ -208,6 +221,14 @@ static void GeometryFunction(DataChunk &args, ExpressionState &state, Vector &re
 	BoundsProcessor<N, OP> processor;
 	UnaryExecutor::ExecuteWithNulls<geometry_t, double>(input, result, count,
 	                                                    [&](geometry_t blob, ValidityMask &mask, idx_t idx) {
+		                                                    double ordinate;
+		                                                    bool is_empty;
+		                                                    if (TryGetPointOrdinate<N>(blob, ordinate, is_empty)) {
+			                                                    if (is_empty) {
+				                                                    mask.SetInvalid(idx);
+			                                                    }
+			                                                    return ordinate;
+		                                                    }
 		                                                    auto res = processor.Execute(blob);
 		                                                    if (processor.ResultIsEmpty()) {
 			                                                    mask.SetInvalid(idx);
@@ -236,6 +257,14 @@ static void GeometryAccessFunction(DataChunk &args, ExpressionState &state, Vect
 		    if (blob.GetType() != GeometryType::POINT) {
 			    throw InvalidInputException("ST_X/ST_Y/ST_Z/ST_M only supports POINT geometries");
 		    }
+		    double ordinate;
+		    bool is_empty;
+		    if (TryGetPointOrdinate<N>(blob, ordinate, is_empty)) {
+			    if (is_empty) {
+				    mask.SetInvalid(idx);
+			    }
+			    return ordinate;
+		    }
 		    auto res = processor.Execute(blob);
 		    if (processor.ResultIsEmpty()) {
 			    mask.SetInvalid(idx);
@@ -0,0 +1,61 @@
+#include "duckdb/parser/parsed_data/create_table_function_info.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/functions/table.hpp"
+#include "spatial/core/functions/common.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// spatial_arena_metrics()
+//------------------------------------------------------------------------------
+// Reports the memory held by the geometry arenas of the spatial functions. The peak and the number of trims are
+// reset by every call, so calling it after a query reports the usage of that query.
+
+struct ArenaMetricsState : public GlobalTableFunctionState {
+	bool done = false;
+};
+
+static unique_ptr<FunctionData> ArenaMetricsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                 vector<LogicalType> &return_types, vector<string> &names) {
+	return_types.push_back(LogicalType::UBIGINT);
+	return_types.push_back(LogicalType::UBIGINT);
+	return_types.push_back(LogicalType::UBIGINT);
+	names.push_back("held_bytes");
+	names.push_back("peak_bytes");
+	names.push_back("trims");
+	return nullptr;
+}
+
+static unique_ptr<GlobalTableFunctionState> ArenaMetricsInit(ClientContext &context, TableFunctionInitInput &input) {
+	return make_uniq<ArenaMetricsState>();
+}
+
+static void ArenaMetricsExecute(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
+	auto &state = input.global_state->Cast<ArenaMetricsState>();
+	if (state.done) {
+		return;
+	}
+	state.done = true;
+
+	idx_t held_bytes;
+	idx_t peak_bytes;
+	idx_t trim_count;
+	GeometryArena::FetchMetrics(held_bytes, peak_bytes, trim_count);
+
+	output.SetValue(0, 0, Value::UBIGINT(held_bytes));
+	output.SetValue(1, 0, Value::UBIGINT(peak_bytes));
+	output.SetValue(2, 0, Value::UBIGINT(trim_count));
+	output.SetCardinality(1);
+}
+
+void CoreTableFunctions::RegisterArenaMetricsTableFunction(DatabaseInstance &db) {
+	TableFunction func("spatial_arena_metrics", {}, ArenaMetricsExecute, ArenaMetricsBind, ArenaMetricsInit);
+	ExtensionUtil::RegisterFunction(db, func);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,59 @@
+#include "duckdb/parser/parsed_data/create_table_function_info.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/functions/table.hpp"
+#include "spatial/core/init_profile.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// spatial_init_profile()
+//------------------------------------------------------------------------------
+// Reports the time spent registering each module when the extension was loaded, and initializing the libraries that
+// are only set up when they are first used.
+
+struct InitProfileState : public GlobalTableFunctionState {
+	vector<InitProfile::Entry> entries;
+	idx_t offset = 0;
+};
+
+static unique_ptr<FunctionData> InitProfileBind(ClientContext &context, TableFunctionBindInput &input,
+                                                vector<LogicalType> &return_types, vector<string> &names) {
+	return_types.push_back(LogicalType::VARCHAR);
+	return_types.push_back(LogicalType::VARCHAR);
+	return_types.push_back(LogicalType::DOUBLE);
+	names.push_back("module");
+	names.push_back("phase");
+	names.push_back("elapsed_ms");
+	return nullptr;
+}
+
+static unique_ptr<GlobalTableFunctionState> InitProfileInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto result = make_uniq<InitProfileState>();
+	result->entries = InitProfile::GetEntries();
+	return std::move(result);
+}
+
+static void InitProfileExecute(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
+	auto &state = input.global_state->Cast<InitProfileState>();
+	idx_t count = 0;
+	while (state.offset < state.entries.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &entry = state.entries[state.offset++];
+		output.SetValue(0, count, Value(entry.module));
+		output.SetValue(1, count, Value(entry.phase));
+		output.SetValue(2, count, Value::DOUBLE(entry.elapsed_ms));
+		count++;
+	}
+	output.SetCardinality(count);
+}
+
+void CoreTableFunctions::RegisterInitProfileTableFunction(DatabaseInstance &db) {
+	TableFunction func("spatial_init_profile", {}, InitProfileExecute, InitProfileBind, InitProfileInit);
+	ExtensionUtil::RegisterFunction(db, func);
+}
+
+} // namespace core
+
+} // namespace spatial
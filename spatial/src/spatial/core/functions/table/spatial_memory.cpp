@@ -0,0 +1,96 @@
+#include "duckdb/parser/parsed_data/create_table_function_info.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/functions/table.hpp"
+#include "spatial/core/functions/common.hpp"
+#include "spatial/core/join_index_cache.hpp"
+#include "spatial/core/tile_cache.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// spatial_memory()
+//------------------------------------------------------------------------------
+// Reports the memory held by the spatial functions, one row per component. The geometry arenas allocate through the
+// buffer allocator and are part of the memory reported by duckdb_memory(), the aggregate states are not. The peaks
+// are reset by every call (and the peak of the arenas by spatial_arena_metrics() too).
+
+struct SpatialMemoryState : public GlobalTableFunctionState {
+	bool done = false;
+};
+
+static unique_ptr<FunctionData> SpatialMemoryBind(ClientContext &context, TableFunctionBindInput &input,
+                                                  vector<LogicalType> &return_types, vector<string> &names) {
+	return_types.push_back(LogicalType::VARCHAR);
+	return_types.push_back(LogicalType::UBIGINT);
+	return_types.push_back(LogicalType::UBIGINT);
+	return_types.push_back(LogicalType::BOOLEAN);
+	names.push_back("component");
+	names.push_back("held_bytes");
+	names.push_back("peak_bytes");
+	names.push_back("buffer_managed");
+	return nullptr;
+}
+
+static unique_ptr<GlobalTableFunctionState> SpatialMemoryInit(ClientContext &context, TableFunctionInitInput &input) {
+	return make_uniq<SpatialMemoryState>();
+}
+
+static void SpatialMemoryExecute(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
+	auto &state = input.global_state->Cast<SpatialMemoryState>();
+	if (state.done) {
+		return;
+	}
+	state.done = true;
+
+	idx_t arena_held;
+	idx_t arena_peak;
+	GeometryArena::FetchMemory(arena_held, arena_peak);
+	output.SetValue(0, 0, Value("geometry_arenas"));
+	output.SetValue(1, 0, Value::UBIGINT(arena_held));
+	output.SetValue(2, 0, Value::UBIGINT(arena_peak));
+	output.SetValue(3, 0, Value::BOOLEAN(true));
+
+	idx_t aggregate_held;
+	idx_t aggregate_peak;
+	AggregateMemoryBindData::FetchMemory(aggregate_held, aggregate_peak);
+	output.SetValue(0, 1, Value("aggregate_states"));
+	output.SetValue(1, 1, Value::UBIGINT(aggregate_held));
+	output.SetValue(2, 1, Value::UBIGINT(aggregate_peak));
+	output.SetValue(3, 1, Value::BOOLEAN(false));
+
+	idx_t tile_cache_held = 0;
+	idx_t tile_cache_peak = 0;
+	auto tile_cache = TileCache::TryGet(context);
+	if (tile_cache) {
+		tile_cache->FetchMemory(tile_cache_held, tile_cache_peak);
+	}
+	output.SetValue(0, 2, Value("tile_cache"));
+	output.SetValue(1, 2, Value::UBIGINT(tile_cache_held));
+	output.SetValue(2, 2, Value::UBIGINT(tile_cache_peak));
+	output.SetValue(3, 2, Value::BOOLEAN(true));
+
+	idx_t join_cache_held = 0;
+	idx_t join_cache_peak = 0;
+	auto join_cache = JoinIndexCache::TryGet(context);
+	if (join_cache) {
+		join_cache->FetchMemory(join_cache_held, join_cache_peak);
+	}
+	output.SetValue(0, 3, Value("join_index_cache"));
+	output.SetValue(1, 3, Value::UBIGINT(join_cache_held));
+	output.SetValue(2, 3, Value::UBIGINT(join_cache_peak));
+	output.SetValue(3, 3, Value::BOOLEAN(false));
+
+	output.SetCardinality(4);
+}
+
+void CoreTableFunctions::RegisterSpatialMemoryTableFunction(DatabaseInstance &db) {
+	TableFunction func("spatial_memory", {}, SpatialMemoryExecute, SpatialMemoryBind, SpatialMemoryInit);
+	ExtensionUtil::RegisterFunction(db, func);
+}
+
+} // namespace core
+
+} // namespace spatial
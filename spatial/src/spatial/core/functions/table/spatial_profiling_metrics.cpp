@@ -0,0 +1,69 @@
+#include "duckdb/parser/parsed_data/create_table_function_info.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/functions/table.hpp"
+#include "spatial/core/profiling.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// spatial_profiling_metrics()
+//------------------------------------------------------------------------------
+// Reports the hot path counters of the spatial functions, collected while the "spatial_profiling" setting is enabled.
+// The counters are reset by every call, so calling it after a query reports the work done by that query.
+
+struct ProfilingMetricsState : public GlobalTableFunctionState {
+	bool done = false;
+};
+
+static unique_ptr<FunctionData> ProfilingMetricsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                     vector<LogicalType> &return_types, vector<string> &names) {
+	for (auto &name : {"deserialize_calls", "deserialize_bytes", "geos_predicate_calls", "prepared_cache_hits",
+	                   "bbox_rejects", "proj_pipelines", "join_candidates", "join_matches", "join_grid_rejects",
+	                   "join_build_ms", "join_probe_ms", "join_refine_ms"}) {
+		auto is_time = StringUtil::EndsWith(name, "_ms");
+		return_types.push_back(is_time ? LogicalType::DOUBLE : LogicalType::UBIGINT);
+		names.push_back(name);
+	}
+	return nullptr;
+}
+
+static unique_ptr<GlobalTableFunctionState> ProfilingMetricsInit(ClientContext &context,
+                                                                 TableFunctionInitInput &input) {
+	return make_uniq<ProfilingMetricsState>();
+}
+
+static void ProfilingMetricsExecute(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
+	auto &state = input.global_state->Cast<ProfilingMetricsState>();
+	if (state.done) {
+		return;
+	}
+	state.done = true;
+
+	auto counters = SpatialCounters::Fetch();
+	output.SetValue(0, 0, Value::UBIGINT(counters.deserialize_calls));
+	output.SetValue(1, 0, Value::UBIGINT(counters.deserialize_bytes));
+	output.SetValue(2, 0, Value::UBIGINT(counters.geos_predicate_calls));
+	output.SetValue(3, 0, Value::UBIGINT(counters.prepared_cache_hits));
+	output.SetValue(4, 0, Value::UBIGINT(counters.bbox_rejects));
+	output.SetValue(5, 0, Value::UBIGINT(counters.proj_pipelines));
+	output.SetValue(6, 0, Value::UBIGINT(counters.join_candidates));
+	output.SetValue(7, 0, Value::UBIGINT(counters.join_matches));
+	output.SetValue(8, 0, Value::UBIGINT(counters.join_grid_rejects));
+	output.SetValue(9, 0, Value::DOUBLE(counters.join_build_us / 1000.0));
+	output.SetValue(10, 0, Value::DOUBLE(counters.join_probe_us / 1000.0));
+	output.SetValue(11, 0, Value::DOUBLE(counters.join_refine_us / 1000.0));
+	output.SetCardinality(1);
+}
+
+void CoreTableFunctions::RegisterProfilingMetricsTableFunction(DatabaseInstance &db) {
+	TableFunction func("spatial_profiling_metrics", {}, ProfilingMetricsExecute, ProfilingMetricsBind,
+	                   ProfilingMetricsInit);
+	ExtensionUtil::RegisterFunction(db, func);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,233 @@
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
+#include "duckdb/main/connection.hpp"
+#include "duckdb/main/materialized_query_result.hpp"
+#include "duckdb/parser/parser.hpp"
+#include "duckdb/parser/parsed_data/create_table_function_info.hpp"
+#include "duckdb/planner/operator/logical_get.hpp"
+#include "duckdb/planner/planner.hpp"
+#include "duckdb/storage/data_table.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/functions/table.hpp"
+#include "spatial/core/operators/spatial_cache_invalidation.hpp"
+#include "spatial/core/tile_cache.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// ST_CachedTile(query)
+//------------------------------------------------------------------------------
+// Runs a query, typically one that generates a tile with ST_AsMVT or ST_AsGeoJSON, and returns its result from the
+// tile cache when the same query was run before and the tables it reads did not change since. The cache is opt-in:
+// with the default "spatial_tile_cache_size" of 0 the query is simply run every time.
+//
+//   SELECT tile FROM ST_CachedTile('SELECT ST_AsMVT(...) AS tile FROM roads WHERE ... z = 12 AND x = 2100 ...');
+//
+// The query runs on a connection of its own when the function is initialized, as a query can not run inside of
+// another one on the same connection. The cache is checked then as well, so a prepared statement that is bound once
+// still sees the writes between its runs. The other connection reads the committed state of the database through the
+// default search path, so a query that reads a table the open transaction of the calling connection wrote to, a
+// temporary table, or a table found through a different search path is rejected rather than answered from other data.
+
+struct CachedTileBindData : public TableFunctionData {
+	string query;
+	vector<LogicalType> types;
+	// The tables the query reads, as resolved when it was bound
+	vector<TileCache::ReadTable> tables;
+};
+
+struct CachedTileState : public GlobalTableFunctionState {
+	shared_ptr<TileCache::Result> result;
+	ColumnDataScanState scan_state;
+};
+
+// The rows in the storage of a table, deleted ones included, or 0 if it is not a DuckDB table. It changes with every
+// committed append, also those of appenders, which do not run a statement and so do not bump the version of the table.
+static idx_t GetTableRows(ClientContext &context, const TileCache::ReadTable &read_table) {
+	auto entry = Catalog::GetEntry(context, CatalogType::TABLE_ENTRY, read_table.catalog, read_table.schema,
+	                               read_table.table_name, OnEntryNotFound::RETURN_NULL);
+	if (!entry || entry->type != CatalogType::TABLE_ENTRY) {
+		return 0;
+	}
+	auto &table = entry->Cast<TableCatalogEntry>();
+	return table.IsDuckTable() ? table.GetStorage().GetTotalRows() : 0;
+}
+
+static bool IsSameTable(const TileCache::ReadTable &left, const TileCache::ReadTable &right) {
+	return left.catalog == right.catalog && left.schema == right.schema && left.table_name == right.table_name;
+}
+
+static bool ContainsTable(const vector<TileCache::ReadTable> &tables, const TileCache::ReadTable &table) {
+	for (auto &other : tables) {
+		if (IsSameTable(other, table)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// The tables a plan scans, by the catalog, schema and name they were resolved to. Views are expanded into the tables
+// they read by the binder.
+static void GetReadTables(LogicalOperator &op, vector<TileCache::ReadTable> &tables) {
+	if (op.type == LogicalOperatorType::LOGICAL_GET) {
+		auto table = op.Cast<LogicalGet>().GetTable();
+		if (table) {
+			TileCache::ReadTable read_table;
+			read_table.name = StringUtil::Lower(table->name);
+			read_table.catalog = table->catalog.GetName();
+			read_table.schema = table->schema.name;
+			read_table.table_name = table->name;
+			if (!ContainsTable(tables, read_table)) {
+				tables.push_back(std::move(read_table));
+			}
+		}
+	}
+	for (auto &child : op.children) {
+		GetReadTables(*child, tables);
+	}
+}
+
+static bool SameTables(const vector<TileCache::ReadTable> &left, const vector<TileCache::ReadTable> &right) {
+	if (left.size() != right.size()) {
+		return false;
+	}
+	for (auto &table : left) {
+		if (!ContainsTable(right, table)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static shared_ptr<TileCache::Result> RunQuery(ClientContext &context, const CachedTileBindData &bind_data,
+                                              const shared_ptr<TileCache> &cache) {
+	Connection con(*context.db);
+	auto result = make_shared<TileCache::Result>();
+	if (cache) {
+		// The versions are taken before the query runs, so that a write while it runs keeps it out of the cache
+		for (auto &table : bind_data.tables) {
+			auto read_table = table;
+			read_table.version = cache->GetTableVersion(read_table.name);
+			read_table.rows = GetTableRows(context, read_table);
+			result->tables.push_back(std::move(read_table));
+		}
+	}
+	auto &query = bind_data.query;
+	auto query_result = con.Query(query);
+	if (query_result->HasError()) {
+		query_result->ThrowError("ST_CachedTile: ");
+	}
+	result->types = query_result->types;
+	result->names = query_result->names;
+	result->rows = query_result->TakeCollection();
+	result->size = query.size() + result->rows->SizeInBytes();
+	return result;
+}
+
+static unique_ptr<FunctionData> CachedTileBind(ClientContext &context, TableFunctionBindInput &input,
+                                               vector<LogicalType> &return_types, vector<string> &names) {
+	if (input.inputs[0].IsNull()) {
+		throw BinderException("ST_CachedTile: the query can not be NULL");
+	}
+	auto query = StringValue::Get(input.inputs[0]);
+	Parser parser;
+	parser.ParseQuery(query);
+	if (parser.statements.size() != 1 || parser.statements[0]->type != StatementType::SELECT_STATEMENT) {
+		throw BinderException("ST_CachedTile: expected a single SELECT statement");
+	}
+
+	auto bind_data = make_uniq<CachedTileBindData>();
+	bind_data->query = query;
+
+	// The query is planned on the calling connection to find the tables it reads there, and on a new connection to
+	// check that the connection it runs on reads the same tables
+	Planner planner(context);
+	planner.CreatePlan(std::move(parser.statements[0]));
+	GetReadTables(*planner.plan, bind_data->tables);
+	bool same_tables;
+	{
+		Connection con(*context.db);
+		con.Query("PRAGMA disable_optimizer");
+		try {
+			vector<TileCache::ReadTable> run_tables;
+			GetReadTables(*con.ExtractPlan(query), run_tables);
+			same_tables = SameTables(bind_data->tables, run_tables);
+		} catch (std::exception &) {
+			// A table the calling connection found does not exist there
+			same_tables = false;
+		}
+	}
+	if (!same_tables) {
+		throw BinderException("ST_CachedTile: the query runs on a connection of its own, so it can not read temporary "
+		                      "tables or tables found through the search path of the calling connection. Use the "
+		                      "qualified names of the tables instead.");
+	}
+
+	return_types = planner.types;
+	names = planner.names;
+	bind_data->types = return_types;
+	return std::move(bind_data);
+}
+
+// Whether rows were appended to one of the tables a cached result read
+static bool RowsChanged(ClientContext &context, const TileCache::Result &result) {
+	for (auto &table : result.tables) {
+		if (GetTableRows(context, table) != table.rows) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// The query does not see the uncommitted writes of the calling connection, so it can not read a table they wrote to
+static void CheckUncommittedWrites(ClientContext &context, const CachedTileBindData &bind_data) {
+	if (context.transaction.IsAutoCommit()) {
+		return;
+	}
+	for (auto &table : bind_data.tables) {
+		if (SpatialCacheWrites::IsWritten(context, table.name)) {
+			throw InvalidInputException("ST_CachedTile: the query can not read the table \"%s\", which the open "
+			                            "transaction wrote to, as it runs on a connection of its own",
+			                            table.table_name);
+		}
+	}
+}
+
+static unique_ptr<GlobalTableFunctionState> CachedTileInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<CachedTileBindData>();
+	CheckUncommittedWrites(context, bind_data);
+	auto state = make_uniq<CachedTileState>();
+	auto capacity = TileCache::GetCapacity(context);
+	if (capacity == 0) {
+		state->result = RunQuery(context, bind_data, nullptr);
+	} else {
+		auto cache = TileCache::GetOrCreate(context);
+		state->result = cache->Lookup(bind_data.query);
+		if (!state->result || RowsChanged(context, *state->result)) {
+			state->result = RunQuery(context, bind_data, cache);
+			cache->Insert(bind_data.query, state->result, capacity);
+		}
+	}
+	if (state->result->types != bind_data.types) {
+		throw InvalidInputException("ST_CachedTile: the columns of the query changed since it was bound");
+	}
+	state->result->rows->InitializeScan(state->scan_state);
+	return std::move(state);
+}
+
+static void CachedTileExecute(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
+	auto &state = input.global_state->Cast<CachedTileState>();
+	state.result->rows->Scan(state.scan_state, output);
+}
+
+void CoreTableFunctions::RegisterCachedTileTableFunction(DatabaseInstance &db) {
+	TableFunction func("ST_CachedTile", {LogicalType::VARCHAR}, CachedTileExecute, CachedTileBind, CachedTileInit);
+	ExtensionUtil::RegisterFunction(db, func);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,183 @@
+#include "duckdb/parser/parsed_data/create_table_function_info.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/functions/table.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/types.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// ST_Dump(geom) / ST_CollectionExtract(geom, type)
+//------------------------------------------------------------------------------
+// Table in-out versions of the scalar functions, which return one row per part of the geometry instead of a LIST (or
+// a collection) that has to be built in full first. The parts are copied from the input blob without deserializing
+// it, and a geometry with more parts than fit in a chunk is continued in the next one.
+//
+//   SELECT t.id, d.geom, d.path FROM t, ST_Dump(t.geom) d;
+
+struct DumpBindData : public TableFunctionData {
+	// The part type to keep, or none to keep all parts
+	bool extract = false;
+};
+
+struct DumpLocalState : public LocalTableFunctionState {
+	// The position in the current input chunk
+	idx_t row_idx = 0;
+	bool row_loaded = false;
+
+	// The parts of the current row, pointing into its blob
+	GeometryProperties properties;
+	vector<GeometryFactory::SerializedPart> parts;
+	vector<int32_t> paths;
+	idx_t part_idx = 0;
+};
+
+static unique_ptr<FunctionData> DumpBind(ClientContext &context, TableFunctionBindInput &input,
+                                         vector<LogicalType> &return_types, vector<string> &names) {
+	auto &types = input.input_table_types;
+	if (types.empty() || types[0] != GeoTypes::GEOMETRY()) {
+		throw BinderException("ST_Dump: the first argument must be a GEOMETRY");
+	}
+	if (types.size() != 1) {
+		throw BinderException("ST_Dump: expected a single GEOMETRY argument");
+	}
+	return_types.push_back(GeoTypes::GEOMETRY());
+	names.push_back("geom");
+	return_types.push_back(LogicalType::LIST(LogicalType::INTEGER));
+	names.push_back("path");
+	return make_uniq<DumpBindData>();
+}
+
+static unique_ptr<FunctionData> CollectionExtractBind(ClientContext &context, TableFunctionBindInput &input,
+                                                      vector<LogicalType> &return_types, vector<string> &names) {
+	auto &types = input.input_table_types;
+	if (types.size() != 2 || types[0] != GeoTypes::GEOMETRY() || types[1] != LogicalType::INTEGER) {
+		throw BinderException("ST_CollectionExtract: expected a GEOMETRY and an INTEGER type argument");
+	}
+	return_types.push_back(GeoTypes::GEOMETRY());
+	names.push_back("geom");
+	return_types.push_back(LogicalType::LIST(LogicalType::INTEGER));
+	names.push_back("path");
+	auto result = make_uniq<DumpBindData>();
+	result->extract = true;
+	return std::move(result);
+}
+
+static unique_ptr<LocalTableFunctionState> DumpInitLocal(ExecutionContext &context, TableFunctionInitInput &input,
+                                                        GlobalTableFunctionState *global_state) {
+	return make_uniq<DumpLocalState>();
+}
+
+static GeometryType GetRequestedType(int32_t requested_type) {
+	switch (requested_type) {
+	case 1:
+		return GeometryType::POINT;
+	case 2:
+		return GeometryType::LINESTRING;
+	case 3:
+		return GeometryType::POLYGON;
+	default:
+		throw InvalidInputException("Invalid requested type parameter for collection extract, must be 1 "
+		                            "(POINT), 2 (LINESTRING) or 3 (POLYGON)");
+	}
+}
+
+static void LoadRow(DumpLocalState &state, const DumpBindData &bind_data, DataChunk &input) {
+	state.parts.clear();
+	state.paths.clear();
+	state.part_idx = 0;
+	state.row_loaded = true;
+
+	UnifiedVectorFormat geom_format;
+	input.data[0].ToUnifiedFormat(input.size(), geom_format);
+	auto geom_idx = geom_format.sel->get_index(state.row_idx);
+	if (!geom_format.validity.RowIsValid(geom_idx)) {
+		return;
+	}
+
+	auto geom = UnifiedVectorFormat::GetData<geometry_t>(geom_format)[geom_idx];
+	state.properties = geom.GetProperties();
+	GeometryFactory::GetSerializedParts(geom, state.parts, state.paths);
+
+	if (bind_data.extract) {
+		UnifiedVectorFormat type_format;
+		input.data[1].ToUnifiedFormat(input.size(), type_format);
+		auto type_idx = type_format.sel->get_index(state.row_idx);
+		if (!type_format.validity.RowIsValid(type_idx)) {
+			state.parts.clear();
+			return;
+		}
+		auto type = GetRequestedType(UnifiedVectorFormat::GetData<int32_t>(type_format)[type_idx]);
+		idx_t kept = 0;
+		for (auto &part : state.parts) {
+			if (part.type == type) {
+				state.parts[kept++] = part;
+			}
+		}
+		state.parts.resize(kept);
+	}
+}
+
+static OperatorResultType DumpInOut(ExecutionContext &context, TableFunctionInput &data, DataChunk &input,
+                                    DataChunk &output) {
+	auto &bind_data = data.bind_data->Cast<DumpBindData>();
+	auto &state = data.local_state->Cast<DumpLocalState>();
+
+	auto &geom_vec = output.data[0];
+	auto &path_vec = output.data[1];
+	auto geom_data = FlatVector::GetData<geometry_t>(geom_vec);
+	auto path_entries = FlatVector::GetData<list_entry_t>(path_vec);
+
+	idx_t out_idx = 0;
+	while (state.row_idx < input.size()) {
+		if (!state.row_loaded) {
+			LoadRow(state, bind_data, input);
+		}
+
+		for (; state.part_idx < state.parts.size() && out_idx < STANDARD_VECTOR_SIZE; state.part_idx++, out_idx++) {
+			auto &part = state.parts[state.part_idx];
+			geom_data[out_idx] = GeometryFactory::SerializePart(geom_vec, state.properties, part);
+
+			auto path_offset = ListVector::GetListSize(path_vec);
+			ListVector::Reserve(path_vec, path_offset + part.path_length);
+			auto path_data = FlatVector::GetData<int32_t>(ListVector::GetEntry(path_vec));
+			for (idx_t i = 0; i < part.path_length; i++) {
+				path_data[path_offset + i] = state.paths[part.path_offset + i];
+			}
+			path_entries[out_idx].offset = path_offset;
+			path_entries[out_idx].length = part.path_length;
+			ListVector::SetListSize(path_vec, path_offset + part.path_length);
+		}
+
+		if (state.part_idx < state.parts.size()) {
+			// The chunk is full, continue with the same row on the next call
+			output.SetCardinality(out_idx);
+			return OperatorResultType::HAVE_MORE_OUTPUT;
+		}
+		state.row_idx++;
+		state.row_loaded = false;
+	}
+
+	state.row_idx = 0;
+	output.SetCardinality(out_idx);
+	return OperatorResultType::NEED_MORE_INPUT;
+}
+
+void CoreTableFunctions::RegisterDumpTableFunctions(DatabaseInstance &db) {
+	TableFunction dump("ST_Dump", {LogicalType::TABLE}, nullptr, DumpBind, nullptr, DumpInitLocal);
+	dump.in_out_function = DumpInOut;
+	ExtensionUtil::RegisterFunction(db, dump);
+
+	TableFunction extract("ST_CollectionExtract", {LogicalType::TABLE}, nullptr, CollectionExtractBind, nullptr,
+	                      DumpInitLocal);
+	extract.in_out_function = DumpInOut;
+	ExtensionUtil::RegisterFunction(db, extract);
+}
+
+} // namespace core
+
+} // namespace spatial
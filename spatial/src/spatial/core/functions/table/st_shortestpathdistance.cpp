@@ -0,0 +1,188 @@
+#include "duckdb/parser/parsed_data/create_table_function_info.hpp"
+#include "duckdb/storage/object_cache.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/functions/table.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/graph/routing_graph.hpp"
+#include "spatial/core/types.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// ST_ShortestPathDistance(graph, (SELECT source, target ...))
+//------------------------------------------------------------------------------
+// The length of the shortest path between the nodes closest to the source and target points of every input row,
+// through a graph built with ST_RoutingGraph_Agg. The rows of a chunk are grouped by source node, and every group is
+// answered by a single search. The input is split over the threads of the query like any other in-out function, and
+// every thread keeps its own search buffers.
+//
+//   SELECT * FROM ST_ShortestPathDistance('roads', (SELECT origin, destination FROM trips));
+
+struct ShortestPathBindData : public TableFunctionData {
+	string graph_name;
+	// Looked up once, so that a graph replaced while the query runs does not affect it
+	shared_ptr<RoutingGraph> graph;
+};
+
+struct ShortestPathLocalState : public LocalTableFunctionState {
+	// Allocated on the first search, it holds a distance for every node of the graph
+	unique_ptr<RoutingSearch> search;
+
+	vector<uint32_t> source_nodes;
+	vector<uint32_t> target_nodes;
+	vector<bool> valid;
+	vector<uint32_t> order;
+
+	vector<uint32_t> group_targets;
+	vector<double> group_distances;
+};
+
+static unique_ptr<FunctionData> ShortestPathBind(ClientContext &context, TableFunctionBindInput &input,
+                                                 vector<LogicalType> &return_types, vector<string> &names) {
+	auto &types = input.input_table_types;
+	if (types.size() != 2 || types[0] != GeoTypes::GEOMETRY() || types[1] != GeoTypes::GEOMETRY()) {
+		throw BinderException("ST_ShortestPathDistance: expected a subquery with a source and a target GEOMETRY");
+	}
+	if (input.inputs[0].IsNull()) {
+		throw BinderException("ST_ShortestPathDistance: the graph name can not be NULL");
+	}
+
+	auto result = make_uniq<ShortestPathBindData>();
+	result->graph_name = StringValue::Get(input.inputs[0]);
+	auto &cache = ObjectCache::GetObjectCache(context);
+	result->graph = cache.Get<RoutingGraph>(RoutingGraph::GetCacheKey(result->graph_name));
+	if (!result->graph) {
+		throw BinderException("ST_ShortestPathDistance: routing graph \"%s\" does not exist, build it with "
+		                      "ST_RoutingGraph_Agg first",
+		                      result->graph_name);
+	}
+
+	return_types.push_back(GeoTypes::GEOMETRY());
+	names.push_back("source");
+	return_types.push_back(GeoTypes::GEOMETRY());
+	names.push_back("target");
+	return_types.push_back(LogicalType::DOUBLE);
+	names.push_back("distance");
+	return std::move(result);
+}
+
+static unique_ptr<LocalTableFunctionState> ShortestPathInitLocal(ExecutionContext &context,
+                                                                 TableFunctionInitInput &input,
+                                                                 GlobalTableFunctionState *global_state) {
+	return make_uniq<ShortestPathLocalState>();
+}
+
+// Snap the points of a column to the graph, NULL and empty points have no node
+static void SnapPoints(const RoutingGraph &graph, Vector &points, idx_t count, vector<uint32_t> &nodes,
+                       vector<bool> &valid) {
+	UnifiedVectorFormat format;
+	points.ToUnifiedFormat(count, format);
+	auto data = UnifiedVectorFormat::GetData<geometry_t>(format);
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = format.sel->get_index(i);
+		if (!valid[i] || !format.validity.RowIsValid(idx)) {
+			valid[i] = false;
+			continue;
+		}
+		auto &blob = data[idx];
+		if (blob.GetType() != GeometryType::POINT) {
+			throw InvalidInputException("ST_ShortestPathDistance only accepts POINT geometries");
+		}
+		double x, y;
+		if (!GeometryFactory::TryGetSerializedPoint(blob, x, y)) {
+			valid[i] = false;
+			continue;
+		}
+		auto node = graph.FindNearestNode(x, y);
+		if (node == DConstants::INVALID_INDEX) {
+			valid[i] = false;
+			continue;
+		}
+		nodes[i] = static_cast<uint32_t>(node);
+	}
+}
+
+static OperatorResultType ShortestPathInOut(ExecutionContext &context, TableFunctionInput &data, DataChunk &input,
+                                            DataChunk &output) {
+	auto &bind_data = data.bind_data->Cast<ShortestPathBindData>();
+	auto &state = data.local_state->Cast<ShortestPathLocalState>();
+	auto &graph = *bind_data.graph;
+	auto count = input.size();
+
+	state.source_nodes.resize(count);
+	state.target_nodes.resize(count);
+	state.valid.assign(count, true);
+	SnapPoints(graph, input.data[0], count, state.source_nodes, state.valid);
+	SnapPoints(graph, input.data[1], count, state.target_nodes, state.valid);
+
+	output.data[0].Reference(input.data[0]);
+	output.data[1].Reference(input.data[1]);
+	auto &distance_vec = output.data[2];
+	auto distance_data = FlatVector::GetData<double>(distance_vec);
+	auto &distance_validity = FlatVector::Validity(distance_vec);
+
+	// Group the rows by their source node
+	state.order.clear();
+	for (idx_t i = 0; i < count; i++) {
+		if (state.valid[i]) {
+			state.order.push_back(static_cast<uint32_t>(i));
+		} else {
+			distance_validity.SetInvalid(i);
+		}
+	}
+	auto &source_nodes = state.source_nodes;
+	std::sort(state.order.begin(), state.order.end(),
+	          [&](uint32_t a, uint32_t b) { return source_nodes[a] < source_nodes[b]; });
+
+	if (!state.order.empty() && !state.search) {
+		state.search = make_uniq<RoutingSearch>(graph);
+	}
+	idx_t group_start = 0;
+	while (group_start < state.order.size()) {
+		auto source = source_nodes[state.order[group_start]];
+		auto group_end = group_start + 1;
+		while (group_end < state.order.size() && source_nodes[state.order[group_end]] == source) {
+			group_end++;
+		}
+
+		if (group_end - group_start == 1) {
+			auto row = state.order[group_start];
+			distance_data[row] = state.search->OneToOne(source, state.target_nodes[row]);
+		} else {
+			state.group_targets.clear();
+			for (auto i = group_start; i < group_end; i++) {
+				state.group_targets.push_back(state.target_nodes[state.order[i]]);
+			}
+			state.search->OneToMany(source, state.group_targets, state.group_distances);
+			for (auto i = group_start; i < group_end; i++) {
+				distance_data[state.order[i]] = state.group_distances[i - group_start];
+			}
+		}
+		for (auto i = group_start; i < group_end; i++) {
+			auto row = state.order[i];
+			if (distance_data[row] == std::numeric_limits<double>::infinity()) {
+				// Not connected
+				distance_validity.SetInvalid(row);
+			}
+		}
+		group_start = group_end;
+	}
+
+	output.SetCardinality(count);
+	return OperatorResultType::NEED_MORE_INPUT;
+}
+
+void CoreTableFunctions::RegisterShortestPathDistanceTableFunction(DatabaseInstance &db) {
+	TableFunction function("ST_ShortestPathDistance", {LogicalType::VARCHAR, LogicalType::TABLE}, nullptr,
+	                       ShortestPathBind, nullptr, ShortestPathInitLocal);
+	function.in_out_function = ShortestPathInOut;
+	ExtensionUtil::RegisterFunction(db, function);
+}
+
+} // namespace core
+
+} // namespace spatial
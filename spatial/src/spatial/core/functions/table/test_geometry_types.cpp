@@ -1,17 +1,197 @@
+#include "duckdb/parser/parsed_data/create_table_function_info.hpp"
+
 #include "spatial/common.hpp"
 #include "spatial/core/types.hpp"
 #include "spatial/core/functions/table.hpp"
+#include "spatial/core/geometry/geometry.hpp"
 #include "spatial/core/geometry/geometry_factory.hpp"
 
 namespace spatial {
 
 namespace core {
 
-void CoreTableFunctions::RegisterTestTableFunctions(DatabaseInstance &db) {
+//------------------------------------------------------------------------------
+// test_geometry_types(count)
+//------------------------------------------------------------------------------
+// Generates count rows of deterministic geometries of configurable complexity, to benchmark and test the geometry
+// codecs without depending on external data. Every row has a point, a linestring and a multipolygon of polygons with
+// holes, all placed in their own 10 by 10 cell of a grid so that no two rows are the same.
+
+struct TestGeometryTypesBindData : public TableFunctionData {
+	idx_t count = 0;
+	uint32_t line_vertices = 1000;
+	uint32_t polygons = 8;
+	uint32_t holes = 8;
+	uint32_t ring_vertices = 32;
+};
+
+struct TestGeometryTypesState : public GlobalTableFunctionState {
+	explicit TestGeometryTypesState(ClientContext &context, vector<column_t> column_ids_p)
+	    : column_ids(std::move(column_ids_p)), factory(BufferAllocator::Get(context)) {
+	}
+	vector<column_t> column_ids;
+	GeometryFactory factory;
+	idx_t offset = 0;
+};
+
+static constexpr idx_t TEST_GEOMETRY_ID_COLUMN = 0;
+static constexpr idx_t TEST_GEOMETRY_POINT_COLUMN = 1;
+static constexpr idx_t TEST_GEOMETRY_LINESTRING_COLUMN = 2;
+static constexpr idx_t TEST_GEOMETRY_MULTIPOLYGON_COLUMN = 3;
+static constexpr double TEST_GEOMETRY_CELL_SIZE = 10;
+static constexpr idx_t TEST_GEOMETRY_GRID_WIDTH = 1000;
+
+static unique_ptr<FunctionData> TestGeometryTypesBind(ClientContext &context, TableFunctionBindInput &input,
+                                                      vector<LogicalType> &return_types, vector<string> &names) {
+	auto result = make_uniq<TestGeometryTypesBindData>();
+	auto &count = input.inputs[0];
+	if (count.IsNull() || count.GetValue<int64_t>() < 0) {
+		throw InvalidInputException("test_geometry_types: count must be a non-negative number");
+	}
+	result->count = count.GetValue<idx_t>();
 
-    // TODO:
-	// TableFunction test_geometry_types("test_geometry_types", {}, Execute, Bind, Init);
-	// ExtensionUtil::RegisterFunction(db, test_geometry_types);
+	for (auto &kv : input.named_parameters) {
+		if (kv.second.IsNull() || kv.second.GetValue<int32_t>() < 0) {
+			throw InvalidInputException("test_geometry_types: %s must be a non-negative number", kv.first);
+		}
+		auto value = kv.second.GetValue<uint32_t>();
+		if (kv.first == "line_vertices") {
+			if (value < 2) {
+				throw InvalidInputException("test_geometry_types: line_vertices must be at least 2");
+			}
+			result->line_vertices = value;
+		} else if (kv.first == "polygons") {
+			result->polygons = value;
+		} else if (kv.first == "holes") {
+			result->holes = value;
+		} else if (kv.first == "ring_vertices") {
+			if (value < 3) {
+				throw InvalidInputException("test_geometry_types: ring_vertices must be at least 3");
+			}
+			result->ring_vertices = value;
+		}
+	}
+
+	return_types.push_back(LogicalType::BIGINT);
+	return_types.push_back(GeoTypes::GEOMETRY());
+	return_types.push_back(GeoTypes::GEOMETRY());
+	return_types.push_back(GeoTypes::GEOMETRY());
+	names.push_back("id");
+	names.push_back("point");
+	names.push_back("linestring");
+	names.push_back("multipolygon");
+	return std::move(result);
+}
+
+static unique_ptr<GlobalTableFunctionState> TestGeometryTypesInit(ClientContext &context,
+                                                                  TableFunctionInitInput &input) {
+	return make_uniq<TestGeometryTypesState>(context, input.column_ids);
+}
+
+// A closed ring of vertex_count distinct vertices on a circle, counter-clockwise unless reversed
+static VertexArray CreateCircle(ArenaAllocator &arena, double cx, double cy, double radius, uint32_t vertex_count,
+                                bool reverse) {
+	auto ring = VertexArray::Create(arena, vertex_count + 1, false, false);
+	for (uint32_t i = 0; i < vertex_count; i++) {
+		auto angle = 2 * PI * i / vertex_count;
+		if (reverse) {
+			angle = -angle;
+		}
+		ring.Set(i, cx + radius * std::cos(angle), cy + radius * std::sin(angle));
+	}
+	ring.Set(vertex_count, cx + radius, cy);
+	return ring;
+}
+
+static Geometry CreateLineString(ArenaAllocator &arena, const TestGeometryTypesBindData &bind_data, double x0,
+                                 double y0) {
+	auto vertices = VertexArray::Create(arena, bind_data.line_vertices, false, false);
+	auto step = TEST_GEOMETRY_CELL_SIZE / (bind_data.line_vertices - 1);
+	for (uint32_t i = 0; i < bind_data.line_vertices; i++) {
+		auto x = i * step;
+		vertices.Set(i, x0 + x, y0 + TEST_GEOMETRY_CELL_SIZE / 2 + std::sin(x * 3) * TEST_GEOMETRY_CELL_SIZE / 4);
+	}
+	return LineString(vertices);
+}
+
+// The polygons are circles side by side in the cell, with the holes on a circle of half the radius around their center
+static Geometry CreateMultiPolygon(ArenaAllocator &arena, const TestGeometryTypesBindData &bind_data, double x0,
+                                   double y0) {
+	MultiPolygon multi_polygon(arena, bind_data.polygons, false, false);
+	auto width = TEST_GEOMETRY_CELL_SIZE / MaxValue<uint32_t>(bind_data.polygons, 1);
+	auto radius = width * 0.45;
+	auto hole_radius = bind_data.holes < 2 ? radius * 0.2 : radius * 0.2 * std::sin(PI / bind_data.holes);
+	for (uint32_t i = 0; i < bind_data.polygons; i++) {
+		auto cx = x0 + width * (i + 0.5);
+		auto cy = y0 + TEST_GEOMETRY_CELL_SIZE / 2;
+		Polygon polygon(arena, bind_data.holes + 1, false, false);
+		polygon[0] = CreateCircle(arena, cx, cy, radius, bind_data.ring_vertices, false);
+		for (uint32_t j = 0; j < bind_data.holes; j++) {
+			auto angle = 2 * PI * j / bind_data.holes;
+			polygon[j + 1] = CreateCircle(arena, cx + radius * 0.5 * std::cos(angle),
+			                              cy + radius * 0.5 * std::sin(angle), hole_radius, bind_data.ring_vertices,
+			                              true);
+		}
+		multi_polygon[i] = polygon;
+	}
+	return multi_polygon;
+}
+
+static void TestGeometryTypesExecute(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
+	auto &bind_data = input.bind_data->Cast<TestGeometryTypesBindData>();
+	auto &state = input.global_state->Cast<TestGeometryTypesState>();
+
+	auto count = MinValue<idx_t>(STANDARD_VECTOR_SIZE, bind_data.count - state.offset);
+	auto &factory = state.factory;
+	factory.allocator.Reset();
+
+	for (idx_t col_idx = 0; col_idx < output.ColumnCount(); col_idx++) {
+		auto column_id = state.column_ids[col_idx];
+		auto &col_vec = output.data[col_idx];
+		if (column_id == TEST_GEOMETRY_ID_COLUMN) {
+			auto ids = FlatVector::GetData<int64_t>(col_vec);
+			for (idx_t i = 0; i < count; i++) {
+				ids[i] = static_cast<int64_t>(state.offset + i);
+			}
+			continue;
+		}
+		if (column_id > TEST_GEOMETRY_MULTIPOLYGON_COLUMN) {
+			// The row id
+			col_vec.SetVectorType(VectorType::CONSTANT_VECTOR);
+			ConstantVector::SetNull(col_vec, true);
+			continue;
+		}
+		auto geoms = FlatVector::GetData<geometry_t>(col_vec);
+		for (idx_t i = 0; i < count; i++) {
+			auto id = state.offset + i;
+			auto x0 = static_cast<double>(id % TEST_GEOMETRY_GRID_WIDTH) * TEST_GEOMETRY_CELL_SIZE;
+			auto y0 = static_cast<double>(id / TEST_GEOMETRY_GRID_WIDTH) * TEST_GEOMETRY_CELL_SIZE;
+			if (column_id == TEST_GEOMETRY_POINT_COLUMN) {
+				geoms[i] = GeometryFactory::SerializePoint2D(col_vec, x0 + TEST_GEOMETRY_CELL_SIZE / 2,
+				                                            y0 + TEST_GEOMETRY_CELL_SIZE / 2);
+			} else if (column_id == TEST_GEOMETRY_LINESTRING_COLUMN) {
+				auto line = CreateLineString(factory.allocator, bind_data, x0, y0);
+				geoms[i] = factory.Serialize(col_vec, line, false, false);
+			} else {
+				auto multi_polygon = CreateMultiPolygon(factory.allocator, bind_data, x0, y0);
+				geoms[i] = factory.Serialize(col_vec, multi_polygon, false, false);
+			}
+		}
+	}
+
+	state.offset += count;
+	output.SetCardinality(count);
+}
+
+void CoreTableFunctions::RegisterTestTableFunctions(DatabaseInstance &db) {
+	TableFunction test_geometry_types("test_geometry_types", {LogicalType::BIGINT}, TestGeometryTypesExecute,
+	                                  TestGeometryTypesBind, TestGeometryTypesInit);
+	test_geometry_types.named_parameters["line_vertices"] = LogicalType::INTEGER;
+	test_geometry_types.named_parameters["polygons"] = LogicalType::INTEGER;
+	test_geometry_types.named_parameters["holes"] = LogicalType::INTEGER;
+	test_geometry_types.named_parameters["ring_vertices"] = LogicalType::INTEGER;
+	test_geometry_types.projection_pushdown = true;
+	ExtensionUtil::RegisterFunction(db, test_geometry_types);
 }
 
 } // namespace core
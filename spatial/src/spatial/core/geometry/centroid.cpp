@@ -0,0 +1,271 @@
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/centroid.hpp"
+#include "spatial/core/geometry/geometry_processor.hpp"
+
+namespace spatial {
+
+namespace core {
+
+static inline VertexXY GetVertex(const VertexData &vertices, uint32_t i) {
+	return {Load<double>(vertices.data[0] + i * vertices.stride[0]),
+	        Load<double>(vertices.data[1] + i * vertices.stride[1])};
+}
+
+//------------------------------------------------------------------------------
+// Centroid
+//------------------------------------------------------------------------------
+// Like geos::algorithm::Centroid, the rings are split into triangles with the first vertex of the shell of their
+// polygon. The orientation of a ring is taken from the sign of its area, so that shells add to the area and holes
+// subtract from it whichever way they are oriented.
+class CentroidProcessor final : GeometryProcessor<> {
+private:
+	VertexXY base = {0, 0};
+	double area_sum2 = 0;
+	double area_sum_x = 0;
+	double area_sum_y = 0;
+	double length_sum = 0;
+	double line_sum_x = 0;
+	double line_sum_y = 0;
+	double point_sum_x = 0;
+	double point_sum_y = 0;
+	idx_t point_count = 0;
+
+	void AddPoint(const VertexXY &point) {
+		point_count++;
+		point_sum_x += point.x;
+		point_sum_y += point.y;
+	}
+
+	void AddLineSegments(const VertexData &vertices) {
+		double length = 0;
+		for (uint32_t i = 1; i < vertices.count; i++) {
+			auto p0 = GetVertex(vertices, i - 1);
+			auto p1 = GetVertex(vertices, i);
+			auto segment_length = std::sqrt((p1.x - p0.x) * (p1.x - p0.x) + (p1.y - p0.y) * (p1.y - p0.y));
+			if (segment_length == 0) {
+				continue;
+			}
+			length += segment_length;
+			line_sum_x += segment_length * (p0.x + p1.x) / 2;
+			line_sum_y += segment_length * (p0.y + p1.y) / 2;
+		}
+		length_sum += length;
+		// A line without length counts as a point
+		if (length == 0 && vertices.count > 0) {
+			AddPoint(GetVertex(vertices, 0));
+		}
+	}
+
+	void AddRing(const VertexData &vertices, bool is_shell) {
+		double ring_area2 = 0;
+		double ring_sum_x = 0;
+		double ring_sum_y = 0;
+		for (uint32_t i = 1; i < vertices.count; i++) {
+			auto p1 = GetVertex(vertices, i - 1);
+			auto p2 = GetVertex(vertices, i);
+			auto area2 = (p1.x - base.x) * (p2.y - base.y) - (p2.x - base.x) * (p1.y - base.y);
+			ring_area2 += area2;
+			ring_sum_x += area2 * (base.x + p1.x + p2.x);
+			ring_sum_y += area2 * (base.y + p1.y + p2.y);
+		}
+		// Clockwise shells and counter-clockwise holes have a positive area in GEOS
+		auto is_ccw = ring_area2 > 0;
+		double sign = is_shell != is_ccw ? 1 : -1;
+		area_sum2 += sign * ring_area2;
+		area_sum_x += sign * ring_sum_x;
+		area_sum_y += sign * ring_sum_y;
+		AddLineSegments(vertices);
+	}
+
+	void ProcessPoint(const VertexData &vertices) override {
+		if (!vertices.IsEmpty()) {
+			AddPoint(GetVertex(vertices, 0));
+		}
+	}
+
+	void ProcessLineString(const VertexData &vertices) override {
+		AddLineSegments(vertices);
+	}
+
+	void ProcessPolygon(PolygonState &state) override {
+		if (state.IsDone()) {
+			return;
+		}
+		auto shell = state.Next();
+		if (shell.IsEmpty()) {
+			return;
+		}
+		base = GetVertex(shell, 0);
+		AddRing(shell, true);
+		while (!state.IsDone()) {
+			AddRing(state.Next(), false);
+		}
+	}
+
+	void ProcessCollection(CollectionState &state) override {
+		while (!state.IsDone()) {
+			state.Next();
+		}
+	}
+
+public:
+	bool Execute(const geometry_t &geom, VertexXY &centroid) {
+		Process(geom);
+		if (std::abs(area_sum2) > 0) {
+			centroid.x = area_sum_x / 3 / area_sum2;
+			centroid.y = area_sum_y / 3 / area_sum2;
+		} else if (length_sum > 0) {
+			centroid.x = line_sum_x / length_sum;
+			centroid.y = line_sum_y / length_sum;
+		} else if (point_count > 0) {
+			centroid.x = point_sum_x / static_cast<double>(point_count);
+			centroid.y = point_sum_y / static_cast<double>(point_count);
+		} else {
+			return false;
+		}
+		return true;
+	}
+};
+
+bool Centroid::TryGetCentroid(const geometry_t &geom, VertexXY &centroid) {
+	CentroidProcessor processor;
+	return processor.Execute(geom, centroid);
+}
+
+//------------------------------------------------------------------------------
+// Interior Point
+//------------------------------------------------------------------------------
+// Like geos::algorithm::InteriorPointArea, every polygon is cut by a horizontal scan line between the two vertices
+// closest to the middle of its height, so that the line does not go through a vertex. The polygon with the widest
+// section of its scan line inside of it wins, and the interior point is the middle of that section.
+class InteriorPointProcessor final : GeometryProcessor<> {
+private:
+	vector<VertexData> rings;
+	vector<double> crossings;
+	bool has_polygons = false;
+	double max_width = -1;
+	VertexXY point = {0, 0};
+
+	static double GetScanLineY(const vector<VertexData> &rings) {
+		auto &shell = rings[0];
+		auto lo_y = NumericLimits<double>::Maximum();
+		auto hi_y = NumericLimits<double>::Minimum();
+		for (uint32_t i = 0; i < shell.count; i++) {
+			auto y = GetVertex(shell, i).y;
+			lo_y = MinValue(lo_y, y);
+			hi_y = MaxValue(hi_y, y);
+		}
+		auto centre_y = (lo_y + hi_y) / 2;
+		for (auto &ring : rings) {
+			for (uint32_t i = 0; i < ring.count; i++) {
+				auto y = GetVertex(ring, i).y;
+				if (y <= centre_y) {
+					lo_y = MaxValue(lo_y, y);
+				} else {
+					hi_y = MinValue(hi_y, y);
+				}
+			}
+		}
+		return (lo_y + hi_y) / 2;
+	}
+
+	// Horizontal edges are skipped, and edges that only touch the scan line count at their upper vertex
+	static bool IsEdgeCrossingCounted(const VertexXY &p0, const VertexXY &p1, double scan_y) {
+		if ((p0.y > scan_y && p1.y > scan_y) || (p0.y < scan_y && p1.y < scan_y) || p0.y == p1.y) {
+			return false;
+		}
+		if (p0.y == scan_y && p1.y < scan_y) {
+			return false;
+		}
+		if (p1.y == scan_y && p0.y < scan_y) {
+			return false;
+		}
+		return true;
+	}
+
+	static double GetCrossingX(const VertexXY &p0, const VertexXY &p1, double scan_y) {
+		if (p0.x == p1.x) {
+			return p0.x;
+		}
+		auto slope = (p1.y - p0.y) / (p1.x - p0.x);
+		return p0.x + (scan_y - p0.y) / slope;
+	}
+
+	void ProcessRings() {
+		auto scan_y = GetScanLineY(rings);
+		crossings.clear();
+		for (auto &ring : rings) {
+			for (uint32_t i = 1; i < ring.count; i++) {
+				auto p0 = GetVertex(ring, i - 1);
+				auto p1 = GetVertex(ring, i);
+				if (IsEdgeCrossingCounted(p0, p1, scan_y)) {
+					crossings.push_back(GetCrossingX(p0, p1, scan_y));
+				}
+			}
+		}
+		std::sort(crossings.begin(), crossings.end());
+
+		// Without a section of any width, e.g. for a polygon without area, the point is the first vertex
+		auto width = 0.0;
+		auto polygon_point = GetVertex(rings[0], 0);
+		for (idx_t i = 0; i + 1 < crossings.size(); i += 2) {
+			auto section_width = crossings[i + 1] - crossings[i];
+			if (section_width > width) {
+				width = section_width;
+				polygon_point = {(crossings[i] + crossings[i + 1]) / 2, scan_y};
+			}
+		}
+		if (width > max_width) {
+			max_width = width;
+			point = polygon_point;
+		}
+	}
+
+	void ProcessPoint(const VertexData &) override {
+	}
+
+	void ProcessLineString(const VertexData &) override {
+	}
+
+	void ProcessPolygon(PolygonState &state) override {
+		has_polygons = true;
+		rings.clear();
+		while (!state.IsDone()) {
+			rings.push_back(state.Next());
+		}
+		if (rings.empty() || rings[0].IsEmpty()) {
+			return;
+		}
+		ProcessRings();
+	}
+
+	void ProcessCollection(CollectionState &state) override {
+		// A MULTIPOLYGON has two dimensions even when it is empty
+		if (CurrentType() == GeometryType::MULTIPOLYGON) {
+			has_polygons = true;
+		}
+		while (!state.IsDone()) {
+			state.Next();
+		}
+	}
+
+public:
+	bool Execute(const geometry_t &geom, VertexXY &result, bool &is_empty) {
+		Process(geom);
+		if (!has_polygons) {
+			return false;
+		}
+		is_empty = max_width < 0;
+		result = point;
+		return true;
+	}
+};
+
+bool Centroid::TryGetInteriorPoint(const geometry_t &geom, VertexXY &point, bool &is_empty) {
+	InteriorPointProcessor processor;
+	return processor.Execute(geom, point, is_empty);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,361 @@
+#include "spatial/core/geometry/clip_by_box.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+
+namespace spatial {
+
+namespace core {
+
+using ClipVertex = BoxClipper::ClipVertex;
+
+geometry_t BoxClipper::Execute(const geometry_t &geom, const BoundingBox &box_p, GeometryWriter &writer_p,
+                               Vector &result) {
+	BoundingBox bbox;
+	if (!GeometryFactory::TryGetSerializedBoundingBox(geom, bbox)) {
+		// Empty
+		return geom;
+	}
+	if (bbox.minx >= box_p.minx && bbox.miny >= box_p.miny && bbox.maxx <= box_p.maxx && bbox.maxy <= box_p.maxy) {
+		return geom;
+	}
+
+	auto props = geom.GetProperties();
+	auto type = geom.GetType();
+	box = box_p;
+	writer = &writer_p;
+	writer->Begin(type, props.HasZ(), props.HasM());
+	if (!bbox.Intersects(box)) {
+		switch (type) {
+		case GeometryType::POINT:
+			writer->AddPoint(true);
+			break;
+		case GeometryType::LINESTRING:
+			writer->AddLineString(0);
+			break;
+		case GeometryType::POLYGON:
+			writer->AddPolygon(0);
+			break;
+		default:
+			writer->AddCollection(type, 0);
+			break;
+		}
+		return writer->End(result);
+	}
+	Process(geom);
+	return writer->End(result);
+}
+
+static ClipVertex LoadVertex(const VertexData &data, uint32_t i) {
+	return {Load<double>(data.data[0] + i * data.stride[0]), Load<double>(data.data[1] + i * data.stride[1]),
+	        Load<double>(data.data[2] + i * data.stride[2]), Load<double>(data.data[3] + i * data.stride[3])};
+}
+
+static ClipVertex Interpolate(const ClipVertex &a, const ClipVertex &b, double t) {
+	return {a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t, a.m + (b.m - a.m) * t};
+}
+
+static bool IsInside(const BoundingBox &box, const ClipVertex &v) {
+	return v.x >= box.minx && v.x <= box.maxx && v.y >= box.miny && v.y <= box.maxy;
+}
+
+void BoxClipper::WriteVertices(uint32_t begin, uint32_t end) {
+	for (auto i = begin; i < end; i++) {
+		auto &v = vertices[i];
+		writer->AddVertex(v.x, v.y, v.z, v.m);
+	}
+}
+
+//------------------------------------------------------------------------------
+// Liang-Barsky
+//------------------------------------------------------------------------------
+// The range [t0, t1] of the segment from a to b that is inside the box, returns false if there is none
+static bool ClipSegment(const BoundingBox &box, const ClipVertex &a, const ClipVertex &b, double &t0, double &t1) {
+	auto dx = b.x - a.x;
+	auto dy = b.y - a.y;
+	const double p[4] = {-dx, dx, -dy, dy};
+	const double q[4] = {a.x - box.minx, box.maxx - a.x, a.y - box.miny, box.maxy - a.y};
+	t0 = 0;
+	t1 = 1;
+	for (idx_t i = 0; i < 4; i++) {
+		if (p[i] == 0) {
+			// Parallel to this side of the box
+			if (q[i] < 0) {
+				return false;
+			}
+			continue;
+		}
+		auto t = q[i] / p[i];
+		if (p[i] < 0) {
+			if (t > t1) {
+				return false;
+			}
+			t0 = MaxValue(t0, t);
+		} else {
+			if (t < t0) {
+				return false;
+			}
+			t1 = MinValue(t1, t);
+		}
+	}
+	return true;
+}
+
+// A vertex where a segment crosses the boundary, which rounding may have put just outside of the box
+static ClipVertex CrossingVertex(const BoundingBox &box, const ClipVertex &a, const ClipVertex &b, double t) {
+	auto v = Interpolate(a, b, t);
+	v.x = MinValue(MaxValue(v.x, box.minx), box.maxx);
+	v.y = MinValue(MaxValue(v.y, box.miny), box.maxy);
+	return v;
+}
+
+void BoxClipper::ClipLine(const VertexData &data) {
+	auto piece_begin = vertices.size();
+	bool is_open = false;
+	auto close_piece = [&]() {
+		if (!is_open) {
+			return;
+		}
+		is_open = false;
+		// A piece that only touches the box is dropped
+		if (vertices.size() - piece_begin < 2) {
+			vertices.resize(piece_begin);
+			return;
+		}
+		ends.push_back(static_cast<uint32_t>(vertices.size()));
+	};
+
+	if (data.count < 2) {
+		return;
+	}
+	auto prev = LoadVertex(data, 0);
+	for (uint32_t i = 1; i < data.count; i++) {
+		auto next = LoadVertex(data, i);
+		double t0, t1;
+		if (!ClipSegment(box, prev, next, t0, t1)) {
+			close_piece();
+			prev = next;
+			continue;
+		}
+		// The segment enters the box, or continues the current piece from its last vertex
+		if (!is_open || t0 > 0) {
+			close_piece();
+			piece_begin = vertices.size();
+			is_open = true;
+			vertices.push_back(t0 > 0 ? CrossingVertex(box, prev, next, t0) : prev);
+		}
+		auto exit = t1 < 1 ? CrossingVertex(box, prev, next, t1) : next;
+		auto &last = vertices.back();
+		if (exit.x != last.x || exit.y != last.y) {
+			vertices.push_back(exit);
+		}
+		if (t1 < 1) {
+			close_piece();
+		}
+		prev = next;
+	}
+	close_piece();
+}
+
+//------------------------------------------------------------------------------
+// Sutherland-Hodgman
+//------------------------------------------------------------------------------
+// The sides of the box, in the order the ring is clipped against them: min x, max x, min y, max y
+
+static bool IsInsideSide(const BoundingBox &box, const ClipVertex &v, idx_t side) {
+	switch (side) {
+	case 0:
+		return v.x >= box.minx;
+	case 1:
+		return v.x <= box.maxx;
+	case 2:
+		return v.y >= box.miny;
+	default:
+		return v.y <= box.maxy;
+	}
+}
+
+// The vertex where the edge from a to b crosses a side of the box, with exactly the coordinate of that side
+static ClipVertex IntersectSide(const BoundingBox &box, const ClipVertex &a, const ClipVertex &b, idx_t side) {
+	if (side < 2) {
+		auto x = side == 0 ? box.minx : box.maxx;
+		auto v = Interpolate(a, b, (x - a.x) / (b.x - a.x));
+		v.x = x;
+		return v;
+	}
+	auto y = side == 2 ? box.miny : box.maxy;
+	auto v = Interpolate(a, b, (y - a.y) / (b.y - a.y));
+	v.y = y;
+	return v;
+}
+
+bool BoxClipper::ClipRing(const VertexData &data) {
+	if (data.count < 4) {
+		return false;
+	}
+
+	BoundingBox ring_box;
+	for (uint32_t i = 0; i < data.count; i++) {
+		auto x = Load<double>(data.data[0] + i * data.stride[0]);
+		auto y = Load<double>(data.data[1] + i * data.stride[1]);
+		ring_box.minx = MinValue(ring_box.minx, x);
+		ring_box.miny = MinValue(ring_box.miny, y);
+		ring_box.maxx = MaxValue(ring_box.maxx, x);
+		ring_box.maxy = MaxValue(ring_box.maxy, y);
+	}
+	if (!ring_box.Intersects(box)) {
+		return false;
+	}
+	if (ring_box.minx >= box.minx && ring_box.miny >= box.miny && ring_box.maxx <= box.maxx &&
+	    ring_box.maxy <= box.maxy) {
+		for (uint32_t i = 0; i < data.count; i++) {
+			vertices.push_back(LoadVertex(data, i));
+		}
+		ends.push_back(static_cast<uint32_t>(vertices.size()));
+		return true;
+	}
+
+	// Clip the ring without its closing vertex against each side in turn
+	ring_in.clear();
+	for (uint32_t i = 0; i + 1 < data.count; i++) {
+		ring_in.push_back(LoadVertex(data, i));
+	}
+	for (idx_t side = 0; side < 4 && !ring_in.empty(); side++) {
+		ring_out.clear();
+		auto count = ring_in.size();
+		for (idx_t i = 0; i < count; i++) {
+			auto &prev = ring_in[(i + count - 1) % count];
+			auto &curr = ring_in[i];
+			auto prev_inside = IsInsideSide(box, prev, side);
+			auto curr_inside = IsInsideSide(box, curr, side);
+			if (prev_inside != curr_inside) {
+				ring_out.push_back(IntersectSide(box, prev, curr, side));
+			}
+			if (curr_inside) {
+				ring_out.push_back(curr);
+			}
+		}
+		std::swap(ring_in, ring_out);
+	}
+
+	// Drop the repeated vertices, and close the ring again
+	auto begin = vertices.size();
+	for (auto &v : ring_in) {
+		if (vertices.size() > begin && vertices.back().x == v.x && vertices.back().y == v.y) {
+			continue;
+		}
+		vertices.push_back(v);
+	}
+	while (vertices.size() > begin + 1 && vertices.back().x == vertices[begin].x &&
+	       vertices.back().y == vertices[begin].y) {
+		vertices.pop_back();
+	}
+	if (vertices.size() - begin < 3) {
+		vertices.resize(begin);
+		return false;
+	}
+	vertices.push_back(vertices[begin]);
+	ends.push_back(static_cast<uint32_t>(vertices.size()));
+	return true;
+}
+
+//------------------------------------------------------------------------------
+// Geometries
+//------------------------------------------------------------------------------
+// Each returns the number of items it wrote, which is 0 for a nested geometry that is dropped
+
+uint32_t BoxClipper::ProcessPoint(const VertexData &data) {
+	if (data.count == 0 || !IsInside(box, LoadVertex(data, 0))) {
+		if (IsNested()) {
+			return 0;
+		}
+		writer->AddPoint(true);
+		return 1;
+	}
+	auto v = LoadVertex(data, 0);
+	writer->AddPoint(false);
+	writer->AddVertex(v.x, v.y, v.z, v.m);
+	return 1;
+}
+
+uint32_t BoxClipper::ProcessLineString(const VertexData &data) {
+	vertices.clear();
+	ends.clear();
+	ClipLine(data);
+
+	auto piece_count = static_cast<uint32_t>(ends.size());
+	if (piece_count == 0) {
+		if (IsNested()) {
+			return 0;
+		}
+		writer->AddLineString(0);
+		return 1;
+	}
+
+	uint32_t item_count = 1;
+	if (piece_count > 1) {
+		if (!IsNested()) {
+			// Nothing has been written yet, start over as a MULTILINESTRING
+			writer->Begin(GeometryType::MULTILINESTRING, HasZ(), HasM());
+			writer->AddCollection(GeometryType::MULTILINESTRING, piece_count);
+		} else if (ParentType() == GeometryType::MULTILINESTRING) {
+			// The pieces become items of the parent
+			item_count = piece_count;
+		} else {
+			writer->AddCollection(GeometryType::MULTILINESTRING, piece_count);
+		}
+	}
+	uint32_t begin = 0;
+	for (auto end : ends) {
+		writer->AddLineString(end - begin);
+		WriteVertices(begin, end);
+		begin = end;
+	}
+	return item_count;
+}
+
+uint32_t BoxClipper::ProcessPolygon(PolygonState &state) {
+	vertices.clear();
+	ends.clear();
+	while (!state.IsDone()) {
+		auto ring = state.Next();
+		// A collapsed shell takes the holes with it
+		if (!ClipRing(ring) && ends.empty()) {
+			break;
+		}
+	}
+	if (ends.empty()) {
+		if (IsNested()) {
+			return 0;
+		}
+		writer->AddPolygon(0);
+		return 1;
+	}
+
+	// The vertex counts of all the rings come before the vertices of the first ring
+	writer->AddPolygon(static_cast<uint32_t>(ends.size()));
+	uint32_t begin = 0;
+	for (auto end : ends) {
+		writer->AddRing(end - begin);
+		begin = end;
+	}
+	begin = 0;
+	for (auto end : ends) {
+		WriteVertices(begin, end);
+		begin = end;
+	}
+	return 1;
+}
+
+uint32_t BoxClipper::ProcessCollection(CollectionState &state) {
+	// The item count is only known once the items outside of the box are dropped
+	auto offset = writer->AddCollection(CurrentType(), 0);
+	uint32_t item_count = 0;
+	while (!state.IsDone()) {
+		item_count += state.Next();
+	}
+	writer->SetCount(offset, item_count);
+	return 1;
+}
+
+} // namespace core
+
+} // namespace spatial
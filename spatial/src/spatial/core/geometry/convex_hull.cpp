@@ -0,0 +1,146 @@
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/convex_hull.hpp"
+#include "spatial/core/geometry/geometry_processor.hpp"
+#include "spatial/core/geometry/predicates.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Collect vertices
+//------------------------------------------------------------------------------
+class HullVertexCollector final : GeometryProcessor<void, vector<VertexXY> &> {
+private:
+	static void Append(const VertexData &data, vector<VertexXY> &points) {
+		for (uint32_t i = 0; i < data.count; i++) {
+			auto x = Load<double>(data.data[0] + i * data.stride[0]);
+			auto y = Load<double>(data.data[1] + i * data.stride[1]);
+			points.push_back({x, y});
+		}
+	}
+
+	void ProcessPoint(const VertexData &vertices, vector<VertexXY> &points) override {
+		Append(vertices, points);
+	}
+
+	void ProcessLineString(const VertexData &vertices, vector<VertexXY> &points) override {
+		Append(vertices, points);
+	}
+
+	void ProcessPolygon(PolygonState &state, vector<VertexXY> &points) override {
+		// Holes are inside the shell, so they can not contribute to the hull
+		if (!state.IsDone()) {
+			Append(state.Next(), points);
+		}
+	}
+
+	void ProcessCollection(CollectionState &state, vector<VertexXY> &points) override {
+		while (!state.IsDone()) {
+			state.Next(points);
+		}
+	}
+
+public:
+	void Execute(const geometry_t &geom, vector<VertexXY> &points) {
+		Process(geom, points);
+	}
+};
+
+void ConvexHull::AppendVertices(const geometry_t &geom, vector<VertexXY> &points) {
+	HullVertexCollector collector;
+	collector.Execute(geom, points);
+}
+
+//------------------------------------------------------------------------------
+// Monotone chain
+//------------------------------------------------------------------------------
+// 1 if o -> a -> b turns counter-clockwise, -1 if clockwise and 0 if the points are collinear. This has to be exact,
+// a rounded cross product can keep a collinear vertex or drop a hull vertex that is almost collinear.
+static inline int Turn(const VertexXY &o, const VertexXY &a, const VertexXY &b) {
+	return Predicates::Orient2D(o.x, o.y, a.x, a.y, b.x, b.y);
+}
+
+void ConvexHull::Reduce(vector<VertexXY> &points) {
+	auto count = points.size();
+	if (count < 2) {
+		return;
+	}
+	std::sort(points.begin(), points.end(), [](const VertexXY &a, const VertexXY &b) {
+		return a.x < b.x || (a.x == b.x && a.y < b.y);
+	});
+
+	// Build the lower and then the upper chain in place, the chains only ever shrink behind the read position
+	vector<VertexXY> hull(2 * count);
+	idx_t size = 0;
+	for (idx_t i = 0; i < count; i++) {
+		while (size >= 2 && Turn(hull[size - 2], hull[size - 1], points[i]) <= 0) {
+			size--;
+		}
+		hull[size++] = points[i];
+	}
+	auto lower_size = size + 1;
+	for (idx_t i = count - 1; i > 0; i--) {
+		auto &point = points[i - 1];
+		while (size >= lower_size && Turn(hull[size - 2], hull[size - 1], point) <= 0) {
+			size--;
+		}
+		hull[size++] = point;
+	}
+	// The last vertex is the first one again
+	size--;
+
+	// All points are the same
+	if (size == 1 || (size == 2 && hull[0].x == hull[1].x && hull[0].y == hull[1].y)) {
+		size = 1;
+	}
+	hull.resize(size);
+	points = std::move(hull);
+}
+
+//------------------------------------------------------------------------------
+// Serialize
+//------------------------------------------------------------------------------
+geometry_t ConvexHull::Serialize(GeometryFactory &factory, Vector &result, const vector<VertexXY> &hull) {
+	auto &arena = factory.allocator;
+	auto count = hull.size();
+	if (count == 0) {
+		GeometryCollection empty(false, false);
+		return factory.Serialize(result, empty, false, false);
+	}
+	if (count == 1) {
+		Point point(arena, hull[0].x, hull[0].y);
+		return factory.Serialize(result, point, false, false);
+	}
+	if (count > NumericLimits<uint32_t>::Maximum() - 1) {
+		throw InvalidInputException("Too many vertices for a single convex hull");
+	}
+
+	// Start at the lowest, then leftmost vertex and go clockwise
+	idx_t start = 0;
+	for (idx_t i = 1; i < count; i++) {
+		if (hull[i].y < hull[start].y || (hull[i].y == hull[start].y && hull[i].x < hull[start].x)) {
+			start = i;
+		}
+	}
+	if (count == 2) {
+		LineString line(arena, 2, false, false);
+		line.Vertices().Set(0, hull[start].x, hull[start].y);
+		line.Vertices().Set(1, hull[1 - start].x, hull[1 - start].y);
+		return factory.Serialize(result, line, false, false);
+	}
+
+	auto ring_size = static_cast<uint32_t>(count + 1);
+	Polygon polygon(arena, 1, &ring_size, false, false);
+	auto &shell = polygon[0];
+	for (idx_t i = 0; i < count; i++) {
+		auto &vertex = hull[(start + count - i) % count];
+		shell.Set(static_cast<uint32_t>(i), vertex.x, vertex.y);
+	}
+	shell.Set(static_cast<uint32_t>(count), hull[start].x, hull[start].y);
+	return factory.Serialize(result, polygon, false, false);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,280 @@
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geojson_reader.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+
+namespace spatial {
+
+namespace core {
+
+using namespace duckdb_yyjson_spatial;
+
+static Point PointFromGeoJSON(yyjson_val *coord_array, GeometryFactory &factory, const string_t &raw, bool &has_z) {
+	auto len = yyjson_arr_size(coord_array);
+	if (len == 0) {
+		// empty point
+		return Point(has_z, false);
+	}
+	if (len < 2) {
+		throw InvalidInputException("GeoJSON input coordinates field is not an array of at least length 2: %s",
+		                            raw.GetString());
+	}
+	auto x_val = yyjson_arr_get_first(coord_array);
+	if (!yyjson_is_num(x_val)) {
+		throw InvalidInputException("GeoJSON input coordinates field is not an array of numbers: %s", raw.GetString());
+	}
+	auto y_val = yyjson_arr_get(coord_array, 1);
+	if (!yyjson_is_num(y_val)) {
+		throw InvalidInputException("GeoJSON input coordinates field is not an array of numbers: %s", raw.GetString());
+	}
+
+	auto x = yyjson_get_num(x_val);
+	auto y = yyjson_get_num(y_val);
+
+	auto geom_has_z = len > 2;
+	if (geom_has_z) {
+		has_z = true;
+		auto z_val = yyjson_arr_get(coord_array, 2);
+		if (!yyjson_is_num(z_val)) {
+			throw InvalidInputException("GeoJSON input coordinates field is not an array of numbers: %s",
+			                            raw.GetString());
+		}
+		auto z = yyjson_get_num(z_val);
+		return Point(factory.allocator, x, y, z);
+	} else {
+		return Point(factory.allocator, x, y);
+	}
+}
+
+static VertexArray VerticesFromGeoJSON(yyjson_val *coord_array, GeometryFactory &factory, const string_t &raw,
+                                       bool &has_z) {
+	auto len = yyjson_arr_size(coord_array);
+	if (len == 0) {
+		// Empty
+		return VertexArray::Empty(false, false);
+	} else {
+		// Sniff the coordinates to see if we have Z
+		bool has_any_z = false;
+		size_t idx, max;
+		yyjson_val *coord;
+		yyjson_arr_foreach(coord_array, idx, max, coord) {
+			if (!yyjson_is_arr(coord)) {
+				throw InvalidInputException("GeoJSON input coordinates field is not an array of arrays: %s",
+				                            raw.GetString());
+			}
+			auto coord_len = yyjson_arr_size(coord);
+			if (coord_len > 2) {
+				has_any_z = true;
+			} else if (coord_len < 2) {
+				throw InvalidInputException(
+				    "GeoJSON input coordinates field is not an array of arrays of length >= 2: %s", raw.GetString());
+			}
+		}
+
+		if (has_any_z) {
+			has_z = true;
+		}
+
+		auto vertices = VertexArray::Create(factory.allocator, len, has_any_z, false);
+
+		yyjson_arr_foreach(coord_array, idx, max, coord) {
+			auto coord_len = yyjson_arr_size(coord);
+			auto x_val = yyjson_arr_get_first(coord);
+			if (!yyjson_is_num(x_val)) {
+				throw InvalidInputException("GeoJSON input coordinates field is not an array of arrays of numbers: %s",
+				                            raw.GetString());
+			}
+			auto y_val = yyjson_arr_get(coord, 1);
+			if (!yyjson_is_num(y_val)) {
+				throw InvalidInputException("GeoJSON input coordinates field is not an array of arrays of numbers: %s",
+				                            raw.GetString());
+			}
+			auto x = yyjson_get_num(x_val);
+			auto y = yyjson_get_num(y_val);
+			auto z = 0.0;
+
+			if (coord_len > 2) {
+				auto z_val = yyjson_arr_get(coord, 2);
+				if (!yyjson_is_num(z_val)) {
+					throw InvalidInputException(
+					    "GeoJSON input coordinates field is not an array of arrays of numbers: %s", raw.GetString());
+				}
+				z = yyjson_get_num(z_val);
+			}
+			if (has_any_z) {
+				vertices.Set(idx, x, y, z);
+			} else {
+				vertices.Set(idx, x, y);
+			}
+		}
+		return vertices;
+	}
+}
+
+static LineString LineStringFromGeoJSON(yyjson_val *coord_array, GeometryFactory &factory, const string_t &raw,
+                                        bool &has_z) {
+	return LineString(VerticesFromGeoJSON(coord_array, factory, raw, has_z));
+}
+
+static Polygon PolygonFromGeoJSON(yyjson_val *coord_array, GeometryFactory &factory, const string_t &raw, bool &has_z) {
+	auto num_rings = yyjson_arr_size(coord_array);
+	if (num_rings == 0) {
+		// Empty
+		return Polygon(false, false);
+	} else {
+		// Polygon
+		Polygon polygon(factory.allocator, num_rings, false, false);
+		size_t idx, max;
+		yyjson_val *ring_val;
+		yyjson_arr_foreach(coord_array, idx, max, ring_val) {
+			if (!yyjson_is_arr(ring_val)) {
+				throw InvalidInputException("GeoJSON input coordinates field is not an array of arrays: %s",
+				                            raw.GetString());
+			}
+			polygon[idx] = VerticesFromGeoJSON(ring_val, factory, raw, has_z);
+		}
+
+		return polygon;
+	}
+}
+
+static MultiPoint MultiPointFromGeoJSON(yyjson_val *coord_array, GeometryFactory &factory, const string_t &raw,
+                                        bool &has_z) {
+	auto num_points = yyjson_arr_size(coord_array);
+	if (num_points == 0) {
+		// Empty
+		return MultiPoint(false, false);
+	} else {
+		// MultiPoint
+		MultiPoint multi_point(factory.allocator, num_points, false, false);
+		size_t idx, max;
+		yyjson_val *point_val;
+		yyjson_arr_foreach(coord_array, idx, max, point_val) {
+			if (!yyjson_is_arr(point_val)) {
+				throw InvalidInputException("GeoJSON input coordinates field is not an array of arrays: %s",
+				                            raw.GetString());
+			}
+			if (yyjson_arr_size(point_val) < 2) {
+				throw InvalidInputException(
+				    "GeoJSON input coordinates field is not an array of arrays of length >= 2: %s", raw.GetString());
+			}
+			multi_point[idx] = PointFromGeoJSON(point_val, factory, raw, has_z);
+		}
+		return multi_point;
+	}
+}
+
+static MultiLineString MultiLineStringFromGeoJSON(yyjson_val *coord_array, GeometryFactory &factory,
+                                                  const string_t &raw, bool &has_z) {
+	auto num_linestrings = yyjson_arr_size(coord_array);
+	if (num_linestrings == 0) {
+		// Empty
+		return MultiLineString(false, false);
+	} else {
+		// MultiLineString
+		MultiLineString multi_linestring(factory.allocator, num_linestrings, false, false);
+		size_t idx, max;
+		yyjson_val *linestring_val;
+		yyjson_arr_foreach(coord_array, idx, max, linestring_val) {
+			if (!yyjson_is_arr(linestring_val)) {
+				throw InvalidInputException("GeoJSON input coordinates field is not an array of arrays: %s",
+				                            raw.GetString());
+			}
+			multi_linestring[idx] = LineStringFromGeoJSON(linestring_val, factory, raw, has_z);
+		}
+
+		return multi_linestring;
+	}
+}
+
+static MultiPolygon MultiPolygonFromGeoJSON(yyjson_val *coord_array, GeometryFactory &factory, const string_t &raw,
+                                            bool &has_z) {
+	auto num_polygons = yyjson_arr_size(coord_array);
+	if (num_polygons == 0) {
+		// Empty
+		return MultiPolygon(false, false);
+	} else {
+		// MultiPolygon
+		MultiPolygon multi_polygon(factory.allocator, num_polygons, false, false);
+		size_t idx, max;
+		yyjson_val *polygon_val;
+		yyjson_arr_foreach(coord_array, idx, max, polygon_val) {
+			if (!yyjson_is_arr(polygon_val)) {
+				throw InvalidInputException("GeoJSON input coordinates field is not an array of arrays: %s",
+				                            raw.GetString());
+			}
+			multi_polygon[idx] = PolygonFromGeoJSON(polygon_val, factory, raw, has_z);
+		}
+
+		return multi_polygon;
+	}
+}
+
+static GeometryCollection GeometryCollectionFromGeoJSON(yyjson_val *root, GeometryFactory &factory, const string_t &raw,
+                                                        bool &has_z) {
+	auto geometries_val = yyjson_obj_get(root, "geometries");
+	if (!geometries_val) {
+		throw InvalidInputException("GeoJSON input does not have a geometries field: %s", raw.GetString());
+	}
+	if (!yyjson_is_arr(geometries_val)) {
+		throw InvalidInputException("GeoJSON input geometries field is not an array: %s", raw.GetString());
+	}
+	auto num_geometries = yyjson_arr_size(geometries_val);
+	if (num_geometries == 0) {
+		// Empty
+		return GeometryCollection(false, false);
+	} else {
+		// GeometryCollection
+		GeometryCollection geometry_collection(factory.allocator, num_geometries, false, false);
+		size_t idx, max;
+		yyjson_val *geometry_val;
+		yyjson_arr_foreach(geometries_val, idx, max, geometry_val) {
+			geometry_collection[idx] = GeoJSONReader::Read(geometry_val, factory, raw, has_z);
+		}
+
+		return geometry_collection;
+	}
+}
+
+Geometry GeoJSONReader::Read(yyjson_val *root, GeometryFactory &factory, const string_t &raw, bool &has_z) {
+	auto type_val = yyjson_obj_get(root, "type");
+	if (!type_val) {
+		throw InvalidInputException("GeoJSON input does not have a type field: %s", raw.GetString());
+	}
+	auto type_str = yyjson_get_str(type_val);
+	if (!type_str) {
+		throw InvalidInputException("GeoJSON input type field is not a string: %s", raw.GetString());
+	}
+
+	if (StringUtil::Equals(type_str, "GeometryCollection")) {
+		return GeometryCollectionFromGeoJSON(root, factory, raw, has_z);
+	}
+
+	// Get the coordinates
+	auto coord_array = yyjson_obj_get(root, "coordinates");
+	if (!coord_array) {
+		throw InvalidInputException("GeoJSON input does not have a coordinates field: %s", raw.GetString());
+	}
+	if (!yyjson_is_arr(coord_array)) {
+		throw InvalidInputException("GeoJSON input coordinates field is not an array: %s", raw.GetString());
+	}
+
+	if (StringUtil::Equals(type_str, "Point")) {
+		return PointFromGeoJSON(coord_array, factory, raw, has_z);
+	} else if (StringUtil::Equals(type_str, "LineString")) {
+		return LineStringFromGeoJSON(coord_array, factory, raw, has_z);
+	} else if (StringUtil::Equals(type_str, "Polygon")) {
+		return PolygonFromGeoJSON(coord_array, factory, raw, has_z);
+	} else if (StringUtil::Equals(type_str, "MultiPoint")) {
+		return MultiPointFromGeoJSON(coord_array, factory, raw, has_z);
+	} else if (StringUtil::Equals(type_str, "MultiLineString")) {
+		return MultiLineStringFromGeoJSON(coord_array, factory, raw, has_z);
+	} else if (StringUtil::Equals(type_str, "MultiPolygon")) {
+		return MultiPolygonFromGeoJSON(coord_array, factory, raw, has_z);
+	} else {
+		throw InvalidInputException("GeoJSON input has invalid type field: %s", raw.GetString());
+	}
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,153 @@
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geojson_writer.hpp"
+
+#include "yyjson.h"
+
+namespace spatial {
+
+namespace core {
+
+using namespace duckdb_yyjson_spatial;
+
+void GeoJSONWriter::AppendNumber(string &buffer, double value, uint32_t precision) {
+	if (precision < Utils::MAX_COORD_PRECISION) {
+		if (!std::isfinite(value)) {
+			buffer += "null";
+			return;
+		}
+		Utils::append_coord(buffer, value, precision);
+		return;
+	}
+	// Format the number the same way the yyjson writer does, directly into the buffer
+	auto offset = buffer.size();
+	buffer.resize(offset + 32);
+	auto end = yyjson_write_real(value, &buffer[offset]);
+	if (!end) {
+		// NaN and infinity are not valid JSON numbers
+		buffer.resize(offset);
+		buffer += "null";
+		return;
+	}
+	buffer.resize(end - buffer.data());
+}
+
+void GeoJSONWriter::WriteNumber(double value) {
+	AppendNumber(*text, value, precision);
+}
+
+void GeoJSONWriter::WriteVertex(const VertexData &data, uint32_t idx) {
+	*text += '[';
+	WriteNumber(Load<double>(data.data[0] + idx * data.stride[0]));
+	*text += ',';
+	WriteNumber(Load<double>(data.data[1] + idx * data.stride[1]));
+	if (HasZ()) {
+		*text += ',';
+		WriteNumber(Load<double>(data.data[2] + idx * data.stride[2]));
+	}
+	*text += ']';
+}
+
+void GeoJSONWriter::WriteVertices(const VertexData &data) {
+	*text += '[';
+	for (uint32_t i = 0; i < data.count; i++) {
+		if (i > 0) {
+			*text += ',';
+		}
+		WriteVertex(data, i);
+	}
+	*text += ']';
+}
+
+void GeoJSONWriter::ProcessPoint(const VertexData &data, bool in_typed_collection) {
+	if (in_typed_collection) {
+		// Empty points in a multipoint are skipped entirely
+		if (!data.IsEmpty()) {
+			WriteVertex(data, 0);
+		}
+		return;
+	}
+	*text += R"({"type":"Point","coordinates":)";
+	if (data.IsEmpty()) {
+		*text += "[]";
+	} else {
+		WriteVertex(data, 0);
+	}
+	*text += '}';
+}
+
+void GeoJSONWriter::ProcessLineString(const VertexData &data, bool in_typed_collection) {
+	if (in_typed_collection) {
+		WriteVertices(data);
+		return;
+	}
+	*text += R"({"type":"LineString","coordinates":)";
+	WriteVertices(data);
+	*text += '}';
+}
+
+void GeoJSONWriter::ProcessPolygon(PolygonState &state, bool in_typed_collection) {
+	if (!in_typed_collection) {
+		*text += R"({"type":"Polygon","coordinates":)";
+	}
+	*text += '[';
+	bool first = true;
+	while (!state.IsDone()) {
+		if (!first) {
+			*text += ',';
+		}
+		first = false;
+		WriteVertices(state.Next());
+	}
+	*text += ']';
+	if (!in_typed_collection) {
+		*text += '}';
+	}
+}
+
+void GeoJSONWriter::ProcessCollection(CollectionState &state, bool) {
+	bool collection_is_typed = true;
+	switch (CurrentType()) {
+	case GeometryType::MULTIPOINT:
+		*text += R"({"type":"MultiPoint","coordinates":[)";
+		break;
+	case GeometryType::MULTILINESTRING:
+		*text += R"({"type":"MultiLineString","coordinates":[)";
+		break;
+	case GeometryType::MULTIPOLYGON:
+		*text += R"({"type":"MultiPolygon","coordinates":[)";
+		break;
+	case GeometryType::GEOMETRYCOLLECTION:
+		*text += R"({"type":"GeometryCollection","geometries":[)";
+		collection_is_typed = false;
+		break;
+	default:
+		throw InvalidInputException("Invalid geometry type");
+	}
+
+	bool first = true;
+	while (!state.IsDone()) {
+		auto offset = text->size();
+		if (!first) {
+			*text += ',';
+		}
+		auto item_offset = text->size();
+		state.Next(collection_is_typed);
+		if (text->size() == item_offset) {
+			// Nothing was written (empty point in a multipoint), so drop the separator as well
+			text->resize(offset);
+		} else {
+			first = false;
+		}
+	}
+	*text += "]}";
+}
+
+void GeoJSONWriter::Write(const geometry_t &geom, string &buffer) {
+	text = &buffer;
+	Process(geom, false);
+	text = nullptr;
+}
+
+} // namespace core
+
+} // namespace spatial
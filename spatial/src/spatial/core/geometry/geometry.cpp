@@ -9,44 +9,55 @@ namespace core {
 // super illegal lol, we should try to get this exposed upstream.
 extern "C" int geos_d2sfixed_buffered_n(double f, uint32_t precision, char *result);
 
+constexpr uint32_t Utils::MAX_COORD_PRECISION;
+constexpr uint32_t Utils::MAX_COORD_LENGTH;
+
+uint32_t Utils::format_coord(double d, char *buffer, uint32_t precision) {
+	// Prints the shortest representation that reads back as the same double if it has at most "precision" digits
+	// after the decimal point, and otherwise rounds to that many digits, without trailing zeros
+	return static_cast<uint32_t>(geos_d2sfixed_buffered_n(d, MinValue(precision, MAX_COORD_PRECISION), buffer));
+}
+
+void Utils::append_coord(string &buffer, double d, uint32_t precision) {
+	auto offset = buffer.size();
+	buffer.resize(offset + MAX_COORD_LENGTH);
+	auto len = format_coord(d, &buffer[offset], precision);
+	buffer.resize(offset + len);
+}
+
 string Utils::format_coord(double d) {
-	char buf[25];
-	auto len = geos_d2sfixed_buffered_n(d, 15, buf);
-	buf[len] = '\0';
-	return string {buf};
+	char buf[MAX_COORD_LENGTH];
+	return string(buf, format_coord(d, buf));
 }
 
 string Utils::format_coord(double x, double y) {
-	char buf[51];
-	auto res_x = geos_d2sfixed_buffered_n(x, 15, buf);
-	buf[res_x++] = ' ';
-	auto res_y = geos_d2sfixed_buffered_n(y, 15, buf + res_x);
-	buf[res_x + res_y] = '\0';
-	return string {buf};
+	char buf[MAX_COORD_LENGTH * 2 + 1];
+	auto len = format_coord(x, buf);
+	buf[len++] = ' ';
+	len += format_coord(y, buf + len);
+	return string(buf, len);
 }
 
 string Utils::format_coord(double x, double y, double zm) {
-	char buf[76];
-	auto res_x = geos_d2sfixed_buffered_n(x, 15, buf);
-	buf[res_x++] = ' ';
-	auto res_y = geos_d2sfixed_buffered_n(y, 15, buf + res_x);
-	buf[res_x + res_y++] = ' ';
-	auto res_zm = geos_d2sfixed_buffered_n(zm, 15, buf + res_x + res_y);
-	buf[res_x + res_y + res_zm] = '\0';
-	return string {buf};
+	char buf[MAX_COORD_LENGTH * 3 + 2];
+	auto len = format_coord(x, buf);
+	buf[len++] = ' ';
+	len += format_coord(y, buf + len);
+	buf[len++] = ' ';
+	len += format_coord(zm, buf + len);
+	return string(buf, len);
 }
 
 string Utils::format_coord(double x, double y, double z, double m) {
-	char buf[101];
-	auto res_x = geos_d2sfixed_buffered_n(x, 15, buf);
-	buf[res_x++] = ' ';
-	auto res_y = geos_d2sfixed_buffered_n(y, 15, buf + res_x);
-	buf[res_x + res_y++] = ' ';
-	auto res_z = geos_d2sfixed_buffered_n(z, 15, buf + res_x + res_y);
-	buf[res_x + res_y + res_z++] = ' ';
-	auto res_m = geos_d2sfixed_buffered_n(m, 15, buf + res_x + res_y + res_z);
-	buf[res_x + res_y + res_z + res_m] = '\0';
-	return string {buf};
+	char buf[MAX_COORD_LENGTH * 4 + 3];
+	auto len = format_coord(x, buf);
+	buf[len++] = ' ';
+	len += format_coord(y, buf + len);
+	buf[len++] = ' ';
+	len += format_coord(z, buf + len);
+	buf[len++] = ' ';
+	len += format_coord(m, buf + len);
+	return string(buf, len);
 }
 
 //------------------------------------------------------------------------------
@@ -79,9 +90,10 @@ string LineString::ToString() const {
 
 	string result = "LINESTRING (";
 	for (uint32_t i = 0; i < vertices.Count(); i++) {
-		auto x = vertices.Get(i).x;
-		auto y = vertices.Get(i).y;
-		result += Utils::format_coord(x, y);
+		auto vert = vertices.Get(i);
+		Utils::append_coord(result, vert.x);
+		result += ' ';
+		Utils::append_coord(result, vert.y);
 		if (i < vertices.Count() - 1) {
 			result += ", ";
 		}
@@ -110,9 +122,10 @@ string Polygon::ToString() const {
 	for (uint32_t i = 0; i < num_rings; i++) {
 		result += "(";
 		for (uint32_t j = 0; j < rings[i].Count(); j++) {
-			auto x = rings[i].Get(j).x;
-			auto y = rings[i].Get(j).y;
-			result += Utils::format_coord(x, y);
+			auto vert = rings[i].Get(j);
+			Utils::append_coord(result, vert.x);
+			result += ' ';
+			Utils::append_coord(result, vert.y);
 			if (j < rings[i].Count() - 1) {
 				result += ", ";
 			}
@@ -143,7 +156,9 @@ string MultiPoint::ToString() const {
 			str += "EMPTY";
 		} else {
 			auto vert = point.Vertices().Get(0);
-			str += Utils::format_coord(vert.x, vert.y);
+			Utils::append_coord(str, vert.x);
+			str += ' ';
+			Utils::append_coord(str, vert.y);
 		}
 		if (i < num_points - 1) {
 			str += ", ";
@@ -179,7 +194,9 @@ string MultiLineString::ToString() const {
 			} else {
 				str += ", ";
 			}
-			str += Utils::format_coord(vert.x, vert.y);
+			Utils::append_coord(str, vert.x);
+			str += ' ';
+			Utils::append_coord(str, vert.y);
 		}
 		str += ")";
 	}
@@ -221,7 +238,9 @@ string MultiPolygon::ToString() const {
 				} else {
 					str += ", ";
 				}
-				str += Utils::format_coord(vert.x, vert.y);
+				Utils::append_coord(str, vert.x);
+				str += ' ';
+				Utils::append_coord(str, vert.y);
 			}
 			str += ")";
 		}
@@ -16,6 +16,7 @@ namespace core {
 // layout:
 // GeometryHeader (4 bytes)
 // Padding (4 bytes) (or SRID?)
+// BoundingBox (2 floats or doubles per dimension, unless the geometry is a point or empty)
 // Data (variable length)
 // -- Point
 // 	  Type ( 4 bytes)
@@ -47,14 +48,14 @@ geometry_t GeometryFactory::Serialize(Vector &result, const Geometry &geometry,
 	// auto properties = geometry.Properties();
 	GeometryProperties properties;
 	properties.SetBBox(has_bbox);
+	properties.SetDoubleBBox(has_bbox && double_bbox);
 	properties.SetZ(has_z);
 	properties.SetM(has_m);
 	uint16_t hash = 0;
 
 	auto header_size = 4;
-	auto dims = 2 + (has_z ? 1 : 0) + (has_m ? 1 : 0);
-	auto bbox_size = has_bbox ? (sizeof(float) * 2 * dims) : 0;
-	auto size = header_size + 4 + bbox_size + geom_size; // + 4 for padding, + 16 for bbox
+	auto bbox_size = properties.BBoxSize();
+	auto size = header_size + 4 + bbox_size + geom_size; // + 4 for padding
 	auto blob = StringVector::EmptyString(result, size);
 	Cursor cursor(blob);
 
@@ -115,8 +116,29 @@ geometry_t GeometryFactory::Serialize(Vector &result, const Geometry &geometry,
 	}
 
 	// Now write the bounding box
-	if (has_bbox) {
-		cursor.SetPtr(bbox_ptr);
+	cursor.SetPtr(bbox_ptr);
+	SerializeBoundingBox(cursor, bbox, properties);
+	blob.Finalize();
+	return geometry_t(blob);
+}
+
+void GeometryFactory::SerializeBoundingBox(Cursor &cursor, const BoundingBox &bbox, GeometryProperties properties) {
+	auto has_z = properties.HasZ();
+	auto has_m = properties.HasM();
+	if (properties.HasDoubleBBox()) {
+		cursor.Write<double>(bbox.minx);
+		cursor.Write<double>(bbox.miny);
+		cursor.Write<double>(bbox.maxx);
+		cursor.Write<double>(bbox.maxy);
+		if (has_z) {
+			cursor.Write<double>(bbox.minz);
+			cursor.Write<double>(bbox.maxz);
+		}
+		if (has_m) {
+			cursor.Write<double>(bbox.minm);
+			cursor.Write<double>(bbox.maxm);
+		}
+	} else if (properties.HasBBox()) {
 		// We serialize the bounding box as floats to save space, but ensure that the bounding box is
 		// still large enough to contain the original double values by rounding up and down
 		cursor.Write<float>(Utils::DoubleToFloatDown(bbox.minx));
@@ -132,8 +154,6 @@ geometry_t GeometryFactory::Serialize(Vector &result, const Geometry &geometry,
 			cursor.Write<float>(Utils::DoubleToFloatUp(bbox.maxm));
 		}
 	}
-	blob.Finalize();
-	return geometry_t(blob);
 }
 
 void GeometryFactory::SerializeVertexArray(Cursor &cursor, const VertexArray &array, bool update_bounds,
@@ -321,6 +341,51 @@ void GeometryFactory::SerializeGeometryCollection(Cursor &cursor, const Geometry
 	}
 }
 
+geometry_t GeometryFactory::SerializePoint2D(Vector &result, double x, double y) {
+	// Same layout as Serialize produces for a non-empty point without Z and M: no bounding box, a hash of 0
+	auto blob = StringVector::EmptyString(result, SERIALIZED_POINT_2D_SIZE);
+	Cursor cursor(blob);
+	cursor.Write<GeometryType>(GeometryType::POINT);
+	cursor.Write<GeometryProperties>(GeometryProperties());
+	cursor.Write<uint16_t>(0);
+	cursor.Write<uint32_t>(0);
+	cursor.Write(SerializedGeometryType::POINT);
+	cursor.Write<uint32_t>(1);
+	cursor.Write<double>(x);
+	cursor.Write<double>(y);
+	blob.Finalize();
+	return geometry_t(blob);
+}
+
+GeometryProperties GeometryFactory::SkipSerializedHeader(Cursor &cursor) {
+	cursor.Skip<GeometryType>();
+	auto properties = cursor.Read<GeometryProperties>();
+	cursor.Skip<uint16_t>(); // hash
+	cursor.Skip<uint32_t>(); // padding
+	cursor.Skip(properties.BBoxSize());
+	return properties;
+}
+
+bool GeometryFactory::TryGetSerializedPoint(const geometry_t &data, double &x, double &y) {
+	Cursor cursor(data);
+
+	if (cursor.Peek<GeometryType>() != GeometryType::POINT) {
+		return false;
+	}
+	SkipSerializedHeader(cursor);
+
+	auto type = cursor.Read<SerializedGeometryType>();
+	D_ASSERT(type == SerializedGeometryType::POINT);
+	(void)type;
+	if (cursor.Read<uint32_t>() == 0) {
+		return false;
+	}
+	// Z and M, if any, follow X and Y
+	x = cursor.Read<double>();
+	y = cursor.Read<double>();
+	return true;
+}
+
 bool GeometryFactory::TryGetSerializedBoundingBox(const geometry_t &data, BoundingBox &bbox) {
 	Cursor cursor(data);
 
@@ -330,6 +395,16 @@ bool GeometryFactory::TryGetSerializedBoundingBox(const geometry_t &data, Boundi
 	auto hash = cursor.Read<uint16_t>();
 	(void)hash;
 
+	if (properties.HasDoubleBBox()) {
+		cursor.Skip(4); // skip padding
+
+		bbox.minx = cursor.Read<double>();
+		bbox.miny = cursor.Read<double>();
+		bbox.maxx = cursor.Read<double>();
+		bbox.maxy = cursor.Read<double>();
+		return true;
+	}
+
 	if (properties.HasBBox()) {
 		cursor.Skip(4); // skip padding
 
@@ -366,6 +441,410 @@ bool GeometryFactory::TryGetSerializedBoundingBox(const geometry_t &data, Boundi
 	return false;
 }
 
+//----------------------------------------------------------------------
+// Serialized Rewrites
+//----------------------------------------------------------------------
+// Per-vertex transforms that keep the structure of a geometry are done directly on the serialized format. The body
+// is walked once, handing the type, count and padding words and the runs of vertices to a visitor, without building
+// a Geometry.
+static uint32_t SerializedVertexSize(GeometryProperties properties) {
+	return sizeof(double) * (2 + (properties.HasZ() ? 1 : 0) + (properties.HasM() ? 1 : 0));
+}
+
+template <class VISITOR>
+static void VisitSerializedBody(Cursor &cursor, uint32_t vertex_size, VISITOR &visitor) {
+	auto start = cursor.GetPtr();
+	auto type = cursor.Read<SerializedGeometryType>();
+	auto count = cursor.Read<uint32_t>();
+	switch (type) {
+	case SerializedGeometryType::POINT:
+	case SerializedGeometryType::LINESTRING:
+		visitor.Words(start, 8);
+		visitor.Vertices(cursor.GetPtr(), count);
+		cursor.Skip(count * vertex_size);
+		break;
+	case SerializedGeometryType::POLYGON: {
+		auto ring_counts = cursor.GetPtr();
+		cursor.Skip(count * sizeof(uint32_t) + (count % 2 == 1 ? sizeof(uint32_t) : 0));
+		visitor.Words(start, cursor.GetPtr() - start);
+		for (uint32_t i = 0; i < count; i++) {
+			auto ring_count = Load<uint32_t>(ring_counts + i * sizeof(uint32_t));
+			visitor.Vertices(cursor.GetPtr(), ring_count);
+			cursor.Skip(ring_count * vertex_size);
+		}
+		break;
+	}
+	case SerializedGeometryType::MULTIPOINT:
+	case SerializedGeometryType::MULTILINESTRING:
+	case SerializedGeometryType::MULTIPOLYGON:
+	case SerializedGeometryType::GEOMETRYCOLLECTION:
+		visitor.Words(start, 8);
+		for (uint32_t i = 0; i < count; i++) {
+			VisitSerializedBody(cursor, vertex_size, visitor);
+		}
+		break;
+	default:
+		auto msg = StringUtil::Format("Unknown geometry type in serialized geometry: %d", static_cast<uint32_t>(type));
+		throw SerializationException(msg);
+	}
+}
+
+struct FlipVisitor {
+	uint32_t vertex_size;
+
+	void Words(const_data_ptr_t, idx_t) {
+	}
+	void Vertices(const_data_ptr_t data, uint32_t count) {
+		// The blob is a copy, so swap in place. A plain loop over the stride, which compilers vectorize for XY.
+		auto ptr = const_cast<data_ptr_t>(data);
+		for (uint32_t i = 0; i < count; i++) {
+			auto vertex = ptr + i * vertex_size;
+			auto x = Load<double>(vertex);
+			auto y = Load<double>(vertex + sizeof(double));
+			Store<double>(y, vertex);
+			Store<double>(x, vertex + sizeof(double));
+		}
+	}
+};
+
+geometry_t GeometryFactory::SerializedSetValid(Vector &result, const geometry_t &data) {
+	auto properties = data.GetProperties();
+	if (properties.IsValid()) {
+		return data;
+	}
+	properties.SetValid(true);
+
+	string_t input = data;
+	auto size = input.GetSize();
+	auto blob = StringVector::EmptyString(result, size);
+	auto ptr = data_ptr_cast(blob.GetDataWriteable());
+	memcpy(ptr, input.GetData(), size);
+	Store<GeometryProperties>(properties, ptr + sizeof(GeometryType));
+	blob.Finalize();
+	return geometry_t(blob);
+}
+
+// The body of a serialized geometry, after the header and the bounding box
+static string_t GetSerializedBody(const geometry_t &data) {
+	string_t blob = data;
+	auto offset = 8 + data.GetProperties().BBoxSize();
+	return string_t(blob.GetData() + offset, static_cast<uint32_t>(blob.GetSize() - offset));
+}
+
+// The type and the Z and M flags, which are all of the header that is part of the value of a geometry
+static uint16_t GetSerializedKind(const geometry_t &data) {
+	auto properties = data.GetProperties();
+	auto type = static_cast<uint8_t>(data.GetType());
+	return static_cast<uint16_t>(type << 2 | properties.HasZ() << 1 | properties.HasM());
+}
+
+hash_t GeometryFactory::SerializedHash(const geometry_t &data) {
+	auto body = GetSerializedBody(data);
+	return CombineHash(Hash(GetSerializedKind(data)), Hash(body.GetData(), body.GetSize()));
+}
+
+bool GeometryFactory::SerializedEquals(const geometry_t &left, const geometry_t &right) {
+	if (GetSerializedKind(left) != GetSerializedKind(right)) {
+		return false;
+	}
+	auto left_body = GetSerializedBody(left);
+	auto right_body = GetSerializedBody(right);
+	return left_body.GetSize() == right_body.GetSize() &&
+	       memcmp(left_body.GetData(), right_body.GetData(), left_body.GetSize()) == 0;
+}
+
+geometry_t GeometryFactory::SerializedFlipCoordinates(Vector &result, const geometry_t &data) {
+	string_t input = data;
+	auto size = input.GetSize();
+	auto blob = StringVector::EmptyString(result, size);
+	auto ptr = data_ptr_cast(blob.GetDataWriteable());
+	memcpy(ptr, input.GetData(), size);
+
+	Cursor cursor(ptr, ptr + size);
+	cursor.Skip(sizeof(GeometryType));
+	auto properties = cursor.Read<GeometryProperties>();
+	cursor.Skip(2 + 4); // hash and padding
+
+	// The bounding box starts with min x, min y, max x, max y
+	if (properties.HasBBox()) {
+		auto width = properties.HasDoubleBBox() ? sizeof(double) : sizeof(float);
+		auto bbox_ptr = cursor.GetPtr();
+		uint8_t scratch[sizeof(double)];
+		for (idx_t i = 0; i < 4; i += 2) {
+			memcpy(scratch, bbox_ptr + i * width, width);
+			memcpy(bbox_ptr + i * width, bbox_ptr + (i + 1) * width, width);
+			memcpy(bbox_ptr + (i + 1) * width, scratch, width);
+		}
+	}
+	cursor.Skip(properties.BBoxSize());
+
+	FlipVisitor visitor {SerializedVertexSize(properties)};
+	VisitSerializedBody(cursor, visitor.vertex_size, visitor);
+
+	blob.Finalize();
+	return geometry_t(blob);
+}
+
+struct CountVisitor {
+	idx_t vertex_count = 0;
+
+	void Words(const_data_ptr_t, idx_t) {
+	}
+	void Vertices(const_data_ptr_t, uint32_t count) {
+		vertex_count += count;
+	}
+};
+
+struct SetVertexTypeVisitor {
+	Cursor &out;
+	bool in_z;
+	bool in_m;
+	bool out_z;
+	bool out_m;
+	double default_z;
+	double default_m;
+
+	void Words(const_data_ptr_t data, idx_t bytes) {
+		auto dst = out.GetPtr();
+		out.Skip(bytes);
+		memcpy(dst, data, bytes);
+	}
+	void Vertices(const_data_ptr_t data, uint32_t count) {
+		auto in_size = sizeof(double) * (2 + in_z + in_m);
+		auto out_size = sizeof(double) * (2 + out_z + out_m);
+		auto dst = out.GetPtr();
+		// Skip first, so a truncated buffer throws before anything is written
+		out.Skip(count * out_size);
+		for (uint32_t i = 0; i < count; i++) {
+			auto src = data + i * in_size;
+			auto vertex = dst + i * out_size;
+			memcpy(vertex, src, 2 * sizeof(double));
+			if (out_z) {
+				Store<double>(in_z ? Load<double>(src + 2 * sizeof(double)) : default_z, vertex + 2 * sizeof(double));
+			}
+			if (out_m) {
+				auto m = in_m ? Load<double>(src + (2 + in_z) * sizeof(double)) : default_m;
+				Store<double>(m, vertex + (2 + out_z) * sizeof(double));
+			}
+		}
+	}
+};
+
+geometry_t GeometryFactory::SerializedSetVertexType(Vector &result, const geometry_t &data, bool has_z, bool has_m,
+                                                    double default_z, double default_m) {
+	string_t input = data;
+	Cursor in(input);
+	auto type = in.Read<GeometryType>();
+	auto in_props = in.Read<GeometryProperties>();
+	auto hash = in.Read<uint16_t>();
+	in.Skip(4); // padding
+	auto bbox_ptr = in.GetPtr();
+	in.Skip(in_props.BBoxSize());
+	auto body = in.GetPtr();
+
+	auto out_props = in_props;
+	out_props.SetZ(has_z);
+	out_props.SetM(has_m);
+
+	// The body only changes in the size of the vertices
+	auto in_vertex_size = SerializedVertexSize(in_props);
+	CountVisitor counter;
+	VisitSerializedBody(in, in_vertex_size, counter);
+	auto body_size = (in.GetPtr() - body) - counter.vertex_count * in_vertex_size;
+	auto size = 8 + out_props.BBoxSize() + body_size + counter.vertex_count * SerializedVertexSize(out_props);
+
+	auto blob = StringVector::EmptyString(result, size);
+	Cursor out(blob);
+	out.Write<GeometryType>(type);
+	out.Write<GeometryProperties>(out_props);
+	out.Write<uint16_t>(hash);
+	out.Write<uint32_t>(0);
+
+	// The x and y bounds are copied, the bounds of a kept dimension too, and an added dimension is bounded by its
+	// default value
+	if (in_props.HasBBox()) {
+		auto double_bbox = in_props.HasDoubleBBox();
+		auto width = double_bbox ? sizeof(double) : sizeof(float);
+		auto write_bounds = [&](idx_t in_index, bool has_in, double default_value) {
+			if (has_in) {
+				memcpy(out.GetPtr(), bbox_ptr + in_index * width, 2 * width);
+				out.Skip(2 * width);
+			} else if (double_bbox) {
+				out.Write<double>(default_value);
+				out.Write<double>(default_value);
+			} else {
+				out.Write<float>(Utils::DoubleToFloatDown(default_value));
+				out.Write<float>(Utils::DoubleToFloatUp(default_value));
+			}
+		};
+		memcpy(out.GetPtr(), bbox_ptr, 4 * width);
+		out.Skip(4 * width);
+		if (has_z) {
+			write_bounds(4, in_props.HasZ(), default_z);
+		}
+		if (has_m) {
+			write_bounds(in_props.HasZ() ? 6 : 4, in_props.HasM(), default_m);
+		}
+	}
+
+	in.SetPtr(body);
+	SetVertexTypeVisitor visitor {out, in_props.HasZ(), in_props.HasM(), has_z, has_m, default_z, default_m};
+	VisitSerializedBody(in, in_vertex_size, visitor);
+	D_ASSERT(out.Remaining() == 0);
+
+	blob.Finalize();
+	return geometry_t(blob);
+}
+
+// The parts of a collection are found by walking the body, without deserializing it. A part is serialized on its own
+// by copying its body behind a new header and the bounding box of its vertices.
+struct BoundsVisitor {
+	bool has_z;
+	bool has_m;
+	uint32_t vertex_size;
+	BoundingBox bbox;
+
+	void Words(const_data_ptr_t, idx_t) {
+	}
+	void Vertices(const_data_ptr_t data, uint32_t count) {
+		auto m_offset = (has_z ? 3 : 2) * sizeof(double);
+		for (uint32_t i = 0; i < count; i++) {
+			auto vertex = data + i * vertex_size;
+			auto x = Load<double>(vertex);
+			auto y = Load<double>(vertex + sizeof(double));
+			bbox.minx = MinValue(bbox.minx, x);
+			bbox.miny = MinValue(bbox.miny, y);
+			bbox.maxx = MaxValue(bbox.maxx, x);
+			bbox.maxy = MaxValue(bbox.maxy, y);
+			if (has_z) {
+				auto z = Load<double>(vertex + 2 * sizeof(double));
+				bbox.minz = MinValue(bbox.minz, z);
+				bbox.maxz = MaxValue(bbox.maxz, z);
+			}
+			if (has_m) {
+				auto m = Load<double>(vertex + m_offset);
+				bbox.minm = MinValue(bbox.minm, m);
+				bbox.maxm = MaxValue(bbox.maxm, m);
+			}
+		}
+	}
+};
+
+static void CollectSerializedParts(Cursor &cursor, uint32_t vertex_size, vector<int32_t> &path,
+                                   vector<GeometryFactory::SerializedPart> &parts, vector<int32_t> &paths) {
+	auto start = cursor.GetPtr();
+	auto type = cursor.Read<SerializedGeometryType>();
+	auto count = cursor.Read<uint32_t>();
+	switch (type) {
+	case SerializedGeometryType::MULTIPOINT:
+	case SerializedGeometryType::MULTILINESTRING:
+	case SerializedGeometryType::MULTIPOLYGON:
+	case SerializedGeometryType::GEOMETRYCOLLECTION:
+		for (uint32_t i = 0; i < count; i++) {
+			path.push_back(static_cast<int32_t>(i + 1)); // paths are 1-indexed
+			CollectSerializedParts(cursor, vertex_size, path, parts, paths);
+			path.pop_back();
+		}
+		break;
+	default: {
+		cursor.SetPtr(start);
+		CountVisitor counter;
+		VisitSerializedBody(cursor, vertex_size, counter);
+		GeometryFactory::SerializedPart part;
+		part.type = static_cast<GeometryType>(type);
+		part.body = start;
+		part.body_size = static_cast<uint32_t>(cursor.GetPtr() - start);
+		part.vertex_count = static_cast<uint32_t>(counter.vertex_count);
+		part.path_offset = static_cast<uint32_t>(paths.size());
+		part.path_length = static_cast<uint32_t>(path.size());
+		paths.insert(paths.end(), path.begin(), path.end());
+		parts.push_back(part);
+		break;
+	}
+	}
+}
+
+void GeometryFactory::GetSerializedParts(const geometry_t &data, vector<SerializedPart> &parts,
+                                         vector<int32_t> &paths) {
+	Cursor cursor(data);
+	auto properties = SkipSerializedHeader(cursor);
+
+	vector<int32_t> path;
+	CollectSerializedParts(cursor, SerializedVertexSize(properties), path, parts, paths);
+}
+
+geometry_t GeometryFactory::SerializePart(Vector &result, GeometryProperties properties, const SerializedPart &part) {
+	auto has_bbox = part.type != GeometryType::POINT && part.vertex_count > 0;
+	properties.SetDoubleBBox(has_bbox && properties.HasDoubleBBox());
+	properties.SetBBox(has_bbox);
+	// A part of a valid collection need not be valid on its own, e.g. the touching shells of a MULTIPOLYGON
+	properties.SetValid(false);
+
+	auto blob = StringVector::EmptyString(result, 8 + properties.BBoxSize() + part.body_size);
+	Cursor cursor(blob);
+	cursor.Write<GeometryType>(part.type);
+	cursor.Write<GeometryProperties>(properties);
+	cursor.Write<uint16_t>(0);
+	cursor.Write<uint32_t>(0);
+
+	if (has_bbox) {
+		Cursor body(const_cast<data_ptr_t>(part.body), const_cast<data_ptr_t>(part.body) + part.body_size);
+		BoundsVisitor bounds {properties.HasZ(), properties.HasM(), SerializedVertexSize(properties), BoundingBox()};
+		VisitSerializedBody(body, bounds.vertex_size, bounds);
+		SerializeBoundingBox(cursor, bounds.bbox, properties);
+	}
+	memcpy(cursor.GetPtr(), part.body, part.body_size);
+
+	blob.Finalize();
+	return geometry_t(blob);
+}
+
+struct TransformVisitor {
+	const std::function<void(data_ptr_t, uint32_t, uint32_t)> &transform;
+	BoundsVisitor bounds;
+
+	void Words(const_data_ptr_t, idx_t) {
+	}
+	void Vertices(const_data_ptr_t data, uint32_t count) {
+		// The blob is a copy, so transform in place
+		transform(const_cast<data_ptr_t>(data), count, bounds.vertex_size);
+		bounds.Vertices(data, count);
+	}
+};
+
+geometry_t GeometryFactory::SerializedTransformVertices(
+    Vector &result, const geometry_t &data, const std::function<void(data_ptr_t, uint32_t, uint32_t)> &transform) {
+	string_t input = data;
+	auto size = input.GetSize();
+	auto blob = StringVector::EmptyString(result, size);
+	auto ptr = data_ptr_cast(blob.GetDataWriteable());
+	memcpy(ptr, input.GetData(), size);
+
+	Cursor cursor(ptr, ptr + size);
+	cursor.Skip(sizeof(GeometryType));
+	auto properties = cursor.Read<GeometryProperties>();
+	// Moving the vertices can make a valid geometry invalid
+	if (properties.IsValid()) {
+		properties.SetValid(false);
+		Store<GeometryProperties>(properties, ptr + sizeof(GeometryType));
+	}
+	cursor.Skip(2 + 4); // hash and padding
+	auto bbox_ptr = cursor.GetPtr();
+	cursor.Skip(properties.BBoxSize());
+
+	auto vertex_size = SerializedVertexSize(properties);
+	TransformVisitor visitor {transform, {properties.HasZ(), properties.HasM(), vertex_size, BoundingBox()}};
+	VisitSerializedBody(cursor, vertex_size, visitor);
+
+	if (properties.HasBBox()) {
+		Cursor bbox_cursor(bbox_ptr, bbox_ptr + properties.BBoxSize());
+		SerializeBoundingBox(bbox_cursor, visitor.bounds.bbox, properties);
+	}
+
+	blob.Finalize();
+	return geometry_t(blob);
+}
+
 //----------------------------------------------------------------------
 // Serialized Size
 //----------------------------------------------------------------------
@@ -539,6 +1018,8 @@ public:
 };
 
 Geometry GeometryFactory::Deserialize(const geometry_t &data) {
+	counters.deserialize_calls++;
+	counters.deserialize_bytes += string_t(data).GetSize();
 	GeometryDeserializer deserializer(allocator);
 	return deserializer.Execute(data);
 }
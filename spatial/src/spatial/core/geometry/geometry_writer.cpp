@@ -0,0 +1,140 @@
+#include "spatial/core/geometry/geometry_writer.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+
+namespace spatial {
+
+namespace core {
+
+void GeometryWriter::CopyVertices(const_data_ptr_t data, uint32_t count, bool in_z, bool in_m) {
+	if (count == 0) {
+		return;
+	}
+	auto in_vertex_size = sizeof(double) * (2 + (in_z ? 1 : 0) + (in_m ? 1 : 0));
+	auto out_vertex_size = sizeof(double) * (2 + (has_z ? 1 : 0) + (has_m ? 1 : 0));
+	buffer.Reserve(count * out_vertex_size);
+
+	if (in_z == has_z && in_m == has_m) {
+		// Same layout, copy the vertices as they are and only read them for the bounding box
+		buffer.Write(data, count * in_vertex_size);
+		auto m_offset = (has_z ? 3 : 2) * sizeof(double);
+		for (uint32_t i = 0; i < count; i++) {
+			auto vertex = data + i * in_vertex_size;
+			stats.Update(Load<double>(vertex), Load<double>(vertex + sizeof(double)));
+			if (has_z) {
+				stats.UpdateZ(Load<double>(vertex + 2 * sizeof(double)));
+			}
+			if (has_m) {
+				stats.UpdateM(Load<double>(vertex + m_offset));
+			}
+		}
+		return;
+	}
+
+	auto in_m_offset = (in_z ? 3 : 2) * sizeof(double);
+	for (uint32_t i = 0; i < count; i++) {
+		auto vertex = data + i * in_vertex_size;
+		auto x = Load<double>(vertex);
+		auto y = Load<double>(vertex + sizeof(double));
+		auto z = in_z ? Load<double>(vertex + 2 * sizeof(double)) : 0;
+		auto m = in_m ? Load<double>(vertex + in_m_offset) : 0;
+		AddVertex(x, y, z, m);
+	}
+}
+
+void GeometryWriter::AddGeometry(const Geometry &geometry) {
+	switch (geometry.Type()) {
+	case GeometryType::POINT: {
+		auto &point = geometry.As<Point>();
+		AddPoint(point.IsEmpty());
+		AddVertices(point.Vertices());
+		break;
+	}
+	case GeometryType::LINESTRING: {
+		auto &line = geometry.As<LineString>();
+		AddLineString(line.Vertices().Count());
+		AddVertices(line.Vertices());
+		break;
+	}
+	case GeometryType::POLYGON: {
+		auto &polygon = geometry.As<Polygon>();
+		AddPolygon(polygon.RingCount());
+		for (auto &ring : polygon) {
+			AddRing(ring.Count());
+		}
+		for (auto &ring : polygon) {
+			AddVertices(ring);
+		}
+		break;
+	}
+	case GeometryType::MULTIPOINT: {
+		auto &multipoint = geometry.As<MultiPoint>();
+		AddCollection(GeometryType::MULTIPOINT, multipoint.ItemCount());
+		for (auto &point : multipoint) {
+			AddPoint(point.IsEmpty());
+			AddVertices(point.Vertices());
+		}
+		break;
+	}
+	case GeometryType::MULTILINESTRING: {
+		auto &multiline = geometry.As<MultiLineString>();
+		AddCollection(GeometryType::MULTILINESTRING, multiline.ItemCount());
+		for (auto &line : multiline) {
+			AddLineString(line.Vertices().Count());
+			AddVertices(line.Vertices());
+		}
+		break;
+	}
+	case GeometryType::MULTIPOLYGON: {
+		auto &multipolygon = geometry.As<MultiPolygon>();
+		AddCollection(GeometryType::MULTIPOLYGON, multipolygon.ItemCount());
+		for (auto &polygon : multipolygon) {
+			AddPolygon(polygon.RingCount());
+			for (auto &ring : polygon) {
+				AddRing(ring.Count());
+			}
+			for (auto &ring : polygon) {
+				AddVertices(ring);
+			}
+		}
+		break;
+	}
+	case GeometryType::GEOMETRYCOLLECTION: {
+		auto &collection = geometry.As<GeometryCollection>();
+		AddCollection(GeometryType::GEOMETRYCOLLECTION, collection.ItemCount());
+		for (auto &item : collection) {
+			AddGeometry(item);
+		}
+		break;
+	}
+	default:
+		throw NotImplementedException("Unimplemented geometry type for GeometryWriter::AddGeometry");
+	}
+}
+
+geometry_t GeometryWriter::End(Vector &result) {
+	auto has_bbox = type != GeometryType::POINT && stats.vertex_count > 0;
+
+	GeometryProperties properties;
+	properties.SetBBox(has_bbox);
+	properties.SetDoubleBBox(has_bbox && double_bbox);
+	properties.SetZ(has_z);
+	properties.SetM(has_m);
+
+	auto blob = StringVector::EmptyString(result, 8 + properties.BBoxSize() + buffer.Size());
+	Cursor cursor(blob);
+	cursor.Write<GeometryType>(type);
+	cursor.Write<GeometryProperties>(properties);
+	cursor.Write<uint16_t>(0); // hash
+	cursor.Write<uint32_t>(0); // padding
+	GeometryFactory::SerializeBoundingBox(cursor, stats.bbox, properties);
+	memcpy(cursor.GetPtr(), buffer.GetPtr(), buffer.Size());
+
+	blob.Finalize();
+	return geometry_t(blob);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,72 @@
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/hex_codec.hpp"
+
+namespace spatial {
+
+namespace core {
+
+struct HexTables {
+	// The two characters of every byte
+	char encode[256][2];
+	// The value of every character, or 0xFF if it is not a hex digit
+	uint8_t decode[256];
+
+	HexTables() {
+		static constexpr const char *DIGITS = "0123456789ABCDEF";
+		for (idx_t i = 0; i < 256; i++) {
+			encode[i][0] = DIGITS[i >> 4];
+			encode[i][1] = DIGITS[i & 0x0F];
+			decode[i] = 0xFF;
+		}
+		for (uint8_t i = 0; i < 10; i++) {
+			decode['0' + i] = i;
+		}
+		for (uint8_t i = 0; i < 6; i++) {
+			decode['A' + i] = 10 + i;
+			decode['a' + i] = 10 + i;
+		}
+	}
+
+	static const HexTables &Get() {
+		static const HexTables tables;
+		return tables;
+	}
+};
+
+// The bytes are read a block at a time before their characters are written, which is what allows the input to
+// overlap the second half of the output: the characters of a block never reach past the bytes of the next block.
+static constexpr idx_t HEX_BLOCK_SIZE = 8;
+
+void HexCodec::Encode(const_data_ptr_t input, idx_t size, char *output) {
+	auto &encode = HexTables::Get().encode;
+	idx_t i = 0;
+	data_t block[HEX_BLOCK_SIZE];
+	for (; i + HEX_BLOCK_SIZE <= size; i += HEX_BLOCK_SIZE) {
+		memcpy(block, input + i, HEX_BLOCK_SIZE);
+		for (idx_t j = 0; j < HEX_BLOCK_SIZE; j++) {
+			memcpy(output + 2 * (i + j), encode[block[j]], 2);
+		}
+	}
+	for (; i < size; i++) {
+		auto byte = input[i];
+		memcpy(output + 2 * i, encode[byte], 2);
+	}
+}
+
+bool HexCodec::Decode(const char *input, idx_t size, data_ptr_t output) {
+	auto &decode = HexTables::Get().decode;
+	auto chars = const_data_ptr_cast(input);
+	uint8_t invalid = 0;
+	for (idx_t i = 0; i < size; i++) {
+		auto high = decode[chars[2 * i]];
+		auto low = decode[chars[2 * i + 1]];
+		invalid |= high | low;
+		output[i] = static_cast<data_t>((high << 4) | (low & 0x0F));
+	}
+	// Valid digits never set the high nibble
+	return (invalid & 0xF0) == 0;
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,301 @@
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/line_intersection.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/geometry_processor.hpp"
+#include "spatial/core/geometry/predicates.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Segments
+//------------------------------------------------------------------------------
+struct LineSegment {
+	double x1;
+	double y1;
+	double x2;
+	double y2;
+	// 0 for the segments of the left geometry, 1 for those of the right one
+	uint8_t side;
+
+	double MinX() const {
+		return MinValue(x1, x2);
+	}
+	double MaxX() const {
+		return MaxValue(x1, x2);
+	}
+	double MinY() const {
+		return MinValue(y1, y2);
+	}
+	double MaxY() const {
+		return MaxValue(y1, y2);
+	}
+};
+
+enum class SegmentIntersection : uint8_t {
+	NONE,
+	// The segments meet in a single point that is a vertex of at least one of them
+	VERTEX,
+	// The segments cross in a single point in the interior of both
+	PROPER,
+	// The segments are collinear and share more than a point
+	OVERLAP
+};
+
+static SegmentIntersection IntersectSegments(const LineSegment &p, const LineSegment &q, double &x, double &y) {
+	if (p.MaxX() < q.MinX() || q.MaxX() < p.MinX() || p.MaxY() < q.MinY() || q.MaxY() < p.MinY()) {
+		return SegmentIntersection::NONE;
+	}
+	auto o1 = Predicates::Orient2D(p.x1, p.y1, p.x2, p.y2, q.x1, q.y1);
+	auto o2 = Predicates::Orient2D(p.x1, p.y1, p.x2, p.y2, q.x2, q.y2);
+	if (o1 * o2 > 0) {
+		return SegmentIntersection::NONE;
+	}
+	auto o3 = Predicates::Orient2D(q.x1, q.y1, q.x2, q.y2, p.x1, p.y1);
+	auto o4 = Predicates::Orient2D(q.x1, q.y1, q.x2, q.y2, p.x2, p.y2);
+	if (o3 * o4 > 0) {
+		return SegmentIntersection::NONE;
+	}
+
+	if (o1 == 0 && o2 == 0 && o3 == 0 && o4 == 0) {
+		// Collinear with intersecting bounding boxes, so they share at least a point. Compare the ranges along the
+		// axis on which p is not degenerate to tell a shared end point from an overlap.
+		auto use_x = p.x1 != p.x2;
+		auto lo = use_x ? MaxValue(p.MinX(), q.MinX()) : MaxValue(p.MinY(), q.MinY());
+		auto hi = use_x ? MinValue(p.MaxX(), q.MaxX()) : MinValue(p.MaxY(), q.MaxY());
+		if (lo < hi) {
+			return SegmentIntersection::OVERLAP;
+		}
+		auto p1_shared = use_x ? p.x1 == lo : p.y1 == lo;
+		x = p1_shared ? p.x1 : p.x2;
+		y = p1_shared ? p.y1 : p.y2;
+		return SegmentIntersection::VERTEX;
+	}
+	if (o1 == 0) {
+		x = q.x1;
+		y = q.y1;
+	} else if (o2 == 0) {
+		x = q.x2;
+		y = q.y2;
+	} else if (o3 == 0) {
+		x = p.x1;
+		y = p.y1;
+	} else if (o4 == 0) {
+		x = p.x2;
+		y = p.y2;
+	} else {
+		return SegmentIntersection::PROPER;
+	}
+	return SegmentIntersection::VERTEX;
+}
+
+//------------------------------------------------------------------------------
+// Collect segments
+//------------------------------------------------------------------------------
+// Collects the segments of a (multi)linestring that can touch the other geometry, and the end points of its lines
+class SegmentCollector final : GeometryProcessor<void> {
+private:
+	vector<LineSegment> &segments;
+	vector<std::pair<double, double>> &end_points;
+	BoundingBox filter;
+	uint8_t side = 0;
+	bool supported = true;
+
+	void ProcessPoint(const VertexData &) override {
+		supported = false;
+	}
+
+	void ProcessLineString(const VertexData &vertices) override {
+		if (vertices.IsEmpty()) {
+			return;
+		}
+		auto x1 = Load<double>(vertices.data[0]);
+		auto y1 = Load<double>(vertices.data[1]);
+		end_points.emplace_back(x1, y1);
+		bool has_length = false;
+		for (uint32_t i = 1; i < vertices.count; i++) {
+			auto x2 = Load<double>(vertices.data[0] + i * vertices.stride[0]);
+			auto y2 = Load<double>(vertices.data[1] + i * vertices.stride[1]);
+			if (x1 == x2 && y1 == y2) {
+				continue;
+			}
+			has_length = true;
+			if (MaxValue(x1, x2) >= filter.minx && MinValue(x1, x2) <= filter.maxx &&
+			    MaxValue(y1, y2) >= filter.miny && MinValue(y1, y2) <= filter.maxy) {
+				segments.push_back({x1, y1, x2, y2, side});
+			}
+			x1 = x2;
+			y1 = y2;
+		}
+		end_points.emplace_back(x1, y1);
+		// GEOS has its own rules for lines that are a single point
+		if (!has_length) {
+			supported = false;
+		}
+	}
+
+	void ProcessPolygon(PolygonState &) override {
+		supported = false;
+	}
+
+	void ProcessCollection(CollectionState &state) override {
+		if (CurrentType() != GeometryType::MULTILINESTRING) {
+			supported = false;
+			return;
+		}
+		while (!state.IsDone() && supported) {
+			state.Next();
+		}
+	}
+
+public:
+	SegmentCollector(vector<LineSegment> &segments, vector<std::pair<double, double>> &end_points)
+	    : segments(segments), end_points(end_points) {
+	}
+
+	// Returns false if the geometry is not a (multi)linestring of lines with length
+	bool Execute(const geometry_t &geom, const BoundingBox &filter_p, uint8_t side_p) {
+		filter = filter_p;
+		side = side_p;
+		supported = true;
+		end_points.clear();
+		Process(geom);
+		return supported;
+	}
+};
+
+static bool IsLineal(const geometry_t &geom) {
+	auto type = geom.GetType();
+	return type == GeometryType::LINESTRING || type == GeometryType::MULTILINESTRING;
+}
+
+// The end points that are the end of an odd number of lines, sorted
+static void GetBoundary(vector<std::pair<double, double>> &end_points) {
+	std::sort(end_points.begin(), end_points.end());
+	idx_t boundary_count = 0;
+	for (idx_t i = 0; i < end_points.size();) {
+		idx_t j = i;
+		while (j < end_points.size() && end_points[j] == end_points[i]) {
+			j++;
+		}
+		if ((j - i) % 2 == 1) {
+			end_points[boundary_count++] = end_points[i];
+		}
+		i = j;
+	}
+	end_points.resize(boundary_count);
+}
+
+//------------------------------------------------------------------------------
+// Sweep
+//------------------------------------------------------------------------------
+// Compare the segments of the two sides whose x ranges overlap, in order of their minimum x. The callback returns
+// true to stop the sweep.
+template <class F>
+static void SweepSegments(vector<LineSegment> &segments, F &&callback) {
+	std::sort(segments.begin(), segments.end(),
+	          [](const LineSegment &a, const LineSegment &b) { return a.MinX() < b.MinX(); });
+	vector<uint32_t> active[2];
+	for (uint32_t i = 0; i < segments.size(); i++) {
+		auto &segment = segments[i];
+		auto min_x = segment.MinX();
+		auto &others = active[1 - segment.side];
+		idx_t kept = 0;
+		for (idx_t j = 0; j < others.size(); j++) {
+			auto &other = segments[others[j]];
+			// The segments are sorted, so one that ends before this one starts can not meet any of the next ones
+			if (other.MaxX() < min_x) {
+				continue;
+			}
+			others[kept++] = others[j];
+			if (callback(segment.side == 0 ? segment : other, segment.side == 0 ? other : segment)) {
+				return;
+			}
+		}
+		others.resize(kept);
+		active[segment.side].push_back(i);
+	}
+}
+
+static bool TryCollectSegments(const geometry_t &left, const geometry_t &right, vector<LineSegment> &segments,
+                               vector<std::pair<double, double>> &left_end_points,
+                               vector<std::pair<double, double>> &right_end_points) {
+	if (!IsLineal(left) || !IsLineal(right)) {
+		return false;
+	}
+	// Only the segments within the bounding box of the other geometry can intersect it
+	BoundingBox left_bbox;
+	BoundingBox right_bbox;
+	if (!GeometryFactory::TryGetSerializedBoundingBox(left, left_bbox) ||
+	    !GeometryFactory::TryGetSerializedBoundingBox(right, right_bbox)) {
+		// An empty line, which intersects nothing
+		return true;
+	}
+	SegmentCollector left_collector(segments, left_end_points);
+	SegmentCollector right_collector(segments, right_end_points);
+	return left_collector.Execute(left, right_bbox, 0) && right_collector.Execute(right, left_bbox, 1);
+}
+
+//------------------------------------------------------------------------------
+// Predicates
+//------------------------------------------------------------------------------
+bool LineIntersection::TryIntersects(const geometry_t &left, const geometry_t &right, bool &result) {
+	vector<LineSegment> segments;
+	vector<std::pair<double, double>> left_end_points;
+	vector<std::pair<double, double>> right_end_points;
+	if (!TryCollectSegments(left, right, segments, left_end_points, right_end_points)) {
+		return false;
+	}
+	result = false;
+	SweepSegments(segments, [&](const LineSegment &p, const LineSegment &q) {
+		double x;
+		double y;
+		result = IntersectSegments(p, q, x, y) != SegmentIntersection::NONE;
+		return result;
+	});
+	return true;
+}
+
+bool LineIntersection::TryCrosses(const geometry_t &left, const geometry_t &right, bool &result) {
+	vector<LineSegment> segments;
+	vector<std::pair<double, double>> left_boundary;
+	vector<std::pair<double, double>> right_boundary;
+	if (!TryCollectSegments(left, right, segments, left_boundary, right_boundary)) {
+		return false;
+	}
+	GetBoundary(left_boundary);
+	GetBoundary(right_boundary);
+
+	// The interiors have to meet, but only in points: any overlap of positive length is shared by the interiors
+	bool interiors_meet = false;
+	bool overlap = false;
+	SweepSegments(segments, [&](const LineSegment &p, const LineSegment &q) {
+		double x;
+		double y;
+		switch (IntersectSegments(p, q, x, y)) {
+		case SegmentIntersection::OVERLAP:
+			overlap = true;
+			return true;
+		case SegmentIntersection::PROPER:
+			interiors_meet = true;
+			break;
+		case SegmentIntersection::VERTEX:
+			if (!interiors_meet) {
+				auto point = std::make_pair(x, y);
+				interiors_meet = !std::binary_search(left_boundary.begin(), left_boundary.end(), point) &&
+				                 !std::binary_search(right_boundary.begin(), right_boundary.end(), point);
+			}
+			break;
+		default:
+			break;
+		}
+		return false;
+	});
+	result = interiors_meet && !overlap;
+	return true;
+}
+
+} // namespace core
+
+} // namespace spatial
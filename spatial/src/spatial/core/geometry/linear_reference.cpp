@@ -0,0 +1,121 @@
+#include "spatial/core/geometry/linear_reference.hpp"
+
+namespace spatial {
+
+namespace core {
+
+bool LinearReference::Load(const_data_ptr_t vertices, uint32_t count, uint32_t dimensions_p) {
+	auto size = static_cast<idx_t>(count) * dimensions_p;
+	if (dimensions_p == dimensions && count == Count() &&
+	    (size == 0 || memcmp(coords.data(), vertices, size * sizeof(double)) == 0)) {
+		return false;
+	}
+	dimensions = dimensions_p;
+	coords.resize(size);
+	memcpy(coords.data(), vertices, size * sizeof(double));
+	cumulative.resize(count);
+	Measure();
+	return true;
+}
+
+bool LinearReference::Load(const double *xs, const double *ys, uint32_t count) {
+	if (dimensions == 2 && count == Count()) {
+		bool same = true;
+		for (uint32_t i = 0; same && i < count; i++) {
+			same = coords[2 * i] == xs[i] && coords[2 * i + 1] == ys[i];
+		}
+		if (same) {
+			return false;
+		}
+	}
+	dimensions = 2;
+	coords.resize(static_cast<idx_t>(count) * 2);
+	for (uint32_t i = 0; i < count; i++) {
+		coords[2 * i] = xs[i];
+		coords[2 * i + 1] = ys[i];
+	}
+	cumulative.resize(count);
+	Measure();
+	return true;
+}
+
+void LinearReference::Measure() {
+	if (cumulative.empty()) {
+		return;
+	}
+	double length = 0;
+	cumulative[0] = 0;
+	for (uint32_t i = 1; i < Count(); i++) {
+		auto a = Vertex(i - 1);
+		auto b = Vertex(i);
+		length += std::sqrt((b[0] - a[0]) * (b[0] - a[0]) + (b[1] - a[1]) * (b[1] - a[1]));
+		cumulative[i] = length;
+	}
+}
+
+uint32_t LinearReference::FindSegment(double distance) const {
+	D_ASSERT(Count() >= 2);
+	auto next = std::upper_bound(cumulative.begin(), cumulative.end(), distance) - cumulative.begin();
+	return static_cast<uint32_t>(MinValue<int64_t>(MaxValue<int64_t>(next - 1, 0), Count() - 2));
+}
+
+void LinearReference::Interpolate(double distance, double *out) const {
+	D_ASSERT(Count() > 0);
+	if (Count() == 1) {
+		memcpy(out, Vertex(0), dimensions * sizeof(double));
+		return;
+	}
+	auto segment = FindSegment(distance);
+	auto a = Vertex(segment);
+	auto b = Vertex(segment + 1);
+	auto segment_length = cumulative[segment + 1] - cumulative[segment];
+	auto t = segment_length > 0 ? (distance - cumulative[segment]) / segment_length : 0;
+	t = MinValue(MaxValue(t, 0.0), 1.0);
+	for (uint32_t d = 0; d < dimensions; d++) {
+		out[d] = t == 1 ? b[d] : a[d] + t * (b[d] - a[d]);
+	}
+}
+
+double LinearReference::Locate(double x, double y) const {
+	double result = 0;
+	auto min_distance_sq = std::numeric_limits<double>::infinity();
+	for (uint32_t i = 0; i + 1 < Count(); i++) {
+		auto a = Vertex(i);
+		auto b = Vertex(i + 1);
+		auto dx = b[0] - a[0];
+		auto dy = b[1] - a[1];
+		auto len_sq = dx * dx + dy * dy;
+		auto r = len_sq == 0 ? 0 : ((x - a[0]) * dx + (y - a[1]) * dy) / len_sq;
+		r = MinValue(MaxValue(r, 0.0), 1.0);
+		auto cx = a[0] + r * dx - x;
+		auto cy = a[1] + r * dy - y;
+		auto distance_sq = cx * cx + cy * cy;
+		if (distance_sq < min_distance_sq) {
+			min_distance_sq = distance_sq;
+			result = cumulative[i] + r * (cumulative[i + 1] - cumulative[i]);
+		}
+	}
+	return result;
+}
+
+void LinearReference::Substring(double start, double end, vector<double> &out) const {
+	D_ASSERT(Count() > 0 && start <= end);
+	auto offset = out.size();
+	out.resize(offset + dimensions);
+	Interpolate(start, &out[offset]);
+	if (Count() >= 2) {
+		for (auto i = FindSegment(start) + 1; i < Count() && cumulative[i] < end; i++) {
+			if (cumulative[i] > start) {
+				auto vertex = Vertex(i);
+				out.insert(out.end(), vertex, vertex + dimensions);
+			}
+		}
+	}
+	offset = out.size();
+	out.resize(offset + dimensions);
+	Interpolate(end, &out[offset]);
+}
+
+} // namespace core
+
+} // namespace spatial
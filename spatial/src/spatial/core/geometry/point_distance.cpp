@@ -0,0 +1,106 @@
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/point_distance.hpp"
+#include "spatial/core/geometry/point_in_polygon.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/geometry_processor.hpp"
+
+namespace spatial {
+
+namespace core {
+
+// Finds the smallest squared distance from a point to any vertex or segment of a geometry. Polygon rings are treated
+// as linestrings, so whether the point is inside a polygon has to be checked separately.
+class VertexDistanceFinder final : GeometryProcessor<void> {
+private:
+	double x = 0;
+	double y = 0;
+	double min_distance_sq = 0;
+
+	void ProcessVertices(const VertexData &data) {
+		if (data.count == 0) {
+			return;
+		}
+		auto x1 = Load<double>(data.data[0]);
+		auto y1 = Load<double>(data.data[1]);
+		if (data.count == 1) {
+			min_distance_sq = std::min(min_distance_sq, (x - x1) * (x - x1) + (y - y1) * (y - y1));
+			return;
+		}
+		for (uint32_t i = 1; i < data.count && min_distance_sq > 0; i++) {
+			auto x2 = Load<double>(data.data[0] + i * data.stride[0]);
+			auto y2 = Load<double>(data.data[1] + i * data.stride[1]);
+			min_distance_sq = std::min(min_distance_sq, PointDistance::ToSegmentSquared(x, y, x1, y1, x2, y2));
+			x1 = x2;
+			y1 = y2;
+		}
+	}
+
+	void ProcessPoint(const VertexData &data) override {
+		ProcessVertices(data);
+	}
+	void ProcessLineString(const VertexData &data) override {
+		ProcessVertices(data);
+	}
+	void ProcessPolygon(PolygonState &state) override {
+		while (!state.IsDone()) {
+			ProcessVertices(state.Next());
+		}
+	}
+	void ProcessCollection(CollectionState &state) override {
+		while (!state.IsDone()) {
+			state.Next();
+		}
+	}
+
+public:
+	double Find(const geometry_t &geom, double x_p, double y_p) {
+		x = x_p;
+		y = y_p;
+		min_distance_sq = std::numeric_limits<double>::infinity();
+		Process(geom);
+		return std::sqrt(min_distance_sq);
+	}
+};
+
+bool PointDistance::TryCompute(const geometry_t &left, const geometry_t &right, double &distance) {
+	double x;
+	double y;
+	auto left_is_point = PointInPolygon::TryGetPoint(left, x, y);
+	if (!left_is_point && !PointInPolygon::TryGetPoint(right, x, y)) {
+		return false;
+	}
+	auto &point = left_is_point ? left : right;
+	auto &other = left_is_point ? right : left;
+
+	auto other_type = other.GetType();
+	if (other_type == GeometryType::GEOMETRYCOLLECTION) {
+		return false;
+	}
+	BoundingBox bbox;
+	if (!GeometryFactory::TryGetSerializedBoundingBox(other, bbox)) {
+		// Empty
+		return false;
+	}
+
+	if (other_type == GeometryType::POINT) {
+		// The bounding box of a point is exact
+		distance = std::sqrt((bbox.minx - x) * (bbox.minx - x) + (bbox.miny - y) * (bbox.miny - y));
+		return true;
+	}
+
+	if (other_type == GeometryType::POLYGON || other_type == GeometryType::MULTIPOLYGON) {
+		PointLocation location;
+		if (PointInPolygon::TryLocate(point, other, location) && location != PointLocation::EXTERIOR) {
+			distance = 0;
+			return true;
+		}
+	}
+
+	VertexDistanceFinder finder;
+	distance = finder.Find(other, x, y);
+	return true;
+}
+
+} // namespace core
+
+} // namespace spatial
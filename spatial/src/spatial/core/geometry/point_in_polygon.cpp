@@ -0,0 +1,296 @@
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/point_in_polygon.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/geometry_processor.hpp"
+#include "spatial/core/geometry/predicates.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Ray crossing
+//------------------------------------------------------------------------------
+// Count the crossings of a ray going from (x, y) towards positive x with the segment p1 -> p2. Returns true if the
+// point lies on the segment, in which case the crossing count is meaningless.
+static bool CountSegment(double x, double y, double x1, double y1, double x2, double y2, uint32_t &crossings) {
+	// Segment is strictly to the left of the point
+	if (x1 < x && x2 < x) {
+		return false;
+	}
+	// Point is a vertex of the segment (the start vertex is the end vertex of the previous segment)
+	if (x == x2 && y == y2) {
+		return true;
+	}
+	// Horizontal segment, it can only contain the point
+	if (y1 == y && y2 == y) {
+		return std::min(x1, x2) <= x && x <= std::max(x1, x2);
+	}
+	// Segment straddling the ray, the lower end point is included and the upper one is not
+	if ((y1 > y && y2 <= y) || (y2 > y && y1 <= y)) {
+		auto orientation = Predicates::Orient2D(x1, y1, x2, y2, x, y);
+		if (orientation == 0) {
+			return true;
+		}
+		if (y2 < y1) {
+			orientation = -orientation;
+		}
+		if (orientation > 0) {
+			crossings++;
+		}
+	}
+	return false;
+}
+
+//------------------------------------------------------------------------------
+// Linear scan
+//------------------------------------------------------------------------------
+class PointLocator final : GeometryProcessor<void> {
+private:
+	double x = 0;
+	double y = 0;
+	uint32_t crossings = 0;
+	bool on_boundary = false;
+
+	void ProcessPoint(const VertexData &data) override {
+		// Not areal
+	}
+	void ProcessLineString(const VertexData &data) override {
+		// Not areal
+	}
+	void ProcessPolygon(PolygonState &state) override {
+		while (!state.IsDone() && !on_boundary) {
+			auto ring = state.Next();
+			if (ring.count < 2) {
+				continue;
+			}
+			auto x1 = Load<double>(ring.data[0]);
+			auto y1 = Load<double>(ring.data[1]);
+			for (uint32_t i = 1; i < ring.count; i++) {
+				auto x2 = Load<double>(ring.data[0] + i * ring.stride[0]);
+				auto y2 = Load<double>(ring.data[1] + i * ring.stride[1]);
+				if (CountSegment(x, y, x1, y1, x2, y2, crossings)) {
+					on_boundary = true;
+					break;
+				}
+				x1 = x2;
+				y1 = y2;
+			}
+		}
+	}
+	void ProcessCollection(CollectionState &state) override {
+		// Stopping early is fine here since nothing is read after the collection
+		while (!state.IsDone() && !on_boundary) {
+			state.Next();
+		}
+	}
+
+public:
+	PointLocation Locate(const geometry_t &polygon, double x_p, double y_p) {
+		x = x_p;
+		y = y_p;
+		crossings = 0;
+		on_boundary = false;
+		Process(polygon);
+		if (on_boundary) {
+			return PointLocation::BOUNDARY;
+		}
+		return (crossings % 2) == 1 ? PointLocation::INTERIOR : PointLocation::EXTERIOR;
+	}
+};
+
+static bool IsPolygonal(const geometry_t &geom) {
+	auto type = geom.GetType();
+	return type == GeometryType::POLYGON || type == GeometryType::MULTIPOLYGON;
+}
+
+bool PointInPolygon::TryGetPoint(const geometry_t &geom, double &x, double &y) {
+	if (geom.GetType() != GeometryType::POINT) {
+		return false;
+	}
+	// The "bounding box" of a point is the point itself
+	BoundingBox bbox;
+	if (!GeometryFactory::TryGetSerializedBoundingBox(geom, bbox)) {
+		return false;
+	}
+	x = bbox.minx;
+	y = bbox.miny;
+	return true;
+}
+
+bool PointInPolygon::TryLocate(const geometry_t &point, const geometry_t &polygon, PointLocation &location) {
+	double x;
+	double y;
+	if (!IsPolygonal(polygon) || !TryGetPoint(point, x, y)) {
+		return false;
+	}
+	BoundingBox bbox;
+	if (!GeometryFactory::TryGetSerializedBoundingBox(polygon, bbox)) {
+		// Empty polygon
+		location = PointLocation::EXTERIOR;
+		return true;
+	}
+	// The header bounding box is rounded outwards, so this never rejects a point on the boundary
+	if (x < bbox.minx || x > bbox.maxx || y < bbox.miny || y > bbox.maxy) {
+		location = PointLocation::EXTERIOR;
+		return true;
+	}
+	PointLocator locator;
+	location = locator.Locate(polygon, x, y);
+	return true;
+}
+
+//------------------------------------------------------------------------------
+// Prepared polygon
+//------------------------------------------------------------------------------
+class EdgeCollector final : GeometryProcessor<void> {
+private:
+	vector<std::array<double, 4>> &edges;
+
+	void ProcessPoint(const VertexData &data) override {
+	}
+	void ProcessLineString(const VertexData &data) override {
+	}
+	void ProcessPolygon(PolygonState &state) override {
+		while (!state.IsDone()) {
+			auto ring = state.Next();
+			for (uint32_t i = 1; i < ring.count; i++) {
+				auto x1 = Load<double>(ring.data[0] + (i - 1) * ring.stride[0]);
+				auto y1 = Load<double>(ring.data[1] + (i - 1) * ring.stride[1]);
+				auto x2 = Load<double>(ring.data[0] + i * ring.stride[0]);
+				auto y2 = Load<double>(ring.data[1] + i * ring.stride[1]);
+				edges.push_back({x1, y1, x2, y2});
+			}
+		}
+	}
+	void ProcessCollection(CollectionState &state) override {
+		while (!state.IsDone()) {
+			state.Next();
+		}
+	}
+
+public:
+	explicit EdgeCollector(vector<std::array<double, 4>> &edges) : edges(edges) {
+	}
+	void Collect(const geometry_t &geom) {
+		Process(geom);
+	}
+};
+
+unique_ptr<PreparedPolygon> PreparedPolygon::TryCreate(const geometry_t &polygon) {
+	if (!IsPolygonal(polygon)) {
+		return nullptr;
+	}
+
+	vector<std::array<double, 4>> raw_edges;
+	EdgeCollector collector(raw_edges);
+	collector.Collect(polygon);
+	return TryCreate(raw_edges);
+}
+
+unique_ptr<PreparedPolygon> PreparedPolygon::TryCreate(const list_entry_t *rings, idx_t ring_count,
+                                                       const double *x_data, const double *y_data) {
+	vector<std::array<double, 4>> raw_edges;
+	for (idx_t ring_idx = 0; ring_idx < ring_count; ring_idx++) {
+		auto &ring = rings[ring_idx];
+		for (idx_t i = ring.offset + 1; i < ring.offset + ring.length; i++) {
+			raw_edges.push_back({x_data[i - 1], y_data[i - 1], x_data[i], y_data[i]});
+		}
+	}
+	return TryCreate(raw_edges);
+}
+
+unique_ptr<PreparedPolygon> PreparedPolygon::TryCreate(const vector<std::array<double, 4>> &raw_edges) {
+	if (raw_edges.empty()) {
+		return nullptr;
+	}
+
+	auto result = make_uniq<PreparedPolygon>();
+	result->edges.reserve(raw_edges.size());
+	for (auto &edge : raw_edges) {
+		result->edges.push_back({edge[0], edge[1], edge[2], edge[3]});
+		result->bbox.minx = std::min(result->bbox.minx, std::min(edge[0], edge[2]));
+		result->bbox.miny = std::min(result->bbox.miny, std::min(edge[1], edge[3]));
+		result->bbox.maxx = std::max(result->bbox.maxx, std::max(edge[0], edge[2]));
+		result->bbox.maxy = std::max(result->bbox.maxy, std::max(edge[1], edge[3]));
+	}
+	result->BuildIndex();
+	return result;
+}
+
+void PreparedPolygon::BuildIndex() {
+	static constexpr idx_t MAX_STRIPS = 4096;
+	// Long edges are replicated into every strip they span, so cap the total size of the index relative to the
+	// number of edges and use fewer strips if it would be exceeded
+	static constexpr idx_t MAX_ENTRIES_PER_EDGE = 8;
+
+	auto edge_count = edges.size();
+	auto height = bbox.maxy - bbox.miny;
+	idx_t strip_count = MinValue<idx_t>(MaxValue<idx_t>(edge_count / 4, 1), MAX_STRIPS);
+
+	while (true) {
+		strip_height = height > 0 ? height / static_cast<double>(strip_count) : 1;
+		strip_offsets.assign(strip_count + 1, 0);
+
+		auto get_strip = [&](double y) {
+			auto strip = static_cast<int64_t>((y - bbox.miny) / strip_height);
+			return static_cast<idx_t>(MinValue<int64_t>(MaxValue<int64_t>(strip, 0), strip_count - 1));
+		};
+
+		// Count the edges per strip
+		idx_t total = 0;
+		for (auto &edge : edges) {
+			auto first = get_strip(std::min(edge.y1, edge.y2));
+			auto last = get_strip(std::max(edge.y1, edge.y2));
+			for (auto strip = first; strip <= last; strip++) {
+				strip_offsets[strip + 1]++;
+			}
+			total += last - first + 1;
+		}
+
+		if (strip_count > 1 && total > edge_count * MAX_ENTRIES_PER_EDGE) {
+			strip_count /= 2;
+			continue;
+		}
+
+		// Prefix sum, then fill in the edge ids
+		for (idx_t i = 0; i < strip_count; i++) {
+			strip_offsets[i + 1] += strip_offsets[i];
+		}
+		vector<uint32_t> fill(strip_offsets.begin(), strip_offsets.end() - 1);
+		strip_edges.resize(total);
+		for (idx_t edge_idx = 0; edge_idx < edge_count; edge_idx++) {
+			auto &edge = edges[edge_idx];
+			auto first = get_strip(std::min(edge.y1, edge.y2));
+			auto last = get_strip(std::max(edge.y1, edge.y2));
+			for (auto strip = first; strip <= last; strip++) {
+				strip_edges[fill[strip]++] = static_cast<uint32_t>(edge_idx);
+			}
+		}
+		return;
+	}
+}
+
+PointLocation PreparedPolygon::Locate(double x, double y) const {
+	if (x < bbox.minx || x > bbox.maxx || y < bbox.miny || y > bbox.maxy) {
+		return PointLocation::EXTERIOR;
+	}
+
+	// Every edge that can contain or cross the ray spans y, so it is in the strip of y
+	auto strip_count = static_cast<int64_t>(strip_offsets.size() - 1);
+	auto strip = static_cast<int64_t>((y - bbox.miny) / strip_height);
+	strip = MinValue<int64_t>(MaxValue<int64_t>(strip, 0), strip_count - 1);
+
+	uint32_t crossings = 0;
+	for (auto i = strip_offsets[strip]; i < strip_offsets[strip + 1]; i++) {
+		auto &edge = edges[strip_edges[i]];
+		if (CountSegment(x, y, edge.x1, edge.y1, edge.x2, edge.y2, crossings)) {
+			return PointLocation::BOUNDARY;
+		}
+	}
+	return (crossings % 2) == 1 ? PointLocation::INTERIOR : PointLocation::EXTERIOR;
+}
+
+} // namespace core
+
+} // namespace spatial
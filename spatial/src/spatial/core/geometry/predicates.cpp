@@ -0,0 +1,170 @@
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/predicates.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Expansion arithmetic
+//------------------------------------------------------------------------------
+// An expansion is a sum of doubles that do not overlap, ordered by increasing magnitude, and represents its value
+// exactly. Zero terms are dropped, so the sign of an expansion is the sign of its last term.
+
+// x + y == a + b exactly, with x the rounded sum
+static inline void TwoSum(double a, double b, double &x, double &y) {
+	x = a + b;
+	auto b_virtual = x - a;
+	auto a_virtual = x - b_virtual;
+	y = (a - a_virtual) + (b - b_virtual);
+}
+
+// Same as TwoSum, but only if |a| >= |b|
+static inline void FastTwoSum(double a, double b, double &x, double &y) {
+	x = a + b;
+	y = b - (x - a);
+}
+
+// x + y == a * b exactly, with x the rounded product
+static inline void TwoProduct(double a, double b, double &x, double &y) {
+	x = a * b;
+	y = std::fma(a, b, -x);
+}
+
+// h = e + b, h may be e and needs room for elen + 1 terms
+static idx_t GrowExpansion(const double *e, idx_t elen, double b, double *h) {
+	idx_t hlen = 0;
+	auto q = b;
+	for (idx_t i = 0; i < elen; i++) {
+		double sum, err;
+		TwoSum(q, e[i], sum, err);
+		q = sum;
+		if (err != 0) {
+			h[hlen++] = err;
+		}
+	}
+	if (q != 0 || hlen == 0) {
+		h[hlen++] = q;
+	}
+	return hlen;
+}
+
+// h += a * b, h needs room for hlen + 2 terms
+static idx_t AddProduct(double *h, idx_t hlen, double a, double b) {
+	double product, err;
+	TwoProduct(a, b, product, err);
+	hlen = GrowExpansion(h, hlen, err, h);
+	return GrowExpansion(h, hlen, product, h);
+}
+
+// h += f, h needs room for hlen + flen terms
+static idx_t AddExpansion(double *h, idx_t hlen, const double *f, idx_t flen) {
+	for (idx_t i = 0; i < flen; i++) {
+		hlen = GrowExpansion(h, hlen, f[i], h);
+	}
+	return hlen;
+}
+
+// h = e * b, h needs room for 2 * elen terms
+static idx_t ScaleExpansion(const double *e, idx_t elen, double b, double *h) {
+	idx_t hlen = 0;
+	double q, err;
+	TwoProduct(e[0], b, q, err);
+	if (err != 0) {
+		h[hlen++] = err;
+	}
+	for (idx_t i = 1; i < elen; i++) {
+		double product, product_err, sum;
+		TwoProduct(e[i], b, product, product_err);
+		TwoSum(q, product_err, sum, err);
+		if (err != 0) {
+			h[hlen++] = err;
+		}
+		FastTwoSum(product, sum, q, err);
+		if (err != 0) {
+			h[hlen++] = err;
+		}
+	}
+	if (q != 0 || hlen == 0) {
+		h[hlen++] = q;
+	}
+	return hlen;
+}
+
+static inline int Sign(const double *e, idx_t elen) {
+	auto last = e[elen - 1];
+	return last > 0 ? 1 : (last < 0 ? -1 : 0);
+}
+
+// The determinant |ax ay 1; bx by 1; cx cy 1| as an expansion of at most 12 terms
+static idx_t Orient2DExpansion(double ax, double ay, double bx, double by, double cx, double cy, double *h) {
+	idx_t hlen = 0;
+	hlen = AddProduct(h, hlen, ax, by);
+	hlen = AddProduct(h, hlen, -ay, bx);
+	hlen = AddProduct(h, hlen, bx, cy);
+	hlen = AddProduct(h, hlen, -by, cx);
+	hlen = AddProduct(h, hlen, cx, ay);
+	return AddProduct(h, hlen, -cy, ax);
+}
+
+//------------------------------------------------------------------------------
+// Orient2D
+//------------------------------------------------------------------------------
+int Predicates::Orient2DExact(double ax, double ay, double bx, double by, double cx, double cy) {
+	double det[12];
+	auto len = Orient2DExpansion(ax, ay, bx, by, cx, cy, det);
+	return Sign(det, len);
+}
+
+void Predicates::Orient2D(const double *ax, const double *ay, const double *bx, const double *by, const double *cx,
+                          const double *cy, int8_t *result, idx_t count) {
+	// Filter all of them first without branching, 0 marks the ones the filter can not decide
+	for (idx_t i = 0; i < count; i++) {
+		auto det_left = (ax[i] - cx[i]) * (by[i] - cy[i]);
+		auto det_right = (ay[i] - cy[i]) * (bx[i] - cx[i]);
+		auto det = det_left - det_right;
+		auto err_bound = ORIENT_ERROR_BOUND * (std::fabs(det_left) + std::fabs(det_right));
+		result[i] = static_cast<int8_t>((det > err_bound) - (-det > err_bound));
+	}
+	for (idx_t i = 0; i < count; i++) {
+		if (result[i] == 0) {
+			result[i] = static_cast<int8_t>(Orient2DExact(ax[i], ay[i], bx[i], by[i], cx[i], cy[i]));
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// InCircle
+//------------------------------------------------------------------------------
+// The 4x4 determinant with rows (x, y, x^2 + y^2, 1), expanded along the lifted column into four 3x3 orientation
+// determinants. Unlike the filter, this does not translate the points by d, as the differences would not be exact.
+int Predicates::InCircleExact(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy) {
+	const double px[4] = {ax, bx, cx, dx};
+	const double py[4] = {ay, by, cy, dy};
+	// The other three points of every term, in the order that gives it a positive sign
+	static constexpr idx_t OTHERS[4][3] = {{1, 2, 3}, {2, 0, 3}, {0, 1, 3}, {1, 0, 2}};
+
+	double det[384];
+	idx_t det_len = 0;
+	for (idx_t i = 0; i < 4; i++) {
+		double lift[4];
+		idx_t lift_len = 0;
+		lift_len = AddProduct(lift, lift_len, px[i], px[i]);
+		lift_len = AddProduct(lift, lift_len, py[i], py[i]);
+
+		auto &o = OTHERS[i];
+		double orient[12];
+		auto orient_len = Orient2DExpansion(px[o[0]], py[o[0]], px[o[1]], py[o[1]], px[o[2]], py[o[2]], orient);
+
+		for (idx_t j = 0; j < lift_len; j++) {
+			double term[24];
+			auto term_len = ScaleExpansion(orient, orient_len, lift[j], term);
+			det_len = AddExpansion(det, det_len, term, term_len);
+		}
+	}
+	return Sign(det, det_len);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,535 @@
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/quantized_geometry.hpp"
+#include "spatial/core/geometry/geometry_processor.hpp"
+#include "spatial/core/geometry/point_distance.hpp"
+#include "spatial/core/geometry/cursor.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Grid
+//------------------------------------------------------------------------------
+// Converts between coordinates and grid positions. Decimal grid sizes like 0.01 are not exact in binary but their
+// inverse is, so dividing by the inverse turns a grid position back into the double closest to the decimal value.
+struct QuantizedGrid {
+	double size;
+	double inverse;
+	bool has_exact_inverse;
+
+	explicit QuantizedGrid(double size_p)
+	    : size(size_p), inverse(1 / size_p), has_exact_inverse(inverse == std::round(inverse)) {
+	}
+	double ToGrid(double value) const {
+		return has_exact_inverse ? value * inverse : value / size;
+	}
+	double ToWorld(double position) const {
+		return has_exact_inverse ? position / inverse : position * size;
+	}
+};
+
+//------------------------------------------------------------------------------
+// Quantizer
+//------------------------------------------------------------------------------
+// Processes the geometry twice, first to measure its extent, which decides the origin and the grid size, and then to
+// write the vertices on the grid. The origin is snapped to the grid as well, so that the same coordinate always ends
+// up at the same grid position regardless of the geometry it is part of.
+class Quantizer final : GeometryProcessor<void, vector<data_t> &> {
+	bool measuring = false;
+	bool has_vertices = false;
+	double min_x = 0;
+	double min_y = 0;
+	double max_x = 0;
+	double max_y = 0;
+
+	QuantizedGrid grid = QuantizedGrid(1);
+	double origin_index_x = 0;
+	double origin_index_y = 0;
+	int32_t bounds[4] = {0, 0, 0, 0};
+
+	template <class T>
+	void Append(vector<data_t> &out, T value) {
+		if (measuring) {
+			return;
+		}
+		auto offset = out.size();
+		out.resize(offset + sizeof(T));
+		Store<T>(value, out.data() + offset);
+	}
+
+	void AppendType(vector<data_t> &out) {
+		// Only the items of collections store their type, the type of the geometry itself is in the header
+		if (IsNested()) {
+			Append<uint32_t>(out, static_cast<uint32_t>(CurrentType()));
+		}
+	}
+
+	int32_t Snap(double value, double origin_index) const {
+		auto position = std::round(grid.ToGrid(value)) - origin_index;
+		if (!(position >= 0 && position <= static_cast<double>(std::numeric_limits<int32_t>::max()))) {
+			throw InvalidInputException(
+			    "GEOMETRY_Q: the geometry does not fit in 32 bit integers at grid size %s, use a larger grid size",
+			    std::to_string(grid.size));
+		}
+		return static_cast<int32_t>(position);
+	}
+
+	void ProcessVertices(const VertexData &vertices, vector<data_t> &out) {
+		for (uint32_t i = 0; i < vertices.count; i++) {
+			auto x = Load<double>(vertices.data[0] + i * vertices.stride[0]);
+			auto y = Load<double>(vertices.data[1] + i * vertices.stride[1]);
+			if (measuring) {
+				if (!std::isfinite(x) || !std::isfinite(y)) {
+					throw InvalidInputException("GEOMETRY_Q: can not quantize non-finite coordinates");
+				}
+				min_x = has_vertices ? MinValue(min_x, x) : x;
+				min_y = has_vertices ? MinValue(min_y, y) : y;
+				max_x = has_vertices ? MaxValue(max_x, x) : x;
+				max_y = has_vertices ? MaxValue(max_y, y) : y;
+				has_vertices = true;
+				continue;
+			}
+			auto qx = Snap(x, origin_index_x);
+			auto qy = Snap(y, origin_index_y);
+			bounds[0] = MinValue(bounds[0], qx);
+			bounds[1] = MinValue(bounds[1], qy);
+			bounds[2] = MaxValue(bounds[2], qx);
+			bounds[3] = MaxValue(bounds[3], qy);
+			Append<int32_t>(out, qx);
+			Append<int32_t>(out, qy);
+		}
+	}
+
+	void ProcessPoint(const VertexData &vertices, vector<data_t> &out) override {
+		AppendType(out);
+		Append<uint32_t>(out, vertices.count);
+		ProcessVertices(vertices, out);
+	}
+
+	void ProcessLineString(const VertexData &vertices, vector<data_t> &out) override {
+		AppendType(out);
+		Append<uint32_t>(out, vertices.count);
+		ProcessVertices(vertices, out);
+	}
+
+	void ProcessPolygon(PolygonState &state, vector<data_t> &out) override {
+		AppendType(out);
+		Append<uint32_t>(out, state.RingCount());
+		while (!state.IsDone()) {
+			auto vertices = state.Next();
+			Append<uint32_t>(out, vertices.count);
+			ProcessVertices(vertices, out);
+		}
+	}
+
+	void ProcessCollection(CollectionState &state, vector<data_t> &out) override {
+		AppendType(out);
+		Append<uint32_t>(out, state.ItemCount());
+		while (!state.IsDone()) {
+			state.Next(out);
+		}
+	}
+
+	void ChooseGrid(double requested_grid_size) {
+		if (requested_grid_size > 0) {
+			grid = QuantizedGrid(requested_grid_size);
+		} else {
+			// The finest power of ten at which the extent fits, keeping a margin for rounding
+			auto extent = has_vertices ? MaxValue(max_x - min_x, max_y - min_y) : 0;
+			auto limit = static_cast<double>(std::numeric_limits<int32_t>::max()) - 2;
+			auto exponent = QuantizedGeometry::MIN_AUTO_GRID_EXPONENT;
+			while (extent / std::pow(10.0, exponent) > limit) {
+				exponent++;
+			}
+			grid = QuantizedGrid(std::pow(10.0, exponent));
+		}
+		origin_index_x = has_vertices ? std::floor(grid.ToGrid(min_x)) : 0;
+		origin_index_y = has_vertices ? std::floor(grid.ToGrid(min_y)) : 0;
+	}
+
+public:
+	void Execute(const geometry_t &geometry, double requested_grid_size, vector<data_t> &buffer) {
+		auto properties = geometry.GetProperties();
+		if (properties.HasZ() || properties.HasM()) {
+			throw InvalidInputException("GEOMETRY_Q: only geometries with X and Y coordinates can be quantized");
+		}
+
+		measuring = true;
+		has_vertices = false;
+		Process(geometry, buffer);
+		ChooseGrid(requested_grid_size);
+
+		measuring = false;
+		bounds[0] = bounds[1] = std::numeric_limits<int32_t>::max();
+		bounds[2] = bounds[3] = 0;
+
+		// Points are their own bounding box
+		auto type = geometry.GetType();
+		auto has_bbox = has_vertices && type != GeometryType::POINT;
+
+		buffer.clear();
+		Append<uint8_t>(buffer, static_cast<uint8_t>(type));
+		Append<uint8_t>(buffer, has_bbox ? QuantizedGeometry::BOUNDING_BOX_FLAG : 0);
+		Append<uint16_t>(buffer, 0);
+		Append<uint32_t>(buffer, 0);
+		Append<double>(buffer, origin_index_x);
+		Append<double>(buffer, origin_index_y);
+		Append<double>(buffer, grid.size);
+		auto bbox_offset = buffer.size();
+		if (has_bbox) {
+			buffer.resize(bbox_offset + 4 * sizeof(int32_t));
+		}
+		Process(geometry, buffer);
+		if (has_bbox) {
+			for (idx_t i = 0; i < 4; i++) {
+				Store<int32_t>(bounds[i], buffer.data() + bbox_offset + i * sizeof(int32_t));
+			}
+		}
+	}
+};
+
+void QuantizedGeometry::Quantize(const geometry_t &geometry, double grid_size, vector<data_t> &buffer) {
+	if (grid_size < 0 || !std::isfinite(grid_size)) {
+		throw InvalidInputException("GEOMETRY_Q: the grid size must be a positive number");
+	}
+	Quantizer quantizer;
+	quantizer.Execute(geometry, grid_size, buffer);
+}
+
+string_t QuantizedGeometry::Quantize(const geometry_t &geometry, double grid_size, Vector &result) {
+	vector<data_t> buffer;
+	Quantize(geometry, grid_size, buffer);
+	return StringVector::AddStringOrBlob(result, const_char_ptr_cast(buffer.data()), buffer.size());
+}
+
+//------------------------------------------------------------------------------
+// Reading
+//------------------------------------------------------------------------------
+struct QuantizedHeader {
+	GeometryType type;
+	bool has_bbox;
+	double origin_x;
+	double origin_y;
+	double grid_size;
+	int32_t bbox[4];
+
+	double ToWorldX(double position) const {
+		return QuantizedGrid(grid_size).ToWorld(origin_x + position);
+	}
+	double ToWorldY(double position) const {
+		return QuantizedGrid(grid_size).ToWorld(origin_y + position);
+	}
+};
+
+static QuantizedHeader ReadHeader(Cursor &cursor) {
+	QuantizedHeader header = {};
+	auto type = cursor.Read<uint8_t>();
+	if (type > static_cast<uint8_t>(GeometryType::GEOMETRYCOLLECTION)) {
+		throw SerializationException("GEOMETRY_Q: unknown geometry type %d", static_cast<int>(type));
+	}
+	header.type = static_cast<GeometryType>(type);
+	header.has_bbox = (cursor.Read<uint8_t>() & QuantizedGeometry::BOUNDING_BOX_FLAG) != 0;
+	cursor.Skip<uint16_t>();
+	cursor.Skip<uint32_t>();
+	header.origin_x = cursor.Read<double>();
+	header.origin_y = cursor.Read<double>();
+	header.grid_size = cursor.Read<double>();
+	if (header.has_bbox) {
+		for (idx_t i = 0; i < 4; i++) {
+			header.bbox[i] = cursor.Read<int32_t>();
+		}
+	}
+	return header;
+}
+
+static uint32_t ReadVertexCount(Cursor &cursor) {
+	auto count = cursor.Read<uint32_t>();
+	if (static_cast<uint64_t>(count) * 2 * sizeof(int32_t) > cursor.Remaining()) {
+		throw SerializationException("GEOMETRY_Q: vertex count exceeds the size of the blob");
+	}
+	return count;
+}
+
+static GeometryType ReadItemType(Cursor &cursor) {
+	auto type = cursor.Read<uint32_t>();
+	if (type > static_cast<uint32_t>(GeometryType::GEOMETRYCOLLECTION)) {
+		throw SerializationException("GEOMETRY_Q: unknown geometry type %d", static_cast<int>(type));
+	}
+	return static_cast<GeometryType>(type);
+}
+
+class Dequantizer {
+	ArenaAllocator &arena;
+	Cursor &cursor;
+	const QuantizedHeader &header;
+
+	VertexArray ReadVertices(uint32_t count) {
+		auto vertices = VertexArray::Create(arena, count, false, false);
+		for (uint32_t i = 0; i < count; i++) {
+			auto x = cursor.Read<int32_t>();
+			auto y = cursor.Read<int32_t>();
+			vertices.Set(i, header.ToWorldX(x), header.ToWorldY(y));
+		}
+		return vertices;
+	}
+
+	Point ReadPoint() {
+		auto count = ReadVertexCount(cursor);
+		if (count == 0) {
+			return Point(false, false);
+		}
+		return Point(ReadVertices(count));
+	}
+
+	LineString ReadLineString() {
+		auto count = ReadVertexCount(cursor);
+		if (count == 0) {
+			return LineString(false, false);
+		}
+		return LineString(ReadVertices(count));
+	}
+
+	Polygon ReadPolygon() {
+		auto ring_count = cursor.Read<uint32_t>();
+		if (ring_count == 0) {
+			return Polygon(false, false);
+		}
+		if (static_cast<uint64_t>(ring_count) * sizeof(uint32_t) > cursor.Remaining()) {
+			throw SerializationException("GEOMETRY_Q: ring count exceeds the size of the blob");
+		}
+		Polygon polygon(arena, ring_count, false, false);
+		for (uint32_t i = 0; i < ring_count; i++) {
+			polygon[i] = ReadVertices(ReadVertexCount(cursor));
+		}
+		return polygon;
+	}
+
+	template <class T, class F>
+	T ReadCollection(F &&read_item) {
+		auto count = cursor.Read<uint32_t>();
+		if (count == 0) {
+			return T(false, false);
+		}
+		if (static_cast<uint64_t>(count) * sizeof(uint32_t) > cursor.Remaining()) {
+			throw SerializationException("GEOMETRY_Q: item count exceeds the size of the blob");
+		}
+		T collection(arena, count, false, false);
+		for (uint32_t i = 0; i < count; i++) {
+			collection[i] = read_item(ReadItemType(cursor));
+		}
+		return collection;
+	}
+
+	static void CheckItemType(GeometryType expected, GeometryType actual) {
+		if (expected != actual) {
+			throw SerializationException("GEOMETRY_Q: unexpected item type in a MULTI geometry");
+		}
+	}
+
+public:
+	Dequantizer(ArenaAllocator &arena, Cursor &cursor, const QuantizedHeader &header)
+	    : arena(arena), cursor(cursor), header(header) {
+	}
+
+	Geometry ReadGeometry(GeometryType type) {
+		switch (type) {
+		case GeometryType::POINT:
+			return ReadPoint();
+		case GeometryType::LINESTRING:
+			return ReadLineString();
+		case GeometryType::POLYGON:
+			return ReadPolygon();
+		case GeometryType::MULTIPOINT:
+			return ReadCollection<MultiPoint>([&](GeometryType item_type) {
+				CheckItemType(GeometryType::POINT, item_type);
+				return ReadPoint();
+			});
+		case GeometryType::MULTILINESTRING:
+			return ReadCollection<MultiLineString>([&](GeometryType item_type) {
+				CheckItemType(GeometryType::LINESTRING, item_type);
+				return ReadLineString();
+			});
+		case GeometryType::MULTIPOLYGON:
+			return ReadCollection<MultiPolygon>([&](GeometryType item_type) {
+				CheckItemType(GeometryType::POLYGON, item_type);
+				return ReadPolygon();
+			});
+		case GeometryType::GEOMETRYCOLLECTION:
+			return ReadCollection<GeometryCollection>([&](GeometryType item_type) { return ReadGeometry(item_type); });
+		default:
+			throw SerializationException("GEOMETRY_Q: unknown geometry type %d", static_cast<int>(type));
+		}
+	}
+};
+
+Geometry QuantizedGeometry::Dequantize(ArenaAllocator &arena, const string_t &blob) {
+	Cursor cursor(blob);
+	auto header = ReadHeader(cursor);
+	Dequantizer dequantizer(arena, cursor, header);
+	return dequantizer.ReadGeometry(header.type);
+}
+
+bool QuantizedGeometry::TryGetBoundingBox(const string_t &blob, BoundingBox &bbox) {
+	Cursor cursor(blob);
+	auto header = ReadHeader(cursor);
+	int32_t bounds[4];
+	if (header.has_bbox) {
+		memcpy(bounds, header.bbox, sizeof(bounds));
+	} else if (header.type == GeometryType::POINT && cursor.Read<uint32_t>() != 0) {
+		bounds[0] = bounds[2] = cursor.Read<int32_t>();
+		bounds[1] = bounds[3] = cursor.Read<int32_t>();
+	} else {
+		return false;
+	}
+	bbox.minx = header.ToWorldX(bounds[0]);
+	bbox.miny = header.ToWorldY(bounds[1]);
+	bbox.maxx = header.ToWorldX(bounds[2]);
+	bbox.maxy = header.ToWorldY(bounds[3]);
+	return true;
+}
+
+//------------------------------------------------------------------------------
+// Kernels
+//------------------------------------------------------------------------------
+// The kernels move the point onto the grid of the geometry instead of moving the geometry off it, so the vertices are
+// read as integers and only the point is scaled. Differences of grid positions are exact in doubles.
+
+struct GridPoint {
+	double x;
+	double y;
+};
+
+// Walks the rings of a polygon, updating the squared distance to the closest edge and the parity of the edges that a
+// ray from the point towards positive X crosses. Sets on_boundary if the point is on an edge, returns whether the ring
+// has any vertices.
+static bool ScanRing(Cursor &cursor, const GridPoint &p, double &min_distance_sq, bool &inside, bool &on_boundary) {
+	auto count = ReadVertexCount(cursor);
+	if (count == 0) {
+		return false;
+	}
+	double x1 = cursor.Read<int32_t>();
+	double y1 = cursor.Read<int32_t>();
+	for (uint32_t i = 1; i < count; i++) {
+		double x2 = cursor.Read<int32_t>();
+		double y2 = cursor.Read<int32_t>();
+
+		auto distance_sq = PointDistance::ToSegmentSquared(p.x, p.y, x1, y1, x2, y2);
+		min_distance_sq = MinValue(min_distance_sq, distance_sq);
+		if (distance_sq == 0) {
+			on_boundary = true;
+		}
+
+		// The side of the edge the point is on, positive if it is to the left
+		auto side = (x2 - x1) * (p.y - y1) - (p.x - x1) * (y2 - y1);
+		if ((y1 <= p.y && y2 > p.y && side > 0) || (y2 <= p.y && y1 > p.y && side < 0)) {
+			inside = !inside;
+		}
+		x1 = x2;
+		y1 = y2;
+	}
+	return true;
+}
+
+static bool ScanPolygon(Cursor &cursor, const GridPoint &p, double &min_distance_sq, bool &inside,
+                        bool &on_boundary) {
+	auto ring_count = cursor.Read<uint32_t>();
+	auto any = false;
+	for (uint32_t i = 0; i < ring_count; i++) {
+		any |= ScanRing(cursor, p, min_distance_sq, inside, on_boundary);
+	}
+	return any;
+}
+
+// Returns whether the geometry has any vertices
+static bool ScanDistance(Cursor &cursor, GeometryType type, const GridPoint &p, double &min_distance_sq) {
+	switch (type) {
+	case GeometryType::POINT:
+	case GeometryType::LINESTRING: {
+		auto count = ReadVertexCount(cursor);
+		if (count == 0) {
+			return false;
+		}
+		double x1 = cursor.Read<int32_t>();
+		double y1 = cursor.Read<int32_t>();
+		min_distance_sq = MinValue(min_distance_sq, (p.x - x1) * (p.x - x1) + (p.y - y1) * (p.y - y1));
+		for (uint32_t i = 1; i < count; i++) {
+			double x2 = cursor.Read<int32_t>();
+			double y2 = cursor.Read<int32_t>();
+			min_distance_sq = MinValue(min_distance_sq, PointDistance::ToSegmentSquared(p.x, p.y, x1, y1, x2, y2));
+			x1 = x2;
+			y1 = y2;
+		}
+		return true;
+	}
+	case GeometryType::POLYGON: {
+		auto inside = false;
+		auto on_boundary = false;
+		auto any = ScanPolygon(cursor, p, min_distance_sq, inside, on_boundary);
+		if (inside) {
+			min_distance_sq = 0;
+		}
+		return any;
+	}
+	default: {
+		auto count = cursor.Read<uint32_t>();
+		auto any = false;
+		for (uint32_t i = 0; i < count; i++) {
+			any |= ScanDistance(cursor, ReadItemType(cursor), p, min_distance_sq);
+		}
+		return any;
+	}
+	}
+}
+
+bool QuantizedGeometry::TryGetDistanceToPoint(const string_t &blob, double x, double y, double &distance) {
+	Cursor cursor(blob);
+	auto header = ReadHeader(cursor);
+	QuantizedGrid grid(header.grid_size);
+	GridPoint p = {grid.ToGrid(x) - header.origin_x, grid.ToGrid(y) - header.origin_y};
+	auto min_distance_sq = std::numeric_limits<double>::max();
+	if (!ScanDistance(cursor, header.type, p, min_distance_sq) ||
+	    min_distance_sq == std::numeric_limits<double>::max()) {
+		return false;
+	}
+	distance = std::sqrt(min_distance_sq) * header.grid_size;
+	return true;
+}
+
+bool QuantizedGeometry::TryLocatePoint(const string_t &blob, double x, double y, PointLocation &location) {
+	Cursor cursor(blob);
+	auto header = ReadHeader(cursor);
+	if (header.type != GeometryType::POLYGON && header.type != GeometryType::MULTIPOLYGON) {
+		return false;
+	}
+	QuantizedGrid grid(header.grid_size);
+	GridPoint p = {grid.ToGrid(x) - header.origin_x, grid.ToGrid(y) - header.origin_y};
+
+	// Empty polygons have no bounding box
+	if (!header.has_bbox || p.x < header.bbox[0] || p.y < header.bbox[1] || p.x > header.bbox[2] ||
+	    p.y > header.bbox[3]) {
+		location = PointLocation::EXTERIOR;
+		return true;
+	}
+
+	// The polygons of a multipolygon do not overlap, so the parity can be counted over all of their rings
+	auto inside = false;
+	auto on_boundary = false;
+	auto min_distance_sq = std::numeric_limits<double>::max();
+	if (header.type == GeometryType::POLYGON) {
+		ScanPolygon(cursor, p, min_distance_sq, inside, on_boundary);
+	} else {
+		auto count = cursor.Read<uint32_t>();
+		for (uint32_t i = 0; i < count; i++) {
+			ReadItemType(cursor);
+			ScanPolygon(cursor, p, min_distance_sq, inside, on_boundary);
+		}
+	}
+	location = on_boundary ? PointLocation::BOUNDARY : (inside ? PointLocation::INTERIOR : PointLocation::EXTERIOR);
+	return true;
+}
+
+} // namespace core
+
+} // namespace spatial
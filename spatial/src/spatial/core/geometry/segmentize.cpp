@@ -0,0 +1,117 @@
+#include "spatial/core/geometry/segmentize.hpp"
+
+namespace spatial {
+
+namespace core {
+
+geometry_t Segmentizer::Execute(const geometry_t &geom, GeometryWriter &writer_p, Vector &result) {
+	auto props = geom.GetProperties();
+	writer = &writer_p;
+	writer->Begin(geom.GetType(), props.HasZ(), props.HasM());
+	Process(geom);
+	return writer->End(result);
+}
+
+VertexXYZM Segmentizer::GetVertex(const VertexData &vertices, uint32_t i) const {
+	VertexXYZM vertex;
+	vertex.x = Load<double>(vertices.data[0] + i * vertices.stride[0]);
+	vertex.y = Load<double>(vertices.data[1] + i * vertices.stride[1]);
+	vertex.z = Load<double>(vertices.data[2] + i * vertices.stride[2]);
+	vertex.m = Load<double>(vertices.data[3] + i * vertices.stride[3]);
+	return vertex;
+}
+
+uint32_t Segmentizer::CountVertices(const VertexData &vertices) {
+	if (vertices.count == 0) {
+		return 0;
+	}
+	double count = 1;
+	auto a = GetVertex(vertices, 0);
+	for (uint32_t i = 1; i < vertices.count; i++) {
+		auto b = GetVertex(vertices, i);
+		auto segment_pieces = CountPieces(a, b);
+		count += segment_pieces;
+		if (!(count <= NumericLimits<uint32_t>::Maximum())) {
+			throw InvalidInputException("%s: the result would have too many vertices, use a larger maximum length",
+			                            function_name);
+		}
+		pieces.push_back(static_cast<uint32_t>(segment_pieces));
+		a = b;
+	}
+	return static_cast<uint32_t>(count);
+}
+
+void Segmentizer::WriteVertices(const VertexData &vertices, const uint32_t *segment_pieces) {
+	if (vertices.count == 0) {
+		return;
+	}
+	auto a = GetVertex(vertices, 0);
+	writer->AddVertex(a.x, a.y, a.z, a.m);
+	for (uint32_t i = 1; i < vertices.count; i++) {
+		auto b = GetVertex(vertices, i);
+		if (segment_pieces[i - 1] > 1) {
+			WritePieces(a, b, segment_pieces[i - 1], *writer);
+		}
+		writer->AddVertex(b.x, b.y, b.z, b.m);
+		a = b;
+	}
+}
+
+void Segmentizer::ProcessPoint(const VertexData &vertices) {
+	writer->AddPoint(vertices.IsEmpty());
+	WriteVertices(vertices, nullptr);
+}
+
+void Segmentizer::ProcessLineString(const VertexData &vertices) {
+	pieces.clear();
+	writer->AddLineString(CountVertices(vertices));
+	WriteVertices(vertices, pieces.data());
+}
+
+void Segmentizer::ProcessPolygon(PolygonState &state) {
+	// The vertex counts of all the rings come before the vertices of the first ring
+	rings.clear();
+	while (!state.IsDone()) {
+		rings.push_back(state.Next());
+	}
+	pieces.clear();
+	writer->AddPolygon(static_cast<uint32_t>(rings.size()));
+	for (auto &ring : rings) {
+		writer->AddRing(CountVertices(ring));
+	}
+	idx_t offset = 0;
+	for (auto &ring : rings) {
+		WriteVertices(ring, pieces.data() + offset);
+		offset += ring.count == 0 ? 0 : ring.count - 1;
+	}
+}
+
+void Segmentizer::ProcessCollection(CollectionState &state) {
+	writer->AddCollection(CurrentType(), state.ItemCount());
+	while (!state.IsDone()) {
+		state.Next();
+	}
+}
+
+//------------------------------------------------------------------------------
+// PlanarSegmentizer
+//------------------------------------------------------------------------------
+double PlanarSegmentizer::CountPieces(const VertexXYZM &a, const VertexXYZM &b) {
+	auto length = std::sqrt((b.x - a.x) * (b.x - a.x) + (b.y - a.y) * (b.y - a.y));
+	if (!(length > max_length)) {
+		return 1;
+	}
+	return std::ceil(length / max_length);
+}
+
+void PlanarSegmentizer::WritePieces(const VertexXYZM &a, const VertexXYZM &b, uint32_t pieces,
+                                    GeometryWriter &writer) {
+	for (uint32_t k = 1; k < pieces; k++) {
+		auto t = static_cast<double>(k) / pieces;
+		writer.AddVertex(a.x + t * (b.x - a.x), a.y + t * (b.y - a.y), a.z + t * (b.z - a.z), a.m + t * (b.m - a.m));
+	}
+}
+
+} // namespace core
+
+} // namespace spatial
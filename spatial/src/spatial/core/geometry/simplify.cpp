@@ -0,0 +1,401 @@
+#include "spatial/core/geometry/simplify.hpp"
+#include "spatial/core/geometry/point_distance.hpp"
+
+#include <queue>
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Vertex selection
+//------------------------------------------------------------------------------
+// Iterative Douglas-Peucker: keep the vertex furthest from the segment between the ends of a range if it is further
+// than the tolerance, and continue with the two halves. The ranges to visit are kept on an explicit stack.
+uint32_t GeometrySimplifier::MarkDouglasPeucker(uint32_t count) {
+	auto tolerance_sq = tolerance * tolerance;
+	keep[0] = true;
+	keep[count - 1] = true;
+	uint32_t kept = 2;
+
+	ranges.clear();
+	ranges.emplace_back(0, count - 1);
+	while (!ranges.empty()) {
+		auto range = ranges.back();
+		ranges.pop_back();
+		auto start = range.first;
+		auto end = range.second;
+		if (end - start < 2) {
+			continue;
+		}
+
+		auto ax = x_data[start];
+		auto ay = y_data[start];
+		auto bx = x_data[end];
+		auto by = y_data[end];
+		auto max_dist = -1.0;
+		auto max_idx = start;
+		for (auto i = start + 1; i < end; i++) {
+			auto dist = PointDistance::ToSegmentSquared(x_data[i], y_data[i], ax, ay, bx, by);
+			if (dist > max_dist) {
+				max_dist = dist;
+				max_idx = i;
+			}
+		}
+		if (max_dist > tolerance_sq) {
+			keep[max_idx] = true;
+			kept++;
+			ranges.emplace_back(start, max_idx);
+			ranges.emplace_back(max_idx, end);
+		}
+	}
+	return kept;
+}
+
+// Visvalingam-Whyatt: repeatedly remove the vertex with the smallest triangle with its neighbours, as long as that
+// area is below the tolerance. The vertices are a linked list and the heap holds stale entries, which are skipped
+// when their area no longer matches. An area never drops below the one of a vertex removed before it, so that the
+// removal order does not depend on how the tolerance is approached.
+uint32_t GeometrySimplifier::MarkVisvalingamWhyatt(uint32_t count, uint32_t min_count) {
+	prev.resize(count);
+	next.resize(count);
+	areas.resize(count);
+
+	auto triangle_area = [&](uint32_t i) {
+		auto p = prev[i];
+		auto n = next[i];
+		return std::abs((x_data[p] - x_data[i]) * (y_data[n] - y_data[i]) -
+		                (x_data[n] - x_data[i]) * (y_data[p] - y_data[i])) /
+		       2;
+	};
+
+	using entry_t = std::pair<double, uint32_t>;
+	std::priority_queue<entry_t, vector<entry_t>, std::greater<entry_t>> heap;
+	for (uint32_t i = 0; i < count; i++) {
+		keep[i] = true;
+		prev[i] = i - 1;
+		next[i] = i + 1;
+	}
+	for (uint32_t i = 1; i + 1 < count; i++) {
+		areas[i] = triangle_area(i);
+		heap.emplace(areas[i], i);
+	}
+
+	auto kept = count;
+	while (!heap.empty() && kept > min_count) {
+		auto top = heap.top();
+		heap.pop();
+		auto area = top.first;
+		auto i = top.second;
+		if (!keep[i] || area != areas[i]) {
+			continue;
+		}
+		if (area >= tolerance) {
+			break;
+		}
+		keep[i] = false;
+		kept--;
+
+		auto p = prev[i];
+		auto n = next[i];
+		next[p] = n;
+		prev[n] = p;
+		if (p != 0) {
+			areas[p] = std::max(triangle_area(p), area);
+			heap.emplace(areas[p], p);
+		}
+		if (n != count - 1) {
+			areas[n] = std::max(triangle_area(n), area);
+			heap.emplace(areas[n], n);
+		}
+	}
+	return kept;
+}
+
+// Douglas-Peucker down to the smallest tolerance, with the distance a vertex is kept up to: the distance of a vertex
+// to the segment of its range, but no more than that of the vertex that split off the range, as the range is only
+// visited at tolerances where that vertex is kept. The splits do not depend on the tolerance, so a vertex is kept at
+// exactly the tolerances below this distance.
+void GeometrySimplifier::RankVertices(const VertexArray &vertices) {
+	auto count = vertices.Count();
+	auto level_count = static_cast<uint8_t>(rank_tolerances_sq.size());
+	if (count < 3) {
+		rank_output->insert(rank_output->end(), count, level_count);
+		return;
+	}
+	GatherCoordinates(vertices);
+
+	auto infinity = std::numeric_limits<double>::infinity();
+	effective.assign(count, 0);
+	effective[0] = infinity;
+	effective[count - 1] = infinity;
+	ranges.clear();
+	limits.clear();
+	ranges.emplace_back(0, count - 1);
+	limits.push_back(infinity);
+	while (!ranges.empty()) {
+		auto range = ranges.back();
+		auto limit = limits.back();
+		ranges.pop_back();
+		limits.pop_back();
+		auto start = range.first;
+		auto end = range.second;
+		if (end - start < 2) {
+			continue;
+		}
+
+		auto ax = x_data[start];
+		auto ay = y_data[start];
+		auto bx = x_data[end];
+		auto by = y_data[end];
+		auto max_dist = -1.0;
+		auto max_idx = start;
+		for (auto i = start + 1; i < end; i++) {
+			auto dist = PointDistance::ToSegmentSquared(x_data[i], y_data[i], ax, ay, bx, by);
+			if (dist > max_dist) {
+				max_dist = dist;
+				max_idx = i;
+			}
+		}
+		// Ranges split off below the smallest tolerance are not kept at any of them
+		if (max_dist > rank_tolerances_sq[0]) {
+			effective[max_idx] = MinValue(max_dist, limit);
+			ranges.emplace_back(start, max_idx);
+			limits.push_back(effective[max_idx]);
+			ranges.emplace_back(max_idx, end);
+			limits.push_back(effective[max_idx]);
+		}
+	}
+
+	for (uint32_t i = 0; i < count; i++) {
+		auto kept_at = std::lower_bound(rank_tolerances_sq.begin(), rank_tolerances_sq.end(), effective[i]);
+		rank_output->push_back(static_cast<uint8_t>(kept_at - rank_tolerances_sq.begin()));
+	}
+}
+
+void GeometrySimplifier::GatherCoordinates(const VertexArray &vertices) {
+	// Gather the coordinates once, the vertices of a deserialized geometry are not necessarily aligned
+	auto count = vertices.Count();
+	auto data = vertices.GetData();
+	auto vertex_size = vertices.GetProperties().VertexSize();
+	x_data.resize(count);
+	y_data.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		x_data[i] = Load<double>(data + i * vertex_size);
+		y_data[i] = Load<double>(data + i * vertex_size + sizeof(double));
+	}
+}
+
+VertexArray GeometrySimplifier::SimplifyVertices(const VertexArray &vertices, uint32_t min_count) {
+	auto count = vertices.Count();
+	auto props = vertices.GetProperties();
+	if (pass == Pass::RANK) {
+		RankVertices(vertices);
+		return vertices;
+	}
+	auto vertex_ranks = rank_input;
+	if (pass == Pass::SELECT) {
+		rank_input += count;
+	}
+	if (count < 3) {
+		return vertices;
+	}
+
+	keep.assign(count, false);
+	uint32_t kept = 0;
+	if (pass == Pass::SELECT) {
+		for (uint32_t i = 0; i < count; i++) {
+			keep[i] = vertex_ranks[i] >= min_rank;
+			kept += keep[i];
+		}
+	} else {
+		GatherCoordinates(vertices);
+		kept = method == Method::DOUGLAS_PEUCKER ? MarkDouglasPeucker(count) : MarkVisvalingamWhyatt(count, min_count);
+	}
+	if (kept < min_count) {
+		return VertexArray::Empty(props.HasZ(), props.HasM());
+	}
+	if (kept == count) {
+		return vertices;
+	}
+
+	auto data = vertices.GetData();
+	auto vertex_size = props.VertexSize();
+	auto simplified = VertexArray::Create(arena, kept, props.HasZ(), props.HasM());
+	auto out = simplified.GetData();
+	for (uint32_t i = 0; i < count; i++) {
+		if (keep[i]) {
+			memcpy(out, data + i * vertex_size, vertex_size);
+			out += vertex_size;
+		}
+	}
+	return simplified;
+}
+
+//------------------------------------------------------------------------------
+// Geometries
+//------------------------------------------------------------------------------
+Polygon GeometrySimplifier::SimplifyPolygon(const Polygon &polygon) {
+	auto ring_count = polygon.RingCount();
+	if (ring_count == 0) {
+		return polygon;
+	}
+	auto props = polygon[0].GetProperties();
+
+	// Simplify the rings in place in a copy of the ring array, then compact the ones that did not collapse. The holes
+	// of a collapsed shell are still visited, to keep the ranks in step with the vertices.
+	Polygon simplified(arena, ring_count, props.HasZ(), props.HasM());
+	uint32_t kept = 0;
+	auto has_shell = true;
+	for (uint32_t i = 0; i < ring_count; i++) {
+		auto ring = SimplifyVertices(polygon[i], 4);
+		if (ring.IsEmpty()) {
+			has_shell = has_shell && i > 0;
+			continue;
+		}
+		simplified[kept++] = ring;
+	}
+	if (!has_shell) {
+		// Without a shell there is no polygon
+		return Polygon(props.HasZ(), props.HasM());
+	}
+	if (kept == ring_count) {
+		return simplified;
+	}
+	Polygon result(arena, kept, props.HasZ(), props.HasM());
+	for (uint32_t i = 0; i < kept; i++) {
+		result[i] = simplified[i];
+	}
+	return result;
+}
+
+template <class T, class F>
+static T SimplifyParts(ArenaAllocator &arena, const T &multi, bool has_z, bool has_m, F simplify_part) {
+	vector<typename std::decay<decltype(multi[0])>::type> parts;
+	for (auto &part : multi) {
+		auto simplified = simplify_part(part);
+		if (!simplified.IsEmpty()) {
+			parts.push_back(std::move(simplified));
+		}
+	}
+	T result(arena, static_cast<uint32_t>(parts.size()), has_z, has_m);
+	for (uint32_t i = 0; i < parts.size(); i++) {
+		result[i] = std::move(parts[i]);
+	}
+	return result;
+}
+
+Geometry GeometrySimplifier::Simplify(const Geometry &geom, double tolerance_p) {
+	pass = Pass::SIMPLIFY;
+	tolerance = tolerance_p;
+	return SimplifyGeometry(geom);
+}
+
+void GeometrySimplifier::Rank(const Geometry &geom, const vector<double> &tolerances, vector<uint8_t> &ranks) {
+	D_ASSERT(!tolerances.empty() && tolerances.size() <= NumericLimits<uint8_t>::Maximum());
+	pass = Pass::RANK;
+	rank_tolerances_sq.clear();
+	for (auto &rank_tolerance : tolerances) {
+		rank_tolerances_sq.push_back(rank_tolerance * rank_tolerance);
+	}
+	rank_output = &ranks;
+	SimplifyGeometry(geom);
+	rank_output = nullptr;
+}
+
+idx_t GeometrySimplifier::RankCount(const Geometry &geom) {
+	idx_t count = 0;
+	switch (geom.Type()) {
+	case GeometryType::POINT:
+	case GeometryType::MULTIPOINT:
+		break;
+	case GeometryType::LINESTRING:
+		count += geom.As<LineString>().Vertices().Count();
+		break;
+	case GeometryType::POLYGON:
+		for (auto &ring : geom.As<Polygon>()) {
+			count += ring.Count();
+		}
+		break;
+	case GeometryType::MULTILINESTRING:
+		for (auto &line : geom.As<MultiLineString>()) {
+			count += line.Vertices().Count();
+		}
+		break;
+	case GeometryType::MULTIPOLYGON:
+		for (auto &polygon : geom.As<MultiPolygon>()) {
+			for (auto &ring : polygon) {
+				count += ring.Count();
+			}
+		}
+		break;
+	case GeometryType::GEOMETRYCOLLECTION:
+		for (auto &child : geom.As<GeometryCollection>()) {
+			count += RankCount(child);
+		}
+		break;
+	default:
+		throw NotImplementedException("GeometrySimplifier::RankCount()");
+	}
+	return count;
+}
+
+Geometry GeometrySimplifier::SimplifyRanked(const Geometry &geom, const uint8_t *ranks, uint8_t min_rank_p) {
+	pass = Pass::SELECT;
+	rank_input = ranks;
+	min_rank = min_rank_p;
+	auto result = SimplifyGeometry(geom);
+	rank_input = nullptr;
+	return result;
+}
+
+Geometry GeometrySimplifier::SimplifyGeometry(const Geometry &geom) {
+	auto has_z = false;
+	auto has_m = false;
+	switch (geom.Type()) {
+	case GeometryType::POINT:
+	case GeometryType::MULTIPOINT:
+		return geom;
+	case GeometryType::LINESTRING: {
+		auto &vertices = geom.As<LineString>().Vertices();
+		return Geometry(LineString(SimplifyVertices(vertices, 2)));
+	}
+	case GeometryType::POLYGON:
+		return Geometry(SimplifyPolygon(geom.As<Polygon>()));
+	case GeometryType::MULTILINESTRING: {
+		auto &lines = geom.As<MultiLineString>();
+		if (lines.ItemCount() > 0) {
+			auto props = lines[0].Vertices().GetProperties();
+			has_z = props.HasZ();
+			has_m = props.HasM();
+		}
+		return Geometry(SimplifyParts(arena, lines, has_z, has_m, [&](const LineString &line) {
+			return LineString(SimplifyVertices(line.Vertices(), 2));
+		}));
+	}
+	case GeometryType::MULTIPOLYGON: {
+		auto &polygons = geom.As<MultiPolygon>();
+		for (auto &polygon : polygons) {
+			if (polygon.RingCount() > 0) {
+				auto props = polygon[0].GetProperties();
+				has_z = props.HasZ();
+				has_m = props.HasM();
+				break;
+			}
+		}
+		return Geometry(SimplifyParts(arena, polygons, has_z, has_m,
+		                              [&](const Polygon &polygon) { return SimplifyPolygon(polygon); }));
+	}
+	case GeometryType::GEOMETRYCOLLECTION: {
+		// The vertex type of a collection is only used for its empty children, the serializer takes it as an argument
+		return Geometry(SimplifyParts(arena, geom.As<GeometryCollection>(), has_z, has_m,
+		                              [&](const Geometry &child) { return SimplifyGeometry(child); }));
+	}
+	default:
+		throw NotImplementedException("GeometrySimplifier::SimplifyGeometry()");
+	}
+}
+
+} // namespace core
+
+} // namespace spatial
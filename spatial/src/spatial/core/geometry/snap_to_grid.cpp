@@ -0,0 +1,144 @@
+#include "spatial/core/geometry/snap_to_grid.hpp"
+
+namespace spatial {
+
+namespace core {
+
+geometry_t GridSnapper::Execute(const geometry_t &geom, GeometryWriter &writer_p, Vector &result) {
+	auto props = geom.GetProperties();
+	writer = &writer_p;
+	writer->Begin(geom.GetType(), props.HasZ(), props.HasM());
+	Process(geom);
+	return writer->End(result);
+}
+
+uint32_t GridSnapper::SnapVertices(const VertexData &vertices) {
+	if (vertices.count == 0) {
+		return 0;
+	}
+	auto offset = x_data.size();
+	x_data.resize(offset + vertices.count);
+	y_data.resize(offset + vertices.count);
+	source_index.resize(offset + vertices.count);
+	auto x_out = x_data.data() + offset;
+	auto y_out = y_data.data() + offset;
+	auto index_out = source_index.data() + offset;
+
+	// Adding 0 turns the -0 of coordinates that round to 0 from below into 0, so that they compare and print the same
+	auto x_in = vertices.data[0];
+	auto y_in = vertices.data[1];
+	x_out[0] = std::rint(Load<double>(x_in) / grid_size) * grid_size + 0.0;
+	y_out[0] = std::rint(Load<double>(y_in) / grid_size) * grid_size + 0.0;
+	index_out[0] = 0;
+	uint32_t kept = 1;
+	for (uint32_t i = 1; i < vertices.count; i++) {
+		auto x = std::rint(Load<double>(x_in + i * vertices.stride[0]) / grid_size) * grid_size + 0.0;
+		auto y = std::rint(Load<double>(y_in + i * vertices.stride[1]) / grid_size) * grid_size + 0.0;
+		// Every vertex is written, but only kept if it differs from the previous one, so that the loop has no branches
+		x_out[kept] = x;
+		y_out[kept] = y;
+		index_out[kept] = i;
+		kept += (x != x_out[kept - 1]) | (y != y_out[kept - 1]);
+	}
+	x_data.resize(offset + kept);
+	y_data.resize(offset + kept);
+	source_index.resize(offset + kept);
+	return kept;
+}
+
+void GridSnapper::WriteVertices(const VertexData &vertices, idx_t offset, uint32_t count) {
+	for (uint32_t i = 0; i < count; i++) {
+		auto source = source_index[offset + i];
+		auto z = Load<double>(vertices.data[2] + source * vertices.stride[2]);
+		auto m = Load<double>(vertices.data[3] + source * vertices.stride[3]);
+		writer->AddVertex(x_data[offset + i], y_data[offset + i], z, m);
+	}
+}
+
+bool GridSnapper::ProcessPoint(const VertexData &vertices) {
+	x_data.clear();
+	y_data.clear();
+	source_index.clear();
+	auto count = SnapVertices(vertices);
+	writer->AddPoint(count == 0);
+	WriteVertices(vertices, 0, count);
+	return true;
+}
+
+bool GridSnapper::ProcessLineString(const VertexData &vertices) {
+	x_data.clear();
+	y_data.clear();
+	source_index.clear();
+	auto count = SnapVertices(vertices);
+	if (count < 2) {
+		if (IsNested()) {
+			return false;
+		}
+		writer->AddLineString(0);
+		return true;
+	}
+	writer->AddLineString(count);
+	WriteVertices(vertices, 0, count);
+	return true;
+}
+
+bool GridSnapper::ProcessPolygon(PolygonState &state) {
+	x_data.clear();
+	y_data.clear();
+	source_index.clear();
+	rings.clear();
+	ring_counts.clear();
+	while (!state.IsDone()) {
+		auto ring = state.Next();
+		auto offset = x_data.size();
+		auto count = SnapVertices(ring);
+		if (count >= 4) {
+			rings.push_back(ring);
+			ring_counts.push_back(count);
+			continue;
+		}
+		// A collapsed shell takes the holes with it
+		if (rings.empty()) {
+			break;
+		}
+		x_data.resize(offset);
+		y_data.resize(offset);
+		source_index.resize(offset);
+	}
+	if (rings.empty()) {
+		if (IsNested()) {
+			return false;
+		}
+		writer->AddPolygon(0);
+		return true;
+	}
+
+	// The vertex counts of all the rings come before the vertices of the first ring
+	writer->AddPolygon(static_cast<uint32_t>(rings.size()));
+	for (auto &count : ring_counts) {
+		writer->AddRing(count);
+	}
+	idx_t offset = 0;
+	for (idx_t i = 0; i < rings.size(); i++) {
+		WriteVertices(rings[i], offset, ring_counts[i]);
+		offset += ring_counts[i];
+	}
+	return true;
+}
+
+bool GridSnapper::ProcessCollection(CollectionState &state) {
+	// The item count is only known once the collapsed items are dropped
+	auto offset = writer->AddCollection(CurrentType(), 0);
+	uint32_t item_count = 0;
+	while (!state.IsDone()) {
+		if (state.Next()) {
+			item_count++;
+		}
+	}
+	writer->SetCount(offset, item_count);
+	return true;
+}
+
+} // namespace core
+
+} // namespace spatial
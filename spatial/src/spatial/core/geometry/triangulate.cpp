@@ -0,0 +1,574 @@
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/triangulate.hpp"
+#include "spatial/core/geometry/predicates.hpp"
+
+#include <limits>
+
+namespace spatial {
+
+namespace core {
+
+using Node = Triangulator::Node;
+
+//------------------------------------------------------------------------------
+// Geometric helpers
+//------------------------------------------------------------------------------
+// The sign of earcut's area(p, q, r), which is positive if p -> q -> r turns clockwise
+static inline int Area(const Node *p, const Node *q, const Node *r) {
+	return -Predicates::Orient2D(p->x, p->y, q->x, q->y, r->x, r->y);
+}
+
+static inline bool Equals(const Node *a, const Node *b) {
+	return a->x == b->x && a->y == b->y;
+}
+
+// Whether p is inside the counter-clockwise triangle a, b, c or on its boundary
+static inline bool PointInTriangle(double ax, double ay, double bx, double by, double cx, double cy, double px,
+                                   double py) {
+	return Predicates::Orient2D(px, py, cx, cy, ax, ay) >= 0 && Predicates::Orient2D(px, py, ax, ay, bx, by) >= 0 &&
+	       Predicates::Orient2D(px, py, bx, by, cx, cy) >= 0;
+}
+
+// Whether q is within the bounding box of p and r
+static inline bool OnSegment(const Node *p, const Node *q, const Node *r) {
+	return q->x <= MaxValue(p->x, r->x) && q->x >= MinValue(p->x, r->x) && q->y <= MaxValue(p->y, r->y) &&
+	       q->y >= MinValue(p->y, r->y);
+}
+
+// Whether the segments p1 - q1 and p2 - q2 intersect
+static bool Intersects(const Node *p1, const Node *q1, const Node *p2, const Node *q2) {
+	auto o1 = Area(p1, q1, p2);
+	auto o2 = Area(p1, q1, q2);
+	auto o3 = Area(p2, q2, p1);
+	auto o4 = Area(p2, q2, q1);
+	if (o1 != o2 && o3 != o4) {
+		return true;
+	}
+	return (o1 == 0 && OnSegment(p1, p2, q1)) || (o2 == 0 && OnSegment(p1, q2, q1)) ||
+	       (o3 == 0 && OnSegment(p2, p1, q2)) || (o4 == 0 && OnSegment(p2, q1, q2));
+}
+
+// Whether the diagonal a - b intersects an edge of the ring of a
+static bool IntersectsPolygon(const Node *a, const Node *b) {
+	auto p = a;
+	do {
+		if (p->i != a->i && p->next->i != a->i && p->i != b->i && p->next->i != b->i && Intersects(p, p->next, a, b)) {
+			return true;
+		}
+		p = p->next;
+	} while (p != a);
+	return false;
+}
+
+// Whether the diagonal a - b starts into the inside of the ring at a
+static bool LocallyInside(const Node *a, const Node *b) {
+	if (Area(a->prev, a, a->next) < 0) {
+		return Area(a, b, a->next) >= 0 && Area(a, a->prev, b) >= 0;
+	}
+	return Area(a, b, a->prev) < 0 || Area(a, a->next, b) < 0;
+}
+
+// Whether the middle of the diagonal a - b is inside the ring of a
+static bool MiddleInside(const Node *a, const Node *b) {
+	auto p = a;
+	auto inside = false;
+	auto px = (a->x + b->x) / 2;
+	auto py = (a->y + b->y) / 2;
+	do {
+		if (((p->y > py) != (p->next->y > py)) && p->next->y != p->y &&
+		    (px < (p->next->x - p->x) * (py - p->y) / (p->next->y - p->y) + p->x)) {
+			inside = !inside;
+		}
+		p = p->next;
+	} while (p != a);
+	return inside;
+}
+
+// Whether the diagonal a - b is inside the ring of a and does not cross any of its edges
+static bool IsValidDiagonal(const Node *a, const Node *b) {
+	if (a->next->i == b->i || a->prev->i == b->i || IntersectsPolygon(a, b)) {
+		return false;
+	}
+	// Locally visible, without creating sectors that face each other
+	if (LocallyInside(a, b) && LocallyInside(b, a) && MiddleInside(a, b) &&
+	    (Area(a->prev, a, b->prev) != 0 || Area(a, b->prev, b) != 0)) {
+		return true;
+	}
+	// A diagonal of length zero
+	return Equals(a, b) && Area(a->prev, a, a->next) > 0 && Area(b->prev, b, b->next) > 0;
+}
+
+// Whether the sector at m contains the sector at p, at the same coordinates
+static bool SectorContainsSector(const Node *m, const Node *p) {
+	return Area(m->prev, m, p->prev) < 0 && Area(p->next, m, m->next) < 0;
+}
+
+static void RemoveNode(Node *p) {
+	p->next->prev = p->prev;
+	p->prev->next = p->next;
+	if (p->prev_z) {
+		p->prev_z->next_z = p->next_z;
+	}
+	if (p->next_z) {
+		p->next_z->prev_z = p->prev_z;
+	}
+}
+
+// Remove duplicate and collinear vertices between start and end, returns a node that is still in the ring
+static Node *FilterPoints(Node *start, Node *end = nullptr) {
+	if (!start) {
+		return start;
+	}
+	if (!end) {
+		end = start;
+	}
+	auto p = start;
+	bool again;
+	do {
+		again = false;
+		if (!p->steiner && (Equals(p, p->next) || Area(p->prev, p, p->next) == 0)) {
+			RemoveNode(p);
+			p = end = p->prev;
+			if (p == p->next) {
+				break;
+			}
+			again = true;
+		} else {
+			p = p->next;
+		}
+	} while (again || p != end);
+	return end;
+}
+
+static Node *GetLeftmost(Node *start) {
+	auto p = start;
+	auto leftmost = start;
+	do {
+		if (p->x < leftmost->x || (p->x == leftmost->x && p->y < leftmost->y)) {
+			leftmost = p;
+		}
+		p = p->next;
+	} while (p != start);
+	return leftmost;
+}
+
+// David Eberly's bridge from the leftmost vertex of a hole to a vertex of the outer ring that it can see
+static Node *FindHoleBridge(const Node *hole, Node *outer) {
+	auto p = outer;
+	auto hx = hole->x;
+	auto hy = hole->y;
+	auto qx = -std::numeric_limits<double>::infinity();
+	Node *m = nullptr;
+
+	// Find the closest edge left of the hole that a ray to the left crosses, and its endpoint with the smallest x
+	do {
+		if (hy <= p->y && hy >= p->next->y && p->next->y != p->y) {
+			auto x = p->x + (hy - p->y) * (p->next->x - p->x) / (p->next->y - p->y);
+			if (x <= hx && x > qx) {
+				qx = x;
+				m = p->x < p->next->x ? p : p->next;
+				if (x == hx) {
+					// The hole touches the edge
+					return m;
+				}
+			}
+		}
+		p = p->next;
+	} while (p != outer);
+	if (!m) {
+		return nullptr;
+	}
+
+	// The endpoint can be seen from the hole unless there are vertices inside the triangle of the hole vertex, the
+	// crossing and the endpoint. If there are, take the one with the smallest angle to the ray instead.
+	auto stop = m;
+	auto mx = m->x;
+	auto my = m->y;
+	auto tan_min = std::numeric_limits<double>::infinity();
+	p = m;
+	do {
+		if (hx >= p->x && p->x >= mx && hx != p->x &&
+		    PointInTriangle(hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, p->x, p->y)) {
+			auto tan = std::fabs(hy - p->y) / (hx - p->x);
+			if (LocallyInside(p, hole) &&
+			    (tan < tan_min || (tan == tan_min && (p->x > m->x || (p->x == m->x && SectorContainsSector(m, p)))))) {
+				m = p;
+				tan_min = tan;
+			}
+		}
+		p = p->next;
+	} while (p != stop);
+	return m;
+}
+
+// Whether an ear can be cut off, i.e. it is convex and no reflex vertex of the ring is inside of it
+static bool IsEar(const Node *ear) {
+	auto a = ear->prev;
+	auto b = ear;
+	auto c = ear->next;
+	if (Area(a, b, c) >= 0) {
+		return false;
+	}
+	auto x0 = MinValue(a->x, MinValue(b->x, c->x));
+	auto y0 = MinValue(a->y, MinValue(b->y, c->y));
+	auto x1 = MaxValue(a->x, MaxValue(b->x, c->x));
+	auto y1 = MaxValue(a->y, MaxValue(b->y, c->y));
+
+	auto p = c->next;
+	while (p != a) {
+		if (p->x >= x0 && p->x <= x1 && p->y >= y0 && p->y <= y1 &&
+		    PointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y) && Area(p->prev, p, p->next) >= 0) {
+			return false;
+		}
+		p = p->next;
+	}
+	return true;
+}
+
+// Whether p is a vertex other than a and c that is inside the ear a, b, c and keeps it from being cut off
+static inline bool BlocksEar(const Node *p, const Node *a, const Node *b, const Node *c, double x0, double y0,
+                             double x1, double y1) {
+	return p->x >= x0 && p->x <= x1 && p->y >= y0 && p->y <= y1 && p != a && p != c &&
+	       PointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y) && Area(p->prev, p, p->next) >= 0;
+}
+
+//------------------------------------------------------------------------------
+// Triangulator
+//------------------------------------------------------------------------------
+Node *Triangulator::NewNode(uint32_t i) {
+	nodes.emplace_back();
+	auto &node = nodes.back();
+	node.i = i;
+	node.x = vertices[i].x;
+	node.y = vertices[i].y;
+	node.prev = nullptr;
+	node.next = nullptr;
+	node.z = 0;
+	node.prev_z = nullptr;
+	node.next_z = nullptr;
+	node.steiner = false;
+	return &node;
+}
+
+Node *Triangulator::InsertNode(uint32_t i, Node *last) {
+	auto p = NewNode(i);
+	if (!last) {
+		p->prev = p;
+		p->next = p;
+	} else {
+		p->next = last->next;
+		p->prev = last;
+		last->next->prev = p;
+		last->next = p;
+	}
+	return p;
+}
+
+Node *Triangulator::LinkRing(uint32_t start, uint32_t end, bool is_shell) {
+	// Twice the signed area, positive if the ring is counter-clockwise
+	double area = 0;
+	for (uint32_t i = start, j = end - 1; i < end; j = i++) {
+		area += (vertices[j].x - vertices[i].x) * (vertices[i].y + vertices[j].y);
+	}
+	Node *last = nullptr;
+	if (is_shell == (area > 0)) {
+		for (auto i = start; i < end; i++) {
+			last = InsertNode(i, last);
+		}
+	} else {
+		for (auto i = end; i > start; i--) {
+			last = InsertNode(i - 1, last);
+		}
+	}
+	if (last && Equals(last, last->next)) {
+		RemoveNode(last);
+		last = last->next;
+	}
+	return last;
+}
+
+Node *Triangulator::SplitPolygon(Node *a, Node *b) {
+	auto a2 = NewNode(a->i);
+	auto b2 = NewNode(b->i);
+	auto an = a->next;
+	auto bp = b->prev;
+
+	a->next = b;
+	b->prev = a;
+	a2->next = an;
+	an->prev = a2;
+	b2->next = a2;
+	a2->prev = b2;
+	bp->next = b2;
+	b2->prev = bp;
+	return b2;
+}
+
+Node *Triangulator::EliminateHoles(Node *outer) {
+	std::sort(holes.begin(), holes.end(), [](const Node *a, const Node *b) {
+		return a->x < b->x || (a->x == b->x && a->y < b->y);
+	});
+	for (auto hole : holes) {
+		auto bridge = FindHoleBridge(hole, outer);
+		if (!bridge) {
+			continue;
+		}
+		auto bridge_reverse = SplitPolygon(bridge, hole);
+		// Filter the collinear vertices around the cuts
+		FilterPoints(bridge_reverse, bridge_reverse->next);
+		outer = FilterPoints(bridge, bridge->next);
+	}
+	return outer;
+}
+
+// The position of a vertex along the z-order curve over the bounding box of the polygon, with 15 bits per axis
+uint32_t Triangulator::ZOrder(double x, double y) const {
+	auto ix = static_cast<uint32_t>((x - min_x) * inv_size);
+	auto iy = static_cast<uint32_t>((y - min_y) * inv_size);
+	ix = (ix | (ix << 8)) & 0x00FF00FF;
+	ix = (ix | (ix << 4)) & 0x0F0F0F0F;
+	ix = (ix | (ix << 2)) & 0x33333333;
+	ix = (ix | (ix << 1)) & 0x55555555;
+	iy = (iy | (iy << 8)) & 0x00FF00FF;
+	iy = (iy | (iy << 4)) & 0x0F0F0F0F;
+	iy = (iy | (iy << 2)) & 0x33333333;
+	iy = (iy | (iy << 1)) & 0x55555555;
+	return ix | (iy << 1);
+}
+
+void Triangulator::IndexCurve(Node *start) {
+	z_order.clear();
+	auto p = start;
+	do {
+		if (p->z == 0) {
+			p->z = ZOrder(p->x, p->y);
+		}
+		z_order.push_back(p);
+		p = p->next;
+	} while (p != start);
+
+	std::stable_sort(z_order.begin(), z_order.end(), [](const Node *a, const Node *b) { return a->z < b->z; });
+	for (idx_t i = 0; i < z_order.size(); i++) {
+		z_order[i]->prev_z = i > 0 ? z_order[i - 1] : nullptr;
+		z_order[i]->next_z = i + 1 < z_order.size() ? z_order[i + 1] : nullptr;
+	}
+}
+
+// IsEar, but only looking at the vertices within the z-order range of the bounding box of the ear
+bool Triangulator::IsEarHashed(const Node *ear) const {
+	auto a = ear->prev;
+	auto b = ear;
+	auto c = ear->next;
+	if (Area(a, b, c) >= 0) {
+		return false;
+	}
+	auto x0 = MinValue(a->x, MinValue(b->x, c->x));
+	auto y0 = MinValue(a->y, MinValue(b->y, c->y));
+	auto x1 = MaxValue(a->x, MaxValue(b->x, c->x));
+	auto y1 = MaxValue(a->y, MaxValue(b->y, c->y));
+	auto min_z = ZOrder(x0, y0);
+	auto max_z = ZOrder(x1, y1);
+
+	// Look in both directions at once, and then at whatever is left in either
+	auto p = ear->prev_z;
+	auto n = ear->next_z;
+	while (p && p->z >= min_z && n && n->z <= max_z) {
+		if (BlocksEar(p, a, b, c, x0, y0, x1, y1) || BlocksEar(n, a, b, c, x0, y0, x1, y1)) {
+			return false;
+		}
+		p = p->prev_z;
+		n = n->next_z;
+	}
+	for (; p && p->z >= min_z; p = p->prev_z) {
+		if (BlocksEar(p, a, b, c, x0, y0, x1, y1)) {
+			return false;
+		}
+	}
+	for (; n && n->z <= max_z; n = n->next_z) {
+		if (BlocksEar(n, a, b, c, x0, y0, x1, y1)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void Triangulator::AddTriangle(const Node *a, const Node *b, const Node *c) {
+	indices.push_back(a->i);
+	indices.push_back(b->i);
+	indices.push_back(c->i);
+}
+
+// Cut off the triangles of small self-intersections, where an edge crosses the edge after the next
+Node *Triangulator::CureLocalIntersections(Node *start) {
+	auto p = start;
+	do {
+		auto a = p->prev;
+		auto b = p->next->next;
+		if (!Equals(a, b) && Intersects(a, p, p->next, b) && LocallyInside(a, b) && LocallyInside(b, a)) {
+			AddTriangle(a, p, b);
+			RemoveNode(p);
+			RemoveNode(p->next);
+			p = start = b;
+		}
+		p = p->next;
+	} while (p != start);
+	return FilterPoints(p);
+}
+
+// Split the ring in two along a valid diagonal, and triangulate both halves
+void Triangulator::SplitEarcut(Node *start) {
+	auto a = start;
+	do {
+		auto b = a->next->next;
+		while (b != a->prev) {
+			if (a->i != b->i && IsValidDiagonal(a, b)) {
+				auto c = SplitPolygon(a, b);
+				a = FilterPoints(a, a->next);
+				c = FilterPoints(c, c->next);
+				EarcutLinked(a, 0);
+				EarcutLinked(c, 0);
+				return;
+			}
+			b = b->next;
+		}
+		a = a->next;
+	} while (a != start);
+}
+
+// Cut off ears until a triangle is left. When there are no more ears, the ring is not simple: first retry without
+// collinear vertices, then cut off small self-intersections, and as a last resort split it in two.
+void Triangulator::EarcutLinked(Node *ear, int pass) {
+	if (!ear) {
+		return;
+	}
+	if (pass == 0 && inv_size != 0) {
+		IndexCurve(ear);
+	}
+	auto stop = ear;
+	while (ear->prev != ear->next) {
+		auto prev = ear->prev;
+		auto next = ear->next;
+		if (inv_size != 0 ? IsEarHashed(ear) : IsEar(ear)) {
+			AddTriangle(prev, ear, next);
+			RemoveNode(ear);
+			// Skipping the next vertex leads to fewer slivers
+			ear = next->next;
+			stop = next->next;
+			continue;
+		}
+		ear = next;
+		if (ear == stop) {
+			if (pass == 0) {
+				EarcutLinked(FilterPoints(ear), 1);
+			} else if (pass == 1) {
+				EarcutLinked(CureLocalIntersections(FilterPoints(ear)), 2);
+			} else {
+				SplitEarcut(ear);
+			}
+			break;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// Processing
+//------------------------------------------------------------------------------
+void Triangulator::ProcessPoint(const VertexData &) {
+}
+
+void Triangulator::ProcessLineString(const VertexData &) {
+}
+
+void Triangulator::ProcessPolygon(PolygonState &state) {
+	nodes.clear();
+	holes.clear();
+	auto polygon_start = vertices.size();
+	Node *outer = nullptr;
+	bool is_shell = true;
+	while (!state.IsDone()) {
+		auto ring = state.Next();
+		auto count = ring.count;
+		if (count > 1 && Load<double>(ring.data[0]) == Load<double>(ring.data[0] + (count - 1) * ring.stride[0]) &&
+		    Load<double>(ring.data[1]) == Load<double>(ring.data[1] + (count - 1) * ring.stride[1])) {
+			// Skip the closing vertex
+			count--;
+		}
+		if (vertices.size() + count > NumericLimits<uint32_t>::Maximum()) {
+			throw InvalidInputException("Too many vertices to triangulate a single geometry");
+		}
+		auto ring_start = static_cast<uint32_t>(vertices.size());
+		for (uint32_t i = 0; i < count; i++) {
+			auto x = Load<double>(ring.data[0] + i * ring.stride[0]);
+			auto y = Load<double>(ring.data[1] + i * ring.stride[1]);
+			vertices.push_back({x, y});
+		}
+		auto list = LinkRing(ring_start, static_cast<uint32_t>(vertices.size()), is_shell);
+		if (is_shell) {
+			outer = list;
+			is_shell = false;
+		} else if (list) {
+			if (list == list->next) {
+				list->steiner = true;
+			}
+			holes.push_back(GetLeftmost(list));
+		}
+	}
+	if (!outer || outer->next == outer->prev) {
+		return;
+	}
+	if (!holes.empty()) {
+		outer = EliminateHoles(outer);
+	}
+
+	// Only larger polygons are worth hashing
+	inv_size = 0;
+	if (vertices.size() - polygon_start > 80) {
+		auto max_x = vertices[polygon_start].x;
+		auto max_y = vertices[polygon_start].y;
+		min_x = max_x;
+		min_y = max_y;
+		for (auto i = polygon_start + 1; i < vertices.size(); i++) {
+			min_x = MinValue(min_x, vertices[i].x);
+			min_y = MinValue(min_y, vertices[i].y);
+			max_x = MaxValue(max_x, vertices[i].x);
+			max_y = MaxValue(max_y, vertices[i].y);
+		}
+		auto size = MaxValue(max_x - min_x, max_y - min_y);
+		// Also leaves out non-finite coordinates, which can not be placed on the curve
+		if (size > 0 && Value::IsFinite(size)) {
+			inv_size = 32767 / size;
+		}
+	}
+	EarcutLinked(outer, 0);
+}
+
+void Triangulator::ProcessCollection(CollectionState &state) {
+	while (!state.IsDone()) {
+		state.Next();
+	}
+}
+
+void Triangulator::Execute(const geometry_t &geom) {
+	vertices.clear();
+	indices.clear();
+	Process(geom);
+}
+
+geometry_t Triangulator::Serialize(GeometryWriter &writer, Vector &result) const {
+	auto triangle_count = static_cast<uint32_t>(indices.size() / 3);
+	writer.Begin(GeometryType::GEOMETRYCOLLECTION, false, false);
+	writer.AddCollection(GeometryType::GEOMETRYCOLLECTION, triangle_count);
+	for (idx_t i = 0; i < indices.size(); i += 3) {
+		writer.AddPolygon(1);
+		writer.AddRing(4);
+		for (idx_t j = 0; j < 4; j++) {
+			auto &vertex = vertices[indices[i + j % 3]];
+			writer.AddVertex(vertex.x, vertex.y);
+		}
+	}
+	return writer.End(result);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,222 @@
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/twkb_reader.hpp"
+
+namespace spatial {
+
+namespace core {
+
+Geometry TWKBReader::Deserialize(const string_t &twkb) {
+	return Deserialize(const_data_ptr_cast(twkb.GetDataUnsafe()), twkb.GetSize());
+}
+
+Geometry TWKBReader::Deserialize(const_data_ptr_t twkb, uint32_t size) {
+	ptr = twkb;
+	end = twkb + size;
+	has_any_z = false;
+	has_any_m = false;
+
+	auto geom = ReadGeometry();
+
+	// The items of a collection can have different dimensions, unify them like the WKB reader does
+	geom.SetVertexType(arena, has_any_z, has_any_m);
+	return geom;
+}
+
+//------------------------------------------------------------------------------
+// Primitives
+//------------------------------------------------------------------------------
+uint8_t TWKBReader::ReadByte() {
+	if (ptr >= end) {
+		throw InvalidInputException("ST_GeomFromTWKB: unexpected end of the TWKB blob");
+	}
+	return *ptr++;
+}
+
+uint64_t TWKBReader::ReadVarInt() {
+	uint64_t result = 0;
+	for (uint32_t shift = 0; shift < 64; shift += 7) {
+		auto byte = ReadByte();
+		result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+		if (!(byte & 0x80)) {
+			return result;
+		}
+	}
+	throw InvalidInputException("ST_GeomFromTWKB: invalid variable length integer");
+}
+
+int64_t TWKBReader::ReadSignedVarInt() {
+	auto value = ReadVarInt();
+	return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+uint32_t TWKBReader::ReadCount() {
+	auto count = ReadVarInt();
+	// Every item takes at least a byte, so a count past the end of the blob can only come from corrupt input
+	if (count > static_cast<uint64_t>(end - ptr)) {
+		throw InvalidInputException("ST_GeomFromTWKB: count %s exceeds the size of the TWKB blob",
+		                            std::to_string(count));
+	}
+	return static_cast<uint32_t>(count);
+}
+
+void TWKBReader::SkipIdList(const Encoding &encoding, uint32_t count) {
+	if (encoding.has_id_list) {
+		for (uint32_t i = 0; i < count; i++) {
+			ReadVarInt();
+		}
+	}
+}
+
+VertexArray TWKBReader::ReadVertices(Encoding &encoding, uint32_t count) {
+	idx_t axes[4] = {0, 1, 0, 0};
+	idx_t axis_count = 2;
+	if (encoding.has_z) {
+		axes[axis_count++] = 2;
+	}
+	if (encoding.has_m) {
+		axes[axis_count++] = 3;
+	}
+	auto vertices = VertexArray::Create(arena, count, encoding.has_z, encoding.has_m);
+	auto data = vertices.GetData();
+	for (uint32_t i = 0; i < count; i++) {
+		for (idx_t a = 0; a < axis_count; a++) {
+			auto axis = axes[a];
+			encoding.last[axis] += ReadSignedVarInt();
+			Store<double>(static_cast<double>(encoding.last[axis]) / encoding.scale[axis], data);
+			data += sizeof(double);
+		}
+	}
+	return vertices;
+}
+
+//------------------------------------------------------------------------------
+// Geometries
+//------------------------------------------------------------------------------
+Polygon TWKBReader::ReadPolygon(Encoding &encoding) {
+	auto ring_count = ReadCount();
+	Polygon polygon(arena, ring_count, encoding.has_z, encoding.has_m);
+	for (uint32_t i = 0; i < ring_count; i++) {
+		polygon[i] = ReadVertices(encoding, ReadCount());
+	}
+	return polygon;
+}
+
+Geometry TWKBReader::ReadGeometry() {
+	Encoding encoding = {};
+	auto type_and_precision = ReadByte();
+	auto type_id = type_and_precision & 0x0F;
+	if (type_id < 1 || type_id > 7) {
+		throw InvalidInputException("ST_GeomFromTWKB: unknown geometry type %d", type_id);
+	}
+	encoding.type = static_cast<GeometryType>(type_id - 1);
+	auto precision_bits = type_and_precision >> 4;
+	auto precision_xy = static_cast<int32_t>(precision_bits >> 1) ^ -static_cast<int32_t>(precision_bits & 1);
+
+	auto metadata = ReadByte();
+	auto has_box = (metadata & 0x01) != 0;
+	auto has_size = (metadata & 0x02) != 0;
+	encoding.has_id_list = (metadata & 0x04) != 0;
+	auto has_extended_dims = (metadata & 0x08) != 0;
+	auto is_empty = (metadata & 0x10) != 0;
+
+	int32_t precision_z = 0;
+	int32_t precision_m = 0;
+	if (has_extended_dims) {
+		auto extended = ReadByte();
+		encoding.has_z = (extended & 0x01) != 0;
+		encoding.has_m = (extended & 0x02) != 0;
+		precision_z = (extended >> 2) & 0x07;
+		precision_m = (extended >> 5) & 0x07;
+	}
+	has_any_z |= encoding.has_z;
+	has_any_m |= encoding.has_m;
+	encoding.scale[0] = encoding.scale[1] = std::pow(10.0, precision_xy);
+	encoding.scale[2] = std::pow(10.0, precision_z);
+	encoding.scale[3] = std::pow(10.0, precision_m);
+
+	if (has_size) {
+		ReadVarInt();
+	}
+	if (has_box) {
+		// The bounds are not needed to build the geometry, the serializer computes its own
+		auto dims = 2 + encoding.has_z + encoding.has_m;
+		for (idx_t i = 0; i < 2 * static_cast<idx_t>(dims); i++) {
+			ReadVarInt();
+		}
+	}
+
+	auto has_z = encoding.has_z;
+	auto has_m = encoding.has_m;
+	switch (encoding.type) {
+	case GeometryType::POINT:
+		if (is_empty) {
+			return Point(has_z, has_m);
+		}
+		return Point(ReadVertices(encoding, 1));
+	case GeometryType::LINESTRING:
+		if (is_empty) {
+			return LineString(has_z, has_m);
+		}
+		return LineString(ReadVertices(encoding, ReadCount()));
+	case GeometryType::POLYGON:
+		if (is_empty) {
+			return Polygon(has_z, has_m);
+		}
+		return ReadPolygon(encoding);
+	case GeometryType::MULTIPOINT: {
+		if (is_empty) {
+			return MultiPoint(has_z, has_m);
+		}
+		auto count = ReadCount();
+		SkipIdList(encoding, count);
+		MultiPoint multi_point(arena, count, has_z, has_m);
+		for (uint32_t i = 0; i < count; i++) {
+			multi_point[i] = Point(ReadVertices(encoding, 1));
+		}
+		return multi_point;
+	}
+	case GeometryType::MULTILINESTRING: {
+		if (is_empty) {
+			return MultiLineString(has_z, has_m);
+		}
+		auto count = ReadCount();
+		SkipIdList(encoding, count);
+		MultiLineString multi_line_string(arena, count, has_z, has_m);
+		for (uint32_t i = 0; i < count; i++) {
+			multi_line_string[i] = LineString(ReadVertices(encoding, ReadCount()));
+		}
+		return multi_line_string;
+	}
+	case GeometryType::MULTIPOLYGON: {
+		if (is_empty) {
+			return MultiPolygon(has_z, has_m);
+		}
+		auto count = ReadCount();
+		SkipIdList(encoding, count);
+		MultiPolygon multi_polygon(arena, count, has_z, has_m);
+		for (uint32_t i = 0; i < count; i++) {
+			multi_polygon[i] = ReadPolygon(encoding);
+		}
+		return multi_polygon;
+	}
+	case GeometryType::GEOMETRYCOLLECTION: {
+		if (is_empty) {
+			return GeometryCollection(has_z, has_m);
+		}
+		auto count = ReadCount();
+		SkipIdList(encoding, count);
+		GeometryCollection collection(arena, count, has_z, has_m);
+		for (uint32_t i = 0; i < count; i++) {
+			collection[i] = ReadGeometry();
+		}
+		return collection;
+	}
+	default:
+		throw InvalidInputException("ST_GeomFromTWKB: unknown geometry type %d", type_id);
+	}
+}
+
+} // namespace core
+
+} // namespace spatial
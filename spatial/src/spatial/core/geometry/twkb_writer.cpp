@@ -0,0 +1,213 @@
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/twkb_writer.hpp"
+#include "spatial/core/geometry/geometry_processor.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Serializer
+//------------------------------------------------------------------------------
+// Tiny WKB (https://github.com/TWKB/Specification) stores every coordinate as a zigzag encoded variable length
+// integer: the difference to the previous vertex of the same geometry, after scaling by the precision and rounding.
+// Items of a MULTI geometry only store their body and share the deltas of their parent, the items of a
+// GEOMETRYCOLLECTION are complete TWKB geometries of their own.
+class TWKBSerializer final : GeometryProcessor<void, vector<data_t> &> {
+	const TWKBOptions &options;
+	double scale[4];
+
+	// The running values and the bounds of the TWKB geometries being written, innermost last
+	struct Encoding {
+		int64_t last[4] = {0, 0, 0, 0};
+		int64_t min[4] = {0, 0, 0, 0};
+		int64_t max[4] = {0, 0, 0, 0};
+		bool has_vertices = false;
+	};
+	vector<Encoding> encodings;
+
+	static void WriteVarInt(vector<data_t> &out, uint64_t value) {
+		while (value >= 0x80) {
+			out.push_back(static_cast<data_t>(value | 0x80));
+			value >>= 7;
+		}
+		out.push_back(static_cast<data_t>(value));
+	}
+
+	static void WriteSignedVarInt(vector<data_t> &out, int64_t value) {
+		// Zigzag encoding, so that small negative values are small too
+		WriteVarInt(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+	}
+
+	int64_t Quantize(double value, idx_t axis) const {
+		auto scaled = std::round(value * scale[axis]);
+		// Leave room for the delta to the previous value
+		if (!(std::abs(scaled) < 4e18)) {
+			throw InvalidInputException("ST_AsTWKB: coordinate %s can not be encoded with this precision",
+			                            std::to_string(value));
+		}
+		return static_cast<int64_t>(scaled);
+	}
+
+	void WriteVertices(const VertexData &vertices, vector<data_t> &out) {
+		idx_t axes[4] = {0, 1, 0, 0};
+		idx_t axis_count = 2;
+		if (HasZ()) {
+			axes[axis_count++] = 2;
+		}
+		if (HasM()) {
+			axes[axis_count++] = 3;
+		}
+		auto &encoding = encodings.back();
+		for (uint32_t i = 0; i < vertices.count; i++) {
+			for (idx_t a = 0; a < axis_count; a++) {
+				auto axis = axes[a];
+				auto value = Quantize(Load<double>(vertices.data[axis] + i * vertices.stride[axis]), axis);
+				WriteSignedVarInt(out, value - encoding.last[axis]);
+				encoding.last[axis] = value;
+				if (!encoding.has_vertices || value < encoding.min[axis]) {
+					encoding.min[axis] = value;
+				}
+				if (!encoding.has_vertices || value > encoding.max[axis]) {
+					encoding.max[axis] = value;
+				}
+			}
+			encoding.has_vertices = true;
+		}
+	}
+
+	// Items of a MULTI geometry are written as part of their parent, everything else as a TWKB geometry
+	template <class F>
+	void WriteGeometry(vector<data_t> &out, bool is_empty, F &&write_body) {
+		if (IsNested() && ParentType() != GeometryType::GEOMETRYCOLLECTION) {
+			write_body(out);
+			return;
+		}
+
+		auto dims = 2 + HasZ() + HasM();
+		auto type_id = static_cast<uint8_t>(CurrentType()) + 1;
+		auto precision = static_cast<uint8_t>((options.precision_xy << 1) ^ (options.precision_xy >> 31));
+		out.push_back(static_cast<data_t>(type_id | (precision << 4)));
+
+		auto with_sizes = options.with_sizes && !is_empty;
+		auto with_boxes = options.with_boxes && !is_empty;
+		uint8_t metadata = 0;
+		metadata |= with_boxes ? 0x01 : 0;
+		metadata |= with_sizes ? 0x02 : 0;
+		metadata |= HasZ() || HasM() ? 0x08 : 0;
+		metadata |= is_empty ? 0x10 : 0;
+		out.push_back(metadata);
+		if (HasZ() || HasM()) {
+			out.push_back(static_cast<data_t>((HasZ() ? 0x01 : 0) | (HasM() ? 0x02 : 0) | (options.precision_z << 2) |
+			                                  (options.precision_m << 5)));
+		}
+		if (is_empty) {
+			return;
+		}
+
+		// The body is written first, so that its size and bounds can be written in front of it
+		vector<data_t> body;
+		encodings.emplace_back();
+		write_body(body);
+		auto encoding = encodings.back();
+		encodings.pop_back();
+
+		// The bounds of a GEOMETRYCOLLECTION cover the bounds of its items
+		if (!encodings.empty() && encoding.has_vertices) {
+			auto &parent = encodings.back();
+			for (idx_t axis = 0; axis < 4; axis++) {
+				auto first = !parent.has_vertices;
+				parent.min[axis] = first ? encoding.min[axis] : MinValue(parent.min[axis], encoding.min[axis]);
+				parent.max[axis] = first ? encoding.max[axis] : MaxValue(parent.max[axis], encoding.max[axis]);
+			}
+			parent.has_vertices = true;
+		}
+
+		vector<data_t> box;
+		if (with_boxes) {
+			idx_t axes[4] = {0, 1, 2, 3};
+			if (!HasZ()) {
+				axes[2] = 3;
+			}
+			for (idx_t a = 0; a < static_cast<idx_t>(dims); a++) {
+				auto axis = axes[a];
+				WriteSignedVarInt(box, encoding.min[axis]);
+				WriteSignedVarInt(box, encoding.max[axis] - encoding.min[axis]);
+			}
+		}
+		if (with_sizes) {
+			WriteVarInt(out, box.size() + body.size());
+		}
+		out.insert(out.end(), box.begin(), box.end());
+		out.insert(out.end(), body.begin(), body.end());
+	}
+
+	void ProcessPoint(const VertexData &vertices, vector<data_t> &out) override {
+		if (vertices.IsEmpty() && IsNested() && ParentType() == GeometryType::MULTIPOINT) {
+			throw InvalidInputException("ST_AsTWKB: a MULTIPOINT with EMPTY points can not be encoded");
+		}
+		WriteGeometry(out, vertices.IsEmpty(), [&](vector<data_t> &body) { WriteVertices(vertices, body); });
+	}
+
+	void ProcessLineString(const VertexData &vertices, vector<data_t> &out) override {
+		WriteGeometry(out, vertices.IsEmpty(), [&](vector<data_t> &body) {
+			WriteVarInt(body, vertices.count);
+			WriteVertices(vertices, body);
+		});
+	}
+
+	void ProcessPolygon(PolygonState &state, vector<data_t> &out) override {
+		WriteGeometry(out, state.RingCount() == 0, [&](vector<data_t> &body) {
+			WriteVarInt(body, state.RingCount());
+			while (!state.IsDone()) {
+				auto vertices = state.Next();
+				WriteVarInt(body, vertices.count);
+				WriteVertices(vertices, body);
+			}
+		});
+	}
+
+	void ProcessCollection(CollectionState &state, vector<data_t> &out) override {
+		WriteGeometry(out, state.ItemCount() == 0, [&](vector<data_t> &body) {
+			WriteVarInt(body, state.ItemCount());
+			while (!state.IsDone()) {
+				state.Next(body);
+			}
+		});
+	}
+
+public:
+	explicit TWKBSerializer(const TWKBOptions &options) : options(options) {
+		scale[0] = scale[1] = std::pow(10.0, options.precision_xy);
+		scale[2] = std::pow(10.0, options.precision_z);
+		scale[3] = std::pow(10.0, options.precision_m);
+	}
+
+	void Execute(const geometry_t &geometry, vector<data_t> &buffer) {
+		encodings.clear();
+		Process(geometry, buffer);
+	}
+};
+
+string_t TWKBWriter::Write(const geometry_t &geometry, Vector &result, const TWKBOptions &options) {
+	vector<data_t> buffer;
+	Write(geometry, buffer, options);
+	return StringVector::AddStringOrBlob(result, const_char_ptr_cast(buffer.data()), buffer.size());
+}
+
+void TWKBWriter::Write(const geometry_t &geometry, vector<data_t> &buffer, const TWKBOptions &options) {
+	if (options.precision_xy < -7 || options.precision_xy > 7) {
+		throw InvalidInputException("ST_AsTWKB: the precision of X and Y must be between -7 and 7");
+	}
+	if (options.precision_z < 0 || options.precision_z > 7 || options.precision_m < 0 || options.precision_m > 7) {
+		throw InvalidInputException("ST_AsTWKB: the precision of Z and M must be between 0 and 7");
+	}
+	buffer.clear();
+	TWKBSerializer serializer(options);
+	serializer.Execute(geometry, buffer);
+}
+
+} // namespace core
+
+} // namespace spatial
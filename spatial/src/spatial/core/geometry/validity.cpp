@@ -0,0 +1,95 @@
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/validity.hpp"
+#include "spatial/core/geometry/geometry_processor.hpp"
+
+namespace spatial {
+
+namespace core {
+
+enum class ValidityCheckResult : uint8_t { VALID, INVALID, UNKNOWN };
+
+class ValidityChecker final : GeometryProcessor<ValidityCheckResult> {
+private:
+	static bool HasFiniteCoordinates(const VertexData &vertices) {
+		for (uint32_t i = 0; i < vertices.count; i++) {
+			auto x = Load<double>(vertices.data[0] + i * vertices.stride[0]);
+			auto y = Load<double>(vertices.data[1] + i * vertices.stride[1]);
+			if (!std::isfinite(x) || !std::isfinite(y)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	ValidityCheckResult ProcessPoint(const VertexData &vertices) override {
+		return HasFiniteCoordinates(vertices) ? ValidityCheckResult::VALID : ValidityCheckResult::INVALID;
+	}
+
+	ValidityCheckResult ProcessLineString(const VertexData &vertices) override {
+		if (!HasFiniteCoordinates(vertices)) {
+			return ValidityCheckResult::INVALID;
+		}
+		if (vertices.count == 0) {
+			return ValidityCheckResult::VALID;
+		}
+		auto x0 = Load<double>(vertices.data[0]);
+		auto y0 = Load<double>(vertices.data[1]);
+		for (uint32_t i = 1; i < vertices.count; i++) {
+			auto x = Load<double>(vertices.data[0] + i * vertices.stride[0]);
+			auto y = Load<double>(vertices.data[1] + i * vertices.stride[1]);
+			if (x != x0 || y != y0) {
+				return ValidityCheckResult::VALID;
+			}
+		}
+		return ValidityCheckResult::INVALID;
+	}
+
+	ValidityCheckResult ProcessPolygon(PolygonState &) override {
+		// Rings may self-intersect or overlap each other, that takes GEOS to find out
+		return ValidityCheckResult::UNKNOWN;
+	}
+
+	ValidityCheckResult ProcessCollection(CollectionState &state) override {
+		// The parts of collections are checked one by one, so any invalid part makes the collection invalid
+		auto result = ValidityCheckResult::VALID;
+		while (!state.IsDone()) {
+			switch (state.Next()) {
+			case ValidityCheckResult::INVALID:
+				return ValidityCheckResult::INVALID;
+			case ValidityCheckResult::UNKNOWN:
+				result = ValidityCheckResult::UNKNOWN;
+				break;
+			default:
+				break;
+			}
+		}
+		return result;
+	}
+
+public:
+	ValidityCheckResult Execute(const geometry_t &geom) {
+		return Process(geom);
+	}
+};
+
+bool GeometryValidity::TryCheck(const geometry_t &geom, bool &valid) {
+	if (geom.GetProperties().IsValid()) {
+		valid = true;
+		return true;
+	}
+	ValidityChecker checker;
+	switch (checker.Execute(geom)) {
+	case ValidityCheckResult::VALID:
+		valid = true;
+		return true;
+	case ValidityCheckResult::INVALID:
+		valid = false;
+		return true;
+	default:
+		return false;
+	}
+}
+
+} // namespace core
+
+} // namespace spatial
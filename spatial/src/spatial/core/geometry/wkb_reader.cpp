@@ -2,6 +2,8 @@
 #include "spatial/core/geometry/wkb_reader.hpp"
 #include "spatial/core/geometry/vertex_vector.hpp"
 #include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/cursor.hpp"
 
 namespace spatial {
 
@@ -35,14 +37,17 @@ uint32_t WKBReader::ReadInt(Cursor &cursor, bool little_endian) {
 	}
 }
 
+static uint64_t SwapBytes(uint64_t data) {
+	return (data >> 56) | ((data >> 40) & 0xFF00) | ((data >> 24) & 0xFF0000) | ((data >> 8) & 0xFF000000) |
+	       ((data << 8) & 0xFF00000000) | ((data << 24) & 0xFF0000000000) | ((data << 40) & 0xFF000000000000) |
+	       (data << 56);
+}
+
 double WKBReader::ReadDouble(Cursor &cursor, bool little_endian) {
 	if (little_endian) {
 		return cursor.Read<double>();
 	} else {
-		auto data = cursor.template Read<uint64_t>();
-		// swap bytes
-		data = (data & 0x00000000FF000000) << 24 | (data & 0x000000FF00000000) << 8 | (data & 0x0000FF0000000000) >> 8 |
-		       (data & 0xFF00000000000000) >> 24;
+		auto data = SwapBytes(cursor.template Read<uint64_t>());
 		double result;
 		memcpy(&result, &data, sizeof(double));
 		return result;
@@ -181,6 +186,256 @@ Geometry WKBReader::ReadGeometry(Cursor &cursor) {
 	}
 }
 
+//------------------------------------------------------------------------------
+// Transcoding
+//------------------------------------------------------------------------------
+// The WKB is read twice: once to compute the serialized size, the vertex type and the bounding box, and once to write
+// the serialized geometry. Vertices are converted to the vertex type of the whole geometry, missing Z and M values are
+// set to 0, the same way Geometry::SetVertexType would.
+
+geometry_t WKBReader::Transcode(Vector &result, const string_t &wkb, bool double_bbox) {
+	return Transcode(result, const_data_ptr_cast(wkb.GetDataUnsafe()), wkb.GetSize(), double_bbox);
+}
+
+geometry_t WKBReader::Transcode(Vector &result, const_data_ptr_t wkb, uint32_t size, bool double_bbox) {
+	has_any_m = false;
+	has_any_z = false;
+
+	// First pass, measure
+	TranscodeState state;
+	Cursor measure_cursor(const_cast<data_ptr_t>(wkb), const_cast<data_ptr_t>(wkb + size));
+	auto type = MeasureGeometry(measure_cursor, state);
+
+	if (has_any_z && state.missing_z) {
+		state.bbox.minz = std::min(state.bbox.minz, 0.0);
+		state.bbox.maxz = std::max(state.bbox.maxz, 0.0);
+	}
+	if (has_any_m && state.missing_m) {
+		state.bbox.minm = std::min(state.bbox.minm, 0.0);
+		state.bbox.maxm = std::max(state.bbox.maxm, 0.0);
+	}
+
+	bool has_bbox = type != GeometryType::POINT && state.vertex_count != 0;
+	GeometryProperties properties;
+	properties.SetBBox(has_bbox);
+	properties.SetDoubleBBox(has_bbox && double_bbox);
+	properties.SetZ(has_any_z);
+	properties.SetM(has_any_m);
+
+	auto vertex_size = sizeof(double) * (2 + (has_any_z ? 1 : 0) + (has_any_m ? 1 : 0));
+	auto geom_size = state.fixed_size + state.vertex_count * vertex_size;
+	auto blob = StringVector::EmptyString(result, 4 + 4 + properties.BBoxSize() + geom_size); // + 4 for padding
+	Cursor output(blob);
+
+	// Write the header
+	output.Write<GeometryType>(type);
+	output.Write<GeometryProperties>(properties);
+	output.Write<uint16_t>(0);
+	output.Write<uint32_t>(0);
+	GeometryFactory::SerializeBoundingBox(output, state.bbox, properties);
+
+	// Second pass, write
+	Cursor input(const_cast<data_ptr_t>(wkb), const_cast<data_ptr_t>(wkb + size));
+	TranscodeGeometry(input, output);
+
+	blob.Finalize();
+	return geometry_t(blob);
+}
+
+void WKBReader::MeasureVertices(Cursor &cursor, TranscodeState &state, bool little_endian, bool has_z, bool has_m,
+                                uint32_t count, bool update_bounds) {
+	auto vertex_size = sizeof(double) * (2 + (has_z ? 1 : 0) + (has_m ? 1 : 0));
+	if (count > cursor.Remaining() / vertex_size) {
+		throw SerializationException("Trying to read past end of buffer");
+	}
+	state.vertex_count += count;
+	if (!update_bounds) {
+		cursor.Skip(count * vertex_size);
+		return;
+	}
+	auto &bbox = state.bbox;
+	state.missing_z |= !has_z && count != 0;
+	state.missing_m |= !has_m && count != 0;
+	for (uint32_t i = 0; i < count; i++) {
+		auto x = ReadDouble(cursor, little_endian);
+		auto y = ReadDouble(cursor, little_endian);
+		bbox.minx = std::min(bbox.minx, x);
+		bbox.miny = std::min(bbox.miny, y);
+		bbox.maxx = std::max(bbox.maxx, x);
+		bbox.maxy = std::max(bbox.maxy, y);
+		if (has_z) {
+			auto z = ReadDouble(cursor, little_endian);
+			bbox.minz = std::min(bbox.minz, z);
+			bbox.maxz = std::max(bbox.maxz, z);
+		}
+		if (has_m) {
+			auto m = ReadDouble(cursor, little_endian);
+			bbox.minm = std::min(bbox.minm, m);
+			bbox.maxm = std::max(bbox.maxm, m);
+		}
+	}
+}
+
+GeometryType WKBReader::MeasureGeometry(Cursor &cursor, TranscodeState &state) {
+	bool little_endian = cursor.Read<uint8_t>();
+	auto type = ReadType(cursor, little_endian);
+
+	// Type (4 bytes) and count (4 bytes)
+	state.fixed_size += 8;
+
+	switch (type.type) {
+	case GeometryType::POINT: {
+		// A point where all ordinates are NaN is empty
+		auto dims = 2 + (type.has_z ? 1 : 0) + (type.has_m ? 1 : 0);
+		auto point_ptr = cursor.GetPtr();
+		bool all_nan = true;
+		for (uint32_t i = 0; i < dims; i++) {
+			if (!std::isnan(ReadDouble(cursor, little_endian))) {
+				all_nan = false;
+			}
+		}
+		if (!all_nan) {
+			cursor.SetPtr(point_ptr);
+			MeasureVertices(cursor, state, little_endian, type.has_z, type.has_m, 1, true);
+		}
+	} break;
+	case GeometryType::LINESTRING: {
+		auto count = ReadInt(cursor, little_endian);
+		MeasureVertices(cursor, state, little_endian, type.has_z, type.has_m, count, true);
+	} break;
+	case GeometryType::POLYGON: {
+		auto ring_count = ReadInt(cursor, little_endian);
+		// Ring lengths (4 bytes each), padded to 8 bytes
+		state.fixed_size += ring_count * 4 + (ring_count % 2 == 1 ? 4 : 0);
+		for (uint32_t i = 0; i < ring_count; i++) {
+			auto count = ReadInt(cursor, little_endian);
+			// Only the shell contributes to the bounding box
+			MeasureVertices(cursor, state, little_endian, type.has_z, type.has_m, count, i == 0);
+		}
+	} break;
+	case GeometryType::MULTIPOINT:
+	case GeometryType::MULTILINESTRING:
+	case GeometryType::MULTIPOLYGON:
+	case GeometryType::GEOMETRYCOLLECTION: {
+		auto count = ReadInt(cursor, little_endian);
+		for (uint32_t i = 0; i < count; i++) {
+			auto child_type = MeasureGeometry(cursor, state);
+			bool valid_child = type.type == GeometryType::GEOMETRYCOLLECTION ||
+			                   static_cast<uint8_t>(child_type) + 3 == static_cast<uint8_t>(type.type);
+			if (!valid_child) {
+				throw SerializationException("WKB Reader: Unexpected geometry type %u in multi geometry", child_type);
+			}
+		}
+	} break;
+	default:
+		throw NotImplementedException("WKB Reader: Geometry type %u not supported", type.type);
+	}
+	return type.type;
+}
+
+void WKBReader::TranscodeVertices(Cursor &input, Cursor &output, bool little_endian, bool has_z, bool has_m,
+                                  uint32_t count) {
+	auto input_dims = 2 + (has_z ? 1 : 0) + (has_m ? 1 : 0);
+	auto output_dims = 2 + (has_any_z ? 1 : 0) + (has_any_m ? 1 : 0);
+
+	auto input_ptr = input.GetPtr();
+	auto output_ptr = output.GetPtr();
+	input.Skip(count * input_dims * sizeof(double));
+	output.Skip(count * output_dims * sizeof(double));
+
+	if (input_dims == output_dims) {
+		// Same vertex type, copy in bulk
+		memcpy(output_ptr, input_ptr, count * input_dims * sizeof(double));
+		if (!little_endian) {
+			for (uint32_t i = 0; i < count * output_dims; i++) {
+				auto ordinate_ptr = output_ptr + i * sizeof(double);
+				Store<uint64_t>(SwapBytes(Load<uint64_t>(ordinate_ptr)), ordinate_ptr);
+			}
+		}
+		return;
+	}
+
+	// Different vertex type, convert vertex by vertex
+	auto m_offset = 2 + (has_z ? 1 : 0);
+	for (uint32_t i = 0; i < count; i++) {
+		uint64_t ordinates[4] = {0, 0, 0, 0};
+		auto vertex_ptr = input_ptr + i * input_dims * sizeof(double);
+		for (uint32_t j = 0; j < input_dims; j++) {
+			auto ordinate = Load<uint64_t>(vertex_ptr + j * sizeof(double));
+			ordinates[j] = little_endian ? ordinate : SwapBytes(ordinate);
+		}
+		// Move the M value to the end, the missing Z value stays 0 (positive zero has all bits cleared)
+		uint64_t vertex[4] = {ordinates[0], ordinates[1], has_z ? ordinates[2] : 0, has_m ? ordinates[m_offset] : 0};
+		if (!has_any_z) {
+			vertex[2] = vertex[3];
+		}
+		memcpy(output_ptr + i * output_dims * sizeof(double), vertex, output_dims * sizeof(double));
+	}
+}
+
+void WKBReader::TranscodeGeometry(Cursor &input, Cursor &output) {
+	bool little_endian = input.Read<uint8_t>();
+	auto type = ReadType(input, little_endian);
+
+	switch (type.type) {
+	case GeometryType::POINT: {
+		output.Write(SerializedGeometryType::POINT);
+		auto dims = 2 + (type.has_z ? 1 : 0) + (type.has_m ? 1 : 0);
+		auto point_ptr = input.GetPtr();
+		bool all_nan = true;
+		for (uint32_t i = 0; i < dims; i++) {
+			if (!std::isnan(ReadDouble(input, little_endian))) {
+				all_nan = false;
+			}
+		}
+		if (all_nan) {
+			output.Write<uint32_t>(0);
+		} else {
+			output.Write<uint32_t>(1);
+			input.SetPtr(point_ptr);
+			TranscodeVertices(input, output, little_endian, type.has_z, type.has_m, 1);
+		}
+	} break;
+	case GeometryType::LINESTRING: {
+		output.Write(SerializedGeometryType::LINESTRING);
+		auto count = ReadInt(input, little_endian);
+		output.Write<uint32_t>(count);
+		TranscodeVertices(input, output, little_endian, type.has_z, type.has_m, count);
+	} break;
+	case GeometryType::POLYGON: {
+		output.Write(SerializedGeometryType::POLYGON);
+		auto ring_count = ReadInt(input, little_endian);
+		output.Write<uint32_t>(ring_count);
+
+		// The ring lengths are written up front, but WKB stores each length next to the ring data
+		auto ring_lengths_ptr = output.GetPtr();
+		output.Skip(ring_count * 4);
+		if (ring_count % 2 == 1) {
+			// Write padding (4 bytes)
+			output.Write<uint32_t>(0);
+		}
+		for (uint32_t i = 0; i < ring_count; i++) {
+			auto count = ReadInt(input, little_endian);
+			Store<uint32_t>(count, ring_lengths_ptr + i * 4);
+			TranscodeVertices(input, output, little_endian, type.has_z, type.has_m, count);
+		}
+	} break;
+	case GeometryType::MULTIPOINT:
+	case GeometryType::MULTILINESTRING:
+	case GeometryType::MULTIPOLYGON:
+	case GeometryType::GEOMETRYCOLLECTION: {
+		output.Write(static_cast<SerializedGeometryType>(type.type));
+		auto count = ReadInt(input, little_endian);
+		output.Write<uint32_t>(count);
+		for (uint32_t i = 0; i < count; i++) {
+			TranscodeGeometry(input, output);
+		}
+	} break;
+	default:
+		throw NotImplementedException("WKB Reader: Geometry type %u not supported", type.type);
+	}
+}
+
 } // namespace core
 
 } // namespace spatial
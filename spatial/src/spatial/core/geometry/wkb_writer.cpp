@@ -3,6 +3,7 @@
 #include "spatial/core/geometry/geometry.hpp"
 #include "spatial/core/geometry/wkb_writer.hpp"
 #include "spatial/core/geometry/geometry_processor.hpp"
+#include "spatial/core/geometry/hex_codec.hpp"
 
 namespace spatial {
 
@@ -80,30 +81,14 @@ class WKBSerializer final : GeometryProcessor<void, Cursor &> {
 				cursor.Write(std::numeric_limits<double>::quiet_NaN());
 			}
 		} else {
-			cursor.Write(Load<double>(vertices.data[0]));
-			cursor.Write(Load<double>(vertices.data[1]));
-			if (HasZ()) {
-				cursor.Write(Load<double>(vertices.data[2]));
-			}
-			if (HasM()) {
-				cursor.Write(Load<double>(vertices.data[3]));
-			}
+			ProcessVertices(vertices, cursor);
 		}
 	}
 
+	// The serialized vertices are interleaved doubles in the same X, Y (, Z) (, M) order as WKB, so they are copied
+	// as a single run instead of one coordinate at a time
 	void ProcessVertices(const VertexData &vertices, Cursor &cursor) {
-		bool has_z = HasZ();
-		bool has_m = HasM();
-		for (uint32_t i = 0; i < vertices.count; i++) {
-			cursor.Write(Load<double>(vertices.data[0] + i * vertices.stride[0]));
-			cursor.Write(Load<double>(vertices.data[1] + i * vertices.stride[1]));
-			if (has_z) {
-				cursor.Write(Load<double>(vertices.data[2] + i * vertices.stride[2]));
-			}
-			if (has_m) {
-				cursor.Write(Load<double>(vertices.data[3] + i * vertices.stride[3]));
-			}
-		}
+		cursor.WriteBytes(vertices.data[0], vertices.ByteSize());
 	}
 
 	void ProcessLineString(const VertexData &vertices, Cursor &cursor) override {
@@ -159,6 +144,20 @@ void WKBWriter::Write(const geometry_t &geometry, vector<data_t> &buffer) {
 	serializer.Execute(geometry, buffer.data(), buffer.data() + size);
 }
 
+string_t WKBWriter::WriteHex(const geometry_t &geometry, Vector &result) {
+	WKBSizeCalculator size_processor;
+	WKBSerializer serializer;
+	auto size = size_processor.Execute(geometry);
+	auto hex = StringVector::EmptyString(result, 2 * size);
+	// The WKB is written to the second half of the string and then expanded into hex in place
+	auto hex_ptr = hex.GetDataWriteable();
+	auto wkb_ptr = data_ptr_cast(hex_ptr + size);
+	serializer.Execute(geometry, wkb_ptr, wkb_ptr + size);
+	HexCodec::Encode(wkb_ptr, size, hex_ptr);
+	hex.Finalize();
+	return hex;
+}
+
 const_data_ptr_t WKBWriter::Write(const geometry_t &geometry, uint32_t *size, ArenaAllocator &allocator) {
 	WKBSizeCalculator size_processor;
 	WKBSerializer serializer;
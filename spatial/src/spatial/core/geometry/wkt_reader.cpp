@@ -7,7 +7,7 @@ namespace spatial {
 
 namespace core {
 
-// TODO: Support the full EWKT spec (e.g. SRID and other metadata)
+// TODO: Support the full EWKT spec (e.g. store the SRID)
 // TODO: Support better error messages using DuckDBs new error context
 string WKTReader::GetErrorContext() {
     // Return a string of the current position in the input string
@@ -27,9 +27,7 @@ bool WKTReader::TryParseDouble(double &data) {
     auto result = duckdb_fast_float::from_chars<double>(cursor, end, data);
     if (result.ec == std::errc()) {
         cursor = result.ptr;
-        while (cursor < end && std::isspace(*cursor)) {
-            cursor++;
-        }
+        SkipWhitespace();
         return true;
     } else {
         return false;
@@ -53,12 +51,16 @@ string WKTReader::ParseWord() {
     return string(pos, cursor);
 }
 
+void WKTReader::SkipWhitespace() {
+    while (cursor < end && std::isspace(*cursor)) {
+        cursor++;
+    }
+}
+
 bool WKTReader::Match(char c) {
-    if (*cursor == c) {
+    if (cursor < end && *cursor == c) {
         cursor++;
-        while (cursor < end && std::isspace(*cursor)) {
-            cursor++;
-        }
+        SkipWhitespace();
         return true;
     } else {
         return false;
@@ -68,16 +70,14 @@ bool WKTReader::Match(char c) {
 bool WKTReader::MatchCI(const char *str) {
     auto pos = cursor;
     while (*str) {
-        if (std::tolower(*str) != std::tolower(*cursor)) {
+        if (cursor == end || std::tolower(*str) != std::tolower(*cursor)) {
             cursor = pos;
             return false;
         }
         str++;
         cursor++;
     }
-    while (cursor < end && std::isspace(*cursor)) {
-        cursor++;
-    }
+    SkipWhitespace();
     return true;
 }
 
@@ -88,23 +88,25 @@ void WKTReader::Expect(char c) {
     }
 }
 
-void WKTReader::ParseVertex(vector<double> &coords) {
-    double x, y, z, m;
-    x = ParseDouble();
-    y = ParseDouble();
-    if (has_z) {
-        z = ParseDouble();
-    }
-    if (has_m) {
-        m = ParseDouble();
-    }
-    coords.push_back(x);
-    coords.push_back(y);
+// Count the vertices in the list starting at the cursor, without moving the cursor.
+// Vertex lists don't nest, so this is just the number of separators before the closing paren.
+uint32_t WKTReader::CountVertices() {
+    uint32_t count = 1;
+    for (auto ptr = cursor; ptr < end && *ptr != ')'; ptr++) {
+        count += *ptr == ',';
+    }
+    return count;
+}
+
+// Parse a single vertex into coords, which must have room for all dimensions
+void WKTReader::ParseVertex(double *coords) {
+    coords[0] = ParseDouble();
+    coords[1] = ParseDouble();
     if (has_z) {
-        coords.push_back(z);
+        coords[2] = ParseDouble();
     }
     if (has_m) {
-        coords.push_back(m);
+        coords[2 + has_z] = ParseDouble();
     }
 }
 
@@ -113,16 +115,19 @@ VertexArray WKTReader::ParseVertices() {
         return VertexArray::Empty(has_z, has_m);
     }
     Expect('(');
-    vector<double> coords;
-    uint32_t count = 0;
-    ParseVertex(coords);
-    count++;
-    while (Match(',')) {
-        ParseVertex(coords);
-        count++;
+    // Parse straight into the vertex array instead of collecting the coordinates first
+    auto count = CountVertices();
+    auto vertices = VertexArray::Create(arena, count, has_z, has_m);
+    auto dims = vertices.GetProperties().Dimensions();
+    auto data = reinterpret_cast<double *>(vertices.GetData());
+    for (uint32_t i = 0; i < count; i++) {
+        ParseVertex(data + i * dims);
+        if (i + 1 < count && !Match(',')) {
+            break;
+        }
     }
     Expect(')');
-    return VertexArray::Copy(arena, data_ptr_cast(coords.data()), count, has_z, has_m);
+    return vertices;
 }
 
 Point WKTReader::ParsePoint() {
@@ -130,10 +135,10 @@ Point WKTReader::ParsePoint() {
         return Point(has_z, has_m);
     }
     Expect('(');
-    vector<double> coords;
+    double coords[4];
     ParseVertex(coords);
     Expect(')');
-    return Point(VertexArray::Copy(arena, data_ptr_cast(coords.data()), 1, has_z, has_m));
+    return Point(VertexArray::Copy(arena, data_ptr_cast(coords), 1, has_z, has_m));
 }
 
 LineString WKTReader::ParseLineString() {
@@ -164,32 +169,16 @@ MultiPoint WKTReader::ParseMultiPoint() {
     }
     // Multipoints are special in that parens around each point is optional.
     Expect('(');
-    vector<double> coords;
+    double coords[4];
     vector<Point> points;
-    bool optional_paren = false;
-
-    if (Match('(')) {
-        optional_paren = true;
-    }
-    ParseVertex(coords);
-    if (optional_paren) {
-        Expect(')');
-        optional_paren = false;
-    }
-    points.push_back(Point(VertexArray::Copy(arena, data_ptr_cast(coords.data()), 1, has_z, has_m)));
-    coords.clear();
-    while (Match(',')) {
-        if (Match('(')) {
-            optional_paren = true;
-        }
+    do {
+        bool optional_paren = Match('(');
         ParseVertex(coords);
         if (optional_paren) {
             Expect(')');
-            optional_paren = false;
         }
-        points.push_back(Point(VertexArray::Copy(arena, data_ptr_cast(coords.data()), 1, has_z, has_m)));
-        coords.clear();
-    }
+        points.push_back(Point(VertexArray::Copy(arena, data_ptr_cast(coords), 1, has_z, has_m)));
+    } while (Match(','));
     Expect(')');
     MultiPoint result(arena, points.size(), has_z, has_m);
     for (uint32_t i = 0; i < points.size(); i++) {
@@ -255,12 +244,12 @@ GeometryCollection WKTReader::ParseGeometryCollection() {
 void WKTReader::CheckZM() {
     bool geom_has_z = false;
     bool geom_has_m = false;
-    if (Match('Z')) {
+    if (Match('Z') || Match('z')) {
         geom_has_z = true;
-        if (Match('M')) {
+        if (Match('M') || Match('m')) {
             geom_has_m = true;
         }
-    } else if (Match('M')) {
+    } else if (Match('M') || Match('m')) {
         geom_has_m = true;
     }
 
@@ -320,9 +309,6 @@ Geometry WKTReader::ParseWKT() {
             cursor++;
         }
         Expect(';');
-        while (cursor < end && std::isspace(*cursor)) {
-            cursor++;
-        }
     }
     return ParseGeometry();
 }
@@ -334,6 +320,7 @@ Geometry WKTReader::Parse(const string_t &wkt) {
     zm_set = false;
     has_z = false;
     has_m = false;
+    SkipWhitespace();
     auto geom = ParseWKT();
     return geom;
 }
@@ -0,0 +1,331 @@
+#include "spatial/core/graph/routing_graph.hpp"
+
+#include "spatial/common.hpp"
+
+#include "duckdb/common/types/hash.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Build
+//------------------------------------------------------------------------------
+struct NodeKey {
+	double x;
+	double y;
+	bool operator==(const NodeKey &other) const {
+		return x == other.x && y == other.y;
+	}
+};
+
+struct NodeKeyHash {
+	size_t operator()(const NodeKey &key) const {
+		// -0.0 and 0.0 compare equal, so they must hash equal too
+		auto x = key.x == 0 ? 0.0 : key.x;
+		auto y = key.y == 0 ? 0.0 : key.y;
+		return CombineHash(Hash(x), Hash(y));
+	}
+};
+
+unique_ptr<RoutingGraph> RoutingGraph::Build(const vector<RoutingEdge> &edges, bool planar_weights) {
+	auto graph = make_uniq<RoutingGraph>();
+	graph->planar_weights = planar_weights;
+	graph->edge_count = edges.size();
+	if (edges.size() * 2 > NumericLimits<uint32_t>::Maximum()) {
+		throw InvalidInputException("ST_RoutingGraph_Agg: too many edges for a single routing graph");
+	}
+
+	// Number the distinct end points
+	unordered_map<NodeKey, uint32_t, NodeKeyHash> node_ids;
+	vector<uint32_t> edge_nodes(edges.size() * 2);
+	auto get_node = [&](double x, double y) {
+		auto entry = node_ids.emplace(NodeKey {x, y}, static_cast<uint32_t>(graph->node_x.size()));
+		if (entry.second) {
+			graph->node_x.push_back(x);
+			graph->node_y.push_back(y);
+		}
+		return entry.first->second;
+	};
+	for (idx_t i = 0; i < edges.size(); i++) {
+		edge_nodes[2 * i] = get_node(edges[i].x0, edges[i].y0);
+		edge_nodes[2 * i + 1] = get_node(edges[i].x1, edges[i].y1);
+	}
+	node_ids.clear();
+
+	// Count the edges of every node, loops lead nowhere and are left out
+	auto node_count = graph->NodeCount();
+	auto &offsets = graph->offsets;
+	offsets.assign(node_count + 1, 0);
+	for (idx_t i = 0; i < edges.size(); i++) {
+		auto from = edge_nodes[2 * i];
+		auto to = edge_nodes[2 * i + 1];
+		if (from != to) {
+			offsets[from + 1]++;
+			offsets[to + 1]++;
+		}
+	}
+	for (idx_t i = 0; i < node_count; i++) {
+		offsets[i + 1] += offsets[i];
+	}
+
+	// Place the edges, in both directions
+	graph->targets.resize(offsets[node_count]);
+	graph->weights.resize(offsets[node_count]);
+	vector<uint32_t> positions(offsets.begin(), offsets.end() - 1);
+	for (idx_t i = 0; i < edges.size(); i++) {
+		auto from = edge_nodes[2 * i];
+		auto to = edge_nodes[2 * i + 1];
+		if (from == to) {
+			continue;
+		}
+		auto weight = edges[i].weight;
+		graph->targets[positions[from]] = to;
+		graph->weights[positions[from]++] = weight;
+		graph->targets[positions[to]] = from;
+		graph->weights[positions[to]++] = weight;
+	}
+
+	graph->BuildGrid();
+	return graph;
+}
+
+//------------------------------------------------------------------------------
+// Nearest Node
+//------------------------------------------------------------------------------
+// Around four nodes per cell, in square cells over the extent of the nodes
+void RoutingGraph::BuildGrid() {
+	auto node_count = NodeCount();
+	if (node_count == 0) {
+		return;
+	}
+	auto min_x = node_x[0];
+	auto min_y = node_y[0];
+	auto max_x = node_x[0];
+	auto max_y = node_y[0];
+	for (idx_t i = 1; i < node_count; i++) {
+		min_x = std::min(min_x, node_x[i]);
+		min_y = std::min(min_y, node_y[i]);
+		max_x = std::max(max_x, node_x[i]);
+		max_y = std::max(max_y, node_y[i]);
+	}
+	auto width = max_x - min_x;
+	auto height = max_y - min_y;
+	auto cell_count = std::max<double>(1, static_cast<double>(node_count) / 4);
+	// A long and thin extent (e.g. all nodes on one line) gets cells along its long side only, so that there are
+	// never many more cells than nodes
+	auto cell_size = std::max(std::sqrt(width * height / cell_count), std::max(width, height) / cell_count);
+	if (!(cell_size > 0)) {
+		cell_size = 1;
+	}
+
+	grid_min_x = min_x;
+	grid_min_y = min_y;
+	grid_cell_size = cell_size;
+	grid_width = static_cast<idx_t>(width / cell_size) + 1;
+	grid_height = static_cast<idx_t>(height / cell_size) + 1;
+
+	// Bucket the nodes by cell
+	vector<uint32_t> node_cells(node_count);
+	grid_offsets.assign(grid_width * grid_height + 1, 0);
+	for (idx_t i = 0; i < node_count; i++) {
+		auto cx = std::min(static_cast<idx_t>((node_x[i] - min_x) / cell_size), grid_width - 1);
+		auto cy = std::min(static_cast<idx_t>((node_y[i] - min_y) / cell_size), grid_height - 1);
+		node_cells[i] = static_cast<uint32_t>(cy * grid_width + cx);
+		grid_offsets[node_cells[i] + 1]++;
+	}
+	for (idx_t i = 0; i < grid_width * grid_height; i++) {
+		grid_offsets[i + 1] += grid_offsets[i];
+	}
+	grid_nodes.resize(node_count);
+	vector<uint32_t> positions(grid_offsets.begin(), grid_offsets.end() - 1);
+	for (idx_t i = 0; i < node_count; i++) {
+		grid_nodes[positions[node_cells[i]]++] = static_cast<uint32_t>(i);
+	}
+}
+
+// Search the cells in rings around the cell of the point, until the closest node found is closer than anything
+// outside of the rings searched so far
+idx_t RoutingGraph::FindNearestNode(double x, double y) const {
+	if (NodeCount() == 0) {
+		return DConstants::INVALID_INDEX;
+	}
+	auto to_cell = [&](double value, double min, idx_t size) {
+		auto cell = std::floor((value - min) / grid_cell_size);
+		if (!(cell >= 0)) {
+			return static_cast<int64_t>(0);
+		}
+		return std::min(static_cast<int64_t>(cell), static_cast<int64_t>(size) - 1);
+	};
+	auto cx = to_cell(x, grid_min_x, grid_width);
+	auto cy = to_cell(y, grid_min_y, grid_height);
+	auto max_ring = static_cast<int64_t>(std::max(grid_width, grid_height));
+
+	auto best = DConstants::INVALID_INDEX;
+	auto best_distance = std::numeric_limits<double>::infinity();
+	auto visit_cell = [&](int64_t gx, int64_t gy) {
+		if (gx < 0 || gy < 0 || gx >= static_cast<int64_t>(grid_width) || gy >= static_cast<int64_t>(grid_height)) {
+			return;
+		}
+		auto cell = static_cast<idx_t>(gy) * grid_width + static_cast<idx_t>(gx);
+		for (auto i = grid_offsets[cell]; i < grid_offsets[cell + 1]; i++) {
+			auto node = grid_nodes[i];
+			auto dx = node_x[node] - x;
+			auto dy = node_y[node] - y;
+			auto distance = dx * dx + dy * dy;
+			if (distance < best_distance || (distance == best_distance && node < best)) {
+				best_distance = distance;
+				best = node;
+			}
+		}
+	};
+
+	for (int64_t ring = 0; ring <= max_ring; ring++) {
+		if (ring == 0) {
+			visit_cell(cx, cy);
+		} else {
+			for (auto gx = cx - ring; gx <= cx + ring; gx++) {
+				visit_cell(gx, cy - ring);
+				visit_cell(gx, cy + ring);
+			}
+			for (auto gy = cy - ring + 1; gy <= cy + ring - 1; gy++) {
+				visit_cell(cx - ring, gy);
+				visit_cell(cx + ring, gy);
+			}
+		}
+		if (best == DConstants::INVALID_INDEX) {
+			continue;
+		}
+		// The distance from the point to the outside of the searched square, zero if the point is outside of it
+		auto min_x = grid_min_x + static_cast<double>(cx - ring) * grid_cell_size;
+		auto min_y = grid_min_y + static_cast<double>(cy - ring) * grid_cell_size;
+		auto max_x = grid_min_x + static_cast<double>(cx + ring + 1) * grid_cell_size;
+		auto max_y = grid_min_y + static_cast<double>(cy + ring + 1) * grid_cell_size;
+		auto margin = std::min({x - min_x, y - min_y, max_x - x, max_y - y});
+		if (margin > 0 && best_distance < margin * margin) {
+			break;
+		}
+	}
+	return best;
+}
+
+//------------------------------------------------------------------------------
+// Search
+//------------------------------------------------------------------------------
+RoutingSearch::RoutingSearch(const RoutingGraph &graph)
+    : graph(graph), distance(graph.NodeCount(), std::numeric_limits<double>::infinity()),
+      target_mark(graph.NodeCount(), 0) {
+}
+
+void RoutingSearch::SetDistance(uint32_t node, double value) {
+	if (distance[node] == std::numeric_limits<double>::infinity()) {
+		touched.push_back(node);
+	}
+	distance[node] = value;
+}
+
+void RoutingSearch::Reset() {
+	for (auto node : touched) {
+		distance[node] = std::numeric_limits<double>::infinity();
+	}
+	touched.clear();
+	queue.clear();
+}
+
+void RoutingSearch::OneToMany(uint32_t source, const vector<uint32_t> &target_nodes, vector<double> &distances) {
+	if (++generation == 0) {
+		std::fill(target_mark.begin(), target_mark.end(), 0);
+		generation = 1;
+	}
+	idx_t remaining = 0;
+	for (auto target : target_nodes) {
+		if (target_mark[target] != generation) {
+			target_mark[target] = generation;
+			remaining++;
+		}
+	}
+
+	auto compare = std::greater<QueueEntry>();
+	SetDistance(source, 0);
+	queue.emplace_back(0, source);
+	while (!queue.empty() && remaining > 0) {
+		std::pop_heap(queue.begin(), queue.end(), compare);
+		auto entry = queue.back();
+		queue.pop_back();
+		auto node = entry.second;
+		if (entry.first > distance[node]) {
+			// Already settled through a shorter path
+			continue;
+		}
+		if (target_mark[node] == generation) {
+			remaining--;
+		}
+		for (auto i = graph.offsets[node]; i < graph.offsets[node + 1]; i++) {
+			auto next = graph.targets[i];
+			auto next_distance = entry.first + graph.weights[i];
+			if (next_distance < distance[next]) {
+				SetDistance(next, next_distance);
+				queue.emplace_back(next_distance, next);
+				std::push_heap(queue.begin(), queue.end(), compare);
+			}
+		}
+	}
+
+	distances.resize(target_nodes.size());
+	for (idx_t i = 0; i < target_nodes.size(); i++) {
+		distances[i] = distance[target_nodes[i]];
+	}
+	Reset();
+}
+
+double RoutingSearch::OneToOne(uint32_t source, uint32_t target) {
+	if (!graph.planar_weights) {
+		vector<double> distances;
+		OneToMany(source, {target}, distances);
+		return distances[0];
+	}
+
+	auto target_x = graph.node_x[target];
+	auto target_y = graph.node_y[target];
+	auto heuristic = [&](uint32_t node) {
+		auto dx = graph.node_x[node] - target_x;
+		auto dy = graph.node_y[node] - target_y;
+		return std::sqrt(dx * dx + dy * dy);
+	};
+
+	// The queue is ordered by the distance so far plus the heuristic, which is consistent for planar weights, so a
+	// node is final once it is popped
+	auto compare = std::greater<QueueEntry>();
+	auto result = std::numeric_limits<double>::infinity();
+	SetDistance(source, 0);
+	queue.emplace_back(heuristic(source), source);
+	while (!queue.empty()) {
+		std::pop_heap(queue.begin(), queue.end(), compare);
+		auto entry = queue.back();
+		queue.pop_back();
+		auto node = entry.second;
+		auto node_distance = distance[node];
+		if (entry.first > node_distance + heuristic(node)) {
+			continue;
+		}
+		if (node == target) {
+			result = node_distance;
+			break;
+		}
+		for (auto i = graph.offsets[node]; i < graph.offsets[node + 1]; i++) {
+			auto next = graph.targets[i];
+			auto next_distance = node_distance + graph.weights[i];
+			if (next_distance < distance[next]) {
+				SetDistance(next, next_distance);
+				queue.emplace_back(next_distance + heuristic(next), next);
+				std::push_heap(queue.begin(), queue.end(), compare);
+			}
+		}
+	}
+	Reset();
+	return result;
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,85 @@
+#include "spatial/core/index/flat_rtree.hpp"
+
+#include "spatial/common.hpp"
+
+#include <cmath>
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Sort-Tile-Recursive packing
+//------------------------------------------------------------------------------
+// Sort the entries by the x coordinate of their center, cut them into
+// sqrt(P) vertical slices (where P is the number of parent nodes) and then
+// sort each slice by the y coordinate of the center. Consecutive runs of
+// NODE_SIZE entries in the resulting order become the children of one node.
+void FlatRTree::SortTileRecursive(idx_t begin, idx_t end) {
+	auto count = end - begin;
+	if (count <= NODE_SIZE) {
+		return;
+	}
+
+	auto node_count = (count + NODE_SIZE - 1) / NODE_SIZE;
+	auto slice_count = static_cast<idx_t>(std::ceil(std::sqrt(static_cast<double>(node_count))));
+	auto slice_size = slice_count * NODE_SIZE;
+
+	auto entries_begin = entries.begin() + static_cast<int64_t>(begin);
+	auto entries_end = entries.begin() + static_cast<int64_t>(end);
+
+	std::sort(entries_begin, entries_end,
+	          [](const Entry &a, const Entry &b) { return a.box.CenterX() < b.box.CenterX(); });
+
+	for (idx_t slice_begin = begin; slice_begin < end; slice_begin += slice_size) {
+		auto slice_end = std::min(slice_begin + slice_size, end);
+		std::sort(entries.begin() + static_cast<int64_t>(slice_begin),
+		          entries.begin() + static_cast<int64_t>(slice_end),
+		          [](const Entry &a, const Entry &b) { return a.box.CenterY() < b.box.CenterY(); });
+	}
+}
+
+void FlatRTree::Build() {
+	D_ASSERT(!is_built);
+	is_built = true;
+	item_count = entries.size();
+	level_bounds.clear();
+
+	if (item_count == 0) {
+		return;
+	}
+
+	// Reserve space for all the levels up front (the level sizes form a geometric series)
+	idx_t total = item_count;
+	for (idx_t level_size = item_count; level_size > 1;) {
+		level_size = (level_size + NODE_SIZE - 1) / NODE_SIZE;
+		total += level_size;
+	}
+	entries.reserve(total + 1);
+
+	idx_t level_begin = 0;
+	idx_t level_end = item_count;
+	level_bounds.push_back(level_end);
+
+	// Always create at least one internal node so that the root is never a leaf entry
+	do {
+		SortTileRecursive(level_begin, level_end);
+
+		for (idx_t child = level_begin; child < level_end; child += NODE_SIZE) {
+			auto child_end = std::min(child + NODE_SIZE, level_end);
+			RTreeBox node_box;
+			for (auto i = child; i < child_end; i++) {
+				node_box.Union(entries[i].box);
+			}
+			entries.push_back(Entry {node_box, child});
+		}
+
+		level_begin = level_end;
+		level_end = entries.size();
+		level_bounds.push_back(level_end);
+	} while (level_end - level_begin > 1);
+}
+
+} // namespace core
+
+} // namespace spatial
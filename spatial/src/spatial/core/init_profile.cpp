@@ -0,0 +1,40 @@
+#include "spatial/common.hpp"
+#include "spatial/core/init_profile.hpp"
+
+#include <mutex>
+
+namespace spatial {
+
+namespace core {
+
+static std::mutex &GetProfileLock() {
+	static std::mutex lock;
+	return lock;
+}
+
+static vector<InitProfile::Entry> &GetProfileEntries() {
+	static vector<InitProfile::Entry> entries;
+	return entries;
+}
+
+void InitProfile::Record(const string &module, const string &phase, double elapsed_ms) {
+	std::lock_guard<std::mutex> guard(GetProfileLock());
+	auto &entries = GetProfileEntries();
+	// The extension can be loaded into several database instances, only keep the latest timing of each phase
+	for (auto &entry : entries) {
+		if (entry.module == module && entry.phase == phase) {
+			entry.elapsed_ms = elapsed_ms;
+			return;
+		}
+	}
+	entries.push_back({module, phase, elapsed_ms});
+}
+
+vector<InitProfile::Entry> InitProfile::GetEntries() {
+	std::lock_guard<std::mutex> guard(GetProfileLock());
+	return GetProfileEntries();
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,180 @@
+#include "spatial/core/io/async_reader.hpp"
+
+#include "duckdb/main/client_context.hpp"
+
+#include <functional>
+#include <thread>
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// I/O thread pool
+//------------------------------------------------------------------------------
+// The threads only block in reads, so there can be more of them than cores, but not unboundedly many
+static constexpr idx_t MAX_IO_THREADS = 64;
+
+class IOThreadPool {
+public:
+	static IOThreadPool &Get() {
+		// Never destroyed, so that exiting the process does not wait for (or on Windows, deadlock on) the threads
+		static auto pool = new IOThreadPool();
+		return *pool;
+	}
+
+	// Run a task that does not throw, with at least thread_count threads in the pool
+	void Schedule(std::function<void()> task, idx_t thread_count) {
+		lock_guard<mutex> guard(lock);
+		tasks.push_back(std::move(task));
+		thread_count = MinValue(thread_count, MAX_IO_THREADS);
+		while (threads < thread_count) {
+			std::thread(&IOThreadPool::Work, this).detach();
+			threads++;
+		}
+		work.notify_one();
+	}
+
+private:
+	mutex lock;
+	std::condition_variable work;
+	std::deque<std::function<void()>> tasks;
+	idx_t threads = 0;
+
+	void Work() {
+		while (true) {
+			unique_lock<mutex> guard(lock);
+			work.wait(guard, [&]() { return !tasks.empty(); });
+			auto task = std::move(tasks.front());
+			tasks.pop_front();
+			guard.unlock();
+			task();
+		}
+	}
+};
+
+//------------------------------------------------------------------------------
+// AsyncReader
+//------------------------------------------------------------------------------
+AsyncReader::AsyncReader(FileHandle &handle, idx_t queue_depth)
+    : state(make_shared<State>(handle.file_system, handle.path)), queue_depth(MaxValue<idx_t>(queue_depth, 1)) {
+}
+
+AsyncReader::~AsyncReader() {
+	unique_lock<mutex> guard(state->lock);
+	state->done.wait(guard, [&]() { return state->in_flight == 0; });
+}
+
+idx_t AsyncReader::GetQueueDepth(ClientContext &context) {
+	Value queue_depth;
+	if (context.TryGetCurrentSetting("spatial_io_queue_depth", queue_depth) && !queue_depth.IsNull()) {
+		return static_cast<idx_t>(MaxValue<int64_t>(queue_depth.GetValue<int64_t>(), 0));
+	}
+	return DEFAULT_QUEUE_DEPTH;
+}
+
+void AsyncReader::Execute(State &state, Request &request) {
+	unique_ptr<FileHandle> handle;
+	{
+		lock_guard<mutex> guard(state.lock);
+		if (!state.idle_handles.empty()) {
+			handle = std::move(state.idle_handles.back());
+			state.idle_handles.pop_back();
+		}
+	}
+	std::exception_ptr error;
+	try {
+		if (!handle) {
+			handle = state.fs.OpenFile(state.path, FileFlags::FILE_FLAGS_READ);
+		}
+		handle->Read(request.data.get(), request.size, request.offset);
+	} catch (...) {
+		error = std::current_exception();
+	}
+
+	lock_guard<mutex> guard(state.lock);
+	if (handle && !error) {
+		state.idle_handles.push_back(std::move(handle));
+	}
+	request.error = error;
+	request.done = true;
+	state.in_flight--;
+	state.done.notify_all();
+}
+
+shared_ptr<AsyncReader::Request> AsyncReader::Submit(idx_t offset, idx_t size) {
+	auto request = make_shared<Request>(offset, size);
+	{
+		lock_guard<mutex> guard(state->lock);
+		state->in_flight++;
+	}
+	auto task_state = state;
+	IOThreadPool::Get().Schedule([task_state, request]() { Execute(*task_state, *request); }, queue_depth);
+	return request;
+}
+
+void AsyncReader::Wait(Request &request) {
+	unique_lock<mutex> guard(state->lock);
+	state->done.wait(guard, [&]() { return request.done; });
+	if (request.error) {
+		std::rethrow_exception(request.error);
+	}
+}
+
+//------------------------------------------------------------------------------
+// ReadAheadBuffer
+//------------------------------------------------------------------------------
+ReadAheadBuffer::ReadAheadBuffer(FileHandle &handle, idx_t block_size, idx_t queue_depth)
+    : handle(handle), reader(handle, queue_depth), file_size(handle.GetFileSize()), block_size(block_size) {
+}
+
+void ReadAheadBuffer::SubmitBlocks(idx_t offset) {
+	auto next = blocks.empty() ? offset : blocks.back()->offset + blocks.back()->size;
+	while (blocks.size() < reader.QueueDepth() && next < file_size) {
+		auto size = MinValue(block_size, file_size - next);
+		blocks.push_back(reader.Submit(next, size));
+		next += size;
+	}
+}
+
+idx_t ReadAheadBuffer::Read(data_ptr_t buffer, idx_t size, idx_t offset) {
+	if (offset >= file_size) {
+		return 0;
+	}
+	size = MinValue(size, file_size - offset);
+	auto sequential = offset == next_offset;
+	next_offset = offset + size;
+
+	// The blocks before the offset are not needed anymore
+	while (!blocks.empty() && blocks.front()->offset + blocks.front()->size <= offset) {
+		blocks.pop_front();
+	}
+	if (blocks.empty() || offset < blocks.front()->offset) {
+		blocks.clear();
+		if (!sequential) {
+			handle.Read(buffer, size, offset);
+			return size;
+		}
+	}
+
+	idx_t read_bytes = 0;
+	while (read_bytes < size) {
+		auto position = offset + read_bytes;
+		SubmitBlocks(position);
+		auto &block = *blocks.front();
+		reader.Wait(block);
+		auto copy_bytes = MinValue(size - read_bytes, block.offset + block.size - position);
+		memcpy(buffer + read_bytes, block.data.get() + (position - block.offset), copy_bytes);
+		read_bytes += copy_bytes;
+		if (position + copy_bytes == block.offset + block.size) {
+			blocks.pop_front();
+		}
+	}
+	// Keep the queue full while the reader decodes what it got
+	SubmitBlocks(next_offset);
+	return size;
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,1141 @@
+#include "duckdb/parser/parsed_data/create_table_function_info.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckdb/planner/operator/logical_get.hpp"
+#include "duckdb/common/case_insensitive_map.hpp"
+#include "duckdb/common/mutex.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/functions/table.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/io/mapped_file.hpp"
+
+#include "utf8proc_wrapper.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// FlatBuffers
+//------------------------------------------------------------------------------
+// Just enough of the FlatBuffers wire format to read the header and the features of a FlatGeobuf file in place.
+// Every offset is checked against the size of the buffer, so a corrupt file raises an error instead of reading out
+// of bounds.
+
+struct FlatBufferVector {
+	const_data_ptr_t data = nullptr;
+	uint32_t length = 0;
+};
+
+class FlatBufferTable {
+private:
+	const_data_ptr_t buffer = nullptr;
+	idx_t size = 0;
+	idx_t table = 0;
+	idx_t vtable = 0;
+	uint16_t vtable_size = 0;
+
+	void CheckBounds(idx_t pos, idx_t len) const {
+		if (pos > size || len > size - pos) {
+			throw InvalidInputException("Invalid FlatGeobuf file: offset out of bounds");
+		}
+	}
+
+	uint16_t GetFieldOffset(idx_t field) const {
+		auto entry = 4 + field * sizeof(uint16_t);
+		if (entry + sizeof(uint16_t) > vtable_size) {
+			return 0;
+		}
+		return Load<uint16_t>(buffer + vtable + entry);
+	}
+
+	// Follow the offset stored in a field to the vector, string or table it refers to
+	bool TryGetReference(idx_t field, idx_t &pos) const {
+		auto offset = GetFieldOffset(field);
+		if (offset == 0) {
+			return false;
+		}
+		CheckBounds(table + offset, sizeof(uint32_t));
+		pos = table + offset + Load<uint32_t>(buffer + table + offset);
+		return true;
+	}
+
+public:
+	FlatBufferTable() = default;
+
+	FlatBufferTable(const_data_ptr_t buffer_p, idx_t size_p, idx_t table_p)
+	    : buffer(buffer_p), size(size_p), table(table_p) {
+		CheckBounds(table, sizeof(int32_t));
+		auto vtable_pos = static_cast<int64_t>(table) - Load<int32_t>(buffer + table);
+		if (vtable_pos < 0) {
+			throw InvalidInputException("Invalid FlatGeobuf file: offset out of bounds");
+		}
+		vtable = static_cast<idx_t>(vtable_pos);
+		CheckBounds(vtable, 2 * sizeof(uint16_t));
+		vtable_size = Load<uint16_t>(buffer + vtable);
+		CheckBounds(vtable, vtable_size);
+	}
+
+	static FlatBufferTable GetRoot(const_data_ptr_t buffer, idx_t size) {
+		if (size < sizeof(uint32_t)) {
+			throw InvalidInputException("Invalid FlatGeobuf file: offset out of bounds");
+		}
+		return FlatBufferTable(buffer, size, Load<uint32_t>(buffer));
+	}
+
+	template <class T>
+	T GetScalar(idx_t field, T default_value) const {
+		auto offset = GetFieldOffset(field);
+		if (offset == 0) {
+			return default_value;
+		}
+		CheckBounds(table + offset, sizeof(T));
+		return Load<T>(buffer + table + offset);
+	}
+
+	// A vector of scalars, strings are vectors of bytes. Vectors of tables hold a uint32_t offset per element.
+	FlatBufferVector GetVector(idx_t field, idx_t element_size) const {
+		FlatBufferVector result;
+		idx_t pos;
+		if (!TryGetReference(field, pos)) {
+			return result;
+		}
+		CheckBounds(pos, sizeof(uint32_t));
+		result.length = Load<uint32_t>(buffer + pos);
+		CheckBounds(pos + sizeof(uint32_t), result.length * element_size);
+		result.data = buffer + pos + sizeof(uint32_t);
+		return result;
+	}
+
+	string GetString(idx_t field) const {
+		auto vector = GetVector(field, sizeof(char));
+		return string(const_char_ptr_cast(vector.data), vector.length);
+	}
+
+	bool TryGetTable(idx_t field, FlatBufferTable &result) const {
+		idx_t pos;
+		if (!TryGetReference(field, pos)) {
+			return false;
+		}
+		result = FlatBufferTable(buffer, size, pos);
+		return true;
+	}
+
+	FlatBufferTable GetTable(const FlatBufferVector &tables, uint32_t idx) const {
+		D_ASSERT(idx < tables.length);
+		auto pos = static_cast<idx_t>(tables.data - buffer) + idx * sizeof(uint32_t);
+		return FlatBufferTable(buffer, size, pos + Load<uint32_t>(buffer + pos));
+	}
+};
+
+//------------------------------------------------------------------------------
+// FlatGeobuf format
+//------------------------------------------------------------------------------
+// A FlatGeobuf file consists of the magic bytes, a size prefixed header, an optional packed Hilbert R-tree over the
+// bounding boxes of the features and then the size prefixed features themselves, sorted in the order of the index.
+
+static constexpr const data_t FLATGEOBUF_MAGIC[] = {'f', 'g', 'b', 3, 'f', 'g', 'b'};
+static constexpr idx_t FLATGEOBUF_HEADER_OFFSET = 8 + sizeof(uint32_t);
+static constexpr idx_t FLATGEOBUF_NODE_SIZE = 4 * sizeof(double) + sizeof(uint64_t);
+static constexpr uint16_t FLATGEOBUF_DEFAULT_INDEX_NODE_SIZE = 16;
+
+enum class FlatGeobufGeometryType : uint8_t {
+	UNKNOWN = 0,
+	POINT = 1,
+	LINESTRING = 2,
+	POLYGON = 3,
+	MULTIPOINT = 4,
+	MULTILINESTRING = 5,
+	MULTIPOLYGON = 6,
+	GEOMETRYCOLLECTION = 7
+};
+
+enum class FlatGeobufColumnType : uint8_t {
+	BYTE = 0,
+	UBYTE = 1,
+	BOOL = 2,
+	SHORT = 3,
+	USHORT = 4,
+	INT = 5,
+	UINT = 6,
+	LONG = 7,
+	ULONG = 8,
+	FLOAT = 9,
+	DOUBLE = 10,
+	STRING = 11,
+	JSON = 12,
+	DATETIME = 13,
+	BINARY = 14
+};
+
+// Field numbers of the tables in header.fbs and feature.fbs
+struct FlatGeobufHeaderField {
+	static constexpr idx_t GEOMETRY_TYPE = 2;
+	static constexpr idx_t HAS_Z = 3;
+	static constexpr idx_t HAS_M = 4;
+	static constexpr idx_t COLUMNS = 7;
+	static constexpr idx_t FEATURES_COUNT = 8;
+	static constexpr idx_t INDEX_NODE_SIZE = 9;
+};
+
+struct FlatGeobufColumnField {
+	static constexpr idx_t NAME = 0;
+	static constexpr idx_t TYPE = 1;
+};
+
+struct FlatGeobufFeatureField {
+	static constexpr idx_t GEOMETRY = 0;
+	static constexpr idx_t PROPERTIES = 1;
+};
+
+struct FlatGeobufGeometryField {
+	static constexpr idx_t ENDS = 0;
+	static constexpr idx_t XY = 1;
+	static constexpr idx_t Z = 2;
+	static constexpr idx_t M = 3;
+	static constexpr idx_t TYPE = 6;
+	static constexpr idx_t PARTS = 7;
+};
+
+// The start and end node of every level of the packed R-tree, from the leaves up to the root. The levels are stored
+// from the root down, so the root is the first node and the leaves are the last ones.
+static vector<pair<idx_t, idx_t>> GetLevelBounds(idx_t item_count, idx_t node_size) {
+	vector<idx_t> level_sizes;
+	auto level_size = item_count;
+	auto node_count = level_size;
+	level_sizes.push_back(level_size);
+	do {
+		level_size = (level_size + node_size - 1) / node_size;
+		node_count += level_size;
+		level_sizes.push_back(level_size);
+	} while (level_size != 1);
+
+	vector<pair<idx_t, idx_t>> result;
+	auto level_end = node_count;
+	for (auto size : level_sizes) {
+		result.emplace_back(level_end - size, level_end);
+		level_end -= size;
+	}
+	return result;
+}
+
+//------------------------------------------------------------------------------
+// Bind
+//------------------------------------------------------------------------------
+
+struct FlatGeobufBindData : TableFunctionData {
+	string file_name;
+	FlatGeobufGeometryType geometry_type = FlatGeobufGeometryType::UNKNOWN;
+	bool has_z = false;
+	bool has_m = false;
+	uint64_t feature_count = 0;
+	uint16_t index_node_size = 0;
+	vector<FlatGeobufColumnType> column_types;
+
+	// Where the index and the features start in the file
+	idx_t index_offset = 0;
+	idx_t features_offset = 0;
+
+	// Only read features whose bounding box intersects this box
+	bool has_spatial_filter = false;
+	BoundingBox spatial_filter;
+
+	explicit FlatGeobufBindData(string file_name_p) : file_name(std::move(file_name_p)) {
+	}
+
+	bool HasIndex() const {
+		return index_node_size > 0 && feature_count > 0;
+	}
+
+	// The geometry is always the last column
+	idx_t GeometryColumnIndex() const {
+		return column_types.size();
+	}
+
+	void AddSpatialFilter(const BoundingBox &bbox) {
+		if (!has_spatial_filter) {
+			has_spatial_filter = true;
+			spatial_filter = bbox;
+			return;
+		}
+		spatial_filter.minx = MaxValue(spatial_filter.minx, bbox.minx);
+		spatial_filter.miny = MaxValue(spatial_filter.miny, bbox.miny);
+		spatial_filter.maxx = MinValue(spatial_filter.maxx, bbox.maxx);
+		spatial_filter.maxy = MinValue(spatial_filter.maxy, bbox.maxy);
+	}
+};
+
+static LogicalType GetColumnLogicalType(FlatGeobufColumnType type) {
+	switch (type) {
+	case FlatGeobufColumnType::BYTE:
+		return LogicalType::TINYINT;
+	case FlatGeobufColumnType::UBYTE:
+		return LogicalType::UTINYINT;
+	case FlatGeobufColumnType::BOOL:
+		return LogicalType::BOOLEAN;
+	case FlatGeobufColumnType::SHORT:
+		return LogicalType::SMALLINT;
+	case FlatGeobufColumnType::USHORT:
+		return LogicalType::USMALLINT;
+	case FlatGeobufColumnType::INT:
+		return LogicalType::INTEGER;
+	case FlatGeobufColumnType::UINT:
+		return LogicalType::UINTEGER;
+	case FlatGeobufColumnType::LONG:
+		return LogicalType::BIGINT;
+	case FlatGeobufColumnType::ULONG:
+		return LogicalType::UBIGINT;
+	case FlatGeobufColumnType::FLOAT:
+		return LogicalType::FLOAT;
+	case FlatGeobufColumnType::DOUBLE:
+		return LogicalType::DOUBLE;
+	case FlatGeobufColumnType::STRING:
+	case FlatGeobufColumnType::JSON:
+		return LogicalType::VARCHAR;
+	case FlatGeobufColumnType::DATETIME:
+		return LogicalType::TIMESTAMP;
+	case FlatGeobufColumnType::BINARY:
+		return LogicalType::BLOB;
+	default:
+		throw InvalidInputException("FlatGeobuf column type %d not supported", static_cast<int>(type));
+	}
+}
+
+static unique_ptr<FunctionData> Bind(ClientContext &context, TableFunctionBindInput &input,
+                                     vector<LogicalType> &return_types, vector<string> &names) {
+
+	auto file_name = StringValue::Get(input.inputs[0]);
+	auto result = make_uniq<FlatGeobufBindData>(file_name);
+
+	auto &fs = FileSystem::GetFileSystem(context);
+	auto handle = fs.OpenFile(file_name, FileFlags::FILE_FLAGS_READ);
+	auto file_size = handle->GetFileSize();
+
+	// The magic bytes end with the patch version, which we don't care about
+	data_t prefix[FLATGEOBUF_HEADER_OFFSET];
+	if (file_size < FLATGEOBUF_HEADER_OFFSET) {
+		throw InvalidInputException("File '%s' is not a FlatGeobuf file", file_name);
+	}
+	handle->Read(prefix, FLATGEOBUF_HEADER_OFFSET, 0);
+	if (memcmp(prefix, FLATGEOBUF_MAGIC, sizeof(FLATGEOBUF_MAGIC)) != 0) {
+		throw InvalidInputException("File '%s' is not a FlatGeobuf file", file_name);
+	}
+
+	auto header_size = Load<uint32_t>(prefix + 8);
+	if (header_size > file_size - FLATGEOBUF_HEADER_OFFSET) {
+		throw InvalidInputException("Invalid FlatGeobuf file '%s': header is truncated", file_name);
+	}
+	vector<data_t> header_buffer(header_size);
+	handle->Read(header_buffer.data(), header_size, FLATGEOBUF_HEADER_OFFSET);
+	auto header = FlatBufferTable::GetRoot(header_buffer.data(), header_size);
+
+	auto geometry_type = header.GetScalar<uint8_t>(FlatGeobufHeaderField::GEOMETRY_TYPE, 0);
+	if (geometry_type > static_cast<uint8_t>(FlatGeobufGeometryType::GEOMETRYCOLLECTION)) {
+		throw InvalidInputException("FlatGeobuf geometry type %d not supported", geometry_type);
+	}
+	result->geometry_type = static_cast<FlatGeobufGeometryType>(geometry_type);
+	result->has_z = header.GetScalar<uint8_t>(FlatGeobufHeaderField::HAS_Z, 0) != 0;
+	result->has_m = header.GetScalar<uint8_t>(FlatGeobufHeaderField::HAS_M, 0) != 0;
+	result->feature_count = header.GetScalar<uint64_t>(FlatGeobufHeaderField::FEATURES_COUNT, 0);
+	result->index_node_size =
+	    header.GetScalar<uint16_t>(FlatGeobufHeaderField::INDEX_NODE_SIZE, FLATGEOBUF_DEFAULT_INDEX_NODE_SIZE);
+
+	result->index_offset = FLATGEOBUF_HEADER_OFFSET + header_size;
+	result->features_offset = result->index_offset;
+	if (result->HasIndex()) {
+		if (result->index_node_size < 2) {
+			throw InvalidInputException("Invalid FlatGeobuf file '%s': index node size must be at least 2", file_name);
+		}
+		// Every feature has a leaf node, so there can't be more features than bytes in the file
+		if (result->feature_count > file_size) {
+			throw InvalidInputException("Invalid FlatGeobuf file '%s': index is truncated", file_name);
+		}
+		auto node_count = GetLevelBounds(result->feature_count, result->index_node_size).front().second;
+		auto index_size = node_count * FLATGEOBUF_NODE_SIZE;
+		if (index_size > file_size - result->index_offset) {
+			throw InvalidInputException("Invalid FlatGeobuf file '%s': index is truncated", file_name);
+		}
+		result->features_offset += index_size;
+	}
+
+	auto columns = header.GetVector(FlatGeobufHeaderField::COLUMNS, sizeof(uint32_t));
+	for (uint32_t i = 0; i < columns.length; i++) {
+		auto column = header.GetTable(columns, i);
+		auto column_type = column.GetScalar<uint8_t>(FlatGeobufColumnField::TYPE, 0);
+		if (column_type > static_cast<uint8_t>(FlatGeobufColumnType::BINARY)) {
+			throw InvalidInputException("FlatGeobuf column type %d not supported", column_type);
+		}
+		result->column_types.push_back(static_cast<FlatGeobufColumnType>(column_type));
+		return_types.push_back(GetColumnLogicalType(result->column_types.back()));
+		names.push_back(column.GetString(FlatGeobufColumnField::NAME));
+	}
+
+	// Always return geometry last
+	return_types.push_back(GeoTypes::GEOMETRY());
+	names.push_back("geom");
+
+	// Deduplicate field names if necessary
+	for (size_t i = 0; i < names.size(); i++) {
+		idx_t count = 1;
+		for (size_t j = i + 1; j < names.size(); j++) {
+			if (names[i] == names[j]) {
+				names[j] += "_" + std::to_string(count++);
+			}
+		}
+	}
+
+	for (auto &kv : input.named_parameters) {
+		if (kv.first == "spatial_filter_box") {
+			auto &children = StructValue::GetChildren(kv.second);
+			BoundingBox bbox;
+			bbox.minx = DoubleValue::Get(children[0]);
+			bbox.miny = DoubleValue::Get(children[1]);
+			bbox.maxx = DoubleValue::Get(children[2]);
+			bbox.maxy = DoubleValue::Get(children[3]);
+			result->AddSpatialFilter(bbox);
+		}
+	}
+
+	return std::move(result);
+}
+
+//------------------------------------------------------------------------------
+// Spatial Filter Pushdown
+//------------------------------------------------------------------------------
+// All spatial predicates (except st_disjoint) imply that the bounding boxes intersect, so a predicate against a
+// constant geometry narrows down the nodes of the index that need to be visited. The predicate itself is kept in the
+// plan and evaluated on the features that are read.
+
+static bool TryGetConstantBoundingBox(ClientContext &context, const Expression &expr, BoundingBox &bbox) {
+	if (!expr.IsFoldable() || expr.return_type != GeoTypes::GEOMETRY()) {
+		return false;
+	}
+	Value value;
+	if (!ExpressionExecutor::TryEvaluateScalar(context, expr, value) || value.IsNull()) {
+		return false;
+	}
+	auto &blob = StringValue::Get(value);
+	return GeometryFactory::TryGetSerializedBoundingBox(geometry_t(string_t(blob)), bbox);
+}
+
+static void PushdownComplexFilter(ClientContext &context, LogicalGet &get, FunctionData *bind_data_p,
+                                  vector<unique_ptr<Expression>> &filters) {
+	auto &bind_data = bind_data_p->Cast<FlatGeobufBindData>();
+
+	case_insensitive_set_t predicates = {"st_equals",    "st_intersects",       "st_touches",          "st_crosses",
+	                                     "st_within",    "st_contains",         "st_overlaps",         "st_covers",
+	                                     "st_coveredby", "st_containsproperly", "st_intersects_extent"};
+
+	for (auto &filter : filters) {
+		if (filter->type != ExpressionType::BOUND_FUNCTION) {
+			continue;
+		}
+		auto &func = filter->Cast<BoundFunctionExpression>();
+		if (func.children.size() != 2 || predicates.find(func.function.name) == predicates.end()) {
+			continue;
+		}
+		for (idx_t arg_idx = 0; arg_idx < 2; arg_idx++) {
+			auto &column_arg = func.children[arg_idx];
+			if (column_arg->type != ExpressionType::BOUND_COLUMN_REF) {
+				continue;
+			}
+			auto &column_ref = column_arg->Cast<BoundColumnRefExpression>();
+			if (column_ref.binding.table_index != get.table_index ||
+			    get.column_ids[column_ref.binding.column_index] != bind_data.GeometryColumnIndex()) {
+				continue;
+			}
+			BoundingBox bbox;
+			if (TryGetConstantBoundingBox(context, *func.children[1 - arg_idx], bbox)) {
+				bind_data.AddSpatialFilter(bbox);
+				break;
+			}
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// Init Global
+//------------------------------------------------------------------------------
+// Features are read in batches of roughly this many bytes. Reading a batch happens under the lock, decoding it does
+// not, so the features of different batches are decoded in parallel.
+static constexpr idx_t FLATGEOBUF_BATCH_SIZE = 1 << 20;
+// Start a new batch rather than reading over a gap of filtered out features larger than this
+static constexpr idx_t FLATGEOBUF_MAX_BATCH_GAP = 1 << 16;
+
+// A range of features located through the index
+struct FlatGeobufBatch {
+	// Range of the feature offsets in the global state
+	idx_t feature_begin;
+	idx_t feature_end;
+	// Range of bytes to read, relative to the start of the features
+	idx_t byte_begin;
+	idx_t byte_end;
+};
+
+struct FlatGeobufLocalState : public LocalTableFunctionState {
+	// The bytes of the claimed batch, either in the buffer or in the mapped file
+	vector<data_t> buffer;
+	const_data_ptr_t data = nullptr;
+	idx_t data_size = 0;
+	// Offsets of the size prefixed features in the data
+	vector<idx_t> features;
+	idx_t feature_idx = 0;
+	idx_t batch_index = 0;
+	GeometryFactory factory;
+
+	explicit FlatGeobufLocalState(ClientContext &context) : factory(BufferAllocator::Get(context)) {
+	}
+};
+
+struct FlatGeobufGlobalState : public GlobalTableFunctionState {
+	mutex lock;
+	unique_ptr<FileHandle> handle;
+	// Local files are mapped into memory, and the features are then parsed in place instead of copied to a buffer
+	unique_ptr<MappedFile> mapping;
+	idx_t file_size;
+	idx_t features_offset;
+	idx_t max_threads;
+
+	// Output column of each attribute and of the geometry, or DConstants::INVALID_INDEX if not projected
+	vector<idx_t> attribute_outputs;
+	idx_t geometry_output = DConstants::INVALID_INDEX;
+	bool has_attribute_outputs = false;
+
+	// With an index, the features to read are known up front
+	bool use_index = false;
+	vector<idx_t> feature_offsets;
+	vector<FlatGeobufBatch> batches;
+
+	// Without an index, the features are read one after the other starting at this offset in the file
+	idx_t next_offset;
+	idx_t next_batch = 0;
+
+	atomic<idx_t> bytes_read;
+	idx_t total_bytes;
+
+	FlatGeobufGlobalState(unique_ptr<FileHandle> handle_p, idx_t features_offset_p, idx_t max_threads_p)
+	    : handle(std::move(handle_p)), file_size(handle->GetFileSize()), features_offset(features_offset_p),
+	      max_threads(max_threads_p), next_offset(features_offset_p), bytes_read(0),
+	      total_bytes(file_size - features_offset_p) {
+	}
+
+	idx_t MaxThreads() const override {
+		return max_threads;
+	}
+
+	double GetProgress() const {
+		if (total_bytes == 0) {
+			return 100;
+		}
+		return 100 * (static_cast<double>(bytes_read) / static_cast<double>(total_bytes));
+	}
+
+	void ReadRange(FlatGeobufLocalState &local_state, idx_t size, idx_t offset) {
+		if (mapping) {
+			if (offset + size > mapping->GetSize()) {
+				throw InvalidInputException("Invalid FlatGeobuf file: feature at offset %llu is truncated", offset);
+			}
+			local_state.data = mapping->GetData() + offset;
+		} else {
+			local_state.buffer.resize(size);
+			handle->Read(local_state.buffer.data(), size, offset);
+			local_state.data = local_state.buffer.data();
+		}
+		local_state.data_size = size;
+	}
+
+	bool TryClaimBatch(FlatGeobufLocalState &local_state) {
+		lock_guard<mutex> glock(lock);
+
+		local_state.features.clear();
+		local_state.feature_idx = 0;
+
+		if (use_index) {
+			if (next_batch >= batches.size()) {
+				return false;
+			}
+			auto &batch = batches[next_batch];
+			local_state.batch_index = next_batch++;
+
+			auto read_size = batch.byte_end - batch.byte_begin;
+			ReadRange(local_state, read_size, features_offset + batch.byte_begin);
+			for (auto i = batch.feature_begin; i < batch.feature_end; i++) {
+				local_state.features.push_back(feature_offsets[i] - batch.byte_begin);
+			}
+			bytes_read += read_size;
+			return true;
+		}
+
+		if (next_offset >= file_size) {
+			return false;
+		}
+		auto remaining = file_size - next_offset;
+		auto read_size = MinValue(FLATGEOBUF_BATCH_SIZE, remaining);
+		ReadRange(local_state, read_size, next_offset);
+
+		// Take all the features that were read completely
+		idx_t pos = 0;
+		while (pos + sizeof(uint32_t) <= read_size) {
+			auto feature_size = Load<uint32_t>(local_state.data + pos);
+			if (feature_size > read_size - pos - sizeof(uint32_t)) {
+				break;
+			}
+			local_state.features.push_back(pos);
+			pos += sizeof(uint32_t) + feature_size;
+		}
+
+		if (local_state.features.empty()) {
+			// The next feature is larger than a batch, read it on its own
+			if (remaining < sizeof(uint32_t)) {
+				throw InvalidInputException("Invalid FlatGeobuf file: feature at offset %llu is truncated",
+				                            next_offset);
+			}
+			auto feature_size = Load<uint32_t>(local_state.data);
+			if (feature_size > remaining - sizeof(uint32_t)) {
+				throw InvalidInputException("Invalid FlatGeobuf file: feature at offset %llu is truncated",
+				                            next_offset);
+			}
+			pos = sizeof(uint32_t) + feature_size;
+			ReadRange(local_state, pos, next_offset);
+			local_state.features.push_back(0);
+		}
+
+		next_offset += pos;
+		local_state.batch_index = next_batch++;
+		bytes_read += pos;
+		return true;
+	}
+};
+
+// Find the leaf nodes (in file order) whose bounding box intersects the filter
+static vector<idx_t> SearchIndex(const FlatGeobufBindData &bind_data, const_data_ptr_t index,
+                                 const vector<pair<idx_t, idx_t>> &level_bounds) {
+	auto &filter = bind_data.spatial_filter;
+	auto node_size = bind_data.index_node_size;
+	auto leaf_begin = level_bounds.front().first;
+	auto node_count = level_bounds.front().second;
+
+	vector<idx_t> result;
+	// Pairs of the first node to visit and its level
+	vector<pair<idx_t, idx_t>> stack;
+	stack.emplace_back(0, level_bounds.size() - 1);
+	while (!stack.empty()) {
+		auto node_begin = stack.back().first;
+		auto level = stack.back().second;
+		stack.pop_back();
+
+		if (node_begin >= node_count) {
+			throw InvalidInputException("Invalid FlatGeobuf file '%s': index node out of bounds",
+			                            bind_data.file_name);
+		}
+		auto node_end = MinValue<idx_t>(node_begin + node_size, level_bounds[level].second);
+		for (auto node_idx = node_begin; node_idx < node_end; node_idx++) {
+			auto node = index + node_idx * FLATGEOBUF_NODE_SIZE;
+			auto minx = Load<double>(node);
+			auto miny = Load<double>(node + sizeof(double));
+			auto maxx = Load<double>(node + 2 * sizeof(double));
+			auto maxy = Load<double>(node + 3 * sizeof(double));
+			if (minx > filter.maxx || maxx < filter.minx || miny > filter.maxy || maxy < filter.miny) {
+				continue;
+			}
+			auto offset = Load<uint64_t>(node + 4 * sizeof(double));
+			if (node_idx >= leaf_begin) {
+				result.push_back(node_idx - leaf_begin);
+			} else if (level > 0) {
+				// Internal nodes point to the first of their children
+				stack.emplace_back(offset, level - 1);
+			}
+		}
+	}
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+static void InitIndexBatches(const FlatGeobufBindData &bind_data, FlatGeobufGlobalState &gstate) {
+	auto level_bounds = GetLevelBounds(bind_data.feature_count, bind_data.index_node_size);
+	auto leaf_begin = level_bounds.front().first;
+	auto node_count = level_bounds.front().second;
+
+	// Without a spatial filter only the leaves are needed, they hold the offsets of the features
+	auto read_begin = bind_data.has_spatial_filter ? 0 : leaf_begin;
+	vector<data_t> index((node_count - read_begin) * FLATGEOBUF_NODE_SIZE);
+	gstate.handle->Read(index.data(), index.size(), bind_data.index_offset + read_begin * FLATGEOBUF_NODE_SIZE);
+	auto leaves = index.data() + (leaf_begin - read_begin) * FLATGEOBUF_NODE_SIZE;
+
+	vector<idx_t> selected;
+	if (bind_data.has_spatial_filter) {
+		selected = SearchIndex(bind_data, index.data(), level_bounds);
+	} else {
+		selected.resize(bind_data.feature_count);
+		for (idx_t i = 0; i < selected.size(); i++) {
+			selected[i] = i;
+		}
+	}
+
+	auto features_size = gstate.file_size - bind_data.features_offset;
+	auto get_feature_offset = [&](idx_t leaf_idx) {
+		if (leaf_idx == bind_data.feature_count) {
+			return features_size;
+		}
+		return Load<uint64_t>(leaves + leaf_idx * FLATGEOBUF_NODE_SIZE + 4 * sizeof(double));
+	};
+
+	gstate.total_bytes = 0;
+	for (auto leaf_idx : selected) {
+		auto feature_begin = get_feature_offset(leaf_idx);
+		auto feature_end = get_feature_offset(leaf_idx + 1);
+		if (feature_begin > feature_end || feature_end > features_size) {
+			throw InvalidInputException("Invalid FlatGeobuf file '%s': features are not stored in index order",
+			                            bind_data.file_name);
+		}
+		if (gstate.batches.empty() || feature_begin - gstate.batches.back().byte_end > FLATGEOBUF_MAX_BATCH_GAP ||
+		    feature_end - gstate.batches.back().byte_begin > FLATGEOBUF_BATCH_SIZE) {
+			gstate.batches.push_back({gstate.feature_offsets.size(), gstate.feature_offsets.size(), feature_begin,
+			                          feature_begin});
+		}
+		auto &batch = gstate.batches.back();
+		gstate.total_bytes += feature_end - batch.byte_end;
+		batch.feature_end++;
+		batch.byte_end = feature_end;
+		gstate.feature_offsets.push_back(feature_begin);
+	}
+}
+
+static unique_ptr<GlobalTableFunctionState> InitGlobal(ClientContext &context, TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<FlatGeobufBindData>();
+
+	auto &fs = FileSystem::GetFileSystem(context);
+	auto handle = fs.OpenFile(bind_data.file_name, FileFlags::FILE_FLAGS_READ, FileLockType::READ_LOCK);
+	auto max_threads = context.db->NumberOfThreads();
+	auto result = make_uniq<FlatGeobufGlobalState>(std::move(handle), bind_data.features_offset, max_threads);
+	// Without a spatial filter every feature is read from front to back
+	result->mapping = MappedFile::TryMap(*result->handle, !bind_data.has_spatial_filter);
+
+	result->attribute_outputs.resize(bind_data.column_types.size(), DConstants::INVALID_INDEX);
+	for (idx_t col_idx = 0; col_idx < input.column_ids.size(); col_idx++) {
+		auto column_id = input.column_ids[col_idx];
+		if (column_id == bind_data.GeometryColumnIndex()) {
+			result->geometry_output = col_idx;
+		} else if (column_id < bind_data.column_types.size()) {
+			result->attribute_outputs[column_id] = col_idx;
+			result->has_attribute_outputs = true;
+		}
+	}
+
+	if (bind_data.HasIndex()) {
+		result->use_index = true;
+		InitIndexBatches(bind_data, *result);
+	}
+
+	return std::move(result);
+}
+
+static unique_ptr<LocalTableFunctionState> InitLocal(ExecutionContext &context, TableFunctionInitInput &input,
+                                                     GlobalTableFunctionState *global_state) {
+	return make_uniq<FlatGeobufLocalState>(context.client);
+}
+
+//------------------------------------------------------------------------------
+// Geometry Conversion
+//------------------------------------------------------------------------------
+
+struct FlatGeobufCoordinates {
+	FlatBufferVector xy;
+	FlatBufferVector z;
+	FlatBufferVector m;
+	uint32_t vertex_count;
+
+	explicit FlatGeobufCoordinates(const FlatBufferTable &geometry)
+	    : xy(geometry.GetVector(FlatGeobufGeometryField::XY, sizeof(double))),
+	      z(geometry.GetVector(FlatGeobufGeometryField::Z, sizeof(double))),
+	      m(geometry.GetVector(FlatGeobufGeometryField::M, sizeof(double))), vertex_count(xy.length / 2) {
+	}
+
+	// Missing Z and M values are set to 0
+	VertexArray Read(ArenaAllocator &allocator, uint32_t begin, uint32_t end, bool has_z, bool has_m) const {
+		if (begin > end || end > vertex_count) {
+			throw InvalidInputException("Invalid FlatGeobuf file: geometry part out of bounds");
+		}
+		auto vertices = VertexArray::Create(allocator, end - begin, has_z, has_m);
+		for (auto i = begin; i < end; i++) {
+			VertexXYZM vertex {0, 0, 0, 0};
+			vertex.x = Load<double>(xy.data + 2 * i * sizeof(double));
+			vertex.y = Load<double>(xy.data + (2 * i + 1) * sizeof(double));
+			if (i < z.length) {
+				vertex.z = Load<double>(z.data + i * sizeof(double));
+			}
+			if (i < m.length) {
+				vertex.m = Load<double>(m.data + i * sizeof(double));
+			}
+			vertices.Set(i - begin, vertex);
+		}
+		return vertices;
+	}
+};
+
+static uint32_t GetEnd(const FlatBufferVector &ends, uint32_t idx) {
+	return Load<uint32_t>(ends.data + idx * sizeof(uint32_t));
+}
+
+static Polygon ReadPolygon(ArenaAllocator &allocator, const FlatBufferTable &geometry, bool has_z, bool has_m) {
+	FlatGeobufCoordinates coordinates(geometry);
+	auto ends = geometry.GetVector(FlatGeobufGeometryField::ENDS, sizeof(uint32_t));
+	if (ends.length == 0) {
+		// A single ring
+		if (coordinates.vertex_count == 0) {
+			return Polygon(has_z, has_m);
+		}
+		Polygon polygon(allocator, 1, has_z, has_m);
+		polygon[0] = coordinates.Read(allocator, 0, coordinates.vertex_count, has_z, has_m);
+		return polygon;
+	}
+	Polygon polygon(allocator, ends.length, has_z, has_m);
+	uint32_t begin = 0;
+	for (uint32_t ring_idx = 0; ring_idx < ends.length; ring_idx++) {
+		auto end = GetEnd(ends, ring_idx);
+		polygon[ring_idx] = coordinates.Read(allocator, begin, end, has_z, has_m);
+		begin = end;
+	}
+	return polygon;
+}
+
+static Geometry ReadGeometry(ArenaAllocator &allocator, const FlatBufferTable &geometry, FlatGeobufGeometryType type,
+                             bool has_z, bool has_m) {
+	switch (type) {
+	case FlatGeobufGeometryType::POINT: {
+		FlatGeobufCoordinates coordinates(geometry);
+		if (coordinates.vertex_count == 0) {
+			return Point(has_z, has_m);
+		}
+		return Point(coordinates.Read(allocator, 0, 1, has_z, has_m));
+	}
+	case FlatGeobufGeometryType::LINESTRING: {
+		FlatGeobufCoordinates coordinates(geometry);
+		return LineString(coordinates.Read(allocator, 0, coordinates.vertex_count, has_z, has_m));
+	}
+	case FlatGeobufGeometryType::POLYGON:
+		return ReadPolygon(allocator, geometry, has_z, has_m);
+	case FlatGeobufGeometryType::MULTIPOINT: {
+		FlatGeobufCoordinates coordinates(geometry);
+		MultiPoint multi_point(allocator, coordinates.vertex_count, has_z, has_m);
+		for (uint32_t i = 0; i < coordinates.vertex_count; i++) {
+			multi_point[i] = Point(coordinates.Read(allocator, i, i + 1, has_z, has_m));
+		}
+		return multi_point;
+	}
+	case FlatGeobufGeometryType::MULTILINESTRING: {
+		FlatGeobufCoordinates coordinates(geometry);
+		auto ends = geometry.GetVector(FlatGeobufGeometryField::ENDS, sizeof(uint32_t));
+		if (ends.length == 0) {
+			// A single line
+			auto line_count = coordinates.vertex_count == 0 ? 0 : 1;
+			MultiLineString multi_line_string(allocator, line_count, has_z, has_m);
+			if (line_count == 1) {
+				multi_line_string[0] =
+				    LineString(coordinates.Read(allocator, 0, coordinates.vertex_count, has_z, has_m));
+			}
+			return multi_line_string;
+		}
+		MultiLineString multi_line_string(allocator, ends.length, has_z, has_m);
+		uint32_t begin = 0;
+		for (uint32_t line_idx = 0; line_idx < ends.length; line_idx++) {
+			auto end = GetEnd(ends, line_idx);
+			multi_line_string[line_idx] = LineString(coordinates.Read(allocator, begin, end, has_z, has_m));
+			begin = end;
+		}
+		return multi_line_string;
+	}
+	case FlatGeobufGeometryType::MULTIPOLYGON: {
+		auto parts = geometry.GetVector(FlatGeobufGeometryField::PARTS, sizeof(uint32_t));
+		MultiPolygon multi_polygon(allocator, parts.length, has_z, has_m);
+		for (uint32_t i = 0; i < parts.length; i++) {
+			multi_polygon[i] = ReadPolygon(allocator, geometry.GetTable(parts, i), has_z, has_m);
+		}
+		return multi_polygon;
+	}
+	case FlatGeobufGeometryType::GEOMETRYCOLLECTION: {
+		auto parts = geometry.GetVector(FlatGeobufGeometryField::PARTS, sizeof(uint32_t));
+		GeometryCollection collection(allocator, parts.length, has_z, has_m);
+		for (uint32_t i = 0; i < parts.length; i++) {
+			auto part = geometry.GetTable(parts, i);
+			auto part_type = part.GetScalar<uint8_t>(FlatGeobufGeometryField::TYPE, 0);
+			collection[i] = ReadGeometry(allocator, part, static_cast<FlatGeobufGeometryType>(part_type), has_z, has_m);
+		}
+		return collection;
+	}
+	default:
+		throw InvalidInputException("FlatGeobuf geometry type %d not supported", static_cast<int>(type));
+	}
+}
+
+static void ExpandBounds(const FlatBufferTable &geometry, BoundingBox &bbox) {
+	auto xy = geometry.GetVector(FlatGeobufGeometryField::XY, sizeof(double));
+	for (uint32_t i = 0; i + 1 < xy.length; i += 2) {
+		auto x = Load<double>(xy.data + i * sizeof(double));
+		auto y = Load<double>(xy.data + (i + 1) * sizeof(double));
+		bbox.minx = MinValue(bbox.minx, x);
+		bbox.miny = MinValue(bbox.miny, y);
+		bbox.maxx = MaxValue(bbox.maxx, x);
+		bbox.maxy = MaxValue(bbox.maxy, y);
+	}
+	auto parts = geometry.GetVector(FlatGeobufGeometryField::PARTS, sizeof(uint32_t));
+	for (uint32_t i = 0; i < parts.length; i++) {
+		ExpandBounds(geometry.GetTable(parts, i), bbox);
+	}
+}
+
+//------------------------------------------------------------------------------
+// Attribute Conversion
+//------------------------------------------------------------------------------
+// The properties of a feature are a sequence of a uint16_t column index followed by the value. Columns that are not
+// present are NULL. Variable sized values are prefixed with their uint32_t size.
+
+static idx_t GetFixedValueSize(FlatGeobufColumnType type) {
+	switch (type) {
+	case FlatGeobufColumnType::BYTE:
+	case FlatGeobufColumnType::UBYTE:
+	case FlatGeobufColumnType::BOOL:
+		return 1;
+	case FlatGeobufColumnType::SHORT:
+	case FlatGeobufColumnType::USHORT:
+		return 2;
+	case FlatGeobufColumnType::INT:
+	case FlatGeobufColumnType::UINT:
+	case FlatGeobufColumnType::FLOAT:
+		return 4;
+	case FlatGeobufColumnType::LONG:
+	case FlatGeobufColumnType::ULONG:
+	case FlatGeobufColumnType::DOUBLE:
+		return 8;
+	default:
+		return 0;
+	}
+}
+
+template <class T>
+static void WriteScalarProperty(Vector &result, idx_t row_idx, const_data_ptr_t value) {
+	FlatVector::GetData<T>(result)[row_idx] = Load<T>(value);
+}
+
+static void WriteProperty(Vector &result, idx_t row_idx, FlatGeobufColumnType type, const_data_ptr_t value,
+                          idx_t value_size) {
+	switch (type) {
+	case FlatGeobufColumnType::BYTE:
+		WriteScalarProperty<int8_t>(result, row_idx, value);
+		break;
+	case FlatGeobufColumnType::UBYTE:
+		WriteScalarProperty<uint8_t>(result, row_idx, value);
+		break;
+	case FlatGeobufColumnType::BOOL:
+		FlatVector::GetData<bool>(result)[row_idx] = *value != 0;
+		break;
+	case FlatGeobufColumnType::SHORT:
+		WriteScalarProperty<int16_t>(result, row_idx, value);
+		break;
+	case FlatGeobufColumnType::USHORT:
+		WriteScalarProperty<uint16_t>(result, row_idx, value);
+		break;
+	case FlatGeobufColumnType::INT:
+		WriteScalarProperty<int32_t>(result, row_idx, value);
+		break;
+	case FlatGeobufColumnType::UINT:
+		WriteScalarProperty<uint32_t>(result, row_idx, value);
+		break;
+	case FlatGeobufColumnType::LONG:
+		WriteScalarProperty<int64_t>(result, row_idx, value);
+		break;
+	case FlatGeobufColumnType::ULONG:
+		WriteScalarProperty<uint64_t>(result, row_idx, value);
+		break;
+	case FlatGeobufColumnType::FLOAT:
+		WriteScalarProperty<float>(result, row_idx, value);
+		break;
+	case FlatGeobufColumnType::DOUBLE:
+		WriteScalarProperty<double>(result, row_idx, value);
+		break;
+	case FlatGeobufColumnType::STRING:
+	case FlatGeobufColumnType::JSON: {
+		auto str = const_char_ptr_cast(value + sizeof(uint32_t));
+		auto len = value_size - sizeof(uint32_t);
+		if (!Utf8Proc::IsValid(str, len)) {
+			throw InvalidInputException("Could not decode VARCHAR property of FlatGeobuf feature as valid UTF-8");
+		}
+		FlatVector::GetData<string_t>(result)[row_idx] = StringVector::AddString(result, str, len);
+		break;
+	}
+	case FlatGeobufColumnType::DATETIME: {
+		// ISO 8601 strings
+		auto str = string(const_char_ptr_cast(value + sizeof(uint32_t)), value_size - sizeof(uint32_t));
+		FlatVector::GetData<timestamp_t>(result)[row_idx] = Timestamp::FromString(str);
+		break;
+	}
+	case FlatGeobufColumnType::BINARY:
+		FlatVector::GetData<string_t>(result)[row_idx] = StringVector::AddStringOrBlob(
+		    result, const_char_ptr_cast(value + sizeof(uint32_t)), value_size - sizeof(uint32_t));
+		break;
+	default:
+		throw InvalidInputException("FlatGeobuf column type %d not supported", static_cast<int>(type));
+	}
+	FlatVector::Validity(result).SetValid(row_idx);
+}
+
+static void ReadProperties(const FlatGeobufBindData &bind_data, const FlatGeobufGlobalState &gstate,
+                           const FlatBufferTable &feature, DataChunk &output, idx_t row_idx) {
+	auto properties = feature.GetVector(FlatGeobufFeatureField::PROPERTIES, sizeof(data_t));
+	idx_t pos = 0;
+	while (pos < properties.length) {
+		if (properties.length - pos < sizeof(uint16_t)) {
+			throw InvalidInputException("Invalid FlatGeobuf file: feature properties are truncated");
+		}
+		auto column_idx = Load<uint16_t>(properties.data + pos);
+		pos += sizeof(uint16_t);
+		if (column_idx >= bind_data.column_types.size()) {
+			throw InvalidInputException("Invalid FlatGeobuf file: property of unknown column %d", column_idx);
+		}
+		auto type = bind_data.column_types[column_idx];
+		auto value_size = GetFixedValueSize(type);
+		if (value_size == 0) {
+			if (properties.length - pos < sizeof(uint32_t)) {
+				throw InvalidInputException("Invalid FlatGeobuf file: feature properties are truncated");
+			}
+			value_size = sizeof(uint32_t) + Load<uint32_t>(properties.data + pos);
+		}
+		if (properties.length - pos < value_size) {
+			throw InvalidInputException("Invalid FlatGeobuf file: feature properties are truncated");
+		}
+		auto output_idx = gstate.attribute_outputs[column_idx];
+		if (output_idx != DConstants::INVALID_INDEX) {
+			WriteProperty(output.data[output_idx], row_idx, type, properties.data + pos, value_size);
+		}
+		pos += value_size;
+	}
+}
+
+//------------------------------------------------------------------------------
+// Execute
+//------------------------------------------------------------------------------
+
+static void Execute(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
+	auto &bind_data = input.bind_data->Cast<FlatGeobufBindData>();
+	auto &gstate = input.global_state->Cast<FlatGeobufGlobalState>();
+	auto &lstate = input.local_state->Cast<FlatGeobufLocalState>();
+
+	// Reset the buffer allocator
+	lstate.factory.allocator.Reset();
+
+	// Attributes that are not present in a feature are NULL
+	for (idx_t col_idx = 0; col_idx < output.ColumnCount(); col_idx++) {
+		if (col_idx != gstate.geometry_output) {
+			FlatVector::Validity(output.data[col_idx]).SetAllInvalid(STANDARD_VECTOR_SIZE);
+		}
+	}
+
+	// Without an index, the spatial filter is checked against the coordinates of every feature
+	auto check_bounds = bind_data.has_spatial_filter && !gstate.use_index;
+
+	idx_t count = 0;
+	while (true) {
+		while (count < STANDARD_VECTOR_SIZE && lstate.feature_idx < lstate.features.size()) {
+			auto feature_begin = lstate.features[lstate.feature_idx++];
+			auto buffer_size = lstate.data_size;
+			if (buffer_size - feature_begin < sizeof(uint32_t)) {
+				throw InvalidInputException("Invalid FlatGeobuf file: feature is truncated");
+			}
+			auto feature_size = Load<uint32_t>(lstate.data + feature_begin);
+			if (feature_size > buffer_size - feature_begin - sizeof(uint32_t)) {
+				throw InvalidInputException("Invalid FlatGeobuf file: feature is truncated");
+			}
+			auto feature = FlatBufferTable::GetRoot(lstate.data + feature_begin + sizeof(uint32_t), feature_size);
+
+			FlatBufferTable geometry;
+			auto has_geometry = feature.TryGetTable(FlatGeobufFeatureField::GEOMETRY, geometry);
+			if (check_bounds) {
+				BoundingBox bbox;
+				if (has_geometry) {
+					ExpandBounds(geometry, bbox);
+				}
+				if (!bbox.Intersects(bind_data.spatial_filter)) {
+					continue;
+				}
+			}
+
+			if (gstate.geometry_output != DConstants::INVALID_INDEX) {
+				auto &geom_vec = output.data[gstate.geometry_output];
+				if (has_geometry) {
+					auto type = bind_data.geometry_type;
+					if (type == FlatGeobufGeometryType::UNKNOWN) {
+						type = static_cast<FlatGeobufGeometryType>(
+						    geometry.GetScalar<uint8_t>(FlatGeobufGeometryField::TYPE, 0));
+					}
+					auto geom = ReadGeometry(lstate.factory.allocator, geometry, type, bind_data.has_z, bind_data.has_m);
+					FlatVector::GetData<geometry_t>(geom_vec)[count] =
+					    lstate.factory.Serialize(geom_vec, geom, bind_data.has_z, bind_data.has_m);
+				} else {
+					FlatVector::SetNull(geom_vec, count, true);
+				}
+			}
+
+			if (gstate.has_attribute_outputs) {
+				ReadProperties(bind_data, gstate, feature, output, count);
+			}
+			count++;
+		}
+		// Never mix the features of two batches in one chunk, so that the batch index is correct
+		if (count > 0 || !gstate.TryClaimBatch(lstate)) {
+			break;
+		}
+	}
+	output.SetCardinality(count);
+}
+
+//------------------------------------------------------------------------------
+// Progress, Cardinality and Batch Index
+//------------------------------------------------------------------------------
+
+static double GetProgress(ClientContext &context, const FunctionData *bind_data_p,
+                          const GlobalTableFunctionState *global_state) {
+	auto &gstate = global_state->Cast<FlatGeobufGlobalState>();
+	return gstate.GetProgress();
+}
+
+static unique_ptr<NodeStatistics> GetCardinality(ClientContext &context, const FunctionData *data) {
+	auto &bind_data = data->Cast<FlatGeobufBindData>();
+	auto result = make_uniq<NodeStatistics>();
+
+	// The feature count is optional when there is no index
+	if (bind_data.feature_count > 0) {
+		result->has_estimated_cardinality = true;
+		result->estimated_cardinality = bind_data.feature_count;
+		result->has_max_cardinality = true;
+		result->max_cardinality = bind_data.feature_count;
+	}
+	return result;
+}
+
+static idx_t GetBatchIndex(ClientContext &context, const FunctionData *bind_data_p,
+                           LocalTableFunctionState *local_state, GlobalTableFunctionState *global_state) {
+	auto &lstate = local_state->Cast<FlatGeobufLocalState>();
+	return lstate.batch_index;
+}
+
+//------------------------------------------------------------------------------
+// Register table function
+//------------------------------------------------------------------------------
+void CoreTableFunctions::RegisterFlatGeobufTableFunction(DatabaseInstance &db) {
+	TableFunction read_func("ST_ReadFGB", {LogicalType::VARCHAR}, Execute, Bind, InitGlobal, InitLocal);
+
+	read_func.named_parameters["spatial_filter_box"] = GeoTypes::BOX_2D();
+	read_func.table_scan_progress = GetProgress;
+	read_func.cardinality = GetCardinality;
+	read_func.get_batch_index = GetBatchIndex;
+	read_func.pushdown_complex_filter = PushdownComplexFilter;
+	read_func.projection_pushdown = true;
+	ExtensionUtil::RegisterFunction(db, read_func);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,685 @@
+#include "duckdb/parser/parsed_data/create_table_function_info.hpp"
+#include "duckdb/common/mutex.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/functions/table.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/geojson_reader.hpp"
+#include "spatial/core/io/mapped_file.hpp"
+
+namespace spatial {
+
+namespace core {
+
+using namespace duckdb_yyjson_spatial;
+
+//------------------------------------------------------------------------------
+// Source
+//------------------------------------------------------------------------------
+// The features of a FeatureCollection are read in batches of roughly this many bytes. Finding where the features of
+// a batch start and end happens under the lock, parsing them does not, so the features of different batches are
+// parsed in parallel.
+static constexpr idx_t GEOJSON_BATCH_SIZE = 1 << 20;
+// The number of features whose properties are looked at to pick the column types
+static constexpr int64_t GEOJSON_DEFAULT_SAMPLE_SIZE = 1024;
+
+struct GeoJSONSource {
+	string file_name;
+	unique_ptr<FileHandle> handle;
+	// Local files are mapped into memory, and the features are then parsed in place instead of copied to a buffer
+	unique_ptr<MappedFile> mapping;
+	idx_t file_size;
+
+	GeoJSONSource(ClientContext &context, string file_name_p) : file_name(std::move(file_name_p)) {
+		auto &fs = FileSystem::GetFileSystem(context);
+		handle = fs.OpenFile(file_name, FileFlags::FILE_FLAGS_READ, FileLockType::READ_LOCK);
+		mapping = MappedFile::TryMap(*handle, true);
+		file_size = mapping ? mapping->GetSize() : handle->GetFileSize();
+	}
+
+	// The bytes in [offset, offset + size), either in the mapped file or copied to the buffer
+	const char *Read(vector<data_t> &buffer, idx_t size, idx_t offset) {
+		D_ASSERT(offset + size <= file_size);
+		if (mapping) {
+			return const_char_ptr_cast(mapping->GetData() + offset);
+		}
+		buffer.resize(size);
+		handle->Read(buffer.data(), size, offset);
+		return const_char_ptr_cast(buffer.data());
+	}
+};
+
+static bool IsJSONSpace(char c) {
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Find the offset just after the "[" of the "features" array of the top level object
+static idx_t FindFeatures(GeoJSONSource &source) {
+	vector<data_t> buffer;
+	idx_t depth = 0;
+	bool in_string = false;
+	bool escaped = false;
+	bool started = false;
+	// The start of the last string of the top level object, which is enough to recognize the key
+	string key;
+	// 1 after the "features" key, 2 after its colon
+	int features_state = 0;
+
+	for (idx_t offset = 0; offset < source.file_size; offset += GEOJSON_BATCH_SIZE) {
+		auto size = MinValue(GEOJSON_BATCH_SIZE, source.file_size - offset);
+		auto data = source.Read(buffer, size, offset);
+		idx_t i = 0;
+		// Skip the byte order mark
+		if (offset == 0 && size >= 3 && memcmp(data, "\xEF\xBB\xBF", 3) == 0) {
+			i = 3;
+		}
+		for (; i < size; i++) {
+			auto c = data[i];
+			if (in_string) {
+				if (escaped) {
+					escaped = false;
+				} else if (c == '\\') {
+					escaped = true;
+				} else if (c == '"') {
+					in_string = false;
+					if (depth == 1) {
+						features_state = key == "features" ? 1 : 0;
+					}
+				} else if (depth == 1 && key.size() <= 8) {
+					key += c;
+				}
+				continue;
+			}
+			if (IsJSONSpace(c)) {
+				continue;
+			}
+			if (depth == 0) {
+				// Only a single top level object
+				if (started || c != '{') {
+					break;
+				}
+				started = true;
+			}
+			if (c == '"') {
+				in_string = true;
+				key.clear();
+				continue;
+			}
+			if (depth == 1) {
+				if (c == ':' && features_state == 1) {
+					features_state = 2;
+					continue;
+				}
+				if (c == '[' && features_state == 2) {
+					return offset + i + 1;
+				}
+				features_state = 0;
+			}
+			if (c == '{' || c == '[') {
+				depth++;
+			} else if (c == '}' || c == ']') {
+				if (--depth == 0) {
+					break;
+				}
+			}
+		}
+		if (i < size) {
+			break;
+		}
+	}
+	throw InvalidInputException("File '%s' is not a GeoJSON FeatureCollection: no \"features\" array found",
+	                            source.file_name);
+}
+
+// Add the features that are complete in the data, starting at pos, to the list of [begin, end) ranges. Sets done at
+// the end of the array. Leaves pos at the start of the first incomplete feature.
+static void ScanFeatures(const char *data, idx_t size, idx_t &pos, vector<pair<idx_t, idx_t>> &features,
+                         bool &done) {
+	while (true) {
+		while (pos < size && (IsJSONSpace(data[pos]) || data[pos] == ',')) {
+			pos++;
+		}
+		if (pos == size) {
+			return;
+		}
+		if (data[pos] == ']') {
+			done = true;
+			return;
+		}
+		if (data[pos] != '{') {
+			throw InvalidInputException("Invalid GeoJSON: expected a feature object, found '%c'", data[pos]);
+		}
+		// The matching brace, skipping over strings
+		idx_t depth = 0;
+		bool in_string = false;
+		idx_t i = pos;
+		for (; i < size; i++) {
+			auto c = data[i];
+			if (in_string) {
+				if (c == '\\') {
+					i++;
+				} else if (c == '"') {
+					in_string = false;
+				}
+			} else if (c == '"') {
+				in_string = true;
+			} else if (c == '{' || c == '[') {
+				depth++;
+			} else if ((c == '}' || c == ']') && --depth == 0) {
+				break;
+			}
+		}
+		if (i >= size) {
+			return;
+		}
+		features.emplace_back(pos, i + 1);
+		pos = i + 1;
+	}
+}
+
+// Find the complete features starting at the offset, reading more than a batch if a single feature is larger, and
+// move the offset past them. Returns false at the end of the array.
+static bool ReadFeatures(GeoJSONSource &source, vector<data_t> &buffer, idx_t &offset, const char *&data,
+                         vector<pair<idx_t, idx_t>> &features) {
+	features.clear();
+	auto read_size = MinValue(GEOJSON_BATCH_SIZE, source.file_size - offset);
+	while (true) {
+		data = source.Read(buffer, read_size, offset);
+		idx_t pos = 0;
+		bool done = false;
+		ScanFeatures(data, read_size, pos, features, done);
+		if (!features.empty() || done) {
+			offset += pos;
+			return !features.empty();
+		}
+		if (offset + read_size >= source.file_size) {
+			throw InvalidInputException("Invalid GeoJSON file '%s': feature at offset %llu is truncated",
+			                            source.file_name, offset + pos);
+		}
+		read_size = MinValue(read_size * 2, source.file_size - offset);
+	}
+}
+
+//------------------------------------------------------------------------------
+// Bind
+//------------------------------------------------------------------------------
+enum class GeoJSONPropertyType : uint8_t { UNKNOWN, BOOLEAN, BIGINT, DOUBLE, VARCHAR };
+
+// Larger integers are read as DOUBLE
+static constexpr uint64_t GEOJSON_MAX_BIGINT = static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+
+static GeoJSONPropertyType GetPropertyType(yyjson_val *val) {
+	switch (yyjson_get_type(val)) {
+	case YYJSON_TYPE_NULL:
+		return GeoJSONPropertyType::UNKNOWN;
+	case YYJSON_TYPE_BOOL:
+		return GeoJSONPropertyType::BOOLEAN;
+	case YYJSON_TYPE_NUM:
+		if (yyjson_is_real(val) || (yyjson_is_uint(val) && yyjson_get_uint(val) > GEOJSON_MAX_BIGINT)) {
+			return GeoJSONPropertyType::DOUBLE;
+		}
+		return GeoJSONPropertyType::BIGINT;
+	default:
+		// Strings, and objects and arrays as JSON text
+		return GeoJSONPropertyType::VARCHAR;
+	}
+}
+
+static GeoJSONPropertyType CombinePropertyTypes(GeoJSONPropertyType a, GeoJSONPropertyType b) {
+	if (a == GeoJSONPropertyType::UNKNOWN || a == b) {
+		return b;
+	}
+	if (b == GeoJSONPropertyType::UNKNOWN) {
+		return a;
+	}
+	if ((a == GeoJSONPropertyType::BIGINT || a == GeoJSONPropertyType::DOUBLE) &&
+	    (b == GeoJSONPropertyType::BIGINT || b == GeoJSONPropertyType::DOUBLE)) {
+		return GeoJSONPropertyType::DOUBLE;
+	}
+	return GeoJSONPropertyType::VARCHAR;
+}
+
+static LogicalType GetPropertyLogicalType(GeoJSONPropertyType type) {
+	switch (type) {
+	case GeoJSONPropertyType::BOOLEAN:
+		return LogicalType::BOOLEAN;
+	case GeoJSONPropertyType::BIGINT:
+		return LogicalType::BIGINT;
+	case GeoJSONPropertyType::DOUBLE:
+		return LogicalType::DOUBLE;
+	default:
+		return LogicalType::VARCHAR;
+	}
+}
+
+struct GeoJSONBindData : TableFunctionData {
+	string file_name;
+	// Where the first feature starts in the file
+	idx_t features_offset = 0;
+	int64_t sample_size = GEOJSON_DEFAULT_SAMPLE_SIZE;
+
+	// The property keys as they appear in the file, and their column
+	vector<string> property_keys;
+	vector<GeoJSONPropertyType> property_types;
+	unordered_map<string, idx_t> property_columns;
+
+	// What the sample saw, to estimate the number of features
+	idx_t sampled_features = 0;
+	idx_t sampled_bytes = 0;
+	bool sampled_all = false;
+	idx_t features_size = 0;
+
+	explicit GeoJSONBindData(string file_name_p) : file_name(std::move(file_name_p)) {
+	}
+
+	// The geometry is always the last column
+	idx_t GeometryColumnIndex() const {
+		return property_keys.size();
+	}
+};
+
+// Collect the property keys of the first features and pick a type for each of them
+static void SampleProperties(GeoJSONSource &source, GeoJSONBindData &bind_data) {
+	vector<data_t> buffer;
+	vector<pair<idx_t, idx_t>> features;
+	const char *data;
+	auto offset = bind_data.features_offset;
+	auto sample_size = static_cast<idx_t>(bind_data.sample_size);
+
+	while (bind_data.sampled_features < sample_size) {
+		if (!ReadFeatures(source, buffer, offset, data, features)) {
+			bind_data.sampled_all = true;
+			break;
+		}
+		for (auto &feature : features) {
+			if (bind_data.sampled_features == sample_size) {
+				break;
+			}
+			auto text = data + feature.first;
+			auto length = feature.second - feature.first;
+			yyjson_read_err err;
+			auto doc = yyjson_read_opts(const_cast<char *>(text), length, YYJSON_READ_ALLOW_INF_AND_NAN, nullptr, &err);
+			if (!doc) {
+				throw InvalidInputException("Could not parse GeoJSON feature in '%s': %s", source.file_name, err.msg);
+			}
+			auto properties = yyjson_obj_get(yyjson_doc_get_root(doc), "properties");
+			if (yyjson_is_obj(properties)) {
+				size_t idx, max;
+				yyjson_val *key, *val;
+				yyjson_obj_foreach(properties, idx, max, key, val) {
+					auto key_str = string(yyjson_get_str(key), yyjson_get_len(key));
+					auto entry = bind_data.property_columns.find(key_str);
+					if (entry == bind_data.property_columns.end()) {
+						bind_data.property_columns.emplace(key_str, bind_data.property_keys.size());
+						bind_data.property_keys.push_back(key_str);
+						bind_data.property_types.push_back(GetPropertyType(val));
+					} else {
+						auto &type = bind_data.property_types[entry->second];
+						type = CombinePropertyTypes(type, GetPropertyType(val));
+					}
+				}
+			}
+			yyjson_doc_free(doc);
+			bind_data.sampled_features++;
+			bind_data.sampled_bytes += length;
+		}
+	}
+}
+
+static unique_ptr<FunctionData> Bind(ClientContext &context, TableFunctionBindInput &input,
+                                     vector<LogicalType> &return_types, vector<string> &names) {
+
+	auto file_name = StringValue::Get(input.inputs[0]);
+	auto result = make_uniq<GeoJSONBindData>(file_name);
+
+	for (auto &kv : input.named_parameters) {
+		if (kv.first == "sample_size") {
+			auto sample_size = BigIntValue::Get(kv.second);
+			if (sample_size == -1) {
+				sample_size = NumericLimits<int64_t>::Maximum();
+			} else if (sample_size <= 0) {
+				throw BinderException("ST_ReadGeoJSON: sample_size must be positive, or -1 to sample every feature");
+			}
+			result->sample_size = sample_size;
+		}
+	}
+
+	GeoJSONSource source(context, file_name);
+	result->features_offset = FindFeatures(source);
+	result->features_size = source.file_size - result->features_offset;
+	SampleProperties(source, *result);
+
+	for (idx_t i = 0; i < result->property_keys.size(); i++) {
+		return_types.push_back(GetPropertyLogicalType(result->property_types[i]));
+		names.push_back(result->property_keys[i]);
+	}
+
+	// Always return geometry last
+	return_types.push_back(GeoTypes::GEOMETRY());
+	names.push_back("geom");
+
+	// Deduplicate field names if necessary, column names are case insensitive
+	for (size_t i = 0; i < names.size(); i++) {
+		idx_t count = 1;
+		for (size_t j = i + 1; j < names.size(); j++) {
+			if (StringUtil::CIEquals(names[i], names[j])) {
+				names[j] += "_" + std::to_string(count++);
+			}
+		}
+	}
+
+	return std::move(result);
+}
+
+//------------------------------------------------------------------------------
+// Init
+//------------------------------------------------------------------------------
+struct GeoJSONLocalState : public LocalTableFunctionState {
+	// The bytes of the claimed batch, either in the buffer or in the mapped file
+	vector<data_t> buffer;
+	const char *data = nullptr;
+	// Ranges of the features in the data
+	vector<pair<idx_t, idx_t>> features;
+	idx_t feature_idx = 0;
+	idx_t batch_index = 0;
+	GeometryFactory factory;
+	JSONAllocator json_allocator;
+	// The column of the property at each position of the previous feature, as features tend to list the same keys in
+	// the same order
+	vector<idx_t> key_columns;
+
+	explicit GeoJSONLocalState(ClientContext &context)
+	    : factory(BufferAllocator::Get(context)), json_allocator(factory.allocator) {
+	}
+};
+
+struct GeoJSONGlobalState : public GlobalTableFunctionState {
+	mutex lock;
+	GeoJSONSource source;
+	idx_t max_threads;
+
+	// Output column of each property and of the geometry, or DConstants::INVALID_INDEX if not projected
+	vector<idx_t> property_outputs;
+	idx_t geometry_output = DConstants::INVALID_INDEX;
+	bool has_property_outputs = false;
+
+	// The features are split into batches one after the other starting at this offset in the file
+	idx_t next_offset;
+	idx_t next_batch = 0;
+	bool finished = false;
+
+	atomic<idx_t> bytes_read;
+	idx_t total_bytes;
+
+	GeoJSONGlobalState(ClientContext &context, const GeoJSONBindData &bind_data, idx_t max_threads_p)
+	    : source(context, bind_data.file_name), max_threads(max_threads_p), next_offset(bind_data.features_offset),
+	      bytes_read(0), total_bytes(source.file_size - bind_data.features_offset) {
+	}
+
+	idx_t MaxThreads() const override {
+		return max_threads;
+	}
+
+	double GetProgress() const {
+		if (total_bytes == 0) {
+			return 100;
+		}
+		return 100 * (static_cast<double>(bytes_read) / static_cast<double>(total_bytes));
+	}
+
+	bool TryClaimBatch(GeoJSONLocalState &local_state) {
+		lock_guard<mutex> glock(lock);
+
+		local_state.feature_idx = 0;
+		if (finished) {
+			local_state.features.clear();
+			return false;
+		}
+		auto begin = next_offset;
+		if (!ReadFeatures(source, local_state.buffer, next_offset, local_state.data, local_state.features)) {
+			finished = true;
+			return false;
+		}
+		local_state.batch_index = next_batch++;
+		bytes_read += next_offset - begin;
+		return true;
+	}
+};
+
+static unique_ptr<GlobalTableFunctionState> InitGlobal(ClientContext &context, TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<GeoJSONBindData>();
+
+	auto max_threads = context.db->NumberOfThreads();
+	auto result = make_uniq<GeoJSONGlobalState>(context, bind_data, max_threads);
+
+	result->property_outputs.resize(bind_data.property_keys.size(), DConstants::INVALID_INDEX);
+	for (idx_t col_idx = 0; col_idx < input.column_ids.size(); col_idx++) {
+		auto column_id = input.column_ids[col_idx];
+		if (column_id == bind_data.GeometryColumnIndex()) {
+			result->geometry_output = col_idx;
+		} else if (column_id < bind_data.property_keys.size()) {
+			result->property_outputs[column_id] = col_idx;
+			result->has_property_outputs = true;
+		}
+	}
+
+	return std::move(result);
+}
+
+static unique_ptr<LocalTableFunctionState> InitLocal(ExecutionContext &context, TableFunctionInitInput &input,
+                                                     GlobalTableFunctionState *global_state) {
+	return make_uniq<GeoJSONLocalState>(context.client);
+}
+
+//------------------------------------------------------------------------------
+// Property Conversion
+//------------------------------------------------------------------------------
+static string GetPropertyTypeName(GeoJSONPropertyType type) {
+	return GetPropertyLogicalType(type).ToString();
+}
+
+static void WriteProperty(const GeoJSONBindData &bind_data, GeoJSONLocalState &lstate, Vector &result,
+                          idx_t row_idx, idx_t column_idx, yyjson_val *val) {
+	if (yyjson_is_null(val)) {
+		return;
+	}
+	auto type = bind_data.property_types[column_idx];
+	bool valid = true;
+	switch (type) {
+	case GeoJSONPropertyType::BOOLEAN:
+		valid = yyjson_is_bool(val);
+		if (valid) {
+			FlatVector::GetData<bool>(result)[row_idx] = yyjson_get_bool(val);
+		}
+		break;
+	case GeoJSONPropertyType::BIGINT:
+		valid = yyjson_is_sint(val) ||
+		        (yyjson_is_uint(val) && yyjson_get_uint(val) <= GEOJSON_MAX_BIGINT);
+		if (valid) {
+			FlatVector::GetData<int64_t>(result)[row_idx] =
+			    yyjson_is_sint(val) ? yyjson_get_sint(val) : static_cast<int64_t>(yyjson_get_uint(val));
+		}
+		break;
+	case GeoJSONPropertyType::DOUBLE:
+		valid = yyjson_is_num(val);
+		if (valid) {
+			FlatVector::GetData<double>(result)[row_idx] = yyjson_get_num(val);
+		}
+		break;
+	default:
+		if (yyjson_is_str(val)) {
+			FlatVector::GetData<string_t>(result)[row_idx] =
+			    StringVector::AddString(result, yyjson_get_str(val), yyjson_get_len(val));
+		} else {
+			// Anything else as JSON text
+			size_t len;
+			auto json = yyjson_val_write_opts(val, YYJSON_WRITE_ALLOW_INF_AND_NAN,
+			                                  lstate.json_allocator.GetYYJSONAllocator(), &len, nullptr);
+			if (!json) {
+				throw InvalidInputException("Could not write GeoJSON property \"%s\" as JSON",
+				                            bind_data.property_keys[column_idx]);
+			}
+			FlatVector::GetData<string_t>(result)[row_idx] = StringVector::AddString(result, json, len);
+		}
+		break;
+	}
+	if (!valid) {
+		throw InvalidInputException(
+		    "GeoJSON property \"%s\" has a value that is not a %s, the type of its values in the first %lld features. "
+		    "Use a larger sample_size to sample more features",
+		    bind_data.property_keys[column_idx], GetPropertyTypeName(type), bind_data.sample_size);
+	}
+	FlatVector::Validity(result).SetValid(row_idx);
+}
+
+static void ReadProperties(const GeoJSONBindData &bind_data, const GeoJSONGlobalState &gstate,
+                           GeoJSONLocalState &lstate, yyjson_val *properties, DataChunk &output, idx_t row_idx) {
+	size_t idx, max;
+	yyjson_val *key, *val;
+	yyjson_obj_foreach(properties, idx, max, key, val) {
+		auto key_str = yyjson_get_str(key);
+		auto key_len = yyjson_get_len(key);
+
+		// Try the column of the key at the same position in the previous feature first
+		if (idx >= lstate.key_columns.size()) {
+			lstate.key_columns.resize(idx + 1, DConstants::INVALID_INDEX);
+		}
+		auto column_idx = lstate.key_columns[idx];
+		if (column_idx == DConstants::INVALID_INDEX || bind_data.property_keys[column_idx].size() != key_len ||
+		    memcmp(bind_data.property_keys[column_idx].data(), key_str, key_len) != 0) {
+			auto entry = bind_data.property_columns.find(string(key_str, key_len));
+			if (entry == bind_data.property_columns.end()) {
+				// Keys that were not in the sample are skipped
+				continue;
+			}
+			column_idx = entry->second;
+			lstate.key_columns[idx] = column_idx;
+		}
+
+		auto output_idx = gstate.property_outputs[column_idx];
+		if (output_idx != DConstants::INVALID_INDEX) {
+			WriteProperty(bind_data, lstate, output.data[output_idx], row_idx, column_idx, val);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// Execute
+//------------------------------------------------------------------------------
+static void Execute(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
+	auto &bind_data = input.bind_data->Cast<GeoJSONBindData>();
+	auto &gstate = input.global_state->Cast<GeoJSONGlobalState>();
+	auto &lstate = input.local_state->Cast<GeoJSONLocalState>();
+
+	// Reset the buffer allocator, which also holds the parsed features
+	lstate.factory.allocator.Reset();
+
+	// Properties that are not present in a feature are NULL
+	for (idx_t col_idx = 0; col_idx < output.ColumnCount(); col_idx++) {
+		if (col_idx != gstate.geometry_output) {
+			FlatVector::Validity(output.data[col_idx]).SetAllInvalid(STANDARD_VECTOR_SIZE);
+		}
+	}
+
+	idx_t count = 0;
+	while (true) {
+		while (count < STANDARD_VECTOR_SIZE && lstate.feature_idx < lstate.features.size()) {
+			auto &feature = lstate.features[lstate.feature_idx++];
+			auto text = lstate.data + feature.first;
+			auto length = feature.second - feature.first;
+
+			yyjson_read_err err;
+			auto doc = yyjson_read_opts(const_cast<char *>(text), length, YYJSON_READ_ALLOW_INF_AND_NAN,
+			                            lstate.json_allocator.GetYYJSONAllocator(), &err);
+			if (!doc) {
+				throw InvalidInputException("Could not parse GeoJSON feature in '%s': %s", bind_data.file_name,
+				                            err.msg);
+			}
+			auto root = yyjson_doc_get_root(doc);
+
+			if (gstate.geometry_output != DConstants::INVALID_INDEX) {
+				auto &geom_vec = output.data[gstate.geometry_output];
+				auto geometry = yyjson_obj_get(root, "geometry");
+				if (yyjson_is_obj(geometry)) {
+					bool has_z = false;
+					auto geom = GeoJSONReader::Read(geometry, lstate.factory, string_t(text, length), has_z);
+					if (has_z) {
+						// Ensure the geometries has consistent Z values
+						geom.SetVertexType(lstate.factory.allocator, has_z, false);
+					}
+					FlatVector::GetData<geometry_t>(geom_vec)[count] =
+					    lstate.factory.Serialize(geom_vec, geom, has_z, false);
+				} else if (!geometry || yyjson_is_null(geometry)) {
+					FlatVector::SetNull(geom_vec, count, true);
+				} else {
+					throw InvalidInputException("GeoJSON feature geometry is not an object: %s",
+					                            string(text, length));
+				}
+			}
+
+			if (gstate.has_property_outputs) {
+				auto properties = yyjson_obj_get(root, "properties");
+				if (yyjson_is_obj(properties)) {
+					ReadProperties(bind_data, gstate, lstate, properties, output, count);
+				}
+			}
+			count++;
+		}
+		// Never mix the features of two batches in one chunk, so that the batch index is correct
+		if (count > 0 || !gstate.TryClaimBatch(lstate)) {
+			break;
+		}
+	}
+	output.SetCardinality(count);
+}
+
+//------------------------------------------------------------------------------
+// Progress, Cardinality and Batch Index
+//------------------------------------------------------------------------------
+static double GetProgress(ClientContext &context, const FunctionData *bind_data_p,
+                          const GlobalTableFunctionState *global_state) {
+	auto &gstate = global_state->Cast<GeoJSONGlobalState>();
+	return gstate.GetProgress();
+}
+
+static unique_ptr<NodeStatistics> GetCardinality(ClientContext &context, const FunctionData *data) {
+	auto &bind_data = data->Cast<GeoJSONBindData>();
+	auto result = make_uniq<NodeStatistics>();
+
+	if (bind_data.sampled_all) {
+		result->has_estimated_cardinality = true;
+		result->estimated_cardinality = bind_data.sampled_features;
+		result->has_max_cardinality = true;
+		result->max_cardinality = bind_data.sampled_features;
+	} else if (bind_data.sampled_bytes > 0) {
+		// Assume the rest of the features are as large as the sampled ones
+		result->has_estimated_cardinality = true;
+		result->estimated_cardinality = bind_data.sampled_features * bind_data.features_size / bind_data.sampled_bytes;
+	}
+	return result;
+}
+
+static idx_t GetBatchIndex(ClientContext &context, const FunctionData *bind_data_p,
+                           LocalTableFunctionState *local_state, GlobalTableFunctionState *global_state) {
+	auto &lstate = local_state->Cast<GeoJSONLocalState>();
+	return lstate.batch_index;
+}
+
+//------------------------------------------------------------------------------
+// Register table function
+//------------------------------------------------------------------------------
+void CoreTableFunctions::RegisterGeoJSONTableFunction(DatabaseInstance &db) {
+	TableFunction read_func("ST_ReadGeoJSON", {LogicalType::VARCHAR}, Execute, Bind, InitGlobal, InitLocal);
+
+	read_func.named_parameters["sample_size"] = LogicalType::BIGINT;
+	read_func.table_scan_progress = GetProgress;
+	read_func.cardinality = GetCardinality;
+	read_func.get_batch_index = GetBatchIndex;
+	read_func.projection_pushdown = true;
+	ExtensionUtil::RegisterFunction(db, read_func);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,350 @@
+#include "duckdb/common/types/column/column_data_collection.hpp"
+#include "duckdb/function/copy_function.hpp"
+#include "duckdb/parser/parsed_data/copy_info.hpp"
+#include "duckdb/parser/parsed_data/create_copy_function_info.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/vector_operations/vector_operations.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/functions/copy.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/geometry/geojson_writer.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// JSON encoding
+//------------------------------------------------------------------------------
+
+static void AppendJSONString(string &buffer, const char *data, idx_t size) {
+	static constexpr const char *HEX_DIGITS = "0123456789abcdef";
+	buffer += '"';
+	for (idx_t i = 0; i < size; i++) {
+		auto c = data[i];
+		switch (c) {
+		case '"':
+			buffer += "\\\"";
+			break;
+		case '\\':
+			buffer += "\\\\";
+			break;
+		case '\n':
+			buffer += "\\n";
+			break;
+		case '\r':
+			buffer += "\\r";
+			break;
+		case '\t':
+			buffer += "\\t";
+			break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20) {
+				buffer += "\\u00";
+				buffer += HEX_DIGITS[(c >> 4) & 0xF];
+				buffer += HEX_DIGITS[c & 0xF];
+			} else {
+				buffer += c;
+			}
+			break;
+		}
+	}
+	buffer += '"';
+}
+
+// How the value of a property column is written
+enum class GeoJSONPropertyKind : uint8_t {
+	BOOLEAN,
+	// FLOAT and DOUBLE, NaN and infinity become null
+	FLOAT,
+	DOUBLE,
+	// The VARCHAR cast of integers and decimals is a valid JSON number
+	NUMBER,
+	STRING,
+	// Anything else is cast to VARCHAR and written as a string
+	CAST_STRING
+};
+
+static GeoJSONPropertyKind GetPropertyKind(const LogicalType &type) {
+	switch (type.id()) {
+	case LogicalTypeId::BOOLEAN:
+		return GeoJSONPropertyKind::BOOLEAN;
+	case LogicalTypeId::FLOAT:
+		return GeoJSONPropertyKind::FLOAT;
+	case LogicalTypeId::DOUBLE:
+		return GeoJSONPropertyKind::DOUBLE;
+	case LogicalTypeId::TINYINT:
+	case LogicalTypeId::SMALLINT:
+	case LogicalTypeId::INTEGER:
+	case LogicalTypeId::BIGINT:
+	case LogicalTypeId::HUGEINT:
+	case LogicalTypeId::UTINYINT:
+	case LogicalTypeId::USMALLINT:
+	case LogicalTypeId::UINTEGER:
+	case LogicalTypeId::UBIGINT:
+	case LogicalTypeId::UHUGEINT:
+	case LogicalTypeId::DECIMAL:
+		return GeoJSONPropertyKind::NUMBER;
+	case LogicalTypeId::VARCHAR:
+		return GeoJSONPropertyKind::STRING;
+	default:
+		return GeoJSONPropertyKind::CAST_STRING;
+	}
+}
+
+//------------------------------------------------------------------------------
+// Bind
+//------------------------------------------------------------------------------
+
+struct GeoJSONSeqBindData : public TableFunctionData {
+	string file_path;
+	vector<LogicalType> types;
+	idx_t geometry_column_idx = DConstants::INVALID_INDEX;
+	// The escaped and quoted key of every property followed by a colon, and how its value is written
+	vector<string> property_keys;
+	vector<GeoJSONPropertyKind> property_kinds;
+	// Start every feature with an ASCII record separator, as in RFC 8142
+	bool rs = false;
+};
+
+static unique_ptr<FunctionData> Bind(ClientContext &context, CopyFunctionBindInput &input, const vector<string> &names,
+                                     const vector<LogicalType> &sql_types) {
+	auto bind_data = make_uniq<GeoJSONSeqBindData>();
+	bind_data->file_path = input.info.file_path;
+	bind_data->types = sql_types;
+
+	for (auto &option : input.info.options) {
+		if (StringUtil::Upper(option.first) == "RS") {
+			auto set = option.second.empty() ? Value::BOOLEAN(true) : option.second.front();
+			if (!set.DefaultTryCastAs(LogicalType::BOOLEAN) || set.IsNull()) {
+				throw BinderException("RS must be a boolean");
+			}
+			bind_data->rs = BooleanValue::Get(set);
+		} else {
+			throw BinderException("Unknown option '%s'", option.first);
+		}
+	}
+
+	// The first geometry column is the geometry of the features, every other column is a property
+	for (idx_t col_idx = 0; col_idx < sql_types.size(); col_idx++) {
+		if (bind_data->geometry_column_idx == DConstants::INVALID_INDEX && sql_types[col_idx] == GeoTypes::GEOMETRY()) {
+			bind_data->geometry_column_idx = col_idx;
+			bind_data->property_keys.emplace_back();
+			bind_data->property_kinds.push_back(GeoJSONPropertyKind::CAST_STRING);
+			continue;
+		}
+		string key;
+		AppendJSONString(key, names[col_idx].c_str(), names[col_idx].size());
+		key += ':';
+		bind_data->property_keys.push_back(key);
+		bind_data->property_kinds.push_back(GetPropertyKind(sql_types[col_idx]));
+	}
+	if (bind_data->geometry_column_idx == DConstants::INVALID_INDEX) {
+		throw BinderException("GEOJSONSEQ requires a GEOMETRY column");
+	}
+
+	input.file_extension = "geojsonl";
+	return std::move(bind_data);
+}
+
+//------------------------------------------------------------------------------
+// Encode
+//------------------------------------------------------------------------------
+// Chunks are encoded into a thread local buffer, only writing the buffer to the file is serialized
+
+static void EncodeChunk(ClientContext &context, const GeoJSONSeqBindData &bind_data, DataChunk &chunk,
+                        string &buffer) {
+	auto count = chunk.size();
+	auto column_count = chunk.ColumnCount();
+
+	vector<UnifiedVectorFormat> formats(column_count);
+	vector<unique_ptr<Vector>> casts(column_count);
+	for (idx_t col_idx = 0; col_idx < column_count; col_idx++) {
+		auto kind = bind_data.property_kinds[col_idx];
+		if (col_idx != bind_data.geometry_column_idx &&
+		    (kind == GeoJSONPropertyKind::NUMBER || kind == GeoJSONPropertyKind::CAST_STRING)) {
+			casts[col_idx] = make_uniq<Vector>(LogicalType::VARCHAR, count);
+			VectorOperations::Cast(context, chunk.data[col_idx], *casts[col_idx], count);
+			casts[col_idx]->ToUnifiedFormat(count, formats[col_idx]);
+		} else {
+			chunk.data[col_idx].ToUnifiedFormat(count, formats[col_idx]);
+		}
+	}
+
+	GeoJSONWriter writer;
+	for (idx_t row_idx = 0; row_idx < count; row_idx++) {
+		if (bind_data.rs) {
+			buffer += '\x1e';
+		}
+		buffer += R"({"type":"Feature","geometry":)";
+		auto &geom_format = formats[bind_data.geometry_column_idx];
+		auto geom_idx = geom_format.sel->get_index(row_idx);
+		if (geom_format.validity.RowIsValid(geom_idx)) {
+			writer.Write(UnifiedVectorFormat::GetData<geometry_t>(geom_format)[geom_idx], buffer);
+		} else {
+			buffer += "null";
+		}
+
+		buffer += R"(,"properties":{)";
+		bool first = true;
+		for (idx_t col_idx = 0; col_idx < column_count; col_idx++) {
+			if (col_idx == bind_data.geometry_column_idx) {
+				continue;
+			}
+			if (!first) {
+				buffer += ',';
+			}
+			first = false;
+			buffer += bind_data.property_keys[col_idx];
+
+			auto &format = formats[col_idx];
+			auto idx = format.sel->get_index(row_idx);
+			if (!format.validity.RowIsValid(idx)) {
+				buffer += "null";
+				continue;
+			}
+			switch (bind_data.property_kinds[col_idx]) {
+			case GeoJSONPropertyKind::BOOLEAN:
+				buffer += UnifiedVectorFormat::GetData<bool>(format)[idx] ? "true" : "false";
+				break;
+			case GeoJSONPropertyKind::FLOAT:
+				GeoJSONWriter::AppendNumber(buffer, UnifiedVectorFormat::GetData<float>(format)[idx]);
+				break;
+			case GeoJSONPropertyKind::DOUBLE:
+				GeoJSONWriter::AppendNumber(buffer, UnifiedVectorFormat::GetData<double>(format)[idx]);
+				break;
+			case GeoJSONPropertyKind::NUMBER: {
+				auto &str = UnifiedVectorFormat::GetData<string_t>(format)[idx];
+				buffer.append(str.GetDataUnsafe(), str.GetSize());
+				break;
+			}
+			case GeoJSONPropertyKind::STRING:
+			case GeoJSONPropertyKind::CAST_STRING: {
+				auto &str = UnifiedVectorFormat::GetData<string_t>(format)[idx];
+				AppendJSONString(buffer, str.GetDataUnsafe(), str.GetSize());
+				break;
+			}
+			}
+		}
+		buffer += "}}\n";
+	}
+}
+
+//------------------------------------------------------------------------------
+// Init
+//------------------------------------------------------------------------------
+
+struct GeoJSONSeqGlobalState : public GlobalFunctionData {
+	mutex lock;
+	unique_ptr<FileHandle> handle;
+
+	explicit GeoJSONSeqGlobalState(unique_ptr<FileHandle> handle_p) : handle(std::move(handle_p)) {
+	}
+
+	void WriteData(const string &data) {
+		lock_guard<mutex> glock(lock);
+		handle->Write((void *)data.data(), data.size());
+	}
+};
+
+struct GeoJSONSeqLocalState : public LocalFunctionData {
+	string buffer;
+};
+
+static unique_ptr<GlobalFunctionData> InitGlobal(ClientContext &context, FunctionData &bind_data,
+                                                 const string &file_path) {
+	auto &fs = FileSystem::GetFileSystem(context);
+	// Compressed if the file name ends with e.g. .gz
+	auto handle = fs.OpenFile(file_path, FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE_NEW,
+	                          FileLockType::WRITE_LOCK, FileCompressionType::AUTO_DETECT);
+	return make_uniq<GeoJSONSeqGlobalState>(std::move(handle));
+}
+
+static unique_ptr<LocalFunctionData> InitLocal(ExecutionContext &context, FunctionData &bind_data) {
+	return make_uniq<GeoJSONSeqLocalState>();
+}
+
+//------------------------------------------------------------------------------
+// Sink, Combine and Finalize
+//------------------------------------------------------------------------------
+
+static void Sink(ExecutionContext &context, FunctionData &bind_data, GlobalFunctionData &gstate,
+                 LocalFunctionData &lstate, DataChunk &input) {
+	auto &local_state = lstate.Cast<GeoJSONSeqLocalState>();
+	local_state.buffer.clear();
+	EncodeChunk(context.client, bind_data.Cast<GeoJSONSeqBindData>(), input, local_state.buffer);
+	gstate.Cast<GeoJSONSeqGlobalState>().WriteData(local_state.buffer);
+}
+
+static void Combine(ExecutionContext &context, FunctionData &bind_data, GlobalFunctionData &gstate,
+                    LocalFunctionData &lstate) {
+}
+
+static void Finalize(ClientContext &context, FunctionData &bind_data, GlobalFunctionData &gstate) {
+	auto &global_state = gstate.Cast<GeoJSONSeqGlobalState>();
+	global_state.handle->Close();
+	global_state.handle.reset();
+}
+
+//------------------------------------------------------------------------------
+// Batched (order preserving) copy
+//------------------------------------------------------------------------------
+// When the insertion order has to be preserved, DuckDB hands over the rows in batches that are encoded in parallel
+// and then written in order, the same way the CSV writer does it.
+
+struct GeoJSONSeqBatchData : public PreparedBatchData {
+	string buffer;
+};
+
+static CopyFunctionExecutionMode ExecutionMode(bool preserve_insertion_order, bool supports_batch_index) {
+	if (!preserve_insertion_order) {
+		return CopyFunctionExecutionMode::PARALLEL_COPY_TO_FILE;
+	}
+	if (supports_batch_index) {
+		return CopyFunctionExecutionMode::BATCH_COPY_TO_FILE;
+	}
+	return CopyFunctionExecutionMode::REGULAR_COPY_TO_FILE;
+}
+
+static unique_ptr<PreparedBatchData> PrepareBatch(ClientContext &context, FunctionData &bind_data,
+                                                  GlobalFunctionData &gstate,
+                                                  unique_ptr<ColumnDataCollection> collection) {
+	auto &geojson_data = bind_data.Cast<GeoJSONSeqBindData>();
+	auto batch = make_uniq<GeoJSONSeqBatchData>();
+	for (auto &chunk : collection->Chunks()) {
+		EncodeChunk(context, geojson_data, chunk, batch->buffer);
+	}
+	return std::move(batch);
+}
+
+static void FlushBatch(ClientContext &context, FunctionData &bind_data, GlobalFunctionData &gstate,
+                       PreparedBatchData &batch) {
+	auto &batch_data = batch.Cast<GeoJSONSeqBatchData>();
+	gstate.Cast<GeoJSONSeqGlobalState>().WriteData(batch_data.buffer);
+	batch_data.buffer.clear();
+}
+
+//------------------------------------------------------------------------------
+// Register
+//------------------------------------------------------------------------------
+void CoreCopyFunctions::RegisterGeoJSONSeqCopyFunction(DatabaseInstance &db) {
+	CopyFunction info("GEOJSONSEQ");
+	info.copy_to_bind = Bind;
+	info.copy_to_initialize_local = InitLocal;
+	info.copy_to_initialize_global = InitGlobal;
+	info.copy_to_sink = Sink;
+	info.copy_to_combine = Combine;
+	info.copy_to_finalize = Finalize;
+	info.execution_mode = ExecutionMode;
+	info.prepare_batch = PrepareBatch;
+	info.flush_batch = FlushBatch;
+	info.extension = "geojsonl";
+
+	ExtensionUtil::RegisterFunction(db, info);
+}
+
+} // namespace core
+
+} // namespace spatial
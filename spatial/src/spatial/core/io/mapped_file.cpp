@@ -0,0 +1,63 @@
+#include "spatial/core/io/mapped_file.hpp"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace spatial {
+
+namespace core {
+
+MappedFile::MappedFile(int fd, data_ptr_t data, idx_t size) : fd(fd), data(data), size(size) {
+}
+
+#ifndef _WIN32
+
+MappedFile::~MappedFile() {
+	munmap(data, size);
+	close(fd);
+}
+
+unique_ptr<MappedFile> MappedFile::TryMap(FileHandle &handle, bool sequential) {
+	// Compressed and remote files go through file systems of their own, whose bytes are not the bytes on disk
+	if (handle.file_system.GetName() != "LocalFileSystem" || handle.GetType() != FileType::FILE_TYPE_REGULAR) {
+		return nullptr;
+	}
+	auto fd = open(handle.path.c_str(), O_RDONLY);
+	if (fd == -1) {
+		return nullptr;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) {
+		close(fd);
+		return nullptr;
+	}
+	auto size = static_cast<idx_t>(st.st_size);
+	auto data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (data == MAP_FAILED) {
+		close(fd);
+		return nullptr;
+	}
+	// Only a hint, so a failure does not matter
+	madvise(data, size, sequential ? MADV_SEQUENTIAL : MADV_NORMAL);
+	return make_uniq<MappedFile>(fd, static_cast<data_ptr_t>(data), size);
+}
+
+#else
+
+MappedFile::~MappedFile() {
+}
+
+unique_ptr<MappedFile> MappedFile::TryMap(FileHandle &handle, bool sequential) {
+	// Not supported on Windows, files are read through their handle instead
+	return nullptr;
+}
+
+#endif
+
+} // namespace core
+
+} // namespace spatial
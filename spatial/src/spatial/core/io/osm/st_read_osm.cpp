@@ -1,17 +1,31 @@
 #include "duckdb/parser/parsed_data/create_table_function_info.hpp"
 #include "duckdb/storage/buffer_manager.hpp"
+#include "duckdb/storage/object_cache.hpp"
 #include "duckdb/function/replacement_scan.hpp"
 #include "duckdb/parser/expression/constant_expression.hpp"
 #include "duckdb/parser/expression/function_expression.hpp"
 #include "duckdb/parser/tableref/table_function_ref.hpp"
+#include "duckdb/planner/expression/bound_cast_expression.hpp"
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
+#include "duckdb/planner/expression/bound_comparison_expression.hpp"
+#include "duckdb/planner/expression/bound_conjunction_expression.hpp"
+#include "duckdb/planner/expression/bound_constant_expression.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckdb/planner/expression/bound_operator_expression.hpp"
+#include "duckdb/planner/operator/logical_get.hpp"
 
 #include "spatial/common.hpp"
 #include "spatial/core/functions/table.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/io/async_reader.hpp"
 #include "spatial/core/types.hpp"
 
 #include "protozero/pbf_reader.hpp"
 #include "zlib.h"
 
+#include <condition_variable>
+#include <deque>
+
 namespace spatial {
 
 namespace core {
@@ -29,9 +43,49 @@ static int32_t ReadInt32BigEndian(data_ptr_t ptr) {
 // OSM Table Function
 //------------------------------------------------------------------------------
 
+// The columns of the result, and the kinds of the entities
+static constexpr idx_t OSM_KIND_COLUMN = 0;
+static constexpr idx_t OSM_ID_COLUMN = 1;
+static constexpr idx_t OSM_TAGS_COLUMN = 2;
+static constexpr idx_t OSM_REFS_COLUMN = 3;
+static constexpr idx_t OSM_LAT_COLUMN = 4;
+static constexpr idx_t OSM_LON_COLUMN = 5;
+static constexpr idx_t OSM_REF_ROLES_COLUMN = 6;
+static constexpr idx_t OSM_REF_TYPES_COLUMN = 7;
+// Only present with geometries := true
+static constexpr idx_t OSM_GEOMETRY_COLUMN = 8;
+static constexpr idx_t OSM_COLUMN_COUNT = 9;
+
+static constexpr uint8_t OSM_KIND_NODE = 0;
+static constexpr uint8_t OSM_KIND_WAY = 1;
+static constexpr uint8_t OSM_KIND_RELATION = 2;
+static constexpr uint8_t OSM_ALL_KINDS = (1 << OSM_KIND_NODE) | (1 << OSM_KIND_WAY) | (1 << OSM_KIND_RELATION);
+
+// A tag that every entity in the result must have, optionally with a specific value
+struct OsmTagFilter {
+	string key;
+	bool has_value;
+	string value;
+};
+
 struct BindData : TableFunctionData {
 	string file_name;
 
+	// Entities that can not pass the filters of the query are skipped while decoding. The filters are still
+	// evaluated on the result, so these only need to be implied by them.
+	uint8_t kinds = OSM_ALL_KINDS;
+	vector<OsmTagFilter> tag_filters;
+
+	// Assemble the geometries of nodes, ways and multipolygon relations into an extra column
+	bool geometries = false;
+
+	// Nodes outside of the box are skipped, ways and relations have no coordinates of their own and are kept
+	bool has_spatial_filter = false;
+	BoundingBox spatial_filter;
+
+	// Where to keep the blob table of the file between sessions, if set
+	string blob_index_file;
+
 	BindData(string file_name) : file_name(file_name) {
 	}
 };
@@ -91,19 +145,225 @@ static unique_ptr<FunctionData> Bind(ClientContext &context, TableFunctionBindIn
 
 	auto file_name = StringValue::Get(input.inputs[0]);
 	auto result = make_uniq<BindData>(file_name);
+
+	for (auto &kv : input.named_parameters) {
+		if (kv.first == "geometries") {
+			result->geometries = BooleanValue::Get(kv.second);
+		}
+		if (kv.first == "spatial_filter_box") {
+			auto &children = StructValue::GetChildren(kv.second);
+			result->has_spatial_filter = true;
+			result->spatial_filter.minx = DoubleValue::Get(children[0]);
+			result->spatial_filter.miny = DoubleValue::Get(children[1]);
+			result->spatial_filter.maxx = DoubleValue::Get(children[2]);
+			result->spatial_filter.maxy = DoubleValue::Get(children[3]);
+		}
+		if (kv.first == "blob_index_file") {
+			result->blob_index_file = StringValue::Get(kv.second);
+		}
+	}
+	if (result->geometries) {
+		return_types.push_back(GeoTypes::GEOMETRY());
+		names.push_back("geometry");
+	}
+
 	return std::move(result);
 }
 
+//------------------------------------------------------------------------------
+// Filter Pushdown
+//------------------------------------------------------------------------------
+// Filters on the kind skip the primitive groups of other kinds without decoding them, and filters that require a tag
+// skip the blocks whose string table does not contain its key (or value).
+
+static bool IsOsmColumn(const Expression &expr, const LogicalGet &get, idx_t column_idx) {
+	auto child = &expr;
+	while (child->type == ExpressionType::OPERATOR_CAST) {
+		child = child->Cast<BoundCastExpression>().child.get();
+	}
+	if (child->type != ExpressionType::BOUND_COLUMN_REF) {
+		return false;
+	}
+	auto &column_ref = child->Cast<BoundColumnRefExpression>();
+	return column_ref.binding.table_index == get.table_index &&
+	       get.column_ids[column_ref.binding.column_index] == column_idx;
+}
+
+static bool TryGetConstantString(const Expression &expr, string &result) {
+	if (expr.type != ExpressionType::VALUE_CONSTANT) {
+		return false;
+	}
+	auto &value = expr.Cast<BoundConstantExpression>().value;
+	if (value.IsNull()) {
+		return false;
+	}
+	result = value.ToString();
+	return true;
+}
+
+static uint8_t GetKindMask(const string &kind) {
+	if (kind == "node") {
+		return 1 << OSM_KIND_NODE;
+	}
+	if (kind == "way") {
+		return 1 << OSM_KIND_WAY;
+	}
+	if (kind == "relation") {
+		return 1 << OSM_KIND_RELATION;
+	}
+	return 0;
+}
+
+// Matches kind = 'x', kind IN ('x', 'y') and disjunctions of these
+static bool TryGetKindFilter(const Expression &expr, const LogicalGet &get, uint8_t &kinds) {
+	string kind;
+	switch (expr.type) {
+	case ExpressionType::COMPARE_EQUAL: {
+		auto &comparison = expr.Cast<BoundComparisonExpression>();
+		if (IsOsmColumn(*comparison.left, get, OSM_KIND_COLUMN) && TryGetConstantString(*comparison.right, kind)) {
+			kinds = GetKindMask(kind);
+			return true;
+		}
+		if (IsOsmColumn(*comparison.right, get, OSM_KIND_COLUMN) && TryGetConstantString(*comparison.left, kind)) {
+			kinds = GetKindMask(kind);
+			return true;
+		}
+		return false;
+	}
+	case ExpressionType::COMPARE_IN: {
+		auto &op = expr.Cast<BoundOperatorExpression>();
+		if (!IsOsmColumn(*op.children[0], get, OSM_KIND_COLUMN)) {
+			return false;
+		}
+		kinds = 0;
+		for (idx_t i = 1; i < op.children.size(); i++) {
+			if (!TryGetConstantString(*op.children[i], kind)) {
+				return false;
+			}
+			kinds |= GetKindMask(kind);
+		}
+		return true;
+	}
+	case ExpressionType::CONJUNCTION_OR: {
+		auto &conjunction = expr.Cast<BoundConjunctionExpression>();
+		kinds = 0;
+		for (auto &child : conjunction.children) {
+			uint8_t child_kinds;
+			if (!TryGetKindFilter(*child, get, child_kinds)) {
+				return false;
+			}
+			kinds |= child_kinds;
+		}
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+// Matches tags['key'][1] (and element_at), which is NULL if the entity does not have the tag
+static bool TryGetTagValueKey(const Expression &expr, const LogicalGet &get, string &key) {
+	auto child = &expr;
+	while (child->type == ExpressionType::OPERATOR_CAST) {
+		child = child->Cast<BoundCastExpression>().child.get();
+	}
+	if (child->type != ExpressionType::BOUND_FUNCTION) {
+		return false;
+	}
+	auto &func = child->Cast<BoundFunctionExpression>();
+	auto &name = func.function.name;
+	if (func.children.size() != 2) {
+		return false;
+	}
+	if (name == "list_extract" || name == "array_extract" || name == "list_element") {
+		auto &index = *func.children[1];
+		if (index.type != ExpressionType::VALUE_CONSTANT) {
+			return false;
+		}
+		auto index_value = index.Cast<BoundConstantExpression>().value;
+		if (index_value.IsNull() || !index_value.DefaultTryCastAs(LogicalType::BIGINT) ||
+		    index_value.GetValue<int64_t>() != 1) {
+			return false;
+		}
+		auto &map = *func.children[0];
+		if (map.type != ExpressionType::BOUND_FUNCTION) {
+			return false;
+		}
+		auto &map_func = map.Cast<BoundFunctionExpression>();
+		if (map_func.function.name != "map_extract" && map_func.function.name != "element_at") {
+			return false;
+		}
+		return map_func.children.size() == 2 && IsOsmColumn(*map_func.children[0], get, OSM_TAGS_COLUMN) &&
+		       TryGetConstantString(*map_func.children[1], key);
+	}
+	return false;
+}
+
+// Matches tags['key'][1] IS NOT NULL, and comparisons of tags['key'][1] with a constant
+static bool TryGetTagFilter(const Expression &expr, const LogicalGet &get, OsmTagFilter &filter) {
+	filter.has_value = false;
+	switch (expr.type) {
+	case ExpressionType::OPERATOR_IS_NOT_NULL: {
+		auto &op = expr.Cast<BoundOperatorExpression>();
+		return TryGetTagValueKey(*op.children[0], get, filter.key);
+	}
+	case ExpressionType::COMPARE_EQUAL:
+	case ExpressionType::COMPARE_NOTEQUAL:
+	case ExpressionType::COMPARE_LESSTHAN:
+	case ExpressionType::COMPARE_GREATERTHAN:
+	case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+	case ExpressionType::COMPARE_GREATERTHANOREQUALTO: {
+		auto &comparison = expr.Cast<BoundComparisonExpression>();
+		auto is_equal = expr.type == ExpressionType::COMPARE_EQUAL;
+		for (idx_t side = 0; side < 2; side++) {
+			auto &tag = side == 0 ? *comparison.left : *comparison.right;
+			auto &constant = side == 0 ? *comparison.right : *comparison.left;
+			// Comparing with NULL never passes, so only non null constants imply that the tag exists
+			string value;
+			if (TryGetConstantString(constant, value) && TryGetTagValueKey(tag, get, filter.key)) {
+				// The value is only matched exactly if it is a string, not e.g. a number cast from the tag
+				auto &tag_type = tag.return_type;
+				filter.has_value = is_equal && tag_type.id() == LogicalTypeId::VARCHAR;
+				filter.value = value;
+				return true;
+			}
+		}
+		return false;
+	}
+	default:
+		return false;
+	}
+}
+
+static void PushdownComplexFilter(ClientContext &context, LogicalGet &get, FunctionData *bind_data_p,
+                                  vector<unique_ptr<Expression>> &filters) {
+	auto &bind_data = bind_data_p->Cast<BindData>();
+	for (auto &filter : filters) {
+		uint8_t kinds;
+		OsmTagFilter tag_filter;
+		if (TryGetKindFilter(*filter, get, kinds)) {
+			bind_data.kinds &= kinds;
+		} else if (TryGetTagFilter(*filter, get, tag_filter)) {
+			bind_data.tag_filters.push_back(tag_filter);
+		}
+	}
+}
+
 enum class FileBlockType { Header, Data };
 
 struct OsmBlob {
 	FileBlockType type;
-	AllocatedData data;
+	// The blobs are slices of a larger read, which is kept alive until all of them have been inflated
+	shared_ptr<AllocatedData> buffer;
+	const_data_ptr_t data;
 	idx_t size;
 	idx_t blob_idx;
+	// The offset in the file right after the blob
+	idx_t end_offset;
 
-	explicit OsmBlob(FileBlockType type, AllocatedData data, idx_t size, idx_t blob_idx)
-	    : type(type), data(std::move(data)), size(size), blob_idx(blob_idx) {
+	explicit OsmBlob(FileBlockType type, shared_ptr<AllocatedData> buffer, const_data_ptr_t data, idx_t size,
+	                 idx_t blob_idx, idx_t end_offset)
+	    : type(type), buffer(std::move(buffer)), data(data), size(size), blob_idx(blob_idx), end_offset(end_offset) {
 	}
 };
 
@@ -121,7 +381,7 @@ struct FileBlock {
 static unique_ptr<FileBlock> DecompressBlob(ClientContext &context, OsmBlob &blob) {
 
 	auto &buffer_manager = BufferManager::GetBufferManager(context);
-	pz::pbf_reader reader((const char *)blob.data.get(), blob.size);
+	pz::pbf_reader reader((const char *)blob.data, blob.size);
 
 	// TODO: For now we assume they are all zlib compressed
 	reader.next(2);
@@ -151,20 +411,292 @@ static unique_ptr<FileBlock> DecompressBlob(ClientContext &context, OsmBlob &blo
 	return make_uniq<FileBlock>(blob.type, std::move(uncompressed_handle), blob_uncompressed_size, blob.blob_idx);
 };
 
+// The format is a repeating sequence of:
+//    int4: length of the BlobHeader message in network byte order
+//    serialized BlobHeader message
+//    serialized Blob message (size is given in the header)
+static constexpr idx_t OSM_MAX_BLOB_HEADER_SIZE = 64 * 1024;
+
+static void ReadBlobHeader(const_data_ptr_t header, idx_t header_length, FileBlockType &type, idx_t &blob_length) {
+	pz::pbf_reader reader((const char *)header, header_length);
+
+	// 1 - type of the blob
+	reader.next(1);
+	auto type_str = reader.get_string();
+	if (type_str == "OSMHeader") {
+		type = FileBlockType::Header;
+	} else if (type_str == "OSMData") {
+		type = FileBlockType::Data;
+	} else {
+		throw ParserException("Unexpected fileblock type in Blob");
+	}
+	// 3 - size of the next blob
+	reader.next(3);
+	blob_length = static_cast<idx_t>(reader.get_int32());
+}
+
+//------------------------------------------------------------------------------
+// Blob Table
+//------------------------------------------------------------------------------
+// Finding a blob requires the header of the one before it, so by default the blobs are discovered sequentially. A
+// pre-scan that only reads the headers records where every blob is instead, after which the threads claim blobs by
+// index and read them independently, with as many range requests in flight as there are threads. The table is kept
+// in the object cache of the database, and optionally in a file given with "blob_index_file". Remote files are only
+// pre-scanned when such a file is given, as reading every header with a request of its own is slow.
+
+struct OsmBlobTableEntry {
+	FileBlockType type;
+	// The range of the Blob message in the file
+	idx_t offset;
+	idx_t size;
+};
+
+class OsmBlobTableCacheEntry : public ObjectCacheEntry {
+public:
+	time_t last_modified = 0;
+	idx_t file_size = 0;
+	vector<OsmBlobTableEntry> blobs;
+
+	static string ObjectType() {
+		return "spatial_osm_blob_table";
+	}
+	string GetObjectType() override {
+		return ObjectType();
+	}
+};
+
+// The header of a size prefix and a BlobHeader is usually read with a single request of this size
+static constexpr idx_t OSM_BLOB_HEADER_READ_SIZE = 64;
+
+static void ScanBlobTable(FileHandle &handle, idx_t file_size, vector<OsmBlobTableEntry> &result) {
+	vector<data_t> buffer;
+	idx_t offset = 0;
+	while (offset < file_size) {
+		auto read_size = MinValue(OSM_BLOB_HEADER_READ_SIZE, file_size - offset);
+		if (read_size < sizeof(int32_t)) {
+			throw ParserException("Unexpected end of OSM file");
+		}
+		buffer.resize(read_size);
+		handle.Read(buffer.data(), read_size, offset);
+		auto header_length = static_cast<idx_t>(static_cast<uint32_t>(ReadInt32BigEndian(buffer.data())));
+		if (header_length > OSM_MAX_BLOB_HEADER_SIZE || header_length > file_size - offset - sizeof(int32_t)) {
+			throw ParserException("Invalid blob header in OSM file at offset %llu", offset);
+		}
+		if (sizeof(int32_t) + header_length > read_size) {
+			buffer.resize(sizeof(int32_t) + header_length);
+			handle.Read(buffer.data(), buffer.size(), offset);
+		}
+
+		OsmBlobTableEntry entry;
+		ReadBlobHeader(buffer.data() + sizeof(int32_t), header_length, entry.type, entry.size);
+		entry.offset = offset + sizeof(int32_t) + header_length;
+		if (entry.size > file_size - entry.offset) {
+			throw ParserException("Unexpected end of OSM file");
+		}
+		result.push_back(entry);
+		offset = entry.offset + entry.size;
+	}
+}
+
+// The blob index file holds the size and modification time of the file it was built from, followed by the table
+static constexpr const char *OSM_BLOB_INDEX_MAGIC = "OSMBLOB1";
+static constexpr idx_t OSM_BLOB_INDEX_HEADER_SIZE = 32;
+static constexpr idx_t OSM_BLOB_INDEX_ENTRY_SIZE = 17;
+
+static bool TryReadBlobIndexFile(FileSystem &fs, const string &path, OsmBlobTableCacheEntry &table) {
+	if (!fs.FileExists(path)) {
+		return false;
+	}
+	auto handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_READ);
+	auto size = handle->GetFileSize();
+	if (size < OSM_BLOB_INDEX_HEADER_SIZE) {
+		return false;
+	}
+	vector<data_t> buffer(size);
+	handle->Read(buffer.data(), size, 0);
+	auto data = buffer.data();
+	if (memcmp(data, OSM_BLOB_INDEX_MAGIC, 8) != 0 || Load<uint64_t>(data + 8) != table.file_size ||
+	    Load<int64_t>(data + 16) != static_cast<int64_t>(table.last_modified)) {
+		// Built from another version of the file
+		return false;
+	}
+	auto count = Load<uint64_t>(data + 24);
+	if (count != (size - OSM_BLOB_INDEX_HEADER_SIZE) / OSM_BLOB_INDEX_ENTRY_SIZE) {
+		return false;
+	}
+	table.blobs.resize(count);
+	auto entry_ptr = data + OSM_BLOB_INDEX_HEADER_SIZE;
+	for (auto &entry : table.blobs) {
+		entry.offset = Load<uint64_t>(entry_ptr);
+		entry.size = Load<uint64_t>(entry_ptr + 8);
+		entry.type = entry_ptr[16] == 0 ? FileBlockType::Header : FileBlockType::Data;
+		if (entry.offset > table.file_size || entry.size > table.file_size - entry.offset) {
+			throw IOException("Invalid OSM blob index file: %s", path);
+		}
+		entry_ptr += OSM_BLOB_INDEX_ENTRY_SIZE;
+	}
+	return true;
+}
+
+static void WriteBlobIndexFile(FileSystem &fs, const string &path, const OsmBlobTableCacheEntry &table) {
+	vector<data_t> buffer(OSM_BLOB_INDEX_HEADER_SIZE + table.blobs.size() * OSM_BLOB_INDEX_ENTRY_SIZE);
+	auto data = buffer.data();
+	memcpy(data, OSM_BLOB_INDEX_MAGIC, 8);
+	Store<uint64_t>(table.file_size, data + 8);
+	Store<int64_t>(static_cast<int64_t>(table.last_modified), data + 16);
+	Store<uint64_t>(table.blobs.size(), data + 24);
+	auto entry_ptr = data + OSM_BLOB_INDEX_HEADER_SIZE;
+	for (auto &entry : table.blobs) {
+		Store<uint64_t>(entry.offset, entry_ptr);
+		Store<uint64_t>(entry.size, entry_ptr + 8);
+		entry_ptr[16] = entry.type == FileBlockType::Header ? 0 : 1;
+		entry_ptr += OSM_BLOB_INDEX_ENTRY_SIZE;
+	}
+	auto handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE_NEW);
+	handle->Write(data, buffer.size());
+	handle->Sync();
+}
+
+// Get the blob table of the file from the cache or the blob index file, or pre-scan the file. Returns nullptr if the
+// blobs should be discovered while reading instead.
+static shared_ptr<OsmBlobTableCacheEntry> GetBlobTable(ClientContext &context, const BindData &bind_data,
+                                                       FileHandle &handle) {
+	auto &fs = FileSystem::GetFileSystem(context);
+	auto last_modified = fs.GetLastModifiedTime(handle);
+	auto file_size = handle.GetFileSize();
+
+	auto cache_key = "spatial_osm_blob_table:" + bind_data.file_name;
+	auto &cache = ObjectCache::GetObjectCache(context);
+	auto cache_entry = cache.Get<OsmBlobTableCacheEntry>(cache_key);
+	if (cache_entry && cache_entry->last_modified == last_modified && cache_entry->file_size == file_size) {
+		return cache_entry;
+	}
+
+	auto &index_file = bind_data.blob_index_file;
+	if (index_file.empty() && FileSystem::IsRemoteFile(bind_data.file_name)) {
+		return nullptr;
+	}
+	auto entry = make_shared<OsmBlobTableCacheEntry>();
+	entry->last_modified = last_modified;
+	entry->file_size = file_size;
+	if (index_file.empty() || !TryReadBlobIndexFile(fs, index_file, *entry)) {
+		ScanBlobTable(handle, file_size, entry->blobs);
+		if (!index_file.empty()) {
+			WriteBlobIndexFile(fs, index_file, *entry);
+		}
+	}
+	cache.Put(cache_key, entry);
+	return entry;
+}
+
+//------------------------------------------------------------------------------
+// Read Ahead
+//------------------------------------------------------------------------------
+// The file is read in large sequential ranges that are split into blobs and queued. When fewer blobs than threads
+// are queued, the thread that takes a blob reads the next range outside of the lock, so reading overlaps with the
+// other threads inflating and parsing the queued blobs. Threads only wait for a read when the queue runs empty.
+// The ranges are in turn read in blocks with "spatial_io_queue_depth" reads in flight, so the device is kept busy
+// while the blobs of the previous range are split.
+
+static constexpr idx_t OSM_READ_AHEAD_SIZE = 16 * 1024 * 1024;
+static constexpr idx_t OSM_READ_BLOCK_SIZE = 4 * 1024 * 1024;
+
+//------------------------------------------------------------------------------
+// Block Index
+//------------------------------------------------------------------------------
+// The bounds of the nodes in each block of a file are recorded while it is scanned with a spatial filter, and kept in
+// the object cache of the database. Later scans of the same, unchanged file with a spatial filter skip the blocks that
+// only contain nodes outside of the filter without inflating them. This works best on files sorted by id, where the
+// nodes of a block are spatially coherent.
+
+class OsmBlockIndexCacheEntry : public ObjectCacheEntry {
+public:
+	time_t last_modified = 0;
+	idx_t file_size = 0;
+
+	static string ObjectType() {
+		return "spatial_osm_block_index";
+	}
+	string GetObjectType() override {
+		return ObjectType();
+	}
+
+	void SetBlockBounds(idx_t block_idx, bool only_nodes, const BoundingBox &node_bounds) {
+		lock_guard<mutex> guard(lock);
+		if (block_idx >= blocks.size()) {
+			blocks.resize(block_idx + 1);
+		}
+		auto &block = blocks[block_idx];
+		block.indexed = true;
+		block.only_nodes = only_nodes;
+		block.node_bounds = node_bounds;
+	}
+
+	bool CanSkipBlock(idx_t block_idx, const BoundingBox &filter) {
+		lock_guard<mutex> guard(lock);
+		if (block_idx >= blocks.size()) {
+			return false;
+		}
+		auto &block = blocks[block_idx];
+		return block.indexed && block.only_nodes && !block.node_bounds.Intersects(filter);
+	}
+
+private:
+	struct BlockBounds {
+		bool indexed = false;
+		bool only_nodes = false;
+		BoundingBox node_bounds;
+	};
+
+	mutex lock;
+	vector<BlockBounds> blocks;
+};
+
+class OsmGeometryIndex;
+
 class GlobalState : public GlobalTableFunctionState {
 	mutex lock;
+	std::condition_variable read_done;
 	unique_ptr<FileHandle> handle;
 	idx_t file_size;
-	idx_t offset;
-	bool done;
+	idx_t max_threads;
+
+	// The blobs that have been read but not handed out yet
+	std::deque<unique_ptr<OsmBlob>> blobs;
 	idx_t blob_index;
 	atomic<idx_t> bytes_read;
-	idx_t max_threads;
+
+	// Set while a thread is reading the next range, only one thread reads at a time
+	bool reading;
+	string read_error;
+	// The offset of the next range, and the bytes of an incomplete blob at the end of the previous range
+	idx_t read_offset;
+	AllocatedData remainder;
+	idx_t remainder_size;
+	// Reads the blocks of the next ranges ahead, unless the reads are synchronous
+	unique_ptr<ReadAheadBuffer> read_ahead;
+
+	// With a blob table the blobs are claimed by index instead. Every read uses a handle of its own, as the
+	// positional reads of a remote file handle go through a buffer of the handle.
+	shared_ptr<OsmBlobTableCacheEntry> blob_table;
+	atomic<idx_t> next_blob;
+	vector<unique_ptr<FileHandle>> idle_handles;
 
 public:
-	GlobalState(unique_ptr<FileHandle> handle, idx_t file_size, idx_t max_threads)
-	    : handle(std::move(handle)), file_size(file_size), offset(0), done(false), blob_index(0), bytes_read(0),
-	      max_threads(max_threads) {
+	// The node locations and member ways to assemble geometries from, if requested
+	shared_ptr<OsmGeometryIndex> geometry_index;
+
+	// Set with a spatial filter, nodes_outside_filter is set if the header bbox of the file is outside of it
+	shared_ptr<OsmBlockIndexCacheEntry> block_index;
+	bool nodes_outside_filter = false;
+
+	GlobalState(unique_ptr<FileHandle> handle_p, idx_t file_size, idx_t max_threads, idx_t queue_depth,
+	            shared_ptr<OsmBlobTableCacheEntry> blob_table_p = nullptr)
+	    : handle(std::move(handle_p)), file_size(file_size), max_threads(max_threads), blob_index(0), bytes_read(0),
+	      reading(false), read_offset(0), remainder_size(0), blob_table(std::move(blob_table_p)), next_blob(0) {
+		if (!blob_table && queue_depth > 1 && handle->CanSeek()) {
+			read_ahead = make_uniq<ReadAheadBuffer>(*handle, OSM_READ_BLOCK_SIZE, queue_depth);
+		}
 	}
 
 	double GetProgress() {
@@ -176,63 +708,557 @@ public:
 	}
 
 	unique_ptr<OsmBlob> GetNextBlob(ClientContext &context) {
-		lock_guard<mutex> glock(lock);
+		if (blob_table) {
+			return ReadIndexedBlob(context);
+		}
+		unique_lock<mutex> glock(lock);
+		while (true) {
+			if (!read_error.empty()) {
+				throw IOException(read_error);
+			}
+			if (!blobs.empty()) {
+				auto blob = std::move(blobs.front());
+				blobs.pop_front();
+				bytes_read = blob->end_offset;
+				if (!reading && !IsFileDone() && blobs.size() < max_threads) {
+					ReadAhead(context, glock);
+				}
+				return blob;
+			}
+			if (IsFileDone()) {
+				return nullptr;
+			}
+			if (reading) {
+				read_done.wait(glock);
+				continue;
+			}
+			ReadAhead(context, glock);
+		}
+	}
 
-		if (done) {
+private:
+	unique_ptr<OsmBlob> ReadIndexedBlob(ClientContext &context) {
+		auto idx = next_blob++;
+		if (idx >= blob_table->blobs.size()) {
 			return nullptr;
 		}
-		if (offset >= file_size) {
-			done = true;
-			return nullptr;
+		auto &entry = blob_table->blobs[idx];
+
+		unique_ptr<FileHandle> file;
+		{
+			lock_guard<mutex> glock(lock);
+			if (!idle_handles.empty()) {
+				file = std::move(idle_handles.back());
+				idle_handles.pop_back();
+			}
+		}
+		if (!file) {
+			auto &fs = FileSystem::GetFileSystem(context);
+			file = fs.OpenFile(handle->path, FileFlags::FILE_FLAGS_READ, FileLockType::READ_LOCK);
+		}
+
+		auto &allocator = BufferManager::GetBufferManager(context).GetBufferAllocator();
+		auto buffer = make_shared<AllocatedData>(allocator.Allocate(entry.size));
+		file->Read(buffer->get(), entry.size, entry.offset);
+		{
+			lock_guard<mutex> glock(lock);
+			idle_handles.push_back(std::move(file));
 		}
+		bytes_read += entry.size;
 
-		auto &buffer_manager = BufferManager::GetBufferManager(context);
+		auto end_offset = entry.offset + entry.size;
+		return make_uniq<OsmBlob>(entry.type, buffer, buffer->get(), entry.size, idx, end_offset);
+	}
+
+	bool IsFileDone() const {
+		return read_offset >= file_size && remainder_size == 0;
+	}
+
+	// Read the next range without holding the lock, and queue the blobs in it
+	void ReadAhead(ClientContext &context, unique_lock<mutex> &glock) {
+		reading = true;
+		auto offset = read_offset;
+		auto previous = std::move(remainder);
+		auto previous_size = remainder_size;
+		glock.unlock();
+
+		vector<unique_ptr<OsmBlob>> result;
+		idx_t next_remainder_size = 0;
+		AllocatedData next_remainder;
+		try {
+			auto read_size = MinValue<idx_t>(OSM_READ_AHEAD_SIZE, file_size - offset);
+			auto &allocator = BufferManager::GetBufferManager(context).GetBufferAllocator();
+			auto buffer = make_shared<AllocatedData>(allocator.Allocate(previous_size + read_size));
+			if (previous_size > 0) {
+				memcpy(buffer->get(), previous.get(), previous_size);
+			}
+			if (read_ahead) {
+				read_ahead->Read(buffer->get() + previous_size, read_size, offset);
+			} else {
+				handle->Read(buffer->get() + previous_size, read_size, offset);
+			}
+			offset += read_size;
+
+			auto buffer_size = previous_size + read_size;
+			auto consumed = SplitBlobs(buffer, buffer_size, offset - buffer_size, result);
+			next_remainder_size = buffer_size - consumed;
+			if (next_remainder_size > 0) {
+				if (offset >= file_size) {
+					throw ParserException("Unexpected end of OSM file");
+				}
+				next_remainder = allocator.Allocate(next_remainder_size);
+				memcpy(next_remainder.get(), buffer->get() + consumed, next_remainder_size);
+			}
+		} catch (std::exception &ex) {
+			glock.lock();
+			reading = false;
+			read_error = ex.what();
+			read_done.notify_all();
+			throw;
+		}
+
+		glock.lock();
+		for (auto &blob : result) {
+			blob->blob_idx = blob_index++;
+			blobs.push_back(std::move(blob));
+		}
+		read_offset = offset;
+		remainder = std::move(next_remainder);
+		remainder_size = next_remainder_size;
+		reading = false;
+		read_done.notify_all();
+	}
+
+	// Returns how many bytes of the buffer are complete blobs
+	static idx_t SplitBlobs(const shared_ptr<AllocatedData> &buffer, idx_t buffer_size, idx_t buffer_offset,
+	                        vector<unique_ptr<OsmBlob>> &result) {
+		auto data = buffer->get();
+		idx_t pos = 0;
+		while (pos + sizeof(int32_t) <= buffer_size) {
+			auto header_length = static_cast<idx_t>(ReadInt32BigEndian(data + pos));
+			auto header_ptr = data + pos + sizeof(int32_t);
+			if (pos + sizeof(int32_t) + header_length > buffer_size) {
+				break;
+			}
 
-		// The format is a repeating sequence of:
-		//    int4: length of the BlobHeader message in network byte order
-		//    serialized BlobHeader message
-		//    serialized Blob message (size is given in the header)
+			FileBlockType type;
+			idx_t blob_length;
+			ReadBlobHeader(header_ptr, header_length, type, blob_length);
 
-		// Read the length of the BlobHeader
-		int32_t header_length_be = 0;
-		handle->Read((data_ptr_t)&header_length_be, sizeof(int32_t), offset);
-		offset += sizeof(int32_t);
-		int32_t header_length = ReadInt32BigEndian((data_ptr_t)&header_length_be);
+			auto blob_end = pos + sizeof(int32_t) + header_length + blob_length;
+			if (blob_end > buffer_size) {
+				break;
+			}
+			// The index is assigned when the blob is queued
+			result.push_back(make_uniq<OsmBlob>(type, buffer, header_ptr + header_length, blob_length, 0,
+			                                    buffer_offset + blob_end));
+			pos = blob_end;
+		}
+		return pos;
+	}
+};
 
-		// Read the BlobHeader
-		auto header_buffer = buffer_manager.GetBufferAllocator().Allocate(header_length);
-		handle->Read(header_buffer.get(), header_length, offset);
+//------------------------------------------------------------------------------
+// Geometry Index
+//------------------------------------------------------------------------------
+// To assemble geometries, the file is read ahead of the scan to collect the location of every node, and then again
+// (only if there are multipolygon relations) to collect the refs of the ways that are members of them. Like osmium,
+// locations are stored as 32-bit fixed point coordinates in 1e-7 degrees next to the sorted node ids, so looking up
+// a node is a binary search. PBF files are usually sorted by id, in which case no sorting is needed.
 
-		pz::pbf_reader reader((const char *)header_buffer.get(), header_length);
+class OsmGeometryIndex {
+public:
+	void Build(ClientContext &context, const string &file_name) {
+		ForEachBlock(context, file_name, [&](const FileBlock &block) { ScanLocations(block); });
+		if (!sorted) {
+			SortLocations();
+		}
+		if (!member_ways.empty()) {
+			ForEachBlock(context, file_name, [&](const FileBlock &block) { ScanMemberWays(block); });
+		}
+		member_ways.clear();
+	}
 
-		// 1 - type of the blob
-		reader.next(1);
-		auto type_str = reader.get_string();
-		FileBlockType type;
-		if (type_str == "OSMHeader") {
-			type = FileBlockType::Header;
-		} else if (type_str == "OSMData") {
-			type = FileBlockType::Data;
-		} else {
-			throw ParserException("Unexpected fileblock type in Blob");
+	bool TryGetLocation(int64_t id, double &lon, double &lat) const {
+		auto entry = std::lower_bound(node_ids.begin(), node_ids.end(), id);
+		if (entry == node_ids.end() || *entry != id) {
+			return false;
 		}
-		// 3 - size of the next blob
-		reader.next(3);
-		auto blob_length = reader.get_int32(); // size of the next blob
+		auto offset = (entry - node_ids.begin()) * 2;
+		lon = node_coords[offset] * 0.0000001;
+		lat = node_coords[offset + 1] * 0.0000001;
+		return true;
+	}
 
-		offset += header_length;
+	const vector<int64_t> *GetWayRefs(int64_t id) const {
+		auto entry = way_refs.find(id);
+		return entry == way_refs.end() ? nullptr : &entry->second;
+	}
 
-		// Read the Blob
-		auto blob_buffer = buffer_manager.GetBufferAllocator().Allocate(blob_length);
-		handle->Read(blob_buffer.get(), blob_length, offset);
+private:
+	vector<int64_t> node_ids;
+	// Interleaved lon/lat pairs
+	vector<int32_t> node_coords;
+	bool sorted = true;
+
+	unordered_set<int64_t> member_ways;
+	unordered_map<int64_t, vector<int64_t>> way_refs;
+
+	// The primitive groups and coordinate encoding of a block
+	struct BlockGroups {
+		vector<string> string_table;
+		vector<pz::data_view> groups;
+		int32_t granularity = 100;
+		int64_t lat_offset = 0;
+		int64_t lon_offset = 0;
+	};
+
+	template <class FUNC>
+	static void ForEachBlock(ClientContext &context, const string &file_name, FUNC &&func) {
+		auto &fs = FileSystem::GetFileSystem(context);
+		auto handle = fs.OpenFile(file_name, FileFlags::FILE_FLAGS_READ, FileLockType::READ_LOCK);
+		auto file_size = handle->GetFileSize();
+		GlobalState reader(std::move(handle), file_size, 1);
+		while (true) {
+			auto blob = reader.GetNextBlob(context);
+			if (!blob) {
+				break;
+			}
+			if (blob->type != FileBlockType::Data) {
+				continue;
+			}
+			auto block = DecompressBlob(context, *blob);
+			func(*block);
+		}
+	}
+
+	static BlockGroups ReadBlockGroups(const FileBlock &block, bool read_string_table) {
+		BlockGroups result;
+		pz::pbf_reader block_reader((const char *)block.data.get(), block.size);
+		while (block_reader.next()) {
+			switch (block_reader.tag()) {
+			case 1: { // String table
+				if (!read_string_table) {
+					block_reader.skip();
+					break;
+				}
+				auto string_table_reader = block_reader.get_message();
+				while (string_table_reader.next(1)) {
+					result.string_table.push_back(string_table_reader.get_string());
+				}
+			} break;
+			case 2: // Primitive group
+				result.groups.push_back(block_reader.get_view());
+				break;
+			case 17:
+				result.granularity = block_reader.get_int32();
+				break;
+			case 19:
+				result.lat_offset = block_reader.get_int64();
+				break;
+			case 20:
+				result.lon_offset = block_reader.get_int64();
+				break;
+			default:
+				block_reader.skip();
+			}
+		}
+		return result;
+	}
 
-		offset += blob_length;
-		bytes_read = offset;
+	void AddLocation(const BlockGroups &groups, int64_t id, int64_t lat, int64_t lon) {
+		if (!node_ids.empty() && id <= node_ids.back()) {
+			sorted = false;
+		}
+		node_ids.push_back(id);
+		// Nanodegrees to 1e-7 degrees
+		node_coords.push_back(static_cast<int32_t>((groups.lon_offset + groups.granularity * lon) / 100));
+		node_coords.push_back(static_cast<int32_t>((groups.lat_offset + groups.granularity * lat) / 100));
+	}
 
-		return make_uniq<OsmBlob>(type, std::move(blob_buffer), blob_length, blob_index++);
+	void ScanLocations(const FileBlock &block) {
+		auto groups = ReadBlockGroups(block, true);
+		for (auto &group : groups.groups) {
+			pz::pbf_reader group_reader(group);
+			while (group_reader.next()) {
+				switch (group_reader.tag()) {
+				case 1: { // Node
+					auto node = group_reader.get_message();
+					int64_t id = 0, lat = 0, lon = 0;
+					while (node.next()) {
+						switch (node.tag()) {
+						case 1:
+							id = node.get_sint64();
+							break;
+						case 8:
+							lat = node.get_sint64();
+							break;
+						case 9:
+							lon = node.get_sint64();
+							break;
+						default:
+							node.skip();
+						}
+					}
+					AddLocation(groups, id, lat, lon);
+				} break;
+				case 2: { // Dense nodes
+					auto dense_nodes = group_reader.get_message();
+					pz::iterator_range<pz::const_svarint_iterator<int64_t>> ids;
+					pz::iterator_range<pz::const_svarint_iterator<int64_t>> lats;
+					pz::iterator_range<pz::const_svarint_iterator<int64_t>> lons;
+					while (dense_nodes.next()) {
+						switch (dense_nodes.tag()) {
+						case 1:
+							ids = dense_nodes.get_packed_sint64();
+							break;
+						case 8:
+							lats = dense_nodes.get_packed_sint64();
+							break;
+						case 9:
+							lons = dense_nodes.get_packed_sint64();
+							break;
+						default:
+							dense_nodes.skip();
+						}
+					}
+					int64_t id = 0, lat = 0, lon = 0;
+					auto lat_iter = lats.begin();
+					auto lon_iter = lons.begin();
+					for (auto id_delta : ids) {
+						if (lat_iter == lats.end() || lon_iter == lons.end()) {
+							break;
+						}
+						id += id_delta;
+						lat += *lat_iter++;
+						lon += *lon_iter++;
+						AddLocation(groups, id, lat, lon);
+					}
+				} break;
+				case 4: { // Relation
+					ScanRelationMembers(groups, group_reader.get_message());
+				} break;
+				default:
+					group_reader.skip();
+				}
+			}
+		}
+	}
+
+	// Remember the member ways of multipolygon relations
+	void ScanRelationMembers(const BlockGroups &groups, pz::pbf_reader relation) {
+		pz::iterator_range<pz::const_varint_iterator<uint32_t>> key_iter;
+		pz::iterator_range<pz::const_varint_iterator<uint32_t>> val_iter;
+		pz::iterator_range<pz::const_svarint_iterator<int64_t>> ref_iter;
+		pz::iterator_range<pz::const_varint_iterator<int32_t>> type_iter;
+		while (relation.next()) {
+			switch (relation.tag()) {
+			case 2:
+				key_iter = relation.get_packed_uint32();
+				break;
+			case 3:
+				val_iter = relation.get_packed_uint32();
+				break;
+			case 9:
+				ref_iter = relation.get_packed_sint64();
+				break;
+			case 10:
+				type_iter = relation.get_packed_int32();
+				break;
+			default:
+				relation.skip();
+			}
+		}
+
+		bool is_multipolygon = false;
+		auto vals = val_iter.begin();
+		for (auto key : key_iter) {
+			if (vals == val_iter.end()) {
+				break;
+			}
+			auto val = *vals++;
+			if (groups.string_table[key] == "type") {
+				is_multipolygon = IsMultipolygonType(groups.string_table[val]);
+			}
+		}
+		if (!is_multipolygon) {
+			return;
+		}
+
+		int64_t ref = 0;
+		auto types = type_iter.begin();
+		for (auto ref_delta : ref_iter) {
+			if (types == type_iter.end()) {
+				break;
+			}
+			ref += ref_delta;
+			if (*types++ == 1) {
+				member_ways.insert(ref);
+			}
+		}
+	}
+
+	void ScanMemberWays(const FileBlock &block) {
+		auto groups = ReadBlockGroups(block, false);
+		for (auto &group : groups.groups) {
+			pz::pbf_reader group_reader(group);
+			while (group_reader.next(3)) {
+				auto way = group_reader.get_message();
+				int64_t id = 0;
+				pz::iterator_range<pz::const_svarint_iterator<int64_t>> ref_iter;
+				while (way.next()) {
+					switch (way.tag()) {
+					case 1:
+						id = way.get_int64();
+						break;
+					case 8:
+						ref_iter = way.get_packed_sint64();
+						break;
+					default:
+						way.skip();
+					}
+				}
+				if (member_ways.find(id) == member_ways.end()) {
+					continue;
+				}
+				auto &refs = way_refs[id];
+				int64_t ref = 0;
+				for (auto ref_delta : ref_iter) {
+					ref += ref_delta;
+					refs.push_back(ref);
+				}
+			}
+		}
+	}
+
+	void SortLocations() {
+		vector<idx_t> order(node_ids.size());
+		for (idx_t i = 0; i < order.size(); i++) {
+			order[i] = i;
+		}
+		std::sort(order.begin(), order.end(), [&](idx_t a, idx_t b) { return node_ids[a] < node_ids[b]; });
+
+		vector<int64_t> sorted_ids(node_ids.size());
+		vector<int32_t> sorted_coords(node_coords.size());
+		for (idx_t i = 0; i < order.size(); i++) {
+			sorted_ids[i] = node_ids[order[i]];
+			sorted_coords[i * 2] = node_coords[order[i] * 2];
+			sorted_coords[i * 2 + 1] = node_coords[order[i] * 2 + 1];
+		}
+		node_ids = std::move(sorted_ids);
+		node_coords = std::move(sorted_coords);
+		sorted = true;
+	}
+
+public:
+	static bool IsMultipolygonType(const string &type) {
+		return type == "multipolygon" || type == "boundary";
 	}
 };
 
+//------------------------------------------------------------------------------
+// Geometry Assembly
+//------------------------------------------------------------------------------
+
+// Join ways into closed rings of node ids by matching their end points, returns false if a ring can not be closed
+static bool AssembleRings(const vector<const vector<int64_t> *> &ways, vector<vector<int64_t>> &rings) {
+	vector<bool> used(ways.size(), false);
+	for (idx_t i = 0; i < ways.size(); i++) {
+		if (used[i] || ways[i]->empty()) {
+			continue;
+		}
+		used[i] = true;
+		vector<int64_t> ring(*ways[i]);
+		while (ring.front() != ring.back()) {
+			bool extended = false;
+			for (idx_t j = 0; j < ways.size() && !extended; j++) {
+				auto &way = *ways[j];
+				if (used[j] || way.empty()) {
+					continue;
+				}
+				if (way.front() == ring.back()) {
+					ring.insert(ring.end(), way.begin() + 1, way.end());
+					used[j] = extended = true;
+				} else if (way.back() == ring.back()) {
+					ring.insert(ring.end(), way.rbegin() + 1, way.rend());
+					used[j] = extended = true;
+				}
+			}
+			if (!extended) {
+				return false;
+			}
+		}
+		if (ring.size() < 4) {
+			return false;
+		}
+		rings.push_back(std::move(ring));
+	}
+	return true;
+}
+
+static bool RingContainsPoint(const VertexArray &ring, double x, double y) {
+	bool inside = false;
+	auto count = ring.Count();
+	for (uint32_t i = 0, j = count - 1; i < count; j = i++) {
+		auto a = ring.Get(i);
+		auto b = ring.Get(j);
+		if ((a.y > y) != (b.y > y) && x < (b.x - a.x) * (y - a.y) / (b.y - a.y) + a.x) {
+			inside = !inside;
+		}
+	}
+	return inside;
+}
+
+// Returns false if the header block has no bbox
+static bool TryReadHeaderBBox(const FileBlock &header, BoundingBox &bbox) {
+	pz::pbf_reader header_reader((const char *)header.data.get(), header.size);
+	if (!header_reader.next(1)) {
+		return false;
+	}
+	// The bbox is in nanodegrees
+	auto bbox_reader = header_reader.get_message();
+	while (bbox_reader.next()) {
+		switch (bbox_reader.tag()) {
+		case 1:
+			bbox.minx = 0.000000001 * bbox_reader.get_sint64();
+			break;
+		case 2:
+			bbox.maxx = 0.000000001 * bbox_reader.get_sint64();
+			break;
+		case 3:
+			bbox.maxy = 0.000000001 * bbox_reader.get_sint64();
+			break;
+		case 4:
+			bbox.miny = 0.000000001 * bbox_reader.get_sint64();
+			break;
+		default:
+			bbox_reader.skip();
+		}
+	}
+	return true;
+}
+
+// Get the block index of the file from the cache if the file has not changed since it was cached
+static shared_ptr<OsmBlockIndexCacheEntry> GetBlockIndex(ClientContext &context, const string &file_name,
+                                                         FileHandle &handle) {
+	auto &fs = FileSystem::GetFileSystem(context);
+	auto last_modified = fs.GetLastModifiedTime(handle);
+	auto file_size = handle.GetFileSize();
+
+	auto cache_key = "spatial_osm_block_index:" + file_name;
+	auto &cache = ObjectCache::GetObjectCache(context);
+	auto cache_entry = cache.Get<OsmBlockIndexCacheEntry>(cache_key);
+	if (cache_entry && cache_entry->last_modified == last_modified && cache_entry->file_size == file_size) {
+		return cache_entry;
+	}
+
+	auto entry = make_shared<OsmBlockIndexCacheEntry>();
+	entry->last_modified = last_modified;
+	entry->file_size = file_size;
+	cache.Put(cache_key, entry);
+	return entry;
+}
+
 static unique_ptr<GlobalTableFunctionState> InitGlobal(ClientContext &context, TableFunctionInitInput &input) {
 	auto &bind_data = (BindData &)*input.bind_data;
 
@@ -242,27 +1268,101 @@ static unique_ptr<GlobalTableFunctionState> InitGlobal(ClientContext &context, T
 	auto handle = fs.OpenFile(file_name, FileFlags::FILE_FLAGS_READ, FileLockType::READ_LOCK);
 	auto file_size = handle->GetFileSize();
 
+	shared_ptr<OsmBlockIndexCacheEntry> block_index;
+	if (bind_data.has_spatial_filter) {
+		block_index = GetBlockIndex(context, file_name, *handle);
+	}
+	auto blob_table = GetBlobTable(context, bind_data, *handle);
+
 	auto max_threads = context.db->NumberOfThreads();
 
-	auto global_state = make_uniq<GlobalState>(std::move(handle), file_size, max_threads);
+	auto queue_depth = AsyncReader::GetQueueDepth(context);
+	auto global_state =
+	    make_uniq<GlobalState>(std::move(handle), file_size, max_threads, queue_depth, std::move(blob_table));
 
 	// Read the first blob to get the header
 	auto blob = global_state->GetNextBlob(context);
-	if (blob->type != FileBlockType::Header) {
+	if (!blob || blob->type != FileBlockType::Header) {
 		throw ParserException("First blob in file is not a header");
 	}
 
+	if (bind_data.has_spatial_filter) {
+		global_state->block_index = std::move(block_index);
+		auto header = DecompressBlob(context, *blob);
+		BoundingBox header_bbox;
+		if (TryReadHeaderBBox(*header, header_bbox) && !header_bbox.Intersects(bind_data.spatial_filter)) {
+			global_state->nodes_outside_filter = true;
+		}
+	}
+
+	if (bind_data.geometries) {
+		global_state->geometry_index = make_shared<OsmGeometryIndex>();
+		global_state->geometry_index->Build(context, file_name);
+	}
+
 	return std::move(global_state);
 }
 
 struct LocalState : LocalTableFunctionState {
+	const BindData &bind_data;
 	unique_ptr<FileBlock> block;
 	vector<string> string_table;
 	int32_t granularity;
 	int64_t lat_offset;
 	int64_t lon_offset;
 
-	explicit LocalState(unique_ptr<FileBlock> block) : block(std::move(block)) {
+	vector<column_t> column_ids;
+	// The output vector of each column in the current chunk, or nullptr if the column is not projected
+	Vector *columns[OSM_COLUMN_COUNT];
+	bool projected[OSM_COLUMN_COUNT];
+	// Tags are decoded if they are projected or needed to evaluate the tag filters
+	bool decode_tags;
+
+	// Set if the geometry column is projected
+	const OsmGeometryIndex *geometry_index;
+	GeometryFactory factory;
+
+	// The kinds to scan, without nodes if the file is outside of the spatial filter
+	uint8_t kinds;
+	const BoundingBox *spatial_filter;
+
+	// The bounds of the nodes in the current block, recorded in the block index once the whole block is scanned
+	OsmBlockIndexCacheEntry *block_index;
+	bool block_only_nodes;
+	bool block_nodes_skipped;
+	BoundingBox block_node_bounds;
+
+	// The string table ids of the keys (and values) of each tag filter in the current block
+	struct BlockTagFilter {
+		vector<uint32_t> keys;
+		vector<uint32_t> values;
+		bool has_value;
+	};
+	vector<BlockTagFilter> block_tag_filters;
+
+	LocalState(ClientContext &context, const BindData &bind_data, const vector<column_t> &column_ids,
+	           GlobalState &global, unique_ptr<FileBlock> block)
+	    : bind_data(bind_data), block(std::move(block)), column_ids(column_ids), geometry_index(nullptr),
+	      factory(BufferAllocator::Get(context)) {
+		for (idx_t i = 0; i < OSM_COLUMN_COUNT; i++) {
+			columns[i] = nullptr;
+			projected[i] = false;
+		}
+		for (auto column_id : column_ids) {
+			if (column_id < OSM_COLUMN_COUNT) {
+				projected[column_id] = true;
+			}
+		}
+		decode_tags = projected[OSM_TAGS_COLUMN] || !bind_data.tag_filters.empty();
+		if (projected[OSM_GEOMETRY_COLUMN]) {
+			geometry_index = global.geometry_index.get();
+		}
+		kinds = bind_data.kinds;
+		if (global.nodes_outside_filter) {
+			kinds &= ~(1 << OSM_KIND_NODE);
+		}
+		spatial_filter = bind_data.has_spatial_filter ? &bind_data.spatial_filter : nullptr;
+		block_index = global.block_index.get();
 		Reset();
 	}
 
@@ -271,20 +1371,79 @@ struct LocalState : LocalTableFunctionState {
 		Reset();
 	}
 
+	void SetOutput(DataChunk &output) {
+		factory.allocator.Reset();
+		for (idx_t i = 0; i < column_ids.size(); i++) {
+			auto column_id = column_ids[i];
+			if (column_id < OSM_COLUMN_COUNT) {
+				columns[column_id] = &output.data[i];
+			} else {
+				output.data[i].SetVectorType(VectorType::CONSTANT_VECTOR);
+				ConstantVector::SetNull(output.data[i], true);
+			}
+		}
+	}
+
 	void Reset() {
 		string_table.clear();
 		granularity = 100;
 		lat_offset = 0;
 		lon_offset = 0;
+		block_only_nodes = true;
+		block_nodes_skipped = false;
+		block_node_bounds = BoundingBox();
+
+		// Read the string table and the coordinate encoding, which follows the primitive groups
+		pz::pbf_reader header_reader((const char *)block->data.get(), block->size);
+		while (header_reader.next()) {
+			switch (header_reader.tag()) {
+			case 1: { // String table
+				auto string_table_reader = header_reader.get_message();
+				while (string_table_reader.next(1)) {
+					string_table.push_back(string_table_reader.get_string());
+				}
+			} break;
+			case 17: // Granularity
+				granularity = header_reader.get_int32();
+				break;
+			case 19: // Lat offset
+				lat_offset = header_reader.get_int64();
+				break;
+			case 20: // Lon offset
+				lon_offset = header_reader.get_int64();
+				break;
+			default:
+				header_reader.skip();
+			}
+		}
 
 		block_reader = pz::pbf_reader((const char *)block->data.get(), block->size);
-		block_reader.next(1); // String table
-		auto string_table_reader = block_reader.get_message();
-		while (string_table_reader.next(1)) {
-			string_table.push_back(string_table_reader.get_string());
+		state = ParseState::Block;
+
+		if (kinds == 0) {
+			state = ParseState::End;
+			return;
 		}
 
-		state = ParseState::Block;
+		// Skip the whole block if a required tag never appears in its string table
+		block_tag_filters.clear();
+		for (auto &filter : bind_data.tag_filters) {
+			BlockTagFilter block_filter;
+			block_filter.has_value = filter.has_value;
+			for (uint32_t i = 0; i < string_table.size(); i++) {
+				if (string_table[i] == filter.key) {
+					block_filter.keys.push_back(i);
+				}
+				if (filter.has_value && string_table[i] == filter.value) {
+					block_filter.values.push_back(i);
+				}
+			}
+			if (block_filter.keys.empty() || (filter.has_value && block_filter.values.empty())) {
+				state = ParseState::End;
+				return;
+			}
+			block_tag_filters.push_back(std::move(block_filter));
+		}
 	}
 
 	pz::pbf_reader block_reader;
@@ -296,62 +1455,94 @@ struct LocalState : LocalTableFunctionState {
 	vector<list_entry_t> dense_node_tag_entries;
 	vector<int64_t> dense_node_lats;
 	vector<int64_t> dense_node_lons;
+	// The coordinates in degrees, and the nodes inside of the spatial filter
+	vector<double> dense_node_xs;
+	vector<double> dense_node_ys;
+	vector<uint32_t> dense_node_selection;
+	idx_t dense_node_count;
+	bool has_dense_node_selection;
+
+	// The interleaved key and value ids of the tags of the entity being scanned
+	vector<uint32_t> entity_tags;
 
 	enum class ParseState { Block, Group, DenseNodes, End };
 
 	ParseState state = ParseState::Block;
 
+	bool ScanKind(uint8_t kind) const {
+		return kinds & (1 << kind);
+	}
+
+	void RecordBlockBounds() {
+		if (block_index && !block_nodes_skipped) {
+			block_index->SetBlockBounds(block->block_idx, block_only_nodes, block_node_bounds);
+		}
+	}
+
 	// Returns false if there is data left to read but we've reached the capacity
 	// Returns true if block is empty and we are done
-	bool TryRead(DataChunk &output, idx_t &index, idx_t capacity) {
+	bool TryRead(idx_t &index, idx_t capacity) {
 		// Main finite state machine
 		while (index < capacity) {
 			switch (state) {
 			case ParseState::Block:
 				if (block_reader.next(2)) {
 					group_reader = block_reader.get_message();
-
-					// Read the granularity and optional offsets
-					if (block_reader.next(17)) {
-						granularity = block_reader.get_int32();
-					}
-					if (block_reader.next(19)) {
-						lat_offset = block_reader.get_int64();
-					}
-					if (block_reader.next(20)) {
-						lon_offset = block_reader.get_int64();
-					}
 					state = ParseState::Group;
 				} else {
+					RecordBlockBounds();
 					state = ParseState::End;
 				}
 				break;
 			case ParseState::Group:
 				if (group_reader.next()) {
+					// Groups of kinds that are filtered out are skipped without decoding them
 					switch (group_reader.tag()) {
 					// Nodes
 					case 1: {
-						ScanNode(output, index, capacity);
+						if (ScanKind(OSM_KIND_NODE)) {
+							ScanNode(index);
+						} else {
+							block_nodes_skipped = true;
+							group_reader.skip();
+						}
 					} break;
 					// Dense nodes
 					case 2: {
-						PrepareDenseNodes(output, index, capacity);
-						state = ParseState::DenseNodes;
+						if (ScanKind(OSM_KIND_NODE)) {
+							PrepareDenseNodes();
+							state = ParseState::DenseNodes;
+						} else {
+							block_nodes_skipped = true;
+							group_reader.skip();
+						}
 					} break;
 					// Way
 					case 3: {
-						ScanWay(output, index, capacity);
+						block_only_nodes = false;
+						if (ScanKind(OSM_KIND_WAY)) {
+							ScanWay(index);
+						} else {
+							group_reader.skip();
+						}
 					} break;
 					// Relation
 					case 4: {
-						ScanRelation(output, index, capacity);
+						block_only_nodes = false;
+						if (ScanKind(OSM_KIND_RELATION)) {
+							ScanRelation(index);
+						} else {
+							group_reader.skip();
+						}
 					} break;
 					// Changeset
 					case 5: {
 						// Skip for now.
+						block_only_nodes = false;
 						group_reader.skip();
 					} break;
 					default: {
+						block_only_nodes = false;
 						group_reader.skip();
 					} break;
 					}
@@ -360,7 +1551,7 @@ struct LocalState : LocalTableFunctionState {
 				}
 				break;
 			case ParseState::DenseNodes: {
-				auto done = ScanDenseNodes(output, index, capacity);
+				auto done = ScanDenseNodes(index, capacity);
 				if (done) {
 					state = ParseState::Group;
 				}
@@ -373,19 +1564,296 @@ struct LocalState : LocalTableFunctionState {
 		return false;
 	}
 
-	void ScanNode(DataChunk &output, idx_t &index, idx_t capacity) {
+	// Returns true if the interleaved key/value ids pass all tag filters
+	bool MatchesTagFilters(const uint32_t *tags, idx_t tag_count) const {
+		for (auto &filter : block_tag_filters) {
+			bool found = false;
+			for (idx_t i = 0; i < tag_count && !found; i++) {
+				auto key = tags[i * 2];
+				if (std::find(filter.keys.begin(), filter.keys.end(), key) == filter.keys.end()) {
+					continue;
+				}
+				auto val = tags[i * 2 + 1];
+				found = !filter.has_value ||
+				        std::find(filter.values.begin(), filter.values.end(), val) != filter.values.end();
+			}
+			if (!found) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void ReadEntityTags(pz::iterator_range<pz::const_varint_iterator<uint32_t>> key_iter,
+	                    pz::iterator_range<pz::const_varint_iterator<uint32_t>> val_iter) {
+		entity_tags.clear();
+		auto keys = key_iter.begin();
+		auto vals = val_iter.begin();
+		while (keys != key_iter.end() && vals != val_iter.end()) {
+			entity_tags.push_back(*keys++);
+			entity_tags.push_back(*vals++);
+		}
+	}
+
+	void WriteKind(idx_t index, uint8_t kind) {
+		if (columns[OSM_KIND_COLUMN]) {
+			FlatVector::GetData<uint8_t>(*columns[OSM_KIND_COLUMN])[index] = kind;
+		}
+	}
+
+	void WriteId(idx_t index, int64_t id) {
+		if (columns[OSM_ID_COLUMN]) {
+			FlatVector::GetData<int64_t>(*columns[OSM_ID_COLUMN])[index] = id;
+		}
+	}
+
+	void WriteNull(idx_t index, idx_t column_idx) {
+		if (columns[column_idx]) {
+			FlatVector::SetNull(*columns[column_idx], index, true);
+		}
+	}
+
+	// Convert a coordinate of the block to degrees
+	double LatToDegrees(int64_t lat) const {
+		return 0.000000001 * (lat_offset + (granularity * lat));
+	}
+
+	double LonToDegrees(int64_t lon) const {
+		return 0.000000001 * (lon_offset + (granularity * lon));
+	}
+
+	bool InSpatialFilter(double x, double y) const {
+		return !spatial_filter || (x >= spatial_filter->minx && x <= spatial_filter->maxx &&
+		                           y >= spatial_filter->miny && y <= spatial_filter->maxy);
+	}
+
+	void WriteCoordinates(idx_t index, double x, double y) {
+		if (columns[OSM_LAT_COLUMN]) {
+			FlatVector::GetData<double>(*columns[OSM_LAT_COLUMN])[index] = y;
+		}
+		if (columns[OSM_LON_COLUMN]) {
+			FlatVector::GetData<double>(*columns[OSM_LON_COLUMN])[index] = x;
+		}
+	}
+
+	// Write interleaved key/value ids as a map
+	void WriteTags(idx_t index, const uint32_t *tags, idx_t tag_count) {
+		if (!columns[OSM_TAGS_COLUMN]) {
+			return;
+		}
+		auto &tag_vector = *columns[OSM_TAGS_COLUMN];
+		if (tag_count == 0) {
+			FlatVector::SetNull(tag_vector, index, true);
+			return;
+		}
+		auto total_tags = ListVector::GetListSize(tag_vector);
+		ListVector::Reserve(tag_vector, total_tags + tag_count);
+		ListVector::SetListSize(tag_vector, total_tags + tag_count);
+		auto &tag_entry = ListVector::GetData(tag_vector)[index];
+
+		tag_entry.offset = total_tags;
+		tag_entry.length = tag_count;
+
+		auto &key_vector = MapVector::GetKeys(tag_vector);
+		auto &value_vector = MapVector::GetValues(tag_vector);
+
+		for (idx_t i = 0; i < tag_count; i++) {
+			auto r = tag_entry.offset + i;
+			FlatVector::GetData<string_t>(key_vector)[r] =
+			    StringVector::AddString(key_vector, string_table[tags[i * 2]]);
+			FlatVector::GetData<string_t>(value_vector)[r] =
+			    StringVector::AddString(value_vector, string_table[tags[i * 2 + 1]]);
+		}
+	}
+
+	void WriteRefs(idx_t index, pz::iterator_range<pz::const_svarint_iterator<int64_t>> ref_iter) {
+		if (!columns[OSM_REFS_COLUMN]) {
+			return;
+		}
+		auto &refs_vector = *columns[OSM_REFS_COLUMN];
+		if (ref_iter.empty()) {
+			FlatVector::SetNull(refs_vector, index, true);
+			return;
+		}
+		auto ref_count = ref_iter.size();
+		auto total_refs = ListVector::GetListSize(refs_vector);
+		ListVector::Reserve(refs_vector, total_refs + ref_count);
+		ListVector::SetListSize(refs_vector, total_refs + ref_count);
+		auto &ref_entry = ListVector::GetData(refs_vector)[index];
+		auto &ref_vector = ListVector::GetEntry(refs_vector);
+		ref_entry.offset = total_refs;
+		ref_entry.length = ref_count;
+
+		auto ref_data = FlatVector::GetData<int64_t>(ref_vector);
+
+		int64_t last_ref = 0;
+		for (auto ref : ref_iter) {
+			last_ref += ref;
+			ref_data[total_refs++] = last_ref;
+		}
+	}
+
+	void WritePointGeometry(idx_t index, double x, double y) {
+		if (!geometry_index) {
+			return;
+		}
+		auto &geom_vector = *columns[OSM_GEOMETRY_COLUMN];
+		Point point(factory.allocator, x, y);
+		FlatVector::GetData<geometry_t>(geom_vector)[index] = factory.Serialize(geom_vector, point, false, false);
+	}
+
+	// Resolve the locations of the node refs, returns false if any node is missing from the file
+	bool TryResolveNodes(pz::iterator_range<pz::const_svarint_iterator<int64_t>> ref_iter, VertexArray &vertices) {
+		int64_t ref = 0;
+		uint32_t i = 0;
+		for (auto ref_delta : ref_iter) {
+			ref += ref_delta;
+			double lon, lat;
+			if (!geometry_index->TryGetLocation(ref, lon, lat)) {
+				return false;
+			}
+			vertices.Set(i++, lon, lat);
+		}
+		return true;
+	}
+
+	bool TryResolveNodes(const vector<int64_t> &refs, VertexArray &vertices) {
+		for (uint32_t i = 0; i < refs.size(); i++) {
+			double lon, lat;
+			if (!geometry_index->TryGetLocation(refs[i], lon, lat)) {
+				return false;
+			}
+			vertices.Set(i, lon, lat);
+		}
+		return true;
+	}
+
+	void WriteWayGeometry(idx_t index, pz::iterator_range<pz::const_svarint_iterator<int64_t>> ref_iter) {
+		if (!geometry_index) {
+			return;
+		}
+		auto &geom_vector = *columns[OSM_GEOMETRY_COLUMN];
+		auto ref_count = ref_iter.size();
+		LineString line(factory.allocator, ref_count, false, false);
+		if (ref_count < 2 || !TryResolveNodes(ref_iter, line.Vertices())) {
+			FlatVector::SetNull(geom_vector, index, true);
+			return;
+		}
+		FlatVector::GetData<geometry_t>(geom_vector)[index] = factory.Serialize(geom_vector, line, false, false);
+	}
+
+	// Assemble a multipolygon from the outer and inner member ways of a multipolygon relation. The geometry is NULL
+	// for other relations, and if a member is missing from the file or the rings can not be closed.
+	void WriteRelationGeometry(idx_t index, pz::iterator_range<pz::const_svarint_iterator<int64_t>> ref_iter,
+	                           pz::iterator_range<pz::const_varint_iterator<int32_t>> role_iter,
+	                           pz::iterator_range<pz::const_varint_iterator<int32_t>> type_iter) {
+		if (!geometry_index) {
+			return;
+		}
+		auto &geom_vector = *columns[OSM_GEOMETRY_COLUMN];
+		if (!TryBuildMultiPolygon(geom_vector, index, ref_iter, role_iter, type_iter)) {
+			FlatVector::SetNull(geom_vector, index, true);
+		}
+	}
+
+	bool TryBuildMultiPolygon(Vector &geom_vector, idx_t index,
+	                          pz::iterator_range<pz::const_svarint_iterator<int64_t>> ref_iter,
+	                          pz::iterator_range<pz::const_varint_iterator<int32_t>> role_iter,
+	                          pz::iterator_range<pz::const_varint_iterator<int32_t>> type_iter) {
+		bool is_multipolygon = false;
+		for (idx_t i = 0; i < entity_tags.size(); i += 2) {
+			if (string_table[entity_tags[i]] == "type") {
+				is_multipolygon = OsmGeometryIndex::IsMultipolygonType(string_table[entity_tags[i + 1]]);
+			}
+		}
+		if (!is_multipolygon) {
+			return false;
+		}
+
+		vector<const vector<int64_t> *> outer_ways;
+		vector<const vector<int64_t> *> inner_ways;
+		int64_t ref = 0;
+		auto roles = role_iter.begin();
+		auto types = type_iter.begin();
+		for (auto ref_delta : ref_iter) {
+			if (roles == role_iter.end() || types == type_iter.end()) {
+				return false;
+			}
+			ref += ref_delta;
+			auto &role = string_table[*roles++];
+			if (*types++ != 1) {
+				continue;
+			}
+			auto way_refs = geometry_index->GetWayRefs(ref);
+			if (!way_refs) {
+				return false;
+			}
+			if (role == "inner") {
+				inner_ways.push_back(way_refs);
+			} else {
+				outer_ways.push_back(way_refs);
+			}
+		}
+
+		vector<vector<int64_t>> outer_rings;
+		vector<vector<int64_t>> inner_rings;
+		if (!AssembleRings(outer_ways, outer_rings) || !AssembleRings(inner_ways, inner_rings) ||
+		    outer_rings.empty()) {
+			return false;
+		}
+
+		vector<VertexArray> outers;
+		for (auto &ring : outer_rings) {
+			outers.push_back(VertexArray::Create(factory.allocator, ring.size(), false, false));
+			if (!TryResolveNodes(ring, outers.back())) {
+				return false;
+			}
+		}
+
+		// Each inner ring becomes a hole of the first outer ring that contains it
+		vector<vector<VertexArray>> holes(outers.size());
+		for (auto &ring : inner_rings) {
+			auto inner = VertexArray::Create(factory.allocator, ring.size(), false, false);
+			if (!TryResolveNodes(ring, inner)) {
+				return false;
+			}
+			auto point = inner.Get(0);
+			for (idx_t i = 0; i < outers.size(); i++) {
+				if (RingContainsPoint(outers[i], point.x, point.y)) {
+					holes[i].push_back(inner);
+					break;
+				}
+			}
+		}
+
+		MultiPolygon multipolygon(factory.allocator, outers.size(), false, false);
+		for (idx_t i = 0; i < outers.size(); i++) {
+			Polygon polygon(factory.allocator, holes[i].size() + 1, false, false);
+			polygon[0] = outers[i];
+			for (idx_t j = 0; j < holes[i].size(); j++) {
+				polygon[j + 1] = holes[i][j];
+			}
+			multipolygon[i] = polygon;
+		}
+		FlatVector::GetData<geometry_t>(geom_vector)[index] =
+		    factory.Serialize(geom_vector, multipolygon, false, false);
+		return true;
+	}
+
+	void ScanNode(idx_t &index) {
 
 		auto node = group_reader.get_message();
 
+		int64_t id = 0;
+		int64_t lat = 0;
+		int64_t lon = 0;
 		pz::iterator_range<pz::const_varint_iterator<uint32_t>> key_iter;
 		pz::iterator_range<pz::const_varint_iterator<uint32_t>> val_iter;
 
 		while (node.next()) {
 			switch (node.tag()) {
 			case 1: { // ID
-				auto id = node.get_int64();
-				FlatVector::GetData<uint8_t>(output.data[0])[index] = 0;
-				FlatVector::GetData<int64_t>(output.data[1])[index] = id;
+				id = node.get_sint64();
 			} break;
 			case 2: { // Tag Keys
 				key_iter = node.get_packed_uint32();
@@ -394,53 +1862,59 @@ struct LocalState : LocalTableFunctionState {
 				val_iter = node.get_packed_uint32();
 			} break;
 			case 8: { // Lat
-				auto lat = node.get_sint64();
-				FlatVector::GetData<double>(output.data[4])[index] = 0.000000001 * (lat_offset + (granularity * lat));
+				lat = node.get_sint64();
 			} break;
 			case 9: { // Lon
-				auto lon = node.get_sint64();
-				FlatVector::GetData<double>(output.data[5])[index] = 0.000000001 * (lon_offset + (granularity * lon));
+				lon = node.get_sint64();
 			} break;
 			default:
 				node.skip();
 			}
 		}
 
-		// Read tags
-		if (!key_iter.empty() && !val_iter.empty()) {
-			auto tag_count = key_iter.size();
-			auto total_tags = ListVector::GetListSize(output.data[2]);
-			ListVector::Reserve(output.data[2], total_tags + tag_count);
-			ListVector::SetListSize(output.data[2], total_tags + tag_count);
-			auto &tag_entry = ListVector::GetData(output.data[2])[index];
-
-			tag_entry.offset = total_tags;
-			tag_entry.length = tag_count;
-
-			auto &key_vector = MapVector::GetKeys(output.data[2]);
-			auto &value_vector = MapVector::GetValues(output.data[2]);
+		auto x = LonToDegrees(lon);
+		auto y = LatToDegrees(lat);
+		block_node_bounds.minx = std::min(block_node_bounds.minx, x);
+		block_node_bounds.miny = std::min(block_node_bounds.miny, y);
+		block_node_bounds.maxx = std::max(block_node_bounds.maxx, x);
+		block_node_bounds.maxy = std::max(block_node_bounds.maxy, y);
+		if (!InSpatialFilter(x, y)) {
+			return;
+		}
 
-			auto keys = key_iter.begin();
-			auto vals = val_iter.begin();
-			for (idx_t i = tag_entry.offset; i < tag_entry.offset + tag_count; i++) {
-				FlatVector::GetData<string_t>(key_vector)[i] =
-				    StringVector::AddString(key_vector, string_table[*keys++]);
-				FlatVector::GetData<string_t>(value_vector)[i] =
-				    StringVector::AddString(value_vector, string_table[*vals++]);
+		entity_tags.clear();
+		if (decode_tags) {
+			ReadEntityTags(key_iter, val_iter);
+			if (!MatchesTagFilters(entity_tags.data(), entity_tags.size() / 2)) {
+				return;
 			}
-		} else {
-			FlatVector::SetNull(output.data[2], index, true);
 		}
 
+		WriteKind(index, OSM_KIND_NODE);
+		WriteId(index, id);
+		WriteTags(index, entity_tags.data(), entity_tags.size() / 2);
+		WriteCoordinates(index, x, y);
+		WritePointGeometry(index, x, y);
+
 		// Node has no refs, ref_roles or ref_types
-		FlatVector::SetNull(output.data[3], index, true);
-		FlatVector::SetNull(output.data[6], index, true);
-		FlatVector::SetNull(output.data[7], index, true);
+		WriteNull(index, OSM_REFS_COLUMN);
+		WriteNull(index, OSM_REF_ROLES_COLUMN);
+		WriteNull(index, OSM_REF_TYPES_COLUMN);
 
 		index++;
 	}
 
-	void PrepareDenseNodes(DataChunk &output, idx_t &index, idx_t capacity) {
+	// Running sums of the delta coded values, in place
+	static void DeltaDecode(vector<int64_t> &values) {
+		for (idx_t i = 1; i < values.size(); i++) {
+			values[i] += values[i - 1];
+		}
+	}
+
+	// The dense nodes of a group are decoded in bulk. The varints are read into arrays and delta decoded first, then
+	// converted to degrees and tested against the spatial filter in loops without dependencies between the nodes,
+	// which the compiler can vectorize.
+	void PrepareDenseNodes() {
 		dense_node_index = 0;
 		dense_node_ids.clear();
 		dense_node_tags.clear();
@@ -448,35 +1922,38 @@ struct LocalState : LocalTableFunctionState {
 		dense_node_lats.clear();
 		dense_node_lons.clear();
 
+		auto decode_coordinates =
+		    projected[OSM_LAT_COLUMN] || projected[OSM_LON_COLUMN] || geometry_index || spatial_filter;
+
 		auto dense_nodes = group_reader.get_message();
 
 		while (dense_nodes.next()) {
 			switch (dense_nodes.tag()) {
 			case 1: { // ID
 				auto ids = dense_nodes.get_packed_sint64();
-				int64_t last_id = 0;
-				for (auto id : ids) {
-					last_id += id;
-					dense_node_ids.push_back(last_id);
-				}
+				dense_node_ids.assign(ids.begin(), ids.end());
 			} break;
 			case 8: { // Lats
-				auto lats = dense_nodes.get_packed_sint64();
-				int64_t last_lat = 0;
-				for (auto lat : lats) {
-					last_lat += lat;
-					dense_node_lats.push_back(last_lat);
+				if (!decode_coordinates) {
+					dense_nodes.skip();
+					break;
 				}
+				auto lats = dense_nodes.get_packed_sint64();
+				dense_node_lats.assign(lats.begin(), lats.end());
 			} break;
 			case 9: { // Lons
-				auto lons = dense_nodes.get_packed_sint64();
-				int64_t last_lon = 0;
-				for (auto lon : lons) {
-					last_lon += lon;
-					dense_node_lons.push_back(last_lon);
+				if (!decode_coordinates) {
+					dense_nodes.skip();
+					break;
 				}
+				auto lons = dense_nodes.get_packed_sint64();
+				dense_node_lons.assign(lons.begin(), lons.end());
 			} break;
 			case 10: { // Tags
+				if (!decode_tags) {
+					dense_nodes.skip();
+					break;
+				}
 				auto tags = dense_nodes.get_packed_uint32();
 				idx_t entry_offset = 0;
 				for (auto tag : tags) {
@@ -493,11 +1970,62 @@ struct LocalState : LocalTableFunctionState {
 				dense_nodes.skip();
 			}
 		}
+
+		DeltaDecode(dense_node_ids);
+		dense_node_count = dense_node_ids.size();
+		has_dense_node_selection = false;
+
+		if (!decode_coordinates) {
+			dense_node_xs.clear();
+			dense_node_ys.clear();
+			return;
+		}
+		if (dense_node_lats.size() != dense_node_count || dense_node_lons.size() != dense_node_count) {
+			throw ParserException("Dense nodes have a different number of ids and coordinates");
+		}
+
+		DeltaDecode(dense_node_lats);
+		DeltaDecode(dense_node_lons);
+
+		dense_node_xs.resize(dense_node_count);
+		dense_node_ys.resize(dense_node_count);
+		auto lats = dense_node_lats.data();
+		auto lons = dense_node_lons.data();
+		auto xs = dense_node_xs.data();
+		auto ys = dense_node_ys.data();
+		for (idx_t i = 0; i < dense_node_count; i++) {
+			xs[i] = 0.000000001 * (lon_offset + (granularity * lons[i]));
+			ys[i] = 0.000000001 * (lat_offset + (granularity * lats[i]));
+		}
+
+		auto &bounds = block_node_bounds;
+		for (idx_t i = 0; i < dense_node_count; i++) {
+			bounds.minx = std::min(bounds.minx, xs[i]);
+			bounds.maxx = std::max(bounds.maxx, xs[i]);
+			bounds.miny = std::min(bounds.miny, ys[i]);
+			bounds.maxy = std::max(bounds.maxy, ys[i]);
+		}
+
+		if (spatial_filter) {
+			// Branch free, every index is written but only the ones inside of the filter are kept
+			auto &filter = *spatial_filter;
+			dense_node_selection.resize(dense_node_count);
+			auto selection = dense_node_selection.data();
+			idx_t selected = 0;
+			for (idx_t i = 0; i < dense_node_count; i++) {
+				selection[selected] = i;
+				selected += (xs[i] >= filter.minx) & (xs[i] <= filter.maxx) & (ys[i] >= filter.miny) &
+				            (ys[i] <= filter.maxy);
+			}
+			dense_node_count = selected;
+			has_dense_node_selection = true;
+		}
 	}
 
-	void ScanWay(DataChunk &output, idx_t &index, idx_t capacity) {
+	void ScanWay(idx_t &index) {
 		auto way = group_reader.get_message();
 
+		int64_t id = 0;
 		pz::iterator_range<pz::const_varint_iterator<uint32_t>> key_iter;
 		pz::iterator_range<pz::const_varint_iterator<uint32_t>> val_iter;
 		pz::iterator_range<pz::const_svarint_iterator<int64_t>> ref_iter;
@@ -505,13 +2033,7 @@ struct LocalState : LocalTableFunctionState {
 		while (way.next()) {
 			switch (way.tag()) {
 			case 1: { // ID
-				auto id = way.get_int64();
-				FlatVector::GetData<uint8_t>(output.data[0])[index] = 1;
-				FlatVector::GetData<int64_t>(output.data[1])[index] = id;
-				FlatVector::SetNull(output.data[4], index, true);
-				FlatVector::SetNull(output.data[5], index, true);
-				FlatVector::SetNull(output.data[6], index, true);
-				FlatVector::SetNull(output.data[7], index, true);
+				id = way.get_int64();
 			} break;
 			case 2: { // Tag Keys
 				key_iter = way.get_packed_uint32();
@@ -526,58 +2048,34 @@ struct LocalState : LocalTableFunctionState {
 				way.skip();
 			}
 		}
-		if (!key_iter.empty() && !val_iter.empty()) {
-			auto tag_count = key_iter.size();
-			auto total_tags = ListVector::GetListSize(output.data[2]);
-			ListVector::Reserve(output.data[2], total_tags + tag_count);
-			ListVector::SetListSize(output.data[2], total_tags + tag_count);
-			auto &tag_entry = ListVector::GetData(output.data[2])[index];
-
-			tag_entry.offset = total_tags;
-			tag_entry.length = tag_count;
 
-			auto &key_vector = MapVector::GetKeys(output.data[2]);
-			auto &value_vector = MapVector::GetValues(output.data[2]);
-
-			auto keys = key_iter.begin();
-			auto vals = val_iter.begin();
-			for (idx_t i = tag_entry.offset; i < tag_entry.offset + tag_count; i++) {
-				FlatVector::GetData<string_t>(key_vector)[i] =
-				    StringVector::AddString(key_vector, string_table[*keys++]);
-				FlatVector::GetData<string_t>(value_vector)[i] =
-				    StringVector::AddString(value_vector, string_table[*vals++]);
+		entity_tags.clear();
+		if (decode_tags) {
+			ReadEntityTags(key_iter, val_iter);
+			if (!MatchesTagFilters(entity_tags.data(), entity_tags.size() / 2)) {
+				return;
 			}
-		} else {
-			FlatVector::SetNull(output.data[2], index, true);
 		}
 
-		if (!ref_iter.empty()) {
-			auto ref_count = ref_iter.size();
-			auto total_refs = ListVector::GetListSize(output.data[3]);
-			ListVector::Reserve(output.data[3], total_refs + ref_count);
-			ListVector::SetListSize(output.data[3], total_refs + ref_count);
-			auto &ref_entry = ListVector::GetData(output.data[3])[index];
-			auto &ref_vector = ListVector::GetEntry(output.data[3]);
-			ref_entry.offset = total_refs;
-			ref_entry.length = ref_count;
-
-			auto ref_data = FlatVector::GetData<int64_t>(ref_vector);
+		WriteKind(index, OSM_KIND_WAY);
+		WriteId(index, id);
+		WriteTags(index, entity_tags.data(), entity_tags.size() / 2);
+		WriteRefs(index, ref_iter);
+		WriteWayGeometry(index, ref_iter);
 
-			int64_t last_ref = 0;
-			for (auto ref : ref_iter) {
-				last_ref += ref;
-				ref_data[total_refs++] = last_ref;
-			}
-		} else {
-			FlatVector::SetNull(output.data[3], index, true);
-		}
+		// Way has no coordinates, ref_roles or ref_types
+		WriteNull(index, OSM_LAT_COLUMN);
+		WriteNull(index, OSM_LON_COLUMN);
+		WriteNull(index, OSM_REF_ROLES_COLUMN);
+		WriteNull(index, OSM_REF_TYPES_COLUMN);
 
 		index++;
 	}
 
-	void ScanRelation(DataChunk &output, idx_t &index, idx_t capacity) {
+	void ScanRelation(idx_t &index) {
 		auto relation = group_reader.get_message();
 
+		int64_t id = 0;
 		pz::iterator_range<pz::const_varint_iterator<uint32_t>> key_iter;
 		pz::iterator_range<pz::const_varint_iterator<uint32_t>> val_iter;
 		pz::iterator_range<pz::const_varint_iterator<int32_t>> role_iter;
@@ -587,11 +2085,7 @@ struct LocalState : LocalTableFunctionState {
 		while (relation.next()) {
 			switch (relation.tag()) {
 			case 1: { // ID
-				auto id = relation.get_int64();
-				FlatVector::GetData<uint8_t>(output.data[0])[index] = 2;
-				FlatVector::GetData<int64_t>(output.data[1])[index] = id;
-				FlatVector::SetNull(output.data[4], index, true);
-				FlatVector::SetNull(output.data[5], index, true);
+				id = relation.get_int64();
 			} break;
 			case 2: { // Tag Keys
 				key_iter = relation.get_packed_uint32();
@@ -613,191 +2107,151 @@ struct LocalState : LocalTableFunctionState {
 			}
 		}
 
-		// Read tags
-		if (!key_iter.empty() && !val_iter.empty()) {
-			auto tag_count = key_iter.size();
-
-			auto total_tags = ListVector::GetListSize(output.data[2]);
-			ListVector::Reserve(output.data[2], total_tags + tag_count);
-			ListVector::SetListSize(output.data[2], total_tags + tag_count);
-			auto &tag_entry = ListVector::GetData(output.data[2])[index];
-
-			tag_entry.offset = total_tags;
-			tag_entry.length = tag_count;
-
-			auto &key_vector = MapVector::GetKeys(output.data[2]);
-			auto &value_vector = MapVector::GetValues(output.data[2]);
-
-			auto keys = key_iter.begin();
-			auto vals = val_iter.begin();
-			for (idx_t i = tag_entry.offset; i < tag_entry.offset + tag_count; i++) {
-				FlatVector::GetData<string_t>(key_vector)[i] =
-				    StringVector::AddString(key_vector, string_table[*keys++]);
-				FlatVector::GetData<string_t>(value_vector)[i] =
-				    StringVector::AddString(value_vector, string_table[*vals++]);
+		entity_tags.clear();
+		// The type tag tells if the relation is a multipolygon
+		if (decode_tags || geometry_index) {
+			ReadEntityTags(key_iter, val_iter);
+			if (!MatchesTagFilters(entity_tags.data(), entity_tags.size() / 2)) {
+				return;
 			}
-		} else {
-			FlatVector::SetNull(output.data[2], index, true);
 		}
 
-		// Roles
-		if (!role_iter.empty()) {
-			auto role_count = role_iter.size();
-
-			auto total_roles = ListVector::GetListSize(output.data[6]);
-			ListVector::Reserve(output.data[6], total_roles + role_count);
-			ListVector::SetListSize(output.data[6], total_roles + role_count);
-			auto &role_entry = ListVector::GetData(output.data[6])[index];
-			auto &role_vector = ListVector::GetEntry(output.data[6]);
-			role_entry.offset = total_roles;
-			role_entry.length = role_count;
-
-			auto roles = role_iter.begin();
-			for (idx_t i = role_entry.offset; i < role_entry.offset + role_count; i++) {
-				auto &role_str = string_table[*roles++];
-				if (role_str.empty()) {
-					FlatVector::SetNull(role_vector, i, true);
-				} else {
-					FlatVector::GetData<string_t>(role_vector)[i] = StringVector::AddString(role_vector, role_str);
-				}
-			}
-		} else {
-			FlatVector::SetNull(output.data[6], index, true);
-		}
-
-		// Refs
-		if (!ref_iter.empty()) {
-			auto ref_count = ref_iter.size();
-
-			auto total_refs = ListVector::GetListSize(output.data[3]);
-			ListVector::Reserve(output.data[3], total_refs + ref_count);
-			ListVector::SetListSize(output.data[3], total_refs + ref_count);
-			auto &ref_entry = ListVector::GetData(output.data[3])[index];
-			auto &ref_vector = ListVector::GetEntry(output.data[3]);
-			ref_entry.offset = total_refs;
-			ref_entry.length = ref_count;
+		WriteKind(index, OSM_KIND_RELATION);
+		WriteId(index, id);
+		WriteTags(index, entity_tags.data(), entity_tags.size() / 2);
+		WriteRefs(index, ref_iter);
+		WriteRelationGeometry(index, ref_iter, role_iter, type_iter);
 
-			auto ref_data = FlatVector::GetData<int64_t>(ref_vector);
+		// Relation has no coordinates
+		WriteNull(index, OSM_LAT_COLUMN);
+		WriteNull(index, OSM_LON_COLUMN);
 
-			int64_t last_ref = 0;
-			for (auto ref : ref_iter) {
-				last_ref += ref;
-				ref_data[total_refs++] = last_ref;
+		// Roles
+		if (columns[OSM_REF_ROLES_COLUMN]) {
+			auto &roles_vector = *columns[OSM_REF_ROLES_COLUMN];
+			if (!role_iter.empty()) {
+				auto role_count = role_iter.size();
+
+				auto total_roles = ListVector::GetListSize(roles_vector);
+				ListVector::Reserve(roles_vector, total_roles + role_count);
+				ListVector::SetListSize(roles_vector, total_roles + role_count);
+				auto &role_entry = ListVector::GetData(roles_vector)[index];
+				auto &role_vector = ListVector::GetEntry(roles_vector);
+				role_entry.offset = total_roles;
+				role_entry.length = role_count;
+
+				auto roles = role_iter.begin();
+				for (idx_t i = role_entry.offset; i < role_entry.offset + role_count; i++) {
+					auto &role_str = string_table[*roles++];
+					if (role_str.empty()) {
+						FlatVector::SetNull(role_vector, i, true);
+					} else {
+						FlatVector::GetData<string_t>(role_vector)[i] = StringVector::AddString(role_vector, role_str);
+					}
+				}
+			} else {
+				FlatVector::SetNull(roles_vector, index, true);
 			}
-		} else {
-			FlatVector::SetNull(output.data[3], index, true);
 		}
 
 		// Types
-		if (!type_iter.empty()) {
-			auto type_count = type_iter.size();
-
-			auto total_types = ListVector::GetListSize(output.data[7]);
-			ListVector::Reserve(output.data[7], total_types + type_count);
-			ListVector::SetListSize(output.data[7], total_types + type_count);
-			auto &type_entry = ListVector::GetData(output.data[7])[index];
-			auto &type_vector = ListVector::GetEntry(output.data[7]);
-			type_entry.offset = total_types;
-			type_entry.length = type_count;
-
-			auto type_data = FlatVector::GetData<uint8_t>(type_vector);
-			for (auto type : type_iter) {
-				type_data[total_types++] = (uint8_t)type;
+		if (columns[OSM_REF_TYPES_COLUMN]) {
+			auto &types_vector = *columns[OSM_REF_TYPES_COLUMN];
+			if (!type_iter.empty()) {
+				auto type_count = type_iter.size();
+
+				auto total_types = ListVector::GetListSize(types_vector);
+				ListVector::Reserve(types_vector, total_types + type_count);
+				ListVector::SetListSize(types_vector, total_types + type_count);
+				auto &type_entry = ListVector::GetData(types_vector)[index];
+				auto &type_vector = ListVector::GetEntry(types_vector);
+				type_entry.offset = total_types;
+				type_entry.length = type_count;
+
+				auto type_data = FlatVector::GetData<uint8_t>(type_vector);
+				for (auto type : type_iter) {
+					type_data[total_types++] = (uint8_t)type;
+				}
+			} else {
+				FlatVector::SetNull(types_vector, index, true);
 			}
-		} else {
-			FlatVector::SetNull(output.data[7], index, true);
 		}
 
 		index++;
 	}
 
 	// Returns true if done (all dense nodes have been read)
-	bool ScanDenseNodes(DataChunk &output, idx_t &index, idx_t capacity) {
+	bool ScanDenseNodes(idx_t &index, idx_t capacity) {
+		auto has_coordinates = !dense_node_xs.empty();
+
 		// Write multiple nodes at once as long as we have capacity
-		auto nodes_to_write = capacity - index;
-		auto nodes_to_read = std::min(nodes_to_write, dense_node_ids.size() - dense_node_index);
+		while (index < capacity && dense_node_index < dense_node_count) {
+			auto node_idx = has_dense_node_selection ? dense_node_selection[dense_node_index] : dense_node_index;
+			dense_node_index++;
 
-		auto kind_data = FlatVector::GetData<uint8_t>(output.data[0]);
-		auto id_data = FlatVector::GetData<int64_t>(output.data[1]);
-		auto lat_data = FlatVector::GetData<double>(output.data[4]);
-		auto lon_data = FlatVector::GetData<double>(output.data[5]);
+			const uint32_t *tags = nullptr;
+			idx_t tag_count = 0;
 
-		for (idx_t i = 0; i < nodes_to_read; i++) {
-			auto id = dense_node_ids[dense_node_index];
+			// Do we have tags in this block?
+			if (node_idx < dense_node_tag_entries.size()) {
+				// Dense nodes tags are stored as a list of key/value pairs,
+				// therefore we need to divide the length by 2 to get the number of tags
+				auto entry = dense_node_tag_entries[node_idx];
+				tags = dense_node_tags.data() + entry.offset;
+				tag_count = entry.length / 2;
+			}
 
-			id_data[index] = id;
-			kind_data[index] = 0;
-			lat_data[index] = 0.000000001 * (lat_offset + (granularity * dense_node_lats[dense_node_index]));
-			lon_data[index] = 0.000000001 * (lon_offset + (granularity * dense_node_lons[dense_node_index]));
+			if (decode_tags && !MatchesTagFilters(tags, tag_count)) {
+				continue;
+			}
 
-			// Do we have tags in this block?
-			if (!dense_node_tags.empty()) {
-				auto entry = dense_node_tag_entries[dense_node_index];
-				if (entry.length != 0) {
-					// Dense nodes tags are stored as a list of key/value pairs,
-					// therefore we need to divide the length by 2 to get the number of tags
-					auto tag_count = entry.length / 2;
-
-					auto total_tags = ListVector::GetListSize(output.data[2]);
-					ListVector::Reserve(output.data[2], total_tags + tag_count);
-					ListVector::SetListSize(output.data[2], total_tags + tag_count);
-					auto &tag_entry = ListVector::GetData(output.data[2])[index];
-
-					tag_entry.offset = total_tags;
-					tag_entry.length = tag_count;
-
-					auto &key_vector = MapVector::GetKeys(output.data[2]);
-					auto &value_vector = MapVector::GetValues(output.data[2]);
-
-					idx_t t = entry.offset;
-					idx_t r = tag_entry.offset;
-					for (idx_t i = 0; i < tag_count; i++) {
-
-						auto key_id = dense_node_tags[t];
-						auto val_id = dense_node_tags[t + 1];
-
-						FlatVector::GetData<string_t>(key_vector)[r] =
-						    StringVector::AddString(key_vector, string_table[key_id]);
-						FlatVector::GetData<string_t>(value_vector)[r] =
-						    StringVector::AddString(value_vector, string_table[val_id]);
-
-						t += 2;
-						r += 1;
-					}
-				} else {
-					FlatVector::SetNull(output.data[2], index, true);
-				}
-			} else {
-				FlatVector::SetNull(output.data[2], index, true);
+			WriteKind(index, OSM_KIND_NODE);
+			WriteId(index, dense_node_ids[node_idx]);
+			WriteTags(index, tags, tag_count);
+			if (has_coordinates) {
+				WriteCoordinates(index, dense_node_xs[node_idx], dense_node_ys[node_idx]);
+				WritePointGeometry(index, dense_node_xs[node_idx], dense_node_ys[node_idx]);
 			}
-			FlatVector::SetNull(output.data[3], index, true);
 
-			// No ref types or roles for dense nodes
-			FlatVector::SetNull(output.data[6], index, true);
-			FlatVector::SetNull(output.data[7], index, true);
+			// No refs, ref types or roles for dense nodes
+			WriteNull(index, OSM_REFS_COLUMN);
+			WriteNull(index, OSM_REF_ROLES_COLUMN);
+			WriteNull(index, OSM_REF_TYPES_COLUMN);
 
-			dense_node_index++;
 			index++;
 		}
-		if (dense_node_index >= dense_node_ids.size()) {
+		if (dense_node_index >= dense_node_count) {
 			return true;
 		}
 		return false;
 	}
 };
 
+// Get the next block to scan, skipping the blocks that the block index knows to be outside of the spatial filter
+static unique_ptr<FileBlock> GetNextBlock(ClientContext &context, const BindData &bind_data, GlobalState &global) {
+	while (true) {
+		auto blob = global.GetNextBlob(context);
+		if (!blob) {
+			return nullptr;
+		}
+		if (global.block_index && global.block_index->CanSkipBlock(blob->blob_idx, bind_data.spatial_filter)) {
+			continue;
+		}
+		return DecompressBlob(context, *blob);
+	}
+}
+
 static unique_ptr<LocalTableFunctionState> InitLocal(ExecutionContext &context, TableFunctionInitInput &input,
                                                      GlobalTableFunctionState *global_state) {
-	// auto &bind_data = (BindData &)*input.bind_data;
+	auto &bind_data = (BindData &)*input.bind_data;
 	auto &global = (GlobalState &)*global_state;
 
-	auto blob = global.GetNextBlob(context.client);
-	if (blob == nullptr) {
+	auto block = GetNextBlock(context.client, bind_data, global);
+	if (block == nullptr) {
 		return nullptr;
 	}
-	auto block = DecompressBlob(context.client, *blob);
 
-	auto result = make_uniq<LocalState>(std::move(block));
+	auto result = make_uniq<LocalState>(context.client, bind_data, input.column_ids, global, std::move(block));
 	return std::move(result);
 }
 
@@ -806,21 +2260,22 @@ static void Execute(ClientContext &context, TableFunctionInput &input, DataChunk
 		return;
 	}
 
-	// auto &bind_data = (BindData &)*input.bind_data;
+	auto &bind_data = (BindData &)*input.bind_data;
 	auto &global_state = (GlobalState &)*input.global_state;
 	auto &local_state = (LocalState &)*input.local_state;
 
+	local_state.SetOutput(output);
+
 	idx_t row_id = 0;
 	idx_t capacity = STANDARD_VECTOR_SIZE;
 
 	while (row_id < capacity) {
-		bool done = local_state.TryRead(output, row_id, capacity);
+		bool done = local_state.TryRead(row_id, capacity);
 		if (done) {
-			auto next = global_state.GetNextBlob(context);
-			if (next.get() == nullptr) {
+			auto next_block = GetNextBlock(context, bind_data, global_state);
+			if (next_block == nullptr) {
 				break;
 			}
-			auto next_block = DecompressBlob(context, *next);
 			local_state.SetBlock(std::move(next_block));
 		}
 	}
@@ -859,6 +2314,12 @@ static unique_ptr<TableRef> ReadOsmPBFReplacementScan(ClientContext &context, co
 void CoreTableFunctions::RegisterOsmTableFunction(DatabaseInstance &db) {
 	TableFunction read("ST_ReadOSM", {LogicalType::VARCHAR}, Execute, Bind, InitGlobal, InitLocal);
 
+	read.named_parameters["geometries"] = LogicalType::BOOLEAN;
+	read.named_parameters["spatial_filter_box"] = GeoTypes::BOX_2D();
+	read.named_parameters["blob_index_file"] = LogicalType::VARCHAR;
+	read.projection_pushdown = true;
+	read.pushdown_complex_filter = PushdownComplexFilter;
+
 	read.get_batch_index = GetBatchIndex;
 	read.table_scan_progress = Progress;
 
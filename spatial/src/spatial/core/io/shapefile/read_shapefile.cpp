@@ -5,6 +5,8 @@
 #include "duckdb/parser/expression/function_expression.hpp"
 #include "duckdb/parser/tableref/table_function_ref.hpp"
 #include "duckdb/common/multi_file_reader.hpp"
+#include "duckdb/common/operator/cast_operators.hpp"
+#include "duckdb/common/mutex.hpp"
 
 #include "duckdb/function/copy_function.hpp"
 #include "duckdb/parser/parsed_data/copy_info.hpp"
@@ -12,8 +14,11 @@
 
 #include "spatial/common.hpp"
 #include "spatial/core/io/shapefile.hpp"
+#include "spatial/core/dynamic_spatial_filter.hpp"
 #include "spatial/core/functions/table.hpp"
 #include "spatial/core/types.hpp"
+#include "spatial/core/geometry/cursor.hpp"
+#include "spatial/core/geometry/geometry.hpp"
 #include "spatial/core/geometry/geometry_factory.hpp"
 
 #include "shapefil.h"
@@ -27,54 +32,133 @@ namespace core {
 // Bind
 //------------------------------------------------------------------------------
 
-struct ShapefileBindData : TableFunctionData {
-	string file_name;
+struct ShapefileBindData : TableFunctionData, DynamicSpatialFilterTarget {
+	// The shapefiles to read, zip archive members are addressed as /vsizip/ paths. The schema of the first file is
+	// used, every other file must have the same attributes.
+	vector<string> file_names;
 	int shape_count;
 	int shape_type;
 	double min_bound[4];
 	double max_bound[4];
 	AttributeEncoding attribute_encoding;
 	vector<LogicalType> attribute_types;
+	vector<string> attribute_names;
 
-	explicit ShapefileBindData(string file_name_p)
-	    : file_name(std::move(file_name_p)), shape_count(0),
-	      shape_type(0), min_bound {0, 0, 0, 0}, max_bound {0, 0, 0, 0}, attribute_encoding(AttributeEncoding::LATIN1) {
-	}
-};
+	// Only read records whose bounding box intersects this box
+	bool has_spatial_filter = false;
+	BoundingBox spatial_filter;
+	// The extent of the build side of a spatial join that this scan is the probe side of, narrows the box above
+	shared_ptr<DynamicSpatialFilter> join_filter;
 
-static unique_ptr<FunctionData> Bind(ClientContext &context, TableFunctionBindInput &input,
-                                     vector<LogicalType> &return_types, vector<string> &names) {
+	// The index of the extra column with the name of the file, if requested
+	idx_t filename_column_idx = DConstants::INVALID_INDEX;
 
-	auto file_name = StringValue::Get(input.inputs[0]);
-	auto result = make_uniq<ShapefileBindData>(file_name);
+	explicit ShapefileBindData(vector<string> file_names_p)
+	    : file_names(std::move(file_names_p)), shape_count(0), shape_type(0), min_bound {0, 0, 0, 0},
+	      max_bound {0, 0, 0, 0}, attribute_encoding(AttributeEncoding::LATIN1) {
+	}
 
-	auto &fs = FileSystem::GetFileSystem(context);
-	auto shp_handle = OpenSHPFile(fs, file_name.c_str());
+	// The geometry is always the last column of the file
+	idx_t GeometryColumnIndex() const {
+		return attribute_types.size();
+	}
 
-	// Get info about the geometry
-	SHPGetInfo(shp_handle.get(), &result->shape_count, &result->shape_type, result->min_bound, result->max_bound);
+	bool TryAddDynamicFilter(column_t column_id, shared_ptr<DynamicSpatialFilter> filter) override {
+		if (column_id != GeometryColumnIndex()) {
+			return false;
+		}
+		join_filter = std::move(filter);
+		return true;
+	}
+};
+
+static string GetBaseName(const string &file_name) {
+	return file_name.substr(0, file_name.find_last_of('.'));
+}
 
+static void CheckShapeType(const string &file_name, int shape_type) {
 	// Ensure we have a supported shape type
 	auto valid_types = {SHPT_NULL, SHPT_POINT, SHPT_ARC, SHPT_POLYGON, SHPT_MULTIPOINT};
-	bool is_valid_type = false;
 	for (auto type : valid_types) {
-		if (result->shape_type == type) {
-			is_valid_type = true;
-			break;
+		if (shape_type == type) {
+			return;
+		}
+	}
+	throw InvalidInputException("Invalid shape type %d in %s", shape_type, file_name);
+}
+
+static LogicalType GetAttributeType(DBFHandle dbf_handle, int field_idx, AttributeEncoding encoding, string &name) {
+	char field_name[12]; // Max field name length is 11 + null terminator
+	int field_width = 0;
+	int field_precision = 0;
+	memset(field_name, 0, sizeof(field_name));
+
+	auto field_type = DBFGetFieldInfo(dbf_handle, field_idx, field_name, &field_width, &field_precision);
+	name = field_name;
+	switch (field_type) {
+	case FTString:
+		return encoding == AttributeEncoding::BLOB ? LogicalType::BLOB : LogicalType::VARCHAR;
+	case FTInteger:
+		return LogicalType::INTEGER;
+	case FTDouble:
+		if (field_precision == 0 && field_width < 19) {
+			return LogicalType::BIGINT;
+		}
+		return LogicalType::DOUBLE;
+	case FTDate:
+		// Dates are stored as 8-char strings
+		// YYYYMMDD
+		return LogicalType::DATE;
+	case FTLogical:
+		return LogicalType::BOOLEAN;
+	default:
+		throw InvalidInputException("DBF field type %d not supported", field_type);
+	}
+}
+
+static unique_ptr<FunctionData> Bind(ClientContext &context, TableFunctionBindInput &input,
+                                     vector<LogicalType> &return_types, vector<string> &names) {
+	auto &fs = FileSystem::GetFileSystem(context);
+
+	// A list of files or a glob pattern is expanded through the DuckDB file system, and zip archives are expanded
+	// into the shapefiles they contain
+	auto &path = input.inputs[0];
+	vector<string> paths;
+	if (path.type().id() == LogicalTypeId::LIST || FileSystem::HasGlob(StringValue::Get(path))) {
+		paths = MultiFileReader::GetFileList(context, path, "ST_ReadSHP", FileGlobOptions::DISALLOW_EMPTY);
+	} else {
+		paths.push_back(StringValue::Get(path));
+	}
+	vector<string> file_names;
+	for (auto &file : paths) {
+		for (auto &file_name : ExpandShapefileArchive(fs, file)) {
+			file_names.push_back(file_name);
 		}
 	}
-	if (!is_valid_type) {
-		throw InvalidInputException("Invalid shape type %d", result->shape_type);
+	if (file_names.empty()) {
+		throw IOException("No shapefiles found in %s", path.ToString());
 	}
 
-	auto base_name = file_name.substr(0, file_name.find_last_of('.'));
+	auto result = make_uniq<ShapefileBindData>(std::move(file_names));
+	auto &file_name = result->file_names[0];
+	auto shp_handle = OpenSHPFile(fs, file_name);
+
+	// Get info about the geometry
+	SHPGetInfo(shp_handle.get(), &result->shape_count, &result->shape_type, result->min_bound, result->max_bound);
+	CheckShapeType(file_name, result->shape_type);
+
+	// Get info about the attributes
+	// Remove file extension and replace with .dbf
+	auto base_name = GetBaseName(file_name);
+	auto dbf_handle = OpenDBFFile(fs, base_name + ".dbf");
 
 	// A standards compliant shapefile should use ISO-8859-1 encoding for attributes, but it can be overridden
-	// by a .cpg file. So check if there is a .cpg file, if so use that to determine the encoding
-	auto cpg_file = base_name + ".cpg";
-	if (fs.FileExists(cpg_file)) {
-		auto cpg_handle = fs.OpenFile(cpg_file, FileFlags::FILE_FLAGS_READ);
-		auto cpg_type = StringUtil::Lower(cpg_handle->ReadLine());
+	// by a .cpg file. So check if there is a .cpg file, if so use that to determine the encoding.
+	// shapelib has already read it as the code page of the DBF file.
+	// TODO: Try to get the encoding from the dbf if there is no .cpg file
+	auto code_page = DBFGetCodePage(dbf_handle.get());
+	if (code_page && ShapefileFileExists(fs, base_name + ".cpg")) {
+		auto cpg_type = StringUtil::Lower(code_page);
 		if (cpg_type == "utf-8") {
 			result->attribute_encoding = AttributeEncoding::UTF8;
 		} else if (cpg_type == "iso-8859-1") {
@@ -85,6 +169,7 @@ static unique_ptr<FunctionData> Bind(ClientContext &context, TableFunctionBindIn
 		}
 	}
 
+	bool filename_column = false;
 	for (auto &kv : input.named_parameters) {
 		if (kv.first == "encoding") {
 			auto encoding = StringUtil::Lower(StringValue::Get(kv.second));
@@ -102,63 +187,39 @@ static unique_ptr<FunctionData> Bind(ClientContext &context, TableFunctionBindIn
 			}
 		}
 		if (kv.first == "spatial_filter_box") {
-			auto filter_box = StructValue::GetChildren(kv.second);
+			auto &children = StructValue::GetChildren(kv.second);
+			result->has_spatial_filter = true;
+			result->spatial_filter.minx = DoubleValue::Get(children[0]);
+			result->spatial_filter.miny = DoubleValue::Get(children[1]);
+			result->spatial_filter.maxx = DoubleValue::Get(children[2]);
+			result->spatial_filter.maxy = DoubleValue::Get(children[3]);
+		}
+		if (kv.first == "filename") {
+			filename_column = BooleanValue::Get(kv.second);
 		}
 	}
 
-	// Get info about the attributes
-	// Remove file extension and replace with .dbf
-	auto dbf_handle = OpenDBFFile(fs, base_name + ".dbf");
-
-	// TODO: Try to get the encoding from the dbf if there is no .cpg file
-	// auto code_page = DBFGetCodePage(dbf_handle.get());
-	// if(!has_cpg_file && code_page != 0) { }
-
 	// Then return the attributes
 	auto field_count = DBFGetFieldCount(dbf_handle.get());
-	char field_name[12]; // Max field name length is 11 + null terminator
-	int field_width = 0;
-	int field_precision = 0;
-	memset(field_name, 0, sizeof(field_name));
-
 	for (int i = 0; i < field_count; i++) {
-		auto field_type = DBFGetFieldInfo(dbf_handle.get(), i, field_name, &field_width, &field_precision);
-
-		LogicalType type;
-		switch (field_type) {
-		case FTString:
-			type = result->attribute_encoding == AttributeEncoding::BLOB ? LogicalType::BLOB : LogicalType::VARCHAR;
-			break;
-		case FTInteger:
-			type = LogicalType::INTEGER;
-			break;
-		case FTDouble:
-			if (field_precision == 0 && field_width < 19) {
-				type = LogicalType::BIGINT;
-			} else {
-				type = LogicalType::DOUBLE;
-			}
-			break;
-		case FTDate:
-			// Dates are stored as 8-char strings
-			// YYYYMMDD
-			type = LogicalType::DATE;
-			break;
-		case FTLogical:
-			type = LogicalType::BOOLEAN;
-			break;
-		default:
-			throw InvalidInputException("DBF field type %d not supported", field_type);
-		}
-		names.emplace_back(field_name);
+		string field_name;
+		auto type = GetAttributeType(dbf_handle.get(), i, result->attribute_encoding, field_name);
+		names.push_back(field_name);
 		return_types.push_back(type);
+		result->attribute_names.push_back(field_name);
 		result->attribute_types.push_back(type);
 	}
 
-	// Always return geometry last
+	// Always return geometry last, only followed by the filename
 	return_types.push_back(GeoTypes::GEOMETRY());
 	names.push_back("geom");
 
+	if (filename_column) {
+		result->filename_column_idx = names.size();
+		return_types.push_back(LogicalType::VARCHAR);
+		names.push_back("filename");
+	}
+
 	// Deduplicate field names if necessary
 	for (size_t i = 0; i < names.size(); i++) {
 		idx_t count = 1;
@@ -175,180 +236,596 @@ static unique_ptr<FunctionData> Bind(ClientContext &context, TableFunctionBindIn
 //------------------------------------------------------------------------------
 // Init Global
 //------------------------------------------------------------------------------
+// Threads claim ranges of this many records at a time. Every thread has its own SHP and DBF handles, and the .shx
+// index gives the offset of every record, so the ranges are read and decoded independently. When reading multiple
+// files, the ranges of one file are handed out before moving on to the next one, so threads read from the same file
+// as long as it has ranges left, and from different files when it does not.
+static constexpr idx_t SHAPEFILE_MORSEL_SIZE = STANDARD_VECTOR_SIZE;
+
+// A file that is being scanned, shared by the threads that read its ranges
+struct ShapefileScanFile {
+	idx_t file_idx;
+	int shape_type = SHPT_NULL;
+	// The number of records to scan, either all records in the file or the candidates from the spatial index
+	idx_t scan_count = 0;
+
+	// The records whose index node intersects the spatial filter, in file order
+	bool use_index = false;
+	vector<int> candidate_records;
+
+	explicit ShapefileScanFile(idx_t file_idx_p) : file_idx(file_idx_p) {
+	}
+
+	int GetRecordIndex(idx_t scan_idx) const {
+		return use_index ? candidate_records[scan_idx] : static_cast<int>(scan_idx);
+	}
+};
 
 struct ShapefileGlobalState : public GlobalTableFunctionState {
-	int shape_idx;
-	SHPHandlePtr shp_handle;
-	DBFHandlePtr dbf_handle;
-	GeometryFactory factory;
+	mutable mutex lock;
 	vector<idx_t> column_ids;
+	idx_t max_threads;
+
+	// The spatial filter of the bind data, narrowed down to the extent of the join if it is known by now
+	bool has_spatial_filter;
+	BoundingBox spatial_filter;
+
+	// The file whose ranges are being handed out, and the next range in it
+	shared_ptr<ShapefileScanFile> current_file;
+	idx_t next_file_idx = 0;
+	idx_t next_record = 0;
+	idx_t next_batch_index = 0;
+
+	ShapefileGlobalState(const ShapefileBindData &bind_data, vector<idx_t> column_ids_p)
+	    : column_ids(std::move(column_ids_p)), has_spatial_filter(bind_data.has_spatial_filter),
+	      spatial_filter(bind_data.spatial_filter) {
+		BoundingBox extent;
+		if (bind_data.join_filter && bind_data.join_filter->TryGetExtent(extent)) {
+			if (has_spatial_filter) {
+				spatial_filter.minx = MaxValue(spatial_filter.minx, extent.minx);
+				spatial_filter.miny = MaxValue(spatial_filter.miny, extent.miny);
+				spatial_filter.maxx = MinValue(spatial_filter.maxx, extent.maxx);
+				spatial_filter.maxy = MinValue(spatial_filter.maxy, extent.maxy);
+			} else {
+				spatial_filter = extent;
+			}
+			has_spatial_filter = true;
+		}
+		// Assume that every file is about as large as the first one
+		auto estimated_count = static_cast<idx_t>(bind_data.shape_count) * bind_data.file_names.size();
+		max_threads = MaxValue<idx_t>(1, (estimated_count + SHAPEFILE_MORSEL_SIZE - 1) / SHAPEFILE_MORSEL_SIZE);
+	}
 
-	explicit ShapefileGlobalState(ClientContext &context, const string &file_name, vector<idx_t> column_ids_p)
-	    : shape_idx(0), factory(BufferAllocator::Get(context)), column_ids(std::move(column_ids_p)) {
-		auto &fs = FileSystem::GetFileSystem(context);
+	idx_t MaxThreads() const override {
+		return max_threads;
+	}
+};
 
-		shp_handle = OpenSHPFile(fs, file_name);
+// Use the quadtree (.qix) or the ESRI (.sbn) spatial index next to the shapefile, if there is one, to find the
+// records that may intersect the spatial filter. Both indexes only store coarse node bounds, so the bounding box of
+// every candidate record is still checked before it is decoded.
+static bool TrySearchSpatialIndex(FileSystem &fs, const string &file_name, const BoundingBox &filter,
+                                  vector<int> &result) {
+	auto base_name = GetBaseName(file_name);
+
+	int *shape_ids = nullptr;
+	int shape_id_count = 0;
+
+	auto qix_handle = TryOpenQIXFile(fs, base_name + ".qix");
+	if (qix_handle) {
+		double bounds_min[4] = {filter.minx, filter.miny, 0, 0};
+		double bounds_max[4] = {filter.maxx, filter.maxy, 0, 0};
+		shape_ids = SHPSearchDiskTreeEx(qix_handle.get(), bounds_min, bounds_max, &shape_id_count);
+		if (shape_ids) {
+			result.assign(shape_ids, shape_ids + shape_id_count);
+			free(shape_ids);
+			return true;
+		}
+	}
 
-		// Remove file extension and replace with .dbf
-		auto dot_idx = file_name.find_last_of('.');
-		auto base_name = file_name.substr(0, dot_idx);
-		dbf_handle = OpenDBFFile(fs, base_name + ".dbf");
+	auto sbn_handle = TryOpenSBNFile(fs, base_name + ".sbn");
+	if (sbn_handle) {
+		double bounds_min[2] = {filter.minx, filter.miny};
+		double bounds_max[2] = {filter.maxx, filter.maxy};
+		shape_ids = SBNSearchDiskTree(sbn_handle.get(), bounds_min, bounds_max, &shape_id_count);
+		if (shape_ids) {
+			result.assign(shape_ids, shape_ids + shape_id_count);
+			SBNSearchFreeIds(shape_ids);
+			return true;
+		}
 	}
-};
+	return false;
+}
+
+static shared_ptr<ShapefileScanFile> OpenScanFile(FileSystem &fs, const ShapefileBindData &bind_data,
+                                                  const ShapefileGlobalState &gstate, idx_t file_idx) {
+	auto &file_name = bind_data.file_names[file_idx];
+	auto result = make_shared<ShapefileScanFile>(file_idx);
+
+	auto shp_handle = OpenSHPFile(fs, file_name);
+	int shape_count = 0;
+	double min_bound[4];
+	double max_bound[4];
+	SHPGetInfo(shp_handle.get(), &shape_count, &result->shape_type, min_bound, max_bound);
+	CheckShapeType(file_name, result->shape_type);
+	result->scan_count = shape_count;
+
+	// The attributes of the first file have been checked in the bind
+	if (file_idx != 0) {
+		auto dbf_handle = OpenDBFFile(fs, GetBaseName(file_name) + ".dbf");
+		bool same_attributes = DBFGetFieldCount(dbf_handle.get()) == static_cast<int>(bind_data.attribute_types.size());
+		for (idx_t i = 0; same_attributes && i < bind_data.attribute_types.size(); i++) {
+			string name;
+			auto type = GetAttributeType(dbf_handle.get(), static_cast<int>(i), bind_data.attribute_encoding, name);
+			same_attributes = name == bind_data.attribute_names[i] && type == bind_data.attribute_types[i];
+		}
+		if (!same_attributes) {
+			throw InvalidInputException("Shapefile %s does not have the same attributes as %s", file_name,
+			                            bind_data.file_names[0]);
+		}
+	}
+
+	if (gstate.has_spatial_filter) {
+		auto &candidates = result->candidate_records;
+		if (TrySearchSpatialIndex(fs, file_name, gstate.spatial_filter, candidates)) {
+			// A stale index may reference records that no longer exist
+			while (!candidates.empty() && candidates.back() >= shape_count) {
+				candidates.pop_back();
+			}
+			result->use_index = true;
+			result->scan_count = candidates.size();
+		}
+	}
+	return result;
+}
 
 static unique_ptr<GlobalTableFunctionState> InitGlobal(ClientContext &context, TableFunctionInitInput &input) {
 	auto &bind_data = input.bind_data->Cast<ShapefileBindData>();
-	auto result = make_uniq<ShapefileGlobalState>(context, bind_data.file_name, input.column_ids);
+	auto result = make_uniq<ShapefileGlobalState>(bind_data, input.column_ids);
 	return std::move(result);
 }
 
+//------------------------------------------------------------------------------
+// Record Buffers
+//------------------------------------------------------------------------------
+// DBF records are fixed width rows of text fields. The rows of a chunk are loaded with a single read, and only the
+// projected fields are parsed, straight into the output vectors.
+
+struct DBFRecordBlock {
+	vector<data_t> buffer;
+	int first_record = 0;
+	int end_record = 0;
+
+	void Load(DBFHandle dbf_handle, const vector<int> &record_ids) {
+		// The record ids are in file order, so read every row between the first and the last one
+		first_record = record_ids.front();
+		end_record = MinValue<int>(record_ids.back() + 1, dbf_handle->nRecords);
+		if (first_record >= end_record) {
+			return;
+		}
+		auto record_length = static_cast<idx_t>(dbf_handle->nRecordLength);
+		auto read_size = record_length * static_cast<idx_t>(end_record - first_record);
+		buffer.resize(read_size);
+
+		auto offset = dbf_handle->nHeaderLength + record_length * static_cast<idx_t>(first_record);
+		dbf_handle->sHooks.FSeek(dbf_handle->fp, offset, SEEK_SET);
+		if (dbf_handle->sHooks.FRead(buffer.data(), read_size, 1, dbf_handle->fp) != 1) {
+			throw IOException("Failed to read records %d to %d of DBF file", first_record, end_record);
+		}
+	}
+
+	// Returns false if the DBF file has fewer records than the SHP file. The value is trimmed of the surrounding
+	// blanks, the same way shapelib does.
+	bool TryGetField(DBFHandle dbf_handle, int record_idx, int field_idx, const char *&value, idx_t &length) const {
+		if (record_idx < first_record || record_idx >= end_record) {
+			return false;
+		}
+		auto record_offset = static_cast<idx_t>(record_idx - first_record) * dbf_handle->nRecordLength;
+		auto begin = const_char_ptr_cast(buffer.data() + record_offset + dbf_handle->panFieldOffset[field_idx]);
+		auto end = begin + dbf_handle->panFieldSize[field_idx];
+		auto nul = static_cast<const char *>(memchr(begin, '\0', end - begin));
+		if (nul) {
+			end = nul;
+		}
+		while (begin < end && *begin == ' ') {
+			begin++;
+		}
+		while (end > begin && *(end - 1) == ' ') {
+			end--;
+		}
+		value = begin;
+		length = end - begin;
+		return true;
+	}
+};
+
+// Reused between records so that decoding does not allocate
+struct ShapeDecodeState {
+	vector<data_t> record_buffer;
+	// The offset of every part, followed by the number of points
+	vector<uint32_t> part_offsets;
+	// The parts of a polygon record that are shells
+	vector<uint32_t> shell_parts;
+};
+
+//------------------------------------------------------------------------------
+// Init Local
+//------------------------------------------------------------------------------
+
+struct ShapefileLocalState : public LocalTableFunctionState {
+	// Which handles to open, depending on whether the geometry or any attribute is projected
+	bool needs_shp = false;
+	bool needs_dbf = false;
+
+	// The file of the claimed range, the handles are reopened when a range of another file is claimed
+	shared_ptr<ShapefileScanFile> scan_file;
+	SHPHandlePtr shp_handle;
+	DBFHandlePtr dbf_handle;
+	ShapeDecodeState decode_state;
+
+	// The range of records claimed by this thread
+	idx_t record_idx = 0;
+	idx_t record_end = 0;
+	idx_t batch_index = 0;
+
+	// The records to read into the current chunk
+	vector<int> record_ids;
+	DBFRecordBlock dbf_block;
+};
+
+static unique_ptr<LocalTableFunctionState> InitLocal(ExecutionContext &context, TableFunctionInitInput &input,
+                                                     GlobalTableFunctionState *global_state) {
+	auto &bind_data = input.bind_data->Cast<ShapefileBindData>();
+	auto &gstate = global_state->Cast<ShapefileGlobalState>();
+	auto result = make_uniq<ShapefileLocalState>();
+
+	auto geometry_column_idx = bind_data.GeometryColumnIndex();
+	bool has_geometry = false;
+	bool has_attributes = false;
+	for (auto &column_id : input.column_ids) {
+		if (column_id == geometry_column_idx) {
+			has_geometry = true;
+		} else if (column_id < geometry_column_idx) {
+			has_attributes = true;
+		}
+	}
+
+	// The spatial filter is checked against the bounding box in the record header
+	result->needs_shp = has_geometry || gstate.has_spatial_filter;
+	result->needs_dbf = has_attributes;
+	return std::move(result);
+}
+
+// Claims the next range of records, moving on to the next file when the current one has none left.
+// Returns false when every file has been scanned.
+static bool TryClaimRange(ClientContext &context, const ShapefileBindData &bind_data, ShapefileGlobalState &gstate,
+                          ShapefileLocalState &lstate) {
+	lock_guard<mutex> guard(gstate.lock);
+	while (!gstate.current_file || gstate.next_record >= gstate.current_file->scan_count) {
+		if (gstate.next_file_idx >= bind_data.file_names.size()) {
+			return false;
+		}
+		auto &fs = FileSystem::GetFileSystem(context);
+		gstate.current_file = OpenScanFile(fs, bind_data, gstate, gstate.next_file_idx++);
+		gstate.next_record = 0;
+	}
+	auto &file = gstate.current_file;
+	lstate.record_idx = gstate.next_record;
+	lstate.record_end = MinValue<idx_t>(lstate.record_idx + SHAPEFILE_MORSEL_SIZE, file->scan_count);
+	lstate.batch_index = gstate.next_batch_index++;
+	gstate.next_record = lstate.record_end;
+
+	if (lstate.scan_file != file) {
+		lstate.scan_file = file;
+		lstate.shp_handle.reset();
+		lstate.dbf_handle.reset();
+	}
+	return true;
+}
+
+// Opens the handles of the claimed file, outside of the global lock
+static void OpenScanHandles(ClientContext &context, const ShapefileBindData &bind_data, ShapefileLocalState &lstate) {
+	auto &fs = FileSystem::GetFileSystem(context);
+	auto &file_name = bind_data.file_names[lstate.scan_file->file_idx];
+	if (lstate.needs_shp && !lstate.shp_handle) {
+		lstate.shp_handle = OpenSHPFile(fs, file_name);
+	}
+	if (lstate.needs_dbf && !lstate.dbf_handle) {
+		// Remove file extension and replace with .dbf
+		lstate.dbf_handle = OpenDBFFile(fs, GetBaseName(file_name) + ".dbf");
+	}
+}
+
 //------------------------------------------------------------------------------
 // Geometry Conversion
 //------------------------------------------------------------------------------
+// Records are decoded straight from their bytes into the serialized geometry format. Shapefiles store the x/y pairs of
+// a record interleaved, the same way as our vertices, so every part is copied with a single memcpy. The bounding box
+// is taken from the record instead of being recomputed.
+
+static constexpr uint32_t SHAPE_VERTEX_SIZE = 2 * sizeof(double);
+
+// Allocates a serialized geometry and writes its header and bounding box, the body is written through the cursor
+struct ShapeGeometryWriter {
+	GeometryProperties properties;
+	string_t blob;
+	Cursor cursor;
+
+	ShapeGeometryWriter(Vector &result, GeometryType type, bool has_bbox, const BoundingBox &bbox, uint32_t body_size)
+	    : properties(GetProperties(has_bbox)),
+	      blob(StringVector::EmptyString(result, 4 + 4 + properties.BBoxSize() + body_size)), cursor(blob) {
+		cursor.Write<GeometryType>(type);
+		cursor.Write<GeometryProperties>(properties);
+		cursor.Write<uint16_t>(0);
+		// Padding
+		cursor.Write<uint32_t>(0);
+		GeometryFactory::SerializeBoundingBox(cursor, bbox, properties);
+	}
+
+	void WriteVertices(const_data_ptr_t vertices, uint32_t count) {
+		auto byte_size = count * SHAPE_VERTEX_SIZE;
+		if (byte_size > cursor.Remaining()) {
+			throw SerializationException("Trying to write past end of buffer");
+		}
+		memcpy(cursor.GetPtr(), vertices, byte_size);
+		cursor.Skip(byte_size);
+	}
+
+	geometry_t Finish() {
+		blob.Finalize();
+		return geometry_t(blob);
+	}
+
+private:
+	static GeometryProperties GetProperties(bool has_bbox) {
+		// TODO: Handle Z and M
+		GeometryProperties result;
+		result.SetBBox(has_bbox);
+		return result;
+	}
+};
+
+static BoundingBox ReadShapeBounds(Cursor &input) {
+	BoundingBox bbox;
+	bbox.minx = input.Read<double>();
+	bbox.miny = input.Read<double>();
+	bbox.maxx = input.Read<double>();
+	bbox.maxy = input.Read<double>();
+	return bbox;
+}
+
+// Read the part offsets and points of a PolyLine or Polygon record, returns a pointer to the points
+static const_data_ptr_t ReadShapeParts(Cursor &input, ShapeDecodeState &state) {
+	auto part_count = input.Read<uint32_t>();
+	auto point_count = input.Read<uint32_t>();
+	if (part_count > input.Remaining() / sizeof(uint32_t)) {
+		throw SerializationException("Trying to read past end of buffer");
+	}
+	auto &offsets = state.part_offsets;
+	offsets.resize(part_count + 1);
+	for (uint32_t i = 0; i < part_count; i++) {
+		offsets[i] = input.Read<uint32_t>();
+	}
+	offsets[part_count] = point_count;
+	for (uint32_t i = 0; i < part_count; i++) {
+		if (offsets[i] > offsets[i + 1]) {
+			throw InvalidInputException("Invalid part offset %u in shapefile record", offsets[i]);
+		}
+	}
+	if (point_count > input.Remaining() / SHAPE_VERTEX_SIZE) {
+		throw SerializationException("Trying to read past end of buffer");
+	}
+	return input.GetPtr();
+}
+
+static uint32_t GetPartCount(const ShapeDecodeState &state) {
+	return static_cast<uint32_t>(state.part_offsets.size() - 1);
+}
+
+static uint32_t GetPartSize(const ShapeDecodeState &state, uint32_t part_idx) {
+	return state.part_offsets[part_idx + 1] - state.part_offsets[part_idx];
+}
 
 struct ConvertPoint {
-	static Geometry Convert(SHPObjectPtr &shape, GeometryFactory &factory) {
-		return Point(factory.allocator, shape->padfX[0], shape->padfY[0]);
+	static geometry_t Convert(Vector &result, Cursor &input, ShapeDecodeState &state) {
+		auto vertex_ptr = input.GetPtr();
+		input.Skip(SHAPE_VERTEX_SIZE);
+
+		BoundingBox bbox;
+		ShapeGeometryWriter writer(result, GeometryType::POINT, false, bbox, 4 + 4 + SHAPE_VERTEX_SIZE);
+		writer.cursor.Write(SerializedGeometryType::POINT);
+		writer.cursor.Write<uint32_t>(1);
+		writer.WriteVertices(vertex_ptr, 1);
+		return writer.Finish();
 	}
 };
 
 struct ConvertLineString {
-	static Geometry Convert(SHPObjectPtr &shape, GeometryFactory &factory) {
-		if (shape->nParts == 1) {
+	static geometry_t Convert(Vector &result, Cursor &input, ShapeDecodeState &state) {
+		auto bbox = ReadShapeBounds(input);
+		auto points = ReadShapeParts(input, state);
+		auto part_count = GetPartCount(state);
+		auto &offsets = state.part_offsets;
+		auto has_bbox = offsets[part_count] != 0;
+
+		if (part_count == 1) {
 			// Single LineString
-			auto vertices = VertexArray::Create(factory.allocator, shape->nVertices, false, false);
-			for (int i = 0; i < shape->nVertices; i++) {
-				vertices.Set(i, shape->padfX[i], shape->padfY[i]);
-			}
-			return LineString(vertices);
-		} else {
-			// MultiLineString
-			MultiLineString multi_line_string(factory.allocator, shape->nParts, false, false);
-			auto start = shape->panPartStart[0];
-			for (int i = 0; i < shape->nParts; i++) {
-				auto end = i == shape->nParts - 1 ? shape->nVertices : shape->panPartStart[i + 1];
-				auto line_size = end - start;
-				auto vertices = VertexArray::Create(factory.allocator, line_size, false, false);
-				for (int j = 0; j < line_size; j++) {
-					auto offset = start + j;
-					vertices.Set(j, shape->padfX[offset], shape->padfY[offset]);
-				}
-				multi_line_string[i] = LineString(vertices);
-				start = end;
-			}
-			return multi_line_string;
+			auto count = GetPartSize(state, 0);
+			ShapeGeometryWriter writer(result, GeometryType::LINESTRING, has_bbox, bbox,
+			                           4 + 4 + count * SHAPE_VERTEX_SIZE);
+			writer.cursor.Write(SerializedGeometryType::LINESTRING);
+			writer.cursor.Write<uint32_t>(count);
+			writer.WriteVertices(points + offsets[0] * SHAPE_VERTEX_SIZE, count);
+			return writer.Finish();
+		}
+
+		// MultiLineString
+		uint32_t body_size = 4 + 4;
+		for (uint32_t i = 0; i < part_count; i++) {
+			body_size += 4 + 4 + GetPartSize(state, i) * SHAPE_VERTEX_SIZE;
 		}
+		ShapeGeometryWriter writer(result, GeometryType::MULTILINESTRING, has_bbox, bbox, body_size);
+		writer.cursor.Write(SerializedGeometryType::MULTILINESTRING);
+		writer.cursor.Write<uint32_t>(part_count);
+		for (uint32_t i = 0; i < part_count; i++) {
+			auto count = GetPartSize(state, i);
+			writer.cursor.Write(SerializedGeometryType::LINESTRING);
+			writer.cursor.Write<uint32_t>(count);
+			writer.WriteVertices(points + offsets[i] * SHAPE_VERTEX_SIZE, count);
+		}
+		return writer.Finish();
 	}
 };
 
 struct ConvertPolygon {
-	static Geometry Convert(SHPObjectPtr &shape, GeometryFactory &factory) {
-		// First off, check if there are more than one polygon.
-		// Each polygon is identified by a part with clockwise winding order
-		// we calculate the winding order by checking the sign of the area
-		vector<int> polygon_part_starts;
-		for (int i = 0; i < shape->nParts; i++) {
-			auto start = shape->panPartStart[i];
-			auto end = i == shape->nParts - 1 ? shape->nVertices : shape->panPartStart[i + 1];
-			double area = 0;
-			for (int j = start; j < end - 1; j++) {
-				area += (shape->padfX[j] * shape->padfY[j + 1]) - (shape->padfX[j + 1] * shape->padfY[j]);
-			}
-			if (area < 0) {
-				polygon_part_starts.push_back(i);
+	// Shells are wound clockwise, which gives them a negative signed area
+	static bool IsShell(const_data_ptr_t points, uint32_t begin, uint32_t end) {
+		double area = 0;
+		for (uint32_t i = begin; i + 1 < end; i++) {
+			auto x0 = Load<double>(points + i * SHAPE_VERTEX_SIZE);
+			auto y0 = Load<double>(points + i * SHAPE_VERTEX_SIZE + sizeof(double));
+			auto x1 = Load<double>(points + (i + 1) * SHAPE_VERTEX_SIZE);
+			auto y1 = Load<double>(points + (i + 1) * SHAPE_VERTEX_SIZE + sizeof(double));
+			area += (x0 * y1) - (x1 * y0);
+		}
+		return area < 0;
+	}
+
+	static uint32_t GetPolygonSize(const ShapeDecodeState &state, uint32_t part_begin, uint32_t part_end) {
+		auto ring_count = part_end - part_begin;
+		uint32_t size = 4 + 4 + ring_count * 4 + (ring_count % 2 == 1 ? 4 : 0);
+		size += (state.part_offsets[part_end] - state.part_offsets[part_begin]) * SHAPE_VERTEX_SIZE;
+		return size;
+	}
+
+	static void WritePolygon(ShapeGeometryWriter &writer, const_data_ptr_t points, const ShapeDecodeState &state,
+	                         uint32_t part_begin, uint32_t part_end) {
+		auto ring_count = part_end - part_begin;
+		writer.cursor.Write(SerializedGeometryType::POLYGON);
+		writer.cursor.Write<uint32_t>(ring_count);
+		for (auto i = part_begin; i < part_end; i++) {
+			writer.cursor.Write<uint32_t>(GetPartSize(state, i));
+		}
+		if (ring_count % 2 == 1) {
+			// Write padding (4 bytes)
+			writer.cursor.Write<uint32_t>(0);
+		}
+		// The rings of a polygon are adjacent, so they are copied together
+		auto &offsets = state.part_offsets;
+		writer.WriteVertices(points + offsets[part_begin] * SHAPE_VERTEX_SIZE,
+		                     offsets[part_end] - offsets[part_begin]);
+	}
+
+	static geometry_t Convert(Vector &result, Cursor &input, ShapeDecodeState &state) {
+		auto bbox = ReadShapeBounds(input);
+		auto points = ReadShapeParts(input, state);
+		auto part_count = GetPartCount(state);
+		auto has_bbox = state.part_offsets[part_count] != 0;
+
+		// Each polygon starts with a shell, followed by its holes
+		auto &shells = state.shell_parts;
+		shells.clear();
+		for (uint32_t i = 0; i < part_count; i++) {
+			if (IsShell(points, state.part_offsets[i], state.part_offsets[i + 1])) {
+				shells.push_back(i);
 			}
 		}
-		if (polygon_part_starts.size() < 2) {
-			// Single polygon, every part is an interior ring
+
+		if (shells.size() < 2) {
+			// Single polygon, every part after the first one is an interior ring.
 			// Even if the polygon is counter-clockwise (which should not happen for shapefiles).
 			// we still fall back and convert it to a single polygon.
-			Polygon polygon(factory.allocator, shape->nParts, false, false);
-			auto start = shape->panPartStart[0];
-			for (int i = 0; i < shape->nParts; i++) {
-				auto end = i == shape->nParts - 1 ? shape->nVertices : shape->panPartStart[i + 1];
-				auto &ring = polygon[i];
-				auto ring_size = end - start;
-				ring.Resize(factory.allocator, ring_size);
-				for (int j = 0; j < ring_size; j++) {
-					auto offset = start + j;
-					ring.Set(j, shape->padfX[offset], shape->padfY[offset]);
-				}
-				start = end;
-			}
-			return polygon;
-		} else {
-			// MultiPolygon
-			MultiPolygon multi_polygon(factory.allocator, polygon_part_starts.size(), false, false);
-			for (size_t polygon_idx = 0; polygon_idx < polygon_part_starts.size(); polygon_idx++) {
-				auto part_start = polygon_part_starts[polygon_idx];
-				auto part_end = polygon_idx == polygon_part_starts.size() - 1 ? shape->nParts
-				                                                              : polygon_part_starts[polygon_idx + 1];
-
-				Polygon polygon(factory.allocator, part_end - part_start, false, false);
-
-				for (auto ring_idx = part_start; ring_idx < part_end; ring_idx++) {
-					auto start = shape->panPartStart[ring_idx];
-					auto end = ring_idx == shape->nParts - 1 ? shape->nVertices : shape->panPartStart[ring_idx + 1];
-					auto &ring = polygon[ring_idx - part_start];
-					auto ring_size = end - start;
-					ring.Resize(factory.allocator, ring_size);
-					for (int j = 0; j < ring_size; j++) {
-						auto offset = start + j;
-						ring.Set(j, shape->padfX[offset], shape->padfY[offset]);
-					}
-				}
-				multi_polygon[polygon_idx] = polygon;
-			}
-			return multi_polygon;
+			ShapeGeometryWriter writer(result, GeometryType::POLYGON, has_bbox, bbox,
+			                           GetPolygonSize(state, 0, part_count));
+			WritePolygon(writer, points, state, 0, part_count);
+			return writer.Finish();
+		}
+
+		// MultiPolygon, any holes before the first shell are kept with the first polygon
+		shells[0] = 0;
+		shells.push_back(part_count);
+		auto polygon_count = static_cast<uint32_t>(shells.size() - 1);
+		uint32_t body_size = 4 + 4;
+		for (uint32_t i = 0; i < polygon_count; i++) {
+			body_size += GetPolygonSize(state, shells[i], shells[i + 1]);
+		}
+		ShapeGeometryWriter writer(result, GeometryType::MULTIPOLYGON, has_bbox, bbox, body_size);
+		writer.cursor.Write(SerializedGeometryType::MULTIPOLYGON);
+		writer.cursor.Write<uint32_t>(polygon_count);
+		for (uint32_t i = 0; i < polygon_count; i++) {
+			WritePolygon(writer, points, state, shells[i], shells[i + 1]);
 		}
+		return writer.Finish();
 	}
 };
 
 struct ConvertMultiPoint {
-	static Geometry Convert(SHPObjectPtr &shape, GeometryFactory &factory) {
-		MultiPoint multi_point(factory.allocator, shape->nVertices, false, false);
-		for (int i = 0; i < shape->nVertices; i++) {
-			multi_point[i] = Point(factory.allocator, shape->padfX[i], shape->padfY[i]);
+	static geometry_t Convert(Vector &result, Cursor &input, ShapeDecodeState &state) {
+		auto bbox = ReadShapeBounds(input);
+		auto point_count = input.Read<uint32_t>();
+		if (point_count > input.Remaining() / SHAPE_VERTEX_SIZE) {
+			throw SerializationException("Trying to read past end of buffer");
 		}
-		return multi_point;
+		auto points = input.GetPtr();
+
+		ShapeGeometryWriter writer(result, GeometryType::MULTIPOINT, point_count != 0, bbox,
+		                           4 + 4 + point_count * (4 + 4 + SHAPE_VERTEX_SIZE));
+		writer.cursor.Write(SerializedGeometryType::MULTIPOINT);
+		writer.cursor.Write<uint32_t>(point_count);
+		for (uint32_t i = 0; i < point_count; i++) {
+			writer.cursor.Write(SerializedGeometryType::POINT);
+			writer.cursor.Write<uint32_t>(1);
+			writer.WriteVertices(points + i * SHAPE_VERTEX_SIZE, 1);
+		}
+		return writer.Finish();
 	}
 };
 
-template <class OP>
-static void ConvertGeomLoop(Vector &result, int record_start, idx_t count, SHPHandle &shp_handle,
-                            GeometryFactory &factory) {
-	for (idx_t result_idx = 0; result_idx < count; result_idx++) {
-		auto shape = SHPObjectPtr(SHPReadObject(shp_handle, record_start++));
-		if (shape->nSHPType == SHPT_NULL) {
-			FlatVector::SetNull(result, result_idx, true);
-		} else {
-			// TODO: Handle Z and M
-			FlatVector::GetData<string_t>(result)[result_idx] =
-			    factory.Serialize(result, OP::Convert(shape, factory), false, false);
+// Read the content of a record, without the 8 byte record header, into the buffer
+static Cursor ReadShapeRecord(SHPHandle shp_handle, int record_idx, vector<data_t> &buffer) {
+	auto record_size = static_cast<idx_t>(shp_handle->panRecSize[record_idx]);
+	if (buffer.size() < record_size) {
+		buffer.resize(record_size);
+	}
+	if (record_size != 0) {
+		shp_handle->sHooks.FSeek(shp_handle->fpSHP, shp_handle->panRecOffset[record_idx] + 8, SEEK_SET);
+		if (shp_handle->sHooks.FRead(buffer.data(), record_size, 1, shp_handle->fpSHP) != 1) {
+			throw IOException("Failed to read record %d of SHP file", record_idx);
 		}
 	}
+	return Cursor(buffer.data(), buffer.data() + record_size);
 }
 
-static void ConvertGeometryVector(Vector &result, int record_start, idx_t count, SHPHandle shp_handle,
-                                  GeometryFactory &factory, int geom_type) {
-	switch (geom_type) {
-	case SHPT_NULL:
-		FlatVector::Validity(result).SetAllInvalid(count);
-		break;
-	case SHPT_POINT:
-		ConvertGeomLoop<ConvertPoint>(result, record_start, count, shp_handle, factory);
-		break;
-	case SHPT_ARC:
-		ConvertGeomLoop<ConvertLineString>(result, record_start, count, shp_handle, factory);
-		break;
-	case SHPT_POLYGON:
-		ConvertGeomLoop<ConvertPolygon>(result, record_start, count, shp_handle, factory);
-		break;
-	case SHPT_MULTIPOINT:
-		ConvertGeomLoop<ConvertMultiPoint>(result, record_start, count, shp_handle, factory);
-		break;
-	default:
-		throw InvalidInputException("Shape type %d not supported", geom_type);
+static void ConvertGeometryVector(Vector &result, const vector<int> &record_ids, SHPHandle shp_handle,
+                                  ShapeDecodeState &state, int geom_type) {
+	if (geom_type == SHPT_NULL) {
+		FlatVector::Validity(result).SetAllInvalid(record_ids.size());
+		return;
+	}
+	auto data = FlatVector::GetData<string_t>(result);
+	for (idx_t result_idx = 0; result_idx < record_ids.size(); result_idx++) {
+		auto input = ReadShapeRecord(shp_handle, record_ids[result_idx], state.record_buffer);
+		// Deleted records have no content, and any record may be a null shape
+		auto shape_type = input.Remaining() < sizeof(int32_t) ? SHPT_NULL : input.Read<int32_t>();
+		switch (shape_type) {
+		case SHPT_NULL:
+			FlatVector::SetNull(result, result_idx, true);
+			break;
+		case SHPT_POINT:
+			data[result_idx] = ConvertPoint::Convert(result, input, state);
+			break;
+		case SHPT_ARC:
+			data[result_idx] = ConvertLineString::Convert(result, input, state);
+			break;
+		case SHPT_POLYGON:
+			data[result_idx] = ConvertPolygon::Convert(result, input, state);
+			break;
+		case SHPT_MULTIPOINT:
+			data[result_idx] = ConvertMultiPoint::Convert(result, input, state);
+			break;
+		default:
+			throw InvalidInputException("Shape type %d not supported", shape_type);
+		}
 	}
 }
 
@@ -358,128 +835,187 @@ static void ConvertGeometryVector(Vector &result, int record_start, idx_t count,
 
 struct ConvertBlobAttribute {
 	using TYPE = string_t;
-	static string_t Convert(Vector &result, DBFHandle dbf_handle, int record_idx, int field_idx) {
-		auto value = DBFReadStringAttribute(dbf_handle, record_idx, field_idx);
-		return StringVector::AddString(result, const_char_ptr_cast(value));
-	}
-};
-
-struct ConvertIntegerAttribute {
-	using TYPE = int32_t;
-	static int32_t Convert(Vector &, DBFHandle dbf_handle, int record_idx, int field_idx) {
-		return DBFReadIntegerAttribute(dbf_handle, record_idx, field_idx);
+	static bool Convert(Vector &result, const char *value, idx_t length, string_t &out) {
+		if (length == 0) {
+			return false;
+		}
+		out = StringVector::AddString(result, value, length);
+		return true;
 	}
 };
 
-struct ConvertBigIntAttribute {
-	using TYPE = int64_t;
-	static int64_t Convert(Vector &, DBFHandle dbf_handle, int record_idx, int field_idx) {
-		return static_cast<int64_t>(DBFReadDoubleAttribute(dbf_handle, record_idx, field_idx));
-	}
-};
+// Numeric fields that are blank or filled with asterisks are NULL
+static bool IsNumericFieldNull(const char *value, idx_t length) {
+	return length == 0 || value[0] == '*';
+}
 
-struct ConvertDoubleAttribute {
-	using TYPE = double;
-	static double Convert(Vector &, DBFHandle dbf_handle, int record_idx, int field_idx) {
-		return DBFReadDoubleAttribute(dbf_handle, record_idx, field_idx);
+template <class T>
+struct ConvertNumericAttribute {
+	using TYPE = T;
+	static bool Convert(Vector &, const char *value, idx_t length, T &out) {
+		if (IsNumericFieldNull(value, length)) {
+			return false;
+		}
+		return TryCast::Operation<string_t, T>(string_t(value, length), out, false);
 	}
 };
 
 struct ConvertDateAttribute {
 	using TYPE = date_t;
-	static date_t Convert(Vector &, DBFHandle dbf_handle, int record_idx, int field_idx) {
-		// XBase stores dates as 8-char strings (without separators)
-		// but DuckDB expects a date string with separators.
-		auto value = DBFReadStringAttribute(dbf_handle, record_idx, field_idx);
-		char date_with_separator[11];
-		memcpy(date_with_separator, value, 4);
-		date_with_separator[4] = '-';
-		memcpy(date_with_separator + 5, value + 4, 2);
-		date_with_separator[7] = '-';
-		memcpy(date_with_separator + 8, value + 6, 2);
-		date_with_separator[10] = '\0';
-		return Date::FromString(date_with_separator);
+	static bool Convert(Vector &, const char *value, idx_t length, date_t &out) {
+		// XBase stores dates as 8-char strings without separators, YYYYMMDD. Null dates are all zeroes.
+		if (length != 8) {
+			return false;
+		}
+		int32_t parts[3] = {0, 0, 0};
+		const idx_t part_lengths[3] = {4, 2, 2};
+		idx_t pos = 0;
+		for (idx_t part_idx = 0; part_idx < 3; part_idx++) {
+			for (idx_t i = 0; i < part_lengths[part_idx]; i++) {
+				auto c = value[pos++];
+				if (c < '0' || c > '9') {
+					return false;
+				}
+				parts[part_idx] = parts[part_idx] * 10 + (c - '0');
+			}
+		}
+		return Date::TryFromDate(parts[0], parts[1], parts[2], out);
 	}
 };
 
 struct ConvertBooleanAttribute {
 	using TYPE = bool;
-	static bool Convert(Vector &result, DBFHandle dbf_handle, int record_idx, int field_idx) {
-		return *DBFReadLogicalAttribute(dbf_handle, record_idx, field_idx) == 'T';
+	static bool Convert(Vector &, const char *value, idx_t length, bool &out) {
+		// Null booleans are stored as '?'
+		if (length != 0 && value[0] == '?') {
+			return false;
+		}
+		out = length != 0 && value[0] == 'T';
+		return true;
 	}
 };
 
 template <class OP>
-static void ConvertAttributeLoop(Vector &result, int record_start, idx_t count, DBFHandle dbf_handle, int field_idx) {
-	int record_idx = record_start;
-	for (idx_t row_idx = 0; row_idx < count; row_idx++) {
-		if (DBFIsAttributeNULL(dbf_handle, record_idx, field_idx)) {
+static void ConvertAttributeLoop(Vector &result, const vector<int> &record_ids, DBFHandle dbf_handle,
+                                 const DBFRecordBlock &block, int field_idx) {
+	auto data = FlatVector::GetData<typename OP::TYPE>(result);
+	for (idx_t row_idx = 0; row_idx < record_ids.size(); row_idx++) {
+		const char *value;
+		idx_t length;
+		if (!block.TryGetField(dbf_handle, record_ids[row_idx], field_idx, value, length) ||
+		    !OP::Convert(result, value, length, data[row_idx])) {
 			FlatVector::SetNull(result, row_idx, true);
-		} else {
-			FlatVector::GetData<typename OP::TYPE>(result)[row_idx] =
-			    OP::Convert(result, dbf_handle, record_idx, field_idx);
 		}
-		record_idx++;
 	}
 }
 
-static void ConvertStringAttributeLoop(Vector &result, int record_start, idx_t count, DBFHandle dbf_handle,
-                                       int field_idx, AttributeEncoding attribute_encoding) {
-	int record_idx = record_start;
+static void ConvertStringAttributeLoop(Vector &result, const vector<int> &record_ids, DBFHandle dbf_handle,
+                                       const DBFRecordBlock &block, int field_idx,
+                                       AttributeEncoding attribute_encoding) {
+	auto data = FlatVector::GetData<string_t>(result);
 	vector<data_t> conversion_buffer;
-	for (idx_t row_idx = 0; row_idx < count; row_idx++) {
-		if (DBFIsAttributeNULL(dbf_handle, record_idx, field_idx)) {
+	for (idx_t row_idx = 0; row_idx < record_ids.size(); row_idx++) {
+		const char *value;
+		idx_t length;
+		if (!block.TryGetField(dbf_handle, record_ids[row_idx], field_idx, value, length) || length == 0) {
 			FlatVector::SetNull(result, row_idx, true);
+			continue;
+		}
+		string_t result_str;
+		if (attribute_encoding == AttributeEncoding::LATIN1) {
+			conversion_buffer.resize(length * 2); // worst case (all non-ascii chars)
+			auto out_len = EncodingUtil::LatinToUTF8Buffer(const_data_ptr_cast(value), length, conversion_buffer.data());
+			result_str = StringVector::AddString(result, const_char_ptr_cast(conversion_buffer.data()), out_len);
 		} else {
-			auto string_bytes = DBFReadStringAttribute(dbf_handle, record_idx, field_idx);
-			string_t result_str;
-			if (attribute_encoding == AttributeEncoding::LATIN1) {
-				conversion_buffer.reserve(strlen(string_bytes) * 2 + 1); // worst case (all non-ascii chars)
-				auto out_len =
-				    EncodingUtil::LatinToUTF8Buffer(const_data_ptr_cast(string_bytes), conversion_buffer.data());
-				result_str = StringVector::AddString(result, const_char_ptr_cast(conversion_buffer.data()), out_len);
-			} else {
-				result_str = StringVector::AddString(result, const_char_ptr_cast(string_bytes));
-			}
-			if (!Utf8Proc::IsValid(result_str.GetDataUnsafe(), result_str.GetSize())) {
-				throw InvalidInputException("Could not decode VARCHAR field as valid UTF-8, try passing "
-				                            "encoding='blob' to skip decoding of string attributes");
-			}
-			FlatVector::GetData<string_t>(result)[row_idx] = result_str;
+			result_str = StringVector::AddString(result, value, length);
 		}
-		record_idx++;
+		if (!Utf8Proc::IsValid(result_str.GetDataUnsafe(), result_str.GetSize())) {
+			throw InvalidInputException("Could not decode VARCHAR field as valid UTF-8, try passing "
+			                            "encoding='blob' to skip decoding of string attributes");
+		}
+		data[row_idx] = result_str;
 	}
 }
 
-static void ConvertAttributeVector(Vector &result, int record_start, idx_t count, DBFHandle dbf_handle, int field_idx,
-                                   AttributeEncoding attribute_encoding) {
+static void ConvertAttributeVector(Vector &result, const vector<int> &record_ids, DBFHandle dbf_handle,
+                                   const DBFRecordBlock &block, int field_idx, AttributeEncoding attribute_encoding) {
 	switch (result.GetType().id()) {
 	case LogicalTypeId::BLOB:
-		ConvertAttributeLoop<ConvertBlobAttribute>(result, record_start, count, dbf_handle, field_idx);
+		ConvertAttributeLoop<ConvertBlobAttribute>(result, record_ids, dbf_handle, block, field_idx);
 		break;
 	case LogicalTypeId::VARCHAR:
-		ConvertStringAttributeLoop(result, record_start, count, dbf_handle, field_idx, attribute_encoding);
+		ConvertStringAttributeLoop(result, record_ids, dbf_handle, block, field_idx, attribute_encoding);
 		break;
 	case LogicalTypeId::INTEGER:
-		ConvertAttributeLoop<ConvertIntegerAttribute>(result, record_start, count, dbf_handle, field_idx);
+		ConvertAttributeLoop<ConvertNumericAttribute<int32_t>>(result, record_ids, dbf_handle, block, field_idx);
 		break;
 	case LogicalTypeId::BIGINT:
-		ConvertAttributeLoop<ConvertBigIntAttribute>(result, record_start, count, dbf_handle, field_idx);
+		ConvertAttributeLoop<ConvertNumericAttribute<int64_t>>(result, record_ids, dbf_handle, block, field_idx);
 		break;
 	case LogicalTypeId::DOUBLE:
-		ConvertAttributeLoop<ConvertDoubleAttribute>(result, record_start, count, dbf_handle, field_idx);
+		ConvertAttributeLoop<ConvertNumericAttribute<double>>(result, record_ids, dbf_handle, block, field_idx);
 		break;
 	case LogicalTypeId::DATE:
-		ConvertAttributeLoop<ConvertDateAttribute>(result, record_start, count, dbf_handle, field_idx);
+		ConvertAttributeLoop<ConvertDateAttribute>(result, record_ids, dbf_handle, block, field_idx);
 		break;
 	case LogicalTypeId::BOOLEAN:
-		ConvertAttributeLoop<ConvertBooleanAttribute>(result, record_start, count, dbf_handle, field_idx);
+		ConvertAttributeLoop<ConvertBooleanAttribute>(result, record_ids, dbf_handle, block, field_idx);
 		break;
 	default:
 		throw InvalidInputException("Attribute type %s not supported", result.GetType().ToString());
 	}
 }
 
+//------------------------------------------------------------------------------
+// Spatial Filter
+//------------------------------------------------------------------------------
+// Every record starts with an 8 byte header followed by the shape type, and all shape types except points store their
+// bounding box right after it. Reading these few bytes is enough to skip a record without decoding its shape.
+
+static bool RecordIntersects(SHPHandle shp_handle, int record_idx, const BoundingBox &filter) {
+	if (record_idx >= shp_handle->nRecords) {
+		return false;
+	}
+	auto record_size = shp_handle->panRecSize[record_idx];
+	if (record_size < 4) {
+		return false;
+	}
+
+	data_t buffer[4 + 4 * sizeof(double)];
+	auto read_size = MinValue<idx_t>(record_size, sizeof(buffer));
+	shp_handle->sHooks.FSeek(shp_handle->fpSHP, shp_handle->panRecOffset[record_idx] + 8, SEEK_SET);
+	if (shp_handle->sHooks.FRead(buffer, read_size, 1, shp_handle->fpSHP) != 1) {
+		throw IOException("Failed to read record %d of SHP file", record_idx);
+	}
+
+	BoundingBox bbox;
+	auto shape_type = Load<int32_t>(buffer);
+	switch (shape_type) {
+	case SHPT_NULL:
+		// Null shapes never intersect the filter
+		return false;
+	case SHPT_POINT:
+	case SHPT_POINTZ:
+	case SHPT_POINTM:
+		if (read_size < 4 + 2 * sizeof(double)) {
+			return false;
+		}
+		bbox.minx = bbox.maxx = Load<double>(buffer + 4);
+		bbox.miny = bbox.maxy = Load<double>(buffer + 4 + sizeof(double));
+		break;
+	default:
+		if (read_size < sizeof(buffer)) {
+			return false;
+		}
+		bbox.minx = Load<double>(buffer + 4);
+		bbox.miny = Load<double>(buffer + 4 + sizeof(double));
+		bbox.maxx = Load<double>(buffer + 4 + 2 * sizeof(double));
+		bbox.maxy = Load<double>(buffer + 4 + 3 * sizeof(double));
+		break;
+	}
+	return bbox.Intersects(filter);
+}
+
 //------------------------------------------------------------------------------
 // Execute
 //------------------------------------------------------------------------------
@@ -487,64 +1023,116 @@ static void ConvertAttributeVector(Vector &result, int record_start, idx_t count
 static void Execute(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
 	auto &bind_data = input.bind_data->Cast<ShapefileBindData>();
 	auto &gstate = input.global_state->Cast<ShapefileGlobalState>();
+	auto &lstate = input.local_state->Cast<ShapefileLocalState>();
+
+	auto &record_ids = lstate.record_ids;
+	record_ids.clear();
+
+	// With a spatial filter a range may not have any matching records, so keep claiming ranges until one does.
+	// A chunk never spans two ranges, so the batch index stays valid.
+	while (record_ids.empty()) {
+		if (lstate.record_idx == lstate.record_end) {
+			// Claim the next range of records
+			if (!TryClaimRange(context, bind_data, gstate, lstate)) {
+				output.SetCardinality(0);
+				return;
+			}
+			OpenScanHandles(context, bind_data, lstate);
+		}
 
-	// Reset the buffer allocator
-	gstate.factory.allocator.Reset();
+		// Collect as many records as we can fit in the output
+		auto &scan_file = *lstate.scan_file;
+		while (lstate.record_idx < lstate.record_end && record_ids.size() < STANDARD_VECTOR_SIZE) {
+			auto record_idx = scan_file.GetRecordIndex(lstate.record_idx++);
+			if (gstate.has_spatial_filter &&
+			    !RecordIntersects(lstate.shp_handle.get(), record_idx, gstate.spatial_filter)) {
+				continue;
+			}
+			record_ids.push_back(record_idx);
+		}
+	}
 
-	// Calculate how many record we can fit in the output
-	auto output_size = std::min<int>(STANDARD_VECTOR_SIZE, bind_data.shape_count - gstate.shape_idx);
-	int record_start = gstate.shape_idx;
-	for (auto col_idx = 0; col_idx < output.ColumnCount(); col_idx++) {
+	auto output_size = record_ids.size();
+	if (lstate.dbf_handle) {
+		lstate.dbf_block.Load(lstate.dbf_handle.get(), record_ids);
+	}
+	auto geometry_column_idx = bind_data.GeometryColumnIndex();
+	for (idx_t col_idx = 0; col_idx < output.ColumnCount(); col_idx++) {
 
 		// Projected column indices
 		auto projected_col_idx = gstate.column_ids[col_idx];
 
 		auto &col_vec = output.data[col_idx];
-		if (col_vec.GetType() == GeoTypes::GEOMETRY()) {
-			ConvertGeometryVector(col_vec, record_start, output_size, gstate.shp_handle.get(), gstate.factory,
-			                      bind_data.shape_type);
-		} else {
-			// The geometry is always last, so we can use the projected column index directly
+		if (projected_col_idx == geometry_column_idx) {
+			ConvertGeometryVector(col_vec, record_ids, lstate.shp_handle.get(), lstate.decode_state,
+			                      lstate.scan_file->shape_type);
+		} else if (projected_col_idx == bind_data.filename_column_idx) {
+			col_vec.Reference(Value(bind_data.file_names[lstate.scan_file->file_idx]));
+		} else if (projected_col_idx < geometry_column_idx) {
+			// The geometry is always after the attributes, so we can use the projected column index directly
 			auto field_idx = projected_col_idx;
-			ConvertAttributeVector(col_vec, record_start, output_size, gstate.dbf_handle.get(), (int)field_idx,
+			ConvertAttributeVector(col_vec, record_ids, lstate.dbf_handle.get(), lstate.dbf_block, (int)field_idx,
 			                       bind_data.attribute_encoding);
+		} else {
+			// The row id, which shapefiles do not have
+			col_vec.SetVectorType(VectorType::CONSTANT_VECTOR);
+			ConstantVector::SetNull(col_vec, true);
 		}
 	}
-	// Update the shape index
-	gstate.shape_idx += output_size;
 
 	// Set the cardinality of the output
 	output.SetCardinality(output_size);
 }
 
 //------------------------------------------------------------------------------
-// Progress, Cardinality and Replacement Scans
+// Progress, Cardinality, Batch Index and Replacement Scans
 //------------------------------------------------------------------------------
 
 static double GetProgress(ClientContext &context, const FunctionData *bind_data_p,
                           const GlobalTableFunctionState *global_state) {
-
-	auto &gstate = global_state->Cast<ShapefileGlobalState>();
 	auto &bind_data = bind_data_p->Cast<ShapefileBindData>();
+	auto &gstate = global_state->Cast<ShapefileGlobalState>();
+	lock_guard<mutex> guard(gstate.lock);
+	if (!gstate.current_file) {
+		return 0;
+	}
+	// Every file counts the same, and the current file counts by the fraction of its records that have been claimed
+	auto &file = *gstate.current_file;
+	double file_progress = 1;
+	if (file.scan_count != 0) {
+		file_progress = static_cast<double>(gstate.next_record) / static_cast<double>(file.scan_count);
+	}
+	auto file_count = static_cast<double>(bind_data.file_names.size());
+	return 100 * ((static_cast<double>(file.file_idx) + file_progress) / file_count);
+}
 
-	return (double)gstate.shape_idx / (double)bind_data.shape_count;
+static idx_t GetBatchIndex(ClientContext &context, const FunctionData *bind_data_p,
+                           LocalTableFunctionState *local_state, GlobalTableFunctionState *global_state) {
+	auto &lstate = local_state->Cast<ShapefileLocalState>();
+	return lstate.batch_index;
 }
 
 static unique_ptr<NodeStatistics> GetCardinality(ClientContext &context, const FunctionData *data) {
 	auto &bind_data = data->Cast<ShapefileBindData>();
 	auto result = make_uniq<NodeStatistics>();
 
-	// This is the maximum number of shapes in a single file
-	result->has_max_cardinality = true;
-	result->max_cardinality = bind_data.shape_count;
-
+	if (bind_data.file_names.size() == 1) {
+		// This is the maximum number of shapes in a single file
+		result->has_max_cardinality = true;
+		result->max_cardinality = bind_data.shape_count;
+	} else {
+		// Only the first file has been opened, assume that the others are about as large
+		result->has_estimated_cardinality = true;
+		result->estimated_cardinality = static_cast<idx_t>(bind_data.shape_count) * bind_data.file_names.size();
+	}
 	return result;
 }
 
 static unique_ptr<TableRef> GetReplacementScan(ClientContext &context, const string &table_name,
                                                ReplacementScanData *data) {
-	// Check if the table name ends with .shp
-	if (!StringUtil::EndsWith(StringUtil::Lower(table_name), ".shp")) {
+	// Check if the table name ends with .shp, or is a zipped shapefile
+	auto lower_name = StringUtil::Lower(table_name);
+	if (!StringUtil::EndsWith(lower_name, ".shp") && !StringUtil::EndsWith(lower_name, ".shp.zip")) {
 		return nullptr;
 	}
 
@@ -559,13 +1147,24 @@ static unique_ptr<TableRef> GetReplacementScan(ClientContext &context, const str
 // Register table function
 //------------------------------------------------------------------------------
 void CoreTableFunctions::RegisterShapefileTableFunction(DatabaseInstance &db) {
-	TableFunction read_func("ST_ReadSHP", {LogicalType::VARCHAR}, Execute, Bind, InitGlobal);
+	TableFunctionSet set("ST_ReadSHP");
 
+	TableFunction read_func("ST_ReadSHP", {LogicalType::VARCHAR}, Execute, Bind, InitGlobal, InitLocal);
 	read_func.named_parameters["encoding"] = LogicalType::VARCHAR;
+	read_func.named_parameters["spatial_filter_box"] = GeoTypes::BOX_2D();
+	read_func.named_parameters["filename"] = LogicalType::BOOLEAN;
 	read_func.table_scan_progress = GetProgress;
 	read_func.cardinality = GetCardinality;
+	read_func.get_batch_index = GetBatchIndex;
 	read_func.projection_pushdown = true;
-	ExtensionUtil::RegisterFunction(db, read_func);
+	set.AddFunction(read_func);
+
+	// Read a list of files
+	TableFunction list_func = read_func;
+	list_func.arguments = {LogicalType::LIST(LogicalType::VARCHAR)};
+	set.AddFunction(list_func);
+
+	ExtensionUtil::RegisterFunction(db, set);
 
 	// Replacement scan
 	auto &config = DBConfig::GetConfig(db);
@@ -49,9 +49,13 @@ static unique_ptr<FunctionData> ShapeFileMetaBind(ClientContext &context, TableF
                                                   vector<LogicalType> &return_types, vector<string> &names) {
 	auto result = make_uniq<ShapeFileMetaBindData>();
 	auto files = MultiFileReader::GetFileList(context, input.inputs[0], "ShapeFiles", FileGlobOptions::ALLOW_EMPTY);
+	auto &fs = FileSystem::GetFileSystem(context);
 	for (auto &file : files) {
-		if (StringUtil::EndsWith(StringUtil::Lower(file), ".shp")) {
-			result->files.push_back(file);
+		// Zip archives are expanded into the shapefiles they contain
+		for (auto &file_name : ExpandShapefileArchive(fs, file)) {
+			if (StringUtil::EndsWith(StringUtil::Lower(file_name), ".shp")) {
+				result->files.push_back(file_name);
+			}
 		}
 	}
 
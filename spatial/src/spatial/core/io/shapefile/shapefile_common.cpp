@@ -1,8 +1,13 @@
 #include "duckdb/common/file_system.hpp"
+#include "duckdb/common/mutex.hpp"
 
 #include "spatial/common.hpp"
+#include "spatial/core/io/async_reader.hpp"
+#include "spatial/core/io/mapped_file.hpp"
 #include "spatial/core/io/shapefile.hpp"
 
+#include "zlib.h"
+
 void SASetupDefaultHooks(SAHooks *hooks) {
 	// Should never be called, use OpenLL and pass in the hooks
 	throw duckdb::InternalException("SASetupDefaultHooks");
@@ -12,36 +17,319 @@ namespace spatial {
 
 namespace core {
 
+//------------------------------------------------------------------------------
+// Zip Archives
+//------------------------------------------------------------------------------
+// Shapefiles inside a zip archive are addressed GDAL style, as /vsizip/path/to/archive.zip/member.shp. The archive
+// itself is read through the DuckDB file system, and a member is inflated into memory the first time it is opened.
+// The inflated member is shared by all handles that have it open, so that parallel scans only inflate it once.
+
+static constexpr const char *VSIZIP_PREFIX = "/vsizip/";
+
+struct ZipMemberEntry {
+	uint16_t method = 0;
+	idx_t compressed_size = 0;
+	idx_t uncompressed_size = 0;
+	idx_t local_header_offset = 0;
+};
+
+struct ZipMemberBuffer {
+	unsafe_unique_array<data_t> data;
+	idx_t size = 0;
+};
+
+static bool TrySplitZipPath(const string &path, string &archive_path, string &member_name) {
+	if (!StringUtil::StartsWith(path, VSIZIP_PREFIX)) {
+		return false;
+	}
+	auto inner_path = path.substr(strlen(VSIZIP_PREFIX));
+	auto archive_end = StringUtil::Lower(inner_path).find(".zip/");
+	if (archive_end == string::npos) {
+		return false;
+	}
+	archive_path = inner_path.substr(0, archive_end + 4);
+	member_name = inner_path.substr(archive_end + 5);
+	return true;
+}
+
+// Read the central directory at the end of the archive
+static unordered_map<string, ZipMemberEntry> ReadZipDirectory(FileHandle &handle) {
+	// The end of central directory record is 22 bytes, followed by a comment of at most 64KB
+	auto file_size = handle.GetFileSize();
+	auto tail_size = MinValue<idx_t>(file_size, 22 + 65535);
+	auto tail = make_unsafe_uniq_array<data_t>(tail_size);
+	handle.Read(tail.get(), tail_size, file_size - tail_size);
+
+	idx_t eocd_offset = DConstants::INVALID_INDEX;
+	for (idx_t i = tail_size; i >= 22; i--) {
+		if (Load<uint32_t>(tail.get() + i - 22) == 0x06054b50) {
+			eocd_offset = i - 22;
+			break;
+		}
+	}
+	if (eocd_offset == DConstants::INVALID_INDEX) {
+		throw IOException("Not a zip archive: %s", handle.path);
+	}
+	auto entry_count = Load<uint16_t>(tail.get() + eocd_offset + 10);
+	auto directory_size = static_cast<idx_t>(Load<uint32_t>(tail.get() + eocd_offset + 12));
+	auto directory_offset = static_cast<idx_t>(Load<uint32_t>(tail.get() + eocd_offset + 16));
+	if (entry_count == 0xFFFF || directory_offset == 0xFFFFFFFF || directory_offset + directory_size > file_size) {
+		throw IOException("Zip64 archives are not supported: %s", handle.path);
+	}
+
+	auto directory = make_unsafe_uniq_array<data_t>(directory_size);
+	handle.Read(directory.get(), directory_size, directory_offset);
+
+	unordered_map<string, ZipMemberEntry> result;
+	idx_t offset = 0;
+	for (idx_t i = 0; i < entry_count; i++) {
+		if (offset + 46 > directory_size || Load<uint32_t>(directory.get() + offset) != 0x02014b50) {
+			throw IOException("Corrupt zip archive: %s", handle.path);
+		}
+		auto entry_ptr = directory.get() + offset;
+		ZipMemberEntry entry;
+		entry.method = Load<uint16_t>(entry_ptr + 10);
+		entry.compressed_size = Load<uint32_t>(entry_ptr + 20);
+		entry.uncompressed_size = Load<uint32_t>(entry_ptr + 24);
+		entry.local_header_offset = Load<uint32_t>(entry_ptr + 42);
+		auto name_length = Load<uint16_t>(entry_ptr + 28);
+		auto extra_length = Load<uint16_t>(entry_ptr + 30);
+		auto comment_length = Load<uint16_t>(entry_ptr + 32);
+		if (offset + 46 + name_length > directory_size) {
+			throw IOException("Corrupt zip archive: %s", handle.path);
+		}
+		string name(const_char_ptr_cast(entry_ptr + 46), name_length);
+		result[name] = entry;
+		offset += 46 + name_length + extra_length + comment_length;
+	}
+	return result;
+}
+
+static shared_ptr<ZipMemberBuffer> InflateZipMember(FileHandle &handle, const ZipMemberEntry &entry) {
+	// The local header repeats the name and has its own extra field, so its size is only known after reading it
+	data_t local_header[30];
+	handle.Read(local_header, sizeof(local_header), entry.local_header_offset);
+	if (Load<uint32_t>(local_header) != 0x04034b50) {
+		throw IOException("Corrupt zip archive: %s", handle.path);
+	}
+	auto data_offset = entry.local_header_offset + sizeof(local_header) + Load<uint16_t>(local_header + 26) +
+	                   Load<uint16_t>(local_header + 28);
+
+	auto result = make_shared<ZipMemberBuffer>();
+	result->size = entry.uncompressed_size;
+	result->data = make_unsafe_uniq_array<data_t>(MaxValue<idx_t>(entry.uncompressed_size, 1));
+
+	if (entry.method == 0) {
+		// Stored
+		handle.Read(result->data.get(), entry.uncompressed_size, data_offset);
+		return result;
+	}
+	if (entry.method != 8) {
+		throw NotImplementedException("Zip compression method %d is not supported: %s", entry.method, handle.path);
+	}
+
+	// Deflated, inflate the raw stream in chunks as it is read
+	static constexpr idx_t INFLATE_CHUNK_SIZE = 1 << 20;
+	auto chunk = make_unsafe_uniq_array<data_t>(INFLATE_CHUNK_SIZE);
+	z_stream zstream = {};
+	if (inflateInit2(&zstream, -MAX_WBITS) != Z_OK) {
+		throw IOException("Failed to initialize zlib");
+	}
+	zstream.next_out = result->data.get();
+	zstream.avail_out = entry.uncompressed_size;
+
+	auto read_offset = data_offset;
+	auto remaining = entry.compressed_size;
+	int status = Z_OK;
+	while (status == Z_OK && remaining > 0) {
+		auto read_size = MinValue<idx_t>(remaining, INFLATE_CHUNK_SIZE);
+		handle.Read(chunk.get(), read_size, read_offset);
+		read_offset += read_size;
+		remaining -= read_size;
+
+		zstream.next_in = chunk.get();
+		zstream.avail_in = read_size;
+		status = inflate(&zstream, remaining == 0 ? Z_FINISH : Z_NO_FLUSH);
+		if (status == Z_BUF_ERROR && zstream.avail_in == 0 && remaining > 0) {
+			// Needs more input
+			status = Z_OK;
+		}
+	}
+	auto total_out = zstream.total_out;
+	inflateEnd(&zstream);
+	if (status != Z_STREAM_END || total_out != entry.uncompressed_size) {
+		throw IOException("Failed to inflate zip archive member: %s", handle.path);
+	}
+	return result;
+}
+
+// The members that are currently open, so that every handle of a member shares the same inflated buffer
+static mutex zip_member_lock;
+static unordered_map<string, weak_ptr<ZipMemberBuffer>> zip_member_cache;
+
+static shared_ptr<ZipMemberBuffer> OpenZipMember(FileSystem &fs, const string &archive_path,
+                                                 const string &member_name) {
+	auto cache_key = archive_path + "/" + member_name;
+	lock_guard<mutex> guard(zip_member_lock);
+	auto entry = zip_member_cache.find(cache_key);
+	if (entry != zip_member_cache.end()) {
+		auto buffer = entry->second.lock();
+		if (buffer) {
+			return buffer;
+		}
+	}
+
+	auto handle = fs.OpenFile(archive_path, FileFlags::FILE_FLAGS_READ);
+	auto directory = ReadZipDirectory(*handle);
+	auto member = directory.find(member_name);
+	if (member == directory.end()) {
+		return nullptr;
+	}
+	auto buffer = InflateZipMember(*handle, member->second);
+	zip_member_cache[cache_key] = buffer;
+	return buffer;
+}
+
+vector<string> ExpandShapefileArchive(FileSystem &fs, const string &file_name) {
+	if (!StringUtil::EndsWith(StringUtil::Lower(file_name), ".zip")) {
+		return {file_name};
+	}
+	auto handle = fs.OpenFile(file_name, FileFlags::FILE_FLAGS_READ);
+	vector<string> result;
+	for (auto &entry : ReadZipDirectory(*handle)) {
+		if (StringUtil::EndsWith(StringUtil::Lower(entry.first), ".shp")) {
+			result.push_back(VSIZIP_PREFIX + file_name + "/" + entry.first);
+		}
+	}
+	// The directory is unordered
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+bool ShapefileFileExists(FileSystem &fs, const string &filename) {
+	string archive_path;
+	string member_name;
+	if (!TrySplitZipPath(filename, archive_path, member_name)) {
+		return fs.FileExists(filename);
+	}
+	if (!fs.FileExists(archive_path)) {
+		return false;
+	}
+	auto handle = fs.OpenFile(archive_path, FileFlags::FILE_FLAGS_READ);
+	auto directory = ReadZipDirectory(*handle);
+	return directory.find(member_name) != directory.end();
+}
+
 //------------------------------------------------------------------------------
 // Shapefile filesystem abstractions
 //------------------------------------------------------------------------------
+// shapelib accesses files through these hooks. A file is either a DuckDB file handle, or its contents are in memory:
+// an inflated zip member, or a local file mapped into memory. Files that can not be mapped, e.g. remote ones, are
+// read ahead in blocks, as shapelib reads them record after record.
+
+static constexpr idx_t SHAPEFILE_READ_BLOCK_SIZE = 1024 * 1024;
+
+struct ShapefileHandle {
+	unique_ptr<FileHandle> file;
+	unique_ptr<ReadAheadBuffer> read_ahead;
+	shared_ptr<ZipMemberBuffer> member;
+	unique_ptr<MappedFile> mapping;
+	const_data_ptr_t data = nullptr;
+	idx_t size = 0;
+	idx_t position = 0;
+
+	idx_t Read(void *buffer, idx_t nr_bytes) {
+		if (read_ahead) {
+			auto read_size = read_ahead->Read(data_ptr_cast(buffer), nr_bytes, position);
+			position += read_size;
+			return read_size;
+		}
+		if (file) {
+			return file->Read(buffer, nr_bytes);
+		}
+		auto read_size = position < size ? MinValue<idx_t>(nr_bytes, size - position) : 0;
+		memcpy(buffer, data + position, read_size);
+		position += read_size;
+		return read_size;
+	}
+
+	void Seek(idx_t location) {
+		if (file && !read_ahead) {
+			file->Seek(location);
+		} else {
+			position = location;
+		}
+	}
+
+	idx_t SeekPosition() {
+		return file && !read_ahead ? file->SeekPosition() : position;
+	}
+
+	idx_t GetFileSize() {
+		if (read_ahead) {
+			return read_ahead->GetFileSize();
+		}
+		return file ? file->GetFileSize() : size;
+	}
+};
+
 static SAFile DuckDBShapefileOpen(void *userData, const char *filename, const char *access_mode) {
 	try {
 		auto &fs = *reinterpret_cast<FileSystem *>(userData);
-		auto file_handle = fs.OpenFile(filename, FileFlags::FILE_FLAGS_READ);
-		if (!file_handle) {
-			return nullptr;
+		auto handle = make_uniq<ShapefileHandle>();
+		string archive_path;
+		string member_name;
+		if (TrySplitZipPath(filename, archive_path, member_name)) {
+			handle->member = OpenZipMember(fs, archive_path, member_name);
+			if (!handle->member) {
+				return nullptr;
+			}
+			handle->data = handle->member->data.get();
+			handle->size = handle->member->size;
+		} else if (strchr(access_mode, 'w')) {
+			// Only used to write the spatial index
+			handle->file = fs.OpenFile(filename, FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE_NEW);
+		} else {
+			handle->file = fs.OpenFile(filename, FileFlags::FILE_FLAGS_READ);
+			if (!handle->file) {
+				return nullptr;
+			}
+			// The records and the attributes are read from front to back, local files are mapped to save the
+			// system call shapelib makes for every record
+			handle->mapping = MappedFile::TryMap(*handle->file, true);
+			if (handle->mapping) {
+				handle->file.reset();
+				handle->data = handle->mapping->GetData();
+				handle->size = handle->mapping->GetSize();
+			} else if (handle->file->CanSeek()) {
+				// The hooks have no client context, so the default queue depth is used
+				handle->read_ahead = make_uniq<ReadAheadBuffer>(*handle->file, SHAPEFILE_READ_BLOCK_SIZE,
+				                                                AsyncReader::DEFAULT_QUEUE_DEPTH);
+			}
 		}
-		return reinterpret_cast<SAFile>(file_handle.release());
+		return reinterpret_cast<SAFile>(handle.release());
 	} catch (...) {
 		return nullptr;
 	}
 }
 
 static SAOffset DuckDBShapefileRead(void *p, SAOffset size, SAOffset nmemb, SAFile file) {
-	auto handle = reinterpret_cast<FileHandle *>(file);
+	auto handle = reinterpret_cast<ShapefileHandle *>(file);
 	auto read_bytes = handle->Read(p, size * nmemb);
 	return read_bytes / size;
 }
 
 static SAOffset DuckDBShapefileWrite(const void *p, SAOffset size, SAOffset nmemb, SAFile file) {
-	auto handle = reinterpret_cast<FileHandle *>(file);
-	auto written_bytes = handle->Write(const_cast<void *>(p), size * nmemb);
+	auto handle = reinterpret_cast<ShapefileHandle *>(file);
+	if (!handle->file) {
+		return 0;
+	}
+	auto written_bytes = handle->file->Write(const_cast<void *>(p), size * nmemb);
 	return written_bytes / size;
 }
 
 static SAOffset DuckDBShapefileSeek(SAFile file, SAOffset offset, int whence) {
-	auto file_handle = reinterpret_cast<FileHandle *>(file);
+	auto file_handle = reinterpret_cast<ShapefileHandle *>(file);
 	switch (whence) {
 	case SEEK_SET:
 		file_handle->Seek(offset);
@@ -59,14 +347,16 @@ static SAOffset DuckDBShapefileSeek(SAFile file, SAOffset offset, int whence) {
 }
 
 static SAOffset DuckDBShapefileTell(SAFile file) {
-	auto handle = reinterpret_cast<FileHandle *>(file);
+	auto handle = reinterpret_cast<ShapefileHandle *>(file);
 	return handle->SeekPosition();
 }
 
 static int DuckDBShapefileFlush(SAFile file) {
 	try {
-		auto handle = reinterpret_cast<FileHandle *>(file);
-		handle->Sync();
+		auto handle = reinterpret_cast<ShapefileHandle *>(file);
+		if (handle->file) {
+			handle->file->Sync();
+		}
 		return 0;
 	} catch (...) {
 		return -1;
@@ -75,8 +365,10 @@ static int DuckDBShapefileFlush(SAFile file) {
 
 static int DuckDBShapefileClose(SAFile file) {
 	try {
-		auto handle = reinterpret_cast<FileHandle *>(file);
-		handle->Close();
+		auto handle = reinterpret_cast<ShapefileHandle *>(file);
+		if (handle->file) {
+			handle->file->Close();
+		}
 		delete handle;
 		return 0;
 	} catch (...) {
@@ -152,6 +444,38 @@ SHPHandlePtr OpenSHPFile(FileSystem &fs, const string &filename) {
 	return SHPHandlePtr(handle);
 }
 
+SHPTreeDiskHandlePtr TryOpenQIXFile(FileSystem &fs, const string &filename) {
+	if (!ShapefileFileExists(fs, filename)) {
+		return nullptr;
+	}
+	auto hooks = GetDuckDBHooks(fs);
+	return SHPTreeDiskHandlePtr(SHPOpenDiskTree(filename.c_str(), &hooks));
+}
+
+SBNSearchHandlePtr TryOpenSBNFile(FileSystem &fs, const string &filename) {
+	if (!ShapefileFileExists(fs, filename)) {
+		return nullptr;
+	}
+	auto hooks = GetDuckDBHooks(fs);
+	return SBNSearchHandlePtr(SBNOpenDiskTree(filename.c_str(), &hooks));
+}
+
+void WriteQIXFile(FileSystem &fs, const string &shp_filename, const string &qix_filename) {
+	auto shp_handle = OpenSHPFile(fs, shp_filename);
+	// Let shapelib pick the depth of the tree from the number of shapes
+	auto tree = SHPCreateTree(shp_handle.get(), 2, 0, nullptr, nullptr);
+	if (!tree) {
+		throw IOException("Failed to build spatial index for %s", shp_filename);
+	}
+	SHPTreeTrimExtraNodes(tree);
+	auto hooks = GetDuckDBHooks(fs);
+	auto ok = SHPWriteTreeLL(tree, qix_filename.c_str(), &hooks);
+	SHPDestroyTree(tree);
+	if (!ok) {
+		throw IOException("Failed to write spatial index %s", qix_filename);
+	}
+}
+
 } // namespace core
 
 } // namespace spatial
\ No newline at end of file
@@ -0,0 +1,811 @@
+#include "duckdb/common/types/column/column_data_collection.hpp"
+#include "duckdb/common/types/date.hpp"
+#include "duckdb/function/copy_function.hpp"
+#include "duckdb/parser/parsed_data/copy_info.hpp"
+#include "duckdb/parser/parsed_data/create_copy_function_info.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/vector_operations/vector_operations.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/functions/copy.hpp"
+#include "spatial/core/io/shapefile.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_processor.hpp"
+
+#include "shapefil.h"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Bind
+//------------------------------------------------------------------------------
+// Every attribute column becomes a fixed width DBF field, the widths have to be known up front so that rows can be
+// encoded in parallel.
+
+enum class DBFFieldKind : uint8_t {
+	LOGICAL,
+	INTEGER,
+	DOUBLE,
+	DATE,
+	// VARCHAR, anything else is cast to VARCHAR first
+	STRING,
+	CAST_STRING
+};
+
+struct DBFFieldInfo {
+	string name;
+	DBFFieldKind kind;
+	char type;
+	uint8_t width;
+	uint8_t decimals;
+};
+
+static DBFFieldInfo GetFieldInfo(const LogicalType &type) {
+	switch (type.id()) {
+	case LogicalTypeId::BOOLEAN:
+		return {"", DBFFieldKind::LOGICAL, 'L', 1, 0};
+	// Fields narrower than 10 digits are read back as INTEGER, wider ones as BIGINT
+	case LogicalTypeId::TINYINT:
+	case LogicalTypeId::SMALLINT:
+	case LogicalTypeId::UTINYINT:
+	case LogicalTypeId::USMALLINT:
+		return {"", DBFFieldKind::INTEGER, 'N', 6, 0};
+	case LogicalTypeId::INTEGER:
+	case LogicalTypeId::UINTEGER:
+		return {"", DBFFieldKind::INTEGER, 'N', 11, 0};
+	case LogicalTypeId::BIGINT:
+		return {"", DBFFieldKind::INTEGER, 'N', 18, 0};
+	case LogicalTypeId::UBIGINT:
+	case LogicalTypeId::HUGEINT:
+	case LogicalTypeId::UHUGEINT:
+	case LogicalTypeId::FLOAT:
+	case LogicalTypeId::DOUBLE:
+	case LogicalTypeId::DECIMAL:
+		return {"", DBFFieldKind::DOUBLE, 'N', 24, 15};
+	case LogicalTypeId::DATE:
+		return {"", DBFFieldKind::DATE, 'D', 8, 0};
+	case LogicalTypeId::VARCHAR:
+		return {"", DBFFieldKind::STRING, 'C', 254, 0};
+	default:
+		return {"", DBFFieldKind::CAST_STRING, 'C', 254, 0};
+	}
+}
+
+struct ShapefileWriteBindData : public TableFunctionData {
+	string file_path;
+	idx_t geometry_column_idx = DConstants::INVALID_INDEX;
+	// The DBF field of every attribute column, the geometry column has an empty entry
+	vector<DBFFieldInfo> fields;
+	idx_t record_length = 1;
+	AttributeEncoding encoding = AttributeEncoding::UTF8;
+	// Also write a quadtree spatial index (.qix)
+	bool spatial_index = false;
+};
+
+// DBF field names are at most 10 bytes, truncate them and make them unique again
+static vector<string> GetFieldNames(const vector<string> &names) {
+	vector<string> result;
+	for (auto &name : names) {
+		auto field_name = name.substr(0, 10);
+		for (idx_t suffix = 1; std::find(result.begin(), result.end(), field_name) != result.end(); suffix++) {
+			auto suffix_str = "_" + std::to_string(suffix);
+			field_name = name.substr(0, 10 - suffix_str.size()) + suffix_str;
+		}
+		result.push_back(field_name);
+	}
+	return result;
+}
+
+static unique_ptr<FunctionData> Bind(ClientContext &context, CopyFunctionBindInput &input, const vector<string> &names,
+                                     const vector<LogicalType> &sql_types) {
+	auto bind_data = make_uniq<ShapefileWriteBindData>();
+	bind_data->file_path = input.info.file_path;
+
+	for (auto &option : input.info.options) {
+		if (StringUtil::Upper(option.first) == "SPATIAL_INDEX") {
+			auto set = option.second.empty() ? Value::BOOLEAN(true) : option.second.front();
+			if (!set.DefaultTryCastAs(LogicalType::BOOLEAN) || set.IsNull()) {
+				throw BinderException("SPATIAL_INDEX must be a boolean");
+			}
+			bind_data->spatial_index = BooleanValue::Get(set);
+		} else if (StringUtil::Upper(option.first) == "ENCODING") {
+			auto set = option.second.empty() ? Value() : option.second.front();
+			if (set.type().id() != LogicalTypeId::VARCHAR) {
+				throw BinderException("ENCODING must be a string");
+			}
+			auto encoding = StringUtil::Lower(StringValue::Get(set));
+			if (encoding == "utf-8") {
+				bind_data->encoding = AttributeEncoding::UTF8;
+			} else if (encoding == "iso-8859-1") {
+				bind_data->encoding = AttributeEncoding::LATIN1;
+			} else {
+				throw BinderException("Unknown encoding '%s', expected one of 'UTF-8', 'ISO-8859-1'", encoding);
+			}
+		} else {
+			throw BinderException("Unknown option '%s'", option.first);
+		}
+	}
+
+	// The first geometry column is the shape of the records, every other column is an attribute
+	vector<string> attribute_names;
+	for (idx_t col_idx = 0; col_idx < sql_types.size(); col_idx++) {
+		if (bind_data->geometry_column_idx == DConstants::INVALID_INDEX && sql_types[col_idx] == GeoTypes::GEOMETRY()) {
+			bind_data->geometry_column_idx = col_idx;
+			continue;
+		}
+		attribute_names.push_back(names[col_idx]);
+	}
+	if (bind_data->geometry_column_idx == DConstants::INVALID_INDEX) {
+		throw BinderException("SHP requires a GEOMETRY column");
+	}
+	if (attribute_names.size() > 255) {
+		throw BinderException("SHP supports at most 255 attribute columns");
+	}
+
+	auto field_names = GetFieldNames(attribute_names);
+	idx_t field_idx = 0;
+	for (idx_t col_idx = 0; col_idx < sql_types.size(); col_idx++) {
+		if (col_idx == bind_data->geometry_column_idx) {
+			bind_data->fields.push_back({"", DBFFieldKind::CAST_STRING, 'C', 0, 0});
+			continue;
+		}
+		auto field = GetFieldInfo(sql_types[col_idx]);
+		field.name = field_names[field_idx++];
+		bind_data->record_length += field.width;
+		bind_data->fields.push_back(field);
+	}
+	if (bind_data->record_length > NumericLimits<uint16_t>::Maximum()) {
+		throw BinderException("The attribute columns are too wide for a DBF file");
+	}
+
+	input.file_extension = "shp";
+	return std::move(bind_data);
+}
+
+//------------------------------------------------------------------------------
+// Shape Encoding
+//------------------------------------------------------------------------------
+// Geometries are flattened into the parts and x/y pairs of a shape record. Shapefiles expect the shells of polygons in
+// clockwise order and their holes in counter-clockwise order, so rings are reversed where necessary.
+
+class ShapeRecordEncoder final : GeometryProcessor<void> {
+public:
+	vector<int32_t> parts;
+	vector<double> points;
+
+	// Returns the shapefile shape type of the geometry, SHPT_NULL if it is empty
+	int32_t Encode(const geometry_t &geom) {
+		parts.clear();
+		points.clear();
+		if (geom.GetProperties().HasZ() || geom.GetProperties().HasM()) {
+			throw NotImplementedException("Writing geometries with Z or M values to SHP is not supported");
+		}
+		Process(geom);
+		if (points.empty()) {
+			return SHPT_NULL;
+		}
+		switch (geom.GetType()) {
+		case GeometryType::POINT:
+			return SHPT_POINT;
+		case GeometryType::LINESTRING:
+		case GeometryType::MULTILINESTRING:
+			return SHPT_ARC;
+		case GeometryType::POLYGON:
+		case GeometryType::MULTIPOLYGON:
+			return SHPT_POLYGON;
+		case GeometryType::MULTIPOINT:
+			return SHPT_MULTIPOINT;
+		default:
+			throw InvalidInputException("SHP does not support GEOMETRYCOLLECTION");
+		}
+	}
+
+private:
+	void AppendVertices(const VertexData &vertices, bool reverse) {
+		for (uint32_t i = 0; i < vertices.count; i++) {
+			auto vertex_idx = reverse ? vertices.count - 1 - i : i;
+			points.push_back(Load<double>(vertices.data[0] + vertex_idx * vertices.stride[0]));
+			points.push_back(Load<double>(vertices.data[1] + vertex_idx * vertices.stride[1]));
+		}
+	}
+
+	static double SignedArea(const VertexData &vertices) {
+		double area = 0;
+		for (uint32_t i = 0; i + 1 < vertices.count; i++) {
+			auto x1 = Load<double>(vertices.data[0] + i * vertices.stride[0]);
+			auto y1 = Load<double>(vertices.data[1] + i * vertices.stride[1]);
+			auto x2 = Load<double>(vertices.data[0] + (i + 1) * vertices.stride[0]);
+			auto y2 = Load<double>(vertices.data[1] + (i + 1) * vertices.stride[1]);
+			area += x1 * y2 - x2 * y1;
+		}
+		return area / 2;
+	}
+
+	void ProcessPoint(const VertexData &vertices) override {
+		AppendVertices(vertices, false);
+	}
+
+	void ProcessLineString(const VertexData &vertices) override {
+		if (vertices.IsEmpty()) {
+			return;
+		}
+		parts.push_back(static_cast<int32_t>(points.size() / 2));
+		AppendVertices(vertices, false);
+	}
+
+	void ProcessPolygon(PolygonState &state) override {
+		bool is_shell = true;
+		while (!state.IsDone()) {
+			auto vertices = state.Next();
+			if (vertices.IsEmpty()) {
+				is_shell = false;
+				continue;
+			}
+			// Shells are clockwise (negative area), holes counter-clockwise
+			auto area = SignedArea(vertices);
+			parts.push_back(static_cast<int32_t>(points.size() / 2));
+			AppendVertices(vertices, is_shell ? area > 0 : area < 0);
+			is_shell = false;
+		}
+	}
+
+	void ProcessCollection(CollectionState &state) override {
+		if (CurrentType() == GeometryType::GEOMETRYCOLLECTION) {
+			throw InvalidInputException("SHP does not support GEOMETRYCOLLECTION");
+		}
+		while (!state.IsDone()) {
+			state.Next();
+		}
+	}
+};
+
+//------------------------------------------------------------------------------
+// Record Encoding
+//------------------------------------------------------------------------------
+// Rows are encoded into the SHP records and DBF rows of a buffer, which is then appended to the files as a whole.
+// The record numbers and the .shx index entries depend on the position in the file, so they are only filled in when
+// the buffer is written.
+
+static constexpr idx_t SHP_HEADER_SIZE = 100;
+static constexpr idx_t SHP_RECORD_HEADER_SIZE = 8;
+
+static void StoreBigEndian(int32_t value, data_ptr_t ptr) {
+	auto bits = static_cast<uint32_t>(value);
+	ptr[0] = static_cast<data_t>(bits >> 24);
+	ptr[1] = static_cast<data_t>(bits >> 16);
+	ptr[2] = static_cast<data_t>(bits >> 8);
+	ptr[3] = static_cast<data_t>(bits);
+}
+
+struct ShapefileWriteBuffer {
+	vector<data_t> shp_data;
+	// The offset of every record in shp_data
+	vector<idx_t> record_offsets;
+	vector<data_t> dbf_data;
+	// The shape type of the non-null records, and their extent
+	int32_t shape_type = SHPT_NULL;
+	BoundingBox extent;
+
+	void Clear() {
+		shp_data.clear();
+		record_offsets.clear();
+		dbf_data.clear();
+		shape_type = SHPT_NULL;
+		extent = BoundingBox();
+	}
+
+	data_ptr_t AppendRecord(idx_t content_size) {
+		auto offset = shp_data.size();
+		record_offsets.push_back(offset);
+		shp_data.resize(offset + SHP_RECORD_HEADER_SIZE + content_size);
+		auto ptr = shp_data.data() + offset;
+		// The record number is filled in when the buffer is written
+		StoreBigEndian(0, ptr);
+		StoreBigEndian(static_cast<int32_t>(content_size / 2), ptr + 4);
+		return ptr + SHP_RECORD_HEADER_SIZE;
+	}
+};
+
+static const char *GetShapeTypeName(int32_t shape_type) {
+	switch (shape_type) {
+	case SHPT_POINT:
+		return "POINT";
+	case SHPT_ARC:
+		return "LINESTRING";
+	case SHPT_POLYGON:
+		return "POLYGON";
+	case SHPT_MULTIPOINT:
+		return "MULTIPOINT";
+	default:
+		return "NULL";
+	}
+}
+
+// All non-null records of a shapefile have the same shape type
+static void MergeShapeType(int32_t &shape_type, int32_t other) {
+	if (other == SHPT_NULL || other == shape_type) {
+		return;
+	}
+	if (shape_type != SHPT_NULL) {
+		throw InvalidInputException("SHP files can only contain one geometry type, got both %s and %s",
+		                            GetShapeTypeName(shape_type), GetShapeTypeName(other));
+	}
+	shape_type = other;
+}
+
+static void MergeExtent(BoundingBox &extent, const BoundingBox &other) {
+	extent.minx = MinValue(extent.minx, other.minx);
+	extent.miny = MinValue(extent.miny, other.miny);
+	extent.maxx = MaxValue(extent.maxx, other.maxx);
+	extent.maxy = MaxValue(extent.maxy, other.maxy);
+}
+
+static void EncodeShape(ShapeRecordEncoder &encoder, const geometry_t *geom, ShapefileWriteBuffer &buffer) {
+	auto shape_type = geom ? encoder.Encode(*geom) : SHPT_NULL;
+	MergeShapeType(buffer.shape_type, shape_type);
+
+	auto &points = encoder.points;
+	auto point_count = static_cast<int32_t>(points.size() / 2);
+	BoundingBox bbox;
+	for (idx_t i = 0; i < points.size(); i += 2) {
+		bbox.minx = MinValue(bbox.minx, points[i]);
+		bbox.miny = MinValue(bbox.miny, points[i + 1]);
+		bbox.maxx = MaxValue(bbox.maxx, points[i]);
+		bbox.maxy = MaxValue(bbox.maxy, points[i + 1]);
+	}
+
+	switch (shape_type) {
+	case SHPT_NULL: {
+		auto ptr = buffer.AppendRecord(sizeof(int32_t));
+		Store<int32_t>(SHPT_NULL, ptr);
+		return;
+	}
+	case SHPT_POINT: {
+		auto ptr = buffer.AppendRecord(sizeof(int32_t) + 2 * sizeof(double));
+		Store<int32_t>(SHPT_POINT, ptr);
+		memcpy(ptr + sizeof(int32_t), points.data(), 2 * sizeof(double));
+		break;
+	}
+	case SHPT_MULTIPOINT: {
+		auto ptr = buffer.AppendRecord(40 + points.size() * sizeof(double));
+		Store<int32_t>(SHPT_MULTIPOINT, ptr);
+		Store<double>(bbox.minx, ptr + 4);
+		Store<double>(bbox.miny, ptr + 12);
+		Store<double>(bbox.maxx, ptr + 20);
+		Store<double>(bbox.maxy, ptr + 28);
+		Store<int32_t>(point_count, ptr + 36);
+		memcpy(ptr + 40, points.data(), points.size() * sizeof(double));
+		break;
+	}
+	default: {
+		auto &parts = encoder.parts;
+		auto parts_size = parts.size() * sizeof(int32_t);
+		auto ptr = buffer.AppendRecord(44 + parts_size + points.size() * sizeof(double));
+		Store<int32_t>(shape_type, ptr);
+		Store<double>(bbox.minx, ptr + 4);
+		Store<double>(bbox.miny, ptr + 12);
+		Store<double>(bbox.maxx, ptr + 20);
+		Store<double>(bbox.maxy, ptr + 28);
+		Store<int32_t>(static_cast<int32_t>(parts.size()), ptr + 36);
+		Store<int32_t>(point_count, ptr + 40);
+		memcpy(ptr + 44, parts.data(), parts_size);
+		memcpy(ptr + 44 + parts_size, points.data(), points.size() * sizeof(double));
+		break;
+	}
+	}
+	MergeExtent(buffer.extent, bbox);
+}
+
+// Write a value into a field, right aligned for numbers and left aligned for text. The field is already blank.
+static void WriteNumber(data_ptr_t field, idx_t width, const char *value, idx_t length) {
+	if (length > width) {
+		throw InvalidInputException("Value %s does not fit in a DBF field of width %d", string(value, length),
+		                            width);
+	}
+	memcpy(field + width - length, value, length);
+}
+
+static void WriteString(data_ptr_t field, idx_t width, const char *value, idx_t length,
+                        AttributeEncoding encoding) {
+	if (encoding == AttributeEncoding::LATIN1) {
+		// Every UTF-8 character becomes a single byte
+		auto ptr = const_data_ptr_cast(value);
+		auto end = ptr + length;
+		idx_t out_len = 0;
+		while (ptr < end && out_len < width) {
+			field[out_len++] = EncodingUtil::UTF8ToLatin1Char(ptr);
+			ptr += EncodingUtil::GetUTF8ByteLength(*ptr);
+		}
+		return;
+	}
+	// Truncate to the last complete UTF-8 character that fits
+	if (length > width) {
+		length = width;
+		while (length > 0 && (static_cast<data_t>(value[length]) & 0xC0) == 0x80) {
+			length--;
+		}
+	}
+	memcpy(field, value, length);
+}
+
+static void EncodeAttribute(const DBFFieldInfo &field, const UnifiedVectorFormat &format, idx_t row_idx,
+                            data_ptr_t ptr, AttributeEncoding encoding) {
+	char value[64];
+	auto idx = format.sel->get_index(row_idx);
+	if (!format.validity.RowIsValid(idx)) {
+		// Null numbers are filled with asterisks, null dates with zeroes and null booleans with a question mark
+		switch (field.kind) {
+		case DBFFieldKind::LOGICAL:
+			ptr[0] = '?';
+			break;
+		case DBFFieldKind::INTEGER:
+		case DBFFieldKind::DOUBLE:
+			memset(ptr, '*', field.width);
+			break;
+		case DBFFieldKind::DATE:
+			memset(ptr, '0', field.width);
+			break;
+		default:
+			break;
+		}
+		return;
+	}
+	switch (field.kind) {
+	case DBFFieldKind::LOGICAL:
+		ptr[0] = UnifiedVectorFormat::GetData<bool>(format)[idx] ? 'T' : 'F';
+		break;
+	case DBFFieldKind::INTEGER: {
+		auto length = snprintf(value, sizeof(value), "%lld",
+		                       static_cast<long long>(UnifiedVectorFormat::GetData<int64_t>(format)[idx]));
+		WriteNumber(ptr, field.width, value, length);
+		break;
+	}
+	case DBFFieldKind::DOUBLE: {
+		auto number = UnifiedVectorFormat::GetData<double>(format)[idx];
+		if (!Value::IsFinite(number)) {
+			memset(ptr, '*', field.width);
+			break;
+		}
+		auto length = snprintf(value, sizeof(value), "%.*f", field.decimals, number);
+		if (length > field.width) {
+			// Too large for the fixed notation, this always fits
+			length = snprintf(value, sizeof(value), "%.15e", number);
+		}
+		WriteNumber(ptr, field.width, value, length);
+		break;
+	}
+	case DBFFieldKind::DATE: {
+		auto date = UnifiedVectorFormat::GetData<date_t>(format)[idx];
+		int32_t year, month, day;
+		if (!Date::IsFinite(date)) {
+			memset(ptr, '0', field.width);
+			break;
+		}
+		Date::Convert(date, year, month, day);
+		if (year < 0 || year > 9999) {
+			memset(ptr, '0', field.width);
+			break;
+		}
+		snprintf(value, sizeof(value), "%04d%02d%02d", year, month, day);
+		memcpy(ptr, value, 8);
+		break;
+	}
+	case DBFFieldKind::STRING:
+	case DBFFieldKind::CAST_STRING: {
+		auto &str = UnifiedVectorFormat::GetData<string_t>(format)[idx];
+		WriteString(ptr, field.width, str.GetDataUnsafe(), str.GetSize(), encoding);
+		break;
+	}
+	}
+}
+
+static void EncodeChunk(ClientContext &context, const ShapefileWriteBindData &bind_data, DataChunk &chunk,
+                        ShapeRecordEncoder &encoder, ShapefileWriteBuffer &buffer) {
+	auto count = chunk.size();
+	auto column_count = chunk.ColumnCount();
+
+	// Integers and doubles are widened, and everything that is not a string already is cast to one
+	vector<UnifiedVectorFormat> formats(column_count);
+	vector<unique_ptr<Vector>> casts(column_count);
+	for (idx_t col_idx = 0; col_idx < column_count; col_idx++) {
+		auto &source = chunk.data[col_idx];
+		LogicalType cast_type = LogicalTypeId::INVALID;
+		if (col_idx != bind_data.geometry_column_idx) {
+			switch (bind_data.fields[col_idx].kind) {
+			case DBFFieldKind::INTEGER:
+				cast_type = LogicalType::BIGINT;
+				break;
+			case DBFFieldKind::DOUBLE:
+				cast_type = LogicalType::DOUBLE;
+				break;
+			case DBFFieldKind::CAST_STRING:
+				cast_type = LogicalType::VARCHAR;
+				break;
+			default:
+				break;
+			}
+		}
+		if (cast_type.id() != LogicalTypeId::INVALID && cast_type != source.GetType()) {
+			casts[col_idx] = make_uniq<Vector>(cast_type, count);
+			VectorOperations::Cast(context, source, *casts[col_idx], count);
+			casts[col_idx]->ToUnifiedFormat(count, formats[col_idx]);
+		} else {
+			source.ToUnifiedFormat(count, formats[col_idx]);
+		}
+	}
+
+	auto &geom_format = formats[bind_data.geometry_column_idx];
+	auto geom_data = UnifiedVectorFormat::GetData<geometry_t>(geom_format);
+
+	auto dbf_offset = buffer.dbf_data.size();
+	buffer.dbf_data.resize(dbf_offset + count * bind_data.record_length, ' ');
+	for (idx_t row_idx = 0; row_idx < count; row_idx++) {
+		auto geom_idx = geom_format.sel->get_index(row_idx);
+		auto geom = geom_format.validity.RowIsValid(geom_idx) ? &geom_data[geom_idx] : nullptr;
+		EncodeShape(encoder, geom, buffer);
+
+		// Every row starts with the deletion flag, which is blank
+		auto field_ptr = buffer.dbf_data.data() + dbf_offset + row_idx * bind_data.record_length + 1;
+		for (idx_t col_idx = 0; col_idx < column_count; col_idx++) {
+			if (col_idx == bind_data.geometry_column_idx) {
+				continue;
+			}
+			auto &field = bind_data.fields[col_idx];
+			EncodeAttribute(field, formats[col_idx], row_idx, field_ptr, bind_data.encoding);
+			field_ptr += field.width;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// Init
+//------------------------------------------------------------------------------
+
+static string GetSiblingPath(const string &file_path, const string &extension) {
+	auto dot = file_path.find_last_of('.');
+	auto slash = file_path.find_last_of("/\\");
+	if (dot == string::npos || (slash != string::npos && dot < slash)) {
+		return file_path + extension;
+	}
+	return file_path.substr(0, dot) + extension;
+}
+
+struct ShapefileWriteGlobalState : public GlobalFunctionData {
+	mutex lock;
+	unique_ptr<FileHandle> shp_handle;
+	unique_ptr<FileHandle> shx_handle;
+	unique_ptr<FileHandle> dbf_handle;
+
+	idx_t record_count = 0;
+	idx_t shp_size = SHP_HEADER_SIZE;
+	int32_t shape_type = SHPT_NULL;
+	BoundingBox extent;
+	vector<data_t> shx_buffer;
+
+	// Append a buffer to the files, must be called in the order the rows should be written
+	void WriteBuffer(ShapefileWriteBuffer &buffer) {
+		lock_guard<mutex> glock(lock);
+		MergeShapeType(shape_type, buffer.shape_type);
+		MergeExtent(extent, buffer.extent);
+
+		auto count = buffer.record_offsets.size();
+		shx_buffer.resize(count * SHP_RECORD_HEADER_SIZE);
+		for (idx_t i = 0; i < count; i++) {
+			auto record_ptr = buffer.shp_data.data() + buffer.record_offsets[i];
+			auto record_end = i + 1 < count ? buffer.record_offsets[i + 1] : buffer.shp_data.size();
+			auto content_size = record_end - buffer.record_offsets[i] - SHP_RECORD_HEADER_SIZE;
+
+			// Offsets and lengths are counted in 16 bit words
+			auto offset = shp_size + buffer.record_offsets[i];
+			if ((offset + SHP_RECORD_HEADER_SIZE + content_size) / 2 > NumericLimits<int32_t>::Maximum()) {
+				throw IOException("SHP files can not be larger than 4GB");
+			}
+			StoreBigEndian(static_cast<int32_t>(record_count + i + 1), record_ptr);
+			StoreBigEndian(static_cast<int32_t>(offset / 2), shx_buffer.data() + i * SHP_RECORD_HEADER_SIZE);
+			StoreBigEndian(static_cast<int32_t>(content_size / 2), shx_buffer.data() + i * SHP_RECORD_HEADER_SIZE + 4);
+		}
+		shp_handle->Write(buffer.shp_data.data(), buffer.shp_data.size());
+		shx_handle->Write(shx_buffer.data(), shx_buffer.size());
+		dbf_handle->Write(buffer.dbf_data.data(), buffer.dbf_data.size());
+		shp_size += buffer.shp_data.size();
+		record_count += count;
+	}
+};
+
+struct ShapefileWriteLocalState : public LocalFunctionData {
+	ShapeRecordEncoder encoder;
+	ShapefileWriteBuffer buffer;
+};
+
+static unique_ptr<FileHandle> OpenOutputFile(FileSystem &fs, const string &path) {
+	return fs.OpenFile(path, FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE_NEW,
+	                   FileLockType::WRITE_LOCK);
+}
+
+// The SHP and SHX headers only differ in the file length
+static void WriteSHPHeader(FileHandle &handle, idx_t file_size, int32_t shape_type, const BoundingBox &extent,
+                           bool has_extent) {
+	data_t header[SHP_HEADER_SIZE];
+	memset(header, 0, sizeof(header));
+	StoreBigEndian(9994, header);
+	StoreBigEndian(static_cast<int32_t>(file_size / 2), header + 24);
+	Store<int32_t>(1000, header + 28);
+	Store<int32_t>(shape_type, header + 32);
+	if (has_extent) {
+		Store<double>(extent.minx, header + 36);
+		Store<double>(extent.miny, header + 44);
+		Store<double>(extent.maxx, header + 52);
+		Store<double>(extent.maxy, header + 60);
+	}
+	handle.Write(header, sizeof(header), 0);
+}
+
+static void WriteDBFHeader(FileHandle &handle, const ShapefileWriteBindData &bind_data, idx_t record_count) {
+	idx_t field_count = 0;
+	for (auto &field : bind_data.fields) {
+		field_count += field.width != 0;
+	}
+	auto header_size = 32 + field_count * 32 + 1;
+	auto header = make_unsafe_uniq_array<data_t>(header_size);
+	memset(header.get(), 0, header_size);
+
+	// dBase III without memo, with the same last update date that shapelib writes
+	header[0] = 0x03;
+	header[1] = 95;
+	header[2] = 7;
+	header[3] = 26;
+	Store<uint32_t>(static_cast<uint32_t>(record_count), header.get() + 4);
+	Store<uint16_t>(static_cast<uint16_t>(header_size), header.get() + 8);
+	Store<uint16_t>(static_cast<uint16_t>(bind_data.record_length), header.get() + 10);
+	// The language driver id of ANSI (Windows-1252), readers use the .cpg file for everything else
+	header[29] = bind_data.encoding == AttributeEncoding::LATIN1 ? 0x57 : 0;
+
+	auto field_ptr = header.get() + 32;
+	for (auto &field : bind_data.fields) {
+		if (field.width == 0) {
+			continue;
+		}
+		memcpy(field_ptr, field.name.c_str(), field.name.size());
+		field_ptr[11] = static_cast<data_t>(field.type);
+		field_ptr[16] = field.width;
+		field_ptr[17] = field.decimals;
+		field_ptr += 32;
+	}
+	*field_ptr = 0x0D;
+	handle.Write(header.get(), header_size, 0);
+}
+
+static unique_ptr<GlobalFunctionData> InitGlobal(ClientContext &context, FunctionData &bind_data,
+                                                 const string &file_path) {
+	auto &shp_data = bind_data.Cast<ShapefileWriteBindData>();
+	auto &fs = FileSystem::GetFileSystem(context);
+	auto result = make_uniq<ShapefileWriteGlobalState>();
+	result->shp_handle = OpenOutputFile(fs, file_path);
+	result->shx_handle = OpenOutputFile(fs, GetSiblingPath(file_path, ".shx"));
+	result->dbf_handle = OpenOutputFile(fs, GetSiblingPath(file_path, ".dbf"));
+
+	// The headers are written again once the number of records and the extent are known
+	WriteSHPHeader(*result->shp_handle, SHP_HEADER_SIZE, SHPT_NULL, result->extent, false);
+	WriteSHPHeader(*result->shx_handle, SHP_HEADER_SIZE, SHPT_NULL, result->extent, false);
+	WriteDBFHeader(*result->dbf_handle, shp_data, 0);
+	return std::move(result);
+}
+
+static unique_ptr<LocalFunctionData> InitLocal(ExecutionContext &context, FunctionData &bind_data) {
+	return make_uniq<ShapefileWriteLocalState>();
+}
+
+//------------------------------------------------------------------------------
+// Sink, Combine and Finalize
+//------------------------------------------------------------------------------
+
+static void Sink(ExecutionContext &context, FunctionData &bind_data, GlobalFunctionData &gstate,
+                 LocalFunctionData &lstate, DataChunk &input) {
+	auto &local_state = lstate.Cast<ShapefileWriteLocalState>();
+	local_state.buffer.Clear();
+	EncodeChunk(context.client, bind_data.Cast<ShapefileWriteBindData>(), input, local_state.encoder,
+	            local_state.buffer);
+	gstate.Cast<ShapefileWriteGlobalState>().WriteBuffer(local_state.buffer);
+}
+
+static void Combine(ExecutionContext &context, FunctionData &bind_data, GlobalFunctionData &gstate,
+                    LocalFunctionData &lstate) {
+}
+
+static void Finalize(ClientContext &context, FunctionData &bind_data, GlobalFunctionData &gstate) {
+	auto &shp_data = bind_data.Cast<ShapefileWriteBindData>();
+	auto &global_state = gstate.Cast<ShapefileWriteGlobalState>();
+
+	auto has_extent = global_state.shape_type != SHPT_NULL;
+	auto shx_size = SHP_HEADER_SIZE + global_state.record_count * SHP_RECORD_HEADER_SIZE;
+	WriteSHPHeader(*global_state.shp_handle, global_state.shp_size, global_state.shape_type, global_state.extent,
+	               has_extent);
+	WriteSHPHeader(*global_state.shx_handle, shx_size, global_state.shape_type, global_state.extent, has_extent);
+	WriteDBFHeader(*global_state.dbf_handle, shp_data, global_state.record_count);
+
+	// The DBF file ends with an end of file marker
+	data_t eof_marker = 0x1A;
+	global_state.dbf_handle->Write(&eof_marker, 1);
+
+	for (auto handle : {&global_state.shp_handle, &global_state.shx_handle, &global_state.dbf_handle}) {
+		(*handle)->Sync();
+		(*handle)->Close();
+		handle->reset();
+	}
+
+	auto &fs = FileSystem::GetFileSystem(context);
+	auto cpg_handle = OpenOutputFile(fs, GetSiblingPath(shp_data.file_path, ".cpg"));
+	string code_page = shp_data.encoding == AttributeEncoding::LATIN1 ? "ISO-8859-1" : "UTF-8";
+	cpg_handle->Write((void *)code_page.data(), code_page.size());
+	cpg_handle->Close();
+
+	if (shp_data.spatial_index) {
+		WriteQIXFile(fs, shp_data.file_path, GetSiblingPath(shp_data.file_path, ".qix"));
+	}
+}
+
+//------------------------------------------------------------------------------
+// Batched (order preserving) copy
+//------------------------------------------------------------------------------
+// Batches are encoded in parallel and then appended in order, so only the record numbers and index entries are
+// computed while the lock is held.
+
+struct ShapefileWriteBatchData : public PreparedBatchData {
+	ShapefileWriteBuffer buffer;
+};
+
+static CopyFunctionExecutionMode ExecutionMode(bool preserve_insertion_order, bool supports_batch_index) {
+	if (!preserve_insertion_order) {
+		return CopyFunctionExecutionMode::PARALLEL_COPY_TO_FILE;
+	}
+	if (supports_batch_index) {
+		return CopyFunctionExecutionMode::BATCH_COPY_TO_FILE;
+	}
+	return CopyFunctionExecutionMode::REGULAR_COPY_TO_FILE;
+}
+
+static unique_ptr<PreparedBatchData> PrepareBatch(ClientContext &context, FunctionData &bind_data,
+                                                  GlobalFunctionData &gstate,
+                                                  unique_ptr<ColumnDataCollection> collection) {
+	auto &shp_data = bind_data.Cast<ShapefileWriteBindData>();
+	auto batch = make_uniq<ShapefileWriteBatchData>();
+	ShapeRecordEncoder encoder;
+	for (auto &chunk : collection->Chunks()) {
+		EncodeChunk(context, shp_data, chunk, encoder, batch->buffer);
+	}
+	return std::move(batch);
+}
+
+static void FlushBatch(ClientContext &context, FunctionData &bind_data, GlobalFunctionData &gstate,
+                       PreparedBatchData &batch) {
+	auto &batch_data = batch.Cast<ShapefileWriteBatchData>();
+	gstate.Cast<ShapefileWriteGlobalState>().WriteBuffer(batch_data.buffer);
+	batch_data.buffer.Clear();
+}
+
+//------------------------------------------------------------------------------
+// Register
+//------------------------------------------------------------------------------
+void CoreCopyFunctions::RegisterShapefileCopyFunction(DatabaseInstance &db) {
+	CopyFunction info("SHP");
+	info.copy_to_bind = Bind;
+	info.copy_to_initialize_local = InitLocal;
+	info.copy_to_initialize_global = InitGlobal;
+	info.copy_to_sink = Sink;
+	info.copy_to_combine = Combine;
+	info.copy_to_finalize = Finalize;
+	info.execution_mode = ExecutionMode;
+	info.prepare_batch = PrepareBatch;
+	info.flush_batch = FlushBatch;
+	info.extension = "shp";
+
+	ExtensionUtil::RegisterFunction(db, info);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,107 @@
+#include "spatial/core/join_index_cache.hpp"
+
+namespace spatial {
+
+namespace core {
+
+shared_ptr<JoinIndexCache> JoinIndexCache::TryGet(ClientContext &context) {
+	return ObjectCache::GetObjectCache(context).Get<JoinIndexCache>(ObjectType());
+}
+
+shared_ptr<JoinIndexCache> JoinIndexCache::GetOrCreate(ClientContext &context) {
+	return ObjectCache::GetObjectCache(context).GetOrCreate<JoinIndexCache>(ObjectType());
+}
+
+idx_t JoinIndexCache::GetCapacity(ClientContext &context) {
+	Value capacity;
+	if (context.TryGetCurrentSetting("spatial_join_cache_size", capacity) && !capacity.IsNull()) {
+		return DBConfig::ParseMemoryLimit(capacity.ToString());
+	}
+	return 0;
+}
+
+idx_t JoinIndexCache::GetVersion(const string &table) const {
+	auto entry = table_versions.find(table);
+	return generation + (entry == table_versions.end() ? 0 : entry->second);
+}
+
+idx_t JoinIndexCache::GetTableVersion(const string &table) {
+	lock_guard<mutex> guard(lock);
+	return GetVersion(table);
+}
+
+void JoinIndexCache::InvalidateTable(const string &table) {
+	lock_guard<mutex> guard(lock);
+	table_versions[table]++;
+	for (auto entry = entries.begin(); entry != entries.end();) {
+		auto current = entry++;
+		if (current->second.table == table) {
+			Erase(current);
+		}
+	}
+}
+
+void JoinIndexCache::InvalidateAll() {
+	lock_guard<mutex> guard(lock);
+	generation++;
+	entries.clear();
+	lru.clear();
+	size = 0;
+}
+
+void JoinIndexCache::Erase(unordered_map<string, Entry>::iterator entry) {
+	size -= entry->second.size;
+	lru.erase(entry->second.lru_position);
+	entries.erase(entry);
+}
+
+shared_ptr<SpatialJoinIndex> JoinIndexCache::Lookup(const string &key, idx_t table_rows) {
+	lock_guard<mutex> guard(lock);
+	auto entry = entries.find(key);
+	if (entry == entries.end()) {
+		return nullptr;
+	}
+	if (GetVersion(entry->second.table) != entry->second.version || entry->second.table_rows != table_rows) {
+		Erase(entry);
+		return nullptr;
+	}
+	lru.splice(lru.begin(), lru, entry->second.lru_position);
+	return entry->second.index;
+}
+
+void JoinIndexCache::Insert(const string &key, shared_ptr<SpatialJoinIndex> index, const string &table,
+                            idx_t version, idx_t table_rows, idx_t index_size, idx_t capacity) {
+	lock_guard<mutex> guard(lock);
+	auto existing = entries.find(key);
+	if (existing != entries.end()) {
+		Erase(existing);
+	}
+	if (GetVersion(table) != version || index_size > capacity) {
+		return;
+	}
+	while (size + index_size > capacity) {
+		Erase(entries.find(lru.back()));
+	}
+	lru.push_front(key);
+	size += index_size;
+	peak_size = MaxValue(peak_size, size);
+	Entry entry;
+	entry.index = std::move(index);
+	entry.table = table;
+	entry.version = version;
+	entry.table_rows = table_rows;
+	entry.size = index_size;
+	entry.lru_position = lru.begin();
+	entries.emplace(key, std::move(entry));
+}
+
+void JoinIndexCache::FetchMemory(idx_t &held_bytes, idx_t &peak_bytes) {
+	lock_guard<mutex> guard(lock);
+	held_bytes = size;
+	peak_bytes = peak_size;
+	peak_size = size;
+}
+
+} // namespace core
+
+} // namespace spatial
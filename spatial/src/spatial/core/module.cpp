@@ -4,9 +4,11 @@
 #include "spatial/common.hpp"
 #include "spatial/core/functions/aggregate.hpp"
 #include "spatial/core/functions/cast.hpp"
+#include "spatial/core/functions/copy.hpp"
 #include "spatial/core/functions/scalar.hpp"
 #include "spatial/core/functions/table.hpp"
 #include "spatial/core/functions/macros.hpp"
+#include "spatial/core/io/async_reader.hpp"
 #include "spatial/core/optimizer_rules.hpp"
 #include "spatial/core/types.hpp"
 
@@ -19,9 +21,30 @@ void CoreModule::Register(DatabaseInstance &db) {
 	CoreScalarFunctions::Register(db);
 	CoreCastFunctions::Register(db);
 	CoreTableFunctions::Register(db);
+	CoreCopyFunctions::Register(db);
 	CoreAggregateFunctions::Register(db);
 	CoreOptimizerRules::Register(db);
     CoreScalarMacros::Register(db);
+
+	auto &config = DBConfig::GetConfig(db);
+	config.AddExtensionOption("spatial_double_precision_bbox",
+	                          "Store the bounding box of new geometries with double instead of single precision",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(false));
+	config.AddExtensionOption("spatial_arena_soft_limit",
+	                          "The size above which the per-thread geometry arena is released after a chunk, instead of "
+	                          "being kept for reuse",
+	                          LogicalType::VARCHAR, Value("64MB"));
+	config.AddExtensionOption("spatial_profiling",
+	                          "Count deserializations, GEOS predicate calls, bounding box rejects and PROJ pipeline "
+	                          "creations of the spatial functions, reported by spatial_profiling_metrics()",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(false));
+	config.AddExtensionOption("spatial_tile_cache_size",
+	                          "The memory the results cached by ST_CachedTile may take, caching is disabled at 0",
+	                          LogicalType::VARCHAR, Value("0"));
+	config.AddExtensionOption("spatial_io_queue_depth",
+	                          "The number of reads ST_ReadOSM and the GDAL readers keep in flight ahead of decoding, "
+	                          "or 0 to read synchronously",
+	                          LogicalType::BIGINT, Value::BIGINT(AsyncReader::DEFAULT_QUEUE_DEPTH));
 }
 
 } // namespace core
@@ -0,0 +1,117 @@
+#include "spatial/core/operators/spatial_cache_invalidation.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/join_index_cache.hpp"
+#include "spatial/core/tile_cache.hpp"
+
+#include "duckdb/execution/physical_plan_generator.hpp"
+#include "duckdb/main/client_context_state.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Spatial Cache Writes
+//------------------------------------------------------------------------------
+static void InvalidateCachedTables(ClientContext &context, const unordered_set<string> &tables) {
+	auto tile_cache = TileCache::TryGet(context);
+	auto join_cache = JoinIndexCache::TryGet(context);
+	for (auto &table : tables) {
+		if (tile_cache) {
+			tile_cache->InvalidateTable(table);
+		}
+		if (join_cache) {
+			join_cache->InvalidateTable(table);
+		}
+	}
+}
+
+// The tables written by the open transaction of a client
+class SpatialCacheWriteState : public ClientContextState {
+public:
+	explicit SpatialCacheWriteState(ClientContext &context) : context(context) {
+	}
+
+	ClientContext &context;
+	unordered_set<string> tables;
+
+	void QueryEnd() override {
+		if (tables.empty() || context.transaction.HasActiveTransaction()) {
+			return;
+		}
+		InvalidateCachedTables(context, tables);
+		tables.clear();
+	}
+
+	static SpatialCacheWriteState &GetOrCreate(ClientContext &context) {
+		if (!context.registered_state["spatial_cache_writes"]) {
+			context.registered_state["spatial_cache_writes"] = make_uniq<SpatialCacheWriteState>(context);
+		}
+		return *dynamic_cast<SpatialCacheWriteState *>(context.registered_state["spatial_cache_writes"].get());
+	}
+};
+
+void SpatialCacheWrites::Invalidate(ClientContext &context, const unordered_set<string> &tables) {
+	InvalidateCachedTables(context, tables);
+	// Remembered even if nothing is cached yet, a query may cache what it read before the write is committed
+	auto &state = SpatialCacheWriteState::GetOrCreate(context);
+	state.tables.insert(tables.begin(), tables.end());
+}
+
+bool SpatialCacheWrites::IsWritten(ClientContext &context, const string &table) {
+	auto entry = context.registered_state.find("spatial_cache_writes");
+	if (entry == context.registered_state.end() || !entry->second) {
+		return false;
+	}
+	auto &state = dynamic_cast<SpatialCacheWriteState &>(*entry->second);
+	return state.tables.count(table) > 0;
+}
+
+//------------------------------------------------------------------------------
+// Logical Operator
+//------------------------------------------------------------------------------
+LogicalSpatialCacheInvalidation::LogicalSpatialCacheInvalidation(string table_p)
+    : LogicalExtensionOperator(), table(std::move(table_p)) {
+}
+
+vector<ColumnBinding> LogicalSpatialCacheInvalidation::GetColumnBindings() {
+	return children[0]->GetColumnBindings();
+}
+
+void LogicalSpatialCacheInvalidation::ResolveTypes() {
+	types = children[0]->types;
+}
+
+unique_ptr<PhysicalOperator> LogicalSpatialCacheInvalidation::CreatePlan(ClientContext &context,
+                                                                         PhysicalPlanGenerator &generator) {
+	D_ASSERT(children.size() == 1);
+	auto child = generator.CreatePlan(std::move(children[0]));
+	return make_uniq<PhysicalSpatialCacheInvalidation>(*this, std::move(child));
+}
+
+//------------------------------------------------------------------------------
+// Physical Operator
+//------------------------------------------------------------------------------
+PhysicalSpatialCacheInvalidation::PhysicalSpatialCacheInvalidation(const LogicalSpatialCacheInvalidation &op,
+                                                                   unique_ptr<PhysicalOperator> child)
+    : PhysicalOperator(PhysicalOperatorType::EXTENSION, op.types, op.estimated_cardinality), table(op.table) {
+	children.push_back(std::move(child));
+}
+
+unique_ptr<OperatorState> PhysicalSpatialCacheInvalidation::GetOperatorState(ExecutionContext &context) const {
+	// Created once for every run of the plan, after the write below it ran
+	SpatialCacheWrites::Invalidate(context.client, {table});
+	return make_uniq<OperatorState>();
+}
+
+OperatorResultType PhysicalSpatialCacheInvalidation::Execute(ExecutionContext &context, DataChunk &input,
+                                                             DataChunk &chunk, GlobalOperatorState &gstate,
+                                                             OperatorState &state) const {
+	chunk.Reference(input);
+	return OperatorResultType::NEED_MORE_INPUT;
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,1329 @@
+#include "spatial/core/operators/spatial_join.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/point_distance.hpp"
+#include "spatial/core/index/flat_rtree.hpp"
+#include "spatial/core/join_index_cache.hpp"
+#include "spatial/core/profiling.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
+#include "duckdb/common/types/string_heap.hpp"
+#include "duckdb/common/vector_operations/vector_operations.hpp"
+#include "duckdb/execution/column_binding_resolver.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/execution/physical_plan_generator.hpp"
+#include "duckdb/parallel/base_pipeline_event.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
+#include "duckdb/planner/operator/logical_get.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+#include "duckdb/storage/data_table.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Logical Operator
+//------------------------------------------------------------------------------
+LogicalSpatialJoin::LogicalSpatialJoin(JoinType join_type) : LogicalExtensionOperator(), join_type(join_type) {
+}
+
+// SEMI and ANTI joins only return the columns of the left side
+static bool ReturnsRightSide(JoinType join_type) {
+	return join_type != JoinType::SEMI && join_type != JoinType::ANTI;
+}
+
+vector<ColumnBinding> LogicalSpatialJoin::GetColumnBindings() {
+	auto left_bindings = children[0]->GetColumnBindings();
+	if (!ReturnsRightSide(join_type)) {
+		return left_bindings;
+	}
+	auto right_bindings = children[1]->GetColumnBindings();
+	left_bindings.insert(left_bindings.end(), right_bindings.begin(), right_bindings.end());
+	if (distance_index != DConstants::INVALID_INDEX) {
+		left_bindings.emplace_back(distance_index, 0);
+	}
+	return left_bindings;
+}
+
+vector<idx_t> LogicalSpatialJoin::GetTableIndex() const {
+	if (distance_index == DConstants::INVALID_INDEX) {
+		return vector<idx_t>();
+	}
+	return vector<idx_t> {distance_index};
+}
+
+void LogicalSpatialJoin::ResolveTypes() {
+	types = children[0]->types;
+	if (ReturnsRightSide(join_type)) {
+		types.insert(types.end(), children[1]->types.begin(), children[1]->types.end());
+	}
+	if (distance_index != DConstants::INVALID_INDEX) {
+		types.push_back(LogicalType::DOUBLE);
+	}
+}
+
+// The index of the exact condition, which follows the key expressions
+static idx_t ConditionIndex(const LogicalSpatialJoin &join) {
+	return join.has_time_band ? 4 : 2;
+}
+
+void LogicalSpatialJoin::ResolveColumnBindings(ColumnBindingResolver &res, vector<ColumnBinding> &bindings) {
+	D_ASSERT(children.size() == 2);
+	auto condition_idx = ConditionIndex(*this);
+	D_ASSERT(expressions.size() == condition_idx || expressions.size() == condition_idx + 1);
+
+	// The key expressions are evaluated separately on each side of the join,
+	// so resolve them against the bindings of their own side only.
+	res.VisitOperator(*children[0]);
+	res.VisitExpression(&expressions[0]);
+	if (has_time_band) {
+		res.VisitExpression(&expressions[2]);
+	}
+
+	res.VisitOperator(*children[1]);
+	res.VisitExpression(&expressions[1]);
+	if (has_time_band) {
+		res.VisitExpression(&expressions[3]);
+	}
+
+	if (expressions.size() > condition_idx) {
+		// The condition is evaluated on pairs of rows, so resolve it against the bindings of both sides
+		bindings = children[0]->GetColumnBindings();
+		auto right_bindings = children[1]->GetColumnBindings();
+		bindings.insert(bindings.end(), right_bindings.begin(), right_bindings.end());
+		res.VisitExpression(&expressions[condition_idx]);
+	}
+
+	bindings = GetColumnBindings();
+}
+
+// The key of the build side in the join index cache, or an empty string if it can not be cached. The build side has
+// to be a plain scan of a table, possibly below projections.
+static string GetCacheKey(ClientContext &context, LogicalSpatialJoin &join, optional_ptr<TableCatalogEntry> &table) {
+	// The rows of the index hold the columns of the build side, and its shape depends on the key expressions and on
+	// the parameters that decide how it is partitioned
+	string projections;
+	reference<LogicalOperator> right = *join.children[1];
+	while (right.get().type == LogicalOperatorType::LOGICAL_PROJECTION) {
+		for (auto &expr : right.get().expressions) {
+			if (expr->IsVolatile()) {
+				return string();
+			}
+			projections += expr->ToString() + ",";
+		}
+		projections += ") (";
+		right = *right.get().children[0];
+	}
+	if (right.get().type != LogicalOperatorType::LOGICAL_GET) {
+		return string();
+	}
+	auto &get = right.get().Cast<LogicalGet>();
+	table = get.GetTable();
+	if (!table || !get.table_filters.filters.empty()) {
+		return string();
+	}
+
+	auto key = table->catalog.GetName() + "." + table->schema.name + "." + table->name + " (" + projections;
+	for (auto &column_id : get.column_ids) {
+		key += std::to_string(column_id) + ",";
+	}
+	key += ") (";
+	for (auto &projection_id : get.projection_ids) {
+		key += std::to_string(projection_id) + ",";
+	}
+	key += ") " + join.expressions[1]->ToString();
+	if (join.has_time_band) {
+		key += " " + join.expressions[3]->ToString();
+	}
+	key += " k=" + std::to_string(join.k) + " partition=" + std::to_string(join.partition_threshold);
+	return key;
+}
+
+// The rows in the storage of a table, deleted ones included. It changes with every committed append, also those of
+// appenders, which do not run a statement and so do not bump the version of the table.
+static idx_t GetTableRows(TableCatalogEntry &table) {
+	return table.IsDuckTable() ? table.GetStorage().GetTotalRows() : 0;
+}
+
+unique_ptr<PhysicalOperator> LogicalSpatialJoin::CreatePlan(ClientContext &context, PhysicalPlanGenerator &generator) {
+	D_ASSERT(children.size() == 2);
+	auto condition_idx = ConditionIndex(*this);
+	D_ASSERT(expressions.size() == condition_idx || expressions.size() == condition_idx + 1);
+
+	optional_ptr<TableCatalogEntry> cache_table;
+	string cache_key;
+	if (JoinIndexCache::GetCapacity(context) > 0) {
+		cache_key = GetCacheKey(context, *this, cache_table);
+	}
+
+	auto left = generator.CreatePlan(std::move(children[0]));
+	auto right = generator.CreatePlan(std::move(children[1]));
+
+	auto result = make_uniq<PhysicalSpatialJoin>(*this, std::move(left), std::move(right), std::move(expressions[0]),
+	                                             std::move(expressions[1]), join_type, distance, k,
+	                                             partition_threshold, estimated_cardinality);
+	result->emit_distance = distance_index != DConstants::INVALID_INDEX;
+	if (!cache_key.empty()) {
+		result->cache_key = std::move(cache_key);
+		result->cache_table = StringUtil::Lower(cache_table->name);
+		result->cache_catalog = cache_table->catalog.GetName();
+		result->cache_schema = cache_table->schema.name;
+		result->cache_table_name = cache_table->name;
+		if (context.transaction.IsAutoCommit()) {
+			auto cached = JoinIndexCache::GetOrCreate(context)->Lookup(result->cache_key, GetTableRows(*cache_table));
+			result->cached_when_planned = cached != nullptr;
+		}
+	}
+	if (has_time_band) {
+		result->left_time_key = std::move(expressions[2]);
+		result->right_time_key = std::move(expressions[3]);
+		result->time_lower = time_lower;
+		result->time_upper = time_upper;
+	}
+	result->extent_filter = std::move(extent_filter);
+	if (expressions.size() > condition_idx) {
+		result->condition = std::move(expressions[condition_idx]);
+	}
+	return std::move(result);
+}
+
+//------------------------------------------------------------------------------
+// Physical Operator
+//------------------------------------------------------------------------------
+PhysicalSpatialJoin::PhysicalSpatialJoin(LogicalOperator &op, unique_ptr<PhysicalOperator> left,
+                                         unique_ptr<PhysicalOperator> right, unique_ptr<Expression> left_key_p,
+                                         unique_ptr<Expression> right_key_p, JoinType join_type, double distance,
+                                         idx_t k, idx_t partition_threshold, idx_t estimated_cardinality)
+    : PhysicalJoin(op, PhysicalOperatorType::EXTENSION, join_type, estimated_cardinality),
+      left_key(std::move(left_key_p)), right_key(std::move(right_key_p)), distance(distance), k(k),
+      partition_threshold(partition_threshold) {
+	children.push_back(std::move(left));
+	children.push_back(std::move(right));
+}
+
+string PhysicalSpatialJoin::ParamsToString() const {
+	auto result = left_key->ToString() + " && " + right_key->ToString();
+	if (condition) {
+		result += "\n" + condition->ToString();
+	}
+	if (distance != 0) {
+		result += "\nDistance: " + std::to_string(distance);
+	}
+	if (k != 0) {
+		result += "\nNearest: " + std::to_string(k);
+	}
+	if (left_time_key) {
+		result += "\n" + left_time_key->ToString() + " - " + right_time_key->ToString() + " in [" +
+		          std::to_string(time_lower) + ", " + std::to_string(time_upper) + "]";
+	}
+	if (cached_when_planned) {
+		result += "\nCached Build Side";
+	}
+	return result;
+}
+
+//------------------------------------------------------------------------------
+// Sink
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// Tile Grid
+//------------------------------------------------------------------------------
+// A uniform grid over the bounds of the build side, used to partition the build side into tiles.
+// Coordinates outside of the bounds are clamped to the border tiles.
+struct SpatialJoinTileGrid {
+	// The target number of build side entries per tile
+	static constexpr const idx_t TARGET_TILE_SIZE = 1 << 16;
+
+	RTreeBox bounds;
+	idx_t cols = 1;
+	idx_t rows = 1;
+	double cell_width = 0;
+	double cell_height = 0;
+
+	// Use at least min_tile_count tiles, so that all threads have a tile to build
+	void Initialize(const RTreeBox &bounds_p, idx_t entry_count, idx_t min_tile_count) {
+		auto tile_count = MaxValue<idx_t>((entry_count + TARGET_TILE_SIZE - 1) / TARGET_TILE_SIZE, min_tile_count);
+		InitializeCells(bounds_p, tile_count);
+	}
+
+	// Split the bounds into a square number of at least tile_count cells
+	void InitializeCells(const RTreeBox &bounds_p, idx_t tile_count) {
+		bounds = bounds_p;
+		tile_count = MaxValue<idx_t>(tile_count, 1);
+		auto side = static_cast<idx_t>(std::ceil(std::sqrt(static_cast<double>(tile_count))));
+		cols = side;
+		rows = side;
+		cell_width = (static_cast<double>(bounds.maxx) - static_cast<double>(bounds.minx)) / static_cast<double>(cols);
+		cell_height = (static_cast<double>(bounds.maxy) - static_cast<double>(bounds.miny)) / static_cast<double>(rows);
+	}
+
+	idx_t TileCount() const {
+		return cols * rows;
+	}
+
+	idx_t Col(float x) const {
+		return Clamp(static_cast<double>(x) - static_cast<double>(bounds.minx), cell_width, cols);
+	}
+
+	idx_t Row(float y) const {
+		return Clamp(static_cast<double>(y) - static_cast<double>(bounds.miny), cell_height, rows);
+	}
+
+private:
+	static idx_t Clamp(double offset, double cell_size, idx_t count) {
+		if (offset <= 0 || cell_size <= 0) {
+			return 0;
+		}
+		auto cell = offset / cell_size;
+		if (cell >= static_cast<double>(count - 1)) {
+			return count - 1;
+		}
+		return static_cast<idx_t>(cell);
+	}
+};
+
+//------------------------------------------------------------------------------
+// Occupancy Grid
+//------------------------------------------------------------------------------
+// A bitmap over a fine grid of the build side bounds, with a bit set for every cell that a build side box overlaps.
+// A probe box that only covers empty cells can not match anything, so e.g. the points of a point-in-polygon join
+// that fall outside of all polygons are dropped with a single bit test instead of an R-tree search.
+struct SpatialJoinOccupancyGrid {
+	// The number of cells per build side entry, within the bounds below
+	static constexpr const idx_t CELLS_PER_ENTRY = 16;
+	static constexpr const idx_t MIN_CELL_COUNT = 1 << 12;
+	static constexpr const idx_t MAX_CELL_COUNT = 1 << 20;
+	// Probe boxes that span more cells than this are left to the R-tree
+	static constexpr const idx_t MAX_PROBE_CELLS = 16;
+
+	SpatialJoinTileGrid grid;
+	vector<uint64_t> bits;
+
+	bool IsBuilt() const {
+		return !bits.empty();
+	}
+
+	void Build(const vector<std::pair<RTreeBox, idx_t>> &entries, const RTreeBox &bounds) {
+		auto cell_count = MaxValue<idx_t>(entries.size() * CELLS_PER_ENTRY, MIN_CELL_COUNT);
+		cell_count = MinValue<idx_t>(cell_count, MAX_CELL_COUNT);
+		grid.InitializeCells(bounds, cell_count);
+
+		// Add every box to a 2D difference array, whose prefix sums are the number of boxes overlapping each cell.
+		// This takes a pass over the entries and one over the cells, however many cells the boxes cover.
+		auto stride = grid.cols + 1;
+		vector<int64_t> counts(stride * (grid.rows + 1), 0);
+		for (auto &entry : entries) {
+			auto &box = entry.first;
+			auto col_begin = grid.Col(box.minx);
+			auto col_end = grid.Col(box.maxx) + 1;
+			auto row_begin = grid.Row(box.miny);
+			auto row_end = grid.Row(box.maxy) + 1;
+			counts[row_begin * stride + col_begin]++;
+			counts[row_begin * stride + col_end]--;
+			counts[row_end * stride + col_begin]--;
+			counts[row_end * stride + col_end]++;
+		}
+
+		bits.assign((grid.TileCount() + 63) / 64, 0);
+		for (idx_t row = 0; row < grid.rows; row++) {
+			for (idx_t col = 0; col < grid.cols; col++) {
+				auto idx = row * stride + col;
+				if (col > 0) {
+					counts[idx] += counts[idx - 1];
+				}
+				if (row > 0) {
+					counts[idx] += counts[idx - stride];
+				}
+				if (row > 0 && col > 0) {
+					counts[idx] -= counts[idx - stride - 1];
+				}
+				if (counts[idx] > 0) {
+					auto cell = row * grid.cols + col;
+					bits[cell / 64] |= uint64_t(1) << (cell % 64);
+				}
+			}
+		}
+	}
+
+	// Whether a probe box may intersect a build side box, false if it only covers empty cells
+	bool MayMatch(const RTreeBox &probe) const {
+		if (!IsBuilt()) {
+			return true;
+		}
+		if (!grid.bounds.Intersects(probe)) {
+			return false;
+		}
+		auto col_begin = grid.Col(probe.minx);
+		auto col_end = grid.Col(probe.maxx);
+		auto row_begin = grid.Row(probe.miny);
+		auto row_end = grid.Row(probe.maxy);
+		if ((col_end - col_begin + 1) * (row_end - row_begin + 1) > MAX_PROBE_CELLS) {
+			return true;
+		}
+		for (auto row = row_begin; row <= row_end; row++) {
+			for (auto col = col_begin; col <= col_end; col++) {
+				auto cell = row * grid.cols + col;
+				if (bits[cell / 64] & (uint64_t(1) << (cell % 64))) {
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+};
+
+// The double precision bounding box of a geometry, used to compute exact (bounding box) distances for KNN joins
+struct SpatialJoinExactBox {
+	double minx;
+	double miny;
+	double maxx;
+	double maxy;
+
+	explicit SpatialJoinExactBox(const BoundingBox &bbox)
+	    : minx(bbox.minx), miny(bbox.miny), maxx(bbox.maxx), maxy(bbox.maxy) {
+	}
+
+	double Distance(const SpatialJoinExactBox &other) const {
+		auto dx = std::max({0.0, minx - other.maxx, other.minx - maxx});
+		auto dy = std::max({0.0, miny - other.maxy, other.miny - maxy});
+		return std::sqrt(dx * dx + dy * dy);
+	}
+};
+
+// The relative margin by which the time window of a probe is widened
+static constexpr const double TIME_SLACK = 1e-12;
+
+// The time keys of a chunk, as microseconds for TIMESTAMPs. NULL and NaN keys never match.
+struct SpatialJoinTimeKeys {
+	UnifiedVectorFormat format;
+	bool is_timestamp = false;
+
+	void Load(Vector &keys, idx_t count) {
+		keys.ToUnifiedFormat(count, format);
+		is_timestamp = keys.GetType().id() != LogicalTypeId::DOUBLE;
+	}
+
+	bool TryGet(idx_t row, double &result) const {
+		auto idx = format.sel->get_index(row);
+		if (!format.validity.RowIsValid(idx)) {
+			return false;
+		}
+		if (is_timestamp) {
+			result = static_cast<double>(UnifiedVectorFormat::GetData<timestamp_t>(format)[idx].value);
+			return true;
+		}
+		result = UnifiedVectorFormat::GetData<double>(format)[idx];
+		return !std::isnan(result);
+	}
+};
+
+//------------------------------------------------------------------------------
+// Index
+//------------------------------------------------------------------------------
+// The build side is stored as a list of chunks, only rows with a non-empty geometry are kept since the rest can
+// never match. Every row is identified by (chunk index * STANDARD_VECTOR_SIZE + row index in chunk). The index is
+// read-only once it is built, so an index from the join index cache is shared by the joins of many queries.
+class SpatialJoinIndex {
+public:
+	vector<unique_ptr<DataChunk>> build_chunks;
+	vector<std::pair<RTreeBox, idx_t>> entries;
+	idx_t entry_count = 0;
+	// The bounds of all entries, except for KNN joins
+	RTreeBox bounds;
+
+	// KNN: the exact bounding boxes of the entries, the R-tree then stores the entry index instead of the row id
+	vector<SpatialJoinExactBox> exact_boxes;
+	vector<idx_t> knn_rows;
+	// KNN: the build side geometries, one chunk per chunk of build_chunks, to compute the exact distances
+	vector<unique_ptr<DataChunk>> knn_keys;
+
+	// Not partitioned: a single R-tree over the whole build side
+	FlatRTree rtree;
+
+	// All joins but KNN: the cells of the build side bounds that a build side box overlaps, to drop probe rows early
+	SpatialJoinOccupancyGrid occupancy;
+
+	// Partitioned: one R-tree per tile of the grid
+	bool partitioned = false;
+	SpatialJoinTileGrid grid;
+	vector<FlatRTree> tiles;
+
+	// Time band: the entries sorted by their time key and split into buckets of TIME_BUCKET_SIZE, with one R-tree per
+	// bucket in tiles. The R-trees store the position of the entry in the sorted order.
+	static constexpr const idx_t TIME_BUCKET_SIZE = 1 << 12;
+	bool time_partitioned = false;
+	vector<double> entry_times;
+	vector<double> sorted_times;
+	vector<idx_t> sorted_rows;
+	vector<double> bucket_min;
+	vector<double> bucket_max;
+
+	bool IsEmpty() const {
+		return entry_count == 0;
+	}
+
+	// The build side geometry of a KNN entry
+	geometry_t GetKnnKey(idx_t entry_idx) const {
+		auto row_id = knn_rows[entry_idx];
+		auto &keys = knn_keys[row_id / STANDARD_VECTOR_SIZE]->data[0];
+		return FlatVector::GetData<geometry_t>(keys)[row_id % STANDARD_VECTOR_SIZE];
+	}
+
+	// An estimate of the memory held by the index, for the join index cache
+	idx_t SizeInBytes() const;
+
+	// Call the callback with the row id of every build side entry whose box intersects the probe box and whose time
+	// is within [min_time, max_time]
+	template <class CALLBACK>
+	void ProbeTimeBand(const RTreeBox &probe, double min_time, double max_time, vector<idx_t> &stack,
+	                   CALLBACK &&callback) const {
+		// The buckets are in time order, so the ones that overlap the window follow each other
+		auto bucket = static_cast<idx_t>(std::lower_bound(bucket_max.begin(), bucket_max.end(), min_time) -
+		                                 bucket_max.begin());
+		for (; bucket < tiles.size() && bucket_min[bucket] <= max_time; bucket++) {
+			tiles[bucket].Search(probe, stack, [&](idx_t position, const RTreeBox &) {
+				auto time = sorted_times[position];
+				if (time >= min_time && time <= max_time) {
+					callback(sorted_rows[position]);
+				}
+			});
+		}
+	}
+
+	// Call the callback with the row id of every build side entry whose box intersects the probe box
+	template <class CALLBACK>
+	void Probe(const RTreeBox &probe, vector<idx_t> &stack, CALLBACK &&callback) const {
+		if (!partitioned) {
+			rtree.Search(probe, stack, [&](idx_t row_id, const RTreeBox &) { callback(row_id); });
+			return;
+		}
+		if (!grid.bounds.Intersects(probe)) {
+			return;
+		}
+		auto col_begin = grid.Col(probe.minx);
+		auto col_end = grid.Col(probe.maxx);
+		auto row_begin = grid.Row(probe.miny);
+		auto row_end = grid.Row(probe.maxy);
+		for (auto row = row_begin; row <= row_end; row++) {
+			for (auto col = col_begin; col <= col_end; col++) {
+				tiles[row * grid.cols + col].Search(probe, stack, [&](idx_t row_id, const RTreeBox &build) {
+					// Reference point deduplication: both boxes overlap the tile containing the lower left corner
+					// of their intersection, so only report the pair from that tile.
+					auto ref_x = std::max(probe.minx, build.minx);
+					auto ref_y = std::max(probe.miny, build.miny);
+					if (grid.Col(ref_x) == col && grid.Row(ref_y) == row) {
+						callback(row_id);
+					}
+				});
+			}
+		}
+	}
+};
+
+static idx_t ChunkSizeInBytes(const DataChunk &chunk) {
+	idx_t size = 0;
+	for (auto &vec : chunk.data) {
+		size += GetTypeIdSize(vec.GetType().InternalType()) * chunk.size();
+		if (vec.GetType().InternalType() != PhysicalType::VARCHAR) {
+			continue;
+		}
+		// The geometries themselves, the chunks are flat copies
+		auto strings = FlatVector::GetData<string_t>(vec);
+		for (idx_t i = 0; i < chunk.size(); i++) {
+			if (FlatVector::IsNull(vec, i) || strings[i].IsInlined()) {
+				continue;
+			}
+			size += strings[i].GetSize();
+		}
+	}
+	return size;
+}
+
+idx_t SpatialJoinIndex::SizeInBytes() const {
+	idx_t size = 0;
+	for (auto &chunk : build_chunks) {
+		size += ChunkSizeInBytes(*chunk);
+	}
+	for (auto &chunk : knn_keys) {
+		size += ChunkSizeInBytes(*chunk);
+	}
+	size += rtree.SizeInBytes();
+	for (auto &tile : tiles) {
+		size += tile.SizeInBytes();
+	}
+	size += occupancy.bits.capacity() * sizeof(uint64_t);
+	size += exact_boxes.capacity() * sizeof(SpatialJoinExactBox);
+	size += (knn_rows.capacity() + sorted_rows.capacity()) * sizeof(idx_t);
+	size += (sorted_times.capacity() + bucket_min.capacity() + bucket_max.capacity()) * sizeof(double);
+	return size;
+}
+
+//------------------------------------------------------------------------------
+// Sink
+//------------------------------------------------------------------------------
+class SpatialJoinGlobalState : public GlobalSinkState {
+public:
+	explicit SpatialJoinGlobalState(ClientContext &context) : index(make_shared<SpatialJoinIndex>()) {
+		counters.Init(context);
+	}
+	~SpatialJoinGlobalState() override {
+		counters.Flush();
+	}
+
+	mutex lock;
+	// Counts the R-tree build time of Finalize, the tile build tasks count into their own
+	SpatialCounters counters;
+	shared_ptr<SpatialJoinIndex> index;
+	// Set if the build side is looked up in and added to the join index cache, with the version and the rows its
+	// table had when the build started
+	bool use_cache = false;
+	idx_t cache_table_version = 0;
+	idx_t cache_table_rows = 0;
+	// Set if the index comes from the join index cache, it is then already built and nothing is sunk
+	bool is_cached = false;
+};
+
+// Hand the extent of the build side, expanded by the distance, to the scan of the probe side
+static void SetExtentFilter(const PhysicalSpatialJoin &op, const RTreeBox &bounds) {
+	if (!op.extent_filter) {
+		return;
+	}
+	BoundingBox extent;
+	extent.minx = static_cast<double>(bounds.minx) - op.distance;
+	extent.miny = static_cast<double>(bounds.miny) - op.distance;
+	extent.maxx = static_cast<double>(bounds.maxx) + op.distance;
+	extent.maxy = static_cast<double>(bounds.maxy) + op.distance;
+	op.extent_filter->SetExtent(extent);
+}
+
+// Add the index to the join index cache once it is built, if the build side can be cached
+static void CacheIndex(ClientContext &context, const PhysicalSpatialJoin &op, const SpatialJoinGlobalState &gstate) {
+	if (!gstate.use_cache || gstate.is_cached) {
+		return;
+	}
+	auto capacity = JoinIndexCache::GetCapacity(context);
+	if (capacity == 0) {
+		return;
+	}
+	JoinIndexCache::GetOrCreate(context)->Insert(op.cache_key, gstate.index, op.cache_table,
+	                                             gstate.cache_table_version, gstate.cache_table_rows,
+	                                             gstate.index->SizeInBytes(), capacity);
+}
+
+class SpatialJoinLocalState : public LocalSinkState {
+public:
+	SpatialJoinLocalState(ClientContext &context, const PhysicalSpatialJoin &op)
+	    : executor(context, *op.right_key), keep_sel(STANDARD_VECTOR_SIZE) {
+		build_keys.Initialize(Allocator::Get(context), {op.right_key->return_type});
+		if (op.right_time_key) {
+			time_executor = make_uniq<ExpressionExecutor>(context, *op.right_time_key);
+			build_times.Initialize(Allocator::Get(context), {op.right_time_key->return_type});
+		}
+	}
+
+	ExpressionExecutor executor;
+	DataChunk build_keys;
+	SelectionVector keep_sel;
+	unique_ptr<ExpressionExecutor> time_executor;
+	DataChunk build_times;
+
+	vector<unique_ptr<DataChunk>> build_chunks;
+	vector<std::pair<RTreeBox, idx_t>> entries;
+	vector<SpatialJoinExactBox> exact_boxes;
+	vector<unique_ptr<DataChunk>> knn_keys;
+	vector<double> entry_times;
+};
+
+unique_ptr<GlobalSinkState> PhysicalSpatialJoin::GetGlobalSinkState(ClientContext &context) const {
+	if (extent_filter) {
+		extent_filter->Clear();
+	}
+	auto gstate = make_uniq<SpatialJoinGlobalState>(context);
+	// The cache is looked up when the join runs rather than when it is planned, as a prepared join may run after its
+	// table changed. Inside of a transaction the build side may see uncommitted writes, so it is not cached at all.
+	if (cache_key.empty() || !context.transaction.IsAutoCommit() || JoinIndexCache::GetCapacity(context) == 0) {
+		return std::move(gstate);
+	}
+	auto table = Catalog::GetEntry<TableCatalogEntry>(context, cache_catalog, cache_schema, cache_table_name,
+	                                                  OnEntryNotFound::RETURN_NULL);
+	if (!table) {
+		return std::move(gstate);
+	}
+	auto cache = JoinIndexCache::GetOrCreate(context);
+	gstate->use_cache = true;
+	gstate->cache_table_version = cache->GetTableVersion(cache_table);
+	gstate->cache_table_rows = GetTableRows(*table);
+	auto cached_index = cache->Lookup(cache_key, gstate->cache_table_rows);
+	if (cached_index) {
+		gstate->index = std::move(cached_index);
+		gstate->is_cached = true;
+	}
+	return std::move(gstate);
+}
+
+unique_ptr<LocalSinkState> PhysicalSpatialJoin::GetLocalSinkState(ExecutionContext &context) const {
+	return make_uniq<SpatialJoinLocalState>(context.client, *this);
+}
+
+// Holds the strings of a build side chunk, the result chunks that reference them keep it alive
+class SpatialJoinStringBuffer : public VectorBuffer {
+public:
+	explicit SpatialJoinStringBuffer(Allocator &allocator)
+	    : VectorBuffer(VectorBufferType::OPAQUE_BUFFER), heap(allocator) {
+	}
+
+	StringHeap heap;
+};
+
+// Copy the selected rows of a chunk into a build side chunk. The rows and the strings of the top level string columns,
+// which hold the geometries, are allocated through the buffer allocator, so that they count towards the memory limit
+// also while the join index cache keeps the build side after the query.
+static unique_ptr<DataChunk> CopyBuildChunk(Allocator &allocator, DataChunk &source, const SelectionVector &sel,
+                                            idx_t count) {
+	auto result = make_uniq<DataChunk>();
+	result->Initialize(allocator, source.GetTypes());
+	buffer_ptr<SpatialJoinStringBuffer> strings;
+	for (idx_t col_idx = 0; col_idx < source.ColumnCount(); col_idx++) {
+		auto &target = result->data[col_idx];
+		if (target.GetType().InternalType() != PhysicalType::VARCHAR) {
+			VectorOperations::Copy(source.data[col_idx], target, sel, count, 0, 0);
+			continue;
+		}
+		if (!strings) {
+			strings = make_buffer<SpatialJoinStringBuffer>(allocator);
+		}
+		UnifiedVectorFormat format;
+		source.data[col_idx].ToUnifiedFormat(source.size(), format);
+		auto source_data = UnifiedVectorFormat::GetData<string_t>(format);
+		auto target_data = FlatVector::GetData<string_t>(target);
+		auto &target_validity = FlatVector::Validity(target);
+		for (idx_t i = 0; i < count; i++) {
+			auto idx = format.sel->get_index(sel.get_index(i));
+			if (!format.validity.RowIsValid(idx)) {
+				target_validity.SetInvalid(i);
+				continue;
+			}
+			auto &value = source_data[idx];
+			target_data[i] = value.IsInlined() ? value : strings->heap.AddBlob(value);
+		}
+		StringVector::AddBuffer(target, strings);
+	}
+	result->SetCardinality(count);
+	return result;
+}
+
+SinkResultType PhysicalSpatialJoin::Sink(ExecutionContext &context, DataChunk &chunk, OperatorSinkInput &input) const {
+	if (input.global_state.Cast<SpatialJoinGlobalState>().is_cached) {
+		// The build side is not needed, stop scanning it
+		return SinkResultType::FINISHED;
+	}
+	auto &lstate = input.local_state.Cast<SpatialJoinLocalState>();
+
+	lstate.build_keys.Reset();
+	lstate.executor.Execute(chunk, lstate.build_keys);
+
+	UnifiedVectorFormat format;
+	lstate.build_keys.data[0].ToUnifiedFormat(chunk.size(), format);
+	auto keys = reinterpret_cast<const geometry_t *>(format.data);
+
+	SpatialJoinTimeKeys time_keys;
+	if (lstate.time_executor) {
+		lstate.build_times.Reset();
+		lstate.time_executor->Execute(chunk, lstate.build_times);
+		time_keys.Load(lstate.build_times.data[0], chunk.size());
+	}
+
+	auto row_offset = lstate.build_chunks.size() * STANDARD_VECTOR_SIZE;
+	idx_t keep_count = 0;
+	BoundingBox bbox;
+	double time = 0;
+
+	for (idx_t i = 0; i < chunk.size(); i++) {
+		auto idx = format.sel->get_index(i);
+		if (!format.validity.RowIsValid(idx)) {
+			continue;
+		}
+		if (!GeometryFactory::TryGetSerializedBoundingBox(keys[idx], bbox)) {
+			// Empty geometry
+			continue;
+		}
+		if (lstate.time_executor) {
+			if (!time_keys.TryGet(i, time)) {
+				continue;
+			}
+			lstate.entry_times.push_back(time);
+		}
+		if (k != 0) {
+			if (keys[idx].GetType() == GeometryType::GEOMETRYCOLLECTION) {
+				throw InvalidInputException("ST_KNN: the right side geometries can not be geometry collections");
+			}
+			lstate.exact_boxes.emplace_back(bbox);
+		}
+		lstate.entries.emplace_back(RTreeBox::FromBoundingBox(bbox), row_offset + keep_count);
+		lstate.keep_sel.set_index(keep_count++, i);
+	}
+
+	if (keep_count == 0) {
+		return SinkResultType::NEED_MORE_INPUT;
+	}
+
+	auto &allocator = BufferAllocator::Get(context.client);
+	lstate.build_chunks.push_back(CopyBuildChunk(allocator, chunk, lstate.keep_sel, keep_count));
+	if (k != 0) {
+		lstate.knn_keys.push_back(CopyBuildChunk(allocator, lstate.build_keys, lstate.keep_sel, keep_count));
+	}
+
+	return SinkResultType::NEED_MORE_INPUT;
+}
+
+SinkCombineResultType PhysicalSpatialJoin::Combine(ExecutionContext &context, OperatorSinkCombineInput &input) const {
+	auto &gstate = input.global_state.Cast<SpatialJoinGlobalState>();
+	auto &lstate = input.local_state.Cast<SpatialJoinLocalState>();
+	if (gstate.is_cached) {
+		// The cached index is shared with other queries and must not change
+		return SinkCombineResultType::FINISHED;
+	}
+
+	lock_guard<mutex> guard(gstate.lock);
+	auto &index = *gstate.index;
+
+	// Shift the local row ids past the chunks already in the global state
+	auto row_offset = index.build_chunks.size() * STANDARD_VECTOR_SIZE;
+	for (auto &entry : lstate.entries) {
+		index.entries.emplace_back(entry.first, entry.second + row_offset);
+	}
+	for (auto &build_chunk : lstate.build_chunks) {
+		index.build_chunks.push_back(std::move(build_chunk));
+	}
+	for (auto &key_chunk : lstate.knn_keys) {
+		index.knn_keys.push_back(std::move(key_chunk));
+	}
+	index.exact_boxes.insert(index.exact_boxes.end(), lstate.exact_boxes.begin(), lstate.exact_boxes.end());
+	index.entry_times.insert(index.entry_times.end(), lstate.entry_times.begin(), lstate.entry_times.end());
+
+	lstate.entries.clear();
+	lstate.build_chunks.clear();
+	lstate.exact_boxes.clear();
+	lstate.knn_keys.clear();
+	lstate.entry_times.clear();
+
+	return SinkCombineResultType::FINISHED;
+}
+
+// Builds the R-trees of a range of tiles
+class SpatialJoinTileBuildTask : public ExecutorTask {
+public:
+	SpatialJoinTileBuildTask(shared_ptr<Event> event_p, ClientContext &context, SpatialJoinGlobalState &gstate,
+	                         idx_t tile_begin, idx_t tile_end)
+	    : ExecutorTask(context), event(std::move(event_p)), gstate(gstate), tile_begin(tile_begin),
+	      tile_end(tile_end) {
+	}
+
+	TaskExecutionResult ExecuteTask(TaskExecutionMode mode) override {
+		SpatialCounters counters;
+		counters.enabled = gstate.counters.enabled;
+		{
+			SpatialCounters::Timer timer(counters, counters.join_build_us);
+			for (auto tile_idx = tile_begin; tile_idx < tile_end; tile_idx++) {
+				gstate.index->tiles[tile_idx].Build();
+			}
+		}
+		counters.Flush();
+		event->FinishTask();
+		return TaskExecutionResult::TASK_FINISHED;
+	}
+
+private:
+	shared_ptr<Event> event;
+	SpatialJoinGlobalState &gstate;
+	idx_t tile_begin;
+	idx_t tile_end;
+};
+
+class SpatialJoinTileBuildEvent : public BasePipelineEvent {
+public:
+	SpatialJoinTileBuildEvent(Pipeline &pipeline_p, const PhysicalSpatialJoin &op, SpatialJoinGlobalState &gstate)
+	    : BasePipelineEvent(pipeline_p), op(op), gstate(gstate) {
+	}
+
+	const PhysicalSpatialJoin &op;
+	SpatialJoinGlobalState &gstate;
+
+	void Schedule() override {
+		auto &context = pipeline->GetClientContext();
+		auto &scheduler = TaskScheduler::GetScheduler(context);
+		auto thread_count = MaxValue<idx_t>(static_cast<idx_t>(scheduler.NumberOfThreads()), 1);
+
+		auto tile_count = gstate.index->tiles.size();
+		auto tiles_per_task = MaxValue<idx_t>((tile_count + thread_count - 1) / thread_count, 1);
+
+		vector<shared_ptr<Task>> tasks;
+		for (idx_t tile_begin = 0; tile_begin < tile_count; tile_begin += tiles_per_task) {
+			auto tile_end = MinValue<idx_t>(tile_begin + tiles_per_task, tile_count);
+			tasks.push_back(
+			    make_uniq<SpatialJoinTileBuildTask>(shared_from_this(), context, gstate, tile_begin, tile_end));
+		}
+		SetTasks(std::move(tasks));
+	}
+
+	void FinishEvent() override {
+		CacheIndex(pipeline->GetClientContext(), op, gstate);
+	}
+};
+
+SinkFinalizeType PhysicalSpatialJoin::Finalize(Pipeline &pipeline, Event &event, ClientContext &context,
+                                               OperatorSinkFinalizeInput &input) const {
+	auto &gstate = input.global_state.Cast<SpatialJoinGlobalState>();
+	auto &index = *gstate.index;
+	if (gstate.is_cached) {
+		// Built by an earlier query, the scan of the build side stopped at its first chunk
+		if (index.IsEmpty()) {
+			return EmptyResultIfRHSIsEmpty() ? SinkFinalizeType::NO_OUTPUT_POSSIBLE : SinkFinalizeType::READY;
+		}
+		if (k == 0) {
+			SetExtentFilter(*this, index.bounds);
+		}
+		return SinkFinalizeType::READY;
+	}
+	SpatialCounters::Timer timer(gstate.counters, gstate.counters.join_build_us);
+
+	index.entry_count = index.entries.size();
+	if (index.IsEmpty()) {
+		// Left and anti joins still return all the rows of the left side
+		index.rtree.Build();
+		CacheIndex(context, *this, gstate);
+		return EmptyResultIfRHSIsEmpty() ? SinkFinalizeType::NO_OUTPUT_POSSIBLE : SinkFinalizeType::READY;
+	}
+
+	if (k != 0) {
+		// KNN joins are never partitioned, as the nearest neighbours may be in any tile
+		index.knn_rows.reserve(index.entry_count);
+		for (idx_t entry_idx = 0; entry_idx < index.entry_count; entry_idx++) {
+			index.rtree.Insert(index.entries[entry_idx].first, entry_idx);
+			index.knn_rows.push_back(index.entries[entry_idx].second);
+		}
+		index.entries.clear();
+		index.entries.shrink_to_fit();
+		index.rtree.Build();
+		CacheIndex(context, *this, gstate);
+		return SinkFinalizeType::READY;
+	}
+
+	for (auto &entry : index.entries) {
+		index.bounds.Union(entry.first);
+	}
+	index.occupancy.Build(index.entries, index.bounds);
+	SetExtentFilter(*this, index.bounds);
+
+	if (right_time_key) {
+		// Sort the entries by time and split them into buckets, instead of tiles in space
+		vector<idx_t> order(index.entry_count);
+		for (idx_t i = 0; i < order.size(); i++) {
+			order[i] = i;
+		}
+		auto &times = index.entry_times;
+		std::sort(order.begin(), order.end(), [&](idx_t a, idx_t b) { return times[a] < times[b]; });
+
+		auto bucket_size = SpatialJoinIndex::TIME_BUCKET_SIZE;
+		index.time_partitioned = true;
+		index.tiles.resize((index.entry_count + bucket_size - 1) / bucket_size);
+		index.sorted_times.resize(index.entry_count);
+		index.sorted_rows.resize(index.entry_count);
+		for (idx_t position = 0; position < order.size(); position++) {
+			auto &entry = index.entries[order[position]];
+			index.sorted_times[position] = times[order[position]];
+			index.sorted_rows[position] = entry.second;
+			index.tiles[position / bucket_size].Insert(entry.first, position);
+		}
+		for (idx_t bucket = 0; bucket < index.tiles.size(); bucket++) {
+			auto last = MinValue<idx_t>((bucket + 1) * bucket_size, index.entry_count) - 1;
+			index.bucket_min.push_back(index.sorted_times[bucket * bucket_size]);
+			index.bucket_max.push_back(index.sorted_times[last]);
+		}
+		index.entries.clear();
+		index.entries.shrink_to_fit();
+		index.entry_times.clear();
+		index.entry_times.shrink_to_fit();
+
+		// Build the R-trees of the buckets in parallel
+		auto build_event = make_shared<SpatialJoinTileBuildEvent>(pipeline, *this, gstate);
+		event.InsertEvent(std::move(build_event));
+		return SinkFinalizeType::READY;
+	}
+
+	if (index.entry_count <= partition_threshold) {
+		for (auto &entry : index.entries) {
+			index.rtree.Insert(entry.first, entry.second);
+		}
+		index.entries.clear();
+		index.entries.shrink_to_fit();
+		index.rtree.Build();
+		CacheIndex(context, *this, gstate);
+		return SinkFinalizeType::READY;
+	}
+
+	// Partition the build side into tiles
+	auto thread_count = static_cast<idx_t>(TaskScheduler::GetScheduler(context).NumberOfThreads());
+
+	index.partitioned = true;
+	index.grid.Initialize(index.bounds, index.entry_count, thread_count);
+	index.tiles.resize(index.grid.TileCount());
+
+	for (auto &entry : index.entries) {
+		auto &box = entry.first;
+		auto col_end = index.grid.Col(box.maxx);
+		auto row_end = index.grid.Row(box.maxy);
+		for (auto row = index.grid.Row(box.miny); row <= row_end; row++) {
+			for (auto col = index.grid.Col(box.minx); col <= col_end; col++) {
+				index.tiles[row * index.grid.cols + col].Insert(box, entry.second);
+			}
+		}
+	}
+	index.entries.clear();
+	index.entries.shrink_to_fit();
+
+	// Build the R-trees of the tiles in parallel
+	auto build_event = make_shared<SpatialJoinTileBuildEvent>(pipeline, *this, gstate);
+	event.InsertEvent(std::move(build_event));
+
+	return SinkFinalizeType::READY;
+}
+
+//------------------------------------------------------------------------------
+// Operator
+//------------------------------------------------------------------------------
+class SpatialJoinProbeState : public CachingOperatorState {
+public:
+	SpatialJoinProbeState(ClientContext &context, const PhysicalSpatialJoin &op)
+	    : executor(context, *op.left_key), distance(op.distance), k(op.k), time_lower(op.time_lower),
+	      time_upper(op.time_upper), probe_sel(STANDARD_VECTOR_SIZE), build_sel(STANDARD_VECTOR_SIZE),
+	      match_sel(STANDARD_VECTOR_SIZE) {
+		probe_keys.Initialize(Allocator::Get(context), {op.left_key->return_type});
+		if (op.left_time_key) {
+			time_executor = make_uniq<ExpressionExecutor>(context, *op.left_time_key);
+			probe_times.Initialize(Allocator::Get(context), {op.left_time_key->return_type});
+		}
+		if (op.condition) {
+			condition_executor = make_uniq<ExpressionExecutor>(context, *op.condition);
+			auto pair_types = op.children[0]->types;
+			pair_types.insert(pair_types.end(), op.children[1]->types.begin(), op.children[1]->types.end());
+			pairs.Initialize(Allocator::Get(context), pair_types);
+		}
+		counters.Init(context);
+	}
+	~SpatialJoinProbeState() override {
+		counters.Flush();
+	}
+
+	ExpressionExecutor executor;
+	DataChunk probe_keys;
+	double distance;
+	idx_t k;
+	unique_ptr<ExpressionExecutor> time_executor;
+	DataChunk probe_times;
+	double time_lower;
+	double time_upper;
+
+	// The candidate pairs of the current input chunk
+	bool has_candidates = false;
+	idx_t candidate_offset = 0;
+	vector<sel_t> probe_rows;
+	vector<idx_t> build_rows;
+	vector<std::pair<idx_t, sel_t>> sort_buffer;
+	// KNN: the distance of every candidate pair, and a max-heap of the (distance, entry) of the k closest entries
+	// found so far
+	vector<double> distances;
+	vector<std::pair<double, idx_t>> nearest;
+
+	vector<idx_t> search_stack;
+	SelectionVector probe_sel;
+	SelectionVector build_sel;
+
+	// Join types other than INNER evaluate the condition on the candidate pairs themselves
+	unique_ptr<ExpressionExecutor> condition_executor;
+	DataChunk pairs;
+	SelectionVector match_sel;
+	bool found_match[STANDARD_VECTOR_SIZE];
+
+	SpatialCounters counters;
+
+	void CollectCandidates(DataChunk &input, const SpatialJoinIndex &index) {
+		SpatialCounters::Timer timer(counters, counters.join_probe_us);
+		probe_keys.Reset();
+		executor.Execute(input, probe_keys);
+
+		UnifiedVectorFormat format;
+		probe_keys.data[0].ToUnifiedFormat(input.size(), format);
+		auto keys = reinterpret_cast<const geometry_t *>(format.data);
+
+		probe_rows.clear();
+		build_rows.clear();
+		distances.clear();
+		candidate_offset = 0;
+		memset(found_match, 0, sizeof(found_match));
+
+		SpatialJoinTimeKeys time_keys;
+		if (time_executor) {
+			probe_times.Reset();
+			time_executor->Execute(input, probe_times);
+			time_keys.Load(probe_times.data[0], input.size());
+		}
+
+		BoundingBox bbox;
+		double time = 0;
+		for (idx_t i = 0; i < input.size(); i++) {
+			auto idx = format.sel->get_index(i);
+			if (!format.validity.RowIsValid(idx)) {
+				continue;
+			}
+			if (!GeometryFactory::TryGetSerializedBoundingBox(keys[idx], bbox)) {
+				continue;
+			}
+			if (k != 0) {
+				if (keys[idx].GetType() != GeometryType::POINT) {
+					throw InvalidInputException("ST_KNN: the left side geometries must be points");
+				}
+				CollectNearest(static_cast<sel_t>(i), keys[idx], bbox, index);
+				continue;
+			}
+			bbox.minx -= distance;
+			bbox.miny -= distance;
+			bbox.maxx += distance;
+			bbox.maxy += distance;
+			auto probe = RTreeBox::FromBoundingBox(bbox);
+			if (!index.occupancy.MayMatch(probe)) {
+				counters.join_grid_rejects++;
+				continue;
+			}
+			auto add_candidate = [&](idx_t row_id) {
+				probe_rows.push_back(static_cast<sel_t>(i));
+				build_rows.push_back(row_id);
+			};
+			if (!index.time_partitioned) {
+				index.Probe(probe, search_stack, add_candidate);
+				continue;
+			}
+			// left - right in [lower, upper] means right in [left - upper, left - lower]
+			if (!time_keys.TryGet(i, time)) {
+				continue;
+			}
+			auto min_time = time - time_upper;
+			auto max_time = time - time_lower;
+			if (std::isfinite(time)) {
+				// The condition subtracts the times instead, which may round the other way
+				min_time -= (std::abs(time) + std::abs(min_time)) * TIME_SLACK;
+				max_time += (std::abs(time) + std::abs(max_time)) * TIME_SLACK;
+			}
+			index.ProbeTimeBand(probe, min_time, max_time, search_stack, add_candidate);
+		}
+		if (k == 0) {
+			SortCandidates();
+		}
+		counters.join_candidates += probe_rows.size();
+		has_candidates = true;
+	}
+
+	// Order the candidates by build side row, and by probe row within the same build side row. The candidates of a
+	// build side geometry then reach the exact predicate one after the other, which prepares it (through the
+	// per-thread prepared geometry cache) the second time it sees it and reuses it for the rest, instead of
+	// alternating between the build side geometries in probe order. The build side rows are also gathered in longer
+	// runs from the same chunk.
+	void SortCandidates() {
+		if (std::is_sorted(build_rows.begin(), build_rows.end())) {
+			return;
+		}
+		sort_buffer.clear();
+		for (idx_t i = 0; i < build_rows.size(); i++) {
+			sort_buffer.emplace_back(build_rows[i], probe_rows[i]);
+		}
+		// The probe rows were collected in order, so this keeps them in order within a build side row
+		std::sort(sort_buffer.begin(), sort_buffer.end());
+		for (idx_t i = 0; i < sort_buffer.size(); i++) {
+			build_rows[i] = sort_buffer[i].first;
+			probe_rows[i] = sort_buffer[i].second;
+		}
+	}
+
+	// Collect the k nearest build side rows of a probe point, closest first. The entries come in the order of their
+	// bounding box distance, which is never more than their exact distance, so once it exceeds the k-th closest exact
+	// distance so far no later entry can be closer.
+	void CollectNearest(sel_t probe_row, const geometry_t &probe, const BoundingBox &bbox,
+	                    const SpatialJoinIndex &index) {
+		SpatialJoinExactBox probe_box(bbox);
+		nearest.clear();
+		index.rtree.NearestSearch(
+		    RTreeBox::FromBoundingBox(bbox),
+		    [&](idx_t entry_idx, const RTreeBox &) { return index.exact_boxes[entry_idx].Distance(probe_box); },
+		    [&](idx_t entry_idx, double box_distance) {
+			    if (nearest.size() == k && box_distance > nearest.front().first) {
+				    return false;
+			    }
+			    double exact_distance;
+			    if (!PointDistance::TryCompute(probe, index.GetKnnKey(entry_idx), exact_distance)) {
+				    // Neither empty nor a collection, see Sink
+				    throw InternalException("ST_KNN: could not compute the distance to a right side geometry");
+			    }
+			    if (nearest.size() == k) {
+				    if (exact_distance >= nearest.front().first) {
+					    return true;
+				    }
+				    std::pop_heap(nearest.begin(), nearest.end());
+				    nearest.pop_back();
+			    }
+			    nearest.emplace_back(exact_distance, entry_idx);
+			    std::push_heap(nearest.begin(), nearest.end());
+			    return true;
+		    });
+		std::sort_heap(nearest.begin(), nearest.end());
+		for (auto &entry : nearest) {
+			probe_rows.push_back(probe_row);
+			build_rows.push_back(index.knn_rows[entry.second]);
+			distances.push_back(entry.first);
+		}
+	}
+};
+
+unique_ptr<OperatorState> PhysicalSpatialJoin::GetOperatorState(ExecutionContext &context) const {
+	return make_uniq<SpatialJoinProbeState>(context.client, *this);
+}
+
+// Copy the given build side rows into the result, starting at the column offset.
+// Consecutive rows that belong to the same build chunk are copied in one go.
+static void GatherBuildRows(const vector<unique_ptr<DataChunk>> &build_chunks, const idx_t *row_ids, idx_t count,
+                            SelectionVector &sel, DataChunk &result, idx_t col_offset) {
+	idx_t run_begin = 0;
+	while (run_begin < count) {
+		auto chunk_idx = row_ids[run_begin] / STANDARD_VECTOR_SIZE;
+		auto run_end = run_begin;
+		while (run_end < count && row_ids[run_end] / STANDARD_VECTOR_SIZE == chunk_idx) {
+			sel.set_index(run_end - run_begin, row_ids[run_end] % STANDARD_VECTOR_SIZE);
+			run_end++;
+		}
+
+		auto &source = *build_chunks[chunk_idx];
+		for (idx_t col_idx = 0; col_idx < source.ColumnCount(); col_idx++) {
+			VectorOperations::Copy(source.data[col_idx], result.data[col_offset + col_idx], sel, run_end - run_begin,
+			                       0, run_begin);
+		}
+		run_begin = run_end;
+	}
+}
+
+// Construct the next batch of candidate pairs, starting at the current candidate offset, followed by their distance
+// if emit_distance is set
+static idx_t SliceCandidates(const SpatialJoinIndex &index, SpatialJoinProbeState &state, DataChunk &input,
+                             DataChunk &result, bool emit_distance) {
+	auto remaining = state.probe_rows.size() - state.candidate_offset;
+	auto count = MinValue<idx_t>(remaining, STANDARD_VECTOR_SIZE);
+	for (idx_t i = 0; i < count; i++) {
+		state.probe_sel.set_index(i, state.probe_rows[state.candidate_offset + i]);
+	}
+
+	// Left side: slice the input chunk, right side: copy from the build side
+	result.Slice(input, state.probe_sel, count);
+	GatherBuildRows(index.build_chunks, state.build_rows.data() + state.candidate_offset, count, state.build_sel,
+	                result, input.ColumnCount());
+	if (emit_distance) {
+		auto &distance_vector = result.data.back();
+		distance_vector.SetVectorType(VectorType::FLAT_VECTOR);
+		memcpy(FlatVector::GetData<double>(distance_vector), state.distances.data() + state.candidate_offset,
+		       count * sizeof(double));
+	}
+	result.SetCardinality(count);
+	return count;
+}
+
+// Output the rows of the left side that found a match (SEMI) or did not find one (LEFT, ANTI).
+// The right side columns of a LEFT join are all NULL.
+static void ConstructUnmatchedResult(JoinType join_type, DataChunk &input, DataChunk &result,
+                                     const bool found_match[]) {
+	auto keep_matched = join_type == JoinType::SEMI;
+	SelectionVector sel(STANDARD_VECTOR_SIZE);
+	idx_t count = 0;
+	for (idx_t i = 0; i < input.size(); i++) {
+		if (found_match[i] == keep_matched) {
+			sel.set_index(count++, i);
+		}
+	}
+	if (count == 0) {
+		return;
+	}
+	result.Slice(input, sel, count);
+	for (idx_t col_idx = input.ColumnCount(); col_idx < result.ColumnCount(); col_idx++) {
+		result.data[col_idx].SetVectorType(VectorType::CONSTANT_VECTOR);
+		ConstantVector::SetNull(result.data[col_idx], true);
+	}
+	result.SetCardinality(count);
+}
+
+OperatorResultType PhysicalSpatialJoin::ExecuteConditional(DataChunk &input, DataChunk &chunk,
+                                                           OperatorState &state_p) const {
+	auto &index = *sink_state->Cast<SpatialJoinGlobalState>().index;
+	auto &state = state_p.Cast<SpatialJoinProbeState>();
+
+	while (state.candidate_offset < state.probe_rows.size()) {
+		state.pairs.Reset();
+		auto pair_count = SliceCandidates(index, state, input, state.pairs, false);
+		idx_t match_count;
+		{
+			SpatialCounters::Timer timer(state.counters, state.counters.join_refine_us);
+			match_count = state.condition_executor->SelectExpression(state.pairs, state.match_sel);
+		}
+		state.counters.join_matches += match_count;
+		for (idx_t i = 0; i < match_count; i++) {
+			auto candidate_idx = state.candidate_offset + state.match_sel.get_index(i);
+			state.found_match[state.probe_rows[candidate_idx]] = true;
+		}
+		state.candidate_offset += pair_count;
+
+		if (join_type == JoinType::LEFT && match_count > 0) {
+			chunk.Slice(state.pairs, state.match_sel, match_count);
+			chunk.SetCardinality(match_count);
+			return OperatorResultType::HAVE_MORE_OUTPUT;
+		}
+	}
+
+	// All the candidates of this input chunk have been checked
+	ConstructUnmatchedResult(join_type, input, chunk, state.found_match);
+	state.has_candidates = false;
+	return OperatorResultType::NEED_MORE_INPUT;
+}
+
+OperatorResultType PhysicalSpatialJoin::ExecuteInternal(ExecutionContext &context, DataChunk &input, DataChunk &chunk,
+                                                        GlobalOperatorState &gstate_p, OperatorState &state_p) const {
+	auto &index = *sink_state->Cast<SpatialJoinGlobalState>().index;
+	auto &state = state_p.Cast<SpatialJoinProbeState>();
+
+	if (index.IsEmpty() && EmptyResultIfRHSIsEmpty()) {
+		return OperatorResultType::FINISHED;
+	}
+
+	if (!state.has_candidates) {
+		state.CollectCandidates(input, index);
+	}
+
+	if (condition) {
+		return ExecuteConditional(input, chunk, state_p);
+	}
+
+	if (state.candidate_offset < state.probe_rows.size()) {
+		state.candidate_offset += SliceCandidates(index, state, input, chunk, emit_distance);
+	}
+
+	if (state.candidate_offset < state.probe_rows.size()) {
+		return OperatorResultType::HAVE_MORE_OUTPUT;
+	}
+
+	state.has_candidates = false;
+	return OperatorResultType::NEED_MORE_INPUT;
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,197 @@
+#include "spatial/core/operators/spatial_top_n.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+
+#include <cmath>
+#include <queue>
+
+#include "duckdb/execution/column_binding_resolver.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/execution/physical_plan_generator.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Logical Operator
+//------------------------------------------------------------------------------
+LogicalSpatialTopNFilter::LogicalSpatialTopNFilter(idx_t k)
+    : LogicalExtensionOperator(), k(k), minx(0), miny(0), maxx(0), maxy(0) {
+}
+
+vector<ColumnBinding> LogicalSpatialTopNFilter::GetColumnBindings() {
+	return children[0]->GetColumnBindings();
+}
+
+void LogicalSpatialTopNFilter::ResolveTypes() {
+	types = children[0]->types;
+}
+
+void LogicalSpatialTopNFilter::ResolveColumnBindings(ColumnBindingResolver &res, vector<ColumnBinding> &bindings) {
+	D_ASSERT(children.size() == 1);
+	D_ASSERT(expressions.size() == 2);
+	res.VisitOperator(*children[0]);
+	res.VisitExpression(&expressions[0]);
+	res.VisitExpression(&expressions[1]);
+	bindings = GetColumnBindings();
+}
+
+unique_ptr<PhysicalOperator> LogicalSpatialTopNFilter::CreatePlan(ClientContext &context,
+                                                                  PhysicalPlanGenerator &generator) {
+	D_ASSERT(children.size() == 1);
+	auto child = generator.CreatePlan(std::move(children[0]));
+	return make_uniq<PhysicalSpatialTopNFilter>(*this, std::move(child), std::move(expressions[0]),
+	                                            std::move(expressions[1]));
+}
+
+//------------------------------------------------------------------------------
+// Physical Operator
+//------------------------------------------------------------------------------
+PhysicalSpatialTopNFilter::PhysicalSpatialTopNFilter(const LogicalSpatialTopNFilter &op,
+                                                     unique_ptr<PhysicalOperator> child,
+                                                     unique_ptr<Expression> geometry_p,
+                                                     unique_ptr<Expression> distance_p)
+    : PhysicalOperator(PhysicalOperatorType::EXTENSION, op.types, op.estimated_cardinality),
+      geometry(std::move(geometry_p)), distance(std::move(distance_p)), k(op.k), minx(op.minx), miny(op.miny),
+      maxx(op.maxx), maxy(op.maxy) {
+	children.push_back(std::move(child));
+}
+
+string PhysicalSpatialTopNFilter::ParamsToString() const {
+	return distance->ToString() + "\nTop: " + std::to_string(k);
+}
+
+class SpatialTopNFilterState : public OperatorState {
+public:
+	SpatialTopNFilterState(ClientContext &context, const PhysicalSpatialTopNFilter &op)
+	    : geometry_executor(context, *op.geometry), distance_executor(context, *op.distance),
+	      candidate_sel(STANDARD_VECTOR_SIZE), keep_sel(STANDARD_VECTOR_SIZE) {
+		geometries.Initialize(Allocator::Get(context), {op.geometry->return_type});
+		candidates.Initialize(Allocator::Get(context), op.children[0]->types);
+		distances.Initialize(Allocator::Get(context), {op.distance->return_type});
+	}
+
+	ExpressionExecutor geometry_executor;
+	ExpressionExecutor distance_executor;
+	DataChunk geometries;
+	DataChunk candidates;
+	DataChunk distances;
+	SelectionVector candidate_sel;
+	SelectionVector keep_sel;
+
+	// The k smallest distances seen by this thread, largest on top
+	std::priority_queue<double> heap;
+
+	bool IsFull(idx_t k) const {
+		return heap.size() >= k;
+	}
+
+	// Whether a row at the given distance may be among the first k, and if so remember its distance
+	bool Offer(double value, idx_t k) {
+		if (!IsFull(k)) {
+			heap.push(value);
+			return true;
+		}
+		// Ties with the k-th distance are kept, the TOP_N decides between them
+		if (value > heap.top()) {
+			return false;
+		}
+		if (value < heap.top()) {
+			heap.pop();
+			heap.push(value);
+		}
+		return true;
+	}
+};
+
+unique_ptr<OperatorState> PhysicalSpatialTopNFilter::GetOperatorState(ExecutionContext &context) const {
+	return make_uniq<SpatialTopNFilterState>(context.client, *this);
+}
+
+// The relative margin by which the box distance is lowered, as the exact distance may round the other way
+static constexpr const double DISTANCE_SLACK = 1e-12;
+
+// The distance between two bounding boxes, zero if they intersect. Never larger than the distance between the
+// geometries, as they are contained in their boxes.
+static double BoxDistance(const BoundingBox &bbox, double minx, double miny, double maxx, double maxy) {
+	auto dx = std::max({0.0, bbox.minx - maxx, minx - bbox.maxx});
+	auto dy = std::max({0.0, bbox.miny - maxy, miny - bbox.maxy});
+	auto distance = std::sqrt(dx * dx + dy * dy);
+	return distance - distance * DISTANCE_SLACK;
+}
+
+OperatorResultType PhysicalSpatialTopNFilter::Execute(ExecutionContext &context, DataChunk &input, DataChunk &chunk,
+                                                      GlobalOperatorState &gstate, OperatorState &state_p) const {
+	auto &state = state_p.Cast<SpatialTopNFilterState>();
+	auto count = input.size();
+
+	state.geometries.Reset();
+	state.geometry_executor.Execute(input, state.geometries);
+	UnifiedVectorFormat geometry_format;
+	state.geometries.data[0].ToUnifiedFormat(count, geometry_format);
+	auto geometry_data = UnifiedVectorFormat::GetData<geometry_t>(geometry_format);
+
+	// Drop the rows whose bounding box is further away than the k-th distance so far
+	idx_t keep_count = 0;
+	idx_t candidate_count = 0;
+	BoundingBox bbox;
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = geometry_format.sel->get_index(i);
+		if (!geometry_format.validity.RowIsValid(idx)) {
+			if (!state.IsFull(k)) {
+				state.keep_sel.set_index(keep_count++, i);
+			}
+			continue;
+		}
+		if (!GeometryFactory::TryGetSerializedBoundingBox(geometry_data[idx], bbox)) {
+			// Empty geometries have no bounding box to bound their distance with
+			state.keep_sel.set_index(keep_count++, i);
+			continue;
+		}
+		if (state.IsFull(k) && BoxDistance(bbox, minx, miny, maxx, maxy) > state.heap.top()) {
+			continue;
+		}
+		state.candidate_sel.set_index(candidate_count++, i);
+	}
+
+	// Compute the exact distances of the remaining rows
+	if (candidate_count > 0) {
+		state.candidates.Reset();
+		state.candidates.Slice(input, state.candidate_sel, candidate_count);
+		state.distances.Reset();
+		state.distance_executor.Execute(state.candidates, state.distances);
+
+		UnifiedVectorFormat distance_format;
+		state.distances.data[0].ToUnifiedFormat(candidate_count, distance_format);
+		auto distance_data = UnifiedVectorFormat::GetData<double>(distance_format);
+		for (idx_t i = 0; i < candidate_count; i++) {
+			auto idx = distance_format.sel->get_index(i);
+			bool keep;
+			if (!distance_format.validity.RowIsValid(idx) || std::isnan(distance_data[idx])) {
+				// Sorted after all distances, so only needed while there are fewer than k of them
+				keep = !state.IsFull(k);
+			} else {
+				keep = state.Offer(distance_data[idx], k);
+			}
+			if (keep) {
+				state.keep_sel.set_index(keep_count++, state.candidate_sel.get_index(i));
+			}
+		}
+	}
+
+	// The kept rows are not in input order, but the TOP_N above sorts them anyway
+	if (keep_count == count) {
+		chunk.Reference(input);
+	} else if (keep_count > 0) {
+		chunk.Slice(input, state.keep_sel, keep_count);
+	} else {
+		chunk.SetCardinality(0);
+	}
+	return OperatorResultType::NEED_MORE_INPUT;
+}
+
+} // namespace core
+
+} // namespace spatial
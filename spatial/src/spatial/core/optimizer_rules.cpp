@@ -1,17 +1,41 @@
 #include "duckdb/catalog/catalog_entry/scalar_function_catalog_entry.hpp"
 #include "duckdb/execution/expression_executor.hpp"
 #include "duckdb/optimizer/optimizer_extension.hpp"
+#include "duckdb/parser/parsed_data/alter_info.hpp"
+#include "duckdb/parser/parsed_data/create_table_info.hpp"
+#include "duckdb/parser/parsed_data/drop_info.hpp"
+#include "duckdb/storage/statistics/string_stats.hpp"
+#include "duckdb/planner/expression/bound_between_expression.hpp"
+#include "duckdb/planner/expression/bound_cast_expression.hpp"
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
 #include "duckdb/planner/expression/bound_comparison_expression.hpp"
 #include "duckdb/planner/expression/bound_conjunction_expression.hpp"
+#include "duckdb/planner/expression/bound_constant_expression.hpp"
 #include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckdb/planner/expression/bound_operator_expression.hpp"
+#include "duckdb/planner/expression_iterator.hpp"
 #include "duckdb/planner/logical_operator.hpp"
 #include "duckdb/planner/operator/logical_any_join.hpp"
 #include "duckdb/planner/operator/logical_comparison_join.hpp"
+#include "duckdb/planner/operator/logical_create_table.hpp"
+#include "duckdb/planner/operator/logical_delete.hpp"
 #include "duckdb/planner/operator/logical_filter.hpp"
 #include "duckdb/planner/operator/logical_get.hpp"
+#include "duckdb/planner/operator/logical_insert.hpp"
 #include "duckdb/planner/operator/logical_join.hpp"
+#include "duckdb/planner/operator/logical_projection.hpp"
+#include "duckdb/planner/operator/logical_simple.hpp"
+#include "duckdb/planner/operator/logical_top_n.hpp"
+#include "duckdb/planner/operator/logical_update.hpp"
 #include "spatial/common.hpp"
 #include "spatial/core/optimizer_rules.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/join_index_cache.hpp"
+#include "spatial/core/operators/spatial_cache_invalidation.hpp"
+#include "spatial/core/operators/spatial_join.hpp"
+#include "spatial/core/operators/spatial_top_n.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/geographiclib/spheroid_bounds.hpp"
 
 namespace spatial {
 
@@ -27,7 +51,28 @@ namespace core {
 //  faster.
 //
 //	All spatial predicates (except st_disjoint) imply an intersection of the
-//  bounding boxes of the two geometries.
+//  bounding boxes of the two geometries. The same holds for ST_DWithin once the
+//  bounding boxes are expanded by the (constant) distance.
+//
+//  If both sides of the predicate are GEOMETRY, the join is instead planned as a
+//  dedicated spatial join that probes an R-tree built over the bounding boxes of
+//  one side, chosen by the number of rows and the vertices of the geometries on
+//  each side. The exact predicate is still evaluated in a filter on top.
+//  If the build side has more rows than the "spatial_join_partition_threshold"
+//  setting, it is partitioned into a grid of tiles with one R-tree per tile.
+//
+//  The spatial predicate can be combined with other conditions. If they bound
+//  the difference between a time on each side (see "Time Band" below), the
+//  spatial join prunes on time as well.
+//
+//  Joins on ST_KNN are always planned as a k-nearest-neighbour spatial join.
+//  The other rewrites can be turned off with the "spatial_join_rewrite" setting,
+//  e.g. to compare against the plain nested loop join.
+//
+//  LEFT, SEMI and ANTI joins can only be planned as a spatial join, in which
+//  case the predicate is evaluated by the join itself. NOT st_disjoint is
+//  treated like st_intersects, so e.g. "rows that are disjoint from all zones"
+//  becomes an (indexed) anti join.
 //
 class RangeJoinSpatialPredicateRewriter : public OptimizerExtension {
 public:
@@ -78,165 +123,923 @@ public:
 		return true;
 	}
 
-	static void TryOptimize(ClientContext &context, OptimizerExtensionInfo *info, unique_ptr<LogicalOperator> &plan) {
+	// Evaluates a constant, finite and non-negative distance argument
+	static bool TryGetConstantDistance(ClientContext &context, Expression &expr, double &distance) {
+		if (!expr.IsFoldable()) {
+			return false;
+		}
+		Value value;
+		if (!ExpressionExecutor::TryEvaluateScalar(context, expr, value)) {
+			return false;
+		}
+		if (value.IsNull() || !value.DefaultTryCastAs(LogicalType::DOUBLE)) {
+			return false;
+		}
+		distance = value.GetValue<double>();
+		return std::isfinite(distance) && distance >= 0;
+	}
 
-		auto &op = *plan;
+	static unique_ptr<Expression> BindDoubleArithmetic(ClientContext &context, const string &op,
+	                                                   unique_ptr<Expression> left, double right) {
+		auto &catalog = Catalog::GetSystemCatalog(context);
+		auto &func_set = catalog.GetEntry(context, CatalogType::SCALAR_FUNCTION_ENTRY, DEFAULT_SCHEMA, op)
+		                     .Cast<ScalarFunctionCatalogEntry>();
+		auto func = func_set.functions.GetFunctionByArguments(context, {LogicalType::DOUBLE, LogicalType::DOUBLE});
+		vector<unique_ptr<Expression>> args;
+		args.push_back(std::move(left));
+		args.push_back(make_uniq<BoundConstantExpression>(Value::DOUBLE(right)));
+		return make_uniq<BoundFunctionExpression>(LogicalType::DOUBLE, std::move(func), std::move(args), nullptr);
+	}
 
-		// Look for ANY_JOIN operators
-		if (op.type == LogicalOperatorType::LOGICAL_ANY_JOIN) {
-			auto &any_join = op.Cast<LogicalAnyJoin>();
+	// Estimates the cardinality of a join on a spatial predicate.
+	// The default estimate for a join on an arbitrary condition is a fraction of the cross product, which is far off
+	// for most spatial joins: they are usually close to 1:1 with the larger side, e.g. points in (mostly)
+	// non-overlapping zones, or zones intersecting their neighbours. KNN joins return exactly k rows per probe row.
+	static idx_t EstimateSpatialJoinCardinality(ClientContext &context, JoinType join_type, LogicalOperator &left,
+	                                            LogicalOperator &right, idx_t k = 0) {
+		auto left_card = left.EstimateCardinality(context);
+		auto right_card = right.EstimateCardinality(context);
+		switch (join_type) {
+		case JoinType::SEMI:
+		case JoinType::ANTI:
+			return left_card;
+		default:
+			break;
+		}
+		if (k != 0) {
+			return left_card * MinValue(k, right_card);
+		}
+		return MaxValue(left_card, right_card);
+	}
 
-			// Check if the join condition is a spatial predicate and the join type is INNER
-			if (any_join.condition->type == ExpressionType::BOUND_FUNCTION && any_join.join_type == JoinType::INNER) {
-				auto bound_func_expr = any_join.condition->Copy();
-				auto &bound_function = bound_func_expr->Cast<BoundFunctionExpression>();
+	// Only ever lowers the estimate of the rewritten join
+	static void SetSpatialJoinCardinality(ClientContext &context, LogicalAnyJoin &any_join, LogicalOperator &join,
+	                                      idx_t k = 0) {
+		auto estimate = EstimateSpatialJoinCardinality(context, any_join.join_type, *join.children[0],
+		                                               *join.children[1], k);
+		if (any_join.has_estimated_cardinality) {
+			estimate = MinValue(estimate, any_join.estimated_cardinality);
+		}
+		join.estimated_cardinality = estimate;
+		join.has_estimated_cardinality = true;
+	}
+
+	// The largest blob a column of a table scan can hold, from the statistics of the table. The column is followed
+	// through the projections and filters above the scan.
+	static bool TryGetMaxBlobSize(ClientContext &context, LogicalOperator &op, const ColumnBinding &binding,
+	                              idx_t &size) {
+		switch (op.type) {
+		case LogicalOperatorType::LOGICAL_GET: {
+			auto &get = op.Cast<LogicalGet>();
+			if (get.table_index != binding.table_index || !get.function.statistics ||
+			    binding.column_index >= get.column_ids.size()) {
+				return false;
+			}
+			auto column_id = get.column_ids[binding.column_index];
+			if (column_id == COLUMN_IDENTIFIER_ROW_ID) {
+				return false;
+			}
+			auto stats = get.function.statistics(context, get.bind_data.get(), column_id);
+			if (!stats || !StringStats::HasMaxStringLength(*stats)) {
+				return false;
+			}
+			size = StringStats::MaxStringLength(*stats);
+			return true;
+		}
+		case LogicalOperatorType::LOGICAL_PROJECTION: {
+			auto &projection = op.Cast<LogicalProjection>();
+			if (projection.table_index != binding.table_index) {
+				return false;
+			}
+			auto &expr = *projection.expressions[binding.column_index];
+			if (expr.type != ExpressionType::BOUND_COLUMN_REF) {
+				return false;
+			}
+			return TryGetMaxBlobSize(context, *op.children[0], expr.Cast<BoundColumnRefExpression>().binding, size);
+		}
+		default:
+			for (auto &child : op.children) {
+				if (TryGetMaxBlobSize(context, *child, binding, size)) {
+					return true;
+				}
+			}
+			return false;
+		}
+	}
+
+	// Estimates the number of vertices of the geometries of one side of a join, or returns 0 if it is unknown.
+	// Points are recognized by the function that creates them, the vertices of the geometries of a table column
+	// are bounded by the size of its largest blob, which is about 16 bytes per (2D) vertex.
+	static idx_t EstimateVertexCount(ClientContext &context, LogicalOperator &op, Expression &expr) {
+		switch (expr.type) {
+		case ExpressionType::BOUND_FUNCTION: {
+			auto &name = expr.Cast<BoundFunctionExpression>().function.name;
+			if (StringUtil::CIEquals(name, "st_point") || StringUtil::CIEquals(name, "st_makepoint") ||
+			    StringUtil::CIEquals(name, "st_centroid") || StringUtil::CIEquals(name, "st_pointonsurface")) {
+				return 1;
+			}
+			return 0;
+		}
+		case ExpressionType::BOUND_COLUMN_REF: {
+			idx_t size;
+			if (!TryGetMaxBlobSize(context, op, expr.Cast<BoundColumnRefExpression>().binding, size)) {
+				return 0;
+			}
+			return MaxValue<idx_t>(size / 16, 2) - 1;
+		}
+		default:
+			return 0;
+		}
+	}
+
+	// The estimated cost of a spatial join that builds the R-tree on one side and probes it with the other. The
+	// candidate pairs of a probe row are consecutive, so the exact predicate prepares a probe geometry once and
+	// reuses it for all of its pairs, while the build geometries come in no particular order and are evaluated
+	// unprepared, in time linear in their vertices. Complex geometries should therefore rather be probed, even if
+	// there are more of them.
+	static double EstimateSpatialJoinCost(double build_card, double build_vertices, double probe_card) {
+		auto tree_depth = std::log2(build_card + 2);
+		auto pairs = MaxValue(build_card, probe_card);
+		return (build_card + probe_card) * tree_depth + pairs * build_vertices;
+	}
+
+	// Whether the R-tree of an inner spatial join should be built on the left side instead of the right side. Without
+	// an estimate of the vertices of both sides the smaller side is built on.
+	static bool ShouldBuildOnLeft(ClientContext &context, LogicalOperator &left, Expression &left_expr,
+	                              LogicalOperator &right, Expression &right_expr) {
+		auto left_card = static_cast<double>(left.EstimateCardinality(context));
+		auto right_card = static_cast<double>(right.EstimateCardinality(context));
+		auto left_vertices = static_cast<double>(EstimateVertexCount(context, left, left_expr));
+		auto right_vertices = static_cast<double>(EstimateVertexCount(context, right, right_expr));
+		if (left_vertices == 0 || right_vertices == 0) {
+			return left_card < right_card;
+		}
+		return EstimateSpatialJoinCost(left_card, left_vertices, right_card) <
+		       EstimateSpatialJoinCost(right_card, right_vertices, left_card);
+	}
+
+	// Rewrites a join on ST_DWithin_Spheroid(a, b, distance) into a band join on the latitude (the first
+	// coordinate) of the two points, a.x - d <= b.x <= a.x + d, where d is the distance in degrees. Longitude is
+	// left unbounded as its length in meters goes to zero towards the poles, the remaining pairs are mostly rejected
+	// by the cheap bounds check of ST_DWithin_Spheroid itself.
+	static unique_ptr<LogicalOperator> CreateSpheroidDistanceJoin(ClientContext &context, LogicalAnyJoin &any_join,
+	                                                              unique_ptr<Expression> left_pred_expr,
+	                                                              unique_ptr<Expression> right_pred_expr,
+	                                                              double distance) {
+		auto degrees = geographiclib::SpheroidBounds::LatitudeDegrees(distance);
+
+		auto &catalog = Catalog::GetSystemCatalog(context);
+		auto &x_func_set = catalog.GetEntry(context, CatalogType::SCALAR_FUNCTION_ENTRY, DEFAULT_SCHEMA, "st_x")
+		                       .Cast<ScalarFunctionCatalogEntry>();
+
+		auto make_x = [&](const unique_ptr<Expression> &arg) -> unique_ptr<Expression> {
+			auto func = x_func_set.functions.GetFunctionByArguments(context, {arg->return_type});
+			vector<unique_ptr<Expression>> args;
+			args.push_back(arg->Copy());
+			return make_uniq<BoundFunctionExpression>(LogicalType::DOUBLE, std::move(func), std::move(args), nullptr);
+		};
+
+		auto new_join = make_uniq<LogicalComparisonJoin>(JoinType::INNER);
+
+		JoinCondition lower;
+		lower.comparison = ExpressionType::COMPARE_LESSTHANOREQUALTO;
+		lower.left = BindDoubleArithmetic(context, "-", make_x(left_pred_expr), degrees);
+		lower.right = make_x(right_pred_expr);
+		new_join->conditions.push_back(std::move(lower));
+
+		JoinCondition upper;
+		upper.comparison = ExpressionType::COMPARE_GREATERTHANOREQUALTO;
+		upper.left = BindDoubleArithmetic(context, "+", make_x(left_pred_expr), degrees);
+		upper.right = make_x(right_pred_expr);
+		new_join->conditions.push_back(std::move(upper));
+
+		new_join->children = std::move(any_join.children);
+		SetSpatialJoinCardinality(context, any_join, *new_join);
+
+		auto filter = make_uniq<LogicalFilter>(std::move(any_join.condition));
+		filter->estimated_cardinality = new_join->estimated_cardinality;
+		filter->has_estimated_cardinality = true;
+		filter->children.push_back(std::move(new_join));
+		return std::move(filter);
+	}
 
-				// Note that we cant perform this optimization for st_disjoint as all comparisons have to be AND'd
-				case_insensitive_set_t predicates = {"st_equals",    "st_intersects",      "st_touches",  "st_crosses",
-				                                     "st_within",    "st_contains",        "st_overlaps", "st_covers",
-				                                     "st_coveredby", "st_containsproperly"};
-
-				if (predicates.find(bound_function.function.name) != predicates.end()) {
-					// Found a spatial predicate we can optimize
-
-					// Convert this into a comparison join on st_xmin, st_xmax, st_ymin, st_ymax of the two input
-					// geometries
-					auto left_pred_expr = std::move(bound_function.children[0]);
-					auto right_pred_expr = std::move(bound_function.children[1]);
-
-					// We need to place the left side of the predicate on the left side of the join
-					// and the right side of the predicate on the right side of the join
-					// So look at the table indexes of the left and right side of the predicate
-					unordered_set<idx_t> left_table_indexes;
-					LogicalJoin::GetTableReferences(*any_join.children[0], left_table_indexes);
-
-					unordered_set<idx_t> right_table_indexes;
-					LogicalJoin::GetTableReferences(*any_join.children[1], right_table_indexes);
-
-					unordered_set<idx_t> left_pred_bindings;
-					LogicalJoin::GetExpressionBindings(*left_pred_expr, left_pred_bindings);
-
-					unordered_set<idx_t> right_pred_bindings;
-					LogicalJoin::GetExpressionBindings(*right_pred_expr, right_pred_bindings);
-
-					// Check if we can optimize this join
-					// We need to make sure that the left and right side of the predicate are disjoint
-					// e.g.
-					// 		a JOIN b ON st_intersects(a.geom, b.geom) 						=> OK
-					//		a JOIN b ON st_intersects(b.geom, a.geom)				 		=> OK
-					//		a JOIN b ON st_intersects(a.geom, st_union(a.geom, b.geom)) 	=> NOT OK
-					auto can_split = IsTableRefsDisjoint(left_table_indexes, right_table_indexes, left_pred_bindings,
-					                                     right_pred_bindings);
-					if (!can_split) {
-						// Try again with the left and right side of the predicate swapped
-						// We can safely swap because the intersection operation we encode with the comparison join
-						// is symmetric, so the order of the arguments wont matter in the "new" join condition we're
-						// about to create.
-						can_split = IsTableRefsDisjoint(left_table_indexes, right_table_indexes, right_pred_bindings,
-						                                left_pred_bindings);
-						if (!can_split) {
-							// We cant optimize this join
-							return;
-						}
-						// Swap the left and right side of the predicate
-						std::swap(left_pred_expr, right_pred_expr);
+	// Rewrites a join on ST_KNN(a, b, k) into a k-nearest-neighbour spatial join, where the side of the first
+	// argument is the probe side. Afterwards no ST_KNN call may remain, as it can not be evaluated on its own.
+	static void TryCreateKNNJoin(ClientContext &context, unique_ptr<LogicalOperator> &plan, LogicalAnyJoin &any_join,
+	                             BoundFunctionExpression &knn_func) {
+		if (knn_func.children.size() != 3 || !knn_func.children[2]->IsFoldable()) {
+			return;
+		}
+		Value k_value;
+		if (!ExpressionExecutor::TryEvaluateScalar(context, *knn_func.children[2], k_value) || k_value.IsNull() ||
+		    !k_value.DefaultTryCastAs(LogicalType::BIGINT)) {
+			return;
+		}
+		auto k = k_value.GetValue<int64_t>();
+		if (k <= 0) {
+			throw InvalidInputException("ST_KNN: k must be a positive integer");
+		}
+
+		unordered_set<idx_t> left_table_indexes;
+		LogicalJoin::GetTableReferences(*any_join.children[0], left_table_indexes);
+		unordered_set<idx_t> right_table_indexes;
+		LogicalJoin::GetTableReferences(*any_join.children[1], right_table_indexes);
+
+		unordered_set<idx_t> probe_bindings;
+		LogicalJoin::GetExpressionBindings(*knn_func.children[0], probe_bindings);
+		unordered_set<idx_t> build_bindings;
+		LogicalJoin::GetExpressionBindings(*knn_func.children[1], build_bindings);
+
+		auto swap_sides = false;
+		if (!IsTableRefsDisjoint(left_table_indexes, right_table_indexes, probe_bindings, build_bindings)) {
+			if (!IsTableRefsDisjoint(right_table_indexes, left_table_indexes, probe_bindings, build_bindings)) {
+				return;
+			}
+			swap_sides = true;
+		}
+
+		auto knn_join = make_uniq<LogicalSpatialJoin>(JoinType::INNER);
+		knn_join->children = std::move(any_join.children);
+		if (swap_sides) {
+			std::swap(knn_join->children[0], knn_join->children[1]);
+		}
+		knn_join->k = static_cast<idx_t>(k);
+		SetSpatialJoinCardinality(context, any_join, *knn_join, knn_join->k);
+		knn_join->expressions.push_back(std::move(knn_func.children[0]));
+		knn_join->expressions.push_back(std::move(knn_func.children[1]));
+
+		plan = std::move(knn_join);
+	}
+
+	// Returns a copy of the spatial predicate function of a join condition, or nullptr if it is not one.
+	// NOT st_disjoint(a, b) is returned as st_intersects(a, b).
+	static unique_ptr<Expression> GetSpatialPredicate(Expression &condition) {
+		if (condition.type == ExpressionType::BOUND_FUNCTION) {
+			return condition.Copy();
+		}
+		if (condition.type != ExpressionType::OPERATOR_NOT) {
+			return nullptr;
+		}
+		auto &not_expr = condition.Cast<BoundOperatorExpression>();
+		if (not_expr.children.size() != 1 || not_expr.children[0]->type != ExpressionType::BOUND_FUNCTION) {
+			return nullptr;
+		}
+		auto &func = not_expr.children[0]->Cast<BoundFunctionExpression>();
+		if (!StringUtil::CIEquals(func.function.name, "st_disjoint")) {
+			return nullptr;
+		}
+		auto result = func.Copy();
+		result->Cast<BoundFunctionExpression>().function.name = "st_intersects";
+		return result;
+	}
+
+	// The conjuncts of a join condition, or the condition itself if it is not a conjunction
+	static void GetConjuncts(Expression &condition, vector<reference<Expression>> &result) {
+		if (condition.type != ExpressionType::CONJUNCTION_AND) {
+			result.push_back(condition);
+			return;
+		}
+		for (auto &child : condition.Cast<BoundConjunctionExpression>().children) {
+			GetConjuncts(*child, result);
+		}
+	}
+
+	static bool IsRewriteEnabled(ClientContext &context) {
+		Value rewrite;
+		return !context.TryGetCurrentSetting("spatial_join_rewrite", rewrite) || rewrite.IsNull() ||
+		       rewrite.GetValue<bool>();
+	}
+
+	// A spatial predicate between the two sides of a join, with its arguments split by side
+	struct SpatialPredicateMatch {
+		unique_ptr<Expression> left;
+		unique_ptr<Expression> right;
+		double distance = 0;
+		bool is_dwithin = false;
+		bool is_dwithin_spheroid = false;
+	};
+
+	// Matches a predicate that implies an intersection of the bounding boxes of an argument from each side of the
+	// join (once expanded by the distance of a distance predicate)
+	static bool MatchSpatialPredicate(ClientContext &context, Expression &condition, LogicalOperator &left,
+	                                  LogicalOperator &right, SpatialPredicateMatch &match) {
+		auto bound_func_expr = GetSpatialPredicate(condition);
+		if (!bound_func_expr) {
+			return false;
+		}
+		auto &bound_function = bound_func_expr->Cast<BoundFunctionExpression>();
+
+		// Note that we cant perform this optimization for st_disjoint as all comparisons have to be AND'd
+		case_insensitive_set_t predicates = {"st_equals",    "st_intersects",      "st_touches",  "st_crosses",
+		                                     "st_within",    "st_contains",        "st_overlaps", "st_covers",
+		                                     "st_coveredby", "st_containsproperly"};
+
+		// Distance predicates imply an intersection of the bounding boxes once expanded by the distance
+		// (a lower bound of the distance in degrees for ST_DWithin_Spheroid), as long as it is constant.
+		match.is_dwithin = StringUtil::CIEquals(bound_function.function.name, "st_dwithin");
+		match.is_dwithin_spheroid = StringUtil::CIEquals(bound_function.function.name, "st_dwithin_spheroid");
+		auto is_distance_predicate = match.is_dwithin || match.is_dwithin_spheroid;
+
+		if (is_distance_predicate && (bound_function.children.size() != 3 ||
+		                              !TryGetConstantDistance(context, *bound_function.children[2], match.distance))) {
+			return false;
+		}
+		if (!is_distance_predicate && predicates.find(bound_function.function.name) == predicates.end()) {
+			return false;
+		}
+
+		auto left_pred_expr = std::move(bound_function.children[0]);
+		auto right_pred_expr = std::move(bound_function.children[1]);
+
+		// We need to place the left side of the predicate on the left side of the join
+		// and the right side of the predicate on the right side of the join
+		// So look at the table indexes of the left and right side of the predicate
+		unordered_set<idx_t> left_table_indexes;
+		LogicalJoin::GetTableReferences(left, left_table_indexes);
+
+		unordered_set<idx_t> right_table_indexes;
+		LogicalJoin::GetTableReferences(right, right_table_indexes);
+
+		unordered_set<idx_t> left_pred_bindings;
+		LogicalJoin::GetExpressionBindings(*left_pred_expr, left_pred_bindings);
+
+		unordered_set<idx_t> right_pred_bindings;
+		LogicalJoin::GetExpressionBindings(*right_pred_expr, right_pred_bindings);
+
+		// Check if we can optimize this join
+		// We need to make sure that the left and right side of the predicate are disjoint
+		// e.g.
+		// 		a JOIN b ON st_intersects(a.geom, b.geom) 						=> OK
+		//		a JOIN b ON st_intersects(b.geom, a.geom)				 		=> OK
+		//		a JOIN b ON st_intersects(a.geom, st_union(a.geom, b.geom)) 	=> NOT OK
+		auto can_split =
+		    IsTableRefsDisjoint(left_table_indexes, right_table_indexes, left_pred_bindings, right_pred_bindings);
+		if (!can_split) {
+			// Try again with the left and right side of the predicate swapped
+			// We can safely swap because the intersection operation we encode with the comparison join
+			// is symmetric, so the order of the arguments wont matter in the "new" join condition we're
+			// about to create.
+			can_split =
+			    IsTableRefsDisjoint(left_table_indexes, right_table_indexes, right_pred_bindings, left_pred_bindings);
+			if (!can_split) {
+				// We cant optimize this join
+				return false;
+			}
+			// Swap the left and right side of the predicate
+			std::swap(left_pred_expr, right_pred_expr);
+		}
+
+		match.left = std::move(left_pred_expr);
+		match.right = std::move(right_pred_expr);
+		return true;
+	}
+
+	//------------------------------------------------------------------------------
+	// Time Band
+	//------------------------------------------------------------------------------
+	// Besides the spatial predicate, the condition of a spatiotemporal join bounds the difference between a time on
+	// each side, e.g. for "within 50 m and 5 minutes":
+	//
+	//		ST_DWithin(a.geom, b.geom, 50) AND a.ts BETWEEN b.ts - INTERVAL 5 MINUTE AND b.ts + INTERVAL 5 MINUTE
+	//		ST_DWithin(a.geom, b.geom, 50) AND abs(epoch(a.ts) - epoch(b.ts)) <= 300
+	//
+	// The comparisons are collected into a band on left - right, which the spatial join uses to prune on time as
+	// well. The times are TIMESTAMPs (offset by constant intervals without months) or numbers (offset by constant
+	// numbers). Comparisons that do not fit are still evaluated by the filter, like the whole condition.
+
+	// One side of a comparison: an expression plus a constant offset, e.g. b.ts - INTERVAL 5 MINUTE
+	struct TimeTerm {
+		optional_ptr<Expression> base;
+		double offset = 0;
+		bool has_interval = false;
+		bool has_number = false;
+		// Whole days are not a fixed number of microseconds in a time zone
+		bool has_days = false;
+	};
+
+	struct TimeBand {
+		optional_ptr<Expression> left;
+		optional_ptr<Expression> right;
+		double lower = -std::numeric_limits<double>::infinity();
+		double upper = std::numeric_limits<double>::infinity();
+	};
+
+	static bool TryGetTimeOffset(ClientContext &context, Expression &expr, TimeTerm &term, double &offset) {
+		Value value;
+		if (!ExpressionExecutor::TryEvaluateScalar(context, expr, value) || value.IsNull()) {
+			return false;
+		}
+		if (value.type().id() == LogicalTypeId::INTERVAL) {
+			auto interval = IntervalValue::Get(value);
+			if (interval.months != 0) {
+				return false;
+			}
+			term.has_interval = true;
+			term.has_days = term.has_days || interval.days != 0;
+			offset = static_cast<double>(interval.micros) +
+			         static_cast<double>(interval.days) * static_cast<double>(Interval::MICROS_PER_DAY);
+			return true;
+		}
+		if (!value.type().IsNumeric() || !value.DefaultTryCastAs(LogicalType::DOUBLE)) {
+			return false;
+		}
+		term.has_number = true;
+		offset = value.GetValue<double>();
+		return std::isfinite(offset);
+	}
+
+	static bool TryParseTimeTerm(ClientContext &context, Expression &expr, TimeTerm &term) {
+		if (expr.IsFoldable()) {
+			return false;
+		}
+		if (expr.type == ExpressionType::BOUND_FUNCTION) {
+			auto &func = expr.Cast<BoundFunctionExpression>();
+			auto is_plus = func.function.name == "+";
+			auto is_minus = func.function.name == "-";
+			if ((is_plus || is_minus) && func.children.size() == 2) {
+				auto &first = *func.children[0];
+				auto &second = *func.children[1];
+				double offset;
+				if (second.IsFoldable()) {
+					if (!TryGetTimeOffset(context, second, term, offset) || !TryParseTimeTerm(context, first, term)) {
+						return false;
 					}
+					term.offset += is_plus ? offset : -offset;
+					return true;
+				}
+				if (is_plus && first.IsFoldable()) {
+					if (!TryGetTimeOffset(context, first, term, offset) || !TryParseTimeTerm(context, second, term)) {
+						return false;
+					}
+					term.offset += offset;
+					return true;
+				}
+			}
+		}
+		term.base = &expr;
+		return true;
+	}
+
+	static bool IsTimeKey(const TimeTerm &term) {
+		auto &type = term.base->return_type;
+		switch (type.id()) {
+		case LogicalTypeId::TIMESTAMP:
+			return !term.has_number;
+		case LogicalTypeId::TIMESTAMP_TZ:
+			return !term.has_number && !term.has_days;
+		default:
+			return type.IsNumeric() && !term.has_interval;
+		}
+	}
+
+	// Narrows the band with p - q in [lower, upper], where p and q are a term on each side of the join
+	static bool AddTimeDifference(ClientContext &context, Expression &p_expr, Expression &q_expr, double lower,
+	                              double upper, const unordered_set<idx_t> &left_tables, TimeBand &band) {
+		TimeTerm p;
+		TimeTerm q;
+		if (!TryParseTimeTerm(context, p_expr, p) || !TryParseTimeTerm(context, q_expr, q)) {
+			return false;
+		}
+		if (!IsTimeKey(p) || !IsTimeKey(q) || p.base->return_type != q.base->return_type) {
+			return false;
+		}
+		// (p + p.offset) - (q + q.offset) in [lower, upper]
+		lower += q.offset - p.offset;
+		upper += q.offset - p.offset;
+
+		unordered_set<idx_t> p_bindings;
+		LogicalJoin::GetExpressionBindings(*p.base, p_bindings);
+		unordered_set<idx_t> q_bindings;
+		LogicalJoin::GetExpressionBindings(*q.base, q_bindings);
+		if (p_bindings.empty() || q_bindings.empty()) {
+			return false;
+		}
+		auto on_left = [&](const unordered_set<idx_t> &bindings) {
+			for (auto &binding : bindings) {
+				if (left_tables.find(binding) == left_tables.end()) {
+					return false;
+				}
+			}
+			return true;
+		};
+		auto p_left = on_left(p_bindings);
+		auto q_left = on_left(q_bindings);
+		if (p_left == q_left) {
+			return false;
+		}
+		if (!p_left) {
+			std::swap(p, q);
+			std::swap(lower, upper);
+			lower = -lower;
+			upper = -upper;
+		}
+
+		// Only the first pair of times is used
+		if (band.left) {
+			if (!band.left->Equals(*p.base) || !band.right->Equals(*q.base)) {
+				return false;
+			}
+		} else {
+			band.left = p.base;
+			band.right = q.base;
+		}
+		band.lower = MaxValue(band.lower, lower);
+		band.upper = MinValue(band.upper, upper);
+		return true;
+	}
+
+	static void AddTimeComparison(ClientContext &context, ExpressionType comparison, Expression &left,
+	                              Expression &right, const unordered_set<idx_t> &left_tables, TimeBand &band) {
+		auto infinity = std::numeric_limits<double>::infinity();
+		switch (comparison) {
+		case ExpressionType::COMPARE_LESSTHAN:
+		case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+			AddTimeDifference(context, left, right, -infinity, 0, left_tables, band);
+			break;
+		case ExpressionType::COMPARE_GREATERTHAN:
+		case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+			AddTimeDifference(context, left, right, 0, infinity, left_tables, band);
+			break;
+		default:
+			break;
+		}
+	}
+
+	// abs(p - q) <= c
+	static void AddAbsoluteTimeComparison(ClientContext &context, Expression &abs_expr, Expression &limit,
+	                                      const unordered_set<idx_t> &left_tables, TimeBand &band) {
+		if (abs_expr.type != ExpressionType::BOUND_FUNCTION || !limit.IsFoldable()) {
+			return;
+		}
+		auto &abs_func = abs_expr.Cast<BoundFunctionExpression>();
+		if (abs_func.function.name != "abs" || abs_func.children.size() != 1 ||
+		    abs_func.children[0]->type != ExpressionType::BOUND_FUNCTION) {
+			return;
+		}
+		auto &difference = abs_func.children[0]->Cast<BoundFunctionExpression>();
+		if (difference.function.name != "-" || difference.children.size() != 2) {
+			return;
+		}
+		Value value;
+		if (!ExpressionExecutor::TryEvaluateScalar(context, limit, value) || value.IsNull() ||
+		    !value.type().IsNumeric() || !value.DefaultTryCastAs(LogicalType::DOUBLE)) {
+			return;
+		}
+		auto max_difference = value.GetValue<double>();
+		if (!std::isfinite(max_difference)) {
+			return;
+		}
+		AddTimeDifference(context, *difference.children[0], *difference.children[1], -max_difference, max_difference,
+		                  left_tables, band);
+	}
+
+	static bool TryExtractTimeBand(ClientContext &context, const vector<reference<Expression>> &conjuncts,
+	                               LogicalOperator &left, TimeBand &band) {
+		unordered_set<idx_t> left_tables;
+		LogicalJoin::GetTableReferences(left, left_tables);
+
+		for (auto &conjunct_ref : conjuncts) {
+			auto &conjunct = conjunct_ref.get();
+			if (conjunct.GetExpressionClass() == ExpressionClass::BOUND_BETWEEN) {
+				auto &between = conjunct.Cast<BoundBetweenExpression>();
+				AddTimeComparison(context, ExpressionType::COMPARE_LESSTHANOREQUALTO, *between.lower,
+				                  *between.input, left_tables, band);
+				AddTimeComparison(context, ExpressionType::COMPARE_LESSTHANOREQUALTO, *between.input,
+				                  *between.upper, left_tables, band);
+				continue;
+			}
+			if (conjunct.GetExpressionClass() != ExpressionClass::BOUND_COMPARISON) {
+				continue;
+			}
+			auto &comparison = conjunct.Cast<BoundComparisonExpression>();
+			if (comparison.type == ExpressionType::COMPARE_LESSTHAN ||
+			    comparison.type == ExpressionType::COMPARE_LESSTHANOREQUALTO) {
+				AddAbsoluteTimeComparison(context, *comparison.left, *comparison.right, left_tables, band);
+			} else if (comparison.type == ExpressionType::COMPARE_GREATERTHAN ||
+			           comparison.type == ExpressionType::COMPARE_GREATERTHANOREQUALTO) {
+				AddAbsoluteTimeComparison(context, *comparison.right, *comparison.left, left_tables, band);
+			}
+			AddTimeComparison(context, comparison.type, *comparison.left, *comparison.right, left_tables, band);
+		}
+		return band.left && (std::isfinite(band.lower) || std::isfinite(band.upper));
+	}
+
+	// The key of a time, TIMESTAMPs are compared in microseconds and numbers as DOUBLE
+	static unique_ptr<Expression> CreateTimeKey(ClientContext &context, Expression &base) {
+		auto type = base.return_type.id();
+		if (type == LogicalTypeId::TIMESTAMP || type == LogicalTypeId::TIMESTAMP_TZ) {
+			return base.Copy();
+		}
+		return BoundCastExpression::AddCastToType(context, base.Copy(), LogicalType::DOUBLE);
+	}
+
+	//------------------------------------------------------------------------------
+	// Comparison Join Merge
+	//------------------------------------------------------------------------------
+	// A join on a spatial predicate and a time band on plain comparisons, e.g. a.ts >= b.ts - INTERVAL 5 MINUTE, is
+	// planned as an inequality join on the comparisons with the spatial predicate in a filter on top, which leaves
+	// the space to the filter. Merge them back into one join on all of the conditions, which is then planned as a
+	// spatial join with a time band below the same filter. The filter keeps the columns the inequality join had
+	// projected out.
+	static void TryMergeComparisonJoin(ClientContext &context, unique_ptr<LogicalOperator> &plan) {
+		auto &filter = plan->Cast<LogicalFilter>();
+		if (filter.children.size() != 1 || filter.children[0]->type != LogicalOperatorType::LOGICAL_COMPARISON_JOIN) {
+			return;
+		}
+		auto &join = filter.children[0]->Cast<LogicalComparisonJoin>();
+		if (join.join_type != JoinType::INNER || join.conditions.empty()) {
+			return;
+		}
+
+		vector<unique_ptr<Expression>> expressions;
+		for (auto &expr : filter.expressions) {
+			expressions.push_back(expr->Copy());
+		}
+		for (auto &condition : join.conditions) {
+			switch (condition.comparison) {
+			case ExpressionType::COMPARE_LESSTHAN:
+			case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+			case ExpressionType::COMPARE_GREATERTHAN:
+			case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+				break;
+			default:
+				// Equi-joins are better off as hash joins
+				return;
+			}
+			expressions.push_back(make_uniq<BoundComparisonExpression>(condition.comparison, condition.left->Copy(),
+			                                                           condition.right->Copy()));
+		}
+		vector<reference<Expression>> conjuncts;
+		for (auto &expr : expressions) {
+			conjuncts.push_back(*expr);
+		}
+
+		// The first spatial predicate is the one the join is planned on, it has to become a spatial join
+		auto &left = *join.children[0];
+		auto &right = *join.children[1];
+		SpatialPredicateMatch match;
+		bool found = false;
+		for (auto &conjunct : conjuncts) {
+			if (MatchSpatialPredicate(context, conjunct, left, right, match)) {
+				found = true;
+				break;
+			}
+		}
+		TimeBand band;
+		if (!found || match.left->return_type != GeoTypes::GEOMETRY() ||
+		    match.right->return_type != GeoTypes::GEOMETRY() || !TryExtractTimeBand(context, conjuncts, left, band)) {
+			return;
+		}
 
-					// Lookup the st_xmin, st_xmax, st_ymin, st_ymax functions in the catalog
-					auto &catalog = Catalog::GetSystemCatalog(context);
-					auto &xmin_func_set =
-					    catalog.GetEntry(context, CatalogType::SCALAR_FUNCTION_ENTRY, DEFAULT_SCHEMA, "st_xmin")
-					        .Cast<ScalarFunctionCatalogEntry>();
-					auto &xmax_func_set =
-					    catalog.GetEntry(context, CatalogType::SCALAR_FUNCTION_ENTRY, DEFAULT_SCHEMA, "st_xmax")
-					        .Cast<ScalarFunctionCatalogEntry>();
-					auto &ymin_func_set =
-					    catalog.GetEntry(context, CatalogType::SCALAR_FUNCTION_ENTRY, DEFAULT_SCHEMA, "st_ymin")
-					        .Cast<ScalarFunctionCatalogEntry>();
-					auto &ymax_func_set =
-					    catalog.GetEntry(context, CatalogType::SCALAR_FUNCTION_ENTRY, DEFAULT_SCHEMA, "st_ymax")
-					        .Cast<ScalarFunctionCatalogEntry>();
-
-					auto &left_arg_type = left_pred_expr->return_type;
-					auto &right_arg_type = right_pred_expr->return_type;
-
-					auto xmin_func_left = xmin_func_set.functions.GetFunctionByArguments(context, {left_arg_type});
-					auto xmax_func_left = xmax_func_set.functions.GetFunctionByArguments(context, {left_arg_type});
-					auto ymin_func_left = ymin_func_set.functions.GetFunctionByArguments(context, {left_arg_type});
-					auto ymax_func_left = ymax_func_set.functions.GetFunctionByArguments(context, {left_arg_type});
-
-					auto xmin_func_right = xmin_func_set.functions.GetFunctionByArguments(context, {right_arg_type});
-					auto xmax_func_right = xmax_func_set.functions.GetFunctionByArguments(context, {right_arg_type});
-					auto ymin_func_right = ymin_func_set.functions.GetFunctionByArguments(context, {right_arg_type});
-					auto ymax_func_right = ymax_func_set.functions.GetFunctionByArguments(context, {right_arg_type});
-
-					// Create the new join condition
-
-					// Left
-					vector<unique_ptr<Expression>> left_xmin_args;
-					left_xmin_args.push_back(left_pred_expr->Copy());
-					auto a_x_min = make_uniq<BoundFunctionExpression>(LogicalType::DOUBLE, std::move(xmin_func_left),
-					                                                  std::move(left_xmin_args), nullptr);
-
-					vector<unique_ptr<Expression>> left_xmax_args;
-					left_xmax_args.push_back(left_pred_expr->Copy());
-					auto a_x_max = make_uniq<BoundFunctionExpression>(LogicalType::DOUBLE, std::move(xmax_func_left),
-					                                                  std::move(left_xmax_args), nullptr);
-
-					vector<unique_ptr<Expression>> left_ymin_args;
-					left_ymin_args.push_back(left_pred_expr->Copy());
-					auto a_y_min = make_uniq<BoundFunctionExpression>(LogicalType::DOUBLE, std::move(ymin_func_left),
-					                                                  std::move(left_ymin_args), nullptr);
-
-					vector<unique_ptr<Expression>> left_ymax_args;
-					left_ymax_args.push_back(left_pred_expr->Copy());
-					auto a_y_max = make_uniq<BoundFunctionExpression>(LogicalType::DOUBLE, std::move(ymax_func_left),
-					                                                  std::move(left_ymax_args), nullptr);
-
-					// Right
-					vector<unique_ptr<Expression>> right_xmin_args;
-					right_xmin_args.push_back(right_pred_expr->Copy());
-					auto b_x_min = make_uniq<BoundFunctionExpression>(LogicalType::DOUBLE, std::move(xmin_func_right),
-					                                                  std::move(right_xmin_args), nullptr);
-
-					vector<unique_ptr<Expression>> right_xmax_args;
-					right_xmax_args.push_back(right_pred_expr->Copy());
-					auto b_x_max = make_uniq<BoundFunctionExpression>(LogicalType::DOUBLE, std::move(xmax_func_right),
-					                                                  std::move(right_xmax_args), nullptr);
-
-					vector<unique_ptr<Expression>> right_ymin_args;
-					right_ymin_args.push_back(right_pred_expr->Copy());
-					auto b_y_min = make_uniq<BoundFunctionExpression>(LogicalType::DOUBLE, std::move(ymin_func_right),
-					                                                  std::move(right_ymin_args), nullptr);
-
-					vector<unique_ptr<Expression>> right_ymax_args;
-					right_ymax_args.push_back(right_pred_expr->Copy());
-					auto b_y_max = make_uniq<BoundFunctionExpression>(LogicalType::DOUBLE, std::move(ymax_func_right),
-					                                                  std::move(right_ymax_args), nullptr);
-
-					// Now create the new join operator
-					auto new_join = make_uniq<LogicalComparisonJoin>(JoinType::INNER);
-					AddComparison(new_join, std::move(a_x_min), std::move(b_x_max),
-					              ExpressionType::COMPARE_LESSTHANOREQUALTO);
-					AddComparison(new_join, std::move(a_x_max), std::move(b_x_min),
-					              ExpressionType::COMPARE_GREATERTHANOREQUALTO);
-					AddComparison(new_join, std::move(a_y_min), std::move(b_y_max),
-					              ExpressionType::COMPARE_LESSTHANOREQUALTO);
-					AddComparison(new_join, std::move(a_y_max), std::move(b_y_min),
-					              ExpressionType::COMPARE_GREATERTHANOREQUALTO);
-
-					new_join->children = std::move(any_join.children);
-					if (any_join.has_estimated_cardinality) {
-						new_join->estimated_cardinality = any_join.estimated_cardinality;
-						new_join->has_estimated_cardinality = true;
+		// The columns the filter returns, the join below it is replaced by one that returns all of its inputs
+		auto bindings = filter.GetColumnBindings();
+
+		auto condition = make_uniq<BoundConjunctionExpression>(ExpressionType::CONJUNCTION_AND);
+		for (auto &expr : expressions) {
+			condition->children.push_back(std::move(expr));
+		}
+		auto any_join = make_uniq<LogicalAnyJoin>(JoinType::INNER);
+		any_join->condition = std::move(condition);
+		any_join->children = std::move(join.children);
+		any_join->estimated_cardinality = join.estimated_cardinality;
+		any_join->has_estimated_cardinality = join.has_estimated_cardinality;
+
+		unique_ptr<LogicalOperator> result = std::move(any_join);
+		TryOptimizeAnyJoin(context, result);
+		D_ASSERT(result->type == LogicalOperatorType::LOGICAL_FILTER);
+		auto &new_filter = result->Cast<LogicalFilter>();
+		auto join_bindings = new_filter.children[0]->GetColumnBindings();
+		if (join_bindings != bindings) {
+			for (auto &binding : bindings) {
+				auto entry = std::find(join_bindings.begin(), join_bindings.end(), binding);
+				D_ASSERT(entry != join_bindings.end());
+				new_filter.projection_map.push_back(static_cast<idx_t>(entry - join_bindings.begin()));
+			}
+		}
+		plan = std::move(result);
+	}
+
+	static void TryOptimizeAnyJoin(ClientContext &context, unique_ptr<LogicalOperator> &plan) {
+		auto &any_join = plan->Cast<LogicalAnyJoin>();
+
+		// Non-inner joins can only be planned as a spatial join, which evaluates the predicate itself
+		auto join_type = any_join.join_type;
+		if (join_type != JoinType::INNER && join_type != JoinType::LEFT && join_type != JoinType::SEMI &&
+		    join_type != JoinType::ANTI) {
+			return;
+		}
+
+		// ST_KNN can not be combined with other conditions, as they would change which rows are the nearest
+		vector<reference<Expression>> conjuncts;
+		GetConjuncts(*any_join.condition, conjuncts);
+		if (conjuncts.size() == 1) {
+			auto bound_func_expr = GetSpatialPredicate(*any_join.condition);
+			if (bound_func_expr) {
+				auto &bound_function = bound_func_expr->Cast<BoundFunctionExpression>();
+				if (StringUtil::CIEquals(bound_function.function.name, "st_knn")) {
+					if (join_type == JoinType::INNER) {
+						TryCreateKNNJoin(context, plan, any_join, bound_function);
 					}
+					return;
+				}
+			}
+		}
 
-					auto filter = make_uniq<LogicalFilter>(std::move(any_join.condition));
-					filter->children.push_back(std::move(new_join));
+		if (!IsRewriteEnabled(context)) {
+			return;
+		}
+
+		// The condition is a spatial predicate, or a conjunction of one with other conditions (e.g. a time band)
+		SpatialPredicateMatch match;
+		bool found = false;
+		for (auto &conjunct : conjuncts) {
+			if (MatchSpatialPredicate(context, conjunct, *any_join.children[0], *any_join.children[1], match)) {
+				found = true;
+				break;
+			}
+		}
+		if (!found) {
+			return;
+		}
+
+		// Found a spatial predicate we can optimize
+		auto left_pred_expr = std::move(match.left);
+		auto right_pred_expr = std::move(match.right);
+		auto distance = match.distance;
+
+		if (left_pred_expr->return_type == GeoTypes::GEOMETRY() &&
+		    right_pred_expr->return_type == GeoTypes::GEOMETRY()) {
+			// Plan a spatial join instead
+			auto spatial_join = make_uniq<LogicalSpatialJoin>(join_type);
+			spatial_join->children = std::move(any_join.children);
+			spatial_join->distance = distance;
 
-					plan = std::move(filter);
+			// The R-tree is built on the right side, so make sure the right side is the cheaper one to build on, by
+			// the number of rows and the complexity of the geometries on each side.
+			// This is always fine for inner joins as all the columns are referenced by their bindings.
+			// Other join types always probe with the left side, as that is the side they return rows of.
+			if (join_type == JoinType::INNER) {
+				if (ShouldBuildOnLeft(context, *spatial_join->children[0], *left_pred_expr, *spatial_join->children[1],
+				                      *right_pred_expr)) {
+					std::swap(spatial_join->children[0], spatial_join->children[1]);
+					std::swap(left_pred_expr, right_pred_expr);
 				}
 			}
+
+			Value partition_threshold;
+			if (context.TryGetCurrentSetting("spatial_join_partition_threshold", partition_threshold)) {
+				spatial_join->partition_threshold = partition_threshold.GetValue<idx_t>();
+			}
+
+			spatial_join->expressions.push_back(std::move(left_pred_expr));
+			spatial_join->expressions.push_back(std::move(right_pred_expr));
+			SetSpatialJoinCardinality(context, any_join, *spatial_join);
+
+			// Prune on time as well if the other conditions bound a time on each side
+			TimeBand band;
+			if (TryExtractTimeBand(context, conjuncts, *spatial_join->children[0], band)) {
+				spatial_join->has_time_band = true;
+				spatial_join->time_lower = band.lower;
+				spatial_join->time_upper = band.upper;
+				spatial_join->expressions.push_back(CreateTimeKey(context, *band.left));
+				spatial_join->expressions.push_back(CreateTimeKey(context, *band.right));
+			}
+
+			if (join_type != JoinType::INNER) {
+				// The join has to know which pairs match, so evaluate the predicate in the join
+				spatial_join->expressions.push_back(std::move(any_join.condition));
+				plan = std::move(spatial_join);
+				return;
+			}
+
+			auto filter = make_uniq<LogicalFilter>(std::move(any_join.condition));
+			filter->estimated_cardinality = spatial_join->estimated_cardinality;
+			filter->has_estimated_cardinality = true;
+			filter->children.push_back(std::move(spatial_join));
+
+			plan = std::move(filter);
+			return;
+		}
+
+		if (join_type != JoinType::INNER) {
+			// The rewrites below add a filter on top of the join, which only works for inner joins
+			return;
+		}
+
+		auto &catalog = Catalog::GetSystemCatalog(context);
+
+		if (match.is_dwithin_spheroid) {
+			plan = CreateSpheroidDistanceJoin(context, any_join, std::move(left_pred_expr), std::move(right_pred_expr),
+			                                  distance);
+			return;
+		}
+
+		if (match.is_dwithin) {
+			// Only GEOMETRY is supported, which is always planned as a spatial join
+			return;
+		}
+
+		// Lookup the st_xmin, st_xmax, st_ymin, st_ymax functions in the catalog
+		auto &xmin_func_set =
+		    catalog.GetEntry(context, CatalogType::SCALAR_FUNCTION_ENTRY, DEFAULT_SCHEMA, "st_xmin")
+		        .Cast<ScalarFunctionCatalogEntry>();
+		auto &xmax_func_set =
+		    catalog.GetEntry(context, CatalogType::SCALAR_FUNCTION_ENTRY, DEFAULT_SCHEMA, "st_xmax")
+		        .Cast<ScalarFunctionCatalogEntry>();
+		auto &ymin_func_set =
+		    catalog.GetEntry(context, CatalogType::SCALAR_FUNCTION_ENTRY, DEFAULT_SCHEMA, "st_ymin")
+		        .Cast<ScalarFunctionCatalogEntry>();
+		auto &ymax_func_set =
+		    catalog.GetEntry(context, CatalogType::SCALAR_FUNCTION_ENTRY, DEFAULT_SCHEMA, "st_ymax")
+		        .Cast<ScalarFunctionCatalogEntry>();
+
+		auto &left_arg_type = left_pred_expr->return_type;
+		auto &right_arg_type = right_pred_expr->return_type;
+
+		auto xmin_func_left = xmin_func_set.functions.GetFunctionByArguments(context, {left_arg_type});
+		auto xmax_func_left = xmax_func_set.functions.GetFunctionByArguments(context, {left_arg_type});
+		auto ymin_func_left = ymin_func_set.functions.GetFunctionByArguments(context, {left_arg_type});
+		auto ymax_func_left = ymax_func_set.functions.GetFunctionByArguments(context, {left_arg_type});
+
+		auto xmin_func_right = xmin_func_set.functions.GetFunctionByArguments(context, {right_arg_type});
+		auto xmax_func_right = xmax_func_set.functions.GetFunctionByArguments(context, {right_arg_type});
+		auto ymin_func_right = ymin_func_set.functions.GetFunctionByArguments(context, {right_arg_type});
+		auto ymax_func_right = ymax_func_set.functions.GetFunctionByArguments(context, {right_arg_type});
+
+		// Create the new join condition
+
+		// Left
+		vector<unique_ptr<Expression>> left_xmin_args;
+		left_xmin_args.push_back(left_pred_expr->Copy());
+		auto a_x_min = make_uniq<BoundFunctionExpression>(LogicalType::DOUBLE, std::move(xmin_func_left),
+		                                                  std::move(left_xmin_args), nullptr);
+
+		vector<unique_ptr<Expression>> left_xmax_args;
+		left_xmax_args.push_back(left_pred_expr->Copy());
+		auto a_x_max = make_uniq<BoundFunctionExpression>(LogicalType::DOUBLE, std::move(xmax_func_left),
+		                                                  std::move(left_xmax_args), nullptr);
+
+		vector<unique_ptr<Expression>> left_ymin_args;
+		left_ymin_args.push_back(left_pred_expr->Copy());
+		auto a_y_min = make_uniq<BoundFunctionExpression>(LogicalType::DOUBLE, std::move(ymin_func_left),
+		                                                  std::move(left_ymin_args), nullptr);
+
+		vector<unique_ptr<Expression>> left_ymax_args;
+		left_ymax_args.push_back(left_pred_expr->Copy());
+		auto a_y_max = make_uniq<BoundFunctionExpression>(LogicalType::DOUBLE, std::move(ymax_func_left),
+		                                                  std::move(left_ymax_args), nullptr);
+
+		// Right
+		vector<unique_ptr<Expression>> right_xmin_args;
+		right_xmin_args.push_back(right_pred_expr->Copy());
+		auto b_x_min = make_uniq<BoundFunctionExpression>(LogicalType::DOUBLE, std::move(xmin_func_right),
+		                                                  std::move(right_xmin_args), nullptr);
+
+		vector<unique_ptr<Expression>> right_xmax_args;
+		right_xmax_args.push_back(right_pred_expr->Copy());
+		auto b_x_max = make_uniq<BoundFunctionExpression>(LogicalType::DOUBLE, std::move(xmax_func_right),
+		                                                  std::move(right_xmax_args), nullptr);
+
+		vector<unique_ptr<Expression>> right_ymin_args;
+		right_ymin_args.push_back(right_pred_expr->Copy());
+		auto b_y_min = make_uniq<BoundFunctionExpression>(LogicalType::DOUBLE, std::move(ymin_func_right),
+		                                                  std::move(right_ymin_args), nullptr);
+
+		vector<unique_ptr<Expression>> right_ymax_args;
+		right_ymax_args.push_back(right_pred_expr->Copy());
+		auto b_y_max = make_uniq<BoundFunctionExpression>(LogicalType::DOUBLE, std::move(ymax_func_right),
+		                                                  std::move(right_ymax_args), nullptr);
+
+		// Now create the new join operator
+		auto new_join = make_uniq<LogicalComparisonJoin>(JoinType::INNER);
+		AddComparison(new_join, std::move(a_x_min), std::move(b_x_max), ExpressionType::COMPARE_LESSTHANOREQUALTO);
+		AddComparison(new_join, std::move(a_x_max), std::move(b_x_min), ExpressionType::COMPARE_GREATERTHANOREQUALTO);
+		AddComparison(new_join, std::move(a_y_min), std::move(b_y_max), ExpressionType::COMPARE_LESSTHANOREQUALTO);
+		AddComparison(new_join, std::move(a_y_max), std::move(b_y_min), ExpressionType::COMPARE_GREATERTHANOREQUALTO);
+
+		new_join->children = std::move(any_join.children);
+		SetSpatialJoinCardinality(context, any_join, *new_join);
+
+		auto filter = make_uniq<LogicalFilter>(std::move(any_join.condition));
+		filter->estimated_cardinality = new_join->estimated_cardinality;
+		filter->has_estimated_cardinality = true;
+		filter->children.push_back(std::move(new_join));
+
+		plan = std::move(filter);
+	}
+
+	static void TryOptimize(ClientContext &context, OptimizerExtensionInfo *info, unique_ptr<LogicalOperator> &plan) {
+		auto &op = *plan;
+
+		// Look for ANY_JOIN operators
+		if (op.type == LogicalOperatorType::LOGICAL_ANY_JOIN) {
+			TryOptimizeAnyJoin(context, plan);
+			return;
+		}
+
+		// And for inequality joins with a spatial predicate in a filter on top
+		if (op.type == LogicalOperatorType::LOGICAL_FILTER && IsRewriteEnabled(context)) {
+			TryMergeComparisonJoin(context, plan);
 		}
 	}
 
@@ -251,6 +1054,625 @@ public:
 	}
 };
 
+//------------------------------------------------------------------------------
+// Spatial Filter Bounding Box Prefilter
+//------------------------------------------------------------------------------
+//
+//  Adds a cheap bounding box check in front of filters on spatial predicates
+//  against a constant geometry, e.g.
+//
+//		WHERE st_within(geom, <constant>)
+//	=>	WHERE st_intersects_extent(geom, <constant>) AND st_within(geom, <constant>)
+//
+//  st_intersects_extent only reads the bounding box from the header of the
+//  serialized geometry, so most rows can be rejected without deserializing them
+//  (or converting them to GEOS geometries) when the constant is small compared
+//  to the extent of the data.
+//
+class SpatialFilterBoundingBoxPrefilter : public OptimizerExtension {
+public:
+	SpatialFilterBoundingBoxPrefilter() {
+		optimize_function = SpatialFilterBoundingBoxPrefilter::Optimize;
+	}
+
+	// Returns true if the expression is a constant, non-empty geometry
+	static bool IsConstantGeometry(ClientContext &context, Expression &expr) {
+		if (expr.return_type != GeoTypes::GEOMETRY() || !expr.IsFoldable()) {
+			return false;
+		}
+		Value value;
+		if (!ExpressionExecutor::TryEvaluateScalar(context, expr, value) || value.IsNull()) {
+			return false;
+		}
+		BoundingBox bbox;
+		return GeometryFactory::TryGetSerializedBoundingBox(geometry_t(string_t(StringValue::Get(value))), bbox);
+	}
+
+	static unique_ptr<Expression> TryCreatePrefilter(ClientContext &context, Expression &expr) {
+		if (expr.type != ExpressionType::BOUND_FUNCTION) {
+			return nullptr;
+		}
+		auto &func = expr.Cast<BoundFunctionExpression>();
+
+		// Note that we cant perform this optimization for st_disjoint, as it is true if the boxes dont intersect
+		case_insensitive_set_t predicates = {"st_equals",    "st_intersects",      "st_touches",  "st_crosses",
+		                                     "st_within",    "st_contains",        "st_overlaps", "st_covers",
+		                                     "st_coveredby", "st_containsproperly"};
+		if (func.children.size() != 2 || predicates.find(func.function.name) == predicates.end()) {
+			return nullptr;
+		}
+
+		auto &left = func.children[0];
+		auto &right = func.children[1];
+		if (left->return_type != GeoTypes::GEOMETRY() || right->return_type != GeoTypes::GEOMETRY()) {
+			return nullptr;
+		}
+
+		// Exactly one side has to be constant, otherwise it will just be constant folded
+		auto left_constant = IsConstantGeometry(context, *left);
+		auto right_constant = IsConstantGeometry(context, *right);
+		if (left_constant == right_constant) {
+			return nullptr;
+		}
+
+		auto &catalog = Catalog::GetSystemCatalog(context);
+		auto &extent_func_set =
+		    catalog.GetEntry(context, CatalogType::SCALAR_FUNCTION_ENTRY, DEFAULT_SCHEMA, "st_intersects_extent")
+		        .Cast<ScalarFunctionCatalogEntry>();
+		auto extent_func = extent_func_set.functions.GetFunctionByArguments(
+		    context, {GeoTypes::GEOMETRY(), GeoTypes::GEOMETRY()});
+
+		vector<unique_ptr<Expression>> args;
+		args.push_back(left->Copy());
+		args.push_back(right->Copy());
+		return make_uniq<BoundFunctionExpression>(LogicalType::BOOLEAN, std::move(extent_func), std::move(args),
+		                                          nullptr);
+	}
+
+	static void TryOptimize(ClientContext &context, unique_ptr<LogicalOperator> &plan) {
+		if (plan->type != LogicalOperatorType::LOGICAL_FILTER) {
+			return;
+		}
+		auto &filter = plan->Cast<LogicalFilter>();
+
+		vector<unique_ptr<Expression>> prefilters;
+		for (auto &expr : filter.expressions) {
+			auto prefilter = TryCreatePrefilter(context, *expr);
+			if (prefilter) {
+				prefilters.push_back(std::move(prefilter));
+			}
+		}
+		if (prefilters.empty()) {
+			return;
+		}
+
+		// Put the prefilters first
+		for (auto &expr : filter.expressions) {
+			prefilters.push_back(std::move(expr));
+		}
+		filter.expressions = std::move(prefilters);
+	}
+
+	static void Optimize(ClientContext &context, OptimizerExtensionInfo *info, unique_ptr<LogicalOperator> &plan) {
+
+		TryOptimize(context, plan);
+
+		// Recursively optimize the children
+		for (auto &child : plan->children) {
+			Optimize(context, info, child);
+		}
+	}
+};
+
+//------------------------------------------------------------------------------
+// Spatial Predicate Fusion
+//------------------------------------------------------------------------------
+//
+//  Replaces several spatial predicates (or their negations) on the same pair of
+//  geometries in a filter with a single call that derives all of them from one
+//  DE-9IM intersection matrix, e.g.
+//
+//		WHERE st_intersects(a, b) AND NOT st_touches(a, b)
+//	=>	WHERE __internal_st_relate_predicates(a, b, 'st_intersects,!st_touches')
+//
+//  Each predicate would otherwise deserialize both geometries and compute the
+//  relation between them on its own. Predicates against a constant geometry are
+//  left alone, as they are evaluated on a prepared geometry instead.
+//
+class SpatialPredicateFusion : public OptimizerExtension {
+public:
+	SpatialPredicateFusion() {
+		optimize_function = SpatialPredicateFusion::Optimize;
+	}
+
+	// Returns the predicate function if the expression is a fusable predicate (or the negation of one)
+	static optional_ptr<BoundFunctionExpression> GetPredicate(Expression &expr, bool &negated) {
+		reference<Expression> inner = expr;
+		negated = false;
+		if (expr.type == ExpressionType::OPERATOR_NOT) {
+			auto &not_expr = expr.Cast<BoundOperatorExpression>();
+			if (not_expr.children.size() != 1) {
+				return nullptr;
+			}
+			inner = *not_expr.children[0];
+			negated = true;
+		}
+		if (inner.get().type != ExpressionType::BOUND_FUNCTION) {
+			return nullptr;
+		}
+		auto &func = inner.get().Cast<BoundFunctionExpression>();
+
+		case_insensitive_set_t predicates = {"st_equals",   "st_intersects", "st_disjoint",  "st_touches",
+		                                     "st_crosses",  "st_within",     "st_contains",  "st_overlaps",
+		                                     "st_covers",   "st_coveredby",  "st_containsproperly"};
+		if (func.children.size() != 2 || predicates.find(func.function.name) == predicates.end()) {
+			return nullptr;
+		}
+		auto &left = func.children[0];
+		auto &right = func.children[1];
+		if (left->return_type != GeoTypes::GEOMETRY() || right->return_type != GeoTypes::GEOMETRY()) {
+			return nullptr;
+		}
+		if (left->IsFoldable() || right->IsFoldable()) {
+			return nullptr;
+		}
+		return &func;
+	}
+
+	static void TryOptimize(ClientContext &context, unique_ptr<LogicalOperator> &plan) {
+		if (plan->type != LogicalOperatorType::LOGICAL_FILTER) {
+			return;
+		}
+		auto &filter = plan->Cast<LogicalFilter>();
+
+		// Group the predicates by their (ordered) pair of arguments
+		struct PredicateGroup {
+			idx_t first;
+			string spec;
+			vector<idx_t> members;
+		};
+		vector<PredicateGroup> groups;
+		for (idx_t i = 0; i < filter.expressions.size(); i++) {
+			bool negated;
+			auto func = GetPredicate(*filter.expressions[i], negated);
+			if (!func) {
+				continue;
+			}
+			auto term = (negated ? "!" : "") + StringUtil::Lower(func->function.name);
+			bool found = false;
+			for (auto &group : groups) {
+				bool group_negated;
+				auto &first = *GetPredicate(*filter.expressions[group.first], group_negated);
+				if (first.children[0]->Equals(*func->children[0]) && first.children[1]->Equals(*func->children[1])) {
+					group.spec += "," + term;
+					group.members.push_back(i);
+					found = true;
+					break;
+				}
+			}
+			if (!found) {
+				groups.push_back({i, term, {i}});
+			}
+		}
+
+		optional_ptr<ScalarFunctionCatalogEntry> fused_func_set;
+		vector<bool> removed(filter.expressions.size(), false);
+		for (auto &group : groups) {
+			if (group.members.size() < 2) {
+				continue;
+			}
+			if (!fused_func_set) {
+				auto &catalog = Catalog::GetSystemCatalog(context);
+				fused_func_set = &catalog
+				                      .GetEntry(context, CatalogType::SCALAR_FUNCTION_ENTRY, DEFAULT_SCHEMA,
+				                                "__internal_st_relate_predicates")
+				                      .Cast<ScalarFunctionCatalogEntry>();
+			}
+			auto fused_func = fused_func_set->functions.GetFunctionByArguments(
+			    context, {GeoTypes::GEOMETRY(), GeoTypes::GEOMETRY(), LogicalType::VARCHAR});
+
+			bool negated;
+			auto &first = *GetPredicate(*filter.expressions[group.first], negated);
+			vector<unique_ptr<Expression>> args;
+			args.push_back(first.children[0]->Copy());
+			args.push_back(first.children[1]->Copy());
+			args.push_back(make_uniq<BoundConstantExpression>(Value(group.spec)));
+			auto fused = make_uniq<BoundFunctionExpression>(LogicalType::BOOLEAN, std::move(fused_func),
+			                                                std::move(args), nullptr);
+
+			// Replace the first predicate of the group and drop the others
+			filter.expressions[group.first] = std::move(fused);
+			for (idx_t i = 1; i < group.members.size(); i++) {
+				removed[group.members[i]] = true;
+			}
+		}
+
+		vector<unique_ptr<Expression>> expressions;
+		for (idx_t i = 0; i < filter.expressions.size(); i++) {
+			if (!removed[i]) {
+				expressions.push_back(std::move(filter.expressions[i]));
+			}
+		}
+		filter.expressions = std::move(expressions);
+	}
+
+	static void Optimize(ClientContext &context, OptimizerExtensionInfo *info, unique_ptr<LogicalOperator> &plan) {
+
+		TryOptimize(context, plan);
+
+		// Recursively optimize the children
+		for (auto &child : plan->children) {
+			Optimize(context, info, child);
+		}
+	}
+};
+
+//------------------------------------------------------------------------------
+// Spatial Join Extent Pushdown
+//------------------------------------------------------------------------------
+//
+//  Connects an INNER or SEMI spatial join to the scan of its probe side, if
+//  the probe side geometry is a column that a table function such as ST_Read
+//  or ST_ReadSHP reads, possibly through projections and filters. Once the
+//  join has built its right side, it hands the extent of the right side to the
+//  scan, which only reads the features that intersect it. A feature outside of
+//  the extent can not match any row of the right side, so this only applies to
+//  joins that drop the rows of the left side without a match.
+//
+class SpatialJoinExtentPushdown : public OptimizerExtension {
+public:
+	SpatialJoinExtentPushdown() {
+		optimize_function = SpatialJoinExtentPushdown::Optimize;
+	}
+
+	// Follow a column through projections and filters down to the scan that produces it, and hand the filter to the
+	// scan. Returns false if the column is computed or the scan can not use the filter.
+	static bool TryPushdown(LogicalOperator &op, const ColumnBinding &binding,
+	                        const shared_ptr<DynamicSpatialFilter> &filter) {
+		switch (op.type) {
+		case LogicalOperatorType::LOGICAL_FILTER:
+			return TryPushdown(*op.children[0], binding, filter);
+		case LogicalOperatorType::LOGICAL_PROJECTION: {
+			auto &projection = op.Cast<LogicalProjection>();
+			if (projection.table_index != binding.table_index) {
+				return false;
+			}
+			auto &expr = *projection.expressions[binding.column_index];
+			if (expr.type != ExpressionType::BOUND_COLUMN_REF) {
+				return false;
+			}
+			return TryPushdown(*op.children[0], expr.Cast<BoundColumnRefExpression>().binding, filter);
+		}
+		case LogicalOperatorType::LOGICAL_GET: {
+			auto &get = op.Cast<LogicalGet>();
+			if (get.table_index != binding.table_index || !get.bind_data) {
+				return false;
+			}
+			auto target = dynamic_cast<DynamicSpatialFilterTarget *>(get.bind_data.get());
+			return target && target->TryAddDynamicFilter(get.column_ids[binding.column_index], filter);
+		}
+		default:
+			return false;
+		}
+	}
+
+	static void TryOptimize(LogicalOperator &op) {
+		if (op.type != LogicalOperatorType::LOGICAL_EXTENSION_OPERATOR) {
+			return;
+		}
+		auto &extension = op.Cast<LogicalExtensionOperator>();
+		if (extension.GetExtensionName() != "spatial_join") {
+			return;
+		}
+		auto &join = op.Cast<LogicalSpatialJoin>();
+		if ((join.join_type != JoinType::INNER && join.join_type != JoinType::SEMI) || join.k != 0 ||
+		    join.expressions[0]->type != ExpressionType::BOUND_COLUMN_REF) {
+			return;
+		}
+		auto filter = make_shared<DynamicSpatialFilter>();
+		if (TryPushdown(*join.children[0], join.expressions[0]->Cast<BoundColumnRefExpression>().binding, filter)) {
+			join.extent_filter = std::move(filter);
+		}
+	}
+
+	static void Optimize(ClientContext &context, OptimizerExtensionInfo *info, unique_ptr<LogicalOperator> &plan) {
+		TryOptimize(*plan);
+		for (auto &child : plan->children) {
+			Optimize(context, info, child);
+		}
+	}
+};
+
+//------------------------------------------------------------------------------
+// KNN Join Distance
+//------------------------------------------------------------------------------
+//
+//  A KNN spatial join computes the distance of every pair it returns to rank
+//  them. If a projection or filter on top of the join, possibly through other
+//  filters, uses the distance between the two join keys, e.g.
+//
+//		SELECT a.id, h.id, ST_Distance(a.geom, h.geom)
+//		FROM addresses a JOIN hydrants h ON ST_KNN(a.geom, h.geom, 5)
+//
+//  the join returns the distance as an extra column, and ST_Distance of the
+//  keys (in either order) is replaced by a reference to it.
+//
+class SpatialKNNDistance : public OptimizerExtension {
+public:
+	SpatialKNNDistance() {
+		optimize_function = SpatialKNNDistance::Optimize;
+	}
+
+	// The KNN join below the operator, through filters that do not project their output
+	static optional_ptr<LogicalSpatialJoin> GetKNNJoin(LogicalOperator &op) {
+		reference<LogicalOperator> child = *op.children[0];
+		while (child.get().type == LogicalOperatorType::LOGICAL_FILTER &&
+		       child.get().Cast<LogicalFilter>().projection_map.empty()) {
+			child = *child.get().children[0];
+		}
+		if (child.get().type != LogicalOperatorType::LOGICAL_EXTENSION_OPERATOR ||
+		    child.get().Cast<LogicalExtensionOperator>().GetExtensionName() != "spatial_join") {
+			return nullptr;
+		}
+		auto &join = child.get().Cast<LogicalSpatialJoin>();
+		if (join.k == 0) {
+			return nullptr;
+		}
+		return &join;
+	}
+
+	static bool IsKeyDistance(const Expression &expr, const LogicalSpatialJoin &join) {
+		if (expr.type != ExpressionType::BOUND_FUNCTION) {
+			return false;
+		}
+		auto &func = expr.Cast<BoundFunctionExpression>();
+		if (!StringUtil::CIEquals(func.function.name, "st_distance") || func.children.size() != 2 ||
+		    func.children[0]->return_type != GeoTypes::GEOMETRY() ||
+		    func.children[1]->return_type != GeoTypes::GEOMETRY()) {
+			return false;
+		}
+		auto &probe = *join.expressions[0];
+		auto &build = *join.expressions[1];
+		return (func.children[0]->Equals(probe) && func.children[1]->Equals(build)) ||
+		       (func.children[0]->Equals(build) && func.children[1]->Equals(probe));
+	}
+
+	static void ReplaceDistance(unique_ptr<Expression> &expr, LogicalSpatialJoin &join, idx_t &next_table_index) {
+		if (!IsKeyDistance(*expr, join)) {
+			ExpressionIterator::EnumerateChildren(
+			    *expr, [&](unique_ptr<Expression> &child) { ReplaceDistance(child, join, next_table_index); });
+			return;
+		}
+		if (join.distance_index == DConstants::INVALID_INDEX) {
+			join.distance_index = next_table_index++;
+		}
+		expr = make_uniq<BoundColumnRefExpression>(expr->alias, LogicalType::DOUBLE,
+		                                           ColumnBinding(join.distance_index, 0));
+	}
+
+	static void TryOptimize(LogicalOperator &op, idx_t &next_table_index) {
+		if (op.type != LogicalOperatorType::LOGICAL_PROJECTION && op.type != LogicalOperatorType::LOGICAL_FILTER) {
+			return;
+		}
+		auto join = GetKNNJoin(op);
+		if (!join) {
+			return;
+		}
+		for (auto &expr : op.expressions) {
+			ReplaceDistance(expr, *join, next_table_index);
+		}
+	}
+
+	// The table indexes of the plan, a new one has to be past all of them
+	static void GetMaxTableIndex(LogicalOperator &op, idx_t &max_index) {
+		auto table_indexes = op.GetTableIndex();
+		for (auto &binding : op.GetColumnBindings()) {
+			table_indexes.push_back(binding.table_index);
+		}
+		for (auto table_index : table_indexes) {
+			if (table_index != DConstants::INVALID_INDEX) {
+				max_index = MaxValue(max_index, table_index);
+			}
+		}
+		for (auto &child : op.children) {
+			GetMaxTableIndex(*child, max_index);
+		}
+	}
+
+	static void Optimize(LogicalOperator &op, idx_t &next_table_index) {
+		TryOptimize(op, next_table_index);
+		for (auto &child : op.children) {
+			Optimize(*child, next_table_index);
+		}
+	}
+
+	static void Optimize(ClientContext &context, OptimizerExtensionInfo *info, unique_ptr<LogicalOperator> &plan) {
+		idx_t max_index = 0;
+		GetMaxTableIndex(*plan, max_index);
+		auto next_table_index = max_index + 1;
+		Optimize(*plan, next_table_index);
+	}
+};
+
+//------------------------------------------------------------------------------
+// Spatial Top-N
+//------------------------------------------------------------------------------
+//
+//  Adds a filter below a TOP_N whose first ordering is the distance to a
+//  constant geometry, e.g. "the 10 stores closest to a point":
+//
+//		ORDER BY ST_Distance(geom, ST_Point(...)) LIMIT 10
+//
+//  The filter keeps the 10 smallest distances it has seen, and drops the rows
+//  whose bounding box alone puts them further away without computing their
+//  distance (see LogicalSpatialTopNFilter). The TOP_N still sorts the rows
+//  that are left, so the result is the same.
+//
+class SpatialTopNRewriter : public OptimizerExtension {
+public:
+	SpatialTopNRewriter() {
+		optimize_function = SpatialTopNRewriter::Optimize;
+	}
+
+	static void TryOptimize(ClientContext &context, LogicalOperator &op) {
+		if (op.type != LogicalOperatorType::LOGICAL_TOP_N) {
+			return;
+		}
+		auto &top_n = op.Cast<LogicalTopN>();
+		auto k = top_n.limit + top_n.offset;
+		if (k == 0 || k < top_n.limit || top_n.orders.empty()) {
+			return;
+		}
+		// NULL distances have to come last, so that they can be dropped as soon as there are k distances
+		auto &order = top_n.orders[0];
+		if (order.type != OrderType::ASCENDING || order.null_order != OrderByNullType::NULLS_LAST ||
+		    order.expression->type != ExpressionType::BOUND_FUNCTION) {
+			return;
+		}
+		auto &func = order.expression->Cast<BoundFunctionExpression>();
+		if (!StringUtil::CIEquals(func.function.name, "st_distance") || func.children.size() != 2 ||
+		    func.children[0]->return_type != GeoTypes::GEOMETRY() ||
+		    func.children[1]->return_type != GeoTypes::GEOMETRY()) {
+			return;
+		}
+		if (op.children[0]->type == LogicalOperatorType::LOGICAL_EXTENSION_OPERATOR) {
+			auto &child = op.children[0]->Cast<LogicalExtensionOperator>();
+			if (child.GetExtensionName() == "spatial_top_n_filter") {
+				return;
+			}
+		}
+
+		for (idx_t arg_idx = 0; arg_idx < 2; arg_idx++) {
+			auto &geometry = func.children[arg_idx];
+			auto &constant = func.children[1 - arg_idx];
+			if (geometry->IsFoldable() || !constant->IsFoldable()) {
+				continue;
+			}
+			Value value;
+			if (!ExpressionExecutor::TryEvaluateScalar(context, *constant, value) || value.IsNull()) {
+				return;
+			}
+			BoundingBox bbox;
+			if (!GeometryFactory::TryGetSerializedBoundingBox(geometry_t(string_t(StringValue::Get(value))), bbox)) {
+				return;
+			}
+
+			auto filter = make_uniq<LogicalSpatialTopNFilter>(k);
+			filter->minx = bbox.minx;
+			filter->miny = bbox.miny;
+			filter->maxx = bbox.maxx;
+			filter->maxy = bbox.maxy;
+			filter->expressions.push_back(geometry->Copy());
+			filter->expressions.push_back(order.expression->Copy());
+			filter->children.push_back(std::move(op.children[0]));
+			filter->estimated_cardinality = filter->children[0]->estimated_cardinality;
+			filter->has_estimated_cardinality = filter->children[0]->has_estimated_cardinality;
+			op.children[0] = std::move(filter);
+			return;
+		}
+	}
+
+	static void Optimize(ClientContext &context, OptimizerExtensionInfo *info, unique_ptr<LogicalOperator> &plan) {
+		TryOptimize(context, *plan);
+		for (auto &child : plan->children) {
+			Optimize(context, info, child);
+		}
+	}
+};
+
+//------------------------------------------------------------------------------
+// Cache Invalidation
+//------------------------------------------------------------------------------
+//
+//  Drops the results cached by ST_CachedTile and the build sides cached by
+//  spatial joins that read a table when a statement that writes to the table
+//  (or creates, alters or drops it) is planned. The table is matched by its
+//  name without the schema, which at worst drops more than needed.
+//
+//  A prepared statement is not planned again when it runs, so INSERT, UPDATE
+//  and DELETE are also wrapped in a LogicalSpatialCacheInvalidation, which
+//  drops them every time the statement runs. Attaching or detaching a database
+//  drops all the cached build sides, which are keyed by the name of the
+//  database.
+//
+class CacheInvalidation : public OptimizerExtension {
+public:
+	CacheInvalidation() {
+		optimize_function = CacheInvalidation::Optimize;
+	}
+
+	// Collect the tables the plan writes to, and wrap the operators that write rows into a cache invalidation
+	static void CollectWrittenTables(unique_ptr<LogicalOperator> &plan, vector<string> &tables, bool &attaches) {
+		auto &op = *plan;
+		string written_rows;
+		switch (op.type) {
+		case LogicalOperatorType::LOGICAL_INSERT:
+			written_rows = op.Cast<LogicalInsert>().table.name;
+			break;
+		case LogicalOperatorType::LOGICAL_DELETE:
+			written_rows = op.Cast<LogicalDelete>().table.name;
+			break;
+		case LogicalOperatorType::LOGICAL_UPDATE:
+			written_rows = op.Cast<LogicalUpdate>().table.name;
+			break;
+		case LogicalOperatorType::LOGICAL_EXTENSION_OPERATOR:
+			if (op.Cast<LogicalExtensionOperator>().GetExtensionName() == "spatial_cache_invalidation") {
+				// Already wrapped
+				tables.push_back(op.Cast<LogicalSpatialCacheInvalidation>().table);
+				return;
+			}
+			break;
+		case LogicalOperatorType::LOGICAL_CREATE_TABLE:
+			tables.push_back(op.Cast<LogicalCreateTable>().info->Base().table);
+			break;
+		case LogicalOperatorType::LOGICAL_DROP:
+			tables.push_back(op.Cast<LogicalSimple>().info->Cast<DropInfo>().name);
+			break;
+		case LogicalOperatorType::LOGICAL_ALTER:
+			tables.push_back(op.Cast<LogicalSimple>().info->Cast<AlterInfo>().name);
+			break;
+		case LogicalOperatorType::LOGICAL_ATTACH:
+		case LogicalOperatorType::LOGICAL_DETACH:
+			attaches = true;
+			break;
+		default:
+			break;
+		}
+		for (auto &child : op.children) {
+			CollectWrittenTables(child, tables, attaches);
+		}
+		if (written_rows.empty()) {
+			return;
+		}
+		tables.push_back(written_rows);
+		auto invalidation = make_uniq<LogicalSpatialCacheInvalidation>(StringUtil::Lower(written_rows));
+		invalidation->estimated_cardinality = plan->estimated_cardinality;
+		invalidation->has_estimated_cardinality = plan->has_estimated_cardinality;
+		invalidation->children.push_back(std::move(plan));
+		plan = std::move(invalidation);
+	}
+
+	static void Optimize(ClientContext &context, OptimizerExtensionInfo *info, unique_ptr<LogicalOperator> &plan) {
+		vector<string> tables;
+		bool attaches = false;
+		CollectWrittenTables(plan, tables, attaches);
+		if (attaches) {
+			auto join_cache = JoinIndexCache::TryGet(context);
+			if (join_cache) {
+				join_cache->InvalidateAll();
+			}
+		}
+		if (tables.empty()) {
+			return;
+		}
+		unordered_set<string> written;
+		for (auto &table : tables) {
+			written.insert(StringUtil::Lower(table));
+		}
+		SpatialCacheWrites::Invalidate(context, written);
+	}
+};
+
 //------------------------------------------------------------------------------
 // Register optimizers
 //------------------------------------------------------------------------------
@@ -263,6 +1685,26 @@ void CoreOptimizerRules::Register(DatabaseInstance &db) {
 
 	// Register the optimizer rules
 	config.optimizer_extensions.push_back(RangeJoinSpatialPredicateRewriter());
+	config.optimizer_extensions.push_back(SpatialFilterBoundingBoxPrefilter());
+	config.optimizer_extensions.push_back(SpatialPredicateFusion());
+	config.optimizer_extensions.push_back(SpatialJoinExtentPushdown());
+	config.optimizer_extensions.push_back(SpatialKNNDistance());
+	config.optimizer_extensions.push_back(SpatialTopNRewriter());
+	config.optimizer_extensions.push_back(CacheInvalidation());
+
+	config.AddExtensionOption("spatial_join_partition_threshold",
+	                          "The number of build side rows above which a spatial join partitions the build side into "
+	                          "tiles",
+	                          LogicalType::UBIGINT, Value::UBIGINT(1 << 22));
+
+	config.AddExtensionOption("spatial_join_cache_size",
+	                          "The memory the build sides of spatial joins kept for later queries may take, caching is "
+	                          "disabled at 0. A build side is dropped when its table is written to",
+	                          LogicalType::VARCHAR, Value("0"));
+
+	config.AddExtensionOption("spatial_join_rewrite",
+	                          "Plan joins on spatial predicates as spatial or range joins on their bounding boxes",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(true));
 
 	con.Commit();
 }
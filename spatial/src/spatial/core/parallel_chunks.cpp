@@ -0,0 +1,116 @@
+#include "spatial/common.hpp"
+#include "spatial/core/parallel_chunks.hpp"
+
+#include "duckdb/common/error_data.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
+
+#include <condition_variable>
+
+namespace spatial {
+
+namespace core {
+
+struct ParallelChunksJob {
+	ParallelChunksJob(idx_t chunk_count, const ParallelChunks::ChunkFunction &fun)
+	    : chunk_count(chunk_count), fun(fun) {
+	}
+
+	idx_t chunk_count;
+	// Only called while the job is open, and Run does not return before it is closed
+	const ParallelChunks::ChunkFunction &fun;
+	atomic<idx_t> next_chunk {0};
+
+	mutex lock;
+	std::condition_variable tasks_done;
+	// The number of tasks working on chunks, and whether the job still takes new ones
+	idx_t active_tasks = 0;
+	bool closed = false;
+	bool has_error = false;
+	ErrorData error;
+
+	// Called by a task before it works on the job, returns false once the job is closed
+	bool Join() {
+		lock_guard<mutex> guard(lock);
+		if (closed) {
+			return false;
+		}
+		active_tasks++;
+		return true;
+	}
+
+	void Leave() {
+		lock_guard<mutex> guard(lock);
+		active_tasks--;
+		if (active_tasks == 0) {
+			tasks_done.notify_all();
+		}
+	}
+
+	// Stop new tasks from joining, and wait for the ones that did
+	void Close() {
+		unique_lock<mutex> guard(lock);
+		closed = true;
+		tasks_done.wait(guard, [&]() { return active_tasks == 0; });
+	}
+
+	void Work() {
+		try {
+			for (auto i = next_chunk++; i < chunk_count; i = next_chunk++) {
+				fun(i);
+			}
+		} catch (std::exception &ex) {
+			lock_guard<mutex> guard(lock);
+			if (!has_error) {
+				has_error = true;
+				error = ErrorData(ex);
+			}
+			// Make the other threads stop after their current chunk
+			next_chunk = chunk_count;
+		}
+	}
+};
+
+class ParallelChunksTask : public Task {
+public:
+	explicit ParallelChunksTask(shared_ptr<ParallelChunksJob> job_p) : job(std::move(job_p)) {
+	}
+
+	TaskExecutionResult Execute(TaskExecutionMode mode) override {
+		if (job->Join()) {
+			job->Work();
+			job->Leave();
+		}
+		return TaskExecutionResult::TASK_FINISHED;
+	}
+
+private:
+	shared_ptr<ParallelChunksJob> job;
+};
+
+void ParallelChunks::Run(ClientContext &context, idx_t chunk_count, const ChunkFunction &fun) {
+	auto &scheduler = TaskScheduler::GetScheduler(context);
+	auto thread_count = MaxValue<idx_t>(static_cast<idx_t>(scheduler.NumberOfThreads()), 1);
+	if (chunk_count <= 1 || thread_count == 1) {
+		for (idx_t chunk = 0; chunk < chunk_count; chunk++) {
+			fun(chunk);
+		}
+		return;
+	}
+
+	auto job = make_shared<ParallelChunksJob>(chunk_count, fun);
+	auto token = scheduler.CreateProducer();
+	auto task_count = MinValue<idx_t>(thread_count - 1, chunk_count - 1);
+	for (idx_t i = 0; i < task_count; i++) {
+		scheduler.ScheduleTask(*token, make_shared<ParallelChunksTask>(job));
+	}
+	job->Work();
+	job->Close();
+	if (job->has_error) {
+		job->error.Throw();
+	}
+}
+
+} // namespace core
+
+} // namespace spatial
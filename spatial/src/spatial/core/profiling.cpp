@@ -0,0 +1,79 @@
+#include "spatial/common.hpp"
+#include "spatial/core/profiling.hpp"
+
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/main/client_context.hpp"
+
+namespace spatial {
+
+namespace core {
+
+// Totals since the last call to SpatialCounters::Fetch
+static atomic<idx_t> total_deserialize_calls(0);
+static atomic<idx_t> total_deserialize_bytes(0);
+static atomic<idx_t> total_geos_predicate_calls(0);
+static atomic<idx_t> total_prepared_cache_hits(0);
+static atomic<idx_t> total_bbox_rejects(0);
+static atomic<idx_t> total_proj_pipelines(0);
+static atomic<idx_t> total_join_candidates(0);
+static atomic<idx_t> total_join_matches(0);
+static atomic<idx_t> total_join_grid_rejects(0);
+static atomic<idx_t> total_join_build_us(0);
+static atomic<idx_t> total_join_probe_us(0);
+static atomic<idx_t> total_join_refine_us(0);
+
+void SpatialCounters::Init(ClientContext &context) {
+	Value profiling;
+	enabled = context.TryGetCurrentSetting("spatial_profiling", profiling) && !profiling.IsNull() &&
+	          profiling.GetValue<bool>();
+}
+
+void SpatialCounters::Flush() {
+	if (enabled) {
+		total_deserialize_calls += deserialize_calls;
+		total_deserialize_bytes += deserialize_bytes;
+		total_geos_predicate_calls += geos_predicate_calls;
+		total_prepared_cache_hits += prepared_cache_hits;
+		total_bbox_rejects += bbox_rejects;
+		total_proj_pipelines += proj_pipelines;
+		total_join_candidates += join_candidates;
+		total_join_matches += join_matches;
+		total_join_grid_rejects += join_grid_rejects;
+		total_join_build_us += join_build_us;
+		total_join_probe_us += join_probe_us;
+		total_join_refine_us += join_refine_us;
+	}
+	deserialize_calls = 0;
+	deserialize_bytes = 0;
+	geos_predicate_calls = 0;
+	prepared_cache_hits = 0;
+	bbox_rejects = 0;
+	proj_pipelines = 0;
+	join_candidates = 0;
+	join_matches = 0;
+	join_grid_rejects = 0;
+	join_build_us = 0;
+	join_probe_us = 0;
+	join_refine_us = 0;
+}
+
+SpatialCounters SpatialCounters::Fetch() {
+	SpatialCounters result;
+	result.deserialize_calls = total_deserialize_calls.exchange(0);
+	result.deserialize_bytes = total_deserialize_bytes.exchange(0);
+	result.geos_predicate_calls = total_geos_predicate_calls.exchange(0);
+	result.prepared_cache_hits = total_prepared_cache_hits.exchange(0);
+	result.bbox_rejects = total_bbox_rejects.exchange(0);
+	result.proj_pipelines = total_proj_pipelines.exchange(0);
+	result.join_candidates = total_join_candidates.exchange(0);
+	result.join_matches = total_join_matches.exchange(0);
+	result.join_grid_rejects = total_join_grid_rejects.exchange(0);
+	result.join_build_us = total_join_build_us.exchange(0);
+	result.join_probe_us = total_join_probe_us.exchange(0);
+	result.join_refine_us = total_join_refine_us.exchange(0);
+	return result;
+}
+
+} // namespace core
+
+} // namespace spatial
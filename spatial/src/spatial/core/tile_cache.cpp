@@ -0,0 +1,100 @@
+#include "spatial/core/tile_cache.hpp"
+
+namespace spatial {
+
+namespace core {
+
+shared_ptr<TileCache> TileCache::TryGet(ClientContext &context) {
+	return ObjectCache::GetObjectCache(context).Get<TileCache>(ObjectType());
+}
+
+shared_ptr<TileCache> TileCache::GetOrCreate(ClientContext &context) {
+	return ObjectCache::GetObjectCache(context).GetOrCreate<TileCache>(ObjectType());
+}
+
+idx_t TileCache::GetCapacity(ClientContext &context) {
+	Value capacity;
+	if (context.TryGetCurrentSetting("spatial_tile_cache_size", capacity) && !capacity.IsNull()) {
+		return DBConfig::ParseMemoryLimit(capacity.ToString());
+	}
+	return 0;
+}
+
+idx_t TileCache::GetTableVersion(const string &table) {
+	lock_guard<mutex> guard(lock);
+	auto entry = table_versions.find(table);
+	return entry == table_versions.end() ? 0 : entry->second;
+}
+
+void TileCache::InvalidateTable(const string &table) {
+	lock_guard<mutex> guard(lock);
+	table_versions[table]++;
+	for (auto entry = entries.begin(); entry != entries.end();) {
+		auto current = entry++;
+		if (!IsValid(*current->second.result)) {
+			Erase(current);
+		}
+	}
+}
+
+bool TileCache::IsValid(const Result &result) {
+	for (auto &table : result.tables) {
+		auto version = table_versions.find(table.name);
+		if ((version == table_versions.end() ? 0 : version->second) != table.version) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void TileCache::Erase(unordered_map<string, Entry>::iterator entry) {
+	size -= entry->second.result->size;
+	lru.erase(entry->second.lru_position);
+	entries.erase(entry);
+}
+
+shared_ptr<TileCache::Result> TileCache::Lookup(const string &query) {
+	lock_guard<mutex> guard(lock);
+	auto entry = entries.find(query);
+	if (entry == entries.end()) {
+		return nullptr;
+	}
+	if (!IsValid(*entry->second.result)) {
+		Erase(entry);
+		return nullptr;
+	}
+	lru.splice(lru.begin(), lru, entry->second.lru_position);
+	return entry->second.result;
+}
+
+void TileCache::Insert(const string &query, shared_ptr<Result> result, idx_t capacity) {
+	lock_guard<mutex> guard(lock);
+	auto existing = entries.find(query);
+	if (existing != entries.end()) {
+		Erase(existing);
+	}
+	if (!IsValid(*result) || result->size > capacity) {
+		return;
+	}
+	while (size + result->size > capacity) {
+		Erase(entries.find(lru.back()));
+	}
+	lru.push_front(query);
+	size += result->size;
+	peak_size = MaxValue(peak_size, size);
+	Entry entry;
+	entry.result = std::move(result);
+	entry.lru_position = lru.begin();
+	entries.emplace(query, std::move(entry));
+}
+
+void TileCache::FetchMemory(idx_t &held_bytes, idx_t &peak_bytes) {
+	lock_guard<mutex> guard(lock);
+	held_bytes = size;
+	peak_bytes = peak_size;
+	peak_size = size;
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -52,12 +52,45 @@ LogicalType GeoTypes::POLYGON_2D() {
 	return type;
 }
 
+// The MULTI* types follow the nested list layout of the native GeoArrow encodings
+LogicalType GeoTypes::MULTIPOINT_2D() {
+	auto type = LogicalType::LIST(LogicalType::STRUCT({{"x", LogicalType::DOUBLE}, {"y", LogicalType::DOUBLE}}));
+	type.SetAlias("MULTIPOINT_2D");
+	return type;
+}
+
+LogicalType GeoTypes::MULTILINESTRING_2D() {
+	auto type = LogicalType::LIST(
+	    LogicalType::LIST(LogicalType::STRUCT({{"x", LogicalType::DOUBLE}, {"y", LogicalType::DOUBLE}})));
+	type.SetAlias("MULTILINESTRING_2D");
+	return type;
+}
+
+LogicalType GeoTypes::MULTIPOLYGON_2D() {
+	auto type = LogicalType::LIST(LogicalType::LIST(
+	    LogicalType::LIST(LogicalType::STRUCT({{"x", LogicalType::DOUBLE}, {"y", LogicalType::DOUBLE}}))));
+	type.SetAlias("MULTIPOLYGON_2D");
+	return type;
+}
+
 LogicalType GeoTypes::GEOMETRY() {
 	auto blob_type = LogicalType(LogicalTypeId::BLOB);
 	blob_type.SetAlias("GEOMETRY");
 	return blob_type;
 }
 
+LogicalType GeoTypes::GEOMETRY_Q() {
+	auto blob_type = LogicalType(LogicalTypeId::BLOB);
+	blob_type.SetAlias("GEOMETRY_Q");
+	return blob_type;
+}
+
+LogicalType GeoTypes::GEOMETRY_LOD() {
+	auto blob_type = LogicalType(LogicalTypeId::BLOB);
+	blob_type.SetAlias("GEOMETRY_LOD");
+	return blob_type;
+}
+
 LogicalType GeoTypes::WKB_BLOB() {
 	auto blob_type = LogicalType(LogicalTypeId::BLOB);
 	blob_type.SetAlias("WKB_BLOB");
@@ -93,12 +126,27 @@ void GeoTypes::Register(DatabaseInstance &db) {
 	// Polygon2D
 	ExtensionUtil::RegisterType(db, "POLYGON_2D", GeoTypes::POLYGON_2D());
 
+	// MultiPoint2D
+	ExtensionUtil::RegisterType(db, "MULTIPOINT_2D", GeoTypes::MULTIPOINT_2D());
+
+	// MultiLineString2D
+	ExtensionUtil::RegisterType(db, "MULTILINESTRING_2D", GeoTypes::MULTILINESTRING_2D());
+
+	// MultiPolygon2D
+	ExtensionUtil::RegisterType(db, "MULTIPOLYGON_2D", GeoTypes::MULTIPOLYGON_2D());
+
 	// Box2D
 	ExtensionUtil::RegisterType(db, "BOX_2D", GeoTypes::BOX_2D());
 
 	// GEOMETRY
 	ExtensionUtil::RegisterType(db, "GEOMETRY", GeoTypes::GEOMETRY());
 
+	// GEOMETRY_Q
+	ExtensionUtil::RegisterType(db, "GEOMETRY_Q", GeoTypes::GEOMETRY_Q());
+
+	// GEOMETRY_LOD
+	ExtensionUtil::RegisterType(db, "GEOMETRY_LOD", GeoTypes::GEOMETRY_LOD());
+
 	// WKB_BLOB
 	ExtensionUtil::RegisterType(db, "WKB_BLOB", GeoTypes::WKB_BLOB());
 }
@@ -1,6 +1,11 @@
 #include "spatial/gdal/file_handler.hpp"
+#include "spatial/gdal/module.hpp"
+#include "spatial/core/io/async_reader.hpp"
+#include "spatial/core/io/mapped_file.hpp"
 
+#include "duckdb/common/atomic.hpp"
 #include "duckdb/common/mutex.hpp"
+#include "duckdb/main/config.hpp"
 #include "duckdb/main/client_context.hpp"
 #include "duckdb/common/types/uuid.hpp"
 
@@ -17,18 +22,284 @@ namespace gdal {
 // GDAL DuckDB File handle wrapper
 //--------------------------------------------------------------------------
 
+// Ranges that are at most this far apart are read with a single request, and a single request reads at most this much
+static constexpr idx_t MULTI_RANGE_MAX_GAP = 64 * 1024;
+static constexpr idx_t MULTI_RANGE_MAX_SIZE = 16 * 1024 * 1024;
+// The most data kept around after an AdviseRead call
+static constexpr idx_t ADVISE_READ_MAX_SIZE = 64 * 1024 * 1024;
+// The number of blocks of "spatial_gdal_io_buffer_size" bytes cached per file handle
+static constexpr idx_t IO_BUFFER_BLOCK_COUNT = 8;
+
+// Totals since the last call to GdalIOMetrics::Fetch
+static atomic<idx_t> io_read_count(0);
+static atomic<idx_t> io_cache_hit_count(0);
+static atomic<idx_t> io_cache_miss_count(0);
+static atomic<idx_t> io_bytes_read(0);
+static atomic<idx_t> io_batch_size(0);
+
+void GdalIOMetrics::Fetch(idx_t &read_count, idx_t &cache_hit_count, idx_t &cache_miss_count, idx_t &bytes_read,
+                          idx_t &batch_size) {
+	read_count = io_read_count.exchange(0);
+	cache_hit_count = io_cache_hit_count.exchange(0);
+	cache_miss_count = io_cache_miss_count.exchange(0);
+	bytes_read = io_bytes_read.exchange(0);
+	batch_size = io_batch_size.exchange(0);
+}
+
+void GdalIOMetrics::RecordBatchSize(idx_t batch_size) {
+	io_batch_size = batch_size;
+}
+
+struct FileRange {
+	idx_t offset;
+	idx_t size;
+};
+
+// Sort and merge ranges that are close to each other, so that they can be read with as few requests as possible
+static vector<FileRange> CoalesceRanges(int range_count, const vsi_l_offset *offsets, const size_t *sizes) {
+	vector<FileRange> ranges;
+	for (int i = 0; i < range_count; i++) {
+		if (sizes[i] > 0) {
+			ranges.push_back({static_cast<idx_t>(offsets[i]), static_cast<idx_t>(sizes[i])});
+		}
+	}
+	std::sort(ranges.begin(), ranges.end(),
+	          [](const FileRange &a, const FileRange &b) { return a.offset < b.offset; });
+
+	vector<FileRange> result;
+	for (auto &range : ranges) {
+		if (!result.empty()) {
+			auto &last = result.back();
+			auto last_end = last.offset + last.size;
+			auto end = MaxValue(last_end, range.offset + range.size);
+			if (range.offset <= last_end + MULTI_RANGE_MAX_GAP && end - last.offset <= MULTI_RANGE_MAX_SIZE) {
+				last.size = end - last.offset;
+				continue;
+			}
+		}
+		result.push_back(range);
+	}
+	return result;
+}
+
 class DuckDBFileHandle : public VSIVirtualHandle {
 private:
 	unique_ptr<FileHandle> file_handle;
 
+	// Data read ahead of time because of an AdviseRead call
+	struct AdvisedRange {
+		idx_t offset;
+		idx_t size;
+		vector<data_t> data;
+		// Set instead of data while the range is read in the background
+		shared_ptr<core::AsyncReader::Request> pending;
+	};
+	vector<AdvisedRange> advised_ranges;
+
+	// Seekable files opened for reading that are not mapped read the ranges of AdviseRead and ReadMultiRange calls
+	// concurrently, with up to "spatial_io_queue_depth" reads in flight, instead of one after the other
+	unique_ptr<core::AsyncReader> async_reader;
+
+	// Small reads of seekable files opened for reading are served from a few cached blocks of block_size bytes. The
+	// position is then tracked here instead of by the file handle, and the file is only read with positional reads.
+	struct CachedBlock {
+		idx_t block_idx;
+		idx_t last_used;
+		vector<data_t> data;
+	};
+	idx_t block_size = 0;
+	idx_t position = 0;
+	idx_t file_size = 0;
+	idx_t block_clock = 0;
+	vector<CachedBlock> blocks;
+
+	// Local files opened for reading are mapped into memory instead, the position is then tracked here as well and
+	// every read is a copy out of the mapping
+	unique_ptr<core::MappedFile> mapping;
+
+	bool TracksPosition() const {
+		return mapping || block_size > 0;
+	}
+
+	// Read a range without moving the file position, returns false if it could not be read completely
+	bool ReadAt(data_ptr_t buffer, idx_t size, idx_t offset) {
+		if (mapping) {
+			return mapping->Read(buffer, size, offset) == size;
+		}
+		if (offset + size > file_handle->GetFileSize()) {
+			return false;
+		}
+		try {
+			file_handle->Read(buffer, size, offset);
+		} catch (...) {
+			return false;
+		}
+		io_bytes_read += size;
+		return true;
+	}
+
+	// Get a block from the cache, or read it and evict the least recently used block. Returns nullptr if it could
+	// not be read.
+	CachedBlock *GetBlock(idx_t block_idx) {
+		for (auto &block : blocks) {
+			if (block.block_idx == block_idx) {
+				io_cache_hit_count++;
+				block.last_used = ++block_clock;
+				return &block;
+			}
+		}
+		io_cache_miss_count++;
+
+		CachedBlock *target;
+		if (blocks.size() < IO_BUFFER_BLOCK_COUNT) {
+			blocks.emplace_back();
+			target = &blocks.back();
+		} else {
+			target = &blocks[0];
+			for (auto &block : blocks) {
+				if (block.last_used < target->last_used) {
+					target = &block;
+				}
+			}
+		}
+		auto offset = block_idx * block_size;
+		target->data.resize(MinValue(block_size, file_size - offset));
+		if (!ReadAt(target->data.data(), target->data.size(), offset)) {
+			// Make sure the block is not found again
+			target->block_idx = DConstants::INVALID_INDEX;
+			target->last_used = 0;
+			return nullptr;
+		}
+		target->block_idx = block_idx;
+		target->last_used = ++block_clock;
+		return target;
+	}
+
+	// Read from the current position through the block cache, returns the number of bytes read
+	idx_t ReadBuffered(data_ptr_t buffer, idx_t size) {
+		if (position >= file_size) {
+			return 0;
+		}
+		size = MinValue(size, file_size - position);
+		if (mapping) {
+			auto read_bytes = mapping->Read(buffer, size, position);
+			position += read_bytes;
+			return read_bytes;
+		}
+		if (TryReadAdvised(buffer, size, position)) {
+			position += size;
+			return size;
+		}
+		if (size >= block_size) {
+			// Caching would not save any reads
+			if (!ReadAt(buffer, size, position)) {
+				return 0;
+			}
+			position += size;
+			return size;
+		}
+		idx_t read_bytes = 0;
+		while (read_bytes < size) {
+			auto block = GetBlock(position / block_size);
+			if (!block) {
+				break;
+			}
+			auto block_offset = position % block_size;
+			auto copy_bytes = MinValue(size - read_bytes, block->data.size() - block_offset);
+			memcpy(buffer + read_bytes, block->data.data() + block_offset, copy_bytes);
+			read_bytes += copy_bytes;
+			position += copy_bytes;
+		}
+		return read_bytes;
+	}
+
+	AdvisedRange *FindAdvised(idx_t size, idx_t offset) {
+		for (auto &range : advised_ranges) {
+			if (offset >= range.offset && offset + size <= range.offset + range.size) {
+				return &range;
+			}
+		}
+		return nullptr;
+	}
+
+	// Copy from the advised ranges if one of them contains the whole range
+	bool TryReadAdvised(data_ptr_t buffer, idx_t size, idx_t offset) {
+		auto range = FindAdvised(size, offset);
+		if (!range) {
+			return false;
+		}
+		const_data_ptr_t data;
+		if (range->pending) {
+			try {
+				async_reader->Wait(*range->pending);
+			} catch (...) {
+				// Only a hint, the data is read again when it is actually needed
+				range->size = 0;
+				range->pending.reset();
+				return false;
+			}
+			data = range->pending->data.get();
+		} else {
+			data = range->data.data();
+		}
+		memcpy(buffer, data + (offset - range->offset), size);
+		return true;
+	}
+
+	// Copy the requested ranges that a coalesced range contains out of it
+	static void CopyRanges(const FileRange &range, const_data_ptr_t data, int range_count, void **buffers,
+	                       const vsi_l_offset *offsets, const size_t *sizes) {
+		for (int i = 0; i < range_count; i++) {
+			auto offset = static_cast<idx_t>(offsets[i]);
+			if (sizes[i] > 0 && offset >= range.offset && offset + sizes[i] <= range.offset + range.size) {
+				memcpy(buffers[i], data + (offset - range.offset), sizes[i]);
+			}
+		}
+	}
+
 public:
-	explicit DuckDBFileHandle(unique_ptr<FileHandle> file_handle_p) : file_handle(std::move(file_handle_p)) {
+	DuckDBFileHandle(unique_ptr<FileHandle> file_handle_p, idx_t block_size_p, bool map_file, idx_t queue_depth = 0)
+	    : file_handle(std::move(file_handle_p)) {
+		if (map_file) {
+			// GDAL drivers jump around in the file, so the default read ahead of the operating system is kept
+			mapping = core::MappedFile::TryMap(*file_handle, false);
+		}
+		if (mapping) {
+			position = file_handle->SeekPosition();
+			file_size = mapping->GetSize();
+		} else if (block_size_p > 0 && file_handle->CanSeek()) {
+			block_size = block_size_p;
+			position = file_handle->SeekPosition();
+			file_size = file_handle->GetFileSize();
+		}
+		if (!mapping && map_file && queue_depth > 1 && file_handle->CanSeek()) {
+			async_reader = make_uniq<core::AsyncReader>(*file_handle, queue_depth);
+		}
 	}
 
 	vsi_l_offset Tell() override {
+		if (TracksPosition()) {
+			return static_cast<vsi_l_offset>(position);
+		}
 		return static_cast<vsi_l_offset>(file_handle->SeekPosition());
 	}
 	int Seek(vsi_l_offset nOffset, int nWhence) override {
+		if (TracksPosition()) {
+			switch (nWhence) {
+			case SEEK_SET:
+				position = nOffset;
+				break;
+			case SEEK_CUR:
+				position += nOffset;
+				break;
+			case SEEK_END:
+				position = file_size + nOffset;
+				break;
+			default:
+				throw InternalException("Unknown seek type");
+			}
+			return 0;
+		}
 		if (nWhence == SEEK_SET && nOffset == 0) {
 			// Use the reset function instead to allow compressed file handles to rewind
 			// even if they don't support seeking
@@ -52,7 +323,21 @@ public:
 	}
 
 	size_t Read(void *pBuffer, size_t nSize, size_t nCount) override {
+		io_read_count++;
+		if (TracksPosition()) {
+			if (nSize == 0) {
+				return 0;
+			}
+			return ReadBuffered(static_cast<data_ptr_t>(pBuffer), nSize * nCount) / nSize;
+		}
 		auto remaining_bytes = nSize * nCount;
+		if (!advised_ranges.empty() && remaining_bytes > 0) {
+			auto position = file_handle->SeekPosition();
+			if (TryReadAdvised(static_cast<data_ptr_t>(pBuffer), remaining_bytes, position)) {
+				file_handle->Seek(position + remaining_bytes);
+				return nCount;
+			}
+		}
 		try {
 			while (remaining_bytes > 0) {
 				auto read_bytes = file_handle->Read(pBuffer, remaining_bytes);
@@ -60,6 +345,7 @@ public:
 					break;
 				}
 				remaining_bytes -= read_bytes;
+				io_bytes_read += read_bytes;
 				// Note we performed a cast back to void*
 				pBuffer = static_cast<uint8_t *>(pBuffer) + read_bytes;
 			}
@@ -69,11 +355,15 @@ public:
 	}
 
 	int Eof() override {
+		if (TracksPosition()) {
+			return position >= file_size ? TRUE : FALSE;
+		}
 		return file_handle->SeekPosition() == file_handle->GetFileSize() ? TRUE : FALSE;
 	}
 
 	size_t Write(const void *pBuffer, size_t nSize, size_t nCount) override {
 		size_t written_bytes = 0;
+		advised_ranges.clear();
 		try {
 			written_bytes = file_handle->Write(const_cast<void *>(pBuffer), nSize * nCount);
 		} catch (...) {
@@ -87,6 +377,7 @@ public:
 		return 0;
 	}
 	int Truncate(vsi_l_offset nNewSize) override {
+		advised_ranges.clear();
 		file_handle->Truncate(static_cast<int64_t>(nNewSize));
 		return 0;
 	}
@@ -95,9 +386,99 @@ public:
 		return 0;
 	}
 
-	// int ReadMultiRange(int nRanges, void **ppData, const vsi_l_offset *panOffsets, const size_t *panSizes) override;
-	// void AdviseRead(int nRanges, const vsi_l_offset *panOffsets, const size_t *panSizes) override;
-	// VSIRangeStatus GetRangeStatus(vsi_l_offset nOffset, vsi_l_offset nLength) override;
+	int ReadMultiRange(int nRanges, void **ppData, const vsi_l_offset *panOffsets, const size_t *panSizes) override {
+		if (!file_handle->CanSeek()) {
+			// Fall back to reading the ranges one after the other
+			return VSIVirtualHandle::ReadMultiRange(nRanges, ppData, panOffsets, panSizes);
+		}
+
+		// Read the coalesced ranges, then copy the requested ranges out of them
+		auto ranges = CoalesceRanges(nRanges, panOffsets, panSizes);
+		vector<data_t> buffer;
+		if (!async_reader) {
+			for (auto &range : ranges) {
+				buffer.resize(range.size);
+				if (!TryReadAdvised(buffer.data(), range.size, range.offset) &&
+				    !ReadAt(buffer.data(), range.size, range.offset)) {
+					return -1;
+				}
+				CopyRanges(range, buffer.data(), nRanges, ppData, panOffsets, panSizes);
+			}
+			return 0;
+		}
+
+		// Keep up to the queue depth of the ranges that were not advised in flight, and copy them in order
+		auto file_size = file_handle->GetFileSize();
+		std::deque<shared_ptr<core::AsyncReader::Request>> in_flight;
+		idx_t next_range = 0;
+		for (auto &range : ranges) {
+			while (next_range < ranges.size() && in_flight.size() < async_reader->QueueDepth()) {
+				auto &next = ranges[next_range++];
+				if (next.offset + next.size > file_size) {
+					return -1;
+				}
+				if (FindAdvised(next.size, next.offset)) {
+					in_flight.push_back(nullptr);
+				} else {
+					in_flight.push_back(async_reader->Submit(next.offset, next.size));
+					io_bytes_read += next.size;
+				}
+			}
+			auto request = std::move(in_flight.front());
+			in_flight.pop_front();
+			if (!request) {
+				buffer.resize(range.size);
+				if (!TryReadAdvised(buffer.data(), range.size, range.offset) &&
+				    !ReadAt(buffer.data(), range.size, range.offset)) {
+					return -1;
+				}
+				CopyRanges(range, buffer.data(), nRanges, ppData, panOffsets, panSizes);
+				continue;
+			}
+			try {
+				async_reader->Wait(*request);
+			} catch (...) {
+				return -1;
+			}
+			CopyRanges(range, request->data.get(), nRanges, ppData, panOffsets, panSizes);
+		}
+		return 0;
+	}
+
+	void AdviseRead(int nRanges, const vsi_l_offset *panOffsets, const size_t *panSizes) override {
+		advised_ranges.clear();
+		if (mapping || !file_handle->CanSeek()) {
+			return;
+		}
+		auto file_size = file_handle->GetFileSize();
+		idx_t total_size = 0;
+		for (auto &range : CoalesceRanges(nRanges, panOffsets, panSizes)) {
+			if (total_size + range.size > ADVISE_READ_MAX_SIZE) {
+				break;
+			}
+			AdvisedRange advised;
+			advised.offset = range.offset;
+			advised.size = range.size;
+			if (async_reader) {
+				// Read in the background, the data is waited for when it is actually needed
+				if (range.offset + range.size > file_size) {
+					break;
+				}
+				advised.pending = async_reader->Submit(range.offset, range.size);
+				io_bytes_read += range.size;
+				total_size += range.size;
+				advised_ranges.push_back(std::move(advised));
+				continue;
+			}
+			advised.data.resize(range.size);
+			if (!ReadAt(advised.data.data(), range.size, range.offset)) {
+				// Only a hint, the data is read again when it is actually needed
+				break;
+			}
+			total_size += range.size;
+			advised_ranges.push_back(std::move(advised));
+		}
+	}
 };
 
 //--------------------------------------------------------------------------
@@ -116,6 +497,18 @@ public:
 		return pszFilename + client_prefix.size();
 	}
 
+	idx_t GetIOQueueDepth() {
+		return core::AsyncReader::GetQueueDepth(context);
+	}
+
+	idx_t GetIOBufferSize() {
+		Value buffer_size;
+		if (context.TryGetCurrentSetting("spatial_gdal_io_buffer_size", buffer_size) && !buffer_size.IsNull()) {
+			return DBConfig::ParseMemoryLimit(buffer_size.ToString());
+		}
+		return 0;
+	}
+
 	VSIVirtualHandle *Open(const char *prefixed_file_name, const char *access, bool bSetError,
 	                       CSLConstList /* papszOptions */) override {
 		auto file_name = StripPrefix(prefixed_file_name);
@@ -164,11 +557,15 @@ public:
 				// We can't open a directory for reading on windows without special flags
 				// so just open nul instead, gdal will reject it when it tries to read
 				auto file = fs.OpenFile("nul", flags);
-				return new DuckDBFileHandle(std::move(file));
+				return new DuckDBFileHandle(std::move(file), 0, false);
 			}
 #endif
 			auto file = fs.OpenFile(file_name, flags, FileSystem::DEFAULT_LOCK, FileCompressionType::AUTO_DETECT);
-			return new DuckDBFileHandle(std::move(file));
+			// Only buffer files that are opened for reading, so that the cached blocks never go stale
+			auto read_only = flags == FileFlags::FILE_FLAGS_READ;
+			auto block_size = read_only ? GetIOBufferSize() : 0;
+			auto queue_depth = read_only ? GetIOQueueDepth() : 0;
+			return new DuckDBFileHandle(std::move(file), block_size, read_only, queue_depth);
 		} catch (std::exception &ex) {
 			// Failed to open file via DuckDB File System. If this doesnt have a VSI prefix we can return an error here.
 			if (strncmp(file_name, "/vsi", 4) != 0) {
@@ -299,7 +696,8 @@ public:
 	}
 
 	int HasOptimizedReadMultiRange(const char *pszPath) override {
-		return 0;
+		// Multiple ranges are coalesced into fewer requests, which only pays off when each request is expensive
+		return FileSystem::IsRemoteFile(StripPrefix(pszPath)) ? TRUE : FALSE;
 	}
 
 	int Unlink(const char *prefixed_file_name) override {
@@ -323,6 +721,7 @@ public:
 // not otherwise aware of the connection context.
 //
 GDALClientContextState::GDALClientContextState(ClientContext &context) {
+	GdalModule::Initialize();
 
 	// Create a new random prefix for this client
 	client_prefix = StringUtil::Format("/vsiduckdb-%s/", UUID::ToString(UUID::GenerateRandomUUID()));
@@ -0,0 +1,69 @@
+#include "duckdb/parser/parsed_data/create_table_function_info.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/gdal/functions.hpp"
+#include "spatial/gdal/file_handler.hpp"
+
+namespace spatial {
+
+namespace gdal {
+
+//------------------------------------------------------------------------------
+// spatial_gdal_io_metrics()
+//------------------------------------------------------------------------------
+// Reports the reads of GDAL through the DuckDB file system, and the features per Arrow batch of the last ST_Read. The
+// counters are reset by every call, so calling it after a query reports the reads of that query.
+
+struct IOMetricsState : public GlobalTableFunctionState {
+	bool done = false;
+};
+
+static unique_ptr<FunctionData> IOMetricsBind(ClientContext &context, TableFunctionBindInput &input,
+                                              vector<LogicalType> &return_types, vector<string> &names) {
+	return_types.push_back(LogicalType::UBIGINT);
+	return_types.push_back(LogicalType::UBIGINT);
+	return_types.push_back(LogicalType::UBIGINT);
+	return_types.push_back(LogicalType::UBIGINT);
+	return_types.push_back(LogicalType::UBIGINT);
+	names.push_back("reads");
+	names.push_back("cache_hits");
+	names.push_back("cache_misses");
+	names.push_back("bytes_read");
+	names.push_back("batch_size");
+	return nullptr;
+}
+
+static unique_ptr<GlobalTableFunctionState> IOMetricsInit(ClientContext &context, TableFunctionInitInput &input) {
+	return make_uniq<IOMetricsState>();
+}
+
+static void IOMetricsExecute(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
+	auto &state = input.global_state->Cast<IOMetricsState>();
+	if (state.done) {
+		return;
+	}
+	state.done = true;
+
+	idx_t read_count;
+	idx_t cache_hit_count;
+	idx_t cache_miss_count;
+	idx_t bytes_read;
+	idx_t batch_size;
+	GdalIOMetrics::Fetch(read_count, cache_hit_count, cache_miss_count, bytes_read, batch_size);
+
+	output.SetValue(0, 0, Value::UBIGINT(read_count));
+	output.SetValue(1, 0, Value::UBIGINT(cache_hit_count));
+	output.SetValue(2, 0, Value::UBIGINT(cache_miss_count));
+	output.SetValue(3, 0, Value::UBIGINT(bytes_read));
+	output.SetValue(4, 0, Value::UBIGINT(batch_size));
+	output.SetCardinality(1);
+}
+
+void GdalIOMetricsFunction::Register(DatabaseInstance &db) {
+	TableFunction func("spatial_gdal_io_metrics", {}, IOMetricsExecute, IOMetricsBind, IOMetricsInit);
+	ExtensionUtil::RegisterFunction(db, func);
+}
+
+} // namespace gdal
+
+} // namespace spatial
@@ -3,6 +3,7 @@
 #include "spatial/common.hpp"
 #include "spatial/core/types.hpp"
 #include "spatial/gdal/functions.hpp"
+#include "spatial/gdal/module.hpp"
 
 #include "ogrsf_frmts.h"
 
@@ -13,6 +14,8 @@ namespace gdal {
 // Simple table function to list all the drivers available
 unique_ptr<FunctionData> GdalDriversTableFunction::Bind(ClientContext &context, TableFunctionBindInput &input,
                                                         vector<LogicalType> &return_types, vector<string> &names) {
+	GdalModule::Initialize();
+
 	return_types.emplace_back(LogicalType::VARCHAR);
 	return_types.emplace_back(LogicalType::VARCHAR);
 	return_types.emplace_back(LogicalType::BOOLEAN);
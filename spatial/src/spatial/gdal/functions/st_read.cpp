@@ -2,16 +2,29 @@
 #include "duckdb/parser/expression/constant_expression.hpp"
 #include "duckdb/parser/expression/function_expression.hpp"
 #include "duckdb/parser/tableref/table_function_ref.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
+#include "duckdb/planner/expression/bound_constant_expression.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckdb/planner/expression/bound_operator_expression.hpp"
+#include "duckdb/planner/operator/logical_get.hpp"
 #include "duckdb/planner/filter/conjunction_filter.hpp"
 #include "duckdb/planner/filter/constant_filter.hpp"
 #include "duckdb/planner/table_filter.hpp"
+#include "duckdb/storage/table/column_segment.hpp"
 #include "duckdb/function/function.hpp"
 #include "duckdb/function/replacement_scan.hpp"
+#include "duckdb/common/constants.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/multi_file_reader.hpp"
+#include "duckdb/storage/object_cache.hpp"
 
 #include "spatial/common.hpp"
 #include "spatial/core/types.hpp"
+#include "spatial/core/dynamic_spatial_filter.hpp"
 #include "spatial/gdal/functions.hpp"
 #include "spatial/gdal/file_handler.hpp"
+#include "spatial/gdal/module.hpp"
 #include "spatial/core/geometry/geometry_factory.hpp"
 #include "spatial/core/geometry/geometry_writer.hpp"
 #include "spatial/core/geometry/wkb_reader.hpp"
@@ -49,96 +62,703 @@ struct WKBSpatialFilter : SpatialFilter {
 	}
 };
 
-// TODO: Verify that this actually corresponds to the same sql subset expected by OGR SQL
-static string FilterToGdal(const TableFilter &filter, const string &column_name) {
+//------------------------------------------------------------------------------
+// Attribute filter pushdown
+//------------------------------------------------------------------------------
+// Filters are passed to GDAL as an OGR SQL attribute filter, which drivers like GPKG or PostgreSQL translate into
+// their own SQL so that attribute indexes can be used. Only constants that are written the same way in OGR SQL as in
+// DuckDB are passed on, anything else is left for DuckDB to evaluate.
+static bool TryConstantToGdal(const Value &value, string &result) {
+	switch (value.type().id()) {
+	case LogicalTypeId::TINYINT:
+	case LogicalTypeId::SMALLINT:
+	case LogicalTypeId::INTEGER:
+	case LogicalTypeId::BIGINT:
+	case LogicalTypeId::UTINYINT:
+	case LogicalTypeId::USMALLINT:
+	case LogicalTypeId::UINTEGER:
+	case LogicalTypeId::UBIGINT:
+	case LogicalTypeId::DECIMAL:
+		result = value.ToString();
+		return true;
+	case LogicalTypeId::FLOAT:
+	case LogicalTypeId::DOUBLE: {
+		auto dbl = value.GetValue<double>();
+		if (!std::isfinite(dbl)) {
+			return false;
+		}
+		result = value.ToString();
+		return true;
+	}
+	case LogicalTypeId::VARCHAR:
+		// Strings are quoted the same way in OGR SQL
+		result = value.ToSQLString();
+		return true;
+	default:
+		return false;
+	}
+}
+
+static bool TryFilterToGdal(const TableFilter &filter, const string &column_name, string &result) {
 
 	switch (filter.filter_type) {
 	case TableFilterType::CONSTANT_COMPARISON: {
 		auto &constant_filter = filter.Cast<ConstantFilter>();
-		return KeywordHelper::WriteOptionallyQuoted(column_name) +
-		       ExpressionTypeToOperator(constant_filter.comparison_type) + constant_filter.constant.ToSQLString();
+		string constant;
+		if (constant_filter.constant.IsNull() || !TryConstantToGdal(constant_filter.constant, constant)) {
+			return false;
+		}
+		result = KeywordHelper::WriteOptionallyQuoted(column_name) +
+		         ExpressionTypeToOperator(constant_filter.comparison_type) + constant;
+		return true;
 	}
 	case TableFilterType::CONJUNCTION_AND: {
 		auto &and_filter = filter.Cast<ConjunctionAndFilter>();
 		vector<string> filters;
 		for (const auto &child_filter : and_filter.child_filters) {
-			filters.push_back(FilterToGdal(*child_filter, column_name));
+			string child;
+			if (!TryFilterToGdal(*child_filter, column_name, child)) {
+				return false;
+			}
+			filters.push_back(child);
 		}
-		return StringUtil::Join(filters, " AND ");
+		result = "(" + StringUtil::Join(filters, " AND ") + ")";
+		return true;
 	}
 	case TableFilterType::CONJUNCTION_OR: {
 		auto &or_filter = filter.Cast<ConjunctionOrFilter>();
 		vector<string> filters;
 		for (const auto &child_filter : or_filter.child_filters) {
-			filters.push_back(FilterToGdal(*child_filter, column_name));
+			string child;
+			if (!TryFilterToGdal(*child_filter, column_name, child)) {
+				return false;
+			}
+			filters.push_back(child);
 		}
-		return StringUtil::Join(filters, " OR ");
+		result = "(" + StringUtil::Join(filters, " OR ") + ")";
+		return true;
 	}
 	case TableFilterType::IS_NOT_NULL: {
-		return KeywordHelper::WriteOptionallyQuoted(column_name) + " IS NOT NULL";
+		result = KeywordHelper::WriteOptionallyQuoted(column_name) + " IS NOT NULL";
+		return true;
 	}
 	case TableFilterType::IS_NULL: {
-		return KeywordHelper::WriteOptionallyQuoted(column_name) + " IS NULL";
+		result = KeywordHelper::WriteOptionallyQuoted(column_name) + " IS NULL";
+		return true;
 	}
 	default:
-		throw NotImplementedException("FilterToGdal: filter type not implemented");
+		return false;
 	}
 }
 
-static string FilterToGdal(const TableFilterSet &set, const vector<idx_t> &column_ids,
-                           const vector<string> &column_names) {
+//------------------------------------------------------------------------------
+// Dataset pool
+//------------------------------------------------------------------------------
+// Dataset handles of a file that are kept open between scans when reading with keep_open, e.g. from the views of an
+// attached GDAL database, so that a scan does not have to open the file again. A handle is only handed out again
+// while the file is unchanged.
+class GdalDatasetPool : public ObjectCacheEntry {
+public:
+	static string ObjectType() {
+		return "spatial_gdal_dataset_pool";
+	}
+	string GetObjectType() override {
+		return ObjectType();
+	}
+
+	// Take an idle handle of the given version of the file, or nullptr if there is none
+	GDALDatasetUniquePtr Take(time_t last_modified, idx_t file_size) {
+		lock_guard<mutex> guard(lock);
+		for (idx_t i = idle.size(); i > 0; i--) {
+			auto &entry = idle[i - 1];
+			if (entry.last_modified == last_modified && entry.file_size == file_size) {
+				auto dataset = std::move(entry.dataset);
+				idle.erase(idle.begin() + (i - 1));
+				return dataset;
+			}
+		}
+		return nullptr;
+	}
+
+	// Keep a handle for the next scan. Handles of other versions of the file are closed, and at most max_handles are
+	// kept open.
+	void Return(GDALDatasetUniquePtr dataset, time_t last_modified, idx_t file_size, idx_t max_handles) {
+		lock_guard<mutex> guard(lock);
+		idle.erase(std::remove_if(idle.begin(), idle.end(),
+		                          [&](const IdleDataset &entry) {
+			                          return entry.last_modified != last_modified || entry.file_size != file_size;
+		                          }),
+		           idle.end());
+		if (idle.size() < max_handles) {
+			idle.push_back(IdleDataset {last_modified, file_size, std::move(dataset)});
+		}
+	}
+
+private:
+	struct IdleDataset {
+		time_t last_modified;
+		idx_t file_size;
+		GDALDatasetUniquePtr dataset;
+	};
+	mutex lock;
+	vector<IdleDataset> idle;
+};
+
+// The pool of the file that is scanned and the version of the file at bind time. The states of a scan keep a copy, as
+// they return their handles when they are destroyed.
+struct GdalPooledFile {
+	shared_ptr<GdalDatasetPool> pool;
+	time_t last_modified = 0;
+	idx_t file_size = 0;
+	idx_t max_handles = 0;
+};
 
-	vector<string> filters;
-	for (auto &input_filter : set.filters) {
-		auto col_idx = column_ids[input_filter.first];
-		auto &col_name = column_names[col_idx];
-		filters.push_back(FilterToGdal(*input_filter.second, col_name));
+// Return a dataset handle to the pool of the file, if it has one, after undoing what the scan set on its layers.
+// Otherwise the handle is closed as usual.
+static void ReleaseDataset(const GdalPooledFile &file, GDALDatasetUniquePtr &dataset) {
+	if (!file.pool || !dataset) {
+		return;
 	}
-	return StringUtil::Join(filters, " AND ");
+	for (int layer_idx = 0; layer_idx < dataset->GetLayerCount(); layer_idx++) {
+		auto layer = dataset->GetLayer(layer_idx);
+		layer->SetSpatialFilter(nullptr);
+		layer->SetAttributeFilter(nullptr);
+		layer->SetIgnoredFields(nullptr);
+		layer->ResetReading();
+	}
+	file.pool->Return(std::move(dataset), file.last_modified, file.file_size, file.max_handles);
 }
 
-struct GdalScanFunctionData : public TableFunctionData {
+struct GdalScanFunctionData : public TableFunctionData, public core::DynamicSpatialFilterTarget {
 	int layer_idx;
 	bool sequential_layer_scan = false;
 	bool keep_wkb = false;
 	unordered_set<idx_t> geometry_column_ids;
 	unique_ptr<SpatialFilter> spatial_filter;
+	// The extent of the build side of a spatial join that this scan is the probe side of, narrows the rectangle
+	shared_ptr<core::DynamicSpatialFilter> join_filter;
 	idx_t max_threads;
 	// before they are renamed
 	vector<string> all_names;
 	vector<LogicalType> all_types;
-	ArrowTableType arrow_table;
+	// Whether the columns of the Arrow stream are the attribute fields followed by the geometry fields of the layer,
+	// so that columns that are not scanned can be mapped to fields for OGR to ignore
+	bool can_ignore_fields = false;
+
+	// OGR SQL for filter expressions that stay in the plan but narrow down what GDAL returns, e.g. IN lists and LIKE
+	vector<string> attribute_filters;
+
+	// Scan the layer in FID ranges with a dataset handle per thread, if the driver supports it
+	bool parallel_scan = true;
+	idx_t max_batch_size = STANDARD_VECTOR_SIZE;
+	// The bytes the Arrow batches should take, from the "spatial_gdal_batch_target_size" setting. Unless it is 0 or
+	// max_batch_size was given, the features per batch are chosen from the size of the first features of the layer.
+	idx_t batch_target_size = 0;
 
 	bool has_approximate_feature_count;
 	idx_t approximate_feature_count;
 	string raw_file_name;
 	string prefixed_file_name;
+	// The VSI prefix of the client, that routes the file names through the DuckDB file system
+	string vsi_prefix;
+
+	// All the files to read, when given a list of files or a glob pattern. The first file is raw_file_name.
+	vector<string> file_names;
+	// The layer to read from every file, if it was selected by name
+	string layer_name;
+	bool union_by_name = false;
+	// The index of the extra column with the name of the file, if requested
+	idx_t filename_column_idx = DConstants::INVALID_INDEX;
+
+	// Set with layer = '*', to read every layer of every file, with the name of the layer in an extra column
+	bool all_layers = false;
+	struct LayerPart {
+		idx_t file_idx;
+		int layer_idx;
+		string layer_name;
+	};
+	// The layers that are read with all_layers, ordered by file and then by layer
+	vector<LayerPart> layer_parts;
+	idx_t layer_name_column_idx = DConstants::INVALID_INDEX;
 	CPLStringList dataset_open_options;
 	CPLStringList dataset_allowed_drivers;
 	CPLStringList dataset_sibling_files;
 	CPLStringList layer_creation_options;
+
+	// The dataset opened during the bind, taken over by the first global init so it does not open the file again
+	mutable mutex bound_dataset_lock;
+	mutable GDALDatasetUniquePtr bound_dataset;
+
+	// Only set with keep_open, for a single file that can be recognized as unchanged
+	GdalPooledFile pooled_file;
+
+	// Multiple files or layers are read one per thread at a time, instead of splitting up the layer of a single file
+	bool IsMultiFile() const {
+		return file_names.size() > 1 || filename_column_idx != DConstants::INVALID_INDEX || all_layers;
+	}
+
+	// The files or layers that are read one per thread
+	idx_t PartCount() const {
+		return all_layers ? layer_parts.size() : file_names.size();
+	}
+
+	idx_t GetPartFileIndex(idx_t part_idx) const {
+		return all_layers ? layer_parts[part_idx].file_idx : part_idx;
+	}
+
+	// OGR filters on the first geometry field, so only take the filter if the layer has a single one
+	bool TryAddDynamicFilter(column_t column_id, shared_ptr<core::DynamicSpatialFilter> filter) override {
+		if (keep_wkb || geometry_column_ids.size() != 1 || geometry_column_ids.count(column_id) == 0) {
+			return false;
+		}
+		if (spatial_filter && spatial_filter->type != SpatialFilterType::Rectangle) {
+			return false;
+		}
+		join_filter = std::move(filter);
+		return true;
+	}
+
+	// The rectangle to filter on, if any: the spatial filter narrowed down to the extent of the join
+	bool TryGetFilterRectangle(core::BoundingBox &result) const {
+		auto has_rect = spatial_filter && spatial_filter->type == SpatialFilterType::Rectangle;
+		if (has_rect) {
+			auto &rect = (RectangleSpatialFilter &)*spatial_filter;
+			result.minx = rect.min_x;
+			result.miny = rect.min_y;
+			result.maxx = rect.max_x;
+			result.maxy = rect.max_y;
+		}
+		core::BoundingBox extent;
+		if (!join_filter || !join_filter->TryGetExtent(extent)) {
+			return has_rect;
+		}
+		if (!has_rect) {
+			result = extent;
+			return true;
+		}
+		result.minx = MaxValue(result.minx, extent.minx);
+		result.miny = MaxValue(result.miny, extent.miny);
+		result.maxx = MinValue(result.maxx, extent.maxx);
+		result.maxy = MinValue(result.maxy, extent.maxy);
+		return true;
+	}
+
+	// Whether no feature can pass the filter rectangle, because the rectangles it was narrowed down from are disjoint.
+	// OGR would read the features in the gap between them instead.
+	bool IsFilterEmpty() const {
+		core::BoundingBox rect;
+		return TryGetFilterRectangle(rect) && (rect.minx > rect.maxx || rect.miny > rect.maxy);
+	}
 };
 
 struct GdalScanLocalState : ArrowScanLocalState {
 	core::GeometryFactory factory;
 	// We trust GDAL to produce valid WKB
 	core::WKBReader wkb_reader;
+
+	// The scanned columns as ids into the bind data, column_ids holds them as ids into the Arrow stream instead
+	vector<column_t> scan_column_ids;
+
+	// Only used when scanning in FID ranges or multiple files: the dataset handle of this thread, and the stream and
+	// index of the range or file that is currently being read
+	GDALDatasetUniquePtr dataset;
+	unique_ptr<ArrowArrayStreamWrapper> range_stream;
+	idx_t range_idx = 0;
+	idx_t range_batch = 0;
+
+	// Only used when scanning multiple files: the columns of the Arrow stream of the current file, and for every
+	// scanned column the index of the same column in the stream, or INVALID_INDEX if the file does not have it
+	ArrowTableType file_arrow_table;
+	unordered_set<idx_t> file_geometry_ids;
+	vector<idx_t> file_column_map;
+	DataChunk file_chunk;
+
+	GdalPooledFile pooled_file;
+
 	explicit GdalScanLocalState(unique_ptr<ArrowArrayWrapper> current_chunk, ClientContext &context)
 	    : ArrowScanLocalState(std::move(current_chunk)), factory(BufferAllocator::Get(context)),
 	      wkb_reader(factory.allocator) {
 	}
+
+	~GdalScanLocalState() override {
+		// The stream has to be released before its dataset
+		range_stream.reset();
+		ReleaseDataset(pooled_file, dataset);
+	}
+};
+
+struct FIDRange {
+	int64_t min_fid;
+	int64_t max_fid;
 };
 
 struct GdalScanGlobalState : ArrowScanGlobalState {
 	GDALDatasetUniquePtr dataset;
 	atomic<idx_t> lines_read;
-	explicit GdalScanGlobalState(GDALDatasetUniquePtr dataset) : dataset(std::move(dataset)), lines_read(0) {
+
+	// The fields OGR does not have to read, and the types and ids of the columns of the resulting Arrow stream
+	CPLStringList ignored_fields;
+	ArrowTableType arrow_table;
+	vector<column_t> arrow_column_ids;
+	// The features per Arrow batch, chosen when the first layer is opened, and the layer creation options with it
+	atomic<idx_t> batch_size;
+	CPLStringList stream_options;
+
+	// Set when the layer is scanned in FID ranges instead of through a single stream
+	vector<FIDRange> fid_ranges;
+	// The next FID range, or the next file when scanning multiple files
+	atomic<idx_t> next_range;
+	idx_t batches_per_range = 0;
+	string fid_column;
+	string attribute_filter;
+	// Set when the spatial filter can not match any feature, the scan returns no rows then
+	bool empty_filter = false;
+	// The table filters that can not be expressed in OGR SQL, by index into the scanned columns. DuckDB does not
+	// evaluate pushed down table filters itself, so these are applied to the scanned chunks instead.
+	vector<std::pair<idx_t, const TableFilter *>> duckdb_filters;
+
+	GdalPooledFile pooled_file;
+
+	explicit GdalScanGlobalState(GDALDatasetUniquePtr dataset)
+	    : dataset(std::move(dataset)), lines_read(0), batch_size(0), next_range(0) {
+	}
+
+	~GdalScanGlobalState() override {
+		stream.reset();
+		ReleaseDataset(pooled_file, dataset);
+	}
+
+	bool IsRangeScan() const {
+		return !fid_ranges.empty();
 	}
 };
 
 //------------------------------------------------------------------------------
 // Bind
 //------------------------------------------------------------------------------
+static GDALDatasetUniquePtr OpenDataset(const GdalScanFunctionData &data, const string &raw_file_name) {
+	auto prefixed_file_name = data.vsi_prefix + raw_file_name;
+	auto dataset = GDALDatasetUniquePtr(
+	    GDALDataset::Open(prefixed_file_name.c_str(), GDAL_OF_VECTOR | GDAL_OF_VERBOSE_ERROR,
+	                      data.dataset_allowed_drivers, data.dataset_open_options, data.dataset_sibling_files));
+	if (dataset == nullptr) {
+		auto error = string(CPLGetLastErrorMsg());
+		throw IOException("Could not open file: " + raw_file_name + " (" + error + ")");
+	}
+	return dataset;
+}
+
+static GDALDatasetUniquePtr OpenDataset(const GdalScanFunctionData &data) {
+	return OpenDataset(data, data.raw_file_name);
+}
+
+// Take a handle from the pool of the file if there is an idle one, otherwise open the dataset
+static GDALDatasetUniquePtr AcquireDataset(const GdalScanFunctionData &data) {
+	auto &file = data.pooled_file;
+	if (file.pool) {
+		auto dataset = file.pool->Take(file.last_modified, file.file_size);
+		if (dataset) {
+			return dataset;
+		}
+	}
+	return OpenDataset(data);
+}
+
+// The value of the ARROW:extension:name key in the metadata of an Arrow attribute, or an empty string if there is none.
+// The metadata is an int32 pair count followed by the pairs, each an int32 length prefixed key and value.
+static string GetArrowExtensionName(const ArrowSchema &attribute) {
+	if (attribute.metadata == nullptr) {
+		return string();
+	}
+	auto ptr = attribute.metadata;
+	auto read_string = [&]() {
+		int32_t length;
+		memcpy(&length, ptr, sizeof(int32_t));
+		ptr += sizeof(int32_t);
+		string result(ptr, static_cast<size_t>(length));
+		ptr += length;
+		return result;
+	};
+	int32_t pair_count;
+	memcpy(&pair_count, ptr, sizeof(int32_t));
+	ptr += sizeof(int32_t);
+	for (int32_t i = 0; i < pair_count; i++) {
+		auto key = read_string();
+		auto value = read_string();
+		if (key == "ARROW:extension:name") {
+			return value;
+		}
+	}
+	return string();
+}
+
+// Arrow attributes with these extension names hold WKB geometries
+static bool IsGeometryAttribute(const string &extension_name, const LogicalType &type) {
+	return type.id() == LogicalTypeId::BLOB && (extension_name == "ogc.wkb" || extension_name == "geoarrow.wkb");
+}
+
+// Arrow attributes in the separated GeoArrow coordinate layouts have the same layout as the native geometry types, so
+// they are read as the native type without converting them. Returns false for the interleaved layouts and for
+// coordinates the native types can not hold.
+static bool TryGetNativeGeometryType(const string &extension_name, const LogicalType &type, LogicalType &result) {
+	if (!StringUtil::StartsWith(extension_name, "geoarrow.")) {
+		return false;
+	}
+	// The types are compared without the alias of the native types
+	auto xy = LogicalType::STRUCT({{"x", LogicalType::DOUBLE}, {"y", LogicalType::DOUBLE}});
+	auto xyz =
+	    LogicalType::STRUCT({{"x", LogicalType::DOUBLE}, {"y", LogicalType::DOUBLE}, {"z", LogicalType::DOUBLE}});
+	auto xyzm = LogicalType::STRUCT({{"x", LogicalType::DOUBLE},
+	                                 {"y", LogicalType::DOUBLE},
+	                                 {"z", LogicalType::DOUBLE},
+	                                 {"m", LogicalType::DOUBLE}});
+
+	vector<std::pair<LogicalType, LogicalType>> candidates;
+	if (extension_name == "geoarrow.point") {
+		candidates = {{xy, core::GeoTypes::POINT_2D()},
+		              {xyz, core::GeoTypes::POINT_3D()},
+		              {xyzm, core::GeoTypes::POINT_4D()}};
+	} else if (extension_name == "geoarrow.linestring") {
+		candidates = {{LogicalType::LIST(xy), core::GeoTypes::LINESTRING_2D()}};
+	} else if (extension_name == "geoarrow.polygon") {
+		candidates = {{LogicalType::LIST(LogicalType::LIST(xy)), core::GeoTypes::POLYGON_2D()}};
+	} else if (extension_name == "geoarrow.multipoint") {
+		candidates = {{LogicalType::LIST(xy), core::GeoTypes::MULTIPOINT_2D()}};
+	} else if (extension_name == "geoarrow.multilinestring") {
+		candidates = {{LogicalType::LIST(LogicalType::LIST(xy)), core::GeoTypes::MULTILINESTRING_2D()}};
+	} else if (extension_name == "geoarrow.multipolygon") {
+		candidates = {
+		    {LogicalType::LIST(LogicalType::LIST(LogicalType::LIST(xy))), core::GeoTypes::MULTIPOLYGON_2D()}};
+	}
+	for (auto &candidate : candidates) {
+		if (type == candidate.first) {
+			result = candidate.second;
+			return true;
+		}
+	}
+	return false;
+}
+
+// The name a column of the layer gets in the result, before duplicates are renamed
+static string GetBoundColumnName(const string &name, bool is_geometry, bool keep_wkb) {
+	if (is_geometry && !keep_wkb && name == "wkb_geometry") {
+		return "geom";
+	}
+	return name;
+}
+
+// The columns of a layer, as returned by its Arrow stream
+struct GdalLayerSchema {
+	vector<string> names;
+	vector<LogicalType> types;
+	unordered_set<idx_t> geometry_column_ids;
+	bool can_ignore_fields = false;
+	// Only set once the feature count was asked for, -1 if the driver can not tell it cheaply
+	bool has_feature_count = false;
+	int64_t feature_count = -1;
+};
+
+// The layers of a dataset and the schema of the layers that were bound so far, kept in the object cache of the
+// database so that binding a query on a file that has not changed does not have to open it.
+class GdalDatasetCacheEntry : public ObjectCacheEntry {
+public:
+	time_t last_modified = 0;
+	idx_t file_size = 0;
+	vector<string> layer_names;
+
+	static string ObjectType() {
+		return "spatial_gdal_dataset";
+	}
+	string GetObjectType() override {
+		return ObjectType();
+	}
+
+	bool TryGetLayerSchema(idx_t layer_idx, GdalLayerSchema &result) {
+		lock_guard<mutex> guard(lock);
+		if (layer_idx >= layer_schemas.size() || !layer_schemas[layer_idx]) {
+			return false;
+		}
+		result = *layer_schemas[layer_idx];
+		return true;
+	}
+
+	void SetLayerSchema(idx_t layer_idx, const GdalLayerSchema &schema) {
+		lock_guard<mutex> guard(lock);
+		if (layer_idx >= layer_schemas.size()) {
+			layer_schemas.resize(layer_idx + 1);
+		}
+		layer_schemas[layer_idx] = make_uniq<GdalLayerSchema>(schema);
+	}
+
+private:
+	mutex lock;
+	vector<unique_ptr<GdalLayerSchema>> layer_schemas;
+};
+
+// Everything that changes how the dataset is opened is part of the key
+static string GetDatasetCacheKey(const GdalScanFunctionData &data, const string &file_name) {
+	string key = "spatial_gdal_dataset:" + file_name;
+	for (auto &list : {&data.dataset_open_options, &data.dataset_allowed_drivers, &data.dataset_sibling_files}) {
+		key += "|";
+		for (int i = 0; i < list->Count(); i++) {
+			key += string((*list)[i]) + ";";
+		}
+	}
+	return key;
+}
+
+// Get the modification time and size of a file through the DuckDB file system. Returns false for anything that can
+// not be opened as a file (e.g. directories or GDAL /vsi paths), which are then never cached.
+static bool TryGetFileVersion(FileSystem &fs, const string &file_name, time_t &last_modified, idx_t &file_size) {
+	try {
+		auto file = fs.OpenFile(file_name, FileFlags::FILE_FLAGS_READ);
+		last_modified = fs.GetLastModifiedTime(*file);
+		file_size = fs.GetFileSize(*file);
+		return true;
+	} catch (std::exception &) {
+		return false;
+	}
+}
+
+// Get the layers of a dataset from the cache if the file has not changed since it was cached, otherwise open the
+// dataset. dataset is only set if the dataset had to be opened.
+static shared_ptr<GdalDatasetCacheEntry> GetDatasetEntry(ClientContext &context, const GdalScanFunctionData &data,
+                                                         const string &file_name, GDALDatasetUniquePtr &dataset) {
+	auto cache_key = GetDatasetCacheKey(data, file_name);
+	auto &fs = FileSystem::GetFileSystem(context);
+	time_t last_modified = 0;
+	idx_t file_size = 0;
+	auto is_cacheable = TryGetFileVersion(fs, file_name, last_modified, file_size);
+
+	auto &cache = ObjectCache::GetObjectCache(context);
+	if (is_cacheable) {
+		auto cache_entry = cache.Get<GdalDatasetCacheEntry>(cache_key);
+		if (cache_entry && cache_entry->last_modified == last_modified && cache_entry->file_size == file_size) {
+			return cache_entry;
+		}
+	}
+
+	dataset = OpenDataset(data, file_name);
+
+	// Double check that the dataset have any layers
+	if (dataset->GetLayerCount() <= 0) {
+		throw IOException("Dataset does not contain any layers");
+	}
+
+	auto entry = make_shared<GdalDatasetCacheEntry>();
+	entry->last_modified = last_modified;
+	entry->file_size = file_size;
+	for (int layer_idx = 0; layer_idx < dataset->GetLayerCount(); layer_idx++) {
+		entry->layer_names.emplace_back(dataset->GetLayer(layer_idx)->GetName());
+	}
+
+	// Only datasets that consist of a single file can be recognized as unchanged by looking at that file
+	char **file_list = dataset->GetFileList();
+	if (is_cacheable && CSLCount(file_list) == 1) {
+		cache.Put(cache_key, entry);
+	}
+	CSLDestroy(file_list);
+	return entry;
+}
+
+// Find the pool of dataset handles of the file for keep_open. Like the dataset cache, only datasets that consist of a
+// single file are pooled. dataset is the dataset opened during the bind, if any.
+static void BindDatasetPool(ClientContext &context, GdalScanFunctionData &data, GDALDataset *dataset) {
+	auto &file = data.pooled_file;
+	if (!TryGetFileVersion(FileSystem::GetFileSystem(context), data.raw_file_name, file.last_modified,
+	                       file.file_size)) {
+		return;
+	}
+	if (dataset) {
+		char **file_list = dataset->GetFileList();
+		auto is_single_file = CSLCount(file_list) == 1;
+		CSLDestroy(file_list);
+		if (!is_single_file) {
+			return;
+		}
+	}
+	auto &cache = ObjectCache::GetObjectCache(context);
+	auto cache_key = GetDatasetCacheKey(data, data.raw_file_name) + "|pool";
+	file.pool = cache.GetOrCreate<GdalDatasetPool>(cache_key);
+	file.max_handles = data.max_threads;
+}
+
+static int GetLayerIndex(const GdalDatasetCacheEntry &entry, const Value &layer) {
+	auto layer_count = static_cast<int>(entry.layer_names.size());
+	if (layer.IsNull()) {
+		return 0;
+	}
+
+	// Find layer by index
+	if (layer.type() == LogicalType::INTEGER) {
+		auto layer_idx = IntegerValue::Get(layer);
+		if (layer_idx < 0) {
+			throw BinderException("Layer index must be positive");
+		}
+		if (layer_idx > layer_count) {
+			throw BinderException(StringUtil::Format("Layer index too large (%s > %s)", layer_idx, layer_count));
+		}
+		return layer_idx;
+	}
+
+	// Find layer by name
+	auto &name = StringValue::Get(layer);
+	for (auto layer_idx = 0; layer_idx < layer_count; layer_idx++) {
+		if (entry.layer_names[layer_idx] == name) {
+			return layer_idx;
+		}
+	}
+	throw BinderException(StringUtil::Format("Layer '%s' could not be found in dataset", name));
+}
+
+void GdalTableFunction::BindLayerSchema(OGRLayer *layer, const char *const *layer_creation_options,
+                                        GdalLayerSchema &schema) {
+	struct ArrowArrayStream stream;
+	if (!layer->GetArrowStream(&stream, layer_creation_options)) {
+		// layer is owned by GDAL, we do not need to destory it
+		throw IOException("Could not get arrow stream from layer");
+	}
+
+	struct ArrowSchema arrow_schema;
+	if (stream.get_schema(&stream, &arrow_schema) != 0) {
+		if (stream.release) {
+			stream.release(&stream);
+		}
+		throw IOException("Could not get arrow schema from layer");
+	}
+
+	// The Arrow API will return attributes in this order
+	// 1. FID column
+	// 2. all ogr field attributes
+	// 3. all geometry columns
+
+	auto attribute_count = arrow_schema.n_children;
+	auto attributes = arrow_schema.children;
+
+	for (idx_t col_idx = 0; col_idx < (idx_t)attribute_count; col_idx++) {
+		auto &attribute = *attributes[col_idx];
+
+		auto arrow_type = GetArrowType(attribute);
+		auto duckdb_type = arrow_type->GetDuckType();
+		auto extension_name = GetArrowExtensionName(attribute);
+
+		LogicalType native_type;
+		if (IsGeometryAttribute(extension_name, duckdb_type)) {
+			schema.geometry_column_ids.insert(col_idx);
+		} else if (TryGetNativeGeometryType(extension_name, duckdb_type, native_type)) {
+			duckdb_type = native_type;
+		}
+		schema.names.emplace_back(attribute.name);
+		schema.types.push_back(duckdb_type);
+	}
+
+	arrow_schema.release(&arrow_schema);
+	stream.release(&stream);
+
+	auto layer_defn = layer->GetLayerDefn();
+	schema.can_ignore_fields = attribute_count == layer_defn->GetFieldCount() + layer_defn->GetGeomFieldCount();
+}
+
 unique_ptr<FunctionData> GdalTableFunction::Bind(ClientContext &context, TableFunctionBindInput &input,
                                                  vector<LogicalType> &return_types, vector<string> &names) {
 
@@ -147,6 +767,8 @@ unique_ptr<FunctionData> GdalTableFunction::Bind(ClientContext &context, TableFu
 		throw PermissionException("Scanning GDAL files is disabled through configuration");
 	}
 
+	GdalModule::Initialize();
+
 	auto result = make_uniq<GdalScanFunctionData>();
 
 	// First scan for "options" parameter
@@ -172,62 +794,37 @@ unique_ptr<FunctionData> GdalTableFunction::Bind(ClientContext &context, TableFu
 		}
 	}
 
-	// Now we can open the dataset
 	auto &ctx_state = GDALClientContextState::GetOrCreate(context);
+	result->vsi_prefix = ctx_state.GetPrefix();
 
-	result->raw_file_name = input.inputs[0].GetValue<string>();
-	result->prefixed_file_name = ctx_state.GetPrefix() + result->raw_file_name;
-
-	auto dataset = GDALDatasetUniquePtr(GDALDataset::Open(
-	    result->prefixed_file_name.c_str(), GDAL_OF_VECTOR | GDAL_OF_VERBOSE_ERROR, result->dataset_allowed_drivers,
-	    result->dataset_open_options, result->dataset_sibling_files));
-
-	if (dataset == nullptr) {
-		auto error = string(CPLGetLastErrorMsg());
-		throw IOException("Could not open file: " + result->raw_file_name + " (" + error + ")");
-	}
-
-	// Double check that the dataset have any layers
-	if (dataset->GetLayerCount() <= 0) {
-		throw IOException("Dataset does not contain any layers");
+	// A list of files or a glob pattern is expanded through the DuckDB file system, anything else (e.g. GDAL /vsi
+	// paths or directories) is passed on to GDAL as is
+	auto &path = input.inputs[0];
+	if (path.type().id() == LogicalTypeId::LIST || FileSystem::HasGlob(StringValue::Get(path))) {
+		result->file_names = MultiFileReader::GetFileList(context, path, "ST_Read", FileGlobOptions::DISALLOW_EMPTY);
+	} else {
+		result->file_names.push_back(StringValue::Get(path));
 	}
+	result->raw_file_name = result->file_names[0];
+	result->prefixed_file_name = result->vsi_prefix + result->raw_file_name;
 
 	// Now we can bind the additonal options
+	Value layer_param;
+	bool filename_column = false;
 	bool max_batch_size_set = false;
+	bool keep_open = false;
 	for (auto &kv : input.named_parameters) {
 		auto loption = StringUtil::Lower(kv.first);
 		if (loption == "layer") {
-
-			// Find layer by index
-			if (kv.second.type() == LogicalType::INTEGER) {
-				auto layer_idx = IntegerValue::Get(kv.second);
-				if (layer_idx < 0) {
-					throw BinderException("Layer index must be positive");
-				}
-				if (layer_idx > dataset->GetLayerCount()) {
-					throw BinderException(
-					    StringUtil::Format("Layer index too large (%s > %s)", layer_idx, dataset->GetLayerCount()));
-				}
-				result->layer_idx = layer_idx;
-			}
-
-			// Find layer by name
-			if (kv.second.type() == LogicalTypeId::VARCHAR) {
-				auto name = StringValue::Get(kv.second).c_str();
-				bool found = false;
-				for (auto layer_idx = 0; layer_idx < dataset->GetLayerCount(); layer_idx++) {
-					if (strcmp(dataset->GetLayer(layer_idx)->GetName(), name) == 0) {
-						result->layer_idx = layer_idx;
-						found = true;
-						break;
-					}
-				}
-				if (!found) {
-					throw BinderException(StringUtil::Format("Layer '%s' could not be found in dataset", name));
+			layer_param = kv.second;
+			if (kv.second.type().id() == LogicalTypeId::VARCHAR) {
+				result->layer_name = StringValue::Get(kv.second);
+				if (result->layer_name == "*") {
+					result->all_layers = true;
+					result->layer_name.clear();
 				}
 			}
 		}
-
 		if (loption == "spatial_filter_box" && kv.second.type() == core::GeoTypes::BOX_2D()) {
 			if (result->spatial_filter) {
 				throw BinderException("Only one spatial filter can be specified");
@@ -267,12 +864,29 @@ unique_ptr<FunctionData> GdalTableFunction::Bind(ClientContext &context, TableFu
 			}
 			auto str = StringUtil::Format("MAX_FEATURES_IN_BATCH=%d", max_batch_size);
 			result->layer_creation_options.AddString(str.c_str());
+			result->max_batch_size = (idx_t)max_batch_size;
 			max_batch_size_set = true;
 		}
 
+		if (loption == "parallel_scan") {
+			result->parallel_scan = BooleanValue::Get(kv.second);
+		}
+
 		if (loption == "keep_wkb") {
 			result->keep_wkb = BooleanValue::Get(kv.second);
 		}
+
+		if (loption == "filename") {
+			filename_column = BooleanValue::Get(kv.second);
+		}
+
+		if (loption == "union_by_name") {
+			result->union_by_name = BooleanValue::Get(kv.second);
+		}
+
+		if (loption == "keep_open") {
+			keep_open = BooleanValue::Get(kv.second);
+		}
 	}
 
 	// set default max_threads
@@ -286,87 +900,159 @@ unique_ptr<FunctionData> GdalTableFunction::Bind(ClientContext &context, TableFu
 		// Set default max batch size to standard vector size
 		auto str = StringUtil::Format("MAX_FEATURES_IN_BATCH=%d", STANDARD_VECTOR_SIZE);
 		result->layer_creation_options.AddString(str.c_str());
-	}
-
-	// Get the schema for the selected layer
-	auto layer = dataset->GetLayer(result->layer_idx);
 
-	// Check if we can get an approximate feature count
-	result->approximate_feature_count = 0;
-	result->has_approximate_feature_count = false;
-	if (!result->sequential_layer_scan) {
-		auto count = layer->GetFeatureCount();
-		if (count > -1) {
-			result->approximate_feature_count = count;
-			result->has_approximate_feature_count = true;
+		Value batch_target_size;
+		if (context.TryGetCurrentSetting("spatial_gdal_batch_target_size", batch_target_size) &&
+		    !batch_target_size.IsNull()) {
+			result->batch_target_size = DBConfig::ParseMemoryLimit(batch_target_size.ToString());
 		}
 	}
 
-	struct ArrowArrayStream stream;
-	if (!layer->GetArrowStream(&stream, result->layer_creation_options)) {
-		// layer is owned by GDAL, we do not need to destory it
-		throw IOException("Could not get arrow stream from layer");
-	}
-
-	struct ArrowSchema schema;
-	if (stream.get_schema(&stream, &schema) != 0) {
-		if (stream.release) {
-			stream.release(&stream);
+	// Get the schema of a layer of a file. Reuse the schemas of an earlier bind if the file has not changed since,
+	// otherwise open the dataset.
+	auto bind_layer_schema = [&](const string &file_name, GdalDatasetCacheEntry &cache_entry,
+	                             GDALDatasetUniquePtr &dataset, int layer_idx, GdalLayerSchema &schema) {
+		auto has_schema = cache_entry.TryGetLayerSchema(layer_idx, schema);
+		if (!has_schema || (!result->sequential_layer_scan && !schema.has_feature_count)) {
+			if (!dataset) {
+				dataset = OpenDataset(*result, file_name);
+			}
+			auto layer = dataset->GetLayer(layer_idx);
+			if (!has_schema) {
+				BindLayerSchema(layer, result->layer_creation_options, schema);
+			}
+			// Check if we can get the feature count without reading through the layer. Drivers that can not tell it
+			// cheaply return -1 instead of counting.
+			if (!result->sequential_layer_scan) {
+				schema.feature_count = layer->GetFeatureCount(FALSE);
+				schema.has_feature_count = true;
+			}
+			cache_entry.SetLayerSchema(layer_idx, schema);
 		}
-		throw IOException("Could not get arrow schema from layer");
-	}
-
-	// The Arrow API will return attributes in this order
-	// 1. FID column
-	// 2. all ogr field attributes
-	// 3. all geometry columns
+	};
+
+	// Get the schema of the selected layer of a file
+	auto bind_file_schema = [&](const string &file_name, GDALDatasetUniquePtr &dataset, GdalLayerSchema &schema) {
+		auto cache_entry = GetDatasetEntry(context, *result, file_name, dataset);
+		auto layer_idx = GetLayerIndex(*cache_entry, layer_param);
+		bind_layer_schema(file_name, *cache_entry, dataset, layer_idx, schema);
+		return layer_idx;
+	};
+
+	// Add the columns of a schema that are not bound yet, and widen the types of the columns whose type differs
+	// between the files. Columns are matched by name.
+	auto bind_columns_by_name = [&](const GdalLayerSchema &file_schema) {
+		for (idx_t col_idx = 0; col_idx < file_schema.names.size(); col_idx++) {
+			auto is_geometry = file_schema.geometry_column_ids.count(col_idx) != 0;
+			auto column_name = GetBoundColumnName(file_schema.names[col_idx], is_geometry, result->keep_wkb);
+			auto column_type = is_geometry ? (result->keep_wkb ? core::GeoTypes::WKB_BLOB()
+			                                                   : core::GeoTypes::GEOMETRY())
+			                               : file_schema.types[col_idx];
+
+			auto entry = std::find(result->all_names.begin(), result->all_names.end(), column_name);
+			if (entry == result->all_names.end()) {
+				if (is_geometry) {
+					result->geometry_column_ids.insert(result->all_names.size());
+				}
+				result->all_names.push_back(column_name);
+				return_types.push_back(column_type);
+				continue;
+			}
+			auto bound_idx = static_cast<idx_t>(entry - result->all_names.begin());
+			if (is_geometry) {
+				result->geometry_column_ids.insert(bound_idx);
+				return_types[bound_idx] = column_type;
+			} else if (result->geometry_column_ids.find(bound_idx) == result->geometry_column_ids.end() &&
+			           return_types[bound_idx] != column_type) {
+				return_types[bound_idx] = LogicalType::MaxLogicalType(return_types[bound_idx], column_type);
+			}
+		}
+	};
 
-	auto attribute_count = schema.n_children;
-	auto attributes = schema.children;
+	// An opened dataset is handed on to the global init, so it does not have to open the file again
+	GDALDatasetUniquePtr dataset;
+	GdalLayerSchema schema;
 
-	result->all_names.reserve(attribute_count + 1);
-	names.reserve(attribute_count + 1);
+	result->approximate_feature_count = 0;
+	result->has_approximate_feature_count = false;
 
-	for (idx_t col_idx = 0; col_idx < (idx_t)attribute_count; col_idx++) {
-		auto &attribute = *attributes[col_idx];
+	if (result->all_layers) {
+		// Every layer of every file is a part of its own, the layers generally have different columns so they are
+		// always combined by name
+		result->union_by_name = true;
+		result->has_approximate_feature_count = !result->sequential_layer_scan;
+		for (idx_t file_idx = 0; file_idx < result->file_names.size(); file_idx++) {
+			auto &file_name = result->file_names[file_idx];
+			GDALDatasetUniquePtr file_dataset;
+			auto cache_entry = GetDatasetEntry(context, *result, file_name, file_dataset);
+			for (int layer_idx = 0; layer_idx < static_cast<int>(cache_entry->layer_names.size()); layer_idx++) {
+				GdalLayerSchema layer_schema;
+				bind_layer_schema(file_name, *cache_entry, file_dataset, layer_idx, layer_schema);
+				bind_columns_by_name(layer_schema);
+				result->layer_parts.push_back({file_idx, layer_idx, cache_entry->layer_names[layer_idx]});
+				if (layer_schema.feature_count > -1) {
+					result->approximate_feature_count += layer_schema.feature_count;
+				} else {
+					result->has_approximate_feature_count = false;
+				}
+			}
+		}
+		result->layer_idx = 0;
+		result->layer_name_column_idx = result->all_names.size();
+		result->all_names.emplace_back("layer_name");
+		return_types.push_back(LogicalType::VARCHAR);
+	} else {
+		result->layer_idx = bind_file_schema(result->raw_file_name, dataset, schema);
 
-		const char ogc_flag[] = {'\x01', '\0', '\0', '\0', '\x14', '\0', '\0', '\0', 'A', 'R', 'R', 'O', 'W',
-		                         ':',    'e',  'x',  't',  'e',    'n',  's',  'i',  'o', 'n', ':', 'n', 'a',
-		                         'm',    'e',  '\a', '\0', '\0',   '\0', 'o',  'g',  'c', '.', 'w', 'k', 'b'};
+		if (!result->sequential_layer_scan && schema.feature_count > -1) {
+			// Assume the other files are about as large as the first one
+			result->approximate_feature_count = schema.feature_count * result->file_names.size();
+			result->has_approximate_feature_count = true;
+		}
 
-		auto arrow_type = GetArrowLogicalType(attribute);
-		auto column_name = string(attribute.name);
-		auto duckdb_type = arrow_type->GetDuckType();
+		result->all_names.reserve(schema.names.size());
+		names.reserve(schema.names.size());
 
-		if (duckdb_type.id() == LogicalTypeId::BLOB && attribute.metadata != nullptr &&
-		    strncmp(attribute.metadata, ogc_flag, sizeof(ogc_flag)) == 0) {
-			// This is a WKB geometry blob
-			result->arrow_table.AddColumn(col_idx, std::move(arrow_type));
+		for (idx_t col_idx = 0; col_idx < schema.names.size(); col_idx++) {
+			auto is_geometry = schema.geometry_column_ids.count(col_idx) != 0;
+			auto column_name = GetBoundColumnName(schema.names[col_idx], is_geometry, result->keep_wkb);
 
-			if (result->keep_wkb) {
-				return_types.emplace_back(core::GeoTypes::WKB_BLOB());
-			} else {
-				return_types.emplace_back(core::GeoTypes::GEOMETRY());
-				if (column_name == "wkb_geometry") {
-					column_name = "geom";
+			if (is_geometry) {
+				// This is a WKB geometry blob
+				if (result->keep_wkb) {
+					return_types.emplace_back(core::GeoTypes::WKB_BLOB());
+				} else {
+					return_types.emplace_back(core::GeoTypes::GEOMETRY());
 				}
+				result->geometry_column_ids.insert(col_idx);
+			} else {
+				return_types.emplace_back(schema.types[col_idx]);
 			}
-			result->geometry_column_ids.insert(col_idx);
 
-		} else if (attribute.dictionary) {
-			auto dictionary_type = GetArrowLogicalType(attribute);
-			return_types.emplace_back(dictionary_type->GetDuckType());
-			arrow_type->SetDictionary(std::move(dictionary_type));
-			result->arrow_table.AddColumn(col_idx, std::move(arrow_type));
-		} else {
-			return_types.emplace_back(arrow_type->GetDuckType());
-			result->arrow_table.AddColumn(col_idx, std::move(arrow_type));
+			// keep these around for projection/filter pushdown later
+			// does GDAL even allow duplicate/missing names?
+			result->all_names.push_back(column_name);
+		}
+
+		// Add the columns of the other files that the first one does not have
+		if (result->union_by_name) {
+			for (idx_t file_idx = 1; file_idx < result->file_names.size(); file_idx++) {
+				GDALDatasetUniquePtr file_dataset;
+				GdalLayerSchema file_schema;
+				bind_file_schema(result->file_names[file_idx], file_dataset, file_schema);
+				bind_columns_by_name(file_schema);
+			}
 		}
+	}
 
-		// keep these around for projection/filter pushdown later
-		// does GDAL even allow duplicate/missing names?
-		result->all_names.push_back(column_name);
+	if (filename_column) {
+		result->filename_column_idx = result->all_names.size();
+		result->all_names.emplace_back("filename");
+		return_types.push_back(LogicalType::VARCHAR);
+	}
 
+	for (idx_t col_idx = 0; col_idx < result->all_names.size(); col_idx++) {
+		auto &column_name = result->all_names[col_idx];
 		if (column_name.empty()) {
 			names.push_back("v" + to_string(col_idx));
 		} else {
@@ -374,13 +1060,19 @@ unique_ptr<FunctionData> GdalTableFunction::Bind(ClientContext &context, TableFu
 		}
 	}
 
-	schema.release(&schema);
-	stream.release(&stream);
+	result->can_ignore_fields = schema.can_ignore_fields;
 
 	GdalTableFunction::RenameColumns(names);
 
 	result->all_types = return_types;
 
+	if (!result->IsMultiFile()) {
+		if (keep_open) {
+			BindDatasetPool(context, *result, dataset.get());
+		}
+		result->bound_dataset = std::move(dataset);
+	}
+
 	return std::move(result);
 };
 
@@ -416,71 +1108,384 @@ idx_t GdalTableFunction::MaxThreads(ClientContext &context, const FunctionData *
 //-----------------------------------------------------------------------------
 // Init global
 //-----------------------------------------------------------------------------
-unique_ptr<GlobalTableFunctionState> GdalTableFunction::InitGlobal(ClientContext &context,
-                                                                   TableFunctionInitInput &input) {
-	auto &data = input.bind_data->Cast<GdalScanFunctionData>();
-
-	auto dataset = GDALDatasetUniquePtr(
-	    GDALDataset::Open(data.prefixed_file_name.c_str(), GDAL_OF_VECTOR | GDAL_OF_VERBOSE_ERROR,
-	                      data.dataset_allowed_drivers, data.dataset_open_options, data.dataset_sibling_files));
-	if (dataset == nullptr) {
-		auto error = string(CPLGetLastErrorMsg());
-		throw IOException("Could not open file: " + data.raw_file_name + " (" + error + ")");
+static void SetSpatialFilter(const GdalScanFunctionData &data, OGRLayer *layer) {
+	core::BoundingBox rect;
+	if (data.TryGetFilterRectangle(rect)) {
+		layer->SetSpatialFilterRect(rect.minx, rect.miny, rect.maxx, rect.maxy);
+	} else if (data.spatial_filter && data.spatial_filter->type == SpatialFilterType::Wkb) {
+		auto &filter = (WKBSpatialFilter &)*data.spatial_filter;
+		layer->SetSpatialFilter(OGRGeometry::FromHandle(filter.geom));
 	}
+}
 
-	auto global_state = make_uniq<GdalScanGlobalState>(std::move(dataset));
-	auto &gstate = *global_state;
+// The features read from the start of a layer to estimate how large its features are
+static constexpr idx_t BATCH_SAMPLE_FEATURES = 256;
+// The bounds of the features per batch chosen for the "spatial_gdal_batch_target_size" setting
+static constexpr idx_t MIN_ADAPTIVE_BATCH_SIZE = 64;
+static constexpr idx_t MAX_ADAPTIVE_BATCH_SIZE = 32 * STANDARD_VECTOR_SIZE;
+
+// Choose the features per Arrow batch so that a batch takes about "spatial_gdal_batch_target_size" bytes: fewer for
+// wide layers with large geometries, so that a batch still fits in the cache while it is converted, and more for
+// narrow layers such as points, so that the overhead of a batch is spread over more features. The size of a feature
+// is measured on the first features of the layer, in the fields that are not ignored, after which it is rewound.
+static idx_t ChooseBatchSize(const GdalScanFunctionData &data, OGRLayer *layer) {
+	if (data.batch_target_size == 0 || data.sequential_layer_scan) {
+		// Layers that are scanned sequentially can not be rewound
+		return data.max_batch_size;
+	}
+	idx_t feature_count = 0;
+	idx_t total_size = 0;
+	OGRFeature *feature;
+	while (feature_count < BATCH_SAMPLE_FEATURES && (feature = layer->GetNextFeature()) != nullptr) {
+		auto layer_defn = feature->GetDefnRef();
+		for (int i = 0; i < feature->GetFieldCount(); i++) {
+			auto field_defn = layer_defn->GetFieldDefn(i);
+			if (field_defn->IsIgnored()) {
+				continue;
+			}
+			if (field_defn->GetType() == OFTString) {
+				// The offset and the characters of the string
+				total_size += sizeof(uint32_t);
+				if (feature->IsFieldSetAndNotNull(i)) {
+					total_size += strlen(feature->GetFieldAsString(i));
+				}
+			} else if (field_defn->GetType() == OFTBinary) {
+				int binary_size = 0;
+				feature->GetFieldAsBinary(i, &binary_size);
+				total_size += sizeof(uint32_t) + static_cast<idx_t>(binary_size);
+			} else {
+				total_size += sizeof(int64_t);
+			}
+		}
+		for (int i = 0; i < feature->GetGeomFieldCount(); i++) {
+			if (layer_defn->GetGeomFieldDefn(i)->IsIgnored()) {
+				continue;
+			}
+			auto geometry = feature->GetGeomFieldRef(i);
+			total_size += sizeof(uint32_t) + (geometry ? geometry->WkbSize() : 0);
+		}
+		feature_count++;
+		OGRFeature::DestroyFeature(feature);
+	}
+	layer->ResetReading();
+	if (feature_count == 0) {
+		return data.max_batch_size;
+	}
+	auto feature_size = MaxValue<idx_t>(total_size / feature_count, 1);
+	auto batch_size = MinValue<idx_t>(data.batch_target_size / feature_size, MAX_ADAPTIVE_BATCH_SIZE);
+	return MaxValue<idx_t>(batch_size, MIN_ADAPTIVE_BATCH_SIZE);
+}
 
-	// Open the layer
-	OGRLayer *layer = nullptr;
-	if (data.sequential_layer_scan) {
-		// Get the layer from the dataset by scanning through the layers
-		for (int i = 0; i < gstate.dataset->GetLayerCount(); i++) {
-			layer = gstate.dataset->GetLayer(i);
-			if (i == data.layer_idx) {
-				// desired layer found
-				break;
+// The layer creation options of the bind, with the features per batch that were chosen for the layer
+static CPLStringList GetStreamOptions(const GdalScanFunctionData &data, idx_t batch_size) {
+	CPLStringList options(data.layer_creation_options);
+	options.SetNameValue("MAX_FEATURES_IN_BATCH", to_string(batch_size).c_str());
+	return options;
+}
+
+// Don't bother splitting layers that fit in a few batches
+static constexpr idx_t MIN_BATCHES_PER_RANGE = 8;
+// Make more ranges than threads, so that threads that got a cheap range can pick up another one
+static constexpr idx_t RANGES_PER_THREAD = 4;
+
+// Split the layer into ranges of FIDs that are each read through their own dataset handle. Only done for drivers
+// that pass attribute filters on to SQLite, where a filter on the FID column is a range scan over the rowid, so
+// that every thread only reads its own part of the file.
+static void TryCreateFIDRanges(const GdalScanFunctionData &data, GdalScanGlobalState &gstate, OGRLayer *layer) {
+	if (!data.parallel_scan || data.sequential_layer_scan || data.max_threads <= 1) {
+		return;
+	}
+	auto driver_name = string(gstate.dataset->GetDriver()->GetDescription());
+	if (driver_name != "GPKG" && driver_name != "SQLite") {
+		return;
+	}
+	auto fid_column = string(layer->GetFIDColumn());
+	if (fid_column.empty()) {
+		return;
+	}
+
+	auto fid_column_sql = KeywordHelper::WriteQuoted(fid_column, '"');
+	auto query = "SELECT MIN(" + fid_column_sql + "), MAX(" + fid_column_sql + ") FROM " +
+	             KeywordHelper::WriteQuoted(layer->GetName(), '"');
+	auto result = gstate.dataset->ExecuteSQL(query.c_str(), nullptr, nullptr);
+	if (!result) {
+		return;
+	}
+	int64_t min_fid = 0;
+	int64_t max_fid = -1;
+	auto feature = result->GetNextFeature();
+	if (feature) {
+		if (feature->IsFieldSetAndNotNull(0) && feature->IsFieldSetAndNotNull(1)) {
+			min_fid = feature->GetFieldAsInteger64(0);
+			max_fid = feature->GetFieldAsInteger64(1);
+		}
+		OGRFeature::DestroyFeature(feature);
+	}
+	gstate.dataset->ReleaseResultSet(result);
+	if (max_fid < min_fid) {
+		return;
+	}
+
+	auto fid_count = static_cast<uint64_t>(max_fid - min_fid) + 1;
+	idx_t batch_size = gstate.batch_size;
+	auto min_range_size = batch_size * MIN_BATCHES_PER_RANGE;
+	auto range_count = MinValue<uint64_t>(fid_count / min_range_size, data.max_threads * RANGES_PER_THREAD);
+	if (range_count <= 1) {
+		return;
+	}
+	auto range_size = (fid_count + range_count - 1) / range_count;
+	for (uint64_t offset = 0; offset < fid_count; offset += range_size) {
+		auto range_min = min_fid + static_cast<int64_t>(offset);
+		auto range_max = min_fid + static_cast<int64_t>(MinValue<uint64_t>(offset + range_size, fid_count) - 1);
+		gstate.fid_ranges.push_back({range_min, range_max});
+	}
+	// A range yields at most one batch per batch_size features. Batch indices are assigned per range and in FID order,
+	// so that the insertion order is still preserved.
+	gstate.batches_per_range = (range_size + batch_size - 1) / batch_size + 1;
+	gstate.fid_column = fid_column;
+}
+
+// Move the local state on to the next chunk of the FID range it is reading, or to the first chunk of the next range
+// that has not been claimed yet. Returns false once all ranges have been read.
+static bool RangeScanStateNext(const GdalScanFunctionData &data, GdalScanLocalState &state,
+                               GdalScanGlobalState &gstate) {
+	while (true) {
+		if (state.range_stream) {
+			auto chunk = state.range_stream->GetNextChunk();
+			if (chunk->arrow_array.release) {
+				if (chunk->arrow_array.length == 0) {
+					continue;
+				}
+				state.Reset();
+				state.chunk = std::move(chunk);
+				state.batch_index = state.range_idx * gstate.batches_per_range + state.range_batch++;
+				return true;
 			}
-			// else scan through and empty the layer
-			OGRFeature *feature;
-			while ((feature = layer->GetNextFeature()) != nullptr) {
-				OGRFeature::DestroyFeature(feature);
+			// The layer can only have one stream at a time
+			state.range_stream.reset();
+		}
+
+		auto range_idx = gstate.next_range++;
+		if (range_idx >= gstate.fid_ranges.size()) {
+			return false;
+		}
+		if (!state.dataset) {
+			state.dataset = AcquireDataset(data);
+		}
+
+		auto &range = gstate.fid_ranges[range_idx];
+		auto fid_column_sql = KeywordHelper::WriteQuoted(gstate.fid_column, '"');
+		auto filter_clause = fid_column_sql + " >= " + to_string(range.min_fid) + " AND " + fid_column_sql +
+		                     " <= " + to_string(range.max_fid);
+		if (!gstate.attribute_filter.empty()) {
+			filter_clause = "(" + gstate.attribute_filter + ") AND " + filter_clause;
+		}
+
+		auto layer = state.dataset->GetLayer(data.layer_idx);
+		SetSpatialFilter(data, layer);
+		layer->SetIgnoredFields(const_cast<const char **>(gstate.ignored_fields.List()));
+		if (layer->SetAttributeFilter(filter_clause.c_str()) != OGRERR_NONE) {
+			throw IOException("Could not set attribute filter on layer");
+		}
+		state.range_stream = make_uniq<ArrowArrayStreamWrapper>();
+		if (!layer->GetArrowStream(&state.range_stream->arrow_array_stream, gstate.stream_options)) {
+			throw IOException("Could not get arrow stream");
+		}
+		state.range_idx = range_idx;
+		state.range_batch = 0;
+	}
+}
+
+// Let OGR skip the fields and geometry fields that are not scanned, so they are never read or converted to Arrow. The
+// Arrow stream then only has the scanned columns, still in their original order. Returns the number of columns the
+// Arrow stream is expected to have.
+static idx_t SetIgnoredFields(const GdalScanFunctionData &data, GdalScanGlobalState &gstate, OGRLayer *layer,
+                              const vector<column_t> &column_ids) {
+	gstate.arrow_column_ids = column_ids;
+	if (!data.can_ignore_fields) {
+		return data.all_names.size();
+	}
+
+	vector<bool> scanned(data.all_names.size(), false);
+	for (auto &col_idx : column_ids) {
+		if (col_idx != COLUMN_IDENTIFIER_ROW_ID) {
+			scanned[col_idx] = true;
+		}
+	}
+	if (!scanned.empty() && std::find(scanned.begin(), scanned.end(), true) == scanned.end()) {
+		// Keep one column, so that the batches still say how many features they contain
+		scanned[0] = true;
+	}
+
+	auto layer_defn = layer->GetLayerDefn();
+	auto field_count = static_cast<idx_t>(layer_defn->GetFieldCount());
+	vector<column_t> arrow_idx(scanned.size(), 0);
+	column_t arrow_column_count = 0;
+	for (idx_t col_idx = 0; col_idx < scanned.size(); col_idx++) {
+		if (scanned[col_idx]) {
+			arrow_idx[col_idx] = arrow_column_count++;
+		} else if (col_idx < field_count) {
+			gstate.ignored_fields.AddString(layer_defn->GetFieldDefn(static_cast<int>(col_idx))->GetNameRef());
+		} else {
+			auto geom_field_name = layer_defn->GetGeomFieldDefn(static_cast<int>(col_idx - field_count))->GetNameRef();
+			// Drivers with a single unnamed geometry field (e.g. shapefiles)
+			gstate.ignored_fields.AddString(geom_field_name[0] != '\0' ? geom_field_name : "OGR_GEOMETRY");
+		}
+	}
+
+	if (layer->SetIgnoredFields(const_cast<const char **>(gstate.ignored_fields.List())) != OGRERR_NONE) {
+		// Some field could not be found by name, read all of them instead
+		layer->SetIgnoredFields(nullptr);
+		gstate.ignored_fields.Clear();
+		return data.all_names.size();
+	}
+	for (auto &col_idx : gstate.arrow_column_ids) {
+		if (col_idx != COLUMN_IDENTIFIER_ROW_ID) {
+			col_idx = arrow_idx[col_idx];
+		}
+	}
+	return arrow_column_count;
+}
+
+// Translate the table filters and the filter expressions collected during the complex filter pushdown into one
+// OGR SQL attribute filter. Filters on the geometry columns or the row id, and filters that can not be translated, are
+// kept to be evaluated by the scan.
+static void SetAttributeFilter(const GdalScanFunctionData &data, GdalScanGlobalState &gstate,
+                               TableFunctionInitInput &input) {
+	vector<string> filters = data.attribute_filters;
+	if (input.filters) {
+		for (auto &entry : input.filters->filters) {
+			auto col_idx = input.column_ids[entry.first];
+			string filter;
+			if (col_idx != COLUMN_IDENTIFIER_ROW_ID &&
+			    data.geometry_column_ids.find(col_idx) == data.geometry_column_ids.end() &&
+			    TryFilterToGdal(*entry.second, data.all_names[col_idx], filter)) {
+				filters.push_back(filter);
+			} else {
+				gstate.duckdb_filters.emplace_back(entry.first, entry.second.get());
 			}
 		}
-	} else {
-		// Otherwise get the layer directly
-		layer = gstate.dataset->GetLayer(data.layer_idx);
 	}
+	gstate.attribute_filter = StringUtil::Join(filters, " AND ");
+}
 
-	// Apply spatial filter (if we got one)
-	if (data.spatial_filter != nullptr) {
-		if (data.spatial_filter->type == SpatialFilterType::Rectangle) {
-			auto &rect = (RectangleSpatialFilter &)*data.spatial_filter;
-			layer->SetSpatialFilterRect(rect.min_x, rect.min_y, rect.max_x, rect.max_y);
-		} else if (data.spatial_filter->type == SpatialFilterType::Wkb) {
-			auto &filter = (WKBSpatialFilter &)*data.spatial_filter;
-			layer->SetSpatialFilter(OGRGeometry::FromHandle(filter.geom));
+static OGRLayer *OpenLayer(const GdalScanFunctionData &data, GDALDataset &dataset, int layer_idx) {
+	if (!data.sequential_layer_scan) {
+		// Get the layer directly
+		return dataset.GetLayer(layer_idx);
+	}
+	// Otherwise get the layer from the dataset by scanning through the layers
+	OGRLayer *layer = nullptr;
+	for (int i = 0; i < dataset.GetLayerCount(); i++) {
+		layer = dataset.GetLayer(i);
+		if (i == layer_idx) {
+			// desired layer found
+			break;
+		}
+		// else scan through and empty the layer
+		OGRFeature *feature;
+		while ((feature = layer->GetNextFeature()) != nullptr) {
+			OGRFeature::DestroyFeature(feature);
 		}
 	}
-	// TODO: Apply projection pushdown
+	return layer;
+}
+
+// Every file is read by a single thread, from its own dataset handle, so no dataset is opened up front. The files
+// can have different fields, so all the table filters are evaluated by the scan.
+static unique_ptr<GlobalTableFunctionState> InitMultiFileGlobal(ClientContext &context, TableFunctionInitInput &input) {
+	auto &data = input.bind_data->Cast<GdalScanFunctionData>();
+	auto global_state = make_uniq<GdalScanGlobalState>(nullptr);
+	auto &gstate = *global_state;
+	gstate.empty_filter = data.IsFilterEmpty();
 
-	// Apply predicate pushdown
-	// We simply create a string out of the predicates and pass it to GDAL.
 	if (input.filters) {
-		auto filter_clause = FilterToGdal(*input.filters, input.column_ids, data.all_names);
-		layer->SetAttributeFilter(filter_clause.c_str());
+		for (auto &entry : input.filters->filters) {
+			gstate.duckdb_filters.emplace_back(entry.first, entry.second.get());
+		}
 	}
+	gstate.max_threads =
+	    MinValue<idx_t>(GdalTableFunction::MaxThreads(context, input.bind_data.get()), data.PartCount());
 
-	// Create arrow stream from layer
+	if (input.CanRemoveFilterColumns()) {
+		gstate.projection_ids = input.projection_ids;
+		for (const auto &col_idx : input.column_ids) {
+			if (col_idx == COLUMN_IDENTIFIER_ROW_ID) {
+				gstate.scanned_types.emplace_back(LogicalType::ROW_TYPE);
+			} else {
+				gstate.scanned_types.push_back(data.all_types[col_idx]);
+			}
+		}
+	}
+	return std::move(global_state);
+}
+
+unique_ptr<GlobalTableFunctionState> GdalTableFunction::InitGlobal(ClientContext &context,
+                                                                   TableFunctionInitInput &input) {
+	auto &data = input.bind_data->Cast<GdalScanFunctionData>();
+	if (data.IsMultiFile()) {
+		return InitMultiFileGlobal(context, input);
+	}
+
+	GDALDatasetUniquePtr dataset;
+	{
+		lock_guard<mutex> guard(data.bound_dataset_lock);
+		dataset = std::move(data.bound_dataset);
+	}
+	if (!dataset) {
+		dataset = AcquireDataset(data);
+	}
+	auto global_state = make_uniq<GdalScanGlobalState>(std::move(dataset));
+	auto &gstate = *global_state;
+	gstate.pooled_file = data.pooled_file;
+
+	// Open the layer
+	auto layer = OpenLayer(data, *gstate.dataset, data.layer_idx);
+
+	// Apply spatial filter (if we got one)
+	SetSpatialFilter(data, layer);
+	gstate.empty_filter = data.IsFilterEmpty();
+
+	// Apply projection pushdown
+	auto arrow_column_count = SetIgnoredFields(data, gstate, layer, input.column_ids);
+
+	// Apply predicate pushdown
+	SetAttributeFilter(data, gstate, input);
 
+	gstate.max_threads = GdalTableFunction::MaxThreads(context, input.bind_data.get());
+
+	gstate.batch_size = ChooseBatchSize(data, layer);
+	gstate.stream_options = GetStreamOptions(data, gstate.batch_size);
+	GdalIOMetrics::RecordBatchSize(gstate.batch_size);
+
+	TryCreateFIDRanges(data, gstate, layer);
+	if (!gstate.IsRangeScan() && !gstate.attribute_filter.empty()) {
+		layer->SetAttributeFilter(gstate.attribute_filter.c_str());
+	}
+
+	// Create arrow stream from layer
 	gstate.stream = make_uniq<ArrowArrayStreamWrapper>();
 
 	// set layer options
-	if (!layer->GetArrowStream(&gstate.stream->arrow_array_stream, data.layer_creation_options)) {
+	if (!layer->GetArrowStream(&gstate.stream->arrow_array_stream, gstate.stream_options)) {
 		throw IOException("Could not get arrow stream");
 	}
 
-	gstate.max_threads = GdalTableFunction::MaxThreads(context, input.bind_data.get());
+	// The types of the columns that are left after the projection pushdown
+	ArrowSchemaWrapper schema;
+	gstate.stream->GetSchema(schema);
+	if ((idx_t)schema.arrow_schema.n_children != arrow_column_count) {
+		throw IOException("Arrow stream of layer does not have the expected number of columns");
+	}
+	for (idx_t arrow_idx = 0; arrow_idx < (idx_t)schema.arrow_schema.n_children; arrow_idx++) {
+		gstate.arrow_table.AddColumn(arrow_idx, GetArrowType(*schema.arrow_schema.children[arrow_idx]));
+	}
+
+	if (gstate.IsRangeScan()) {
+		// Every thread reads whole ranges through its own dataset handle, the stream was only needed for the schema
+		gstate.stream.reset();
+		gstate.max_threads = MinValue<idx_t>(gstate.max_threads, gstate.fid_ranges.size());
+	}
 
 	if (input.CanRemoveFilterColumns()) {
 		gstate.projection_ids = input.projection_ids;
@@ -496,6 +1501,228 @@ unique_ptr<GlobalTableFunctionState> GdalTableFunction::InitGlobal(ClientContext
 	return std::move(global_state);
 }
 
+unique_ptr<ArrowType> GdalTableFunction::GetArrowType(ArrowSchema &attribute) {
+	auto arrow_type = GetArrowLogicalType(attribute);
+	if (attribute.dictionary) {
+		arrow_type->SetDictionary(GetArrowLogicalType(attribute));
+	}
+	return arrow_type;
+}
+
+// Batch indices are assigned per file and in file order, so that the insertion order is still preserved
+static constexpr idx_t MAX_BATCHES_PER_FILE = idx_t(1) << 24;
+
+// Move the local state on to the next chunk of the file it is reading. Returns false once the file has been read, in
+// which case its dataset is closed.
+static bool MultiFileStreamNext(GdalScanLocalState &state) {
+	while (state.range_stream) {
+		auto chunk = state.range_stream->GetNextChunk();
+		if (chunk->arrow_array.release) {
+			if (chunk->arrow_array.length == 0) {
+				continue;
+			}
+			if (state.range_batch >= MAX_BATCHES_PER_FILE) {
+				throw IOException("Too many batches in a single file, try a larger 'max_batch_size'");
+			}
+			state.Reset();
+			state.chunk = std::move(chunk);
+			state.batch_index = state.range_idx * MAX_BATCHES_PER_FILE + state.range_batch++;
+			return true;
+		}
+		state.range_stream.reset();
+		state.dataset.reset();
+	}
+	return false;
+}
+
+// Files in a Hive partition named quadkey, as written by COPY ... PARTITION_BY (quadkey) with the key computed by
+// ST_QuadKey, only hold points in the web mercator tile of the key. Returns false for files in no such partition.
+static bool TryGetQuadKeyPartitionBox(const string &file_name, core::BoundingBox &bbox) {
+	static constexpr char PARTITION_PREFIX[] = "quadkey=";
+	for (auto &segment : StringUtil::Split(StringUtil::Replace(file_name, "\\", "/"), '/')) {
+		if (!StringUtil::StartsWith(segment, PARTITION_PREFIX)) {
+			continue;
+		}
+		auto key = segment.substr(sizeof(PARTITION_PREFIX) - 1);
+		if (key.empty() || key.size() > 23 || key.find_first_not_of("0123") != string::npos) {
+			return false;
+		}
+		uint32_t x = 0;
+		uint32_t y = 0;
+		for (auto digit : key) {
+			x = (x << 1) | ((digit - '0') & 1);
+			y = (y << 1) | ((digit - '0') >> 1);
+		}
+		auto tile_count = static_cast<double>(1u << key.size());
+		auto latitude = [&](double row) {
+			return std::atan(std::sinh(PI * (1 - 2 * row / tile_count))) * 180.0 / PI;
+		};
+		// ST_QuadKey clamps coordinates outside of the web mercator square into the tiles along its edges
+		auto last = (1u << key.size()) - 1;
+		auto infinity = NumericLimits<double>::Maximum();
+		bbox.minx = x == 0 ? -infinity : x / tile_count * 360.0 - 180.0;
+		bbox.maxx = x == last ? infinity : (x + 1) / tile_count * 360.0 - 180.0;
+		bbox.miny = y == last ? -infinity : latitude(y + 1);
+		bbox.maxy = y == 0 ? infinity : latitude(y);
+		return true;
+	}
+	return false;
+}
+
+// Whether a file can be skipped because it is in a quadkey partition that the spatial filter does not intersect
+static bool IsPrunedPartition(const GdalScanFunctionData &data, const string &file_name) {
+	core::BoundingBox filter;
+	auto has_rect = data.TryGetFilterRectangle(filter);
+	if (!has_rect && !data.spatial_filter) {
+		return false;
+	}
+	core::BoundingBox partition;
+	if (!TryGetQuadKeyPartitionBox(file_name, partition)) {
+		return false;
+	}
+	if (!has_rect) {
+		auto &wkb_filter = (WKBSpatialFilter &)*data.spatial_filter;
+		OGREnvelope envelope;
+		OGR_G_GetEnvelope(wkb_filter.geom, &envelope);
+		filter.minx = envelope.MinX;
+		filter.miny = envelope.MinY;
+		filter.maxx = envelope.MaxX;
+		filter.maxy = envelope.MaxY;
+	}
+	return !partition.Intersects(filter);
+}
+
+// Open the layer of the next file (or with all_layers, the next layer) that has not been claimed yet and start
+// streaming it. Files in partitions that the spatial filter misses are not opened at all. Returns false once all files
+// have been claimed.
+static bool MultiFileOpenNext(const GdalScanFunctionData &data, GdalScanLocalState &state,
+                              GdalScanGlobalState &gstate) {
+	idx_t part_idx;
+	do {
+		part_idx = gstate.next_range++;
+		if (part_idx >= data.PartCount()) {
+			return false;
+		}
+	} while (IsPrunedPartition(data, data.file_names[data.GetPartFileIndex(part_idx)]));
+	auto &file_name = data.file_names[data.GetPartFileIndex(part_idx)];
+	// Every layer gets a dataset handle of its own, so that the layers of a single file are read in parallel too
+	state.dataset = OpenDataset(data, file_name);
+
+	// Layers selected by name may be at a different index in every file
+	auto layer_idx = data.layer_idx;
+	if (data.all_layers) {
+		layer_idx = data.layer_parts[part_idx].layer_idx;
+		if (layer_idx >= state.dataset->GetLayerCount()) {
+			throw IOException(StringUtil::Format("Layer index too large for dataset: %s", file_name));
+		}
+	} else if (!data.layer_name.empty()) {
+		layer_idx = -1;
+		for (int i = 0; i < state.dataset->GetLayerCount(); i++) {
+			if (data.layer_name == state.dataset->GetLayer(i)->GetName()) {
+				layer_idx = i;
+				break;
+			}
+		}
+		if (layer_idx < 0) {
+			throw IOException(
+			    StringUtil::Format("Layer '%s' could not be found in dataset: %s", data.layer_name, file_name));
+		}
+	} else if (layer_idx >= state.dataset->GetLayerCount()) {
+		throw IOException(StringUtil::Format("Layer index too large for dataset: %s", file_name));
+	}
+
+	auto layer = OpenLayer(data, *state.dataset, layer_idx);
+	SetSpatialFilter(data, layer);
+
+	// The features per batch are chosen for the first file that is opened, and used for all of them
+	idx_t batch_size = gstate.batch_size;
+	if (batch_size == 0) {
+		auto chosen = ChooseBatchSize(data, layer);
+		if (gstate.batch_size.compare_exchange_strong(batch_size, chosen)) {
+			batch_size = chosen;
+			GdalIOMetrics::RecordBatchSize(batch_size);
+		}
+	}
+	state.range_stream = make_uniq<ArrowArrayStreamWrapper>();
+	if (!layer->GetArrowStream(&state.range_stream->arrow_array_stream, GetStreamOptions(data, batch_size))) {
+		throw IOException("Could not get arrow stream");
+	}
+	state.range_idx = part_idx;
+	state.range_batch = 0;
+	return true;
+}
+
+bool GdalTableFunction::ScanStateNext(ClientContext &context, const FunctionData *bind_data,
+                                      ArrowScanLocalState &state_p, ArrowScanGlobalState &gstate_p) {
+	auto &state = state_p.Cast<GdalScanLocalState>();
+	auto &gstate = gstate_p.Cast<GdalScanGlobalState>();
+	auto &data = bind_data->Cast<GdalScanFunctionData>();
+	if (gstate.empty_filter) {
+		return false;
+	}
+	if (data.IsMultiFile()) {
+		while (!MultiFileStreamNext(state)) {
+			if (!MultiFileOpenNext(data, state, gstate)) {
+				return false;
+			}
+
+			// The Arrow stream of the file is read as a whole, then mapped to the scanned columns by name
+			ArrowSchemaWrapper schema;
+			state.range_stream->GetSchema(schema);
+			state.file_arrow_table = ArrowTableType();
+			state.file_geometry_ids.clear();
+			state.column_ids.clear();
+			vector<string> file_names;
+			vector<LogicalType> file_types;
+			for (idx_t arrow_idx = 0; arrow_idx < (idx_t)schema.arrow_schema.n_children; arrow_idx++) {
+				auto &attribute = *schema.arrow_schema.children[arrow_idx];
+				auto arrow_type = GetArrowType(attribute);
+				auto file_type = arrow_type->GetDuckType();
+				auto extension_name = GetArrowExtensionName(attribute);
+				auto is_geometry = IsGeometryAttribute(extension_name, file_type);
+				LogicalType native_type;
+				if (is_geometry) {
+					state.file_geometry_ids.insert(arrow_idx);
+					file_type = data.keep_wkb ? core::GeoTypes::WKB_BLOB() : core::GeoTypes::GEOMETRY();
+				} else if (TryGetNativeGeometryType(extension_name, file_type, native_type)) {
+					file_type = native_type;
+				}
+				file_names.push_back(GetBoundColumnName(attribute.name, is_geometry, data.keep_wkb));
+				file_types.push_back(file_type);
+				state.file_arrow_table.AddColumn(arrow_idx, std::move(arrow_type));
+				state.column_ids.push_back(arrow_idx);
+			}
+			state.file_chunk.Destroy();
+			state.file_chunk.Initialize(context, file_types);
+
+			state.file_column_map.clear();
+			for (auto &column_id : state.scan_column_ids) {
+				if (column_id == COLUMN_IDENTIFIER_ROW_ID || column_id == data.filename_column_idx ||
+				    column_id == data.layer_name_column_idx) {
+					state.file_column_map.push_back(DConstants::INVALID_INDEX);
+					continue;
+				}
+				auto &column_name = data.all_names[column_id];
+				auto entry = std::find(file_names.begin(), file_names.end(), column_name);
+				if (entry == file_names.end() && !data.union_by_name) {
+					throw InvalidInputException(
+					    "Column '%s' could not be found in file '%s', set 'union_by_name' to read files with different "
+					    "columns",
+					    column_name, data.file_names[data.GetPartFileIndex(state.range_idx)]);
+				}
+				state.file_column_map.push_back(entry == file_names.end()
+				                                    ? DConstants::INVALID_INDEX
+				                                    : static_cast<idx_t>(entry - file_names.begin()));
+			}
+		}
+		return true;
+	}
+	if (gstate.IsRangeScan()) {
+		return RangeScanStateNext(data, state, gstate);
+	}
+	return ArrowScanParallelStateNext(context, bind_data, state, gstate);
+}
+
 //-----------------------------------------------------------------------------
 // Init Local
 //-----------------------------------------------------------------------------
@@ -503,16 +1730,18 @@ unique_ptr<LocalTableFunctionState> GdalTableFunction::InitLocal(ExecutionContex
                                                                  TableFunctionInitInput &input,
                                                                  GlobalTableFunctionState *global_state_p) {
 
-	auto &global_state = global_state_p->Cast<ArrowScanGlobalState>();
+	auto &global_state = global_state_p->Cast<GdalScanGlobalState>();
 	auto current_chunk = make_uniq<ArrowArrayWrapper>();
 	auto result = make_uniq<GdalScanLocalState>(std::move(current_chunk), context.client);
-	result->column_ids = input.column_ids;
+	result->column_ids = global_state.arrow_column_ids;
+	result->scan_column_ids = input.column_ids;
 	result->filters = input.filters.get();
+	result->pooled_file = global_state.pooled_file;
 	if (input.CanRemoveFilterColumns()) {
 		result->all_columns.Initialize(context.client, global_state.scanned_types);
 	}
 
-	if (!ArrowScanParallelStateNext(context.client, input.bind_data.get(), *result, global_state)) {
+	if (!ScanStateNext(context.client, input.bind_data.get(), *result, global_state)) {
 		return nullptr;
 	}
 
@@ -522,6 +1751,91 @@ unique_ptr<LocalTableFunctionState> GdalTableFunction::InitLocal(ExecutionContex
 //-----------------------------------------------------------------------------
 // Scan
 //-----------------------------------------------------------------------------
+// Filter the chunk by the table filters on either the geometry or the attribute columns that GDAL could not evaluate.
+// Returns false if no rows are left.
+static bool ApplyDuckDBFilters(const GdalScanFunctionData &data, const GdalScanLocalState &state,
+                               const GdalScanGlobalState &gstate, DataChunk &chunk, bool geometry_columns,
+                               SelectionVector &sel, idx_t &approved_count) {
+	auto count = chunk.size();
+	for (auto &entry : gstate.duckdb_filters) {
+		auto column_id = state.scan_column_ids[entry.first];
+		if ((data.geometry_column_ids.find(column_id) != data.geometry_column_ids.end()) != geometry_columns) {
+			continue;
+		}
+		auto &vec = chunk.data[entry.first];
+		vec.Flatten(count);
+		ColumnSegment::FilterSelection(sel, vec, *entry.second, approved_count, FlatVector::Validity(vec));
+	}
+	if (approved_count == 0) {
+		return false;
+	}
+	if (approved_count < count) {
+		chunk.Slice(sel, approved_count);
+		// The selection is relative to the sliced chunk from now on
+		sel.Initialize(nullptr);
+	}
+	return true;
+}
+
+// Convert the WKB of the geometry columns to GEOMETRY, directly from the Arrow buffers. Arrow batches are fetched
+// under the lock of the global state but converted by the thread that fetched them, so with several threads the
+// conversion of one batch overlaps with GDAL producing the next.
+static void ConvertGeometryColumns(const GdalScanFunctionData &data, GdalScanLocalState &state, DataChunk &chunk) {
+	auto count = chunk.size();
+	state.factory.allocator.Reset();
+	for (idx_t col_idx = 0; col_idx < state.scan_column_ids.size(); col_idx++) {
+		auto mapped_idx = state.scan_column_ids[col_idx];
+		if (data.geometry_column_ids.find(mapped_idx) == data.geometry_column_ids.end()) {
+			continue;
+		}
+		auto &wkb_vec = chunk.data[col_idx];
+		Vector geom_vec(core::GeoTypes::GEOMETRY(), count);
+		UnaryExecutor::Execute<string_t, core::geometry_t>(wkb_vec, geom_vec, count, [&](string_t input) {
+			return state.wkb_reader.Transcode(geom_vec, input, state.factory.double_bbox);
+		});
+		chunk.data[col_idx].ReferenceAndSetType(geom_vec);
+	}
+}
+
+// Read the next rows of the current file and map its columns to the scanned columns, casting them to the types of the
+// bound columns. Columns the file does not have are NULL.
+static void ScanFileColumns(ClientContext &context, const GdalScanFunctionData &data, GdalScanLocalState &state,
+                            DataChunk &scan_chunk, idx_t count) {
+	auto &file_chunk = state.file_chunk;
+	file_chunk.Reset();
+	file_chunk.SetCardinality(count);
+	ArrowToDuckDB(state, state.file_arrow_table.GetColumns(), file_chunk, 0, false);
+
+	if (!data.keep_wkb) {
+		state.factory.allocator.Reset();
+		for (auto &col_idx : state.file_geometry_ids) {
+			auto &wkb_vec = file_chunk.data[col_idx];
+			Vector geom_vec(core::GeoTypes::GEOMETRY(), count);
+			UnaryExecutor::Execute<string_t, core::geometry_t>(wkb_vec, geom_vec, count, [&](string_t input) {
+				return state.wkb_reader.Transcode(geom_vec, input, state.factory.double_bbox);
+			});
+			wkb_vec.ReferenceAndSetType(geom_vec);
+		}
+	}
+
+	for (idx_t col_idx = 0; col_idx < state.scan_column_ids.size(); col_idx++) {
+		auto &result = scan_chunk.data[col_idx];
+		auto column_id = state.scan_column_ids[col_idx];
+		auto file_idx = state.file_column_map[col_idx];
+		if (column_id == data.filename_column_idx) {
+			result.Reference(Value(data.file_names[data.GetPartFileIndex(state.range_idx)]));
+		} else if (column_id == data.layer_name_column_idx) {
+			result.Reference(Value(data.layer_parts[state.range_idx].layer_name));
+		} else if (file_idx == DConstants::INVALID_INDEX) {
+			result.Reference(Value(result.GetType()));
+		} else if (file_chunk.data[file_idx].GetType() == result.GetType()) {
+			result.Reference(file_chunk.data[file_idx]);
+		} else {
+			VectorOperations::Cast(context, file_chunk.data[file_idx], result, count);
+		}
+	}
+}
+
 void GdalTableFunction::Scan(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
 	if (!input.local_state) {
 		return;
@@ -530,48 +1844,59 @@ void GdalTableFunction::Scan(ClientContext &context, TableFunctionInput &input,
 	auto &state = input.local_state->Cast<GdalScanLocalState>();
 	auto &gstate = input.global_state->Cast<GdalScanGlobalState>();
 
-	//! Out of tuples in this chunk
-	if (state.chunk_offset >= (idx_t)state.chunk->arrow_array.length) {
-		if (!ArrowScanParallelStateNext(context, input.bind_data.get(), state, gstate)) {
+	while (true) {
+		//! Out of tuples in this chunk
+		if (state.chunk_offset >= (idx_t)state.chunk->arrow_array.length) {
+			if (!ScanStateNext(context, input.bind_data.get(), state, gstate)) {
+				return;
+			}
+		}
+		auto output_size =
+		    MinValue<idx_t>(STANDARD_VECTOR_SIZE, state.chunk->arrow_array.length - state.chunk_offset);
+		gstate.lines_read += output_size;
+
+		// The chunk with all the scanned columns, including the ones that are only needed for filtering
+		auto &scan_chunk = gstate.CanRemoveFilterColumns() ? state.all_columns : output;
+		scan_chunk.Reset();
+		scan_chunk.SetCardinality(output_size);
+		if (data.IsMultiFile()) {
+			ScanFileColumns(context, data, state, scan_chunk, output_size);
+			state.chunk_offset += output_size;
+			idx_t approved_count = output_size;
+			SelectionVector sel;
+			if (!ApplyDuckDBFilters(data, state, gstate, scan_chunk, false, sel, approved_count) ||
+			    !ApplyDuckDBFilters(data, state, gstate, scan_chunk, true, sel, approved_count)) {
+				continue;
+			}
+			if (gstate.CanRemoveFilterColumns()) {
+				output.ReferenceColumns(state.all_columns, gstate.projection_ids);
+			}
+			output.Verify();
 			return;
 		}
-	}
-	auto output_size = MinValue<idx_t>(STANDARD_VECTOR_SIZE, state.chunk->arrow_array.length - state.chunk_offset);
-	gstate.lines_read += output_size;
-
-	if (gstate.CanRemoveFilterColumns()) {
-		state.all_columns.Reset();
-		state.all_columns.SetCardinality(output_size);
-		ArrowToDuckDB(state, data.arrow_table.GetColumns(), state.all_columns, gstate.lines_read - output_size, false);
-		output.ReferenceColumns(state.all_columns, gstate.projection_ids);
-	} else {
-		output.SetCardinality(output_size);
-		ArrowToDuckDB(state, data.arrow_table.GetColumns(), output, gstate.lines_read - output_size, false);
-	}
+		ArrowToDuckDB(state, gstate.arrow_table.GetColumns(), scan_chunk, gstate.lines_read - output_size, false);
+		state.chunk_offset += output_size;
+
+		// Evaluate the filters that GDAL could not, those on attribute columns first so that only the geometries of
+		// the rows that pass them have to be converted
+		idx_t approved_count = output_size;
+		SelectionVector sel;
+		if (!ApplyDuckDBFilters(data, state, gstate, scan_chunk, false, sel, approved_count)) {
+			continue;
+		}
+		if (!data.keep_wkb) {
+			ConvertGeometryColumns(data, state, scan_chunk);
+		}
+		if (!ApplyDuckDBFilters(data, state, gstate, scan_chunk, true, sel, approved_count)) {
+			continue;
+		}
 
-	if (!data.keep_wkb) {
-		// Find the geometry columns
-		for (idx_t col_idx = 0; col_idx < state.column_ids.size(); col_idx++) {
-			auto mapped_idx = state.column_ids[col_idx];
-			if (data.geometry_column_ids.find(mapped_idx) != data.geometry_column_ids.end()) {
-				// Found a geometry column
-				// Convert the WKB columns to a geometry column
-				state.factory.allocator.Reset();
-				auto &wkb_vec = output.data[col_idx];
-				Vector geom_vec(core::GeoTypes::GEOMETRY(), output_size);
-				UnaryExecutor::Execute<string_t, core::geometry_t>(wkb_vec, geom_vec, output_size, [&](string_t input) {
-					auto geometry = state.wkb_reader.Deserialize(input);
-					auto has_z = state.wkb_reader.GeomHasZ();
-					auto has_m = state.wkb_reader.GeomHasM();
-					return state.factory.Serialize(geom_vec, geometry, has_z, has_m);
-				});
-				output.data[col_idx].ReferenceAndSetType(geom_vec);
-			}
+		if (gstate.CanRemoveFilterColumns()) {
+			output.ReferenceColumns(state.all_columns, gstate.projection_ids);
 		}
+		output.Verify();
+		return;
 	}
-
-	output.Verify();
-	state.chunk_offset += output.size();
 }
 
 unique_ptr<NodeStatistics> GdalTableFunction::Cardinality(ClientContext &context, const FunctionData *data) {
@@ -581,10 +1906,243 @@ unique_ptr<NodeStatistics> GdalTableFunction::Cardinality(ClientContext &context
 	if (gdal_data.has_approximate_feature_count) {
 		result->has_estimated_cardinality = true;
 		result->estimated_cardinality = gdal_data.approximate_feature_count;
+		// The count of a single layer is exact, the count of multiple files is extrapolated from the first one
+		if (gdal_data.file_names.size() == 1 || gdal_data.all_layers) {
+			result->has_max_cardinality = true;
+			result->max_cardinality = gdal_data.approximate_feature_count;
+		}
 	}
 	return result;
 }
 
+double GdalTableFunction::Progress(ClientContext &context, const FunctionData *bind_data_p,
+                                   const GlobalTableFunctionState *global_state) {
+	auto &data = bind_data_p->Cast<GdalScanFunctionData>();
+	auto &gstate = global_state->Cast<GdalScanGlobalState>();
+
+	// The features read so far, before any filters, against the feature count of the layer
+	if (data.has_approximate_feature_count && data.approximate_feature_count > 0) {
+		auto progress = 100.0 * (double)gstate.lines_read / (double)data.approximate_feature_count;
+		return MinValue<double>(progress, 100.0);
+	}
+	// Otherwise the files or FID ranges that have been claimed
+	idx_t part_count = data.IsMultiFile() ? data.PartCount() : gstate.fid_ranges.size();
+	if (part_count > 0) {
+		auto claimed = MinValue<idx_t>(gstate.next_range, part_count);
+		return 100.0 * (double)claimed / (double)part_count;
+	}
+	return -1;
+}
+
+//-----------------------------------------------------------------------------
+// Spatial filter pushdown
+//-----------------------------------------------------------------------------
+// Filters like ST_Intersects(geom, <constant geometry>) imply that the bounding box of the geometry column intersects
+// the bounding box of the constant. Pass that box on to GDAL as a spatial filter, so that drivers with a spatial index
+// (e.g. GeoPackage, FlatGeobuf, shapefiles with a .qix file) can skip features without reading them. The filter
+// itself is kept, as GDAL only guarantees that the bounding boxes intersect. For ST_DWithin the box of the constant is
+// expanded by the (constant) distance first.
+static bool TryGetConstantBoundingBox(ClientContext &context, const Expression &expr, core::BoundingBox &bbox) {
+	if (!expr.IsFoldable() || expr.return_type != core::GeoTypes::GEOMETRY()) {
+		return false;
+	}
+	Value value;
+	if (!ExpressionExecutor::TryEvaluateScalar(context, expr, value) || value.IsNull()) {
+		return false;
+	}
+	auto &blob = StringValue::Get(value);
+	return core::GeometryFactory::TryGetSerializedBoundingBox(core::geometry_t(string_t(blob)), bbox);
+}
+
+static bool TryGetConstantDistance(ClientContext &context, const Expression &expr, double &distance) {
+	if (!expr.IsFoldable()) {
+		return false;
+	}
+	Value value;
+	if (!ExpressionExecutor::TryEvaluateScalar(context, expr, value) || value.IsNull() ||
+	    !value.DefaultTryCastAs(LogicalType::DOUBLE)) {
+		return false;
+	}
+	distance = value.GetValue<double>();
+	return std::isfinite(distance) && distance >= 0;
+}
+
+static void PushdownSpatialFilter(ClientContext &context, LogicalGet &get, GdalScanFunctionData &data,
+                                  BoundFunctionExpression &func) {
+	if (data.keep_wkb) {
+		return;
+	}
+	if (data.spatial_filter && data.spatial_filter->type != SpatialFilterType::Rectangle) {
+		return;
+	}
+	// OGR filters on the first geometry field, so only push down the filter if the layer has a single one
+	if (data.geometry_column_ids.size() != 1) {
+		return;
+	}
+
+	// All spatial predicates (except st_disjoint) imply an intersection of the bounding boxes
+	case_insensitive_set_t predicates = {"st_equals",    "st_intersects",       "st_touches",          "st_crosses",
+	                                     "st_within",    "st_contains",         "st_overlaps",         "st_covers",
+	                                     "st_coveredby", "st_containsproperly", "st_intersects_extent"};
+
+	// ST_DWithin(a, b, d) implies that the bounding boxes intersect once one of them is expanded by d
+	double distance = 0;
+	if (func.children.size() == 3 && StringUtil::CIEquals(func.function.name, "st_dwithin")) {
+		if (!TryGetConstantDistance(context, *func.children[2], distance)) {
+			return;
+		}
+	} else if (func.children.size() != 2 || predicates.find(func.function.name) == predicates.end()) {
+		return;
+	}
+
+	for (idx_t arg_idx = 0; arg_idx < 2; arg_idx++) {
+		auto &column_arg = func.children[arg_idx];
+		auto &constant_arg = func.children[1 - arg_idx];
+		if (column_arg->type != ExpressionType::BOUND_COLUMN_REF) {
+			continue;
+		}
+		auto &column_ref = column_arg->Cast<BoundColumnRefExpression>();
+		if (column_ref.binding.table_index != get.table_index) {
+			continue;
+		}
+		auto column_id = get.column_ids[column_ref.binding.column_index];
+		if (data.geometry_column_ids.find(column_id) == data.geometry_column_ids.end()) {
+			continue;
+		}
+
+		core::BoundingBox bbox;
+		if (!TryGetConstantBoundingBox(context, *constant_arg, bbox)) {
+			continue;
+		}
+		bbox.minx -= distance;
+		bbox.miny -= distance;
+		bbox.maxx += distance;
+		bbox.maxy += distance;
+
+		if (!data.spatial_filter) {
+			data.spatial_filter = make_uniq<RectangleSpatialFilter>(bbox.minx, bbox.miny, bbox.maxx, bbox.maxy);
+		} else {
+			// Narrow down the existing rectangle. If the rectangles are disjoint this leaves it empty, with the minimum
+			// above the maximum, and the scan returns no rows.
+			auto &rect = (RectangleSpatialFilter &)*data.spatial_filter;
+			rect.min_x = MaxValue(rect.min_x, bbox.minx);
+			rect.min_y = MaxValue(rect.min_y, bbox.miny);
+			rect.max_x = MinValue(rect.max_x, bbox.maxx);
+			rect.max_y = MinValue(rect.max_y, bbox.maxy);
+		}
+		break;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// IN list and LIKE pushdown
+//-----------------------------------------------------------------------------
+// These do not become table filters, so translate them into OGR SQL here. The expressions are kept in the plan: OGR
+// SQL and SQLite compare LIKE patterns case insensitively, so GDAL may return more rows than DuckDB would keep.
+static bool TryGetAttributeColumnName(LogicalGet &get, const GdalScanFunctionData &data, const Expression &expr,
+                                      string &column_name) {
+	if (expr.type != ExpressionType::BOUND_COLUMN_REF) {
+		return false;
+	}
+	auto &column_ref = expr.Cast<BoundColumnRefExpression>();
+	if (column_ref.binding.table_index != get.table_index) {
+		return false;
+	}
+	auto column_id = get.column_ids[column_ref.binding.column_index];
+	if (column_id == COLUMN_IDENTIFIER_ROW_ID ||
+	    data.geometry_column_ids.find(column_id) != data.geometry_column_ids.end()) {
+		return false;
+	}
+	column_name = KeywordHelper::WriteOptionallyQuoted(data.all_names[column_id]);
+	return true;
+}
+
+static bool TryInListToGdal(LogicalGet &get, const GdalScanFunctionData &data, const BoundOperatorExpression &expr,
+                            string &result) {
+	string column_name;
+	if (expr.children.size() < 2 || !TryGetAttributeColumnName(get, data, *expr.children[0], column_name)) {
+		return false;
+	}
+	vector<string> values;
+	for (idx_t i = 1; i < expr.children.size(); i++) {
+		if (expr.children[i]->type != ExpressionType::VALUE_CONSTANT) {
+			return false;
+		}
+		auto &value = expr.children[i]->Cast<BoundConstantExpression>().value;
+		if (value.IsNull()) {
+			// Never equal to anything
+			continue;
+		}
+		string constant;
+		if (!TryConstantToGdal(value, constant)) {
+			return false;
+		}
+		values.push_back(constant);
+	}
+	if (values.empty()) {
+		return false;
+	}
+	result = column_name + " IN (" + StringUtil::Join(values, ", ") + ")";
+	return true;
+}
+
+static bool TryLikeToGdal(LogicalGet &get, const GdalScanFunctionData &data, const BoundFunctionExpression &func,
+                          string &result) {
+	// LIKE patterns without wildcards in the middle are rewritten into these functions by the optimizer
+	auto &name = func.function.name;
+	auto is_pattern = name == "~~";
+	if (func.children.size() != 2 || !(is_pattern || name == "prefix" || name == "suffix" || name == "contains")) {
+		return false;
+	}
+	string column_name;
+	if (!TryGetAttributeColumnName(get, data, *func.children[0], column_name) ||
+	    func.children[0]->return_type.id() != LogicalTypeId::VARCHAR ||
+	    func.children[1]->type != ExpressionType::VALUE_CONSTANT) {
+		return false;
+	}
+	auto &value = func.children[1]->Cast<BoundConstantExpression>().value;
+	if (value.IsNull() || value.type().id() != LogicalTypeId::VARCHAR) {
+		return false;
+	}
+	auto pattern = StringValue::Get(value);
+	if (!is_pattern) {
+		// The argument is matched literally, so it must not contain any wildcards itself
+		if (pattern.find_first_of("%_") != string::npos) {
+			return false;
+		}
+		if (name == "prefix") {
+			pattern = pattern + "%";
+		} else if (name == "suffix") {
+			pattern = "%" + pattern;
+		} else {
+			pattern = "%" + pattern + "%";
+		}
+	}
+	result = column_name + " LIKE " + Value(pattern).ToSQLString();
+	return true;
+}
+
+void GdalTableFunction::PushdownComplexFilter(ClientContext &context, LogicalGet &get, FunctionData *bind_data_p,
+                                              vector<unique_ptr<Expression>> &filters) {
+	auto &data = bind_data_p->Cast<GdalScanFunctionData>();
+
+	for (auto &filter : filters) {
+		string attribute_filter;
+		if (filter->type == ExpressionType::COMPARE_IN) {
+			if (TryInListToGdal(get, data, filter->Cast<BoundOperatorExpression>(), attribute_filter)) {
+				data.attribute_filters.push_back(attribute_filter);
+			}
+		} else if (filter->type == ExpressionType::BOUND_FUNCTION) {
+			auto &func = filter->Cast<BoundFunctionExpression>();
+			if (TryLikeToGdal(get, data, func, attribute_filter)) {
+				data.attribute_filters.push_back(attribute_filter);
+			} else {
+				PushdownSpatialFilter(context, get, data, func);
+			}
+		}
+	}
+}
+
 unique_ptr<TableRef> GdalTableFunction::ReplacementScan(ClientContext &, const string &table_name,
                                                         ReplacementScanData *) {
 
@@ -609,10 +2167,12 @@ void GdalTableFunction::Register(DatabaseInstance &db) {
 	                   GdalTableFunction::InitGlobal, GdalTableFunction::InitLocal);
 
 	scan.cardinality = GdalTableFunction::Cardinality;
+	scan.table_scan_progress = GdalTableFunction::Progress;
 	scan.get_batch_index = ArrowTableFunction::ArrowGetBatchIndex;
 
 	scan.projection_pushdown = true;
 	scan.filter_pushdown = true;
+	scan.pushdown_complex_filter = GdalTableFunction::PushdownComplexFilter;
 
 	scan.named_parameters["open_options"] = LogicalType::LIST(LogicalType::VARCHAR);
 	scan.named_parameters["allowed_drivers"] = LogicalType::LIST(LogicalType::VARCHAR);
@@ -623,8 +2183,17 @@ void GdalTableFunction::Register(DatabaseInstance &db) {
 	scan.named_parameters["sequential_layer_scan"] = LogicalType::BOOLEAN;
 	scan.named_parameters["max_batch_size"] = LogicalType::INTEGER;
 	scan.named_parameters["keep_wkb"] = LogicalType::BOOLEAN;
+	scan.named_parameters["parallel_scan"] = LogicalType::BOOLEAN;
+	scan.named_parameters["filename"] = LogicalType::BOOLEAN;
+	scan.named_parameters["union_by_name"] = LogicalType::BOOLEAN;
+	scan.named_parameters["keep_open"] = LogicalType::BOOLEAN;
 	set.AddFunction(scan);
 
+	// Read a list of files
+	TableFunction list_scan = scan;
+	list_scan.arguments = {LogicalType::LIST(LogicalType::VARCHAR)};
+	set.AddFunction(list_scan);
+
 	ExtensionUtil::RegisterFunction(db, set);
 
 	// Replacement scan
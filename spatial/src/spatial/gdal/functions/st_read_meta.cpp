@@ -7,6 +7,7 @@
 #include "spatial/common.hpp"
 #include "spatial/gdal/functions.hpp"
 #include "spatial/gdal/file_handler.hpp"
+#include "spatial/gdal/module.hpp"
 
 #include "ogrsf_frmts.h"
 #include <cstring>
@@ -57,6 +58,8 @@ static LogicalType LAYER_TYPE = LogicalType::STRUCT({
 static unique_ptr<FunctionData> Bind(ClientContext &context, TableFunctionBindInput &input,
                                      vector<LogicalType> &return_types, vector<string> &names) {
 
+	GdalModule::Initialize();
+
 	auto file_name = input.inputs[0].GetValue<string>();
 	auto result = make_uniq<GDALMetadataBindData>();
 
@@ -0,0 +1,312 @@
+#include "duckdb/parser/parsed_data/create_table_function_info.hpp"
+#include "duckdb/main/extension_util.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/geometry/geometry_writer.hpp"
+#include "spatial/gdal/functions.hpp"
+#include "spatial/gdal/file_handler.hpp"
+#include "spatial/gdal/module.hpp"
+
+#include "gdal_priv.h"
+
+#include <cmath>
+
+namespace spatial {
+
+namespace gdal {
+
+//------------------------------------------------------------------------------
+// ST_ReadRaster
+//------------------------------------------------------------------------------
+// Reads the bands of a raster one row per block, with the pixels of the block as a list. Every thread reads through
+// its own dataset handle, and the files are read through the DuckDB file system like in ST_Read, so that only the
+// blocks that are scanned are fetched from e.g. a cloud optimized GeoTIFF.
+//
+//   SELECT band, tile_x, tile_y, geom, list_avg(values) FROM ST_ReadRaster('dem.tif');
+
+// Rows are claimed in runs that together hold about this many pixels, so that a chunk of large blocks stays small
+static constexpr idx_t READ_RASTER_PIXELS_PER_CHUNK = 1 << 20;
+
+enum ReadRasterColumn : column_t {
+	RASTER_BAND_COLUMN,
+	RASTER_TILE_X_COLUMN,
+	RASTER_TILE_Y_COLUMN,
+	RASTER_WIDTH_COLUMN,
+	RASTER_HEIGHT_COLUMN,
+	RASTER_GEOM_COLUMN,
+	RASTER_VALUES_COLUMN
+};
+
+struct ReadRasterBand {
+	int band;
+	bool has_nodata;
+	double nodata;
+};
+
+struct ReadRasterBindData : public TableFunctionData {
+	string file_name;
+	string prefixed_file_name;
+
+	int width;
+	int height;
+	int block_width;
+	int block_height;
+	idx_t blocks_x;
+	idx_t blocks_y;
+	double geo_transform[6];
+	vector<ReadRasterBand> bands;
+
+	idx_t rows_per_chunk;
+	idx_t max_threads;
+
+	idx_t BlockCount() const {
+		return blocks_x * blocks_y * bands.size();
+	}
+};
+
+struct ReadRasterGlobalState : public GlobalTableFunctionState {
+	// The first block of the next run of rows that has not been claimed yet
+	atomic<idx_t> next_block;
+	idx_t max_threads;
+
+	explicit ReadRasterGlobalState(idx_t max_threads) : next_block(0), max_threads(max_threads) {
+	}
+
+	idx_t MaxThreads() const override {
+		return max_threads;
+	}
+};
+
+struct ReadRasterLocalState : public LocalTableFunctionState {
+	// GDAL datasets can not be shared between threads, so every thread opens its own
+	GDALDatasetUniquePtr dataset;
+	core::GeometryWriter writer;
+	vector<column_t> column_ids;
+	idx_t batch_index = 0;
+};
+
+static GDALDatasetUniquePtr OpenRaster(const string &prefixed_file_name, const string &file_name) {
+	auto dataset = GDALDatasetUniquePtr(GDALDataset::Open(prefixed_file_name.c_str(),
+	                                                      GDAL_OF_RASTER | GDAL_OF_VERBOSE_ERROR, nullptr, nullptr,
+	                                                      nullptr));
+	if (dataset == nullptr) {
+		auto error = string(CPLGetLastErrorMsg());
+		throw IOException("Could not open raster: " + file_name + " (" + error + ")");
+	}
+	return dataset;
+}
+
+static unique_ptr<FunctionData> ReadRasterBind(ClientContext &context, TableFunctionBindInput &input,
+                                               vector<LogicalType> &return_types, vector<string> &names) {
+	auto &config = DBConfig::GetConfig(context);
+	if (!config.options.enable_external_access) {
+		throw PermissionException("Scanning GDAL files is disabled through configuration");
+	}
+	GdalModule::Initialize();
+
+	auto result = make_uniq<ReadRasterBindData>();
+	result->file_name = StringValue::Get(input.inputs[0]);
+	result->prefixed_file_name = GDALClientContextState::GetOrCreate(context).GetPrefix() + result->file_name;
+
+	auto dataset = OpenRaster(result->prefixed_file_name, result->file_name);
+	result->width = dataset->GetRasterXSize();
+	result->height = dataset->GetRasterYSize();
+	if (dataset->GetRasterCount() <= 0) {
+		throw IOException("Raster does not contain any bands: " + result->file_name);
+	}
+
+	// Rasters without a geo transform are in pixel coordinates
+	if (dataset->GetGeoTransform(result->geo_transform) != CE_None) {
+		double identity[6] = {0, 1, 0, 0, 0, 1};
+		memcpy(result->geo_transform, identity, sizeof(identity));
+	}
+
+	vector<int> band_numbers;
+	auto band_param = input.named_parameters.find("band");
+	if (band_param != input.named_parameters.end()) {
+		auto band = IntegerValue::Get(band_param->second);
+		if (band < 1 || band > dataset->GetRasterCount()) {
+			throw BinderException("ST_ReadRaster: band %d does not exist, the raster has %d bands", band,
+			                      dataset->GetRasterCount());
+		}
+		band_numbers.push_back(band);
+	} else {
+		for (int band = 1; band <= dataset->GetRasterCount(); band++) {
+			band_numbers.push_back(band);
+		}
+	}
+
+	// All bands are read in the blocks of the first band, which is how most formats store them anyway
+	dataset->GetRasterBand(band_numbers[0])->GetBlockSize(&result->block_width, &result->block_height);
+	result->blocks_x = (result->width + result->block_width - 1) / result->block_width;
+	result->blocks_y = (result->height + result->block_height - 1) / result->block_height;
+	for (auto band_number : band_numbers) {
+		ReadRasterBand band;
+		band.band = band_number;
+		int has_nodata = 0;
+		band.nodata = dataset->GetRasterBand(band_number)->GetNoDataValue(&has_nodata);
+		band.has_nodata = has_nodata != 0;
+		result->bands.push_back(band);
+	}
+
+	auto block_pixels = static_cast<idx_t>(result->block_width) * result->block_height;
+	result->rows_per_chunk =
+	    MaxValue<idx_t>(1, MinValue<idx_t>(STANDARD_VECTOR_SIZE, READ_RASTER_PIXELS_PER_CHUNK / block_pixels));
+	result->max_threads = context.db->NumberOfThreads();
+
+	names = {"band", "tile_x", "tile_y", "width", "height", "geom", "values"};
+	return_types = {LogicalType::INTEGER, LogicalType::INTEGER,     LogicalType::INTEGER,
+	                LogicalType::INTEGER, LogicalType::INTEGER,     core::GeoTypes::GEOMETRY(),
+	                LogicalType::LIST(LogicalType::DOUBLE)};
+	return std::move(result);
+}
+
+static unique_ptr<GlobalTableFunctionState> ReadRasterInitGlobal(ClientContext &context,
+                                                                 TableFunctionInitInput &input) {
+	auto &data = input.bind_data->Cast<ReadRasterBindData>();
+	auto runs = (data.BlockCount() + data.rows_per_chunk - 1) / data.rows_per_chunk;
+	return make_uniq<ReadRasterGlobalState>(MaxValue<idx_t>(1, MinValue<idx_t>(data.max_threads, runs)));
+}
+
+static unique_ptr<LocalTableFunctionState> ReadRasterInitLocal(ExecutionContext &context,
+                                                               TableFunctionInitInput &input,
+                                                               GlobalTableFunctionState *global_state) {
+	auto result = make_uniq<ReadRasterLocalState>();
+	result->column_ids = input.column_ids;
+	return std::move(result);
+}
+
+// The footprint of the pixels from (x0, y0) to (x1, y1), through the geo transform
+static core::geometry_t WriteFootprint(const ReadRasterBindData &data, core::GeometryWriter &writer, Vector &result,
+                                       int x0, int y0, int x1, int y1) {
+	auto &gt = data.geo_transform;
+	auto add_corner = [&](int px, int py) {
+		writer.AddVertex(gt[0] + px * gt[1] + py * gt[2], gt[3] + px * gt[4] + py * gt[5]);
+	};
+	writer.Begin(core::GeometryType::POLYGON, false, false);
+	writer.AddPolygon(1);
+	writer.AddRing(5);
+	add_corner(x0, y0);
+	add_corner(x1, y0);
+	add_corner(x1, y1);
+	add_corner(x0, y1);
+	add_corner(x0, y0);
+	return writer.End(result);
+}
+
+// Read the pixels of a block into the list child, with the nodata pixels set to NULL
+static void ReadBlockValues(const ReadRasterBindData &data, ReadRasterLocalState &state, const ReadRasterBand &band,
+                            int x0, int y0, int width, int height, Vector &values_vec, idx_t row_idx) {
+	auto pixel_count = static_cast<idx_t>(width) * height;
+	auto offset = ListVector::GetListSize(values_vec);
+	ListVector::Reserve(values_vec, offset + pixel_count);
+	auto &child = ListVector::GetEntry(values_vec);
+	auto child_data = FlatVector::GetData<double>(child) + offset;
+
+	auto raster_band = state.dataset->GetRasterBand(band.band);
+	if (raster_band->RasterIO(GF_Read, x0, y0, width, height, child_data, width, height, GDT_Float64, 0, 0,
+	                          nullptr) != CE_None) {
+		throw IOException("Could not read block of raster: " + data.file_name);
+	}
+
+	auto &child_validity = FlatVector::Validity(child);
+	for (idx_t i = 0; i < pixel_count; i++) {
+		auto value = child_data[i];
+		if (std::isnan(value) || (band.has_nodata && value == band.nodata)) {
+			child_validity.SetInvalid(offset + i);
+		}
+	}
+
+	auto &entry = FlatVector::GetData<list_entry_t>(values_vec)[row_idx];
+	entry.offset = offset;
+	entry.length = pixel_count;
+	ListVector::SetListSize(values_vec, offset + pixel_count);
+}
+
+static void ReadRasterScan(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
+	auto &data = input.bind_data->Cast<ReadRasterBindData>();
+	auto &gstate = input.global_state->Cast<ReadRasterGlobalState>();
+	auto &state = input.local_state->Cast<ReadRasterLocalState>();
+
+	// Claim the next run of blocks, a run is a chunk and its batch
+	auto block_count = data.BlockCount();
+	auto first_block = gstate.next_block.fetch_add(data.rows_per_chunk);
+	if (first_block >= block_count) {
+		return;
+	}
+	state.batch_index = first_block / data.rows_per_chunk;
+	if (!state.dataset) {
+		state.dataset = OpenRaster(data.prefixed_file_name, data.file_name);
+	}
+
+	auto count = MinValue<idx_t>(data.rows_per_chunk, block_count - first_block);
+	auto blocks_per_band = data.blocks_x * data.blocks_y;
+	for (idx_t row_idx = 0; row_idx < count; row_idx++) {
+		auto block_idx = first_block + row_idx;
+		auto &band = data.bands[block_idx / blocks_per_band];
+		auto tile_x = static_cast<int>(block_idx % data.blocks_x);
+		auto tile_y = static_cast<int>((block_idx % blocks_per_band) / data.blocks_x);
+		auto x0 = tile_x * data.block_width;
+		auto y0 = tile_y * data.block_height;
+		// The blocks at the right and bottom edge may extend past the raster
+		auto width = MinValue<int>(data.block_width, data.width - x0);
+		auto height = MinValue<int>(data.block_height, data.height - y0);
+
+		for (idx_t col_idx = 0; col_idx < state.column_ids.size(); col_idx++) {
+			auto &vec = output.data[col_idx];
+			switch (state.column_ids[col_idx]) {
+			case RASTER_BAND_COLUMN:
+				FlatVector::GetData<int32_t>(vec)[row_idx] = band.band;
+				break;
+			case RASTER_TILE_X_COLUMN:
+				FlatVector::GetData<int32_t>(vec)[row_idx] = tile_x;
+				break;
+			case RASTER_TILE_Y_COLUMN:
+				FlatVector::GetData<int32_t>(vec)[row_idx] = tile_y;
+				break;
+			case RASTER_WIDTH_COLUMN:
+				FlatVector::GetData<int32_t>(vec)[row_idx] = width;
+				break;
+			case RASTER_HEIGHT_COLUMN:
+				FlatVector::GetData<int32_t>(vec)[row_idx] = height;
+				break;
+			case RASTER_GEOM_COLUMN:
+				FlatVector::GetData<core::geometry_t>(vec)[row_idx] =
+				    WriteFootprint(data, state.writer, vec, x0, y0, x0 + width, y0 + height);
+				break;
+			case RASTER_VALUES_COLUMN:
+				// Only read when the pixels are projected, e.g. not when only counting the blocks
+				ReadBlockValues(data, state, band, x0, y0, width, height, vec, row_idx);
+				break;
+			default:
+				break;
+			}
+		}
+	}
+	output.SetCardinality(count);
+}
+
+static idx_t ReadRasterGetBatchIndex(ClientContext &context, const FunctionData *bind_data,
+                                     LocalTableFunctionState *local_state, GlobalTableFunctionState *global_state) {
+	return local_state->Cast<ReadRasterLocalState>().batch_index;
+}
+
+static unique_ptr<NodeStatistics> ReadRasterCardinality(ClientContext &context, const FunctionData *bind_data) {
+	auto &data = bind_data->Cast<ReadRasterBindData>();
+	return make_uniq<NodeStatistics>(data.BlockCount(), data.BlockCount());
+}
+
+void GdalReadRasterFunction::Register(DatabaseInstance &db) {
+	TableFunction func("ST_ReadRaster", {LogicalType::VARCHAR}, ReadRasterScan, ReadRasterBind, ReadRasterInitGlobal,
+	                   ReadRasterInitLocal);
+	func.named_parameters["band"] = LogicalType::INTEGER;
+	func.projection_pushdown = true;
+	func.get_batch_index = ReadRasterGetBatchIndex;
+	func.cardinality = ReadRasterCardinality;
+	ExtensionUtil::RegisterFunction(db, func);
+}
+
+} // namespace gdal
+
+} // namespace spatial
@@ -1,4 +1,5 @@
 #include "duckdb/catalog/catalog.hpp"
+#include "duckdb/common/arrow/arrow_converter.hpp"
 #include "duckdb/common/types/value.hpp"
 #include "duckdb/function/copy_function.hpp"
 #include "duckdb/function/table_function.hpp"
@@ -8,11 +9,14 @@
 #include "duckdb/parser/parsed_data/create_copy_function_info.hpp"
 #include "duckdb/parser/parsed_data/create_table_function_info.hpp"
 #include "spatial/core/types.hpp"
+#include "spatial/core/geometry/geometry.hpp"
 #include "spatial/core/geometry/geometry_factory.hpp"
 #include "spatial/core/geometry/geometry_type.hpp"
+#include "spatial/core/geometry/space_filling_curve.hpp"
 #include "spatial/core/geometry/wkb_writer.hpp"
 #include "spatial/gdal/functions.hpp"
 #include "spatial/gdal/file_handler.hpp"
+#include "spatial/gdal/module.hpp"
 
 #include "ogrsf_frmts.h"
 
@@ -31,6 +35,12 @@ struct BindData : public TableFunctionData {
 	CPLStringList layer_creation_options;
 	string target_srs;
 	OGRwkbGeometryType geometry_type = wkbUnknown;
+	static constexpr const idx_t DEFAULT_TRANSACTION_SIZE = 100000;
+	// Commit every this many features on drivers with transactions, 0 to write them in autocommit mode
+	idx_t transaction_size = DEFAULT_TRANSACTION_SIZE;
+	// Buffer all rows and write them in the order of the Hilbert key of their geometry's bounding box center
+	bool sort_spatial = false;
+	idx_t geometry_column_idx = DConstants::INVALID_INDEX;
 
 	BindData(string file_path, vector<LogicalType> field_sql_types, vector<string> field_names)
 	    : file_path(std::move(file_path)), field_sql_types(std::move(field_sql_types)),
@@ -38,8 +48,51 @@ struct BindData : public TableFunctionData {
 	}
 };
 
+// Set an attribute field of a feature from a (valid) row of a column
+typedef void (*ogr_field_writer_t)(OGRFeature &feature, int field_idx, const UnifiedVectorFormat &format, idx_t idx);
+
+// A buffered row when sorting spatially, rows without a (non-empty) geometry are written last
+struct SpatialSortEntry {
+	double x;
+	double y;
+	bool has_geometry;
+	uint32_t chunk_idx;
+	uint32_t row_idx;
+};
+
+// The rows buffered for sorting spatially, and the extent of their bounding box centers
+struct SpatialSortBuffer {
+	vector<unique_ptr<DataChunk>> chunks;
+	vector<SpatialSortEntry> entries;
+	core::BoundingBox extent;
+
+	void Append(SpatialSortBuffer &other) {
+		auto chunk_offset = chunks.size();
+		for (auto &chunk : other.chunks) {
+			chunks.push_back(std::move(chunk));
+		}
+		for (auto &entry : other.entries) {
+			entry.chunk_idx += static_cast<uint32_t>(chunk_offset);
+			entries.push_back(entry);
+		}
+		extent.minx = MinValue(extent.minx, other.extent.minx);
+		extent.miny = MinValue(extent.miny, other.extent.miny);
+		extent.maxx = MaxValue(extent.maxx, other.extent.maxx);
+		extent.maxy = MaxValue(extent.maxy, other.extent.maxy);
+		other.chunks.clear();
+		other.entries.clear();
+	}
+};
+
 struct LocalState : public LocalFunctionData {
 	core::GeometryFactory factory;
+	// The input with the geometries as WKB, when writing Arrow batches
+	DataChunk arrow_chunk;
+	// The features of the chunk that is being written, otherwise
+	vector<OGRFeatureUniquePtr> features;
+	vector<UnifiedVectorFormat> formats;
+	vector<data_t> wkb_buffer;
+	SpatialSortBuffer sort_buffer;
 	explicit LocalState(ClientContext &context) : factory(BufferAllocator::Get(context)) {
 	}
 };
@@ -49,9 +102,30 @@ struct GlobalState : public GlobalFunctionData {
 	GDALDatasetUniquePtr dataset;
 	OGRLayer *layer;
 	vector<unique_ptr<OGRFieldDefn>> field_defs;
+	// The writer of every attribute column, nullptr for the geometry columns
+	vector<ogr_field_writer_t> field_writers;
+
+	// Set while the features are written in a transaction, that is committed every transaction_size features
+	bool in_transaction = false;
+	idx_t transaction_features = 0;
+
+	// Set if whole chunks are written to the layer as Arrow batches instead of one feature at a time
+	bool use_arrow = false;
+	ArrowSchema arrow_schema;
+	vector<LogicalType> arrow_types;
+	CPLStringList arrow_options;
+
+	// The rows of all threads, when sorting spatially
+	SpatialSortBuffer sort_buffer;
 
 	GlobalState(GDALDatasetUniquePtr dataset, OGRLayer *layer, vector<unique_ptr<OGRFieldDefn>> field_defs)
 	    : dataset(std::move(dataset)), layer(layer), field_defs(std::move(field_defs)) {
+		arrow_schema.release = nullptr;
+	}
+	~GlobalState() override {
+		if (arrow_schema.release) {
+			arrow_schema.release(&arrow_schema);
+		}
 	}
 };
 
@@ -61,6 +135,8 @@ struct GlobalState : public GlobalFunctionData {
 static unique_ptr<FunctionData> Bind(ClientContext &context, CopyFunctionBindInput &input, const vector<string> &names,
                                      const vector<LogicalType> &sql_types) {
 
+	GdalModule::Initialize();
+
 	auto bind_data = make_uniq<BindData>(input.info.file_path, sql_types, names);
 
 	// check all the options in the copy info
@@ -125,6 +201,18 @@ static unique_ptr<FunctionData> Bind(ClientContext &context, CopyFunctionBindInp
 			} else {
 				throw BinderException("Geometry type must be a string");
 			}
+		} else if (StringUtil::Upper(option.first) == "TRANSACTION_SIZE") {
+			auto set = option.second.front();
+			if (!set.DefaultTryCastAs(LogicalType::BIGINT) || set.IsNull() || BigIntValue::Get(set) < 0) {
+				throw BinderException("Transaction size must be a non-negative integer");
+			}
+			bind_data->transaction_size = static_cast<idx_t>(BigIntValue::Get(set));
+		} else if (StringUtil::Upper(option.first) == "SORT_SPATIAL") {
+			auto set = option.second.empty() ? Value::BOOLEAN(true) : option.second.front();
+			if (!set.DefaultTryCastAs(LogicalType::BOOLEAN) || set.IsNull()) {
+				throw BinderException("Sort spatial must be a boolean");
+			}
+			bind_data->sort_spatial = BooleanValue::Get(set);
 		} else if (StringUtil::Upper(option.first) == "SRS") {
 			auto &set = option.second.front();
 			if (set.type().id() == LogicalTypeId::VARCHAR) {
@@ -173,6 +261,24 @@ static unique_ptr<FunctionData> Bind(ClientContext &context, CopyFunctionBindInp
 		throw BinderException("OpenFileGDB requires 'GEOMETRY_TYPE' parameter to be set when writing!");
 	}
 
+	if (bind_data->sort_spatial) {
+		for (idx_t i = 0; i < sql_types.size(); i++) {
+			if (sql_types[i] == core::GeoTypes::GEOMETRY() || sql_types[i] == core::GeoTypes::POINT_2D()) {
+				bind_data->geometry_column_idx = i;
+				break;
+			}
+		}
+		if (bind_data->geometry_column_idx == DConstants::INVALID_INDEX) {
+			throw BinderException("SORT_SPATIAL requires a GEOMETRY or POINT_2D column");
+		}
+		// Sorting only pays off when readers can find the features through a spatial index. The GeoPackage and
+		// FlatGeobuf drivers create one by default, shapefiles only get a .qix index when asked for.
+		if (bind_data->driver_name == "ESRI Shapefile" &&
+		    bind_data->layer_creation_options.FetchNameValue("SPATIAL_INDEX") == nullptr) {
+			bind_data->layer_creation_options.SetNameValue("SPATIAL_INDEX", "YES");
+		}
+	}
+
 	return std::move(bind_data);
 }
 
@@ -275,6 +381,157 @@ static unique_ptr<OGRFieldDefn> OGRFieldTypeFromLogicalType(const string &name,
 		throw NotImplementedException("Unsupported type for OGR: %s", type.ToString());
 	}
 }
+//===--------------------------------------------------------------------===//
+// Attribute writers
+//===--------------------------------------------------------------------===//
+// One writer is picked per column up front, which then reads the typed values straight from the vector
+template <class T, class OGR_T>
+static void WriteNumberField(OGRFeature &feature, int field_idx, const UnifiedVectorFormat &format, idx_t idx) {
+	feature.SetField(field_idx, static_cast<OGR_T>(UnifiedVectorFormat::GetData<T>(format)[idx]));
+}
+
+static void WriteStringField(OGRFeature &feature, int field_idx, const UnifiedVectorFormat &format, idx_t idx) {
+	auto &str = UnifiedVectorFormat::GetData<string_t>(format)[idx];
+	feature.SetField(field_idx, (int)str.GetSize(), str.GetDataUnsafe());
+}
+
+static void WriteDateField(OGRFeature &feature, int field_idx, const UnifiedVectorFormat &format, idx_t idx) {
+	int32_t year, month, day;
+	Date::Convert(UnifiedVectorFormat::GetData<date_t>(format)[idx], year, month, day);
+	feature.SetField(field_idx, year, month, day, 0, 0, 0, 0);
+}
+
+static void SetTimeOfDay(OGRFeature &feature, int field_idx, int year, int month, int day, dtime_t time) {
+	auto hour = static_cast<int>((time.micros % Interval::MICROS_PER_DAY) / Interval::MICROS_PER_HOUR);
+	auto minute = static_cast<int>((time.micros % Interval::MICROS_PER_HOUR) / Interval::MICROS_PER_MINUTE);
+	auto second = static_cast<float>(static_cast<double>(time.micros % Interval::MICROS_PER_MINUTE) /
+	                                 static_cast<double>(Interval::MICROS_PER_SEC));
+	feature.SetField(field_idx, year, month, day, hour, minute, second, 0);
+}
+
+static void WriteTimeField(OGRFeature &feature, int field_idx, const UnifiedVectorFormat &format, idx_t idx) {
+	SetTimeOfDay(feature, field_idx, 0, 0, 0, UnifiedVectorFormat::GetData<dtime_t>(format)[idx]);
+}
+
+// The timestamp types only differ in the unit of the stored value
+template <timestamp_t (*TO_MICROS)(int64_t)>
+static void WriteTimestampField(OGRFeature &feature, int field_idx, const UnifiedVectorFormat &format, idx_t idx) {
+	auto timestamp = TO_MICROS(UnifiedVectorFormat::GetData<timestamp_t>(format)[idx].value);
+	int32_t year, month, day;
+	Date::Convert(Timestamp::GetDate(timestamp), year, month, day);
+	SetTimeOfDay(feature, field_idx, year, month, day, Timestamp::GetTime(timestamp));
+}
+
+static void WriteTimestampTZField(OGRFeature &feature, int field_idx, const UnifiedVectorFormat &format, idx_t idx) {
+	// Not sure what to with the timezone, just let GDAL parse it?
+	auto time_str = Timestamp::ToString(UnifiedVectorFormat::GetData<timestamp_t>(format)[idx]);
+	feature.SetField(field_idx, time_str.c_str());
+}
+
+static void WriteUnsupportedField(OGRFeature &, int, const UnifiedVectorFormat &, idx_t) {
+	// TODO: Handle list types
+	throw NotImplementedException("Unsupported field type");
+}
+
+static ogr_field_writer_t GetFieldWriter(const LogicalType &type) {
+	switch (type.id()) {
+	case LogicalTypeId::BOOLEAN:
+		return WriteNumberField<bool, int>;
+	case LogicalTypeId::TINYINT:
+		return WriteNumberField<int8_t, int>;
+	case LogicalTypeId::SMALLINT:
+		return WriteNumberField<int16_t, int>;
+	case LogicalTypeId::INTEGER:
+		return WriteNumberField<int32_t, int>;
+	case LogicalTypeId::BIGINT:
+		return WriteNumberField<int64_t, GIntBig>;
+	case LogicalTypeId::FLOAT:
+		return WriteNumberField<float, double>;
+	case LogicalTypeId::DOUBLE:
+		return WriteNumberField<double, double>;
+	case LogicalTypeId::VARCHAR:
+	case LogicalTypeId::BLOB:
+		return WriteStringField;
+	case LogicalTypeId::DATE:
+		return WriteDateField;
+	case LogicalTypeId::TIME:
+		return WriteTimeField;
+	case LogicalTypeId::TIMESTAMP:
+		return WriteTimestampField<Timestamp::FromEpochMicroSeconds>;
+	case LogicalTypeId::TIMESTAMP_NS:
+		return WriteTimestampField<Timestamp::FromEpochNanoSeconds>;
+	case LogicalTypeId::TIMESTAMP_MS:
+		return WriteTimestampField<Timestamp::FromEpochMs>;
+	case LogicalTypeId::TIMESTAMP_SEC:
+		return WriteTimestampField<Timestamp::FromEpochSeconds>;
+	case LogicalTypeId::TIMESTAMP_TZ:
+		return WriteTimestampTZField;
+	default:
+		return WriteUnsupportedField;
+	}
+}
+
+// The types that OGR reads from Arrow the same way as they are set on features one by one
+static bool IsArrowWritableType(const LogicalType &type) {
+	switch (type.id()) {
+	case LogicalTypeId::BOOLEAN:
+	case LogicalTypeId::TINYINT:
+	case LogicalTypeId::SMALLINT:
+	case LogicalTypeId::INTEGER:
+	case LogicalTypeId::BIGINT:
+	case LogicalTypeId::FLOAT:
+	case LogicalTypeId::DOUBLE:
+	case LogicalTypeId::VARCHAR:
+	case LogicalTypeId::BLOB:
+	case LogicalTypeId::DATE:
+		return true;
+	default:
+		return false;
+	}
+}
+
+// Check if the input can be written through OGRLayer::WriteArrowBatch, with the geometries exported as WKB. Drivers
+// that do not write Arrow batches natively still turn them into features, but without going through Value for every
+// field. Geometries are only checked against GEOMETRY_TYPE one feature at a time.
+static void TryInitArrowWrite(ClientContext &context, const BindData &bind_data, GlobalState &gstate) {
+	if (bind_data.geometry_type != wkbUnknown) {
+		return;
+	}
+
+	// The Arrow fields are matched to the fields of the layer by name, which the driver may have changed
+	auto layer_defn = gstate.layer->GetLayerDefn();
+	vector<string> names;
+	int field_idx = 0;
+	for (auto &type : bind_data.field_sql_types) {
+		if (type == core::GeoTypes::GEOMETRY() || type == core::GeoTypes::WKB_BLOB()) {
+			if (layer_defn->GetGeomFieldCount() != 1) {
+				return;
+			}
+			string name = layer_defn->GetGeomFieldDefn(0)->GetNameRef();
+			if (name.empty()) {
+				name = "wkb_geometry";
+			}
+			gstate.arrow_options.SetNameValue("GEOMETRY_NAME", name.c_str());
+			gstate.arrow_types.push_back(LogicalType::BLOB);
+			names.push_back(name);
+		} else if (IsGeometryType(type) || !IsArrowWritableType(type)) {
+			return;
+		} else {
+			gstate.arrow_types.push_back(type);
+			names.emplace_back(layer_defn->GetFieldDefn(field_idx++)->GetNameRef());
+		}
+	}
+
+	ArrowConverter::ToArrowSchema(&gstate.arrow_schema, gstate.arrow_types, names, context.GetClientProperties());
+	std::string error;
+	if (!gstate.layer->IsArrowSchemaSupported(&gstate.arrow_schema, gstate.arrow_options.List(), error)) {
+		gstate.arrow_schema.release(&gstate.arrow_schema);
+		gstate.arrow_schema.release = nullptr;
+		return;
+	}
+	gstate.use_arrow = true;
+}
+
 static unique_ptr<GlobalFunctionData> InitGlobal(ClientContext &context, FunctionData &bind_data,
                                                  const string &file_path) {
 
@@ -287,8 +544,19 @@ static unique_ptr<GlobalFunctionData> InitGlobal(ClientContext &context, Functio
 	// Create the dataset
 	auto &client_ctx = GDALClientContextState::GetOrCreate(context);
 	auto prefixed_path = client_ctx.GetPrefix() + file_path;
+
+	// The SQLite based drivers sync the file on every commit by default. The file is new and incomplete until the copy
+	// finishes anyway, so skip that unless configured otherwise. The setting is read when the dataset is created.
+	auto is_sqlite = gdal_data.driver_name == "GPKG" || gdal_data.driver_name == "SQLite";
+	auto set_synchronous = is_sqlite && CPLGetConfigOption("OGR_SQLITE_SYNCHRONOUS", nullptr) == nullptr;
+	if (set_synchronous) {
+		CPLSetThreadLocalConfigOption("OGR_SQLITE_SYNCHRONOUS", "OFF");
+	}
 	auto dataset = GDALDatasetUniquePtr(
 	    driver->Create(prefixed_path.c_str(), 0, 0, 0, GDT_Unknown, gdal_data.dataset_creation_options));
+	if (set_synchronous) {
+		CPLSetThreadLocalConfigOption("OGR_SQLITE_SYNCHRONOUS", nullptr);
+	}
 	if (!dataset) {
 		throw IOException("Could not open dataset");
 	}
@@ -311,6 +579,7 @@ static unique_ptr<GlobalFunctionData> InitGlobal(ClientContext &context, Functio
 	// Create the layer field definitions
 	idx_t geometry_field_count = 0;
 	vector<unique_ptr<OGRFieldDefn>> field_defs;
+	vector<ogr_field_writer_t> field_writers;
 	for (idx_t i = 0; i < gdal_data.field_names.size(); i++) {
 		auto &name = gdal_data.field_names[i];
 		auto &type = gdal_data.field_sql_types[i];
@@ -320,7 +589,9 @@ static unique_ptr<GlobalFunctionData> InitGlobal(ClientContext &context, Functio
 			if (geometry_field_count > 1) {
 				throw NotImplementedException("Multiple geometry fields not supported yet");
 			}
+			field_writers.push_back(nullptr);
 		} else {
+			field_writers.push_back(GetFieldWriter(type));
 			auto field = OGRFieldTypeFromLogicalType(name, type);
 			if (layer->CreateField(field.get()) != OGRERR_NONE) {
 				throw IOException("Could not create attribute field");
@@ -330,6 +601,15 @@ static unique_ptr<GlobalFunctionData> InitGlobal(ClientContext &context, Functio
 		}
 	}
 	auto global_data = make_uniq<GlobalState>(std::move(dataset), layer, std::move(field_defs));
+	global_data->field_writers = std::move(field_writers);
+	if (!gdal_data.sort_spatial) {
+		TryInitArrowWrite(context, gdal_data, *global_data);
+	}
+
+	// Only use native transactions, emulated ones copy the whole dataset
+	if (gdal_data.transaction_size > 0 && global_data->dataset->TestCapability(ODsCTransactions)) {
+		global_data->in_transaction = global_data->dataset->StartTransaction() == OGRERR_NONE;
+	}
 
 	return std::move(global_data);
 }
@@ -338,156 +618,205 @@ static unique_ptr<GlobalFunctionData> InitGlobal(ClientContext &context, Functio
 // Sink
 //===--------------------------------------------------------------------===//
 
-static OGRGeometryUniquePtr OGRGeometryFromValue(const LogicalType &type, const Value &value,
-                                                 core::GeometryFactory &factory) {
-	if (type == core::GeoTypes::WKB_BLOB()) {
-		auto str = value.GetValueUnsafe<string_t>();
-
-		OGRGeometry *ptr;
-		size_t consumed;
-		auto ok = OGRGeometryFactory::createFromWkb(str.GetDataUnsafe(), nullptr, &ptr, str.GetSize(), wkbVariantIso,
-		                                            consumed);
+static OGRGeometryUniquePtr OGRGeometryFromWKB(const_data_ptr_t wkb, idx_t size) {
+	OGRGeometry *ptr;
+	size_t consumed;
+	auto ok = OGRGeometryFactory::createFromWkb(wkb, nullptr, &ptr, size, wkbVariantIso, consumed);
+	if (ok != OGRERR_NONE) {
+		throw IOException("Could not parse WKB");
+	}
+	return OGRGeometryUniquePtr(ptr);
+}
 
-		if (ok != OGRERR_NONE) {
-			throw IOException("Could not parse WKB");
-		}
-		return OGRGeometryUniquePtr(ptr);
+// Create the OGR geometry of a (valid) row of a geometry column. GEOMETRY is exported as WKB into a buffer that is
+// reused for every row, which OGR then parses directly.
+static OGRGeometryUniquePtr OGRGeometryFromVector(const LogicalType &type, Vector &vector,
+                                                  const UnifiedVectorFormat &format, idx_t idx,
+                                                  LocalState &local_state) {
+	if (type == core::GeoTypes::WKB_BLOB()) {
+		auto &str = UnifiedVectorFormat::GetData<string_t>(format)[idx];
+		return OGRGeometryFromWKB(const_data_ptr_cast(str.GetDataUnsafe()), str.GetSize());
 	} else if (type == core::GeoTypes::GEOMETRY()) {
-		auto blob = value.GetValueUnsafe<string_t>();
-		uint32_t size;
-		auto wkb = core::WKBWriter::Write(core::geometry_t(blob), &size, factory.allocator);
-		OGRGeometry *ptr;
-		auto ok = OGRGeometryFactory::createFromWkb(wkb, nullptr, &ptr, size, wkbVariantIso);
-		if (ok != OGRERR_NONE) {
-			throw IOException("Could not parse WKB");
-		}
-		return OGRGeometryUniquePtr(ptr);
+		auto &blob = UnifiedVectorFormat::GetData<string_t>(format)[idx];
+		core::WKBWriter::Write(core::geometry_t(blob), local_state.wkb_buffer);
+		return OGRGeometryFromWKB(local_state.wkb_buffer.data(), local_state.wkb_buffer.size());
 	} else if (type == core::GeoTypes::POINT_2D()) {
-		auto children = StructValue::GetChildren(value);
-		auto x = children[0].GetValue<double>();
-		auto y = children[1].GetValue<double>();
-		auto ogr_point = new OGRPoint(x, y);
-		return OGRGeometryUniquePtr(ogr_point);
+		// The struct vector is flattened before the rows are read
+		auto &children = StructVector::GetEntries(vector);
+		auto x = FlatVector::GetData<double>(*children[0])[idx];
+		auto y = FlatVector::GetData<double>(*children[1])[idx];
+		return OGRGeometryUniquePtr(new OGRPoint(x, y));
 	} else {
 		throw NotImplementedException("Unsupported geometry type");
 	}
 }
 
-static void SetOgrFieldFromValue(OGRFeature *feature, int field_idx, const LogicalType &type, const Value &value) {
-	// TODO: Set field by index always instead of by name for performance.
-	if (value.IsNull()) {
-		feature->SetFieldNull(field_idx);
+// Commit the open transaction once it holds enough features and start the next one. Must be called with the lock of
+// the global state held.
+static void CountWrittenFeatures(const BindData &bind_data, GlobalState &global_state, idx_t count) {
+	if (!global_state.in_transaction) {
 		return;
 	}
-	switch (type.id()) {
-	case LogicalTypeId::BOOLEAN:
-		feature->SetField(field_idx, value.GetValue<bool>());
-		break;
-	case LogicalTypeId::TINYINT:
-		feature->SetField(field_idx, value.GetValue<int8_t>());
-		break;
-	case LogicalTypeId::SMALLINT:
-		feature->SetField(field_idx, value.GetValue<int16_t>());
-		break;
-	case LogicalTypeId::INTEGER:
-		feature->SetField(field_idx, value.GetValue<int32_t>());
-		break;
-	case LogicalTypeId::BIGINT:
-		feature->SetField(field_idx, (GIntBig)value.GetValue<int64_t>());
-		break;
-	case LogicalTypeId::FLOAT:
-		feature->SetField(field_idx, value.GetValue<float>());
-		break;
-	case LogicalTypeId::DOUBLE:
-		feature->SetField(field_idx, value.GetValue<double>());
-		break;
-	case LogicalTypeId::VARCHAR:
-	case LogicalTypeId::BLOB: {
-		auto str = value.GetValueUnsafe<string_t>();
-		feature->SetField(field_idx, (int)str.GetSize(), str.GetDataUnsafe());
-	} break;
-	case LogicalTypeId::DATE: {
-		auto date = value.GetValueUnsafe<date_t>();
-		auto year = Date::ExtractYear(date);
-		auto month = Date::ExtractMonth(date);
-		auto day = Date::ExtractDay(date);
-		feature->SetField(field_idx, year, month, day, 0, 0, 0, 0);
-	} break;
-	case LogicalTypeId::TIME: {
-		auto time = value.GetValueUnsafe<dtime_t>();
-		auto hour = static_cast<int>(time.micros / Interval::MICROS_PER_HOUR);
-		auto minute = static_cast<int>((time.micros % Interval::MICROS_PER_HOUR) / Interval::MICROS_PER_MINUTE);
-		auto second = static_cast<float>(static_cast<double>(time.micros % Interval::MICROS_PER_MINUTE) /
-		                                 static_cast<double>(Interval::MICROS_PER_SEC));
-		feature->SetField(field_idx, 0, 0, 0, hour, minute, second, 0);
-	} break;
-	case LogicalTypeId::TIMESTAMP: {
-		auto timestamp = value.GetValueUnsafe<timestamp_t>();
-		auto date = Timestamp::GetDate(timestamp);
-		auto time = Timestamp::GetTime(timestamp);
-		auto year = Date::ExtractYear(date);
-		auto month = Date::ExtractMonth(date);
-		auto day = Date::ExtractDay(date);
-		auto hour = static_cast<int>((time.micros % Interval::MICROS_PER_DAY) / Interval::MICROS_PER_HOUR);
-		auto minute = static_cast<int>((time.micros % Interval::MICROS_PER_HOUR) / Interval::MICROS_PER_MINUTE);
-		auto second = static_cast<float>(static_cast<double>(time.micros % Interval::MICROS_PER_MINUTE) /
-		                                 static_cast<double>(Interval::MICROS_PER_SEC));
-		feature->SetField(field_idx, year, month, day, hour, minute, second, 0);
-	} break;
-	case LogicalTypeId::TIMESTAMP_NS: {
-		auto timestamp = value.GetValueUnsafe<timestamp_t>();
-		timestamp = Timestamp::FromEpochNanoSeconds(timestamp.value);
-		auto date = Timestamp::GetDate(timestamp);
-		auto time = Timestamp::GetTime(timestamp);
-		auto year = Date::ExtractYear(date);
-		auto month = Date::ExtractMonth(date);
-		auto day = Date::ExtractDay(date);
-		auto hour = static_cast<int>((time.micros % Interval::MICROS_PER_DAY) / Interval::MICROS_PER_HOUR);
-		auto minute = static_cast<int>((time.micros % Interval::MICROS_PER_HOUR) / Interval::MICROS_PER_MINUTE);
-		auto second = static_cast<float>(static_cast<double>(time.micros % Interval::MICROS_PER_MINUTE) /
-		                                 static_cast<double>(Interval::MICROS_PER_SEC));
-		feature->SetField(field_idx, year, month, day, hour, minute, second, 0);
-	} break;
-	case LogicalTypeId::TIMESTAMP_MS: {
-		auto timestamp = value.GetValueUnsafe<timestamp_t>();
-		timestamp = Timestamp::FromEpochMs(timestamp.value);
-		auto date = Timestamp::GetDate(timestamp);
-		auto time = Timestamp::GetTime(timestamp);
-		auto year = Date::ExtractYear(date);
-		auto month = Date::ExtractMonth(date);
-		auto day = Date::ExtractDay(date);
-		auto hour = static_cast<int>((time.micros % Interval::MICROS_PER_DAY) / Interval::MICROS_PER_HOUR);
-		auto minute = static_cast<int>((time.micros % Interval::MICROS_PER_HOUR) / Interval::MICROS_PER_MINUTE);
-		auto second = static_cast<float>(static_cast<double>(time.micros % Interval::MICROS_PER_MINUTE) /
-		                                 static_cast<double>(Interval::MICROS_PER_SEC));
-		feature->SetField(field_idx, year, month, day, hour, minute, second, 0);
-	} break;
-	case LogicalTypeId::TIMESTAMP_SEC: {
-		auto timestamp = value.GetValueUnsafe<timestamp_t>();
-		timestamp = Timestamp::FromEpochSeconds(timestamp.value);
-		auto date = Timestamp::GetDate(timestamp);
-		auto time = Timestamp::GetTime(timestamp);
-		auto year = Date::ExtractYear(date);
-		auto month = Date::ExtractMonth(date);
-		auto day = Date::ExtractDay(date);
-		auto hour = static_cast<int>((time.micros % Interval::MICROS_PER_DAY) / Interval::MICROS_PER_HOUR);
-		auto minute = static_cast<int>((time.micros % Interval::MICROS_PER_HOUR) / Interval::MICROS_PER_MINUTE);
-		auto second = static_cast<float>(static_cast<double>(time.micros % Interval::MICROS_PER_MINUTE) /
-		                                 static_cast<double>(Interval::MICROS_PER_SEC));
-		feature->SetField(field_idx, year, month, day, hour, minute, second, 0);
-	} break;
-	case LogicalTypeId::TIMESTAMP_TZ: {
-		// Not sure what to with the timezone, just let GDAL parse it?
-		auto timestamp = value.GetValueUnsafe<timestamp_t>();
-		auto time_str = Timestamp::ToString(timestamp);
-		feature->SetField(field_idx, time_str.c_str());
-	} break;
-	default:
-		// TODO: Handle list types
-		throw NotImplementedException("Unsupported field type");
+	global_state.transaction_features += count;
+	if (global_state.transaction_features < bind_data.transaction_size) {
+		return;
+	}
+	if (global_state.dataset->CommitTransaction() != OGRERR_NONE) {
+		throw IOException("Could not commit transaction: %s", CPLGetLastErrorMsg());
+	}
+	global_state.transaction_features = 0;
+	global_state.in_transaction = global_state.dataset->StartTransaction() == OGRERR_NONE;
+}
+
+// Convert the chunk to an Arrow batch before taking the lock, so that only OGR writing the batch is serialized
+static void SinkArrow(ExecutionContext &context, const BindData &bind_data, GlobalState &global_state,
+                      LocalState &local_state, DataChunk &input) {
+	auto &chunk = local_state.arrow_chunk;
+	if (chunk.ColumnCount() == 0) {
+		chunk.Initialize(context.client, global_state.arrow_types);
+	}
+	chunk.Reset();
+
+	auto count = input.size();
+	for (idx_t col_idx = 0; col_idx < input.ColumnCount(); col_idx++) {
+		auto &type = bind_data.field_sql_types[col_idx];
+		auto &source = input.data[col_idx];
+		auto &target = chunk.data[col_idx];
+		if (type == core::GeoTypes::GEOMETRY()) {
+			UnaryExecutor::Execute<core::geometry_t, string_t>(
+			    source, target, count, [&](core::geometry_t geom) { return core::WKBWriter::Write(geom, target); });
+		} else if (type == core::GeoTypes::WKB_BLOB()) {
+			UnaryExecutor::Execute<string_t, string_t>(source, target, count, [](string_t wkb) { return wkb; });
+			StringVector::AddHeapReference(target, source);
+		} else {
+			target.Reference(source);
+		}
+	}
+	chunk.SetCardinality(count);
+
+	ArrowArray array;
+	ArrowConverter::ToArrowArray(chunk, &array, context.client.GetClientProperties());
+
+	bool ok;
+	{
+		lock_guard<mutex> d_lock(global_state.lock);
+		ok = global_state.layer->WriteArrowBatch(&global_state.arrow_schema, &array,
+		                                         global_state.arrow_options.List());
+		if (ok) {
+			CountWrittenFeatures(bind_data, global_state, count);
+		}
+	}
+	if (array.release) {
+		array.release(&array);
+	}
+	if (!ok) {
+		throw IOException("Could not write features: %s", CPLGetLastErrorMsg());
 	}
 }
 
+// Flatten the POINT_2D columns, whose children are read directly, and get the unified format of every column
+static void GetColumnFormats(const BindData &bind_data, DataChunk &input, vector<UnifiedVectorFormat> &formats) {
+	formats.resize(input.ColumnCount());
+	for (idx_t col_idx = 0; col_idx < input.ColumnCount(); col_idx++) {
+		if (bind_data.field_sql_types[col_idx] == core::GeoTypes::POINT_2D()) {
+			input.data[col_idx].Flatten(input.size());
+		}
+		input.data[col_idx].ToUnifiedFormat(input.size(), formats[col_idx]);
+	}
+}
+
+static OGRFeatureUniquePtr BuildFeature(const BindData &bind_data, const GlobalState &global_state,
+                                        LocalState &local_state, DataChunk &input,
+                                        const vector<UnifiedVectorFormat> &formats, idx_t row_idx) {
+	auto feature = OGRFeatureUniquePtr(OGRFeature::CreateFeature(global_state.layer->GetLayerDefn()));
+
+	// Geometry fields do not count towards the field index, so we need to keep track of them separately.
+	idx_t field_idx = 0;
+	for (idx_t col_idx = 0; col_idx < input.ColumnCount(); col_idx++) {
+		auto &type = bind_data.field_sql_types[col_idx];
+
+		if (IsGeometryType(type)) {
+			auto &format = formats[col_idx];
+			auto idx = format.sel->get_index(row_idx);
+			if (!format.validity.RowIsValid(idx)) {
+				// Leave the geometry of the feature empty
+				continue;
+			}
+			// TODO: check how many geometry fields there are and use the correct one.
+			auto geom = OGRGeometryFromVector(type, input.data[col_idx], format, idx, local_state);
+			if (bind_data.geometry_type != wkbUnknown && geom->getGeometryType() != bind_data.geometry_type) {
+				auto got_name =
+				    StringUtil::Replace(StringUtil::Upper(OGRGeometryTypeToName(geom->getGeometryType())), " ", "");
+				auto expected_name =
+				    StringUtil::Replace(StringUtil::Upper(OGRGeometryTypeToName(bind_data.geometry_type)), " ", "");
+				throw InvalidInputException("Expected all geometries to be of type '%s', but got one of type '%s'",
+				                            expected_name, got_name);
+			}
+
+			// Hand the geometry over to the feature instead of having it copied
+			if (feature->SetGeometryDirectly(geom.release()) != OGRERR_NONE) {
+				throw IOException("Could not set geometry");
+			}
+		} else {
+			auto &format = formats[col_idx];
+			auto idx = format.sel->get_index(row_idx);
+			if (format.validity.RowIsValid(idx)) {
+				global_state.field_writers[col_idx](*feature, (int)field_idx, format, idx);
+			} else {
+				feature->SetFieldNull((int)field_idx);
+			}
+			field_idx++;
+		}
+	}
+	return feature;
+}
+
+// Copy the chunk into the thread local sort buffer, along with the bounding box center of every row
+static void SinkSorted(ExecutionContext &context, const BindData &bind_data, LocalState &local_state,
+                       DataChunk &input) {
+	auto &buffer = local_state.sort_buffer;
+	auto chunk_idx = static_cast<uint32_t>(buffer.chunks.size());
+	auto chunk = make_uniq<DataChunk>();
+	chunk->Initialize(Allocator::Get(context.client), input.GetTypes());
+	input.Copy(*chunk);
+
+	auto &geom_vec = chunk->data[bind_data.geometry_column_idx];
+	auto is_point = geom_vec.GetType() == core::GeoTypes::POINT_2D();
+	auto count = chunk->size();
+	UnifiedVectorFormat format;
+	geom_vec.ToUnifiedFormat(count, format);
+
+	for (idx_t row_idx = 0; row_idx < count; row_idx++) {
+		SpatialSortEntry entry {0, 0, false, chunk_idx, static_cast<uint32_t>(row_idx)};
+		auto idx = format.sel->get_index(row_idx);
+		if (format.validity.RowIsValid(idx)) {
+			if (is_point) {
+				// The copy is flat
+				auto &children = StructVector::GetEntries(geom_vec);
+				entry.x = FlatVector::GetData<double>(*children[0])[idx];
+				entry.y = FlatVector::GetData<double>(*children[1])[idx];
+				entry.has_geometry = true;
+			} else {
+				auto &blob = UnifiedVectorFormat::GetData<core::geometry_t>(format)[idx];
+				core::BoundingBox bbox;
+				if (core::GeometryFactory::TryGetSerializedBoundingBox(blob, bbox)) {
+					entry.x = bbox.minx + (bbox.maxx - bbox.minx) / 2;
+					entry.y = bbox.miny + (bbox.maxy - bbox.miny) / 2;
+					entry.has_geometry = true;
+				}
+			}
+		}
+		if (entry.has_geometry) {
+			buffer.extent.minx = MinValue(buffer.extent.minx, entry.x);
+			buffer.extent.miny = MinValue(buffer.extent.miny, entry.y);
+			buffer.extent.maxx = MaxValue(buffer.extent.maxx, entry.x);
+			buffer.extent.maxy = MaxValue(buffer.extent.maxy, entry.y);
+		}
+		buffer.entries.push_back(entry);
+	}
+	buffer.chunks.push_back(std::move(chunk));
+}
+
 static void Sink(ExecutionContext &context, FunctionData &bdata, GlobalFunctionData &gstate, LocalFunctionData &lstate,
                  DataChunk &input) {
 	auto &bind_data = bdata.Cast<BindData>();
@@ -495,45 +824,33 @@ static void Sink(ExecutionContext &context, FunctionData &bdata, GlobalFunctionD
 	auto &local_state = lstate.Cast<LocalState>();
 	local_state.factory.allocator.Reset();
 
-	lock_guard<mutex> d_lock(global_state.lock);
-	auto layer = global_state.layer;
+	if (bind_data.sort_spatial) {
+		SinkSorted(context, bind_data, local_state, input);
+		return;
+	}
 
-	// Create the feature
-	input.Flatten();
-	for (idx_t row_idx = 0; row_idx < input.size(); row_idx++) {
+	if (global_state.use_arrow) {
+		SinkArrow(context, bind_data, global_state, local_state, input);
+		return;
+	}
 
-		auto feature = OGRFeatureUniquePtr(OGRFeature::CreateFeature(layer->GetLayerDefn()));
-
-		// Geometry fields do not count towards the field index, so we need to keep track of them separately.
-		idx_t field_idx = 0;
-		for (idx_t col_idx = 0; col_idx < input.ColumnCount(); col_idx++) {
-			auto &type = bind_data.field_sql_types[col_idx];
-			auto value = input.GetValue(col_idx, row_idx);
-
-			if (IsGeometryType(type)) {
-				// TODO: check how many geometry fields there are and use the correct one.
-				auto geom = OGRGeometryFromValue(type, value, local_state.factory);
-				if (bind_data.geometry_type != wkbUnknown && geom->getGeometryType() != bind_data.geometry_type) {
-					auto got_name =
-					    StringUtil::Replace(StringUtil::Upper(OGRGeometryTypeToName(geom->getGeometryType())), " ", "");
-					auto expected_name =
-					    StringUtil::Replace(StringUtil::Upper(OGRGeometryTypeToName(bind_data.geometry_type)), " ", "");
-					throw InvalidInputException("Expected all geometries to be of type '%s', but got one of type '%s'",
-					                            expected_name, got_name);
-				}
+	// Build the features of the chunk before taking the lock, so that only handing them to the layer is serialized.
+	// The layer definition does not change anymore once the fields are created.
+	auto &features = local_state.features;
+	features.clear();
+	GetColumnFormats(bind_data, input, local_state.formats);
+	for (idx_t row_idx = 0; row_idx < input.size(); row_idx++) {
+		features.push_back(BuildFeature(bind_data, global_state, local_state, input, local_state.formats, row_idx));
+	}
 
-				if (feature->SetGeometry(geom.get()) != OGRERR_NONE) {
-					throw IOException("Could not set geometry");
-				}
-			} else {
-				SetOgrFieldFromValue(feature.get(), (int)field_idx, type, value);
-				field_idx++;
-			}
-		}
-		if (layer->CreateFeature(feature.get()) != OGRERR_NONE) {
+	lock_guard<mutex> d_lock(global_state.lock);
+	for (auto &feature : features) {
+		if (global_state.layer->CreateFeature(feature.get()) != OGRERR_NONE) {
 			throw IOException("Could not create feature");
 		}
 	}
+	CountWrittenFeatures(bind_data, global_state, input.size());
+	features.clear();
 }
 
 //===--------------------------------------------------------------------===//
@@ -542,13 +859,66 @@ static void Sink(ExecutionContext &context, FunctionData &bdata, GlobalFunctionD
 
 static void Combine(ExecutionContext &context, FunctionData &bind_data, GlobalFunctionData &gstate,
                     LocalFunctionData &lstate) {
+	auto &global_state = gstate.Cast<GlobalState>();
+	auto &local_state = lstate.Cast<LocalState>();
+	if (!local_state.sort_buffer.chunks.empty()) {
+		lock_guard<mutex> d_lock(global_state.lock);
+		global_state.sort_buffer.Append(local_state.sort_buffer);
+	}
 }
 
 //===--------------------------------------------------------------------===//
 // Finalize
 //===--------------------------------------------------------------------===//
+// Write the buffered rows in the order of the Hilbert key of their bounding box center within the extent of all of
+// them. Rows with the same key keep their input order.
+static void WriteSorted(ClientContext &context, const BindData &bind_data, GlobalState &global_state) {
+	auto &buffer = global_state.sort_buffer;
+	auto &extent = buffer.extent;
+
+	vector<pair<uint64_t, idx_t>> keys;
+	keys.reserve(buffer.entries.size());
+	for (idx_t i = 0; i < buffer.entries.size(); i++) {
+		auto &entry = buffer.entries[i];
+		auto key = NumericLimits<uint64_t>::Maximum();
+		if (entry.has_geometry) {
+			auto cell_x = core::CurveGrid::GetCell(entry.x, extent.minx, extent.maxx);
+			auto cell_y = core::CurveGrid::GetCell(entry.y, extent.miny, extent.maxy);
+			key = core::HilbertCurve::Encode(cell_x, cell_y);
+		}
+		keys.emplace_back(key, i);
+	}
+	std::sort(keys.begin(), keys.end());
+
+	vector<vector<UnifiedVectorFormat>> formats(buffer.chunks.size());
+	for (idx_t chunk_idx = 0; chunk_idx < buffer.chunks.size(); chunk_idx++) {
+		GetColumnFormats(bind_data, *buffer.chunks[chunk_idx], formats[chunk_idx]);
+	}
+
+	LocalState local_state(context);
+	for (auto &key : keys) {
+		auto &entry = buffer.entries[key.second];
+		auto feature = BuildFeature(bind_data, global_state, local_state, *buffer.chunks[entry.chunk_idx],
+		                            formats[entry.chunk_idx], entry.row_idx);
+		if (global_state.layer->CreateFeature(feature.get()) != OGRERR_NONE) {
+			throw IOException("Could not create feature");
+		}
+		CountWrittenFeatures(bind_data, global_state, 1);
+	}
+	buffer.chunks.clear();
+	buffer.entries.clear();
+}
+
 static void Finalize(ClientContext &context, FunctionData &bind_data, GlobalFunctionData &gstate) {
 	auto &global_state = (GlobalState &)gstate;
+	auto &gdal_data = bind_data.Cast<BindData>();
+	if (gdal_data.sort_spatial) {
+		WriteSorted(context, gdal_data, global_state);
+	}
+	if (global_state.in_transaction && global_state.dataset->CommitTransaction() != OGRERR_NONE) {
+		throw IOException("Could not commit transaction: %s", CPLGetLastErrorMsg());
+	}
+	global_state.in_transaction = false;
 	global_state.dataset->FlushCache();
 	global_state.dataset->Close();
 }
@@ -0,0 +1,305 @@
+#include "duckdb/main/extension_util.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/functions/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/gdal/functions.hpp"
+#include "spatial/gdal/file_handler.hpp"
+#include "spatial/gdal/module.hpp"
+
+#include "gdal_priv.h"
+
+#include <cmath>
+
+namespace spatial {
+
+namespace gdal {
+
+//------------------------------------------------------------------------------
+// ST_ZonalStats(raster, geom [, band])
+//------------------------------------------------------------------------------
+// Aggregates the pixels of a raster band whose centers are within a (multi)polygon. Only the window of the raster under
+// the bounding box of the polygon is read, so GDAL only reads the blocks that the polygon overlaps. The polygon is
+// rasterized with a scanline in pixel space, which also works for rotated geo transforms. Every thread keeps its own
+// handles to the rasters it reads.
+
+struct ZonalRaster {
+	GDALDatasetUniquePtr dataset;
+	// From world to pixel coordinates
+	double inverse_transform[6];
+};
+
+// An edge of the polygon in pixel coordinates
+struct ZonalEdge {
+	double x0;
+	double y0;
+	double x1;
+	double y1;
+};
+
+struct ZonalStats {
+	int64_t count = 0;
+	double sum = 0;
+	double min = 0;
+	double max = 0;
+
+	void Update(double value) {
+		if (count == 0) {
+			min = value;
+			max = value;
+		} else {
+			min = MinValue(min, value);
+			max = MaxValue(max, value);
+		}
+		sum += value;
+		count++;
+	}
+};
+
+struct ZonalStatsBindData : public FunctionData {
+	// The VSI prefix of the client, that routes the file names through the DuckDB file system
+	string vsi_prefix;
+
+	explicit ZonalStatsBindData(string vsi_prefix_p) : vsi_prefix(std::move(vsi_prefix_p)) {
+	}
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<ZonalStatsBindData>(vsi_prefix);
+	}
+	bool Equals(const FunctionData &other) const override {
+		return vsi_prefix == other.Cast<ZonalStatsBindData>().vsi_prefix;
+	}
+};
+
+struct ZonalStatsLocalState : public core::GeometryFunctionLocalState {
+	string vsi_prefix;
+	unordered_map<string, ZonalRaster> rasters;
+	// Reused between polygons
+	vector<ZonalEdge> edges;
+	vector<double> crossings;
+	vector<double> window;
+
+	ZonalStatsLocalState(ClientContext &context, string vsi_prefix_p)
+	    : GeometryFunctionLocalState(context), vsi_prefix(std::move(vsi_prefix_p)) {
+	}
+
+	static unique_ptr<FunctionLocalState> Init(ExpressionState &state, const BoundFunctionExpression &expr,
+	                                           FunctionData *bind_data) {
+		auto &data = bind_data->Cast<ZonalStatsBindData>();
+		return make_uniq<ZonalStatsLocalState>(state.GetContext(), data.vsi_prefix);
+	}
+
+	static ZonalStatsLocalState &ResetAndGet(ExpressionState &state) {
+		return static_cast<ZonalStatsLocalState &>(GeometryFunctionLocalState::ResetAndGet(state));
+	}
+
+	ZonalRaster &GetRaster(const string &file_name) {
+		auto entry = rasters.find(file_name);
+		if (entry != rasters.end()) {
+			return entry->second;
+		}
+		auto prefixed_file_name = vsi_prefix + file_name;
+		ZonalRaster raster;
+		raster.dataset = GDALDatasetUniquePtr(GDALDataset::Open(
+		    prefixed_file_name.c_str(), GDAL_OF_RASTER | GDAL_OF_VERBOSE_ERROR, nullptr, nullptr, nullptr));
+		if (raster.dataset == nullptr) {
+			auto error = string(CPLGetLastErrorMsg());
+			throw IOException("Could not open raster: " + file_name + " (" + error + ")");
+		}
+		double transform[6];
+		if (raster.dataset->GetGeoTransform(transform) != CE_None) {
+			double identity[6] = {0, 1, 0, 0, 0, 1};
+			memcpy(transform, identity, sizeof(identity));
+		}
+		if (!GDALInvGeoTransform(transform, raster.inverse_transform)) {
+			throw InvalidInputException("ST_ZonalStats: the geo transform of raster %s can not be inverted", file_name);
+		}
+		return rasters.emplace(file_name, std::move(raster)).first->second;
+	}
+};
+
+static void AddEdges(const core::Polygon &polygon, const double *inv, vector<ZonalEdge> &edges) {
+	for (auto &ring : polygon) {
+		for (uint32_t i = 0; i + 1 < ring.Count(); i++) {
+			auto p = ring.Get(i);
+			auto q = ring.Get(i + 1);
+			ZonalEdge edge;
+			edge.x0 = inv[0] + p.x * inv[1] + p.y * inv[2];
+			edge.y0 = inv[3] + p.x * inv[4] + p.y * inv[5];
+			edge.x1 = inv[0] + q.x * inv[1] + q.y * inv[2];
+			edge.y1 = inv[3] + q.x * inv[4] + q.y * inv[5];
+			edges.push_back(edge);
+		}
+	}
+}
+
+// Returns false if the geometry has no area
+static bool ComputeZonalStats(ZonalStatsLocalState &lstate, const string &file_name, int32_t band_number,
+                              const core::geometry_t &blob, ZonalStats &stats) {
+	auto geometry = lstate.factory.Deserialize(blob);
+	auto &raster = lstate.GetRaster(file_name);
+	auto band = raster.dataset->GetRasterBand(band_number);
+	if (band == nullptr) {
+		throw InvalidInputException("ST_ZonalStats: band %d does not exist in raster %s", band_number, file_name);
+	}
+
+	auto &edges = lstate.edges;
+	edges.clear();
+	if (geometry.Type() == core::GeometryType::POLYGON) {
+		AddEdges(geometry.As<core::Polygon>(), raster.inverse_transform, edges);
+	} else if (geometry.Type() == core::GeometryType::MULTIPOLYGON) {
+		for (auto &polygon : geometry.As<core::MultiPolygon>()) {
+			AddEdges(polygon, raster.inverse_transform, edges);
+		}
+	} else {
+		return false;
+	}
+	if (edges.empty()) {
+		return false;
+	}
+
+	// The window of pixels under the bounding box of the polygon
+	auto min_x = edges[0].x0, max_x = edges[0].x0, min_y = edges[0].y0, max_y = edges[0].y0;
+	for (auto &edge : edges) {
+		min_x = MinValue(min_x, MinValue(edge.x0, edge.x1));
+		max_x = MaxValue(max_x, MaxValue(edge.x0, edge.x1));
+		min_y = MinValue(min_y, MinValue(edge.y0, edge.y1));
+		max_y = MaxValue(max_y, MaxValue(edge.y0, edge.y1));
+	}
+	auto x_begin = static_cast<int>(MaxValue<double>(0, std::floor(min_x)));
+	auto x_end = static_cast<int>(MinValue<double>(raster.dataset->GetRasterXSize(), std::ceil(max_x)));
+	auto y_begin = static_cast<int>(MaxValue<double>(0, std::floor(min_y)));
+	auto y_end = static_cast<int>(MinValue<double>(raster.dataset->GetRasterYSize(), std::ceil(max_y)));
+	if (x_begin >= x_end || y_begin >= y_end) {
+		return true;
+	}
+
+	auto window_width = x_end - x_begin;
+	auto window_height = y_end - y_begin;
+	auto &window = lstate.window;
+	window.resize(static_cast<idx_t>(window_width) * window_height);
+	if (band->RasterIO(GF_Read, x_begin, y_begin, window_width, window_height, window.data(), window_width,
+	                   window_height, GDT_Float64, 0, 0, nullptr) != CE_None) {
+		throw IOException("Could not read raster: " + file_name);
+	}
+
+	int has_nodata = 0;
+	auto nodata = band->GetNoDataValue(&has_nodata);
+
+	// Every row is split into the runs of pixels whose centers are inside the polygon (by the even-odd rule), from
+	// where the edges cross the horizontal line through the pixel centers
+	auto &crossings = lstate.crossings;
+	for (auto y = y_begin; y < y_end; y++) {
+		auto center_y = y + 0.5;
+		crossings.clear();
+		for (auto &edge : edges) {
+			if ((edge.y0 <= center_y) != (edge.y1 <= center_y)) {
+				crossings.push_back(edge.x0 + (center_y - edge.y0) * (edge.x1 - edge.x0) / (edge.y1 - edge.y0));
+			}
+		}
+		std::sort(crossings.begin(), crossings.end());
+
+		auto row = window.data() + static_cast<idx_t>(y - y_begin) * window_width;
+		for (idx_t i = 0; i + 1 < crossings.size(); i += 2) {
+			// The pixels with their center in [crossings[i], crossings[i + 1])
+			auto run_begin = MaxValue<double>(x_begin, std::ceil(crossings[i] - 0.5));
+			auto run_end = MinValue<double>(x_end, std::ceil(crossings[i + 1] - 0.5));
+			for (auto x = static_cast<int>(run_begin); x < static_cast<int>(run_end); x++) {
+				auto value = row[x - x_begin];
+				if (std::isnan(value) || (has_nodata && value == nodata)) {
+					continue;
+				}
+				stats.Update(value);
+			}
+		}
+	}
+	return true;
+}
+
+static void ZonalStatsFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = ZonalStatsLocalState::ResetAndGet(state);
+	auto count = args.size();
+
+	UnifiedVectorFormat raster_format;
+	UnifiedVectorFormat geom_format;
+	UnifiedVectorFormat band_format;
+	args.data[0].ToUnifiedFormat(count, raster_format);
+	args.data[1].ToUnifiedFormat(count, geom_format);
+	auto has_band = args.ColumnCount() == 3;
+	if (has_band) {
+		args.data[2].ToUnifiedFormat(count, band_format);
+	}
+	auto raster_data = UnifiedVectorFormat::GetData<string_t>(raster_format);
+	auto geom_data = UnifiedVectorFormat::GetData<core::geometry_t>(geom_format);
+
+	auto &children = StructVector::GetEntries(result);
+	auto count_data = FlatVector::GetData<int64_t>(*children[0]);
+	auto sum_data = FlatVector::GetData<double>(*children[1]);
+	auto mean_data = FlatVector::GetData<double>(*children[2]);
+	auto min_data = FlatVector::GetData<double>(*children[3]);
+	auto max_data = FlatVector::GetData<double>(*children[4]);
+
+	for (idx_t i = 0; i < count; i++) {
+		auto raster_idx = raster_format.sel->get_index(i);
+		auto geom_idx = geom_format.sel->get_index(i);
+		auto band_idx = has_band ? band_format.sel->get_index(i) : 0;
+		if (!raster_format.validity.RowIsValid(raster_idx) || !geom_format.validity.RowIsValid(geom_idx) ||
+		    (has_band && !band_format.validity.RowIsValid(band_idx))) {
+			FlatVector::SetNull(result, i, true);
+			continue;
+		}
+		auto band = has_band ? UnifiedVectorFormat::GetData<int32_t>(band_format)[band_idx] : 1;
+
+		ZonalStats stats;
+		if (!ComputeZonalStats(lstate, raster_data[raster_idx].GetString(), band, geom_data[geom_idx], stats)) {
+			FlatVector::SetNull(result, i, true);
+			continue;
+		}
+		count_data[i] = stats.count;
+		if (stats.count == 0) {
+			for (idx_t child_idx = 1; child_idx < children.size(); child_idx++) {
+				FlatVector::SetNull(*children[child_idx], i, true);
+			}
+			continue;
+		}
+		sum_data[i] = stats.sum;
+		mean_data[i] = stats.sum / stats.count;
+		min_data[i] = stats.min;
+		max_data[i] = stats.max;
+	}
+
+	if (args.AllConstant()) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
+}
+
+static unique_ptr<FunctionData> ZonalStatsBind(ClientContext &context, ScalarFunction &bound_function,
+                                               vector<unique_ptr<Expression>> &arguments) {
+	auto &config = DBConfig::GetConfig(context);
+	if (!config.options.enable_external_access) {
+		throw PermissionException("Scanning GDAL files is disabled through configuration");
+	}
+	GdalModule::Initialize();
+	return make_uniq<ZonalStatsBindData>(GDALClientContextState::GetOrCreate(context).GetPrefix());
+}
+
+void GdalZonalStatsFunction::Register(DatabaseInstance &db) {
+	auto stats_type = LogicalType::STRUCT({{"count", LogicalType::BIGINT},
+	                                       {"sum", LogicalType::DOUBLE},
+	                                       {"mean", LogicalType::DOUBLE},
+	                                       {"min", LogicalType::DOUBLE},
+	                                       {"max", LogicalType::DOUBLE}});
+
+	ScalarFunctionSet set("ST_ZonalStats");
+	set.AddFunction(ScalarFunction({LogicalType::VARCHAR, core::GeoTypes::GEOMETRY()}, stats_type, ZonalStatsFunction,
+	                               ZonalStatsBind, nullptr, nullptr, ZonalStatsLocalState::Init));
+	set.AddFunction(ScalarFunction({LogicalType::VARCHAR, core::GeoTypes::GEOMETRY(), LogicalType::INTEGER},
+	                               stats_type, ZonalStatsFunction, ZonalStatsBind, nullptr, nullptr,
+	                               ZonalStatsLocalState::Init));
+	ExtensionUtil::RegisterFunction(db, set);
+}
+
+} // namespace gdal
+
+} // namespace spatial
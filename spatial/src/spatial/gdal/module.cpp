@@ -1,9 +1,15 @@
 #include "spatial/gdal/module.hpp"
 #include "spatial/gdal/functions.hpp"
 #include "spatial/gdal/file_handler.hpp"
+#include "spatial/gdal/storage.hpp"
 #include "spatial/common.hpp"
+#include "spatial/core/init_profile.hpp"
+#include "spatial/proj/module.hpp"
+
+#include "duckdb/main/config.hpp"
 
 #include "ogrsf_frmts.h"
+#include "gdal_frmts.h"
 
 #include <mutex>
 
@@ -11,13 +17,21 @@ namespace spatial {
 
 namespace gdal {
 
-void GdalModule::Register(DatabaseInstance &db) {
+// Registering the drivers is deferred until GDAL is first used, so that loading the extension stays cheap for sessions
+// that never read or write files through GDAL.
+void GdalModule::Initialize() {
+	// GDAL uses PROJ for its spatial references, so it has to be pointed at the embedded proj.db first
+	proj::ProjModule::Initialize();
 
 	// Load GDAL (once)
 	static std::once_flag loaded;
 	std::call_once(loaded, [&]() {
+		core::InitProfile::Timer timer("gdal", "initialize");
+
 		// Register all embedded drivers (dont go looking for plugins)
 		OGRRegisterAllInternal();
+		// And the GeoTIFF driver for ST_ReadRaster and ST_ZonalStats, which also reads cloud optimized GeoTIFFs
+		GDALRegister_GTiff();
 
 		// Set GDAL error handler
 
@@ -59,12 +73,31 @@ void GdalModule::Register(DatabaseInstance &db) {
 			}
 		});
 	});
+}
 
+void GdalModule::Register(DatabaseInstance &db) {
 	// Register functions
 	GdalTableFunction::Register(db);
 	GdalDriversTableFunction::Register(db);
 	GdalCopyFunction::Register(db);
 	GdalMetadataFunction::Register(db);
+	GdalIOMetricsFunction::Register(db);
+	GdalReadRasterFunction::Register(db);
+	GdalZonalStatsFunction::Register(db);
+
+	// ATTACH ... (TYPE GDAL)
+	GdalStorageExtension::Register(db);
+
+	auto &config = DBConfig::GetConfig(db);
+	config.AddExtensionOption("spatial_gdal_io_buffer_size",
+	                          "The size of the blocks that small reads of GDAL from files opened for reading are "
+	                          "buffered in, or 0 to read directly from the file",
+	                          LogicalType::VARCHAR, Value("1MB"));
+	config.AddExtensionOption("spatial_gdal_batch_target_size",
+	                          "The size ST_Read aims for with the Arrow batches it reads from GDAL, by choosing the "
+	                          "features per batch from the size of the first features, or 0 to always read "
+	                          "2048 features per batch",
+	                          LogicalType::VARCHAR, Value("1MB"));
 }
 
 } // namespace gdal
@@ -0,0 +1,174 @@
+#include "duckdb/catalog/catalog_entry/schema_catalog_entry.hpp"
+#include "duckdb/catalog/duck_catalog.hpp"
+#include "duckdb/common/reference_map.hpp"
+#include "duckdb/main/attached_database.hpp"
+#include "duckdb/main/config.hpp"
+#include "duckdb/parser/keyword_helper.hpp"
+#include "duckdb/parser/parsed_data/attach_info.hpp"
+#include "duckdb/parser/parsed_data/create_view_info.hpp"
+#include "duckdb/storage/storage_extension.hpp"
+#include "duckdb/transaction/transaction.hpp"
+#include "duckdb/transaction/transaction_manager.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/gdal/file_handler.hpp"
+#include "spatial/gdal/module.hpp"
+#include "spatial/gdal/storage.hpp"
+
+#include "ogrsf_frmts.h"
+
+namespace spatial {
+
+namespace gdal {
+
+//------------------------------------------------------------------------------
+// Catalog
+//------------------------------------------------------------------------------
+// The layers of an attached dataset are views over ST_Read with keep_open, so a query on a layer is planned like any
+// other ST_Read scan (with the projection, attribute filter and spatial filter pushdown) and reuses the dataset
+// handles of earlier queries. The catalog itself is an in-memory catalog that only holds these views.
+class GdalCatalog : public DuckCatalog {
+public:
+	GdalCatalog(AttachedDatabase &db, string path_p, vector<unique_ptr<CreateViewInfo>> views_p)
+	    : DuckCatalog(db), path(std::move(path_p)), views(std::move(views_p)) {
+	}
+
+	void Initialize(bool load_builtin) override {
+		DuckCatalog::Initialize(load_builtin);
+		auto transaction = CatalogTransaction::GetSystemTransaction(GetDatabase());
+		auto schema = GetSchema(transaction, DEFAULT_SCHEMA, OnEntryNotFound::THROW_EXCEPTION);
+		for (auto &view : views) {
+			schema->CreateView(transaction, *view);
+		}
+		views.clear();
+	}
+
+	string GetCatalogType() override {
+		return "gdal";
+	}
+	bool IsDuckCatalog() override {
+		return false;
+	}
+	bool InMemory() override {
+		return false;
+	}
+	string GetDBPath() override {
+		return path;
+	}
+	DatabaseSize GetDatabaseSize(ClientContext &context) override {
+		return DatabaseSize();
+	}
+
+private:
+	string path;
+	// The views of the layers, until they are created when the catalog is initialized
+	vector<unique_ptr<CreateViewInfo>> views;
+};
+
+//------------------------------------------------------------------------------
+// Transaction Manager
+//------------------------------------------------------------------------------
+// The attached database is read-only and has nothing to commit
+class GdalTransactionManager : public TransactionManager {
+public:
+	explicit GdalTransactionManager(AttachedDatabase &db) : TransactionManager(db) {
+	}
+
+	Transaction &StartTransaction(ClientContext &context) override {
+		auto transaction = make_uniq<Transaction>(*this, context);
+		auto &result = *transaction;
+		lock_guard<mutex> guard(lock);
+		transactions[result] = std::move(transaction);
+		return result;
+	}
+
+	ErrorData CommitTransaction(ClientContext &context, Transaction &transaction) override {
+		lock_guard<mutex> guard(lock);
+		transactions.erase(transaction);
+		return ErrorData();
+	}
+
+	void RollbackTransaction(Transaction &transaction) override {
+		lock_guard<mutex> guard(lock);
+		transactions.erase(transaction);
+	}
+
+	void Checkpoint(ClientContext &context, bool force) override {
+	}
+
+private:
+	mutex lock;
+	reference_map_t<Transaction, unique_ptr<Transaction>> transactions;
+};
+
+//------------------------------------------------------------------------------
+// Attach
+//------------------------------------------------------------------------------
+static vector<string> GetLayerNames(ClientContext &context, const string &path) {
+	auto prefixed_path = GDALClientContextState::GetOrCreate(context).GetPrefix() + path;
+	auto dataset = GDALDatasetUniquePtr(
+	    GDALDataset::Open(prefixed_path.c_str(), GDAL_OF_VECTOR | GDAL_OF_VERBOSE_ERROR, nullptr, nullptr, nullptr));
+	if (dataset == nullptr) {
+		auto error = string(CPLGetLastErrorMsg());
+		throw IOException("Could not open file: " + path + " (" + error + ")");
+	}
+	vector<string> names;
+	for (int layer_idx = 0; layer_idx < dataset->GetLayerCount(); layer_idx++) {
+		names.emplace_back(dataset->GetLayer(layer_idx)->GetName());
+	}
+	return names;
+}
+
+static unique_ptr<Catalog> GdalAttach(StorageExtensionInfo *storage_info, ClientContext &context,
+                                      AttachedDatabase &db, const string &name, AttachInfo &info,
+                                      AccessMode access_mode) {
+	auto &config = DBConfig::GetConfig(context);
+	if (!config.options.enable_external_access) {
+		throw PermissionException("Attaching GDAL datasets is disabled through configuration");
+	}
+	if (access_mode != AccessMode::READ_ONLY) {
+		throw BinderException("GDAL datasets can only be attached read-only, e.g. ATTACH '%s' (TYPE GDAL, READ_ONLY)",
+		                      info.path);
+	}
+	for (auto &option : info.options) {
+		auto loption = StringUtil::Lower(option.first);
+		if (loption != "type" && loption != "read_only" && loption != "readonly") {
+			throw BinderException("Unrecognized option for attaching a GDAL dataset: %s", option.first);
+		}
+	}
+
+	GdalModule::Initialize();
+
+	// Bind a view for every layer now, so that the errors of layers that can not be read are raised by the ATTACH
+	vector<unique_ptr<CreateViewInfo>> views;
+	case_insensitive_set_t view_names;
+	for (auto &layer_name : GetLayerNames(context, info.path)) {
+		if (!view_names.insert(layer_name).second) {
+			continue;
+		}
+		auto view = make_uniq<CreateViewInfo>();
+		view->schema = DEFAULT_SCHEMA;
+		view->view_name = layer_name;
+		view->sql = "SELECT * FROM ST_Read(" + KeywordHelper::WriteQuoted(info.path, '\'') +
+		            ", layer = " + KeywordHelper::WriteQuoted(layer_name, '\'') + ", keep_open = true)";
+		views.push_back(CreateViewInfo::FromSelect(context, std::move(view)));
+	}
+	return make_uniq<GdalCatalog>(db, info.path, std::move(views));
+}
+
+static unique_ptr<TransactionManager> GdalCreateTransactionManager(StorageExtensionInfo *storage_info,
+                                                                   AttachedDatabase &db, Catalog &catalog) {
+	return make_uniq<GdalTransactionManager>(db);
+}
+
+void GdalStorageExtension::Register(DatabaseInstance &db) {
+	auto extension = make_uniq<StorageExtension>();
+	extension->attach = GdalAttach;
+	extension->create_transaction_manager = GdalCreateTransactionManager;
+	auto &config = DBConfig::GetConfig(db);
+	config.storage_extensions["gdal"] = std::move(extension);
+}
+
+} // namespace gdal
+
+} // namespace spatial
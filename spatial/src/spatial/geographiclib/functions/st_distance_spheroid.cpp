@@ -1,4 +1,3 @@
-#include "duckdb/common/vector_operations/generic_executor.hpp"
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
 
 #include "spatial/common.hpp"
@@ -17,20 +16,105 @@ namespace geographiclib {
 // POINT_2D
 //------------------------------------------------------------------------------
 static void GeodesicPoint2DFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	using POINT_TYPE = StructTypeBinary<double, double>;
-	using DISTANCE_TYPE = PrimitiveType<double>;
 	auto count = args.size();
 	auto &p1 = args.data[0];
 	auto &p2 = args.data[1];
 
+	auto is_constant =
+	    p1.GetVectorType() == VectorType::CONSTANT_VECTOR && p2.GetVectorType() == VectorType::CONSTANT_VECTOR;
+	if (is_constant) {
+		count = 1;
+	}
+
+	p1.Flatten(count);
+	p2.Flatten(count);
+
+	auto &p1_children = StructVector::GetEntries(p1);
+	auto &p2_children = StructVector::GetEntries(p2);
+	auto lat1_data = FlatVector::GetData<double>(*p1_children[0]);
+	auto lon1_data = FlatVector::GetData<double>(*p1_children[1]);
+	auto lat2_data = FlatVector::GetData<double>(*p2_children[0]);
+	auto lon2_data = FlatVector::GetData<double>(*p2_children[1]);
+
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto result_data = FlatVector::GetData<double>(result);
+	auto &result_validity = FlatVector::Validity(result);
+	result_validity.Copy(FlatVector::Validity(p1), count);
+	result_validity.Combine(FlatVector::Validity(p2), count);
+
+	// Solve the inverse problem for distance only, directly over the coordinate arrays. Identical points are common
+	// (e.g. when comparing a point with itself), and do not need to go through the geodesic solver at all.
 	const GeographicLib::Geodesic &geod = GeographicLib::Geodesic::WGS84();
+	for (idx_t i = 0; i < count; i++) {
+		if (!result_validity.RowIsValid(i)) {
+			continue;
+		}
+		auto lat1 = lat1_data[i];
+		auto lon1 = lon1_data[i];
+		auto lat2 = lat2_data[i];
+		auto lon2 = lon2_data[i];
+		if (lat1 == lat2 && lon1 == lon2) {
+			result_data[i] = 0;
+			continue;
+		}
+		double distance;
+		geod.Inverse(lat1, lon1, lat2, lon2, distance);
+		result_data[i] = distance;
+	}
+
+	if (is_constant) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
+}
+
+//------------------------------------------------------------------------------
+// Haversine
+//------------------------------------------------------------------------------
+// The great circle distance on a sphere with the mean radius of the WGS84 ellipsoid. Compared to the ellipsoidal
+// distance the error is at most about 0.56%, but it is a fixed sequence of arithmetic and can be run over whole vectors.
+static constexpr double MEAN_EARTH_RADIUS = 6371008.8;
+static constexpr double DEG_TO_RAD = 0.017453292519943296;
+
+static void HaversinePoint2DFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto count = args.size();
+	auto &p1 = args.data[0];
+	auto &p2 = args.data[1];
+
+	auto is_constant =
+	    p1.GetVectorType() == VectorType::CONSTANT_VECTOR && p2.GetVectorType() == VectorType::CONSTANT_VECTOR;
+	if (is_constant) {
+		count = 1;
+	}
+
+	p1.Flatten(count);
+	p2.Flatten(count);
 
-	GenericExecutor::ExecuteBinary<POINT_TYPE, POINT_TYPE, DISTANCE_TYPE>(
-	    p1, p2, result, count, [&](POINT_TYPE p1, POINT_TYPE p2) {
-		    double distance;
-		    geod.Inverse(p1.a_val, p1.b_val, p2.a_val, p2.b_val, distance);
-		    return distance;
-	    });
+	auto &p1_children = StructVector::GetEntries(p1);
+	auto &p2_children = StructVector::GetEntries(p2);
+	auto lat1_data = FlatVector::GetData<double>(*p1_children[0]);
+	auto lon1_data = FlatVector::GetData<double>(*p1_children[1]);
+	auto lat2_data = FlatVector::GetData<double>(*p2_children[0]);
+	auto lon2_data = FlatVector::GetData<double>(*p2_children[1]);
+
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto result_data = FlatVector::GetData<double>(result);
+	auto &result_validity = FlatVector::Validity(result);
+	result_validity.Copy(FlatVector::Validity(p1), count);
+	result_validity.Combine(FlatVector::Validity(p2), count);
+
+	// No branches, so the compiler can vectorize this. The values of NULL rows are computed but never read.
+	for (idx_t i = 0; i < count; i++) {
+		auto lat1 = lat1_data[i] * DEG_TO_RAD;
+		auto lat2 = lat2_data[i] * DEG_TO_RAD;
+		auto sin_dlat = std::sin((lat2 - lat1) * 0.5);
+		auto sin_dlon = std::sin((lon2_data[i] - lon1_data[i]) * DEG_TO_RAD * 0.5);
+		auto h = sin_dlat * sin_dlat + std::cos(lat1) * std::cos(lat2) * sin_dlon * sin_dlon;
+		result_data[i] = 2 * MEAN_EARTH_RADIUS * std::asin(std::sqrt(std::min(h, 1.0)));
+	}
+
+	if (is_constant) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
 }
 
 void GeographicLibFunctions::RegisterDistance(DatabaseInstance &db) {
@@ -41,6 +125,12 @@ void GeographicLibFunctions::RegisterDistance(DatabaseInstance &db) {
 	                               LogicalType::DOUBLE, GeodesicPoint2DFunction));
 
 	ExtensionUtil::RegisterFunction(db, set);
+
+	ScalarFunctionSet sphere_set("ST_Distance_Sphere");
+	sphere_set.AddFunction(ScalarFunction({spatial::core::GeoTypes::POINT_2D(), spatial::core::GeoTypes::POINT_2D()},
+	                                      LogicalType::DOUBLE, HaversinePoint2DFunction));
+
+	ExtensionUtil::RegisterFunction(db, sphere_set);
 }
 
 } // namespace geographiclib
@@ -1,4 +1,3 @@
-#include "duckdb/common/vector_operations/generic_executor.hpp"
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
 
 #include "spatial/common.hpp"
@@ -6,6 +5,7 @@
 #include "spatial/core/geometry/geometry_factory.hpp"
 #include "spatial/geographiclib/functions.hpp"
 #include "spatial/geographiclib/module.hpp"
+#include "spatial/geographiclib/spheroid_bounds.hpp"
 
 #include "GeographicLib/Geodesic.hpp"
 
@@ -17,22 +17,65 @@ namespace geographiclib {
 // POINT_2D
 //------------------------------------------------------------------------------
 static void GeodesicPoint2DFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	using POINT_TYPE = StructTypeBinary<double, double>;
-	using DISTANCE_TYPE = PrimitiveType<double>;
-	using BOOL_TYPE = PrimitiveType<bool>;
 	auto count = args.size();
-	auto &p1_vec = args.data[0];
-	auto &p2_vec = args.data[1];
-	auto &limit_vec = args.data[2];
+	auto &p1 = args.data[0];
+	auto &p2 = args.data[1];
+	auto &limit = args.data[2];
 
+	auto is_constant = p1.GetVectorType() == VectorType::CONSTANT_VECTOR &&
+	                   p2.GetVectorType() == VectorType::CONSTANT_VECTOR &&
+	                   limit.GetVectorType() == VectorType::CONSTANT_VECTOR;
+	if (is_constant) {
+		count = 1;
+	}
+
+	p1.Flatten(count);
+	p2.Flatten(count);
+	limit.Flatten(count);
+
+	auto &p1_children = StructVector::GetEntries(p1);
+	auto &p2_children = StructVector::GetEntries(p2);
+	auto lat1_data = FlatVector::GetData<double>(*p1_children[0]);
+	auto lon1_data = FlatVector::GetData<double>(*p1_children[1]);
+	auto lat2_data = FlatVector::GetData<double>(*p2_children[0]);
+	auto lon2_data = FlatVector::GetData<double>(*p2_children[1]);
+	auto limit_data = FlatVector::GetData<double>(limit);
+
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto result_data = FlatVector::GetData<bool>(result);
+	auto &result_validity = FlatVector::Validity(result);
+	result_validity.Copy(FlatVector::Validity(p1), count);
+	result_validity.Combine(FlatVector::Validity(p2), count);
+	result_validity.Combine(FlatVector::Validity(limit), count);
+
+	// Most pairs in a filter or join are far apart compared to the limit, reject those with a bounds check in
+	// degrees before solving the inverse problem
 	const GeographicLib::Geodesic &geod = GeographicLib::Geodesic::WGS84();
+	for (idx_t i = 0; i < count; i++) {
+		if (!result_validity.RowIsValid(i)) {
+			continue;
+		}
+		auto lat1 = lat1_data[i];
+		auto lon1 = lon1_data[i];
+		auto lat2 = lat2_data[i];
+		auto lon2 = lon2_data[i];
+		auto distance_limit = limit_data[i];
+		if (!SpheroidBounds::MayBeWithin(lat1, lon1, lat2, lon2, distance_limit)) {
+			result_data[i] = false;
+			continue;
+		}
+		if (lat1 == lat2 && lon1 == lon2) {
+			result_data[i] = distance_limit >= 0;
+			continue;
+		}
+		double distance;
+		geod.Inverse(lat1, lon1, lat2, lon2, distance);
+		result_data[i] = distance <= distance_limit;
+	}
 
-	GenericExecutor::ExecuteTernary<POINT_TYPE, POINT_TYPE, DISTANCE_TYPE, BOOL_TYPE>(
-	    p1_vec, p2_vec, limit_vec, result, count, [&](POINT_TYPE p1, POINT_TYPE p2, DISTANCE_TYPE limit) {
-		    double distance;
-		    geod.Inverse(p1.a_val, p1.b_val, p2.a_val, p2.b_val, distance);
-		    return distance <= limit.val;
-	    });
+	if (is_constant) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
 }
 
 void GeographicLibFunctions::RegisterDistanceWithin(DatabaseInstance &db) {
@@ -41,7 +84,7 @@ void GeographicLibFunctions::RegisterDistanceWithin(DatabaseInstance &db) {
 	ScalarFunctionSet set("ST_DWithin_Spheroid");
 	set.AddFunction(
 	    ScalarFunction({spatial::core::GeoTypes::POINT_2D(), spatial::core::GeoTypes::POINT_2D(), LogicalType::DOUBLE},
-	                   LogicalType::DOUBLE, GeodesicPoint2DFunction));
+	                   LogicalType::BOOLEAN, GeodesicPoint2DFunction));
 
 	ExtensionUtil::RegisterFunction(db, set);
 }
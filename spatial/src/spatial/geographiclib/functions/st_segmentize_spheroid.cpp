@@ -0,0 +1,88 @@
+#include "duckdb/common/vector_operations/binary_executor.hpp"
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/functions/common.hpp"
+#include "spatial/core/geometry/segmentize.hpp"
+#include "spatial/geographiclib/functions.hpp"
+#include "spatial/geographiclib/module.hpp"
+
+#include "GeographicLib/Geodesic.hpp"
+#include "GeographicLib/GeodesicLine.hpp"
+
+namespace spatial {
+
+namespace geographiclib {
+
+using namespace core;
+
+//------------------------------------------------------------------------------
+// GEOMETRY
+//------------------------------------------------------------------------------
+// Splits segments by their length along the geodesic on the WGS84 ellipsoid, and places the new vertices on the
+// geodesic. Like the other spheroid functions, x is the latitude and y the longitude. Z and M are interpolated
+// linearly by the distance along the geodesic.
+class GeodesicSegmentizer final : public Segmentizer {
+public:
+	double max_length = 1;
+
+	GeodesicSegmentizer() : Segmentizer("ST_Segmentize_Spheroid"), geod(GeographicLib::Geodesic::WGS84()) {
+	}
+
+protected:
+	double CountPieces(const VertexXYZM &a, const VertexXYZM &b) override {
+		double length;
+		geod.Inverse(a.x, a.y, b.x, b.y, length);
+		if (!(length > max_length)) {
+			return 1;
+		}
+		return std::ceil(length / max_length);
+	}
+
+	void WritePieces(const VertexXYZM &a, const VertexXYZM &b, uint32_t pieces, GeometryWriter &writer) override {
+		auto line = geod.InverseLine(a.x, a.y, b.x, b.y);
+		auto length = line.Distance();
+		for (uint32_t k = 1; k < pieces; k++) {
+			auto t = static_cast<double>(k) / pieces;
+			double lat;
+			double lon;
+			line.Position(t * length, lat, lon);
+			writer.AddVertex(lat, lon, a.z + t * (b.z - a.z), a.m + t * (b.m - a.m));
+		}
+	}
+
+private:
+	const GeographicLib::Geodesic &geod;
+};
+
+static void GeometrySegmentizeFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
+	auto count = args.size();
+
+	GeometryWriter writer;
+	writer.double_bbox = lstate.factory.double_bbox;
+	GeodesicSegmentizer segmentizer;
+
+	BinaryExecutor::Execute<geometry_t, double, geometry_t>(
+	    args.data[0], args.data[1], result, count, [&](geometry_t input, double max_length) {
+		    if (!(max_length > 0)) {
+			    throw InvalidInputException("ST_Segmentize_Spheroid: the maximum segment length must be positive");
+		    }
+		    segmentizer.max_length = max_length;
+		    return segmentizer.Execute(input, writer, result);
+	    });
+}
+
+void GeographicLibFunctions::RegisterSegmentize(DatabaseInstance &db) {
+	ScalarFunctionSet set("ST_Segmentize_Spheroid");
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), LogicalType::DOUBLE}, GeoTypes::GEOMETRY(),
+	                               GeometrySegmentizeFunction, nullptr, nullptr, nullptr,
+	                               GeometryFunctionLocalState::Init));
+
+	ExtensionUtil::RegisterFunction(db, set);
+}
+
+} // namespace geographiclib
+
+} // namespace spatial
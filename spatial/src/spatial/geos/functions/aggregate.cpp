@@ -1,9 +1,14 @@
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
 #include "duckdb/parser/parsed_data/create_aggregate_function_info.hpp"
+#include "duckdb/execution/expression_executor.hpp"
 
 #include "spatial/common.hpp"
 #include "spatial/geos/functions/aggregate.hpp"
 #include "spatial/geos/geos_wrappers.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/functions/common.hpp"
+#include "spatial/core/geometry/point_distance.hpp"
+#include "spatial/core/index/flat_rtree.hpp"
 
 #include "geos_c.h"
 
@@ -11,85 +16,142 @@ namespace spatial {
 
 namespace geos {
 
-struct GEOSAggState {
-	GEOSGeometry *geom = nullptr;
-	GEOSContextHandle_t context = nullptr;
+using core::AggregateMemoryBindData;
 
-	~GEOSAggState() {
-		if (geom) {
-			GEOSGeom_destroy_r(context, geom);
-			geom = nullptr;
-		}
-		if (context) {
-			GEOS_finish_r(context);
-			context = nullptr;
-		}
-	}
-};
+static const AggregateMemoryBindData &GetMemory(AggregateInputData &input) {
+	return input.bind_data->Cast<AggregateMemoryBindData>();
+}
 
 //------------------------------------------------------------------------
-// INTERSECTION
+// SERIALIZED PARTIALS
 //------------------------------------------------------------------------
-struct IntersectionAggFunction {
+// ST_Intersection_Agg and ST_Union_Agg keep their partial results serialized, in memory from the buffer allocator,
+// instead of as a GEOS geometry with a GEOS context of its own in every state. A grouped aggregate over millions of
+// groups then only holds compact blobs that count towards the memory limit, so the buffer manager can evict the
+// partitions of the hash table to disk to make room for them. The inputs are copied into the state and merged in
+// batches: once MAX_PARTS inputs are buffered, and on finalize, a pooled GEOS context deserializes the partial result
+// and the buffered inputs, merges them with OP::Merge and serializes the new partial result.
+// Combine adds the merged partial result of the other state to the buffered inputs, without changing the other state.
+// When the aggregate runs over a window frame, DuckDB combines the states of the nodes of a segment tree for every
+// frame, so a frame only merges the partial results of the few nodes that cover it instead of all of its rows.
+
+struct GEOSPartial {
+	// The partial result, a null pointer if there is none yet
+	AllocatedData result;
+	// The inputs not yet merged into the result
+	vector<AllocatedData> parts;
+};
+
+struct GEOSPartialAggState {
+	GEOSPartial *partial;
+};
+
+static geometry_t GetBlob(const AllocatedData &data) {
+	return geometry_t(string_t(const_char_ptr_cast(data.get()), static_cast<uint32_t>(data.GetSize())));
+}
+
+static AllocatedData CopyBlob(const AggregateMemoryBindData &memory, const geometry_t &blob) {
+	auto str = string_t(blob);
+	auto data = memory.allocator.Allocate(str.GetSize());
+	memcpy(data.get(), str.GetData(), str.GetSize());
+	return data;
+}
+
+template <class OP>
+struct PartialAggFunction {
+	// The number of buffered inputs after which they are merged, this bounds the work of a single merge
+	static constexpr idx_t MAX_PARTS = 4096;
+
 	template <class STATE>
 	static void Initialize(STATE &state) {
-		state.geom = nullptr;
-		state.context = GEOS_init_r();
+		state.partial = nullptr;
 	}
 
-	template <class STATE, class OP>
-	static void Combine(const STATE &source, STATE &target, AggregateInputData &data) {
-		if (!source.geom) {
-			return;
+	template <class STATE>
+	static GEOSPartial &GetPartial(STATE &state) {
+		if (!state.partial) {
+			state.partial = new GEOSPartial();
+		}
+		return *state.partial;
+	}
+
+	static void AddPart(GEOSPartial &partial, AllocatedData part, const AggregateMemoryBindData &memory) {
+		partial.parts.push_back(std::move(part));
+		if (partial.parts.size() >= MAX_PARTS) {
+			Flush(partial, memory);
 		}
-		if (!target.geom) {
-			target.geom = GEOSGeom_clone_r(target.context, source.geom);
+	}
+
+	// The partial result merged with the buffered inputs
+	static AllocatedData Merge(const GEOSPartial &partial, const AggregateMemoryBindData &memory) {
+		GeosInterruptScope interrupt_scope(memory.context);
+		GeosContextWrapper wrapper;
+		auto geom = OP::Merge(wrapper, partial);
+		interrupt_scope.Check();
+		return SerializeGEOSGeometry(memory.allocator, geom.get(), wrapper.GetCtx(),
+		                             GeometryFunctionLocalState::GetDoubleBBox(memory.context));
+	}
+
+	static void Flush(GEOSPartial &partial, const AggregateMemoryBindData &memory) {
+		if (partial.parts.empty()) {
 			return;
 		}
-		auto curr = target.geom;
-		target.geom = GEOSIntersection_r(target.context, curr, source.geom);
-		GEOSGeom_destroy_r(target.context, curr);
+		partial.result = Merge(partial, memory);
+		partial.parts.clear();
 	}
 
-	template <class INPUT_TYPE, class STATE, class OP>
-	static void Operation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &) {
-		if (!state.geom) {
-			state.geom = DeserializeGEOSGeometry(input, state.context);
-		} else {
-			auto next = DeserializeGEOSGeometry(input, state.context);
-			auto curr = state.geom;
-			state.geom = GEOSIntersection_r(state.context, curr, next);
-			GEOSGeom_destroy_r(state.context, next);
-			GEOSGeom_destroy_r(state.context, curr);
+	template <class STATE, class OP2>
+	static void Combine(const STATE &source, STATE &target, AggregateInputData &data) {
+		// The source can be combined into many targets (e.g. a node of a segment tree), and by several threads at
+		// once, so it is only read
+		if (!source.partial) {
+			return;
+		}
+		auto &memory = GetMemory(data);
+		auto &partial = GetPartial(target);
+		if (!source.partial->parts.empty()) {
+			OP::AddPart(partial, Merge(*source.partial, memory), memory);
+		} else if (source.partial->result.get()) {
+			OP::AddPart(partial, CopyBlob(memory, GetBlob(source.partial->result)), memory);
 		}
 	}
 
-	template <class INPUT_TYPE, class STATE, class OP>
-	static void ConstantOperation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &, idx_t count) {
-		// There is no point in doing anything else, intersection is idempotent
-		if (!state.geom) {
-			state.geom = DeserializeGEOSGeometry(input, state.context);
+	template <class INPUT_TYPE, class STATE, class OP2>
+	static void Operation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &agg) {
+		auto &memory = GetMemory(agg.input);
+		auto &partial = GetPartial(state);
+		if (OP::TrySkip(partial, input, memory)) {
+			return;
 		}
+		OP::AddPart(partial, CopyBlob(memory, input), memory);
+	}
+
+	template <class INPUT_TYPE, class STATE, class OP2>
+	static void ConstantOperation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &agg, idx_t count) {
+		// There is no point in doing anything else, union and intersection are idempotent
+		Operation<INPUT_TYPE, STATE, OP2>(state, input, agg);
 	}
 
 	template <class T, class STATE>
 	static void Finalize(STATE &state, T &target, AggregateFinalizeData &finalize_data) {
-		if (!state.geom) {
+		if (!state.partial) {
+			finalize_data.ReturnNull();
+			return;
+		}
+		auto &partial = *state.partial;
+		Flush(partial, GetMemory(finalize_data.input));
+		if (!partial.result.get()) {
 			finalize_data.ReturnNull();
-		} else {
-			target = SerializeGEOSGeometry(finalize_data.result, state.geom, state.context);
+			return;
 		}
+		target = geometry_t(StringVector::AddStringOrBlob(finalize_data.result, GetBlob(partial.result)));
 	}
 
 	template <class STATE>
-	static void Destroy(STATE &state, AggregateInputData &) {
-		if (state.geom) {
-			GEOSGeom_destroy_r(state.context, state.geom);
-			state.geom = nullptr;
-		}
-		if (state.context) {
-			GEOS_finish_r(state.context);
-			state.context = nullptr;
+	static void Destroy(STATE &state, AggregateInputData &data) {
+		if (state.partial) {
+			delete state.partial;
+			state.partial = nullptr;
 		}
 	}
 
@@ -98,75 +160,550 @@ struct IntersectionAggFunction {
 	}
 };
 
+//------------------------------------------------------------------------
+// INTERSECTION
+//------------------------------------------------------------------------
+// The first input becomes the partial result as it is. Once the partial result is empty, it stays empty, so the
+// remaining inputs are skipped without copying them. An input whose bounding box (read from the serialized header)
+// does not intersect the partial result makes the result empty right away.
+struct IntersectionAggFunction : PartialAggFunction<IntersectionAggFunction> {
+	static void AddPart(GEOSPartial &partial, AllocatedData part, const AggregateMemoryBindData &memory) {
+		if (!partial.result.get() && partial.parts.empty()) {
+			partial.result = std::move(part);
+			return;
+		}
+		PartialAggFunction<IntersectionAggFunction>::AddPart(partial, std::move(part), memory);
+	}
+
+	// The dimension of a geometry from its type, -1 for collections which can hold any
+	static int GetDimension(GeometryType type) {
+		switch (type) {
+		case GeometryType::POINT:
+		case GeometryType::MULTIPOINT:
+			return 0;
+		case GeometryType::LINESTRING:
+		case GeometryType::MULTILINESTRING:
+			return 1;
+		case GeometryType::POLYGON:
+		case GeometryType::MULTIPOLYGON:
+			return 2;
+		default:
+			return -1;
+		}
+	}
+
+	static bool TrySkip(GEOSPartial &partial, const geometry_t &input, const AggregateMemoryBindData &memory) {
+		if (!partial.result.get()) {
+			return false;
+		}
+		BoundingBox result_box;
+		if (!GeometryFactory::TryGetSerializedBoundingBox(GetBlob(partial.result), result_box)) {
+			// The result is empty, which is not changed by the buffered inputs either
+			return true;
+		}
+		BoundingBox input_box;
+		// The serialized bounding boxes are rounded outwards, so this never rejects an intersecting input
+		if (GetDimension(input.GetType()) < 0 || !GeometryFactory::TryGetSerializedBoundingBox(input, input_box) ||
+		    result_box.Intersects(input_box)) {
+			return false;
+		}
+		// The dimension of the empty result depends on the actual result, so merge the buffered inputs first
+		Flush(partial, memory);
+		if (!GeometryFactory::TryGetSerializedBoundingBox(GetBlob(partial.result), result_box)) {
+			return true;
+		}
+		auto result_dimension = GetDimension(GetBlob(partial.result).GetType());
+		if (result_dimension < 0) {
+			return false;
+		}
+		// Like GEOS, the empty result has the lowest dimension of the two
+		GeosContextWrapper wrapper;
+		auto ctx = wrapper.GetCtx();
+		GeometryPtr empty;
+		switch (MinValue(GetDimension(input.GetType()), result_dimension)) {
+		case 0:
+			empty = make_uniq_geos(ctx, GEOSGeom_createEmptyPoint_r(ctx));
+			break;
+		case 1:
+			empty = make_uniq_geos(ctx, GEOSGeom_createEmptyLineString_r(ctx));
+			break;
+		default:
+			empty = make_uniq_geos(ctx, GEOSGeom_createEmptyPolygon_r(ctx));
+			break;
+		}
+		partial.result = SerializeGEOSGeometry(memory.allocator, empty.get(), ctx);
+		return true;
+	}
+
+	static GeometryPtr Merge(GeosContextWrapper &wrapper, const GEOSPartial &partial) {
+		auto ctx = wrapper.GetCtx();
+		GeometryPtr geom;
+		if (partial.result.get()) {
+			geom = wrapper.Deserialize(GetBlob(partial.result));
+		}
+		for (auto &part : partial.parts) {
+			if (!geom) {
+				geom = wrapper.Deserialize(GetBlob(part));
+				continue;
+			}
+			if (GEOSisEmpty_r(ctx, geom.get()) == 1) {
+				break;
+			}
+			auto next = wrapper.Deserialize(GetBlob(part));
+			geom = make_uniq_geos(ctx, GEOSIntersection_r(ctx, geom.get(), next.get()));
+		}
+		return geom;
+	}
+};
+
 //------------------------------------------------------------------------
 // UNION
 //------------------------------------------------------------------------
+// Instead of unioning every input into the partial result, the inputs are merged with a single cascaded (unary) union.
+// The cascaded union already merges neighbouring pieces first as it groups the inputs with an STR-tree, so the inputs
+// are not sorted up front.
+struct UnionAggFunction : PartialAggFunction<UnionAggFunction> {
+	static bool TrySkip(GEOSPartial &partial, const geometry_t &input, const AggregateMemoryBindData &memory) {
+		return false;
+	}
+
+	static GeometryPtr Merge(GeosContextWrapper &wrapper, const GEOSPartial &partial) {
+		auto ctx = wrapper.GetCtx();
+		vector<GeometryPtr> geoms;
+		geoms.reserve(partial.parts.size() + 1);
+		if (partial.result.get()) {
+			geoms.push_back(wrapper.Deserialize(GetBlob(partial.result)));
+		}
+		for (auto &part : partial.parts) {
+			geoms.push_back(wrapper.Deserialize(GetBlob(part)));
+		}
+		// The collection takes ownership of the parts
+		vector<GEOSGeometry *> parts;
+		parts.reserve(geoms.size());
+		for (auto &geom : geoms) {
+			parts.push_back(geom.release());
+		}
+		auto collection = make_uniq_geos(ctx, GEOSGeom_createCollection_r(ctx, GEOS_GEOMETRYCOLLECTION, parts.data(),
+		                                                                   static_cast<unsigned int>(parts.size())));
+		return make_uniq_geos(ctx, GEOSUnaryUnion_r(ctx, collection.get()));
+	}
+};
+
+//------------------------------------------------------------------------
+// CLUSTERING
+//------------------------------------------------------------------------
+// The clustering aggregates only collect the serialized inputs, all the work happens on finalize: an R-tree is bulk
+// loaded over the bounding boxes in the headers, every geometry is checked against the candidates the tree returns
+// and connected pairs are merged with union-find. Grouped aggregates finalize their groups in parallel.
+
+struct GEOSClusterAggState {
+	// Copies of the serialized inputs
+	vector<string> *geoms;
+	// The size of the copies
+	idx_t memory;
+};
+
+// Union-find with path halving and union by size
+class ClusterUnionFind {
+private:
+	vector<idx_t> parents;
+	vector<idx_t> sizes;
+
+public:
+	explicit ClusterUnionFind(idx_t count) : parents(count), sizes(count, 1) {
+		for (idx_t i = 0; i < count; i++) {
+			parents[i] = i;
+		}
+	}
+
+	idx_t Find(idx_t i) {
+		while (parents[i] != i) {
+			parents[i] = parents[parents[i]];
+			i = parents[i];
+		}
+		return i;
+	}
+
+	void Union(idx_t a, idx_t b) {
+		a = Find(a);
+		b = Find(b);
+		if (a == b) {
+			return;
+		}
+		if (sizes[a] < sizes[b]) {
+			std::swap(a, b);
+		}
+		parents[b] = a;
+		sizes[a] += sizes[b];
+	}
+};
 
-struct UnionAggFunction {
+// The collected inputs of a clustering aggregate, with an R-tree over their bounding boxes. Empty geometries are
+// not put in the tree.
+struct ClusterInput {
+	vector<geometry_t> blobs;
+	vector<RTreeBox> boxes;
+	vector<bool> is_empty;
+	FlatRTree tree;
+
+	explicit ClusterInput(const vector<string> &geoms) {
+		blobs.reserve(geoms.size());
+		boxes.resize(geoms.size());
+		is_empty.resize(geoms.size());
+		for (idx_t i = 0; i < geoms.size(); i++) {
+			blobs.emplace_back(string_t(geoms[i].data(), static_cast<uint32_t>(geoms[i].size())));
+			BoundingBox bbox;
+			if (!GeometryFactory::TryGetSerializedBoundingBox(blobs[i], bbox)) {
+				is_empty[i] = true;
+				continue;
+			}
+			boxes[i] = RTreeBox::FromBoundingBox(bbox);
+			tree.Insert(boxes[i], i);
+		}
+		tree.Build();
+	}
+};
+
+struct ClusterAggFunctionBase {
 	template <class STATE>
 	static void Initialize(STATE &state) {
-		state.geom = nullptr;
-		state.context = GEOS_init_r();
+		state.geoms = nullptr;
+		state.memory = 0;
+	}
+
+	template <class STATE>
+	static void Append(STATE &state, const geometry_t &input, idx_t count, const AggregateMemoryBindData &memory) {
+		if (!state.geoms) {
+			state.geoms = new vector<string>();
+		}
+		auto blob = string_t(input);
+		for (idx_t i = 0; i < count; i++) {
+			state.geoms->emplace_back(blob.GetData(), blob.GetSize());
+		}
+		memory.Update(state.memory, state.memory + count * (sizeof(string) + blob.GetSize()));
 	}
 
 	template <class STATE, class OP>
 	static void Combine(const STATE &source, STATE &target, AggregateInputData &data) {
-		if (!source.geom) {
+		if (!source.geoms) {
 			return;
 		}
-		if (!target.geom) {
-			target.geom = GEOSGeom_clone_r(target.context, source.geom);
-			return;
+		if (!target.geoms) {
+			target.geoms = new vector<string>();
 		}
-		auto curr = target.geom;
-		target.geom = GEOSUnion_r(target.context, curr, source.geom);
-		GEOSGeom_destroy_r(target.context, curr);
+		// The source is copied rather than moved, as it can be combined into many targets when the aggregate runs
+		// over window frames
+		target.geoms->insert(target.geoms->end(), source.geoms->begin(), source.geoms->end());
+		GetMemory(data).Update(target.memory, target.memory + source.memory);
 	}
 
 	template <class INPUT_TYPE, class STATE, class OP>
-	static void Operation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &) {
-		if (!state.geom) {
-			state.geom = DeserializeGEOSGeometry(input, state.context);
-		} else {
-			auto next = DeserializeGEOSGeometry(input, state.context);
-			auto curr = state.geom;
-			state.geom = GEOSUnion_r(state.context, curr, next);
-			GEOSGeom_destroy_r(state.context, next);
-			GEOSGeom_destroy_r(state.context, curr);
-		}
+	static void Operation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &agg) {
+		Append(state, input, 1, GetMemory(agg.input));
 	}
 
 	template <class INPUT_TYPE, class STATE, class OP>
-	static void ConstantOperation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &, idx_t count) {
-		// There is no point in doing anything else, union is idempotent
-		if (!state.geom) {
-			state.geom = DeserializeGEOSGeometry(input, state.context);
+	static void ConstantOperation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &agg, idx_t count) {
+		// Duplicates count towards the density of a cluster, so keep all of them
+		Append(state, input, count, GetMemory(agg.input));
+	}
+
+	template <class STATE>
+	static void Destroy(STATE &state, AggregateInputData &data) {
+		if (state.geoms) {
+			delete state.geoms;
+			state.geoms = nullptr;
 		}
+		GetMemory(data).Update(state.memory, 0);
 	}
 
+	static bool IgnoreNull() {
+		return true;
+	}
+};
+
+// Returns a GEOMETRYCOLLECTION for each set of geometries that are connected through intersections
+struct ClusterIntersectingAggFunction : ClusterAggFunctionBase {
 	template <class T, class STATE>
 	static void Finalize(STATE &state, T &target, AggregateFinalizeData &finalize_data) {
-		if (!state.geom) {
+		if (!state.geoms || state.geoms->empty()) {
 			finalize_data.ReturnNull();
-		} else {
-			target = SerializeGEOSGeometry(finalize_data.result, state.geom, state.context);
+			return;
 		}
+
+		auto &context = GetMemory(finalize_data.input).context;
+		GeosInterruptScope interrupt_scope(context);
+		GeosContextWrapper wrapper;
+		wrapper.double_bbox = GeometryFunctionLocalState::GetDoubleBBox(context);
+		auto ctx = wrapper.GetCtx();
+		ClusterInput input(*state.geoms);
+		auto count = input.blobs.size();
+
+		vector<GeometryPtr> geoms;
+		geoms.reserve(count);
+		for (auto &blob : input.blobs) {
+			geoms.push_back(wrapper.Deserialize(blob));
+		}
+
+		ClusterUnionFind clusters(count);
+		vector<idx_t> stack;
+		for (idx_t i = 0; i < count; i++) {
+			interrupt_scope.Check();
+			if (input.is_empty[i]) {
+				continue;
+			}
+			input.tree.Search(input.boxes[i], stack, [&](idx_t j, const RTreeBox &) {
+				if (j <= i || clusters.Find(i) == clusters.Find(j)) {
+					return;
+				}
+				if (GEOSIntersects_r(ctx, geoms[i].get(), geoms[j].get()) == 1) {
+					clusters.Union(i, j);
+				}
+			});
+		}
+
+		// Number the clusters in order of their first member
+		unordered_map<idx_t, idx_t> cluster_ids;
+		vector<vector<GEOSGeometry *>> members;
+		for (idx_t i = 0; i < count; i++) {
+			auto entry = cluster_ids.emplace(clusters.Find(i), members.size());
+			if (entry.second) {
+				members.emplace_back();
+			}
+			members[entry.first->second].push_back(geoms[i].release());
+		}
+
+		auto &result = finalize_data.result;
+		auto offset = ListVector::GetListSize(result);
+		ListVector::Reserve(result, offset + members.size());
+		auto &child = ListVector::GetEntry(result);
+		auto child_data = FlatVector::GetData<geometry_t>(child);
+		for (idx_t i = 0; i < members.size(); i++) {
+			// The collection takes ownership of its members
+			auto collection = make_uniq_geos(
+			    ctx, GEOSGeom_createCollection_r(ctx, GEOS_GEOMETRYCOLLECTION, members[i].data(),
+			                                     static_cast<unsigned int>(members[i].size())));
+			child_data[offset + i] = wrapper.Serialize(child, collection);
+		}
+		ListVector::SetListSize(result, offset + members.size());
+		target.offset = offset;
+		target.length = members.size();
 	}
+};
 
-	template <class STATE>
-	static void Destroy(STATE &state, AggregateInputData &) {
-		if (state.geom) {
-			GEOSGeom_destroy_r(state.context, state.geom);
-			state.geom = nullptr;
+struct ClusterDBSCANBindData final : public AggregateMemoryBindData {
+	double eps;
+	idx_t min_points;
+
+	ClusterDBSCANBindData(string function_name, ClientContext &context, double eps, idx_t min_points)
+	    : AggregateMemoryBindData(std::move(function_name), context), eps(eps), min_points(min_points) {
+	}
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<ClusterDBSCANBindData>(function_name, context, eps, min_points);
+	}
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<ClusterDBSCANBindData>();
+		return AggregateMemoryBindData::Equals(other) && eps == other.eps && min_points == other.min_points;
+	}
+};
+
+static unique_ptr<FunctionData> ClusterDBSCANBind(ClientContext &context, AggregateFunction &function,
+                                                  vector<unique_ptr<Expression>> &arguments) {
+	if (!arguments[1]->IsFoldable() || !arguments[2]->IsFoldable()) {
+		throw InvalidInputException("ST_ClusterDBSCAN: eps and minpoints must be constant");
+	}
+	auto eps_value = ExpressionExecutor::EvaluateScalar(context, *arguments[1]);
+	auto min_points_value = ExpressionExecutor::EvaluateScalar(context, *arguments[2]);
+	if (eps_value.IsNull() || min_points_value.IsNull()) {
+		throw InvalidInputException("ST_ClusterDBSCAN: eps and minpoints can not be NULL");
+	}
+	// The arguments are not cast to the parameter types yet
+	auto eps = eps_value.GetValue<double>();
+	auto min_points = min_points_value.GetValue<int32_t>();
+	if (!(eps >= 0)) {
+		throw InvalidInputException("ST_ClusterDBSCAN: eps must be a non-negative number");
+	}
+	if (min_points < 1) {
+		throw InvalidInputException("ST_ClusterDBSCAN: minpoints must be at least 1");
+	}
+
+	// The parameters are constant, so the aggregate itself only sees the geometries
+	Function::EraseArgument(function, arguments, 2);
+	Function::EraseArgument(function, arguments, 1);
+	return make_uniq<ClusterDBSCANBindData>(function.name, context, eps, static_cast<idx_t>(min_points));
+}
+
+// Returns every input together with the id of its DBSCAN cluster, or NULL if it is noise. A geometry is a core point
+// if at least minpoints geometries (including itself) are within eps of it. Core points within eps of each other are
+// in the same cluster, and geometries within eps of a core point but not core points themselves join the cluster of
+// the first such core point.
+struct ClusterDBSCANAggFunction : ClusterAggFunctionBase {
+	template <class T, class STATE>
+	static void Finalize(STATE &state, T &target, AggregateFinalizeData &finalize_data) {
+		if (!state.geoms || state.geoms->empty()) {
+			finalize_data.ReturnNull();
+			return;
 		}
-		if (state.context) {
-			GEOS_finish_r(state.context);
-			state.context = nullptr;
+		auto &bind_data = finalize_data.input.bind_data->Cast<ClusterDBSCANBindData>();
+		auto eps = bind_data.eps;
+
+		GeosInterruptScope interrupt_scope(bind_data.context);
+		GeosContextWrapper wrapper;
+		auto ctx = wrapper.GetCtx();
+		ClusterInput input(*state.geoms);
+		auto count = input.blobs.size();
+
+		// Only deserialized for pairs that can not be measured natively
+		vector<GeometryPtr> geoms(count);
+		auto is_within = [&](idx_t i, idx_t j) {
+			if (i == j) {
+				return true;
+			}
+			double distance;
+			if (!PointDistance::TryCompute(input.blobs[i], input.blobs[j], distance)) {
+				if (!geoms[i]) {
+					geoms[i] = wrapper.Deserialize(input.blobs[i]);
+				}
+				if (!geoms[j]) {
+					geoms[j] = wrapper.Deserialize(input.blobs[j]);
+				}
+				GEOSDistance_r(ctx, geoms[i].get(), geoms[j].get(), &distance);
+			}
+			return distance <= eps;
+		};
+		auto search_box = [&](idx_t i) {
+			BoundingBox bbox;
+			bbox.minx = input.boxes[i].minx - eps;
+			bbox.miny = input.boxes[i].miny - eps;
+			bbox.maxx = input.boxes[i].maxx + eps;
+			bbox.maxy = input.boxes[i].maxy + eps;
+			return RTreeBox::FromBoundingBox(bbox);
+		};
+
+		// Find the core points
+		vector<bool> is_core(count, false);
+		vector<idx_t> stack;
+		for (idx_t i = 0; i < count; i++) {
+			interrupt_scope.Check();
+			if (input.is_empty[i]) {
+				continue;
+			}
+			idx_t neighbors = 0;
+			input.tree.Search(search_box(i), stack, [&](idx_t j, const RTreeBox &) {
+				if (neighbors < bind_data.min_points && is_within(i, j)) {
+					neighbors++;
+				}
+			});
+			is_core[i] = neighbors >= bind_data.min_points;
+		}
+
+		// Connect the core points, and attach the border points to the first core point that reaches them
+		ClusterUnionFind clusters(count);
+		vector<idx_t> border_of(count, DConstants::INVALID_INDEX);
+		for (idx_t i = 0; i < count; i++) {
+			interrupt_scope.Check();
+			if (!is_core[i]) {
+				continue;
+			}
+			input.tree.Search(search_box(i), stack, [&](idx_t j, const RTreeBox &) {
+				if (is_core[j]) {
+					if (j > i && clusters.Find(i) != clusters.Find(j) && is_within(i, j)) {
+						clusters.Union(i, j);
+					}
+				} else if (border_of[j] == DConstants::INVALID_INDEX && is_within(i, j)) {
+					border_of[j] = i;
+				}
+			});
+		}
+
+		auto &result = finalize_data.result;
+		auto offset = ListVector::GetListSize(result);
+		ListVector::Reserve(result, offset + count);
+		auto &child_entries = StructVector::GetEntries(ListVector::GetEntry(result));
+		auto &geom_vec = *child_entries[0];
+		auto &cluster_vec = *child_entries[1];
+		auto geom_data = FlatVector::GetData<geometry_t>(geom_vec);
+		auto cluster_data = FlatVector::GetData<int32_t>(cluster_vec);
+		auto &cluster_validity = FlatVector::Validity(cluster_vec);
+
+		// Number the clusters in order of their first member
+		unordered_map<idx_t, int32_t> cluster_ids;
+		for (idx_t i = 0; i < count; i++) {
+			geom_data[offset + i] = geometry_t(StringVector::AddStringOrBlob(geom_vec, string_t(input.blobs[i])));
+			auto core = is_core[i] ? i : border_of[i];
+			if (core == DConstants::INVALID_INDEX) {
+				cluster_validity.SetInvalid(offset + i);
+				continue;
+			}
+			auto entry = cluster_ids.emplace(clusters.Find(core), static_cast<int32_t>(cluster_ids.size()));
+			cluster_data[offset + i] = entry.first->second;
 		}
+		ListVector::SetListSize(result, offset + count);
+		target.offset = offset;
+		target.length = count;
 	}
+};
 
-	static bool IgnoreNull() {
-		return true;
+//------------------------------------------------------------------------
+// LINEWORK
+//------------------------------------------------------------------------
+// ST_LineMerge_Agg and ST_Node_Agg collect the serialized (multi)linestrings of a group and merge or node all of them
+// with a single GEOS call on finalize, instead of first unioning the inputs one by one. Like the clustering
+// aggregates, Combine only copies the inputs of the other states over: two lines merged in one state could meet a
+// line of another state where they join, so merging can not be applied to partial results. Grouped aggregates
+// finalize their groups in parallel.
+
+template <GEOSGeometry *(*LINEWORK_FUNCTION)(GEOSContextHandle_t, const GEOSGeometry *)>
+struct LineworkAggFunction : ClusterAggFunctionBase {
+	// Everything but (multi)linestrings is skipped
+	static bool IsLineal(const geometry_t &input) {
+		auto type = input.GetType();
+		return type == GeometryType::LINESTRING || type == GeometryType::MULTILINESTRING;
+	}
+
+	template <class INPUT_TYPE, class STATE, class OP>
+	static void Operation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &agg) {
+		if (IsLineal(input)) {
+			Append(state, input, 1, GetMemory(agg.input));
+		}
+	}
+
+	template <class INPUT_TYPE, class STATE, class OP>
+	static void ConstantOperation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &agg, idx_t count) {
+		// Repeated lines are kept, so that the result is the same as for the collection of all the inputs
+		if (IsLineal(input)) {
+			Append(state, input, count, GetMemory(agg.input));
+		}
+	}
+
+	template <class T, class STATE>
+	static void Finalize(STATE &state, T &target, AggregateFinalizeData &finalize_data) {
+		if (!state.geoms || state.geoms->empty()) {
+			finalize_data.ReturnNull();
+			return;
+		}
+
+		auto &context = GetMemory(finalize_data.input).context;
+		GeosInterruptScope interrupt_scope(context);
+		GeosContextWrapper wrapper;
+		wrapper.double_bbox = GeometryFunctionLocalState::GetDoubleBBox(context);
+		auto ctx = wrapper.GetCtx();
+		vector<GeometryPtr> geoms;
+		geoms.reserve(state.geoms->size());
+		for (auto &geom : *state.geoms) {
+			geoms.push_back(wrapper.Deserialize(geometry_t(string_t(geom.data(), static_cast<uint32_t>(geom.size())))));
+		}
+		// The collection takes ownership of the lines
+		vector<GEOSGeometry *> lines;
+		lines.reserve(geoms.size());
+		for (auto &geom : geoms) {
+			lines.push_back(geom.release());
+		}
+		auto collection = make_uniq_geos(ctx, GEOSGeom_createCollection_r(ctx, GEOS_GEOMETRYCOLLECTION, lines.data(),
+		                                                                   static_cast<unsigned int>(lines.size())));
+		auto result = make_uniq_geos(ctx, LINEWORK_FUNCTION(ctx, collection.get()));
+		interrupt_scope.Check();
+		target = wrapper.Serialize(finalize_data.result, result);
 	}
 };
 
@@ -177,18 +714,61 @@ void GeosAggregateFunctions::Register(DatabaseInstance &db) {
 	;
 
 	AggregateFunctionSet st_intersection_agg("ST_Intersection_Agg");
-	st_intersection_agg.AddFunction(
-	    AggregateFunction::UnaryAggregateDestructor<GEOSAggState, geometry_t, geometry_t, IntersectionAggFunction>(
-	        core::GeoTypes::GEOMETRY(), core::GeoTypes::GEOMETRY()));
+	auto intersection_agg = AggregateFunction::UnaryAggregateDestructor<GEOSPartialAggState, geometry_t, geometry_t,
+	                                                                    IntersectionAggFunction>(
+	    core::GeoTypes::GEOMETRY(), core::GeoTypes::GEOMETRY());
+	intersection_agg.bind = AggregateMemoryBindData::Bind;
+	st_intersection_agg.AddFunction(intersection_agg);
 
 	ExtensionUtil::RegisterFunction(db, st_intersection_agg);
 
 	AggregateFunctionSet st_union_agg("ST_Union_Agg");
-	st_union_agg.AddFunction(
-	    AggregateFunction::UnaryAggregateDestructor<GEOSAggState, geometry_t, geometry_t, UnionAggFunction>(
-	        core::GeoTypes::GEOMETRY(), core::GeoTypes::GEOMETRY()));
+	auto union_agg = AggregateFunction::UnaryAggregateDestructor<GEOSPartialAggState, geometry_t, geometry_t,
+	                                                             UnionAggFunction>(core::GeoTypes::GEOMETRY(),
+	                                                                               core::GeoTypes::GEOMETRY());
+	union_agg.bind = AggregateMemoryBindData::Bind;
+	st_union_agg.AddFunction(union_agg);
 
 	ExtensionUtil::RegisterFunction(db, st_union_agg);
+
+	AggregateFunctionSet st_linemerge_agg("ST_LineMerge_Agg");
+	auto linemerge_agg = AggregateFunction::UnaryAggregateDestructor<GEOSClusterAggState, geometry_t, geometry_t,
+	                                                                 LineworkAggFunction<GEOSLineMerge_r>>(
+	    core::GeoTypes::GEOMETRY(), core::GeoTypes::GEOMETRY());
+	linemerge_agg.bind = AggregateMemoryBindData::Bind;
+	st_linemerge_agg.AddFunction(linemerge_agg);
+
+	ExtensionUtil::RegisterFunction(db, st_linemerge_agg);
+
+	AggregateFunctionSet st_node_agg("ST_Node_Agg");
+	auto node_agg = AggregateFunction::UnaryAggregateDestructor<GEOSClusterAggState, geometry_t, geometry_t,
+	                                                            LineworkAggFunction<GEOSNode_r>>(
+	    core::GeoTypes::GEOMETRY(), core::GeoTypes::GEOMETRY());
+	node_agg.bind = AggregateMemoryBindData::Bind;
+	st_node_agg.AddFunction(node_agg);
+
+	ExtensionUtil::RegisterFunction(db, st_node_agg);
+
+	AggregateFunctionSet st_cluster_intersecting("ST_ClusterIntersecting");
+	auto cluster_intersecting = AggregateFunction::UnaryAggregateDestructor<GEOSClusterAggState, geometry_t,
+	                                                                        list_entry_t, ClusterIntersectingAggFunction>(
+	    core::GeoTypes::GEOMETRY(), LogicalType::LIST(core::GeoTypes::GEOMETRY()));
+	cluster_intersecting.bind = AggregateMemoryBindData::Bind;
+	st_cluster_intersecting.AddFunction(cluster_intersecting);
+
+	ExtensionUtil::RegisterFunction(db, st_cluster_intersecting);
+
+	AggregateFunctionSet st_cluster_dbscan("ST_ClusterDBSCAN");
+	auto dbscan_type = LogicalType::LIST(
+	    LogicalType::STRUCT({{"geom", core::GeoTypes::GEOMETRY()}, {"cluster_id", LogicalType::INTEGER}}));
+	auto dbscan = AggregateFunction::UnaryAggregateDestructor<GEOSClusterAggState, geometry_t, list_entry_t,
+	                                                          ClusterDBSCANAggFunction>(core::GeoTypes::GEOMETRY(),
+	                                                                                    dbscan_type);
+	dbscan.arguments = {core::GeoTypes::GEOMETRY(), LogicalType::DOUBLE, LogicalType::INTEGER};
+	dbscan.bind = ClusterDBSCANBind;
+	st_cluster_dbscan.AddFunction(dbscan);
+
+	ExtensionUtil::RegisterFunction(db, st_cluster_dbscan);
 }
 
 } // namespace geos
@@ -11,9 +11,9 @@ namespace spatial {
 namespace geos {
 
 static bool WKBToWKTCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters) {
-	auto ctx = GeosContextWrapper();
-	auto reader = ctx.CreateWKBReader();
-	auto writer = ctx.CreateWKTWriter();
+	GeosContextWrapper ctx;
+	auto &reader = ctx.GetWKBReader();
+	auto &writer = ctx.GetWKTWriter();
 	writer.SetTrim(true);
 
 	UnaryExecutor::Execute<string_t, string_t>(source, result, count, [&](string_t input) {
@@ -7,9 +7,26 @@ namespace geos {
 
 using namespace spatial::core;
 
-GEOSFunctionLocalState::GEOSFunctionLocalState(ClientContext &context) : ctx(), factory(BufferAllocator::Get(context)) {
+GEOSFunctionLocalState::GEOSFunctionLocalState(ClientContext &context)
+    : context(context), ctx(), factory(BufferAllocator::Get(context)), arena_soft_limit(GeometryArena::GetSoftLimit(context)) {
 	// TODO: Set GEOS error handler
 	// GEOSContext_setErrorMessageHandler_r()
+	factory.double_bbox = GeometryFunctionLocalState::GetDoubleBBox(context);
+	factory.counters.Init(context);
+	ctx.counters = &factory.counters;
+	ctx.double_bbox = factory.double_bbox;
+}
+
+GEOSFunctionLocalState::~GEOSFunctionLocalState() {
+	factory.counters.Flush();
+	GeometryArena::Release(factory.allocator, arena_size);
+}
+
+PreparedGeometryCache &GEOSFunctionLocalState::GetPreparedCache() {
+	if (!prepared_cache) {
+		prepared_cache = make_uniq<PreparedGeometryCache>(ctx.GetCtx());
+	}
+	return *prepared_cache;
 }
 
 unique_ptr<FunctionLocalState> GEOSFunctionLocalState::Init(ExpressionState &state, const BoundFunctionExpression &expr,
@@ -23,13 +40,13 @@ unique_ptr<FunctionLocalState> GEOSFunctionLocalState::InitCast(CastLocalStatePa
 
 GEOSFunctionLocalState &GEOSFunctionLocalState::ResetAndGet(CastParameters &parameters) {
 	auto &local_state = (GEOSFunctionLocalState &)*parameters.local_state;
-	local_state.factory.allocator.Reset();
+	GeometryArena::Reset(local_state.factory.allocator, local_state.arena_soft_limit, local_state.arena_size);
 	return local_state;
 }
 
 GEOSFunctionLocalState &GEOSFunctionLocalState::ResetAndGet(ExpressionState &state) {
 	auto &local_state = (GEOSFunctionLocalState &)*ExecuteFunctionState::GetFunctionState(state);
-	local_state.factory.allocator.Reset();
+	GeometryArena::Reset(local_state.factory.allocator, local_state.arena_soft_limit, local_state.arena_size);
 	return local_state;
 }
 
@@ -0,0 +1,236 @@
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/geometry/clip_by_box.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/geos/functions/scalar.hpp"
+#include "spatial/geos/functions/common.hpp"
+#include "spatial/geos/geos_wrappers.hpp"
+
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+
+namespace spatial {
+
+namespace geos {
+
+using namespace spatial::core;
+
+static constexpr int32_t MVT_DEFAULT_EXTENT = 4096;
+static constexpr int32_t MVT_DEFAULT_BUFFER = 256;
+
+struct TileTransform {
+	double x_min;
+	double y_max;
+	double x_scale;
+	double y_scale;
+
+	// Tile coordinates start in the top left corner, with y pointing down
+	static int Apply(double *x, double *y, void *userdata) {
+		auto &transform = *static_cast<TileTransform *>(userdata);
+		*x = (*x - transform.x_min) * transform.x_scale;
+		*y = (transform.y_max - *y) * transform.y_scale;
+		return 1;
+	}
+};
+
+// Clipping can turn e.g. a polygon into a collection that also holds the lines and points where it touches the
+// clipping rectangle. Only keep the parts with the same dimension as the input, the way they can be encoded in a tile.
+static GeometryPtr ExtractDimension(GEOSContextHandle_t ctx, GeometryPtr geom, int dimension) {
+	if (GEOSGeomTypeId_r(ctx, geom.get()) != GEOS_GEOMETRYCOLLECTION) {
+		return geom;
+	}
+	vector<GEOSGeometry *> parts;
+	auto num_parts = GEOSGetNumGeometries_r(ctx, geom.get());
+	for (int i = 0; i < num_parts; i++) {
+		auto part = GEOSGetGeometryN_r(ctx, geom.get(), i);
+		if (GEOSGeom_getDimensions_r(ctx, part) != dimension || GEOSisEmpty_r(ctx, part)) {
+			continue;
+		}
+		auto type = GEOSGeomTypeId_r(ctx, part);
+		if (type == GEOS_MULTIPOINT || type == GEOS_MULTILINESTRING || type == GEOS_MULTIPOLYGON) {
+			auto num_items = GEOSGetNumGeometries_r(ctx, part);
+			for (int j = 0; j < num_items; j++) {
+				parts.push_back(GEOSGeom_clone_r(ctx, GEOSGetGeometryN_r(ctx, part, j)));
+			}
+		} else {
+			parts.push_back(GEOSGeom_clone_r(ctx, part));
+		}
+	}
+	auto type = dimension == 0 ? GEOS_MULTIPOINT : dimension == 1 ? GEOS_MULTILINESTRING : GEOS_MULTIPOLYGON;
+	return make_uniq_geos(ctx, GEOSGeom_createCollection_r(ctx, type, parts.data(), parts.size()));
+}
+
+static bool IsPuntalOrLineal(GeometryType type) {
+	return type == GeometryType::POINT || type == GeometryType::MULTIPOINT || type == GeometryType::LINESTRING ||
+	       type == GeometryType::MULTILINESTRING;
+}
+
+static void AsMVTGeomFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
+	auto ctx = lstate.ctx.GetCtx();
+	auto count = args.size();
+
+	GeometryWriter writer;
+	BoxClipper clipper;
+
+	UnifiedVectorFormat geom_format;
+	UnifiedVectorFormat bounds_format;
+	UnifiedVectorFormat extent_format;
+	UnifiedVectorFormat buffer_format;
+	UnifiedVectorFormat clip_format;
+	args.data[0].ToUnifiedFormat(count, geom_format);
+	args.data[1].ToUnifiedFormat(count, bounds_format);
+	auto has_extent = args.ColumnCount() > 2;
+	auto has_buffer = args.ColumnCount() > 3;
+	auto has_clip = args.ColumnCount() > 4;
+	if (has_extent) {
+		args.data[2].ToUnifiedFormat(count, extent_format);
+	}
+	if (has_buffer) {
+		args.data[3].ToUnifiedFormat(count, buffer_format);
+	}
+	if (has_clip) {
+		args.data[4].ToUnifiedFormat(count, clip_format);
+	}
+
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto result_data = FlatVector::GetData<geometry_t>(result);
+	auto &result_validity = FlatVector::Validity(result);
+
+	for (idx_t row_idx = 0; row_idx < count; row_idx++) {
+		auto geom_idx = geom_format.sel->get_index(row_idx);
+		auto bounds_idx = bounds_format.sel->get_index(row_idx);
+		auto extent_idx = has_extent ? extent_format.sel->get_index(row_idx) : 0;
+		auto buffer_idx = has_buffer ? buffer_format.sel->get_index(row_idx) : 0;
+		auto clip_idx = has_clip ? clip_format.sel->get_index(row_idx) : 0;
+		if (!geom_format.validity.RowIsValid(geom_idx) || !bounds_format.validity.RowIsValid(bounds_idx) ||
+		    (has_extent && !extent_format.validity.RowIsValid(extent_idx)) ||
+		    (has_buffer && !buffer_format.validity.RowIsValid(buffer_idx)) ||
+		    (has_clip && !clip_format.validity.RowIsValid(clip_idx))) {
+			result_validity.SetInvalid(row_idx);
+			continue;
+		}
+
+		auto extent =
+		    has_extent ? UnifiedVectorFormat::GetData<int32_t>(extent_format)[extent_idx] : MVT_DEFAULT_EXTENT;
+		auto buffer =
+		    has_buffer ? UnifiedVectorFormat::GetData<int32_t>(buffer_format)[buffer_idx] : MVT_DEFAULT_BUFFER;
+		auto clip = has_clip ? UnifiedVectorFormat::GetData<bool>(clip_format)[clip_idx] : true;
+		if (extent <= 0) {
+			throw InvalidInputException("ST_AsMVTGeom: extent must be positive");
+		}
+		if (buffer < 0) {
+			throw InvalidInputException("ST_AsMVTGeom: buffer must not be negative");
+		}
+
+		auto bounds = lstate.ctx.Deserialize(UnifiedVectorFormat::GetData<geometry_t>(bounds_format)[bounds_idx]);
+		double bounds_x_min, bounds_y_min, bounds_x_max, bounds_y_max;
+		if (GEOSisEmpty_r(ctx, bounds.get()) || !GEOSGeom_getXMin_r(ctx, bounds.get(), &bounds_x_min) ||
+		    !GEOSGeom_getYMin_r(ctx, bounds.get(), &bounds_y_min) ||
+		    !GEOSGeom_getXMax_r(ctx, bounds.get(), &bounds_x_max) ||
+		    !GEOSGeom_getYMax_r(ctx, bounds.get(), &bounds_y_max) || !(bounds_x_max > bounds_x_min) ||
+		    !(bounds_y_max > bounds_y_min)) {
+			throw InvalidInputException("ST_AsMVTGeom: bounds must have a positive width and height");
+		}
+
+		TileTransform transform {bounds_x_min, bounds_y_max, extent / (bounds_x_max - bounds_x_min),
+		                         extent / (bounds_y_max - bounds_y_min)};
+
+		auto blob = UnifiedVectorFormat::GetData<geometry_t>(geom_format)[geom_idx];
+		// Whether the geometry still has to be clipped to the buffered tile after the transform
+		auto clip_in_tile = clip;
+		if (clip) {
+			BoundingBox bbox;
+			if (!GeometryFactory::TryGetSerializedBoundingBox(blob, bbox)) {
+				// Empty
+				result_validity.SetInvalid(row_idx);
+				continue;
+			}
+			BoundingBox tile_box;
+			tile_box.minx = bounds_x_min - buffer / transform.x_scale;
+			tile_box.miny = bounds_y_min - buffer / transform.y_scale;
+			tile_box.maxx = bounds_x_max + buffer / transform.x_scale;
+			tile_box.maxy = bounds_y_max + buffer / transform.y_scale;
+			// Skip the transform entirely if the geometry is outside of the buffered tile
+			if (!bbox.Intersects(tile_box)) {
+				result_validity.SetInvalid(row_idx);
+				continue;
+			}
+			if (bbox.minx >= tile_box.minx && bbox.miny >= tile_box.miny && bbox.maxx <= tile_box.maxx &&
+			    bbox.maxy <= tile_box.maxy) {
+				clip_in_tile = false;
+			} else if (IsPuntalOrLineal(blob.GetType())) {
+				// Points and lines are clipped natively before they are handed to GEOS. Polygons are left to GEOS,
+				// as snapping them to the grid needs the valid result of an overlay.
+				blob = clipper.Execute(blob, tile_box, writer, result);
+				clip_in_tile = false;
+			}
+		}
+
+		auto geom = lstate.ctx.Deserialize(blob);
+		if (GEOSisEmpty_r(ctx, geom.get())) {
+			result_validity.SetInvalid(row_idx);
+			continue;
+		}
+
+		auto dimension = GEOSGeom_getDimensions_r(ctx, geom.get());
+		auto tile_geom = make_uniq_geos(ctx, GEOSGeom_transformXY_r(ctx, geom.get(), TileTransform::Apply, &transform));
+		if (!tile_geom) {
+			throw InvalidInputException("ST_AsMVTGeom: could not transform geometry");
+		}
+
+		if (clip_in_tile) {
+			tile_geom = make_uniq_geos(ctx, GEOSClipByRect_r(ctx, tile_geom.get(), -buffer, -buffer, extent + buffer,
+			                                                 extent + buffer));
+			if (!tile_geom) {
+				throw InvalidInputException("ST_AsMVTGeom: could not clip geometry");
+			}
+		}
+
+		// Snap to the integer grid of the tile. This also drops repeated points and parts that collapse.
+		tile_geom = make_uniq_geos(ctx, GEOSGeom_setPrecision_r(ctx, tile_geom.get(), 1.0, 0));
+		if (!tile_geom) {
+			throw InvalidInputException("ST_AsMVTGeom: could not snap geometry to the tile grid");
+		}
+
+		// Remove the vertices that are collinear with their neighbors after snapping
+		if (dimension > 0 && !GEOSisEmpty_r(ctx, tile_geom.get())) {
+			tile_geom = make_uniq_geos(ctx, GEOSSimplify_r(ctx, tile_geom.get(), 0));
+			if (!tile_geom) {
+				throw InvalidInputException("ST_AsMVTGeom: could not simplify geometry");
+			}
+		}
+
+		tile_geom = ExtractDimension(ctx, std::move(tile_geom), dimension);
+		if (GEOSisEmpty_r(ctx, tile_geom.get())) {
+			result_validity.SetInvalid(row_idx);
+			continue;
+		}
+
+		result_data[row_idx] = lstate.ctx.Serialize(result, tile_geom);
+	}
+
+	if (count == 1) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
+}
+
+void GEOSScalarFunctions::RegisterStAsMVTGeom(DatabaseInstance &db) {
+
+	ScalarFunctionSet set("ST_AsMVTGeom");
+
+	vector<LogicalType> arguments = {GeoTypes::GEOMETRY(), GeoTypes::GEOMETRY()};
+	set.AddFunction(ScalarFunction(arguments, GeoTypes::GEOMETRY(), AsMVTGeomFunction, nullptr, nullptr, nullptr,
+	                               GEOSFunctionLocalState::Init));
+	for (auto &type : {LogicalType::INTEGER, LogicalType::INTEGER, LogicalType::BOOLEAN}) {
+		arguments.push_back(type);
+		set.AddFunction(ScalarFunction(arguments, GeoTypes::GEOMETRY(), AsMVTGeomFunction, nullptr, nullptr, nullptr,
+		                               GEOSFunctionLocalState::Init));
+	}
+
+	ExtensionUtil::RegisterFunction(db, set);
+}
+
+} // namespace geos
+
+} // namespace spatial
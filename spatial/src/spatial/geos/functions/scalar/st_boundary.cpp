@@ -17,6 +17,7 @@ using namespace spatial::core;
 static void BoundaryFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 
 	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
 
 	UnaryExecutor::ExecuteWithNulls<geometry_t, geometry_t>(
 	    args.data[0], result, args.size(), [&](geometry_t &geometry_blob, ValidityMask &mask, idx_t i) {
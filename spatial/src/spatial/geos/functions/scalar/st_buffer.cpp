@@ -1,8 +1,11 @@
 #include "spatial/common.hpp"
 #include "spatial/core/types.hpp"
+#include "spatial/core/functions/common.hpp"
+#include "spatial/core/geometry/point_in_polygon.hpp"
 #include "spatial/geos/functions/scalar.hpp"
 #include "spatial/geos/functions/common.hpp"
 #include "spatial/geos/geos_wrappers.hpp"
+#include "spatial/geos/geos_split.hpp"
 
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
 #include "duckdb/common/vector_operations/unary_executor.hpp"
@@ -15,33 +18,155 @@ namespace geos {
 
 using namespace spatial::core;
 
+//------------------------------------------------------------------------------
+// Local state
+//------------------------------------------------------------------------------
+// GEOS buffers a point into a regular polygon with 4 vertices per quadrant segment, starting at angle 0 and going
+// clockwise. Points are buffered natively from a unit circle for the most recent number of segments instead, which
+// is only scaled and translated per row. Styled buffers of other geometries reuse their GEOSBufferParams as long as
+// the style does not change.
+struct BufferLocalState : GEOSFunctionLocalState {
+	static constexpr double PI = 3.14159265358979323846;
+
+	int32_t circle_segments = 0;
+	vector<double> circle_x;
+	vector<double> circle_y;
+
+	int32_t params_segments = 0;
+	GEOSBufCapStyles params_cap_style = GEOSBUF_CAP_ROUND;
+	GEOSBufJoinStyles params_join_style = GEOSBUF_JOIN_ROUND;
+	double params_mitre_limit = 0;
+	unique_ptr<GEOSBufferParams, GeosDeleter<GEOSBufferParams>> params;
+
+	explicit BufferLocalState(ClientContext &context) : GEOSFunctionLocalState(context) {
+	}
+
+	static unique_ptr<FunctionLocalState> Init(ExpressionState &state, const BoundFunctionExpression &expr,
+	                                           FunctionData *bind_data) {
+		return make_uniq<BufferLocalState>(state.GetContext());
+	}
+
+	static BufferLocalState &ResetAndGet(ExpressionState &state) {
+		return static_cast<BufferLocalState &>(GEOSFunctionLocalState::ResetAndGet(state));
+	}
+
+	// Buffer a non-empty point by a positive radius without GEOS, returns false for anything else
+	bool TryBufferPoint(const geometry_t &blob, double radius, int32_t segments, Vector &result, geometry_t &buffer) {
+		double x;
+		double y;
+		if (!(radius > 0) || segments < 1 || !PointInPolygon::TryGetPoint(blob, x, y)) {
+			return false;
+		}
+		if (segments != circle_segments) {
+			// Computed the same way as the fillets of GEOS, so the vertices are identical
+			auto vertex_count = 4 * static_cast<idx_t>(segments);
+			auto angle_increment = 2.0 * PI / static_cast<double>(vertex_count);
+			circle_x.resize(vertex_count);
+			circle_y.resize(vertex_count);
+			for (idx_t i = 0; i < vertex_count; i++) {
+				auto angle = -static_cast<double>(i) * angle_increment;
+				circle_x[i] = std::cos(angle);
+				circle_y[i] = std::sin(angle);
+			}
+			circle_segments = segments;
+		}
+
+		auto vertex_count = static_cast<uint32_t>(circle_x.size());
+		auto capacity = vertex_count + 1;
+		Polygon circle(factory.allocator, 1, &capacity, false, false);
+		auto &shell = circle[0];
+		shell.Set(0, x + radius, y);
+		for (uint32_t i = 1; i < vertex_count; i++) {
+			shell.Set(i, x + radius * circle_x[i], y + radius * circle_y[i]);
+		}
+		shell.Set(vertex_count, x + radius, y);
+		buffer = factory.Serialize(result, circle, false, false);
+		return true;
+	}
+
+	GEOSBufferParams *GetParams(int32_t segments, GEOSBufCapStyles cap_style, GEOSBufJoinStyles join_style,
+	                            double mitre_limit) {
+		if (params && segments == params_segments && cap_style == params_cap_style &&
+		    join_style == params_join_style && mitre_limit == params_mitre_limit) {
+			return params.get();
+		}
+		auto &geos_ctx = ctx.GetCtx();
+		params = make_uniq_geos(geos_ctx, GEOSBufferParams_create_r(geos_ctx));
+		GEOSBufferParams_setQuadrantSegments_r(geos_ctx, params.get(), segments);
+		GEOSBufferParams_setEndCapStyle_r(geos_ctx, params.get(), cap_style);
+		GEOSBufferParams_setJoinStyle_r(geos_ctx, params.get(), join_style);
+		GEOSBufferParams_setMitreLimit_r(geos_ctx, params.get(), mitre_limit);
+		params_segments = segments;
+		params_cap_style = cap_style;
+		params_join_style = join_style;
+		params_mitre_limit = mitre_limit;
+		return params.get();
+	}
+};
+
+//------------------------------------------------------------------------------
+// ST_Buffer
+//------------------------------------------------------------------------------
+// Huge geometries are split over all threads if "spatial_split_threshold" is set. The round buffer of a union is the
+// union of the buffers, but only for a positive radius: a negative one would open gaps along the cuts.
+static GeometryPtr BufferGEOS(GEOSFunctionLocalState &lstate, idx_t split_threshold, const GeometryPtr &geom,
+                              double radius, int32_t segments) {
+	auto &ctx = lstate.ctx.GetCtx();
+	if (radius > 0 && GEOSSplitExecutor::ShouldSplit(ctx, split_threshold, {geom.get()})) {
+		auto buffer_cell = [&](GEOSContextHandle_t cell_ctx, vector<GeometryPtr> &pieces) {
+			return make_uniq_geos(cell_ctx, GEOSBuffer_r(cell_ctx, pieces[0].get(), radius, segments));
+		};
+		return GEOSSplitExecutor::Execute(lstate.context, lstate.ctx, {geom.get()}, buffer_cell);
+	}
+	return make_uniq_geos(ctx, GEOSBuffer_r(ctx, geom.get(), radius, segments));
+}
+
 static void BufferFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 
-	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	auto &lstate = BufferLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
+	auto split_threshold = GEOSSplitExecutor::GetThreshold(lstate.context);
 	auto &left = args.data[0];
 	auto &right = args.data[1];
 
-	BinaryExecutor::Execute<geometry_t, double, geometry_t>(
-	    left, right, result, args.size(), [&](geometry_t &geometry_blob, double radius) {
-		    auto geos_geom = lstate.ctx.Deserialize(geometry_blob);
-		    auto boundary =
-		        make_uniq_geos(lstate.ctx.GetCtx(), GEOSBuffer_r(lstate.ctx.GetCtx(), geos_geom.get(), radius, 8));
-		    return lstate.ctx.Serialize(result, boundary);
-	    });
+	auto buffer = [&](geometry_t &geometry_blob, double radius) {
+		geometry_t point_buffer;
+		if (lstate.TryBufferPoint(geometry_blob, radius, 8, result, point_buffer)) {
+			return point_buffer;
+		}
+		auto geos_geom = lstate.ctx.Deserialize(geometry_blob);
+		auto boundary = BufferGEOS(lstate, split_threshold, geos_geom, radius, 8);
+		return lstate.ctx.Serialize(result, boundary);
+	};
+
+	if (right.GetVectorType() == VectorType::CONSTANT_VECTOR && !ConstantVector::IsNull(right)) {
+		// Special case: the radius is constant (very common), so only the distinct geometries need to be buffered
+		auto radius = ConstantVector::GetData<double>(right)[0];
+		GeometryExecutor::ExecuteUnary<geometry_t, geometry_t>(
+		    left, result, args.size(), [&](geometry_t &geometry_blob) { return buffer(geometry_blob, radius); });
+		return;
+	}
+
+	BinaryExecutor::Execute<geometry_t, double, geometry_t>(left, right, result, args.size(), buffer);
 }
 
 static void BufferFunctionWithSegments(DataChunk &args, ExpressionState &state, Vector &result) {
 
-	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	auto &lstate = BufferLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
+	auto split_threshold = GEOSSplitExecutor::GetThreshold(lstate.context);
 	auto &left = args.data[0];
 	auto &right = args.data[1];
 	auto &segments = args.data[2];
 
 	TernaryExecutor::Execute<geometry_t, double, int32_t, geometry_t>(
 	    left, right, segments, result, args.size(), [&](geometry_t &geometry_blob, double radius, int32_t segments) {
+		    geometry_t point_buffer;
+		    if (lstate.TryBufferPoint(geometry_blob, radius, segments, result, point_buffer)) {
+			    return point_buffer;
+		    }
 		    auto geos_geom = lstate.ctx.Deserialize(geometry_blob);
-		    auto boundary = make_uniq_geos(lstate.ctx.GetCtx(),
-		                                   GEOSBuffer_r(lstate.ctx.GetCtx(), geos_geom.get(), radius, segments));
+		    auto boundary = BufferGEOS(lstate, split_threshold, geos_geom, radius, segments);
 		    return lstate.ctx.Serialize(result, boundary);
 	    });
 }
@@ -62,14 +187,13 @@ static T TryParseStringArgument(const char *name, const vector<string> &keys, co
 }
 
 static void BufferFunctionWithArgs(DataChunk &args, ExpressionState &state, Vector &result) {
-	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	auto &lstate = BufferLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
 
 	SenaryExecutor::Execute<geometry_t, double, int32_t, string_t, string_t, double, geometry_t>(
 	    args, result,
 	    [&](const geometry_t &geometry_blob, double radius, int32_t segments, const string_t &cap_style_str,
 	        const string_t &join_style_str, double mitre_limit) {
-		    auto geos_geom = lstate.ctx.Deserialize(geometry_blob);
-
 		    auto cap_style = TryParseStringArgument<GEOSBufCapStyles>(
 		        "cap style", {"CAP_ROUND", "CAP_FLAT", "CAP_SQUARE"},
 		        {GEOSBUF_CAP_ROUND, GEOSBUF_CAP_FLAT, GEOSBUF_CAP_SQUARE}, cap_style_str);
@@ -78,8 +202,16 @@ static void BufferFunctionWithArgs(DataChunk &args, ExpressionState &state, Vect
 		        "join style", {"JOIN_ROUND", "JOIN_MITRE", "JOIN_BEVEL"},
 		        {GEOSBUF_JOIN_ROUND, GEOSBUF_JOIN_MITRE, GEOSBUF_JOIN_BEVEL}, join_style_str);
 
-		    auto buffer = GEOSBufferWithStyle_r(lstate.ctx.GetCtx(), geos_geom.get(), radius, segments, cap_style,
-		                                        join_style, mitre_limit);
+		    // The join style does not matter for points, only round caps make a circle
+		    geometry_t point_buffer;
+		    if (cap_style == GEOSBUF_CAP_ROUND &&
+		        lstate.TryBufferPoint(geometry_blob, radius, segments, result, point_buffer)) {
+			    return point_buffer;
+		    }
+
+		    auto geos_geom = lstate.ctx.Deserialize(geometry_blob);
+		    auto params = lstate.GetParams(segments, cap_style, join_style, mitre_limit);
+		    auto buffer = GEOSBufferWithParams_r(lstate.ctx.GetCtx(), geos_geom.get(), params, radius);
 		    auto buffer_ptr = make_uniq_geos(lstate.ctx.GetCtx(), buffer);
 		    return lstate.ctx.Serialize(result, buffer_ptr);
 	    });
@@ -89,15 +221,15 @@ void GEOSScalarFunctions::RegisterStBuffer(DatabaseInstance &db) {
 	ScalarFunctionSet set("ST_Buffer");
 
 	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), LogicalType::DOUBLE}, GeoTypes::GEOMETRY(), BufferFunction,
-	                               nullptr, nullptr, nullptr, GEOSFunctionLocalState::Init));
+	                               nullptr, nullptr, nullptr, BufferLocalState::Init));
 	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), LogicalType::DOUBLE, LogicalType::INTEGER},
 	                               GeoTypes::GEOMETRY(), BufferFunctionWithSegments, nullptr, nullptr, nullptr,
-	                               GEOSFunctionLocalState::Init));
+	                               BufferLocalState::Init));
 
 	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), LogicalType::DOUBLE, LogicalType::INTEGER,
 	                                LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::DOUBLE},
 	                               GeoTypes::GEOMETRY(), BufferFunctionWithArgs, nullptr, nullptr, nullptr,
-	                               GEOSFunctionLocalState::Init));
+	                               BufferLocalState::Init));
 
 	ExtensionUtil::RegisterFunction(db, set);
 }
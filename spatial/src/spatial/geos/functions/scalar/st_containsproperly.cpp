@@ -25,6 +25,9 @@ static void ExecuteContainsProperlyPrepared(GEOSFunctionLocalState &lstate, Vect
 		auto left_prepared = make_uniq_geos(ctx, GEOSPrepare_r(ctx, left_geom.get()));
 
 		UnaryExecutor::Execute<geometry_t, bool>(right, result, count, [&](geometry_t &right_blob) {
+			if (GEOSExecutor::BoundingBoxesDisjoint(left_blob, right_blob)) {
+				return false;
+			}
 			auto right_geometry = lstate.ctx.Deserialize(right_blob);
 			auto ok = GEOSPreparedContainsProperly_r(ctx, left_prepared.get(), right_geometry.get());
 			return ok == 1;
@@ -33,6 +36,9 @@ static void ExecuteContainsProperlyPrepared(GEOSFunctionLocalState &lstate, Vect
 		// ContainsProperly only has a prepared version, so we just prepare the left one always
 		BinaryExecutor::Execute<geometry_t, geometry_t, bool>(
 		    left, right, result, count, [&](geometry_t &left_blob, geometry_t &right_blob) {
+			    if (GEOSExecutor::BoundingBoxesDisjoint(left_blob, right_blob)) {
+				    return false;
+			    }
 			    auto left_geometry = lstate.ctx.Deserialize(left_blob);
 			    auto right_geometry = lstate.ctx.Deserialize(right_blob);
 
@@ -46,6 +52,7 @@ static void ExecuteContainsProperlyPrepared(GEOSFunctionLocalState &lstate, Vect
 
 static void ContainsProperlyFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
 	auto &left = args.data[0];
 	auto &right = args.data[1];
 	auto count = args.size();
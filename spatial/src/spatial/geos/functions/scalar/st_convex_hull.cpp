@@ -1,5 +1,6 @@
 #include "spatial/common.hpp"
 #include "spatial/core/types.hpp"
+#include "spatial/core/geometry/convex_hull.hpp"
 #include "spatial/geos/functions/scalar.hpp"
 #include "spatial/geos/functions/common.hpp"
 #include "spatial/geos/geos_wrappers.hpp"
@@ -16,8 +17,20 @@ using namespace spatial::core;
 
 static void ConvexHullFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
 	auto &ctx = lstate.ctx.GetCtx();
+	vector<VertexXY> points;
 	UnaryExecutor::Execute<geometry_t, geometry_t>(args.data[0], result, args.size(), [&](geometry_t &geometry_blob) {
+		// The hull of 2D geometries is computed natively, GEOS keeps the Z values and handles empty geometries
+		auto properties = geometry_blob.GetProperties();
+		if (!properties.HasZ() && !properties.HasM()) {
+			points.clear();
+			ConvexHull::AppendVertices(geometry_blob, points);
+			if (!points.empty()) {
+				ConvexHull::Reduce(points);
+				return ConvexHull::Serialize(lstate.factory, result, points);
+			}
+		}
 		auto geometry = lstate.ctx.Deserialize(geometry_blob);
 		auto convex_hull_geometry = make_uniq_geos(ctx, GEOSConvexHull_r(ctx, geometry.get()));
 		return lstate.ctx.Serialize(result, convex_hull_geometry);
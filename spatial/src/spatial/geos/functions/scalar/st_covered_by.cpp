@@ -17,6 +17,7 @@ using namespace spatial::core;
 
 static void CoveredByFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
 	auto &left = args.data[0];
 	auto &right = args.data[1];
 	auto count = args.size();
@@ -3,6 +3,7 @@
 #include "spatial/geos/functions/scalar.hpp"
 #include "spatial/geos/functions/common.hpp"
 #include "spatial/geos/geos_wrappers.hpp"
+#include "spatial/geos/geos_executor.hpp"
 
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
 #include "duckdb/common/vector_operations/unary_executor.hpp"
@@ -14,13 +15,52 @@ namespace geos {
 
 using namespace spatial::core;
 
+// Erase a constant geometry from every row. Rows that are disjoint from it by bounding box are returned as they are,
+// and rows inside a constant polygon become empty, only the rows on its boundary are overlaid.
+static void ExecuteConstantErase(GEOSFunctionLocalState &lstate, const geometry_t &erase_blob, Vector &rows,
+                                 idx_t count, Vector &result) {
+	auto &ctx = lstate.ctx.GetCtx();
+	auto erase_geom = lstate.ctx.Deserialize(erase_blob);
+	GEOSExecutor::LazyPreparedGeometry erase_prepared(lstate, erase_blob);
+	auto erase_is_areal = GEOSExecutor::GetTypeDimension(erase_blob.GetType()) == 2;
+
+	UnaryExecutor::Execute<geometry_t, geometry_t>(rows, result, count, [&](geometry_t &row_blob) {
+		if (GEOSExecutor::BoundingBoxesDisjoint(row_blob, erase_blob)) {
+			return geometry_t(StringVector::AddStringOrBlob(result, string_t(row_blob)));
+		}
+		auto row_geom = lstate.ctx.Deserialize(row_blob);
+		auto row_dimension = GEOSExecutor::GetTypeDimension(row_blob.GetType());
+		if (erase_is_areal && row_dimension >= 0 &&
+		    GEOSPreparedContainsProperly_r(ctx, erase_prepared.Get(), row_geom.get()) == 1) {
+			return lstate.ctx.Serialize(result, GEOSExecutor::CreateEmpty(ctx, row_dimension));
+		}
+		auto geos_result = make_uniq_geos(ctx, GEOSDifference_r(ctx, row_geom.get(), erase_geom.get()));
+		return lstate.ctx.Serialize(result, geos_result);
+	});
+}
+
 static void DifferenceFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
 	auto &ctx = lstate.ctx.GetCtx();
+	auto &left = args.data[0];
+	auto &right = args.data[1];
+	auto count = args.size();
+
+	if (right.GetVectorType() == VectorType::CONSTANT_VECTOR && left.GetVectorType() != VectorType::CONSTANT_VECTOR &&
+	    !ConstantVector::IsNull(right)) {
+		ExecuteConstantErase(lstate, ConstantVector::GetData<geometry_t>(right)[0], left, count, result);
+		return;
+	}
+
 	BinaryExecutor::Execute<geometry_t, geometry_t, geometry_t>(
-	    args.data[0], args.data[1], result, args.size(), [&](geometry_t left, geometry_t right) {
-		    auto left_geos_geom = lstate.ctx.Deserialize(left);
-		    auto right_geos_geom = lstate.ctx.Deserialize(right);
+	    left, right, result, count, [&](geometry_t left_blob, geometry_t right_blob) {
+		    // Nothing to erase if the bounding boxes are disjoint
+		    if (GEOSExecutor::BoundingBoxesDisjoint(left_blob, right_blob)) {
+			    return geometry_t(StringVector::AddStringOrBlob(result, string_t(left_blob)));
+		    }
+		    auto left_geos_geom = lstate.ctx.Deserialize(left_blob);
+		    auto right_geos_geom = lstate.ctx.Deserialize(right_blob);
 		    auto geos_result = make_uniq_geos(ctx, GEOSDifference_r(ctx, left_geos_geom.get(), right_geos_geom.get()));
 		    return lstate.ctx.Serialize(result, geos_result);
 	    });
@@ -17,11 +17,12 @@ using namespace spatial::core;
 
 static void DisjointFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
 	auto &left = args.data[0];
 	auto &right = args.data[1];
 	auto count = args.size();
 	GEOSExecutor::ExecuteSymmetricPreparedBinary(lstate, left, right, count, result, GEOSDisjoint_r,
-	                                             GEOSPreparedDisjoint_r);
+	                                             GEOSPreparedDisjoint_r, true);
 }
 
 void GEOSScalarFunctions::RegisterStDisjoint(DatabaseInstance &db) {
@@ -1,8 +1,10 @@
 #include "spatial/common.hpp"
 #include "spatial/core/types.hpp"
+#include "spatial/core/geometry/point_distance.hpp"
 #include "spatial/geos/functions/scalar.hpp"
 #include "spatial/geos/functions/common.hpp"
 #include "spatial/geos/geos_wrappers.hpp"
+#include "spatial/geos/geos_executor.hpp"
 
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
 #include "duckdb/common/vector_operations/unary_executor.hpp"
@@ -14,40 +16,62 @@ namespace geos {
 
 using namespace spatial::core;
 
+// Pairs of a point and a point, (multi)linestring or (multi)polygon are measured natively on the serialized
+// geometries, GEOS is only used for the rest
 static void ExecutePreparedDistance(GEOSFunctionLocalState &lstate, Vector &left, Vector &right, idx_t count,
                                     Vector &result) {
 	auto &ctx = lstate.ctx.GetCtx();
 
 	// Optimize: if one of the arguments is a constant, we can prepare it once and reuse it
-	if (left.GetVectorType() == VectorType::CONSTANT_VECTOR && right.GetVectorType() != VectorType::CONSTANT_VECTOR) {
-		auto &left_blob = FlatVector::GetData<geometry_t>(left)[0];
-		auto left_geom = lstate.ctx.Deserialize(left_blob);
-		auto left_prepared = make_uniq_geos(ctx, GEOSPrepare_r(ctx, left_geom.get()));
+	if (left.GetVectorType() == VectorType::CONSTANT_VECTOR && right.GetVectorType() != VectorType::CONSTANT_VECTOR &&
+	    !ConstantVector::IsNull(left)) {
+		auto &left_blob = ConstantVector::GetData<geometry_t>(left)[0];
+		GEOSExecutor::LazyPreparedGeometry left_prepared(lstate, left_blob);
 
 		UnaryExecutor::Execute<geometry_t, double>(right, result, count, [&](geometry_t &right_blob) {
-			auto right_geometry = lstate.ctx.Deserialize(right_blob);
 			double distance;
-			GEOSPreparedDistance_r(ctx, left_prepared.get(), right_geometry.get(), &distance);
+			if (PointDistance::TryCompute(left_blob, right_blob, distance)) {
+				return distance;
+			}
+			auto right_geometry = lstate.ctx.Deserialize(right_blob);
+			GEOSPreparedDistance_r(ctx, left_prepared.Get(), right_geometry.get(), &distance);
 			return distance;
 		});
 	} else if (right.GetVectorType() == VectorType::CONSTANT_VECTOR &&
-	           left.GetVectorType() != VectorType::CONSTANT_VECTOR) {
-		auto &right_blob = FlatVector::GetData<geometry_t>(right)[0];
-		auto right_geom = lstate.ctx.Deserialize(right_blob);
-		auto right_prepared = make_uniq_geos(ctx, GEOSPrepare_r(ctx, right_geom.get()));
+	           left.GetVectorType() != VectorType::CONSTANT_VECTOR && !ConstantVector::IsNull(right)) {
+		auto &right_blob = ConstantVector::GetData<geometry_t>(right)[0];
+		GEOSExecutor::LazyPreparedGeometry right_prepared(lstate, right_blob);
 
 		UnaryExecutor::Execute<geometry_t, double>(left, result, count, [&](geometry_t &left_blob) {
-			auto left_geometry = lstate.ctx.Deserialize(left_blob);
 			double distance;
-			GEOSPreparedDistance_r(ctx, right_prepared.get(), left_geometry.get(), &distance);
+			if (PointDistance::TryCompute(left_blob, right_blob, distance)) {
+				return distance;
+			}
+			auto left_geometry = lstate.ctx.Deserialize(left_blob);
+			GEOSPreparedDistance_r(ctx, right_prepared.Get(), left_geometry.get(), &distance);
 			return distance;
 		});
 	} else {
+		// Distance is symmetric, so prepare the larger side through the per-thread cache if it keeps repeating
+		auto &cache = lstate.GetPreparedCache();
 		BinaryExecutor::Execute<geometry_t, geometry_t, double>(
 		    left, right, result, count, [&](geometry_t &left_blob, geometry_t &right_blob) {
+			    double distance;
+			    if (PointDistance::TryCompute(left_blob, right_blob, distance)) {
+				    return distance;
+			    }
+			    auto left_is_larger = string_t(left_blob).GetSize() >= string_t(right_blob).GetSize();
+			    auto &prepare_blob = left_is_larger ? left_blob : right_blob;
+			    auto &other_blob = left_is_larger ? right_blob : left_blob;
+			    auto prepared_geom = cache.Get(prepare_blob);
+			    if (prepared_geom) {
+				    lstate.factory.counters.prepared_cache_hits++;
+				    auto other_geometry = lstate.ctx.Deserialize(other_blob);
+				    GEOSPreparedDistance_r(ctx, prepared_geom, other_geometry.get(), &distance);
+				    return distance;
+			    }
 			    auto left_geometry = lstate.ctx.Deserialize(left_blob);
 			    auto right_geometry = lstate.ctx.Deserialize(right_blob);
-			    double distance;
 			    GEOSDistance_r(ctx, left_geometry.get(), right_geometry.get(), &distance);
 			    return distance;
 		    });
@@ -56,6 +80,7 @@ static void ExecutePreparedDistance(GEOSFunctionLocalState &lstate, Vector &left
 
 static void DistanceFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
 	auto &left = args.data[0];
 	auto &right = args.data[1];
 	auto count = args.size();
@@ -1,12 +1,15 @@
 #include "spatial/common.hpp"
 #include "spatial/core/types.hpp"
+#include "spatial/core/geometry/point_distance.hpp"
 #include "spatial/geos/functions/scalar.hpp"
 #include "spatial/geos/functions/common.hpp"
 #include "spatial/geos/geos_wrappers.hpp"
+#include "spatial/geos/geos_executor.hpp"
 
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
 #include "duckdb/common/vector_operations/unary_executor.hpp"
 #include "duckdb/common/vector_operations/binary_executor.hpp"
+#include "duckdb/common/vector_operations/ternary_executor.hpp"
 
 namespace spatial {
 
@@ -14,40 +17,81 @@ namespace geos {
 
 using namespace core;
 
+// Pairs whose bounding boxes are further apart than the distance are rejected from the serialized headers, and pairs
+// of a point and a point, (multi)linestring or (multi)polygon are measured natively. GEOS is only used for the rest.
 static void ExecutePreparedDistanceWithin(GEOSFunctionLocalState &lstate, Vector &left, Vector &right,
                                           Vector &distance_vec, idx_t count, Vector &result) {
 	auto &ctx = lstate.ctx.GetCtx();
+	auto &counters = lstate.factory.counters;
 
 	// Optimize: if one of the arguments is a constant, we can prepare it once and reuse it
-	if (left.GetVectorType() == VectorType::CONSTANT_VECTOR && right.GetVectorType() != VectorType::CONSTANT_VECTOR) {
-		auto &left_blob = FlatVector::GetData<geometry_t>(left)[0];
-		auto left_geom = lstate.ctx.Deserialize(left_blob);
-		auto left_prepared = make_uniq_geos(ctx, GEOSPrepare_r(ctx, left_geom.get()));
+	if (left.GetVectorType() == VectorType::CONSTANT_VECTOR && right.GetVectorType() != VectorType::CONSTANT_VECTOR &&
+	    !ConstantVector::IsNull(left)) {
+		auto &left_blob = ConstantVector::GetData<geometry_t>(left)[0];
+		GEOSExecutor::LazyPreparedGeometry left_prepared(lstate, left_blob);
 
 		BinaryExecutor::Execute<geometry_t, double, bool>(
 		    right, distance_vec, result, count, [&](geometry_t &right_blob, double distance) {
+			    if (GEOSExecutor::BoundingBoxesFartherThan(left_blob, right_blob, distance)) {
+				    counters.bbox_rejects++;
+				    return false;
+			    }
+			    double native_distance;
+			    if (PointDistance::TryCompute(left_blob, right_blob, native_distance)) {
+				    return native_distance <= distance;
+			    }
 			    auto right_geometry = lstate.ctx.Deserialize(right_blob);
-			    auto ok = GEOSPreparedDistanceWithin_r(ctx, left_prepared.get(), right_geometry.get(), distance);
+			    counters.geos_predicate_calls++;
+			    auto ok = GEOSPreparedDistanceWithin_r(ctx, left_prepared.Get(), right_geometry.get(), distance);
 			    return ok == 1;
 		    });
 	} else if (right.GetVectorType() == VectorType::CONSTANT_VECTOR &&
-	           left.GetVectorType() != VectorType::CONSTANT_VECTOR) {
-		auto &right_blob = FlatVector::GetData<geometry_t>(right)[0];
-		auto right_geom = lstate.ctx.Deserialize(right_blob);
-		auto right_prepared = make_uniq_geos(ctx, GEOSPrepare_r(ctx, right_geom.get()));
+	           left.GetVectorType() != VectorType::CONSTANT_VECTOR && !ConstantVector::IsNull(right)) {
+		auto &right_blob = ConstantVector::GetData<geometry_t>(right)[0];
+		GEOSExecutor::LazyPreparedGeometry right_prepared(lstate, right_blob);
 
 		BinaryExecutor::Execute<geometry_t, double, bool>(
 		    left, distance_vec, result, count, [&](geometry_t &left_blob, double distance) {
+			    if (GEOSExecutor::BoundingBoxesFartherThan(left_blob, right_blob, distance)) {
+				    counters.bbox_rejects++;
+				    return false;
+			    }
+			    double native_distance;
+			    if (PointDistance::TryCompute(left_blob, right_blob, native_distance)) {
+				    return native_distance <= distance;
+			    }
 			    auto left_geometry = lstate.ctx.Deserialize(left_blob);
-			    auto ok = GEOSPreparedDistanceWithin_r(ctx, right_prepared.get(), left_geometry.get(), distance);
+			    counters.geos_predicate_calls++;
+			    auto ok = GEOSPreparedDistanceWithin_r(ctx, right_prepared.Get(), left_geometry.get(), distance);
 			    return ok == 1;
 		    });
 	} else {
+		// Prepare the larger side through the per-thread cache if it keeps repeating
+		auto &cache = lstate.GetPreparedCache();
 		TernaryExecutor::Execute<geometry_t, geometry_t, double, bool>(
 		    left, right, distance_vec, result, count,
 		    [&](geometry_t &left_blob, geometry_t &right_blob, double distance) {
+			    if (GEOSExecutor::BoundingBoxesFartherThan(left_blob, right_blob, distance)) {
+				    counters.bbox_rejects++;
+				    return false;
+			    }
+			    double native_distance;
+			    if (PointDistance::TryCompute(left_blob, right_blob, native_distance)) {
+				    return native_distance <= distance;
+			    }
+			    auto left_is_larger = string_t(left_blob).GetSize() >= string_t(right_blob).GetSize();
+			    auto &prepare_blob = left_is_larger ? left_blob : right_blob;
+			    auto &other_blob = left_is_larger ? right_blob : left_blob;
+			    auto prepared_geom = cache.Get(prepare_blob);
+			    if (prepared_geom) {
+				    counters.prepared_cache_hits++;
+				    auto other_geometry = lstate.ctx.Deserialize(other_blob);
+				    counters.geos_predicate_calls++;
+				    return GEOSPreparedDistanceWithin_r(ctx, prepared_geom, other_geometry.get(), distance) == 1;
+			    }
 			    auto left_geometry = lstate.ctx.Deserialize(left_blob);
 			    auto right_geometry = lstate.ctx.Deserialize(right_blob);
+			    counters.geos_predicate_calls++;
 			    auto ok = GEOSDistanceWithin_r(ctx, left_geometry.get(), right_geometry.get(), distance);
 			    return ok == 1;
 		    });
@@ -56,6 +100,7 @@ static void ExecutePreparedDistanceWithin(GEOSFunctionLocalState &lstate, Vector
 
 static void DistanceWithinFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
 	auto &left = args.data[0];
 	auto &right = args.data[1];
 	auto &distance_vec = args.data[2];
@@ -16,6 +16,7 @@ using namespace spatial::core;
 
 static void EnvelopeFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
 	auto &ctx = lstate.ctx.GetCtx();
 	UnaryExecutor::ExecuteWithNulls<geometry_t, geometry_t>(
 	    args.data[0], result, args.size(), [&](geometry_t &geometry_blob, ValidityMask &mask, idx_t i) {
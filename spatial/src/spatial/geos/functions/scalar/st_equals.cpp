@@ -3,6 +3,7 @@
 #include "spatial/geos/functions/scalar.hpp"
 #include "spatial/geos/functions/common.hpp"
 #include "spatial/geos/geos_wrappers.hpp"
+#include "spatial/geos/geos_executor.hpp"
 
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
 #include "duckdb/common/vector_operations/unary_executor.hpp"
@@ -14,15 +15,44 @@ namespace geos {
 
 using namespace spatial::core;
 
+// The bounding box in the header, rounded outwards to single precision the way it is stored unless the geometry is a
+// point or has a double precision box. Equal geometries have the same box however their headers were written.
+static bool TryGetFloatBoundingBox(const geometry_t &blob, BoundingBox &bbox) {
+	if (!GeometryFactory::TryGetSerializedBoundingBox(blob, bbox)) {
+		return false;
+	}
+	bbox.minx = Utils::DoubleToFloatDown(bbox.minx);
+	bbox.miny = Utils::DoubleToFloatDown(bbox.miny);
+	bbox.maxx = Utils::DoubleToFloatUp(bbox.maxx);
+	bbox.maxy = Utils::DoubleToFloatUp(bbox.maxy);
+	return true;
+}
+
 static void EqualsFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
 	auto &ctx = lstate.ctx.GetCtx();
-	BinaryExecutor::Execute<geometry_t, geometry_t, bool>(args.data[0], args.data[1], result, args.size(),
-	                                                      [&](geometry_t &left_blob, geometry_t &right_blob) {
-		                                                      auto left = lstate.ctx.Deserialize(left_blob);
-		                                                      auto right = lstate.ctx.Deserialize(right_blob);
-		                                                      return GEOSEquals_r(ctx, left.get(), right.get());
-	                                                      });
+	auto &counters = lstate.factory.counters;
+	BinaryExecutor::Execute<geometry_t, geometry_t, bool>(
+	    args.data[0], args.data[1], result, args.size(), [&](geometry_t &left_blob, geometry_t &right_blob) {
+		    // Geometries with the same vertices in the same structure are equal, e.g. when deduplicating
+		    if (GeometryFactory::SerializedEquals(left_blob, right_blob)) {
+			    return true;
+		    }
+		    // Geometries that cover the same points have the same bounding box
+		    BoundingBox left_bbox;
+		    BoundingBox right_bbox;
+		    if (TryGetFloatBoundingBox(left_blob, left_bbox) && TryGetFloatBoundingBox(right_blob, right_bbox) &&
+		        (left_bbox.minx != right_bbox.minx || left_bbox.miny != right_bbox.miny ||
+		         left_bbox.maxx != right_bbox.maxx || left_bbox.maxy != right_bbox.maxy)) {
+			    counters.bbox_rejects++;
+			    return false;
+		    }
+		    auto left = lstate.ctx.Deserialize(left_blob);
+		    auto right = lstate.ctx.Deserialize(right_blob);
+		    counters.geos_predicate_calls++;
+		    return GEOSEquals_r(ctx, left.get(), right.get()) == 1;
+	    });
 }
 
 void GEOSScalarFunctions::RegisterStEquals(DatabaseInstance &db) {
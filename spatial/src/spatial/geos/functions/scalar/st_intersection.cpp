@@ -3,6 +3,7 @@
 #include "spatial/geos/functions/scalar.hpp"
 #include "spatial/geos/functions/common.hpp"
 #include "spatial/geos/geos_wrappers.hpp"
+#include "spatial/geos/geos_executor.hpp"
 
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
 #include "duckdb/common/vector_operations/unary_executor.hpp"
@@ -14,13 +15,104 @@ namespace geos {
 
 using namespace spatial::core;
 
+// Whether a geometry is a polygon without holes whose ring runs along the sides of its (exact) extent
+static bool IsRectangle(GEOSContextHandle_t ctx, const GEOSGeometry *geom, const BoundingBox &extent) {
+	if (GEOSGeomTypeId_r(ctx, geom) != GEOS_POLYGON || GEOSGetNumInteriorRings_r(ctx, geom) != 0 ||
+	    GEOSGetNumCoordinates_r(ctx, geom) != 5) {
+		return false;
+	}
+	auto seq = GEOSGeom_getCoordSeq_r(ctx, GEOSGetExteriorRing_r(ctx, geom));
+	double x[5];
+	double y[5];
+	for (unsigned int i = 0; i < 5; i++) {
+		GEOSCoordSeq_getXY_r(ctx, seq, i, &x[i], &y[i]);
+		if ((x[i] != extent.minx && x[i] != extent.maxx) || (y[i] != extent.miny && y[i] != extent.maxy)) {
+			return false;
+		}
+	}
+	for (unsigned int i = 1; i < 5; i++) {
+		// Every side is axis aligned, which rules out rings that cross themselves
+		if ((x[i] != x[i - 1]) == (y[i] != y[i - 1])) {
+			return false;
+		}
+	}
+	return extent.maxx > extent.minx && extent.maxy > extent.miny;
+}
+
+// Intersect every row with a constant clip geometry. Rows that are disjoint from the clip by bounding box get an
+// empty result and rows inside it are returned as they are, only the rows on the boundary of the clip are overlaid.
+static void ExecuteConstantIntersection(GEOSFunctionLocalState &lstate, const geometry_t &clip_blob, Vector &rows,
+                                        bool clip_is_left, idx_t count, Vector &result) {
+	auto &ctx = lstate.ctx.GetCtx();
+	auto clip_geom = lstate.ctx.Deserialize(clip_blob);
+	GEOSExecutor::LazyPreparedGeometry clip_prepared(lstate, clip_blob);
+
+	BoundingBox clip_extent;
+	auto has_extent = GEOSGeom_getXMin_r(ctx, clip_geom.get(), &clip_extent.minx) &&
+	                  GEOSGeom_getYMin_r(ctx, clip_geom.get(), &clip_extent.miny) &&
+	                  GEOSGeom_getXMax_r(ctx, clip_geom.get(), &clip_extent.maxx) &&
+	                  GEOSGeom_getYMax_r(ctx, clip_geom.get(), &clip_extent.maxy);
+	auto clip_dimension = GEOSGeom_getDimensions_r(ctx, clip_geom.get());
+	auto clip_is_rectangle = has_extent && IsRectangle(ctx, clip_geom.get(), clip_extent);
+	auto clip_is_areal = GEOSExecutor::GetTypeDimension(clip_blob.GetType()) == 2;
+
+	UnaryExecutor::Execute<geometry_t, geometry_t>(rows, result, count, [&](geometry_t &row_blob) {
+		auto row_dimension = GEOSExecutor::GetTypeDimension(row_blob.GetType());
+		BoundingBox row_bbox;
+		if (has_extent && row_dimension >= 0 && GeometryFactory::TryGetSerializedBoundingBox(row_blob, row_bbox)) {
+			// The serialized bounding box is rounded outwards, so these checks are conservative
+			if (!row_bbox.Intersects(clip_extent)) {
+				// Like GEOS, the empty result has the lowest dimension of the two
+				auto dimension = MinValue(row_dimension, clip_dimension);
+				return lstate.ctx.Serialize(result, GEOSExecutor::CreateEmpty(ctx, dimension));
+			}
+			if (clip_is_rectangle && row_bbox.minx > clip_extent.minx && row_bbox.maxx < clip_extent.maxx &&
+			    row_bbox.miny > clip_extent.miny && row_bbox.maxy < clip_extent.maxy) {
+				return geometry_t(StringVector::AddStringOrBlob(result, string_t(row_blob)));
+			}
+		}
+
+		auto row_geom = lstate.ctx.Deserialize(row_blob);
+		if (clip_is_areal && GEOSPreparedContainsProperly_r(ctx, clip_prepared.Get(), row_geom.get()) == 1) {
+			return geometry_t(StringVector::AddStringOrBlob(result, string_t(row_blob)));
+		}
+		if (clip_is_rectangle && row_dimension >= 0 && row_dimension < 2) {
+			// Clipping points and lines by a rectangle is exact, polygons still go through the full overlay since
+			// the output of GEOSClipByRect is not guaranteed to be valid for them
+			auto clipped = make_uniq_geos(ctx, GEOSClipByRect_r(ctx, row_geom.get(), clip_extent.minx,
+			                                                    clip_extent.miny, clip_extent.maxx, clip_extent.maxy));
+			return lstate.ctx.Serialize(result, clipped);
+		}
+		// Keep the argument order, the overlay is symmetric but the vertex order of the output may not be
+		auto result_geom = clip_is_left ? GEOSIntersection_r(ctx, clip_geom.get(), row_geom.get())
+		                                : GEOSIntersection_r(ctx, row_geom.get(), clip_geom.get());
+		return lstate.ctx.Serialize(result, make_uniq_geos(ctx, result_geom));
+	});
+}
+
 static void IntersectionFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
 	auto &ctx = lstate.ctx.GetCtx();
+	auto &left = args.data[0];
+	auto &right = args.data[1];
+	auto count = args.size();
+
+	if (left.GetVectorType() == VectorType::CONSTANT_VECTOR && right.GetVectorType() != VectorType::CONSTANT_VECTOR &&
+	    !ConstantVector::IsNull(left)) {
+		ExecuteConstantIntersection(lstate, ConstantVector::GetData<geometry_t>(left)[0], right, true, count, result);
+		return;
+	}
+	if (right.GetVectorType() == VectorType::CONSTANT_VECTOR && left.GetVectorType() != VectorType::CONSTANT_VECTOR &&
+	    !ConstantVector::IsNull(right)) {
+		ExecuteConstantIntersection(lstate, ConstantVector::GetData<geometry_t>(right)[0], left, false, count, result);
+		return;
+	}
+
 	BinaryExecutor::Execute<geometry_t, geometry_t, geometry_t>(
-	    args.data[0], args.data[1], result, args.size(), [&](geometry_t left, geometry_t right) {
-		    auto left_geom = lstate.ctx.Deserialize(left);
-		    auto right_geom = lstate.ctx.Deserialize(right);
+	    left, right, result, count, [&](geometry_t left_blob, geometry_t right_blob) {
+		    auto left_geom = lstate.ctx.Deserialize(left_blob);
+		    auto right_geom = lstate.ctx.Deserialize(right_blob);
 
 		    auto result_geom = make_uniq_geos(ctx, GEOSIntersection_r(ctx, left_geom.get(), right_geom.get()));
 		    return lstate.ctx.Serialize(result, result_geom);
@@ -4,6 +4,7 @@
 #include "spatial/geos/functions/common.hpp"
 #include "spatial/geos/geos_wrappers.hpp"
 #include "spatial/geos/geos_executor.hpp"
+#include "spatial/core/geometry/line_intersection.hpp"
 
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
 #include "duckdb/common/vector_operations/unary_executor.hpp"
@@ -17,11 +18,17 @@ using namespace spatial::core;
 
 static void IntersectsFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
 	auto &left = args.data[0];
 	auto &right = args.data[1];
 	auto count = args.size();
+	PointInPolygonMask pip_mask;
+	pip_mask.polygon_left =
+	    static_cast<uint8_t>(PointLocation::INTERIOR) | static_cast<uint8_t>(PointLocation::BOUNDARY);
+	pip_mask.polygon_right = pip_mask.polygon_left;
 	GEOSExecutor::ExecuteSymmetricPreparedBinary(lstate, left, right, count, result, GEOSIntersects_r,
-	                                             GEOSPreparedIntersects_r);
+	                                             GEOSPreparedIntersects_r, false, pip_mask,
+	                                             LineIntersection::TryIntersects);
 }
 
 void GEOSScalarFunctions::RegisterStIntersects(DatabaseInstance &db) {
@@ -1,5 +1,6 @@
 #include "spatial/common.hpp"
 #include "spatial/core/types.hpp"
+#include "spatial/core/geometry/validity.hpp"
 #include "spatial/geos/functions/scalar.hpp"
 #include "spatial/geos/functions/common.hpp"
 #include "spatial/geos/geos_wrappers.hpp"
@@ -63,7 +64,14 @@ static bool IsValidForGeos(Geometry &geometry) {
 
 static void IsValidFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
 	UnaryExecutor::Execute<geometry_t, bool>(args.data[0], result, args.size(), [&](geometry_t input) {
+		// Geometries returned by ST_MakeValid and geometries without polygons are checked without GEOS
+		bool is_valid;
+		if (GeometryValidity::TryCheck(input, is_valid)) {
+			return is_valid;
+		}
+
 		auto geom = lstate.factory.Deserialize(input);
 
 		// double check before calling into geos
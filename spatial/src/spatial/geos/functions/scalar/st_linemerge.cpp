@@ -16,6 +16,7 @@ using namespace spatial::core;
 
 static void LineMergeFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
 	auto &ctx = lstate.ctx.GetCtx();
 	UnaryExecutor::Execute<geometry_t, geometry_t>(args.data[0], result, args.size(), [&](geometry_t &geometry_blob) {
 		auto geometry = lstate.ctx.Deserialize(geometry_blob);
@@ -26,6 +27,7 @@ static void LineMergeFunction(DataChunk &args, ExpressionState &state, Vector &r
 
 static void LineMergeFunctionWithDirected(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
 	auto &ctx = lstate.ctx.GetCtx();
 	BinaryExecutor::Execute<geometry_t, bool, geometry_t>(
 	    args.data[0], args.data[1], result, args.size(), [&](geometry_t &geometry_blob, bool directed) {
@@ -1,5 +1,6 @@
 #include "spatial/common.hpp"
 #include "spatial/core/types.hpp"
+#include "spatial/core/geometry/validity.hpp"
 #include "spatial/geos/functions/scalar.hpp"
 #include "spatial/geos/functions/common.hpp"
 #include "spatial/geos/geos_wrappers.hpp"
@@ -16,11 +17,21 @@ using namespace spatial::core;
 
 static void MakeValidFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
 	auto &ctx = lstate.ctx.GetCtx();
 	UnaryExecutor::Execute<geometry_t, geometry_t>(args.data[0], result, args.size(), [&](geometry_t input) {
+		// Most geometries are valid already, so only rebuild the ones that are not. Either way the result is marked
+		// as valid, so that checking it again is free.
+		bool is_valid;
+		if (GeometryValidity::TryCheck(input, is_valid) && is_valid) {
+			return GeometryFactory::SerializedSetValid(result, input);
+		}
 		auto geom = lstate.ctx.Deserialize(input);
+		if (GEOSisValid_r(ctx, geom.get()) == 1) {
+			return GeometryFactory::SerializedSetValid(result, input);
+		}
 		auto valid = make_uniq_geos(ctx, GEOSMakeValid_r(ctx, geom.get()));
-		return lstate.ctx.Serialize(result, valid);
+		return GeometryFactory::SerializedSetValid(result, lstate.ctx.Serialize(result, valid));
 	});
 }
 
@@ -2,6 +2,7 @@
 #include "spatial/core/types.hpp"
 #include "spatial/geos/functions/scalar.hpp"
 #include "spatial/geos/functions/common.hpp"
+#include "spatial/core/geometry/centroid.hpp"
 
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
 #include "duckdb/common/vector_operations/unary_executor.hpp"
@@ -15,8 +16,19 @@ using namespace spatial::core;
 
 static void PointOnSurfaceFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
 	auto ctx = lstate.ctx.GetCtx();
 	UnaryExecutor::Execute<geometry_t, geometry_t>(args.data[0], result, args.size(), [&](geometry_t &geometry_blob) {
+		// The interior point of polygons is found without GEOS, only that of lines and points is left to it
+		VertexXY point;
+		bool is_empty;
+		if (Centroid::TryGetInteriorPoint(geometry_blob, point, is_empty)) {
+			if (is_empty) {
+				Point empty(false, false);
+				return lstate.factory.Serialize(result, empty, false, false);
+			}
+			return GeometryFactory::SerializePoint2D(result, point.x, point.y);
+		}
 		auto geometry = lstate.ctx.Deserialize(geometry_blob);
 		auto result_geom = make_uniq_geos(ctx, GEOSPointOnSurface_r(ctx, geometry.get()));
 		return lstate.ctx.Serialize(result, result_geom);
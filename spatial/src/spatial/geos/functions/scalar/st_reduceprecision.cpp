@@ -15,6 +15,7 @@ using namespace spatial::core;
 
 static void ReducePrecisionFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
 	auto ctx = lstate.ctx.GetCtx();
 	BinaryExecutor::Execute<geometry_t, double, geometry_t>(
 	    args.data[0], args.data[1], result, args.size(), [&](geometry_t &geometry_blob, double precision) {
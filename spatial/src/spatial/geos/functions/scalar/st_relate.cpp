@@ -0,0 +1,368 @@
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/geos/functions/scalar.hpp"
+#include "spatial/geos/functions/common.hpp"
+#include "spatial/geos/geos_wrappers.hpp"
+#include "spatial/geos/geos_executor.hpp"
+
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include "duckdb/common/vector_operations/binary_executor.hpp"
+#include "duckdb/common/vector_operations/ternary_executor.hpp"
+
+namespace spatial {
+
+namespace geos {
+
+using namespace spatial::core;
+
+//------------------------------------------------------------------------------
+// DE-9IM
+//------------------------------------------------------------------------------
+// An intersection matrix is 9 characters, the dimension (F, 0, 1 or 2) of the intersection of the interior, boundary
+// and exterior of the first geometry (rows) with those of the second (columns). A pattern has a T (any dimension),
+// F, *, 0, 1 or 2 in each position.
+
+static bool IsValidPattern(const string_t &pattern) {
+	if (pattern.GetSize() != 9) {
+		return false;
+	}
+	auto data = pattern.GetData();
+	for (idx_t i = 0; i < 9; i++) {
+		switch (data[i]) {
+		case 'T':
+		case 't':
+		case 'F':
+		case 'f':
+		case '*':
+		case '0':
+		case '1':
+		case '2':
+			break;
+		default:
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool MatchesPattern(const char *matrix, const char *pattern) {
+	for (idx_t i = 0; i < 9; i++) {
+		auto entry = matrix[i] == 'f' ? 'F' : matrix[i];
+		switch (pattern[i]) {
+		case '*':
+			break;
+		case 'T':
+		case 't':
+			if (entry == 'F') {
+				return false;
+			}
+			break;
+		case 'F':
+		case 'f':
+			if (entry != 'F') {
+				return false;
+			}
+			break;
+		default:
+			if (entry != pattern[i]) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static bool MatchesAnyPattern(const char *matrix, std::initializer_list<const char *> patterns) {
+	for (auto pattern : patterns) {
+		if (MatchesPattern(matrix, pattern)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// The dimension of a geometry is the dimension of its interior, which is covered by the interior, boundary and
+// exterior of the other geometry. -1 if it is empty.
+static int32_t RowDimension(const char *matrix, idx_t row) {
+	int32_t result = -1;
+	for (idx_t col = 0; col < 3; col++) {
+		auto entry = matrix[row * 3 + col];
+		if (entry >= '0' && entry <= '2') {
+			result = MaxValue<int32_t>(result, entry - '0');
+		}
+	}
+	return result;
+}
+
+static int32_t ColumnDimension(const char *matrix, idx_t col) {
+	int32_t result = -1;
+	for (idx_t row = 0; row < 3; row++) {
+		auto entry = matrix[row * 3 + col];
+		if (entry >= '0' && entry <= '2') {
+			result = MaxValue<int32_t>(result, entry - '0');
+		}
+	}
+	return result;
+}
+
+//------------------------------------------------------------------------------
+// Named predicates
+//------------------------------------------------------------------------------
+// The predicates that the "__internal_st_relate_predicates" function evaluates from a single intersection matrix.
+// Queries that test several of them on the same pair of geometries are rewritten to it by the optimizer, see
+// "Spatial Predicate Fusion" in optimizer_rules.cpp.
+
+enum class RelatePredicate : uint8_t {
+	EQUALS,
+	INTERSECTS,
+	DISJOINT,
+	TOUCHES,
+	CROSSES,
+	WITHIN,
+	CONTAINS,
+	OVERLAPS,
+	COVERS,
+	COVEREDBY,
+	CONTAINSPROPERLY
+};
+
+struct RelatePredicateInfo {
+	const char *name;
+	RelatePredicate predicate;
+	GEOSBinaryPredicate function;
+};
+
+static char ContainsProperly(GEOSContextHandle_t ctx, const GEOSGeometry *left, const GEOSGeometry *right) {
+	return GEOSRelatePattern_r(ctx, left, right, "T**FF*FF*");
+}
+
+static const RelatePredicateInfo RELATE_PREDICATES[] = {
+    {"st_equals", RelatePredicate::EQUALS, GEOSEquals_r},
+    {"st_intersects", RelatePredicate::INTERSECTS, GEOSIntersects_r},
+    {"st_disjoint", RelatePredicate::DISJOINT, GEOSDisjoint_r},
+    {"st_touches", RelatePredicate::TOUCHES, GEOSTouches_r},
+    {"st_crosses", RelatePredicate::CROSSES, GEOSCrosses_r},
+    {"st_within", RelatePredicate::WITHIN, GEOSWithin_r},
+    {"st_contains", RelatePredicate::CONTAINS, GEOSContains_r},
+    {"st_overlaps", RelatePredicate::OVERLAPS, GEOSOverlaps_r},
+    {"st_covers", RelatePredicate::COVERS, GEOSCovers_r},
+    {"st_coveredby", RelatePredicate::COVEREDBY, GEOSCoveredBy_r},
+    {"st_containsproperly", RelatePredicate::CONTAINSPROPERLY, ContainsProperly}};
+
+static bool EvaluatePredicate(RelatePredicate predicate, const char *matrix) {
+	switch (predicate) {
+	case RelatePredicate::EQUALS:
+		return MatchesPattern(matrix, "T*F**FFF*");
+	case RelatePredicate::INTERSECTS:
+		return !MatchesPattern(matrix, "FF*FF****");
+	case RelatePredicate::DISJOINT:
+		return MatchesPattern(matrix, "FF*FF****");
+	case RelatePredicate::TOUCHES:
+		return MatchesAnyPattern(matrix, {"FT*******", "F**T*****", "F***T****"});
+	case RelatePredicate::WITHIN:
+		return MatchesPattern(matrix, "T*F**F***");
+	case RelatePredicate::CONTAINS:
+		return MatchesPattern(matrix, "T*****FF*");
+	case RelatePredicate::COVERS:
+		return MatchesAnyPattern(matrix, {"T*****FF*", "*T****FF*", "***T**FF*", "****T*FF*"});
+	case RelatePredicate::COVEREDBY:
+		return MatchesAnyPattern(matrix, {"T*F**F***", "*TF**F***", "**FT*F***", "**F*TF***"});
+	case RelatePredicate::CONTAINSPROPERLY:
+		return MatchesPattern(matrix, "T**FF*FF*");
+	case RelatePredicate::CROSSES: {
+		auto left_dim = RowDimension(matrix, 0);
+		auto right_dim = ColumnDimension(matrix, 0);
+		if (left_dim < right_dim) {
+			return MatchesPattern(matrix, "T*T******");
+		}
+		if (left_dim > right_dim) {
+			return MatchesPattern(matrix, "T*****T**");
+		}
+		return left_dim == 1 && MatchesPattern(matrix, "0********");
+	}
+	case RelatePredicate::OVERLAPS: {
+		auto left_dim = RowDimension(matrix, 0);
+		auto right_dim = ColumnDimension(matrix, 0);
+		if (left_dim != right_dim) {
+			return false;
+		}
+		if (left_dim == 1) {
+			return MatchesPattern(matrix, "1*T***T**");
+		}
+		return (left_dim == 0 || left_dim == 2) && MatchesPattern(matrix, "T*T***T**");
+	}
+	default:
+		throw InternalException("Unknown relate predicate");
+	}
+}
+
+struct RelatePredicateTerm {
+	const RelatePredicateInfo *info;
+	bool negated;
+};
+
+// Parse a comma separated list of predicate names, each optionally negated with a leading '!'
+static vector<RelatePredicateTerm> ParseRelatePredicates(const string &spec) {
+	vector<RelatePredicateTerm> result;
+	for (auto &entry : StringUtil::Split(spec, ',')) {
+		auto negated = !entry.empty() && entry[0] == '!';
+		auto name = negated ? entry.substr(1) : entry;
+		const RelatePredicateInfo *info = nullptr;
+		for (auto &candidate : RELATE_PREDICATES) {
+			if (StringUtil::CIEquals(candidate.name, name)) {
+				info = &candidate;
+			}
+		}
+		if (!info) {
+			throw InvalidInputException("Unknown relate predicate: '%s'", name);
+		}
+		result.push_back({info, negated});
+	}
+	return result;
+}
+
+//------------------------------------------------------------------------------
+// ST_Relate
+//------------------------------------------------------------------------------
+static void RelateFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
+	auto &ctx = lstate.ctx.GetCtx();
+	BinaryExecutor::Execute<geometry_t, geometry_t, string_t>(
+	    args.data[0], args.data[1], result, args.size(), [&](geometry_t &left_blob, geometry_t &right_blob) {
+		    auto left = lstate.ctx.Deserialize(left_blob);
+		    auto right = lstate.ctx.Deserialize(right_blob);
+		    auto matrix = GEOSRelate_r(ctx, left.get(), right.get());
+		    if (!matrix) {
+			    throw InvalidInputException("ST_Relate: could not compute the intersection matrix");
+		    }
+		    auto matrix_str = StringVector::AddString(result, matrix);
+		    GEOSFree_r(ctx, matrix);
+		    return matrix_str;
+	    });
+}
+
+static void RelatePatternFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
+	auto &ctx = lstate.ctx.GetCtx();
+	TernaryExecutor::Execute<geometry_t, geometry_t, string_t, bool>(
+	    args.data[0], args.data[1], args.data[2], result, args.size(),
+	    [&](geometry_t &left_blob, geometry_t &right_blob, string_t &pattern) {
+		    if (!IsValidPattern(pattern)) {
+			    throw InvalidInputException("ST_Relate: invalid intersection matrix pattern '%s'", pattern.GetString());
+		    }
+		    auto left = lstate.ctx.Deserialize(left_blob);
+		    auto right = lstate.ctx.Deserialize(right_blob);
+		    auto matrix = GEOSRelate_r(ctx, left.get(), right.get());
+		    if (!matrix) {
+			    throw InvalidInputException("ST_Relate: could not compute the intersection matrix");
+		    }
+		    auto matches = MatchesPattern(matrix, pattern.GetData());
+		    GEOSFree_r(ctx, matrix);
+		    return matches;
+	    });
+}
+
+//------------------------------------------------------------------------------
+// ST_RelateMatch
+//------------------------------------------------------------------------------
+static void RelateMatchFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	BinaryExecutor::Execute<string_t, string_t, bool>(
+	    args.data[0], args.data[1], result, args.size(), [&](string_t &matrix, string_t &pattern) {
+		    if (!IsValidPattern(matrix)) {
+			    throw InvalidInputException("ST_RelateMatch: invalid intersection matrix '%s'", matrix.GetString());
+		    }
+		    if (!IsValidPattern(pattern)) {
+			    throw InvalidInputException("ST_RelateMatch: invalid intersection matrix pattern '%s'",
+			                                pattern.GetString());
+		    }
+		    return MatchesPattern(matrix.GetData(), pattern.GetData());
+	    });
+}
+
+//------------------------------------------------------------------------------
+// __internal_st_relate_predicates
+//------------------------------------------------------------------------------
+// The conjunction of the predicates (and negated predicates) in the constant third argument, all derived from one
+// intersection matrix per row instead of a GEOS call per predicate.
+static void RelatePredicatesFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
+	auto &ctx = lstate.ctx.GetCtx();
+	auto &counters = lstate.factory.counters;
+
+	auto &spec_vec = args.data[2];
+	if (spec_vec.GetVectorType() != VectorType::CONSTANT_VECTOR || ConstantVector::IsNull(spec_vec)) {
+		throw InvalidInputException("The predicates of __internal_st_relate_predicates must be a constant");
+	}
+	auto terms = ParseRelatePredicates(ConstantVector::GetData<string_t>(spec_vec)[0].GetString());
+
+	BinaryExecutor::Execute<geometry_t, geometry_t, bool>(
+	    args.data[0], args.data[1], result, args.size(), [&](geometry_t &left_blob, geometry_t &right_blob) {
+		    if (GEOSExecutor::BoundingBoxesDisjoint(left_blob, right_blob)) {
+			    counters.bbox_rejects++;
+			    for (auto &term : terms) {
+				    if ((term.info->predicate == RelatePredicate::DISJOINT) == term.negated) {
+					    return false;
+				    }
+			    }
+			    return true;
+		    }
+		    auto left = lstate.ctx.Deserialize(left_blob);
+		    auto right = lstate.ctx.Deserialize(right_blob);
+		    if (GEOSisEmpty_r(ctx, left.get()) || GEOSisEmpty_r(ctx, right.get())) {
+			    // The predicates have special cases for empty geometries, so ask GEOS for each of them
+			    for (auto &term : terms) {
+				    counters.geos_predicate_calls++;
+				    if ((term.info->function(ctx, left.get(), right.get()) == 1) == term.negated) {
+					    return false;
+				    }
+			    }
+			    return true;
+		    }
+		    counters.geos_predicate_calls++;
+		    auto matrix = GEOSRelate_r(ctx, left.get(), right.get());
+		    if (!matrix) {
+			    throw InvalidInputException("Could not compute the intersection matrix");
+		    }
+		    auto matches = true;
+		    for (auto &term : terms) {
+			    if (EvaluatePredicate(term.info->predicate, matrix) == term.negated) {
+				    matches = false;
+				    break;
+			    }
+		    }
+		    GEOSFree_r(ctx, matrix);
+		    return matches;
+	    });
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void GEOSScalarFunctions::RegisterStRelate(DatabaseInstance &db) {
+
+	ScalarFunctionSet set("ST_Relate");
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), GeoTypes::GEOMETRY()}, LogicalType::VARCHAR, RelateFunction,
+	                               nullptr, nullptr, nullptr, GEOSFunctionLocalState::Init));
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), GeoTypes::GEOMETRY(), LogicalType::VARCHAR},
+	                               LogicalType::BOOLEAN, RelatePatternFunction, nullptr, nullptr, nullptr,
+	                               GEOSFunctionLocalState::Init));
+	ExtensionUtil::RegisterFunction(db, set);
+
+	ScalarFunctionSet match_set("ST_RelateMatch");
+	match_set.AddFunction(
+	    ScalarFunction({LogicalType::VARCHAR, LogicalType::VARCHAR}, LogicalType::BOOLEAN, RelateMatchFunction));
+	ExtensionUtil::RegisterFunction(db, match_set);
+
+	ScalarFunctionSet predicates_set("__internal_st_relate_predicates");
+	predicates_set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), GeoTypes::GEOMETRY(), LogicalType::VARCHAR},
+	                                          LogicalType::BOOLEAN, RelatePredicatesFunction, nullptr, nullptr, nullptr,
+	                                          GEOSFunctionLocalState::Init));
+	ExtensionUtil::RegisterFunction(db, predicates_set);
+}
+
+} // namespace geos
+
+} // namespace spatial
@@ -20,6 +20,7 @@ static void RemoveRepeatedPointsFunction(DataChunk &args, ExpressionState &state
 	auto count = args.size();
 
 	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
 	auto ctx = lstate.ctx.GetCtx();
 	UnaryExecutor::Execute<geometry_t, geometry_t>(input, result, count, [&](geometry_t input) {
 		auto geom = lstate.ctx.Deserialize(input);
@@ -35,6 +36,7 @@ static void RemoveRepeatedPointsFunctionWithTolerance(DataChunk &args, Expressio
 	auto count = args.size();
 
 	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
 	auto ctx = lstate.ctx.GetCtx();
 
 	BinaryExecutor::Execute<geometry_t, double, geometry_t>(
@@ -23,6 +23,7 @@ static void GeometryReverseFunction(DataChunk &args, ExpressionState &state, Vec
 	auto count = args.size();
 
 	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
 	auto ctx = lstate.ctx.GetCtx();
 	UnaryExecutor::Execute<geometry_t, geometry_t>(input, result, count, [&](geometry_t input) {
 		auto geom = lstate.ctx.Deserialize(input);
@@ -16,6 +16,7 @@ using namespace spatial::core;
 
 static void SimplifyPreserveTopologyFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
 	auto &ctx = lstate.ctx.GetCtx();
 	BinaryExecutor::Execute<geometry_t, double, geometry_t>(
 	    args.data[0], args.data[1], result, args.size(), [&](geometry_t input, double distance) {
@@ -0,0 +1,136 @@
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/geos/functions/scalar.hpp"
+#include "spatial/geos/functions/common.hpp"
+#include "spatial/geos/geos_wrappers.hpp"
+#include "spatial/geos/geos_split.hpp"
+
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+
+namespace spatial {
+
+namespace geos {
+
+using namespace spatial::core;
+
+// Split a geometry in half along the longer side of its extent until every piece has at most max_vertices
+// vertices. Collections are split into their parts first. The pieces are serialized into the result vector as soon
+// as they are small enough.
+static void Subdivide(GEOSContextHandle_t ctx, bool double_bbox, const GEOSGeometry *geom, int32_t max_vertices,
+                      idx_t depth, Vector &result, vector<geometry_t> &pieces) {
+	if (GEOSisEmpty_r(ctx, geom)) {
+		return;
+	}
+
+	if (GEOSGetNumCoordinates_r(ctx, geom) <= max_vertices || depth >= GEOSSplitExecutor::MAX_DEPTH) {
+		pieces.push_back(SerializeGEOSGeometry(result, geom, ctx, double_bbox));
+		return;
+	}
+
+	auto type = GEOSGeomTypeId_r(ctx, geom);
+	if (type == GEOS_MULTIPOINT || type == GEOS_MULTILINESTRING || type == GEOS_MULTIPOLYGON ||
+	    type == GEOS_GEOMETRYCOLLECTION) {
+		auto num_parts = GEOSGetNumGeometries_r(ctx, geom);
+		for (int i = 0; i < num_parts; i++) {
+			Subdivide(ctx, double_bbox, GEOSGetGeometryN_r(ctx, geom, i), max_vertices, depth, result, pieces);
+		}
+		return;
+	}
+
+	double xmin, ymin, xmax, ymax;
+	GEOSGeom_getXMin_r(ctx, geom, &xmin);
+	GEOSGeom_getYMin_r(ctx, geom, &ymin);
+	GEOSGeom_getXMax_r(ctx, geom, &xmax);
+	GEOSGeom_getYMax_r(ctx, geom, &ymax);
+
+	auto width = xmax - xmin;
+	auto height = ymax - ymin;
+	if (width == 0 && height == 0) {
+		// All vertices are in the same place, there is nothing to split
+		pieces.push_back(SerializeGEOSGeometry(result, geom, ctx, double_bbox));
+		return;
+	}
+
+	// Clip to the two halves of the extent and recurse into each
+	double halves[2][4];
+	GEOSSplitExecutor::HalveExtent(xmin, ymin, xmax, ymax, halves);
+
+	for (auto &half : halves) {
+		auto clipped = make_uniq_geos(ctx, GEOSClipByRect_r(ctx, geom, half[0], half[1], half[2], half[3]));
+		if (!clipped) {
+			throw InvalidInputException("ST_Subdivide: could not clip geometry");
+		}
+		Subdivide(ctx, double_bbox, clipped.get(), max_vertices, depth + 1, result, pieces);
+	}
+}
+
+static void SubdivideFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
+	auto &ctx = lstate.ctx.GetCtx();
+	auto count = args.size();
+
+	UnifiedVectorFormat geom_format;
+	UnifiedVectorFormat max_format;
+	args.data[0].ToUnifiedFormat(count, geom_format);
+	args.data[1].ToUnifiedFormat(count, max_format);
+	auto geom_data = UnifiedVectorFormat::GetData<geometry_t>(geom_format);
+	auto max_data = UnifiedVectorFormat::GetData<int32_t>(max_format);
+
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto result_entries = ListVector::GetData(result);
+	auto &result_validity = FlatVector::Validity(result);
+	auto &result_child = ListVector::GetEntry(result);
+
+	vector<geometry_t> pieces;
+	idx_t total_pieces = 0;
+
+	for (idx_t out_row_idx = 0; out_row_idx < count; out_row_idx++) {
+		auto geom_idx = geom_format.sel->get_index(out_row_idx);
+		auto max_idx = max_format.sel->get_index(out_row_idx);
+		if (!geom_format.validity.RowIsValid(geom_idx) || !max_format.validity.RowIsValid(max_idx)) {
+			result_validity.SetInvalid(out_row_idx);
+			continue;
+		}
+
+		auto max_vertices = max_data[max_idx];
+		// Anything smaller can not hold a rectangular piece of a polygon, so splitting would never stop
+		if (max_vertices < 5) {
+			throw InvalidInputException("ST_Subdivide: max_vertices must be at least 5");
+		}
+
+		pieces.clear();
+		auto geom = lstate.ctx.Deserialize(geom_data[geom_idx]);
+		Subdivide(ctx, lstate.ctx.double_bbox, geom.get(), max_vertices, 0, result_child, pieces);
+
+		result_entries[out_row_idx].offset = total_pieces;
+		result_entries[out_row_idx].length = pieces.size();
+		total_pieces += pieces.size();
+
+		ListVector::Reserve(result, total_pieces);
+		auto child_data = FlatVector::GetData<geometry_t>(ListVector::GetEntry(result));
+		for (idx_t i = 0; i < pieces.size(); i++) {
+			child_data[result_entries[out_row_idx].offset + i] = pieces[i];
+		}
+		ListVector::SetListSize(result, total_pieces);
+	}
+
+	if (count == 1) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
+}
+
+void GEOSScalarFunctions::RegisterStSubdivide(DatabaseInstance &db) {
+
+	ScalarFunctionSet set("ST_Subdivide");
+
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), LogicalType::INTEGER},
+	                               LogicalType::LIST(GeoTypes::GEOMETRY()), SubdivideFunction, nullptr, nullptr,
+	                               nullptr, GEOSFunctionLocalState::Init));
+
+	ExtensionUtil::RegisterFunction(db, set);
+}
+
+} // namespace geos
+
+} // namespace spatial
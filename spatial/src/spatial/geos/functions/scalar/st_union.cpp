@@ -3,6 +3,8 @@
 #include "spatial/geos/functions/scalar.hpp"
 #include "spatial/geos/functions/common.hpp"
 #include "spatial/geos/geos_wrappers.hpp"
+#include "spatial/geos/geos_executor.hpp"
+#include "spatial/geos/geos_split.hpp"
 
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
 #include "duckdb/common/vector_operations/unary_executor.hpp"
@@ -14,14 +16,125 @@ namespace geos {
 
 using namespace spatial::core;
 
+// The union of two (multi)polygons with disjoint bounding boxes is the multipolygon of all their polygons, which is
+// assembled from the serialized geometries without an overlay. Returns false for any other pair.
+static bool TryUnionDisjointPolygons(GEOSFunctionLocalState &lstate, const geometry_t &left_blob,
+                                     const geometry_t &right_blob, Vector &result, geometry_t &union_blob) {
+	if (GEOSExecutor::GetTypeDimension(left_blob.GetType()) != 2 ||
+	    GEOSExecutor::GetTypeDimension(right_blob.GetType()) != 2) {
+		return false;
+	}
+	auto left_props = left_blob.GetProperties();
+	auto right_props = right_blob.GetProperties();
+	if (left_props.HasZ() != right_props.HasZ() || left_props.HasM() != right_props.HasM() ||
+	    !GEOSExecutor::BoundingBoxesDisjoint(left_blob, right_blob)) {
+		return false;
+	}
+
+	auto &factory = lstate.factory;
+	vector<Polygon> polygons;
+	for (auto &blob : {left_blob, right_blob}) {
+		auto geom = factory.Deserialize(blob);
+		if (geom.Type() == GeometryType::POLYGON) {
+			polygons.push_back(geom.As<Polygon>());
+			continue;
+		}
+		for (auto &polygon : geom.As<MultiPolygon>()) {
+			if (!polygon.IsEmpty()) {
+				polygons.push_back(polygon);
+			}
+		}
+	}
+	auto has_z = left_props.HasZ();
+	auto has_m = left_props.HasM();
+	MultiPolygon multi_polygon(factory.allocator, static_cast<uint32_t>(polygons.size()), has_z, has_m);
+	for (idx_t i = 0; i < polygons.size(); i++) {
+		multi_polygon[static_cast<uint32_t>(i)] = polygons[i];
+	}
+	union_blob = factory.Serialize(result, multi_polygon, has_z, has_m);
+	return true;
+}
+
+// Huge (multi)polygons are split over all threads if "spatial_split_threshold" is set: the union of the pieces in
+// every cell is computed on its own, and the cells are stitched back together with a cascaded union. Lines would keep
+// the cuts as extra nodes, so other geometries are not split.
+static GeometryPtr UnionGEOS(GEOSFunctionLocalState &lstate, idx_t split_threshold, const geometry_t &left_blob,
+                             const GEOSGeometry *left, const geometry_t &right_blob, const GEOSGeometry *right) {
+	auto &ctx = lstate.ctx.GetCtx();
+	if (GEOSExecutor::GetTypeDimension(left_blob.GetType()) == 2 &&
+	    GEOSExecutor::GetTypeDimension(right_blob.GetType()) == 2 &&
+	    GEOSSplitExecutor::ShouldSplit(ctx, split_threshold, {left, right})) {
+		auto union_cell = [&](GEOSContextHandle_t cell_ctx, vector<GeometryPtr> &pieces) {
+			if (!pieces[0]) {
+				return std::move(pieces[1]);
+			}
+			if (!pieces[1]) {
+				return std::move(pieces[0]);
+			}
+			return make_uniq_geos(cell_ctx, GEOSUnion_r(cell_ctx, pieces[0].get(), pieces[1].get()));
+		};
+		return GEOSSplitExecutor::Execute(lstate.context, lstate.ctx, {left, right}, union_cell);
+	}
+	return make_uniq_geos(ctx, GEOSUnion_r(ctx, left, right));
+}
+
+// Union every row with a constant geometry. Rows inside a constant polygon do not add anything to it.
+static void ExecuteConstantUnion(GEOSFunctionLocalState &lstate, idx_t split_threshold, const geometry_t &const_blob,
+                                 Vector &rows, bool const_is_left, idx_t count, Vector &result) {
+	auto &ctx = lstate.ctx.GetCtx();
+	auto const_geom = lstate.ctx.Deserialize(const_blob);
+	GEOSExecutor::LazyPreparedGeometry const_prepared(lstate, const_blob);
+	auto const_is_areal = GEOSExecutor::GetTypeDimension(const_blob.GetType()) == 2;
+
+	UnaryExecutor::Execute<geometry_t, geometry_t>(rows, result, count, [&](geometry_t &row_blob) {
+		geometry_t union_blob;
+		if (const_is_left ? TryUnionDisjointPolygons(lstate, const_blob, row_blob, result, union_blob)
+		                  : TryUnionDisjointPolygons(lstate, row_blob, const_blob, result, union_blob)) {
+			return union_blob;
+		}
+		auto row_geom = lstate.ctx.Deserialize(row_blob);
+		if (const_is_areal && GEOSExecutor::GetTypeDimension(row_blob.GetType()) >= 0 &&
+		    GEOSPreparedContainsProperly_r(ctx, const_prepared.Get(), row_geom.get()) == 1) {
+			return geometry_t(StringVector::AddStringOrBlob(result, string_t(const_blob)));
+		}
+		auto result_geom =
+		    const_is_left ? UnionGEOS(lstate, split_threshold, const_blob, const_geom.get(), row_blob, row_geom.get())
+		                  : UnionGEOS(lstate, split_threshold, row_blob, row_geom.get(), const_blob, const_geom.get());
+		return lstate.ctx.Serialize(result, result_geom);
+	});
+}
+
 static void UnionFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
-	auto &ctx = lstate.ctx.GetCtx();
+	GeosInterruptScope interrupt_scope(lstate.context);
+	auto split_threshold = GEOSSplitExecutor::GetThreshold(lstate.context);
+	auto &left = args.data[0];
+	auto &right = args.data[1];
+	auto count = args.size();
+
+	if (left.GetVectorType() == VectorType::CONSTANT_VECTOR && right.GetVectorType() != VectorType::CONSTANT_VECTOR &&
+	    !ConstantVector::IsNull(left)) {
+		ExecuteConstantUnion(lstate, split_threshold, ConstantVector::GetData<geometry_t>(left)[0], right, true, count,
+		                     result);
+		return;
+	}
+	if (right.GetVectorType() == VectorType::CONSTANT_VECTOR && left.GetVectorType() != VectorType::CONSTANT_VECTOR &&
+	    !ConstantVector::IsNull(right)) {
+		ExecuteConstantUnion(lstate, split_threshold, ConstantVector::GetData<geometry_t>(right)[0], left, false, count,
+		                     result);
+		return;
+	}
+
 	BinaryExecutor::Execute<geometry_t, geometry_t, geometry_t>(
-	    args.data[0], args.data[1], result, args.size(), [&](geometry_t left, geometry_t right) {
-		    auto left_geom = lstate.ctx.Deserialize(left);
-		    auto right_geom = lstate.ctx.Deserialize(right);
-		    auto result_geom = make_uniq_geos(ctx, GEOSUnion_r(ctx, left_geom.get(), right_geom.get()));
+	    left, right, result, count, [&](geometry_t left_blob, geometry_t right_blob) {
+		    geometry_t union_blob;
+		    if (TryUnionDisjointPolygons(lstate, left_blob, right_blob, result, union_blob)) {
+			    return union_blob;
+		    }
+		    auto left_geom = lstate.ctx.Deserialize(left_blob);
+		    auto right_geom = lstate.ctx.Deserialize(right_blob);
+		    auto result_geom =
+		        UnionGEOS(lstate, split_threshold, left_blob, left_geom.get(), right_blob, right_geom.get());
 		    return lstate.ctx.Serialize(result, result_geom);
 	    });
 }
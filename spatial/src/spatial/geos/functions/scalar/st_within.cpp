@@ -17,11 +17,15 @@ using namespace spatial::core;
 
 static void WithinFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &lstate = GEOSFunctionLocalState::ResetAndGet(state);
+	GeosInterruptScope interrupt_scope(lstate.context);
 	auto &left = args.data[0];
 	auto &right = args.data[1];
 	auto count = args.size();
+	// A point is within a polygon only if it is in its interior, not on its boundary
+	PointInPolygonMask pip_mask;
+	pip_mask.polygon_right = static_cast<uint8_t>(PointLocation::INTERIOR);
 	GEOSExecutor::ExecuteNonSymmetricPreparedBinary(lstate, left, right, count, result, GEOSWithin_r,
-	                                                GEOSPreparedWithin_r);
+	                                                GEOSPreparedWithin_r, false, pip_mask);
 }
 
 void GEOSScalarFunctions::RegisterStWithin(DatabaseInstance &db) {
@@ -0,0 +1,183 @@
+#include "spatial/common.hpp"
+#include "spatial/core/parallel_chunks.hpp"
+#include "spatial/geos/geos_split.hpp"
+
+#include "duckdb/parallel/task_scheduler.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+
+namespace spatial {
+
+namespace geos {
+
+void GEOSSplitExecutor::HalveExtent(double xmin, double ymin, double xmax, double ymax, double halves[2][4]) {
+	for (idx_t i = 0; i < 2; i++) {
+		halves[i][0] = xmin;
+		halves[i][1] = ymin;
+		halves[i][2] = xmax;
+		halves[i][3] = ymax;
+	}
+	auto width = xmax - xmin;
+	auto height = ymax - ymin;
+	if (width >= height) {
+		auto center = xmin + width / 2;
+		halves[0][2] = center;
+		halves[1][0] = center;
+	} else {
+		auto center = ymin + height / 2;
+		halves[0][3] = center;
+		halves[1][1] = center;
+	}
+}
+
+idx_t GEOSSplitExecutor::GetThreshold(ClientContext &context) {
+	Value threshold;
+	if (context.TryGetCurrentSetting("spatial_split_threshold", threshold) && !threshold.IsNull()) {
+		return threshold.GetValue<idx_t>();
+	}
+	return 0;
+}
+
+static idx_t CountVertices(GEOSContextHandle_t ctx, const vector<const GEOSGeometry *> &geoms) {
+	idx_t count = 0;
+	for (auto geom : geoms) {
+		if (geom) {
+			auto coordinates = GEOSGetNumCoordinates_r(ctx, geom);
+			count += coordinates > 0 ? static_cast<idx_t>(coordinates) : 0;
+		}
+	}
+	return count;
+}
+
+bool GEOSSplitExecutor::ShouldSplit(GEOSContextHandle_t ctx, idx_t threshold,
+                                    const vector<const GEOSGeometry *> &geoms) {
+	return threshold > 0 && CountVertices(ctx, geoms) > threshold;
+}
+
+//------------------------------------------------------------------------------
+// Job
+//------------------------------------------------------------------------------
+// The serialized pieces of every cell, and the serialized result of every cell once the function ran on it
+struct GEOSSplitJob {
+	explicit GEOSSplitJob(ClientContext &context) : allocator(BufferAllocator::Get(context)) {
+	}
+
+	Allocator &allocator;
+	vector<vector<AllocatedData>> cells;
+	vector<AllocatedData> results;
+};
+
+//------------------------------------------------------------------------------
+// Split
+//------------------------------------------------------------------------------
+// Halve the extent of the pieces until the pieces in a cell have at most max_vertices vertices together, and add
+// the serialized pieces of every cell to the job. Cells without any piece are dropped.
+static void SplitCells(GEOSContextHandle_t ctx, const vector<const GEOSGeometry *> &pieces, idx_t max_vertices,
+                       idx_t depth, GEOSSplitJob &job) {
+	bool has_extent = false;
+	double xmin = 0, ymin = 0, xmax = 0, ymax = 0;
+	for (auto piece : pieces) {
+		double piece_xmin, piece_ymin, piece_xmax, piece_ymax;
+		if (!piece || GEOSisEmpty_r(ctx, piece) || !GEOSGeom_getExtent_r(ctx, piece, &piece_xmin, &piece_ymin,
+		                                                                  &piece_xmax, &piece_ymax)) {
+			continue;
+		}
+		xmin = has_extent ? MinValue(xmin, piece_xmin) : piece_xmin;
+		ymin = has_extent ? MinValue(ymin, piece_ymin) : piece_ymin;
+		xmax = has_extent ? MaxValue(xmax, piece_xmax) : piece_xmax;
+		ymax = has_extent ? MaxValue(ymax, piece_ymax) : piece_ymax;
+		has_extent = true;
+	}
+	if (!has_extent) {
+		return;
+	}
+
+	if (CountVertices(ctx, pieces) <= max_vertices || depth >= GEOSSplitExecutor::MAX_DEPTH ||
+	    (xmax == xmin && ymax == ymin)) {
+		vector<AllocatedData> cell;
+		for (auto piece : pieces) {
+			if (!piece || GEOSisEmpty_r(ctx, piece)) {
+				cell.emplace_back();
+			} else {
+				cell.push_back(SerializeGEOSGeometry(job.allocator, piece, ctx));
+			}
+		}
+		job.cells.push_back(std::move(cell));
+		return;
+	}
+
+	double halves[2][4];
+	GEOSSplitExecutor::HalveExtent(xmin, ymin, xmax, ymax, halves);
+	for (auto &half : halves) {
+		vector<GeometryPtr> clipped;
+		vector<const GEOSGeometry *> clipped_pieces;
+		for (auto piece : pieces) {
+			if (!piece) {
+				clipped.emplace_back();
+			} else {
+				auto clip = GEOSClipByRect_r(ctx, piece, half[0], half[1], half[2], half[3]);
+				clipped.push_back(make_uniq_geos(ctx, clip));
+				if (!clipped.back()) {
+					throw InvalidInputException("Could not clip geometry to split it");
+				}
+			}
+			clipped_pieces.push_back(clipped.back().get());
+		}
+		SplitCells(ctx, clipped_pieces, max_vertices, depth + 1, job);
+	}
+}
+
+GeometryPtr GEOSSplitExecutor::Execute(ClientContext &context, GeosContextWrapper &wrapper,
+                                       const vector<const GEOSGeometry *> &geoms, const CellFunction &fun) {
+	auto ctx = wrapper.GetCtx();
+	auto &scheduler = TaskScheduler::GetScheduler(context);
+	auto thread_count = MaxValue<idx_t>(static_cast<idx_t>(scheduler.NumberOfThreads()), 1);
+
+	// A few cells per thread, so that a thread with a cheap cell picks up another one
+	GEOSSplitJob job(context);
+	auto max_vertices = MaxValue<idx_t>(CountVertices(ctx, geoms) / (4 * thread_count), MIN_CELL_VERTICES);
+	SplitCells(ctx, geoms, max_vertices, 0, job);
+	job.results.resize(job.cells.size());
+
+	// Every cell runs in a GEOS context of its own, which comes from the pool of contexts
+	core::ParallelChunks::Run(context, job.cells.size(), [&](idx_t i) {
+		GeosInterruptScope interrupt_scope(context);
+		interrupt_scope.Check();
+		GeosContextWrapper cell_wrapper;
+		auto cell_ctx = cell_wrapper.GetCtx();
+		vector<GeometryPtr> pieces;
+		for (auto &piece : job.cells[i]) {
+			if (!piece.get()) {
+				pieces.emplace_back();
+				continue;
+			}
+			auto blob = string_t(const_char_ptr_cast(piece.get()), static_cast<uint32_t>(piece.GetSize()));
+			pieces.push_back(cell_wrapper.Deserialize(geometry_t(blob)));
+		}
+		auto result = fun(cell_ctx, pieces);
+		if (result) {
+			job.results[i] = SerializeGEOSGeometry(job.allocator, result.get(), cell_ctx);
+		}
+	});
+
+	// Stitch the results of the cells back together
+	vector<GeometryPtr> results;
+	for (auto &result : job.results) {
+		if (result.get()) {
+			auto blob = string_t(const_char_ptr_cast(result.get()), static_cast<uint32_t>(result.GetSize()));
+			results.push_back(wrapper.Deserialize(geometry_t(blob)));
+		}
+	}
+	// The collection takes ownership of the results
+	vector<GEOSGeometry *> parts;
+	parts.reserve(results.size());
+	for (auto &result : results) {
+		parts.push_back(result.release());
+	}
+	auto collection = make_uniq_geos(ctx, GEOSGeom_createCollection_r(ctx, GEOS_GEOMETRYCOLLECTION, parts.data(),
+	                                                                   static_cast<unsigned int>(parts.size())));
+	return make_uniq_geos(ctx, GEOSUnaryUnion_r(ctx, collection.get()));
+}
+
+} // namespace geos
+
+} // namespace spatial
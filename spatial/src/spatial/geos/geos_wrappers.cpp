@@ -3,6 +3,9 @@
 #include "spatial/core/geometry/geometry.hpp"
 #include "spatial/core/geometry/cursor.hpp"
 #include "spatial/core/geometry/geometry_processor.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+
+#include "duckdb/main/client_context.hpp"
 
 namespace spatial {
 
@@ -20,10 +23,14 @@ bool IsPointerAligned(const void *ptr) {
 	return (uintptr % alignof(T)) == 0;
 }
 
+// The deserializer is kept alive with the pooled context, so the scratch buffers below are only allocated once per
+// context instead of for every row. Ring and collection members are gathered on a single stack, nested collections
+// push their members on top and pop them again before their parent continues.
 class GEOSDeserializer final : GeometryProcessor<GEOSGeometry *> {
 private:
 	GEOSContextHandle_t ctx;
 	vector<double> aligned_buffer;
+	vector<GEOSGeometry *> parts;
 
 private:
 	GEOSCoordSeq_t *HandleVertexData(const VertexData &vertices) {
@@ -42,7 +49,6 @@ private:
 			auto vertex_data = reinterpret_cast<const double *>(data_ptr);
 			if (!IsPointerAligned<double>(data_ptr)) {
 				// If the pointer is not aligned we need to copy the data to an aligned buffer before passing it to GEOS
-				aligned_buffer.clear();
 				aligned_buffer.resize(count * n_dims);
 				memcpy(aligned_buffer.data(), data_ptr, count * vertex_size);
 				vertex_data = aligned_buffer.data();
@@ -75,15 +81,15 @@ private:
 		if (num_rings == 0) {
 			return GEOSGeom_createEmptyPolygon_r(ctx);
 		} else {
-			// TODO: Make a vector here instead of using new
-			auto geoms = new GEOSGeometry *[num_rings];
+			auto base = parts.size();
 			for (uint32_t i = 0; i < num_rings; i++) {
 				auto vertices = state.Next();
 				auto seq = HandleVertexData(vertices);
-				geoms[i] = GEOSGeom_createLinearRing_r(ctx, seq);
+				parts.push_back(GEOSGeom_createLinearRing_r(ctx, seq));
 			}
-			auto result = GEOSGeom_createPolygon_r(ctx, geoms[0], geoms + 1, num_rings - 1);
-			delete[] geoms;
+			auto rings = parts.data() + base;
+			auto result = GEOSGeom_createPolygon_r(ctx, rings[0], rings + 1, num_rings - 1);
+			parts.resize(base);
 			return result;
 		}
 	}
@@ -107,12 +113,14 @@ private:
 		if (item_count == 0) {
 			return GEOSGeom_createEmptyCollection_r(ctx, collection_type);
 		} else {
-			auto geoms = new GEOSGeometry *[item_count];
+			auto base = parts.size();
 			for (uint32_t i = 0; i < item_count; i++) {
-				geoms[i] = state.Next();
+				// Take the pointer only after all members are done, nested members may grow the stack
+				auto geom = state.Next();
+				parts.push_back(geom);
 			}
-			auto result = GEOSGeom_createCollection_r(ctx, collection_type, geoms, item_count);
-			delete[] geoms;
+			auto result = GEOSGeom_createCollection_r(ctx, collection_type, parts.data() + base, item_count);
+			parts.resize(base);
 			return result;
 		}
 	}
@@ -122,10 +130,125 @@ public:
 	}
 
 	GeometryPtr Execute(const geometry_t &geom) {
-		return GeometryPtr {Process(geom)};
+		// Anything left over is from a row that threw half way through
+		parts.clear();
+		return make_uniq_geos(ctx, Process(geom));
+	}
+};
+
+//------------------------------------------------------------------------------
+// Interrupts
+//------------------------------------------------------------------------------
+static thread_local const atomic<bool> *thread_interrupted = nullptr;
+
+GeosInterruptScope::GeosInterruptScope(const atomic<bool> &interrupted)
+    : interrupted(interrupted), previous(thread_interrupted) {
+	thread_interrupted = &interrupted;
+}
+
+GeosInterruptScope::GeosInterruptScope(ClientContext &context) : GeosInterruptScope(context.interrupted) {
+}
+
+GeosInterruptScope::~GeosInterruptScope() {
+	thread_interrupted = previous;
+}
+
+bool GeosInterruptScope::IsInterrupted() {
+	return thread_interrupted && thread_interrupted->load(std::memory_order_relaxed);
+}
+
+// Throwing here unwinds GEOS up to its C API, which reports the exception to the error handler of the context
+static void GeosInterruptCallback() {
+	if (GeosInterruptScope::IsInterrupted()) {
+		throw InterruptException();
+	}
+}
+
+void GeosInterruptScope::RegisterCallback() {
+	GEOS_interruptRegisterCallback(GeosInterruptCallback);
+}
+
+//------------------------------------------------------------------------------
+// Context
+//------------------------------------------------------------------------------
+struct GeosPooledContext {
+	GEOSContextHandle_t ctx;
+	unique_ptr<GEOSDeserializer> deserializer;
+	unique_ptr<WKBReader> wkb_reader;
+	unique_ptr<WKTWriter> wkt_writer;
+
+	GeosPooledContext() {
+		ctx = GEOS_init_r();
+		GEOSContext_setErrorMessageHandler_r(ctx, GeosContextWrapper::ErrorHandler, (void *)nullptr);
+	}
+
+	~GeosPooledContext() {
+		// The helpers belong to the context, so they have to go first
+		deserializer.reset();
+		wkb_reader.reset();
+		wkt_writer.reset();
+		GEOS_finish_r(ctx);
+	}
+};
+
+// The contexts that are not checked out. Enough are kept for every thread of a large machine to run a few GEOS
+// expressions at once, any beyond that are destroyed when they are returned.
+class GeosContextPool {
+public:
+	static constexpr idx_t MAX_POOLED_CONTEXTS = 256;
+
+	static unique_ptr<GeosPooledContext> Acquire() {
+		auto &pool = Get();
+		{
+			lock_guard<mutex> guard(pool.lock);
+			if (!pool.contexts.empty()) {
+				auto context = std::move(pool.contexts.back());
+				pool.contexts.pop_back();
+				return context;
+			}
+		}
+		return make_uniq<GeosPooledContext>();
+	}
+
+	static void Release(unique_ptr<GeosPooledContext> context) {
+		auto &pool = Get();
+		lock_guard<mutex> guard(pool.lock);
+		if (pool.contexts.size() < MAX_POOLED_CONTEXTS) {
+			pool.contexts.push_back(std::move(context));
+		}
+	}
+
+private:
+	mutex lock;
+	vector<unique_ptr<GeosPooledContext>> contexts;
+
+	static GeosContextPool &Get() {
+		static GeosContextPool pool;
+		return pool;
 	}
 };
 
+GeosContextWrapper::GeosContextWrapper() : pooled(GeosContextPool::Acquire()) {
+	ctx = pooled->ctx;
+}
+
+GeosContextWrapper::~GeosContextWrapper() {
+	GeosContextPool::Release(std::move(pooled));
+}
+
+const WKBReader &GeosContextWrapper::GetWKBReader() {
+	if (!pooled->wkb_reader) {
+		pooled->wkb_reader = make_uniq<WKBReader>(ctx);
+	}
+	return *pooled->wkb_reader;
+}
+
+const WKTWriter &GeosContextWrapper::GetWKTWriter() {
+	if (!pooled->wkt_writer) {
+		pooled->wkt_writer = make_uniq<WKTWriter>(ctx);
+	}
+	return *pooled->wkt_writer;
+}
 
 GEOSGeometry *DeserializeGEOSGeometry(const geometry_t &blob, GEOSContextHandle_t ctx) {
 	GEOSDeserializer deserializer(ctx);
@@ -133,8 +256,14 @@ GEOSGeometry *DeserializeGEOSGeometry(const geometry_t &blob, GEOSContextHandle_
 }
 
 GeometryPtr GeosContextWrapper::Deserialize(const geometry_t &blob) {
-	GEOSDeserializer deserializer(ctx);
-	return deserializer.Execute(blob);
+	if (!pooled->deserializer) {
+		pooled->deserializer = make_uniq<GEOSDeserializer>(ctx);
+	}
+	if (counters) {
+		counters->deserialize_calls++;
+		counters->deserialize_bytes += string_t(blob).GetSize();
+	}
+	return pooled->deserializer->Execute(blob);
 }
 
 //-------------------------------------------------------------------
@@ -497,95 +626,101 @@ static void GetExtendedExtent(const GEOSGeometry *geom, double *zmin, double *zm
 	}
 }
 
-geometry_t SerializeGEOSGeometry(Vector &result, const GEOSGeometry *geom, GEOSContextHandle_t ctx) {
-
+// The header of a serialized GEOS geometry, and the size of the whole blob
+struct SerializedHeader {
 	GeometryType type;
+	GeometryProperties properties;
+	uint32_t size;
+};
+
+static SerializedHeader GetSerializedHeader(const GEOSGeometry *geom, GEOSContextHandle_t ctx, bool double_bbox) {
+	SerializedHeader header;
 	auto geos_type = GEOSGeomTypeId_r(ctx, geom);
 	switch (geos_type) {
 	case GEOS_POINT:
-		type = GeometryType::POINT;
+		header.type = GeometryType::POINT;
 		break;
 	case GEOS_LINESTRING:
-		type = GeometryType::LINESTRING;
+		header.type = GeometryType::LINESTRING;
 		break;
 	case GEOS_POLYGON:
-		type = GeometryType::POLYGON;
+		header.type = GeometryType::POLYGON;
 		break;
 	case GEOS_MULTIPOINT:
-		type = GeometryType::MULTIPOINT;
+		header.type = GeometryType::MULTIPOINT;
 		break;
 	case GEOS_MULTILINESTRING:
-		type = GeometryType::MULTILINESTRING;
+		header.type = GeometryType::MULTILINESTRING;
 		break;
 	case GEOS_MULTIPOLYGON:
-		type = GeometryType::MULTIPOLYGON;
+		header.type = GeometryType::MULTIPOLYGON;
 		break;
 	case GEOS_GEOMETRYCOLLECTION:
-		type = GeometryType::GEOMETRYCOLLECTION;
+		header.type = GeometryType::GEOMETRYCOLLECTION;
 		break;
 	default:
 		throw NotImplementedException(
 		    StringUtil::Format("GEOS Wrapper Serialize: Geometry type %d not supported", geos_type));
 	}
 
-	bool has_bbox = type != GeometryType::POINT && GEOSisEmpty_r(ctx, geom) == 0;
-	bool has_z = GEOSHasZ_r(ctx, geom);
-	bool has_m = GEOSHasM_r(ctx, geom);
+	auto has_bbox = header.type != GeometryType::POINT && GEOSisEmpty_r(ctx, geom) == 0;
+	header.properties.SetBBox(has_bbox);
+	header.properties.SetDoubleBBox(has_bbox && double_bbox);
+	header.properties.SetZ(GEOSHasZ_r(ctx, geom));
+	header.properties.SetM(GEOSHasM_r(ctx, geom));
 
-	auto bbox_size = has_bbox ? (sizeof(float) * 2 * (2 + (has_z ? 1 : 0) + (has_m ? 1 : 0))) : 0;
-
-	auto size = GetSerializedSize(geom, ctx);
-	size += 4;                // Header
-	size += sizeof(uint32_t); // Padding
-	size += bbox_size;        // BBox
-
-	auto blob = StringVector::EmptyString(result, size);
-	Cursor writer(blob);
+	header.size = GetSerializedSize(geom, ctx);
+	header.size += 4;                            // Header
+	header.size += sizeof(uint32_t);             // Padding
+	header.size += header.properties.BBoxSize(); // BBox
+	return header;
+}
 
+static void WriteSerialized(Cursor &writer, const SerializedHeader &header, const GEOSGeometry *geom,
+                            GEOSContextHandle_t ctx) {
 	uint16_t hash = 0;
 
-	GeometryProperties properties;
-	properties.SetBBox(has_bbox);
-	properties.SetZ(GEOSHasZ_r(ctx, geom));
-	properties.SetM(GEOSHasM_r(ctx, geom));
-	writer.Write<GeometryType>(type);             // Type
+	auto &properties = header.properties;
+	writer.Write<GeometryType>(header.type);      // Type
 	writer.Write<GeometryProperties>(properties); // Properties
 	writer.Write<uint16_t>(hash);                 // Hash
 	writer.Write<uint32_t>(0);                    // Padding
 
 	// If the geom is not a point, write the bounding box
-	if (has_bbox) {
-		double minx, maxx, miny, maxy;
-		GEOSGeom_getExtent_r(ctx, geom, &minx, &miny, &maxx, &maxy);
-		writer.Write<float>(Utils::DoubleToFloatDown(minx));
-		writer.Write<float>(Utils::DoubleToFloatDown(miny));
-		writer.Write<float>(Utils::DoubleToFloatUp(maxx));
-		writer.Write<float>(Utils::DoubleToFloatUp(maxy));
+	if (properties.HasBBox()) {
+		BoundingBox bbox;
+		GEOSGeom_getExtent_r(ctx, geom, &bbox.minx, &bbox.miny, &bbox.maxx, &bbox.maxy);
 
 		// well, this sucks. GEOS doesnt have a native way to get the Z and M value extents.
-		if (has_z || has_m) {
-			double minz, maxz, minm, maxm;
-			GetExtendedExtent(geom, &minz, &maxz, &minm, &maxm, ctx);
-			if (has_z) {
-				writer.Write<float>(Utils::DoubleToFloatDown(minz));
-				writer.Write<float>(Utils::DoubleToFloatUp(maxz));
-			}
-			if (has_m) {
-				writer.Write<float>(Utils::DoubleToFloatDown(minm));
-				writer.Write<float>(Utils::DoubleToFloatUp(maxm));
-			}
+		if (properties.HasZ() || properties.HasM()) {
+			GetExtendedExtent(geom, &bbox.minz, &bbox.maxz, &bbox.minm, &bbox.maxm, ctx);
 		}
+		GeometryFactory::SerializeBoundingBox(writer, bbox, properties);
 	}
 
 	SerializeGeometry(writer, geom, ctx);
+}
 
+geometry_t SerializeGEOSGeometry(Vector &result, const GEOSGeometry *geom, GEOSContextHandle_t ctx, bool double_bbox) {
+	auto header = GetSerializedHeader(geom, ctx, double_bbox);
+	auto blob = StringVector::EmptyString(result, header.size);
+	Cursor writer(blob);
+	WriteSerialized(writer, header, geom, ctx);
 	blob.Finalize();
-
 	return geometry_t(blob);
 }
 
+AllocatedData SerializeGEOSGeometry(Allocator &allocator, const GEOSGeometry *geom, GEOSContextHandle_t ctx,
+                                    bool double_bbox) {
+	auto header = GetSerializedHeader(geom, ctx, double_bbox);
+	auto data = allocator.Allocate(header.size);
+	Cursor writer(data.get(), data.get() + header.size);
+	WriteSerialized(writer, header, geom, ctx);
+	return data;
+}
+
 geometry_t GeosContextWrapper::Serialize(Vector &result, const GeometryPtr &geom) {
-	return SerializeGEOSGeometry(result, geom.get(), ctx);
+	return SerializeGEOSGeometry(result, geom.get(), ctx, double_bbox);
 }
 
 } // namespace geos
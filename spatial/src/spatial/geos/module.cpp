@@ -2,17 +2,27 @@
 #include "spatial/geos/functions/aggregate.hpp"
 #include "spatial/geos/functions/scalar.hpp"
 #include "spatial/geos/functions/cast.hpp"
+#include "spatial/geos/geos_wrappers.hpp"
 
 #include "spatial/common.hpp"
 
+#include "duckdb/main/config.hpp"
+
 namespace spatial {
 
 namespace geos {
 
 void GeosModule::Register(DatabaseInstance &db) {
+	GeosInterruptScope::RegisterCallback();
 	GEOSScalarFunctions::Register(db);
 	GeosAggregateFunctions::Register(db);
 	GeosCastFunctions::Register(db);
+
+	auto &config = DBConfig::GetConfig(db);
+	config.AddExtensionOption("spatial_split_threshold",
+	                          "The number of vertices above which ST_Buffer and ST_Union cut a single geometry into "
+	                          "pieces that are processed on all threads, or 0 to never split geometries",
+	                          LogicalType::UBIGINT, Value::UBIGINT(0));
 }
 
 } // namespace geos
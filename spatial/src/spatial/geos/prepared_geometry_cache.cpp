@@ -0,0 +1,73 @@
+#include "spatial/common.hpp"
+#include "spatial/geos/prepared_geometry_cache.hpp"
+
+#include "duckdb/common/types/hash.hpp"
+
+namespace spatial {
+
+namespace geos {
+
+// The header and bounding box are usually enough to tell geometries apart
+static constexpr idx_t KEY_PREFIX_SIZE = 64;
+
+PreparedGeometryCache::PreparedGeometryCache(GEOSContextHandle_t ctx, idx_t max_bytes)
+    : ctx(ctx), max_bytes(max_bytes) {
+}
+
+const GEOSPreparedGeometry *PreparedGeometryCache::Get(const geometry_t &geom) {
+	// Preparing a point does not speed anything up
+	if (geom.GetType() == GeometryType::POINT) {
+		return nullptr;
+	}
+
+	string_t blob = geom;
+	auto data = blob.GetDataUnsafe();
+	auto size = blob.GetSize();
+	if (size > max_bytes) {
+		return nullptr;
+	}
+	auto key = CombineHash(Hash(data, MinValue<idx_t>(size, KEY_PREFIX_SIZE)), Hash(size));
+
+	auto lookup = index.find(key);
+	if (lookup != index.end()) {
+		auto &entry = *lookup->second;
+		if (entry.blob.size() == size && memcmp(entry.blob.data(), data, size) == 0) {
+			// Hit, move it to the front
+			entries.splice(entries.begin(), entries, lookup->second);
+			if (!entry.prepared) {
+				// Seen before, now it is worth preparing
+				entry.geometry = make_uniq_geos(ctx, DeserializeGEOSGeometry(geom, ctx));
+				entry.prepared = make_uniq_geos(ctx, GEOSPrepare_r(ctx, entry.geometry.get()));
+			}
+			return entry.prepared.get();
+		}
+		// Hash collision, replace the old entry
+		size_in_bytes -= entry.blob.size();
+		entries.erase(lookup->second);
+		index.erase(lookup);
+	}
+
+	// First time we see this geometry, only remember the blob
+	entries.emplace_front();
+	auto &entry = entries.front();
+	entry.key = key;
+	entry.blob = string(data, size);
+	index[key] = entries.begin();
+	size_in_bytes += size;
+	Evict();
+	return nullptr;
+}
+
+void PreparedGeometryCache::Evict() {
+	// Always keep the most recent entry
+	while (size_in_bytes > max_bytes && entries.size() > 1) {
+		auto &entry = entries.back();
+		size_in_bytes -= entry.blob.size();
+		index.erase(entry.key);
+		entries.pop_back();
+	}
+}
+
+} // namespace geos
+
+} // namespace spatial
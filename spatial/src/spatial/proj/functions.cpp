@@ -1,14 +1,24 @@
+#include "duckdb/common/list.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/operator/cast_operators.hpp"
+#include "duckdb/common/unordered_map.hpp"
 #include "duckdb/common/vector_operations/generic_executor.hpp"
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
 #include "duckdb/parser/parsed_data/create_table_function_info.hpp"
 #include "duckdb/parser/parsed_data/create_view_info.hpp"
 #include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/function/replacement_scan.hpp"
+#include "duckdb/parser/expression/function_expression.hpp"
+#include "duckdb/parser/tableref/table_function_ref.hpp"
+#include "duckdb/storage/object_cache.hpp"
 #include "duckdb/planner/expression/bound_function_expression.hpp"
 
 #include "spatial/common.hpp"
 #include "spatial/core/types.hpp"
+#include "spatial/core/functions/common.hpp"
 #include "spatial/core/geometry/geometry_factory.hpp"
 #include "spatial/proj/functions.hpp"
+#include "spatial/proj/grid_cache.hpp"
 #include "spatial/proj/module.hpp"
 
 #include "proj.h"
@@ -19,19 +29,174 @@ namespace proj {
 
 using namespace core;
 
+struct ProjCRSDelete {
+	void operator()(PJ *crs) {
+		proj_destroy(crs);
+	}
+};
+
+using ProjCRS = unique_ptr<PJ, ProjCRSDelete>;
+
+// A pipeline resolved once when binding a transform with constant projections, in a context of its own. Threads clone
+// it into their own context instead of each searching the proj database for the same operations.
+class ProjPipelineTemplate {
+public:
+	ProjPipelineTemplate(string from_p, string to_p, bool always_xy_p, PJ_CONTEXT *ctx_p, PJ *crs_p)
+	    : from(std::move(from_p)), to(std::move(to_p)), always_xy(always_xy_p), ctx(ctx_p), crs(crs_p) {
+	}
+
+	~ProjPipelineTemplate() {
+		proj_destroy(crs);
+		proj_context_destroy(ctx);
+	}
+
+	// Returns nullptr if the pipeline can not be created, the error is then raised when the transform is executed
+	static shared_ptr<ProjPipelineTemplate> TryCreate(ClientContext &context, const string &from, const string &to,
+	                                                  bool always_xy) {
+		auto ctx = ProjModule::GetThreadProjContext();
+		// Which operations are available depends on the grids that can be found
+		ProjGridCache::Attach(ctx, context);
+		auto crs = proj_create_crs_to_crs(ctx, from.c_str(), to.c_str(), nullptr);
+		if (!crs) {
+			proj_context_destroy(ctx);
+			return nullptr;
+		}
+		if (always_xy) {
+			auto normalized_crs = proj_normalize_for_visualization(ctx, crs);
+			if (normalized_crs) {
+				proj_destroy(crs);
+				crs = normalized_crs;
+			}
+			// otherwise fall back to the original CRS
+		}
+		return make_shared<ProjPipelineTemplate>(from, to, always_xy, ctx, crs);
+	}
+
+	bool Matches(const string &from_p, const string &to_p, bool always_xy_p) const {
+		return always_xy == always_xy_p && from == from_p && to == to_p;
+	}
+	bool Matches(const ProjPipelineTemplate &other) const {
+		return Matches(other.from, other.to, other.always_xy);
+	}
+
+	// Clone the pipeline into another context
+	PJ *Clone(PJ_CONTEXT *target_ctx) {
+		// The template is shared by all threads
+		lock_guard<mutex> guard(lock);
+		return proj_clone(target_ctx, crs);
+	}
+
+private:
+	string from;
+	string to;
+	bool always_xy;
+	PJ_CONTEXT *ctx;
+	PJ *crs;
+	mutex lock;
+};
+
+// A small LRU cache of transformation pipelines, keyed by the source and target CRS strings and the axis order.
+// Creating a pipeline means parsing both CRS definitions and looking up the candidate operations in the proj database,
+// which is far more expensive than transforming a handful of coordinates, so each thread should only do it once per
+// pair of projections.
+class ProjPipelineCache {
+public:
+	static constexpr idx_t MAX_ENTRIES = 64;
+
+	// Get the pipeline transforming from -> to, cloned from the template if it is for the same projections. The cache
+	// keeps ownership of the returned pipeline, which stays valid until the next call.
+	PJ *GetOrCreate(PJ_CONTEXT *ctx, const string &from, const string &to, bool always_xy,
+	                ProjPipelineTemplate *shared, SpatialCounters &counters) {
+		auto key = from + '\0' + to + (always_xy ? '1' : '0');
+
+		auto lookup = index.find(key);
+		if (lookup != index.end()) {
+			// Hit, move it to the front
+			entries.splice(entries.begin(), entries, lookup->second);
+			return entries.front().crs.get();
+		}
+		counters.proj_pipelines++;
+
+		if (shared && shared->Matches(from, to, always_xy)) {
+			auto cloned = ProjCRS(shared->Clone(ctx));
+			if (cloned.get()) {
+				return Insert(std::move(key), std::move(cloned));
+			}
+			// otherwise resolve it from scratch
+		}
+
+		auto crs = ProjCRS(proj_create_crs_to_crs(ctx, from.c_str(), to.c_str(), nullptr));
+		if (!crs.get()) {
+			throw InvalidInputException("Could not create projection: " + from + " -> " + to);
+		}
+
+		if (always_xy) {
+			auto normalized_crs = proj_normalize_for_visualization(ctx, crs.get());
+			if (normalized_crs) {
+				crs = ProjCRS(normalized_crs);
+			}
+			// otherwise fall back to the original CRS
+		}
+		return Insert(std::move(key), std::move(crs));
+	}
+
+	void Clear() {
+		index.clear();
+		entries.clear();
+	}
+
+private:
+	struct Entry {
+		string key;
+		ProjCRS crs;
+	};
+
+	PJ *Insert(string key, ProjCRS crs) {
+		if (entries.size() >= MAX_ENTRIES) {
+			index.erase(entries.back().key);
+			entries.pop_back();
+		}
+
+		entries.emplace_front();
+		auto &entry = entries.front();
+		entry.key = std::move(key);
+		entry.crs = std::move(crs);
+		index[entry.key] = entries.begin();
+		return entry.crs.get();
+	}
+
+	// Most recently used first
+	list<Entry> entries;
+	unordered_map<string, list<Entry>::iterator> index;
+};
+
 struct ProjFunctionLocalState : public FunctionLocalState {
 
 	PJ_CONTEXT *proj_ctx;
 	GeometryFactory factory;
+	idx_t arena_soft_limit;
+	idx_t arena_size = 0;
+	ProjPipelineCache pipelines;
 
 	explicit ProjFunctionLocalState(ClientContext &context)
-	    : proj_ctx(ProjModule::GetThreadProjContext()), factory(BufferAllocator::Get(context)) {
+	    : proj_ctx(ProjModule::GetThreadProjContext()), factory(BufferAllocator::Get(context)),
+	      arena_soft_limit(GeometryArena::GetSoftLimit(context)) {
+		factory.counters.Init(context);
+		ProjGridCache::Attach(proj_ctx, context);
 	}
 
 	~ProjFunctionLocalState() override {
+		factory.counters.Flush();
+		GeometryArena::Release(factory.allocator, arena_size);
+		// The pipelines belong to the context, so they have to be destroyed first
+		pipelines.Clear();
 		proj_context_destroy(proj_ctx);
 	}
 
+	PJ *GetPipeline(const string &from, const string &to, bool always_xy, ProjPipelineTemplate *shared = nullptr) {
+		return pipelines.GetOrCreate(proj_ctx, from, to, always_xy, shared, factory.counters);
+	}
+
 	static unique_ptr<FunctionLocalState> Init(ExpressionState &state, const BoundFunctionExpression &expr,
 	                                           FunctionData *bind_data) {
 		auto result = make_uniq<ProjFunctionLocalState>(state.GetContext());
@@ -40,24 +205,176 @@ struct ProjFunctionLocalState : public FunctionLocalState {
 
 	static ProjFunctionLocalState &ResetAndGet(ExpressionState &state) {
 		auto &local_state = (ProjFunctionLocalState &)*ExecuteFunctionState::GetFunctionState(state);
-		local_state.factory.allocator.Reset();
+		GeometryArena::Reset(local_state.factory.allocator, local_state.arena_soft_limit, local_state.arena_size);
 		return local_state;
 	}
 };
 
+//------------------------------------------------------------------------------
+// Well-known transforms
+//------------------------------------------------------------------------------
+// Pairs of projections that are common enough (e.g. for generating web map tiles) to be worth transforming with a
+// closed-form kernel instead of going through the PROJ pipeline.
+enum class WellKnownTransform : uint8_t { NONE, WGS84_TO_WEB_MERCATOR, WEB_MERCATOR_TO_WGS84 };
+
+struct WebMercator {
+	// The same constants and operations as the EPSG:4326 -> EPSG:3857 pipeline in PROJ
+	// (axisswap, unitconvert deg -> rad and webmerc on the WGS84 semi-major axis)
+	static constexpr double SEMI_MAJOR_AXIS = 6378137.0;
+	static constexpr double DEG_TO_RAD = 0.017453292519943296;
+	// PROJ reports an error when projecting this close to the poles
+	static constexpr double MAX_LATITUDE_RAD = 1.5707963267948966 - 1e-10;
+	static constexpr double PI = 3.14159265358979323846;
+
+	// Transform count strided pairs of coordinates in place. lat_first is true when the geographic coordinates are in
+	// the authority axis order of EPSG:4326 (latitude, longitude) rather than (longitude, latitude). Returns false
+	// without modifying anything if any coordinate is outside the domain handled here (e.g. longitudes that PROJ would
+	// wrap around), in which case the caller has to use PROJ instead.
+	static bool TryTransform(WellKnownTransform kind, bool lat_first, double *x, double *y, idx_t stride_bytes,
+	                         idx_t count) {
+		// Coordinates are either separate arrays or interleaved vertices of two to four dimensions, with the stride
+		// fixed at compile time the loops below compile to straight vector code
+		switch (stride_bytes / sizeof(double)) {
+		case 1:
+			return TransformStrided(kind, lat_first, x, y, std::integral_constant<idx_t, 1>(), count);
+		case 2:
+			return TransformStrided(kind, lat_first, x, y, std::integral_constant<idx_t, 2>(), count);
+		case 3:
+			return TransformStrided(kind, lat_first, x, y, std::integral_constant<idx_t, 3>(), count);
+		case 4:
+			return TransformStrided(kind, lat_first, x, y, std::integral_constant<idx_t, 4>(), count);
+		default:
+			return TransformStrided(kind, lat_first, x, y, stride_bytes / sizeof(double), count);
+		}
+	}
+
+private:
+	template <class STRIDE>
+	static bool TransformStrided(WellKnownTransform kind, bool lat_first, double *x, double *y, STRIDE stride,
+	                             idx_t count) {
+		if (kind == WellKnownTransform::WGS84_TO_WEB_MERCATOR) {
+			auto lon = lat_first ? y : x;
+			auto lat = lat_first ? x : y;
+			for (idx_t i = 0; i < count; i++) {
+				auto lon_deg = lon[i * stride];
+				auto lat_rad = lat[i * stride] * DEG_TO_RAD;
+				// Also fails for NaN
+				if (!(lon_deg >= -180.0 && lon_deg <= 180.0 && lat_rad >= -MAX_LATITUDE_RAD &&
+				      lat_rad <= MAX_LATITUDE_RAD)) {
+					return false;
+				}
+			}
+			for (idx_t i = 0; i < count; i++) {
+				auto lam = lon[i * stride] * DEG_TO_RAD;
+				auto phi = lat[i * stride] * DEG_TO_RAD;
+				x[i * stride] = SEMI_MAJOR_AXIS * lam;
+				y[i * stride] = SEMI_MAJOR_AXIS * std::asinh(std::tan(phi));
+			}
+			return true;
+		}
+		if (kind == WellKnownTransform::WEB_MERCATOR_TO_WGS84) {
+			static constexpr double INV_SEMI_MAJOR_AXIS = 1.0 / SEMI_MAJOR_AXIS;
+			static constexpr double RAD_TO_DEG = 1.0 / DEG_TO_RAD;
+			for (idx_t i = 0; i < count; i++) {
+				auto lam = x[i * stride] * INV_SEMI_MAJOR_AXIS;
+				auto north = y[i * stride];
+				if (!(lam >= -PI && lam <= PI && north == north)) {
+					return false;
+				}
+			}
+			auto lon = lat_first ? y : x;
+			auto lat = lat_first ? x : y;
+			for (idx_t i = 0; i < count; i++) {
+				auto lam = x[i * stride] * INV_SEMI_MAJOR_AXIS;
+				auto phi = std::atan(std::sinh(y[i * stride] * INV_SEMI_MAJOR_AXIS));
+				lon[i * stride] = lam * RAD_TO_DEG;
+				lat[i * stride] = phi * RAD_TO_DEG;
+			}
+			return true;
+		}
+		return false;
+	}
+};
+
+static WellKnownTransform GetWellKnownTransform(const string &from, const string &to) {
+	auto from_crs = StringUtil::Upper(from);
+	auto to_crs = StringUtil::Upper(to);
+	StringUtil::Trim(from_crs);
+	StringUtil::Trim(to_crs);
+	if (from_crs == "EPSG:4326" && to_crs == "EPSG:3857") {
+		return WellKnownTransform::WGS84_TO_WEB_MERCATOR;
+	}
+	if (from_crs == "EPSG:3857" && to_crs == "EPSG:4326") {
+		return WellKnownTransform::WEB_MERCATOR_TO_WGS84;
+	}
+	return WellKnownTransform::NONE;
+}
+
+// Transforms buffers of coordinates, with the closed-form kernel if the projections are well-known and PROJ otherwise
+struct CoordinateTransformer {
+	PJ *crs;
+	WellKnownTransform well_known;
+	bool lat_first;
+
+	explicit CoordinateTransformer(PJ *crs, WellKnownTransform well_known = WellKnownTransform::NONE,
+	                               bool always_xy = false)
+	    : crs(crs), well_known(well_known), lat_first(!always_xy) {
+	}
+
+	void Transform(double *x, double *y, idx_t stride_bytes, idx_t count) const {
+		if (well_known != WellKnownTransform::NONE &&
+		    WebMercator::TryTransform(well_known, lat_first, x, y, stride_bytes, count)) {
+			return;
+		}
+		proj_trans_generic(crs, PJ_FWD, x, stride_bytes, count, y, stride_bytes, count, nullptr, 0, 0, nullptr, 0, 0);
+	}
+};
+
+// Whether two projections are the same coordinate reference system, e.g. 'EPSG:4326' and 'epsg:4326', so that
+// transforming between them leaves every coordinate unchanged
+static bool IsSameCRS(const string &from, const string &to) {
+	auto ctx = ProjModule::GetThreadProjContext();
+	auto from_crs = ProjCRS(proj_create(ctx, from.c_str()));
+	auto to_crs = ProjCRS(proj_create(ctx, to.c_str()));
+	auto result = from_crs && to_crs && proj_is_crs(from_crs.get()) && proj_is_crs(to_crs.get()) &&
+	              proj_is_equivalent_to_with_ctx(ctx, from_crs.get(), to_crs.get(), PJ_COMP_EQUIVALENT);
+	from_crs.reset();
+	to_crs.reset();
+	proj_context_destroy(ctx);
+	return result;
+}
+
+// Bound instead of the transform when the constant projections are the same CRS
+static void IdentityTransformFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	result.Reference(args.data[0]);
+}
+
 struct TransformFunctionData : FunctionData {
 
 	// Whether or not to always return XY coordinates, even when the CRS has a different axis order.
 	bool conventional_gis_order = false;
+	// Set if both projections are constant and can be transformed without PROJ
+	WellKnownTransform well_known = WellKnownTransform::NONE;
+	// Set if both projections are constant, the pipeline each thread clones
+	shared_ptr<ProjPipelineTemplate> pipeline;
+	// The number of points added to each edge of a BOX_2D before transforming it
+	int32_t densify_pts = 0;
 
 	unique_ptr<FunctionData> Copy() const override {
 		auto result = make_uniq<TransformFunctionData>();
 		result->conventional_gis_order = conventional_gis_order;
+		result->well_known = well_known;
+		result->pipeline = pipeline;
+		result->densify_pts = densify_pts;
 		return std::move(result);
 	}
 	bool Equals(const FunctionData &other) const override {
 		auto &data = other.Cast<TransformFunctionData>();
-		return conventional_gis_order == data.conventional_gis_order;
+		if (!pipeline != !data.pipeline || (pipeline && !pipeline->Matches(*data.pipeline))) {
+			return false;
+		}
+		return conventional_gis_order == data.conventional_gis_order && well_known == data.well_known &&
+		       densify_pts == data.densify_pts;
 	}
 };
 
@@ -65,7 +382,7 @@ static unique_ptr<FunctionData> TransformBind(ClientContext &context, ScalarFunc
                                               vector<unique_ptr<Expression>> &arguments) {
 
 	auto result = make_uniq<TransformFunctionData>();
-	if (arguments.size() == 4) {
+	if (arguments.size() >= 4) {
 		// Ensure the "always_xy" parameter is a constant
 		auto &arg = arguments[3];
 		if (arg->HasParameter()) {
@@ -76,9 +393,145 @@ static unique_ptr<FunctionData> TransformBind(ClientContext &context, ScalarFunc
 		}
 		result->conventional_gis_order = BooleanValue::Get(ExpressionExecutor::EvaluateScalar(context, *arg));
 	}
+	if (arguments.size() == 5) {
+		// Ensure the "densify_pts" parameter is a constant
+		auto &arg = arguments[4];
+		if (arg->HasParameter() || !arg->IsFoldable()) {
+			throw InvalidInputException("The 'densify_pts' parameter must be a constant");
+		}
+		auto value = ExpressionExecutor::EvaluateScalar(context, *arg);
+		// The range accepted by proj_trans_bounds
+		if (value.IsNull() || IntegerValue::Get(value) < 0 || IntegerValue::Get(value) > 10000) {
+			throw InvalidInputException("The 'densify_pts' parameter must be between 0 and 10000");
+		}
+		result->densify_pts = IntegerValue::Get(value);
+	}
+
+	// If the projections are constant, resolve the pipeline once here instead of in every thread, and check if they
+	// are one of the pairs we can transform without PROJ
+	auto &from_arg = arguments[1];
+	auto &to_arg = arguments[2];
+	if (from_arg->IsFoldable() && to_arg->IsFoldable() && !from_arg->HasParameter() && !to_arg->HasParameter()) {
+		auto from_val = ExpressionExecutor::EvaluateScalar(context, *from_arg);
+		auto to_val = ExpressionExecutor::EvaluateScalar(context, *to_arg);
+		if (!from_val.IsNull() && !to_val.IsNull()) {
+			auto &from_str = StringValue::Get(from_val);
+			auto &to_str = StringValue::Get(to_val);
+			if (IsSameCRS(from_str, to_str)) {
+				bound_function.function = IdentityTransformFunction;
+				return std::move(result);
+			}
+			result->well_known = GetWellKnownTransform(from_str, to_str);
+			result->pipeline =
+			    ProjPipelineTemplate::TryCreate(context, from_str, to_str, result->conventional_gis_order);
+		}
+	}
 	return std::move(result);
 }
 
+// Transforms the bounds of many boxes with the same pipeline, by densifying the edges of all of them into one buffer
+// and transforming it with a single call. The boundary is sampled and reduced exactly like proj_trans_bounds does it.
+// proj_trans_bounds itself is still used for what it treats specially: geographic output, where the bounds can wrap
+// around the antimeridian or contain a pole, and boxes with min > max on either axis.
+class BoundsTransformer {
+public:
+	BoundsTransformer(PJ_CONTEXT *ctx, PJ *crs, int32_t densify_pts)
+	    : ctx(ctx), crs(crs), densify_pts(densify_pts), side_pts(densify_pts + 1), boundary_len(side_pts * 4),
+	      batchable(proj_degree_output(crs, PJ_FWD) == 0) {
+		auto rows = MaxValue<idx_t>(MAX_BUFFER_POINTS / boundary_len, 1);
+		x_buffer.resize(rows * boundary_len);
+		y_buffer.resize(rows * boundary_len);
+		pending.reserve(rows);
+	}
+
+	// Transforms the box in the given row, or queues it up for the next call to Flush
+	void Transform(const double *in[4], double *out[4], idx_t row) {
+		auto xmin = in[0][row];
+		auto ymin = in[1][row];
+		auto xmax = in[2][row];
+		auto ymax = in[3][row];
+		if (!batchable || !(xmin <= xmax && ymin <= ymax)) {
+			proj_trans_bounds(ctx, crs, PJ_FWD, xmin, ymin, xmax, ymax, &out[0][row], &out[1][row], &out[2][row],
+			                  &out[3][row], densify_pts);
+			return;
+		}
+		if (pending.size() * boundary_len == x_buffer.size()) {
+			Flush(out);
+		}
+
+		// Build the densified boundary, in the same order and with the same arithmetic as proj_trans_bounds
+		auto x_boundary = x_buffer.data() + pending.size() * boundary_len;
+		auto y_boundary = y_buffer.data() + pending.size() * boundary_len;
+		auto delta_x = (xmax - xmin) / side_pts;
+		auto delta_y = (ymax - ymin) / side_pts;
+		for (idx_t i = 0; i < side_pts; i++) {
+			y_boundary[i] = ymax - i * delta_y;
+			x_boundary[i] = xmin;
+			y_boundary[i + side_pts] = ymin;
+			x_boundary[i + side_pts] = xmin + i * delta_x;
+			y_boundary[i + side_pts * 2] = ymin + i * delta_y;
+			x_boundary[i + side_pts * 2] = xmax;
+			y_boundary[i + side_pts * 3] = ymax;
+			x_boundary[i + side_pts * 3] = xmax - i * delta_x;
+		}
+		pending.push_back(row);
+	}
+
+	void Flush(double *out[4]) {
+		if (pending.empty()) {
+			return;
+		}
+		auto total = pending.size() * boundary_len;
+		proj_trans_generic(crs, PJ_FWD, x_buffer.data(), sizeof(double), total, y_buffer.data(), sizeof(double),
+		                   total, nullptr, 0, 0, nullptr, 0, 0);
+		for (idx_t i = 0; i < pending.size(); i++) {
+			auto row = pending[i];
+			auto x_boundary = x_buffer.data() + i * boundary_len;
+			auto y_boundary = y_buffer.data() + i * boundary_len;
+			out[0][row] = Min(x_boundary);
+			out[1][row] = Min(y_boundary);
+			out[2][row] = Max(x_boundary);
+			out[3][row] = Max(y_boundary);
+		}
+		pending.clear();
+	}
+
+private:
+	// Bounds the size of the boundary buffers for large densify factors
+	static constexpr idx_t MAX_BUFFER_POINTS = 65536;
+
+	PJ_CONTEXT *ctx;
+	PJ *crs;
+	int32_t densify_pts;
+	idx_t side_pts;
+	idx_t boundary_len;
+	bool batchable;
+	vector<double> x_buffer;
+	vector<double> y_buffer;
+	vector<idx_t> pending;
+
+	// Failed points are HUGE_VAL, which the minimum ignores by itself and the maximum skips, like in PROJ
+	double Min(const double *data) const {
+		auto result = data[0];
+		for (idx_t i = 1; i < boundary_len; i++) {
+			if (data[i] < result) {
+				result = data[i];
+			}
+		}
+		return result;
+	}
+
+	double Max(const double *data) const {
+		auto result = data[0];
+		for (idx_t i = 1; i < boundary_len; i++) {
+			if ((data[i] > result || result == HUGE_VAL) && data[i] != HUGE_VAL) {
+				result = data[i];
+			}
+		}
+		return result;
+	}
+};
+
 static void Box2DTransformFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	using BOX_TYPE = StructTypeQuaternary<double, double, double, double>;
 	using PROJ_TYPE = PrimitiveType<string_t>;
@@ -100,56 +553,64 @@ static void Box2DTransformFunction(DataChunk &args, ExpressionState &state, Vect
 		auto from_str = ConstantVector::GetData<PROJ_TYPE>(proj_from)[0].val.GetString();
 		auto to_str = ConstantVector::GetData<PROJ_TYPE>(proj_to)[0].val.GetString();
 
-		auto crs = proj_create_crs_to_crs(proj_ctx, from_str.c_str(), to_str.c_str(), nullptr);
-		if (!crs) {
-			throw InvalidInputException("Could not create projection: " + from_str + " -> " + to_str);
+		auto crs = local_state.GetPipeline(from_str, to_str, info.conventional_gis_order, info.pipeline.get());
+
+		auto is_constant = box.GetVectorType() == VectorType::CONSTANT_VECTOR;
+		if (is_constant) {
+			count = 1;
+		}
+		box.Flatten(count);
+		auto &box_children = StructVector::GetEntries(box);
+		const double *box_in[4];
+		for (idx_t i = 0; i < 4; i++) {
+			box_in[i] = FlatVector::GetData<double>(*box_children[i]);
 		}
 
-		if (info.conventional_gis_order) {
-			auto normalized_crs = proj_normalize_for_visualization(proj_ctx, crs);
-			if (normalized_crs) {
-				proj_destroy(crs);
-				crs = normalized_crs;
-			}
-			// otherwise fall back to the original CRS
+		result.SetVectorType(VectorType::FLAT_VECTOR);
+		auto &result_children = StructVector::GetEntries(result);
+		double *box_out[4];
+		for (idx_t i = 0; i < 4; i++) {
+			box_out[i] = FlatVector::GetData<double>(*result_children[i]);
 		}
+		auto &result_validity = FlatVector::Validity(result);
+		result_validity.Copy(FlatVector::Validity(box), count);
 
-		GenericExecutor::ExecuteUnary<BOX_TYPE, BOX_TYPE>(box, result, count, [&](BOX_TYPE box_in) {
-			BOX_TYPE box_out;
-			int densify_pts = 0;
-			proj_trans_bounds(proj_ctx, crs, PJ_FWD, box_in.a_val, box_in.b_val, box_in.c_val, box_in.d_val,
-			                  &box_out.a_val, &box_out.b_val, &box_out.c_val, &box_out.d_val, densify_pts);
-			return box_out;
-		});
+		BoundsTransformer transformer(proj_ctx, crs, info.densify_pts);
+		for (idx_t row = 0; row < count; row++) {
+			if (!result_validity.RowIsValid(row)) {
+				continue;
+			}
+			if (info.well_known != WellKnownTransform::NONE) {
+				// Both axes are transformed independently and monotonically, so the corners are enough
+				double xs[2] = {box_in[0][row], box_in[2][row]};
+				double ys[2] = {box_in[1][row], box_in[3][row]};
+				if (WebMercator::TryTransform(info.well_known, !info.conventional_gis_order, xs, ys, sizeof(double),
+				                              2)) {
+					box_out[0][row] = xs[0];
+					box_out[1][row] = ys[0];
+					box_out[2][row] = xs[1];
+					box_out[3][row] = ys[1];
+					continue;
+				}
+			}
+			transformer.Transform(box_in, box_out, row);
+		}
+		transformer.Flush(box_out);
 
-		proj_destroy(crs);
+		if (is_constant) {
+			result.SetVectorType(VectorType::CONSTANT_VECTOR);
+		}
 	} else {
 		GenericExecutor::ExecuteTernary<BOX_TYPE, PROJ_TYPE, PROJ_TYPE, BOX_TYPE>(
 		    box, proj_from, proj_to, result, count, [&](BOX_TYPE box_in, PROJ_TYPE proj_from, PROJ_TYPE proj_to) {
 			    auto from_str = proj_from.val.GetString();
 			    auto to_str = proj_to.val.GetString();
 
-			    auto crs = proj_create_crs_to_crs(nullptr, from_str.c_str(), to_str.c_str(), nullptr);
-			    if (!crs) {
-				    throw InvalidInputException("Could not create projection: " + from_str + " -> " + to_str);
-			    }
-
-			    if (info.conventional_gis_order) {
-				    auto normalized_crs = proj_normalize_for_visualization(proj_ctx, crs);
-				    if (normalized_crs) {
-					    proj_destroy(crs);
-					    crs = normalized_crs;
-				    }
-				    // otherwise fall back to the original CRS
-			    }
-
-			    // TODO: this may be interesting to use, but at that point we can only return a BOX_TYPE
-			    int densify_pts = 0;
+			    auto crs = local_state.GetPipeline(from_str, to_str, info.conventional_gis_order);
+
 			    BOX_TYPE box_out;
 			    proj_trans_bounds(proj_ctx, crs, PJ_FWD, box_in.a_val, box_in.b_val, box_in.c_val, box_in.d_val,
-			                      &box_out.a_val, &box_out.b_val, &box_out.c_val, &box_out.d_val, densify_pts);
-
-			    proj_destroy(crs);
+			                      &box_out.a_val, &box_out.b_val, &box_out.c_val, &box_out.d_val, info.densify_pts);
 
 			    return box_out;
 		    });
@@ -177,118 +638,57 @@ static void Point2DTransformFunction(DataChunk &args, ExpressionState &state, Ve
 		auto from_str = ConstantVector::GetData<PROJ_TYPE>(proj_from)[0].val.GetString();
 		auto to_str = ConstantVector::GetData<PROJ_TYPE>(proj_to)[0].val.GetString();
 
-		auto crs = proj_create_crs_to_crs(proj_ctx, from_str.c_str(), to_str.c_str(), nullptr);
-		if (!crs) {
-			throw InvalidInputException("Could not create projection: " + from_str + " -> " + to_str);
-		}
+		auto crs = local_state.GetPipeline(from_str, to_str, info.conventional_gis_order, info.pipeline.get());
 
-		if (info.conventional_gis_order) {
-			auto normalized_crs = proj_normalize_for_visualization(proj_ctx, crs);
-			if (normalized_crs) {
-				proj_destroy(crs);
-				crs = normalized_crs;
-			}
-			// otherwise fall back to the original CRS
-		}
+		// Copy the coordinates into the result and transform all of them in place with a single call
+		auto is_constant = point.GetVectorType() == VectorType::CONSTANT_VECTOR;
+		point.Flatten(count);
+		auto &point_children = StructVector::GetEntries(point);
+		auto x_in = FlatVector::GetData<double>(*point_children[0]);
+		auto y_in = FlatVector::GetData<double>(*point_children[1]);
 
-		GenericExecutor::ExecuteUnary<POINT_TYPE, POINT_TYPE>(point, result, count, [&](POINT_TYPE point_in) {
-			POINT_TYPE point_out;
-			auto transformed = proj_trans(crs, PJ_FWD, proj_coord(point_in.a_val, point_in.b_val, 0, 0)).xy;
-			point_out.a_val = transformed.x;
-			point_out.b_val = transformed.y;
-			return point_out;
-		});
-		proj_destroy(crs);
+		result.SetVectorType(VectorType::FLAT_VECTOR);
+		auto &result_children = StructVector::GetEntries(result);
+		auto x_out = FlatVector::GetData<double>(*result_children[0]);
+		auto y_out = FlatVector::GetData<double>(*result_children[1]);
+		memcpy(x_out, x_in, count * sizeof(double));
+		memcpy(y_out, y_in, count * sizeof(double));
+		FlatVector::Validity(result).Copy(FlatVector::Validity(point), count);
+
+		CoordinateTransformer transformer(crs, info.well_known, info.conventional_gis_order);
+		transformer.Transform(x_out, y_out, sizeof(double), count);
 
+		if (is_constant) {
+			result.SetVectorType(VectorType::CONSTANT_VECTOR);
+		}
 	} else {
 		GenericExecutor::ExecuteTernary<POINT_TYPE, PROJ_TYPE, PROJ_TYPE, POINT_TYPE>(
 		    point, proj_from, proj_to, result, count, [&](POINT_TYPE point_in, PROJ_TYPE proj_from, PROJ_TYPE proj_to) {
 			    auto from_str = proj_from.val.GetString();
 			    auto to_str = proj_to.val.GetString();
 
-			    auto crs = proj_create_crs_to_crs(proj_ctx, from_str.c_str(), to_str.c_str(), nullptr);
-			    if (!crs) {
-				    throw InvalidInputException("Could not create projection: " + from_str + " -> " + to_str);
-			    }
-
-			    if (info.conventional_gis_order) {
-				    auto normalized_crs = proj_normalize_for_visualization(proj_ctx, crs);
-				    if (normalized_crs) {
-					    proj_destroy(crs);
-					    crs = normalized_crs;
-				    }
-				    // otherwise fall back to the original CRS
-			    }
+			    auto crs = local_state.GetPipeline(from_str, to_str, info.conventional_gis_order);
 
 			    POINT_TYPE point_out;
 			    auto transformed = proj_trans(crs, PJ_FWD, proj_coord(point_in.a_val, point_in.b_val, 0, 0)).xy;
 			    point_out.a_val = transformed.x;
 			    point_out.b_val = transformed.y;
 
-			    proj_destroy(crs);
-
 			    return point_out;
 		    });
 	}
 }
 
-struct TransformOp {
-	static void Transform(VertexArray &array, PJ *crs, ArenaAllocator &arena) {
-		array.MakeOwning(arena);
-		for (uint32_t i = 0; i < array.Count(); i++) {
-			auto vertex = array.Get(i);
-			auto transformed = proj_trans(crs, PJ_FWD, proj_coord(vertex.x, vertex.y, 0, 0)).xy;
-			// we own the array, so we can use SetUnsafe
-			array.Set(i, transformed.x, transformed.y);
-		}
-	}
-
-	static void Apply(Point &point, PJ *crs, ArenaAllocator &arena) {
-		Transform(point.Vertices(), crs, arena);
-	}
-
-	static void Apply(LineString &line, PJ *crs, ArenaAllocator &arena) {
-		Transform(line.Vertices(), crs, arena);
-	}
-
-	static void Apply(Polygon &poly, PJ *crs, ArenaAllocator &arena) {
-		for (auto &ring : poly) {
-			Transform(ring, crs, arena);
-		}
-	}
-
-	static void Apply(MultiPoint &multi_point, PJ *crs, ArenaAllocator &arena) {
-		for (auto &point : multi_point) {
-			Apply(point, crs, arena);
-		}
-	}
-
-	static void Apply(MultiLineString &multi_line, PJ *crs, ArenaAllocator &arena) {
-		for (auto &line : multi_line) {
-			Apply(line, crs, arena);
-		}
-	}
-
-	static void Apply(MultiPolygon &multi_poly, PJ *crs, ArenaAllocator &arena) {
-		for (auto &poly : multi_poly) {
-			Apply(poly, crs, arena);
-		}
-	}
-
-	static void Apply(GeometryCollection &geom, PJ *crs, ArenaAllocator &arena) {
-		for (auto &child : geom) {
-			child.Dispatch<TransformOp>(crs, arena);
-		}
-	}
-};
-
-struct ProjCRSDelete {
-	void operator()(PJ *crs) {
-		proj_destroy(crs);
-	}
-};
-
-using ProjCRS = unique_ptr<PJ, ProjCRSDelete>;
+// The geometry is copied and only the runs of vertices of the copy are transformed, in place and a run at a time.
+// Z and M are left untouched, like when transforming vertex by vertex.
+static geometry_t TransformGeometry(Vector &result, const geometry_t &input, const CoordinateTransformer &transformer) {
+	return GeometryFactory::SerializedTransformVertices(
+	    result, input, [&](data_ptr_t vertices, uint32_t count, uint32_t vertex_size) {
+		    auto x_data = reinterpret_cast<double *>(vertices);
+		    auto y_data = reinterpret_cast<double *>(vertices + sizeof(double));
+		    transformer.Transform(x_data, y_data, vertex_size, count);
+	    });
+}
 
 static void GeometryTransformFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto count = args.size();
@@ -301,78 +701,170 @@ static void GeometryTransformFunction(DataChunk &args, ExpressionState &state, V
 	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
 	auto &info = func_expr.bind_info->Cast<TransformFunctionData>();
 
-	auto &proj_ctx = local_state.proj_ctx;
-	auto &factory = local_state.factory;
-
 	if (proj_from_vec.GetVectorType() == VectorType::CONSTANT_VECTOR &&
 	    proj_to_vec.GetVectorType() == VectorType::CONSTANT_VECTOR && !ConstantVector::IsNull(proj_from_vec) &&
 	    !ConstantVector::IsNull(proj_to_vec)) {
 		// Special case: both projections are constant (very common)
 		// we can create the projection once and reuse it for all geometries
 
-		// TODO: In the future we can cache the projections in the state instead.
-
 		auto from_str = ConstantVector::GetData<string_t>(proj_from_vec)[0].GetString();
 		auto to_str = ConstantVector::GetData<string_t>(proj_to_vec)[0].GetString();
-		auto crs = ProjCRS(proj_create_crs_to_crs(proj_ctx, from_str.c_str(), to_str.c_str(), nullptr));
-		if (!crs.get()) {
-			throw InvalidInputException("Could not create projection: " + from_str + " -> " + to_str);
-		}
-
-		if (info.conventional_gis_order) {
-			auto normalized_crs = proj_normalize_for_visualization(proj_ctx, crs.get());
-			if (normalized_crs) {
-				crs = ProjCRS(normalized_crs);
-			}
-			// otherwise fall back to the original CRS
-		}
+		auto crs = local_state.GetPipeline(from_str, to_str, info.conventional_gis_order, info.pipeline.get());
+		CoordinateTransformer transformer(crs, info.well_known, info.conventional_gis_order);
 
-		UnaryExecutor::Execute<geometry_t, geometry_t>(geom_vec, result, count, [&](geometry_t input_geom) {
-			auto props = input_geom.GetProperties();
-			auto geom = factory.Deserialize(input_geom);
-			geom.Dispatch<TransformOp>(crs.get(), factory.allocator);
-			return factory.Serialize(result, geom, props.HasZ(), props.HasM());
+		GeometryExecutor::ExecuteUnary<geometry_t, geometry_t>(geom_vec, result, count, [&](geometry_t input_geom) {
+			return TransformGeometry(result, input_geom, transformer);
 		});
 	} else {
 		// General case: projections are not constant
-		// we need to create a projection for each geometry
+		// we look up the projection of each geometry in the cache, so each pair is only created once per thread
 		TernaryExecutor::Execute<geometry_t, string_t, string_t, geometry_t>(
 		    geom_vec, proj_from_vec, proj_to_vec, result, count,
 		    [&](geometry_t input_geom, string_t proj_from, string_t proj_to) {
 			    auto from_str = proj_from.GetString();
 			    auto to_str = proj_to.GetString();
-			    auto crs = ProjCRS(proj_create_crs_to_crs(proj_ctx, from_str.c_str(), to_str.c_str(), nullptr));
-
-			    if (!crs.get()) {
-				    throw InvalidInputException("Could not create projection: " + from_str + " -> " + to_str);
-			    }
-
-			    if (info.conventional_gis_order) {
-				    auto normalized_crs = proj_normalize_for_visualization(proj_ctx, crs.get());
-				    if (normalized_crs) {
-					    crs = ProjCRS(normalized_crs);
-				    }
-				    // otherwise fall back to the original CRS
-			    }
-
-			    auto props = input_geom.GetProperties();
-			    auto geom = factory.Deserialize(input_geom);
-			    geom.Dispatch<TransformOp>(crs.get(), factory.allocator);
-			    // TransformGeometry(crs.get(), geom);
-			    return factory.Serialize(result, geom, props.HasZ(), props.HasM());
+			    auto crs = local_state.GetPipeline(from_str, to_str, info.conventional_gis_order);
+			    CoordinateTransformer transformer(crs);
+			    return TransformGeometry(result, input_geom, transformer);
 		    });
 	}
 }
 
-// SPATIAL_REF_SYS table function
-struct GenerateSpatialRefSysTable {
+//------------------------------------------------------------------------------
+// CRS catalog
+//------------------------------------------------------------------------------
+// All coordinate reference systems in the embedded proj.db, enumerated once per database instance and kept in the
+// object cache, so that ST_List_Proj_CRS() and spatial_ref_sys do not have to go through the proj database again.
+class ProjCRSCatalog : public ObjectCacheEntry {
+public:
+	// The columns of ST_List_Proj_CRS(), in order
+	static constexpr idx_t INFO_COLUMN_COUNT = 8;
+	// The columns of spatial_ref_sys
+	enum class RefSysColumn : idx_t { SRID = 0, AUTH_NAME = 1, AUTH_SRID = 2, SRTEXT = 3, PROJ4TEXT = 4 };
+
+	ProjCRSCatalog() {
+		ProjModule::Initialize();
+
+		int result_count = 0;
+		auto crs_list = proj_get_crs_info_list_from_database(nullptr, nullptr, nullptr, &result_count);
+		rows.reserve(result_count);
+		for (int i = 0; i < result_count; i++) {
+			auto proj = crs_list[i];
+			Row row;
+			row.info[0] = GetValue(proj->auth_name);
+			row.info[1] = GetValue(proj->code);
+			row.info[2] = GetValue(proj->name);
+			row.info[3] = Value(proj->type);
+			row.info[4] = Value::BOOLEAN(proj->deprecated != 0);
+			row.info[5] = GetValue(proj->area_name);
+			row.info[6] = GetValue(proj->projection_method_name);
+			row.info[7] = GetValue(proj->celestial_body_name);
+
+			// Only EPSG codes are used as SRIDs, the codes of other authorities could collide with them
+			int32_t auth_srid;
+			string code = proj->code ? proj->code : "";
+			if (TryCast::Operation<string_t, int32_t>(string_t(code), auth_srid)) {
+				row.auth_srid = Value::INTEGER(auth_srid);
+				if (proj->auth_name && StringUtil::CIEquals(proj->auth_name, "EPSG")) {
+					row.srid = row.auth_srid;
+				}
+			}
+			rows.push_back(std::move(row));
+		}
+		proj_crs_info_list_destroy(crs_list);
+	}
+
+	static string ObjectType() {
+		return "spatial_proj_crs_catalog";
+	}
+
+	string GetObjectType() override {
+		return ObjectType();
+	}
+
+	static shared_ptr<ProjCRSCatalog> Get(ClientContext &context) {
+		auto &cache = ObjectCache::GetObjectCache(context);
+		return cache.GetOrCreate<ProjCRSCatalog>(ObjectType());
+	}
+
+	idx_t Count() const {
+		return rows.size();
+	}
+
+	const Value &GetInfo(idx_t row_idx, idx_t column_idx) const {
+		return rows[row_idx].info[column_idx];
+	}
+
+	// The WKT and PROJ string definitions are expensive to produce for the whole database, so they are only written
+	// the first time a query asks for them
+	void LoadDefinitions() {
+		std::call_once(definitions_loaded, [&]() {
+			auto ctx = ProjModule::GetThreadProjContext();
+			for (auto &row : rows) {
+				if (row.info[0].IsNull() || row.info[1].IsNull()) {
+					continue;
+				}
+				auto &auth_name = StringValue::Get(row.info[0]);
+				auto &code = StringValue::Get(row.info[1]);
+				auto crs = ProjCRS(proj_create_from_database(ctx, auth_name.c_str(), code.c_str(), PJ_CATEGORY_CRS,
+				                                             false, nullptr));
+				if (!crs.get()) {
+					continue;
+				}
+				row.srtext = GetValue(proj_as_wkt(ctx, crs.get(), PJ_WKT1_GDAL, nullptr));
+				row.proj4text = GetValue(proj_as_proj_string(ctx, crs.get(), PJ_PROJ_4, nullptr));
+			}
+			proj_context_destroy(ctx);
+		});
+	}
 
-	struct State : public GlobalTableFunctionState {
-		idx_t current_idx;
-		State() : current_idx(0) {
+	// The srtext and proj4text columns are NULL unless LoadDefinitions() has been called
+	Value GetRefSys(idx_t row_idx, RefSysColumn column) const {
+		auto &row = rows[row_idx];
+		switch (column) {
+		case RefSysColumn::SRID:
+			return row.srid;
+		case RefSysColumn::AUTH_NAME:
+			return row.info[0];
+		case RefSysColumn::AUTH_SRID:
+			return row.auth_srid;
+		case RefSysColumn::SRTEXT:
+			return row.srtext;
+		case RefSysColumn::PROJ4TEXT:
+			return row.proj4text;
+		default:
+			throw InternalException("Unknown spatial_ref_sys column");
 		}
+	}
+
+private:
+	struct Row {
+		Value info[INFO_COLUMN_COUNT];
+		Value srid;
+		Value auth_srid;
+		Value srtext;
+		Value proj4text;
 	};
 
+	vector<Row> rows;
+	std::once_flag definitions_loaded;
+
+	static Value GetValue(const char *str) {
+		return str ? Value(str) : Value();
+	}
+};
+
+struct ProjCRSCatalogState : public GlobalTableFunctionState {
+	shared_ptr<ProjCRSCatalog> catalog;
+	vector<column_t> column_ids;
+	idx_t current_idx = 0;
+};
+
+//------------------------------------------------------------------------------
+// ST_List_Proj_CRS
+//------------------------------------------------------------------------------
+struct GenerateSpatialRefSysTable {
+
 	static unique_ptr<FunctionData> Bind(ClientContext &context, TableFunctionBindInput &input,
 	                                     vector<LogicalType> &return_types, vector<string> &names);
 
@@ -413,36 +905,24 @@ unique_ptr<FunctionData> GenerateSpatialRefSysTable::Bind(ClientContext &context
 
 unique_ptr<GlobalTableFunctionState> GenerateSpatialRefSysTable::Init(ClientContext &context,
                                                                       TableFunctionInitInput &input) {
-	auto result = make_uniq<State>();
+	auto result = make_uniq<ProjCRSCatalogState>();
+	result->catalog = ProjCRSCatalog::Get(context);
 	return std::move(result);
 }
 
 void GenerateSpatialRefSysTable::Execute(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
-	// TODO: This is a lot slower than it has to be, ideally we only do one call to proj_get_crs_info_list
-	// and return the whole list in one go.
-	auto &state = (State &)*input.global_state;
-	int result_count = 0;
-	auto crs_list = proj_get_crs_info_list_from_database(nullptr, nullptr, nullptr, &result_count);
+	auto &state = input.global_state->Cast<ProjCRSCatalogState>();
+	auto &catalog = *state.catalog;
 
 	idx_t count = 0;
-	auto next_idx = MinValue<idx_t>(state.current_idx + STANDARD_VECTOR_SIZE, result_count);
-
-	// TODO: this just returns the crs info, not a spatial_ref_sys table that follows the schema.
+	auto next_idx = MinValue<idx_t>(state.current_idx + STANDARD_VECTOR_SIZE, catalog.Count());
 	for (idx_t i = state.current_idx; i < next_idx; i++) {
-		auto proj = crs_list[i];
-		output.SetValue(0, count, Value(proj->auth_name));
-		output.SetValue(1, count, Value(proj->code));
-		output.SetValue(2, count, Value(proj->name));
-		output.SetValue(3, count, Value(proj->type));
-		output.SetValue(4, count, Value(proj->deprecated));
-		output.SetValue(5, count, Value(proj->area_name));
-		output.SetValue(6, count, Value(proj->projection_method_name));
-		output.SetValue(7, count, Value(proj->celestial_body_name));
+		for (idx_t col_idx = 0; col_idx < ProjCRSCatalog::INFO_COLUMN_COUNT; col_idx++) {
+			output.SetValue(col_idx, count, catalog.GetInfo(i, col_idx));
+		}
 		count++;
 	}
 
-	proj_crs_info_list_destroy(crs_list);
-
 	state.current_idx += count;
 	output.SetCardinality(count);
 }
@@ -450,18 +930,191 @@ void GenerateSpatialRefSysTable::Execute(ClientContext &context, TableFunctionIn
 void GenerateSpatialRefSysTable::Register(DatabaseInstance &db) {
 	TableFunction func("ST_List_Proj_CRS", {}, Execute, Bind, Init);
 	ExtensionUtil::RegisterFunction(db, func);
+}
+
+//------------------------------------------------------------------------------
+// spatial_ref_sys
+//------------------------------------------------------------------------------
+// The SQL/MM spatial_ref_sys table. Also available as a plain "spatial_ref_sys" table through a replacement scan.
+struct SpatialRefSysTable {
+
+	static unique_ptr<FunctionData> Bind(ClientContext &context, TableFunctionBindInput &input,
+	                                     vector<LogicalType> &return_types, vector<string> &names) {
+		names.push_back("srid");
+		return_types.push_back(LogicalType::INTEGER);
+		names.push_back("auth_name");
+		return_types.push_back(LogicalType::VARCHAR);
+		names.push_back("auth_srid");
+		return_types.push_back(LogicalType::INTEGER);
+		names.push_back("srtext");
+		return_types.push_back(LogicalType::VARCHAR);
+		names.push_back("proj4text");
+		return_types.push_back(LogicalType::VARCHAR);
+		return nullptr;
+	}
+
+	static unique_ptr<GlobalTableFunctionState> Init(ClientContext &context, TableFunctionInitInput &input) {
+		auto result = make_uniq<ProjCRSCatalogState>();
+		result->catalog = ProjCRSCatalog::Get(context);
+		// Only produce the projected columns, so that the definitions are not written unless they are needed
+		result->column_ids = input.column_ids;
+		for (auto &column_id : result->column_ids) {
+			if (column_id == static_cast<column_t>(ProjCRSCatalog::RefSysColumn::SRTEXT) ||
+			    column_id == static_cast<column_t>(ProjCRSCatalog::RefSysColumn::PROJ4TEXT)) {
+				result->catalog->LoadDefinitions();
+			}
+		}
+		return std::move(result);
+	}
+
+	static void Execute(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
+		auto &state = input.global_state->Cast<ProjCRSCatalogState>();
+		auto &catalog = *state.catalog;
+
+		idx_t count = 0;
+		auto next_idx = MinValue<idx_t>(state.current_idx + STANDARD_VECTOR_SIZE, catalog.Count());
+		for (idx_t i = state.current_idx; i < next_idx; i++) {
+			for (idx_t out_idx = 0; out_idx < state.column_ids.size(); out_idx++) {
+				auto column_id = state.column_ids[out_idx];
+				if (column_id == COLUMN_IDENTIFIER_ROW_ID) {
+					output.SetValue(out_idx, count, Value::BIGINT(static_cast<int64_t>(i)));
+					continue;
+				}
+				auto column = static_cast<ProjCRSCatalog::RefSysColumn>(column_id);
+				output.SetValue(out_idx, count, catalog.GetRefSys(i, column));
+			}
+			count++;
+		}
 
-	// Also create a view
-	/*
-	auto view = make_uniq<CreateViewInfo>();
-	view->schema = DEFAULT_SCHEMA;
-	view->view_name = "SPATIAL_REF_SYS";
-	view->sql = "SELECT * FROM st_list_proj_crs()"; // TODO: this is not SQL/MM compliant
-	view->temporary = true;
-	view->internal = true;
-	CreateViewInfo::FromSelect(context, std::move(view));
-	catalog.CreateView(context, view.get());
-	*/
+		state.current_idx += count;
+		output.SetCardinality(count);
+	}
+
+	static unique_ptr<TableRef> ReplacementScan(ClientContext &, const string &table_name, ReplacementScanData *) {
+		if (!StringUtil::CIEquals(table_name, "spatial_ref_sys")) {
+			return nullptr;
+		}
+		auto table_function = make_uniq<TableFunctionRef>();
+		vector<unique_ptr<ParsedExpression>> children;
+		table_function->function = make_uniq<FunctionExpression>("ST_Spatial_Ref_Sys", std::move(children));
+		table_function->alias = "spatial_ref_sys";
+		return std::move(table_function);
+	}
+
+	static void Register(DatabaseInstance &db) {
+		TableFunction func("ST_Spatial_Ref_Sys", {}, Execute, Bind, Init);
+		func.projection_pushdown = true;
+		ExtensionUtil::RegisterFunction(db, func);
+
+		auto &config = DBConfig::GetConfig(db);
+		config.replacement_scans.emplace_back(ReplacementScan);
+	}
+};
+
+//------------------------------------------------------------------------------
+// ST_GeoArrowExtension
+//------------------------------------------------------------------------------
+// The native types are exported to Arrow in the separated coordinate layouts of GeoArrow, and WKB as binary, but
+// DuckDB does not let extensions annotate the exported fields. This returns the extension name and metadata for a
+// client to annotate a field of the argument's type with. It only depends on the type and the constant CRS, so it is
+// resolved once when binding.
+
+struct GeoArrowExtensionData final : public FunctionData {
+	Value extension;
+
+	explicit GeoArrowExtensionData(Value extension_p) : extension(std::move(extension_p)) {
+	}
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<GeoArrowExtensionData>(extension);
+	}
+	bool Equals(const FunctionData &other) const override {
+		return extension == other.Cast<GeoArrowExtensionData>().extension;
+	}
+};
+
+// GEOMETRY has no Arrow layout of its own, it is exported as WKB with ST_AsWKB
+static vector<std::pair<LogicalType, string>> GetGeoArrowExtensionNames() {
+	return {
+	    {GeoTypes::POINT_2D(), "geoarrow.point"},
+	    {GeoTypes::POINT_3D(), "geoarrow.point"},
+	    {GeoTypes::POINT_4D(), "geoarrow.point"},
+	    {GeoTypes::LINESTRING_2D(), "geoarrow.linestring"},
+	    {GeoTypes::POLYGON_2D(), "geoarrow.polygon"},
+	    {GeoTypes::MULTIPOINT_2D(), "geoarrow.multipoint"},
+	    {GeoTypes::MULTILINESTRING_2D(), "geoarrow.multilinestring"},
+	    {GeoTypes::MULTIPOLYGON_2D(), "geoarrow.multipolygon"},
+	    {GeoTypes::GEOMETRY(), "geoarrow.wkb"},
+	    {GeoTypes::WKB_BLOB(), "geoarrow.wkb"},
+	};
+}
+
+// The CRS as PROJJSON, which GeoArrow readers understand without a PROJ database of their own
+static string GetProjJSON(const string &crs_string) {
+	auto ctx = ProjModule::GetThreadProjContext();
+	string result;
+	{
+		auto crs = ProjCRS(proj_create(ctx, crs_string.c_str()));
+		const char *json = nullptr;
+		if (crs) {
+			const char *const options[] = {"MULTILINE=NO", nullptr};
+			json = proj_as_projjson(ctx, crs.get(), options);
+		}
+		if (json) {
+			result = json;
+		}
+	}
+	proj_context_destroy(ctx);
+	if (result.empty()) {
+		throw InvalidInputException("ST_GeoArrowExtension: could not create a PROJJSON definition of '%s'",
+		                            crs_string);
+	}
+	return result;
+}
+
+static unique_ptr<FunctionData> GeoArrowExtensionBind(ClientContext &context, ScalarFunction &bound_function,
+                                                      vector<unique_ptr<Expression>> &arguments) {
+	string metadata = "{}";
+	if (arguments.size() == 2) {
+		auto &arg = arguments[1];
+		if (arg->HasParameter() || !arg->IsFoldable()) {
+			throw InvalidInputException("ST_GeoArrowExtension: the CRS must be a constant");
+		}
+		auto crs = ExpressionExecutor::EvaluateScalar(context, *arg);
+		if (!crs.IsNull()) {
+			metadata = "{\"crs\":" + GetProjJSON(StringValue::Get(crs)) + ",\"crs_type\":\"projjson\"}";
+		}
+	}
+
+	auto &type = bound_function.arguments[0];
+	for (auto &entry : GetGeoArrowExtensionNames()) {
+		if (entry.first == type) {
+			auto extension = Value::STRUCT({{"name", Value(entry.second)}, {"metadata", Value(metadata)}});
+			return make_uniq<GeoArrowExtensionData>(std::move(extension));
+		}
+	}
+	throw InternalException("ST_GeoArrowExtension: unexpected type %s", type.ToString());
+}
+
+static void GeoArrowExtensionFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &data = func_expr.bind_info->Cast<GeoArrowExtensionData>();
+	result.Reference(data.extension);
+}
+
+static void RegisterGeoArrowExtension(DatabaseInstance &db) {
+	ScalarFunctionSet set("ST_GeoArrowExtension");
+	auto return_type = LogicalType::STRUCT({{"name", LogicalType::VARCHAR}, {"metadata", LogicalType::VARCHAR}});
+	for (auto &entry : GetGeoArrowExtensionNames()) {
+		ScalarFunction without_crs({entry.first}, return_type, GeoArrowExtensionFunction, GeoArrowExtensionBind);
+		without_crs.null_handling = FunctionNullHandling::SPECIAL_HANDLING;
+		set.AddFunction(without_crs);
+
+		ScalarFunction with_crs({entry.first, LogicalType::VARCHAR}, return_type, GeoArrowExtensionFunction,
+		                        GeoArrowExtensionBind);
+		with_crs.null_handling = FunctionNullHandling::SPECIAL_HANDLING;
+		set.AddFunction(with_crs);
+	}
+	ExtensionUtil::RegisterFunction(db, set);
 }
 
 void ProjFunctions::Register(DatabaseInstance &db) {
@@ -475,6 +1128,9 @@ void ProjFunctions::Register(DatabaseInstance &db) {
 	set.AddFunction(ScalarFunction(
 	    {GeoTypes::BOX_2D(), LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::BOOLEAN}, GeoTypes::BOX_2D(),
 	    Box2DTransformFunction, TransformBind, nullptr, nullptr, ProjFunctionLocalState::Init));
+	set.AddFunction(ScalarFunction(
+	    {GeoTypes::BOX_2D(), LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::BOOLEAN, LogicalType::INTEGER},
+	    GeoTypes::BOX_2D(), Box2DTransformFunction, TransformBind, nullptr, nullptr, ProjFunctionLocalState::Init));
 
 	set.AddFunction(ScalarFunction({GeoTypes::POINT_2D(), LogicalType::VARCHAR, LogicalType::VARCHAR},
 	                               GeoTypes::POINT_2D(), Point2DTransformFunction, TransformBind, nullptr, nullptr,
@@ -493,6 +1149,8 @@ void ProjFunctions::Register(DatabaseInstance &db) {
 	ExtensionUtil::RegisterFunction(db, set);
 
 	GenerateSpatialRefSysTable::Register(db);
+	SpatialRefSysTable::Register(db);
+	RegisterGeoArrowExtension(db);
 }
 
 } // namespace proj
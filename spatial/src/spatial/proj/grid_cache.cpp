@@ -0,0 +1,224 @@
+#include "spatial/common.hpp"
+#include "spatial/proj/grid_cache.hpp"
+
+#include "duckdb/main/client_context.hpp"
+
+namespace spatial {
+
+namespace proj {
+
+//------------------------------------------------------------------------------
+// Cache
+//------------------------------------------------------------------------------
+ProjGridCache &ProjGridCache::Get() {
+	static ProjGridCache cache;
+	return cache;
+}
+
+shared_ptr<ProjGridCache::Grid> ProjGridCache::TryGet(const string &path) {
+	lock_guard<mutex> guard(lock);
+	auto entry = index.find(path);
+	if (entry == index.end() || !(*entry->second)->ready) {
+		return nullptr;
+	}
+	grids.splice(grids.begin(), grids, entry->second);
+	return *entry->second;
+}
+
+shared_ptr<ProjGridCache::Grid> ProjGridCache::Load(FileHandle &file, const string &path, idx_t capacity) {
+	shared_ptr<Grid> grid;
+	{
+		lock_guard<mutex> guard(lock);
+		auto entry = index.find(path);
+		if (entry != index.end()) {
+			grids.splice(grids.begin(), grids, entry->second);
+			grid = *entry->second;
+		} else {
+			grid = make_shared<Grid>();
+			grid->path = path;
+			grids.push_front(grid);
+			index[path] = grids.begin();
+		}
+	}
+
+	// Other threads opening the same grid wait for it instead of reading it again. If reading fails, the next
+	// thread to open it tries again.
+	bool loaded_here = false;
+	std::call_once(grid->loaded, [&]() {
+		auto file_size = file.GetFileSize();
+		grid->data.resize(file_size);
+		file.Read(&grid->data[0], file_size, 0);
+		loaded_here = true;
+	});
+
+	if (loaded_here) {
+		lock_guard<mutex> guard(lock);
+		grid->ready = true;
+		auto entry = index.find(path);
+		// The grid may have been evicted while it was read, it is then only kept alive by its handles
+		if (entry != index.end() && *entry->second == grid) {
+			grid->charged_size = grid->data.size();
+			size += grid->charged_size;
+			Evict(capacity);
+		}
+	}
+	return grid;
+}
+
+void ProjGridCache::Evict(idx_t capacity) {
+	// The most recent grid is always kept, it is the one that was just opened
+	while (size > capacity && grids.size() > 1) {
+		auto &grid = grids.back();
+		size -= grid->charged_size;
+		index.erase(grid->path);
+		grids.pop_back();
+	}
+}
+
+//------------------------------------------------------------------------------
+// PROJ File API
+//------------------------------------------------------------------------------
+// PROJ calls these from C, so no exception may escape them: errors are reported as failures, after which PROJ
+// treats the grid as missing.
+
+struct ProjGridHandle {
+	// Either the cached grid or, for grids larger than the cache, the file itself
+	shared_ptr<ProjGridCache::Grid> grid;
+	unique_ptr<FileHandle> file;
+	idx_t size = 0;
+	idx_t position = 0;
+};
+
+static idx_t GetGridCacheCapacity(ClientContext &context) {
+	Value capacity;
+	if (context.TryGetCurrentSetting("spatial_proj_grid_cache_size", capacity) && !capacity.IsNull()) {
+		return DBConfig::ParseMemoryLimit(capacity.ToString());
+	}
+	return 0;
+}
+
+static PROJ_FILE_HANDLE *GridOpen(PJ_CONTEXT *, const char *filename, PROJ_OPEN_ACCESS access, void *user_data) {
+	if (access != PROJ_OPEN_ACCESS_READ_ONLY) {
+		return nullptr;
+	}
+	auto &context = *static_cast<ClientContext *>(user_data);
+	auto &cache = ProjGridCache::Get();
+	try {
+		auto handle = make_uniq<ProjGridHandle>();
+		handle->grid = cache.TryGet(filename);
+		if (!handle->grid) {
+			auto &fs = FileSystem::GetFileSystem(context);
+			auto file = fs.OpenFile(filename, FileFlags::FILE_FLAGS_READ);
+			if (file->GetFileSize() > GetGridCacheCapacity(context)) {
+				handle->size = file->GetFileSize();
+				handle->file = std::move(file);
+				return reinterpret_cast<PROJ_FILE_HANDLE *>(handle.release());
+			}
+			handle->grid = cache.Load(*file, filename, GetGridCacheCapacity(context));
+		}
+		handle->size = handle->grid->data.size();
+		return reinterpret_cast<PROJ_FILE_HANDLE *>(handle.release());
+	} catch (std::exception &ex) {
+		return nullptr;
+	}
+}
+
+static size_t GridRead(PJ_CONTEXT *, PROJ_FILE_HANDLE *handle_p, void *buffer, size_t size, void *) {
+	auto &handle = *reinterpret_cast<ProjGridHandle *>(handle_p);
+	auto count = MinValue<idx_t>(size, handle.size - MinValue(handle.position, handle.size));
+	if (count == 0) {
+		return 0;
+	}
+	if (handle.grid) {
+		memcpy(buffer, handle.grid->data.data() + handle.position, count);
+	} else {
+		try {
+			handle.file->Read(buffer, count, handle.position);
+		} catch (std::exception &ex) {
+			return 0;
+		}
+	}
+	handle.position += count;
+	return count;
+}
+
+static size_t GridWrite(PJ_CONTEXT *, PROJ_FILE_HANDLE *, const void *, size_t, void *) {
+	return 0;
+}
+
+static int GridSeek(PJ_CONTEXT *, PROJ_FILE_HANDLE *handle_p, long long offset, int whence, void *) {
+	auto &handle = *reinterpret_cast<ProjGridHandle *>(handle_p);
+	long long base;
+	switch (whence) {
+	case SEEK_SET:
+		base = 0;
+		break;
+	case SEEK_CUR:
+		base = static_cast<long long>(handle.position);
+		break;
+	case SEEK_END:
+		base = static_cast<long long>(handle.size);
+		break;
+	default:
+		return false;
+	}
+	if (base + offset < 0) {
+		return false;
+	}
+	handle.position = static_cast<idx_t>(base + offset);
+	return true;
+}
+
+static unsigned long long GridTell(PJ_CONTEXT *, PROJ_FILE_HANDLE *handle_p, void *) {
+	return reinterpret_cast<ProjGridHandle *>(handle_p)->position;
+}
+
+static void GridClose(PJ_CONTEXT *, PROJ_FILE_HANDLE *handle_p, void *) {
+	delete reinterpret_cast<ProjGridHandle *>(handle_p);
+}
+
+static int GridExists(PJ_CONTEXT *, const char *filename, void *user_data) {
+	auto &context = *static_cast<ClientContext *>(user_data);
+	if (ProjGridCache::Get().TryGet(filename)) {
+		return true;
+	}
+	try {
+		return FileSystem::GetFileSystem(context).FileExists(filename);
+	} catch (std::exception &ex) {
+		return false;
+	}
+}
+
+// The grids are only ever read, PROJ only creates and removes files for its own cache of downloaded grids
+static int GridMkdir(PJ_CONTEXT *, const char *, void *) {
+	return false;
+}
+
+static int GridUnlink(PJ_CONTEXT *, const char *, void *) {
+	return false;
+}
+
+static int GridRename(PJ_CONTEXT *, const char *, const char *, void *) {
+	return false;
+}
+
+void ProjGridCache::Attach(PJ_CONTEXT *ctx, ClientContext &context) {
+	Value grid_path;
+	if (!context.TryGetCurrentSetting("spatial_proj_grid_path", grid_path) || grid_path.IsNull()) {
+		return;
+	}
+	auto path = grid_path.ToString();
+	if (path.empty()) {
+		return;
+	}
+
+	static const PROJ_FILE_API FILE_API = {1,         GridOpen,   GridRead,   GridWrite,   GridSeek, GridTell,
+	                                       GridClose, GridExists, GridMkdir, GridUnlink, GridRename};
+	proj_context_set_fileapi(ctx, &FILE_API, &context);
+	auto path_ptr = path.c_str();
+	proj_context_set_search_paths(ctx, 1, &path_ptr);
+}
+
+} // namespace proj
+
+} // namespace spatial
@@ -1,11 +1,14 @@
 #include "spatial/common.hpp"
 
+#include "spatial/core/init_profile.hpp"
 #include "spatial/proj/module.hpp"
 #include "spatial/proj/functions.hpp"
 
 #include "proj.h"
 #include "sqlite3.h"
 
+#include <mutex>
+
 namespace spatial {
 
 namespace proj {
@@ -21,6 +24,7 @@ extern "C" unsigned int proj_db_len;
 extern "C" int sqlite3_memvfs_init(sqlite3 *, char **, const sqlite3_api_routines *);
 
 PJ_CONTEXT *ProjModule::GetThreadProjContext() {
+	Initialize();
 
 	auto ctx = proj_context_create();
 
@@ -46,35 +50,54 @@ PJ_CONTEXT *ProjModule::GetThreadProjContext() {
 
 // TODO: ignore memvfs, load into :memory: at runtime instead...?
 
-// IMPORTANT: Make sure this module is loaded before any other modules that use proj (like GDAL)
-void ProjModule::Register(DatabaseInstance &db) {
-	// we use the sqlite "memvfs" to store the proj.db database in the extension binary itself
-	// this way we don't have to worry about the user having the proj.db database installed
-	// on their system. We therefore have to tell proj to use memvfs as the sqlite3 vfs and
-	// point it to the segment of the binary that contains the proj.db database
-
-	sqlite3_initialize();
-	sqlite3_memvfs_init(nullptr, nullptr, nullptr);
-	auto vfs = sqlite3_vfs_find("memvfs");
-	if (!vfs) {
-		throw InternalException("Could not find sqlite memvfs extension");
-	}
-	sqlite3_vfs_register(vfs, 0);
-
-	// We set the default context proj.db path to the one in the binary here
-	// Otherwise GDAL will try to load the proj.db from the system
-	// Any PJ_CONTEXT we create after this will inherit these settings (on this thread?)
-	auto path = StringUtil::Format("file:/proj.db?ptr=%llu&sz=%lu&max=%lu", (void *)proj_db, proj_db_len, proj_db_len);
-
-	proj_context_set_sqlite3_vfs_name(nullptr, "memvfs");
-
-	auto ok = proj_context_set_database_path(nullptr, path.c_str(), nullptr, nullptr);
-	if (!ok) {
-		throw InternalException("Could not set proj.db path");
-	}
+// Setting up sqlite and the embedded proj.db is deferred until PROJ is first used, so that loading the extension
+// stays cheap for sessions that never transform anything.
+// IMPORTANT: Make sure this is called before any other modules use proj (like GDAL)
+void ProjModule::Initialize() {
+	static std::once_flag initialized;
+	std::call_once(initialized, []() {
+		core::InitProfile::Timer timer("proj", "initialize");
+
+		// we use the sqlite "memvfs" to store the proj.db database in the extension binary itself
+		// this way we don't have to worry about the user having the proj.db database installed
+		// on their system. We therefore have to tell proj to use memvfs as the sqlite3 vfs and
+		// point it to the segment of the binary that contains the proj.db database
+
+		sqlite3_initialize();
+		sqlite3_memvfs_init(nullptr, nullptr, nullptr);
+		auto vfs = sqlite3_vfs_find("memvfs");
+		if (!vfs) {
+			throw InternalException("Could not find sqlite memvfs extension");
+		}
+		sqlite3_vfs_register(vfs, 0);
+
+		// We set the default context proj.db path to the one in the binary here
+		// Otherwise GDAL will try to load the proj.db from the system
+		// Any PJ_CONTEXT we create after this will inherit these settings (on this thread?)
+		auto path =
+		    StringUtil::Format("file:/proj.db?ptr=%llu&sz=%lu&max=%lu", (void *)proj_db, proj_db_len, proj_db_len);
+
+		proj_context_set_sqlite3_vfs_name(nullptr, "memvfs");
+
+		auto ok = proj_context_set_database_path(nullptr, path.c_str(), nullptr, nullptr);
+		if (!ok) {
+			throw InternalException("Could not set proj.db path");
+		}
+	});
+}
 
+void ProjModule::Register(DatabaseInstance &db) {
 	// Register functions
 	ProjFunctions::Register(db);
+
+	auto &config = DBConfig::GetConfig(db);
+	config.AddExtensionOption("spatial_proj_grid_path",
+	                          "The directory or URL prefix that PROJ reads datum shift grids from through the DuckDB "
+	                          "file system, e.g. on S3, or empty to use the grids installed with PROJ",
+	                          LogicalType::VARCHAR, Value(""));
+	config.AddExtensionOption("spatial_proj_grid_cache_size",
+	                          "The memory the grids read from spatial_proj_grid_path may take, shared by all threads",
+	                          LogicalType::VARCHAR, Value("256MB"));
 }
 
 } // namespace proj
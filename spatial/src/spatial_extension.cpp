@@ -7,6 +7,7 @@
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
 #include "duckdb/parser/parsed_data/create_view_info.hpp"
 
+#include "spatial/core/init_profile.hpp"
 #include "spatial/core/module.hpp"
 #include "spatial/gdal/module.hpp"
 #include "spatial/geos/module.hpp"
@@ -16,11 +17,28 @@
 namespace duckdb {
 
 static void LoadInternal(DatabaseInstance &instance) {
-	spatial::core::CoreModule::Register(instance);
-	spatial::proj::ProjModule::Register(instance);
-	spatial::gdal::GdalModule::Register(instance);
-	spatial::geos::GeosModule::Register(instance);
-	spatial::geographiclib::GeographicLibModule::Register(instance);
+	using spatial::core::InitProfile;
+	// PROJ and GDAL are only initialized when first used, see ProjModule::Initialize and GdalModule::Initialize
+	{
+		InitProfile::Timer timer("core", "register");
+		spatial::core::CoreModule::Register(instance);
+	}
+	{
+		InitProfile::Timer timer("proj", "register");
+		spatial::proj::ProjModule::Register(instance);
+	}
+	{
+		InitProfile::Timer timer("gdal", "register");
+		spatial::gdal::GdalModule::Register(instance);
+	}
+	{
+		InitProfile::Timer timer("geos", "register");
+		spatial::geos::GeosModule::Register(instance);
+	}
+	{
+		InitProfile::Timer timer("geographiclib", "register");
+		spatial::geographiclib::GeographicLibModule::Register(instance);
+	}
 }
 
 void SpatialExtension::Load(DuckDB &db) {
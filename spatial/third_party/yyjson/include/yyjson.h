@@ -1274,6 +1274,17 @@ yyjson_api_inline char *yyjson_mut_val_write(const yyjson_mut_val *val,
     return yyjson_mut_val_write_opts(val, flg, NULL, len, NULL);
 }
 
+/**
+ Write a double value as a JSON number to the buffer, formatted the same way
+ the JSON writer formats real numbers (spatial extension addition).
+
+ @param num The number to write.
+ @param buf The output buffer, which must be at least 32 bytes long.
+ @return A pointer to the end of the written number (no null-terminator is
+    written), or NULL if the number is infinite or NaN.
+ */
+yyjson_api char *yyjson_write_real(double num, char *buf);
+
 
 
 /*==============================================================================
@@ -6690,6 +6690,14 @@ static_inline u8 *write_number(u8 *cur, yyjson_val *val,
 
 
 
+char *yyjson_write_real(double num, char *buf) {
+    u64 raw;
+    memcpy(&raw, &num, sizeof(raw));
+    return (char *)write_f64_raw((u8 *)buf, raw, YYJSON_WRITE_NOFLAG);
+}
+
+
+
 /*==============================================================================
  * String Writer
  *============================================================================*/